@@ -46,4 +46,5 @@ from psi4.driver.driver import *
 
 # Single functions
 from psi4.driver.driver_cbs import cbs
+from psi4.driver.benchmark import benchmark_suite
 from psi4.driver.p4util.python_helpers import set_options, set_module_options, pcm_helper, basis_helper
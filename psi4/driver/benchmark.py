@@ -0,0 +1,273 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2017 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+
+"""Reproducible timings of the kernels the SCF and correlated codes
+spend their time in, written as one JSON document (``psi4 --benchmark``).
+
+"""
+from __future__ import print_function
+from __future__ import absolute_import
+import os
+import sys
+import json
+import time
+import socket
+import multiprocessing
+import platform
+import datetime
+
+from psi4 import core
+from psi4.driver import p4util
+from psi4.driver.p4util.exceptions import *
+from psi4.driver.molutil import geometry, activate
+
+# Water dimer, C1 and fixed in space so every machine sees the same problem
+_benchmark_molecule = """
+0 1
+O  -1.551007  -0.114520   0.000000
+H  -1.934259   0.762503   0.000000
+H  -0.599677   0.040712   0.000000
+O   1.350625   0.111469   0.000000
+H   1.680398  -0.373741  -0.758561
+H   1.680398  -0.373741   0.758561
+symmetry c1
+no_reorient
+no_com
+"""
+
+_benchmark_kernels = ['gemm', 'psio', 'eri', 'jk', 'dft', 'dfhelper', 'dpd']
+
+
+def _machine_info():
+    """Returns a dict describing the build and host the timings belong to."""
+    from psi4.metadata import __version__
+    info = {
+        'psi4_version': __version__,
+        'python': platform.python_version(),
+        'platform': platform.platform(),
+        'processor': platform.processor(),
+        'hostname': socket.gethostname(),
+        'cpu_count': multiprocessing.cpu_count(),
+        'threads': core.get_num_threads(),
+        'memory': core.get_memory(),
+        'scratch': core.IOManager.shared_object().get_default_path(),
+        'date': datetime.datetime.now().isoformat(),
+    }
+    for var in ['OMP_NUM_THREADS', 'MKL_NUM_THREADS', 'OPENBLAS_NUM_THREADS']:
+        if var in os.environ:
+            info[var.lower()] = os.environ[var]
+    return info
+
+
+def _repeat(func, min_time):
+    """Calls func until at least min_time seconds pass, returns seconds per call."""
+    calls = 0
+    start = time.time()
+    while True:
+        func()
+        calls += 1
+        elapsed = time.time() - start
+        if elapsed >= min_time:
+            return elapsed / calls, calls
+
+
+def _bench_jk(wfn, min_time):
+    basis = wfn.basisset()
+    Cocc = wfn.Ca_subset("AO", "OCC")
+    results = {}
+    for jk_type in ['PK', 'DIRECT', 'DF']:
+        jk = core.JK.build(basis, jk_type=jk_type)
+        jk.set_memory(int(core.get_memory() * 0.8 / 8))
+        jk.initialize()
+        jk.C_add(Cocc)
+        jk.compute()  # warm-up, not timed
+        jk.clear_metrics()
+        seconds, calls = _repeat(jk.compute, min_time)
+        records = json.loads(jk.metrics_json())['iterations']
+        results[jk_type] = {
+            'algorithm': jk.name(),
+            'seconds': seconds,
+            'calls': calls,
+            'gflops': sum(r['flops'] for r in records) / sum(r['total_time'] for r in records) / 1.e9,
+            'integral_time': sum(r['integral_time'] for r in records) / calls,
+            'contraction_time': sum(r['contraction_time'] for r in records) / calls,
+            'psio_bytes': sum(r['psio_bytes'] for r in records) / calls,
+        }
+        jk.finalize()
+    return results
+
+
+def _bench_dft(molecule, min_time):
+    optstash = p4util.OptionsState(['SCF', 'DFT_SPHERICAL_POINTS'], ['SCF', 'DFT_RADIAL_POINTS'])
+    core.set_local_option('SCF', 'DFT_SPHERICAL_POINTS', 302)
+    core.set_local_option('SCF', 'DFT_RADIAL_POINTS', 75)
+    from psi4.driver.driver import energy
+    e, wfn = energy('b3lyp', molecule=molecule, return_wfn=True)
+    optstash.restore()
+
+    vpot = wfn.V_potential()
+    nbf = wfn.basisset().nbf()
+    V = core.Matrix("V", nbf, nbf)
+    vpot.set_D([wfn.Da()])
+    seconds, calls = _repeat(lambda: vpot.compute_V([V]), min_time)
+    return {'functional': 'B3LYP', 'grid': '(75,302)', 'nbf': nbf, 'seconds': seconds, 'calls': calls}
+
+
+def _bench_dfhelper(wfn, min_time):
+    basis = wfn.basisset()
+    aux = core.BasisSet.build(basis.molecule(), "DF_BASIS_MP2", core.get_global_option('DF_BASIS_MP2'),
+                              "RIFIT", core.get_global_option('BASIS'))
+    Cocc = wfn.Ca_subset("AO", "OCC")
+    Cvir = wfn.Ca_subset("AO", "VIR")
+
+    def transform():
+        dfh = core.DF_Helper(basis, aux)
+        dfh.set_memory(int(core.get_memory() * 0.8 / 8))
+        dfh.set_method("STORE")
+        dfh.set_on_core(True)
+        dfh.initialize()
+        dfh.add_space("i", Cocc)
+        dfh.add_space("a", Cvir)
+        dfh.add_transformation("iaQ", "i", "a", "pqQ")
+        dfh.transform()
+        dfh.clear()
+
+    seconds, calls = _repeat(transform, min_time)
+    return {'naux': aux.nbf(), 'nocc': Cocc.cols(), 'nvir': Cvir.cols(),
+            'seconds': seconds, 'calls': calls}
+
+
+def benchmark_suite(kernels=None, filename='benchmark.json', min_time=1.0, molecule=None, basis='cc-pvdz'):
+    r"""Times a fixed set of computational kernels and writes the results,
+    together with a description of the machine, as JSON.
+
+    :returns: (*dict*) The document written to *filename*.
+
+    :type kernels: list of str
+    :param kernels: ``None`` || ``['gemm', 'jk']`` || etc.
+
+        Subset of ``'gemm'`` (C_DGEMM at 256/1024/2048), ``'psio'`` (scratch
+        write/read of 32 MB), ``'eri'`` (all unique ERI quartets), ``'jk'``
+        (PK, DIRECT and DF J/K builds from the SCF occupied orbitals),
+        ``'dft'`` (B3LYP V matrix build on a (75,302) grid), ``'dfhelper'``
+        (in-core DF_Helper (ia|Q) transform) and ``'dpd'`` (DPD
+        ``contract444`` ladder, o=20, v=80). All by default.
+
+    :type filename: str
+    :param filename: ``'benchmark.json'`` || etc.
+
+        Where to write the JSON document, ``None`` to skip writing.
+
+    :type min_time: float
+    :param min_time: minimum wall time [s] each kernel is repeated for.
+
+    :type molecule: :ref:`molecule <op_py_molecule>`
+    :param molecule: system for the integral, JK, DFT and DF_Helper kernels,
+        a C1 water dimer by default.
+
+    :type basis: str
+    :param basis: orbital basis for those kernels.
+
+    >>> # [1] time everything, write benchmark.json
+    >>> benchmark_suite()
+
+    >>> # [2] just the dense linear algebra and J/K builds
+    >>> benchmark_suite(['gemm', 'jk'], filename='jk.json')
+
+    """
+    if kernels is None:
+        kernels = _benchmark_kernels
+    kernels = [k.lower() for k in kernels]
+    for k in kernels:
+        if k not in _benchmark_kernels:
+            raise ValidationError("benchmark_suite: unknown kernel '%s', choose from %s." % (k, ', '.join(_benchmark_kernels)))
+
+    optstash = p4util.OptionsState(['BASIS'], ['SCF_TYPE'], ['SCF', 'GUESS'], ['SCF', 'SAVE_JK'])
+    old_molecule = core.get_active_molecule()
+    if molecule is None:
+        molecule = geometry(_benchmark_molecule, 'benchmark')
+    molecule.update_geometry()
+    core.set_global_option('BASIS', basis)
+
+    core.print_out("\n  ==> Benchmark Suite <==\n\n")
+    results = {'machine': _machine_info(), 'molecule': molecule.name(), 'basis': basis,
+               'min_time': min_time, 'kernels': {}}
+    timings = results['kernels']
+
+    def report(kernel, label, value, unit):
+        core.print_out("    %-10s %-28s %14.4f %s\n" % (kernel, label, value, unit))
+
+    if 'gemm' in kernels:
+        timings['gemm'] = [core.benchmark_gemm(dim, min_time) for dim in [256, 1024, 2048]]
+        for run in timings['gemm']:
+            report('gemm', 'dim %d' % run['dim'], run['gflops'], 'GFLOP/s')
+
+    if 'psio' in kernels:
+        timings['psio'] = core.benchmark_psio(11, min_time)
+        report('psio', 'write', timings['psio']['write_mb_per_second'], 'MB/s')
+        report('psio', 'read', timings['psio']['read_mb_per_second'], 'MB/s')
+
+    if 'eri' in kernels:
+        orbital_basis = core.BasisSet.build(molecule, 'ORBITAL', basis)
+        timings['eri'] = core.benchmark_eri(orbital_basis, min_time)
+        report('eri', 'nbf %d' % orbital_basis.nbf(), timings['eri']['integrals_per_second'] / 1.e6, 'M ints/s')
+
+    if 'jk' in kernels or 'dfhelper' in kernels:
+        from psi4.driver.driver import energy
+        core.set_global_option('SCF_TYPE', 'DF')
+        e, wfn = energy('scf', molecule=molecule, return_wfn=True)
+
+        if 'jk' in kernels:
+            timings['jk'] = _bench_jk(wfn, min_time)
+            for jk_type, run in sorted(timings['jk'].items()):
+                report('jk', jk_type, run['seconds'], 's/build')
+
+        if 'dfhelper' in kernels:
+            timings['dfhelper'] = _bench_dfhelper(wfn, min_time)
+            report('dfhelper', '(ia|Q) naux %d' % timings['dfhelper']['naux'], timings['dfhelper']['seconds'], 's')
+
+    if 'dft' in kernels:
+        core.set_global_option('SCF_TYPE', 'DF')
+        timings['dft'] = _bench_dft(molecule, min_time)
+        report('dft', 'V build nbf %d' % timings['dft']['nbf'], timings['dft']['seconds'], 's')
+
+    if 'dpd' in kernels:
+        timings['dpd'] = core.benchmark_contract444(20, 80, min_time)
+        report('dpd', 'o %d v %d' % (20, 80), timings['dpd']['gflops'], 'GFLOP/s')
+
+    optstash.restore()
+    core.clean()
+    if old_molecule is not None:
+        activate(old_molecule)
+
+    if filename is not None:
+        with open(filename, 'w') as handle:
+            json.dump(results, handle, indent=2, sort_keys=True)
+        core.print_out("\n    Benchmark results written to %s\n" % filename)
+
+    return results
@@ -48,6 +48,7 @@ PSIF_CIVECT                 =   43  # CI vector from DETCI along with string and
 PSIF_AO_DGDBX               =   44  # B-field derivative AO integrals over GIAO Gaussians -- only bra-ket permutational symmetry holds
 PSIF_AO_DGDBY               =   45  # 
 PSIF_AO_DGDBZ               =   46  # 
+PSIF_SO_TEI_BLOCKED         =   47  # SO TEIs in dense symmetry blocks, in libtrans pair order (SO_TEI_FORMAT BLOCKED)
 PSIF_PSIMRCC_INTEGRALS      =   50  # 
 PSIF_PSIMRCC_RESTART        =   51  # 
 PSIF_MCSCF                  =   52  # 
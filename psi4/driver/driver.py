@@ -40,14 +40,18 @@ import math
 import os
 import shutil
 
+import numpy as np
+
 # Import driver helpers
 from psi4.driver import driver_util
 from psi4.driver import driver_cbs
 from psi4.driver import driver_nbody
+from psi4.driver import driver_farm
 from psi4.driver import p4util
 # from psi4.driver.inputparser import parse_options_block
 
 from psi4.driver.procrouting import *
+from psi4.driver.procrouting import proc_util
 from psi4.driver.p4util.exceptions import *
 # never import wrappers or aliases into this file
 
@@ -478,6 +482,56 @@ def energy(name, **kwargs):
         return core.get_variable('CURRENT ENERGY')
 
 
+def energy_batch(name, molecules, **kwargs):
+    r"""Function to compute the DF-MP2 energies of a series of molecules in
+    one process, as for screening many small molecules.
+
+    Each molecule is run through :py:func:`~psi4.energy` in turn, but the
+    work that does not depend on the geometry is paid only once: basis set
+    files are read and each element's entry parsed for the first molecule
+    only, the scratch manager, OpenMP threads, and BLAS stay up between
+    molecules, and the default |dfmp2__dfmp2_algorithm| keeps the RHF
+    :math:`(Q|ia)` tensor in core so no DF-MP2 scratch files are made. Only
+    the per-molecule scratch files of the SCF are cleaned in between.
+
+    :returns: *list* |w--w| Total electronic energy in Hartrees of each molecule, in order.
+
+    :type name: string
+    :param name: ``'mp2'`` || ``'scs-mp2'``
+
+        First argument, usually unlabeled. Indicates the DF-MP2 method
+        to be applied to every molecule.
+
+    :type molecules: list of :ref:`molecule <op_py_molecule>`
+    :param molecules: ``[h2o, nh3]`` || etc.
+
+        The molecules to compute, in order.
+
+    :examples:
+
+    >>> # [1] DF-MP2 energies of two monomers
+    >>> e_h2o, e_nh3 = energy_batch('mp2', [h2o, nh3])
+
+    """
+    lowername = name.lower()
+    kwargs = p4util.kwargs_lower(kwargs)
+
+    if lowername not in ['mp2', 'scs-mp2']:
+        raise ValidationError("""energy_batch: method '%s' is not available, only DF-MP2 ('mp2', 'scs-mp2').""" % name)
+    if core.get_global_option('MP2_TYPE') != 'DF':
+        raise ValidationError("""energy_batch: requires MP2_TYPE DF.""")
+    for key in ['molecule', 'return_wfn', 'bsse_type', 'ref_wfn']:
+        if key in kwargs:
+            raise ValidationError("""energy_batch: keyword '%s' is not supported.""" % key)
+
+    energies = []
+    for molecule in molecules:
+        energies.append(energy(name, molecule=molecule, **kwargs))
+        core.clean()
+
+    return energies
+
+
 def gradient(name, **kwargs):
     r"""Function complementary to :py:func:~driver.optimize(). Carries out one gradient pass,
     deciding analytic or finite difference.
@@ -595,6 +649,8 @@ def gradient(name, **kwargs):
         opt_linkage = kwargs.get('linkage', None)
         if opt_linkage is None:
             raise ValidationError("""Optimize execution mode 'reap' requires a linkage option.""")
+    elif opt_mode == 'farm':
+        pass
     else:
         raise ValidationError("""Optimize execution mode '%s' not valid.""" % (opt_mode))
 
@@ -634,6 +690,7 @@ def gradient(name, **kwargs):
         # This version is pretty dependent on the reference geometry being last (as it is now)
         print(""" %d displacements needed ...""" % (ndisp), end='')
         energies = []
+        optstash_guess = p4util.OptionsState(['SCF', 'GUESS'])
 
         # S/R: Write instructions for sow/reap procedure to output file and reap input file
         if opt_mode == 'sow':
@@ -673,6 +730,11 @@ def gradient(name, **kwargs):
                 fmaster.write(("""retE, retwfn = optimize('%s', **kwargs)\n\n""" % (lowername)).encode('utf-8'))
                 fmaster.write(instructionsM.encode('utf-8'))
 
+        # Farm: run all displaced energies at once as independent worker processes
+        elif opt_mode == 'farm':
+            energies = [result['energy'] for result in
+                        driver_farm.run_farm('energy', lowername, moleculeclone, displacements, **kwargs)]
+
         for n, displacement in enumerate(displacements):
             rfile = 'OPT-%s-%s' % (opt_iter, n + 1)
 
@@ -693,6 +755,10 @@ def gradient(name, **kwargs):
                 # Load in displacement into the active molecule
                 moleculeclone.set_geometry(displacement)
 
+                # Start from the previous displacement's orbitals, projected onto this geometry
+                if (n > 0) and (not core.get_option('SCF', 'GUESS_PERSIST')):
+                    core.set_local_option('SCF', 'GUESS', 'READ')
+
                 # Perform the energy calculation
                 E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
                 energies.append(core.get_variable('CURRENT ENERGY'))
@@ -722,11 +788,12 @@ def gradient(name, **kwargs):
         # S/R: Quit sow after writing files. Initialize skeleton wfn to receive grad for reap
         if opt_mode == 'sow':
             optstash.restore()
+            optstash_guess.restore()
             if return_wfn:
                 return (None, None)  # any point to building a dummy wfn here?
             else:
                 return None
-        elif opt_mode == 'reap':
+        elif opt_mode in ['reap', 'farm']:
             core.set_variable('CURRENT ENERGY', energies[-1])
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
 
@@ -737,6 +804,7 @@ def gradient(name, **kwargs):
         wfn.set_gradient(G)
 
         optstash.restore()
+        optstash_guess.restore()
 
         if return_wfn:
             return (wfn.gradient(), wfn)
@@ -834,6 +902,87 @@ def properties(*args, **kwargs):
         return core.get_variable('CURRENT ENERGY')
 
 
+def _subspace_hessian(lowername, molecule, H0, nmodes, opt_mode, **kwargs):
+    r"""Returns the Cartesian Hessian of *lowername* at the geometry of
+    *molecule* measured along the *nmodes* lowest vibrational modes of the
+    model Cartesian Hessian *H0* (an np.array) and taken from *H0* elsewhere.
+
+    Each mode costs the gradients at two displacements of |findif__disp_size|
+    along it. Translations and rotations are projected out before the modes are
+    chosen. With *opt_mode* ``'farm'``, the displacements run concurrently as
+    psi4 worker processes.
+
+    """
+    natom = molecule.natom()
+    ncart = 3 * natom
+    geom = np.array(molecule.geometry())
+
+    # Orthonormal complement of the rigid translations and rotations
+    center = geom.mean(axis=0)
+    rigid = []
+    for xyz in range(3):
+        t = np.zeros((natom, 3))
+        t[:, xyz] = 1.0
+        rigid.append(t.ravel())
+        r = np.cross(np.eye(3)[xyz], geom - center)
+        rigid.append(r.ravel())
+    U, sigma, _ = np.linalg.svd(np.array(rigid).T, full_matrices=True)
+    nrigid = int(np.sum(sigma > 1.0e-6 * sigma[0]))
+    Q = U[:, nrigid:]
+
+    nmodes = min(nmodes, ncart - nrigid)
+    evals, evecs = np.linalg.eigh(Q.T.dot(H0).dot(Q))
+    V = Q.dot(evecs[:, :nmodes])
+    core.print_out("""\n  Hessian of the %d lowest model modes (model force constants: %s)\n""" %
+                   (nmodes, ' '.join('%.4f' % e for e in evals[:nmodes])))
+
+    h = core.get_option('FINDIF', 'DISP_SIZE')
+    displacements = []
+    for i in range(nmodes):
+        for sign in (1.0, -1.0):
+            displacements.append(core.Matrix.from_array(geom + sign * h * V[:, i].reshape(natom, 3)))
+
+    moleculeclone = molecule.clone()
+    moleculeclone.reinterpret_coordentry(False)
+    moleculeclone.fix_orientation(True)
+    moleculeclone.fix_com(True)
+    core.set_parent_symmetry(molecule.schoenflies_symbol())
+
+    gradients = []
+    if opt_mode == 'farm':
+        for result in driver_farm.run_farm('gradient', lowername, moleculeclone, displacements, **kwargs):
+            gradients.append(np.array(result['gradient']).ravel())
+    else:
+        for n, displacement in enumerate(displacements):
+            core.print_out('\n')
+            p4util.banner('Loading subspace displacement %d of %d' % (n + 1, len(displacements)))
+            moleculeclone.set_geometry(displacement)
+            if (n > 0) and (not core.get_option('SCF', 'GUESS_PERSIST')):
+                core.set_local_option('SCF', 'GUESS', 'READ')
+            G, wfn = gradient(lowername, molecule=moleculeclone, return_wfn=True, **kwargs)
+            gradients.append(np.array(wfn.gradient()).ravel())
+            core.clean()
+    core.set_parent_symmetry('')
+
+    # H V = W along the modes; H0, projected off them, everywhere else
+    W = np.array([(gradients[2 * i] - gradients[2 * i + 1]) / (2.0 * h) for i in range(nmodes)]).T
+    S = V.T.dot(W)
+    S = 0.5 * (S + S.T)
+    P = np.eye(ncart) - V.dot(V.T)
+    H = P.dot(H0).dot(P) + W.dot(V.T) + V.dot(W.T) - V.dot(S).dot(V.T)
+    return 0.5 * (H + H.T)
+
+
+def _write_cartesian_hessian(molecule, H):
+    """Writes *H* as the .hess file that |optking__cart_hess_read| reads."""
+    natom = molecule.natom()
+    values = np.asarray(H).ravel()
+    with open(core.get_writer_file_prefix(molecule.name()) + '.hess', 'w') as handle:
+        handle.write('%5d%5d\n' % (natom, 6 * natom))
+        for start in range(0, len(values), 3):
+            handle.write(''.join('%20.10f' % v for v in values[start:start + 3]) + '\n')
+
+
 def optimize(name, **kwargs):
     r"""Function to perform a geometry optimization.
 
@@ -880,7 +1029,7 @@ def optimize(name, **kwargs):
         use keyword ``opt_func`` instead of ``func``.
 
     :type mode: string
-    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'``
+    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'`` || ``'farm'``
 
         For a finite difference of energies optimization, indicates whether
         the calculations required to complete the
@@ -889,6 +1038,10 @@ def optimize(name, **kwargs):
         (``'sow'``/``'reap'``). For the latter, run an initial job with
         ``'sow'`` and follow instructions in its output file. For maximum
         flexibility, ``return_wfn`` is always on in ``'reap'`` mode.
+        With ``'farm'``, the displacements of each step are run at once as
+        independent psi4 worker processes on this node, steered by the
+        ``farm_workers``, ``farm_threads``, ``farm_retries``, ``farm_command``,
+        and ``farm_keep`` keywords (see :py:func:`~psi4.driver.driver_farm.run_farm`).
 
     :type dertype: :ref:`dertype <op_py_dertype>`
     :param dertype: ``'gradient'`` || ``'energy'``
@@ -998,6 +1151,9 @@ def optimize(name, **kwargs):
 
     full_hess_every = core.get_option('OPTKING', 'FULL_HESS_EVERY')
     steps_since_last_hessian = 0
+    hess_subspace_modes = core.get_option('OPTKING', 'HESS_SUBSPACE_MODES')
+    # Latest Cartesian Hessian, the model for the next subspace Hessian
+    subspace_hessian = None
 
     if custom_gradient and core.has_option_changed('OPTKING', 'FULL_HESS_EVERY'):
         raise ValidationError("Optimize: Does not support custom Hessian's yet.")
@@ -1006,7 +1162,7 @@ def optimize(name, **kwargs):
 
     # are we in sow/reap mode?
     opt_mode = kwargs.get('mode', 'continuous').lower()
-    if opt_mode not in ['continuous', 'sow', 'reap']:
+    if opt_mode not in ['continuous', 'sow', 'reap', 'farm']:
         raise ValidationError("""Optimize execution mode '%s' not valid.""" % (opt_mode))
 
     optstash = p4util.OptionsState(
@@ -1086,7 +1242,16 @@ def optimize(name, **kwargs):
             G = core.get_gradient()  # TODO
             core.IOManager.shared_object().set_specific_retention(1, True)
             core.IOManager.shared_object().set_specific_path(1, './')
-            frequencies(hessian_with_method, **kwargs)
+            if hess_subspace_modes > 0:
+                core.set_legacy_molecule(moleculeclone)
+                if subspace_hessian is None:
+                    subspace_hessian = np.array(core.optking_model_hessian())
+                subspace_hessian = _subspace_hessian(hessian_with_method, moleculeclone, subspace_hessian,
+                                                     hess_subspace_modes, opt_mode, **kwargs)
+                _write_cartesian_hessian(moleculeclone, subspace_hessian)
+                core.set_variable('CURRENT ENERGY', thisenergy)
+            else:
+                frequencies(hessian_with_method, **kwargs)
             steps_since_last_hessian = 0
             core.set_gradient(G)
             core.set_global_option('CART_HESS_READ', True)
@@ -1223,6 +1388,7 @@ def hessian(name, **kwargs):
 
     optstash = p4util.OptionsState(
         ['FINDIF', 'HESSIAN_WRITE'],
+        ['SCF', 'GUESS'],
         )
 
     # Allow specification of methods to arbitrary order
@@ -1247,6 +1413,8 @@ def hessian(name, **kwargs):
         freq_linkage = kwargs.get('linkage', None)
         if freq_linkage is None:
             raise ValidationError("""Frequency execution mode 'reap' requires a linkage option.""")
+    elif freq_mode == 'farm':
+        pass
     else:
         raise ValidationError("""Frequency execution mode '%s' not valid.""" % (freq_mode))
 
@@ -1334,6 +1502,12 @@ def hessian(name, **kwargs):
                 fmaster.write(instructionsM.encode('utf-8'))
             core.print_out(instructionsM)
 
+        # Farm: run all displaced gradients at once as independent worker processes
+        elif freq_mode == 'farm':
+            for result in driver_farm.run_farm('gradient', lowername, moleculeclone, displacements, **kwargs):
+                gradients.append(core.Matrix.from_list(result['gradient']))
+                energies.append(result['energy'])
+
         for n, displacement in enumerate(displacements):
             rfile = 'FREQ-%s' % (n + 1)
 
@@ -1354,6 +1528,10 @@ def hessian(name, **kwargs):
                 # Load in displacement into the active molecule (xyz coordinates only)
                 moleculeclone.set_geometry(displacement)
 
+                # Start from the previous displacement's orbitals, projected onto this geometry
+                if (n > 0) and (not core.get_option('SCF', 'GUESS_PERSIST')):
+                    core.set_local_option('SCF', 'GUESS', 'READ')
+
                 # Perform the gradient calculation
                 G, wfn = gradient(lowername, molecule=moleculeclone, return_wfn=True, **kwargs)
                 gradients.append(wfn.gradient())
@@ -1398,7 +1576,7 @@ def hessian(name, **kwargs):
                 return (None, None)
             else:
                 return None
-        elif freq_mode == 'reap':
+        elif freq_mode in ['reap', 'farm']:
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
 
         # Assemble Hessian from gradients
@@ -1478,6 +1656,11 @@ def hessian(name, **kwargs):
                 fmaster.write(instructionsM.encode('utf-8'))
             core.print_out(instructionsM)
 
+        # Farm: run all displaced energies at once as independent worker processes
+        elif freq_mode == 'farm':
+            energies = [result['energy'] for result in
+                        driver_farm.run_farm('energy', lowername, moleculeclone, displacements, **kwargs)]
+
         for n, displacement in enumerate(displacements):
             rfile = 'FREQ-%s' % (n + 1)
 
@@ -1498,6 +1681,10 @@ def hessian(name, **kwargs):
                 # Load in displacement into the active molecule
                 moleculeclone.set_geometry(displacement)
 
+                # Start from the previous displacement's orbitals, projected onto this geometry
+                if (n > 0) and (not core.get_option('SCF', 'GUESS_PERSIST')):
+                    core.set_local_option('SCF', 'GUESS', 'READ')
+
                 # Perform the energy calculation
                 E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
                 energies.append(core.get_variable('CURRENT ENERGY'))
@@ -1533,7 +1720,7 @@ def hessian(name, **kwargs):
                 return (None, None)
             else:
                 return None
-        elif freq_mode == 'reap':
+        elif freq_mode in ['reap', 'farm']:
         #    core.set_variable('CURRENT ENERGY', energies[-1])
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
 
@@ -1592,7 +1779,7 @@ def frequency(name, **kwargs):
         use keyword ``freq_func`` instead of ``func``.
 
     :type mode: string
-    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'``
+    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'`` || ``'farm'``
 
         For a finite difference of energies or gradients frequency, indicates
         whether the calculations required to complete the frequency are to be run
@@ -1600,6 +1787,10 @@ def frequency(name, **kwargs):
         embarrassingly parallel fashion (``'sow'``/``'reap'``)/ For the latter,
         run an initial job with ``'sow'`` and follow instructions in its output file.
         For maximum flexibility, ``return_wfn`` is always on in ``'reap'`` mode.
+        With ``'farm'``, all displacements are run at once as independent psi4
+        worker processes on this node, steered by the ``farm_workers``,
+        ``farm_threads``, ``farm_retries``, ``farm_command``, and ``farm_keep``
+        keywords (see :py:func:`~psi4.driver.driver_farm.run_farm`).
 
     :type dertype: :ref:`dertype <op_py_dertype>`
     :param dertype: |dl| ``'hessian'`` |dr| || ``'gradient'`` || ``'energy'``
@@ -1669,7 +1860,7 @@ def frequency(name, **kwargs):
 
     # are we in sow/reap mode?
     freq_mode = kwargs.get('mode', 'continuous').lower()
-    if freq_mode not in ['continuous', 'sow', 'reap']:
+    if freq_mode not in ['continuous', 'sow', 'reap', 'farm']:
         raise ValidationError("""Frequency execution mode '%s' not valid.""" % (freq_mode))
 
     # Make sure the molecule the user provided is the active one
@@ -1699,6 +1890,78 @@ def frequency(name, **kwargs):
         return core.get_variable('CURRENT ENERGY')
 
 
+def vibanal_wfn(wfn, hess=None, molecule=None, scale=1.0, thermo=True):
+    r"""Function to redo the vibrational and thermochemical analysis of a
+    :py:func:`~psi4.frequency` or :py:func:`~psi4.hessian` run from its
+    stored Hessian, without any new energy or gradient computations.
+
+    :returns: :py:class:`~psi4.core.Vector` |w--w| Harmonic frequencies in cm^-1.
+
+    :type wfn: :py:class:`~psi4.core.Wavefunction`
+    :param wfn: The wavefunction returned (``return_wfn=True``) by the frequency run.
+
+    :type hess: :py:class:`~psi4.core.Matrix`
+    :param hess: |dl| ``wfn.hessian()`` |dr| || Cartesian Hessian
+
+        A full Cartesian Hessian in E_h/a0^2 (a partial, single-irrep Hessian will not do)
+        at the geometry of *molecule*.
+
+    :type molecule: :ref:`molecule <op_py_molecule>`
+    :param molecule: |dl| ``wfn.molecule()`` |dr| || ``d2o`` || etc.
+
+        The molecule to analyze, usually an isotopolog of ``wfn.molecule()``
+        (atoms relabeled with other masses) at the same Cartesian geometry.
+
+    :type scale: float
+    :param scale: |dl| ``1.0`` |dr| || ``0.9614`` || etc.
+
+        Scaling factor applied to all frequencies before the thermochemical analysis.
+
+    :type thermo: :ref:`boolean <op_py_boolean>`
+    :param thermo: |dl| ``'on'`` |dr| || ``'off'``
+
+        Whether to follow with a thermochemical analysis at the current
+        |thermo__t|, |thermo__p|, and |thermo__rotational_symmetry_number|.
+
+    :examples:
+
+    >>> # [1] Thermochemistry of water and heavy water from one Hessian
+    >>> e, wfn = frequency('scf', molecule=h2o, return_wfn=True)
+    >>> set t 400.0
+    >>> vibanal_wfn(wfn)
+    >>> d2o.set_geometry(h2o.geometry())
+    >>> vibanal_wfn(wfn, molecule=d2o)
+
+    """
+    if hess is None:
+        hess = wfn.hessian()
+    if hess is None:
+        raise ValidationError("vibanal_wfn: Wavefunction carries no Hessian; run frequency() or hessian() first.")
+
+    ref_molecule = wfn.molecule()
+    if molecule is None:
+        molecule = ref_molecule
+    molecule.update_geometry()
+
+    if molecule.natom() != ref_molecule.natom():
+        raise ValidationError("vibanal_wfn: Molecule has %d atoms, the Hessian's has %d." %
+                              (molecule.natom(), ref_molecule.natom()))
+    if not np.allclose(np.asarray(molecule.geometry()), np.asarray(ref_molecule.geometry()), atol=1.e-6):
+        raise ValidationError("vibanal_wfn: Molecule geometry differs from the one of the Hessian; "
+                              "set it with molecule.set_geometry(wfn.molecule().geometry()).")
+
+    freqs = proc_util.harmonic_frequencies(molecule, hess, scale)
+    freqs.print_out()
+
+    if thermo:
+        # thermo() takes the masses, symmetry, and rotational constants from the wavefunction's molecule
+        thermo_wfn = wfn if molecule is ref_molecule else core.Wavefunction(molecule, wfn.basisset())
+        core.set_variable('CURRENT ENERGY', wfn.energy())
+        core.thermo(thermo_wfn, freqs)
+
+    return freqs
+
+
 def gdma(wfn, datafile=""):
     """Function to use wavefunction information in *wfn* and, if specified,
     additional commands in *filename* to run GDMA analysis.
@@ -40,6 +40,7 @@ from psi4.driver import qcdb
 from psi4.driver import p4util
 from psi4.driver import driver_util
 from psi4.driver import constants
+from psi4.driver import driver_farm
 
 from psi4.driver.p4util.exceptions import *
 from psi4.driver.procrouting.interface_cfour import cfour_psivar_list
@@ -823,6 +824,23 @@ def cbs(func, label, **kwargs):
 
         The target molecule, if not the last molecule defined.
 
+    :type cbs_mode: string
+    :param cbs_mode: |dl| ``'continuous'`` |dr| || ``'farm'``
+
+        With ``'farm'``, the computations are independent of each other and
+        all run at once as psi4 worker processes on this node, sized by the
+        ``farm_workers``, ``farm_threads``, and ``farm_memory`` keywords
+        (see :py:func:`~psi4.driver.driver_farm.run_farm`).
+
+    :type cbs_share_scf: :ref:`boolean <op_py_boolean>`
+    :param cbs_share_scf: |dl| ``'on'`` |dr| || ``'off'``
+
+        In ``'continuous'`` mode, converge the SCF of a basis set once and
+        hand it to every correlated computation in that basis as its
+        reference. This applies to energies with an RHF or UHF reference,
+        and only when |scf__scf_type| has been set, as some methods
+        otherwise choose their own SCF algorithm.
+
     :examples:
 
 
@@ -856,10 +874,14 @@ def cbs(func, label, **kwargs):
     return_wfn = kwargs.pop('return_wfn', False)
     verbose = kwargs.pop('verbose', 0)
     ptype = kwargs.pop('ptype')
+    cbs_mode = kwargs.pop('cbs_mode', 'continuous').lower()
+    share_scf = kwargs.pop('cbs_share_scf', True)
 
     # Establish function to call (only energy makes sense for cbs)
     if ptype not in ['energy', 'gradient', 'hessian']:
         raise ValidationError("""Wrapper complete_basis_set is unhappy to be calling function '%s' instead of 'energy'.""" % ptype)
+    if cbs_mode not in ['continuous', 'farm']:
+        raise ValidationError("""Wrapper complete_basis_set does not recognize cbs_mode '%s'.""" % cbs_mode)
 
     optstash = p4util.OptionsState(
         ['BASIS'],
@@ -1238,6 +1260,19 @@ def cbs(func, label, **kwargs):
     for mc in JOBS_EXT:
         instructions += """   %12s / %-24s for  %s%s\n""" % \
             (mc['f_wfn'], mc['f_basis'], VARH[mc['f_wfn']][mc['f_wfn']], addlremark[ptype])
+
+    #     Jobs in a shared basis depend on its SCF, all others are independent
+    shared_scf = set()
+    if cbs_mode == 'continuous' and share_scf and 'ref_wfn' not in kwargs:
+        shared_scf = _cbs_shared_scf_bases(JOBS, ptype)
+        # Producing SCF jobs go first
+        JOBS.sort(key=lambda job: not (job['f_basis'] in shared_scf and _cbs_is_scf(job['f_wfn'])))
+    if shared_scf:
+        instructions += """\n    Computations sharing one SCF reference.\n"""
+        for basis in sorted(shared_scf):
+            instructions += """   %12s / %-24s to   %s\n""" % \
+                ('hf', basis, ', '.join(job['f_wfn'] for job in JOBS
+                                        if job['f_basis'] == basis and not _cbs_is_scf(job['f_wfn'])))
     core.print_out(instructions)
 
     psioh = core.IOManager.shared_object()
@@ -1247,61 +1282,82 @@ def cbs(func, label, **kwargs):
     core.set_local_option('SCF', 'GUESS_PERSIST', True)
 
     Njobs = 0
-    # Run necessary computations
-    for mc in JOBS:
-        kwargs['name'] = mc['f_wfn']
-
-        # Build string of title banner
-        cbsbanners = ''
-        cbsbanners += """core.print_out('\\n')\n"""
-        cbsbanners += """p4util.banner(' CBS Computation: %s / %s%s ')\n""" % \
-            (mc['f_wfn'].upper(), mc['f_basis'].upper(), addlremark[ptype])
-        cbsbanners += """core.print_out('\\n')\n\n"""
-        exec(cbsbanners)
-
-        # Build string of molecule and commands that are dependent on the database
-        commands = '\n'
-        commands += """\ncore.set_global_option('BASIS', '%s')\n""" % (mc['f_basis'])
-        commands += """core.set_global_option('WRITER_FILE_LABEL', '%s')\n""" % \
-            (user_writer_file_label + ('' if user_writer_file_label == '' else '-') + mc['f_wfn'].lower() + '-' + mc['f_basis'].lower())
-        exec(commands)
-
-        # Make energy(), etc. call
-        response = func(molecule=molecule, **kwargs)
-        if ptype == 'energy':
-            mc['f_energy'] = response
-        elif ptype == 'gradient':
-            mc['f_gradient'] = response
-            mc['f_energy'] = core.get_variable('CURRENT ENERGY')
-            if verbose > 1:
-                mc['f_gradient'].print_out()
-        elif ptype == 'hessian':
-            mc['f_hessian'] = response
-            mc['f_energy'] = core.get_variable('CURRENT ENERGY')
+    shared_ref = {}
+    if cbs_mode == 'farm':
+        Njobs = _cbs_run_farm(JOBS, JOBS_EXT, ptype, molecule, user_writer_file_label, **kwargs)
+    else:
+        # Run necessary computations
+        for mc in JOBS:
+            kwargs['name'] = mc['f_wfn']
+            job_kwargs = {'molecule': molecule}
+
+            # Build string of title banner
+            cbsbanners = ''
+            cbsbanners += """core.print_out('\\n')\n"""
+            cbsbanners += """p4util.banner(' CBS Computation: %s / %s%s ')\n""" % \
+                (mc['f_wfn'].upper(), mc['f_basis'].upper(), addlremark[ptype])
+            cbsbanners += """core.print_out('\\n')\n\n"""
+            exec(cbsbanners)
+
+            # Build string of molecule and commands that are dependent on the database
+            commands = '\n'
+            commands += """\ncore.set_global_option('BASIS', '%s')\n""" % (mc['f_basis'])
+            commands += """core.set_global_option('WRITER_FILE_LABEL', '%s')\n""" % \
+                (user_writer_file_label + ('' if user_writer_file_label == '' else '-') + mc['f_wfn'].lower() + '-' + mc['f_basis'].lower())
+            exec(commands)
+
+            # A consumer of a shared SCF converges it first if no SCF job of its basis has
+            if mc['f_basis'] in shared_scf and not _cbs_is_scf(mc['f_wfn']):
+                if mc['f_basis'] not in shared_ref:
+                    core.print_out("""\n  CBS: converging the SCF shared by the %s computations.\n""" % (mc['f_basis'].upper()))
+                    scf_kwargs = dict(kwargs, name='hf', return_wfn=True)
+                    shared_ref[mc['f_basis']] = _CBSSharedReference(func(molecule=molecule, **scf_kwargs)[1])
+                    core.clean_variables()
+                    core.clean()
+                shared_ref[mc['f_basis']].restore()
+                job_kwargs['ref_wfn'] = shared_ref[mc['f_basis']].wfn
+            elif mc['f_basis'] in shared_scf:
+                job_kwargs['return_wfn'] = True
+
+            # Make energy(), etc. call
+            response = func(**dict(kwargs, **job_kwargs))
+            if job_kwargs.get('return_wfn', False):
+                response, scf_wfn = response
+                shared_ref[mc['f_basis']] = _CBSSharedReference(scf_wfn)
+            if ptype == 'energy':
+                mc['f_energy'] = response
+            elif ptype == 'gradient':
+                mc['f_gradient'] = response
+                mc['f_energy'] = core.get_variable('CURRENT ENERGY')
+                if verbose > 1:
+                    mc['f_gradient'].print_out()
+            elif ptype == 'hessian':
+                mc['f_hessian'] = response
+                mc['f_energy'] = core.get_variable('CURRENT ENERGY')
+                if verbose > 1:
+                    mc['f_hessian'].print_out()
+            Njobs += 1
             if verbose > 1:
-                mc['f_hessian'].print_out()
-        Njobs += 1
-        if verbose > 1:
-            core.print_out("\nCURRENT ENERGY: %14.16f\n" % mc['f_energy'])
+                core.print_out("\nCURRENT ENERGY: %14.16f\n" % mc['f_energy'])
 
-        # Fill in energies for subsumed methods
-        if ptype == 'energy':
-            for wfn in VARH[mc['f_wfn']]:
-                for job in JOBS_EXT:
-                    if (wfn == job['f_wfn']) and (mc['f_basis'] == job['f_basis']):
-                        job['f_energy'] = core.get_variable(VARH[wfn][wfn])
+            # Fill in energies for subsumed methods
+            if ptype == 'energy':
+                for wfn in VARH[mc['f_wfn']]:
+                    for job in JOBS_EXT:
+                        if (wfn == job['f_wfn']) and (mc['f_basis'] == job['f_basis']):
+                            job['f_energy'] = core.get_variable(VARH[wfn][wfn])
 
-        if verbose > 1:
-            core.print_variables()
-        core.clean_variables()
-        core.clean()
+            if verbose > 1:
+                core.print_variables()
+            core.clean_variables()
+            core.clean()
 
-        # Copy data from 'run' to 'obtained' table
-        for mce in JOBS_EXT:
-            if (mc['f_wfn'] == mce['f_wfn']) and (mc['f_basis'] == mce['f_basis']):
-                mce['f_energy'] = mc['f_energy']
-                mce['f_gradient'] = mc['f_gradient']
-                mce['f_hessian'] = mc['f_hessian']
+            # Copy data from 'run' to 'obtained' table
+            for mce in JOBS_EXT:
+                if (mc['f_wfn'] == mce['f_wfn']) and (mc['f_basis'] == mce['f_basis']):
+                    mce['f_energy'] = mc['f_energy']
+                    mce['f_gradient'] = mc['f_gradient']
+                    mce['f_hessian'] = mc['f_hessian']
 
     psioh.set_specific_retention(constants.PSIF_SCF_MOS, False)
 
@@ -1450,6 +1506,93 @@ def cbs(func, label, **kwargs):
         return finalquantity
 
 
+def _cbs_is_scf(wfn):
+    """Is *wfn* a bare SCF method, one no other job can hand a reference to?"""
+    return wfn in ['hf', 'scf', 'c4-hf', 'c4-scf']
+
+
+def _cbs_shared_scf_bases(jobs, ptype):
+    """Returns the set of basis sets whose single SCF can serve all of
+    *jobs* in that basis. A basis qualifies when it has an SCF job and a
+    correlated one, or two correlated ones (then the SCF is run first).
+
+    """
+    if ptype != 'energy':
+        return set()
+    if core.get_option('SCF', 'REFERENCE') not in ['RHF', 'UHF']:
+        return set()
+    # Left at its default, SCF_TYPE is chosen by the correlated method itself
+    if not core.has_option_changed('SCF', 'SCF_TYPE'):
+        return set()
+
+    consumers = {}
+    producers = set()
+    for job in jobs:
+        if job['f_wfn'].startswith('c4-'):
+            continue
+        if _cbs_is_scf(job['f_wfn']):
+            producers.add(job['f_basis'])
+        else:
+            consumers[job['f_basis']] = consumers.get(job['f_basis'], 0) + 1
+
+    return set(basis for basis, count in consumers.items() if count > 1 or basis in producers)
+
+
+class _CBSSharedReference(object):
+    """An SCF wavefunction reused as ref_wfn, with its converged orbitals,
+    densities, Fock matrices and PSI variables kept aside. Some correlated
+    methods (e.g., orbital-optimized ones) write into the reference they are
+    given, restore() puts it back before the next one.
+
+    """
+    def __init__(self, wfn):
+        self.wfn = wfn
+        self.variables = dict(core.get_variables())
+        self.saved = []
+        for data in [wfn.Ca(), wfn.Cb(), wfn.Da(), wfn.Db(), wfn.Fa(), wfn.Fb(), wfn.epsilon_a(), wfn.epsilon_b()]:
+            if data is not None:
+                self.saved.append((data, [np.array(block) for block in data.nph]))
+
+    def restore(self):
+        for data, blocks in self.saved:
+            for block, saved in zip(data.nph, blocks):
+                block[...] = saved
+        for key, val in self.variables.items():
+            core.set_variable(key, val)
+
+
+def _cbs_run_farm(jobs, jobs_ext, ptype, molecule, user_writer_file_label, **kwargs):
+    """Runs every one of *jobs* on the psi4 worker farm and fills in their
+    results and those of the methods they subsume in *jobs_ext*. Returns
+    the number of jobs run.
+
+    """
+    # cbs() keywords and schemes are for this process only
+    cbs_suffixes = ('_wfn', '_wfn_lesser', '_basis', '_scheme')
+    worker_kwargs = dict((k, v) for k, v in kwargs.items() if k != 'name' and not k.endswith(cbs_suffixes))
+
+    names = [job['f_wfn'] for job in jobs]
+    options = []
+    for job in jobs:
+        options.append({'BASIS': job['f_basis'],
+                        'WRITER_FILE_LABEL': user_writer_file_label + ('' if user_writer_file_label == '' else '-') +
+                                             job['f_wfn'].lower() + '-' + job['f_basis'].lower()})
+    results = driver_farm.run_farm_molecules(ptype, names, [molecule] * len(jobs), 'CBS', 'Job',
+                                             options=options, **worker_kwargs)
+
+    for job, result in zip(jobs, results):
+        for mce in jobs_ext:
+            if mce['f_basis'] != job['f_basis']:
+                continue
+            if mce['f_wfn'] == job['f_wfn']:
+                mce['f_energy'] = result['energy']
+                if ptype == 'gradient':
+                    mce['f_gradient'] = core.Matrix.from_array(np.array(result['gradient']))
+            elif ptype == 'energy' and mce['f_wfn'] in VARH[job['f_wfn']]:
+                mce['f_energy'] = result['variables'].get(VARH[mce['f_wfn']][mce['f_wfn']], 0.0)
+    return len(jobs)
+
+
 _lmh_labels = {1: ['HI'],
                2: ['LO', 'HI'],
                3: ['LO', 'MD', 'HI'],
@@ -0,0 +1,242 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2017 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+
+"""Concurrent execution of independent calculations as psi4 worker
+processes: the finite difference displacements of ``mode='farm'`` in
+gradient() and hessian(), and the n-body complexes of ``nbody_mode='farm'``.
+
+"""
+from __future__ import print_function
+from __future__ import absolute_import
+import os
+import sys
+import json
+import time
+import pickle
+import subprocess
+from distutils import spawn
+
+from psi4 import core
+from psi4.driver import p4util
+from psi4.driver.p4util.exceptions import *
+
+# kwargs that steer the farm itself and must not reach the workers
+_farm_kwargs = ['mode', 'linkage', 'nbody_mode', 'farm_workers', 'farm_threads', 'farm_memory',
+                'farm_retries', 'farm_command', 'farm_keep']
+
+
+def _farm_command(kwargs):
+    """Returns the command, as a list, that starts one psi4 worker."""
+    command = kwargs.get('farm_command', None)
+    if command is None:
+        # Prefer the psi4 running this job, so workers are the same build
+        if os.path.basename(sys.argv[0]) == 'psi4' and os.path.isfile(sys.argv[0]):
+            command = [sys.executable, os.path.abspath(sys.argv[0])]
+        else:
+            command = spawn.find_executable('psi4')
+        if command is None:
+            raise ValidationError("""Finite difference mode 'farm' cannot find a psi4 executable. Give one with farm_command.""")
+    if isinstance(command, str):
+        command = command.split()
+    return list(command)
+
+
+def _write_worker_input(filename, resultfile, ptype, lowername, molecule, nthread, memory, forcexyz, options,
+                        **kwargs):
+    """Writes the input for one task, which saves its results as JSON in
+    *resultfile* rather than in formatted output lines. *options* holds
+    global options set for this task only.
+
+    """
+    with open(filename, 'w') as freagent:
+        freagent.write('# This is a psi4 input file auto-generated from the %s() psi4 worker farm.\n\n' % (ptype))
+        freagent.write(p4util.format_molecule_for_input(molecule, forcexyz=forcexyz))
+        freagent.write(p4util.format_options_for_input(molecule, **kwargs))
+        for key, val in sorted(options.items()):
+            freagent.write("""core.set_global_option('%s', %r)\n""" % (key, val))
+        freagent.write("""core.set_memory_bytes(%d)\n""" % (memory))
+        freagent.write("""core.set_num_threads(%d, quiet=True)\n\n""" % (nthread))
+        freagent.write("""import json\nimport pickle\n""")
+        freagent.write("""kwargs = pickle.loads(%r)\n\n""" % (pickle.dumps(kwargs, 0)))
+        if ptype == 'gradient':
+            freagent.write("""G, wfn = gradient('%s', return_wfn=True, **kwargs)\n""" % (lowername))
+            freagent.write("""result = {'energy': get_variable('CURRENT ENERGY'), 'gradient': p4util.mat2arr(wfn.gradient())}\n""")
+        else:
+            freagent.write("""energy('%s', **kwargs)\n""" % (lowername))
+            freagent.write("""result = {'energy': get_variable('CURRENT ENERGY')}\n""")
+        freagent.write("""result['variables'] = dict(core.get_variables())\n""")
+        freagent.write("""with open('%s', 'w') as handle:\n    json.dump(result, handle)\n""" % (resultfile))
+
+
+def run_farm(ptype, lowername, molecule, displacements, **kwargs):
+    r"""Computes *ptype* (``'energy'`` or ``'gradient'``) of *lowername* at
+    each of the *displacements* of *molecule* in concurrent psi4 worker
+    processes and returns their results in displacement order, each a
+    dictionary with ``'energy'`` and, for gradients, ``'gradient'`` (as a
+    list of lists).
+
+    :type farm_workers: int
+    :param farm_workers: Number of workers run at once. Defaults to as many
+        as fit the threads and memory of this process at the per-worker
+        ``farm_threads`` and ``farm_memory``, else to the number of threads.
+
+    :type farm_threads: int
+    :param farm_threads: Threads given to each worker. Defaults to sharing
+        this process's threads out evenly, at least one each.
+
+    :type farm_memory: int or str
+    :param farm_memory: Memory given to each worker, as for
+        :py:func:`~psi4.driver.p4util.util.set_memory`. Defaults to sharing
+        this process's memory out evenly.
+
+    :type farm_retries: int
+    :param farm_retries: Number of times a failed displacement is rerun
+        before the farm gives up. Defaults to 1.
+
+    :type farm_command: string or list
+    :param farm_command: Command that starts psi4. Defaults to the
+        ``psi4`` running this job, else the one found on :envvar:`PATH`.
+
+    :type farm_keep: bool
+    :param farm_keep: Keep the input, output, and result files of displacements
+        that succeeded. Those of failed displacements are always kept.
+
+    """
+    molecules = []
+    for displacement in displacements:
+        moleculeclone = molecule.clone()
+        moleculeclone.set_geometry(displacement)
+        molecules.append(moleculeclone)
+
+    return run_farm_molecules(ptype, lowername, molecules, 'Finite difference', 'Displacement',
+                              forcexyz=True, **kwargs)
+
+
+def run_farm_molecules(ptype, lowername, molecules, farm_label, task_label, forcexyz=False, options=None, **kwargs):
+    """Computes *ptype* of *lowername* for each of *molecules* in concurrent
+    psi4 worker processes and returns their results in order, as for
+    :py:func:`run_farm`, which documents the ``farm_*`` keywords. Each
+    result also carries the worker's PSI variables under ``'variables'``.
+
+    The labels name the farm and its tasks in the output, and *forcexyz*
+    writes each molecule as bare Cartesians (which drops ghost atoms'
+    elements). *lowername* and *options* (dictionaries of global options)
+    may be lists with one entry per molecule.
+
+    """
+    if ptype not in ['energy', 'gradient']:
+        raise ValidationError("""%s farm: ptype '%s' cannot be run by the farm.""" % (farm_label, ptype))
+
+    command = _farm_command(kwargs)
+    ntask = len(molecules)
+    nthread_total = core.get_num_threads()
+    nthread = kwargs.get('farm_threads', None)
+    memory = kwargs.get('farm_memory', None)
+    if memory is not None:
+        memory = p4util.set_memory(memory, execute=False)
+
+    # Workers are sized by their per-task budget unless given outright
+    if 'farm_workers' in kwargs:
+        nworkers = int(kwargs['farm_workers'])
+    else:
+        nworkers = nthread_total // int(nthread) if nthread else nthread_total
+        if memory:
+            nworkers = min(nworkers, core.get_memory() // memory)
+    nworkers = max(1, min(nworkers, ntask))
+    nthread = int(nthread) if nthread else max(1, nthread_total // nworkers)
+    memory = int(memory) if memory else core.get_memory() // nworkers
+    retries = int(kwargs.get('farm_retries', 1))
+    keep = kwargs.get('farm_keep', False)
+
+    worker_kwargs = dict((k, v) for k, v in kwargs.items() if k not in _farm_kwargs)
+
+    core.print_out("""\n  %s farm: %d %s tasks, %d workers of %d threads and %d MiB each.\n\n""" %
+                   (farm_label, ntask, ptype, nworkers, nthread, memory // (1024 * 1024)))
+
+    # Write every input up front
+    prefix = 'FARM-%d-' % (os.getpid())
+    files = []
+    if not isinstance(lowername, list):
+        lowername = [lowername] * ntask
+    if not isinstance(options, list):
+        options = [options or {}] * ntask
+    for n, molecule in enumerate(molecules):
+        names = (prefix + '%d.in' % (n + 1), prefix + '%d.out' % (n + 1), prefix + '%d.json' % (n + 1))
+        _write_worker_input(names[0], names[2], ptype, lowername[n], molecule, nthread, memory, forcexyz, options[n],
+                            **worker_kwargs)
+        files.append(names)
+
+    results = [None] * ntask
+    attempts = [0] * ntask
+    pending = list(range(ntask))
+    running = {}
+    failed = []
+    while pending or running:
+        while pending and len(running) < nworkers:
+            n = pending.pop(0)
+            attempts[n] += 1
+            if os.path.isfile(files[n][2]):
+                os.remove(files[n][2])
+            running[n] = subprocess.Popen(command + ['-n', str(nthread), '-i', files[n][0], '-o', files[n][1]])
+
+        time.sleep(0.05)
+        for n, proc in list(running.items()):
+            if proc.poll() is None:
+                continue
+            del running[n]
+
+            result = None
+            if proc.returncode == 0 and os.path.isfile(files[n][2]):
+                try:
+                    with open(files[n][2], 'r') as handle:
+                        result = json.load(handle)
+                except ValueError:
+                    result = None
+
+            if result is not None:
+                results[n] = result
+                core.print_out("""    %s %4d: %20.12f\n""" % (task_label, n + 1, result['energy']))
+            elif attempts[n] <= retries:
+                core.print_out("""    %s %4d: worker failed (exit %d), rerunning.\n""" % (task_label, n + 1, proc.returncode))
+                pending.append(n)
+            else:
+                core.print_out("""    %s %4d: worker failed (exit %d), see %s.\n""" %
+                               (task_label, n + 1, proc.returncode, files[n][1]))
+                failed.append(n + 1)
+
+    if failed:
+        raise ValidationError("""%s farm: tasks %s failed after %d attempts.""" %
+                              (farm_label, ', '.join(str(n) for n in sorted(failed)), retries + 1))
+
+    if not keep:
+        for names in files:
+            for name in names:
+                if os.path.isfile(name):
+                    os.remove(name)
+
+    return results
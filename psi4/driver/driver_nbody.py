@@ -38,6 +38,8 @@ from psi4 import core
 # Import driver helpers
 from psi4.driver import p4util
 from psi4.driver import constants
+from psi4.driver import driver_farm
+from psi4.driver.procrouting import proc_util
 
 from psi4.driver.p4util.exceptions import *
 
@@ -166,6 +168,15 @@ def nbody_gufunc(func, method_string, **kwargs):
 
         If True returns the total data (energy/gradient/etc) of the system,
         otherwise returns interaction data.
+
+    :type nbody_mode: string
+    :param nbody_mode: |dl| ``'continuous'`` |dr| || ``'farm'``
+
+        With ``'farm'``, all complexes are run at once
+        as independent psi4 worker processes on this node, sized by the
+        ``farm_workers``, ``farm_threads``, and ``farm_memory`` keywords
+        (see :py:func:`~psi4.driver.driver_farm.run_farm`). The summation is
+        the same as for ``'continuous'``.
     """
 
     ### ==> Parse some kwargs <==
@@ -173,12 +184,15 @@ def nbody_gufunc(func, method_string, **kwargs):
     return_wfn = kwargs.pop('return_wfn', False)
     ptype = kwargs.pop('ptype', None)
     return_total_data = kwargs.pop('return_total_data', False)
+    nbody_mode = kwargs.pop('nbody_mode', 'continuous').lower()
     molecule = kwargs.pop('molecule', core.get_active_molecule())
     molecule.update_geometry()
     core.clean_variables()
 
     if ptype not in ['energy', 'gradient', 'hessian']:
         raise ValidationError("""N-Body driver: The ptype '%s' is not regonized.""" % ptype)
+    if nbody_mode not in ['continuous', 'farm']:
+        raise ValidationError("""N-Body driver: The nbody_mode '%s' is not recognized.""" % nbody_mode)
 
     # Figure out BSSE types
     do_cp = False
@@ -291,25 +305,54 @@ def nbody_gufunc(func, method_string, **kwargs):
     # Now compute the energies
     energies_dict = {}
     ptype_dict = {}
-    for n in compute_list.keys():
-        core.print_out("\n   ==> N-Body: Now computing %d-body complexes <==\n\n" % n)
-        total = len(compute_list[n])
-        for num, pair in enumerate(compute_list[n]):
-            core.print_out("\n       N-Body: Computing complex (%d/%d) with fragments %s in the basis of fragments %s.\n\n" %
-                                                                    (num + 1, total, str(pair[0]), str(pair[1])))
-            ghost = list(set(pair[1]) - set(pair[0]))
-
-            current_mol = molecule.extract_subsets(list(pair[0]), ghost)
-            ptype_dict[pair] = func(method_string, molecule=current_mol, **kwargs)
-            energies_dict[pair] = core.get_variable("CURRENT ENERGY")
-            core.print_out("\n       N-Body: Complex Energy (fragments = %s, basis = %s: %20.14f)\n" %
-                                                                (str(pair[0]), str(pair[1]), energies_dict[pair]))
-
-            # Flip this off for now, needs more testing
-            #if 'cp' in bsse_type_list and (len(bsse_type_list) == 1):
-            #    core.set_global_option('DF_INTS_IO', 'LOAD')
-
-            core.clean()
+    if nbody_mode == 'farm':
+        # Every complex is independent of the others, so all levels go to the farm at once.
+        # The sets have no order, fix one so the results map back to their complexes.
+        core.print_out("\n   ==> N-Body: Now computing all complexes on the farm <==\n\n")
+        pairs = [pair for n in compute_list.keys() for pair in sorted(compute_list[n])]
+        for num, pair in enumerate(pairs):
+            core.print_out("       N-Body: Complex %d/%d has fragments %s in the basis of fragments %s.\n" %
+                                                                (num + 1, len(pairs), str(pair[0]), str(pair[1])))
+        molecules = [molecule.extract_subsets(list(pair[0]), list(set(pair[1]) - set(pair[0]))) for pair in pairs]
+        results = driver_farm.run_farm_molecules(ptype, method_string.lower(), molecules, 'N-Body', 'Complex',
+                                                 **kwargs)
+        for pair, result in zip(pairs, results):
+            energies_dict[pair] = result['energy']
+            if ptype == 'energy':
+                ptype_dict[pair] = result['energy']
+            else:
+                ptype_dict[pair] = core.Matrix.from_array(np.array(result[ptype]))
+
+    else:
+        # Converged monomer orbitals, the guess of every larger complex
+        fragment_orbitals = {}
+
+        for n in compute_list.keys():
+            core.print_out("\n   ==> N-Body: Now computing %d-body complexes <==\n\n" % n)
+            total = len(compute_list[n])
+            for num, pair in enumerate(compute_list[n]):
+                core.print_out("\n       N-Body: Computing complex (%d/%d) with fragments %s in the basis of fragments %s.\n\n" %
+                                                                        (num + 1, total, str(pair[0]), str(pair[1])))
+                ghost = list(set(pair[1]) - set(pair[0]))
+
+                current_mol = molecule.extract_subsets(list(pair[0]), ghost)
+                guess = [fragment_orbitals.get(((frag,), pair[1]), fragment_orbitals.get(((frag,), (frag,))))
+                         for frag in pair[0]]
+                if (len(pair[0]) > 1) and all(guess):
+                    kwargs['fragment_guess'] = guess
+                ptype_dict[pair], wfn = func(method_string, molecule=current_mol, return_wfn=True, **kwargs)
+                kwargs.pop('fragment_guess', None)
+                energies_dict[pair] = core.get_variable("CURRENT ENERGY")
+                if (len(pair[0]) == 1) and (wfn is not None) and (wfn.Ca() is not None):
+                    fragment_orbitals[pair] = proc_util.fragment_orbitals(wfn)
+                core.print_out("\n       N-Body: Complex Energy (fragments = %s, basis = %s: %20.14f)\n" %
+                                                                    (str(pair[0]), str(pair[1]), energies_dict[pair]))
+
+                # Flip this off for now, needs more testing
+                #if 'cp' in bsse_type_list and (len(bsse_type_list) == 1):
+                #    core.set_global_option('DF_INTS_IO', 'LOAD')
+
+                core.clean()
 
     # Final dictionaries
     cp_energy_by_level   = {n: 0.0 for n in nbody_range}
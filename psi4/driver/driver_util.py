@@ -40,7 +40,7 @@ def _method_exists(ptype, method_name):
     r"""
     Quick check to see if this method exists, if it does not exist we raise a convenient flag.
     """
-    if method_name not in procedures[ptype].keys():
+    if method_name not in procedures[ptype]:
         alternatives = ""
         alt_method_name = p4util.text.find_approximate_string_matches(method_name,
                                                                 procedures[ptype].keys(), 2)
@@ -40,6 +40,8 @@ import json
 import uuid
 import copy
 import os
+import sys
+import socket
 
 
 methods_dict = {
@@ -238,3 +240,120 @@ def run_json(json_data):
 
     return json_data
 
+
+def _reset_between_jobs(baseline):
+    """Puts the process back into the state it was in before the first job
+    of run_json_server(), keeping what is expensive to rebuild (imports,
+    parsed basis set files, the OpenMP and BLAS thread pools).
+
+    """
+    core.clean()
+    core.clean_options()
+    core.clean_variables()
+    core.set_memory_bytes(baseline["memory"], True)
+    core.set_num_threads(baseline["nthread"], quiet=True)
+    core.IOManager.shared_object().set_default_path(baseline["scratch"])
+    core.set_output_file(baseline["output"], True)
+
+
+def _serve_stream(instream, outstream, baseline):
+    """Runs each line of *instream* as a run_json() job and writes each result
+    as a line of *outstream*. Returns True when a shutdown request was read,
+    False at the end of the stream.
+
+    """
+    for line in iter(instream.readline, ''):
+        if not line.strip():
+            continue
+
+        try:
+            json_data = json.loads(line)
+        except ValueError as error:
+            json_data = {"success": False, "error": "Invalid JSON job: %s" % repr(error)}
+        else:
+            if json_data.get("shutdown", False):
+                outstream.write(json.dumps({"success": True, "shutdown": True}) + "\n")
+                outstream.flush()
+                return True
+            run_json(json_data)
+            _reset_between_jobs(baseline)
+
+        try:
+            reply = json.dumps(json_data)
+        except (TypeError, ValueError) as error:
+            reply = json.dumps({"success": False, "error": "Result could not be serialized: %s" % repr(error)})
+        outstream.write(reply + "\n")
+        outstream.flush()
+
+    return False
+
+
+def run_json_server(address="-", output="json_server.log"):
+    """
+    Runs JSON jobs one after another in this process, so the cost of starting
+    Psi4 (imports, the core module, basis set library reads, thread pools) is
+    paid once rather than per calculation.
+
+    Parameters
+    ----------
+    address : str
+        Where jobs come from. ``"-"`` reads them from stdin and writes results
+        to stdout. ``"host:port"`` listens on that TCP port, anything else is
+        taken as the path of a UNIX socket to create. Connections are served
+        one at a time, each may send any number of jobs.
+    output : str
+        File that collects the Psi4 output of the jobs that did not ask for
+        their own with ``return_output``.
+
+    Notes
+    -----
+    The protocol is one JSON object per line in each direction. Every job is
+    the input of :py:func:`run_json` and is answered with its completed
+    output. A line ``{"shutdown": true}`` stops the server.
+
+    Between jobs the scratch files, options, and PSI variables are cleaned,
+    and memory, threads, and the scratch path are set back to the values the
+    server started with.
+    """
+
+    core.set_output_file(output, False)
+    baseline = {
+        "memory": core.get_memory(),
+        "nthread": core.get_num_threads(),
+        "scratch": core.IOManager.shared_object().get_default_path(),
+        "output": output,
+    }
+
+    if address == "-":
+        _serve_stream(sys.stdin, sys.stdout, baseline)
+        return
+
+    if ":" in address:
+        host, port = address.rsplit(":", 1)
+        server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        server.bind((host, int(port)))
+    else:
+        if os.path.exists(address):
+            os.unlink(address)
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        server.bind(address)
+
+    # Psi4 runs one calculation at a time, so do the connections
+    server.listen(1)
+    try:
+        shutdown = False
+        while not shutdown:
+            connection, _ = server.accept()
+            instream = connection.makefile("r")
+            outstream = connection.makefile("w")
+            try:
+                shutdown = _serve_stream(instream, outstream, baseline)
+            finally:
+                instream.close()
+                outstream.close()
+                connection.close()
+    finally:
+        server.close()
+        if ":" not in address and os.path.exists(address):
+            os.unlink(address)
@@ -64,7 +64,7 @@ def _find_dim(arr, ndim):
         raise ValidationError("Input array does not have a valid shape.")
 
 
-def array_to_matrix(self, arr, name="New Matrix", dim1=None, dim2=None):
+def array_to_matrix(self, arr, name="New Matrix", dim1=None, dim2=None, copy=True):
     """
     Converts a numpy array or list of numpy arrays into a Psi4 Matrix (irreped if list).
 
@@ -81,6 +81,11 @@ def array_to_matrix(self, arr, name="New Matrix", dim1=None, dim2=None):
         dimension.
     dim2 :
         Same as dim1 only if using a Psi4.Dimension object.
+    copy : bool
+        Copy the data if True. Otherwise the new core.Matrix works on the
+        memory of the arrays themselves, which must then be C-contiguous
+        float64 arrays; one per irrep if irreps are wanted, as dim1/dim2
+        cannot be used. Only available for core.Matrix.
 
     Returns
     -------
@@ -101,11 +106,28 @@ def array_to_matrix(self, arr, name="New Matrix", dim1=None, dim2=None):
     >>> matrix = array_to_matrix(irrep_data)
     >>> print matrix.rowspi().to_tuple()
     (2, 0, 4)
+
+    >>> data = np.zeros((20, 20))
+    >>> matrix = core.Matrix.from_array(data, copy=False)
+    >>> matrix.set(0, 0, 1.0)
+    >>> print data[0, 0]
+    1.0
     """
 
     # What type is it? MRO can help.
     arr_type = self.__mro__[0]
 
+    # Views of the passed in memory
+    if not copy:
+        if arr_type != core.Matrix:
+            raise ValidationError("Array_to_Matrix: copy=False is only available for core.Matrix.")
+        if (dim1 is not None) or (dim2 is not None):
+            raise ValidationError("Array_to_Matrix: copy=False cannot be combined with dim1/dim2, pass a list of arrays.")
+
+        if isinstance(arr, (list, tuple)):
+            return self.from_buffer(list(arr), name)
+        return self.from_buffer(arr, name)
+
     # Irreped case
     if isinstance(arr, (list, tuple)):
         if (dim1 is not None) or (dim2 is not None):
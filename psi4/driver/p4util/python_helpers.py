@@ -33,6 +33,7 @@ import uuid
 import numpy as np
 
 from . import optproc
+from .exceptions import *
 from psi4.driver import qcdb
 from psi4 import core
 
@@ -170,6 +171,106 @@ def pybuild_JK(orbital_basis, aux=None, jk_type=None):
 
 core.JK.build = pybuild_JK
 
+## MintsHelper streaming helps
+
+def _shell_runs(basis, row_bytes, memory):
+    """
+    Splits the shells of *basis* into runs ``(start, stop)`` whose functions
+    take at most *memory* bytes at *row_bytes* bytes each. A shell larger than
+    *memory* gets a run of its own.
+    """
+    if memory is None:
+        memory = core.get_memory() // 4
+
+    runs = []
+    start = 0
+    size = 0
+    for M in range(basis.nshell()):
+        shell_bytes = basis.shell(M).nfunction * row_bytes
+        if (M > start) and (size + shell_bytes > memory):
+            runs.append((start, M))
+            start = M
+            size = 0
+        size += shell_bytes
+    runs.append((start, basis.nshell()))
+    return runs
+
+
+def _ao_eri_blocks(self, memory=None):
+    """
+    Streams the AO ERI tensor in slabs of whole shells on its first index.
+
+    Parameters
+    ----------
+    memory : int
+        Bytes per slab. Defaults to a quarter of the Psi4 memory.
+
+    Yields
+    ------
+    tuple
+        ``(start, stop, slab)``, where ``slab`` is a zero-copy NumPy view of
+        shape ``(stop - start, nbf, nbf, nbf)`` holding ``(mn|rs)`` for
+        ``start <= m < stop``. Each slab is computed, threaded, only when it
+        is asked for, and is released once no view of it is left.
+
+    Example
+    -------
+
+    >>> J = np.zeros((nbf, nbf))
+    >>> for start, stop, I in mints.ao_eri_blocks():
+    ...     J[start:stop] = np.einsum('mnrs,rs->mn', I, D)
+
+    """
+    basis = self.basisset()
+    nbf = basis.nbf()
+    for Mstart, Mstop in _shell_runs(basis, 8 * nbf**3, memory):
+        start = basis.shell(Mstart).function_index
+        slab = self.ao_eri_slab(Mstart, Mstop)
+        yield (start, start + slab.rows() // nbf, slab.np)
+
+
+def _df_blocks(self, aux, C1=None, C2=None, memory=None):
+    """
+    Streams the unfitted three-index integrals ``(Q|mn)`` in slabs of whole
+    auxiliary shells, or ``(Q|ij)`` if both *C1* and *C2* are given.
+
+    Parameters
+    ----------
+    aux : :py:class:`~psi4.core.BasisSet`
+        Auxiliary basis of Q.
+    C1, C2 : :py:class:`~psi4.core.Matrix`
+        Optional AO-by-MO coefficients for the two other indices.
+    memory : int
+        Bytes per slab. Defaults to a quarter of the Psi4 memory.
+
+    Yields
+    ------
+    tuple
+        ``(start, stop, slab)``, where ``slab`` is a zero-copy NumPy view of
+        shape ``(stop - start, nbf, nbf)`` (or ``(stop - start, n1, n2)``)
+        holding the slice ``start <= Q < stop``. The fitting metric is left
+        to the caller.
+
+    """
+    if (C1 is None) != (C2 is None):
+        raise ValidationError("MintsHelper.df_blocks: give both C1 and C2, or neither.")
+
+    nbf = self.basisset().nbf()
+    cols = nbf * nbf
+    if C1 is not None:
+        cols = max(cols, C1.cols() * C2.cols())
+    for Pstart, Pstop in _shell_runs(aux, 8 * cols, memory):
+        start = aux.shell(Pstart).function_index
+        if C1 is None:
+            slab = self.ao_3index_slab(aux, Pstart, Pstop)
+        else:
+            slab = self.mo_3index_slab(aux, Pstart, Pstop, C1, C2)
+        yield (start, start + slab.rows(), slab.np)
+
+
+core.MintsHelper.ao_eri_blocks = _ao_eri_blocks
+core.MintsHelper.df_blocks = _df_blocks
+
 ## Grid Helpers
 
 def get_np_xyzw(Vpot):
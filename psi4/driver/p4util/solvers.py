@@ -31,7 +31,6 @@ from __future__ import print_function
 Generalized iterative solvers for Psi4.
 
 """
-import time
 import numpy as np
 
 from psi4 import core
@@ -79,111 +78,12 @@ def cg_solver(rhs_vec, hx_function, preconditioner, guess=None, printer=None, pr
 
     """
 
-    tstart = time.time()
-    if printlvl:
-        core.print_out("\n   -----------------------------------------------------\n")
-        core.print_out("   " + "Generalized CG Solver".center(52) + "\n")
-        core.print_out("   " + "by Daniel. G. A. Smith".center(52) + "\n")
-        core.print_out("   -----------------------------------------------------\n")
-        core.print_out("    Maxiter             = %11d\n" % maxiter)
-        core.print_out("    Convergence         = %11.3E\n" % rcond)
-        core.print_out("    Number of equations = %11ld\n\n" % len(rhs_vec))
-        core.print_out("     %4s %14s %12s  %6s  %6s\n" %
-                       ("Iter", "Residual RMS", "Max RMS", "Remain", "Time [s]"))
-        core.print_out("   -----------------------------------------------------\n")
-
-    nrhs = len(rhs_vec)
-    active_mask = [True for x in range(nrhs)]
-
-    # Start function
-    if guess is None:
-        x_vec = preconditioner(rhs_vec, active_mask)
-    else:
-        if len(guess) != len(rhs_vec):
-            raise ValidationError("CG Solver: Guess vector length does not match RHS vector length.")
-        x_vec = [x.clone() for x in guess]
-
-    Ax_vec = hx_function(x_vec, active_mask)
-
-    # Set it up
-    r_vec = []  # Residual vectors
-    for x in range(nrhs):
-        tmp_r = rhs_vec[x].clone()
-        tmp_r.axpy(-1.0, Ax_vec[x])
-        r_vec.append(tmp_r)
-
-    z_vec = preconditioner(r_vec, active_mask)
-    p_vec = [x.clone() for x in z_vec]
-
-    # First RMS
-    grad_dot = [x.sum_of_squares() for x in rhs_vec]
-
-    resid = [(r_vec[x].sum_of_squares() / grad_dot[x]) ** 0.5 for x in range(nrhs)]
-
-    if printer:
-        resid = printer(0, x_vec, r_vec)
-    elif printlvl:
-        # core.print_out('         CG Iteration Guess:    Rel. RMS = %1.5e\n' %  np.mean(resid))
-        core.print_out("    %5s %14.3e %12.3e %7d %9d\n" % (
-            "Guess", np.mean(resid), np.max(resid), len(z_vec), time.time() - tstart))
-
-    rms = np.mean(resid)
-    rz_old = [0.0 for x in range(nrhs)]
-    alpha = [0.0 for x in range(nrhs)]
-    active = np.where(active_mask)[0]
-
-    # CG iterations
-    for rot_iter in range(maxiter):
-
-        # Build old RZ so we can discard vectors
-        for x in active:
-            rz_old[x] = r_vec[x].vector_dot(z_vec[x])
-
-        # Build Hx product
-        Ap_vec = hx_function(p_vec, active_mask)
-
-        # Update x and r
-        for x in active:
-            alpha[x] = rz_old[x] / Ap_vec[x].vector_dot(p_vec[x])
-            if np.isnan(alpha)[0]:
-                core.print_out("CG: Alpha is NaN for vector %d. Stopping vector." % x)
-                active_mask[x] = False
-                continue
-
-            x_vec[x].axpy(alpha[x], p_vec[x])
-            r_vec[x].axpy(-alpha[x], Ap_vec[x])
-            resid[x] = (r_vec[x].sum_of_squares() / grad_dot[x]) ** 0.5
-
-
-        # Print out or compute the resid function
-        if printer:
-            resid = printer(rot_iter + 1, x_vec, r_vec)
-
-        # Figure out active updated active mask
-        for x in active:
-            if (resid[x] < rcond):
-                active_mask[x] = False
-
-        # Print out if requested
-        if printlvl:
-            core.print_out("    %5d %14.3e %12.3e %7d %9d\n" % (
-                rot_iter + 1, np.mean(resid), np.max(resid), sum(active_mask), time.time() - tstart))
-
-
-        active = np.where(active_mask)[0]
-
-        if sum(active_mask) == 0:
-            break
-
-        # Update p
-        z_vec = preconditioner(r_vec, active_mask)
-        for x in active:
-            beta = r_vec[x].vector_dot(z_vec[x]) / rz_old[x]
-            p_vec[x].scale(beta)
-            p_vec[x].axpy(1.0, z_vec[x])
-
-    if printlvl:
-        core.print_out("   -----------------------------------------------------\n")
+    if (guess is not None) and (len(guess) != len(rhs_vec)):
+        raise ValidationError("CG Solver: Guess vector length does not match RHS vector length.")
+
+    # The iterations run in core.cg_solver, which calls back into hx_function and preconditioner
+    x_vec, r_vec = core.cg_solver(list(rhs_vec), hx_function, preconditioner, guess=guess, printer=printer,
+                                  printlvl=printlvl, maxiter=maxiter, rcond=rcond)
 
     return x_vec, r_vec
 
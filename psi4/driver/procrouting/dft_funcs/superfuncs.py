@@ -53,56 +53,136 @@ superfunctionals.update(double_hyb_superfuncs.double_hyb_superfunc_list)
 
 ## ==> SuperFunctional List <== ##
 
-superfunctional_list = []
-for key in superfunctionals.keys():
-    sup = superfunctionals[key](key, 1, 1, True)[0]
-    superfunctional_list.append(sup)
+def _build_superfunctional_list():
+    """Builds every functional in superfunctionals, plus the dispersion-
+    corrected variants, as the SuperFunctional objects that
+    superfunctional_list holds.
+
+    """
+    superfunctional_list = []
+    for key in superfunctionals.keys():
+        sup = superfunctionals[key](key, 1, 1, True)[0]
+        superfunctional_list.append(sup)
 
-## ==> Dispersion SuperFunctional List <== ##
+    ## ==> Dispersion SuperFunctional List <== ##
 
-p4_funcs = set([x for x in list(superfunctionals)])
-p4_funcs -= set(['b97-d'])
-for dashlvl, dashparam_dict in dftd3.dashcoeff.items():
-    func_list = (set(dashparam_dict) & p4_funcs)
-    for func in func_list:
-        sup = superfunctionals[func](func, 1, 1, True)[0]
+    for dashlvl, dashparam_dict in dftd3.dashcoeff.items():
+        func_list = (set(dashparam_dict) & p4_funcs)
+        for func in func_list:
+            sup = superfunctionals[func](func, 1, 1, True)[0]
+            sup.set_name(sup.name() + '-' + dashlvl.upper())
+            superfunctional_list.append(sup)
+
+            if dashlvl == 'd2p4':
+                # -D2 overide
+                sup = superfunctionals[func](func, 1, 1, True)[0]
+                sup.set_name(sup.name() + '-D2')
+                superfunctional_list.append(sup)
+
+                # -D overide
+                sup = superfunctionals[func](func, 1, 1, True)[0]
+                sup.set_name(sup.name() + '-D')
+                superfunctional_list.append(sup)
+
+            if dashlvl == 'd3zero':
+                sup = superfunctionals[func](func, 1, 1, True)[0]
+                sup.set_name(sup.name() + '-D3')
+                superfunctional_list.append(sup)
+
+            if dashlvl == 'd3mzero':
+                sup = superfunctionals[func](func, 1, 1, True)[0]
+                sup.set_name(sup.name() + '-D3M')
+                superfunctional_list.append(sup)
+
+    # # B97D is an odd one
+    for dashlvl in dftd3.full_dash_keys:
+        if dashlvl == 'd2p4': continue
+
+        sup = superfunctionals['b97-d']('b97-d', 1, 1, True)[0]
+        sup.set_name('B97-' + dashlvl.upper())
+        superfunctional_list.append(sup)
+
+    # wPBE, grr need a new scheme
+    for dashlvl in ['d3', 'd3m', 'd3zero', 'd3mzero', 'd3bj', 'd3mbj']:
+        sup = superfunctionals['wpbe']('wpbe', 1, 1, True)[0]
         sup.set_name(sup.name() + '-' + dashlvl.upper())
         superfunctional_list.append(sup)
 
-        if dashlvl == 'd2p4':
-            # -D2 overide
-            sup = superfunctionals[func](func, 1, 1, True)[0]
-            sup.set_name(sup.name() + '-D2')
-            superfunctional_list.append(sup)
+    return superfunctional_list
 
-            # -D overide
-            sup = superfunctionals[func](func, 1, 1, True)[0]
-            sup.set_name(sup.name() + '-D')
-            superfunctional_list.append(sup)
 
-        if dashlvl == 'd3zero':
-            sup = superfunctionals[func](func, 1, 1, True)[0]
-            sup.set_name(sup.name() + '-D3')
-            superfunctional_list.append(sup)
+class _LazySuperFunctionalList(list):
+    """List of all SuperFunctionals that is only built when first read.
+    Building them all is most of the cost of importing psi4, and a run
+    that computes no DFT never needs them.
 
-        if dashlvl == 'd3mzero':
-            sup = superfunctionals[func](func, 1, 1, True)[0]
-            sup.set_name(sup.name() + '-D3M')
-            superfunctional_list.append(sup)
+    """
+
+    def _fill(self):
+        if not self._filled:
+            self._filled = True
+            list.extend(self, _build_superfunctional_list())
+
+    def __init__(self):
+        list.__init__(self)
+        self._filled = False
+
+    def __iter__(self):
+        self._fill()
+        return list.__iter__(self)
+
+    def __len__(self):
+        self._fill()
+        return list.__len__(self)
+
+    def __getitem__(self, index):
+        self._fill()
+        return list.__getitem__(self, index)
+
+    def __contains__(self, item):
+        self._fill()
+        return list.__contains__(self, item)
+
+    def __repr__(self):
+        self._fill()
+        return list.__repr__(self)
+
+
+p4_funcs = set([x for x in list(superfunctionals)])
+p4_funcs -= set(['b97-d'])
+
+superfunctional_list = _LazySuperFunctionalList()
+
+
+def is_superfunctional_name(name):
+    """Could *name* be one of the functionals in superfunctional_list (or a
+    dispersion-corrected variant of one)? Needs no functional built.
+
+    """
+    name = name.lower()
+    if name in superfunctionals.keys() or name.upper() in superfunctionals.keys():
+        return True
+    return any(name.endswith(al) for al in dftd3.full_dash_keys)
 
-# # B97D is an odd one
-for dashlvl in dftd3.full_dash_keys:
-    if dashlvl == 'd2p4': continue
 
-    sup = superfunctionals['b97-d']('b97-d', 1, 1, True)[0]
-    sup.set_name('B97-' + dashlvl.upper())
-    superfunctional_list.append(sup)
+def find_superfunctional(name):
+    """Returns the (last) entry of superfunctional_list named *name* (in
+    any case), or None. A plain functional is built on its own, so only
+    dispersion variants, and names no key matches, build the whole list.
 
-# wPBE, grr need a new scheme
-for dashlvl in ['d3', 'd3m', 'd3zero', 'd3mzero', 'd3bj', 'd3mbj']:
-    sup = superfunctionals['wpbe']('wpbe', 1, 1, True)[0]
-    sup.set_name(sup.name() + '-' + dashlvl.upper())
-    superfunctional_list.append(sup)
+    """
+    name = name.lower()
+    if not superfunctional_list._filled:
+        for key in superfunctionals.keys():
+            if key.lower() == name:
+                sup = superfunctionals[key](key, 1, 1, True)[0]
+                if sup.name().lower() == name:
+                    return sup
+    found = None
+    for sup in superfunctional_list:
+        if sup.name().lower() == name:
+            found = sup
+    return found
 
 
 ## ==> SuperFunctional Builder <== ##
@@ -177,7 +257,7 @@ def build_superfunctional(alias, restricted):
         sup[0].set_c_alpha(core.get_option("SCF", "DFT_ALPHA_C"))
 
     # Check SCF_TYPE
-    if sup[0].is_x_lrc() and (core.get_option("SCF", "SCF_TYPE") not in ["DIRECT", "DF", "OUT_OF_CORE", "PK"]):
+    if sup[0].is_x_lrc() and (core.get_option("SCF", "SCF_TYPE") not in ["DIRECT", "CFMM", "COSX", "DF", "OUT_OF_CORE", "PK"]):
         raise KeyError("SCF: SCF_TYPE (%s) not supported for range-seperated functionals."
                         % core.get_option("SCF", "SCF_TYPE"))
 
@@ -30,6 +30,7 @@
 Module to provide lightweight definitions of emperical dispersion terms.
 """
 from psi4 import core
+from psi4.driver.p4util.exceptions import *
 from psi4.driver.qcdb import interface_dftd3 as dftd3
 from psi4.driver.qcdb import interface_gcp as gcp
 
@@ -215,3 +216,9 @@ class EmpericalDispersion(object):
                                        dashparam=self.dash_params, verbose=False, dertype=1)
         else:
             return self.disp.compute_gradient(molecule)
+
+    def compute_hessian(self, molecule):
+        if self.disp_type == 'gr':
+            raise ValidationError("EmpericalDispersion: Hessians are only available for the built-in -D1/-D2 dispersion, not through DFTD3.")
+        else:
+            return self.disp.compute_hessian(molecule)
@@ -1007,6 +1007,18 @@ def scf_wavefunction_factory(reference, ref_wfn, functional=None):
 
     # Build the wavefunction
     core.prepare_options_for_module("SCF")
+
+    # Resolve SCF_TYPE AUTO now, as the wavefunction and the basis sets below key off the real type.
+    # scf_helper's optstash puts AUTO back afterwards.
+    if core.get_option("SCF", "SCF_TYPE") == "AUTO":
+        auto_aux = None
+        if not core.get_option("SCF", "JK_AUTO_EXACT"):
+            auto_aux = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_SCF",
+                                           core.get_option("SCF", "DF_BASIS_SCF"),
+                                           "JKFIT", core.get_global_option('BASIS'),
+                                           puream=ref_wfn.basisset().has_puream())
+        core.set_local_option("SCF", "SCF_TYPE", core.JK.select_type(ref_wfn.basisset(), auto_aux))
+
     if reference in ["RHF", "RKS"]:
         wfn = core.RHF(ref_wfn, superfunc)
     elif reference == "ROHF":
@@ -1094,6 +1106,7 @@ def scf_helper(name, **kwargs):
     ref_wfn = kwargs.pop('ref_wfn', None)
     ref_func = kwargs.pop('functional', None)
     banner = kwargs.pop('banner', None)
+    fragment_guess = kwargs.pop('fragment_guess', None)
     if ref_wfn is not None:
         raise Exception("Cannot supply a SCF wavefunction a ref_wfn.")
 
@@ -1275,23 +1288,67 @@ def scf_helper(name, **kwargs):
 
     fname = os.path.split(os.path.abspath(core.get_writer_file_prefix(scf_molecule.name())))[1]
     read_filename = os.path.join(core.get_environment("PSI_SCRATCH"), fname + ".180.npz")
+    read_source = "file 180"
 
+    # A checkpoint from an earlier run wins over file 180
+    checkpoint_filename = core.get_option('SCF', 'CHECKPOINT_FILE')
+    if checkpoint_filename and os.path.isfile(checkpoint_filename):
+        read_filename = checkpoint_filename
+        read_source = "checkpoint " + checkpoint_filename
+
+    # In a QM/MM loop the orbitals of the last step are the best guess there is
+    if hasattr(core, "EXTERN") and (not core.has_option_changed('SCF', 'GUESS')) and os.path.isfile(read_filename):
+        core.set_local_option('SCF', 'GUESS', 'READ')
+
+    data = None
     if (core.get_option('SCF', 'GUESS') == 'READ') and os.path.isfile(read_filename):
         data = np.load(read_filename)
+        if ("geometry" in data.files) and (data["geometry"].shape[0] != scf_molecule.natom()):
+            core.print_out("  Orbitals in %s are for a different molecule.\n" % read_source)
+            data = None
+
+    if data is not None:
         Ca_occ = core.Matrix.np_read(data, "Ca_occ")
         Cb_occ = core.Matrix.np_read(data, "Cb_occ")
         symmetry = str(data["symmetry"])
         basis_name = str(data["BasisSet"])
 
-        if symmetry != scf_molecule.schoenflies_symbol():
-            raise ValidationError("Cannot compute projection of different symmetries.")
+        # Orbitals from another geometry (findif displacement, optimization
+        # step) or point group are projected through the mixed AO overlap
+        moved = ("geometry" in data.files) and \
+                not np.allclose(data["geometry"], np.array(scf_molecule.geometry()), rtol=0.0, atol=1.e-10)
+
+        if moved or (symmetry != scf_molecule.schoenflies_symbol()):
+            if "Ca_occ_ao" not in data.files:
+                raise ValidationError("Cannot compute projection of different symmetries.")
 
-        if basis_name == scf_wfn.basisset().name():
-            core.print_out("  Reading orbitals from file 180, no projection.\n\n")
+            core.print_out("  Reading orbitals from %s, projecting to new geometry.\n\n" % read_source)
+
+            old_molecule = scf_molecule.clone()
+            old_molecule.fix_orientation(True)
+            old_molecule.fix_com(True)
+            old_molecule.set_geometry(core.Matrix.from_array(data["geometry"]))
+
+            if basis_name == scf_wfn.basisset().name():
+                old_basis = core.BasisSet.build(old_molecule, "ORBITAL", core.get_global_option('BASIS'),
+                                                puream=scf_wfn.basisset().has_puream(), quiet=True)
+            else:
+                if ".gbs" in basis_name:
+                    basis_name = basis_name.split('/')[-1].replace('.gbs', '')
+                old_basis = core.BasisSet.build(old_molecule, "ORBITAL", basis_name,
+                                                puream=int(data["BasisSet PUREAM"]), quiet=True)
+
+            pCa = proc_util.geometry_projection(data["Ca_occ_ao"], old_basis, scf_wfn)
+            pCb = proc_util.geometry_projection(data["Cb_occ_ao"], old_basis, scf_wfn)
+            scf_wfn.guess_Ca(pCa)
+            scf_wfn.guess_Cb(pCb)
+
+        elif basis_name == scf_wfn.basisset().name():
+            core.print_out("  Reading orbitals from %s, no projection.\n\n" % read_source)
             scf_wfn.guess_Ca(Ca_occ)
             scf_wfn.guess_Cb(Cb_occ)
         else:
-            core.print_out("  Reading orbitals from file 180, projecting to new basis.\n\n")
+            core.print_out("  Reading orbitals from %s, projecting to new basis.\n\n" % read_source)
 
             puream = int(data["BasisSet PUREAM"])
 
@@ -1314,9 +1371,16 @@ def scf_helper(name, **kwargs):
         if old_ref != new_ref:
             scf_wfn.reset_occ(True)
 
+        # DF tensors for these bases and this geometry, see CHECKPOINT_DF_INTS
+        use_df_cache = core.get_global_option("DF_INTS_CACHE") or core.get_global_option("DF_INTS_SHM")
+        if ("DF keys" in data.files) and use_df_cache:
+            for num, key in enumerate(data["DF keys"]):
+                Qmn = core.Matrix.from_array(data["DF %d" % num], name="Qmn (Checkpoint)", copy=False)
+                core.df_ints_cache_adopt(str(key), Qmn)
 
-    elif (core.get_option('SCF', 'GUESS') == 'READ') and not os.path.isfile(read_filename):
-        core.print_out("  Unable to find file 180, defaulting to SAD guess.\n")
+
+    elif (core.get_option('SCF', 'GUESS') == 'READ'):
+        core.print_out("  Unable to find %s, defaulting to SAD guess.\n" % read_source)
         core.set_local_option('SCF', 'GUESS', 'SAD')
         sad_basis_list = core.BasisSet.build(scf_wfn.molecule(), "ORBITAL",
                                              core.get_global_option("BASIS"),
@@ -1331,6 +1395,20 @@ def scf_helper(name, **kwargs):
                                                    return_atomlist=True)
             scf_wfn.set_sad_fitting_basissets(sad_fitting_list)
 
+    # Converged fragments of this molecule (n-body, SAPT), see FRAGMENT_GUESS
+    if fragment_guess and (data is None) and not cast and core.get_option('SCF', 'FRAGMENT_GUESS'):
+        nalpha = sum(frag[0].shape[1] for frag in fragment_guess)
+        nbeta = sum(frag[1].shape[1] for frag in fragment_guess)
+        if not proc_util.fragments_in_place(fragment_guess, scf_wfn.molecule()):
+            core.print_out("  Fragments are not in the frame of this molecule: no fragment guess.\n\n")
+        elif (nalpha == scf_wfn.nalpha()) and (nbeta == scf_wfn.nbeta()):
+            core.print_out("  Assembling the guess from the orbitals of %d fragments.\n\n" % len(fragment_guess))
+            scf_wfn.guess_Ca(proc_util.fragment_projection([(frag[0], frag[2]) for frag in fragment_guess], scf_wfn))
+            scf_wfn.guess_Cb(proc_util.fragment_projection([(frag[1], frag[2]) for frag in fragment_guess], scf_wfn))
+        else:
+            core.print_out("  Fragments hold %d alpha and %d beta electrons, not %d and %d: no fragment guess.\n\n" %
+                           (nalpha, nbeta, scf_wfn.nalpha(), scf_wfn.nbeta()))
+
 
     if cast:
         core.print_out("\n  Computing basis projection from %s to %s\n\n" % (ref_wfn.basisset().name(), base_wfn.basisset().name()))
@@ -1395,6 +1473,10 @@ def scf_helper(name, **kwargs):
     Cb_occ = scf_wfn.Cb_subset("SO", "OCC")
     data.update(Cb_occ.np_write(None, prefix="Cb_occ"))
 
+    data["Ca_occ_ao"] = np.array(scf_wfn.Ca_subset("AO", "OCC"))
+    data["Cb_occ_ao"] = np.array(scf_wfn.Cb_subset("AO", "OCC"))
+    data["geometry"] = np.array(scf_molecule.geometry())
+
     data["reference"] = core.get_option('SCF', 'REFERENCE')
     data["nsoccpi"] = scf_wfn.soccpi().to_tuple()
     data["ndoccpi"] = scf_wfn.doccpi().to_tuple()
@@ -1406,6 +1488,29 @@ def scf_helper(name, **kwargs):
     np.savez(write_filename, **data)
     extras.register_numpy_file(write_filename)
 
+    # The checkpoint outlives the scratch directory and may be read on another node
+    checkpoint_filename = core.get_option('SCF', 'CHECKPOINT_FILE')
+    if checkpoint_filename:
+        data.update(scf_wfn.epsilon_a().np_write(None, prefix="epsilon_a"))
+        data.update(scf_wfn.epsilon_b().np_write(None, prefix="epsilon_b"))
+        data.update(scf_wfn.occupation_a().np_write(None, prefix="occupation_a"))
+        data.update(scf_wfn.occupation_b().np_write(None, prefix="occupation_b"))
+        data["energy"] = e_scf
+
+        if core.get_option('SCF', 'CHECKPOINT_DF_INTS'):
+            tensors = core.df_ints_cache_tensors()
+            keys = sorted(tensors.keys())
+            data["DF keys"] = np.array(keys)
+            for num, key in enumerate(keys):
+                data["DF %d" % num] = np.asarray(tensors[key])
+
+        # Write aside and rename, so that a job stopped mid-write leaves the old checkpoint intact
+        tmp_filename = checkpoint_filename + ".tmp"
+        with open(tmp_filename, "wb") as handle:
+            np.savez(handle, **data)
+        os.rename(tmp_filename, checkpoint_filename)
+        core.print_out("  Orbitals written to checkpoint %s.\n\n" % checkpoint_filename)
+
     if do_timer:
         core.tstop()
 
@@ -1439,8 +1544,8 @@ def run_dcft(name, **kwargs):
                                             puream=ref_wfn.basisset().has_puream())
         ref_wfn.set_basisset("DF_BASIS_SCF", scf_aux_basis)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn)
+    # Ensure IWL files have been written, DCFT reads them directly
+    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn, iwl_required=True)
 
     dcft_wfn = core.dcft(ref_wfn)
     return dcft_wfn
@@ -1569,7 +1674,9 @@ def run_dfocc(name, **kwargs):
 
     if core.get_option('SCF', 'REFERENCE') == 'ROHF':
         ref_wfn.semicanonicalize()
+    ref_wfn = proc_util.fno_reference(ref_wfn)
     dfocc_wfn = core.dfocc(ref_wfn)
+    proc_util.fno_correct_energy(dfocc_wfn)
 
     optstash.restore()
     return dfocc_wfn
@@ -1988,45 +2095,6 @@ def run_scf_gradient(name, **kwargs):
 
     grad = core.scfgrad(ref_wfn)
 
-    if ref_wfn.basisset().has_ECP():
-        core.print_out("\n\n  ==> Adding ECP gradient terms (computed numerically) <==\n")
-        # Build a map of atom->ECP number
-        old_print = ref_wfn.get_print()
-        ref_wfn.set_print(0)
-        delta = 0.0001
-        natom = ref_wfn.molecule().natom()
-        mints = core.MintsHelper(ref_wfn)
-        ecpgradmat = core.Matrix("ECP Gradient", natom, 3)
-        ecpgradmat.zero()
-        ecpgrad = np.asarray(ecpgradmat)
-        Dmat = ref_wfn.Da_subset("AO")
-        Dmat.add(ref_wfn.Db_subset("AO"))
-        def displaced_energy(atom, displacement):
-            mints.basisset().move_atom(atom, displacement)
-            E = Dmat.vector_dot(mints.ao_ecp())
-            mints.basisset().move_atom(atom, -1*displacement)
-            return E
-
-        for atom in range(natom):
-            for xyz in range(3):
-                transvec = core.Vector3(0.0)
-                transvec[xyz] += delta
-                # +1 displacement
-                Ep1 = displaced_energy(atom,  1*transvec)
-                # -1 displacement
-                Em1 = displaced_energy(atom, -1*transvec)
-                # +2 displacement
-                Ep2 = displaced_energy(atom,  2*transvec)
-                # -2 displacement
-                Em2 = displaced_energy(atom, -2*transvec)
-                # Evaluate
-                ecpgrad[atom, xyz] = (Em2 + 8*Ep1 - 8*Em1 - Ep2) / (12*delta)
-        ecpgradmat.symmetrize_gradient(ref_wfn.molecule())
-        ecpgradmat.print_atom_vector()
-        grad.add(ecpgradmat)
-        grad.print_atom_vector()
-        ref_wfn.set_print(old_print)
-
     ref_wfn.set_gradient(grad)
 
     optstash.restore()
@@ -2048,41 +2116,17 @@ def run_scf_hessian(name, **kwargs):
     badint = core.get_option('SCF', 'SCF_TYPE') in [ 'CD', 'OUT_OF_CORE']
     if badref or badint:
         raise ValidationError("Only RHF Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+
+    if "_disp_functor" in dir(ref_wfn):
+        disp_hess = ref_wfn._disp_functor.compute_hessian(ref_wfn.molecule())
+        ref_wfn.set_array("-D Hessian", disp_hess)
+
     H = core.scfhess(ref_wfn)
     ref_wfn.set_hessian(H)
 
-    # Temporary freq code.  To be replaced with proper frequency analysis later...
-    import numpy as np
-
     mol = ref_wfn.molecule()
     natoms = mol.natom()
-    masses = np.zeros(natoms)
-
-    for atom in range(natoms):
-        masses[atom] = mol.mass(atom)
-
-    m = np.repeat( np.divide(1.0, np.sqrt(masses)), 3)
-    mwhess = np.einsum('i,ij,j->ij', m, H, m)
-
-    # Are we linear?
-    if mol.get_full_point_group() in [ "C_inf_v", "D_inf_h" ]:
-        nexternal = 5
-    else:
-        nexternal = 6
-
-    fcscale = constants.hartree2J / (constants.bohr2m * constants.bohr2m * constants.amu2kg);
-    fc = fcscale * np.linalg.eigvalsh(mwhess)
-    # Sort by magnitude of the force constants, to project out rot/vib
-    ordering = np.argsort(np.abs(fc))
-    projected = fc[ordering][nexternal:]
-    freqs = np.sqrt(np.abs(projected))
-    freqs *= 1.0 / (2.0 * np.pi * constants.c * 100.0)
-    freqs[projected < 0] *= -1
-    freqs.sort()
-
-    freqvec = core.Vector.from_array(freqs)
-    ref_wfn.set_frequencies(freqvec)
-    # End of temporary freq hack.  Remove me later!
+    ref_wfn.set_frequencies(proc_util.harmonic_frequencies(mol, H))
 
     # Write Hessian out.  This probably needs a more permanent home, too.
     # This is a drop-in replacement for the code that lives in findif
@@ -2249,8 +2293,9 @@ def run_ccenergy(name, **kwargs):
                                             "RIFIT", core.get_global_option("BASIS"))
         wfn.set_basisset("DF_BASIS_CC", aux_basis)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn)
+    # Ensure IWL files have been written, the AO-basis algorithm reads them directly
+    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn,
+                                           iwl_required=(core.get_option('CCENERGY', 'AO_BASIS') != 'NONE'))
 
     # Obtain semicanonical orbitals
     if (core.get_option('SCF', 'REFERENCE') == 'ROHF') and \
@@ -2258,6 +2303,9 @@ def run_ccenergy(name, **kwargs):
               core.get_option('CCTRANSORT', 'SEMICANONICAL')):
         ref_wfn.semicanonicalize()
 
+    # Truncate the virtual space to DF-MP2 frozen natural orbitals
+    ref_wfn = proc_util.fno_reference(ref_wfn)
+
     if core.get_global_option('RUN_CCTRANSORT'):
         core.cctransort(ref_wfn)
     else:
@@ -2274,6 +2322,8 @@ def run_ccenergy(name, **kwargs):
         core.cchbar(ref_wfn)
         core.cclambda(ref_wfn)
 
+    proc_util.fno_correct_energy(ccwfn)
+
     optstash.restore()
     return ccwfn
 
@@ -2355,8 +2405,9 @@ def run_bccd(name, **kwargs):
     if (core.get_option('SCF', 'REFERENCE') == 'ROHF'):
         ref_wfn.semicanonicalize()
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn)
+    # Ensure IWL files have been written, the AO-basis algorithm reads them directly
+    proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn,
+                                           iwl_required=(core.get_option('CCENERGY', 'AO_BASIS') != 'NONE'))
 
     core.set_local_option('CCTRANSORT', 'DELETE_TEI', 'false')
 
@@ -2920,6 +2971,12 @@ def run_adc(name, **kwargs):
     # Ensure IWL files have been written
     proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn)
 
+    if core.get_option('ADC', 'ADC_OVVV_TYPE') == 'DF':
+        aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_MP2",
+                                        core.get_option("DFMP2", "DF_BASIS_MP2"),
+                                        "RIFIT", core.get_global_option('BASIS'))
+        ref_wfn.set_basisset("DF_BASIS_MP2", aux_basis)
+
     return core.adc(ref_wfn)
 
 
@@ -2955,9 +3012,7 @@ def run_dft(name, **kwargs):
     scf_wfn = run_scf(name, **kwargs)
     returnvalue = core.get_variable('CURRENT ENERGY')
 
-    for ssuper in dft_funcs.superfunctional_list:
-        if ssuper.name().lower() == name:
-            dfun = ssuper
+    dfun = dft_funcs.find_superfunctional(name)
 
     if dfun.is_c_hybrid():
         core.tstart()
@@ -3044,7 +3099,8 @@ def run_detci(name, **kwargs):
         ['DETCI', 'MPN_ORDER_SAVE'],
         ['DETCI', 'MPN'],
         ['DETCI', 'FCI'],
-        ['DETCI', 'EX_LEVEL'])
+        ['DETCI', 'EX_LEVEL'],
+        ['DETCI', 'FROZEN_UOCC'])
 
     if core.get_option('DETCI', 'REFERENCE') not in ['RHF', 'ROHF']:
         raise ValidationError('Reference %s for DETCI is not available.' %
@@ -3108,6 +3164,12 @@ def run_detci(name, **kwargs):
     # Ensure IWL files have been written
     proc_util.check_iwl_file_from_scf_type(core.get_option('SCF', 'SCF_TYPE'), ref_wfn)
 
+    # DETCI takes its frozen virtuals from FROZEN_UOCC rather than the wavefunction
+    if core.get_global_option('FNO_TRUNCATE'):
+        ref_wfn = proc_util.fno_reference(ref_wfn)
+        frzvpi = ref_wfn.frzvpi()
+        core.set_local_option('DETCI', 'FROZEN_UOCC', [frzvpi[h] for h in range(frzvpi.n())])
+
     ciwfn = core.detci(ref_wfn)
 
     print_nos = False
@@ -3116,6 +3178,7 @@ def run_detci(name, **kwargs):
         print_nos = True
 
     proc_util.print_ci_results(ciwfn, name.upper(), core.get_variable("HF TOTAL ENERGY"), core.get_variable("CURRENT ENERGY"), print_nos)
+    proc_util.fno_correct_energy(ciwfn)
 
     core.print_out("\t\t \"A good bug is a dead bug\" \n\n");
     core.print_out("\t\t\t - Starship Troopers\n\n");
@@ -3435,27 +3498,11 @@ def run_sapt(name, **kwargs):
     df_ints_io = core.get_option('SCF', 'DF_INTS_IO')
     # inquire if above at all applies to dfmp2
 
-    core.IO.set_default_namespace('dimer')
-    core.print_out('\n')
-    p4util.banner('Dimer HF')
-    core.print_out('\n')
-
-    # Compute dimer wavefunction
+    # The monomers go first, so the dimer can start from their orbitals
     if (sapt_basis == 'dimer') and (ri == 'DF'):
         core.set_global_option('DF_INTS_IO', 'SAVE')
 
-    dimer_wfn = scf_helper('RHF', molecule=sapt_dimer, **kwargs)
-    if do_delta_mp2:
-        select_mp2(name, ref_wfn=dimer_wfn, **kwargs)
-        mp2_corl_interaction_e = core.get_variable('MP2 CORRELATION ENERGY')
-
-    if (sapt_basis == 'dimer') and (ri == 'DF'):
-        core.set_global_option('DF_INTS_IO', 'LOAD')
-
     # Compute Monomer A wavefunction
-    if (sapt_basis == 'dimer') and (ri == 'DF'):
-        core.IO.change_file_namespace(97, 'dimer', 'monomerA')
-
     core.IO.set_default_namespace('monomerA')
     core.print_out('\n')
     p4util.banner('Monomer A HF')
@@ -3463,7 +3510,10 @@ def run_sapt(name, **kwargs):
     monomerA_wfn = scf_helper('RHF', molecule=monomerA, **kwargs)
     if do_delta_mp2:
         select_mp2(name, ref_wfn=monomerA_wfn, **kwargs)
-        mp2_corl_interaction_e -= core.get_variable('MP2 CORRELATION ENERGY')
+        mp2_corl_interaction_e = -core.get_variable('MP2 CORRELATION ENERGY')
+
+    if (sapt_basis == 'dimer') and (ri == 'DF'):
+        core.set_global_option('DF_INTS_IO', 'LOAD')
 
     # Compute Monomer B wavefunction
     if (sapt_basis == 'dimer') and (ri == 'DF'):
@@ -3473,11 +3523,24 @@ def run_sapt(name, **kwargs):
     p4util.banner('Monomer B HF')
     core.print_out('\n')
     monomerB_wfn = scf_helper('RHF', molecule=monomerB, **kwargs)
-
-    # Delta MP2
     if do_delta_mp2:
         select_mp2(name, ref_wfn=monomerB_wfn, **kwargs)
         mp2_corl_interaction_e -= core.get_variable('MP2 CORRELATION ENERGY')
+
+    # Compute dimer wavefunction
+    if (sapt_basis == 'dimer') and (ri == 'DF'):
+        core.IO.change_file_namespace(97, 'monomerB', 'dimer')
+    core.IO.set_default_namespace('dimer')
+    core.print_out('\n')
+    p4util.banner('Dimer HF')
+    core.print_out('\n')
+    guess = [proc_util.fragment_orbitals(monomerA_wfn), proc_util.fragment_orbitals(monomerB_wfn)]
+    dimer_wfn = scf_helper('RHF', molecule=sapt_dimer, fragment_guess=guess, **kwargs)
+
+    # Delta MP2
+    if do_delta_mp2:
+        select_mp2(name, ref_wfn=dimer_wfn, **kwargs)
+        mp2_corl_interaction_e += core.get_variable('MP2 CORRELATION ENERGY')
         core.set_variable('SAPT MP2 CORRELATION ENERGY', mp2_corl_interaction_e)
     core.set_global_option('DF_INTS_IO', df_ints_io)
 
@@ -205,16 +205,95 @@ energy_only_methods = [x for x in procedures['energy'].keys() if 'sapt' in x]
 energy_only_methods += ['adc', 'efp', 'cphf', 'tdhf', 'cis']
 
 # Integrate DFT with driver routines
-superfunc_list = proc.dft_funcs.superfunctional_list
-for ssuper in superfunc_list:
-      procedures['energy'][ssuper.name().lower()] = proc.run_dft
+#   Registering every functional means building every SuperFunctional, so the
+#   tables below do it only when a lookup could concern a DFT method (or the
+#   whole table is listed). Entries set after this point win over DFT ones,
+#   as they did when DFT was registered here eagerly.
+_dft_registration = {'all': False, 'seen': set()}
+
+def _register_superfunctional(ssuper):
+      name = ssuper.name().lower()
+      procedures['energy']._register(name, proc.run_dft)
 
       if not ssuper.is_c_hybrid():
-            procedures['properties'][ssuper.name().lower()] = proc.run_dft_property
+            procedures['properties']._register(name, proc.run_dft_property)
 
-for ssuper in superfunc_list:
       if ((not ssuper.is_c_hybrid()) and (not ssuper.is_c_lrc()) and (not ssuper.is_x_lrc())):
-            procedures['gradient'][ssuper.name().lower()] = proc.run_dft_gradient
+            procedures['gradient']._register(name, proc.run_dft_gradient)
+
+def _register_dft(name=None):
+      """Registers the DFT methods that *name* could be, or all of them."""
+      if _dft_registration['all']:
+            return
+      if name is not None:
+            try:
+                  name = name.lower()
+            except AttributeError:
+                  return
+            if name in _dft_registration['seen']:
+                  return
+            _dft_registration['seen'].add(name)
+            known = any(dict.__contains__(procedures[ptype], name) for ptype in ['energy', 'gradient', 'properties'])
+            if known and not proc.dft_funcs.is_superfunctional_name(name):
+                  return
+            ssuper = proc.dft_funcs.find_superfunctional(name) if proc.dft_funcs.is_superfunctional_name(name) else None
+            if ssuper is not None and not proc.dft_funcs.superfunctional_list._filled:
+                  _register_superfunctional(ssuper)
+                  return
+
+      _dft_registration['all'] = True
+      for ssuper in proc.dft_funcs.superfunctional_list:
+            _register_superfunctional(ssuper)
+
+class _ProcedureTable(dict):
+      """One ptype of *procedures*, registering DFT methods on demand."""
+
+      def __init__(self, *args, **kwargs):
+            dict.__init__(self, *args, **kwargs)
+            self._pinned = set()
+
+      def _register(self, name, func):
+            if name not in self._pinned:
+                  dict.__setitem__(self, name, func)
+
+      def __setitem__(self, name, func):
+            self._pinned.add(name)
+            dict.__setitem__(self, name, func)
+
+      def __getitem__(self, name):
+            _register_dft(name)
+            return dict.__getitem__(self, name)
+
+      def __contains__(self, name):
+            _register_dft(name)
+            return dict.__contains__(self, name)
+
+      def get(self, name, default=None):
+            _register_dft(name)
+            return dict.get(self, name, default)
+
+      def __iter__(self):
+            _register_dft()
+            return dict.__iter__(self)
+
+      def __len__(self):
+            _register_dft()
+            return dict.__len__(self)
+
+      def keys(self):
+            _register_dft()
+            return dict.keys(self)
+
+      def values(self):
+            _register_dft()
+            return dict.values(self)
+
+      def items(self):
+            _register_dft()
+            return dict.items(self)
+
+for ptype in ['energy', 'gradient', 'properties']:
+      procedures[ptype] = _ProcedureTable(procedures[ptype])
 
 # Integrate CFOUR with driver routines
 for ssuper in interface_cfour.cfour_list():
@@ -31,6 +31,7 @@ from __future__ import absolute_import
 
 from psi4.driver.p4util.exceptions import *
 from psi4.driver import p4util
+from psi4.driver import constants
 from psi4 import core
 
 import numpy as np
@@ -124,13 +125,17 @@ def oeprop_validator(prop_list):
             raise ValidationError("OEProp: Feature '%s' is not recognized. %s" % (prop, alternatives))
 
 
-def check_iwl_file_from_scf_type(scf_type, wfn):
+def check_iwl_file_from_scf_type(scf_type, wfn, iwl_required=False):
     """
     Ensures that a IWL file has been written based on input SCF type.
+
+    If SO_TEI_FORMAT is BLOCKED and the caller reads its integrals through
+    libtrans only (iwl_required False), the blocked file is written instead.
     """
 
 
-    if scf_type in ['DF', 'CD', 'PK', 'DIRECT']:
+    # AUTO may have picked a type that writes no IWL file, so it is treated like the others
+    if scf_type in ['DF', 'CD', 'PK', 'DIRECT', 'AUTO']:
         mints = core.MintsHelper(wfn.basisset())
         if core.get_global_option("RELATIVISTIC") in ["X2C", "DKH"]:
             rel_bas = core.BasisSet.build(wfn.molecule(), "BASIS_RELATIVISTIC",
@@ -140,14 +145,190 @@ def check_iwl_file_from_scf_type(scf_type, wfn):
             mints.set_rel_basisset(rel_bas)
 
         mints.set_print(1)
-        mints.integrals()
+        if core.get_global_option("SO_TEI_FORMAT") == "BLOCKED" and not iwl_required:
+            mints.integrals_blocked()
+        else:
+            mints.integrals()
+
+def fno_reference(ref_wfn):
+    """
+    Returns a copy of *ref_wfn* whose virtual space is truncated to DF-MP2
+    frozen natural orbitals when FNO_TRUNCATE is set, otherwise *ref_wfn*
+    itself. The dropped natural orbitals become frozen virtuals, so
+    the correlated module that receives the copy works in the truncated space.
+    """
+
+    if not core.get_global_option('FNO_TRUNCATE'):
+        return ref_wfn
+
+    if core.get_option('SCF', 'REFERENCE') != 'RHF':
+        raise ValidationError("""FNO_TRUNCATE requires 'reference rhf'.""")
+    if core.get_global_option('DERTYPE') != 'NONE':
+        raise ValidationError("""FNO_TRUNCATE is only available for energies.""")
+
+    aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_MP2",
+                                    core.get_option("DFMP2", "DF_BASIS_MP2"),
+                                    "RIFIT", core.get_global_option('BASIS'),
+                                    puream=ref_wfn.basisset().has_puream())
+    ref_wfn.set_basisset("DF_BASIS_MP2", aux_basis)
+
+    return core.dfmp2_fno(ref_wfn)
+
+
+def fno_correct_energy(wfn):
+    """
+    Adds the DF-MP2 energy lost to the FNO truncation of fno_reference()
+    to the current energies, and records it on *wfn*.
+    """
+
+    if not core.get_global_option('FNO_TRUNCATE'):
+        return
+
+    delta = core.get_variable('MP2 FNO CORRECTION')
+    core.set_variable('CURRENT CORRELATION ENERGY', core.get_variable('CURRENT CORRELATION ENERGY') + delta)
+    core.set_variable('CURRENT ENERGY', core.get_variable('CURRENT ENERGY') + delta)
+    wfn.set_variable('MP2 FNO CORRECTION', delta)
+    core.print_out("\n    MP2 FNO correction added to the current energy: %20.12f\n" % delta)
+    core.print_out("    FNO-corrected total energy:                  %20.12f\n\n" % core.get_variable('CURRENT ENERGY'))
+
+
+def geometry_projection(C_occ, old_basis, wfn):
+    """
+    Projects occupied orbitals from a nearby geometry onto the SO basis of wfn.
+
+    C_occ is the (nao, nocc) C1 coefficient array of the occupied orbitals in
+    old_basis, which may sit on different centers (and in a different point
+    group) than wfn.basisset(). Each orbital is mapped by the mixed overlap
+    into the SO irrep of wfn holding most of its weight, and the orbitals of
+    each irrep are then orthonormalized in the new metric as in
+    Wavefunction.basis_projection (Werner, Mol. Phys. 102, 2311).
+
+    Returns the projected orbitals as a core.Matrix of shape (nsopi, noccpi).
+    """
+
+    return fragment_projection([(C_occ, old_basis)], wfn)
+
+
+def fragment_projection(fragments, wfn):
+    """
+    Assembles the occupied orbitals of wfn from those of its fragments.
+
+    fragments is a list of (C_occ, basis) pairs, C_occ being the (nao, nocc)
+    C1 occupied coefficients of one fragment in its own basis, whose centers
+    must sit where the fragment sits in wfn.molecule(). A fragment computed
+    in the full ghosted basis projects exactly; one computed in its own
+    basis is carried over by the mixed overlap. The orbitals of all
+    fragments are projected together, as in geometry_projection, so the
+    overlap between fragments is removed by the orthonormalization.
+
+    Returns the orbitals as a core.Matrix of shape (nsopi, noccpi).
+    """
+
+    mints = core.MintsHelper(wfn.basisset())
+    S_BB = np.asarray(mints.ao_overlap())
+    D = [np.dot(np.asarray(mints.ao_overlap(basis, wfn.basisset())).T, C) for C, basis in fragments]
+    D = np.hstack(D) if D else np.zeros((S_BB.shape[0], 0))
+
+    U = wfn.aotoso().nph
+    nirrep = len(U)
+    D_h = [np.dot(u.T, D) for u in U]
+    S_h = [np.dot(u.T, np.dot(S_BB, u)) for u in U]
+    X_h = [np.linalg.solve(S, d) if d.shape[0] else d for S, d in zip(S_h, D_h)]
+
+    # Weight of each orbital in each irrep: d^T S^-1 d
+    weight = np.array([np.einsum('pi,pi->i', d, x) for d, x in zip(D_h, X_h)])
+    irrep = np.argmax(weight, axis=0) if D.shape[1] else np.zeros(0, dtype=int)
+
+    blocks = []
+    for h in range(nirrep):
+        cols = np.where(irrep == h)[0]
+        C = X_h[h][:, cols]
+        if C.shape[0] and C.shape[1]:
+            T = np.dot(D_h[h][:, cols].T, C)
+            evals, evecs = np.linalg.eigh(T)
+            C = np.dot(C, np.dot(evecs * evals ** -0.5, evecs.T))
+        blocks.append(C.reshape(U[h].shape[1], len(cols)))
+
+    return core.Matrix.from_array(blocks)
+
+
+def fragment_orbitals(wfn):
+    """
+    The (Ca_occ, Cb_occ, basis) of a converged SCF wfn, with C1 AO coefficients,
+    as kept by the n-body and SAPT drivers for fragment_projection.
+    """
+
+    return (np.array(wfn.Ca_subset("AO", "OCC")), np.array(wfn.Cb_subset("AO", "OCC")), wfn.basisset())
+
+
+def fragments_in_place(fragments, molecule):
+    """
+    Do the basis centers of all fragments coincide with atoms of molecule?
+    Subsystems that were reoriented into their own frames cannot be projected.
+    """
+
+    geom = np.asarray(molecule.geometry())
+    for frag in fragments:
+        fgeom = np.asarray(frag[-1].molecule().geometry())
+        if not fgeom.shape[0]:
+            continue
+        dist = np.linalg.norm(fgeom[:, None, :] - geom[None, :, :], axis=2)
+        if np.max(np.min(dist, axis=1)) > 1.e-8:
+            return False
+    return True
+
+def harmonic_frequencies(molecule, H, scale=1.0):
+    """
+    Harmonic vibrational frequencies [cm^-1] of molecule from its Cartesian
+    Hessian H [E_h/a0^2], with the masses molecule carries now. Nothing but
+    the masses enter besides H, so one Hessian serves every isotopolog.
+
+    Translations and rotations about the center of mass are projected out
+    exactly, which leaves 3N-6 (3N-5 if linear) frequencies in ascending
+    order, imaginary ones as negative numbers, each multiplied by scale.
+
+    Returns the frequencies as a core.Vector.
+    """
+
+    natom = molecule.natom()
+    H = np.asarray(H)
+    if H.shape != (3 * natom, 3 * natom):
+        raise ValidationError("harmonic_frequencies: Hessian of shape %s does not fit %d atoms." %
+                              (str(H.shape), natom))
+
+    masses = np.array([molecule.mass(at) for at in range(natom)])
+    geom = np.asarray(molecule.geometry())
+    X = geom - np.dot(masses, geom) / np.sum(masses)
+    sqm = np.sqrt(masses)
+
+    # Mass-weighted translations and infinitesimal rotations
+    external = []
+    for k in range(3):
+        T = np.zeros((natom, 3))
+        T[:, k] = sqm
+        external.append(T.ravel())
+        external.append((np.cross(np.eye(3)[k], X) * sqm[:, None]).ravel())
+    U, sigma, _ = np.linalg.svd(np.array(external).T)
+    nexternal = np.sum(sigma > 1.e-6 * sigma[0])
+    Uvib = U[:, nexternal:]
+
+    m = np.repeat(1.0 / sqm, 3)
+    mwhess = m[:, None] * H * m[None, :]
+
+    fcscale = constants.hartree2J / (constants.bohr2m * constants.bohr2m * constants.amu2kg)
+    fc = fcscale * np.linalg.eigvalsh(np.dot(Uvib.T, np.dot(mwhess, Uvib)))
+    freqs = np.sqrt(np.abs(fc)) / (2.0 * np.pi * constants.c * 100.0)
+    freqs[fc < 0] *= -1
+
+    return core.Vector.from_array(scale * freqs)
+
 
 def check_non_symmetric_jk_density(name):
     """
     Ensure non-symmetric density matrices are supported for the selected JK routine.
     """
     scf_type = core.get_option('SCF', 'SCF_TYPE')
-    supp_jk_type = ['DF', 'CD', 'PK', 'DIRECT', 'OUT_OF_CORE']
+    supp_jk_type = ['DF', 'CD', 'PK', 'DIRECT', 'CFMM', 'COSX', 'OUT_OF_CORE']
     supp_string = ', '.join(supp_jk_type[:-1]) + ', or ' + supp_jk_type[-1] + '.'
 
     if scf_type not in supp_jk_type:
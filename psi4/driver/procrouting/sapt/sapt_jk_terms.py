@@ -39,6 +39,8 @@ from .sapt_util import print_sapt_var
 def build_sapt_jk_cache(wfn_A, wfn_B, jk, do_print=True):
     """
     Constructs the DCBS cache data required to compute ELST/EXCH/IND
+
+    Every J/K matrix the three terms need comes out of a single JK build.
     """
 
     core.print_out("\n  ==> Preparing SAPT Data Cache <== \n\n")
@@ -84,34 +86,56 @@ def build_sapt_jk_cache(wfn_A, wfn_B, jk, do_print=True):
     # Anything else we might need
     cache["S"] = wfn_A.S().clone()
 
-    # J and K matrices
-    jk.C_clear()
+    # Inverse exchange metric (S^inf exchange)
+    nocc_A = cache["Cocc_A"].shape[1]
+    nocc_B = cache["Cocc_B"].shape[1]
+    SAB = core.Matrix.triplet(
+        cache["Cocc_A"], cache["S"], cache["Cocc_B"], True, False, False)
+    num_occ = nocc_A + nocc_B
+
+    Sab = core.Matrix(num_occ, num_occ)
+    Sab.np[:nocc_A, nocc_A:] = SAB.np
+    Sab.np[nocc_A:, :nocc_A] = SAB.np.T
+    Sab.np[np.diag_indices_from(Sab.np)] += 1
+    Sab.power(-1.0, 1.e-14)
+    Sab.np[np.diag_indices_from(Sab.np)] -= 1.0
 
-    # Normal J/K for Monomer A
-    jk.C_left_add(wfn_A.Ca_subset("SO", "OCC"))
-    jk.C_right_add(wfn_A.Ca_subset("SO", "OCC"))
+    cache["Tmo_AA"] = core.Matrix.from_array(Sab.np[:nocc_A, :nocc_A])
+    cache["Tmo_BB"] = core.Matrix.from_array(Sab.np[nocc_A:, nocc_A:])
+    cache["Tmo_AB"] = core.Matrix.from_array(Sab.np[:nocc_A, nocc_A:])
+
+    S = cache["S"]
+    D_A = cache["D_A"]
+    D_B = cache["D_B"]
+    P_B = cache["P_B"]
 
-    # Normal J/K for Monomer B
-    jk.C_left_add(wfn_B.Ca_subset("SO", "OCC"))
-    jk.C_right_add(wfn_B.Ca_subset("SO", "OCC"))
+    # J and K matrices, name: (C_left, C_right)
+    pairs = [
+        # Normal J/K for Monomer A and B
+        ("A", wfn_A.Ca_subset("SO", "OCC"), wfn_A.Ca_subset("SO", "OCC")),
+        ("B", wfn_B.Ca_subset("SO", "OCC"), wfn_B.Ca_subset("SO", "OCC")),
+        # K_O J/K
+        ("O", core.Matrix.triplet(D_B, S, cache["Cocc_A"], False, False, False), cache["Cocc_A"]),
+        # Exchange
+        ("T_A", cache["Cocc_A"], core.Matrix.doublet(cache["Cocc_A"], cache["Tmo_AA"], False, False)),
+        ("T_AB", cache["Cocc_B"], core.Matrix.doublet(cache["Cocc_A"], cache["Tmo_AB"], False, False)),
+        ("ij", cache["Cocc_A"], core.Matrix.chain_dot(P_B, S, cache["Cocc_A"])),
+        # Exchange-induction
+        ("P_B", core.Matrix.chain_dot(D_B, S, D_A, S, cache["Cocc_B"]), cache["Cocc_B"]),
+        ("P_A", core.Matrix.chain_dot(D_A, S, D_B, S, cache["Cocc_A"]), cache["Cocc_A"]),
+    ]
 
-    # K_O J/K
-    C_O_A = core.Matrix.triplet(
-        cache["D_B"], cache["S"], cache["Cocc_A"], False, False, False)
-    jk.C_left_add(C_O_A)
-    jk.C_right_add(cache["Cocc_A"])
+    jk.C_clear()
+    for name, C_left, C_right in pairs:
+        jk.C_left_add(C_left)
+        jk.C_right_add(C_right)
 
     jk.compute()
 
     # Clone them as the JK object will overwrite.
-    cache["J_A"] = jk.J()[0].clone()
-    cache["K_A"] = jk.K()[0].clone()
-
-    cache["J_B"] = jk.J()[1].clone()
-    cache["K_B"] = jk.K()[1].clone()
-
-    cache["J_O"] = jk.J()[2].clone()
-    cache["K_O"] = jk.K()[2].clone()
+    for n, pair in enumerate(pairs):
+        cache["J_" + pair[0]] = jk.J()[n].clone()
+        cache["K_" + pair[0]] = jk.K()[n].clone()
     cache["K_O"].transpose_this()
 
     monA_nr = wfn_A.molecule().nuclear_repulsion_energy()
@@ -168,23 +192,10 @@ def exchange(cache, jk, do_print=True):
     w_B = cache["V_B"].clone()
     w_B.axpy(2.0, cache["J_B"])
 
-    # Build inverse exchange metric
-    nocc_A = cache["Cocc_A"].shape[1]
-    nocc_B = cache["Cocc_B"].shape[1]
-    SAB = core.Matrix.triplet(
-        cache["Cocc_A"], cache["S"], cache["Cocc_B"], True, False, False)
-    num_occ = nocc_A + nocc_B
-
-    Sab = core.Matrix(num_occ, num_occ)
-    Sab.np[:nocc_A, nocc_A:] = SAB.np
-    Sab.np[nocc_A:, :nocc_A] = SAB.np.T
-    Sab.np[np.diag_indices_from(Sab.np)] += 1
-    Sab.power(-1.0, 1.e-14)
-    Sab.np[np.diag_indices_from(Sab.np)] -= 1.0
-
-    Tmo_AA = core.Matrix.from_array(Sab.np[:nocc_A, :nocc_A])
-    Tmo_BB = core.Matrix.from_array(Sab.np[nocc_A:, nocc_A:])
-    Tmo_AB = core.Matrix.from_array(Sab.np[:nocc_A, nocc_A:])
+    # Inverse exchange metric
+    Tmo_AA = cache["Tmo_AA"]
+    Tmo_BB = cache["Tmo_BB"]
+    Tmo_AB = cache["Tmo_AB"]
 
     T_A = np.dot(cache["Cocc_A"], Tmo_AA).dot(cache["Cocc_A"].np.T)
     T_B = np.dot(cache["Cocc_B"], Tmo_BB).dot(cache["Cocc_B"].np.T)
@@ -198,22 +209,9 @@ def exchange(cache, jk, do_print=True):
     D_B = cache["D_B"]
     P_B = cache["P_B"]
 
-    # Compute the J and K matrices
-    jk.C_clear()
-
-    jk.C_left_add(cache["Cocc_A"])
-    jk.C_right_add(core.Matrix.doublet(cache["Cocc_A"], Tmo_AA, False, False))
-
-    jk.C_left_add(cache["Cocc_B"])
-    jk.C_right_add(core.Matrix.doublet(cache["Cocc_A"], Tmo_AB, False, False))
-
-    jk.C_left_add(cache["Cocc_A"])
-    jk.C_right_add(core.Matrix.chain_dot(P_B, S, cache["Cocc_A"]))
-
-    jk.compute()
-
-    JT_A, JT_AB, Jij = jk.J()
-    KT_A, KT_AB, Kij = jk.K()
+    # J and K matrices, from build_sapt_jk_cache
+    JT_A, JT_AB = cache["J_T_A"], cache["J_T_AB"]
+    KT_A, KT_AB, Kij = cache["K_T_A"], cache["K_T_AB"], cache["K_ij"]
 
     # Start S^2
     Exch_s2 = 0.0
@@ -274,21 +272,8 @@ def induction(cache, jk, do_print=True, maxiter=12, conv=1.e-8, do_response=True
     K_O = cache["K_O"]
     J_O = cache["J_O"]
 
-    jk.C_clear()
-
-    jk.C_left_add(core.Matrix.chain_dot(D_B, S, cache["Cocc_A"]))
-    jk.C_right_add(cache["Cocc_A"])
-
-    jk.C_left_add(core.Matrix.chain_dot(D_B, S, D_A, S, cache["Cocc_B"]))
-    jk.C_right_add(cache["Cocc_B"])
-
-    jk.C_left_add(core.Matrix.chain_dot(D_A, S, D_B, S, cache["Cocc_A"]))
-    jk.C_right_add(cache["Cocc_A"])
-
-    jk.compute()
-
-    J_Ot, J_P_B, J_P_A = jk.J()
-    K_Ot, K_P_B, K_P_A = jk.K()
+    J_P_B = cache["J_P_B"]
+    J_P_A = cache["J_P_A"]
 
     # Exch-Ind Potential A
     EX_A = K_B.clone()
@@ -448,8 +433,16 @@ def _sapt_cpscf_solve(cache, jk, rhsA, rhsB, maxiter, conv):
 
         return [pA, pB]
 
+    # Both monomers' two-electron parts come from one JK build, unless a
+    # monomer has XC or range-separated exchange terms that only its own JK carries
+    batch_hx = all(not cache[w].functional().needs_xc() and not cache[w].functional().is_x_lrc()
+                   for w in ["wfn_A", "wfn_B"])
+
     # Hx function
     def hessian_vec(x_vec, act_mask):
+        if batch_hx:
+            return _batched_cphf_Hx(cache, jk, x_vec, act_mask)
+
         if act_mask[0]:
             xA = cache["wfn_A"].cphf_Hx([x_vec[0]])[0]
         else:
@@ -508,3 +501,41 @@ def _sapt_cpscf_solve(cache, jk, rhsA, rhsB, maxiter, conv):
     core.print_out("   " + ("-" * sep_size) + "\n")
 
     return vecs
+
+
+def _batched_cphf_Hx(cache, jk, x_vec, act_mask):
+    """
+    The cphf_Hx products of the active monomers (HF-like references) from a
+    single JK build with one density per monomer.
+    """
+
+    active = [m for m in range(2) if act_mask[m]]
+
+    jk.C_clear()
+    for m in active:
+        mon = "AB"[m]
+        jk.C_left_add(cache["Cocc_" + mon])
+        R = core.Matrix.doublet(cache["Cvir_" + mon], x_vec[m], False, True)
+        R.scale(-1.0)
+        jk.C_right_add(R)
+    jk.compute()
+
+    ret = [False, False]
+    for n, m in enumerate(active):
+        mon = "AB"[m]
+        wfn = cache["wfn_" + mon]
+        functional = wfn.functional()
+        alpha = functional.x_alpha() if functional.is_x_hybrid() else 0.0
+
+        # 4 J[D] - K[D] - K[D]^T
+        G = jk.J()[n].clone()
+        G.scale(4.0)
+        K = jk.K()[n]
+        G.axpy(-alpha, K)
+        G.axpy(-alpha, K.transpose())
+
+        Hx = wfn.onel_Hx([x_vec[m]])[0]
+        Hx.axpy(1.0, core.Matrix.triplet(cache["Cocc_" + mon], G, cache["Cvir_" + mon], True, False, False))
+        ret[m] = Hx
+
+    return ret
@@ -35,6 +35,8 @@ import sys
 import string
 import hashlib
 import itertools
+import pickle
+import tempfile
 from collections import defaultdict
 try:
     from collections import OrderedDict
@@ -67,6 +69,17 @@ class BasisSet(object):
     # Global arrays of x, y, z exponents (Need libmint for max ang mom)
     LIBINT_MAX_AM = 6  # TODO
     exp_ao = [[] for l in range(LIBINT_MAX_AM)]
+    # Basis set files read and atom entries parsed so far, keyed by full
+    #   filename, as (mtime, lines, {(entry, forced puream): parse}, entry
+    #   names), so that constructions for a series of molecules (e.g.,
+    #   psi4.energy_batch()) read each file and parse each entry only once
+    #   (and across runs, through the compiled copies of save_compiled())
+    gbs_cache = {}
+    # Finished pyconstruct() dictionaries for string molecules and string
+    #   basis names, with the (file, mtime) pairs they were built from
+    pyconstruct_cache = {}
+    # Version of the on-disk compiled basis file layout, see load_compiled()
+    COMPILED_VERSION = 1
 
     def __init__(self, *args):
 
@@ -608,6 +621,18 @@ class BasisSet(object):
 
         #print('BasisSet::pyconstructP', 'key =', key, 'aux =', aux, 'fitrole =', fitrole, 'orb =', orb, 'orbonly =', orbonly) #, mol)
 
+        # The same molecule string and basis names come back many times over
+        #   (n-body fragments, database reagents, cbs stages), so reuse the
+        #   finished dictionary while the basis files it came from are unchanged
+        memokey = None
+        if isinstance(mol, basestring) and not return_atomlist and \
+            all(x is None or (isinstance(x, basestring) and x not in basishorde) for x in (target, other)):
+            memokey = (mol, key, target, fitrole, other, os.path.abspath('.'),
+                       os.environ.get('PSIPATH', ''), os.environ.get('PSIDATADIR', ''))
+            memo = BasisSet.pyconstruct_cache.get(memokey, None)
+            if memo is not None and BasisSet.files_unchanged(memo[1]):
+                return dict(memo[0])
+
         # Create (if necessary) and update qcdb.Molecule
         if isinstance(mol, basestring):
             mol = Molecule(mol)
@@ -698,6 +723,8 @@ class BasisSet(object):
             bsdict['shell_map'] = bs.export_for_libmints('BASIS' if fitrole == 'ORBITAL' else fitrole)
             if ecp:
                 bsdict['ecp_shell_map'] = ecp.export_for_libmints('BASIS')
+            if memokey is not None:
+                BasisSet.pyconstruct_cache[memokey] = (dict(bsdict), bs.gbs_files)
             return bsdict
 
     @classmethod
@@ -744,6 +771,7 @@ class BasisSet(object):
         names = {}
         summary = []
         bastitles = []
+        gbs_files = []
 
         for at in range(mol.natom()):
             symbol = mol.atom_entry(at).symbol()  # O, He
@@ -814,14 +842,18 @@ class BasisSet(object):
                     # Store contents so not reloading files
                     index = 'file %s' % (fullfilename)
                     if index not in names:
-                        names[index] = parser.load_file(fullfilename)
+                        names[index] = cls.load_cached(parser, fullfilename)
+                        gbs_files.append((fullfilename, cls.gbs_cache[fullfilename][0]))
 
                 lines = names[index]
 
                 for entry in seek['entry']:
 
                     # Seek entry in lines, else skip to next entry
-                    shells, msg, ecp_shells, ecp_msg, ecp_ncore = parser.parse(entry, lines)
+                    if index.startswith('file '):
+                        shells, msg, ecp_shells, ecp_msg, ecp_ncore = cls.parse_cached(parser, fullfilename, entry, lines)
+                    else:
+                        shells, msg, ecp_shells, ecp_msg, ecp_ncore = parser.parse(entry, lines)
                     if shells is None:
                         continue
 
@@ -861,6 +893,7 @@ class BasisSet(object):
 
         # Construct the grand BasisSet for mol
         basisset = BasisSet(key, mol, atom_basis_shell)
+        basisset.gbs_files = gbs_files
 
         # If an ECP was detected, and we're building BASIS, process it now
         ecpbasisset = None
@@ -1378,6 +1411,117 @@ class BasisSet(object):
 
         return basisname
 
+    @classmethod
+    def load_cached(cls, parser, fullfilename):
+        """Returns the lines of basis set file *fullfilename* as loaded by
+        *parser*, reading the file only if it is new or has changed since
+        it was last read.
+
+        """
+        mtime = os.path.getmtime(fullfilename)
+        cached = cls.gbs_cache.get(fullfilename, None)
+        if cached is None or cached[0] != mtime:
+            cached = (mtime, ) + cls.load_compiled(parser, fullfilename, mtime)
+            cls.gbs_cache[fullfilename] = cached
+        return cached[1]
+
+    @staticmethod
+    def compiled_filename(fullfilename):
+        """Returns where the compiled copy of basis set file *fullfilename*
+        lives: in directory ``PSI4_BASIS_CACHE``, or None if that is unset
+        or set to ``none``, as the cache is opt-in.
+
+        """
+        cachedir = os.environ.get('PSI4_BASIS_CACHE', '')
+        if cachedir.lower() in ['', 'none', 'false', '0']:
+            return None
+        cachedir = os.path.expanduser(cachedir)
+        tag = hashlib.sha1(os.path.abspath(fullfilename).encode('utf-8')).hexdigest()[:16]
+        stem = os.path.basename(fullfilename)[:-4]
+        return os.path.join(cachedir, '%s-%s.py%d.pickle' % (stem, tag, sys.version_info[0]))
+
+    @classmethod
+    def load_compiled(cls, parser, fullfilename, mtime):
+        """Returns the lines of basis set file *fullfilename*, the entries
+        parsed from it so far (as kept by parse_cached()) and the names of
+        all the entries it has. These come from the pickled copy under
+        compiled_filename() when that matches the file's *mtime* and size,
+        otherwise the file is read afresh with nothing parsed yet.
+
+        """
+        cachefile = cls.compiled_filename(fullfilename)
+        if cachefile is not None and os.path.isfile(cachefile):
+            try:
+                with open(cachefile, 'rb') as handle:
+                    compiled = pickle.load(handle)
+                if (compiled['version'] == cls.COMPILED_VERSION and
+                        compiled['source'] == os.path.abspath(fullfilename) and compiled['mtime'] == mtime and
+                        compiled['size'] == os.path.getsize(fullfilename)):
+                    return compiled['lines'], compiled['parsed'], compiled['entries']
+            except Exception:
+                # Truncated or foreign file, start over
+                pass
+
+        lines = parser.load_file(fullfilename)
+        return lines, {}, parser.entries(lines)
+
+    @classmethod
+    def save_compiled(cls, fullfilename):
+        """Writes what gbs_cache holds for basis set file *fullfilename* to
+        its compiled copy, quietly doing nothing if the cache directory is
+        off or can't be written.
+
+        """
+        cachefile = cls.compiled_filename(fullfilename)
+        if cachefile is None:
+            return
+        mtime, lines, parsed, entries = cls.gbs_cache[fullfilename]
+        compiled = {'version': cls.COMPILED_VERSION, 'source': os.path.abspath(fullfilename), 'mtime': mtime,
+                    'size': os.path.getsize(fullfilename), 'lines': lines, 'parsed': parsed, 'entries': entries}
+        cachedir = os.path.dirname(cachefile)
+        tmpname = None
+        try:
+            if not os.path.isdir(cachedir):
+                os.makedirs(cachedir)
+            handle, tmpname = tempfile.mkstemp(dir=cachedir, suffix='.tmp')
+            with os.fdopen(handle, 'wb') as handle:
+                pickle.dump(compiled, handle, pickle.HIGHEST_PROTOCOL)
+            # Atomic, so concurrent runs see either the old copy or the new one
+            os.rename(tmpname, cachefile)
+        except (IOError, OSError):
+            if tmpname is not None and os.path.exists(tmpname):
+                os.remove(tmpname)
+
+    @staticmethod
+    def files_unchanged(files):
+        """Are all the basis set files in *files*, a list of (filename,
+        mtime) pairs as left on BasisSet.gbs_files by construct(), still
+        there and unmodified?
+
+        """
+        try:
+            return all(os.path.getmtime(f) == mtime for f, mtime in files)
+        except OSError:
+            return False
+
+    @classmethod
+    def parse_cached(cls, parser, fullfilename, entry, lines):
+        """Returns *parser*'s parse of *entry* in the already loaded lines of
+        basis set file *fullfilename*, parsing only on first request, ever,
+        when the compiled copy of the file can be kept. The ShellInfo-s
+        returned are shared, so must not be modified.
+
+        """
+        parsed, entries = cls.gbs_cache[fullfilename][2:]
+        key = (entry, parser.force_puream_or_cartesian, parser.forced_is_puream)
+        if entry.upper() not in entries:
+            # Not in the file at all, no need to scan it again
+            return None, None, None, None, None
+        if key not in parsed:
+            parsed[key] = parser.parse(entry, lines)
+            cls.save_compiled(fullfilename)
+        return parsed[key]
+
     @staticmethod
     def decontract(shells):
         """Procedure applied to list to ShellInfo-s *shells* that returns
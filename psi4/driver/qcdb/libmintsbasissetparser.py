@@ -37,6 +37,9 @@ from .libmintsgshell import *
 if sys.version_info >= (3,0):
     basestring = str
 
+_ATOM = '(([A-Z]{1,3}\d*)|([A-Z]{1,3}_\w+))'  # match 'C 0', 'Al c 0', 'P p88 p_pass 0' not 'Ofail 0', 'h99_text 0'
+_atom_array = re.compile(r'^\s*((' + _ATOM + '\s+)+)0\s*$', re.IGNORECASE)  # array of atomic symbols terminated by 0
+
 class Gaussian94BasisSetParser(object):
     """Class for parsing basis sets from a text file in Gaussian 94
     format. Translated directly from the Psi4 libmints class written
@@ -97,6 +100,27 @@ class Gaussian94BasisSetParser(object):
 
         return lines
 
+    def entries(self, dataset):
+        """Returns the upper-case atom symbols and labels that head a
+        basis or ECP block in *dataset* (list of lines or a single string),
+        in order of appearance and without repeats. These are all the
+        entries for which parse() can find anything.
+
+        """
+        if isinstance(dataset, basestring):
+            lines = dataset.split('\n')
+        else:
+            lines = dataset
+
+        found = []
+        for line in lines:
+            what = _atom_array.match(line)
+            if what:
+                for entry in what.group(1).split():
+                    if entry.upper() not in found:
+                        found.append(entry.upper())
+        return found
+
     def parse(self, symbol, dataset):
         """Given a string, parse for the basis set needed for atom.
         * @param symbol atom symbol to look for in dataset
@@ -114,8 +138,8 @@ class Gaussian94BasisSetParser(object):
         spherical = re.compile(r'^\s*spherical\s*', re.IGNORECASE)
         comment = re.compile(r'^\s*\!.*')  # line starts with !
         separator = re.compile(r'^\s*\*\*\*\*')  # line starts with ****
-        ATOM = '(([A-Z]{1,3}\d*)|([A-Z]{1,3}_\w+))'  # match 'C 0', 'Al c 0', 'P p88 p_pass 0' not 'Ofail 0', 'h99_text 0'
-        atom_array = re.compile(r'^\s*((' + ATOM + '\s+)+)0\s*$', re.IGNORECASE)  # array of atomic symbols terminated by 0
+        ATOM = _ATOM
+        atom_array = _atom_array
         atom_ecp = re.compile(r'^\s*((' + ATOM + '-ECP\s+)+)(\d+)\s+(\d+)\s*$', re.IGNORECASE)  # atom_ECP number number
         shell = re.compile(r'^\s*(\w+)\s*(\d+)\s*(-?\d+\.\d+)')  # Match beginning of contraction
         blank = re.compile(r'^\s*$')
@@ -148,6 +148,21 @@ class QMMM(object):
         """
         self.charges.append([Q, x / constants.bohr2angstroms, y / constants.bohr2angstroms, z / constants.bohr2angstroms])
 
+    def moveChargeBohr(self, i, x, y, z):
+        """Function to move point charge *i* to (*x*, *y*, *z*) Bohr,
+        keeping its magnitude. Clear ``extern`` and call
+        :py:func:`populateExtern` again to pass the new positions on.
+
+        """
+        self.charges[i][1:] = [x, y, z]
+
+    def moveChargeAngstrom(self, i, x, y, z):
+        """Function to move point charge *i* to (*x*, *y*, *z*)
+        Angstroms, keeping its magnitude.
+
+        """
+        self.moveChargeBohr(i, x / constants.bohr2angstroms, y / constants.bohr2angstroms, z / constants.bohr2angstroms)
+
     def __str__(self):
 
         s = '   ==> QMMM <==\n\n'
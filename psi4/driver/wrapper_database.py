@@ -41,6 +41,7 @@ import pickle
 import copy
 import collections
 from psi4.driver import constants
+from psi4.driver import driver_farm
 from psi4.driver.driver import *
 # never import aliases into this file
 
@@ -109,13 +110,18 @@ def database(name, db_name, **kwargs):
         keyword ``db_func`` instead of ``func``.
 
     :type mode: string
-    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'``
+    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'`` || ``'farm'``
 
         Indicates whether the calculations required to complete the
         database are to be run in one file (``'continuous'``) or are to be
         farmed out in an embarrassingly parallel fashion
         (``'sow'``/``'reap'``).  For the latter, run an initial job with
-        ``'sow'`` and follow instructions in its output file.
+        ``'sow'`` and follow instructions in its output file. With
+        ``'farm'``, the reagents are run at once as psi4 worker processes on
+        this node, largest first, steered by the ``farm_workers``,
+        ``farm_threads``, and ``farm_memory`` keywords (see
+        :py:func:`~psi4.driver.driver_farm.run_farm`). Only single-point
+        ``energy()`` of a named method can be farmed.
 
     :type cp: :ref:`boolean <op_py_boolean>`
     :param cp: ``'on'`` || |dl| ``'off'`` |dr|
@@ -310,6 +316,9 @@ def database(name, db_name, **kwargs):
         db_linkage = kwargs.get('linkage', None)
         if db_linkage is None:
             raise ValidationError("""Database execution mode 'reap' requires a linkage option.""")
+    elif db_mode == 'farm':
+        if func is not energy or hasattr(lowername, '__call__'):
+            raise ValidationError("""Database execution mode 'farm' runs only energy() of a named method.""")
     else:
         raise ValidationError("""Database execution mode '%s' not valid.""" % (db_mode))
 
@@ -445,6 +454,17 @@ def database(name, db_name, **kwargs):
         instructions += """    the database wrapper option mode='sow'/'reap'.\n\n"""
         core.print_out(instructions)
 
+    #   farm the largest reagents first, so the last to finish are short
+    if db_mode == 'farm':
+        HSYS = sorted(HSYS, key=lambda rgt: _estimate_reagent_cost(GEOS[rgt]), reverse=True)
+
+        instructions = """\n    The database worker farm has been selected through mode='farm'.\n"""
+        instructions += """    Calculations for the reagents will start in the order below, largest first, and\n"""
+        instructions += """    will be followed by summary results for the database.\n\n"""
+        for rgt in HSYS:
+            instructions += """                    %-s\n""" % (rgt)
+        core.print_out(instructions)
+
     #   write sow/reap instructions and index of calcs to output file and reap input file
     if db_mode == 'sow':
         instructions = """\n    The database sow/reap procedure has been selected through mode='sow'. In addition\n"""
@@ -475,6 +495,9 @@ def database(name, db_name, **kwargs):
     ERXN = {}
     VRGT = {}
     VRXN = {}
+    farm_molecules = []
+    farm_options = []
+    farm_actives = []
     for rgt in HSYS:
         VRGT[rgt] = {}
 
@@ -581,6 +604,25 @@ def database(name, db_name, **kwargs):
                     freagent.write("""yields variable value    %20.12f for variable %s\\n' % (core.get_variable(""")
                     freagent.write("""'%s'), '%s'))\n""" % (envv.upper(), envv.upper()))
 
+        elif db_mode == 'farm':
+            molecule = core.Molecule.create_molecule_from_string(GEOS[rgt].create_psi4_string_from_molecule())
+            molecule.set_name(rgt)
+            molecule.update_geometry()
+            if symmetry_override:
+                molecule.reset_point_group('c1')
+                molecule.fix_orientation(True)
+                molecule.fix_com(True)
+                molecule.update_geometry()
+            taskopts = {'WRITER_FILE_LABEL': user_writer_file_label + ('' if user_writer_file_label == '' else '-') + rgt}
+            if (openshell_override) and (molecule.multiplicity() != 1):
+                if user_reference == 'RHF':
+                    taskopts['REFERENCE'] = 'UHF'
+                elif user_reference == 'RKS':
+                    taskopts['REFERENCE'] = 'UKS'
+            farm_molecules.append(molecule)
+            farm_options.append(taskopts)
+            farm_actives.append(actives)
+
         elif db_mode == 'reap':
             ERGT[rgt] = 0.0
             for envv in db_tabulate:
@@ -619,6 +661,17 @@ def database(name, db_name, **kwargs):
                                     core.print_out('DATABASE RESULT: variable %s value    = %20.12f\n' % (envv, VRGT[rgt][envv]))
                 freagent.close()
 
+    #   run the farm, results come back in memory
+    if db_mode == 'farm':
+        worker_kwargs = dict((k, v) for k, v in kwargs.items() if k not in ['name', 'db_name', 'db_func', 'db_mode'])
+        results = driver_farm.run_farm_molecules('energy', lowername.lower(), farm_molecules, 'Database %s' % (db_name),
+                                                 'Reagent', options=farm_options, **worker_kwargs)
+        for rgt, result, actives in zip(HSYS, results, farm_actives):
+            ERGT[rgt] = result['energy']
+            for envv in db_tabulate:
+                VRGT[rgt][envv.upper()] = result['variables'].get(envv.upper(), 0.0)
+            exec(actives)
+
     #   end sow after writing files
     if db_mode == 'sow':
         return 0.0
@@ -746,6 +799,16 @@ def database(name, db_name, **kwargs):
     return finalenergy
 
 
+def _estimate_reagent_cost(molecule):
+    """Returns a figure that orders reagents by the cost of computing them:
+    the electron count, then the atom count (ghosts included, they carry basis
+    functions).
+
+    """
+    nelectron = sum(molecule.Z(at) for at in range(molecule.natom())) - molecule.molecular_charge()
+    return (nelectron, molecule.natom())
+
+
 def _tblhead(tbl_maxrgt, tbl_delimit, ttype):
     r"""Function that prints the header for the changable-width results tables in db().
     *tbl_maxrgt* is the number of reagent columns the table must plan for. *tbl_delimit*
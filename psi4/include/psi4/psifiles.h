@@ -72,6 +72,7 @@
 #define PSIF_AO_DGDBX          44   /*- B-field derivative AO integrals over GIAO Gaussians -- only bra-ket permutational symmetry holds -*/
 #define PSIF_AO_DGDBY          45   /*-  -*/
 #define PSIF_AO_DGDBZ          46   /*-  -*/
+#define PSIF_SO_TEI_BLOCKED    47   /*- SO TEIs in dense symmetry blocks, in libtrans pair order (SO_TEI_FORMAT BLOCKED) -*/
 /* PSIMRCC files */
 #define PSIF_PSIMRCC_INTEGRALS 50   /*-  -*/
 #define PSIF_PSIMRCC_RESTART   51   /*-  -*/
@@ -68,8 +68,15 @@ parser.add_argument("-k", "--skip-preprocessor", action='store_true',
                     help="Skips input preprocessing. !Warning! expert option.")
 parser.add_argument("--json", action='store_true',
                     help="Runs a JSON input file. !Warning! experimental option.")
+parser.add_argument("--json-server", nargs='?', const="-", default=None, metavar="ADDRESS",
+                    help="Stays resident and runs JSON jobs, one per line, from ADDRESS: '-' (stdin/stdout), "
+                         "host:port (TCP), or a UNIX socket path. Default: '-'. !Warning! experimental option.")
 parser.add_argument("-t", "--test", action='store_true',
                     help="Runs smoke tests.")
+parser.add_argument("--benchmark", nargs='?', const="benchmark.json", default=None, metavar="FILE",
+                    help="Runs the kernel benchmark suite and writes it as JSON to FILE. Default: benchmark.json.")
+parser.add_argument("--benchmark-kernels", default=None,
+                    help="Comma-separated subset of kernels for --benchmark, e.g. gemm,jk. Default: all.")
 
 # For plugins
 parser.add_argument("--plugin-name", help="""\
@@ -181,6 +188,26 @@ if args["test"]:
     psi4.test()
     sys.exit()
 
+if args["benchmark"] is not None:
+    if args["output"] != "stdout":
+        psi4.core.set_output_file(args["output"], args["append"])
+    psi4.core.set_num_threads(int(args["nthread"]), quiet=True)
+    psi4.core.set_memory_bytes(524288000, True)
+    if args["scratch"] is not None:
+        psi4.core.set_environment("PSI_SCRATCH", os.path.abspath(os.path.expanduser(args["scratch"])))
+    kernels = args["benchmark_kernels"].split(',') if args["benchmark_kernels"] else None
+    psi4.benchmark_suite(kernels, filename=args["benchmark"])
+    sys.exit()
+
+if args["json_server"] is not None:
+    psi4.core.set_num_threads(int(args["nthread"]), quiet=True)
+    psi4.core.set_memory_bytes(524288000, True)
+    if args["scratch"] is not None:
+        psi4.core.set_environment("PSI_SCRATCH", os.path.abspath(os.path.expanduser(args["scratch"])))
+    output = args["output"] if args["output"] not in [None, "stdout", "output.dat"] else "json_server.log"
+    psi4.json_wrapper.run_json_server(args["json_server"], output=output)
+    sys.exit()
+
 if not os.path.isfile(args["input"]):
     raise KeyError("The file %s does not exist." % args["input"])
 args["input"] = os.path.normpath(args["input"])
@@ -51,6 +51,11 @@
 #include "psi4/ccenergy/ccwave.h"
 #include "psi4/cclambda/cclambda.h"
 #include "psi4/libqt/qt.h"
+#include "psi4/libqt/profile.h"
+#include "psi4/libpsi4util/memory_tracker.h"
+#include "psi4/libpsi4util/structured_log.h"
+#include "psi4/lib3index/df_helper.h"
+#include "psi4/lib3index/df_cache.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/psifiles.h"
@@ -90,6 +95,7 @@ extern std::map<std::string, plugin_info> plugins;
 
 namespace opt {
     psi::PsiReturnType optking(psi::Options&);
+    psi::SharedMatrix model_cartesian_hessian(psi::Options&);
     void opt_clean(void);
 }
 // Forward declare /src/bin/ methods
@@ -105,7 +111,8 @@ std::shared_ptr<PsiOutStream> outfile;
 namespace adc       { SharedWavefunction       adc(SharedWavefunction, Options&); }
 namespace dcft      { SharedWavefunction      dcft(SharedWavefunction, Options&); }
 namespace detci     { SharedWavefunction     detci(SharedWavefunction, Options&); }
-namespace dfmp2     { SharedWavefunction     dfmp2(SharedWavefunction, Options&); }
+namespace dfmp2     { SharedWavefunction     dfmp2(SharedWavefunction, Options&);
+                      SharedWavefunction     fno(SharedWavefunction, Options&); }
 namespace dfoccwave { SharedWavefunction dfoccwave(SharedWavefunction, Options&); }
 namespace libfock   { SharedWavefunction   libfock(SharedWavefunction, Options&); }
 namespace fnocc     { SharedWavefunction     fnocc(SharedWavefunction, Options&); }
@@ -184,7 +191,7 @@ std::string to_upper(const std::string& key)
 
 void py_flush_outfile()
 {
-
+    if (outfile) outfile->flush();
 }
 
 void py_close_outfile()
@@ -234,6 +241,11 @@ void py_psi_prepare_options_for_module(std::string const& name)
     }
     // Now we've read in the defaults, make sure that user-specified options are recognized by the current module
     Process::environment.options.validate_options();
+    Profile::configure();
+    MemoryTracker::configure();
+    MemoryTracker::start_module(name);
+    if (outfile) outfile->set_buffered(Process::environment.options.get_bool("OUTPUT_BUFFERING"));
+    StructuredLog::configure();
 }
 
 int py_psi_optking()
@@ -242,6 +254,12 @@ int py_psi_optking()
     return opt::optking(Process::environment.options);
 }
 
+SharedMatrix py_psi_optking_model_hessian()
+{
+    py_psi_prepare_options_for_module("OPTKING");
+    return opt::model_cartesian_hessian(Process::environment.options);
+}
+
 void py_psi_opt_clean(void)
 {
     opt::opt_clean();
@@ -362,6 +380,12 @@ SharedWavefunction py_psi_dfmp2(SharedWavefunction ref_wfn)
     return dfmp2::dfmp2(ref_wfn, Process::environment.options);
 }
 
+SharedWavefunction py_psi_dfmp2_fno(SharedWavefunction ref_wfn)
+{
+    py_psi_prepare_options_for_module("DFMP2");
+    return dfmp2::fno(ref_wfn, Process::environment.options);
+}
+
 
 double py_psi_sapt(SharedWavefunction Dimer, SharedWavefunction MonomerA,
                    SharedWavefunction MonomerB)
@@ -572,6 +596,12 @@ char const *py_psi_git_version()
 
 void py_psi_clean()
 {
+    Profile::report();
+    MemoryTracker::report();
+    if (outfile) outfile->flush();
+    StructuredLog::flush();
+    df_helper::DF_Helper::release_shared();
+    DFIntsCache::clear();
     PSIOManager::shared_object()->psiclean();
 }
 
@@ -1234,6 +1264,8 @@ void psi4_python_module_finalize()
     py_psi_plugin_close_all();
 
     // Shut things down:
+    Profile::report();
+    StructuredLog::close();
     // There is only one timer:
     timer_done();
 
@@ -1276,6 +1308,10 @@ PYBIND11_PLUGIN(core) {
     core.def("version", py_psi_version, "Returns the version ID of this copy of Psi.");
     core.def("git_version", py_psi_git_version, "Returns the git version of this copy of Psi.");
     core.def("clean", py_psi_clean, "Function to remove scratch files. Call between independent jobs.");
+    core.def("df_ints_cache_tensors", &DFIntsCache::tensors,
+             "Returns the (Q|mn) tensors held by DF_INTS_CACHE, by key.");
+    core.def("df_ints_cache_adopt", &DFIntsCache::adopt, py::arg("key"), py::arg("Qmn"),
+             "Hands a (Q|mn) tensor from df_ints_cache_tensors back to DF_INTS_CACHE.");
     core.def("clean_options", py_psi_clean_options, "Function to reset options to clean state.");
 
     core.def("get_writer_file_prefix", get_writer_file_prefix, "Returns the prefix to use for writing files for external programs.");
@@ -1448,6 +1484,7 @@ PYBIND11_PLUGIN(core) {
     core.def("dcft", py_psi_dcft, "Runs the density cumulant functional theory code.");
     core.def("libfock", py_psi_libfock, "Runs a CPHF calculation, using libfock.");
     core.def("dfmp2", py_psi_dfmp2, "Runs the DF-MP2 code.");
+    core.def("dfmp2_fno", py_psi_dfmp2_fno, "Returns a copy of the RHF reference whose virtual space is truncated to DF-MP2 frozen natural orbitals.");
     core.def("mcscf", py_psi_mcscf, "Runs the MCSCF code, (N.B. restricted to certain active spaces).");
     core.def("mrcc_generate_input", py_psi_mrcc_generate_input, "Generates an input for Kallay's MRCC code.");
     core.def("mrcc_load_densities", py_psi_mrcc_load_densities, "Reads in the density matrices from Kallay's MRCC code.");
@@ -1471,6 +1508,8 @@ PYBIND11_PLUGIN(core) {
     // core.def("fisapt", py_psi_fisapt, "Runs the functional-group intramolecular symmetry adapted perturbation theory code.");
     core.def("psimrcc", py_psi_psimrcc, "Runs the multireference coupled cluster code.");
     core.def("optking", py_psi_optking, "Runs the geometry optimization / frequency analysis code.");
+    core.def("optking_model_hessian", py_psi_optking_model_hessian,
+             "Returns optking's Lindh model Cartesian Hessian at the geometry of the legacy molecule.");
     core.def("cctransort", py_psi_cctransort, "Runs CCTRANSORT, which transforms and reorders integrals for use in the coupled cluster codes.");
     core.def("ccenergy", py_psi_ccenergy, "Runs the coupled cluster energy code.");
     core.def("cctriples", py_psi_cctriples, "Runs the coupled cluster (T) energy code.");
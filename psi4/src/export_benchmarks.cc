@@ -27,6 +27,8 @@
  */
 
 #include "psi4/libmints/benchmark.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libdpd/dpd.h"
 #include "psi4/pybind11.h"
 
 void export_benchmarks(py::module& m) {
@@ -36,4 +38,15 @@ void export_benchmarks(py::module& m) {
     m.def("benchmark_disk", &psi::benchmark_disk, "docstring");
     m.def("benchmark_math", &psi::benchmark_math, "docstring");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "docstring");
+    m.def("benchmark_gemm", &psi::benchmark_gemm, "Times a square DGEMM, returns a dict of dim, seconds and gflops",
+          py::arg("dim"), py::arg("min_time"));
+    m.def("benchmark_psio", &psi::benchmark_psio,
+          "Times PSIO writes and reads of a 2^N x 2^N array, returns a dict of bytes, seconds and MB/s",
+          py::arg("N"), py::arg("min_time"));
+    m.def("benchmark_eri", &psi::benchmark_eri,
+          "Times all unique ERI shell quartets of a basis, returns a dict of counts, seconds and rates",
+          py::arg("basis"), py::arg("min_time"));
+    m.def("benchmark_contract444", &psi::benchmark_contract444,
+          "Times the DPD contraction Z(ij,ab) = X(ij,kl) Y(kl,ab), returns a dict of o, v, seconds and gflops",
+          py::arg("nocc"), py::arg("nvir"), py::arg("min_time"));
 }
@@ -30,6 +30,7 @@
 
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/soscf.h"
+#include "psi4/libfock/solver.h"
 #include "psi4/lib3index/denominator.h"
 #include "psi4/lib3index/dftensor.h"
 #include "psi4/lib3index/df_helper.h"
@@ -43,12 +44,36 @@
 
 using namespace psi;
 
+namespace {
+
+/// A Python f(x, mask) as a MatrixProduct; entries that are not a Matrix (False for masked) become null
+MatrixProduct matrix_product(py::function f) {
+    return [f](const std::vector<SharedMatrix>& x, const std::vector<bool>& active) {
+        py::list ret = f(x, active);
+        std::vector<SharedMatrix> out;
+        for (auto item : ret) {
+            out.push_back(py::isinstance<Matrix>(item) ? item.cast<SharedMatrix>() : SharedMatrix());
+        }
+        return out;
+    };
+}
+
+}  // namespace
+
 void export_fock(py::module &m) {
     py::class_<JK, std::shared_ptr<JK>>(m, "JK", "docstring")
         .def_static("build_JK",
                     [](std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet> aux) {
                         return JK::build_JK(basis, aux, Process::environment.options);
                     })
+        .def_static("select_type",
+                    [](std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet> aux) {
+                        return JK::select_type(basis, aux, Process::environment.options);
+                    },
+                    "SCF_TYPE chosen by the AUTO cost model; aux may be None", py::arg("basis"),
+                    py::arg("aux") = nullptr)
+        .def_static("registered_backends", &JK::registered_backends,
+                    "Names of the JK engines plugins have registered, for use as JK_BACKEND")
         .def("initialize", &JK::initialize)
         .def("set_cutoff", &JK::set_cutoff)
         .def("set_memory", &JK::set_memory)
@@ -75,6 +100,9 @@ void export_fock(py::module &m) {
         .def("K", &JK::K, py::return_value_policy::reference_internal)
         .def("wK", &JK::wK, py::return_value_policy::reference_internal)
         .def("D", &JK::D, py::return_value_policy::reference_internal)
+        .def("name", &JK::name, "Short name of the JK algorithm")
+        .def("metrics_json", &JK::metrics_json, "Per-compute() performance records as a JSON string")
+        .def("clear_metrics", &JK::clear_metrics, "Drop the performance records")
         .def("print_header", &JK::print_header, "docstring");
 
     py::class_<LaplaceDenominator, std::shared_ptr<LaplaceDenominator>>(m, "LaplaceDenominator",
@@ -167,4 +195,25 @@ void export_fock(py::module &m) {
         .def("get_tensor", take_string(&df_helper::DF_Helper::get_tensor))
         .def("get_tensor", tensor_access3(&df_helper::DF_Helper::get_tensor))
         .def("build_JK", &df_helper::DF_Helper::build_JK);
+
+    m.def("cg_solver",
+          [](const std::vector<SharedMatrix>& rhs, py::function hx, py::function precon, py::object guess,
+             py::object printer, int printlvl, int maxiter, double rcond) {
+              std::vector<SharedMatrix> x0;
+              if (!guess.is_none()) x0 = guess.cast<std::vector<SharedMatrix>>();
+              MatrixResidual resid = nullptr;
+              if (!printer.is_none()) {
+                  py::function f = printer.cast<py::function>();
+                  resid = [f](int iter, const std::vector<SharedMatrix>& x, const std::vector<SharedMatrix>& r) {
+                      return f(iter, x, r).cast<std::vector<double>>();
+                  };
+              }
+              return cg_solver(rhs, matrix_product(hx), matrix_product(precon), x0, resid, printlvl, maxiter,
+                               rcond);
+          },
+          "Preconditioned CG for hx(x) = rhs over lists of Matrix objects, returning (x, r). hx and precon "
+          "take (vectors, active mask) and may put False in place of masked vectors.",
+          py::arg("rhs"), py::arg("hx"), py::arg("precon"), py::arg("guess") = py::none(),
+          py::arg("printer") = py::none(), py::arg("printlvl") = 1, py::arg("maxiter") = 20,
+          py::arg("rcond") = 1.0E-6);
 }
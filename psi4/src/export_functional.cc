@@ -176,8 +176,8 @@ void export_functional(py::module &m) {
         .def("compute_Vx", &VBase::compute_Vx, "doctsring")
         .def("compute_gradient", &VBase::compute_gradient,
              "Compute the DFT nuclear gradient contribution.")
-        .def("compute_hessain", &VBase::compute_hessian,
-             "Compute the DFT nuclear Hessian contribution.")
+        .def("compute_hessian", &VBase::compute_hessian,
+             "Compute the explicit DFT nuclear Hessian contribution at fixed density.")
 
         .def("set_print", &VBase::set_print, "Sets the print level of the object.")
         .def("set_debug", &VBase::set_debug, "Sets the debug level of the object.")
@@ -192,7 +192,9 @@ void export_functional(py::module &m) {
         .def("max_points", &BasisFunctions::max_points, "docstring")
         .def("deriv", &BasisFunctions::deriv, "docstring")
         .def("set_deriv", &BasisFunctions::set_deriv, "docstring")
-        .def("compute_functions", &BasisFunctions::compute_functions, "docstring")
+        .def("compute_functions", &BasisFunctions::compute_functions, py::arg("block"),
+             py::arg("screen") = false, "docstring")
+        .def("function_map", &BasisFunctions::function_map, "docstring")
         .def("basis_values", &BasisFunctions::basis_values, "docstring");
 
     typedef void (PointFunctions::*matrix_set1)(SharedMatrix);
@@ -206,7 +208,8 @@ void export_functional(py::module &m) {
         .def("set_ansatz", &PointFunctions::set_ansatz, "docstring")
         .def("set_pointers", matrix_set1(&PointFunctions::set_pointers), "docstring")
         .def("set_pointers", matrix_set2(&PointFunctions::set_pointers), "docstring")
-        .def("compute_points", &PointFunctions::compute_points, "docstring")
+        .def("compute_points", &PointFunctions::compute_points, py::arg("block"),
+             py::arg("screen") = false, "docstring")
         .def("point_values", &PointFunctions::point_values, "docstring")
         .def("orbital_values", &PointFunctions::orbital_values, "docstring");
 
@@ -271,7 +274,8 @@ void export_functional(py::module &m) {
     py::class_<DFTGrid, std::shared_ptr<DFTGrid>, MolecularGrid>(m, "DFTGrid", "docstring")
         .def_static("build", [](std::shared_ptr<Molecule> &mol, std::shared_ptr<BasisSet> &basis) {
             return DFTGrid(mol, basis, Process::environment.options);
-        });
+        })
+        .def_static("clear_cache", &DFTGrid::clear_cache, "Drops all grids held in the DFT grid cache.");
 
     py::class_<Dispersion, std::shared_ptr<Dispersion>>(m, "Dispersion", "docstring")
         .def_static("build", &Dispersion::build, py::arg("type"), py::arg("s6") = 0.0,
@@ -297,6 +301,8 @@ void export_functional(py::module &m) {
         .def("s8", &Dispersion::get_s8, "docstring")
         .def("a1", &Dispersion::get_a1, "docstring")
         .def("a2", &Dispersion::get_a2, "docstring")
+        .def("cutoff", &Dispersion::get_cutoff, "Pair distance cutoff [a0], 0 for none.")
+        .def("set_cutoff", &Dispersion::set_cutoff, "Drop atom pairs farther apart than cutoff [a0], 0 for none.")
         .def("print_out", &Dispersion::py_print, "docstring");
 
     py::class_<sapt::FDDS_Dispersion, std::shared_ptr<sapt::FDDS_Dispersion>>(m, "FDDS_Dispersion",
@@ -192,6 +192,86 @@ construct_basisset_from_pydict(const std::shared_ptr <Molecule> &mol, py::dict &
     return basisset;
 }
 
+namespace {
+
+/// Row-major strides of a double array of the given shape
+std::vector<size_t> c_strides(const std::vector<size_t>& shape) {
+    std::vector<size_t> strides(shape.size(), sizeof(double));
+    for (int i = (int)shape.size() - 2; i >= 0; --i) strides[i] = strides[i + 1] * shape[i + 1];
+    return strides;
+}
+
+/// Stands in for the data of empty blocks, which have no storage
+double empty_block = 0.0;
+
+/// The Matrix memory itself (one irrep only), for the buffer protocol
+py::buffer_info matrix_buffer(Matrix& m) {
+    if (m.nirrep() != 1)
+        throw PSIEXCEPTION("Matrix buffer protocol is only valid with one irrep, use .nph for the blocks.");
+
+    std::vector<size_t> shape;
+    if (m.numpy_shape().size()) {
+        for (int val : m.numpy_shape()) shape.push_back((size_t)val);
+    } else {
+        shape = {(size_t)m.rowdim(0), (size_t)m.coldim(0)};
+    }
+    double* ptr = (m.rowdim(0) * m.coldim(0) != 0) ? m.pointer(0)[0] : &empty_block;
+    return py::buffer_info(ptr, sizeof(double), py::format_descriptor<double>::format(), shape.size(), shape,
+                           c_strides(shape));
+}
+
+/// The Vector memory itself (one irrep only), for the buffer protocol
+py::buffer_info vector_buffer(Vector& v) {
+    if (v.nirrep() != 1)
+        throw PSIEXCEPTION("Vector buffer protocol is only valid with one irrep, use .nph for the blocks.");
+
+    std::vector<size_t> shape;
+    if (v.numpy_shape().size()) {
+        for (int val : v.numpy_shape()) shape.push_back((size_t)val);
+    } else {
+        shape = {(size_t)v.dim(0)};
+    }
+    double* ptr = (v.dim(0) != 0) ? v.pointer(0) : &empty_block;
+    return py::buffer_info(ptr, sizeof(double), py::format_descriptor<double>::format(), shape.size(), shape,
+                           c_strides(shape));
+}
+
+/** Returns a Matrix that works on the memory of the buffers (one 2D,
+ * C-contiguous float64 buffer per irrep) instead of a copy of it.
+ * The buffers stay locked for as long as the Matrix is alive.
+ */
+SharedMatrix matrix_from_buffers(std::vector<py::buffer> buffers, const std::string& name) {
+    typedef std::vector<std::unique_ptr<py::buffer_info>> Views;
+    // The last reference may be dropped on the C++ side, releasing the views needs the GIL
+    std::shared_ptr<Views> views(new Views, [](Views* p) {
+        py::gil_scoped_acquire gil;
+        delete p;
+    });
+
+    int nirrep = buffers.size();
+    Dimension rows(nirrep), cols(nirrep);
+    std::vector<double*> blocks(nirrep, nullptr);
+    for (int h = 0; h < nirrep; ++h) {
+        std::unique_ptr<py::buffer_info> info(new py::buffer_info(buffers[h].request(true)));
+        if (info->ndim != 2 || info->itemsize != sizeof(double) ||
+            info->format != py::format_descriptor<double>::format())
+            throw PSIEXCEPTION("Matrix.from_buffer: Buffers must be two-dimensional float64 arrays.");
+
+        rows[h] = info->shape[0];
+        cols[h] = info->shape[1];
+        if (rows[h] != 0 && cols[h] != 0) {
+            bool contiguous = (cols[h] == 1 || (size_t)info->strides[1] == sizeof(double)) &&
+                              (rows[h] == 1 || (size_t)info->strides[0] == sizeof(double) * cols[h]);
+            if (!contiguous) throw PSIEXCEPTION("Matrix.from_buffer: Buffers must be C-contiguous.");
+            blocks[h] = static_cast<double*>(info->ptr);
+        }
+        views->push_back(std::move(info));
+    }
+
+    return Matrix::wrap(name, rows, cols, blocks, views);
+}
+
+}  // namespace
 
 void export_mints(py::module& m)
 {
@@ -237,7 +317,8 @@ void export_mints(py::module& m)
         .def("__getitem__", &Dimension::get, py::return_value_policy::copy, "Get the i'th value", py::arg("i"))
         .def("__setitem__", &Dimension::set, "Set element i to value val", py::arg("i"), py::arg("val"));
 
-    py::class_<Vector, std::shared_ptr<Vector>>(m, "Vector", "Class for creating and manipulating vectors", py::dynamic_attr())
+    py::class_<Vector, std::shared_ptr<Vector>>(m, "Vector", "Class for creating and manipulating vectors", py::dynamic_attr(),
+                                                py::buffer_protocol())
         .def(py::init<int>())
         .def(py::init<const Dimension&>())
         .def(py::init<const std::string&, int>())
@@ -294,7 +375,8 @@ void export_mints(py::module& m)
             }
 
             return ret;
-        }, py::return_value_policy::reference_internal);
+        }, py::return_value_policy::reference_internal)
+        .def_buffer([](Vector& v) { return vector_buffer(v); });
 
     typedef void (IntVector::*int_vector_set)(int, int, int);
     py::class_<IntVector, std::shared_ptr<IntVector>>(m, "IntVector", "Class handling vectors with integer values")
@@ -339,6 +421,14 @@ void export_mints(py::module& m)
         .def(py::init<const std::string&, const Dimension&, const Dimension&>())
         .def(py::init<const std::string&>())
         .def("clone", &Matrix::clone, "Creates exact copy of the matrix and returns it")
+        .def_static("from_buffer",
+                    [](py::buffer buffer, const std::string& name) { return matrix_from_buffers({buffer}, name); },
+                    "Builds a Matrix on the memory of a C-contiguous float64 array, without copying",
+                    py::arg("buffer"), py::arg("name") = "New Matrix")
+        .def_static("from_buffer", &matrix_from_buffers,
+                    "Builds an irreped Matrix on the memory of C-contiguous float64 arrays (one per irrep), "
+                    "without copying", py::arg("buffers"), py::arg("name") = "New Matrix")
+        .def("is_wrapped", &Matrix::is_wrapped, "Is the data owned by an outside buffer (see from_buffer)?")
         .def_property("name", py::cpp_function(&Matrix::name), py::cpp_function(&Matrix::set_name),
                       "The name of the Matrix. Used in printing.")
 
@@ -485,7 +575,8 @@ void export_mints(py::module& m)
             }
 
             return ret;
-    }, py::return_value_policy::reference_internal);
+    }, py::return_value_policy::reference_internal)
+        .def_buffer([](Matrix& m) { return matrix_buffer(m); });
 
     py::class_<Deriv, std::shared_ptr<Deriv>>(m, "Deriv", "Computes gradients of wavefunctions")
         .def(py::init<std::shared_ptr<Wavefunction>>())
@@ -738,6 +829,8 @@ void export_mints(py::module& m)
         // Integral builders
         .def("integral", &MintsHelper::integral, "Integral factory being used")
         .def("integrals", &MintsHelper::integrals, "Molecular integrals")
+        .def("integrals_blocked", &MintsHelper::integrals_blocked,
+             "Molecular integrals as dense symmetry blocks for libtrans (file PSIF_SO_TEI_BLOCKED)")
         .def("integrals_erf", &MintsHelper::integrals_erf, "ERF integrals", py::arg("w") = -1.0)
         .def("integrals_erfc", &MintsHelper::integrals_erfc, "ERFC integrals", py::arg("w") = -1.0)
         .def("one_electron_integrals", &MintsHelper::one_electron_integrals, "Standard one-electron integrals")
@@ -775,6 +868,17 @@ void export_mints(py::module& m)
         .def("ao_eri", normal_eri(&MintsHelper::ao_eri), "AO ERI integrals")
         .def("ao_eri", normal_eri2(&MintsHelper::ao_eri), "AO ERI integrals",
               py::arg("bs1"), py::arg("bs2"), py::arg("bs3"), py::arg("bs4"))
+        .def("ao_eri_packed", &MintsHelper::ao_eri_packed,
+             "Unique AO ERI integrals (mn|rs), m >= n, r >= s, mn >= rs, in canonical triangular order")
+        .def("ao_eri_slab", &MintsHelper::ao_eri_slab,
+             "AO ERI rows (mn|rs) for m on shells [Mstart, Mstop), shaped (nm, nbf, nbf, nbf)",
+             py::arg("Mstart"), py::arg("Mstop"))
+        .def("ao_3index_slab", &MintsHelper::ao_3index_slab,
+             "Unfitted (Q|mn) for Q on auxiliary shells [Pstart, Pstop), shaped (nQ, nbf, nbf)",
+             py::arg("aux"), py::arg("Pstart"), py::arg("Pstop"))
+        .def("mo_3index_slab", &MintsHelper::mo_3index_slab,
+             "Unfitted (Q|ij) for Q on auxiliary shells [Pstart, Pstop), shaped (nQ, n1, n2)",
+             py::arg("aux"), py::arg("Pstart"), py::arg("Pstop"), py::arg("C1"), py::arg("C2"))
         .def("ao_eri_shell", &MintsHelper::ao_eri_shell, "AO ERI Shell", py::arg("M"), py::arg("N"), py::arg("P"), py::arg("Q") )
         .def("ao_erf_eri", &MintsHelper::ao_erf_eri, "AO ERF integrals", py::arg("omega"))
         .def("ao_f12", normal_f12(&MintsHelper::ao_f12), "AO F12 integrals", py::arg("corr"))
@@ -1146,8 +1250,10 @@ void export_mints(py::module& m)
         .def(py::init<>())
         .def("setName", &ExternalPotential::setName, "Sets the name")
         .def("addCharge", &ExternalPotential::addCharge, "Add a charge Z at (x,y,z)", py::arg("Z"), py::arg("x"), py::arg("y"), py::arg("z"))
+        .def("updateCharge", &ExternalPotential::updateCharge, "Move charge i to (x,y,z), keeping its Z", py::arg("i"), py::arg("x"), py::arg("y"), py::arg("z"))
         .def("addBasis", &ExternalPotential::addBasis, "Add a basis of S auxiliary functions iwth Df coefficients", py::arg("basis"), py::arg("coefs") )
         .def("clear", &ExternalPotential::clear, "Reset the field to zero (eliminates all entries)")
+        .def("clearCache", &ExternalPotential::clearCache, "Drop the cached potential matrix, the next one is built from scratch")
         .def("computePotentialMatrix", &ExternalPotential::computePotentialMatrix, "Compute the external potential matrix in the given basis set", py::arg("basis"))
         .def("print_out", &ExternalPotential::py_print, "Print python print helper to the outfile");
 
@@ -29,6 +29,10 @@
 #include "psi4/pybind11.h"
 
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/exception.h"
+
+#include <string>
+#include <vector>
 
 using namespace psi;
 
@@ -43,6 +47,44 @@ void export_psio(py::module &m) {
         .def("tocprint", &PSIO::tocprint, "docstring")
         .def("tocwrite", &PSIO::tocwrite, "docstring")
         .def("set_pid", &PSIO::set_pid, "docstring")
+        .def("set_mmap",
+             [](PSIO &psio, int unit, bool mmap) {
+                 psio.filecfg_kwd("DEFAULT", "MMAP", unit, mmap ? "TRUE" : "FALSE");
+             },
+             py::arg("unit"), py::arg("mmap"),
+             "Serve reads on unit (-1 for all units) from a memory mapping, from the next time it is opened")
+        .def("mapped", &PSIO::mapped, "Returns 1 if reads on unit are served from a memory mapping")
+        .def("set_incore",
+             [](PSIO &psio, int unit, bool incore) {
+                 psio.filecfg_kwd("DEFAULT", "INCORE", unit, incore ? "TRUE" : "FALSE");
+             },
+             py::arg("unit"), py::arg("incore"),
+             "Hold unit (-1 for all units) entirely in memory, from the next time it is opened")
+        .def("in_core", &PSIO::in_core, "Returns 1 if unit is held entirely in memory")
+        .def("set_resident",
+             [](PSIO &psio, int unit, bool resident) {
+                 psio.filecfg_kwd("DEFAULT", "RESIDENT", unit, resident ? "TRUE" : "FALSE");
+             },
+             py::arg("unit"), py::arg("resident"),
+             "Keep unit (-1 for all units) in process memory, not on disk, when it is closed and kept, "
+             "from the next time it is opened (overrides SCRATCH_IN_MEMORY)")
+        .def("set_striping",
+             [](PSIO &psio, int unit, const std::vector<std::string> &volumes, int stripe) {
+                 if (volumes.size() + 1 > PSIO_MAXVOL)
+                     throw PSIEXCEPTION("IO.set_striping: at most " + std::to_string(PSIO_MAXVOL - 1) +
+                                        " volumes besides the scratch directory.");
+                 if (stripe < 1) throw PSIEXCEPTION("IO.set_striping: stripe must be at least one page.");
+                 psio.filecfg_kwd("DEFAULT", "NVOLUME", unit, std::to_string(volumes.size() + 1).c_str());
+                 for (size_t i = 0; i < volumes.size(); i++) {
+                     std::string kwd = "VOLUME" + std::to_string(i + 2);
+                     psio.filecfg_kwd("DEFAULT", kwd.c_str(), unit, volumes[i].c_str());
+                 }
+                 psio.filecfg_kwd("DEFAULT", "STRIPE", unit, std::to_string(stripe).c_str());
+             },
+             py::arg("unit"), py::arg("volumes"), py::arg("stripe") = 1,
+             "Stripe unit (-1 for all units) over the scratch directory and each of the directories volumes, "
+             "stripe 64 KiB pages at a time, from the next time it is opened")
+        .def("resident", &PSIO::resident, "Returns 1 if unit stays in process memory when closed and kept")
         .def_static("shared_object", &PSIO::shared_object, "docstring")
         .def_static("get_default_namespace", &PSIO::get_default_namespace, "docstring")
         .def_static("set_default_namespace", &PSIO::set_default_namespace, py::arg("ns"),
@@ -34,6 +34,7 @@
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/adc/adc.h"
 #include "psi4/libmints/molecule.h"
+#include "psi4/lib3index/df_helper.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
 namespace psi{ namespace adc {
@@ -105,6 +106,10 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) :
     pole_max_ = options_.get_int("POLE_MAXITER");
     sem_max_  = options_.get_int("SEM_MAXITER");
     num_amps_ = options_.get_int("NUM_AMPS_PRINT");
+    df_ovvv_  = options_.get_str("ADC_OVVV_TYPE") == "DF";
+    naux_     = 0;
+    nocc_     = 0;
+    nvir_     = 0;
 
   if(options_["ROOTS_PER_IRREP"].size() > 0){
         int i = options_["ROOTS_PER_IRREP"].size();
@@ -169,6 +174,11 @@ void ADCWfn::release_mem()
 {
     free(poles_);
     delete _ints;
+    if(dfh_){
+        dfh_->clear();
+        dfh_.reset();
+        Bov_.reset();
+    }
     delete aocce_;
     delete avire_;
     delete bocce_;
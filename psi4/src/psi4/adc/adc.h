@@ -29,6 +29,8 @@
 #ifndef ADC_H
 #define ADC_H
 
+#include <vector>
+
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/wavefunction.h"
@@ -50,6 +52,10 @@ class IntegralTransform;
 typedef std::shared_ptr<Matrix> SharedMatrix;
 typedef std::shared_ptr<Vector> SharedVector;
 
+namespace df_helper {
+class DF_Helper;
+}
+
 namespace adc{
 
 struct pole{
@@ -77,7 +83,16 @@ protected:
     double rhf_init_tensors();
     double rhf_differentiate_omega(int irrep, int root);
     void rhf_diagonalize(int irrep, int num_root, bool first, double omega_in, double *eps);
-    void rhf_construct_sigma(int irrep, int root);
+    void rhf_construct_sigma(int irrep, int first, int last);
+    void rhf_sigma_z(int irrep, int root, SharedMatrix X);
+    void rhf_sigma_b(int irrep, int root, SharedMatrix Y);
+    // Density-fitted <OV|VV> terms, see df_ovvv.cc
+    void rhf_df_init();
+    int rhf_df_batch(int nvec);
+    std::vector<SharedMatrix> rhf_df_bvv(std::vector<dpdfile2*>& B);
+    void rhf_df_z(dpdbuf4 *Z, SharedMatrix X);
+    void rhf_df_y(dpdbuf4 *Z, SharedMatrix Y);
+    void rhf_df_sigma(std::vector<SharedMatrix>& Y, std::vector<dpdfile2*>& S);
     void shift_denom2(int root, int irrep, double omega);
     void shift_denom4(int irrep, double omega);
 
@@ -127,6 +142,16 @@ protected:
     IntegralTransform *_ints;
     // Guesses for the correlated excitation energies, which are given as CIS/ADC(1) energies
     SharedVector omega_guess_;
+    // Are the <OV|VV> integrals density fitted (ADC_OVVV_TYPE DF)?
+    bool df_ovvv_;
+    // Source of the fitted (Q|vv) blocks
+    std::shared_ptr<df_helper::DF_Helper> dfh_;
+    // The fitted (Q|ov), kept in core, orbitals in DPD order
+    SharedMatrix Bov_;
+    // Number of auxiliary functions
+    size_t naux_;
+    // Number of active occupied and virtual MOs
+    int nocc_, nvir_;
 };
 
 }}
@@ -26,6 +26,8 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+
 #include "adc.h"
 
 #include "psi4/psi4-dec.h"
@@ -45,12 +47,59 @@ namespace psi{ namespace adc{
 //
 
 void
-ADCWfn::rhf_construct_sigma(int irrep, int root)
+ADCWfn::rhf_construct_sigma(int irrep, int first, int last)
+{
+    char lbl[32];
+
+    if(!df_ovvv_){
+        for(int I = first;I < last;I++){
+            rhf_sigma_z(irrep, I, SharedMatrix());
+            rhf_sigma_b(irrep, I, SharedMatrix());
+        }
+        return;
+    }
+
+    // Each pass over the fitted (Q|vv) serves every trial vector of the batch
+    int nbatch = rhf_df_batch(last - first);
+    for(int start = first;start < last;start += nbatch){
+        int stop = std::min(last, start + nbatch);
+        std::vector<dpdfile2> B(stop - start), S(stop - start);
+        std::vector<dpdfile2*> Bp, Sp;
+        for(int I = start;I < stop;I++){
+            sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
+            global_dpd_->file2_init(&B[I-start], PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+            Bp.push_back(&B[I-start]);
+        }
+        std::vector<SharedMatrix> XY = rhf_df_bvv(Bp);
+        for(int I = start;I < stop;I++)
+            global_dpd_->file2_close(&B[I-start]);
+
+        // X of a root is done with once its Z is built, so Y takes its place
+        for(int I = start;I < stop;I++){
+            rhf_sigma_z(irrep, I, XY[I-start]);
+            rhf_sigma_b(irrep, I, XY[I-start]);
+        }
+
+        for(int I = start;I < stop;I++){
+            sprintf(lbl, "S^(%d)_[%d]12", I, irrep);
+            global_dpd_->file2_init(&S[I-start], PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+            Sp.push_back(&S[I-start]);
+        }
+        rhf_df_sigma(XY, Sp);
+        for(int I = start;I < stop;I++)
+            global_dpd_->file2_close(&S[I-start]);
+    }
+}
+
+// CIS and 3h-3p terms of the sigma vector, and the 2h-2p intermediate Z;
+// with ADC_OVVV_TYPE DF, X holds the fitted b_{ic} (cb|Q) of this root
+void
+ADCWfn::rhf_sigma_z(int irrep, int root, SharedMatrix X)
 {
     bool do_pr = options_.get_bool("PR");
     char lbl[32], ampname[32];
-    dpdfile2 B, S, D, E, Bt, C;
-    dpdbuf4 A, V, K, Z, BT, XT;
+    dpdfile2 B, S, D, E;
+    dpdbuf4 A, V, K, Z;
 
     sprintf(lbl, "S^(%d)_[%d]12", root, irrep);
     global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
@@ -93,18 +142,43 @@ ADCWfn::rhf_construct_sigma(int irrep, int root)
     global_dpd_->buf4_close(&K);
     global_dpd_->buf4_close(&V);
 
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
     sprintf(lbl, "ZOOVV_[%d]1234", irrep);
     global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
-    // ZOVOV_{jiab} <--  \sum_{c} <jc|ab> b_{ic}
-    global_dpd_->contract424(&V, &B, &Z, 1, 1, 1,  1, 0);
-    global_dpd_->buf4_close(&V);
+    if(!X){
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+        // ZOVOV_{jiab} <--  \sum_{c} <jc|ab> b_{ic}
+        global_dpd_->contract424(&V, &B, &Z, 1, 1, 1,  1, 0);
+        global_dpd_->buf4_close(&V);
+    }
 
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0, "MO Ints <OO|VO>");
     // ZOVOV_{ijab} <-- - \sum_{k} <ij|ak> b_{kb}
-    global_dpd_->contract424(&V, &B, &Z, 3, 0, 0, -1, 1);
+    global_dpd_->contract424(&V, &B, &Z, 3, 0, 0, -1, X ? 0 : 1);
     global_dpd_->buf4_close(&V);
 
+    // ZOVOV_{jiab} <--  \sum_Q (ja|Q) X^Q_{ib}
+    if(X) rhf_df_z(&Z, X);
+    global_dpd_->buf4_close(&Z);
+
+    global_dpd_->file2_close(&S);
+    global_dpd_->file2_close(&B);
+}
+
+// Folds Z through the 2h-2p denominator and adds the two 2h-2p terms to the
+// sigma vector; with ADC_OVVV_TYPE DF the <OV|VV> one is left to
+// rhf_df_sigma(), and Y receives its half-transformed \sum_{jc} (jc|Q) B_{jicb}
+void
+ADCWfn::rhf_sigma_b(int irrep, int root, SharedMatrix Y)
+{
+    char lbl[32];
+    dpdfile2 S;
+    dpdbuf4 A, V, Z;
+
+    sprintf(lbl, "S^(%d)_[%d]12", root, irrep);
+    global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+    sprintf(lbl, "ZOOVV_[%d]1234", irrep);
+    global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
+
     // B_{iajb} <-- (2Z_{ijab}-Z_{ijba}+2Z_{jiab}-Z_{jiba}) / (\omega+e_i-e_a+e_j-e_b)
     sprintf(lbl, "BOOVV_[%d]1234", irrep);
     global_dpd_->buf4_scmcopy(&Z, PSIF_ADC_SEM, lbl, 2.0);
@@ -119,10 +193,16 @@ ADCWfn::rhf_construct_sigma(int irrep, int root)
     global_dpd_->buf4_dirprd(&A, &Z);
     global_dpd_->buf4_close(&A);
 
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
-    // \sigma_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
-    global_dpd_->contract442(&Z, &V, &S, 1, 1, 1, 1);
-    global_dpd_->buf4_close(&V);
+    if(Y){
+        // Y^Q_{ib} <-- \sum_{jc} (jc|Q) B_{jicb}
+        rhf_df_y(&Z, Y);
+    }
+    else{
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+        // \sigma_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
+        global_dpd_->contract442(&Z, &V, &S, 1, 1, 1, 1);
+        global_dpd_->buf4_close(&V);
+    }
 
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0, "MO Ints <OO|VO>");
     // \sigma_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}
@@ -131,7 +211,6 @@ ADCWfn::rhf_construct_sigma(int irrep, int root)
     global_dpd_->buf4_close(&Z);
 
     global_dpd_->file2_close(&S);
-    global_dpd_->file2_close(&B);
 }
 
 }} // End Namespaces
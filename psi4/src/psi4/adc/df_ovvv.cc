@@ -0,0 +1,348 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+
+#include "adc.h"
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libtrans/integraltransform.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/lib3index/df_helper.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/exception.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi{ namespace adc{
+
+//
+//  With ADC_OVVV_TYPE DF the two <OV|VV> terms of the sigma vector,
+//
+//    Z_{jiab}  <-- \sum_{c}   <jc|ab> b_{ic}   = \sum_Q (ja|Q) X^Q_{ib},  X^Q_{ib} = \sum_c b_{ic} (cb|Q)
+//    S_{ia}    <-- \sum_{jbc} B_{jicb} <ja|cb> = \sum_Q \sum_b Y^Q_{ib} (ba|Q), Y^Q_{ib} = \sum_{jc} (jc|Q) B_{jicb}
+//
+//  are built from fitted three-index integrals. (Q|ov) stays in core, (Q|vv) is
+//  read in blocks of Q, once per pass for all trial vectors of the batch.
+//  X and Y are (Q|ov)-shaped, with the occupied and virtual orbitals in DPD order.
+//
+
+namespace {
+
+// Dense o x v copy of an OV file2, orbitals in DPD order
+void file2_to_dense(dpdfile2 *F, double *M, int ncol)
+{
+    int G = F->my_irrep;
+    global_dpd_->file2_mat_init(F);
+    global_dpd_->file2_mat_rd(F);
+    for(int h = 0;h < F->params->nirreps;h++)
+        for(int i = 0;i < F->params->rowtot[h];i++)
+            for(int a = 0;a < F->params->coltot[h^G];a++)
+                M[(F->params->poff[h]+i)*ncol + F->params->qoff[h^G]+a] = F->matrix[h][i][a];
+    global_dpd_->file2_mat_close(F);
+}
+
+// F += M for the elements F holds
+void dense_add_file2(const double *M, dpdfile2 *F, int ncol)
+{
+    int G = F->my_irrep;
+    global_dpd_->file2_mat_init(F);
+    global_dpd_->file2_mat_rd(F);
+    for(int h = 0;h < F->params->nirreps;h++)
+        for(int i = 0;i < F->params->rowtot[h];i++)
+            for(int a = 0;a < F->params->coltot[h^G];a++)
+                F->matrix[h][i][a] += M[(F->params->poff[h]+i)*ncol + F->params->qoff[h^G]+a];
+    global_dpd_->file2_mat_wrt(F);
+    global_dpd_->file2_mat_close(F);
+}
+
+int nthreads()
+{
+    return Process::environment.get_n_threads();
+}
+
+}
+
+void
+ADCWfn::rhf_df_init()
+{
+    std::shared_ptr<BasisSet> auxiliary = get_basisset("DF_BASIS_MP2");
+    naux_ = auxiliary->nbf();
+    int nao = basisset_->nbf();
+
+    nocc_ = nvir_ = 0;
+    for(int h = 0;h < nirrep_;h++){
+        nocc_ += aoccpi_[h];
+        nvir_ += avirpi_[h];
+    }
+
+    // AO coefficients with the columns in the order of the DPD occ and vir spaces
+    SharedMatrix Cocc(new Matrix("Active occupied C (DPD order)", nao, nocc_));
+    SharedMatrix Cvir(new Matrix("Active virtual C (DPD order)", nao, nvir_));
+    int ocount = 0, vcount = 0;
+    for(int h = 0;h < nirrep_;h++){
+        int nso = nsopi_[h];
+        if(nso){
+            double **U = AO2SO_->pointer(h);
+            double **C = Ca_->pointer(h);
+            if(aoccpi_[h])
+                C_DGEMM('N', 'N', nao, aoccpi_[h], nso, 1.0, U[0], nso, &C[0][frzcpi_[h]], nmopi_[h],
+                        0.0, &Cocc->pointer()[0][ocount], nocc_);
+            if(avirpi_[h])
+                C_DGEMM('N', 'N', nao, avirpi_[h], nso, 1.0, U[0], nso, &C[0][doccpi_[h]], nmopi_[h],
+                        0.0, &Cvir->pointer()[0][vcount], nvir_);
+        }
+        ocount += aoccpi_[h];
+        vcount += avirpi_[h];
+    }
+
+    size_t doubles = memory_ / 16L;
+    if((size_t) naux_ * nocc_ * nvir_ > doubles / 2)
+        throw PSIEXCEPTION("ADC: Not enough memory to hold (Q|ov) with ADC_OVVV_TYPE DF");
+
+    outfile->Printf( "\n\t==> Fitting (OV|Q) and (VV|Q) Integrals <==\n");
+    outfile->Printf( "\tNAUX = %zu from %s\n", naux_, auxiliary->name().c_str());
+
+    size_t wMO = std::max(nocc_, nvir_);
+    dfh_ = df_helper::DF_Helper::get_shared(basisset_, auxiliary, wMO);
+    if(!dfh_){
+        dfh_ = std::make_shared<df_helper::DF_Helper>(basisset_, auxiliary);
+        dfh_->set_memory(doubles);
+        dfh_->set_method("STORE");
+        dfh_->set_nthreads(nthreads());
+        dfh_->set_schwarz_cutoff(options_.get_double("INTS_TOLERANCE"));
+        dfh_->set_MO_hint(wMO);
+        dfh_->initialize();
+        df_helper::DF_Helper::set_shared(dfh_);
+    }
+    dfh_->add_space("o", Cocc);
+    dfh_->add_space("v", Cvir);
+    dfh_->add_transformation("ov", "o", "v");
+    dfh_->add_transformation("vv", "v", "v");
+    dfh_->transform();
+
+    Bov_ = dfh_->get_tensor("ov");
+}
+
+int
+ADCWfn::rhf_df_batch(int nvec)
+{
+    // Half of what (Q|ov) leaves goes to X or Y, the other half to (Q|vv) blocks
+    size_t doubles = memory_ / 16L;
+    size_t ov = (size_t) nocc_ * nvir_;
+    size_t room = (doubles - naux_ * ov) / 2;
+    int nbatch = (int) std::min((size_t) nvec, room / (naux_ * ov));
+    return std::max(nbatch, 1);
+}
+
+std::vector<SharedMatrix>
+ADCWfn::rhf_df_bvv(std::vector<dpdfile2*>& B)
+{
+    size_t nvec = B.size();
+    size_t ov = (size_t) nocc_ * nvir_;
+    size_t vv = (size_t) nvir_ * nvir_;
+
+    std::vector<double> b(nvec * ov, 0.0);
+    std::vector<SharedMatrix> X;
+    for(size_t k = 0;k < nvec;k++){
+        file2_to_dense(B[k], &b[k * ov], nvir_);
+        X.push_back(SharedMatrix(new Matrix("X^Q_ib", naux_, ov)));
+    }
+
+    size_t doubles = memory_ / 16L;
+    size_t room = (doubles - naux_ * ov) / 2;
+    size_t maxQ = std::min(naux_, std::max(room / vv, (size_t) 2));
+    // get_tensor reads a (0,0) index range as the whole axis
+    maxQ = std::max(maxQ, std::min((size_t) 2, naux_));
+
+    for(size_t Qstart = 0;Qstart < naux_;Qstart += maxQ){
+        size_t nQ = std::min(maxQ, naux_ - Qstart);
+        SharedMatrix Bvv = dfh_->get_tensor("vv", std::make_pair(Qstart, Qstart + nQ - 1));
+        double **Bvvp = Bvv->pointer();
+
+        // X^Q_{ib} = \sum_c b_{ic} (cb|Q)
+        #pragma omp parallel for schedule(dynamic) num_threads(nthreads())
+        for(size_t kQ = 0;kQ < nvec * nQ;kQ++){
+            size_t k = kQ / nQ;
+            size_t Q = kQ % nQ;
+            C_DGEMM('N', 'N', nocc_, nvir_, nvir_, 1.0, &b[k * ov], nvir_, Bvvp[Q], nvir_,
+                    0.0, X[k]->pointer()[Qstart + Q], nvir_);
+        }
+    }
+
+    return X;
+}
+
+void
+ADCWfn::rhf_df_z(dpdbuf4 *Z, SharedMatrix X)
+{
+    int nthread = nthreads();
+    size_t ov = (size_t) nocc_ * nvir_;
+    double **Bp = Bov_->pointer();
+    double **Xp = X->pointer();
+    std::vector<std::vector<double> > scratch(nthread, std::vector<double>((size_t) nvir_ * nvir_));
+
+    for(int h = 0;h < nirrep_;h++){
+        long int rowtot = Z->params->rowtot[h];
+        long int coltot = Z->params->coltot[h^Z->file.my_irrep];
+        if(!rowtot || !coltot) continue;
+
+        long int rows_per_bucket = std::min(rowtot, dpd_memfree() / coltot);
+        if(!rows_per_bucket) throw PSIEXCEPTION("ADC: Not enough memory for one row of Z");
+
+        global_dpd_->buf4_mat_irrep_init_block(Z, h, rows_per_bucket);
+        for(long int first = 0;first < rowtot;first += rows_per_bucket){
+            int nrows = (int) std::min(rows_per_bucket, rowtot - first);
+            global_dpd_->buf4_mat_irrep_rd_block(Z, h, first, nrows);
+
+            // Z_{jiab} += \sum_Q (ja|Q) X^Q_{ib}
+            #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+            for(int row = 0;row < nrows;row++){
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double *T = scratch[thread].data();
+                int j = Z->params->roworb[h][first+row][0];
+                int i = Z->params->roworb[h][first+row][1];
+                C_DGEMM('T', 'N', nvir_, nvir_, naux_, 1.0, &Bp[0][j*nvir_], ov, &Xp[0][i*nvir_], ov,
+                        0.0, T, nvir_);
+                for(long int ab = 0;ab < coltot;ab++){
+                    int a = Z->params->colorb[h^Z->file.my_irrep][ab][0];
+                    int b = Z->params->colorb[h^Z->file.my_irrep][ab][1];
+                    Z->matrix[h][row][ab] += T[a*nvir_+b];
+                }
+            }
+
+            global_dpd_->buf4_mat_irrep_wrt_block(Z, h, first, nrows);
+        }
+        global_dpd_->buf4_mat_irrep_close_block(Z, h, rows_per_bucket);
+    }
+}
+
+void
+ADCWfn::rhf_df_y(dpdbuf4 *Z, SharedMatrix Y)
+{
+    int nthread = nthreads();
+    size_t ov = (size_t) nocc_ * nvir_;
+    double **Bp = Bov_->pointer();
+    double **Yp = Y->pointer();
+    std::vector<std::vector<double> > scratch(nthread, std::vector<double>((size_t) nvir_ * nvir_));
+
+    Y->zero();
+    for(int h = 0;h < nirrep_;h++){
+        long int rowtot = Z->params->rowtot[h];
+        long int coltot = Z->params->coltot[h^Z->file.my_irrep];
+        if(!rowtot || !coltot) continue;
+
+        long int rows_per_bucket = std::min(rowtot, dpd_memfree() / coltot);
+        if(!rows_per_bucket) throw PSIEXCEPTION("ADC: Not enough memory for one row of B");
+
+        global_dpd_->buf4_mat_irrep_init_block(Z, h, rows_per_bucket);
+        for(long int first = 0;first < rowtot;first += rows_per_bucket){
+            int nrows = (int) std::min(rows_per_bucket, rowtot - first);
+            global_dpd_->buf4_mat_irrep_rd_block(Z, h, first, nrows);
+
+            // Rows with the same i all add to Y^Q_{i*}, so they go to the same thread
+            std::vector<std::vector<int> > rows_of(nocc_);
+            for(int row = 0;row < nrows;row++)
+                rows_of[Z->params->roworb[h][first+row][1]].push_back(row);
+
+            // Y^Q_{ib} += \sum_{jc} (jc|Q) B_{jicb}
+            #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+            for(int i = 0;i < nocc_;i++){
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double *T = scratch[thread].data();
+                for(int row : rows_of[i]){
+                    int j = Z->params->roworb[h][first+row][0];
+                    std::fill(scratch[thread].begin(), scratch[thread].end(), 0.0);
+                    for(long int cb = 0;cb < coltot;cb++){
+                        int c = Z->params->colorb[h^Z->file.my_irrep][cb][0];
+                        int b = Z->params->colorb[h^Z->file.my_irrep][cb][1];
+                        T[c*nvir_+b] = Z->matrix[h][row][cb];
+                    }
+                    C_DGEMM('N', 'N', naux_, nvir_, nvir_, 1.0, &Bp[0][j*nvir_], ov, T, nvir_,
+                            1.0, &Yp[0][i*nvir_], ov);
+                }
+            }
+        }
+        global_dpd_->buf4_mat_irrep_close_block(Z, h, rows_per_bucket);
+    }
+}
+
+void
+ADCWfn::rhf_df_sigma(std::vector<SharedMatrix>& Y, std::vector<dpdfile2*>& S)
+{
+    int nthread = nthreads();
+    size_t nvec = S.size();
+    size_t ov = (size_t) nocc_ * nvir_;
+    size_t vv = (size_t) nvir_ * nvir_;
+
+    // One o x v accumulator per thread and vector
+    std::vector<double> s((size_t) nthread * nvec * ov, 0.0);
+
+    size_t doubles = memory_ / 16L;
+    size_t room = (doubles - naux_ * ov) / 2;
+    size_t maxQ = std::min(naux_, std::max(room / vv, (size_t) 2));
+    maxQ = std::max(maxQ, std::min((size_t) 2, naux_));
+
+    for(size_t Qstart = 0;Qstart < naux_;Qstart += maxQ){
+        size_t nQ = std::min(maxQ, naux_ - Qstart);
+        SharedMatrix Bvv = dfh_->get_tensor("vv", std::make_pair(Qstart, Qstart + nQ - 1));
+        double **Bvvp = Bvv->pointer();
+
+        // S_{ia} += \sum_b Y^Q_{ib} (ba|Q)
+        #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for(size_t kQ = 0;kQ < nvec * nQ;kQ++){
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            size_t k = kQ / nQ;
+            size_t Q = kQ % nQ;
+            C_DGEMM('N', 'N', nocc_, nvir_, nvir_, 1.0, Y[k]->pointer()[Qstart + Q], nvir_, Bvvp[Q], nvir_,
+                    1.0, &s[(thread * nvec + k) * ov], nvir_);
+        }
+    }
+
+    for(size_t k = 0;k < nvec;k++){
+        for(int thread = 1;thread < nthread;thread++)
+            C_DAXPY(ov, 1.0, &s[(thread * nvec + k) * ov], 1, &s[k * ov], 1);
+        dense_add_file2(&s[k * ov], S[k], nvir_);
+    }
+}
+
+}} // End Namespaces
@@ -84,8 +84,7 @@ ADCWfn::rhf_diagonalize(int irrep, int num_root, bool first, double omega_in, do
 
         // Evaluating the sigma vectors
         timer_on("Sigma construction");
-        for(int I = prev_length;I < length;I++)
-            if(!nopen_) rhf_construct_sigma(irrep, I);
+        if(!nopen_) rhf_construct_sigma(irrep, prev_length, length);
         timer_off("Sigma construction");
 
         // Making so called Davidson mini-Hamiltonian, or Rayleigh matrix
@@ -54,18 +54,30 @@ ADCWfn::rhf_differentiate_omega(int irrep, int root)
     sprintf(lbl, "D^(%d)_[%d]12", root, irrep);
     global_dpd_->file2_init(&D, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
 
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+    // With ADC_OVVV_TYPE DF, XY holds \sum_c v_{ic} (cb|Q), later \sum_{jc} (jc|Q) dB_{jicb}
+    SharedMatrix XY;
+    if(df_ovvv_){
+        std::vector<dpdfile2*> V1(1, &S);
+        XY = rhf_df_bvv(V1)[0];
+    }
+
     sprintf(lbl, "ZOOVV_[%d]1234", irrep);
     global_dpd_->buf4_init(&Z, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
-    // ZOVOV_{jiab} <--   \sum_{c} <jc|ab> v_{ic}
-    global_dpd_->contract424(&V, &S, &Z, 1, 1, 1,  1, 0);
-    global_dpd_->buf4_close(&V);
+    if(!df_ovvv_){
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+        // ZOVOV_{jiab} <--   \sum_{c} <jc|ab> v_{ic}
+        global_dpd_->contract424(&V, &S, &Z, 1, 1, 1,  1, 0);
+        global_dpd_->buf4_close(&V);
+    }
 
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0, "MO Ints <OO|VO>");
     // ZOVOV_{ijab} <-- - \sum_{k} <ij|ak> v_{kb}
-    global_dpd_->contract424(&V, &S, &Z, 3, 0, 0, -1, 1);
+    global_dpd_->contract424(&V, &S, &Z, 3, 0, 0, -1, df_ovvv_ ? 0 : 1);
     global_dpd_->buf4_close(&V);
 
+    // ZOVOV_{jiab} <--   \sum_Q (ja|Q) X^Q_{ib}
+    if(df_ovvv_) rhf_df_z(&Z, XY);
+
     // dB_{iajb} <-- - (2Z_{ijab}-Z_{ijba}+2Z_{jiab}-Z_{jiba}) / (\omega+e_i-e_a+e_j-e_b)^2
     sprintf(lbl, "BOOVV_[%d]1234", irrep);
     global_dpd_->buf4_scmcopy(&Z, PSIF_ADC_SEM, lbl, -2.0);
@@ -81,10 +93,20 @@ ADCWfn::rhf_differentiate_omega(int irrep, int root)
     global_dpd_->buf4_dirprd(&A, &Z);
     global_dpd_->buf4_close(&A);
 
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
-    // \dV_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
-    global_dpd_->contract442(&Z, &V, &D, 1, 1, 1, 0);
-    global_dpd_->buf4_close(&V);
+    if(df_ovvv_){
+        // \dV_{ia} <-- \sum_Q \sum_b Y^Q_{ib} (ba|Q)
+        std::vector<SharedMatrix> Y(1, XY);
+        std::vector<dpdfile2*> D1(1, &D);
+        rhf_df_y(&Z, XY);
+        global_dpd_->file2_scm(&D, 0.0);
+        rhf_df_sigma(Y, D1);
+    }
+    else{
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+        // \dV_{ia} <-- \sum_{jbc} B_{jicb} <ja|cb>
+        global_dpd_->contract442(&Z, &V, &D, 1, 1, 1, 0);
+        global_dpd_->buf4_close(&V);
+    }
 
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0, "MO Ints <OO|VO>");
     // \dV_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}
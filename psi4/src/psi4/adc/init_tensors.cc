@@ -61,9 +61,14 @@ ADCWfn::rhf_init_tensors()
     // Make (OO|OV) integrals
     outfile->Printf( "\n\t==> Transforming (OV|OO) Integrals <==\n");
     _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::occ);
-    // Make (OV|VV) integrals
-    outfile->Printf( "\n\t==> Transforming (OV|VV) Integrals <==\n");
-    _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::vir, MOSpace::vir);
+    // Make (OV|VV) integrals, or fit them
+    if(df_ovvv_){
+        rhf_df_init();
+    }
+    else{
+        outfile->Printf( "\n\t==> Transforming (OV|VV) Integrals <==\n");
+        _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::vir, MOSpace::vir);
+    }
 
 
     // Preparing MP1 amplitudes then calculating MP2 energy
@@ -198,9 +203,11 @@ ADCWfn::rhf_init_tensors()
     global_dpd_->buf4_close(&V);
 
     // Sort(prqs): <OV|VV> <-- (OV|VV)
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
-    global_dpd_->buf4_sort(&V, PSIF_LIBTRANS_DPD, prqs, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
-    global_dpd_->buf4_close(&V);
+    if(!df_ovvv_){
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
+        global_dpd_->buf4_sort(&V, PSIF_LIBTRANS_DPD, prqs, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
+        global_dpd_->buf4_close(&V);
+    }
 
     return energy;
 }
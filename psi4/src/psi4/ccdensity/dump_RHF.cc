@@ -69,6 +69,11 @@ namespace psi { namespace ccdensity {
     ** be better to let the dump function handle this part to reduce
     ** disk usage.
     **
+    ** GIjKl and GAbCd now do exactly that: bk_pack together with
+    ** swap23 writes the lower triangle of (pr|qs) straight from the
+    ** (pq,rs)-ordered density, so the largest component, Gabcd, is
+    ** no longer copied to CC_TMP0 before it is dumped.
+    **
     ** Finally, I note that Gibja is multiplied by 0.5 before it is
     ** dumped to disk.  I don't remember why this is necessary.
     **
@@ -99,10 +104,7 @@ namespace psi { namespace ccdensity {
 	psio_close(PSIF_MO_LAG, 1);
 
 	global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, 0, 0, 0, 0, 0, 0, "GIjKl");
-	global_dpd_->buf4_sort(&G, PSIF_CC_TMP0, prqs, 0, 0, "G(IK,JL)");
-	global_dpd_->buf4_close(&G);
-	global_dpd_->buf4_init(&G, PSIF_CC_TMP0, 0, 0, 0, 0, 0, 0, "G(IK,JL)");
-	global_dpd_->buf4_dump(&G, OutBuf, qt_occ, qt_occ, qt_occ, qt_occ, 1, 0);
+	global_dpd_->buf4_dump(&G, OutBuf, qt_occ, qt_occ, qt_occ, qt_occ, 1, 1);
 	global_dpd_->buf4_close(&G);
 
 	global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, 0, 0, 10, 0, 10, 0, "GIjKa");
@@ -136,10 +138,7 @@ namespace psi { namespace ccdensity {
 	global_dpd_->buf4_close(&G);
 
 	global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, 0, 5, 5, 5, 5, 0, "GAbCd");
-	global_dpd_->buf4_sort(&G, PSIF_CC_TMP0, prqs, 5, 5, "G(AC,BD)");
-	global_dpd_->buf4_close(&G);
-	global_dpd_->buf4_init(&G, PSIF_CC_TMP0, 0, 5, 5, 5, 5, 0, "G(AC,BD)");
-	global_dpd_->buf4_dump(&G, OutBuf, qt_vir, qt_vir, qt_vir, qt_vir, 1, 0);
+	global_dpd_->buf4_dump(&G, OutBuf, qt_vir, qt_vir, qt_vir, qt_vir, 1, 1);
 	global_dpd_->buf4_close(&G);
 
       }
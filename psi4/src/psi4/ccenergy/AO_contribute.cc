@@ -36,23 +36,139 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libiwl/iwl.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/sobasis.h"
+#include "psi4/libmints/sointegral_twobody.h"
 #include "ccwave.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi { namespace ccenergy {
 
+namespace {
+
+/*
+** Adds one canonical (p>=q, r>=s, pq>=rs) SO integral to tau2 for every
+** permutation it stands for: tau2(pr,ij) += (pq|rs) tau1(qs,ij).  Doubles
+** as the TwoBodySOInt functor.  When locks are given (one per row of tau2,
+** rowoff_ the first row of each irrep) rows are updated under their lock,
+** so that one tau2 can be fed by several threads.
+*/
+class AOContributor {
+    dpdbuf4 *tau1_, *tau2_;
+    const size_t *rowoff_;
+#ifdef _OPENMP
+    omp_lock_t *locks_;
+#endif
+    size_t count_;
+
+    void add(int G, int src, int dst, double value)
+    {
+        int ncol = tau1_->params->coltot[G];
+        if(!ncol) return;
+#ifdef _OPENMP
+        if(locks_) omp_set_lock(&locks_[rowoff_[G] + dst]);
+#endif
+        C_DAXPY(ncol, value, tau1_->matrix[G][src], 1, tau2_->matrix[G][dst], 1);
+#ifdef _OPENMP
+        if(locks_) omp_unset_lock(&locks_[rowoff_[G] + dst]);
+#endif
+    }
+
+public:
+    AOContributor(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO, const size_t *rowoff = nullptr, void *locks = nullptr)
+        : tau1_(tau1_AO), tau2_(tau2_AO), rowoff_(rowoff), count_(0)
+    {
+#ifdef _OPENMP
+        locks_ = static_cast<omp_lock_t *>(locks);
+#endif
+    }
+
+    size_t count() const { return count_; }
+
+    void contribute(int p, int q, int r, int s, double value)
+    {
+        count_++;
+
+        dpdparams4 *params = tau1_->params;
+        int Gp = params->psym[p];
+        int Gq = params->psym[q];
+        int Gr = params->psym[r];
+        int Gs = params->psym[s];
+
+        int Gpr = Gp^Gr;
+        int Gps = Gp^Gs;
+        int Gqr = Gq^Gr;
+        int Gqs = Gq^Gs;
+
+        int pq = params->rowidx[p][q];
+        int rs = params->rowidx[r][s];
+
+        int pr = params->rowidx[p][r];
+        int rp = params->rowidx[r][p];
+        int ps = params->rowidx[p][s];
+        int sp = params->rowidx[s][p];
+        int qr = params->rowidx[q][r];
+        int rq = params->rowidx[r][q];
+        int qs = params->rowidx[q][s];
+        int sq = params->rowidx[s][q];
+
+        /* (pq|rs) */
+        add(Gpr, qs, pr, value);
+
+        if(p!=q && r!=s && pq != rs) {
+            add(Gps, qr, ps, value);  /* (pq|sr) */
+            add(Gqr, ps, qr, value);  /* (qp|rs) */
+            add(Gqs, pr, qs, value);  /* (qp|sr) */
+            add(Gpr, sq, rp, value);  /* (rs|pq) */
+            add(Gps, rq, sp, value);  /* (sr|pq) */
+            add(Gqr, sp, rq, value);  /* (rs|qp) */
+            add(Gqs, rp, sq, value);  /* (sr|qp) */
+        }
+        else if(p!=q && r!=s && pq==rs) {
+            add(Gps, qr, ps, value);  /* (pq|sr) */
+            add(Gqr, ps, qr, value);  /* (qp|rs) */
+            add(Gqs, pr, qs, value);  /* (qp|sr) */
+        }
+        else if(p!=q && r==s) {
+            add(Gqr, ps, qr, value);  /* (qp|rs) */
+            add(Gpr, sq, rp, value);  /* (rs|pq) */
+            add(Gqr, sp, rq, value);  /* (rs|qp) */
+        }
+        else if(p==q && r!=s) {
+            add(Gps, qr, ps, value);  /* (pq|sr) */
+            add(Gpr, sq, rp, value);  /* (rs|pq) */
+            add(Gps, rq, sp, value);  /* (sr|pq) */
+        }
+        else if(p==q && r==s && pq != rs) {
+            add(Gpr, sq, rp, value);  /* (rs|pq) */
+        }
+    }
+
+    void operator()(int p, int q, int r, int s, int, int, int, int, int, int, int, int, double value)
+    {
+        contribute(p, q, r, s, value);
+    }
+};
+
+}
+
 int CCEnergyWavefunction::AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO)
 {
   int idx, p, q, r, s;
-  double value;
   Value *valptr;
   Label *lblptr;
-  int Gp, Gq, Gr, Gs, Gpr, Gps, Gqr, Gqs, Grp, Gsp, Grq, Gsq;
-  int pr, ps, qr, qs, rp, rq, sp, sq, pq, rs;
-  int count=0;
+  AOContributor body(tau1_AO, tau2_AO);
 
   lblptr = InBuf->labels;
   valptr = InBuf->values;
@@ -63,145 +179,95 @@ int CCEnergyWavefunction::AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO,
     r = (int) lblptr[idx++];
     s = (int) lblptr[idx++];
 
-    value = (double) valptr[InBuf->idx];
-    /*
-    if(std::fabs(value) > 1e-8)
-        outfile->Printf(stdout, "%d %d %d %d %20.14f\n", p, q, r, s, value);
-    */
-    count++;
-
-    Gp = tau1_AO->params->psym[p];
-    Gq = tau1_AO->params->psym[q];
-    Gr = tau1_AO->params->psym[r];
-    Gs = tau1_AO->params->psym[s];
-
-    Gpr = Grp = Gp^Gr;
-    Gps = Gsp = Gp^Gs;
-    Gqr = Grq = Gq^Gr;
-    Gqs = Gsq = Gq^Gs;
-
-    pq = tau1_AO->params->rowidx[p][q];
-    rs = tau1_AO->params->rowidx[r][s];
-
-    pr = tau1_AO->params->rowidx[p][r];
-    rp = tau1_AO->params->rowidx[r][p];
-    ps = tau1_AO->params->rowidx[p][s];
-    sp = tau1_AO->params->rowidx[s][p];
-    qr = tau1_AO->params->rowidx[q][r];
-    rq = tau1_AO->params->rowidx[r][q];
-    qs = tau1_AO->params->rowidx[q][s];
-    sq = tau1_AO->params->rowidx[s][q];
-
-    /* (pq|rs) */
-    if(tau1_AO->params->coltot[Gpr])
-      C_DAXPY(tau1_AO->params->coltot[Gpr], value, tau1_AO->matrix[Gpr][qs], 1,
-	      tau2_AO->matrix[Gpr][pr], 1);
-
-    if(p!=q && r!=s && pq != rs) {
-
-      /* (pq|sr) */
-      if(tau1_AO->params->coltot[Gps])
-	C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1,
-		tau2_AO->matrix[Gps][ps], 1);
-
-      /* (qp|rs) */
-      if(tau1_AO->params->coltot[Gqr])
-	C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1,
-		tau2_AO->matrix[Gqr][qr], 1);
-
-      /* (qp|sr) */
-      if(tau1_AO->params->coltot[Gqs])
-	C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1,
-		tau2_AO->matrix[Gqs][qs], 1);
-
-      /* (rs|pq) */
-      if(tau1_AO->params->coltot[Grp])
-	C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1,
-		tau2_AO->matrix[Grp][rp], 1);
-
-      /* (sr|pq) */
-      if(tau1_AO->params->coltot[Gsp])
-	C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1,
-		tau2_AO->matrix[Gsp][sp], 1);
-
-      /* (rs|qp) */
-      if(tau1_AO->params->coltot[Grq])
-	C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1,
-		tau2_AO->matrix[Grq][rq], 1);
-
-      /* (sr|qp) */
-      if(tau1_AO->params->coltot[Gsq])
-	C_DAXPY(tau1_AO->params->coltot[Gsq], value, tau1_AO->matrix[Gsq][rp], 1,
-		tau2_AO->matrix[Gsq][sq],1 );
-
-    }
-    else if(p!=q && r!=s && pq==rs) {
-
-      /* (pq|sr) */
-      if(tau1_AO->params->coltot[Gps])
-	C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1,
-		tau2_AO->matrix[Gps][ps], 1);
-
-      /* (qp|rs) */
-      if(tau1_AO->params->coltot[Gqr])
-	C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1,
-		tau2_AO->matrix[Gqr][qr], 1);
-
-      /* (qp|sr) */
-      if(tau1_AO->params->coltot[Gqs])
-	C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1,
-		tau2_AO->matrix[Gqs][qs], 1);
-
-    }
-    else if(p!=q && r==s) {
-
-      /* (qp|rs) */
-      if(tau1_AO->params->coltot[Gqr])
-	C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1,
-		tau2_AO->matrix[Gqr][qr], 1);
-
-      /* (rs|pq) */
-      if(tau1_AO->params->coltot[Grp])
-	C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1,
-		tau2_AO->matrix[Grp][rp], 1);
-
-      /* (rs|qp) */
-      if(tau1_AO->params->coltot[Grq])
-	C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1,
-		tau2_AO->matrix[Grq][rq], 1);
-
-    }
-
-    else if(p==q && r!=s) {
-
-      /* (pq|sr) */
-      if(tau1_AO->params->coltot[Gps])
-	C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1,
-		tau2_AO->matrix[Gps][ps], 1);
-
-      /* (rs|pq) */
-      if(tau1_AO->params->coltot[Grp])
-	C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1,
-		tau2_AO->matrix[Grp][rp], 1);
+    body.contribute(p, q, r, s, (double) valptr[InBuf->idx]);
+  }
 
-      /* (sr|pq) */
-      if(tau1_AO->params->coltot[Gsp])
-	C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1,
-		tau2_AO->matrix[Gsp][sp], 1);
+  return body.count();
+}
 
+/*
+** AO_contribute_direct(): Integral-direct version of the AO_contribute()
+** loop over PSIF_SO_TEI.  The unique SO integrals are generated shell
+** quartet by shell quartet on params_.nthreads threads, (PQ| pairs handed
+** out dynamically, and quartets whose Schwarz bound falls below tolerance
+** are skipped.  The irreps of tau1_AO and tau2_AO must be in core.
+** Returns the number of integrals used.
+*/
+int CCEnergyWavefunction::AO_contribute_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO, double tolerance)
+{
+  int nthread = params_.nthreads;
+  int nirreps = tau2_AO->params->nirreps;
+
+  std::vector<std::shared_ptr<TwoBodyAOInt> > tb;
+  for(int t=0; t < nthread; t++)
+    tb.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->eri()));
+  std::shared_ptr<TwoBodySOInt> eri(new TwoBodySOInt(tb, integral_));
+  eri->set_cutoff(tolerance);
+  std::shared_ptr<SOBasisSet> sobasis = eri->basis();
+
+  /* Schwarz bound of each SO shell pair, the largest over its AO shell pairs */
+  ERISieve sieve(basisset_, tolerance);
+  int nshell = sobasis->nshell();
+  std::vector<double> pair_bound(nshell * (size_t) nshell, 0.0);
+  double max_bound = 0.0;
+  for(int P=0; P < nshell; P++) {
+    const SOTransform &TP = sobasis->sotrans(P);
+    for(int Q=0; Q <= P; Q++) {
+      const SOTransform &TQ = sobasis->sotrans(Q);
+      double bound = 0.0;
+      for(int m=0; m < TP.naoshell; m++)
+        for(int n=0; n < TQ.naoshell; n++) {
+          int M = TP.aoshell[m].aoshell;
+          int N = TQ.aoshell[n].aoshell;
+          bound = std::max(bound, std::sqrt(sieve.shell_ceiling2(M, N, M, N)));
+        }
+      pair_bound[P * (size_t) nshell + Q] = pair_bound[Q * (size_t) nshell + P] = bound;
+      max_bound = std::max(max_bound, bound);
     }
-
-    else if(p==q && r==s && pq != rs) {
-
-      /* (rs|pq) */
-      if(tau1_AO->params->coltot[Grp])
-	C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1,
-		tau2_AO->matrix[Grp][rp], 1);
-
+  }
+  double tolerance2 = tolerance * tolerance;
+
+  std::vector<std::pair<int, int> > PQ;
+  SO_PQ_Iterator PQIter(sobasis);
+  for(PQIter.first(); PQIter.is_done() == false; PQIter.next())
+    if(pair_bound[PQIter.p() * (size_t) nshell + PQIter.q()] * max_bound >= tolerance2)
+      PQ.push_back(std::make_pair(PQIter.p(), PQIter.q()));
+
+  std::vector<size_t> rowoff(nirreps + 1, 0);
+  for(int h=0; h < nirreps; h++)
+    rowoff[h+1] = rowoff[h] + tau2_AO->params->rowtot[h];
+
+  void *locks = nullptr;
+#ifdef _OPENMP
+  std::vector<omp_lock_t> row_locks(rowoff[nirreps]);
+  for(size_t row=0; row < row_locks.size(); row++) omp_init_lock(&row_locks[row]);
+  if(nthread > 1) locks = row_locks.data();
+#endif
+
+  std::vector<AOContributor> bodies(nthread, AOContributor(tau1_AO, tau2_AO, rowoff.data(), locks));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+  for(long int pq=0; pq < (long int) PQ.size(); pq++) {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    SO_RS_Iterator RSIter(PQ[pq].first, PQ[pq].second, sobasis, sobasis, sobasis, sobasis);
+    for(RSIter.first(); RSIter.is_done() == false; RSIter.next()) {
+      double bound = pair_bound[RSIter.p() * (size_t) nshell + RSIter.q()] *
+                     pair_bound[RSIter.r() * (size_t) nshell + RSIter.s()];
+      if(bound < tolerance2) continue;
+      eri->compute_shell(RSIter.p(), RSIter.q(), RSIter.r(), RSIter.s(), bodies[thread]);
     }
   }
 
-  return count;
+#ifdef _OPENMP
+  for(size_t row=0; row < row_locks.size(); row++) omp_destroy_lock(&row_locks[row]);
+#endif
+
+  size_t count = 0;
+  for(int t=0; t < nthread; t++) count += bodies[t].count();
+  return (int) count;
 }
 
 }} // namespace psi::ccenergy
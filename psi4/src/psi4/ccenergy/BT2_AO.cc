@@ -61,7 +61,6 @@ void CCEnergyWavefunction::BT2_AO(void)
     int **T2_cd_row_start, **T2_pq_row_start, offset, cd, pq;
     int **T2_CD_row_start, **T2_Cd_row_start;
     dpdbuf4 tau, t2, tau1_AO, tau2_AO;
-    dpdfile4 T;
     psio_address next;
     struct iwlbuf InBuf;
     int lastbuf;
@@ -130,7 +129,7 @@ void CCEnergyWavefunction::BT2_AO(void)
 
     if(params_.ref == 0) { /** RHF **/
 
-        if(params_.aobasis == "DISK") {
+        if(params_.aobasis == "DISK" || params_.aobasis == "DIRECT") {
 
             dpd_set_default(1);
             global_dpd_->buf4_init(&tau1_AO, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjPq (1)");
@@ -169,20 +168,25 @@ void CCEnergyWavefunction::BT2_AO(void)
                     global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
                 }
 
-                iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-                lastbuf = InBuf.lastbuf;
-
-                counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+                if(params_.aobasis == "DIRECT") {
+                    counter += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+                }
+                else {
+                    iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-                while(!lastbuf) {
-                    iwl_buf_fetch(&InBuf);
                     lastbuf = InBuf.lastbuf;
 
                     counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-                }
 
-                iwl_buf_close(&InBuf, 1);
+                    while(!lastbuf) {
+                        iwl_buf_fetch(&InBuf);
+                        lastbuf = InBuf.lastbuf;
+
+                        counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+                    }
+
+                    iwl_buf_close(&InBuf, 1);
+                }
 
                 if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <ab||cd> --> T2\n", counter);
 
@@ -215,23 +219,6 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_close(&tau2_AO);
 
         }
-        else if(params_.aobasis == "DIRECT") {
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "tauIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "New tIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            /* close the CC_TAMPS file for cints to use it */
-            psio_close(PSIF_CC_TAMPS, 1);
-
-            int statusvalue=system("cints --cc_bt2");
-
-            /* re-open CCC_TAMPS for remaining terms */
-            psio_open(PSIF_CC_TAMPS, PSIO_OPEN_OLD);
-        }
 
     }
     else if(params_.ref == 1) { /** ROHF **/
@@ -267,20 +254,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterAA += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <AB||CD> --> T2\n", counterAA);
 
@@ -341,20 +333,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterBB += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <ab||cd> --> T2\n", counterBB);
 
@@ -416,20 +413,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterAB += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <Ab|Cd> --> T2\n", counterAB);
 
@@ -492,20 +494,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterAA += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterAA += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <AB||CD> --> T2\n", counterAA);
 
@@ -566,20 +573,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterBB += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterBB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <ab||cd> --> T2\n", counterBB);
 
@@ -641,20 +653,25 @@ void CCEnergyWavefunction::BT2_AO(void)
             global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
         }
 
-        iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
-
-        lastbuf = InBuf.lastbuf;
-
-        counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+        if(params_.aobasis == "DIRECT") {
+            counterAB += AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+        }
+        else {
+            iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-        while(!lastbuf) {
-            iwl_buf_fetch(&InBuf);
             lastbuf = InBuf.lastbuf;
 
             counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-        }
 
-        iwl_buf_close(&InBuf, 1);
+            while(!lastbuf) {
+                iwl_buf_fetch(&InBuf);
+                lastbuf = InBuf.lastbuf;
+
+                counterAB += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+            }
+
+            iwl_buf_close(&InBuf, 1);
+        }
 
         if(params_.print & 2) outfile->Printf( "     *** Processed %d SO integrals for <Ab|Cd> --> T2\n", counterAB);
 
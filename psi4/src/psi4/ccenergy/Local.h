@@ -50,6 +50,8 @@ struct Local {
   int *pairdom_len;
   int *pairdom_nrlen;
   int *weak_pairs;
+  int npairs;        /* strong pairs ij, whose V, W and eps_vir are held in core */
+  int *pairs;
   double ***V;
   double ***W;
   double *eps_occ;
@@ -38,16 +38,21 @@
 
 namespace psi { namespace ccenergy {
 
+/* Length of the DIIS subspace kept by diis_RHF() and friends */
+static const int diis_nvector = 8;
+
 /* Input parameters */
 struct Params {
   int maxiter;
   double convergence;
   double e_convergence;
   int restart;
+  int checkpoint_freq;      /* iterations between amplitude checkpoints, 0 for none */
   long int memory;
   std::string aobasis;
   int cachelev;
   int cachetype;
+  int cache_adapt_iters;
   int ref;
   int diis;
   std::string wfn;
@@ -0,0 +1,78 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*! \file
+    \ingroup CCENERGY
+    \brief Enter brief description of file here
+*/
+#include "Params.h"
+#include "MOInfo.h"
+#include "ccwave.h"
+
+#include "psi4/libdpd/amp_checkpoint.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
+#include "psi4/psifiles.h"
+
+namespace psi { namespace ccenergy {
+
+/* amp_checkpoint(): The restart file for CC_CHECKPOINT_FREQ, holding the
+** T1 and T2 amplitudes of the current reference and, through DIIS, the
+** previous iterates.
+*/
+
+std::shared_ptr<AmpCheckpoint> CCEnergyWavefunction::amp_checkpoint(void)
+{
+    std::string path = get_writer_file_prefix(molecule_->name()) + ".ccamps";
+
+    std::shared_ptr<AmpCheckpoint> chk(new AmpCheckpoint(path, "CCENERGY " + params_.wfn + " " + std::to_string(params_.ref)));
+    chk->add_orbitals(Ca_);
+    if(params_.ref == 2) chk->add_orbitals(Cb_);
+
+    if(params_.ref == 0) { /** RHF **/
+        chk->add_file2(PSIF_CC_OEI, 0, 0, 1, "tIA");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 0, 5, "tIjAb");
+    }
+    else if(params_.ref == 1) { /** ROHF **/
+        chk->add_file2(PSIF_CC_OEI, 0, 0, 1, "tIA");
+        chk->add_file2(PSIF_CC_OEI, 0, 0, 1, "tia");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 2, 7, "tIJAB");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 2, 7, "tijab");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 0, 5, "tIjAb");
+    }
+    else if(params_.ref == 2) { /** UHF **/
+        chk->add_file2(PSIF_CC_OEI, 0, 0, 1, "tIA");
+        chk->add_file2(PSIF_CC_OEI, 0, 2, 3, "tia");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 2, 7, "tIJAB");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 12, 17, "tijab");
+        chk->add_file4(PSIF_CC_TAMPS, 0, 22, 28, "tIjAb");
+    }
+
+    return chk;
+}
+
+}} // namespace psi::ccenergy
@@ -41,6 +41,7 @@
 
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libdpd/amp_checkpoint.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsio/psio.h"
@@ -50,6 +51,7 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -194,6 +196,14 @@ double CCEnergyWavefunction::compute_energy()
 
     init_amps();
 
+    /* Pick up the amplitudes of an interrupted run */
+    std::shared_ptr<AmpCheckpoint> amp_chk;
+    int first_iter = 1;
+    if(params_.checkpoint_freq > 0) {
+        amp_chk = amp_checkpoint();
+        if(params_.restart) first_iter = amp_chk->read() + 1;
+    }
+
     /* Compute the MP2 energy while we're here */
     if(params_.ref == 0 || params_.ref == 2) {
         moinfo_.emp2 = mp2_energy();
@@ -222,7 +232,7 @@ double CCEnergyWavefunction::compute_energy()
     moinfo_.d2diag = d2diag();
     update();
     checkpoint();
-    for(moinfo_.iter=1; moinfo_.iter <= params_.maxiter; moinfo_.iter++) {
+    for(moinfo_.iter=first_iter; moinfo_.iter <= params_.maxiter; moinfo_.iter++) {
 
         sort_amps();
 
@@ -329,6 +339,9 @@ double CCEnergyWavefunction::compute_energy()
             update();
             outfile->Printf( "\n    Iterations converged.\n");
 
+            /* No DIIS step was taken this iteration, so resuming means redoing it */
+            if(amp_chk) amp_chk->write(moinfo_.iter-1, params_.diis ? std::min(moinfo_.iter-1, diis_nvector) : 0);
+
             outfile->Printf( "\n");
             amp_write();
             if (params_.analyze != 0) analyze();
@@ -345,8 +358,16 @@ double CCEnergyWavefunction::compute_energy()
         moinfo_.d2diag = d2diag();
         update();
         checkpoint();
+        if(amp_chk && moinfo_.iter % params_.checkpoint_freq == 0)
+            amp_chk->write(moinfo_.iter, params_.diis ? std::min(moinfo_.iter, diis_nvector) : 0);
+
+        /* Pin the most useful cache entries once their usage has been observed */
+        if(moinfo_.iter == params_.cache_adapt_iters) global_dpd_->file4_cache_adapt();
     }  // end loop over iterations
 
+    if(params_.print > 1 || params_.cachetype == 2)
+        global_dpd_->file4_cache_print_stats("outfile");
+
     // DGAS Edit
     Process::environment.globals["CC T1 DIAGNOSTIC"] = moinfo_.t1diag;
     Process::environment.globals["CC D1 DIAGNOSTIC"] = moinfo_.d1diag;
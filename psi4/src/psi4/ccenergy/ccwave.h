@@ -40,6 +40,7 @@ struct dpd_file4_cache_entry;
 struct dpdfile2;
 struct dpdbuf4;
 struct iwlbuf;
+class AmpCheckpoint;
 }
 
 namespace psi { namespace ccenergy {
@@ -75,6 +76,7 @@ private:
     void spinad_amps(void);
     void amp_write(void);
     void checkpoint(void);
+    std::shared_ptr<AmpCheckpoint> amp_checkpoint(void);
 
     /* intermediates */
     void update(void);
@@ -170,6 +172,7 @@ private:
     void local_filter_T1(dpdfile2 *T1);
     void local_filter_T2(dpdbuf4 *T2);
     void local_init(void);
+    void local_pairs(void);
     void local_done(void);
 
 
@@ -179,6 +182,7 @@ private:
                    int nirreps, int **mo_row, int **so_row, int *mospi_left, int *mospi_right,
                    int *sospi, int type, double alpha, double beta);
     int AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO);
+    int AO_contribute_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO, double tolerance);
 
 
     double rhf_energy(void);
@@ -60,7 +60,7 @@ namespace psi { namespace ccenergy {
 
 void CCEnergyWavefunction::diis_UHF(int iter)
 {
-  int nvector=8;  /* Number of error vectors to keep */
+  int nvector=diis_nvector;  /* Number of error vectors to keep */
   int h, nirreps;
   int row, col;
   size_t p, q, diis_cycle;
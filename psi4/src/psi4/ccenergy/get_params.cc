@@ -107,6 +107,7 @@ void CCEnergyWavefunction::get_params(Options &options)
   params_.convergence = options.get_double("R_CONVERGENCE");
   params_.e_convergence = options.get_double("E_CONVERGENCE");
   params_.restart = options.get_bool("RESTART");
+  params_.checkpoint_freq = options.get_int("CC_CHECKPOINT_FREQ");
 
   params_.memory = Process::environment.get_memory();
 
@@ -117,11 +118,13 @@ void CCEnergyWavefunction::get_params(Options &options)
   cachetype = options.get_str("CACHETYPE");
   if(cachetype == "LOW") params_.cachetype = 1;
   else if(cachetype == "LRU") params_.cachetype = 0;
+  else if(cachetype == "ADAPTIVE") params_.cachetype = 2;
   else
     throw PsiException("Error in input: invalid CACHETYPE", __FILE__, __LINE__);
+  params_.cache_adapt_iters = options.get_int("CACHE_ADAPT_ITERS");
 
 
- if(params_.ref == 2) /* No LOW cacheing yet for UHF references */
+ if(params_.ref == 2 && params_.cachetype == 1) /* No LOW cacheing yet for UHF references */
     params_.cachetype = 0;
 
   params_.nthreads = Process::environment.get_n_threads();
@@ -205,12 +208,14 @@ void CCEnergyWavefunction::get_params(Options &options)
   outfile->Printf( "    E_Convergence   =     %3.1e\n", params_.e_convergence);
   outfile->Printf( "    Restart         =     %s\n",
       params_.restart ? "Yes" : "No");
+  if(params_.checkpoint_freq)
+    outfile->Printf( "    Checkpoint Freq =   %4d\n", params_.checkpoint_freq);
   outfile->Printf( "    DIIS            =     %s\n", params_.diis ? "Yes" : "No");
   outfile->Printf( "    AO Basis        =     %s\n", params_.aobasis.c_str());
   outfile->Printf( "    ABCD            =     %s\n", params_.abcd.c_str());
   outfile->Printf( "    Cache Level     =     %1d\n", params_.cachelev);
   outfile->Printf( "    Cache Type      =    %4s\n",
-      params_.cachetype ? "LOW" : "LRU");
+      params_.cachetype == 2 ? "ADAPTIVE" : (params_.cachetype ? "LOW" : "LRU"));
   outfile->Printf( "    Print Level     =     %1d\n",  params_.print);
   outfile->Printf( "    Num. of threads =     %d\n",  params_.nthreads);
   outfile->Printf( "    # Amps to Print =     %1d\n",  params_.num_amps);
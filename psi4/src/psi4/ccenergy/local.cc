@@ -67,7 +67,7 @@ namespace psi { namespace ccenergy {
 
 void CCEnergyWavefunction::local_init(void)
 {
-  int i, k, ij, nocc;
+  int nocc;
 
   local_.nso = moinfo_.nso;
   local_.nocc = moinfo_.occpi[0]; /* active doubly occupied orbitals */
@@ -80,60 +80,114 @@ void CCEnergyWavefunction::local_init(void)
   psio_read_entry(PSIF_CC_INFO, "Local Weak Pairs", (char *) local_.weak_pairs,
           local_.nocc*local_.nocc*sizeof(int));
 
+  local_.pairdom_len = init_int_array(nocc*nocc);
+  local_.pairdom_nrlen = init_int_array(nocc*nocc);
+  local_.eps_occ = init_array(nocc);
+  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain Length", (char *) local_.pairdom_len,
+		  nocc*nocc*sizeof(int));
+  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain NR Length", (char *) local_.pairdom_nrlen,
+		  nocc*nocc*sizeof(int));
+  psio_read_entry(PSIF_CC_INFO, "Local Occupied Orbital Energies", (char *) local_.eps_occ,
+		  nocc*sizeof(double));
+
+  /* The pair data are read by local_pairs(), strong pairs only */
+  local_.npairs = 0;
+  local_.pairs = init_int_array(nocc*nocc);
+  local_.V = (double ***) calloc(nocc * nocc, sizeof(double **));
+  local_.W = (double ***) calloc(nocc * nocc, sizeof(double **));
+  local_.eps_vir = (double **) calloc(nocc * nocc, sizeof(double *));
+
   outfile->Printf( "    Localization parameters ready.\n\n");
 
 }
 
+/*!
+** local_pairs(): Bring the list of strong pairs up to date with
+** weak_pairs, and hold the projected virtual space of each (V, W and
+** the virtual orbital energies) in core.  Only pairs that were not
+** loaded before are read from CC_INFO; the blocks of weak pairs are
+** skipped on disk and dropped from core.  lmp2() switches all pairs on
+** and then the weak ones off again, so this is called by each filter.
+*/
+
+void CCEnergyWavefunction::local_pairs(void)
+{
+  int ij, nocc, nvir, len, nrlen;
+  size_t eoff, voff, woff;
+  psio_address next;
+
+  nocc = local_.nocc;
+  nvir = local_.nvir;
+
+  local_.npairs = 0;
+  eoff = voff = woff = 0;
+  for(ij=0; ij < nocc*nocc; ij++) {
+    len = local_.pairdom_len[ij];
+    nrlen = local_.pairdom_nrlen[ij];
+
+    if(!local_.weak_pairs[ij]) {
+      if(local_.V[ij] == NULL) {
+        local_.eps_vir[ij] = init_array(nrlen);
+        psio_read(PSIF_CC_INFO, "Local Virtual Orbital Energies", (char *) local_.eps_vir[ij],
+          nrlen*sizeof(double), psio_get_address(PSIO_ZERO, eoff), &next);
+        local_.V[ij] = block_matrix(nvir,len);
+        psio_read(PSIF_CC_INFO, "Local Residual Vector (V)", (char *) local_.V[ij][0],
+          nvir*len*sizeof(double), psio_get_address(PSIO_ZERO, voff), &next);
+        local_.W[ij] = block_matrix(len,nrlen);
+        psio_read(PSIF_CC_INFO, "Local Transformation Matrix (W)", (char *) local_.W[ij][0],
+          len*nrlen*sizeof(double), psio_get_address(PSIO_ZERO, woff), &next);
+      }
+      local_.pairs[local_.npairs++] = ij;
+    }
+    else if(local_.V[ij] != NULL) {
+      free_block(local_.W[ij]);
+      free_block(local_.V[ij]);
+      free(local_.eps_vir[ij]);
+      local_.W[ij] = NULL;
+      local_.V[ij] = NULL;
+      local_.eps_vir[ij] = NULL;
+    }
+
+    eoff += nrlen*sizeof(double);
+    voff += (size_t) nvir*len*sizeof(double);
+    woff += (size_t) len*nrlen*sizeof(double);
+  }
+}
+
 void CCEnergyWavefunction::local_done(void)
 {
+  int ij;
+
+  for(ij=0; ij < local_.nocc*local_.nocc; ij++) {
+    if(local_.V[ij] == NULL) continue;
+    free_block(local_.W[ij]);
+    free_block(local_.V[ij]);
+    free(local_.eps_vir[ij]);
+  }
+  free(local_.W);
+  free(local_.V);
+  free(local_.eps_vir);
+  free(local_.pairs);
+
+  free(local_.eps_occ);
+  free(local_.pairdom_len);
+  free(local_.pairdom_nrlen);
+  free(local_.weak_pairs);
+
   outfile->Printf( "    Local parameters free.\n");
 
 }
 
 void CCEnergyWavefunction::local_filter_T1(dpdfile2 *T1)
 {
-  int i, a, ij, ii;
+  int i, a, ii;
   int nocc, nvir;
   double *T1tilde, *T1bar;
-  psio_address next;
 
   nocc = local_.nocc;
   nvir = local_.nvir;
 
-/*   local.weak_pairs = init_int_array(nocc*nocc); */
-  local_.pairdom_len = init_int_array(nocc*nocc);
-  local_.pairdom_nrlen = init_int_array(nocc*nocc);
-  local_.eps_occ = init_array(nocc);
-/*   psio_read_entry(CC_INFO, "Local Weak Pairs", (char *) local.weak_pairs, */
-/* 		  local.nocc*local.nocc*sizeof(int)); */
-  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain Length", (char *) local_.pairdom_len,
-		  nocc*nocc*sizeof(int));
-  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain NR Length", (char *) local_.pairdom_nrlen,
-		  nocc*nocc*sizeof(int));
-  psio_read_entry(PSIF_CC_INFO, "Local Occupied Orbital Energies", (char *) local_.eps_occ,
-		  nocc*sizeof(double));
-
-  local_.W = (double ***) malloc(nocc * nocc * sizeof(double **));
-  local_.V = (double ***) malloc(nocc * nocc * sizeof(double **));
-  local_.eps_vir = (double **) malloc(nocc * nocc * sizeof(double *));
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.eps_vir[ij] = init_array(local_.pairdom_nrlen[ij]);
-      psio_read(PSIF_CC_INFO, "Local Virtual Orbital Energies", (char *) local_.eps_vir[ij],
-        local_.pairdom_nrlen[ij]*sizeof(double), next, &next);
-    }
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.V[ij] = block_matrix(nvir,local_.pairdom_len[ij]);
-      psio_read(PSIF_CC_INFO, "Local Residual Vector (V)", (char *) local_.V[ij][0],
-        nvir*local_.pairdom_len[ij]*sizeof(double), next, &next);
-    }
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.W[ij] = block_matrix(local_.pairdom_len[ij],local_.pairdom_nrlen[ij]);
-      psio_read(PSIF_CC_INFO, "Local Transformation Matrix (W)", (char *) local_.W[ij][0],
-        local_.pairdom_len[ij]*local_.pairdom_nrlen[ij]*sizeof(double), next, &next);
-    }
+  local_pairs();
 
   global_dpd_->file2_mat_init(T1);
   global_dpd_->file2_mat_rd(T1);
@@ -145,6 +199,9 @@ void CCEnergyWavefunction::local_filter_T1(dpdfile2 *T1)
       outfile->Printf( "\n    local_filter_T1: Pair ii = [%d] is zero-length, which makes no sense.\n",ii);
       throw PsiException("local_filter_T1: Pair ii is zero-length, which makes no sense.", __FILE__, __LINE__);
     }
+    if(local_.V[ii] == NULL) {
+      throw PsiException("local_filter_T1: Pair ii is a weak pair, which makes no sense.", __FILE__, __LINE__);
+    }
 
     T1tilde = init_array(local_.pairdom_len[ii]);
     T1bar = init_array(local_.pairdom_nrlen[ii]);
@@ -177,116 +234,70 @@ void CCEnergyWavefunction::local_filter_T1(dpdfile2 *T1)
 
   global_dpd_->file2_mat_wrt(T1);
   global_dpd_->file2_mat_close(T1);
-
-  for(ij=0; ij<nocc*nocc; ij++) {
-      free_block(local_.W[ij]);
-      free_block(local_.V[ij]);
-      free(local_.eps_vir[ij]);
-    }
-  free(local_.W);
-  free(local_.V);
-  free(local_.eps_vir);
-
-  free(local_.eps_occ);
-  free(local_.pairdom_len);
-  free(local_.pairdom_nrlen);
-/*   free(local.weak_pairs); */
 }
 
 void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2)
 {
-  int ij, i, j, a, b;
+  int p, ij, i, j, a, b, len, nrlen;
   int nso, nocc, nvir;
   double **X1, **X2, **T2tilde, **T2bar;
-  psio_address next;
 
   nso = local_.nso;
   nocc = local_.nocc;
   nvir = local_.nvir;
 
-/*   local.weak_pairs = init_int_array(nocc*nocc); */
-  local_.pairdom_len = init_int_array(nocc*nocc);
-  local_.pairdom_nrlen = init_int_array(nocc*nocc);
-  local_.eps_occ = init_array(nocc);
-/*   psio_read_entry(CC_INFO, "Local Weak Pairs", (char *) local.weak_pairs, */
-/* 		  local.nocc*local.nocc*sizeof(int)); */
-  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain Length", (char *) local_.pairdom_len,
-		  nocc*nocc*sizeof(int));
-  psio_read_entry(PSIF_CC_INFO, "Local Pair Domain NR Length", (char *) local_.pairdom_nrlen,
-		  nocc*nocc*sizeof(int));
-  psio_read_entry(PSIF_CC_INFO, "Local Occupied Orbital Energies", (char *) local_.eps_occ,
-		  nocc*sizeof(double));
-
-  local_.W = (double ***) malloc(nocc * nocc * sizeof(double **));
-  local_.V = (double ***) malloc(nocc * nocc * sizeof(double **));
-  local_.eps_vir = (double **) malloc(nocc * nocc * sizeof(double *));
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.eps_vir[ij] = init_array(local_.pairdom_nrlen[ij]);
-      psio_read(PSIF_CC_INFO, "Local Virtual Orbital Energies", (char *) local_.eps_vir[ij],
-        local_.pairdom_nrlen[ij]*sizeof(double), next, &next);
-    }
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.V[ij] = block_matrix(nvir,local_.pairdom_len[ij]);
-      psio_read(PSIF_CC_INFO, "Local Residual Vector (V)", (char *) local_.V[ij][0],
-        nvir*local_.pairdom_len[ij]*sizeof(double), next, &next);
-    }
-  next = PSIO_ZERO;
-  for(ij=0; ij < nocc*nocc; ij++) {
-      local_.W[ij] = block_matrix(local_.pairdom_len[ij],local_.pairdom_nrlen[ij]);
-      psio_read(PSIF_CC_INFO, "Local Transformation Matrix (W)", (char *) local_.W[ij][0],
-        local_.pairdom_len[ij]*local_.pairdom_nrlen[ij]*sizeof(double), next, &next);
-    }
+  local_pairs();
 
   /* Grab the MO-basis T2's */
   global_dpd_->buf4_mat_irrep_init(T2, 0);
   global_dpd_->buf4_mat_irrep_rd(T2, 0);
 
+  /* Neglected weak pairs are forced to zero */
+  for(ij=0; ij < nocc*nocc; ij++)
+    if(local_.weak_pairs[ij])
+      memset((void *) T2->matrix[0][ij], 0, nvir*nvir*sizeof(double));
+
   X1 = block_matrix(nso,nvir);
   X2 = block_matrix(nvir,nso);
   T2tilde = block_matrix(nso,nso);
   T2bar = block_matrix(nvir, nvir);
 
-  for(i=0,ij=0; i<nocc; i++) {
-    for(j=0; j<nocc; j++,ij++) {
+  for(p=0; p < local_.npairs; p++) {
+    ij = local_.pairs[p];
+    i = ij / nocc;
+    j = ij % nocc;
+    len = local_.pairdom_len[ij];
+    nrlen = local_.pairdom_nrlen[ij];
 
-      if(!local_.weak_pairs[ij]) {
-
-	/* Transform the virtuals to the redundant projected virtual basis */
-    C_DGEMM('t', 'n', local_.pairdom_len[ij], nvir, nvir, 1.0, &(local_.V[ij][0][0]), local_.pairdom_len[ij],
-		&(T2->matrix[0][ij][0]), nvir, 0.0, &(X1[0][0]), nvir);
-    C_DGEMM('n', 'n', local_.pairdom_len[ij], local_.pairdom_len[ij], nvir, 1.0, &(X1[0][0]), nvir,
-        &(local_.V[ij][0][0]), local_.pairdom_len[ij], 0.0, &(T2tilde[0][0]), nso);
-
-	/* Transform the virtuals to the non-redundant virtual basis */
-    C_DGEMM('t', 'n', local_.pairdom_nrlen[ij], local_.pairdom_len[ij], local_.pairdom_len[ij], 1.0,
-        &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], &(T2tilde[0][0]), nso, 0.0, &(X2[0][0]), nso);
-    C_DGEMM('n', 'n', local_.pairdom_nrlen[ij], local_.pairdom_nrlen[ij], local_.pairdom_len[ij], 1.0,
-        &(X2[0][0]), nso, &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], 0.0, &(T2bar[0][0]), nvir);
+    /* Transform the virtuals to the redundant projected virtual basis */
+    C_DGEMM('t', 'n', len, nvir, nvir, 1.0, &(local_.V[ij][0][0]), len,
+        &(T2->matrix[0][ij][0]), nvir, 0.0, &(X1[0][0]), nvir);
+    C_DGEMM('n', 'n', len, len, nvir, 1.0, &(X1[0][0]), nvir,
+        &(local_.V[ij][0][0]), len, 0.0, &(T2tilde[0][0]), nso);
 
-	/* Divide the new amplitudes by the denominators */
-    for(a=0; a < local_.pairdom_nrlen[ij]; a++)
-      for(b=0; b < local_.pairdom_nrlen[ij]; b++)
+    /* Transform the virtuals to the non-redundant virtual basis */
+    C_DGEMM('t', 'n', nrlen, len, len, 1.0,
+        &(local_.W[ij][0][0]), nrlen, &(T2tilde[0][0]), nso, 0.0, &(X2[0][0]), nso);
+    C_DGEMM('n', 'n', nrlen, nrlen, len, 1.0,
+        &(X2[0][0]), nso, &(local_.W[ij][0][0]), nrlen, 0.0, &(T2bar[0][0]), nvir);
+
+    /* Divide the new amplitudes by the denominators */
+    for(a=0; a < nrlen; a++)
+      for(b=0; b < nrlen; b++)
         T2bar[a][b] /= (local_.eps_occ[i] + local_.eps_occ[j]
                 - local_.eps_vir[ij][a] - local_.eps_vir[ij][b]);
 
-	/* Transform the new T2's to the redundant virtual basis */
-    C_DGEMM('n', 'n', local_.pairdom_len[ij], local_.pairdom_nrlen[ij], local_.pairdom_nrlen[ij], 1.0,
-        &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], &(T2bar[0][0]), nvir, 0.0, &(X1[0][0]), nvir);
-    C_DGEMM('n','t', local_.pairdom_len[ij], local_.pairdom_len[ij], local_.pairdom_nrlen[ij], 1.0,
-        &(X1[0][0]), nvir, &(local_.W[ij][0][0]), local_.pairdom_nrlen[ij], 0.0, &(T2tilde[0][0]), nso);
-
-	/* Transform the new T2's to the MO basis */
-    C_DGEMM('n', 'n', nvir, local_.pairdom_len[ij], local_.pairdom_len[ij], 1.0,
-        &(local_.V[ij][0][0]), local_.pairdom_len[ij], &(T2tilde[0][0]), nso, 0.0, &(X2[0][0]), nso);
-    C_DGEMM('n', 't', nvir, nvir, local_.pairdom_len[ij], 1.0, &(X2[0][0]), nso,
-        &(local_.V[ij][0][0]), local_.pairdom_len[ij], 0.0, &(T2->matrix[0][ij][0]), nvir);
-      }
-      else  /* This must be a neglected weak pair; force it to zero */
-	memset((void *) T2->matrix[0][ij], 0, nvir*nvir*sizeof(double));
-
-    }
+    /* Transform the new T2's to the redundant virtual basis */
+    C_DGEMM('n', 'n', len, nrlen, nrlen, 1.0,
+        &(local_.W[ij][0][0]), nrlen, &(T2bar[0][0]), nvir, 0.0, &(X1[0][0]), nvir);
+    C_DGEMM('n','t', len, len, nrlen, 1.0,
+        &(X1[0][0]), nvir, &(local_.W[ij][0][0]), nrlen, 0.0, &(T2tilde[0][0]), nso);
+
+    /* Transform the new T2's to the MO basis */
+    C_DGEMM('n', 'n', nvir, len, len, 1.0,
+        &(local_.V[ij][0][0]), len, &(T2tilde[0][0]), nso, 0.0, &(X2[0][0]), nso);
+    C_DGEMM('n', 't', nvir, nvir, len, 1.0, &(X2[0][0]), nso,
+        &(local_.V[ij][0][0]), len, 0.0, &(T2->matrix[0][ij][0]), nvir);
   }
 
   free_block(X1);
@@ -297,19 +308,5 @@ void CCEnergyWavefunction::local_filter_T2(dpdbuf4 *T2)
   /* Write the updated MO-basis T2's to disk */
   global_dpd_->buf4_mat_irrep_wrt(T2, 0);
   global_dpd_->buf4_mat_irrep_close(T2, 0);
-
-  for(i=0; i<nocc*nocc; i++) {
-      free_block(local_.W[i]);
-      free_block(local_.V[i]);
-      free(local_.eps_vir[i]);
-    }
-  free(local_.W);
-  free(local_.V);
-  free(local_.eps_vir);
-
-  free(local_.eps_occ);
-  free(local_.pairdom_len);
-  free(local_.pairdom_nrlen);
-/*   free(local.weak_pairs); */
 }
 }} // namespace psi::ccenergy
@@ -36,6 +36,7 @@
 
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/structured_log.h"
 
 #include <cstdio>
 
@@ -45,6 +46,16 @@ void CCEnergyWavefunction::update(void) {
     outfile->Printf("  %4d      %20.15f    %4.3e    %7.6f    %7.6f    %7.6f    %7.6f\n",
                     moinfo_.iter, moinfo_.ecc, moinfo_.conv, moinfo_.t1diag, moinfo_.d1diag,
                     moinfo_.new_d1diag, moinfo_.d2diag);
+    StructuredLog::Record("cc iteration")
+        .add("wfn", params_.wfn)
+        .add("iteration", moinfo_.iter)
+        .add("energy", moinfo_.ecc)
+        .add("rms", moinfo_.conv)
+        .add("t1diag", moinfo_.t1diag)
+        .add("d1diag", moinfo_.d1diag)
+        .add("new_d1diag", moinfo_.new_d1diag)
+        .add("d2diag", moinfo_.d2diag)
+        .write();
 }
 }
 }  // namespace psi::ccenergy
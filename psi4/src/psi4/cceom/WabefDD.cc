@@ -33,6 +33,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
@@ -57,15 +59,6 @@ void WabefDD(int i, int C_irr) {
   dpdbuf4 CMNEF, Cmnef, CMnEf, X, F, tau, D, WM, WP, Z;
   char CMNEF_lbl[32], Cmnef_lbl[32], CMnEf_lbl[32];
   char SIJAB_lbl[32], Sijab_lbl[32], SIjAb_lbl[32], SIA_lbl[32], Sia_lbl[32];
-  char lbl_a[32], lbl_s[32];
-  dpdbuf4 tau_a, tau_s;
-  dpdbuf4 B_a, B_s;
-  dpdbuf4 S, A;
-  double **B_diag, **tau_diag;
-  int ij, Gc, C, c, cc;
-  int nbuckets, rows_per_bucket, rows_left, m, row_start, ab, cd, dc, d;
-  int nrows, ncols, nlinks;
-  psio_address next;
 
   if (params.eom_ref == 0) { /* RHF */
     /* SIjAb += WAbEf*CIjEf */
@@ -94,112 +87,7 @@ void WabefDD(int i, int C_irr) {
       global_dpd_->buf4_close(&Z);
       global_dpd_->buf4_close(&SIjAb);
     }
-    else if(params.abcd == "NEW") {
-
-      sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", i);
-      sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", i);
-
-      /* L_a(-)(ij,ab) (i>j, a>b) = L(ij,ab) - L(ij,ba) */
-      global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 0, 5, 1, CMnEf_lbl);
-      global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_a);
-      global_dpd_->buf4_close(&tau_a);
-
-      /* L_s(+)(ij,ab) (i>=j, a>=b) = L(ij,ab) + L(ij,ba) */
-      global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
-      global_dpd_->buf4_copy(&tau_a, PSIF_EOM_TMP, lbl_s);
-      global_dpd_->buf4_sort_axpy(&tau_a, PSIF_EOM_TMP, pqsr, 0, 5, lbl_s, 1);
-      global_dpd_->buf4_close(&tau_a);
-      global_dpd_->buf4_init(&tau_a, PSIF_EOM_TMP, C_irr, 3, 8, 0, 5, 0, lbl_s);
-      global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_s);
-      global_dpd_->buf4_close(&tau_a);
-
-      timer_on("ABCD:S");
-      global_dpd_->buf4_init(&tau_s, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
-      global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-      global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-      global_dpd_->contract444(&B_s, &tau_s, &S, 0, 0, 0.5, 0);
-      global_dpd_->buf4_close(&S);
-      global_dpd_->buf4_close(&B_s);
-      global_dpd_->buf4_close(&tau_s);
-      timer_off("ABCD:S");
-
-      /* L_diag(ij,c)  = 2 * L(ij,cc)*/
-
-      /* NB: Gcc = 0, and B is totally symmetric, so Gab = 0 */
-      /* But Gij = L_irr ^ Gab = L_irr */
-      global_dpd_->buf4_init(&tau, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
-      global_dpd_->buf4_mat_irrep_init(&tau, C_irr);
-      global_dpd_->buf4_mat_irrep_rd(&tau, C_irr);
-      tau_diag = global_dpd_->dpd_block_matrix(tau.params->rowtot[C_irr], moinfo.nvirt);
-      for(ij=0; ij < tau.params->rowtot[C_irr]; ij++)
-	for(Gc=0; Gc < moinfo.nirreps; Gc++)
-	  for(C=0; C < moinfo.virtpi[Gc]; C++) {
-	    c = C + moinfo.vir_off[Gc];
-	    cc = tau.params->colidx[c][c];
-	    tau_diag[ij][c] = tau.matrix[C_irr][ij][cc];
-	  }
-      global_dpd_->buf4_mat_irrep_close(&tau, C_irr);
-
-      global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-      global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-      global_dpd_->buf4_mat_irrep_init(&S, 0);
-      global_dpd_->buf4_mat_irrep_rd(&S, 0);
-
-      rows_per_bucket = dpd_memfree()/(B_s.params->coltot[0] + moinfo.nvirt);
-      if(rows_per_bucket > B_s.params->rowtot[0]) rows_per_bucket = B_s.params->rowtot[0];
-      nbuckets = (int) ceil((double) B_s.params->rowtot[0]/(double) rows_per_bucket);
-      rows_left = B_s.params->rowtot[0] % rows_per_bucket;
-
-      B_diag = global_dpd_->dpd_block_matrix(rows_per_bucket, moinfo.nvirt);
-      next = PSIO_ZERO;
-      ncols = tau.params->rowtot[C_irr];
-      nlinks = moinfo.nvirt;
-      for(m=0; m < (rows_left ? nbuckets-1:nbuckets); m++) {
-	row_start = m * rows_per_bucket;
-	nrows = rows_per_bucket;
-	if(nrows && ncols && nlinks) {
-	  psio_read(PSIF_CC_BINTS,"B(+) <ab|cc>",(char *) B_diag[0],nrows*nlinks*sizeof(double),next, &next);
-	  C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks,
-		  tau_diag[0], nlinks, 1, S.matrix[0][row_start], ncols);
-	}
-
-      }
-      if(rows_left) {
-	row_start = m * rows_per_bucket;
-	nrows = rows_left;
-	if(nrows && ncols && nlinks) {
-	  psio_read(PSIF_CC_BINTS,"B(+) <ab|cc>",(char *) B_diag[0],nrows*nlinks*sizeof(double),next, &next);
-	  C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks,
-		  tau_diag[0], nlinks, 1, S.matrix[0][row_start], ncols);
-	}
-      }
-      global_dpd_->buf4_mat_irrep_wrt(&S, 0);
-      global_dpd_->buf4_mat_irrep_close(&S, 0);
-      global_dpd_->buf4_close(&S);
-      global_dpd_->buf4_close(&B_s);
-      global_dpd_->free_dpd_block(B_diag, rows_per_bucket, moinfo.nvirt);
-      global_dpd_->free_dpd_block(tau_diag, tau.params->rowtot[C_irr], moinfo.nvirt);
-      global_dpd_->buf4_close(&tau);
-
-      timer_on("ABCD:A");
-      global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
-      global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
-      global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, "A(ab,ij)");
-      global_dpd_->contract444(&B_a, &tau_a, &A, 0, 0, 0.5, 0);
-      global_dpd_->buf4_close(&A);
-      global_dpd_->buf4_close(&B_a);
-      global_dpd_->buf4_close(&tau_a);
-      timer_off("ABCD:A");
-
-      timer_on("ABCD:axpy");
-      global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, "S(ab,ij)");
-      global_dpd_->buf4_sort_axpy(&S, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-      global_dpd_->buf4_close(&S);
-      global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, "A(ab,ij)");
-      global_dpd_->buf4_sort_axpy(&A, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-      global_dpd_->buf4_close(&A);
-      timer_off("ABCD:axpy");
-    }
+    /* params.abcd == "NEW" is done for all new vectors at once by WabefDD_RHF_ABCD() */
 
 #ifdef TIME_CCEOM
     timer_off("WabefDD Z");
@@ -531,4 +419,192 @@ void WabefDD(int i, int C_irr) {
   return;
 }
 
+/* Z_k(ab,ij) = alpha W(ab,cd) C_k(ij,cd) for every vector k. Each bucket of
+   rows of W is read once and contracted against as many C_k as fit in core
+   beside it. */
+void contract_abcd_batch(dpdbuf4 *W, std::vector<dpdbuf4> &C, std::vector<dpdbuf4> &Z,
+    double alpha, int C_irr) {
+  int nvec = C.size();
+  if(!nvec) return;
+
+  for(int h=0; h < moinfo.nirreps; h++) {
+    int Gij = h ^ C_irr;
+    long int nab = W->params->rowtot[h];
+    long int ncd = W->params->coltot[h];
+    long int nij = C[0].params->rowtot[Gij];
+
+    long int per_vec = nij * ncd + nab * nij;
+    int nbatch = nvec;
+    if(per_vec) nbatch = std::max(1L, std::min((long int) nvec, dpd_memfree()/2/per_vec));
+
+    for(int k0=0; k0 < nvec; k0 += nbatch) {
+      int k1 = std::min(nvec, k0 + nbatch);
+      for(int k=k0; k < k1; k++) {
+        global_dpd_->buf4_mat_irrep_init(&C[k], Gij);
+        global_dpd_->buf4_mat_irrep_rd(&C[k], Gij);
+        global_dpd_->buf4_mat_irrep_init(&Z[k], h);
+      }
+
+      if(nab && ncd && nij) {
+        Buf4Tiles tiles(W, h, std::max(dpd_memfree(), ncd));
+        while(tiles.next()) {
+          for(int k=k0; k < k1; k++)
+            C_DGEMM('n', 't', tiles.nrows(), nij, ncd, alpha, tiles.block()[0], ncd,
+                    C[k].matrix[Gij][0], ncd, 0.0, Z[k].matrix[h][tiles.start()], nij);
+        }
+      }
+
+      for(int k=k0; k < k1; k++) {
+        global_dpd_->buf4_mat_irrep_wrt(&Z[k], h);
+        global_dpd_->buf4_mat_irrep_close(&Z[k], h);
+        global_dpd_->buf4_mat_irrep_close(&C[k], Gij);
+      }
+    }
+  }
+}
+
+/* The <Ab|Ef> CIjEf part of WabefDD for ABCD = NEW (RHF), for the C vectors
+   first to last-1 at once, so that B(+) and B(-) are read once per
+   iteration rather than once per vector */
+
+void WabefDD_RHF_ABCD(int first, int last, int C_irr) {
+  dpdbuf4 tau_a, tau, B_s, B_a, S, A;
+  char SIjAb_lbl[32], CMnEf_lbl[32], lbl_a[32], lbl_s[32], S_lbl[32], A_lbl[32];
+  double **B_diag, **tau_diag;
+  int ij, Gc, C, c, cc;
+  int nbuckets, rows_per_bucket, rows_left, m, row_start;
+  int nrows, ncols, nlinks;
+  psio_address next;
+  int nvec = last - first;
+  if(nvec <= 0) return;
+
+  for(int i=first; i < last; i++) {
+    sprintf(CMnEf_lbl, "%s %d", "CMnEf", i);
+    sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", i);
+    sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", i);
+
+    /* L_a(-)(ij,ab) (i>j, a>b) = L(ij,ab) - L(ij,ba) */
+    global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 0, 5, 1, CMnEf_lbl);
+    global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_a);
+    global_dpd_->buf4_close(&tau_a);
+
+    /* L_s(+)(ij,ab) (i>=j, a>=b) = L(ij,ab) + L(ij,ba) */
+    global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
+    global_dpd_->buf4_copy(&tau_a, PSIF_EOM_TMP, lbl_s);
+    global_dpd_->buf4_sort_axpy(&tau_a, PSIF_EOM_TMP, pqsr, 0, 5, lbl_s, 1);
+    global_dpd_->buf4_close(&tau_a);
+    global_dpd_->buf4_init(&tau_a, PSIF_EOM_TMP, C_irr, 3, 8, 0, 5, 0, lbl_s);
+    global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_s);
+    global_dpd_->buf4_close(&tau_a);
+  }
+
+  std::vector<dpdbuf4> Cs(nvec), Zs(nvec);
+
+  timer_on("ABCD:S");
+  for(int k=0; k < nvec; k++) {
+    sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", first + k);
+    sprintf(S_lbl, "S(ab,ij) %d", first + k);
+    global_dpd_->buf4_init(&Cs[k], PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
+    global_dpd_->buf4_init(&Zs[k], PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, S_lbl);
+  }
+  global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
+  contract_abcd_batch(&B_s, Cs, Zs, 0.5, C_irr);
+  global_dpd_->buf4_close(&B_s);
+  for(int k=0; k < nvec; k++) {
+    global_dpd_->buf4_close(&Zs[k]);
+    global_dpd_->buf4_close(&Cs[k]);
+  }
+  timer_off("ABCD:S");
+
+  timer_on("ABCD:A");
+  for(int k=0; k < nvec; k++) {
+    sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", first + k);
+    sprintf(A_lbl, "A(ab,ij) %d", first + k);
+    global_dpd_->buf4_init(&Cs[k], PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
+    global_dpd_->buf4_init(&Zs[k], PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, A_lbl);
+  }
+  global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
+  contract_abcd_batch(&B_a, Cs, Zs, 0.5, C_irr);
+  global_dpd_->buf4_close(&B_a);
+  for(int k=0; k < nvec; k++) {
+    global_dpd_->buf4_close(&Zs[k]);
+    global_dpd_->buf4_close(&Cs[k]);
+  }
+  timer_off("ABCD:A");
+
+  for(int i=first; i < last; i++) {
+    sprintf(SIjAb_lbl, "%s %d", "SIjAb", i);
+    sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", i);
+    sprintf(S_lbl, "S(ab,ij) %d", i);
+    sprintf(A_lbl, "A(ab,ij) %d", i);
+
+    /* L_diag(ij,c)  = 2 * L(ij,cc)*/
+
+    /* NB: Gcc = 0, and B is totally symmetric, so Gab = 0 */
+    /* But Gij = L_irr ^ Gab = L_irr */
+    global_dpd_->buf4_init(&tau, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
+    global_dpd_->buf4_mat_irrep_init(&tau, C_irr);
+    global_dpd_->buf4_mat_irrep_rd(&tau, C_irr);
+    tau_diag = global_dpd_->dpd_block_matrix(tau.params->rowtot[C_irr], moinfo.nvirt);
+    for(ij=0; ij < tau.params->rowtot[C_irr]; ij++)
+      for(Gc=0; Gc < moinfo.nirreps; Gc++)
+        for(C=0; C < moinfo.virtpi[Gc]; C++) {
+          c = C + moinfo.vir_off[Gc];
+          cc = tau.params->colidx[c][c];
+          tau_diag[ij][c] = tau.matrix[C_irr][ij][cc];
+        }
+    global_dpd_->buf4_mat_irrep_close(&tau, C_irr);
+
+    global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
+    global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, S_lbl);
+    global_dpd_->buf4_mat_irrep_init(&S, 0);
+    global_dpd_->buf4_mat_irrep_rd(&S, 0);
+
+    rows_per_bucket = dpd_memfree()/(B_s.params->coltot[0] + moinfo.nvirt);
+    if(rows_per_bucket > B_s.params->rowtot[0]) rows_per_bucket = B_s.params->rowtot[0];
+    nbuckets = (int) ceil((double) B_s.params->rowtot[0]/(double) rows_per_bucket);
+    rows_left = B_s.params->rowtot[0] % rows_per_bucket;
+
+    B_diag = global_dpd_->dpd_block_matrix(rows_per_bucket, moinfo.nvirt);
+    next = PSIO_ZERO;
+    ncols = tau.params->rowtot[C_irr];
+    nlinks = moinfo.nvirt;
+    for(m=0; m < (rows_left ? nbuckets-1:nbuckets); m++) {
+      row_start = m * rows_per_bucket;
+      nrows = rows_per_bucket;
+      if(nrows && ncols && nlinks) {
+        psio_read(PSIF_CC_BINTS,"B(+) <ab|cc>",(char *) B_diag[0],nrows*nlinks*sizeof(double),next, &next);
+        C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks,
+                tau_diag[0], nlinks, 1, S.matrix[0][row_start], ncols);
+      }
+
+    }
+    if(rows_left) {
+      row_start = m * rows_per_bucket;
+      nrows = rows_left;
+      if(nrows && ncols && nlinks) {
+        psio_read(PSIF_CC_BINTS,"B(+) <ab|cc>",(char *) B_diag[0],nrows*nlinks*sizeof(double),next, &next);
+        C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks,
+                tau_diag[0], nlinks, 1, S.matrix[0][row_start], ncols);
+      }
+    }
+    global_dpd_->buf4_mat_irrep_wrt(&S, 0);
+    global_dpd_->buf4_mat_irrep_close(&S, 0);
+    global_dpd_->buf4_close(&S);
+    global_dpd_->buf4_close(&B_s);
+    global_dpd_->free_dpd_block(B_diag, rows_per_bucket, moinfo.nvirt);
+    global_dpd_->free_dpd_block(tau_diag, tau.params->rowtot[C_irr], moinfo.nvirt);
+    global_dpd_->buf4_close(&tau);
+
+    timer_on("ABCD:axpy");
+    global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, S_lbl);
+    global_dpd_->buf4_sort_axpy(&S, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+    global_dpd_->buf4_close(&S);
+    global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, A_lbl);
+    global_dpd_->buf4_sort_axpy(&A, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+    global_dpd_->buf4_close(&A);
+    timer_off("ABCD:axpy");
+  }
+}
+
 }} // namespace psi::cceom
@@ -93,6 +93,7 @@ void sigmaSS(int index, int irrep);
 void sigmaSD(int index, int irrep);
 void sigmaDS(int index, int irrep);
 void sigmaDD(int index, int irrep);
+void WabefDD_RHF_ABCD(int first, int last, int irrep);
 void sigma00(int index, int irrep);
 void sigma0S(int index, int irrep);
 void sigma0D(int index, int irrep);
@@ -333,11 +334,21 @@ timer_off("INIT GUESS");
         /* Form a zeroed S vector for each C vector
 	   SIA and Sia do get overwritten by sigmaSS
 	   so this may only be necessary for debugging */
-        ++nsigma_evaluations;
         if (params.full_matrix) init_S0(i);
         init_S1(i, C_irr);
         init_S2(i, C_irr);
+      }
+
+      /* The <ab|cd> term takes all new C vectors in one pass over B */
+      if (params.eom_ref == 0 && params.abcd == "NEW" && params.wfn != "EOM_CC2") {
+        timer_on("WabefDD ABCD");
+        WabefDD_RHF_ABCD(already_sigma, L, C_irr);
+        timer_off("WabefDD ABCD");
+      }
 
+      for (i=already_sigma;i<L;++i) {
+        ++nsigma_evaluations;
+        /* the sorted copies of C are per vector, under fixed labels */
         sort_C(i, C_irr);
 
         /* Computing sigma vectors */
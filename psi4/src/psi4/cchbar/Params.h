@@ -44,6 +44,7 @@ struct Params {
   int dertype;
   int Tamplitude;
   int wabei_lowdisk;
+  int nthreads;
 };
 
 }} // namespace psi::cchbar
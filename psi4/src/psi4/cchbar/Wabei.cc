@@ -34,6 +34,7 @@
 #include <string>
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/exception.h"
 #include "MOInfo.h"
 #include "Params.h"
 #define EXTERN
@@ -108,4 +109,36 @@ void Wabei_UHF_sort_ints(void){
   global_dpd_->buf4_close(&F);
 }
 
+/*
+** Wabei_ZT(): W(ei,ab) += alpha * Z(ei,mn) * T(mn,ab), the tau * Wmnie
+** term of every spin case. Z and T are held in core one irrep at a time,
+** and W goes through in tiles of rows with one DGEMM per tile, rather than
+** a read, a DGEMV, and a write per row. The tiles are read and written
+** back on a helper thread while the previous one is multiplied.
+*/
+void Wabei_ZT(dpdbuf4 *W, dpdbuf4 *Z, dpdbuf4 *T, double alpha)
+{
+  for(int h=0; h < moinfo.nirreps; h++) {
+    int nlinks = T->params->rowtot[h];
+    int ncols = T->params->coltot[h];
+    int rowtot = W->params->rowtot[h];
+    if(!nlinks || !ncols || !rowtot) continue;
+
+    global_dpd_->buf4_mat_irrep_init(Z, h);
+    global_dpd_->buf4_mat_irrep_rd(Z, h);
+    global_dpd_->buf4_mat_irrep_init(T, h);
+    global_dpd_->buf4_mat_irrep_rd(T, h);
+
+    {
+      Buf4Tiles tiles(W, h, dpd_memfree(), true, true);
+      while(tiles.next())
+        C_DGEMM('n','n',tiles.nrows(),ncols,nlinks,alpha,Z->matrix[h][tiles.start()],nlinks,
+                T->matrix[h][0],ncols,1.0,tiles.block()[0],ncols);
+    }
+
+    global_dpd_->buf4_mat_irrep_close(T, h);
+    global_dpd_->buf4_mat_irrep_close(Z, h);
+  }
+}
+
 }} // namespace psi::cchbar
@@ -40,6 +40,8 @@
 
 namespace psi { namespace cchbar {
 
+void Wabei_ZT(dpdbuf4 *W, dpdbuf4 *Z, dpdbuf4 *T, double alpha);
+
 /* WAbEi_UHF(): Computes all contributions to the AbEi spin case of
 ** the Wabei HBAR matrix elements.  The final product is stored in
 ** (Ei,Ab) ordering and is referred to on disk as "WEiAb".
@@ -138,28 +140,7 @@ void WAbEi_UHF(void)
   global_dpd_->buf4_init(&W, PSIF_CC_HBAR,  0, 26, 28, 26, 28, 0, "WEiAb");
   global_dpd_->buf4_init(&Z, PSIF_CC_HBAR,  0, 26, 22, 26, 22, 0, "WmNiE (Ei,Mn)");
   global_dpd_->buf4_init(&T, PSIF_CC_TAMPS, 0,  22, 28,  22, 28, 0, "tauIjAb");
-  for(int Gei=0; Gei< moinfo.nirreps; Gei++) {
-    int Gab = Gei;
-    int Gnm = Gei; /* Everything is totally symmetric */
-    int nrows = T.params->rowtot[Gnm];
-    int ncols = T.params->coltot[Gab];
-    if (nrows && ncols) {
-      global_dpd_->buf4_mat_irrep_init(&Z, Gei);
-      global_dpd_->buf4_mat_irrep_rd(&Z, Gei);
-      global_dpd_->buf4_mat_irrep_init(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_rd(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_row_init(&W, Gei);
-      for(int ei=0; ei< W.params->rowtot[Gei]; ei++){
-         global_dpd_->buf4_mat_irrep_row_rd(&W, Gei, ei);
-         C_DGEMV('t',nrows,ncols,1,T.matrix[Gei][0],ncols,Z.matrix[Gei][ei],1,
-             1.0,W.matrix[Gei][0],1);
-         global_dpd_->buf4_mat_irrep_row_wrt(&W, Gei, ei);
-      }
-      global_dpd_->buf4_mat_irrep_row_close(&W, Gei);
-      global_dpd_->buf4_mat_irrep_close(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_close(&Z, Gei);
-    }
-  }
+  Wabei_ZT(&W, &Z, &T, 1.0);
   global_dpd_->buf4_close(&T);
   global_dpd_->buf4_close(&Z);
   global_dpd_->buf4_close(&W);
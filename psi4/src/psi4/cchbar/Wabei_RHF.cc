@@ -47,6 +47,7 @@ namespace psi { namespace cchbar {
 
 void build_Z1(void);
 void ZFW(dpdbuf4 *Z, dpdbuf4 *F, dpdbuf4 *W, double alpha, double beta);
+void Wabei_ZT(dpdbuf4 *W, dpdbuf4 *Z, dpdbuf4 *T, double alpha);
 
 /* Wabei_RHF(): Builds the Wabei HBAR matrix elements for CCSD for
 ** spin-adapted, closed-shell cases.  (Numbering of individual terms
@@ -63,8 +64,8 @@ void Wabei_RHF(void)
   dpdfile2 Fme, T1;
   dpdbuf4 F, W, T2, B, Z, Z1, Z2, D, T, C, F1, F2, W1, W2, Tau;
   double value;
-  int Gef, Gei, Gab, Ge, Gi, Gf, Gmi, Gm, nrows, ncols, nlinks, EE, e, row, Gnm;
-  int Gma, ma, m, a, Ga, Gb, I, i, mi, E, ei, ab, ba, b, BB, fb, bf, fe, ef, mb, am;
+  int Gef, Gei, Gab, Ge, Gi, Gf, Gmi, Gm, nrows, ncols, nlinks, EE, e, row;
+  int Gma, ma, m, a, Gb, I, i, mi, E, ei, ab, ba, b, BB, fb, bf, fe, ef;
   double ***WW1, ***WW2;
   int h, incore, core_total, rowtot, coltot, maxrows;
 
@@ -227,27 +228,7 @@ void Wabei_RHF(void)
   global_dpd_->buf4_init(&Z, PSIF_CC_HBAR, 0, 11, 0, 11, 0, 0, "WMnIe (eI,nM)");
   global_dpd_->buf4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjAb");
   /*   dpd_contract444(&Z, &T, &W, 1, 1, 1, 1); */
-  for(Gei=0; Gei < moinfo.nirreps; Gei++) {
-    Gab = Gnm = Gei; /* Everything is totally symmetric here */
-    nrows = T.params->rowtot[Gnm];
-    ncols = T.params->coltot[Gab];
-    if(nrows && ncols) {
-      global_dpd_->buf4_mat_irrep_init(&Z, Gei);
-      global_dpd_->buf4_mat_irrep_rd(&Z, Gei);
-      global_dpd_->buf4_mat_irrep_init(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_rd(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_row_init(&W, Gei);
-      for(ei=0; ei < W.params->rowtot[Gei]; ei++) {
-	global_dpd_->buf4_mat_irrep_row_rd(&W, Gei, ei);
-	C_DGEMV('t',nrows,ncols,1,T.matrix[Gei][0],ncols,Z.matrix[Gei][ei],1,
-		1,W.matrix[Gei][0],1);
-	global_dpd_->buf4_mat_irrep_row_wrt(&W, Gei, ei);
-      }
-      global_dpd_->buf4_mat_irrep_row_close(&W, Gei);
-      global_dpd_->buf4_mat_irrep_close(&T, Gnm);
-      global_dpd_->buf4_mat_irrep_close(&Z, Gei);
-    }
-  }
+  Wabei_ZT(&W, &Z, &T, 1.0);
   global_dpd_->buf4_close(&T);
   global_dpd_->buf4_close(&Z);
   global_dpd_->buf4_close(&W);
@@ -348,7 +329,6 @@ void Wabei_RHF(void)
 	m = F.params->roworb[Gma][ma][0];
 	a = F.params->roworb[Gma][ma][1];
 	Gm = F.params->psym[m];
-	Ga = F.params->qsym[a];
 	global_dpd_->buf4_mat_irrep_row_rd(&F, Gma, ma);
 	for(Gi=0; Gi < moinfo.nirreps; Gi++) {
 	  Gmi = Gm ^ Gi;
@@ -464,22 +444,25 @@ void Wabei_RHF(void)
   for(Gei=0; Gei < moinfo.nirreps; Gei++) {
     global_dpd_->buf4_mat_irrep_init(&Z, Gei);
     global_dpd_->buf4_mat_irrep_rd(&Z, Gei);
-    global_dpd_->buf4_mat_irrep_row_init(&W, Gei);
-    for(ei=0; ei < Z.params->rowtot[Gei]; ei++) {
-      global_dpd_->buf4_mat_irrep_row_rd(&W, Gei, ei);
-      for(Gm=0; Gm < moinfo.nirreps; Gm++) {
-	Ga = Gm; /* T1 is totally symmetric */
-	Gb = Gm ^ Gei; /* Z is totally symmetric */
-	nrows = moinfo.virtpi[Ga];
-	ncols = moinfo.virtpi[Gb];
-	nlinks = moinfo.occpi[Gm];
-	mb = Z.col_offset[Gei][Gm];
-	ab = W.col_offset[Gei][Ga];
-	if(nrows && ncols && nlinks)
-	  C_DGEMM('t','n',nrows,ncols,nlinks,-1,T1.matrix[Gm][0],nrows,
-		  &(Z.matrix[Gei][ei][mb]),ncols,1,&(W.matrix[Gei][0][ab]),ncols);
+    Buf4Tiles tiles(&W, Gei, dpd_memfree(), true, true);
+    while(tiles.next()) {
+      double **Wp = tiles.block();
+#pragma omp parallel for schedule(dynamic) num_threads(params.nthreads)
+      for(int tile_ei=0; tile_ei < tiles.nrows(); tile_ei++) {
+        int ei = tiles.start() + tile_ei;
+        for(int Gm=0; Gm < moinfo.nirreps; Gm++) {
+          int Ga = Gm; /* T1 is totally symmetric */
+          int Gb = Gm ^ Gei; /* Z is totally symmetric */
+          int na = moinfo.virtpi[Ga];
+          int nb = moinfo.virtpi[Gb];
+          int nm = moinfo.occpi[Gm];
+          int mb = Z.col_offset[Gei][Gm];
+          int ab = W.col_offset[Gei][Ga];
+          if(na && nb && nm)
+            C_DGEMM('t','n',na,nb,nm,-1,T1.matrix[Gm][0],na,
+                    &(Z.matrix[Gei][ei][mb]),nb,1,&(Wp[tile_ei][ab]),nb);
+        }
       }
-      global_dpd_->buf4_mat_irrep_row_wrt(&W, Gei, ei);
     }
     global_dpd_->buf4_mat_irrep_close(&Z, Gei);
   }
@@ -511,22 +494,25 @@ void Wabei_RHF(void)
   for(Gei=0; Gei < moinfo.nirreps; Gei++) {
     global_dpd_->buf4_mat_irrep_init(&Z, Gei);
     global_dpd_->buf4_mat_irrep_rd(&Z, Gei);
-    global_dpd_->buf4_mat_irrep_row_init(&W, Gei);
-    for(ei=0; ei < Z.params->rowtot[Gei]; ei++) {
-      global_dpd_->buf4_mat_irrep_row_rd(&W, Gei, ei);
-      for(Gm=0; Gm < moinfo.nirreps; Gm++) {
-	Gb = Gm; /* T1 is totally symmetric */
-	Ga = Gm ^ Gei; /* Z is totally symmetric */
-	nrows = moinfo.virtpi[Ga];
-	ncols = moinfo.virtpi[Gb];
-	nlinks = moinfo.occpi[Gm];
-	am = Z.col_offset[Gei][Ga];
-	ab = W.col_offset[Gei][Ga];
-	if(nrows && ncols && nlinks)
-	  C_DGEMM('n','n',nrows,ncols,nlinks,1,&(Z.matrix[Gei][ei][am]),nlinks,
-		  T1.matrix[Gm][0],ncols,1,&(W.matrix[Gei][0][ab]),ncols);
+    Buf4Tiles tiles(&W, Gei, dpd_memfree(), true, true);
+    while(tiles.next()) {
+      double **Wp = tiles.block();
+#pragma omp parallel for schedule(dynamic) num_threads(params.nthreads)
+      for(int tile_ei=0; tile_ei < tiles.nrows(); tile_ei++) {
+        int ei = tiles.start() + tile_ei;
+        for(int Gm=0; Gm < moinfo.nirreps; Gm++) {
+          int Gb = Gm; /* T1 is totally symmetric */
+          int Ga = Gm ^ Gei; /* Z is totally symmetric */
+          int na = moinfo.virtpi[Ga];
+          int nb = moinfo.virtpi[Gb];
+          int nm = moinfo.occpi[Gm];
+          int am = Z.col_offset[Gei][Ga];
+          int ab = W.col_offset[Gei][Ga];
+          if(na && nb && nm)
+            C_DGEMM('n','n',na,nb,nm,1,&(Z.matrix[Gei][ei][am]),nm,
+                    T1.matrix[Gm][0],nb,1,&(Wp[tile_ei][ab]),nb);
+        }
       }
-      global_dpd_->buf4_mat_irrep_row_wrt(&W, Gei, ei);
     }
     global_dpd_->buf4_mat_irrep_close(&Z, Gei);
   }
@@ -81,6 +81,10 @@ void get_params(Options &options)
 //  params.wabei_lowdisk = 0;
 //  errcod = ip_boolean("WABEI_LOWDISK", &params.wabei_lowdisk, 0);
   params.wabei_lowdisk = options.get_bool("WABEI_LOWDISK");
+
+  params.nthreads = Process::environment.get_n_threads();
+  if (options["CC_NUM_THREADS"].has_changed())
+    params.nthreads = options.get_int("CC_NUM_THREADS");
 }
 
 }} // namespace psi::cchbar
@@ -35,11 +35,15 @@
 
 namespace psi { namespace cclambda {
 
+/* Length of the DIIS subspace kept by diis() */
+static const int diis_nvector = 8;
+
 /* Input parameters for cclambda */
 struct Params {
   int maxiter;
   double convergence;
   int restart;
+  int checkpoint_freq;  /* iterations between ground-state L checkpoints, 0 for none */
   long int memory;
   int cachelev;
   int aobasis;
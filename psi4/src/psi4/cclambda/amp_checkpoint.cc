@@ -0,0 +1,84 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*! \file
+    \ingroup CCLAMBDA
+    \brief Enter brief description of file here
+*/
+#include <cstdio>
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libdpd/amp_checkpoint.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
+#include "MOInfo.h"
+#include "Params.h"
+#include "cclambda.h"
+#define EXTERN
+#include "globals.h"
+
+namespace psi { namespace cclambda {
+
+/* amp_checkpoint(): The restart file for the ground-state Lambda
+** equations under CC_CHECKPOINT_FREQ.  For RHF only LIA and LIjAb enter
+** the DIIS vector, the other spin cases are kept so that the restored L
+** is complete.
+*/
+
+std::shared_ptr<AmpCheckpoint> CCLambdaWavefunction::amp_checkpoint()
+{
+  std::string path = get_writer_file_prefix(molecule_->name()) + ".cclamps";
+
+  std::shared_ptr<AmpCheckpoint> chk(new AmpCheckpoint(path, "CCLAMBDA " + params.wfn + " " + std::to_string(params.ref)));
+  chk->add_orbitals(Ca_);
+  if(params.ref == 2) chk->add_orbitals(Cb_);
+
+  if(params.ref == 0) { /** RHF **/
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 0, 1, "LIA");
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 0, 1, "Lia", false);
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 2, 7, "LIJAB", false);
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 2, 7, "Lijab", false);
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 0, 5, "LIjAb");
+  }
+  else if(params.ref == 1) { /** ROHF **/
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 0, 1, "LIA");
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 0, 1, "Lia");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 2, 7, "LIJAB");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 2, 7, "Lijab");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 0, 5, "LIjAb");
+  }
+  else if(params.ref == 2) { /** UHF **/
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 0, 1, "LIA");
+    chk->add_file2(PSIF_CC_LAMBDA, 0, 2, 3, "Lia");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 2, 7, "LIJAB");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 12, 17, "Lijab");
+    chk->add_file4(PSIF_CC_LAMBDA, 0, 22, 28, "LIjAb");
+  }
+
+  return chk;
+}
+
+}} // namespace psi::cclambda
@@ -49,7 +49,9 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libmints/wavefunction.h"
+#include "psi4/libdpd/amp_checkpoint.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -250,6 +252,16 @@ double CCLambdaWavefunction::compute_energy()
       denom(pL_params[i]); /* uses L_params.cceom_energy for excited states */
       init_amps(pL_params[i]); /* uses denominators for initial zeta guess */
 
+      /* Pick up the ground-state L of an interrupted run.  RESTART is off by
+         default here, so only an explicit RESTART = false skips the file. */
+      std::shared_ptr<AmpCheckpoint> amp_chk;
+      int first_iter = 1;
+      if(params.checkpoint_freq > 0 && pL_params[i].ground) {
+        amp_chk = amp_checkpoint();
+        if(params.restart || !options_["RESTART"].has_changed())
+          first_iter = amp_chk->read() + 1;
+      }
+
       outfile->Printf( "\n\t          Solving Lambda Equations\n");
       outfile->Printf( "\t          ------------------------\n");
       outfile->Printf( "\tIter     PseudoEnergy or Norm         RMS  \n");
@@ -258,7 +270,7 @@ double CCLambdaWavefunction::compute_energy()
       moinfo.lcc = pseudoenergy(pL_params[i]);
       update();
 
-      for(moinfo.iter=1 ; moinfo.iter <= params.maxiter; moinfo.iter++) {
+      for(moinfo.iter=first_iter ; moinfo.iter <= params.maxiter; moinfo.iter++) {
         sort_amps(pL_params[i].irrep);
 
         /* must zero New L before adding RHS */
@@ -302,6 +314,9 @@ double CCLambdaWavefunction::compute_energy()
       /* sort_amps(); to be done by later functions */
           outfile->Printf( "\n\tIterations converged.\n");
 
+          /* No DIIS step was taken this iteration, so resuming means redoing it */
+          if(amp_chk) amp_chk->write(moinfo.iter-1, params.diis ? std::min(moinfo.iter-1, diis_nvector) : 0);
+
           moinfo.iter = 0;
           break;
         }
@@ -310,6 +325,8 @@ double CCLambdaWavefunction::compute_energy()
         Lsave(pL_params[i].irrep);
         moinfo.lcc = pseudoenergy(pL_params[i]);
         update();
+        if(amp_chk && moinfo.iter % params.checkpoint_freq == 0)
+          amp_chk->write(moinfo.iter, params.diis ? std::min(moinfo.iter, diis_nvector) : 0);
       }
       outfile->Printf( "\n");
       if(!done) {
@@ -34,6 +34,7 @@
 namespace psi {
 class Wavefunction;
 class Options;
+class AmpCheckpoint;
 }
 
 namespace psi { namespace cclambda {
@@ -48,6 +49,7 @@ public:
 
 private:
     void init();
+    std::shared_ptr<AmpCheckpoint> amp_checkpoint();
 };
 
 }}
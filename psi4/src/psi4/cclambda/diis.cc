@@ -62,7 +62,7 @@ namespace psi { namespace cclambda {
 
 void diis(int iter, int L_irr)
 {
-  int nvector=8;  /* Number of error vectors to keep */
+  int nvector=diis_nvector;  /* Number of error vectors to keep */
   int h, nirreps;
   int row, col, word, p, q, i;
   int diis_cycle;
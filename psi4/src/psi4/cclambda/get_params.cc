@@ -90,6 +90,7 @@ void get_params(Options& options)
   params.convergence = options.get_double("R_CONVERGENCE");
 
   params.restart = options.get_bool("RESTART");
+  params.checkpoint_freq = options.get_int("CC_CHECKPOINT_FREQ");
 
   params.memory = Process::environment.get_memory();
 
@@ -452,6 +453,8 @@ void get_params(Options& options)
   outfile->Printf( "\tRestart           =     %s\n", params.restart ? "Yes" : "No");
   outfile->Printf( "\tCache Level       =     %1d\n", params.cachelev);
   outfile->Printf( "\tModel III         =     %s\n", params.sekino ? "Yes" : "No");
+  if(params.checkpoint_freq)
+    outfile->Printf( "\tCheckpoint Freq   =   %4d\n", params.checkpoint_freq);
   outfile->Printf( "\tDIIS              =     %s\n", params.diis ? "Yes" : "No");
   outfile->Printf( "\tAO Basis          =     %s\n",
           params.aobasis ? "Yes" : "No");
@@ -34,13 +34,16 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <vector>
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/exception.h"
 #include "MOInfo.h"
 #include "Params.h"
 #include "Local.h"
+#include "XSolve.h"
 #define EXTERN
 #include "globals.h"
 
@@ -49,7 +52,11 @@ namespace psi { namespace ccresponse {
 void denom2(dpdbuf4 *X2, double omega);
 void local_filter_T2(dpdbuf4 *T2);
 
-void X2_build(const char *pert, int irrep, double omega)
+/* X2_build(): The X2 residual of one perturbed wave function. With
+** abcd_done, the S and A halves of the <ab||cd> ladder are already on
+** PSIF_CC_TMP0 (from X2_abcd_block()) and only their diagonal correction
+** and sort into the residual are done here. */
+void X2_build(const char *pert, int irrep, double omega, bool abcd_done)
 {
   dpdfile2 X1, z, F, t1;
   dpdbuf4 X2, X2new, Z, Z1, Z2, W, T2, I;
@@ -257,17 +264,19 @@ void X2_build(const char *pert, int irrep, double omega)
 
     global_dpd_->buf4_close(&X2);
 
-    timer_on("ABCD:S");
-    sprintf(lbl, "X_%s_(+)(ij,ab) (%5.3f)", pert, omega);
-    global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 3, 8, 3, 8, 0, lbl);
-    global_dpd_->buf4_init(&I, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-    sprintf(lbl, "S_%s_(ab,ij)", pert);
-    global_dpd_->buf4_init(&S, PSIF_CC_TMP0, irrep, 8, 3, 8, 3, 0, lbl);
-    global_dpd_->contract444(&I, &X2, &S, 0, 0, 0.5, 0);
-    global_dpd_->buf4_close(&S);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->buf4_close(&X2);
-    timer_off("ABCD:S");
+    if(!abcd_done) {
+      timer_on("ABCD:S");
+      sprintf(lbl, "X_%s_(+)(ij,ab) (%5.3f)", pert, omega);
+      global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 3, 8, 3, 8, 0, lbl);
+      global_dpd_->buf4_init(&I, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
+      sprintf(lbl, "S_%s_(ab,ij) (%5.3f)", pert, omega);
+      global_dpd_->buf4_init(&S, PSIF_CC_TMP0, irrep, 8, 3, 8, 3, 0, lbl);
+      global_dpd_->contract444(&I, &X2, &S, 0, 0, 0.5, 0);
+      global_dpd_->buf4_close(&S);
+      global_dpd_->buf4_close(&I);
+      global_dpd_->buf4_close(&X2);
+      timer_off("ABCD:S");
+    }
 
     /* X_diag(ij,c)  = 2 * X(ij,cc)*/
     /* NB: Gcc = 0 and B is totally symmetry, so Gab = 0 */
@@ -287,7 +296,7 @@ void X2_build(const char *pert, int irrep, double omega)
     global_dpd_->buf4_mat_irrep_close(&X2, irrep);
 
     global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-    sprintf(lbl, "S_%s_(ab,ij)", pert);
+    sprintf(lbl, "S_%s_(ab,ij) (%5.3f)", pert, omega);
     global_dpd_->buf4_init(&S, PSIF_CC_TMP0, irrep, 8, 3, 8, 3, 0, lbl);
     global_dpd_->buf4_mat_irrep_init(&S, 0);
     global_dpd_->buf4_mat_irrep_rd(&S, 0);
@@ -328,26 +337,28 @@ void X2_build(const char *pert, int irrep, double omega)
     global_dpd_->free_dpd_block(X_diag, X2.params->rowtot[irrep], moinfo.nvirt);
     global_dpd_->buf4_close(&X2);
 
-    timer_on("ABCD:A");
-    sprintf(lbl, "X_%s_(-)(ij,ab) (%5.3f)", pert, omega);
-    global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 4, 9, 4, 9, 0, lbl);
-    global_dpd_->buf4_init(&I, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
-    sprintf(lbl, "A_%s_(ab,ij)", pert);
-    global_dpd_->buf4_init(&A, PSIF_CC_TMP0, irrep, 9, 4, 9, 4, 0, lbl);
-    global_dpd_->contract444(&I, &X2, &A, 0, 0, 0.5, 0);
-    global_dpd_->buf4_close(&A);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->buf4_close(&X2);
-    timer_off("ABCD:A");
+    if(!abcd_done) {
+      timer_on("ABCD:A");
+      sprintf(lbl, "X_%s_(-)(ij,ab) (%5.3f)", pert, omega);
+      global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 4, 9, 4, 9, 0, lbl);
+      global_dpd_->buf4_init(&I, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
+      sprintf(lbl, "A_%s_(ab,ij) (%5.3f)", pert, omega);
+      global_dpd_->buf4_init(&A, PSIF_CC_TMP0, irrep, 9, 4, 9, 4, 0, lbl);
+      global_dpd_->contract444(&I, &X2, &A, 0, 0, 0.5, 0);
+      global_dpd_->buf4_close(&A);
+      global_dpd_->buf4_close(&I);
+      global_dpd_->buf4_close(&X2);
+      timer_off("ABCD:A");
+    }
 
     timer_on("ABCD:axpy");
     global_dpd_->buf4_close(&X2new);  /* Need to close X2new to avoid collisions */
-    sprintf(lbl, "S_%s_(ab,ij)", pert);
+    sprintf(lbl, "S_%s_(ab,ij) (%5.3f)", pert, omega);
     global_dpd_->buf4_init(&S, PSIF_CC_TMP0, irrep, 5, 0, 8, 3, 0, lbl);
     sprintf(lbl, "New X_%s_IjAb (%5.3f)", pert, omega);
     global_dpd_->buf4_sort_axpy(&S, PSIF_CC_LR, rspq, 0, 5, lbl, 1);
     global_dpd_->buf4_close(&S);
-    sprintf(lbl, "A_%s_(ab,ij)", pert);
+    sprintf(lbl, "A_%s_(ab,ij) (%5.3f)", pert, omega);
     global_dpd_->buf4_init(&A, PSIF_CC_TMP0, irrep, 5, 0, 9, 4, 0, lbl);
     sprintf(lbl, "New X_%s_IjAb (%5.3f)", pert, omega);
     global_dpd_->buf4_sort_axpy(&A, PSIF_CC_LR, rspq, 0, 5, lbl, 1);
@@ -477,4 +488,115 @@ void X2_build(const char *pert, int irrep, double omega)
   global_dpd_->buf4_close(&X2new);
 }
 
+/*
+** X2_abcd_block(): The S and A halves of the <ab||cd> ladder,
+**
+**  S(ab,ij) = 1/2 B(+)(ab,cd) X(+)(ij,cd),  A(ab,ij) = 1/2 B(-)(ab,cd) X(-)(ij,cd)
+**
+** for every solve of a block at once. Each symmetry block of B(+) and
+** B(-) is read once, in row tiles, and multiplied into all the X blocks
+** of matching symmetry held in core. Solves are batched when their X and
+** target blocks do not all fit; each batch makes its own pass over B.
+*/
+void X2_abcd_block(const std::vector<XSolve> &solves)
+{
+  int nsolve = solves.size();
+  int nirreps = moinfo.nirreps;
+  char lbl[32];
+
+  for(int half=0; half < 2; half++) {
+    int xpq = (half ? 4 : 3);
+    int bpq = (half ? 9 : 8);
+    const char *xlbl = (half ? "X_%s_(-)(ij,ab) (%5.3f)" : "X_%s_(+)(ij,ab) (%5.3f)");
+    const char *zlbl = (half ? "A_%s_(ab,ij) (%5.3f)" : "S_%s_(ab,ij) (%5.3f)");
+
+    timer_on(half ? "ABCD:A" : "ABCD:S");
+
+    dpdbuf4 B;
+    global_dpd_->buf4_init(&B, PSIF_CC_BINTS, 0, bpq, bpq, bpq, bpq, 0,
+                           half ? "B(-) <ab|cd> - <ab|dc>" : "B(+) <ab|cd> + <ab|dc>");
+    std::vector<dpdbuf4> X(nsolve), Z(nsolve);
+    for(int k=0; k < nsolve; k++) {
+      sprintf(lbl, xlbl, solves[k].pert.c_str(), solves[k].omega);
+      global_dpd_->buf4_init(&X[k], PSIF_CC_LR, solves[k].irrep, xpq, bpq, xpq, bpq, 0, lbl);
+      sprintf(lbl, zlbl, solves[k].pert.c_str(), solves[k].omega);
+      global_dpd_->buf4_init(&Z[k], PSIF_CC_TMP0, solves[k].irrep, bpq, xpq, bpq, xpq, 0, lbl);
+    }
+
+    /* If a single solve's blocks do not fit in core, leave it all to contract444() */
+    bool incore = true;
+    for(int h=0; h < nirreps; h++)
+      for(int k=0; k < nsolve; k++) {
+        long int nij = X[k].params->rowtot[h ^ solves[k].irrep];
+        long int ncd = B.params->coltot[h];
+        if(nij * ncd + B.params->rowtot[h] * nij + ncd > dpd_memfree()) incore = false;
+      }
+    if(!incore)
+      for(int k=0; k < nsolve; k++)
+        global_dpd_->contract444(&B, &X[k], &Z[k], 0, 0, 0.5, 0);
+
+    /* h is the symmetry of ab and cd; ij has h ^ irrep */
+    for(int h=0; h < nirreps && incore; h++) {
+      int nab = B.params->rowtot[h];
+      int ncd = B.params->coltot[h];
+
+      for(int k0=0; k0 < nsolve; ) {
+        /* as many solves as fit beside at least one row of B */
+        long int avail = dpd_memfree() - ncd;
+        long int used = 0;
+        int k1 = k0;
+        for(; k1 < nsolve; k1++) {
+          long int nij = X[k1].params->rowtot[h ^ solves[k1].irrep];
+          long int need = nij * ncd + nab * nij;
+          if(k1 > k0 && used + need > avail) break;
+          used += need;
+        }
+
+        for(int k=k0; k < k1; k++) {
+          int Gij = h ^ solves[k].irrep;
+          global_dpd_->buf4_mat_irrep_init(&X[k], Gij);
+          global_dpd_->buf4_mat_irrep_rd(&X[k], Gij);
+          global_dpd_->buf4_mat_irrep_init(&Z[k], h);
+        }
+
+        if(nab && ncd) {
+          long int maxrows = dpd_memfree()/ncd;
+          if(maxrows < 1)
+            throw PSIEXCEPTION("CCRESPONSE: not enough memory for a row of the <ab|cd> integrals");
+          int rows_per_bucket = (maxrows < nab) ? (int) maxrows : nab;
+
+          global_dpd_->buf4_mat_irrep_init_block(&B, h, rows_per_bucket);
+          for(int row=0; row < nab; row += rows_per_bucket) {
+            int nrows = (nab - row < rows_per_bucket) ? nab - row : rows_per_bucket;
+            global_dpd_->buf4_mat_irrep_rd_block(&B, h, row, nrows);
+            for(int k=k0; k < k1; k++) {
+              int Gij = h ^ solves[k].irrep;
+              int nij = X[k].params->rowtot[Gij];
+              if(nij)
+                C_DGEMM('n', 't', nrows, nij, ncd, 0.5, B.matrix[h][0], ncd,
+                        X[k].matrix[Gij][0], ncd, 0.0, Z[k].matrix[h][row], nij);
+            }
+          }
+          global_dpd_->buf4_mat_irrep_close_block(&B, h, rows_per_bucket);
+        }
+
+        for(int k=k0; k < k1; k++) {
+          global_dpd_->buf4_mat_irrep_wrt(&Z[k], h);
+          global_dpd_->buf4_mat_irrep_close(&Z[k], h);
+          global_dpd_->buf4_mat_irrep_close(&X[k], h ^ solves[k].irrep);
+        }
+        k0 = k1;
+      }
+    }
+
+    for(int k=0; k < nsolve; k++) {
+      global_dpd_->buf4_close(&Z[k]);
+      global_dpd_->buf4_close(&X[k]);
+    }
+    global_dpd_->buf4_close(&B);
+
+    timer_off(half ? "ABCD:A" : "ABCD:S");
+  }
+}
+
 }} // namespace psi::ccresponse
@@ -26,18 +26,25 @@
  * @END LICENSE
  */
 
-#include "psi4/libdpd/dpd.h"
+/*! \file
+    \ingroup ccresponse
+    \brief One perturbed wave function of a block of linear-response solves
+*/
+#ifndef _psi_src_bin_ccresponse_xsolve_h
+#define _psi_src_bin_ccresponse_xsolve_h
 
-namespace psi { namespace cctransort {
+#include <string>
 
-void e_spinad(void)
-{
-  dpdbuf4 E;
+namespace psi { namespace ccresponse {
 
-  global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-  global_dpd_->buf4_scmcopy(&E, PSIF_CC_EINTS, "E 2<ai|jk> - <ai|kj>", 2);
-  global_dpd_->buf4_sort_axpy(&E, PSIF_CC_EINTS, pqsr, 11, 0, "E 2<ai|jk> - <ai|kj>", -1);
-  global_dpd_->buf4_close(&E);
-}
+/* The perturbation label, its irrep, and the frequency of one X solve.
+** compute_X_block() iterates any number of these together. */
+struct XSolve {
+  std::string pert;
+  int irrep;
+  double omega;
+};
 
-}} // namespace psi::cctranssort
+}} // namespace psi::ccresponse
+
+#endif
@@ -34,6 +34,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <vector>
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
@@ -42,6 +43,7 @@
 #include "MOInfo.h"
 #include "Params.h"
 #include "Local.h"
+#include "XSolve.h"
 #define EXTERN
 #include "globals.h"
 
@@ -51,7 +53,8 @@ void init_X(const char *pert, int irrep, double omega);
 void sort_X(const char *pert, int irrep, double omega);
 void cc2_sort_X(const char *pert, int irrep, double omega);
 void X1_build(const char *pert, int irrep, double omega);
-void X2_build(const char *pert, int irrep, double omega);
+void X2_build(const char *pert, int irrep, double omega, bool abcd_done);
+void X2_abcd_block(const std::vector<XSolve> &solves);
 void cc2_X1_build(const char *pert, int irrep, double omega);
 void cc2_X2_build(const char *pert, int irrep, double omega);
 double converged(const char *pert, int irrep, double omega);
@@ -65,78 +68,111 @@ void exit_io(void);
 void amp_write(const char *pert, int irrep, double omega);
 
 void analyze(const char *pert, int irrep, double omega);
+void compute_X_block(const std::vector<XSolve> &solves);
 
 void compute_X(const char *pert, int irrep, double omega)
 {
-  int i, iter=0, done=0;
+  compute_X_block(std::vector<XSolve>(1, XSolve{pert, irrep, omega}));
+}
+
+/*
+** compute_X_block(): Solves the perturbed wave function equations of
+** several perturbations and/or frequencies together. Every unconverged
+** solve takes one step per macroiteration, so each pass over the Hbar
+** and integral buffers serves all of them, and the <ab||cd> ladder (the
+** dominant cost for CCSD) is done for the whole block in one sweep of the
+** B integrals by X2_abcd_block(). Solves drop out as they converge.
+*/
+void compute_X_block(const std::vector<XSolve> &solves)
+{
+  int iter, nsolve = solves.size(), nactive = nsolve;
   double rms, polar, X2_norm;
-  char lbl[32];
+  char lbl[64];
   dpdbuf4 X2;
+  std::vector<int> done(nsolve, 0);
+  std::vector<XSolve> active;
+  bool cc2 = (params.wfn == "CC2");
+  bool abcd_block = (!cc2 && params.abcd == "NEW");
 
   timer_on("compute_X");
 
-  outfile->Printf( "\n\tComputing %s-Perturbed Wave Function (%5.3f E_h).\n", pert, omega);
-  init_X(pert, irrep, omega);
-  outfile->Printf( "\tIter   Pseudopolarizability       RMS \n");
-  outfile->Printf( "\t----   --------------------   -----------\n");
+  for(int k=0; k < nsolve; k++) {
+    const char *pert = solves[k].pert.c_str();
+    outfile->Printf( "\n\tComputing %s-Perturbed Wave Function (%5.3f E_h).\n", pert, solves[k].omega);
+    init_X(pert, solves[k].irrep, solves[k].omega);
+  }
+  if(nsolve > 1)
+    outfile->Printf( "\n\tIterating the %d perturbed wave functions together.\n", nsolve);
+  outfile->Printf( "\tIter   Perturbation  Omega   Pseudopolarizability       RMS \n");
+  outfile->Printf( "\t----   ------------  -----   --------------------   -----------\n");
+
+  for(int k=0; k < nsolve; k++) {
+    const char *pert = solves[k].pert.c_str();
+    if(cc2) cc2_sort_X(pert, solves[k].irrep, solves[k].omega);
+    else sort_X(pert, solves[k].irrep, solves[k].omega);
+    polar = -2.0*pseudopolar(pert, solves[k].irrep, solves[k].omega);
+    outfile->Printf( "\t%4d   %-12s %6.3f   %20.12f\n", 0, pert, solves[k].omega, polar);
+  }
 
+  for(iter=1; iter <= params.maxiter && nactive; iter++) {
 
-  if (params.wfn == "CC2")
-    cc2_sort_X(pert, irrep, omega);
-  else
-    sort_X(pert, irrep, omega);
-  polar = -2.0*pseudopolar(pert, irrep, omega);
-  outfile->Printf( "\t%4d   %20.12f\n", iter, polar);
+    active.clear();
+    for(int k=0; k < nsolve; k++) {
+      if(done[k]) continue;
+      active.push_back(solves[k]);
+      const char *pert = solves[k].pert.c_str();
+      if(cc2) cc2_sort_X(pert, solves[k].irrep, solves[k].omega);
+      else sort_X(pert, solves[k].irrep, solves[k].omega);
+    }
 
+    if(abcd_block) X2_abcd_block(active);
 
-  for(iter=1; iter <= params.maxiter; iter++) {
+    for(int k=0; k < nsolve; k++) {
+      if(done[k]) continue;
+      const char *pert = solves[k].pert.c_str();
+      int irrep = solves[k].irrep;
+      double omega = solves[k].omega;
 
-    if (params.wfn == "CC2") {
-      cc2_sort_X(pert, irrep, omega);
-      cc2_X1_build(pert, irrep, omega);
-      cc2_X2_build(pert, irrep, omega);
-    }
-    else {
-      sort_X(pert, irrep, omega);
-      X1_build(pert, irrep, omega);
-      X2_build(pert, irrep, omega);
-    }
-    update_X(pert, irrep, omega);
-    rms = converged(pert, irrep, omega);
-    if(rms <= params.convergence) {
-      done = 1;
-      save_X(pert, irrep, omega);
-      if (params.wfn == "CC2")
-        cc2_sort_X(pert, irrep, omega);
-      else
-        sort_X(pert, irrep, omega);
-      outfile->Printf( "\t-----------------------------------------\n");
-      outfile->Printf( "\tConverged %s-Perturbed Wfn to %4.3e\n", pert, rms);
-      if(params.print & 2) {
-        sprintf(lbl, "X_%s_IjAb (%5.3f)", pert, omega);
-        global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 0, 5, 0, 5, 0, lbl);
-        X2_norm = global_dpd_->buf4_dot_self(&X2);
-        global_dpd_->buf4_close(&X2);
-        X2_norm = sqrt(X2_norm);
-        outfile->Printf( "\tNorm of the converged X2 amplitudes %20.15f\n", X2_norm);
-        amp_write(pert, irrep, omega);
+      if(cc2) {
+        cc2_X1_build(pert, irrep, omega);
+        cc2_X2_build(pert, irrep, omega);
+      }
+      else {
+        X1_build(pert, irrep, omega);
+        X2_build(pert, irrep, omega, abcd_block);
       }
+      update_X(pert, irrep, omega);
+      rms = converged(pert, irrep, omega);
+      if(rms <= params.convergence) {
+        done[k] = 1;
+        nactive--;
+        save_X(pert, irrep, omega);
+        if(cc2) cc2_sort_X(pert, irrep, omega);
+        else sort_X(pert, irrep, omega);
+        outfile->Printf( "\tConverged %s-Perturbed Wfn (%5.3f E_h) to %4.3e\n", pert, omega, rms);
+        if(params.print & 2) {
+          sprintf(lbl, "X_%s_IjAb (%5.3f)", pert, omega);
+          global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 0, 5, 0, 5, 0, lbl);
+          X2_norm = global_dpd_->buf4_dot_self(&X2);
+          global_dpd_->buf4_close(&X2);
+          X2_norm = sqrt(X2_norm);
+          outfile->Printf( "\tNorm of the converged X2 amplitudes %20.15f\n", X2_norm);
+          amp_write(pert, irrep, omega);
+        }
+        continue;
+      }
+      if(params.diis) diis(iter, pert, irrep, omega);
+      save_X(pert, irrep, omega);
+      if(cc2) cc2_sort_X(pert, irrep, omega);
+      else sort_X(pert, irrep, omega);
 
-      break;
+      polar = -2.0*pseudopolar(pert, irrep, omega);
+      outfile->Printf( "\t%4d   %-12s %6.3f   %20.12f    %4.3e\n", iter, pert, omega, polar, rms);
     }
-    if(params.diis) diis(iter, pert, irrep, omega);
-    save_X(pert, irrep, omega);
-    if (params.wfn == "CC2")
-      cc2_sort_X(pert, irrep, omega);
-    else
-      sort_X(pert, irrep, omega);
-
-    polar = -2.0*pseudopolar(pert, irrep, omega);
-    outfile->Printf( "\t%4d   %20.12f    %4.3e\n", iter, polar, rms);
-
-
   }
-  if(!done) {
+  outfile->Printf( "\t-------------------------------------------------------------\n");
+
+  if(nactive) {
 
     dpd_close(0);
     cleanup();
@@ -151,12 +187,14 @@ void compute_X(const char *pert, int irrep, double omega)
   psio_open(PSIF_CC_DIIS_AMP, 0);
   psio_open(PSIF_CC_DIIS_ERR, 0);
 
-  for(i=PSIF_CC_TMP; i <= PSIF_CC_TMP11; i++) {
+  for(int i=PSIF_CC_TMP; i <= PSIF_CC_TMP11; i++) {
     psio_close(i,0);
     psio_open(i,0);
   }
 
-  if(params.analyze) analyze(pert, irrep, omega);
+  if(params.analyze)
+    for(int k=0; k < nsolve; k++)
+      analyze(solves[k].pert.c_str(), solves[k].irrep, solves[k].omega);
 
   /*  print_X(pert, irrep, omega); */
 
@@ -77,7 +77,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
   double **error;
   double **B, *C, **vector;
   double product, determinant, maximum;
-  char lbl[32];
+  char lbl[64];
 
   nirreps = moinfo.nirreps;
 
@@ -135,7 +135,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
     global_dpd_->buf4_close(&T2b);
 
     start = psio_get_address(PSIO_ZERO, diis_cycle*vector_length*sizeof(double));
-    sprintf(lbl, "DIIS %s Error Vectors", pert);
+    sprintf(lbl, "DIIS %s Error Vectors (%5.3f)", pert, omega);
     psio_write(PSIF_CC_DIIS_ERR, lbl , (char *) error[0],
                vector_length*sizeof(double), start, &end);
 
@@ -166,7 +166,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
     global_dpd_->buf4_close(&T2a);
 
     start = psio_get_address(PSIO_ZERO, diis_cycle*vector_length*sizeof(double));
-    sprintf(lbl, "DIIS %s Amplitude Vectors", pert);
+    sprintf(lbl, "DIIS %s Amplitude Vectors (%5.3f)", pert, omega);
     psio_write(PSIF_CC_DIIS_AMP, lbl , (char *) error[0],
                vector_length*sizeof(double), start, &end);
 
@@ -187,7 +187,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
 
       start = psio_get_address(PSIO_ZERO, p*vector_length*sizeof(double));
 
-      sprintf(lbl, "DIIS %s Error Vectors", pert);
+      sprintf(lbl, "DIIS %s Error Vectors (%5.3f)", pert, omega);
       psio_read(PSIF_CC_DIIS_ERR, lbl, (char *) vector[0],
                 vector_length*sizeof(double), start, &end);
 
@@ -200,7 +200,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
 
         start = psio_get_address(PSIO_ZERO, q*vector_length*sizeof(double));
 
-        sprintf(lbl, "DIIS %s Error Vectors", pert);
+        sprintf(lbl, "DIIS %s Error Vectors (%5.3f)", pert, omega);
         psio_read(PSIF_CC_DIIS_ERR, lbl, (char *) vector[1],
                   vector_length*sizeof(double), start, &end);
 
@@ -248,7 +248,7 @@ void diis(int iter, const char *pert, int irrep, double omega)
 
       start = psio_get_address(PSIO_ZERO, p*vector_length*sizeof(double));
 
-      sprintf(lbl, "DIIS %s Amplitude Vectors", pert);
+      sprintf(lbl, "DIIS %s Amplitude Vectors (%5.3f)", pert, omega);
       psio_read(PSIF_CC_DIIS_AMP, lbl, (char *) vector[0],
                 vector_length*sizeof(double), start, &end);
 
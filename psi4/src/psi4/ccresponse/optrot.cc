@@ -70,6 +70,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <vector>
 
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libciomr/libciomr.h"
@@ -83,12 +84,13 @@
 #include "Local.h"
 #define EXTERN
 #include "globals.h"
+#include "XSolve.h"
 #include "psi4/physconst.h"
 
 namespace psi { namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_block(const std::vector<XSolve> &solves);
 void linresp(double *tensor, double A, double B,
              const char *pert_x, int x_irrep, double omega_x,
              const char *pert_y, int y_irrep, double omega_y);
@@ -98,6 +100,7 @@ void optrot(std::shared_ptr<Molecule> molecule)
   double ***tensor_rl, ***tensor_pl, ***tensor_rp, **tensor0;
   double **tensor_rl0, **tensor_rl1, **tensor_pl0, **tensor_pl1;
   char **cartcomp, pert[32], pert_x[32], pert_y[32];
+  std::vector<XSolve> solves;
   int alpha, beta, i, j, k;
   double TrG_rl, TrG_pl, M, nu, bohr2a4, m2a, hbar, prefactor;
   double *rotation_rl, *rotation_pl, *rotation_rp, *rotation_mod, **delta;
@@ -151,13 +154,16 @@ void optrot(std::shared_ptr<Molecule> molecule)
       for(alpha=0; alpha < 3; alpha++) {
         sprintf(pert, "P_%1s", cartcomp[alpha]);
         pertbar(pert, moinfo.mu_irreps[alpha], 1);
-        compute_X(pert, moinfo.mu_irreps[alpha], 0);
+        solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], 0});
 
         sprintf(pert, "L_%1s", cartcomp[alpha]);
         pertbar(pert, moinfo.l_irreps[alpha], 1);
-        compute_X(pert, moinfo.l_irreps[alpha], 0);
+        solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], 0});
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n\tComputing %s tensor.\n", lbl1);
       for(alpha=0; alpha < 3; alpha ++) {
         for(beta=0; beta < 3; beta++) {
@@ -230,18 +236,21 @@ void optrot(std::shared_ptr<Molecule> molecule)
       for(alpha=0; alpha < 3; alpha++) {
         if(compute_rl) {
           sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-          compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+          solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], -params.omega[i]});
         }
 
         if(compute_pl) {
           sprintf(pert, "P_%1s", cartcomp[alpha]);
-          compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+          solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], -params.omega[i]});
         }
 
         sprintf(pert, "L_%1s", cartcomp[alpha]);
-        compute_X(pert, moinfo.l_irreps[alpha], params.omega[i]);
+        solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], params.omega[i]});
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n");
       if(compute_rl) {
         outfile->Printf( "\tComputing %s tensor.\n", lbl1);
@@ -323,17 +332,20 @@ void optrot(std::shared_ptr<Molecule> molecule)
       for(alpha=0; alpha < 3; alpha++) {
         if(compute_rl) {
           sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-          compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
+          solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], params.omega[i]});
         }
         if(compute_pl) {
           sprintf(pert, "P*_%1s", cartcomp[alpha]);
-          compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
+          solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], params.omega[i]});
         }
 
         sprintf(pert, "L*_%1s", cartcomp[alpha]);
-        compute_X(pert, moinfo.l_irreps[alpha], -params.omega[i]);
+        solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], -params.omega[i]});
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n");
       if(compute_rl) {
         outfile->Printf( "\tComputing %s tensor.\n", lbl1);
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <vector>
 
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libciomr/libciomr.h"
@@ -43,13 +44,14 @@
 #include "MOInfo.h"
 #include "Params.h"
 #include "Local.h"
+#include "XSolve.h"
 #define EXTERN
 #include "globals.h"
 
 namespace psi { namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_block(const std::vector<XSolve> &solves);
 void linresp(double *tensor, double A, double B,
 	     const char *pert_x, int x_irrep, double omega_x,
 	     const char *pert_y, int y_irrep, double omega_y);
@@ -74,17 +76,32 @@ void polar(void)
 
   trace = init_array(params.nomega);
 
+  /* The perturbed wave functions of all components and frequencies not
+     already on disk are solved for together */
+  std::vector<int> compute(params.nomega, 0);
+  std::vector<XSolve> solves;
   for(i=0; i < params.nomega; i++) {
-
     sprintf(lbl, "<<Mu;Mu>_(%5.3f)", params.omega[i]);
-    if(!params.restart || !psio_tocscan(PSIF_CC_INFO, lbl)) {
+    compute[i] = (!params.restart || !psio_tocscan(PSIF_CC_INFO, lbl));
+    if(!compute[i]) continue;
+    for(alpha=0; alpha < 3; alpha++) {
+      sprintf(pert, "Mu_%1s", cartcomp[alpha]);
+      solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], params.omega[i]});
+      if(params.omega[i] != 0.0) solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], -params.omega[i]});
+    }
+  }
+  if(!solves.empty()) {
+    for(alpha=0; alpha < 3; alpha++) {
+      sprintf(pert, "Mu_%1s", cartcomp[alpha]);
+      pertbar(pert, moinfo.mu_irreps[alpha], 0);
+    }
+    compute_X_block(solves);
+  }
 
-      for(alpha=0; alpha < 3; alpha++) {
-        sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-        pertbar(pert, moinfo.mu_irreps[alpha], 0);
-	compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
-	if(params.omega[i] != 0.0) compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
-      }
+  for(i=0; i < params.nomega; i++) {
+
+    sprintf(lbl, "<<Mu;Mu>_(%5.3f)", params.omega[i]);
+    if(compute[i]) {
 
       outfile->Printf( "\n\tComputing %s tensor.\n", lbl);
       for(alpha=0; alpha < 3; alpha++) {
@@ -98,9 +115,6 @@ void polar(void)
       }
 
       psio_write_entry(PSIF_CC_INFO, lbl, (char *) tensor[i][0], 9*sizeof(double));
-
-      psio_close(PSIF_CC_LR, 0);
-      psio_open(PSIF_CC_LR, 0);
     }
     else {
       outfile->Printf( "Using %s tensor found on disk.\n", lbl);
@@ -144,6 +158,11 @@ void polar(void)
       Process::environment.globals["CCSD DIPOLE POLARIZABILITY"] = trace[i]/3.0;
   }
 
+  if(!solves.empty()) {
+    psio_close(PSIF_CC_LR, 0);
+    psio_open(PSIF_CC_LR, 0);
+  }
+
   if(params.nomega > 1) {  /* print a summary table for multi-wavelength calcs */
 
     outfile->Printf( "\n\t-------------------------------\n");
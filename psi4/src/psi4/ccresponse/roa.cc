@@ -40,6 +40,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
@@ -49,11 +50,12 @@
 #include "Local.h"
 #define EXTERN
 #include "globals.h"
+#include "XSolve.h"
 
 namespace psi { namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_block(const std::vector<XSolve> &solves);
 void linresp(double *tensor, double A, double B,
 	     const char *pert_x, int x_irrep, double omega_x,
 	     const char *pert_y, int y_irrep, double omega_y);
@@ -64,6 +66,7 @@ void roa(void)
   double ****tensor_rQ, ***tensor_rQ0, ***tensor_rQ1;
   double **tensor_rl0, **tensor_rl1, **tensor_pl0, **tensor_pl1;
   char **cartcomp, pert[32], pert_x[32], pert_y[32];
+  std::vector<XSolve> solves;
   int alpha, beta, gamma, i, j, k, l, irrep;
   double omega_nm, omega_ev, omega_cm;
   char lbl1[32], lbl2[32], lbl3[32], lbl4[32];
@@ -114,13 +117,16 @@ void roa(void)
       for(alpha=0; alpha < 3; alpha++) {
         sprintf(pert, "P_%1s", cartcomp[alpha]);
         pertbar(pert, moinfo.mu_irreps[alpha], 1);
-        compute_X(pert, moinfo.mu_irreps[alpha], 0);
+        solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], 0});
 
         sprintf(pert, "L_%1s", cartcomp[alpha]);
         pertbar(pert, moinfo.l_irreps[alpha], 1);
-        compute_X(pert, moinfo.l_irreps[alpha], 0);
+        solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], 0});
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n\tComputing %s tensor.\n", lbl1);
       for(alpha=0; alpha < 3; alpha ++) {
         for(beta=0; beta < 3; beta++) {
@@ -209,21 +215,21 @@ void roa(void)
       for(alpha=0; alpha < 3; alpha++) {
         /* -omega electric-dipole CC wave functions */
         sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-        compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+        solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], -params.omega[i]});
 
         /* +omega electric-dipole CC wave functions */
         sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-        compute_X(pert, moinfo.mu_irreps[alpha], +params.omega[i]);
+        solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], +params.omega[i]});
 
 	if(compute_pl) {
           /* -omega velocity electric-dipole CC wave functions */
           sprintf(pert, "P_%1s", cartcomp[alpha]);
-	  compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+	  solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], -params.omega[i]});
         }
 
         /* +omega magnetic-dipole CC wave functions */
         sprintf(pert, "L_%1s", cartcomp[alpha]);
-	compute_X(pert, moinfo.l_irreps[alpha], +params.omega[i]);
+	solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], +params.omega[i]});
       }
 
       /* +omega electric-quadrupole CC wave functions */
@@ -231,10 +237,13 @@ void roa(void)
         for(beta=0; beta < 3; beta++) {
           sprintf(pert, "Q_%1s%1s", cartcomp[alpha], cartcomp[beta]);
           irrep = moinfo.mu_irreps[alpha]^moinfo.mu_irreps[beta];
-	  compute_X(pert, irrep, params.omega[i]);
+	  solves.push_back(XSolve{pert, irrep, params.omega[i]});
         }
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n");
       outfile->Printf( "\tComputing %s tensor.\n", lbl3);
       for(alpha=0; alpha < 3; alpha++) {
@@ -347,21 +356,24 @@ void roa(void)
       for(alpha=0; alpha < 3; alpha++) {
 	if(compute_pl) {
           sprintf(pert, "P*_%1s", cartcomp[alpha]);
-	  compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
+	  solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha], params.omega[i]});
         }
 
         /* -omega magnetic-dipole CC wave functions */
         sprintf(pert, "L*_%1s", cartcomp[alpha]);
-	compute_X(pert, moinfo.l_irreps[alpha], -params.omega[i]);
+	solves.push_back(XSolve{pert, moinfo.l_irreps[alpha], -params.omega[i]});
       }
 
       for(alpha=0; alpha < 3; alpha++) {
         for(beta=0; beta < 3; beta++) {
           sprintf(pert, "Q_%1s%1s", cartcomp[alpha], cartcomp[beta]);
-          compute_X(pert, moinfo.mu_irreps[alpha]^moinfo.mu_irreps[beta], -params.omega[i]);
+          solves.push_back(XSolve{pert, moinfo.mu_irreps[alpha]^moinfo.mu_irreps[beta], -params.omega[i]});
         }
       }
 
+      compute_X_block(solves);
+      solves.clear();
+
       outfile->Printf( "\n");
       if(compute_rl) {
 	outfile->Printf( "\tComputing %s tensor.\n", lbl1);
@@ -61,8 +61,6 @@ void e_sort(int reference);
 void f_sort(int reference);
 void b_spinad(std::shared_ptr<PSIO>);
 void a_spinad();
-void d_spinad();
-void e_spinad();
 
 void fock_rhf(std::shared_ptr<Wavefunction> ref, Dimension &occpi, Dimension &openpi,
               Dimension &virpi, Dimension &frzcpi, int print);
@@ -653,8 +651,6 @@ PsiReturnType cctransort(SharedWavefunction ref, Options& options)
   if(reference == 0) {
     b_spinad(psio);
     a_spinad();
-    d_spinad();
-    e_spinad();
   }
 
   // Organize Fock matrices
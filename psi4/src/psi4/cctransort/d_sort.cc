@@ -27,6 +27,7 @@
  */
 
 #include "psi4/libdpd/dpd.h"
+#include "sort_multi.h"
 
 namespace psi { namespace cctransort {
 
@@ -53,11 +54,9 @@ void d_sort(int reference)
     global_dpd_->buf4_close(&D);
 
     global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <IJ||AB>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 20, 20, "D <IJ||AB> (IA,JB)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 20, 20, 20, 20, 0, "D <IJ||AB> (IA,JB)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 20, 21, "D <IJ||AB> (IA,BJ)");
+    buf4_sort_multi(&D, PSIF_CC_DINTS, {
+        SortTarget(prqs, 20, 20, "D <IJ||AB> (IA,JB)"),
+        SortTarget(prsq, 20, 21, "D <IJ||AB> (IA,BJ)")});
     global_dpd_->buf4_close(&D);
 
     /*** BB ***/
@@ -78,39 +77,23 @@ void d_sort(int reference)
     global_dpd_->buf4_close(&D);
 
     global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 15, 10, 15, 0, "D <ij||ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 30, 30, "D <ij||ab> (ia,jb)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 30, 30, 30, 30, 0, "D <ij||ab> (ia,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 30, 31, "D <ij||ab> (ia,bj)");
+    buf4_sort_multi(&D, PSIF_CC_DINTS, {
+        SortTarget(prqs, 30, 30, "D <ij||ab> (ia,jb)"),
+        SortTarget(prsq, 30, 31, "D <ij||ab> (ia,bj)")});
     global_dpd_->buf4_close(&D);
 
     /*** AB ***/
     global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 22, 28, 22, 28, 0, "D <Ij|Ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, qpsr, 23, 29, "D <iJ|aB>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, psrq, 24, 26, "D <Ij|Ab> (Ib,Aj)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 20, 30, "D <Ij|Ab> (IA,jb)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 20, 30, 20, 30, 0, "D <Ij|Ab> (IA,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, rspq, 30, 20, "D <Ij|Ab> (ia,JB)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 20, 31, "D <Ij|Ab> (IA,bj)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 30, 20, 30, 20, 0, "D <Ij|Ab> (ia,JB)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 30, 21, "D <Ij|Ab> (ia,BJ)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 23, 29, 23, 29, 0, "D <iJ|aB>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, psrq, 27, 25, "D <iJ|aB> (iB,aJ)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 24, 26, 24, 26, 0, "D <Ij|Ab> (Ib,Aj)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 24, 27, "D <Ij|Ab> (Ib,jA)");
-    global_dpd_->buf4_close(&D);
-
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 27, 25, 27, 25, 0, "D <iJ|aB> (iB,aJ)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 27, 24, "D <iJ|aB> (iB,Ja)");
+    buf4_sort_multi(&D, PSIF_CC_DINTS, {
+        SortTarget(qpsr, 23, 29, "D <iJ|aB>"),
+        SortTarget(psrq, 24, 26, "D <Ij|Ab> (Ib,Aj)"),
+        SortTarget(prqs, 20, 30, "D <Ij|Ab> (IA,jb)"),
+        SortTarget(qspr, 30, 20, "D <Ij|Ab> (ia,JB)"),
+        SortTarget(prsq, 20, 31, "D <Ij|Ab> (IA,bj)"),
+        SortTarget(qsrp, 30, 21, "D <Ij|Ab> (ia,BJ)"),
+        SortTarget(qrsp, 27, 25, "D <iJ|aB> (iB,aJ)"),
+        SortTarget(psqr, 24, 27, "D <Ij|Ab> (Ib,jA)"),
+        SortTarget(qrps, 27, 24, "D <iJ|aB> (iB,Ja)")});
     global_dpd_->buf4_close(&D);
   }
   else {  /*** RHF/ROHF ***/
@@ -130,51 +113,30 @@ void d_sort(int reference)
     global_dpd_->buf4_copy(&D, PSIF_CC_DINTS, "D <ij||ab>");
     global_dpd_->buf4_close(&D);
 
-    /* <ij|ab> (ia,jb) */
+    /* <ij|ab> (ia,jb), (ai,jb), (aj,ib), (bi,ja), (ib,ja), (ib,aj), (ia,bj) */
+    std::vector<SortTarget> targets = {
+        SortTarget(prqs, 10, 10, "D <ij|ab> (ia,jb)"),
+        SortTarget(rpqs, 11, 10, "D <ij|ab> (ai,jb)"),
+        SortTarget(rqps, 11, 10, "D <ij|ab> (aj,ib)"),
+        SortTarget(spqr, 11, 10, "D <ij|ab> (bi,ja)"),
+        SortTarget(psqr, 10, 10, "D <ij|ab> (ib,ja)"),
+        SortTarget(psrq, 10, 11, "D <ij|ab> (ib,aj)"),
+        SortTarget(prsq, 10, 11, "D <ij|ab> (ia,bj)")};
+    /* RHF spin adaptation, 2 <ij|ab> - <ij|ba> */
+    if(reference == 0) {
+      targets.push_back(SortTarget(pqrs, 0, 5, "D 2<ij|ab> - <ij|ba>", 2.0).add(pqsr, -1.0));
+      targets.push_back(SortTarget(prqs, 10, 10, "D 2<ij|ab> - <ij|ba> (ia,jb)", 2.0).add(psqr, -1.0));
+    }
     global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 10, 10, "D <ij|ab> (ia,jb)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij|ab> (ai,jb) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 10, 10, 10, 0, "D <ij|ab> (ia,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, qprs, 11, 10, "D <ij|ab> (ai,jb)");
+    buf4_sort_multi(&D, PSIF_CC_DINTS, targets);
     global_dpd_->buf4_close(&D);
 
-    /* <ij|ab> (aj,ib) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, rqps, 11, 10, "D <ij|ab> (aj,ib)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij|ab> (bi,ja) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, spqr, 11, 10, "D <ij|ab> (bi,ja)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij||ab> (ia,jb) */
+    /* <ij||ab> (ia,jb), (ia,bj) */
     global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij||ab>");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 10, 10, "D <ij||ab> (ia,jb)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij|ab> (ib,ja) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 10, 10, 10, 0, "D <ij|ab> (ia,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, psrq, 10, 10, "D <ij|ab> (ib,ja)");
+    buf4_sort_multi(&D, PSIF_CC_DINTS, {
+        SortTarget(prqs, 10, 10, "D <ij||ab> (ia,jb)"),
+        SortTarget(prsq, 10, 11, "D <ij||ab> (ia,bj)")});
     global_dpd_->buf4_close(&D);
-
-    /* <ij|ab> (ib,aj) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 10, 10, 10, 0, "D <ij|ab> (ib,ja)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 10, 11, "D <ij|ab> (ib,aj)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij|ab> (ia,bj) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 10, 10, 10, 0, "D <ij|ab> (ia,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 10, 11, "D <ij|ab> (ia,bj)");
-    global_dpd_->buf4_close(&D);
-
-    /* <ij||ab> (ia,bj) */
-    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 10, 10, 10, 10, 0, "D <ij||ab> (ia,jb)");
-    global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, pqsr, 10, 11, "D <ij||ab> (ia,bj)");
-    global_dpd_->buf4_close(&D);
-
   }
 }
 
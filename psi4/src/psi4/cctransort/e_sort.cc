@@ -29,6 +29,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include "psi4/libdpd/dpd.h"
+#include "sort_multi.h"
 
 namespace psi { namespace cctransort {
 
@@ -70,31 +71,34 @@ void e_sort(int reference)
     global_dpd_->buf4_close(&E);
 
     /*** AB ***/
-    /* <iJ|kA> */
+    /* <iJ|kA>, <Ij|Ak> */
     global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 26, 22, 26, 22, 0, "E <Ai|Jk>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, qrsp, 23, 27, "E <iJ|kA>");
+    buf4_sort_multi(&E, PSIF_CC_EINTS, {
+        SortTarget(qrsp, 23, 27, "E <iJ|kA>"),
+        SortTarget(rqps, 22, 26, "E <Ij|Ak>")});
     global_dpd_->buf4_close(&E);
 
-    /* <Ij|Ak> */
-    global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 23, 27, 23, 27, 0, "E <iJ|kA>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, qpsr, 22, 26, "E <Ij|Ak>");
-    global_dpd_->buf4_close(&E);
-
-    /* <iJ|aK> */
+    /* <iJ|aK>, <Ia|Jk> */
     global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 22, 24, 22, 24, 0, "E <Ij|Ka>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, qpsr, 23, 25, "E <iJ|aK>");
-    global_dpd_->buf4_close(&E);
-
-    /* <Ia|Jk> */
-    global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 22, 24, 22, 24, 0, "E <Ij|Ka>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, rspq, 24, 22, "E <Ia|Jk>");
+    buf4_sort_multi(&E, PSIF_CC_EINTS, {
+        SortTarget(qpsr, 23, 25, "E <iJ|aK>"),
+        SortTarget(rspq, 24, 22, "E <Ia|Jk>")});
     global_dpd_->buf4_close(&E);
 
   }
   else {  /** RHF/ROHF **/
-    /* <ij|ka> */
+    /* <ij|ka>, <ia|jk>, <ij|ak>, <ij|ka> (ij,ak) */
+    std::vector<SortTarget> targets = {
+        SortTarget(srqp, 0, 10, "E <ij|ka>"),
+        SortTarget(qpsr, 10, 0, "E <ia|jk>"),
+        SortTarget(rspq, 0, 11, "E <ij|ak>"),
+        SortTarget(srpq, 0, 11, "E <ij|ka> (ij,ak)")};
+    /* RHF spin adaptation, 2 <ai|jk> - <ai|kj> */
+    if(reference == 0) {
+      targets.push_back(SortTarget(pqrs, 11, 0, "E 2<ai|jk> - <ai|kj>", 2.0).add(pqsr, -1.0));
+    }
     global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, srqp, 0, 10, "E <ij|ka>");
+    buf4_sort_multi(&E, PSIF_CC_EINTS, targets);
     global_dpd_->buf4_close(&E);
 
     /* <ij||ka> (i>j,ka) */
@@ -102,25 +106,10 @@ void e_sort(int reference)
     global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, srqp, 2, 10, "E <ij||ka> (i>j,ka)");
     global_dpd_->buf4_close(&E);
 
-    /* <ij|ka> (ij,ak) */
-    global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 0, 10, 0, 10, 0, "E <ij|ka>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, pqsr, 0, 11, "E <ij|ka> (ij,ak)");
-    global_dpd_->buf4_close(&E);
-
     /* <ij||ka> (i>j,ak) */
     global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 2, 10, 2, 10, 0, "E <ij||ka> (i>j,ka)");
     global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, pqsr, 2, 11, "E <ij||ka> (i>j,ak)");
     global_dpd_->buf4_close(&E);
-
-    /* <ia|jk> */
-    global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, qpsr, 10, 0, "E <ia|jk>");
-    global_dpd_->buf4_close(&E);
-
-    /* <ij|ak> */
-    global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-    global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, rspq, 0, 11, "E <ij|ak>");
-    global_dpd_->buf4_close(&E);
   }
 }
 
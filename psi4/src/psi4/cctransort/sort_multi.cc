@@ -0,0 +1,160 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "psi4/libdpd/dpd.h"
+#include "sort_multi.h"
+
+namespace psi { namespace cctransort {
+
+namespace {
+
+const char *index_names[24] = {"pqrs", "pqsr", "prqs", "prsq", "psqr", "psrq",
+                               "qprs", "qpsr", "qrps", "qrsp", "qspr", "qsrp",
+                               "rqps", "rqsp", "rpqs", "rpsq", "rsqp", "rspq",
+                               "sqrp", "sqpr", "srqp", "srpq", "spqr", "sprq"};
+
+/* Position in the source of each target index */
+void source_positions(enum indices index, int *pos)
+{
+  for(int k=0; k < 4; k++) pos[k] = index_names[index][k] - 'p';
+}
+
+/* The same targets, one buf4_sort (or copy) and buf4_sort_axpy per term */
+void sort_by_term(dpdbuf4 *In, int outfilenum, const SortTarget &T)
+{
+  dpdbuf4 Out;
+
+  for(size_t t=0; t < T.terms.size(); t++) {
+    enum indices index = T.terms[t].index;
+    double alpha = T.terms[t].alpha;
+    if(t == 0) {
+      if(index == pqrs) global_dpd_->buf4_scmcopy(In, outfilenum, T.label.c_str(), alpha);
+      else {
+        global_dpd_->buf4_sort(In, outfilenum, index, T.pqnum, T.rsnum, T.label.c_str());
+        if(alpha != 1.0) {
+          global_dpd_->buf4_init(&Out, outfilenum, 0, T.pqnum, T.rsnum, T.pqnum, T.rsnum, 0, T.label.c_str());
+          global_dpd_->buf4_scm(&Out, alpha);
+          global_dpd_->buf4_close(&Out);
+        }
+      }
+    }
+    else {
+      if(index == pqrs) {
+        global_dpd_->buf4_init(&Out, outfilenum, 0, T.pqnum, T.rsnum, T.pqnum, T.rsnum, 0, T.label.c_str());
+        global_dpd_->buf4_axpy(In, &Out, alpha);
+        global_dpd_->buf4_close(&Out);
+      }
+      else global_dpd_->buf4_sort_axpy(In, outfilenum, index, T.pqnum, T.rsnum, T.label.c_str(), alpha);
+    }
+  }
+}
+
+} // namespace
+
+/*
+** buf4_sort_multi(): Builds several sorted copies (and linear combinations
+** of sorted copies) of one totally symmetric source buffer, reading the
+** source only once. Each target symmetry block is filled by a threaded
+** gather from the in-core source and written out before the next one is
+** formed. If the source and the largest target block do not fit in core
+** together, or the source is read with antisymmetrization, every target is
+** built with the ordinary buf4_sort() calls instead.
+*/
+void buf4_sort_multi(dpdbuf4 *In, int outfilenum, const std::vector<SortTarget> &targets)
+{
+  int nirreps = In->params->nirreps;
+  dpdbuf4 Out;
+
+  long int in_size = 0;
+  for(int h=0; h < nirreps; h++)
+    in_size += (long int) In->params->rowtot[h] * In->params->coltot[h];
+
+  long int out_size = 0;
+  for(size_t t=0; t < targets.size(); t++) {
+    dpdparams4 *P = &global_dpd_->params4[targets[t].pqnum][targets[t].rsnum];
+    for(int h=0; h < nirreps; h++) {
+      long int size = (long int) P->rowtot[h] * P->coltot[h];
+      if(size > out_size) out_size = size;
+    }
+  }
+
+  if(In->anti || In->file.my_irrep || in_size + out_size > dpd_memfree()) {
+    for(size_t t=0; t < targets.size(); t++) sort_by_term(In, outfilenum, targets[t]);
+    return;
+  }
+
+  for(int h=0; h < nirreps; h++) {
+    global_dpd_->buf4_mat_irrep_init(In, h);
+    global_dpd_->buf4_mat_irrep_rd(In, h);
+  }
+
+  for(size_t t=0; t < targets.size(); t++) {
+    const SortTarget &T = targets[t];
+    int nterms = T.terms.size();
+    std::vector<int> pos(4 * nterms);
+    std::vector<double> alpha(nterms);
+    for(int k=0; k < nterms; k++) {
+      source_positions(T.terms[k].index, &pos[4 * k]);
+      alpha[k] = T.terms[k].alpha;
+    }
+
+    global_dpd_->buf4_init(&Out, outfilenum, 0, T.pqnum, T.rsnum, T.pqnum, T.rsnum, 0, T.label.c_str());
+    for(int h=0; h < nirreps; h++) {
+      global_dpd_->buf4_mat_irrep_init(&Out, h);
+
+      #pragma omp parallel for schedule(dynamic)
+      for(int pq=0; pq < Out.params->rowtot[h]; pq++) {
+        int o[4], x[4];
+        o[0] = Out.params->roworb[h][pq][0];
+        o[1] = Out.params->roworb[h][pq][1];
+        for(int rs=0; rs < Out.params->coltot[h]; rs++) {
+          o[2] = Out.params->colorb[h][rs][0];
+          o[3] = Out.params->colorb[h][rs][1];
+          double value = 0.0;
+          for(int k=0; k < nterms; k++) {
+            const int *pk = &pos[4 * k];
+            x[pk[0]] = o[0]; x[pk[1]] = o[1]; x[pk[2]] = o[2]; x[pk[3]] = o[3];
+            int Gx = In->params->psym[x[0]] ^ In->params->qsym[x[1]];
+            value += alpha[k] * In->matrix[Gx][In->params->rowidx[x[0]][x[1]]][In->params->colidx[x[2]][x[3]]];
+          }
+          Out.matrix[h][pq][rs] = value;
+        }
+      }
+
+      global_dpd_->buf4_mat_irrep_wrt(&Out, h);
+      global_dpd_->buf4_mat_irrep_close(&Out, h);
+    }
+    global_dpd_->buf4_close(&Out);
+  }
+
+  for(int h=0; h < nirreps; h++) global_dpd_->buf4_mat_irrep_close(In, h);
+}
+
+}} // namespace psi::cctransort
@@ -26,22 +26,38 @@
  * @END LICENSE
  */
 
+#ifndef _psi_src_bin_cctransort_sort_multi_h
+#define _psi_src_bin_cctransort_sort_multi_h
+
+#include <string>
+#include <vector>
 #include "psi4/libdpd/dpd.h"
 
 namespace psi { namespace cctransort {
 
-void d_spinad()
-{
-  dpdbuf4 D;
+/* One target of buf4_sort_multi(): the sum over terms of alpha times the
+** source sorted by index, stored with pqnum/rsnum under label */
+struct SortTarget {
+  struct Term {
+    enum indices index;
+    double alpha;
+  };
+
+  std::string label;
+  int pqnum;
+  int rsnum;
+  std::vector<Term> terms;
 
-  global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
-  global_dpd_->buf4_scmcopy(&D, PSIF_CC_DINTS, "D 2<ij|ab> - <ij|ba>", 2);
-  global_dpd_->buf4_sort_axpy(&D, PSIF_CC_DINTS, pqsr, 0, 5, "D 2<ij|ab> - <ij|ba>", -1);
-  global_dpd_->buf4_close(&D);
+  SortTarget(enum indices index, int pq, int rs, const std::string &lbl, double alpha = 1.0)
+    : label(lbl), pqnum(pq), rsnum(rs), terms(1, Term{index, alpha}) {}
+  SortTarget &add(enum indices index, double alpha) {
+    terms.push_back(Term{index, alpha});
+    return *this;
+  }
+};
 
-  global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D 2<ij|ab> - <ij|ba>");
-  global_dpd_->buf4_sort(&D, PSIF_CC_DINTS, prqs, 10, 10, "D 2<ij|ab> - <ij|ba> (ia,jb)");
-  global_dpd_->buf4_close(&D);
-}
+void buf4_sort_multi(dpdbuf4 *In, int outfilenum, const std::vector<SortTarget> &targets);
 
 }} // namespace psi::cctransort
+
+#endif
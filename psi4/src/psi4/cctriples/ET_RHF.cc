@@ -43,34 +43,144 @@
 #define EXTERN
 #include "globals.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-//MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 
 namespace psi { namespace cctriples {
 
 pthread_mutex_t mut = PTHREAD_MUTEX_INITIALIZER;
 
+/* One (i,j,k) triplet of the (T) energy, I >= J >= K */
+struct ijk_task {
+ int Gi; int Gj; int Gk; int i; int j; int k;
+};
+
+/* The part [next, end) of the ijk list that a thread still owns */
+struct ijk_range {
+ pthread_mutex_t lock; long int next; long int end;
+};
+
+/* The F <ia|bc> rows of one occupied index P, block[Gd] = F[P][d][bc] */
+struct F_slice {
+ int P; int Gp; double ***block;
+};
+
+#define NUM_F_SLICES 3
+
 struct thread_data {
  dpdfile2 *fIJ; dpdfile2 *fAB; dpdfile2 *fIA; dpdfile2 *T1;
  dpdbuf4 *T2; dpdbuf4 *Eints; dpdbuf4 *Dints; dpdbuf4 *Fints_local;
- double *ET_local; int Gi; int Gj; int Gk; int first_ijk; int last_ijk;
+ double *ET_local; int thr_id; int nthreads;
+ struct ijk_task *tasks; struct ijk_range *ranges;
 };
 
 void *ET_RHF_thread(void *thread_data);
 
+/* ET_RHF_next_ijk(): Gets the next ijk for a thread.  Each thread starts
+** with a contiguous part of the ijk list and works through it in order,
+** so neighbouring k share the I and J slices of F.  A thread that runs
+** dry steals the upper half of the largest range left to another thread.
+*/
+static int ET_RHF_next_ijk(struct thread_data *data, long int *task)
+{
+  int t, victim;
+  long int left, most, mid, end;
+  struct ijk_range *mine, *other;
+
+  mine = &(data->ranges[data->thr_id]);
+  pthread_mutex_lock(&(mine->lock));
+  if(mine->next < mine->end) {
+    *task = mine->next++;
+    pthread_mutex_unlock(&(mine->lock));
+    return 1;
+  }
+  pthread_mutex_unlock(&(mine->lock));
+
+  while(1) {
+    victim = -1; most = 0;
+    for(t=0; t < data->nthreads; t++) {
+      if(t == data->thr_id) continue;
+      other = &(data->ranges[t]);
+      pthread_mutex_lock(&(other->lock));
+      left = other->end - other->next;
+      pthread_mutex_unlock(&(other->lock));
+      if(left > most) { most = left; victim = t; }
+    }
+    if(victim < 0) return 0;
+
+    other = &(data->ranges[victim]);
+    pthread_mutex_lock(&(other->lock));
+    left = other->end - other->next;
+    if(left <= 0) {
+      pthread_mutex_unlock(&(other->lock));
+      continue;
+    }
+    mid = other->next + left/2;
+    end = other->end;
+    other->end = mid;
+    pthread_mutex_unlock(&(other->lock));
+
+    pthread_mutex_lock(&(mine->lock));
+    mine->next = mid + 1;
+    mine->end = end;
+    pthread_mutex_unlock(&(mine->lock));
+    *task = mid;
+    return 1;
+  }
+}
+
+/* ET_RHF_F_slice(): Returns the F <ia|bc> rows of occupied index P, read
+** only if they are not already held from a previous ijk.  The slot to
+** reuse is one holding none of the current I, J and K.
+*/
+static double ***ET_RHF_F_slice(dpdbuf4 *Fints, struct F_slice *slices, int P, int Gp,
+                                int I, int J, int K)
+{
+  int s, Gd, Gpd, nirreps, *virtpi;
+  struct F_slice *slot;
+
+  for(s=0; s < NUM_F_SLICES; s++)
+    if(slices[s].P == P) return slices[s].block;
+
+  nirreps = moinfo.nirreps;
+  virtpi = moinfo.virtpi;
+
+  slot = NULL;
+  for(s=0; s < NUM_F_SLICES && slot == NULL; s++)
+    if(slices[s].P != I && slices[s].P != J && slices[s].P != K) slot = &(slices[s]);
+
+  pthread_mutex_lock(&mut);
+  if(slot->P >= 0) {
+    for(Gd=0; Gd < nirreps; Gd++) {
+      Gpd = slot->Gp ^ Gd;
+      global_dpd_->free_dpd_block(slot->block[Gd], virtpi[Gd], Fints->params->coltot[Gpd]);
+    }
+  }
+  for(Gd=0; Gd < nirreps; Gd++) {
+    Gpd = Gp ^ Gd;
+    slot->block[Gd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gpd]);
+    Fints->matrix[Gpd] = slot->block[Gd];
+    global_dpd_->buf4_mat_irrep_rd_block(Fints, Gpd, Fints->row_offset[Gpd][P], virtpi[Gd]);
+  }
+  pthread_mutex_unlock(&mut);
+
+  slot->P = P;
+  slot->Gp = Gp;
+
+  return slot->block;
+}
+
 double ET_RHF(void)
 {
-  int i,j,k,I,J,K,Gi,Gj,Gk, h, nirreps, cnt;
-  int nijk, nthreads, thread, *ijk_part, errcod;
+  int i,j,k,I,J,K,Gi,Gj,Gk, h, nirreps;
+  int nijk, nthreads, thread;
+  long int ntasks, task, first;
+  struct ijk_task *tasks;
+  struct ijk_range *ranges;
   int *occpi, *virtpi, *occ_off, *vir_off;
   double ET, *ET_array;
   dpdfile2 fIJ, fAB, fIA, T1;
   dpdbuf4 T2, Eints, Dints, *Fints_array;
   FILE *ijkfile;
-  pthread_t  *p_thread;
   struct thread_data *thread_data_array;
 
   timer_on("ET_RHF");
@@ -83,12 +193,19 @@ double ET_RHF(void)
   nthreads = params.nthreads;
 
   long int mem_avail = dpd_memfree();
-  // Find the size of 4 abc-blocks of the largest irrep
-  long int max_a = 0;
-  for (h=0; h<nirreps; ++h)
-    if (virtpi[h] > max_a)
-      max_a = virtpi[h];
-  long int thread_mem_estimate = 4 * max_a * max_a * max_a;
+  // Find the size of 4 abc-blocks, plus the NUM_F_SLICES slices of F each
+  // thread keeps. Both hold every abc of one overall symmetry (Gijk for the
+  // blocks, Gp for a slice of F), so take the largest such count.
+  long int max_abc = 0;
+  for (h=0; h<nirreps; ++h) {
+    long int abc = 0;
+    for (int Ga=0; Ga<nirreps; ++Ga)
+      for (int Gb=0; Gb<nirreps; ++Gb)
+        abc += (long int) virtpi[Ga] * virtpi[Gb] * virtpi[Ga^Gb^h];
+    if (abc > max_abc)
+      max_abc = abc;
+  }
+  long int thread_mem_estimate = (4 + NUM_F_SLICES) * max_abc;
 
   outfile->Printf("    Memory available in words        : %15ld\n", mem_avail);
   outfile->Printf("    ~Words needed per explicit thread: %15ld\n", thread_mem_estimate);
@@ -107,15 +224,7 @@ double ET_RHF(void)
 
   outfile->Printf("    Number of threads for explicit ijk threading: %4d\n\n", nthreads);
 
-// Don't parallelize mkl if explicit threads are used; should be added for acml too.
-#ifdef USING_LAPACK_MKL
-  int old_threads = mkl_get_max_threads();
-  mkl_set_num_threads(1);
-  outfile->Printf("    MKL num_threads set to 1 for explicit threading.\n\n");
-#endif
-
   thread_data_array = (struct thread_data *) malloc(nthreads*sizeof(struct thread_data));
-  p_thread = (pthread_t *) malloc(nthreads*sizeof(pthread_t));
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -153,7 +262,7 @@ double ET_RHF(void)
   for (thread=0; thread<nthreads;++thread)
     global_dpd_->buf4_init(&(Fints_array[thread]), PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
   ET_array = (double *) malloc(nthreads*sizeof(double));
-  ijk_part = new int [nthreads];
+  ranges = (struct ijk_range *) malloc(nthreads*sizeof(struct ijk_range));
 
   for (thread=0;thread<nthreads;++thread) {
     thread_data_array[thread].fIJ = &fIJ;
@@ -165,6 +274,9 @@ double ET_RHF(void)
     thread_data_array[thread].Dints = &Dints;
     thread_data_array[thread].Fints_local = &(Fints_array[thread]);
     thread_data_array[thread].ET_local = &(ET_array[thread]);
+    thread_data_array[thread].thr_id = thread;
+    thread_data_array[thread].nthreads = nthreads;
+    thread_data_array[thread].ranges = ranges;
   }
 
   /* Compute total number of IJK combinations */
@@ -184,7 +296,10 @@ double ET_RHF(void)
         }
   printer->Printf( "Total number of IJK combinations =: %d\n", nijk);
 
-  ET = 0.0;
+  /* List all IJK, with k running fastest */
+  ntasks = nijk;
+  tasks = (struct ijk_task *) malloc(ntasks*sizeof(struct ijk_task));
+  ntasks = 0;
   for(Gi=0; Gi < nirreps; Gi++) {
     for(Gj=0; Gj < nirreps; Gj++) {
       for(Gk=0; Gk < nirreps; Gk++) {
@@ -196,62 +311,44 @@ double ET_RHF(void)
             J = occ_off[Gj] + j;
             for(k=0; k < occpi[Gk]; k++) {
               K = occ_off[Gk] + k;
-              if(I >= J && J >= K) nijk++;
+              if(I >= J && J >= K) {
+                tasks[ntasks].Gi = Gi; tasks[ntasks].Gj = Gj; tasks[ntasks].Gk = Gk;
+                tasks[ntasks].i = i; tasks[ntasks].j = j; tasks[ntasks].k = k;
+                ntasks++;
+                nijk++;
+              }
             }
           }
         }
         printer->Printf( "Num. of IJK with (Gi,Gj,Gk)=(%d,%d,%d) =: %d\n",
           Gi, Gj, Gk, nijk);
-        if (nijk == 0) continue;
-
-        for (thread=0; thread<nthreads;++thread) {
-          thread_data_array[thread].Gi = Gi;
-          thread_data_array[thread].Gj = Gj;
-          thread_data_array[thread].Gk = Gk;
-          ET_array[thread] = 0.0;
-          ijk_part[thread] = nijk / nthreads; // number of ijk for each thread
-          if (thread < (nijk % nthreads)) ++ijk_part[thread];
-        }
-
-        cnt = 0;
-        for (thread=0; thread<nthreads; ++thread) {
-          if (!ijk_part[thread]) continue;  // there are more threads than nijk
-          thread_data_array[thread].first_ijk = cnt;
-          cnt += ijk_part[thread];
-          thread_data_array[thread].last_ijk = cnt-1;
-        }
-
-        /* execute threads */
-        for (thread=0; thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          printer->Printf("    thread %d: first_ijk=%d,  last_ijk=%d\n", thread,
-            thread_data_array[thread].first_ijk, thread_data_array[thread].last_ijk);
-        }
-
-        for (thread=0;thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_create(&(p_thread[thread]), NULL, ET_RHF_thread,
-                   (void *) &thread_data_array[thread]);
-          if (errcod) {
-            throw PsiException("pthread_create in ET_RHF()",__FILE__,__LINE__);
-          }
-        }
-
-        for (thread=0; thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_join(p_thread[thread], NULL);
-          if (errcod) {
-            throw PsiException("pthread_join in ET_RHF() failed",__FILE__,__LINE__);
-          }
-        }
-
-        for (thread=0;thread<nthreads;++thread)
-          ET += ET_array[thread];
-
       } /* Gk */
     } /* Gj */
   } /* Gi */
 
+  /* All irreps are done in a single pass, each thread starting on an even
+     share of the list; ET_RHF_next_ijk() rebalances as threads run dry */
+  first = 0;
+  for (thread=0; thread<nthreads; ++thread) {
+    task = ntasks / nthreads;
+    if (thread < (ntasks % nthreads)) ++task;
+    pthread_mutex_init(&(ranges[thread].lock), NULL);
+    ranges[thread].next = first;
+    ranges[thread].end = first + task;
+    first += task;
+    thread_data_array[thread].tasks = tasks;
+    ET_array[thread] = 0.0;
+    printer->Printf("    thread %d: first_ijk=%ld,  last_ijk=%ld\n", thread,
+      ranges[thread].next, ranges[thread].end-1);
+  }
+
+  parallel_workers(nthreads, [&](int t) { ET_RHF_thread((void *) &thread_data_array[t]); });
+
+  ET = 0.0;
+  for (thread=0;thread<nthreads;++thread) {
+    ET += ET_array[thread];
+    pthread_mutex_destroy(&(ranges[thread].lock));
+  }
 
   for(h=0; h < nirreps; h++) {
     global_dpd_->buf4_mat_irrep_close(&T2, h);
@@ -277,24 +374,20 @@ double ET_RHF(void)
 
   free(Fints_array);
   free(ET_array);
-  delete [] ijk_part;
+  free(ranges);
+  free(tasks);
 
   free(thread_data_array);
-  free(p_thread);
 
   timer_off("ET_RHF");
 
-#ifdef USING_LAPACK_MKL
-  mkl_set_num_threads(old_threads);
-#endif
-
   return ET;
 }
 
 
 void* ET_RHF_thread(void* thread_data_in)
 {
-  int h, nirreps, cnt_ijk;
+  int h, nirreps;
   int Gp, p, nump;
   int nrows, ncols, nlinks;
   int Gijk, Gid, Gkd, Gjd, Gil, Gkl, Gjl;
@@ -314,7 +407,10 @@ void* ET_RHF_thread(void* thread_data_in)
   double ***W0, ***W1, ***V, ***X, ***Y, ***Z;
   dpdbuf4 *T2, *Eints, *Dints, *Fints;
   dpdfile2 *fIJ, *fAB, *fIA, *T1;
-  int nijk, nthreads, first_ijk, last_ijk, thr_id;
+  long int task;
+  struct ijk_task *ijk;
+  struct F_slice slices[NUM_F_SLICES];
+  double ***FI, ***FJ, ***FK;
   struct thread_data *data;
 
   nirreps = moinfo.nirreps;
@@ -332,11 +428,6 @@ void* ET_RHF_thread(void* thread_data_in)
   Dints = data->Dints;
   Fints = data->Fints_local;
   ET_local  = data->ET_local; // pointer to where thread E goes
-  Gi        =  data->Gi;
-  Gj        =  data->Gj;
-  Gk        =  data->Gk;
-  first_ijk = data->first_ijk;
-  last_ijk  = data->last_ijk;
 
   W0 = (double ***) malloc(nirreps * sizeof(double **));
   W1 = (double ***) malloc(nirreps * sizeof(double **));
@@ -345,24 +436,30 @@ void* ET_RHF_thread(void* thread_data_in)
   Y = (double ***) malloc(nirreps * sizeof(double **));
   Z = (double ***) malloc(nirreps * sizeof(double **));
 
-  Gkj = Gjk = Gk ^ Gj;
-  Gji = Gij = Gi ^ Gj;
-  Gik = Gki = Gi ^ Gk;
-  Gijk = Gi ^ Gj ^ Gk;
-
-  cnt_ijk = -1;
-  for(i=0; i < occpi[Gi]; i++) {
-    I = occ_off[Gi] + i;
-    for(j=0; j < occpi[Gj]; j++) {
-      J = occ_off[Gj] + j;
-      for(k=0; k < occpi[Gk]; k++) {
-        K = occ_off[Gk] + k;
-        if(I >= J && J >= K) {
-
-          ++cnt_ijk;
-          /* check to see if this ijk is for this thread */
-          if ( (cnt_ijk < first_ijk) || (cnt_ijk > last_ijk))
-             continue;
+  for(p=0; p < NUM_F_SLICES; p++) {
+    slices[p].P = -1;
+    slices[p].Gp = 0;
+    slices[p].block = (double ***) malloc(nirreps * sizeof(double **));
+  }
+
+  while(ET_RHF_next_ijk(data, &task)) {
+          ijk = &(data->tasks[task]);
+          Gi = ijk->Gi; Gj = ijk->Gj; Gk = ijk->Gk;
+          i = ijk->i; j = ijk->j; k = ijk->k;
+          I = occ_off[Gi] + i;
+          J = occ_off[Gj] + j;
+          K = occ_off[Gk] + k;
+
+          Gkj = Gjk = Gk ^ Gj;
+          Gji = Gij = Gi ^ Gj;
+          Gik = Gki = Gi ^ Gk;
+          Gijk = Gi ^ Gj ^ Gk;
+
+          /* The F rows of I, J and K, each read once and kept for the
+             following ijk, which mostly differ only in k */
+          FI = ET_RHF_F_slice(Fints, slices, I, Gi, I, J, K);
+          FJ = ET_RHF_F_slice(Fints, slices, J, Gj, I, J, K);
+          FK = ET_RHF_F_slice(Fints, slices, K, Gk, I, J, K);
 
           ij = T2->params->rowidx[I][J];
           ji = T2->params->rowidx[J][I];
@@ -398,12 +495,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gab = Gid = Gi ^ Gd;
                   Gc = Gkj ^ Gd;
 
-                  /* Set up F integrals */
-                  Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
-
                   /* Set up T2 amplitudes */
                   cd = T2->col_offset[Gkj][Gc];
 
@@ -414,11 +505,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gid][0][0]), nrows,
+                            &(FI[Gd][0][0]), nrows,
                             &(T2->matrix[Gkj][kj][cd]), nlinks, 0.0,
                             &(W0[Gab][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                 }
 
                 /* -E_jklc * t_ilab */
@@ -456,10 +545,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gac = Gid = Gi ^ Gd;
                   Gb = Gjk ^ Gd;
 
-                  Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
 
                   bd = T2->col_offset[Gjk][Gb];
 
@@ -469,11 +554,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gid][0][0]), nrows,
+                            &(FI[Gd][0][0]), nrows,
                             &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0,
                             &(W1[Gac][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                 }
 
                 /* -E_kjlb * t_ilac */
@@ -508,10 +591,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gca = Gkd = Gk ^ Gd;
                   Gb = Gji ^ Gd;
 
-                  Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
 
                   bd = T2->col_offset[Gji][Gb];
 
@@ -521,11 +600,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gkd][0][0]), nrows,
+                            &(FK[Gd][0][0]), nrows,
                             &(T2->matrix[Gji][ji][bd]), nlinks, 1.0,
                             &(W0[Gca][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                 }
 
                 /* -E_ijlb * t_klca */
@@ -560,10 +637,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gcb = Gkd = Gk ^ Gd;
                   Ga = Gij ^ Gd;
 
-                  Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
 
                   ad = T2->col_offset[Gij][Ga];
 
@@ -573,11 +646,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gkd][0][0]), nrows,
+                            &(FK[Gd][0][0]), nrows,
                             &(T2->matrix[Gij][ij][ad]), nlinks, 1.0,
                             &(W1[Gcb][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                 }
 
                 /* -E_jila * t_klcb */
@@ -612,10 +683,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gbc = Gjd = Gj ^ Gd;
                   Ga = Gik ^ Gd;
 
-                  Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
 
                   ad = T2->col_offset[Gik][Ga];
 
@@ -625,11 +692,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gjd][0][0]), nrows,
+                            &(FJ[Gd][0][0]), nrows,
                             &(T2->matrix[Gik][ik][ad]), nlinks, 1.0,
                             &(W0[Gbc][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                 }
 
                 /* -E_kila * t_jlbc */
@@ -664,10 +729,6 @@ void* ET_RHF_thread(void* thread_data_in)
                   Gba = Gjd = Gj ^ Gd;
                   Gc = Gki ^ Gd;
 
-                  Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
-          pthread_mutex_lock(&mut);
-                  global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
-          pthread_mutex_unlock(&mut);
 
                   cd = T2->col_offset[Gki][Gc];
 
@@ -677,11 +738,9 @@ void* ET_RHF_thread(void* thread_data_in)
 
                   if(nrows && ncols && nlinks)
                     C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0,
-                            &(Fints->matrix[Gjd][0][0]), nrows,
+                            &(FJ[Gd][0][0]), nrows,
                             &(T2->matrix[Gki][ki][cd]), nlinks, 1.0,
                             &(W1[Gba][0][0]), ncols);
-
-                  global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                 }
 
                 /* -E_iklc * t_jlba */
@@ -951,12 +1010,19 @@ void* ET_RHF_thread(void* thread_data_in)
                 }
                 // timer_off("malloc");
 
-              }
-            } /* k */
-          } /* j */
-        } /* i */
+  } /* ijk */
+
+  for(p=0; p < NUM_F_SLICES; p++) {
+    if(slices[p].P >= 0) {
+      for(Gd=0; Gd < nirreps; Gd++) {
+        Gid = slices[p].Gp ^ Gd;
+        global_dpd_->free_dpd_block(slices[p].block[Gd], virtpi[Gd], Fints->params->coltot[Gid]);
+      }
+    }
+    free(slices[p].block);
+  }
 
-  pthread_exit(NULL);
+  return NULL;
 }
 
 }} // namespace psi::CCTRIPLES
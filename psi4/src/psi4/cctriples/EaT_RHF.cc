@@ -43,10 +43,6 @@
 #define EXTERN
 #include "globals.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-//MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 
 namespace psi { namespace cctriples {
@@ -65,13 +61,12 @@ void *EaT_RHF_thread(void *thread_data);
 double EaT_RHF(void)
 {
   int i,j,k,I,J,K,Gi,Gj,Gk, h, nirreps, cnt;
-  int nijk, nthreads, thread, *ijk_part, errcod;
+  int nijk, nthreads, thread, *ijk_part;
   int *occpi, *virtpi, *occ_off, *vir_off;
   double ET, *ET_array;
   dpdfile2 fIJ, fAB, fIA, L1;
   dpdbuf4 T2, L2, Eints, Dints, *Fints_array;
   FILE *ijkfile;
-  pthread_t  *p_thread;
   struct thread_data *thread_data_array;
 
   timer_on("ET_RHF");
@@ -83,12 +78,6 @@ double EaT_RHF(void)
 
   nthreads = params.nthreads;
   thread_data_array = (struct thread_data *) malloc(nthreads*sizeof(struct thread_data));
-  p_thread = (pthread_t *) malloc(nthreads*sizeof(pthread_t));
-
-#ifdef USING_LAPACK_MKL
-  int old_threads = mkl_get_max_threads();
-  mkl_set_num_threads(1);
-#endif
 
   global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
   global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -205,22 +194,9 @@ double EaT_RHF(void)
             thread_data_array[thread].first_ijk, thread_data_array[thread].last_ijk);
         }
 
-        for (thread=0;thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_create(&(p_thread[thread]), NULL, EaT_RHF_thread,
-                   (void *) &thread_data_array[thread]);
-          if (errcod) {
-            throw PsiException("pthread_create in ET_RHF()",__FILE__,__LINE__);
-          }
-        }
-
-        for (thread=0; thread<nthreads;++thread) {
-          if (!ijk_part[thread]) continue;
-          errcod = pthread_join(p_thread[thread], NULL);
-          if (errcod) {
-            throw PsiException("pthread_join in ET_RHF() failed",__FILE__,__LINE__);
-          }
-        }
+        parallel_workers(nthreads, [&](int t) {
+          if (ijk_part[t]) EaT_RHF_thread((void *) &thread_data_array[t]);
+        });
 
         for (thread=0;thread<nthreads;++thread)
           ET += ET_array[thread];
@@ -261,14 +237,9 @@ double EaT_RHF(void)
   delete [] ijk_part;
 
   free(thread_data_array);
-  free(p_thread);
 
   timer_off("ET_RHF");
 
-#ifdef USING_LAPACK_MKL
-  mkl_set_num_threads(old_threads);
-#endif
-
   return ET;
 }
 
@@ -931,7 +902,7 @@ void* EaT_RHF_thread(void* thread_data_in)
     } /* j */
   } /* i */
 
-  pthread_exit(NULL);
+  return NULL;
 }
 
 }} // namespace psi::CCTRIPLES
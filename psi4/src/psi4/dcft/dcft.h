@@ -542,6 +542,8 @@ protected:
     void build_gbarKappa_UHF();
     /// Form gbar<ab|cd> * lambda <ij|cd>
     void build_gbarlambda_RHF_v3mem();
+    /// Form the g(OV|VV) terms of the RHF orbital gradient from b(Q|ov) and b(Q|vv)
+    void build_DF_orbital_gradient_OVVV_RHF();
     void build_gbarlambda_UHF_v3mem();
 
     // Density-Fitting DCFT
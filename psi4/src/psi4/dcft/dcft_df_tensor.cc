@@ -54,10 +54,12 @@
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
+#include <tuple>
 #include <sstream>
 #include <vector>
 
@@ -1754,6 +1756,368 @@ void DCFTSolver::build_gbarKappa_RHF()
 
 }
 
+/**
+ * Add the g(OV|VV) terms of the RHF orbital gradient, X_IA and X_AI, using density fitting.
+ * g(OV|VV) is never formed as a whole: the OVOV and OOVV densities are first contracted
+ * with b(Q|ov) or b(Q|vv), and the lambda-lambda terms of X_IA are built from one
+ * occupied row g(I'B|CD) = b(I'C|Q) b(Q|BD) per thread at a time.
+ * Memory required: O(V^3) per thread
+ */
+void DCFTSolver::build_DF_orbital_gradient_OVVV_RHF()
+{
+    dcft_timer_on("DCFTSolver::DF g(OV|VV) orbital gradient");
+
+    int nthreads = 1;
+    #ifdef _OPENMP
+        nthreads = Process::environment.get_n_threads();
+    #endif
+
+    // Offsets of the (p,q) subblocks of each irrep of a pair index, in DPD order
+    auto pair_blocks = [this](const Dimension& P, const Dimension& R){
+        std::vector<std::vector<long int>> block(nirrep_, std::vector<long int>(nirrep_, 0));
+        for (int hpq = 0; hpq < nirrep_; ++hpq){
+            long int entrance = 0;
+            for (int hp = 0; hp < nirrep_; ++hp){
+                block[hpq][hp] = entrance;
+                entrance += P[hp] * R[hpq ^ hp];
+            }
+        }
+        return block;
+    };
+    std::vector<std::vector<long int>> ooblock = pair_blocks(naoccpi_, naoccpi_);
+    std::vector<std::vector<long int>> ovblock = pair_blocks(naoccpi_, navirpi_);
+    std::vector<std::vector<long int>> vvblock = pair_blocks(navirpi_, navirpi_);
+
+    std::vector<SharedMatrix> XIA, XAI;
+    for (int i = 0; i < nthreads; ++i){
+        XIA.push_back(SharedMatrix(new Matrix("DF X <O|V>", nirrep_, naoccpi_, navirpi_)));
+        XAI.push_back(SharedMatrix(new Matrix("DF X <V|O>", nirrep_, navirpi_, naoccpi_)));
+    }
+
+    psio_->open(PSIF_DCFT_DENSITY, PSIO_OPEN_OLD);
+
+    dpdfile2 T, X;
+    dpdbuf4 G, Z, Laa, Lab;
+
+    /*
+     * X_IA -= Y2_IC Tau_CA, where
+     * Y2_IA = <IA|CD> Tau_CD - 2 (IA|CD) Tau_CD
+     *       = b(IC|Q) b(Q|AD) Tau_CD - 2 b(IA|Q) b(Q|CD) Tau_CD
+     */
+    dcft_timer_on("DCFTSolver::DF g_IbCd tau_CA tau_DB");
+    global_dpd_->file2_init(&T, PSIF_DCFT_DPD, 0, ID('V'), ID('V'), "Tau <V|V>");
+    global_dpd_->file2_mat_init(&T);
+    global_dpd_->file2_mat_rd(&T);
+
+    std::vector<SharedMatrix> Y2, P;
+    for (int i = 0; i < nthreads; ++i){
+        Y2.push_back(SharedMatrix(new Matrix("Y2 <O|V>", nirrep_, naoccpi_, navirpi_)));
+        P.push_back(SharedMatrix(new Matrix("b(Q|AD) Tau_CD", navirpi_.max(), navirpi_.max())));
+    }
+
+    // (Q) = b(Q|CD) Tau_CD
+    std::vector<double> tQ(nQ_, 0.0);
+    for (int hc = 0; hc < nirrep_; ++hc){
+        if (navirpi_[hc] > 0){
+            double** bQvvAp = bQabA_mo_->pointer(0);
+            C_DGEMV('N', nQ_, navirpi_[hc]*navirpi_[hc], 1.0, bQvvAp[0]+vvblock[0][hc], bQabA_mo_->coldim(0), T.matrix[hc][0], 1, 1.0, tQ.data(), 1);
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int Q = 0; Q < nQ_; ++Q){
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        double** Pp = P[thread]->pointer();
+        for (int h = 0; h < nirrep_; ++h){
+            if (bQabA_mo_->coldim(h) == 0 || bQiaA_mo_->coldim(h) == 0) continue;
+            double** bQvvAp = bQabA_mo_->pointer(h);
+            double** bQovAp = bQiaA_mo_->pointer(h);
+            for (int ha = 0; ha < nirrep_; ++ha){
+                int hd = h ^ ha, hc = hd, hi = ha;
+                if (navirpi_[ha] == 0 || navirpi_[hc] == 0 || naoccpi_[hi] == 0) continue;
+                // P<A|C> = b(Q|AD) Tau_CD
+                C_DGEMM('N', 'T', navirpi_[ha], navirpi_[hc], navirpi_[hd], 1.0, bQvvAp[Q]+vvblock[h][ha], navirpi_[hd], T.matrix[hd][0], navirpi_[hd], 0.0, Pp[0], navirpi_[hc]);
+                // Y2_IA += b(Q|IC) P<A|C>
+                C_DGEMM('N', 'T', naoccpi_[hi], navirpi_[ha], navirpi_[hc], 1.0, bQovAp[Q]+ovblock[h][hi], navirpi_[hc], Pp[0], navirpi_[hc], 1.0, Y2[thread]->pointer(ha)[0], navirpi_[ha]);
+            }
+        }
+    }
+    for (int i = 1; i < nthreads; ++i) Y2[0]->add(Y2[i]);
+
+    for (int h = 0; h < nirrep_; ++h){
+        if (naoccpi_[h] == 0 || navirpi_[h] == 0) continue;
+        double** bQovAp = bQiaA_mo_->pointer(0);
+        double** Y2p = Y2[0]->pointer(h);
+        // Y2_IA -= 2 b(IA|Q) (Q)
+        C_DGEMV('T', nQ_, naoccpi_[h]*navirpi_[h], -2.0, bQovAp[0]+ovblock[0][h], bQiaA_mo_->coldim(0), tQ.data(), 1, 1.0, Y2p[0], 1);
+        // X_IA -= Y2_IC Tau_CA
+        C_DGEMM('N', 'N', naoccpi_[h], navirpi_[h], navirpi_[h], -1.0, Y2p[0], navirpi_[h], T.matrix[h][0], navirpi_[h], 1.0, XIA[0]->pointer(h)[0], navirpi_[h]);
+    }
+    Y2.clear();
+    P.clear();
+
+    global_dpd_->file2_mat_close(&T);
+    global_dpd_->file2_close(&T);
+    dcft_timer_off("DCFTSolver::DF g_IbCd tau_CA tau_DB");
+
+    /*
+     * X_IA += 1/4 W_IBKL lambda_KLAB + 1/2 W_KlIb lambda_KlAb
+     *       = 1/2 g(IC|BD) lambda_KLCD lambda_KLAB + g(IC|BD) lambda_KlCd lambda_KlAb
+     * with g(I'C|BD) = b(I'C|Q) b(Q|BD) formed for one occupied I' at a time
+     */
+    dcft_timer_on("DCFTSolver::DF g_IbCd lambda_CdKl lambda_KlAb");
+    global_dpd_->buf4_init(&Laa, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Lambda <OO|VV>");
+    global_dpd_->buf4_init(&Lab, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Lambda SF <OO|VV>"); // Lambda <Oo|Vv>
+    int maxkl = 0;
+    for (int h = 0; h < nirrep_; ++h){
+        global_dpd_->buf4_mat_irrep_init(&Laa, h);
+        global_dpd_->buf4_mat_irrep_rd(&Laa, h);
+        global_dpd_->buf4_mat_irrep_init(&Lab, h);
+        global_dpd_->buf4_mat_irrep_rd(&Lab, h);
+        maxkl = std::max(maxkl, Laa.params->rowtot[h]);
+    }
+
+    // One task per occupied I and irrep of B
+    std::vector<std::tuple<int, int, int>> tasks;
+    for (int hi = 0; hi < nirrep_; ++hi){
+        for (int I = 0; I < naoccpi_[hi]; ++I){
+            for (int hb = 0; hb < nirrep_; ++hb){
+                if (navirpi_[hi] > 0 && navirpi_[hb] > 0 && Laa.params->rowtot[hi^hb] > 0)
+                    tasks.push_back(std::make_tuple(hi, I, hb));
+            }
+        }
+    }
+
+    long int maxv = navirpi_.max();
+    std::vector<std::vector<double>> CBD(nthreads), CDB(nthreads), Waa(nthreads), Wab(nthreads);
+    for (int i = 0; i < nthreads; ++i){
+        CBD[i].resize(maxv * maxv * maxv);
+        CDB[i].resize(maxv * maxv * maxv);
+        Waa[i].resize((long int)maxkl * maxv);
+        Wab[i].resize((long int)maxkl * maxv);
+    }
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t task = 0; task < tasks.size(); ++task){
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        int hi = std::get<0>(tasks[task]);
+        int I = std::get<1>(tasks[task]);
+        int hb = std::get<2>(tasks[task]);
+        int hcd = hi ^ hb, ha = hi;
+        int nkl = Laa.params->rowtot[hcd];
+        int ncol = Laa.params->coltot[hcd];
+        double* CBDp = CBD[thread].data();
+        double* CDBp = CDB[thread].data();
+        double* Waap = Waa[thread].data();
+        double* Wabp = Wab[thread].data();
+
+        std::fill(Waap, Waap + (long int)nkl * navirpi_[hb], 0.0);
+        std::fill(Wabp, Wabp + (long int)nkl * navirpi_[hb], 0.0);
+
+        for (int hc = 0; hc < nirrep_; ++hc){
+            int hic = hi ^ hc, hd = hic ^ hb;
+            if (navirpi_[hc] == 0 || navirpi_[hd] == 0) continue;
+            double** bQovAp = bQiaA_mo_->pointer(hic);
+            double** bQvvAp = bQabA_mo_->pointer(hic);
+
+            // g(I'C|BD) = b(I'C|Q) b(Q|BD)
+            C_DGEMM('T', 'N', navirpi_[hc], navirpi_[hb]*navirpi_[hd], nQ_, 1.0, bQovAp[0]+ovblock[hic][hi]+I*navirpi_[hc], bQiaA_mo_->coldim(hic), bQvvAp[0]+vvblock[hic][hb], bQabA_mo_->coldim(hic), 0.0, CBDp, navirpi_[hb]*navirpi_[hd]);
+            // g(I'C|BD) -> g(I'C|DB)
+            for (int C = 0; C < navirpi_[hc]; ++C){
+                for (int B = 0; B < navirpi_[hb]; ++B){
+                    for (int D = 0; D < navirpi_[hd]; ++D){
+                        CDBp[(C*navirpi_[hd]+D)*navirpi_[hb]+B] = CBDp[(C*navirpi_[hb]+B)*navirpi_[hd]+D];
+                    }
+                }
+            }
+            // W<KL|I'B> = lambda<KL|CD> g(I'C|DB)
+            C_DGEMM('N', 'N', nkl, navirpi_[hb], navirpi_[hc]*navirpi_[hd], 1.0, Laa.matrix[hcd][0]+vvblock[hcd][hc], ncol, CDBp, navirpi_[hb], 1.0, Waap, navirpi_[hb]);
+            C_DGEMM('N', 'N', nkl, navirpi_[hb], navirpi_[hc]*navirpi_[hd], 1.0, Lab.matrix[hcd][0]+vvblock[hcd][hc], ncol, CDBp, navirpi_[hb], 1.0, Wabp, navirpi_[hb]);
+        }
+
+        // X_I'A += 1/2 W<KL|I'B> lambda<KL|AB> + W<Kl|I'b> lambda<Kl|Ab>
+        double** XIAp = XIA[thread]->pointer(hi);
+        for (int A = 0; A < navirpi_[ha]; ++A){
+            double value = 0.0;
+            for (int kl = 0; kl < nkl; ++kl){
+                value += 0.5 * C_DDOT(navirpi_[hb], Waap+kl*navirpi_[hb], 1, Laa.matrix[hcd][kl]+vvblock[hcd][ha]+A*navirpi_[hb], 1);
+                value += C_DDOT(navirpi_[hb], Wabp+kl*navirpi_[hb], 1, Lab.matrix[hcd][kl]+vvblock[hcd][ha]+A*navirpi_[hb], 1);
+            }
+            XIAp[I][A] += value;
+        }
+    }
+    CBD.clear();
+    CDB.clear();
+    Waa.clear();
+    Wab.clear();
+
+    for (int h = 0; h < nirrep_; ++h){
+        global_dpd_->buf4_mat_irrep_close(&Laa, h);
+        global_dpd_->buf4_mat_irrep_close(&Lab, h);
+    }
+    global_dpd_->buf4_close(&Laa);
+    global_dpd_->buf4_close(&Lab);
+    dcft_timer_off("DCFTSolver::DF g_IbCd lambda_CdKl lambda_KlAb");
+
+    /*
+     * X_AI += <JA||BC> Г_JIBC + 2 <Aj|Bc> Г_IjBc + <JB||AC> Г_JBIC + <Jb|Ac> Г_JbIc - <jB|Ac> Г_jBIc
+     *       = b(AC|Q) Z(Q|IC) + b(AJ|Q) Y(Q|JI), where
+     * Z(Q|IC) = b(Q|JB) [2 Г_JIBC + 2 Г_JiBc - Г_JCIB - Г_jCIb]
+     * Y(Q|JI) = b(Q|BC) [Г_JBIC + Г_JbIc]
+     */
+    dcft_timer_on("DCFTSolver::DF g_JaBc Gamma_JiBc");
+
+    // Z density <JB|IC> = 2 Г_JIBC + 2 Г_JiBc
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Gamma <OO|VV>");
+    global_dpd_->buf4_copy(&G, PSIF_DCFT_DPD, "Gamma(temp) <OO|VV>");
+    global_dpd_->buf4_close(&G);
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Gamma SF <OO|VV>"); // Gamma <Oo|Vv>
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Gamma(temp) <OO|VV>");
+    global_dpd_->buf4_axpy(&G, &Z, 1.0);
+    global_dpd_->buf4_close(&G);
+    global_dpd_->buf4_sort(&Z, PSIF_DCFT_DPD, prqs, ID("[O,V]"), ID("[O,V]"), "Z(temp) <OV|OV>");
+    global_dpd_->buf4_close(&Z);
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Z(temp) <OV|OV>");
+    global_dpd_->buf4_scm(&Z, 2.0);
+    global_dpd_->buf4_close(&Z);
+
+    // Z density <JB|IC> -= Г_JCIB + Г_jCIb
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Gamma <OV|OV>");
+    global_dpd_->buf4_copy(&G, PSIF_DCFT_DPD, "Gamma(temp) <OV|OV>");
+    global_dpd_->buf4_copy(&G, PSIF_DCFT_DPD, "Y(temp) <OV|OV>");
+    global_dpd_->buf4_close(&G);
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|oV>"); // Gamma <oV|Ov>
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Gamma(temp) <OV|OV>");
+    global_dpd_->buf4_axpy(&G, &Z, 1.0);
+    global_dpd_->buf4_close(&G);
+    global_dpd_->buf4_sort(&Z, PSIF_DCFT_DPD, psrq, ID("[O,V]"), ID("[O,V]"), "Gamma(temp) <OV|OV> (psrq)");
+    global_dpd_->buf4_close(&Z);
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Gamma(temp) <OV|OV> (psrq)");
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Z(temp) <OV|OV>");
+    global_dpd_->buf4_axpy(&G, &Z, -1.0);
+    global_dpd_->buf4_close(&G);
+
+    // Z(Q|IC) = b(Q|JB) Z<JB|IC>
+    SharedMatrix bQZ(new Matrix("Z(Q|IA)", bQiaA_mo_->rowspi(), bQiaA_mo_->colspi()));
+    for (int h = 0; h < nirrep_; ++h){
+        if (Z.params->rowtot[h] == 0) continue;
+        global_dpd_->buf4_mat_irrep_init(&Z, h);
+        global_dpd_->buf4_mat_irrep_rd(&Z, h);
+        C_DGEMM('N', 'N', nQ_, Z.params->coltot[h], Z.params->rowtot[h], 1.0, bQiaA_mo_->pointer(h)[0], bQiaA_mo_->coldim(h), Z.matrix[h][0], Z.params->coltot[h], 0.0, bQZ->pointer(h)[0], bQZ->coldim(h));
+        global_dpd_->buf4_mat_irrep_close(&Z, h);
+    }
+    global_dpd_->buf4_close(&Z);
+
+    // Y density <JI|BC> = Г_JBIC + Г_JbIc
+    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|Ov>"); // Gamma <Ov|Ov>
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,V]"),
+                           ID("[O,V]"), ID("[O,V]"), 0, "Y(temp) <OV|OV>");
+    global_dpd_->buf4_axpy(&G, &Z, 1.0);
+    global_dpd_->buf4_close(&G);
+    global_dpd_->buf4_sort(&Z, PSIF_DCFT_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "Y(temp) <OO|VV>");
+    global_dpd_->buf4_close(&Z);
+
+    // Y(Q|JI) = b(Q|BC) Y<JI|BC>
+    Dimension OO(nirrep_);
+    for (int h = 0; h < nirrep_; ++h){
+        for (int hj = 0; hj < nirrep_; ++hj) OO[h] += naoccpi_[hj] * naoccpi_[h ^ hj];
+    }
+    SharedMatrix bQY(new Matrix("Y(Q|IJ)", bQiaA_mo_->rowspi(), OO));
+    global_dpd_->buf4_init(&Z, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                           ID("[O,O]"), ID("[V,V]"), 0, "Y(temp) <OO|VV>");
+    for (int h = 0; h < nirrep_; ++h){
+        if (Z.params->rowtot[h] == 0 || Z.params->coltot[h] == 0) continue;
+        global_dpd_->buf4_mat_irrep_init(&Z, h);
+        global_dpd_->buf4_mat_irrep_rd(&Z, h);
+        C_DGEMM('N', 'T', nQ_, Z.params->rowtot[h], Z.params->coltot[h], 1.0, bQabA_mo_->pointer(h)[0], bQabA_mo_->coldim(h), Z.matrix[h][0], Z.params->coltot[h], 0.0, bQY->pointer(h)[0], bQY->coldim(h));
+        global_dpd_->buf4_mat_irrep_close(&Z, h);
+    }
+    global_dpd_->buf4_close(&Z);
+
+    // X_AI += b(AC|Q) Z(Q|IC) + b(AJ|Q) Y(Q|JI)
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int Q = 0; Q < nQ_; ++Q){
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        for (int h = 0; h < nirrep_; ++h){
+            if (bQiaA_mo_->coldim(h) == 0) continue;
+            double** bQovAp = bQiaA_mo_->pointer(h);
+            double** bQZp = bQZ->pointer(h);
+            for (int ha = 0; ha < nirrep_; ++ha){
+                int hc = h ^ ha, hj = h ^ ha, hi = ha;
+                if (navirpi_[ha] == 0 || naoccpi_[hi] == 0) continue;
+                double** XAIp = XAI[thread]->pointer(ha);
+                if (navirpi_[hc] > 0){
+                    double** bQvvAp = bQabA_mo_->pointer(h);
+                    C_DGEMM('N', 'T', navirpi_[ha], naoccpi_[hi], navirpi_[hc], 1.0, bQvvAp[Q]+vvblock[h][ha], navirpi_[hc], bQZp[Q]+ovblock[h][hi], navirpi_[hc], 1.0, XAIp[0], naoccpi_[hi]);
+                }
+                if (naoccpi_[hj] > 0){
+                    double** bQYp = bQY->pointer(h);
+                    C_DGEMM('T', 'N', navirpi_[ha], naoccpi_[hi], naoccpi_[hj], 1.0, bQovAp[Q]+ovblock[h][hj], navirpi_[ha], bQYp[Q]+ooblock[h][hj], naoccpi_[hi], 1.0, XAIp[0], naoccpi_[hi]);
+                }
+            }
+        }
+    }
+    bQZ.reset();
+    bQY.reset();
+    dcft_timer_off("DCFTSolver::DF g_JaBc Gamma_JiBc");
+
+    psio_->close(PSIF_DCFT_DENSITY, 1);
+
+    for (int i = 1; i < nthreads; ++i){
+        XIA[0]->add(XIA[i]);
+        XAI[0]->add(XAI[i]);
+    }
+
+    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
+    global_dpd_->file2_mat_init(&X);
+    global_dpd_->file2_mat_rd(&X);
+    for (int h = 0; h < nirrep_; ++h){
+        for (int i = 0; i < naoccpi_[h]; ++i){
+            for (int a = 0; a < navirpi_[h]; ++a){
+                X.matrix[h][i][a] += XIA[0]->get(h, i, a);
+            }
+        }
+    }
+    global_dpd_->file2_mat_wrt(&X);
+    global_dpd_->file2_close(&X);
+
+    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+    global_dpd_->file2_mat_init(&X);
+    global_dpd_->file2_mat_rd(&X);
+    for (int h = 0; h < nirrep_; ++h){
+        for (int a = 0; a < navirpi_[h]; ++a){
+            for (int i = 0; i < naoccpi_[h]; ++i){
+                X.matrix[h][a][i] += XAI[0]->get(h, a, i);
+            }
+        }
+    }
+    global_dpd_->file2_mat_wrt(&X);
+    global_dpd_->file2_close(&X);
+
+    dcft_timer_off("DCFTSolver::DF g(OV|VV) orbital gradient");
+}
+
 
 /**
  * Compute the density-fitted ERI <vv||vv> tensors in G intermediates
@@ -59,11 +59,11 @@ DCFTSolver::transform_integrals_RHF()
         /*- Transform g(VV|OO) -*/
         form_df_g_vvoo();
 
+        // The g(OV|VV) terms of the orbital gradient are built from b(Q|ov) and b(Q|vv)
+        // directly (build_DF_orbital_gradient_OVVV_RHF), so only g(VO|OO) goes to disk
         if(orbital_optimized_){
             /*- Transform g(VO|OO) -*/
             form_df_g_vooo();
-            /*- Transform g(OV|VV) -*/
-            form_df_g_ovvv();
         }
 
         psio_->close(PSIF_LIBTRANS_DPD, 1);
@@ -135,7 +135,8 @@ DCFTSolver::transform_integrals_RHF()
 
         sort_OOOV_integrals_RHF();
 
-        sort_OVVV_integrals_RHF();
+        if (options_.get_str("DCFT_TYPE") == "CONV")
+            sort_OVVV_integrals_RHF();
 
     }
 
@@ -233,6 +233,10 @@ DCFTSolver::compute_orbital_residual_RHF() {
     // Compute the VO part of the orbital gradient
     compute_orbital_gradient_VO_RHF();
 
+    // With density fitting, the g(OV|VV) terms of both parts come from the three-index tensors
+    if (options_.get_str("DCFT_TYPE") == "DF")
+        build_DF_orbital_gradient_OVVV_RHF();
+
     global_dpd_->file2_init(&Xia, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
     global_dpd_->file2_init(&Xai, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
     global_dpd_->file2_mat_init(&Xia);
@@ -286,86 +290,89 @@ DCFTSolver::compute_orbital_gradient_OV_RHF() {
 
     // X_OV: Two-electron contributions
 
-    //
-    // 2 * <OV||VV> Г_VVVV
-    //
-
-    // Compute contributions from VVVV density
-    // 1. X_ia <-- <ib||cd> tau_ca tau_db
-    dcft_timer_on("DCFTSolver::g_IbCd tau_CA tau_DB");
-    global_dpd_->file2_init(&T_VV, PSIF_DCFT_DPD, 0, ID('V'), ID('V'), "Tau <V|V>");
-
-    // Alpha contribution X_IA
-    global_dpd_->file2_init(&Y2_OV, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "Y2 <O|V>");
-
-    // Y2_IA = <IA|CD> Tau_CD
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
-    global_dpd_->contract422(&I, &T_VV, &Y2_OV, 0, 0, 1.0, 0.0);
-    global_dpd_->buf4_close(&I);
-    // Y2_IA -= 2 * (IA|CD) Tau_CD
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
-    global_dpd_->contract422(&I, &T_VV, &Y2_OV, 0, 0, -2.0, 1.0);
-    global_dpd_->buf4_close(&I);
-
-    // X_IA -= Y2_IC Tau_CA
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
-    global_dpd_->contract222(&Y2_OV, &T_VV, &X, 0, 1, -1.0, 1.0);
-    global_dpd_->file2_close(&X);
-
-    global_dpd_->file2_close(&Y2_OV);
-    global_dpd_->file2_close(&T_VV);
-    dcft_timer_off("DCFTSolver::g_IbCd tau_CA tau_DB");
-
-    // 2. X_ia <-- 1/4 <ib||cd> lambda_abkl lambda_klcd
-
-    // W_IBKL = <IB||CD> lambda_KLCD
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V>V]-"),
-                  ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
-    global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V>V]-"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "Lambda <OO|VV>");
-    global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,O]"),
-                  ID("[O,V]"), ID("[O>O]-"), 0, "W <OV|OO>");
-    global_dpd_->contract444(&I, &L, &W, 0, 0, 2.0, 0.0);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->buf4_close(&L);
-    global_dpd_->buf4_close(&W);
-
-    // W_KlIb = 2 lambda_KlCd <Ib|Cd>
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                           ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <Ov|Vv>
-    global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                           ID("[O,O]"), ID("[V,V]"), 0, "Lambda SF <OO|VV>"); // Lambda <Oo|Vv>
-    global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[O,V]"),
-                  ID("[O,O]"), ID("[O,V]"), 0, "W SF <OO|OV>"); // W <Oo|Ov>
-    global_dpd_->contract444(&L, &I, &W, 0, 0, 2.0, 0.0);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->buf4_close(&L);
-    global_dpd_->buf4_close(&W);
-
-    // X_IA +=  1/4 W_IBKL lambda_KLAB
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
-    global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,O]"),
-                  ID("[O,V]"), ID("[O>O]-"), 0, "W <OV|OO>");
-    global_dpd_->buf4_init(&LL, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "Lambda <OO|VV>");
-
-    global_dpd_->contract442(&W, &LL, &X, 0, 2, 0.25, 1.0);
-    global_dpd_->buf4_close(&W);
-    global_dpd_->buf4_close(&LL);
-    global_dpd_->file2_close(&X);
-
-    // X_IA +=  1/2 W_KlIb lambda_KlAb
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
-    global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[O,V]"),
-                  ID("[O,O]"), ID("[O,V]"), 0, "W SF <OO|OV>"); // W <Oo|Ov>
-    global_dpd_->buf4_init(&LL, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                           ID("[O,O]"), ID("[V,V]"), 0, "Lambda SF <OO|VV>"); // Lambda <Oo|Vv>
-    global_dpd_->contract442(&W, &LL, &X, 2, 2, 0.5, 1.0);
-    global_dpd_->buf4_close(&W);
-    global_dpd_->buf4_close(&LL);
-    global_dpd_->file2_close(&X);
+    // The <OV|VV> terms; with density fitting, see build_DF_orbital_gradient_OVVV_RHF()
+    if (options_.get_str("DCFT_TYPE") == "CONV") {
+        //
+        // 2 * <OV||VV> Г_VVVV
+        //
+
+        // Compute contributions from VVVV density
+        // 1. X_ia <-- <ib||cd> tau_ca tau_db
+        dcft_timer_on("DCFTSolver::g_IbCd tau_CA tau_DB");
+        global_dpd_->file2_init(&T_VV, PSIF_DCFT_DPD, 0, ID('V'), ID('V'), "Tau <V|V>");
+
+        // Alpha contribution X_IA
+        global_dpd_->file2_init(&Y2_OV, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "Y2 <O|V>");
+
+        // Y2_IA = <IA|CD> Tau_CD
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>");
+        global_dpd_->contract422(&I, &T_VV, &Y2_OV, 0, 0, 1.0, 0.0);
+        global_dpd_->buf4_close(&I);
+        // Y2_IA -= 2 * (IA|CD) Tau_CD
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
+        global_dpd_->contract422(&I, &T_VV, &Y2_OV, 0, 0, -2.0, 1.0);
+        global_dpd_->buf4_close(&I);
+
+        // X_IA -= Y2_IC Tau_CA
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
+        global_dpd_->contract222(&Y2_OV, &T_VV, &X, 0, 1, -1.0, 1.0);
+        global_dpd_->file2_close(&X);
+
+        global_dpd_->file2_close(&Y2_OV);
+        global_dpd_->file2_close(&T_VV);
+        dcft_timer_off("DCFTSolver::g_IbCd tau_CA tau_DB");
+
+        // 2. X_ia <-- 1/4 <ib||cd> lambda_abkl lambda_klcd
+
+        // W_IBKL = <IB||CD> lambda_KLCD
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V>V]-"),
+                      ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
+        global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V>V]-"),
+                      ID("[O,O]"), ID("[V,V]"), 0, "Lambda <OO|VV>");
+        global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,O]"),
+                      ID("[O,V]"), ID("[O>O]-"), 0, "W <OV|OO>");
+        global_dpd_->contract444(&I, &L, &W, 0, 0, 2.0, 0.0);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->buf4_close(&L);
+        global_dpd_->buf4_close(&W);
+
+        // W_KlIb = 2 lambda_KlCd <Ib|Cd>
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                               ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <Ov|Vv>
+        global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                               ID("[O,O]"), ID("[V,V]"), 0, "Lambda SF <OO|VV>"); // Lambda <Oo|Vv>
+        global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[O,V]"),
+                      ID("[O,O]"), ID("[O,V]"), 0, "W SF <OO|OV>"); // W <Oo|Ov>
+        global_dpd_->contract444(&L, &I, &W, 0, 0, 2.0, 0.0);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->buf4_close(&L);
+        global_dpd_->buf4_close(&W);
+
+        // X_IA +=  1/4 W_IBKL lambda_KLAB
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
+        global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,V]"), ID("[O,O]"),
+                      ID("[O,V]"), ID("[O>O]-"), 0, "W <OV|OO>");
+        global_dpd_->buf4_init(&LL, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                      ID("[O,O]"), ID("[V,V]"), 0, "Lambda <OO|VV>");
+
+        global_dpd_->contract442(&W, &LL, &X, 0, 2, 0.25, 1.0);
+        global_dpd_->buf4_close(&W);
+        global_dpd_->buf4_close(&LL);
+        global_dpd_->file2_close(&X);
+
+        // X_IA +=  1/2 W_KlIb lambda_KlAb
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('O'), ID('V'), "X <O|V>");
+        global_dpd_->buf4_init(&W, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[O,V]"),
+                      ID("[O,O]"), ID("[O,V]"), 0, "W SF <OO|OV>"); // W <Oo|Ov>
+        global_dpd_->buf4_init(&LL, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"),
+                               ID("[O,O]"), ID("[V,V]"), 0, "Lambda SF <OO|VV>"); // Lambda <Oo|Vv>
+        global_dpd_->contract442(&W, &LL, &X, 2, 2, 0.5, 1.0);
+        global_dpd_->buf4_close(&W);
+        global_dpd_->buf4_close(&LL);
+        global_dpd_->file2_close(&X);
+    }
 
     //
     // <OO||OV> Г_OOVV
@@ -515,79 +522,82 @@ DCFTSolver::compute_orbital_gradient_VO_RHF() {
     global_dpd_->buf4_close(&I);
     global_dpd_->file2_close(&X);
 
-    //
-    // <VO||VV> Г_OOVV
-    //
-
-    // X_AI += <JA||BC> Г_JIBC
-    dcft_timer_on("DCFTSolver::2 * g_JaBc Gamma_JiBc");
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
-    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "Gamma <OO|VV>");
-
-    global_dpd_->contract442(&I, &G, &X, 1, 1, 1.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
-    dcft_timer_off("DCFTSolver::2 * g_JaBc Gamma_JiBc");
-
-    // X_AI += <Aj|Bc> Г_IjBc
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <oV|vV>
-    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "Gamma SF <OO|VV>"); // Gamma <Oo|Vv>
-
-    global_dpd_->contract442(&I, &G, &X, 1, 1, 2.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
-
-    //
-    // <OV||VV> Г_OVOV
-    //
-
-    // X_AI += <JB||AC> Г_JBIC
-    dcft_timer_on("DCFTSolver::g_JbAc Gamma_JbIc");
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
-    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
-                  ID("[O,V]"), ID("[O,V]"), 0, "Gamma <OV|OV>");
-
-    global_dpd_->contract442(&I, &G, &X, 2, 2, 1.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
-    dcft_timer_off("DCFTSolver::g_JbAc Gamma_JbIc");
-
-    // X_AI += <Jb|Ac> Г_JbIc
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <Ov|Vv>
-    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
-                  ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|Ov>"); // Gamma <Ov|Ov>
-
-    global_dpd_->contract442(&I, &G, &X, 2, 2, 1.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
-
-    // X_AI -= <jB|Ac> Г_jBIc
-    // Note: <jB|Ac> integrals are resorted <Bj|Ac> integrals.
-    // <jB||Ac> Г_jBIc = (-1) * <Bj|Ac> Г_jBIc
-    global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
-    global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
-                  ID("[O,V]"), ID("[V,V]"), 0, "MO Ints SF <OV|VV>"); // MO Ints <oV|Vv>
-    global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
-                  ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|oV>"); // Gamma <oV|Ov>
-
-    global_dpd_->contract442(&I, &G, &X, 2, 2, -1.0, 1.0);
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_close(&I);
-    global_dpd_->file2_close(&X);
+    // The <OV|VV> terms; with density fitting, see build_DF_orbital_gradient_OVVV_RHF()
+    if (options_.get_str("DCFT_TYPE") == "CONV") {
+        //
+        // <VO||VV> Г_OOVV
+        //
+
+        // X_AI += <JA||BC> Г_JIBC
+        dcft_timer_on("DCFTSolver::2 * g_JaBc Gamma_JiBc");
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
+        global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
+                      ID("[O,O]"), ID("[V,V]"), 0, "Gamma <OO|VV>");
+
+        global_dpd_->contract442(&I, &G, &X, 1, 1, 1.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+        dcft_timer_off("DCFTSolver::2 * g_JaBc Gamma_JiBc");
+
+        // X_AI += <Aj|Bc> Г_IjBc
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <oV|vV>
+        global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,O]"), ID("[V,V]"),
+                      ID("[O,O]"), ID("[V,V]"), 0, "Gamma SF <OO|VV>"); // Gamma <Oo|Vv>
+
+        global_dpd_->contract442(&I, &G, &X, 1, 1, 2.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+
+        //
+        // <OV||VV> Г_OVOV
+        //
+
+        // X_AI += <JB||AC> Г_JBIC
+        dcft_timer_on("DCFTSolver::g_JbAc Gamma_JbIc");
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 1, "MO Ints <OV|VV>");
+        global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                      ID("[O,V]"), ID("[O,V]"), 0, "Gamma <OV|OV>");
+
+        global_dpd_->contract442(&I, &G, &X, 2, 2, 1.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+        dcft_timer_off("DCFTSolver::g_JbAc Gamma_JbIc");
+
+        // X_AI += <Jb|Ac> Г_JbIc
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 0, "MO Ints <OV|VV>"); // MO Ints <Ov|Vv>
+        global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                      ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|Ov>"); // Gamma <Ov|Ov>
+
+        global_dpd_->contract442(&I, &G, &X, 2, 2, 1.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+
+        // X_AI -= <jB|Ac> Г_jBIc
+        // Note: <jB|Ac> integrals are resorted <Bj|Ac> integrals.
+        // <jB||Ac> Г_jBIc = (-1) * <Bj|Ac> Г_jBIc
+        global_dpd_->file2_init(&X, PSIF_DCFT_DPD, 0, ID('V'), ID('O'), "X <V|O>");
+        global_dpd_->buf4_init(&I, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
+                      ID("[O,V]"), ID("[V,V]"), 0, "MO Ints SF <OV|VV>"); // MO Ints <oV|Vv>
+        global_dpd_->buf4_init(&G, PSIF_DCFT_DENSITY, 0, ID("[O,V]"), ID("[O,V]"),
+                      ID("[O,V]"), ID("[O,V]"), 0, "Gamma SF <OV|OV>:<Ov|oV>"); // Gamma <oV|Ov>
+
+        global_dpd_->contract442(&I, &G, &X, 2, 2, -1.0, 1.0);
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&I);
+        global_dpd_->file2_close(&X);
+    }
 
     psio_->close(PSIF_DCFT_DENSITY, 1);
     psio_->close(PSIF_LIBTRANS_DPD, 1);
@@ -342,6 +342,7 @@ private:
     std::shared_ptr<MOSpace> rot_space_;
     std::shared_ptr<MOSpace> act_space_;
     std::shared_ptr<DFERI> dferi_; // DF
+    SharedMatrix df_ci_aaQ_; // DF (tu|Q), CI-ordered t >= u pairs
     std::shared_ptr<JK> jk_;
     std::shared_ptr<SOMCSCF> somcscf_;
 
@@ -363,6 +364,10 @@ private:
     void setup_dfmcscf_ints();
     void transform_dfmcscf_ints(bool approx_only = false);
     void rotate_dfmcscf_twoel_ints(SharedMatrix K, SharedVector twoel_out);
+    /// Packs the Pitzer nact^2 x nQ src into CI-ordered t >= u rows of dest, adding src[ut] to src[tu] if symm
+    void pitzer_to_ci_order_df(double* src, int nQ, bool symm, SharedMatrix dest);
+    /// The lower triangle of a CI-ordered ncitri x ncitri pair Matrix, as CI twoel ints
+    void ci_pairs_to_twoel(SharedMatrix src, SharedVector dest);
 
     /// MO transformation through TeraCHEM-like
     /// Added in by Kevin Patrick Hannon
@@ -231,7 +231,6 @@ void CIWavefunction::transform_dfmcscf_ints(bool approx_only) {
     SharedMatrix Cvir = get_orbitals("VIR");
 
     int nao = AO2SO_->rowspi()[0];
-    int nact = CalcInfo_->num_ci_orbs;
     int nrot = Cocc->ncol() + Cact->ncol() + Cvir->ncol();
     int aoc_rowdim = nrot + Cact->ncol();
     SharedMatrix AO_C = SharedMatrix(new Matrix("AO_C", nao, aoc_rowdim));
@@ -289,7 +288,6 @@ void CIWavefunction::transform_dfmcscf_ints(bool approx_only) {
     }
 
     dferi_->compute();
-    std::map<std::string, std::shared_ptr<Tensor> >& dfints = dferi_->ints();
 
     // => Compute onel ints <= //
     onel_ints_from_jk();
@@ -297,17 +295,18 @@ void CIWavefunction::transform_dfmcscf_ints(bool approx_only) {
     // => Compute twoel ints <= //
     int nQ = dferi_->size_Q();
 
-    std::shared_ptr<Tensor> aaQT = dfints["aaQ"];
-    SharedMatrix aaQ(new Matrix("aaQ", nact * nact, nQ));
+    // Read once here; the MCSCF object and rotations reuse the in-core copy.
+    // Only the unique (tu|Q) pairs enter, in CI order, so (tu|vw) is one
+    // ncitri x ncitri SYRK rather than an nact^4 GEMM and a reorder.
+    double* aaQp = dferi_->core_ints("aaQ");
+    int ntri = CalcInfo_->num_ci_tri;
+    df_ci_aaQ_ = SharedMatrix(new Matrix("DF (tu|Q), CI order", ntri, nQ));
+    pitzer_to_ci_order_df(aaQp, nQ, false, df_ci_aaQ_);
 
-    double* aaQp = aaQ->pointer()[0];
-    FILE* aaQF = aaQT->file_pointer();
-    fseek(aaQF, 0L, SEEK_SET);
-    fread(aaQp, sizeof(double), nact * nact * nQ, aaQF);
-    SharedMatrix actMO = Matrix::doublet(aaQ, aaQ, false, true);
-    aaQ.reset();
+    SharedMatrix actMO(new Matrix("actMO", ntri, ntri));
+    C_DSYRK('L', 'N', ntri, nQ, 1.0, df_ci_aaQ_->pointer()[0], nQ, 0.0, actMO->pointer()[0], ntri);
 
-    pitzer_to_ci_order_twoel(actMO, CalcInfo_->twoel_ints);
+    ci_pairs_to_twoel(actMO, CalcInfo_->twoel_ints);
     actMO.reset();
 
     tf_onel_ints(CalcInfo_->onel_ints, CalcInfo_->twoel_ints, CalcInfo_->tf_onel_ints);
@@ -392,18 +391,11 @@ void CIWavefunction::setup_mcscf_ints_ao()
 
     timer_on("CIWave: Setup MCSCF INTS AO");
     std::string scf_type = options_.get_str("SCF_TYPE");
-    if(scf_type == "GTFOCK")
-    {
- #ifdef HAVE_JK_FACTORY
-        Process::environment.set_legacy_molecule(molecule_);
-        jk_ = boost::shared_ptr<JK>(new GTFockJK(basisset_));
-#else
-        throw PSIEXCEPTION("GTFock was not compiled in this version");
-#endif
-    } else if (scf_type == "DF") {
+    if (scf_type == "DF") {
         jk_ = JK::build_JK(this->basisset(), get_basisset("DF_BASIS_SCF"), options_);
     }
-    else if (scf_type == "CD" or scf_type == "PK" or scf_type == "DIRECT" or scf_type == "OUT_OF_CORE")
+    else if (scf_type == "CD" or scf_type == "PK" or scf_type == "DIRECT" or scf_type == "OUT_OF_CORE" or
+             scf_type == "GTFOCK")
     {
         jk_ = JK::build_JK(this->basisset(), BasisSet::zero_ao_basis_set(), options_);
     }
@@ -729,60 +721,34 @@ void CIWavefunction::rotate_dfmcscf_twoel_ints(SharedMatrix Uact,
     int nact = CalcInfo_->num_ci_orbs;
     int nav = nact + CalcInfo_->num_rsv_orbs;
 
-    // Read RaQ
-    std::shared_ptr<Tensor> RaQT = dferi_->ints()["RaQ"];
-    SharedMatrix RaQ(new Matrix("RaQ", nrot, nact * nQ));
-
-    double* RaQp = RaQ->pointer()[0];
-    FILE* RaQF = RaQT->file_pointer();
-    fseek(RaQF, 0L, SEEK_SET);
-    fread(RaQp, sizeof(double), nrot * nact * nQ, RaQF);
+    double* RaQp = dferi_->core_ints("RaQ");
+    if (!df_ci_aaQ_) {
+        throw PSIEXCEPTION("CIWavefunction::rotate_dfmcscf_twoel_ints: DF integrals have not been transformed.");
+    }
 
     // We could slice it or... I like my raw GEMM
     // Uact_av DFERI_R_a_Q - > DFERI_a_aQ
 
     SharedMatrix dense_Uact = Uact->to_block_sharedmatrix();
-    SharedMatrix tmp_rot_aaQ = Matrix::doublet(dense_Uact, RaQ);
-    RaQ.reset();
+    SharedMatrix tmp_rot_aaQ(new Matrix("Rotated aaQ", nact, nact * nQ));
+    C_DGEMM('N', 'N', nact, nact * nQ, nrot, 1.0, dense_Uact->pointer()[0], nrot, RaQp, nact * nQ, 0.0,
+            tmp_rot_aaQ->pointer()[0], nact * nQ);
 
 
-    // Quv += Qvu
-    SharedMatrix rot_aaQ(new Matrix("Rotated aaQ Matrix", nact * nact, nQ));
-    double* tmp_rot_aaQp = tmp_rot_aaQ->pointer()[0];
-    double* rot_aaQp = rot_aaQ->pointer()[0];
-    for (size_t u = 0; u < nact; ++u) {
-        for (size_t v = 0; v < nact; ++v) {
-            for (size_t q = 0; q < nQ; ++q) {
-                size_t uvq = u * nact * nQ + v * nQ + q;
-                size_t vuq = v * nact * nQ + u * nQ + q;
+    // Quv += Qvu, kept only for the CI-ordered u >= v pairs
+    int ntri = CalcInfo_->num_ci_tri;
+    SharedMatrix rot_aaQ(new Matrix("Rotated aaQ Matrix", ntri, nQ));
+    pitzer_to_ci_order_df(tmp_rot_aaQ->pointer()[0], nQ, true, rot_aaQ);
+    tmp_rot_aaQ.reset();
 
-                rot_aaQp[uvq] += tmp_rot_aaQp[uvq];
-                rot_aaQp[uvq] += tmp_rot_aaQp[vuq];
-
-            }
-        }
-    }
-
-    // Read aaQ
-    std::shared_ptr<Tensor> aaQT = dferi_->ints()["aaQ"];
-    SharedMatrix aaQ(new Matrix("aaQ", nact * nact, nQ));
-
-    double* aaQp = aaQ->pointer()[0];
-    FILE* aaQF = aaQT->file_pointer();
-    fseek(aaQF, 0L, SEEK_SET);
-    fread(aaQp, sizeof(double), nact * nact * nQ, aaQF);
-
-
-    // Form ERI's
-    SharedMatrix rot_twoel = Matrix::doublet(rot_aaQ, aaQ, false, true);
+    // Form ERI's, with the final symmetry from the rank-2k update
+    SharedMatrix rot_twoel(new Matrix("Rotated twoel", ntri, ntri));
+    C_DSYR2K('L', 'N', ntri, nQ, 1.0, rot_aaQ->pointer()[0], nQ, df_ci_aaQ_->pointer()[0], nQ, 0.0,
+             rot_twoel->pointer()[0], ntri);
 
     rot_aaQ.reset();
-    aaQ.reset();
 
-    // Add final symmetry
-    rot_twoel->add(rot_twoel->transpose());
-
-    pitzer_to_ci_order_twoel(rot_twoel, twoel_out);
+    ci_pairs_to_twoel(rot_twoel, twoel_out);
 
 }
 void CIWavefunction::rotate_mcscf_twoel_ints(SharedMatrix Uact,
@@ -1125,4 +1091,36 @@ void CIWavefunction::pitzer_to_ci_order_twoel(SharedMatrix src, SharedVector des
     }
 }
 
+void CIWavefunction::pitzer_to_ci_order_df(double* src, int nQ, bool symm, SharedMatrix dest){
+    size_t nact = CalcInfo_->num_ci_orbs;
+    if ((dest->rowdim() != CalcInfo_->num_ci_tri) || (dest->coldim() != nQ)){
+        throw PSIEXCEPTION("CIWavefunciton::pitzer_to_ci_order_df: Destination matrix must be ncitri x nQ.");
+    }
+
+    double** destp = dest->pointer();
+    for (size_t i = 0; i < nact; i++) {
+        size_t irel = CalcInfo_->act_reorder[i];
+        for (size_t j = 0; j <= i; j++) {
+            size_t jrel = CalcInfo_->act_reorder[j];
+            double* ijp = destp[INDEX(irel, jrel)];
+            C_DCOPY(nQ, &src[(i * nact + j) * nQ], 1, ijp, 1);
+            if (symm) C_DAXPY(nQ, 1.0, &src[(j * nact + i) * nQ], 1, ijp, 1);
+        }
+    }
+}
+void CIWavefunction::ci_pairs_to_twoel(SharedMatrix src, SharedVector dest){
+    size_t ntri = CalcInfo_->num_ci_tri;
+    if (dest->dim(0) != CalcInfo_->num_ci_tri2){
+        throw PSIEXCEPTION("CIWavefunciton::ci_pairs_to_twoel: Destination vector must be of size ncitri2.");
+    }
+
+    double** srcp = src->pointer();
+    double* destp = dest->pointer();
+    for (size_t ij = 0; ij < ntri; ij++) {
+        for (size_t kl = 0; kl <= ij; kl++) {
+            destp[INDEX(ij, kl)] = srcp[ij][kl];
+        }
+    }
+}
+
 }} // namespace psi::detci
@@ -313,6 +313,7 @@ void CIWavefunction::get_parameters(Options &options)
   }
 
   Parameters_->icore = options.get_int("ICORE");
+  Parameters_->sigma_distributed = options.get_bool("SIGMA_DISTRIBUTED");
 
   if (options["HD_AVG"].has_changed()) {
     std::string line1 = options.get_str("HD_AVG");
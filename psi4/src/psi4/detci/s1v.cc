@@ -51,10 +51,16 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
+#include "psi4/libpsi4util/process.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 namespace detci {
@@ -65,6 +71,22 @@ extern void b2brepl(unsigned char **occs, int *Jcnt, int **Jij, int **Joij,
 
 #define INDEX(i, j) ((i > j) ? (ioff[(i)] + (j)) : (ioff[(j)] + (i)))
 
+/*
+** SIGMA_NTHREADS()
+**
+** Number of threads to share nwork strings over in the sigma routines
+** (s1, s2, s3).  Never more threads than strings.
+*/
+int sigma_nthreads(int nwork) {
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = Process::environment.get_n_threads();
+  if (nthreads > nwork) nthreads = nwork;
+  if (nthreads < 1) nthreads = 1;
+#endif
+  return nthreads;
+}
+
 /*
 ** S1_BLOCK_VFCI():
 **
@@ -88,19 +110,31 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
                    double **C, double **S, double *oei, double *tei, double *F,
                    int nlists, int nas, int nbs, int Ib_list, int Jb_list,
                    int Jb_list_nbs) {
-  struct stringwr *Ib, *Kb;
-  size_t Ia_idx, Ib_idx, Kb_idx, Jb_idx;
-  size_t Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex;
-  size_t *Ibridx, *Kbridx;
-  int *Ibij, *Kbij;
-  signed char *Ibsgn, *Kbsgn;
-  int ij, kl, ijkl;
-  double Kb_sgn, Jb_sgn;
-  double tval;
+  /* Each I_b only updates its own column of S, so the I_b strings are
+     shared out over threads, each with a private F */
+  int nthreads = sigma_nthreads(nbs);
+  std::vector<double> Fthr((size_t)(nthreads - 1) * Jb_list_nbs);
 
   /* loop over I_b */
-  for (Ib = betlist[Ib_list], Ib_idx = 0; Ib_idx < nbs; Ib_idx++, Ib++) {
-    zero_arr(F, Jb_list_nbs);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for (size_t Ib_idx = 0; Ib_idx < nbs; Ib_idx++) {
+    struct stringwr *Ib, *Kb;
+    size_t Ia_idx, Kb_idx, Jb_idx;
+    size_t Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex;
+    size_t *Ibridx, *Kbridx;
+    int *Ibij, *Kbij;
+    signed char *Ibsgn, *Kbsgn;
+    int ij, kl, ijkl;
+    double Kb_sgn, Jb_sgn;
+    double tval;
+
+    Ib = betlist[Ib_list] + Ib_idx;
+    double *Ft = F;
+#ifdef _OPENMP
+    int thread = omp_get_thread_num();
+    if (thread) Ft = Fthr.data() + (size_t)(thread - 1) * Jb_list_nbs;
+#endif
+    zero_arr(Ft, Jb_list_nbs);
 
     /* loop over excitations E^b_{kl} from |B(I_b)> */
     for (Kb_list = 0; Kb_list < nlists; Kb_list++) {
@@ -115,7 +149,7 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
 
         /* B(K_b) = sgn(kl) * E^b_{kl} |B(I_b)> */
         Kb = betlist[Kb_list] + Kb_idx;
-        if (Kb_list == Jb_list) F[Kb_idx] += Kb_sgn * oei[kl];
+        if (Kb_list == Jb_list) Ft[Kb_idx] += Kb_sgn * oei[kl];
 
         /* loop over excitations E^b_{ij} from |B(K_b)> */
         /* Jb_list pre-determined because of C blocking */
@@ -128,7 +162,7 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
           Jb_sgn = (double)*Kbsgn++;
           ij = *Kbij++;
           ijkl = INDEX(ij, kl);
-          F[Jb_idx] += 0.5 * Kb_sgn * Jb_sgn * tei[ijkl];
+          Ft[Jb_idx] += 0.5 * Kb_sgn * Jb_sgn * tei[ijkl];
         }
       } /* end loop over Ib excitations */
     }   /* end loop over Kb_list */
@@ -137,7 +171,7 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
     for (Ia_idx=0; Ia_idx < nas; Ia_idx++) {
        tval = 0.0;
        for (Jb_idx=0; Jb_idx < Jb_list_nbs; Jb_idx++) {
-          tval += C[Ia_idx][Jb_idx] * F[Jb_idx];
+          tval += C[Ia_idx][Jb_idx] * Ft[Jb_idx];
           }
        S[Ia_idx][Ib_idx] += tval;
        }
@@ -146,7 +180,7 @@ void s1_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
     /* need to improve mem access pattern here! Above vers may be better! */
     /* min op cnt may also be better */
     for (Jb_idx = 0; Jb_idx < Jb_list_nbs; Jb_idx++) {
-      if ((tval = F[Jb_idx]) == 0.0) continue;
+      if ((tval = Ft[Jb_idx]) == 0.0) continue;
 
 #ifdef USE_BLAS
       C_DAXPY(nas, tval, (C[0] + Jb_idx), Jb_list_nbs, (S[0] + Ib_idx), nbs);
@@ -184,19 +218,31 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist,
                    double **C, double **S, double *oei, double *tei, double *F,
                    int nlists, int nas, int nbs, int Ib_list, int Jb_list,
                    int Jb_list_nbs) {
-  struct stringwr *Ib, *Kb;
-  size_t Ia_idx, Ib_idx, Kb_idx, Jb_idx;
-  size_t Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex;
-  size_t *Ibridx, *Kbridx;
-  int *Ibij, *Kbij, *Iboij, *Kboij;
-  signed char *Ibsgn, *Kbsgn;
-  int ij, kl, ijkl, oij, okl;
-  double Kb_sgn, Jb_sgn;
-  double tval;
+  /* Each I_b only updates its own column of S, so the I_b strings are
+     shared out over threads, each with a private F */
+  int nthreads = sigma_nthreads(nbs);
+  std::vector<double> Fthr((size_t)(nthreads - 1) * Jb_list_nbs);
 
   /* loop over I_b */
-  for (Ib = betlist[Ib_list], Ib_idx = 0; Ib_idx < nbs; Ib_idx++, Ib++) {
-    zero_arr(F, Jb_list_nbs);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for (size_t Ib_idx = 0; Ib_idx < nbs; Ib_idx++) {
+    struct stringwr *Ib, *Kb;
+    size_t Ia_idx, Kb_idx, Jb_idx;
+    size_t Ibcnt, Kbcnt, Kb_list, Ib_ex, Kb_ex;
+    size_t *Ibridx, *Kbridx;
+    int *Ibij, *Kbij, *Iboij, *Kboij;
+    signed char *Ibsgn, *Kbsgn;
+    int ij, kl, ijkl, oij, okl;
+    double Kb_sgn, Jb_sgn;
+    double tval;
+
+    Ib = betlist[Ib_list] + Ib_idx;
+    double *Ft = F;
+#ifdef _OPENMP
+    int thread = omp_get_thread_num();
+    if (thread) Ft = Fthr.data() + (size_t)(thread - 1) * Jb_list_nbs;
+#endif
+    zero_arr(Ft, Jb_list_nbs);
 
     /* loop over excitations E^b_{kl} from |B(I_b)> */
     for (Kb_list = 0; Kb_list < nlists; Kb_list++) {
@@ -214,7 +260,7 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist,
         /* B(K_b) = sgn(kl) * E^b_{kl} |B(I_b)> */
         Kb = betlist[Kb_list] + Kb_idx;
         /* note okl on next line, not kl */
-        if (Kb_list == Jb_list) F[Kb_idx] += Kb_sgn * oei[okl];
+        if (Kb_list == Jb_list) Ft[Kb_idx] += Kb_sgn * oei[okl];
 
         /* loop over excitations E^b_{ij} from |B(K_b)> */
         /* Jb_list pre-determined because of C blocking */
@@ -230,9 +276,9 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist,
           oij = *Kboij++;
           ijkl = INDEX(ij, kl);
           if (oij > okl)
-            F[Jb_idx] += Kb_sgn * Jb_sgn * tei[ijkl];
+            Ft[Jb_idx] += Kb_sgn * Jb_sgn * tei[ijkl];
           else if (oij == okl)
-            F[Jb_idx] += 0.5 * Kb_sgn * Jb_sgn * tei[ijkl];
+            Ft[Jb_idx] += 0.5 * Kb_sgn * Jb_sgn * tei[ijkl];
         }
       } /* end loop over Ib excitations */
     }   /* end loop over Kb_list */
@@ -241,7 +287,7 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist,
     for (Ia_idx=0; Ia_idx < nas; Ia_idx++) {
        tval = 0.0;
        for (Jb_idx=0; Jb_idx < Jb_list_nbs; Jb_idx++) {
-          tval += C[Ia_idx][Jb_idx] * F[Jb_idx];
+          tval += C[Ia_idx][Jb_idx] * Ft[Jb_idx];
           }
        S[Ia_idx][Ib_idx] += tval;
        }
@@ -250,7 +296,7 @@ void s1_block_vras(struct stringwr **alplist, struct stringwr **betlist,
     /* need to improve mem access pattern here! Above vers may be better!  */
     /* min op cnt may also be better */
     for (Jb_idx = 0; Jb_idx < Jb_list_nbs; Jb_idx++) {
-      if ((tval = F[Jb_idx]) == 0.0) continue;
+      if ((tval = Ft[Jb_idx]) == 0.0) continue;
 
 #ifdef USE_BLAS
       C_DAXPY(nas, tval, (C[0] + Jb_idx), Jb_list_nbs, (S[0] + Ib_idx), nbs);
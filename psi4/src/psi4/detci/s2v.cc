@@ -39,17 +39,23 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
 extern void b2brepl(unsigned char **occs, int *Jcnt, int **Jij, int **Joij,
                     int **Jridx, signed char **Jsgn, struct olsen_graph *Graph,
                     int Ilist, int Jlist, int len, struct calcinfo *Cinfo);
+extern int sigma_nthreads(int nwork);
 
 #define INDEX(i, j) ((i > j) ? (ioff[(i)] + (j)) : (ioff[(j)] + (i)))
 
@@ -70,22 +76,34 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
                    double **C, double **S, double *oei, double *tei, double *F,
                    int nlists, int nas, int nbs, int Ia_list, int Ja_list,
                    int Ja_list_nas) {
-  struct stringwr *Ia, *Ka;
-  size_t Ia_idx, Ib_idx, Ka_idx, Ja_idx;
-  size_t Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex;
-  size_t *Iaridx, *Karidx;
-  int *Iaij, *Kaij;
-  signed char *Iasgn, *Kasgn;
-  int ij, kl, ijkl;
-  double Ka_sgn, Ja_sgn;
-  double tval;
-  double *Sptr, *Cptr;
+  /* Each I_a only updates its own row of S, so the I_a strings are
+     shared out over threads, each with a private F */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Fthr((size_t)(nthreads - 1) * Ja_list_nas);
 
   /* loop over all alpha strings Ia that belong to list Ia_list (irrep, block
    * of alpha strings) */
-  for (Ia = alplist[Ia_list], Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for (size_t Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+    struct stringwr *Ia, *Ka;
+    size_t Ib_idx, Ka_idx, Ja_idx;
+    size_t Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex;
+    size_t *Iaridx, *Karidx;
+    int *Iaij, *Kaij;
+    signed char *Iasgn, *Kasgn;
+    int ij, kl, ijkl;
+    double Ka_sgn, Ja_sgn;
+    double tval;
+    double *Sptr, *Cptr;
+
+    Ia = alplist[Ia_list] + Ia_idx;
+    double *Ft = F;
+#ifdef _OPENMP
+    int thread = omp_get_thread_num();
+    if (thread) Ft = Fthr.data() + (size_t)(thread - 1) * Ja_list_nas;
+#endif
     Sptr = S[Ia_idx];
-    zero_arr(F, Ja_list_nas);
+    zero_arr(Ft, Ja_list_nas);
 
     /* loop over excitations E^a_{kl} from |A(I_a)> */
 
@@ -105,7 +123,7 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
 
         /* A(K_a) = sgn(kl) * E^a_{kl} |A(I_a)> */
         Ka = alplist[Ka_list] + Ka_idx;
-        if (Ka_list == Ja_list) F[Ka_idx] += Ka_sgn * oei[kl];
+        if (Ka_list == Ja_list) Ft[Ka_idx] += Ka_sgn * oei[kl];
 
         /* loop over excitations E^a_{ij} from |A(K_a)> */
         /* Ja_list pre-determined because of C blocking */
@@ -118,7 +136,7 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
           Ja_sgn = (double)*Kasgn++;
           ij = *Kaij++;
           ijkl = INDEX(ij, kl);
-          F[Ja_idx] += 0.5 * Ka_sgn * Ja_sgn * tei[ijkl];
+          Ft[Ja_idx] += 0.5 * Ka_sgn * Ja_sgn * tei[ijkl];
         }
       } /* end loop over Ia excitations */
     }   /* end loop over Ka_list */
@@ -127,14 +145,14 @@ void s2_block_vfci(struct stringwr **alplist, struct stringwr **betlist,
     for (Ib_idx=0; Ib_idx < nbs; Ib_idx++) {
        tval = 0.0;
        for (Ja_idx=0; Ja_idx < Ja_list_nas; Ja_idx++) {
-          tval += C[Ja_idx][Ib_idx] * F[Ja_idx];
+          tval += C[Ja_idx][Ib_idx] * Ft[Ja_idx];
           }
        S[Ia_idx][Ib_idx] += tval;
        }
     */
 
     for (Ja_idx = 0; Ja_idx < Ja_list_nas; Ja_idx++) {
-      if ((tval = F[Ja_idx]) == 0.0) continue;
+      if ((tval = Ft[Ja_idx]) == 0.0) continue;
       Cptr = C[Ja_idx];
 
 #ifdef USE_BLAS
@@ -172,21 +190,33 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist,
                    double **C, double **S, double *oei, double *tei, double *F,
                    int nlists, int nas, int nbs, int Ia_list, int Ja_list,
                    int Ja_list_nas) {
-  struct stringwr *Ia, *Ka;
-  size_t Ia_idx, Ib_idx, Ka_idx, Ja_idx;
-  size_t Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex;
-  size_t *Iaridx, *Karidx;
-  int *Iaij, *Kaij, *Iaoij, *Kaoij;
-  signed char *Iasgn, *Kasgn;
-  int ij, kl, ijkl, oij, okl;
-  double Ka_sgn, Ja_sgn;
-  double tval;
-  double *Sptr, *Cptr;
+  /* Each I_a only updates its own row of S, so the I_a strings are
+     shared out over threads, each with a private F */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Fthr((size_t)(nthreads - 1) * Ja_list_nas);
 
   /* loop over I_a */
-  for (Ia = alplist[Ia_list], Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for (size_t Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+    struct stringwr *Ia, *Ka;
+    size_t Ib_idx, Ka_idx, Ja_idx;
+    size_t Iacnt, Kacnt, Ka_list, Ia_ex, Ka_ex;
+    size_t *Iaridx, *Karidx;
+    int *Iaij, *Kaij, *Iaoij, *Kaoij;
+    signed char *Iasgn, *Kasgn;
+    int ij, kl, ijkl, oij, okl;
+    double Ka_sgn, Ja_sgn;
+    double tval;
+    double *Sptr, *Cptr;
+
+    Ia = alplist[Ia_list] + Ia_idx;
+    double *Ft = F;
+#ifdef _OPENMP
+    int thread = omp_get_thread_num();
+    if (thread) Ft = Fthr.data() + (size_t)(thread - 1) * Ja_list_nas;
+#endif
     Sptr = S[Ia_idx];
-    zero_arr(F, Ja_list_nas);
+    zero_arr(Ft, Ja_list_nas);
 
     /* loop over excitations E^a_{kl} from |A(I_a)> */
     for (Ka_list = 0; Ka_list < nlists; Ka_list++) {
@@ -204,7 +234,7 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist,
         /* A(K_a) = sgn(kl) * E^a_{kl} |A(I_a)> */
         Ka = alplist[Ka_list] + Ka_idx;
         /* note okl on next line, not kl */
-        if (Ka_list == Ja_list) F[Ka_idx] += Ka_sgn * oei[okl];
+        if (Ka_list == Ja_list) Ft[Ka_idx] += Ka_sgn * oei[okl];
 
         /* loop over excitations E^a_{ij} from |A(K_a)> */
         /* Ja_list pre-determined because of C blocking */
@@ -220,9 +250,9 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist,
           oij = *Kaoij++;
           ijkl = INDEX(ij, kl);
           if (oij > okl)
-            F[Ja_idx] += Ka_sgn * Ja_sgn * tei[ijkl];
+            Ft[Ja_idx] += Ka_sgn * Ja_sgn * tei[ijkl];
           else if (oij == okl)
-            F[Ja_idx] += 0.5 * Ka_sgn * Ja_sgn * tei[ijkl];
+            Ft[Ja_idx] += 0.5 * Ka_sgn * Ja_sgn * tei[ijkl];
         }
       } /* end loop over Ia excitations */
     }   /* end loop over Ka_list */
@@ -231,14 +261,14 @@ void s2_block_vras(struct stringwr **alplist, struct stringwr **betlist,
     for (Ib_idx=0; Ib_idx < nbs; Ib_idx++) {
        tval = 0.0;
        for (Ja_idx=0; Ja_idx < Ja_list_nas; Ja_idx++) {
-          tval += C[Ja_idx][Ib_idx] * F[Ja_idx];
+          tval += C[Ja_idx][Ib_idx] * Ft[Ja_idx];
           }
        S[Ia_idx][Ib_idx] += tval;
        }
     */
 
     for (Ja_idx = 0; Ja_idx < Ja_list_nas; Ja_idx++) {
-      if ((tval = F[Ja_idx]) == 0.0) continue;
+      if ((tval = Ft[Ja_idx]) == 0.0) continue;
       Cptr = C[Ja_idx];
 #ifdef USE_BLAS
       C_DAXPY(nbs, tval, Cptr, 1, Sptr, 1);
@@ -36,11 +36,16 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/detci/structs.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 namespace detci {
 
@@ -48,6 +53,7 @@ int form_ilist(struct stringwr *alplist, int Ja_list, int nas, int kl, int *L,
                int *R, double *Sgn);
 int form_ilist_rotf(int *Cnt, int **Ridx, signed char **Sn, int **Ij, int nas,
                     int kl, int *L, int *R, double *Sgn);
+extern int sigma_nthreads(int nwork);
 
 #define INDEX(i, j) ((i > j) ? (ioff[(i)] + (j)) : (ioff[(j)] + (i)))
 
@@ -79,6 +85,11 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
   double *Tptr;
   int npthreads, rc, status;
 
+  /* The gather and the I_a loop below are shared out over threads, each
+     I_a only updates its own row of S and gets a private V */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Vthr((size_t)(nthreads - 1) * nbs);
+
   /* loop over i, j */
   for (i = 0; i < norbs; i++) {
     for (j = 0; j <= i; j++) {
@@ -92,6 +103,7 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
       Tptr = tei + ioff[ij];
 
       /* gather operation */
+#pragma omp parallel for num_threads(nthreads) private(CprimeI0, CI0, J, tval)
       for (I = 0; I < cnas; I++) {
         CprimeI0 = Cprime[I];
         CI0 = C[I];
@@ -101,14 +113,22 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
         }
       }
 
-      for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) \
+    private(Ia, Ia_ex, kl, I, J, RJ, tval, VS, CprimeI0, Jacnt, Iaij, Iaridx, Iasgn)
+      for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        Ia = alplist + Ia_idx;
+        double *Vt = V;
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+        if (thread) Vt = Vthr.data() + (size_t)(thread - 1) * nbs;
+#endif
         /* loop over excitations E^a_{kl} from |A(I_a)> */
         Jacnt = Ia->cnt[Ja_list];
         Iaridx = Ia->ridx[Ja_list];
         Iasgn = Ia->sgn[Ja_list];
         Iaij = Ia->ij[Ja_list];
 
-        zero_arr(V, jlen);
+        zero_arr(Vt, jlen);
         for (Ia_ex = 0; Ia_ex < Jacnt && (kl = *Iaij++) <= ij; Ia_ex++) {
           I = *Iaridx++;
           tval = *Iasgn++;
@@ -117,10 +137,10 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
           CprimeI0 = Cprime[I];
 
 #ifdef USE_BS
-          C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+          C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
           for (J = 0; J < jlen; J++) {
-            V[J] += VS * CprimeI0[J];
+            Vt[J] += VS * CprimeI0[J];
           }
 #endif
         }
@@ -128,7 +148,7 @@ void s3_block_vdiag(struct stringwr *alplist, struct stringwr *betlist,
         /* scatter */
         for (J = 0; J < jlen; J++) {
           RJ = R[J];
-          S[Ia_idx][RJ] += V[J];
+          S[Ia_idx][RJ] += Vt[J];
         }
 
       } /* end loop over Ia */
@@ -158,6 +178,11 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
   signed char *Iasgn;
   double *Tptr;
 
+  /* The gather and the I_a loop below are shared out over threads, each
+     I_a only updates its own row of S and gets a private V */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Vthr((size_t)(nthreads - 1) * nbs);
+
   /* loop over i, j */
   for (i = 0; i < norbs; i++) {
     for (j = 0; j <= i; j++) {
@@ -170,6 +195,7 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
       Tptr = tei + ioff[ij];
 
       /* gather operation */
+#pragma omp parallel for num_threads(nthreads) private(CprimeI0, CI0, J, tval)
       for (I = 0; I < cnas; I++) {
         CprimeI0 = Cprime[I];
         CI0 = C[I];
@@ -180,14 +206,22 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
       }
 
       timer_on("CIWave: s3_mt");
-      for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) \
+    private(Ia, Ia_ex, kl, ijkl, I, J, RJ, tval, VS, CprimeI0, Jacnt, Iaij, Iaridx, Iasgn)
+      for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        Ia = alplist + Ia_idx;
+        double *Vt = V;
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+        if (thread) Vt = Vthr.data() + (size_t)(thread - 1) * nbs;
+#endif
         /* loop over excitations E^a_{kl} from |A(I_a)> */
         Jacnt = Ia->cnt[Ja_list];
         Iaridx = Ia->ridx[Ja_list];
         Iasgn = Ia->sgn[Ja_list];
         Iaij = Ia->ij[Ja_list];
 
-        zero_arr(V, jlen);
+        zero_arr(Vt, jlen);
 
         for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
           kl = *Iaij++;
@@ -198,10 +232,10 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
           CprimeI0 = Cprime[I];
 
 #ifdef UBLAS
-          C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+          C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
           for (J = 0; J < jlen; J++) {
-            V[J] += VS * CprimeI0[J];
+            Vt[J] += VS * CprimeI0[J];
           }
 #endif
         }
@@ -209,7 +243,7 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
         /* scatter */
         for (J = 0; J < jlen; J++) {
           RJ = R[J];
-          S[Ia_idx][RJ] += V[J];
+          S[Ia_idx][RJ] += Vt[J];
         }
 
       } /* end loop over Ia */
@@ -278,6 +312,11 @@ void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
   signed char *Iasgn;
   double *Tptr;
 
+  /* The gather and the I_a loop below are shared out over threads, each
+     I_a only updates its own row of S and gets a private V */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Vthr((size_t)(nthreads - 1) * nbs);
+
   /* loop over i, j */
   for (i = 0; i < norbs; i++) {
     for (j = 0; j <= i; j++) {
@@ -290,6 +329,7 @@ void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
       Tptr = tei + ioff[ij];
 
       /* gather operation */
+#pragma omp parallel for num_threads(nthreads) private(CprimeI0, CI0, J, tval)
       for (I = 0; I < cnas; I++) {
         CprimeI0 = Cprime[I];
         CI0 = C[I];
@@ -300,14 +340,21 @@ void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
       }
 
       /* loop over Ia */
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) \
+    private(Ia_ex, kl, I, J, RJ, tval, VS, CprimeI0, Jacnt, Iaij, Iaridx, Iasgn)
       for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        double *Vt = V;
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+        if (thread) Vt = Vthr.data() + (size_t)(thread - 1) * nbs;
+#endif
         /* loop over excitations E^a_{kl} from |A(I_a)> */
         Jacnt = Cnt[0][Ia_idx];
         Iaridx = Ridx[0][Ia_idx];
         Iasgn = Sn[0][Ia_idx];
         Iaij = Ij[0][Ia_idx];
 
-        zero_arr(V, jlen);
+        zero_arr(Vt, jlen);
 
         /* rotf doesn't yet ensure kl's in order */
         for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
@@ -320,10 +367,10 @@ void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
           CprimeI0 = Cprime[I];
 
 #ifdef USE_BLAS
-          C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+          C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
           for (J = 0; J < jlen; J++) {
-            V[J] += VS * CprimeI0[J];
+            Vt[J] += VS * CprimeI0[J];
           }
 #endif
         }
@@ -331,7 +378,7 @@ void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
         /* scatter */
         for (J = 0; J < jlen; J++) {
           RJ = R[J];
-          S[Ia_idx][RJ] += V[J];
+          S[Ia_idx][RJ] += Vt[J];
         }
 
       } /* end loop over Ia */
@@ -361,6 +408,11 @@ void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
   signed char *Iasgn;
   double *Tptr;
 
+  /* The gather and the I_a loop below are shared out over threads, each
+     I_a only updates its own row of S and gets a private V */
+  int nthreads = sigma_nthreads(nas);
+  std::vector<double> Vthr((size_t)(nthreads - 1) * nbs);
+
   /* loop over i, j */
   for (i = 0; i < norbs; i++) {
     for (j = 0; j <= i; j++) {
@@ -373,6 +425,7 @@ void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
       Tptr = tei + ioff[ij];
 
       /* gather operation */
+#pragma omp parallel for num_threads(nthreads) private(CprimeI0, CI0, J, tval)
       for (I = 0; I < cnas; I++) {
         CprimeI0 = Cprime[I];
         CI0 = C[I];
@@ -383,14 +436,21 @@ void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
       }
 
       /* loop over Ia */
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) \
+    private(Ia_ex, kl, ijkl, I, J, RJ, tval, VS, CprimeI0, Jacnt, Iaij, Iaridx, Iasgn)
       for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+        double *Vt = V;
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+        if (thread) Vt = Vthr.data() + (size_t)(thread - 1) * nbs;
+#endif
         /* loop over excitations E^a_{kl} from |A(I_a)> */
         Jacnt = Cnt[0][Ia_idx];
         Iaridx = Ridx[0][Ia_idx];
         Iasgn = Sn[0][Ia_idx];
         Iaij = Ij[0][Ia_idx];
 
-        zero_arr(V, jlen);
+        zero_arr(Vt, jlen);
 
         for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
           kl = *Iaij++;
@@ -401,10 +461,10 @@ void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
           CprimeI0 = Cprime[I];
 
 #ifdef USE_BLAS
-          C_DAXPY(jlen, VS, CprimeI0, 1, V, 1);
+          C_DAXPY(jlen, VS, CprimeI0, 1, Vt, 1);
 #else
           for (J = 0; J < jlen; J++) {
-            V[J] += VS * CprimeI0[J];
+            Vt[J] += VS * CprimeI0[J];
           }
 #endif
         }
@@ -412,7 +472,7 @@ void s3_block_vrotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
         /* scatter */
         for (J = 0; J < jlen; J++) {
           RJ = R[J];
-          S[Ia_idx][RJ] += V[J];
+          S[Ia_idx][RJ] += Vt[J];
         }
 
       } /* end loop over Ia */
@@ -46,12 +46,19 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/detci/structs.h"
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
+#include "psi4/libpsi4util/exception.h"
+#ifdef HAVE_MPI
+#include <mpi.h>
+#include <algorithm>
+#include <climits>
+#endif
 
 namespace psi { namespace detci {
 
@@ -124,6 +131,54 @@ extern void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2],
    double **Cprime, double *F, double *V, double *Sgn, int *L, int *R,
    int norbs, int *orbsym);
 
+namespace {
+/*
+** With SIGMA_DISTRIBUTED, every MPI rank runs the same Davidson iterations
+** and holds the whole C vector, so each sigma block is built on one rank
+** only (dealt out round-robin in the order the blocks are visited) and the
+** finished blocks are passed to the other ranks. A build without MPI, or
+** an unset option, gives a single rank.
+*/
+void sigma_ranks(int distributed, int &rank, int &nrank)
+{
+   rank = 0;
+   nrank = 1;
+   if (!distributed) return;
+#ifdef HAVE_MPI
+   int initialized = 0;
+   MPI_Initialized(&initialized);
+   if (!initialized)
+      throw PSIEXCEPTION("SIGMA_DISTRIBUTED: MPI has not been initialized (e.g., import mpi4py before psi4).");
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+#endif
+}
+
+/* Copy n doubles (and the block's nonzero flag) from rank root to all ranks */
+void sigma_share(double *x, size_t n, int *did, int root)
+{
+#ifdef HAVE_MPI
+   for (size_t offset = 0; offset < n; offset += INT_MAX) {
+      int count = (int) std::min(n - offset, (size_t) INT_MAX);
+      MPI_Bcast(x + offset, count, MPI_DOUBLE, root, MPI_COMM_WORLD);
+      }
+   MPI_Bcast(did, 1, MPI_INT, root, MPI_COMM_WORLD);
+#endif
+}
+
+/* Sum n doubles and the n_did nonzero-block flags over all ranks */
+void sigma_sum(double *x, size_t n, int *did, int n_did)
+{
+#ifdef HAVE_MPI
+   for (size_t offset = 0; offset < n; offset += INT_MAX) {
+      int count = (int) std::min(n - offset, (size_t) INT_MAX);
+      MPI_Allreduce(MPI_IN_PLACE, x + offset, count, MPI_DOUBLE, MPI_SUM,
+         MPI_COMM_WORLD);
+      }
+   MPI_Allreduce(MPI_IN_PLACE, did, n_did, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+}
+}
 
 
 /*
@@ -363,10 +418,13 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
    int cairr, cbirr, sbirr;
    int did_sblock = 0;
    int phase;
+   int rank, nrank, owner;
 
    if (!Parameters_->Ms0) phase = 1;
    else phase = ((int) Parameters_->S % 2) ? -1 : 1;
 
+   sigma_ranks(Parameters_->sigma_distributed, rank, nrank);
+
    /* this does a sigma subblock at a time: icore==0 */
    for (buf=0; buf<S.buf_per_vect_; buf++) {
       S.zero();
@@ -378,8 +436,9 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
       nbs = S.Ib_size_[sblock];
       sbirr = sbc / BetaG_->subgr_per_irrep;
       if (SigmaData_->sprime != NULL) set_row_ptrs(nas, nbs, SigmaData_->sprime);
+      owner = buf % nrank;
 
-      for (cbuf=0; cbuf<C.buf_per_vect_; cbuf++) {
+      for (cbuf=0; cbuf<C.buf_per_vect_ && owner==rank; cbuf++) {
          do_cblock=0; do_cblock2=0;
          cblock=C.buf2blk_[cbuf];
          cblock2 = -1;
@@ -430,6 +489,10 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
 
          } /* end loop over c buffers */
 
+      if (nrank > 1)
+         sigma_share(S.blocks_[sblock][0], (size_t) nas * (size_t) nbs,
+            &did_sblock, owner);
+
       if (did_sblock) {
          S.set_zero_block(sblock, 0);
          if (S.Ms0_) S.set_zero_block(S.decode_[sbc][sac], 0);
@@ -480,10 +543,15 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
    int sbirr, cbirr;
    int did_sblock = 0;
    int phase;
+   int rank, nrank, nvisited = 0;
 
    if (!Parameters_->Ms0) phase = 1;
    else phase = ((int) Parameters_->S % 2) ? -1 : 1;
 
+   sigma_ranks(Parameters_->sigma_distributed, rank, nrank);
+   /* blocks built here, and (after the sum) blocks built anywhere */
+   std::vector<int> mine(S.num_blocks_, 0), did(S.num_blocks_, 0);
+
    S.zero();
    C.read(C.cur_vect_, 0);
 
@@ -497,6 +565,8 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
       nbs = S.Ib_size_[sblock];
       if (nas==0 || nbs==0) continue;
       if (S.Ms0_ && sbc > sac) continue;
+      if ((nvisited++) % nrank != rank) continue;
+      mine[sblock] = 1;
       sbirr = sbc / BetaG_->subgr_per_irrep;
       if (SigmaData_->sprime != NULL) set_row_ptrs(nas, nbs, SigmaData_->sprime);
 
@@ -519,6 +589,7 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
          } /* end loop over c blocks */
 
       if (did_sblock) S.set_zero_block(sblock, 0);
+      did[sblock] = did_sblock;
 
       if (S.Ms0_ && (sac==sbc))
          transp_sigma(S.blocks_[sblock], nas, nbs, phase);
@@ -526,6 +597,21 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
          phase);
       } /* end loop over sigma blocks */
 
+   /* other ranks' blocks are zero here, so the sum hands them over */
+   if (nrank > 1) {
+      sigma_sum(S.buffer_, S.buf_size_[0], did.data(), S.num_blocks_);
+      for (sblock=0; sblock<S.num_blocks_; sblock++) {
+         sac = S.Ia_code_[sblock];
+         sbc = S.Ib_code_[sblock];
+         if (mine[sblock] || S.Ia_size_[sblock]==0 || S.Ib_size_[sblock]==0)
+            continue;
+         if (S.Ms0_ && sbc > sac) continue;
+         if (did[sblock]) S.set_zero_block(sblock, 0);
+         H0block_gather(S.blocks_[sblock], sac, sbc, 1, Parameters_->Ms0,
+            phase);
+         }
+      }
+
       if (S.Ms0_) {
          if ((int) Parameters_->S % 2) S.symmetrize(-1.0, 0);
          else S.symmetrize(1.0, 0);
@@ -39,6 +39,8 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <algorithm>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
@@ -49,7 +51,6 @@ namespace psi { namespace detci {
 /* DEFINES */
 #define MIN0(a,b) (((a)<(b)) ? (a) : (b))
 #define MAX0(a,b) (((a)>(b)) ? (a) : (b))
-#define MAXIJ 100000
 
 
 /*
@@ -67,6 +68,27 @@ int *O, *U, *T ;
 int **Tij, **Toij, *Tcnt;
 size_t **Tidx;
 signed char **Tsgn;
+int *Torder;
+
+namespace {
+/* Bump allocator for the replacement lists. Strings live as long as the
+   process anyway, so chunks are taken and never handed back. */
+std::vector<char *> repl_chunks;
+size_t repl_used = 0, repl_size = 0;
+
+void *repl_arena_take(size_t bytes)
+{
+   bytes = (bytes + 7) & ~((size_t) 7);
+   if (repl_chunks.empty() || repl_used + bytes > repl_size) {
+      repl_size = std::max(bytes, (size_t) 4 * 1024 * 1024);
+      repl_chunks.push_back((char *) malloc(repl_size));
+      repl_used = 0;
+      }
+   void *ptr = repl_chunks.back() + repl_used;
+   repl_used += bytes;
+   return ptr;
+}
+}
 
 
 extern int subgr_lex_addr(struct level *head, int *occs, int nel, int norb);
@@ -380,12 +402,23 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs,
       }
 
    /* now write the info in the T matrices */
-   string->cnt = init_int_array(nlists);
-   string->ij = (int **) malloc(sizeof(int *) * nlists);
-   string->oij = (int **) malloc(sizeof(int *) * nlists);
-   string->ridx = (size_t **) malloc(sizeof(size_t *) * nlists);
-   string->sgn = (signed char **) malloc(sizeof(signed char *) * nlists);
-
+   /* All lists of a string go into one block from the arena, so the
+      replacements of neighbouring strings are adjacent when sigma walks them */
+   size_t total = 0;
+   for (i=0; i<nlists; i++) total += Tcnt[i];
+   char *block = (char *) repl_arena_take(
+      nlists * (sizeof(int *) * 2 + sizeof(size_t *) + sizeof(signed char *))
+      + total * (sizeof(size_t) + 2 * sizeof(int) + sizeof(signed char))
+      + nlists * sizeof(int));
+   string->ij = (int **) block;
+   string->oij = string->ij + nlists;
+   string->ridx = (size_t **) (string->oij + nlists);
+   string->sgn = (signed char **) (string->ridx + nlists);
+   size_t *ridx_pool = (size_t *) (string->sgn + nlists);
+   int *ij_pool = (int *) (ridx_pool + total);
+   int *oij_pool = ij_pool + total;
+   string->cnt = oij_pool + total;
+   signed char *sgn_pool = (signed char *) (string->cnt + nlists);
 
    for (i=0; i<nlists; i++) {
       string->cnt[i] = cnt = Tcnt[i];
@@ -394,23 +427,26 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs,
       string->ridx[i] = NULL;
       string->sgn[i] = NULL;
       if (cnt) {
-         string->ij[i] = init_int_array(cnt);
-         string->oij[i] = init_int_array(cnt);
-         string->ridx[i] = (size_t *) malloc(cnt *
-            sizeof(size_t));
-         string->sgn[i] = (signed char *) malloc(cnt *
-            sizeof(signed char));
-
+         string->ij[i] = ij_pool;
+         string->oij[i] = oij_pool;
+         string->ridx[i] = ridx_pool;
+         string->sgn[i] = sgn_pool;
+         ij_pool += cnt;
+         oij_pool += cnt;
+         ridx_pool += cnt;
+         sgn_pool += cnt;
+
+         /* ascending ij; of equal ij the later entry comes first */
+         for (k=0; k<cnt; k++) Torder[k] = k;
+         int *Tij_i = Tij[i];
+         std::sort(Torder, Torder + cnt, [Tij_i](int a, int b) {
+            return Tij_i[a] < Tij_i[b] || (Tij_i[a] == Tij_i[b] && a > b); });
          for (k=0; k<cnt; k++) {
-            for (l=0,p=0,q=MAXIJ; l<cnt; l++) {
-               ij = Tij[i][l];
-               if (ij <= q) { q = ij; p = l; }
-               }
+            p = Torder[k];
             string->ij[i][k] = Tij[i][p];
             string->oij[i][k] = Toij[i][p];
             string->ridx[i][k] = Tidx[i][p];
             string->sgn[i][k] = Tsgn[i][p];
-            Tij[i][p] = MAXIJ;
             }
          }
       } /* end loop over i */
@@ -434,6 +470,7 @@ void init_stringwr_temps(int nel, int num_ci_orbs, int nsym)
    Toij = (int **) malloc(sizeof(int *) * nsym);
    Tidx = (size_t **) malloc(sizeof(size_t *) * nsym);
    Tsgn = (signed char **) malloc(sizeof(signed char *) * nsym);
+   Torder = init_int_array(maxcnt);
 
    for (i=0; i<nsym; i++) {
       Tij[i] = init_int_array(maxcnt);
@@ -452,6 +489,7 @@ void free_stringwr_temps(int nsym)
    free(U);
    free(T);
    free(Tcnt);
+   free(Torder);
    for (i=0; i<nsym; i++) {
       free(Tij[i]);
       free(Toij[i]);
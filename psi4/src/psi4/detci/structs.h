@@ -497,6 +497,7 @@ struct params {
                             0 = RAS subblock at a time
                             1 = Entire CI vector at a time
                             2 = Symmetry block at a time */
+   int sigma_distributed; /* build sigma blocks on separate MPI ranks? */
    int diag_method;  /* diagonalization method:
                             0 = RSP
                             1 = Olsen
@@ -42,6 +42,7 @@
 #include "psi4/libpsio/aiohandler.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -53,6 +54,27 @@
 
 namespace psi { namespace dfep2 {
 
+namespace {
+
+// For one fixed outer index, M[p][q * nE + e] holds (pq|E) type integrals.  Replaces each by
+// the pole strength (2 M[p][q] - M[q][p]) M[p][q], which does not depend on the energy.
+void pair_numerators(double** M, size_t n, size_t nE) {
+    for (size_t p = 0; p < n; p++) {
+        for (size_t q = 0; q <= p; q++) {
+            double* Mpq = M[p] + q * nE;
+            double* Mqp = M[q] + p * nE;
+            for (size_t e = 0; e < nE; e++) {
+                double x = Mpq[e];
+                double y = Mqp[e];
+                Mpq[e] = (2.0 * x - y) * x;
+                Mqp[e] = (2.0 * y - x) * y;
+            }
+        }
+    }
+}
+
+}  // namespace
+
 DFEP2Wavefunction::DFEP2Wavefunction(std::shared_ptr<Wavefunction> ref_wfn)
     : Wavefunction(Process::environment.options) {
     // Copy the wavefuntion then update
@@ -336,11 +358,12 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
 
     // ==> More Sizing <== /
 
-    size_t aaE_size = memory_doubles_ / nvir * nvir * nE;
+    // Half of the memory each for the excitation and de-excitation numerators
+    size_t aaE_size = std::max(memory_doubles_ / (2 * nvir * nvir * nE), (size_t)1);
     if (aaE_size > nocc) aaE_size = nocc;
     // aaE_size = 2;
 
-    size_t ooE_size = memory_doubles_ / nocc * nocc * nE;
+    size_t ooE_size = std::max(memory_doubles_ / (2 * nocc * nocc * nE), (size_t)1);
     if (ooE_size > nvir) ooE_size = nvir;
     // ooE_size = 2;
 
@@ -357,6 +380,38 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
         outfile->Printf("\n\n");
     }
 
+    // ==> Numerators <== /
+    // Only the denominators change from one iteration to the next, so the integrals are turned
+    // into numerators once, for all orbitals at a time.  Numerators that fit in memory stay
+    // there for every iteration; otherwise they replace the integrals on disk.
+
+    SharedMatrix I_ovvE(new Matrix("EP2 I_ovvE Numerators", aaE_size * nvir, nvir * nE));
+    SharedMatrix I_vooE(new Matrix("EP2 I_vooE Numerators", ooE_size * nocc, nocc * nE));
+    double** I_ovvEp = I_ovvE->pointer();
+    double** I_vooEp = I_vooE->pointer();
+
+    auto form_numerators = [&](const char* label, double** Ip, size_t nouter, size_t outer_size, size_t n) {
+        size_t nblock = 1 + ((nouter - 1) / outer_size);
+        psio_address addr = psio_get_address(PSIO_ZERO, 0);
+        for (size_t block = 0; block < nblock; block++) {
+            size_t size = std::min(outer_size, nouter - block * outer_size);
+            size_t bytes = sizeof(double) * size * n * n * nE;
+            psio_address block_addr = addr;
+            psio_->read(unit_, label, (char*)Ip[0], bytes, addr, &addr);
+
+            #pragma omp parallel for schedule(dynamic,1) num_threads(num_threads_)
+            for (size_t k = 0; k < size; k++) {
+                pair_numerators(Ip + k * n, n, nE);
+            }
+
+            if (nblock > 1) {
+                psio_->write(unit_, label, (char*)Ip[0], bytes, block_addr, &block_addr);
+            }
+        }
+    };
+    form_numerators("EP2 I_ovvE Integrals", I_ovvEp, nocc, aaE_size, nvir);
+    form_numerators("EP2 I_vooE Integrals", I_vooEp, nvir, ooE_size, nocc);
+
 
     // ==> Iterate <== /
     outfile->Printf("  ==> Iterations <==\n\n");
@@ -389,11 +444,9 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
 
 
         // => Excitations <= //
-        // sigma <= (Eabi - Ebai) * Eabi / (E - v - v + o)
+        // sigma <= (2 Eabi - Ebai) * Eabi / (E - v - v + o)
 
         ovvE_addr = psio_get_address(PSIO_ZERO, 0);
-        SharedMatrix I_ovvE(new Matrix(aaE_size * nvir, nvir * nE));
-        double** I_ovvEp = I_ovvE->pointer();
 
         for (size_t i_block = 0; i_block < aaE_nblocks; i_block++){
             size_t i_start = aaE_size * i_block;
@@ -402,22 +455,24 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
                 ib_size = nocc - i_start;
             }
 
-            psio_->read(unit_, "EP2 I_ovvE Integrals", (char*)I_ovvEp[0],
-                        (sizeof(double) * ib_size * nvir * nvir * nE), ovvE_addr, &ovvE_addr);
+            if (aaE_nblocks > 1) {
+                psio_->read(unit_, "EP2 I_ovvE Integrals", (char*)I_ovvEp[0],
+                            (sizeof(double) * ib_size * nvir * nvir * nE), ovvE_addr, &ovvE_addr);
+            }
 
             #pragma omp parallel for private(rank) schedule(dynamic,1) collapse(2) num_threads(num_threads_)
             for (size_t i = 0; i < ib_size; i++) {
-                for (size_t a = 0; a < nvir; a++) {
+                for (size_t b = 0; b < nvir; b++) {
                     #ifdef _OPENMP
                         rank = omp_get_thread_num();
                     #endif
+                    const double* numerp = I_ovvEp[i * nvir + b];
+                    double shift = eps_occ[i_start + i] - eps_vir[b];
                     # pragma omp simd collapse(2)
-                    for (size_t b = 0; b < nvir; b++) {
+                    for (size_t a = 0; a < nvir; a++) {
                         for (size_t e = 0; e < nE; e++) {
-                            double Eabi = I_ovvEp[i * nvir + b][a * nE + e];
-                            double Ebai = I_ovvEp[i * nvir + a][b * nE + e];
-                            double numer = (2.0 * Eabi - Ebai) * Eabi;
-                            double denom = (denom_E[e] - eps_vir[a] - eps_vir[b] + eps_occ[i_start + i]);
+                            double numer = numerp[a * nE + e];
+                            double denom = (denom_E[e] - eps_vir[a] + shift);
 
                             sigma_temps[rank][e] += numer / denom;
                             deriv_temps[rank][e] += numer / (denom * denom);
@@ -426,14 +481,11 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
                 }
             }
         }
-        I_ovvE.reset();
 
         // => De-excitations <= //
-        // sigma <= (Eija - Ejia) * Eija / (E - o - o + v)
+        // sigma <= (2 Eija - Ejia) * Eija / (E - o - o + v)
 
         vooE_addr = psio_get_address(PSIO_ZERO, 0);
-        SharedMatrix I_vooE(new Matrix(ooE_size * nocc, nocc * nE));
-        double** I_vooEp = I_vooE->pointer();
 
         for (size_t a_block = 0; a_block < ooE_nblocks; a_block++){
             size_t a_start = ooE_size * a_block;
@@ -442,22 +494,24 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
                 ab_size = nvir - a_start;
             }
 
-            psio_->read(unit_, "EP2 I_vooE Integrals", (char*)I_vooEp[0],
-                        sizeof(double) * ab_size * nocc * nocc * nE, vooE_addr, &vooE_addr);
+            if (ooE_nblocks > 1) {
+                psio_->read(unit_, "EP2 I_vooE Integrals", (char*)I_vooEp[0],
+                            sizeof(double) * ab_size * nocc * nocc * nE, vooE_addr, &vooE_addr);
+            }
 
             #pragma omp parallel for private(rank) schedule(dynamic,1) collapse(2) num_threads(num_threads_)
             for (size_t a = 0; a < ab_size; a++) {
-                for (size_t i = 0; i < nocc; i++) {
+                for (size_t j = 0; j < nocc; j++) {
                     #ifdef _OPENMP
                         rank = omp_get_thread_num();
                     #endif
+                    const double* numerp = I_vooEp[a * nocc + j];
+                    double shift = eps_vir[a_start + a] - eps_occ[j];
                     # pragma omp simd collapse(2)
-                    for (size_t j = 0; j < nocc; j++) {
+                    for (size_t i = 0; i < nocc; i++) {
                         for (size_t e = 0; e < nE; e++) {
-                            double Eija = I_vooEp[a * nocc + j][i * nE + e];
-                            double Ejia = I_vooEp[a * nocc + i][j * nE + e];
-                            double numer = (2.0 * Eija - Ejia) * Eija;
-                            double denom = (denom_E[e] - eps_occ[i] - eps_occ[j] + eps_vir[a_start + a]);
+                            double numer = numerp[i * nE + e];
+                            double denom = (denom_E[e] - eps_occ[i] + shift);
 
                             sigma_temps[rank][e] += numer / denom;
                             deriv_temps[rank][e] += numer / (denom * denom);
@@ -466,7 +520,6 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(s
                 }
             }
         }
-        I_vooE.reset();
 
         // Sum up thread data
         for (size_t i = 0; i < nE; i++) {
@@ -0,0 +1,233 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libmints/dimension.h"
+
+#include "psi4/psi4-dec.h"
+
+#include "mp2.h"
+
+namespace psi { namespace dfmp2 {
+
+namespace {
+
+/// Number of virtual NOs to keep in each irrep, from ACTIVE_NAT_ORBS, OCC_PERCENTAGE, or OCC_TOLERANCE
+Dimension fno_active_virtuals(SharedVector occ, const Dimension& navirpi, Options& options)
+{
+    int nirrep = navirpi.n();
+    Dimension nkeep(nirrep, "Retained virtuals per irrep");
+
+    if (options["ACTIVE_NAT_ORBS"].has_changed()) {
+        if ((int) options["ACTIVE_NAT_ORBS"].size() != nirrep)
+            throw PSIEXCEPTION("DFMP2: ACTIVE_NAT_ORBS needs one entry per irrep.");
+        for (int h = 0; h < nirrep; h++) {
+            nkeep[h] = options["ACTIVE_NAT_ORBS"][h].to_integer();
+            if (nkeep[h] < 0 || nkeep[h] > navirpi[h])
+                throw PSIEXCEPTION("DFMP2: ACTIVE_NAT_ORBS exceeds the number of active virtuals.");
+        }
+        outfile->Printf("    Using the user-specified number of virtual NOs\n\n");
+    } else if (options["OCC_PERCENTAGE"].has_changed()) {
+        // Keep the NOs with the largest occupations until the fraction is reached
+        std::vector<std::pair<double, int> > order;
+        double total = 0.0;
+        for (int h = 0; h < nirrep; h++) {
+            for (int a = 0; a < navirpi[h]; a++) {
+                order.push_back(std::make_pair(occ->get(h, a), h));
+                total += occ->get(h, a);
+            }
+        }
+        std::sort(order.begin(), order.end(), std::greater<std::pair<double, int> >());
+        double frac = options.get_double("OCC_PERCENTAGE") / 100.0;
+        double kept = 0.0;
+        for (size_t n = 0; n < order.size(); n++) {
+            if (kept / total >= frac) break;
+            kept += order[n].first;
+            nkeep[order[n].second]++;
+        }
+        outfile->Printf("    Cutoff for retaining NOs is %5.2lf%% occupancy\n\n", frac * 100.0);
+    } else {
+        double cutoff = options.get_double("OCC_TOLERANCE");
+        for (int h = 0; h < nirrep; h++) {
+            for (int a = 0; a < navirpi[h]; a++) {
+                if (occ->get(h, a) > cutoff) nkeep[h]++;
+            }
+        }
+        outfile->Printf("    Cutoff for significant NO occupancy: %5.3le\n\n", cutoff);
+    }
+
+    return nkeep;
+}
+
+}  // namespace
+
+/*
+ * Frozen natural orbitals from the DF-MP2 virtual-virtual density.
+ *
+ * The active virtuals of an RHF reference are rotated, irrep by irrep, to the
+ * natural orbitals of the unrelaxed DF-MP2 OPDM.  The NOs that are kept and the
+ * ones that are dropped are each semicanonicalized, and the dropped ones join
+ * the frozen virtuals.  The result is a copy of the reference, so any module
+ * that honors frzvpi() works in the truncated space.  The difference of the
+ * DF-MP2 correlation energies in the full and in the truncated space is left
+ * in "MP2 FNO CORRECTION".
+ */
+SharedWavefunction fno(SharedWavefunction ref_wfn, Options& options)
+{
+    if (options.get_str("REFERENCE") != "RHF")
+        throw PSIEXCEPTION("DFMP2: Frozen natural orbitals are only available for RHF references.");
+
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+
+    int nirrep = ref_wfn->nirrep();
+    Dimension nsopi = ref_wfn->nsopi();
+    Dimension doccpi = ref_wfn->doccpi();
+    Dimension frzvpi = ref_wfn->frzvpi();
+    Dimension navirpi = ref_wfn->nmopi() - doccpi - frzvpi;
+    SharedMatrix Ca = ref_wfn->Ca();
+    SharedVector eps = ref_wfn->epsilon_a();
+
+    // => DF-MP2 in the full virtual space <= //
+
+    std::shared_ptr<RDFMP2> mp2(new RDFMP2(ref_wfn, options, psio));
+    SharedMatrix Pc1 = mp2->compute_virtual_opdm();
+    double emp2_full = mp2->get_variable("MP2 CORRELATION ENERGY");
+
+    outfile->Printf("\n  ==> DF-MP2 Frozen Natural Orbitals <==\n\n");
+
+    // The C1 virtuals are sorted by energy, as in Wavefunction::C_subset_helper
+    std::vector<std::tuple<double, int, int> > order;
+    for (int h = 0; h < nirrep; h++) {
+        for (int a = 0; a < navirpi[h]; a++) {
+            order.push_back(std::tuple<double, int, int>(eps->get(h, doccpi[h] + a), a, h));
+        }
+    }
+    std::sort(order.begin(), order.end(), std::less<std::tuple<double, int, int> >());
+
+    SharedMatrix Pab(new Matrix("FNO Virtual OPDM", navirpi, navirpi));
+    for (size_t a = 0; a < order.size(); a++) {
+        int ha = std::get<2>(order[a]);
+        for (size_t b = 0; b < order.size(); b++) {
+            if (std::get<2>(order[b]) != ha) continue;
+            Pab->set(ha, std::get<1>(order[a]), std::get<1>(order[b]), Pc1->get(a, b));
+        }
+    }
+
+    SharedMatrix U(new Matrix("FNO Eigenvectors", navirpi, navirpi));
+    SharedVector occ(new Vector("FNO Occupations", navirpi));
+    Pab->diagonalize(U, occ, descending);
+
+    Dimension nkeep = fno_active_virtuals(occ, navirpi, options);
+
+    // => Semicanonicalize the kept and the dropped NOs <= //
+
+    SharedMatrix Cno = Ca->clone();
+    SharedVector epsno(eps->clone());
+    for (int h = 0; h < nirrep; h++) {
+        int nv = navirpi[h];
+        int nso = nsopi[h];
+        if (!nv || !nso) continue;
+        double** Cp = Ca->pointer(h);
+        double** Cnop = Cno->pointer(h);
+        double** Up = U->pointer(h);
+        int ncol = Ca->colspi()[h];
+        int blocks[2][2] = {{0, nkeep[h]}, {nkeep[h], nv - nkeep[h]}};
+
+        for (int block = 0; block < 2; block++) {
+            int start = blocks[block][0];
+            int n = blocks[block][1];
+            if (!n) continue;
+
+            // The virtual Fock matrix is diagonal in the canonical orbitals
+            SharedMatrix F(new Matrix("F", n, n));
+            double** Fp = F->pointer();
+            for (int k = 0; k < n; k++) {
+                for (int l = 0; l <= k; l++) {
+                    double val = 0.0;
+                    for (int a = 0; a < nv; a++)
+                        val += Up[a][start + k] * eps->get(h, doccpi[h] + a) * Up[a][start + l];
+                    Fp[k][l] = Fp[l][k] = val;
+                }
+            }
+            SharedMatrix W(new Matrix("W", n, n));
+            SharedVector e(new Vector("e", n));
+            F->diagonalize(W, e, ascending);
+
+            // V = U[:, block] W, then C_NO = C_vir V
+            SharedMatrix V(new Matrix("V", nv, n));
+            C_DGEMM('N', 'N', nv, n, n, 1.0, &Up[0][start], nv, W->pointer()[0], n, 0.0, V->pointer()[0], n);
+            C_DGEMM('N', 'N', nso, n, nv, 1.0, &Cp[0][doccpi[h]], ncol, V->pointer()[0], n, 0.0,
+                    &Cnop[0][doccpi[h] + start], ncol);
+            for (int k = 0; k < n; k++) epsno->set(h, doccpi[h] + start + k, e->get(k));
+        }
+    }
+
+    int nvir = navirpi.sum();
+    int nvir_no = nkeep.sum();
+    outfile->Printf("    Number of virtual orbitals in original space:  %5d\n", nvir);
+    outfile->Printf("    Number of virtual orbitals in truncated space: %5d\n\n", nvir_no);
+
+    SharedWavefunction wfn(new Wavefunction(options));
+    wfn->deep_copy(ref_wfn);
+    wfn->Ca()->copy(Cno);
+    wfn->Cb()->copy(Cno);
+    wfn->epsilon_a()->copy(*epsno);
+    wfn->epsilon_b()->copy(*epsno);
+    wfn->set_frzvpi(frzvpi + navirpi - nkeep);
+
+    // => DF-MP2 in the truncated virtual space <= //
+
+    double emp2_trunc = 0.0;
+    if (nvir_no) {
+        std::shared_ptr<RDFMP2> mp2_trunc(new RDFMP2(wfn, options, psio));
+        mp2_trunc->compute_energy();
+        emp2_trunc = mp2_trunc->get_variable("MP2 CORRELATION ENERGY");
+    }
+
+    double delta = emp2_full - emp2_trunc;
+    outfile->Printf("    MP2 FNO correction:              %20.12lf\n\n", delta);
+
+    wfn->set_variable("MP2 FNO CORRECTION", delta);
+    Process::environment.globals["MP2 FNO CORRECTION"] = delta;
+
+    return wfn;
+}
+
+}}
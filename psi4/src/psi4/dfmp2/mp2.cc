@@ -33,6 +33,8 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions_python.h"
 #include "psi4/lib3index/3index.h"
+#include "psi4/lib3index/df_helper.h"
+#include "psi4/lib3index/df_cache.h"
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/apps.h"
 #include "psi4/libqt/qt.h"
@@ -217,20 +219,43 @@ double DFMP2::compute_energy()
     timer_on("DFMP2 Singles");
     form_singles();
     timer_off("DFMP2 Singles");
-    timer_on("DFMP2 Aia");
-    form_Aia();
-    timer_off("DFMP2 Aia");
-    timer_on("DFMP2 Qia");
-    form_Qia();
-    timer_off("DFMP2 Qia");
-    timer_on("DFMP2 Energy");
-    form_energy();
-    timer_off("DFMP2 Energy");
+
+    // INCORE and DIRECT never write the (A|ia)/(Q|ia) intermediates
+    std::string algorithm = options_.get_str("DFMP2_ALGORITHM");
+    if (algorithm == "AUTO") {
+        algorithm = (incore_energy_fits() ? "INCORE" : "DISK");
+    }
+
+    if (algorithm == "DISK") {
+        if (options_.get_str("DF_INTS_ENGINE") == "DF_HELPER") {
+            timer_on("DFMP2 Qia");
+            form_Qia_df_helper();
+            timer_off("DFMP2 Qia");
+        } else {
+            timer_on("DFMP2 Aia");
+            form_Aia();
+            timer_off("DFMP2 Aia");
+            timer_on("DFMP2 Qia");
+            form_Qia();
+            timer_off("DFMP2 Qia");
+        }
+        timer_on("DFMP2 Energy");
+        form_energy();
+        timer_off("DFMP2 Energy");
+    } else {
+        timer_on("DFMP2 Energy");
+        form_energy_direct(algorithm == "INCORE");
+        timer_off("DFMP2 Energy");
+    }
     print_energies();
     energy_ = variables_["MP2 TOTAL ENERGY"];
 
     return variables_["MP2 TOTAL ENERGY"];
 }
+void DFMP2::form_energy_direct(bool incore)
+{
+    throw PSIEXCEPTION("DFMP2: DFMP2_ALGORITHM INCORE and DIRECT are only available for RHF references. Use DISK.");
+}
 SharedMatrix DFMP2::compute_gradient()
 {
     print_header();
@@ -328,6 +353,49 @@ SharedMatrix DFMP2::compute_gradient()
 
     return gradients_["Total"];
 }
+SharedMatrix DFMP2::compute_virtual_opdm()
+{
+    if (options_.get_str("REFERENCE") != "RHF" && options_.get_str("REFERENCE") != "RKS")
+        throw PSIEXCEPTION("DFMP2: The virtual-virtual OPDM is only available for RHF references.");
+
+    print_header();
+
+    if (Ca_subset("AO","ACTIVE_OCC")->colspi()[0] == 0)
+        throw PSIEXCEPTION("There are no occupied orbitals with alpha spin.");
+    if (Ca_subset("AO","ACTIVE_VIR")->colspi()[0] == 0)
+        throw PSIEXCEPTION("There are no virtual orbitals with alpha spin.");
+
+    timer_on("DFMP2 Singles");
+    form_singles();
+    timer_off("DFMP2 Singles");
+
+    timer_on("DFMP2 Aia");
+    form_Aia();
+    timer_off("DFMP2 Aia");
+
+    timer_on("DFMP2 iaQ");
+    form_Qia_gradient();
+    timer_off("DFMP2 iaQ");
+
+    timer_on("DFMP2 aiQ");
+    form_Qia_transpose();
+    timer_off("DFMP2 aiQ");
+
+    timer_on("DFMP2 Tij");
+    form_Pab();
+    timer_off("DFMP2 Tij");
+
+    print_energies();
+    energy_ = variables_["MP2 TOTAL ENERGY"];
+
+    int navir = Ca_subset("AO","ACTIVE_VIR")->colspi()[0];
+    SharedMatrix Pab(new Matrix("Pab", navir, navir));
+    psio_->open(PSIF_DFMP2_AIA,PSIO_OPEN_OLD);
+    psio_->read_entry(PSIF_DFMP2_AIA, "Pab", (char*) Pab->pointer()[0], sizeof(double) * navir * navir);
+    psio_->close(PSIF_DFMP2_AIA,0);
+
+    return Pab;
+}
 void DFMP2::form_singles()
 {
     double E_singles_a = 0.0;
@@ -444,10 +512,8 @@ SharedMatrix DFMP2::form_inverse_metric()
 
     } else {
 
-        // Form the inverse metric manually
-        std::shared_ptr<FittingMetric> metric(new FittingMetric(ribasis_, true));
-        metric->form_eig_inverse(1.0E-10);
-        SharedMatrix Jm12 = metric->get_metric();
+        // Form the inverse metric manually (or take it from DF_INTS_CACHE)
+        SharedMatrix Jm12 = DFIntsCache::metric_power(ribasis_, -0.5, 1.0E-10);
 
         // Save inverse metric to the SCF three-index integral file if it exists
         if (options_.get_str("DF_INTS_IO") == "SAVE") {
@@ -462,7 +528,17 @@ SharedMatrix DFMP2::form_inverse_metric()
         return Jm12;
     }
 }
-void DFMP2::apply_fitting(SharedMatrix Jm12, size_t file, size_t naux, size_t nia)
+SharedMatrix DFMP2::form_cholesky_metric()
+{
+    if (options_.get_str("DF_INTS_IO") != "NONE") return SharedMatrix();
+
+    timer_on("DFMP2 Metric");
+    SharedMatrix L = DFIntsCache::metric_cholesky(ribasis_, 1.0E-10);
+    timer_off("DFMP2 Metric");
+
+    return L;
+}
+void DFMP2::apply_fitting(SharedMatrix Jm12, size_t file, size_t naux, size_t nia, bool cholesky)
 {
     // Memory constraints
     size_t Jmem = naux * naux;
@@ -515,7 +591,14 @@ void DFMP2::apply_fitting(SharedMatrix Jm12, size_t file, size_t naux, size_t ni
 
         // Apply Fitting
         timer_on("DFMP2 (Q|A)(A|ia)");
-        C_DGEMM('T','N',ncols,naux,naux,1.0,Aiap[0],max_nia,Jp[0],naux,0.0,Qiap[0],naux);
+        if (cholesky) {
+            // Each (ia| row is solved against the factor in Jm12
+            for (size_t ia = 0; ia < ncols; ia++)
+                C_DCOPY(naux,&Aiap[0][ia],max_nia,Qiap[ia],1);
+            C_DTRSM('R','L','T','N',ncols,naux,1.0,Jp[0],naux,Qiap[0],naux);
+        } else {
+            C_DGEMM('T','N',ncols,naux,naux,1.0,Aiap[0],max_nia,Jp[0],naux,0.0,Qiap[0],naux);
+        }
         timer_off("DFMP2 (Q|A)(A|ia)");
 
         // Write Qia
@@ -588,6 +671,88 @@ void DFMP2::apply_fitting_grad(SharedMatrix Jm12, size_t file, size_t naux, size
     psio_->close(file, 1);
 
 }
+void DFMP2::transform_Qia_df_helper(const std::vector<SharedMatrix>& Caocc, const std::vector<SharedMatrix>& Cavir,
+                                    const std::vector<size_t>& files)
+{
+    int nthread = 1;
+    #ifdef _OPENMP
+        if (options_.get_int("DF_INTS_NUM_THREADS") == 0) {
+            nthread = Process::environment.get_n_threads();
+        } else {
+            nthread = options_.get_int("DF_INTS_NUM_THREADS");
+        }
+    #endif
+
+    size_t naux = ribasis_->nbf();
+    size_t doubles = ((size_t) (options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+
+    size_t wMO = 0L;
+    for (size_t k = 0; k < Caocc.size(); k++) {
+        wMO = std::max(wMO, (size_t) Caocc[k]->colspi()[0]);
+        wMO = std::max(wMO, (size_t) Cavir[k]->colspi()[0]);
+    }
+
+    // The fitted AO integrals outlive this module, so DF-MP2 after DF-MP2 (or
+    // any other DF_Helper client with this basis pair) skips the AO build
+    std::shared_ptr<df_helper::DF_Helper> dfh = df_helper::DF_Helper::get_shared(basisset_, ribasis_, wMO);
+    if (!dfh) {
+        dfh = std::make_shared<df_helper::DF_Helper>(basisset_, ribasis_);
+        dfh->set_memory(doubles);
+        dfh->set_method("STORE");
+        dfh->set_nthreads(nthread);
+        dfh->set_schwarz_cutoff(options_.get_double("INTS_TOLERANCE"));
+        dfh->set_MO_hint(wMO);
+        dfh->initialize();
+        df_helper::DF_Helper::set_shared(dfh);
+    }
+    dfh->set_AO_async(options_.get_bool("DF_HELPER_ASYNC_IO"));
+
+    for (size_t k = 0; k < Caocc.size(); k++) {
+        std::string occ = "o" + std::to_string(k);
+        std::string vir = "v" + std::to_string(k);
+        dfh->add_space(occ, Caocc[k]);
+        dfh->add_space(vir, Cavir[k]);
+        dfh->add_transformation("B" + std::to_string(k), occ, vir);
+    }
+    dfh->transform();
+
+    for (size_t k = 0; k < Caocc.size(); k++) {
+        size_t naocc = Caocc[k]->colspi()[0];
+        size_t navir = Cavir[k]->colspi()[0];
+
+        // DF_Helper hands out (Q|ia) Q-major, restripe blocks of i as (ia|Q)
+        size_t max_ni = doubles / (2L * navir * naux);
+        max_ni = (max_ni > naocc ? naocc : max_ni);
+        // get_tensor reads an (0,0) index range as the whole axis
+        max_ni = (max_ni < 2L ? std::min((size_t) 2L, naocc) : max_ni);
+
+        SharedMatrix Qia(new Matrix("Qia", max_ni * navir, naux));
+        double** Qiap = Qia->pointer();
+
+        psio_->open(files[k], PSIO_OPEN_NEW);
+        psio_address next_QIA = PSIO_ZERO;
+        for (size_t istart = 0L; istart < naocc; istart += max_ni) {
+            size_t ni = (istart + max_ni > naocc ? naocc - istart : max_ni);
+            size_t nia = ni * navir;
+
+            SharedMatrix B = dfh->get_tensor("B" + std::to_string(k), std::make_pair(0, naux - 1),
+                std::make_pair(istart, istart + ni - 1), std::make_pair(0, navir - 1));
+            double** Bp = B->pointer();
+
+            #pragma omp parallel for num_threads(nthread)
+            for (size_t ia = 0; ia < nia; ia++) {
+                C_DCOPY(naux, &Bp[0][ia], nia, Qiap[ia], 1);
+            }
+
+            timer_on("DFMP2 Qia Write");
+            psio_->write(files[k], "(Q|ia)", (char*) Qiap[0], sizeof(double) * nia * naux, next_QIA, &next_QIA);
+            timer_off("DFMP2 Qia Write");
+        }
+        psio_->close(files[k], 1);
+    }
+
+    dfh->clear();
+}
 void DFMP2::apply_gamma(size_t file, size_t naux, size_t nia)
 {
     size_t Jmem = naux * naux;
@@ -1045,8 +1210,16 @@ void RDFMP2::form_Aia()
 }
 void RDFMP2::form_Qia()
 {
-    SharedMatrix Jm12 = form_inverse_metric();
-    apply_fitting(Jm12, PSIF_DFMP2_AIA, ribasis_->nbf(), Caocc_->colspi()[0] * (size_t) Cavir_->colspi()[0]);
+    // The energy only needs (Q|ia)(Q|jb), so any factor of J^-1 fits
+    size_t nia = Caocc_->colspi()[0] * (size_t) Cavir_->colspi()[0];
+    SharedMatrix L = form_cholesky_metric();
+    bool cholesky = (bool) L;
+    SharedMatrix Jm12 = (cholesky ? L : form_inverse_metric());
+    apply_fitting(Jm12, PSIF_DFMP2_AIA, ribasis_->nbf(), nia, cholesky);
+}
+void RDFMP2::form_Qia_df_helper()
+{
+    transform_Qia_df_helper({Caocc_}, {Cavir_}, {PSIF_DFMP2_AIA});
 }
 void RDFMP2::form_Qia_gradient()
 {
@@ -1110,9 +1283,6 @@ void RDFMP2::form_energy()
         Iab.push_back(SharedMatrix(new Matrix("Iab",navir,navir)));
     }
 
-    double* eps_aoccp = eps_aocc_->pointer();
-    double* eps_avirp = eps_avir_->pointer();
-
     // Loop through pairs of blocks
     psio_->open(PSIF_DFMP2_AIA,PSIO_OPEN_OLD);
     psio_address next_AIA = PSIO_ZERO;
@@ -1146,41 +1316,329 @@ void RDFMP2::form_energy()
             }
             timer_off("DFMP2 Qia Read");
 
-            #pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+: e_ss, e_os)
-            for (long int ij = 0L; ij < ni * nj; ij++) {
+            form_energy_pairs(Qiap, istart, ni, Qjbp, jstart, nj, Iab, e_ss, e_os);
+        }
+    }
+    psio_->close(PSIF_DFMP2_AIA,0);
 
-                // Sizing
-                size_t i = ij / nj + istart;
-                size_t j = ij % nj + jstart;
-                if (j > i) continue;
+    variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = e_ss;
+    variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = e_os;
+}
+void RDFMP2::form_energy_pairs(double** Qiap, size_t istart, size_t ni, double** Qjbp, size_t jstart, size_t nj,
+                               std::vector<SharedMatrix>& Iab, double& e_ss, double& e_os)
+{
+    int naux  = ribasis_->nbf();
+    int navir = Cavir_->colspi()[0];
+    int nthread = Iab.size();
 
-                double perm_factor = (i == j ? 1.0 : 2.0);
+    double* eps_aoccp = eps_aocc_->pointer();
+    double* eps_avirp = eps_avir_->pointer();
 
-                // Which thread is this?
-                int thread = 0;
-                #ifdef _OPENMP
-                    thread = omp_get_thread_num();
-                #endif
-                double** Iabp = Iab[thread]->pointer();
+    double ess = 0.0;
+    double eos = 0.0;
 
-                // Form the integral block (ia|jb) = (ia|Q)(Q|jb)
-                C_DGEMM('N','T',navir,navir,naux,1.0,Qiap[(i-istart)*navir],naux,Qjbp[(j-jstart)*navir],naux,0.0,Iabp[0],navir);
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+: ess, eos)
+    for (long int ij = 0L; ij < ni * nj; ij++) {
 
-                // Add the MP2 energy contributions
-                for (int a = 0; a < navir; a++) {
-                    for (int b = 0; b < navir; b++) {
-                        double iajb = Iabp[a][b];
-                        double ibja = Iabp[b][a];
-                        double denom = - perm_factor / (eps_avirp[a] + eps_avirp[b] - eps_aoccp[i] - eps_aoccp[j]);
+        // Sizing
+        size_t i = ij / nj + istart;
+        size_t j = ij % nj + jstart;
+        if (j > i) continue;
 
-                        e_ss += (iajb*iajb - iajb*ibja) * denom;
-                        e_os += (iajb*iajb) * denom;
+        double perm_factor = (i == j ? 1.0 : 2.0);
+
+        // Which thread is this?
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        double** Iabp = Iab[thread]->pointer();
+
+        // Form the integral block (ia|jb) = (ia|Q)(Q|jb)
+        C_DGEMM('N','T',navir,navir,naux,1.0,Qiap[(i-istart)*navir],naux,Qjbp[(j-jstart)*navir],naux,0.0,Iabp[0],navir);
+
+        // Add the MP2 energy contributions
+        for (int a = 0; a < navir; a++) {
+            for (int b = 0; b < navir; b++) {
+                double iajb = Iabp[a][b];
+                double ibja = Iabp[b][a];
+                double denom = - perm_factor / (eps_avirp[a] + eps_avirp[b] - eps_aoccp[i] - eps_aoccp[j]);
+
+                ess += (iajb*iajb - iajb*ibja) * denom;
+                eos += (iajb*iajb) * denom;
+            }
+        }
+    }
+
+    e_ss += ess;
+    e_os += eos;
+}
+bool RDFMP2::incore_energy_fits()
+{
+    int nthread = 1;
+    #ifdef _OPENMP
+        nthread = Process::environment.get_n_threads();
+    #endif
+
+    size_t nso   = basisset_->nbf();
+    size_t naux  = ribasis_->nbf();
+    size_t naocc = Caocc_->colspi()[0];
+    size_t navir = Cavir_->colspi()[0];
+    size_t maxQ  = ribasis_->max_function_per_shell();
+
+    // (Q|ia), the metric, the Iab buffers, and one shell of the (A|mn) -> (A|ia) build
+    size_t needed = naux * naocc * navir + naux * naux + nthread * navir * navir +
+        maxQ * (nso * nso + nso * naocc + naocc * navir);
+    size_t doubles = ((size_t) (options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+
+    return needed <= doubles;
+}
+void RDFMP2::form_Qia_block(SharedMatrix Jm12, size_t istart, size_t ni, size_t doubles, double** Qiap)
+{
+    // Schwarz Sieve
+    std::shared_ptr<ERISieve> sieve(new ERISieve(basisset_,options_.get_double("INTS_TOLERANCE")));
+    const std::vector<std::pair<int,int> >& shell_pairs = sieve->shell_pairs();
+    const size_t npairs = shell_pairs.size();
+
+    // ERI objects
+    int nthread = 1;
+    #ifdef _OPENMP
+        if (options_.get_int("DF_INTS_NUM_THREADS") == 0) {
+            nthread = Process::environment.get_n_threads();
+        } else {
+            nthread = options_.get_int("DF_INTS_NUM_THREADS");
+        }
+    #endif
+
+    std::shared_ptr<IntegralFactory> factory(new IntegralFactory(ribasis_,BasisSet::zero_ao_basis_set(),
+        basisset_,basisset_));
+    std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+    std::vector<const double*> buffer;
+    for (int thread = 0; thread < nthread; thread++) {
+        eri.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        buffer.push_back(eri[thread]->buffer());
+    }
+
+    // Sizing
+    int nso = basisset_->nbf();
+    int naux = ribasis_->nbf();
+    int naocc = Caocc_->colspi()[0];
+    int navir = Cavir_->colspi()[0];
+    int maxQ = ribasis_->max_function_per_shell();
+    size_t nia = ni * navir;
+
+    // Max block size in naux, from whatever the caller left over
+    size_t total_cost_per_row = nso * (size_t) nso + nso * ni + nia;
+    size_t max_temp = doubles / total_cost_per_row;
+    int max_naux = (max_temp > (size_t) naux ? naux : max_temp);
+    max_naux = (max_naux < maxQ ? maxQ : max_naux);
+
+    // Block extents
+    std::vector<int> block_Q_starts;
+    int counter = 0;
+    block_Q_starts.push_back(0);
+    for (int Q = 0; Q < ribasis_->nshell(); Q++) {
+        int nQ = ribasis_->shell(Q).nfunction();
+        if (counter + nQ > max_naux) {
+            counter = 0;
+            block_Q_starts.push_back(Q);
+        }
+        counter += nQ;
+    }
+    block_Q_starts.push_back(ribasis_->nshell());
+
+    // Tensor blocks
+    SharedMatrix Amn(new Matrix("(A|mn) Block", max_naux, nso * (size_t) nso));
+    SharedMatrix Ami(new Matrix("(A|mi) Block", max_naux, nso * ni));
+    SharedMatrix Aia(new Matrix("(A|ia) Block", max_naux, nia));
+    double** Amnp = Amn->pointer();
+    double** Amip = Ami->pointer();
+    double** Aiap = Aia->pointer();
+    double** Jp   = Jm12->pointer();
+
+    // C Matrices
+    double** Caoccp = Caocc_->pointer();
+    double** Cavirp = Cavir_->pointer();
+
+    ::memset((void*) Qiap[0], '\0', sizeof(double) * nia * naux);
+
+    // Loop over blocks of Qshell
+    for (int block = 0; block < block_Q_starts.size() - 1; block++) {
+
+        // Block sizing/offsets
+        int Qstart = block_Q_starts[block];
+        int Qstop  = block_Q_starts[block+1];
+        int qoff   = ribasis_->shell(Qstart).function_index();
+        int nrows  = (Qstop == ribasis_->nshell() ?
+                     ribasis_->nbf() -
+                     ribasis_->shell(Qstart).function_index() :
+                     ribasis_->shell(Qstop).function_index() -
+                     ribasis_->shell(Qstart).function_index());
+
+        // Clear Amn for Schwarz sieve
+        ::memset((void*) Amnp[0], '\0', sizeof(double) * nrows * nso * nso);
+
+        // Compute TEI tensor block (A|mn)
+        timer_on("DFMP2 (A|mn)");
+        #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for (long int QMN = 0L; QMN < (Qstop - Qstart) * (size_t) npairs; QMN++) {
+
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+
+            int Q =  QMN / npairs + Qstart;
+            int MN = QMN % npairs;
+
+            std::pair<int,int> pair = shell_pairs[MN];
+            int M = pair.first;
+            int N = pair.second;
+
+            int nq = ribasis_->shell(Q).nfunction();
+            int nm = basisset_->shell(M).nfunction();
+            int nn = basisset_->shell(N).nfunction();
+
+            int sq =  ribasis_->shell(Q).function_index();
+            int sm =  basisset_->shell(M).function_index();
+            int sn =  basisset_->shell(N).function_index();
+
+            eri[thread]->compute_shell(Q,0,M,N);
+
+            for (int oq = 0; oq < nq; oq++) {
+                for (int om = 0; om < nm; om++) {
+                    for (int on = 0; on < nn; on++) {
+                        Amnp[sq + oq - qoff][(om + sm) * nso + (on + sn)] =
+                        Amnp[sq + oq - qoff][(on + sn) * nso + (om + sm)] =
+                        buffer[thread][oq * nm * nn + om * nn + on];
                     }
                 }
             }
         }
+        timer_off("DFMP2 (A|mn)");
+
+        // Compute (A|mi) tensor block (A|mn) C_ni, for this block of i only
+        timer_on("DFMP2 (A|mn)C_mi");
+        C_DGEMM('N','N',nrows*(size_t)nso,ni,nso,1.0,Amnp[0],nso,&Caoccp[0][istart],naocc,0.0,Amip[0],ni);
+        timer_off("DFMP2 (A|mn)C_mi");
+
+        // Compute (A|ia) tensor block (A|ia) = (A|mi) C_ma
+        timer_on("DFMP2 (A|mi)C_na");
+        #pragma omp parallel for
+        for (int row = 0; row < nrows; row++) {
+            C_DGEMM('T','N',ni,navir,nso,1.0,Amip[row],ni,Cavirp[0],navir,0.0,Aiap[row],navir);
+        }
+        timer_off("DFMP2 (A|mi)C_na");
+
+        // Fit this block of A straight into (ia|Q) += (ia|A) J_AQ^-1/2
+        timer_on("DFMP2 (Q|A)(A|ia)");
+        C_DGEMM('T','N',nia,naux,nrows,1.0,Aiap[0],nia,Jp[qoff],naux,1.0,Qiap[0],naux);
+        timer_off("DFMP2 (Q|A)(A|ia)");
+    }
+}
+void RDFMP2::form_energy_direct(bool incore)
+{
+    // Energy registers
+    double e_ss = 0.0;
+    double e_os = 0.0;
+
+    // Sizing
+    int nso   = basisset_->nbf();
+    int naux  = ribasis_->nbf();
+    int naocc = Caocc_->colspi()[0];
+    int navir = Cavir_->colspi()[0];
+    int maxQ  = ribasis_->max_function_per_shell();
+
+    // Thread considerations
+    int nthread = 1;
+    #ifdef _OPENMP
+        nthread = Process::environment.get_n_threads();
+    #endif
+
+    // Memory
+    size_t Iab_memory = navir * (size_t) navir;
+    size_t Qa_memory  = naux  * (size_t) navir;
+    size_t J_memory   = naux  * (size_t) naux;
+    size_t doubles = ((size_t) (options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+    if (doubles < nthread * Iab_memory + J_memory) {
+        throw PSIEXCEPTION("DFMP2: Insufficient memory for Iab buffers. Reduce OMP Threads or increase memory.");
+    }
+    size_t remainder = doubles - nthread * Iab_memory - J_memory;
+
+    // The whole (ia|Q) in core, or two blocks of it with the other half of the memory kept for the build
+    size_t max_i;
+    if (incore) {
+        if (!incore_energy_fits()) {
+            throw PSIEXCEPTION("DFMP2: Insufficient memory for DFMP2_ALGORITHM INCORE. Use DIRECT or increase memory.");
+        }
+        max_i = naocc;
+    } else {
+        max_i = remainder / (4L * Qa_memory);
+        max_i = (max_i > naocc? naocc : max_i);
+        max_i = (max_i < 1L ? 1L : max_i);
+    }
+
+    // Blocks
+    std::vector<size_t> i_starts;
+    i_starts.push_back(0L);
+    for (size_t i = 0; i < naocc; i += max_i) {
+        if (i + max_i >= naocc) {
+            i_starts.push_back(naocc);
+        } else {
+            i_starts.push_back(i + max_i);
+        }
+    }
+    int nblocks = i_starts.size() - 1;
+
+    // Tensor blocks, Qjb only if there is more than one block of i
+    SharedMatrix Qia (new Matrix("Qia", max_i * (size_t) navir, naux));
+    SharedMatrix Qjb (new Matrix("Qjb", (nblocks > 1 ? max_i * (size_t) navir : 0), naux));
+    double** Qiap = Qia->pointer();
+    double** Qjbp = Qjb->pointer();
+
+    size_t Q_memory = (nblocks > 1 ? 2L : 1L) * max_i * Qa_memory;
+    size_t min_build = maxQ * (nso * (size_t) nso + nso * max_i + max_i * (size_t) navir);
+    size_t build_memory = (remainder > Q_memory + min_build ? remainder - Q_memory : min_build);
+
+    std::vector<SharedMatrix> Iab;
+    for (int i = 0; i < nthread; i++) {
+        Iab.push_back(SharedMatrix(new Matrix("Iab",navir,navir)));
+    }
+
+    outfile->Printf("\t %s DF-MP2 energy: %d block%s of active occupied, %d (A|mn) pass%s.\n\n",
+        (incore ? "In-core" : "Direct"), nblocks, (nblocks > 1 ? "s" : ""),
+        nblocks * (nblocks + 1) / 2, (nblocks > 1 ? "es" : ""));
+
+    SharedMatrix Jm12 = form_inverse_metric();
+
+    // Loop through pairs of blocks, rebuilding (Q|jb) rather than storing it
+    for (int block_i = 0; block_i < nblocks; block_i++) {
+
+        // Sizing
+        size_t istart = i_starts[block_i];
+        size_t istop  = i_starts[block_i+1];
+        size_t ni     = istop - istart;
+
+        timer_on("DFMP2 Qia Build");
+        form_Qia_block(Jm12, istart, ni, build_memory, Qiap);
+        timer_off("DFMP2 Qia Build");
+
+        for (int block_j = 0; block_j < block_i; block_j++) {
+
+            // Sizing
+            size_t jstart = i_starts[block_j];
+            size_t jstop  = i_starts[block_j+1];
+            size_t nj     = jstop - jstart;
+
+            timer_on("DFMP2 Qia Build");
+            form_Qia_block(Jm12, jstart, nj, build_memory, Qjbp);
+            timer_off("DFMP2 Qia Build");
+
+            form_energy_pairs(Qiap, istart, ni, Qjbp, jstart, nj, Iab, e_ss, e_os);
+        }
+
+        form_energy_pairs(Qiap, istart, ni, Qiap, istart, ni, Iab, e_ss, e_os);
     }
-    psio_->close(PSIF_DFMP2_AIA,0);
 
     variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = e_ss;
     variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = e_os;
@@ -3432,9 +3890,17 @@ void UDFMP2::form_Aia()
 }
 void UDFMP2::form_Qia()
 {
-    SharedMatrix Jm12 = form_inverse_metric();
-    apply_fitting(Jm12, PSIF_DFMP2_AIA, ribasis_->nbf(), Caocc_a_->colspi()[0] * (size_t) Cavir_a_->colspi()[0]);
-    apply_fitting(Jm12, PSIF_DFMP2_QIA, ribasis_->nbf(), Caocc_b_->colspi()[0] * (size_t) Cavir_b_->colspi()[0]);
+    size_t nia_a = Caocc_a_->colspi()[0] * (size_t) Cavir_a_->colspi()[0];
+    size_t nia_b = Caocc_b_->colspi()[0] * (size_t) Cavir_b_->colspi()[0];
+    SharedMatrix L = form_cholesky_metric();
+    bool cholesky = (bool) L;
+    SharedMatrix Jm12 = (cholesky ? L : form_inverse_metric());
+    apply_fitting(Jm12, PSIF_DFMP2_AIA, ribasis_->nbf(), nia_a, cholesky);
+    apply_fitting(Jm12, PSIF_DFMP2_QIA, ribasis_->nbf(), nia_b, cholesky);
+}
+void UDFMP2::form_Qia_df_helper()
+{
+    transform_Qia_df_helper({Caocc_a_, Caocc_b_}, {Cavir_a_, Cavir_b_}, {PSIF_DFMP2_AIA, PSIF_DFMP2_QIA});
 }
 void UDFMP2::form_Qia_gradient()
 {
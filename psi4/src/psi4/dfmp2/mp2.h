@@ -31,6 +31,7 @@
 
 #include "psi4/libmints/wavefunction.h"
 #include <map>
+#include <vector>
 
 namespace psi {
 
@@ -63,12 +64,18 @@ protected:
     virtual void form_Aia() = 0;
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia)
     virtual void form_Qia() = 0;
+    // Form the fitted (Q|ia) tensor(s) directly through DF_Helper (DF_INTS_ENGINE DF_HELPER)
+    virtual void form_Qia_df_helper() = 0;
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia) and J_QA^-1 (A|ia)
     virtual void form_Qia_gradient() = 0;
     // Transpose the integrals to (ai|Q)
     virtual void form_Qia_transpose() = 0;
     // Form the energy contributions
     virtual void form_energy() = 0;
+    // Does the whole (Q|ia) tensor fit in core for the energy?
+    virtual bool incore_energy_fits() { return false; }
+    // Form the energy contributions without the (A|ia)/(Q|ia) disk intermediates
+    virtual void form_energy_direct(bool incore);
     // Form the energy contributions and gradients
     virtual void form_Pab() = 0;
     // Form the energy contributions and gradients
@@ -95,17 +102,24 @@ protected:
     // Compute singles correction [for ROHF-MBPT(2) or dual-basis]
     virtual void form_singles();
     // Apply the fitting and transposition to a given disk entry Aia tensor
-    virtual void apply_fitting(SharedMatrix Jm12, size_t file, size_t naux, size_t nia);
+    // (with cholesky, Jm12 is the Cholesky factor from form_cholesky_metric())
+    virtual void apply_fitting(SharedMatrix Jm12, size_t file, size_t naux, size_t nia, bool cholesky = false);
     // Apply the fitting again to a given disk entry Qia tensor
     virtual void apply_fitting_grad(SharedMatrix Jm12, size_t file, size_t naux, size_t nia);
     // Form the inverse square root of the fitting metric, or read it off disk
     virtual SharedMatrix form_inverse_metric();
+    // Form the lower Cholesky factor of the fitting metric, for apply_fitting(..., true).
+    // nullptr if J is too ill-conditioned or J^-1/2 is exchanged through DF_INTS_IO
+    virtual SharedMatrix form_cholesky_metric();
     // Form an abstract gamma
     virtual void apply_gamma(size_t file, size_t naux, size_t nia);
     // Form a transposed copy of G_ia^P
     virtual void apply_G_transpose(size_t file, size_t naux, size_t nia);
     // Form a transposed copy of iaQ
     virtual void apply_B_transpose(size_t file, size_t naux, size_t naocc, size_t navir);
+    // Write DF_Helper's fitted (Q|ia) for each occ/vir pair as the (Q|ia) entry of each file
+    void transform_Qia_df_helper(const std::vector<SharedMatrix>& Caocc, const std::vector<SharedMatrix>& Cavir,
+                                 const std::vector<size_t>& files);
 
     // Debugging-routine: prints block sizing
     void block_status(std::vector<int> inds, const char* file, int line);
@@ -119,6 +133,9 @@ public:
 
     double compute_energy();
     virtual SharedMatrix compute_gradient();
+    /// Computes the energy and the ab block of the unrelaxed OPDM (RHF only).
+    /// The active virtuals are in the C1, energy-sorted order of Ca_subset("AO", "ACTIVE_VIR").
+    SharedMatrix compute_virtual_opdm();
 
 };
 
@@ -144,12 +161,23 @@ protected:
     virtual void form_Aia();
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia)
     virtual void form_Qia();
+    // Form the fitted (Q|ia) tensor(s) directly through DF_Helper
+    virtual void form_Qia_df_helper();
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia) and J_QA^-1 (A|ia)
     virtual void form_Qia_gradient();
     // Transpose the integrals to (ai|Q)
     virtual void form_Qia_transpose();
     // Form the energy contributions
     virtual void form_energy();
+    // Does the whole (Q|ia) tensor fit in core for the energy?
+    virtual bool incore_energy_fits();
+    // Form the energy contributions without the (A|ia)/(Q|ia) disk intermediates
+    virtual void form_energy_direct(bool incore);
+    // Form the fitted (Q|ia) for active occupied i in [istart, istart + ni), straight from the integrals
+    void form_Qia_block(SharedMatrix Jm12, size_t istart, size_t ni, size_t doubles, double** Qiap);
+    // Add the energy contributions of the ij pairs between two (ia|Q) blocks
+    void form_energy_pairs(double** Qiap, size_t istart, size_t ni, double** Qjbp, size_t jstart, size_t nj,
+                           std::vector<SharedMatrix>& Iab, double& e_ss, double& e_os);
     // Form the energy contributions and gradients
     virtual void form_Pab();
     // Form the energy contributions and gradients
@@ -200,6 +228,8 @@ protected:
     virtual void form_Aia();
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia)
     virtual void form_Qia();
+    // Form the fitted (Q|ia) tensor(s) directly through DF_Helper
+    virtual void form_Qia_df_helper();
     // Apply the fitting (Q|ia) = J_QA^-1/2 (A|ia) and J_QA^-1 (A|ia)
     virtual void form_Qia_gradient();
     // Transpose the integrals to (ai|Q)
@@ -53,7 +53,9 @@ namespace psi { namespace dfmp2 {
 SharedWavefunction dfmp2(SharedWavefunction ref_wfn, Options & options)
 {
 
-    std::shared_ptr<PSIO> psio(new PSIO);
+    // Use the process-wide PSIO so that a series of molecules (psi4.energy_batch)
+    // shares one scratch manager rather than setting up a fresh one each time
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
 
     std::shared_ptr<Wavefunction> dfmp2;
     if (options.get_str("REFERENCE") == "RHF" || options.get_str("REFERENCE") == "RKS") {
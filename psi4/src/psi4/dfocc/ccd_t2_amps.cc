@@ -82,7 +82,8 @@ void DFOCC::ccd_t2_amps()
     // Denom
     Tnew = SharedTensor2d(new Tensor2d("New T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
     Tnew->read_symm(psio_, PSIF_DFOCC_AMPS);
-    Tnew->apply_denom_chem(nfrzc, noccA, FockA);
+    if (do_pno_ == "TRUE") pno_project_amps(Tnew);
+    else Tnew->apply_denom_chem(nfrzc, noccA, FockA);
 
     // Reset T2
     rms_t2 = Tnew->rms(t2);
@@ -119,7 +120,7 @@ void DFOCC::ccd_t2_amps()
     // Energy
     K = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|JB)", naoccA, navirA, naoccA, navirA));
     K->gemm(true, false, bQiaA, bQiaA, 1.0, 0.0);
-    Ecorr = U->vector_dot(K);
+    Ecorr = U->vector_dot(K) + Epno_corr;
     U.reset();
     K.reset();
     Eccd = Escf + Ecorr;
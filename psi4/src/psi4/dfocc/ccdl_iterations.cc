@@ -103,7 +103,7 @@ outfile->Printf("  ----   ----------------      ----------------       ---------
       if (do_diis_ == 1) {
           std::shared_ptr<Matrix> L2(new Matrix("L2", naoccA*navirA, naoccA*navirA));
           if (reference_ == "RESTRICTED") {
-              ccsdlDiisManager = std::shared_ptr<DIISManager>(new DIISManager(cc_maxdiis_, "CCDL DIIS L2 Amps", DIISManager::LargestError, DIISManager::OnDisk));
+              ccsdlDiisManager = std::shared_ptr<DIISManager>(new DIISManager(cc_maxdiis_, "CCDL DIIS L2 Amps", DIISManager::LargestError, static_cast<DIISManager::StoragePolicy>(cc_diis_storage_)));
               ccsdlDiisManager->set_error_vector_size(1, DIISEntry::Matrix, L2.get());
               ccsdlDiisManager->set_vector_size(1, DIISEntry::Matrix, L2.get());
           }
@@ -34,6 +34,32 @@ using namespace psi;
 
 namespace psi{ namespace dfoccwave{
 
+namespace {
+
+// The first nrow rows of A(nrow, ncol) in single precision
+std::vector<float> narrow(const SharedTensor2d& A, int nrow, int ncol)
+{
+    std::vector<float> Af((size_t)nrow * ncol);
+    #pragma omp parallel for
+    for (int p = 0; p < nrow; ++p) {
+        for (int q = 0; q < ncol; ++q) Af[(size_t)p * ncol + q] = (float)A->get(p, q);
+    }
+    return Af;
+}
+
+// Z(b, ij) = \sum_{ef} V(b, ef) U(ij, ef) for b < nb, by SGEMM; Uf is U narrowed
+void contract_sp(int nb, int nij, int nef, const SharedTensor2d& V, std::vector<float>& Uf, const SharedTensor2d& Z)
+{
+    std::vector<float> Vf = narrow(V, nb, nef);
+    std::vector<float> Zf((size_t)nb * nij);
+    C_SGEMM('n', 't', nb, nij, nef, 1.0f, Vf.data(), nef, Uf.data(), nef, 0.0f, Zf.data(), nij);
+    for (int b = 0; b < nb; ++b) {
+        for (int ij = 0; ij < nij; ++ij) Z->set(b, ij, (double)Zf[(size_t)b * nij + ij]);
+    }
+}
+
+}  // namespace
+
 void DFOCC::ccsd_WmnijT2()
 {
     // defs
@@ -745,6 +771,13 @@ void DFOCC::ccsd_Wabef2T2()
     }
     Tau.reset();
 
+    // Early CC_MIXED_PRECISION iterations contract in single precision
+    std::vector<float> Uf, Tf;
+    if (ccsd_sp_) {
+        Uf = narrow(U, ntri_ijAA, ntri_abAA);
+        Tf = narrow(T, ntri_ijAA, ntri_abAA);
+    }
+
     // Read B(Q,ab) and B(Q,ia)
     K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (AB|Q)", navirA * navirA, nQ));
     K = bQabA->transpose();
@@ -810,8 +843,14 @@ void DFOCC::ccsd_Wabef2T2()
         }
 
         // Form T[a](b, i>=j) = \sum_{e>=f} Tau(i>=j,e>=f) V[a](b, e>=f)
-        Ts->contract(false, true, nb, ntri_ijAA, ntri_abAA, Vs, U, 1.0, 0.0);
-        Ta->contract(false, true, nb, ntri_ijAA, ntri_abAA, Va, T, 1.0, 0.0);
+        if (ccsd_sp_) {
+            contract_sp(nb, ntri_ijAA, ntri_abAA, Vs, Uf, Ts);
+            contract_sp(nb, ntri_ijAA, ntri_abAA, Va, Tf, Ta);
+        }
+        else {
+            Ts->contract(false, true, nb, ntri_ijAA, ntri_abAA, Vs, U, 1.0, 0.0);
+            Ta->contract(false, true, nb, ntri_ijAA, ntri_abAA, Va, T, 1.0, 0.0);
+        }
 
         // Form S(ij,ab) & A(ij,ab)
         #pragma omp parallel for
@@ -836,6 +875,8 @@ void DFOCC::ccsd_Wabef2T2()
     Ta.reset();
     U.reset();
     T.reset();
+    std::vector<float>().swap(Uf);
+    std::vector<float>().swap(Tf);
     J.reset();
     L.reset();
     T1.reset();
@@ -914,14 +955,30 @@ void DFOCC::ccsd_WabefT2_high_mem()
     }
     Tau.reset();
 
+    // Early CC_MIXED_PRECISION iterations contract in single precision
+    std::vector<float> Uf, Tf;
+    if (ccsd_sp_) {
+        Uf = narrow(U, ntri_ijAA, ntri_abAA);
+        Tf = narrow(T, ntri_ijAA, ntri_abAA);
+    }
+
     // Read B(Q,a>=b)
     bQabA.reset();
     K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
     K->read(psio_, PSIF_DFOCC_INTS);
 
     // Form (A>=E|B>=F) : cost = V4N/4
-    J = SharedTensor2d(new Tensor2d("J (A>=E|B>=F)", ntri_abAA, ntri_abAA));
-    J->gemm(true, false, K, K, 1.0, 0.0);
+    std::vector<float> Jf;
+    if (ccsd_sp_) {
+        std::vector<float> Kf = narrow(K, nQ, ntri_abAA);
+        Jf.resize((size_t)ntri_abAA * ntri_abAA);
+        C_SGEMM('t', 'n', ntri_abAA, ntri_abAA, nQ, 1.0f, Kf.data(), ntri_abAA, Kf.data(), ntri_abAA, 0.0f,
+                Jf.data(), ntri_abAA);
+    }
+    else {
+        J = SharedTensor2d(new Tensor2d("J (A>=E|B>=F)", ntri_abAA, ntri_abAA));
+        J->gemm(true, false, K, K, 1.0, 0.0);
+    }
     K.reset();
 
     // malloc
@@ -947,8 +1004,10 @@ void DFOCC::ccsd_WabefT2_high_mem()
                     int ef = index2(e,f);
                     int bf = index2(b,f);
                     int af = index2(a,f);
-                    double value1 = 0.5 * ( J->get(ae, bf) + J->get(af, be) );
-                    double value2 = 0.5 * ( J->get(ae, bf) - J->get(af, be) );
+                    double Jaebf = (ccsd_sp_ ? Jf[(size_t)ae * ntri_abAA + bf] : J->get(ae, bf));
+                    double Jafbe = (ccsd_sp_ ? Jf[(size_t)af * ntri_abAA + be] : J->get(af, be));
+                    double value1 = 0.5 * ( Jaebf + Jafbe );
+                    double value2 = 0.5 * ( Jaebf - Jafbe );
                     Vs->set(b, ef, value1);
                     Va->set(b, ef, value2);
                 }
@@ -956,8 +1015,14 @@ void DFOCC::ccsd_WabefT2_high_mem()
         }
 
         // Form T[a](b, i>=j) = \sum_{e>=f} Tau(i>=j,e>=f) V[a](b, e>=f)
-        Ts->contract(false, true, nb, ntri_ijAA, ntri_abAA, Vs, U, 1.0, 0.0);
-        Ta->contract(false, true, nb, ntri_ijAA, ntri_abAA, Va, T, 1.0, 0.0);
+        if (ccsd_sp_) {
+            contract_sp(nb, ntri_ijAA, ntri_abAA, Vs, Uf, Ts);
+            contract_sp(nb, ntri_ijAA, ntri_abAA, Va, Tf, Ta);
+        }
+        else {
+            Ts->contract(false, true, nb, ntri_ijAA, ntri_abAA, Vs, U, 1.0, 0.0);
+            Ta->contract(false, true, nb, ntri_ijAA, ntri_abAA, Va, T, 1.0, 0.0);
+        }
 
         // Form S(ij,ab) & A(ij,ab)
         #pragma omp parallel for
@@ -974,6 +1039,9 @@ void DFOCC::ccsd_WabefT2_high_mem()
 
     }
     J.reset();
+    std::vector<float>().swap(Jf);
+    std::vector<float>().swap(Uf);
+    std::vector<float>().swap(Tf);
     Vs.reset();
     Va.reset();
     Ts.reset();
@@ -58,12 +58,16 @@ outfile->Printf("  ----   ----------------      ----------------       ---------
       conver = 1; // Assuming that the iterations will converge
       Eccsd_old = Eccsd;
 
+      // Single-precision PPL until the amplitudes settle, see CC_MIXED_PRECISION
+      ccsd_sp_ = cc_mixed_precision_ && Wabef_type_ != "CD";
+      bool sp_iteration = false;
+
       // DIIS
       if (do_diis_ == 1) {
           std::shared_ptr<Matrix> T2(new Matrix("T2", naoccA*navirA, naoccA*navirA));
           std::shared_ptr<Matrix> T1(new Matrix("T1", naoccA, navirA));
           if (reference_ == "RESTRICTED") {
-              ccsdDiisManager = std::shared_ptr<DIISManager>(new DIISManager(cc_maxdiis_, "CCSD DIIS T Amps", DIISManager::LargestError, DIISManager::OnDisk));
+              ccsdDiisManager = std::shared_ptr<DIISManager>(new DIISManager(cc_maxdiis_, "CCSD DIIS T Amps", DIISManager::LargestError, static_cast<DIISManager::StoragePolicy>(cc_diis_storage_)));
               ccsdDiisManager->set_error_vector_size(2, DIISEntry::Matrix, T2.get(), DIISEntry::Matrix, T1.get());
               ccsdDiisManager->set_vector_size(2, DIISEntry::Matrix, T2.get(), DIISEntry::Matrix, T1.get());
           }
@@ -94,6 +98,7 @@ do
         timer_off("T1 AMPS");
 
         // T2 amplitudes
+        sp_iteration = ccsd_sp_;
         timer_on("T2 AMPS");
 	ccsd_t2_amps();
         timer_off("T2 AMPS");
@@ -109,7 +114,11 @@ do
     }
 
    // print
-   outfile->Printf(" %3d      %12.10f         %12.10f      %12.2e  %12.2e \n", itr_occ, Ecorr, DE, rms_t2, rms_t1);
+   outfile->Printf(" %3d      %12.10f         %12.10f      %12.2e  %12.2e%s\n", itr_occ, Ecorr, DE, rms_t2, rms_t1,
+                   (sp_iteration ? "  SP" : ""));
+
+    // The converged amplitudes always come from double-precision iterations
+    if (ccsd_sp_ && (rms_t2 < tol_sp_switch || rms_t2 < tol_t2)) ccsd_sp_ = false;
 
     if (itr_occ >= cc_maxiter) {
       conver = 0; // means iterations were NOT converged
@@ -121,7 +130,8 @@ do
     }
 
 }
-while(std::fabs(DE) >= tol_Eod || rms_t2 >= tol_t2 || rms_t1 >= tol_t2);
+while(std::fabs(DE) >= tol_Eod || rms_t2 >= tol_t2 || rms_t1 >= tol_t2 || sp_iteration);
+      ccsd_sp_ = false;
 
  //delete
  if (do_diis_ == 1) ccsdDiisManager->delete_diis_file();
@@ -112,7 +112,8 @@ void DFOCC::ccsd_t2_amps()
     // Denom
     Tnew = SharedTensor2d(new Tensor2d("New T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
     Tnew->read_symm(psio_, PSIF_DFOCC_AMPS);
-    Tnew->apply_denom_chem(nfrzc, noccA, FockA);
+    if (do_pno_ == "TRUE") pno_project_amps(Tnew);
+    else Tnew->apply_denom_chem(nfrzc, noccA, FockA);
 
     // Reset T1
     rms_t1 = t1newA->rms(t1A);
@@ -168,7 +169,7 @@ void DFOCC::ccsd_t2_amps()
     Tau.reset();
     K = SharedTensor2d(new Tensor2d("DF_BASIS_CC MO Ints (IA|JB)", naoccA, navirA, naoccA, navirA));
     K->gemm(true, false, bQiaA, bQiaA, 1.0, 0.0);
-    Ecorr = U->vector_dot(K);
+    Ecorr = U->vector_dot(K) + Epno_corr;
     U.reset();
     K.reset();
     Eccsd = Escf + Ecorr;
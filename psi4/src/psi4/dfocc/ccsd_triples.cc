@@ -26,10 +26,18 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/process.h"
 #include "defines.h"
 #include "dfocc.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace psi;
 
 namespace psi{ namespace dfoccwave{
@@ -38,8 +46,7 @@ void DFOCC::ccsd_canonic_triples()
 {
 
     // defs
-    SharedTensor2d K, L, M, I, J, T, U, Tau, W, X, Y, Z;
-    SharedTensor2d V, J1, J2, J3, Jt;
+    SharedTensor2d K, L, M, I, J, T;
     SharedTensor1d Eijk;
     long int Nijk;
 
@@ -60,7 +67,7 @@ void DFOCC::ccsd_canonic_triples()
     // Malloc Eijk
     //Eijk = SharedTensor1d(new Tensor1d("Eijk", Nijk));
 
-    // Memory: 2*O^2V^2 + 5*V^3 + O^3V + V^2N + V^3/2
+    // Memory: 2*O^2V^2 + O^3V + OVN + V^2N/2, and 5*V^3 + V^3/2 per worker
 
     // Read t2 amps
     t2 = SharedTensor2d(new Tensor2d("T2 (IA|JB)", naoccA, navirA, naoccA, navirA));
@@ -90,190 +97,220 @@ void DFOCC::ccsd_canonic_triples()
     L = M->transpose();
     M.reset();
 
-    // malloc W[ijk](abc)
-    W = SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA));
-    V = SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA));
-    J1 = SharedTensor2d(new Tensor2d("J[I] <AB|E>", navirA * navirA, navirA));
-    J2 = SharedTensor2d(new Tensor2d("J[J] <AB|E>", navirA * navirA, navirA));
-    J3 = SharedTensor2d(new Tensor2d("J[K] <AB|E>", navirA * navirA, navirA));
-
     // B(Q,ab)
     K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|AB)", nQ, ntri_abAA));
     K->read(psio_, PSIF_DFOCC_INTS);
-    Jt = SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA));
+
+    // Each worker takes whole (i,j) tasks and keeps its own W, V, J[i], J[j], J[k] and
+    // packed J buffers; J[i] and J[j] serve every k <= j of the task, and J[i] is kept
+    // for the next task when i repeats. Memory decides how many workers run at once.
+    int nthreads = 1;
+    #ifdef _OPENMP
+        nthreads = Process::environment.get_n_threads();
+    #endif
+    double cost_shared = (double)naoccA * naoccA * navirA * navirA * 2.0;
+    cost_shared += (double)naoccA * naoccA * naoccA * navirA;
+    cost_shared += (double)naoccA * navirA * nQ + (double)nQ * ntri_abAA;
+    double cost_worker = 5.0 * navirA * navirA * navirA + (double)navirA * ntri_abAA;
+    double avail = (double)Process::environment.get_memory() / sizeof(double) - cost_shared;
+    int nworker = nthreads;
+    if (avail < nworker * cost_worker) nworker = (int)std::max(1.0, std::floor(avail / cost_worker));
+    outfile->Printf("\tNumber of (T) workers: %i \n", nworker);
+
+    std::vector<SharedTensor2d> Ws, Vs, J1s, J2s, J3s, Jts;
+    for (int w = 0; w < nworker; w++) {
+        Ws.push_back(SharedTensor2d(new Tensor2d("W[IJK] <AB|C>", navirA * navirA, navirA)));
+        Vs.push_back(SharedTensor2d(new Tensor2d("V[IJK] <BA|C>", navirA * navirA, navirA)));
+        J1s.push_back(SharedTensor2d(new Tensor2d("J[I] <AB|E>", navirA * navirA, navirA)));
+        J2s.push_back(SharedTensor2d(new Tensor2d("J[J] <AB|E>", navirA * navirA, navirA)));
+        J3s.push_back(SharedTensor2d(new Tensor2d("J[K] <AB|E>", navirA * navirA, navirA)));
+        Jts.push_back(SharedTensor2d(new Tensor2d("J[I] <A|B>=C", navirA, ntri_abAA)));
+    }
+    std::vector<long int> J1_occ(nworker, -1);
+
+    // (i,j) tasks, heaviest (largest j) first
+    std::vector<std::pair<long int, long int> > tasks;
+    for (long int j = naoccA - 1; j >= 0; --j) {
+        for (long int i = naoccA - 1; i >= j; --i) tasks.push_back(std::make_pair(i, j));
+    }
+    long int ntask = tasks.size();
 
     // main loop
     E_t = 0.0;
     double sum = 0.0;
-    for(long int i = 0 ; i < naoccA; ++i){
-        double Di = FockA->get(i + nfrzc, i + nfrzc);
-
-	// Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
-        Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i*navirA*nQ, 0, 1.0, 0.0);
-	J1->expand23(navirA, navirA, navirA, Jt);
-
-        for(long int j = 0 ; j <= i; ++j){
-	    double Dij = Di + FockA->get(j + nfrzc, j + nfrzc);
-
-	    // Compute J[j](a,bc) = (ja|bc) = \sum(Q) B[j](aQ) * B(Q,bc)
-            Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, j*navirA*nQ, 0, 1.0, 0.0);
-	    J2->expand23(navirA, navirA, navirA, Jt);
-
-            for(long int k = 0 ; k <= j; ++k){
-	        // Compute J[k](a,bc) = (ka|bc) = \sum(Q) B[k](aQ) * B(Q,bc)
-                Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, k*navirA*nQ, 0, 1.0, 0.0);
-	        J3->expand23(navirA, navirA, navirA, Jt);
-
-                // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
-                // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
-                W->contract(false, false, navirA*navirA, navirA, navirA, J1, T, 0, (j*naoccA*navirA*navirA) + (k*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
-                // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
-                W->contract(true, false, navirA*navirA, navirA, naoccA, T, I, i*naoccA*navirA*navirA, (j*naoccA*naoccA*navirA) + (k*naoccA*navirA), -1.0, 1.0);
-
-                // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
-                // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
-                V->contract(false, false, navirA*navirA, navirA, navirA, J1, T, 0, (k*naoccA*navirA*navirA) + (j*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
-                // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
-                V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, i*naoccA*navirA*navirA, (k*naoccA*naoccA*navirA) + (j*naoccA*navirA), -1.0, 1.0);
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-                    for(long int b = 0 ; b < navirA; ++b){
-		        W->axpy((size_t)navirA, a*navirA*navirA + b, navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
-		    }
-		}
-
-                // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
-                // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
-                V->contract(false, false, navirA*navirA, navirA, navirA, J2, T, 0, (i*naoccA*navirA*navirA) + (k*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
-                // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
-                V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, j*naoccA*navirA*navirA, (i*naoccA*naoccA*navirA) + (k*naoccA*navirA), -1.0, 1.0);
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-                    for(long int b = 0 ; b < navirA; ++b){
-		        W->axpy((size_t)navirA, b*navirA*navirA + a*navirA, 1, V, a*navirA*navirA + b*navirA, 1, 1.0);
-		    }
-		}
-
-                // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
-                // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
-                V->contract(false, false, navirA*navirA, navirA, navirA, J2, T, 0, (k*naoccA*navirA*navirA) + (i*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
-                // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
-                V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, j*naoccA*navirA*navirA, (k*naoccA*naoccA*navirA) + (i*naoccA*navirA), -1.0, 1.0);
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-                    for(long int b = 0 ; b < navirA; ++b){
-		        W->axpy((size_t)navirA, b*navirA*navirA + a, navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
-		    }
-		}
-
-                // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
-                // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
-                V->contract(false, false, navirA*navirA, navirA, navirA, J3, T, 0, (i*naoccA*navirA*navirA) + (j*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
-                // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
-                V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, k*naoccA*navirA*navirA, (i*naoccA*naoccA*navirA) + (j*naoccA*navirA), -1.0, 1.0);
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-                    for(long int b = 0 ; b < navirA; ++b){
-		        W->axpy((size_t)navirA, a*navirA + b, navirA*navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
-		    }
-		}
-
-                // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
-                // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
-                V->contract(false, false, navirA*navirA, navirA, navirA, J3, T, 0, (j*naoccA*navirA*navirA) + (i*navirA*navirA), 1.0, 0.0);
-
-                // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
-                // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
-                V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, k*naoccA*navirA*navirA, (j*naoccA*naoccA*navirA) + (i*naoccA*navirA), -1.0, 1.0);
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-                    for(long int b = 0 ; b < navirA; ++b){
-		        W->axpy((size_t)navirA, b*navirA + a, navirA*navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
-		    }
-		}
-
-		// V[ijk](ab,c) = W[ijk](ab,c)
-		V->copy(W);
-
-		// V[ijk](ab,c) += t_i^a (jb|kc) + t_j^b (ia|kc) + t_k^c (ia|jb)
-		// Vt[ijk](ab,c) = V[ijk](ab,c) / (1 + \delta(abc))
-                #pragma omp parallel for
-                for(long int a = 0 ; a < navirA; ++a){
-	            long int ia = ia_idxAA->get(i,a);
-                    for(long int b = 0 ; b < navirA; ++b){
-			long int jb = ia_idxAA->get(j,b);
-			long int ab = ab_idxAA->get(a,b);
-                        for(long int c = 0 ; c < navirA; ++c){
-			    long int kc = ia_idxAA->get(k,c);
-			    double value = V->get(ab,c) + ( t1A->get(i,a)*J->get(jb,kc) ) + ( t1A->get(j,b)*J->get(ia,kc) ) + ( t1A->get(k,c)*J->get(ia,jb) );
-			    double denom =  1 + ( (a==b) + (b==c) + (a==c) );
-			    V->set(ab, c, value/denom);
-			}
-		    }
-		}
-
-		// Denom
-		double Dijk = Dij + FockA->get(k + nfrzc, k + nfrzc);
-	        double factor =  2 - ( (i==j) + (j==k) + (i==k) );
-
-		// Compute energy
-		double Xvalue, Yvalue, Zvalue;
-                #pragma omp parallel for private(Xvalue,Yvalue,Zvalue) reduction(+:sum)
-                for(long int a = 0 ; a < navirA; ++a){
-	            double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
-                    for(long int b = 0 ; b <=a; ++b){
-			double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
-			long int ab = ab_idxAA->get(a,b);
-			long int ba = ab_idxAA->get(b,a);
-                        for(long int c = 0 ; c <= b; ++c){
-			    long int ac = ab_idxAA->get(a,c);
-			    long int bc = ab_idxAA->get(b,c);
-			    long int ca = ab_idxAA->get(c,a);
-			    long int cb = ab_idxAA->get(c,b);
-
-			    // X_ijk^abc
-			    Xvalue = ( W->get(ab,c)*V->get(ab,c) ) + ( W->get(ac,b)*V->get(ac,b) )
-				         + ( W->get(ba,c)*V->get(ba,c) ) + ( W->get(bc,a)*V->get(bc,a) )
-					 + ( W->get(ca,b)*V->get(ca,b) ) + ( W->get(cb,a)*V->get(cb,a) );
-
-			    // Y_ijk^abc
-			    Yvalue = V->get(ab,c) + V->get(bc,a) + V->get(ca,b);
-
-			    // Z_ijk^abc
-			    Zvalue = V->get(ac,b) + V->get(ba,c) + V->get(cb,a);
-
-			    // contributions to energy
-			    double value = (Yvalue - (2.0*Zvalue)) * ( W->get(ab,c) + W->get(bc,a) + W->get(ca,b) ) ;
-			    value += (Zvalue - (2.0*Yvalue)) * ( W->get(ac,b) + W->get(ba,c) + W->get(cb,a) ) ;
-			    value += 3.0 * Xvalue;
-			    double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
-			    sum += (value * factor) / Dijkabc;
-			}
-		    }
-		}
-
-	    }//k
-	}//j
-    }//i
+    #pragma omp parallel for schedule(dynamic) num_threads(nworker) reduction(+:sum)
+    for (long int task = 0; task < ntask; ++task) {
+        int w = 0;
+        #ifdef _OPENMP
+            w = omp_get_thread_num();
+        #endif
+        long int i = tasks[task].first;
+        long int j = tasks[task].second;
+        SharedTensor2d W = Ws[w];
+        SharedTensor2d V = Vs[w];
+        SharedTensor2d J1 = J1s[w];
+        SharedTensor2d J2 = J2s[w];
+        SharedTensor2d J3 = J3s[w];
+        SharedTensor2d Jt = Jts[w];
+        double Dij = FockA->get(i + nfrzc, i + nfrzc) + FockA->get(j + nfrzc, j + nfrzc);
+
+        // Compute J[i](a,bc) = (ia|bc) = \sum(Q) B[i](aQ) * B(Q,bc)
+        if (J1_occ[w] != i) {
+            Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, i*navirA*nQ, 0, 1.0, 0.0);
+            J1->expand23(navirA, navirA, navirA, Jt);
+            J1_occ[w] = i;
+        }
+
+        // Compute J[j](a,bc) = (ja|bc) = \sum(Q) B[j](aQ) * B(Q,bc)
+        Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, j*navirA*nQ, 0, 1.0, 0.0);
+        J2->expand23(navirA, navirA, navirA, Jt);
+
+        for(long int k = 0 ; k <= j; ++k){
+            // Compute J[k](a,bc) = (ka|bc) = \sum(Q) B[k](aQ) * B(Q,bc)
+            Jt->contract(false, false, navirA, ntri_abAA, nQ, L, K, k*navirA*nQ, 0, 1.0, 0.0);
+            J3->expand23(navirA, navirA, navirA, Jt);
+
+            // W[ijk](ab,c) = \sum(e) t_jk^ec (ia|be) (1+)
+            // W[ijk](ab,c) = \sum(e) J[i](ab,e) T[jk](ec)
+            W->contract(false, false, navirA*navirA, navirA, navirA, J1, T, 0, (j*naoccA*navirA*navirA) + (k*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](ab,c) -= \sum(m) t_im^ab <jk|mc> (1-)
+            // W[ijk](ab,c) -= \sum(m) T[i](m,ab) I[jk](mc)
+            W->contract(true, false, navirA*navirA, navirA, naoccA, T, I, i*naoccA*navirA*navirA, (j*naoccA*naoccA*navirA) + (k*naoccA*navirA), -1.0, 1.0);
+
+            // W[ijk](ac,b) = \sum(e) t_kj^eb (ia|ce) (2+)
+            // W[ijk](ac,b) = \sum(e) J[i](ac,e) T[kj](eb)
+            V->contract(false, false, navirA*navirA, navirA, navirA, J1, T, 0, (k*naoccA*navirA*navirA) + (j*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](ac,b) -= \sum(m) t_im^ac <kj|mb> (2-)
+            // W[ijk](ac,b) -= \sum(m) T[i](m,ac) I[kj](mb)
+            V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, i*naoccA*navirA*navirA, (k*naoccA*naoccA*navirA) + (j*naoccA*navirA), -1.0, 1.0);
+            for(long int a = 0 ; a < navirA; ++a){
+                for(long int b = 0 ; b < navirA; ++b){
+                    W->axpy((size_t)navirA, a*navirA*navirA + b, navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
+                }
+            }
+
+            // W[ijk](ba,c) = \sum(e) t_ik^ec (jb|ae) (3+)
+            // W[ijk](ba,c) = \sum(e) J[j](ba,e) T[ik](ec)
+            V->contract(false, false, navirA*navirA, navirA, navirA, J2, T, 0, (i*naoccA*navirA*navirA) + (k*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](ba,c) -= \sum(m) t_jm^ba <ik|mc> (3-)
+            // W[ijk](ba,c) -= \sum(m) T[j](m,ba) I[ik](mc)
+            V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, j*naoccA*navirA*navirA, (i*naoccA*naoccA*navirA) + (k*naoccA*navirA), -1.0, 1.0);
+            for(long int a = 0 ; a < navirA; ++a){
+                for(long int b = 0 ; b < navirA; ++b){
+                    W->axpy((size_t)navirA, b*navirA*navirA + a*navirA, 1, V, a*navirA*navirA + b*navirA, 1, 1.0);
+                }
+            }
+
+            // W[ijk](bc,a) = \sum(e) t_ki^ea (jb|ce) (4+)
+            // W[ijk](bc,a) = \sum(e) J[j](bc,e) T[ki](ea)
+            V->contract(false, false, navirA*navirA, navirA, navirA, J2, T, 0, (k*naoccA*navirA*navirA) + (i*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](bc,a) -= \sum(m) t_jm^bc <ki|ma> (4-)
+            // W[ijk](bc,a) -= \sum(m) T[j](m,bc) I[ki](ma)
+            V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, j*naoccA*navirA*navirA, (k*naoccA*naoccA*navirA) + (i*naoccA*navirA), -1.0, 1.0);
+            for(long int a = 0 ; a < navirA; ++a){
+                for(long int b = 0 ; b < navirA; ++b){
+                    W->axpy((size_t)navirA, b*navirA*navirA + a, navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
+                }
+            }
+
+            // W[ijk](ca,b) = \sum(e) t_ij^eb (kc|ae) (5+)
+            // W[ijk](ca,b) = \sum(e) J[k](ca,e) T[ij](eb)
+            V->contract(false, false, navirA*navirA, navirA, navirA, J3, T, 0, (i*naoccA*navirA*navirA) + (j*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](ca,b) -= \sum(m) t_km^ca <ij|mb> (5-)
+            // W[ijk](ca,b) -= \sum(m) T[k](m,ca) I[ij](mb)
+            V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, k*naoccA*navirA*navirA, (i*naoccA*naoccA*navirA) + (j*naoccA*navirA), -1.0, 1.0);
+            for(long int a = 0 ; a < navirA; ++a){
+                for(long int b = 0 ; b < navirA; ++b){
+                    W->axpy((size_t)navirA, a*navirA + b, navirA*navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
+                }
+            }
+
+            // W[ijk](cb,a) = \sum(e) t_ji^ea (kc|be) (6+)
+            // W[ijk](cb,a) = \sum(e) J[k](cb,e) T[ji](ea)
+            V->contract(false, false, navirA*navirA, navirA, navirA, J3, T, 0, (j*naoccA*navirA*navirA) + (i*navirA*navirA), 1.0, 0.0);
+
+            // W[ijk](cb,a) -= \sum(m) t_km^cb <ji|ma> (6-)
+            // W[ijk](cb,a) -= \sum(m) T[k](m,cb) I[ji](ma)
+            V->contract(true, false, navirA*navirA, navirA, naoccA, T, I, k*naoccA*navirA*navirA, (j*naoccA*naoccA*navirA) + (i*naoccA*navirA), -1.0, 1.0);
+            for(long int a = 0 ; a < navirA; ++a){
+                for(long int b = 0 ; b < navirA; ++b){
+                    W->axpy((size_t)navirA, b*navirA + a, navirA*navirA, V, a*navirA*navirA + b*navirA, 1, 1.0);
+                }
+            }
+
+            // V[ijk](ab,c) = W[ijk](ab,c)
+            V->copy(W);
+
+            // V[ijk](ab,c) += t_i^a (jb|kc) + t_j^b (ia|kc) + t_k^c (ia|jb)
+            // Vt[ijk](ab,c) = V[ijk](ab,c) / (1 + \delta(abc))
+            for(long int a = 0 ; a < navirA; ++a){
+                long int ia = ia_idxAA->get(i,a);
+                for(long int b = 0 ; b < navirA; ++b){
+                    long int jb = ia_idxAA->get(j,b);
+                    long int ab = ab_idxAA->get(a,b);
+                    for(long int c = 0 ; c < navirA; ++c){
+                        long int kc = ia_idxAA->get(k,c);
+                        double value = V->get(ab,c) + ( t1A->get(i,a)*J->get(jb,kc) ) + ( t1A->get(j,b)*J->get(ia,kc) ) + ( t1A->get(k,c)*J->get(ia,jb) );
+                        double denom =  1 + ( (a==b) + (b==c) + (a==c) );
+                        V->set(ab, c, value/denom);
+                    }
+                }
+            }
+
+            // Denom
+            double Dijk = Dij + FockA->get(k + nfrzc, k + nfrzc);
+            double factor =  2 - ( (i==j) + (j==k) + (i==k) );
+
+            // Compute energy
+            for(long int a = 0 ; a < navirA; ++a){
+                double Dijka = Dijk - FockA->get(a + noccA, a + noccA);
+                for(long int b = 0 ; b <=a; ++b){
+                    double Dijkab = Dijka - FockA->get(b + noccA, b + noccA);
+                    long int ab = ab_idxAA->get(a,b);
+                    long int ba = ab_idxAA->get(b,a);
+                    for(long int c = 0 ; c <= b; ++c){
+                        long int ac = ab_idxAA->get(a,c);
+                        long int bc = ab_idxAA->get(b,c);
+                        long int ca = ab_idxAA->get(c,a);
+                        long int cb = ab_idxAA->get(c,b);
+
+                        // X_ijk^abc
+                        double Xvalue = ( W->get(ab,c)*V->get(ab,c) ) + ( W->get(ac,b)*V->get(ac,b) )
+                                      + ( W->get(ba,c)*V->get(ba,c) ) + ( W->get(bc,a)*V->get(bc,a) )
+                                      + ( W->get(ca,b)*V->get(ca,b) ) + ( W->get(cb,a)*V->get(cb,a) );
+
+                        // Y_ijk^abc
+                        double Yvalue = V->get(ab,c) + V->get(bc,a) + V->get(ca,b);
+
+                        // Z_ijk^abc
+                        double Zvalue = V->get(ac,b) + V->get(ba,c) + V->get(cb,a);
+
+                        // contributions to energy
+                        double value = (Yvalue - (2.0*Zvalue)) * ( W->get(ab,c) + W->get(bc,a) + W->get(ca,b) ) ;
+                        value += (Zvalue - (2.0*Yvalue)) * ( W->get(ac,b) + W->get(ba,c) + W->get(cb,a) ) ;
+                        value += 3.0 * Xvalue;
+                        double Dijkabc = Dijkab - FockA->get(c + noccA, c + noccA);
+                        sum += (value * factor) / Dijkabc;
+                    }
+                }
+            }
+
+        }//k
+    }//task
     T.reset();
     J.reset();
-    W.reset();
-    V.reset();
-    J1.reset();
-    J2.reset();
-    J3.reset();
+    Ws.clear();
+    Vs.clear();
+    J1s.clear();
+    J2s.clear();
+    J3s.clear();
+    Jts.clear();
     K.reset();
-    Jt.reset();
     L.reset();
     I.reset();
 
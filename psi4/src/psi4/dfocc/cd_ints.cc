@@ -168,7 +168,7 @@ void DFOCC::cd_ints()
           std::shared_ptr<BasisSet> primary = basisset();
           std::shared_ptr<IntegralFactory> integral (new IntegralFactory(primary,primary,primary,primary));
           double tol_cd = options_.get_double("CHOLESKY_TOLERANCE");
-          std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(std::shared_ptr<TwoBodyAOInt>(integral->eri()),cutoff,tol_cd,Process::environment.get_memory()));
+          std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(integral,cutoff,tol_cd,Process::environment.get_memory()));
           Ch->choleskify();
           nQ  = Ch->Q();
           nQ_ref = nQ;
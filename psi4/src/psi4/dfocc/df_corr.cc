@@ -32,7 +32,9 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
 #include "psi4/libmints/sieve.h"
+#include "psi4/lib3index/df_cache.h"
 #include "psi4/psi4-dec.h"
 
 #include "defines.h"
@@ -98,6 +100,98 @@ void DFOCC::trans_corr()
     timer_off("Trans OEI");
 }
 
+//=======================================================
+//          trans by orbital rotation
+//=======================================================
+// Within the orbital iterations C = Cref * Uorb, so the MO integrals follow from
+// those of the reference orbitals by b(Q|pq) = \sum_{rs} U(r,p) b_ref(Q|rs) U(s,q),
+// without reading the AO integrals.
+void DFOCC::trans_rotate()
+{
+    timer_on("Rotate B(Q,pq)");
+    rotate_bQ("DF_BASIS_CC", nQ);
+    rotate_bQ("DF_BASIS_SCF", nQ_ref);
+    timer_off("Rotate B(Q,pq)");
+
+    // Trans OEI
+    timer_on("Trans OEI");
+    trans_oei();
+    timer_off("Trans OEI");
+}
+
+//=======================================================
+//          rotate b(Q,pq) : all
+//=======================================================
+void DFOCC::rotate_bQ(std::string basis, int naux)
+{
+    bool cc = (basis == "DF_BASIS_CC");
+    int& formed = cc ? rotate_ref_cc : rotate_ref_scf;
+    bool uhf = (reference_ == "UNRESTRICTED");
+
+    // b_ref(Q|pq) for both spins, formed once from the AO integrals
+    if (!formed) {
+        bQso = SharedTensor2d(new Tensor2d(basis + " B (Q|mn)", naux, nso_, nso_));
+        bQso->read(psio_, PSIF_DFOCC_INTS, true, true);
+        for (int spin = 0; spin < (uhf ? 2 : 1); spin++) {
+            SharedTensor2d Cref = (spin == 0) ? Cmo_refA : Cmo_refB;
+            SharedTensor2d T = SharedTensor2d(new Tensor2d("B (Q|mP)", naux, nso_ * nmo_));
+            T->contract(false, false, naux * nso_, nmo_, nso_, bQso, Cref, 1.0, 0.0);
+            SharedTensor2d R = SharedTensor2d(new Tensor2d(basis + (spin == 0 ? " B (Q|PQ) REF" : " B (Q|pq) REF"), naux, nmo_, nmo_));
+            R->contract233(true, false, nmo_, nmo_, Cref, T, 1.0, 0.0);
+            T.reset();
+            R->write(psio_, PSIF_DFOCC_INTS);
+        }
+        bQso.reset();
+        formed = 1;
+    }
+
+    for (int spin = 0; spin < (uhf ? 2 : 1); spin++) {
+        SharedTensor2d U = (spin == 0) ? UorbA : UorbB;
+        int nocc = (spin == 0) ? noccA : noccB;
+        int nvir = (spin == 0) ? nvirA : nvirB;
+        int naocc = (spin == 0) ? naoccA : naoccB;
+        int navir = (spin == 0) ? navirA : navirB;
+        std::string OO = (spin == 0) ? "OO" : "oo";
+        std::string OV = (spin == 0) ? "OV" : "ov";
+        std::string VV = (spin == 0) ? "VV" : "vv";
+
+        // b(Q|pq) = U^T b_ref(Q) U
+        SharedTensor2d R = SharedTensor2d(new Tensor2d(basis + (spin == 0 ? " B (Q|PQ) REF" : " B (Q|pq) REF"), naux, nmo_, nmo_));
+        R->read(psio_, PSIF_DFOCC_INTS);
+        SharedTensor2d T = SharedTensor2d(new Tensor2d("B (Q|PQ)", naux, nmo_, nmo_));
+        T->contract(false, false, naux * nmo_, nmo_, nmo_, R, U, 1.0, 0.0);
+        R->contract233(true, false, nmo_, nmo_, U, T, 1.0, 0.0);
+        T.reset();
+
+        // The blocks trans_corr and trans_ref write
+        SharedTensor2d X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + OO + ")", naux, nocc, nocc));
+        X->form_b_pq(0, 0, R);
+        X->write(psio_, PSIF_DFOCC_INTS);
+        X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + OV + ")", naux, nocc, nvir));
+        X->form_b_pq(0, nocc, R);
+        X->write(psio_, PSIF_DFOCC_INTS);
+        X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + VV + ")", naux, nvir, nvir));
+        X->form_b_pq(nocc, nocc, R);
+        X->write(psio_, PSIF_DFOCC_INTS, true, true);
+        if (cc) {
+            std::string IJ = (spin == 0) ? "IJ" : "ij";
+            std::string IA = (spin == 0) ? "IA" : "ia";
+            std::string AB = (spin == 0) ? "AB" : "ab";
+            X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + IJ + ")", naux, naocc, naocc));
+            X->form_b_pq(nfrzc, nfrzc, R);
+            X->write(psio_, PSIF_DFOCC_INTS);
+            X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + IA + ")", naux, naocc, navir));
+            X->form_b_pq(nfrzc, nocc, R);
+            X->write(psio_, PSIF_DFOCC_INTS);
+            X = SharedTensor2d(new Tensor2d(basis + " B (Q|" + AB + ")", naux, navir, navir));
+            X->form_b_pq(nocc, nocc, R);
+            X->write(psio_, PSIF_DFOCC_INTS, true, true);
+        }
+        X.reset();
+        R.reset();
+    }
+} // end rotate_bQ
+
 //=======================================================
 //          trans for mp2 energy
 //=======================================================
@@ -149,117 +243,11 @@ void DFOCC::df_corr()
 //=======================================================
 void DFOCC::formJ(std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero)
 {
-
-    int nthreads = 1;
-    #ifdef _OPENMP
-        nthreads = Process::environment.get_n_threads();
-    #endif
-
-    double **J = block_matrix(nQ, nQ);
-    J_mhalf = block_matrix(nQ, nQ);
-
-    // => Integrals <= //
-    std::shared_ptr<IntegralFactory> rifactory(new IntegralFactory(auxiliary_,zero,auxiliary_,zero));
-    std::vector<std::shared_ptr<TwoBodyAOInt> > Jint;
-    std::vector<const double*> buffer;
-    for (int t = 0; t < nthreads; t++) {
-        Jint.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory->eri()));
-        buffer.push_back(Jint[t]->buffer());
-    }
-
-    std::vector<std::pair<int,int> > PQ_pairs;
-    for (int P = 0; P < auxiliary_->nshell(); P++) {
-        for (int Q = 0; Q <= P; Q++) {
-            PQ_pairs.push_back(std::pair<int,int>(P,Q));
-        }
-    }
-
-    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-    for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
-
-        int P = PQ_pairs[PQ].first;
-        int Q = PQ_pairs[PQ].second;
-
-        int thread = 0;
-        #ifdef _OPENMP
-            thread = omp_get_thread_num();
-        #endif
-
-        Jint[thread]->compute_shell(P,0,Q,0);
-        //const double* buffer = Jint[thread]->buffer();
-
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-
-        int nQ = auxiliary_->shell(Q).nfunction();
-        int oQ = auxiliary_->shell(Q).function_index();
-
-        int index = 0;
-        for (int p = 0; p < nP; p++) {
-            for (int q = 0; q < nQ; q++, ++index) {
-                 J[p + oP][q + oQ] = buffer[thread][index];
-            }
-        }
-    }
-
-    /*
-    // Create integral factories for the RI basis
-    std::shared_ptr<IntegralFactory> rifactory_J(new IntegralFactory(auxiliary_, zero, auxiliary_, zero));
-    std::shared_ptr<TwoBodyAOInt> Jint(rifactory_J->eri());
-
-    double **J = block_matrix(nQ, nQ);
+    // J^-1/2 from the fitting metric, shared with the other DF stages under DF_INTS_CACHE.
+    // The gradients reuse Jmhalf, so the symmetric form is kept rather than a Cholesky factor.
+    SharedMatrix Jm12 = DFIntsCache::metric_power(auxiliary_, -0.5, 1.0E-10);
     J_mhalf = block_matrix(nQ, nQ);
-    const double *Jbuffer = Jint->buffer();
-
-    // Compute J_PQ metric
-    int index = 0;
-    for (int MU=0; MU < auxiliary_->nshell(); ++MU) {
-        int nummu = auxiliary_->shell(MU).nfunction();
-        for (int NU=0; NU < auxiliary_->nshell(); ++NU) {
-            int numnu = auxiliary_->shell(NU).nfunction();
-            Jint->compute_shell(MU, 0, NU, 0);
-            index = 0;
-            for (int mu=0; mu < nummu; ++mu) {
-                int omu = auxiliary_->shell(MU).function_index() + mu;
-                for (int nu=0; nu < numnu; ++nu, ++index) {
-                    int onu = auxiliary_->shell(NU).function_index() + nu;
-                    J[omu][onu] = Jbuffer[index];
-                }
-            }
-        }
-    }
-    */
-
-    // First, diagonalize J
-    // the C_DSYEV call replaces the original matrix J with its eigenvectors
-    int lwork = nQ * 3;
-    double* eigval = init_array(nQ);
-    double* work = init_array(lwork);
-    int status = C_DSYEV('v', 'u', nQ, J[0], nQ, eigval, work, lwork);
-    if(status){
-        throw PsiException("Diagonalization of J failed", __FILE__, __LINE__);
-    }
-    free(work);
-
-    // Now J contains the eigenvectors of the original J
-    // Copy J to J_copy
-    double **J_copy = block_matrix(nQ, nQ);
-    C_DCOPY(nQ*nQ, J[0], 1, J_copy[0], 1);
-
-    // Now form J^{-1/2} = U(T)*j^{-1/2}*U,
-    // where j^{-1/2} is the diagonal matrix of the inverse square roots
-    // of the eigenvalues, and U is the matrix of eigenvectors of J
-    for(int i=0; i<nQ; ++i){
-        eigval[i] = (eigval[i] < 1.0E-10) ? 0.0 : 1.0 / sqrt(eigval[i]);
-        // scale one set of eigenvectors by the diagonal elements j^{-1/2}
-        C_DSCAL(nQ, eigval[i], J[i], 1);
-    }
-    free(eigval);
-
-    // J_mhalf = J_copy(T) * J
-    C_DGEMM('t','n', nQ, nQ, nQ, 1.0, J_copy[0], nQ, J[0], nQ, 0.0, J_mhalf[0], nQ);
-    free_block(J);
-    free_block(J_copy);
+    C_DCOPY(nQ * (size_t) nQ, Jm12->pointer()[0], 1, J_mhalf[0], 1);
 
     // write J
     Jmhalf = SharedTensor2d(new Tensor2d("DF_BASIS_CC Jmhalf <P|Q>", nQ, nQ));
@@ -34,6 +34,7 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/sieve.h"
+#include "psi4/lib3index/df_cache.h"
 #include "psi4/psifiles.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsio/psio.hpp"
@@ -195,117 +196,11 @@ void DFOCC::df_ref()
 //=======================================================
 void DFOCC::formJ_ref(std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero)
 {
-    int nthreads = 1;
-    #ifdef _OPENMP
-        nthreads = Process::environment.get_n_threads();
-    #endif
-
-    double **J = block_matrix(nQ_ref, nQ_ref);
+    // J^-1/2 from the fitting metric, shared with the other DF stages under DF_INTS_CACHE.
+    // The gradients reuse Jmhalf, so the symmetric form is kept rather than a Cholesky factor.
+    SharedMatrix Jm12 = DFIntsCache::metric_power(auxiliary_, -0.5, 1.0E-10);
     J_mhalf = block_matrix(nQ_ref, nQ_ref);
-
-    // => Integrals <= //
-    std::shared_ptr<IntegralFactory> rifactory(new IntegralFactory(auxiliary_,zero,auxiliary_,zero));
-    std::vector<std::shared_ptr<TwoBodyAOInt> > Jint;
-    std::vector<const double*> buffer;
-    for (int t = 0; t < nthreads; t++) {
-        Jint.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory->eri()));
-        buffer.push_back(Jint[t]->buffer());
-    }
-
-    std::vector<std::pair<int,int> > PQ_pairs;
-    for (int P = 0; P < auxiliary_->nshell(); P++) {
-        for (int Q = 0; Q <= P; Q++) {
-            PQ_pairs.push_back(std::pair<int,int>(P,Q));
-        }
-    }
-
-    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-    for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
-
-        int P = PQ_pairs[PQ].first;
-        int Q = PQ_pairs[PQ].second;
-
-        int thread = 0;
-        #ifdef _OPENMP
-            thread = omp_get_thread_num();
-        #endif
-
-        Jint[thread]->compute_shell(P,0,Q,0);
-        //const double* buffer = Jint[thread]->buffer();
-
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-
-        int nQ = auxiliary_->shell(Q).nfunction();
-        int oQ = auxiliary_->shell(Q).function_index();
-
-        int index = 0;
-        for (int p = 0; p < nP; p++) {
-            for (int q = 0; q < nQ; q++, ++index) {
-                 J[p + oP][q + oQ] = buffer[thread][index];
-            }
-        }
-    }
-
-
-    /*
-    // Create integral factories for the RI basis
-    std::shared_ptr<IntegralFactory> rifactory_J(new IntegralFactory(auxiliary_, zero, auxiliary_, zero));
-    std::shared_ptr<TwoBodyAOInt> Jint(rifactory_J->eri());
-
-    double **J = block_matrix(nQ_ref, nQ_ref);
-    J_mhalf = block_matrix(nQ_ref, nQ_ref);
-    const double *Jbuffer = Jint->buffer();
-
-    // Compute J_PQ metric
-    int index = 0;
-    for (int MU=0; MU < auxiliary_->nshell(); ++MU) {
-        int nummu = auxiliary_->shell(MU).nfunction();
-        for (int NU=0; NU < auxiliary_->nshell(); ++NU) {
-            int numnu = auxiliary_->shell(NU).nfunction();
-            Jint->compute_shell(MU, 0, NU, 0);
-            index = 0;
-            for (int mu=0; mu < nummu; ++mu) {
-                int omu = auxiliary_->shell(MU).function_index() + mu;
-                for (int nu=0; nu < numnu; ++nu, ++index) {
-                    int onu = auxiliary_->shell(NU).function_index() + nu;
-                    J[omu][onu] = Jbuffer[index];
-                }
-            }
-        }
-    }
-    */
-
-    // First, diagonalize J
-    // the C_DSYEV call replaces the original matrix J with its eigenvectors
-    int lwork = nQ_ref * 3;
-    double* eigval = init_array(nQ_ref);
-    double* work = init_array(lwork);
-    int status = C_DSYEV('v', 'u', nQ_ref, J[0], nQ_ref, eigval, work, lwork);
-    if(status){
-        throw PsiException("Diagonalization of J failed", __FILE__, __LINE__);
-    }
-    free(work);
-
-    // Now J contains the eigenvectors of the original J
-    // Copy J to J_copy
-    double **J_copy = block_matrix(nQ_ref, nQ_ref);
-    C_DCOPY(nQ_ref*nQ_ref, J[0], 1, J_copy[0], 1);
-
-    // Now form J^{-1/2} = U(T)*j^{-1/2}*U,
-    // where j^{-1/2} is the diagonal matrix of the inverse square roots
-    // of the eigenvalues, and U is the matrix of eigenvectors of J
-    for(int i=0; i<nQ_ref; ++i){
-        eigval[i] = (eigval[i] < 1.0E-10) ? 0.0 : 1.0 / sqrt(eigval[i]);
-        // scale one set of eigenvectors by the diagonal elements j^{-1/2}
-        C_DSCAL(nQ_ref, eigval[i], J[i], 1);
-    }
-    free(eigval);
-
-    // J_mhalf = J_copy(T) * J
-    C_DGEMM('t','n', nQ_ref, nQ_ref, nQ_ref, 1.0, J_copy[0], nQ_ref, J[0], nQ_ref, 0.0, J_mhalf[0], nQ_ref);
-    free_block(J);
-    free_block(J_copy);
+    C_DCOPY(nQ_ref * (size_t) nQ_ref, Jm12->pointer()[0], 1, J_mhalf[0], 1);
 
     // write J
     Jmhalf = SharedTensor2d(new Tensor2d("DF_BASIS_SCF Jmhalf <P|Q>", nQ_ref, nQ_ref));
@@ -33,6 +33,8 @@
 #include "defines.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libdiis/diismanager.h"
 
 
 
@@ -51,6 +53,7 @@ DFOCC::DFOCC(SharedWavefunction ref_wfn, Options &options)
 
 DFOCC::~DFOCC()
 {
+    Tensor2dPool::set_max_bytes(0);
 }//
 
 
@@ -65,6 +68,9 @@ void DFOCC::common_init()
     num_vecs=options_.get_int("MO_DIIS_NUM_VECS");
     cc_maxdiis_=options_.get_int("CC_DIIS_MAX_VECS");
     cc_mindiis_=options_.get_int("CC_DIIS_MIN_VECS");
+    if (options_.get_str("CC_DIIS_STORAGE") == "CORE") cc_diis_storage_ = DIISManager::InCore;
+    else if (options_.get_str("CC_DIIS_STORAGE") == "CORE_SINGLE") cc_diis_storage_ = DIISManager::InCoreSingle;
+    else cc_diis_storage_ = DIISManager::OnDisk;
     exp_cutoff=options_.get_int("CUTOFF");
     exp_int_cutoff=options_.get_int("INTEGRAL_CUTOFF");
     pcg_maxiter=options_.get_int("PCG_MAXITER");
@@ -112,8 +118,21 @@ void DFOCC::common_init()
     qchf_=options_.get_str("QCHF");
     cc_lambda_=options_.get_str("CC_LAMBDA");
     Wabef_type_=options_.get_str("PPL_TYPE");
+    cc_mixed_precision_=options_.get_bool("CC_MIXED_PRECISION");
+    tol_sp_switch=options_.get_double("CC_MIXED_PRECISION_SWITCH");
+    ccsd_sp_=false;
     triples_iabc_type_=options_.get_str("TRIPLES_IABC_TYPE");
     do_cd=options_.get_str("CHOLESKY");
+    do_pno_=options_.get_str("PNO");
+    tol_pno_=options_.get_double("PNO_CUTOFF");
+    rotate_df_ints_=options_.get_str("ROTATE_DF_INTS");
+    rotate_ref_cc=0;
+    rotate_ref_scf=0;
+    Epno_corr=0.0;
+
+    // Reuse the buffers of same-shape Tensor2d temporaries across iterations
+    if (options_.get_bool("TENSOR_POOL"))
+        Tensor2dPool::set_max_bytes((size_t)(options_.get_double("TENSOR_POOL_FRACTION") * Process::environment.get_memory()));
 
     //title
     title();
@@ -536,6 +555,8 @@ double DFOCC::compute_energy()
         else if (wfn_type_ == "DF-OLCCD") Etotal = ElccdL;
         else if (wfn_type_ == "QCHF") Etotal = Eref;
 
+        if (options_.get_bool("TENSOR_POOL") && print_ > 1) Tensor2dPool::print();
+
         return Etotal;
 
 } // end of compute_energy
@@ -336,6 +336,8 @@ protected:
     void trans_corr();
     void trans_ref();
     void trans_mp2();
+    void trans_rotate();
+    void rotate_bQ(std::string basis, int naux);
     void formJ(std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero);
     void formJ_ref(std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero);
     void b_so(std::shared_ptr<BasisSet> primary_, std::shared_ptr<BasisSet> auxiliary_, std::shared_ptr<BasisSet> zero);
@@ -474,6 +476,10 @@ protected:
     void ccsd_tau_amps(SharedTensor2d &U, SharedTensor2d &T);
     void ccsd_tau_tilde_amps(SharedTensor2d &U, SharedTensor2d &T);
     void ccsd_mp2_low();
+    // PNO truncation model of the RHF doubles, built from the MP2 guess; it models the
+    // accuracy of a PNO calculation, the contractions still run in the canonical virtuals
+    void pno_build(const SharedTensor2d& T, const SharedTensor2d& K);
+    void pno_project_amps(const SharedTensor2d& T);
     void ccsd_iterations_low();
     void ccsd_3index_intr_low();
     void ccsd_F_intr_low();
@@ -589,6 +595,11 @@ protected:
     std::map<std::string, SharedMatrix> gradients;
     std::vector<std::string> gradient_terms;
 
+    // Semicanonical PNOs (navirA x npno, row-major), their orbital energies and counts, per pair i>=j
+    std::vector<std::vector<double> > pno_Q_;
+    std::vector<std::vector<double> > pno_e_;
+    std::vector<int> pno_n_;
+
      int natom;
      int nmo;		// Number of MOs
      int nao;		// Number of AOs
@@ -670,7 +681,10 @@ protected:
      int time4grad;             // If 0 it is not the time for grad, if 1 it is the time for grad
      int cc_maxdiis_;           // MAX Number of vectors used in CC diis
      int cc_mindiis_;           // MIN Number of vectors used in CC diis
+     int cc_diis_storage_;      // DIISManager::StoragePolicy of the CC diis subspace
      int trans_ab;              // 0 means do not transform, 1 means do transform B(Q, ab)
+     int rotate_ref_cc;         // 1 once the reference-MO B(Q|pq) of the DF-CC basis is on disk
+     int rotate_ref_scf;        // 1 once the reference-MO B(Q|pq) of the DF-SCF basis is on disk
      int mo_optimized;          // 0 means MOs are not optimized, 1 means Mos are optimized
      int orbs_already_opt;      // 0 false, 1 true
      int orbs_already_sc;       // 0 false, 1 true
@@ -720,8 +734,11 @@ protected:
      double cutoff;
      double int_cutoff_;
      double tol_Eod;
+     double tol_pno_;
+     double Epno_corr;
      double tol_grad;
      double tol_t2;
+     double tol_sp_switch;
      double tol_pcg;
      double tol_ldl;
      double step_max;
@@ -847,12 +864,16 @@ protected:
      std::string guess_type_;
      std::string qchf_;
      std::string cc_lambda_;
+     std::string do_pno_;
+     std::string rotate_df_ints_;
      std::string Wabef_type_;
      std::string triples_iabc_type_;
 
      bool df_ints_incore;
      bool t2_incore;
      bool do_ppl_hm;
+     bool cc_mixed_precision_;
+     bool ccsd_sp_;                    // PPL term of this CCSD iteration in single precision
      bool do_triples_hm;
 
      double **C_pitzerA;
@@ -167,11 +167,12 @@ if (reference_ == "RESTRICTED") {
     K->gemm(true, false, bQiaA, bQiaA, 1.0, 0.0);
     t2->copy(K);
     t2->apply_denom_chem(nfrzc, noccA, FockA);
+    if (do_pno_ == "TRUE") pno_build(t2, K);
 
     // Form U(ia,jb) = 2*T(ia,jb) - T (ib,ja)
     U = SharedTensor2d(new Tensor2d("U2 (IA|JB)", naoccA, navirA, naoccA, navirA));
     ccsd_u2_amps(U,t2);
-    Ecorr = U->vector_dot(K);
+    Ecorr = U->vector_dot(K) + Epno_corr;
     U.reset();
     K.reset();
     Emp2 = Eref + Ecorr;
@@ -268,6 +269,7 @@ else if (reference_ == "UNRESTRICTED") {
 //======================================================================
 void DFOCC::ccsd_mp2_low()
 {
+    if (do_pno_ == "TRUE") throw PSIEXCEPTION("DFOCC: PNO truncation needs the T2 amplitudes in core");
     SharedTensor2d K, L, M, T, U, Tau;
     timer_on("MP2");
 if (reference_ == "RESTRICTED") {
@@ -404,11 +406,12 @@ if (reference_ == "RESTRICTED") {
     K->gemm(true, false, bQiaA, bQiaA, 1.0, 0.0);
     t2->copy(K);
     t2->apply_denom_chem(nfrzc, noccA, FockA);
+    if (do_pno_ == "TRUE") pno_build(t2, K);
 
     // Form U(ia,jb) = 2*T(ia,jb) - T (ib,ja)
     U = SharedTensor2d(new Tensor2d("U2 (IA|JB)", naoccA, navirA, naoccA, navirA));
     ccsd_u2_amps(U,t2);
-    Ecorr = U->vector_dot(K);
+    Ecorr = U->vector_dot(K) + Epno_corr;
     U.reset();
     K.reset();
     Emp2 = Eref + Ecorr;
@@ -530,6 +533,7 @@ else if (reference_ == "UNRESTRICTED") {
 //======================================================================
 void DFOCC::ccd_mp2_low()
 {
+    if (do_pno_ == "TRUE") throw PSIEXCEPTION("DFOCC: PNO truncation needs the T2 amplitudes in core");
     SharedTensor2d K, L, M, T, U, Tau;
     timer_on("MP2");
 if (reference_ == "RESTRICTED") {
@@ -120,8 +120,15 @@ do
 //==========================================================================================
 //========================= Trans TEI ======================================================
 //==========================================================================================
+    // DF, rotating the reference-MO integrals
+    if (do_cd == "FALSE" && rotate_df_ints_ == "TRUE") {
+        timer_on("DF Rotate Integrals");
+        trans_rotate();
+        timer_off("DF Rotate Integrals");
+    }// end if (rotate_df_ints_ == "TRUE")
+
     // DF
-    if (do_cd == "FALSE") {
+    else if (do_cd == "FALSE") {
         timer_on("DF CC Integrals");
         trans_corr();
         timer_off("DF CC Integrals");
@@ -0,0 +1,233 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/** Standard library includes */
+#include <cmath>
+
+#include "psi4/libqt/qt.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "defines.h"
+#include "dfocc.h"
+
+namespace psi{ namespace dfoccwave{
+
+//=======================================================
+//          PNO truncation model (RHF)
+//=======================================================
+//
+// Pair natural orbitals from the semicanonical MP2 pair densities
+//   D^ij = 2/(1+d_ij) (Tt^ij' T^ij + Tt^ij T^ij'),  Tt^ij = 2T^ij - T^ij'
+// Each pair keeps the PNOs with occupation at or above PNO_CUTOFF, rotated to
+// diagonalize the virtual Fock block. pno_project_amps() then confines the
+// doubles of pair ij to its PNO space in place of the canonical denominator
+// update, and the MP2 energy lost to the truncation is added back to the
+// correlation energy. This models the error of a PNO truncation: all
+// intermediates and contractions still run over the full canonical virtual
+// space, so it costs slightly more than the canonical calculation.
+//
+void DFOCC::pno_build(const SharedTensor2d& T, const SharedTensor2d& K)
+{
+    if (reference_ != "RESTRICTED") throw PSIEXCEPTION("DFOCC: PNO truncation is only available for RHF references");
+    if (orb_opt_ == "TRUE") throw PSIEXCEPTION("DFOCC: PNO truncation needs ORB_OPT FALSE");
+    if (dertype != "NONE" || cc_lambda_ == "TRUE" || oeprop_ == "TRUE")
+        throw PSIEXCEPTION("DFOCC: PNO truncation is only available for energies");
+
+    timer_on("PNO");
+    int nv = navirA;
+    int npair = naoccA * (naoccA + 1) / 2;
+    pno_Q_.assign(npair, std::vector<double>());
+    pno_e_.assign(npair, std::vector<double>());
+    pno_n_.assign(npair, 0);
+
+    double Efull = 0.0;
+    double Etrunc = 0.0;
+    long int npno = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:Efull,Etrunc,npno)
+    for (int ij = 0; ij < npair; ij++) {
+        int i = (int)((std::sqrt(8.0 * ij + 1.0) - 1.0) / 2.0);
+        while (i * (i + 1) / 2 > ij) i--;
+        while ((i + 1) * (i + 2) / 2 <= ij) i++;
+        int j = ij - i * (i + 1) / 2;
+
+        double **Tij = block_matrix(nv, nv);
+        double **Kij = block_matrix(nv, nv);
+        double **Tt = block_matrix(nv, nv);
+        double **D = block_matrix(nv, nv);
+        for (int a = 0; a < nv; a++) {
+            for (int b = 0; b < nv; b++) {
+                Tij[a][b] = T->get(i * nv + a, j * nv + b);
+                Kij[a][b] = K->get(i * nv + a, j * nv + b);
+            }
+        }
+        for (int a = 0; a < nv; a++) {
+            for (int b = 0; b < nv; b++) {
+                Tt[a][b] = 2.0 * Tij[a][b] - Tij[b][a];
+                if (i != j) Efull += 2.0 * Tt[a][b] * Kij[a][b];
+                else Efull += Tt[a][b] * Kij[a][b];
+            }
+        }
+
+        // Pair density and its natural orbitals (rows of D, ascending occupations)
+        double scale = (i == j ? 1.0 : 2.0);
+        C_DGEMM('t', 'n', nv, nv, nv, scale, Tt[0], nv, Tij[0], nv, 0.0, D[0], nv);
+        C_DGEMM('n', 't', nv, nv, nv, scale, Tt[0], nv, Tij[0], nv, 1.0, D[0], nv);
+        double *occ = init_array(nv);
+        double *work = init_array(3 * nv);
+        C_DSYEV('v', 'u', nv, D[0], nv, occ, work, 3 * nv);
+
+        int n = 0;
+        for (int k = 0; k < nv; k++) {
+            if (occ[k] >= tol_pno_) n++;
+        }
+
+        std::vector<double>& Q = pno_Q_[ij];
+        std::vector<double>& e = pno_e_[ij];
+        Q.assign((size_t)nv * n, 0.0);
+        e.assign(n, 0.0);
+        pno_n_[ij] = n;
+        npno += n;
+
+        if (n > 0) {
+            // Semicanonical PNOs: diagonalize the virtual Fock matrix in the kept space
+            double **F = block_matrix(n, n);
+            for (int p = 0; p < n; p++) {
+                double *dp = D[nv - n + p];
+                for (int q = 0; q <= p; q++) {
+                    double *dq = D[nv - n + q];
+                    double f = 0.0;
+                    for (int a = 0; a < nv; a++) f += dp[a] * FockA->get(a + noccA, a + noccA) * dq[a];
+                    F[p][q] = f;
+                    F[q][p] = f;
+                }
+            }
+            double *work2 = init_array(3 * n);
+            C_DSYEV('v', 'u', n, F[0], n, e.data(), work2, 3 * n);
+            free(work2);
+            // Q(a,p) = sum_q D(q,a) F(p,q)
+            C_DGEMM('t', 't', nv, n, n, 1.0, D[nv - n], nv, F[0], n, 0.0, Q.data(), n);
+            free_block(F);
+
+            // Truncated MP2 amplitudes of the pair, back in the canonical virtuals
+            double **X = block_matrix(nv, n);
+            double **t = block_matrix(n, n);
+            C_DGEMM('n', 'n', nv, n, nv, 1.0, Kij[0], nv, Q.data(), n, 0.0, X[0], n);
+            C_DGEMM('t', 'n', n, n, nv, 1.0, Q.data(), n, X[0], n, 0.0, t[0], n);
+            double fij = FockA->get(i + nfrzc, i + nfrzc) + FockA->get(j + nfrzc, j + nfrzc);
+            for (int p = 0; p < n; p++) {
+                for (int q = 0; q < n; q++) t[p][q] /= (fij - e[p] - e[q]);
+            }
+            C_DGEMM('n', 'n', nv, n, n, 1.0, Q.data(), n, t[0], n, 0.0, X[0], n);
+            C_DGEMM('n', 't', nv, nv, n, 1.0, X[0], n, Q.data(), n, 0.0, Tij[0], nv);
+            free_block(t);
+            free_block(X);
+        } else {
+            memset(Tij[0], 0, sizeof(double) * nv * nv);
+        }
+
+        for (int a = 0; a < nv; a++) {
+            for (int b = 0; b < nv; b++) {
+                double tt = 2.0 * Tij[a][b] - Tij[b][a];
+                if (i != j) Etrunc += 2.0 * tt * Kij[a][b];
+                else Etrunc += tt * Kij[a][b];
+                T->set(i * nv + a, j * nv + b, Tij[a][b]);
+                T->set(j * nv + b, i * nv + a, Tij[a][b]);
+            }
+        }
+
+        free(work);
+        free(occ);
+        free_block(D);
+        free_block(Tt);
+        free_block(Kij);
+        free_block(Tij);
+    }
+
+    Epno_corr = Efull - Etrunc;
+    timer_off("PNO");
+
+    outfile->Printf("\n\tPNO truncation model (PNO_CUTOFF = %.2e, canonical cost):\n", tol_pno_);
+    outfile->Printf("\tAverage PNOs per pair              : %20.2f of %d\n", (double)npno / npair, nv);
+    outfile->Printf("\tMP2 PNO truncation correction      : %20.14f\n", Epno_corr);
+}// end pno_build
+
+//=======================================================
+//          Projection of the doubles onto the PNO spaces
+//=======================================================
+//
+// T holds the doubles numerator (IA|JB); each pair is taken to its
+// semicanonical PNOs, divided by the orbital energy differences there and
+// brought back, which leaves it in the span of its PNOs. The pair blocks
+// stay nv x nv, so nothing downstream gets cheaper.
+//
+void DFOCC::pno_project_amps(const SharedTensor2d& T)
+{
+    int nv = navirA;
+    int npair = naoccA * (naoccA + 1) / 2;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int ij = 0; ij < npair; ij++) {
+        int i = (int)((std::sqrt(8.0 * ij + 1.0) - 1.0) / 2.0);
+        while (i * (i + 1) / 2 > ij) i--;
+        while ((i + 1) * (i + 2) / 2 <= ij) i++;
+        int j = ij - i * (i + 1) / 2;
+        int n = pno_n_[ij];
+
+        double **R = block_matrix(nv, nv);
+        if (n > 0) {
+            double *Q = pno_Q_[ij].data();
+            const std::vector<double>& e = pno_e_[ij];
+            for (int a = 0; a < nv; a++) {
+                for (int b = 0; b < nv; b++) R[a][b] = T->get(i * nv + a, j * nv + b);
+            }
+            double **X = block_matrix(nv, n);
+            double **t = block_matrix(n, n);
+            C_DGEMM('n', 'n', nv, n, nv, 1.0, R[0], nv, Q, n, 0.0, X[0], n);
+            C_DGEMM('t', 'n', n, n, nv, 1.0, Q, n, X[0], n, 0.0, t[0], n);
+            double fij = FockA->get(i + nfrzc, i + nfrzc) + FockA->get(j + nfrzc, j + nfrzc);
+            for (int p = 0; p < n; p++) {
+                for (int q = 0; q < n; q++) t[p][q] /= (fij - e[p] - e[q]);
+            }
+            C_DGEMM('n', 'n', nv, n, n, 1.0, Q, n, t[0], n, 0.0, X[0], n);
+            C_DGEMM('n', 't', nv, nv, n, 1.0, X[0], n, Q, n, 0.0, R[0], nv);
+            free_block(t);
+            free_block(X);
+        }
+        for (int a = 0; a < nv; a++) {
+            for (int b = 0; b < nv; b++) {
+                T->set(i * nv + a, j * nv + b, R[a][b]);
+                T->set(j * nv + b, i * nv + a, R[a][b]);
+            }
+        }
+        free_block(R);
+    }
+}// end pno_project_amps
+
+}} // End Namespaces
@@ -306,13 +306,14 @@ if (reference_ == "RESTRICTED") {
     bQiaA.reset();
     t2->copy(K);
     t2->apply_denom_chem(nfrzc, noccA, FockA);
+    if (do_pno_ == "TRUE") pno_build(t2, K);
     t2->write_symm(psio_, PSIF_DFOCC_AMPS);
 
     // Form U(ia,jb) = 2*T(ia,jb) - T (ib,ja)
     U = SharedTensor2d(new Tensor2d("U2 (IA|JB)", naoccA, navirA, naoccA, navirA));
     ccsd_u2_amps(U,t2);
     t2.reset();
-    Ecorr = U->vector_dot(K);
+    Ecorr = U->vector_dot(K) + Epno_corr;
     U.reset();
     K.reset();
     Emp2 = Eref + Ecorr;
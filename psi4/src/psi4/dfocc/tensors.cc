@@ -42,9 +42,81 @@
 #include <stdio.h>
 #include <fstream>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace psi{ namespace dfoccwave{
 
+/********************************************************************************************/
+/************************** 2d array pool ***************************************************/
+/********************************************************************************************/
+namespace {
+std::mutex pool_lock;
+std::map<std::pair<int,int>, std::vector<double**> > pool_blocks;
+size_t pool_max_bytes = 0;
+size_t pool_bytes = 0;
+size_t pool_hits = 0;
+size_t pool_misses = 0;
+}
+
+double **Tensor2dPool::get(int d1, int d2)
+{
+    double **A = NULL;
+    if (pool_max_bytes) {
+        std::lock_guard<std::mutex> lock(pool_lock);
+        auto it = pool_blocks.find(std::make_pair(d1, d2));
+        if (it != pool_blocks.end() && !it->second.empty()) {
+            A = it->second.back();
+            it->second.pop_back();
+            pool_bytes -= sizeof(double) * (size_t)d1 * (size_t)d2;
+            pool_hits++;
+        }
+        else pool_misses++;
+    }
+    // block_matrix() zeroes new blocks, reused ones are zeroed here
+    if (A) memset(A[0], 0, sizeof(double) * (size_t)d1 * (size_t)d2);
+    else A = block_matrix(d1, d2);
+    return A;
+}//
+
+void Tensor2dPool::put(double **A, int d1, int d2)
+{
+    if (!A) return;
+    size_t size = sizeof(double) * (size_t)d1 * (size_t)d2;
+    {
+        std::lock_guard<std::mutex> lock(pool_lock);
+        if (pool_bytes + size <= pool_max_bytes) {
+            pool_blocks[std::make_pair(d1, d2)].push_back(A);
+            pool_bytes += size;
+            return;
+        }
+    }
+    free_block(A);
+}//
+
+void Tensor2dPool::set_max_bytes(size_t max_bytes)
+{
+    std::lock_guard<std::mutex> lock(pool_lock);
+    pool_max_bytes = max_bytes;
+    if (max_bytes == 0) {
+        for (auto &it : pool_blocks)
+            for (double **A : it.second) free_block(A);
+        pool_blocks.clear();
+        pool_bytes = 0;
+        pool_hits = 0;
+        pool_misses = 0;
+    }
+}//
+
+void Tensor2dPool::print()
+{
+    std::lock_guard<std::mutex> lock(pool_lock);
+    outfile->Printf("\tTensor pool: %zu reused, %zu allocated, %.2f MB idle of %.2f MB.\n",
+                    pool_hits, pool_misses, pool_bytes / (1024.0 * 1024.0),
+                    pool_max_bytes / (1024.0 * 1024.0));
+}//
+
 
 /********************************************************************************************/
 /************************** 1d array ********************************************************/
@@ -558,8 +630,7 @@ Tensor2d::Tensor2d(std::string name, int d1, int d2, int d3, int d4)
 
   // memalloc
   if (A2d_) release();
-  A2d_ = block_matrix(dim1_, dim2_);
-  zero();
+  A2d_ = Tensor2dPool::get(dim1_, dim2_);
 
   // row idx
   row_idx_ = init_int_matrix(d1_, d2_);
@@ -614,8 +685,7 @@ Tensor2d::Tensor2d(std::string name, int d1, int d2, int d3)
 
   // memalloc
   if (A2d_) release();
-  A2d_ = block_matrix(dim1_, dim2_);
-  zero();
+  A2d_ = Tensor2dPool::get(dim1_, dim2_);
 
   // col idx
   col_idx_ = init_int_matrix(d2_, d3_);
@@ -643,15 +713,14 @@ Tensor2d::~Tensor2d()
 void Tensor2d::memalloc()
 {
     if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
-    zero();
+    A2d_ = Tensor2dPool::get(dim1_, dim2_);
 }//
 
 void Tensor2d::release()
 {
    //if (!A2d_) return;
    //free_block(A2d_);
-   if (A2d_) free_block(A2d_);
+   if (A2d_) Tensor2dPool::put(A2d_, dim1_, dim2_);
    if (row_idx_) free_int_matrix(row_idx_);
    if (col_idx_) free_int_matrix(col_idx_);
    if (row2d1_) delete [] row2d1_;
@@ -670,19 +739,20 @@ void Tensor2d::release()
 
 void Tensor2d::init(int d1,int d2)
 {
+    // release with the old shape, the block goes back to the pool under it
+    if (A2d_) release();
     dim1_=d1;
     dim2_=d2;
-    if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = Tensor2dPool::get(dim1_, dim2_);
 }//
 
 void Tensor2d::init(std::string name, int d1,int d2)
 {
+    if (A2d_) release();
     dim1_=d1;
     dim2_=d2;
     name_=name;
-    if (A2d_) release();
-    A2d_ = block_matrix(dim1_, dim2_);
+    A2d_ = Tensor2dPool::get(dim1_, dim2_);
 }//
 
 void Tensor2d::zero()
@@ -3854,6 +3924,20 @@ void Tensor2d::form_b_ab(const SharedTensor2d &A)
     }
 }//
 
+void Tensor2d::form_b_pq(int p0, int q0, const SharedTensor2d &A)
+{
+    #pragma omp parallel for
+    for (int Q = 0; Q < d1_; Q++) {
+         for (int p = 0; p < d2_; p++) {
+              for (int q = 0; q < d3_; q++) {
+                   int pq = col_idx_[p][q];
+                   int mo = A->col_idx_[p + p0][q + q0];
+                   A2d_[Q][pq] = A->A2d_[Q][mo];
+              }
+         }
+    }
+}//
+
 void Tensor2d::form_b_kl(const SharedTensor2d &A)
 {
     int naux = d1_;
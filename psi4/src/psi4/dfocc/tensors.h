@@ -61,6 +61,19 @@ typedef std::shared_ptr<Tensor1i> SharedTensor1i;
 typedef std::shared_ptr<Tensor2i> SharedTensor2i;
 typedef std::shared_ptr<Tensor3i> SharedTensor3i;
 
+// Keeps the storage of released Tensor2d objects and hands it to later
+// tensors of the same shape, so the temporaries built in every iteration
+// skip the allocation and the page faults of fresh memory.  Pooling is off
+// until set_max_bytes() is called with the idle memory it may hold.
+class Tensor2dPool
+{
+  public:
+  static double **get(int d1, int d2);              // zeroed d1 x d2 block
+  static void put(double **A, int d1, int d2);
+  static void set_max_bytes(size_t max_bytes);      // 0 frees and disables the pool
+  static void print();
+};
+
 class Tensor1d
 {
 
@@ -406,6 +419,8 @@ class Tensor2d
   void form_b_ij(int frzc, const SharedTensor2d &A);
   void form_b_ia(int frzc, const SharedTensor2d &A);
   void form_b_ab(const SharedTensor2d &A);
+  // form_b_pq: b(Q,pq) = A(Q, p+p0, q+q0), a block of an all-MO A
+  void form_b_pq(int p0, int q0, const SharedTensor2d &A);
   // form_b_kl: k is active occupied, and l is frozen core
   void form_b_kl(const SharedTensor2d &A);
   // form_b_ki: k is active occupied, and i is all occupied
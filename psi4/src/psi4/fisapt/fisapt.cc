@@ -29,6 +29,7 @@
 #include "psi4/fisapt/fisapt.h"
 #include "psi4/fisapt/local2.h"
 
+#include "psi4/lib3index/df_helper.h"
 #include "psi4/libthce/thce.h"
 #include "psi4/libthce/lreri.h"
 #include "psi4/libfock/jk.h"
@@ -1328,16 +1329,75 @@ void FISAPT::exch()
     // ==> Exchange Terms (S^2, MCBS or DCBS) <== //
 
     std::shared_ptr<Matrix> C_O = Matrix::triplet(D_B,S,Cocc_A);
+    std::shared_ptr<Matrix> C_AS = Matrix::triplet(P_B,S,Cocc_A);
+
+    // => T Matrix (S^\infty) <= //
+
+    int na  = matrices_["Cocc0A"]->colspi()[0];
+    int nb  = matrices_["Cocc0B"]->colspi()[0];
+    int nbf = matrices_["Cocc0A"]->rowspi()[0];
+
+    std::shared_ptr<Matrix> Sab = Matrix::triplet(matrices_["Cocc0A"],S,matrices_["Cocc0B"],true,false,false);
+    double** Sabp = Sab->pointer();
+    std::shared_ptr<Matrix> T(new Matrix("T", na+nb, na+nb));
+    T->identity();
+    double** Tp = T->pointer();
+    for (int a = 0; a < na; a++) {
+        for (int b = 0; b < nb; b++) {
+            Tp[a][b+na] = Tp[b+na][a] = Sabp[a][b];
+        }
+    }
+    //T->print();
+    T->power(-1.0,1.0E-12);
+    Tp = T->pointer();
+    for (int a = 0; a < na+nb; a++) {
+        Tp[a][a] -= 1.0;
+    }
+    //T->print();
+
+    std::shared_ptr<Matrix> C_T_A_n(new Matrix("C_T_A_n", nbf, na));
+    std::shared_ptr<Matrix> C_T_B_n(new Matrix("C_T_A_n", nbf, nb));
+    std::shared_ptr<Matrix> C_T_BA_n(new Matrix("C_T_BA_n", nbf, nb));
+    std::shared_ptr<Matrix> C_T_AB_n(new Matrix("C_T_AB_n", nbf, na));
+
+    C_DGEMM('N','N',nbf,na,na,1.0,matrices_["Cocc0A"]->pointer()[0],na,&Tp[0][0],na+nb,0.0,C_T_A_n->pointer()[0],na);
+    C_DGEMM('N','N',nbf,nb,nb,1.0,matrices_["Cocc0B"]->pointer()[0],nb,&Tp[na][na],na+nb,0.0,C_T_B_n->pointer()[0],nb);
+    C_DGEMM('N','N',nbf,nb,na,1.0,matrices_["Cocc0A"]->pointer()[0],na,&Tp[0][na],na+nb,0.0,C_T_BA_n->pointer()[0],nb);
+    C_DGEMM('N','N',nbf,na,nb,1.0,matrices_["Cocc0B"]->pointer()[0],nb,&Tp[na][0],na+nb,0.0,C_T_AB_n->pointer()[0],na);
+
+    // => All exchange J/K builds in one pass <= //
+
     std::vector<SharedMatrix>& Cl = jk_->C_left();
     std::vector<SharedMatrix>& Cr = jk_->C_right();
     const std::vector<SharedMatrix>& J = jk_->J();
     const std::vector<SharedMatrix>& K = jk_->K();
     Cl.clear();
     Cr.clear();
+    // J/K[O]
     Cl.push_back(Cocc_A);
     Cr.push_back(C_O);
+    // K_AS
+    Cl.push_back(Cocc_A);
+    Cr.push_back(C_AS);
+    // J/K[T^A, S^\infty]
+    Cl.push_back(matrices_["Cocc0A"]);
+    Cr.push_back(C_T_A_n);
+    // J/K[T^AB, S^\infty]
+    Cl.push_back(matrices_["Cocc0A"]);
+    Cr.push_back(C_T_AB_n);
+
     jk_->compute();
-    std::shared_ptr<Matrix> K_O = K[0];
+
+    std::shared_ptr<Matrix> K_O      = K[0];
+    std::shared_ptr<Matrix> K_AS     = K[1];
+    std::shared_ptr<Matrix> J_T_A_n  = J[2];
+    std::shared_ptr<Matrix> K_T_A_n  = K[2];
+    std::shared_ptr<Matrix> J_T_AB_n = J[3];
+    std::shared_ptr<Matrix> K_T_AB_n = K[3];
+
+    // ind() needs J/K[O] as well
+    matrices_["J_O"] = J[0]->clone();
+    matrices_["K_O"] = K[0]->clone();
 
     double Exch10_2M = 0.0;
     std::vector<double> Exch10_2M_terms;
@@ -1367,16 +1427,6 @@ void FISAPT::exch()
 
     // ==> Exchange Terms (S^2, DCBS only) <== //
 
-    // => K_AS <= //
-
-    std::shared_ptr<Matrix> C_AS = Matrix::triplet(P_B,S,Cocc_A);
-    Cl.clear();
-    Cr.clear();
-    Cl.push_back(Cocc_A);
-    Cr.push_back(C_AS);
-    jk_->compute();
-    std::shared_ptr<Matrix> K_AS = K[0];
-
     // => Accumulation <= //
 
     double Exch10_2 = 0.0;
@@ -1400,57 +1450,6 @@ void FISAPT::exch()
 
     // ==> Exchange Terms (S^\infty, MCBS or DCBS) <== //
 
-    // => T Matrix <= //
-
-    int na  = matrices_["Cocc0A"]->colspi()[0];
-    int nb  = matrices_["Cocc0B"]->colspi()[0];
-    int nbf = matrices_["Cocc0A"]->rowspi()[0];
-
-    std::shared_ptr<Matrix> Sab = Matrix::triplet(matrices_["Cocc0A"],S,matrices_["Cocc0B"],true,false,false);
-    double** Sabp = Sab->pointer();
-    std::shared_ptr<Matrix> T(new Matrix("T", na+nb, na+nb));
-    T->identity();
-    double** Tp = T->pointer();
-    for (int a = 0; a < na; a++) {
-        for (int b = 0; b < nb; b++) {
-            Tp[a][b+na] = Tp[b+na][a] = Sabp[a][b];
-        }
-    }
-    //T->print();
-    T->power(-1.0,1.0E-12);
-    Tp = T->pointer();
-    for (int a = 0; a < na+nb; a++) {
-        Tp[a][a] -= 1.0;
-    }
-    //T->print();
-
-    std::shared_ptr<Matrix> C_T_A_n(new Matrix("C_T_A_n", nbf, na));
-    std::shared_ptr<Matrix> C_T_B_n(new Matrix("C_T_A_n", nbf, nb));
-    std::shared_ptr<Matrix> C_T_BA_n(new Matrix("C_T_BA_n", nbf, nb));
-    std::shared_ptr<Matrix> C_T_AB_n(new Matrix("C_T_AB_n", nbf, na));
-
-    C_DGEMM('N','N',nbf,na,na,1.0,matrices_["Cocc0A"]->pointer()[0],na,&Tp[0][0],na+nb,0.0,C_T_A_n->pointer()[0],na);
-    C_DGEMM('N','N',nbf,nb,nb,1.0,matrices_["Cocc0B"]->pointer()[0],nb,&Tp[na][na],na+nb,0.0,C_T_B_n->pointer()[0],nb);
-    C_DGEMM('N','N',nbf,nb,na,1.0,matrices_["Cocc0A"]->pointer()[0],na,&Tp[0][na],na+nb,0.0,C_T_BA_n->pointer()[0],nb);
-    C_DGEMM('N','N',nbf,na,nb,1.0,matrices_["Cocc0B"]->pointer()[0],nb,&Tp[na][0],na+nb,0.0,C_T_AB_n->pointer()[0],na);
-
-    // => K Terms <= //
-
-    Cl.clear();
-    Cr.clear();
-    // J/K[T^A, S^\infty]
-    Cl.push_back(matrices_["Cocc0A"]);
-    Cr.push_back(C_T_A_n);
-    // J/K[T^AB, S^\infty]
-    Cl.push_back(matrices_["Cocc0A"]);
-    Cr.push_back(C_T_AB_n);
-
-    jk_->compute();
-
-    std::shared_ptr<Matrix> J_T_A_n  = J[0];
-    std::shared_ptr<Matrix> K_T_A_n  = K[0];
-    std::shared_ptr<Matrix> J_T_AB_n = J[1];
-    std::shared_ptr<Matrix> K_T_AB_n = K[1];
 
     std::shared_ptr<Matrix> T_A_n  = Matrix::doublet(matrices_["Cocc0A"], C_T_A_n, false, true);
     std::shared_ptr<Matrix> T_B_n  = Matrix::doublet(matrices_["Cocc0B"], C_T_B_n, false, true);
@@ -1543,9 +1542,12 @@ void FISAPT::ind()
     Cl.clear();
     Cr.clear();
 
-    // J/K[O]
-    Cl.push_back(matrices_["Cocc_A"]);
-    Cr.push_back(C_O_A);
+    // J/K[O] was built by exch()
+    bool have_O = matrices_.count("J_O") && matrices_.count("K_O");
+    if (!have_O) {
+        Cl.push_back(matrices_["Cocc_A"]);
+        Cr.push_back(C_O_A);
+    }
     // J/K[P_B]
     Cl.push_back(matrices_["Cocc_A"]);
     Cr.push_back(C_P_B);
@@ -1559,13 +1561,14 @@ void FISAPT::ind()
 
     // => Unload the JK Object <= //
 
-    std::shared_ptr<Matrix> J_O      = J[0];
-    std::shared_ptr<Matrix> J_P_B    = J[1];
-    std::shared_ptr<Matrix> J_P_A    = J[2];
+    int off = (have_O ? 0 : 1);
+    std::shared_ptr<Matrix> J_O      = (have_O ? matrices_["J_O"] : J[0]);
+    std::shared_ptr<Matrix> J_P_B    = J[off];
+    std::shared_ptr<Matrix> J_P_A    = J[off + 1];
 
-    std::shared_ptr<Matrix> K_O      = K[0];
-    std::shared_ptr<Matrix> K_P_B    = K[1];
-    std::shared_ptr<Matrix> K_P_A    = K[2];
+    std::shared_ptr<Matrix> K_O      = (have_O ? matrices_["K_O"] : K[0]);
+    std::shared_ptr<Matrix> K_P_B    = K[off];
+    std::shared_ptr<Matrix> K_P_A    = K[off + 1];
 
     // ==> Generalized ESP (Flat and Exchange) <== //
 
@@ -2731,6 +2734,57 @@ void FISAPT::flocalize()
         matrices_["Qocc0B"]->set_name("Qocc0B");
     }
 }
+std::shared_ptr<df_helper::DF_Helper> FISAPT::fsapt_dfh()
+{
+    if (dfh_) {
+        dfh_->clear();
+        dfh_->set_MO_hint(primary_->nbf());
+        return dfh_;
+    }
+
+    std::shared_ptr<BasisSet> jkfit = reference_->get_basisset("DF_BASIS_SCF");
+    size_t nn = primary_->nbf();
+    size_t nQ = jkfit->nbf();
+
+    dfh_ = df_helper::DF_Helper::get_shared(primary_, jkfit, nn);
+    if (dfh_) return dfh_;
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    dfh_ = std::make_shared<df_helper::DF_Helper>(primary_, jkfit);
+    dfh_->set_memory(doubles_);
+    dfh_->set_method("STORE");
+    dfh_->set_nthreads(nthread);
+    dfh_->set_schwarz_cutoff(options_.get_double("INTS_TOLERANCE"));
+    dfh_->set_MO_hint(nn);
+    // The AO tensor plus the transformed pairs, which together never span more than nn x nn
+    dfh_->set_on_core(2L * nQ * nn * nn <= doubles_);
+    dfh_->initialize();
+    return dfh_;
+}
+std::shared_ptr<Matrix> FISAPT::fsapt_dfh_slice(const std::string& name, size_t p)
+{
+    std::tuple<size_t, size_t, size_t> shape = dfh_->get_tensor_shape(name);
+    size_t nQ = std::get<0>(shape);
+    size_t np = std::get<1>(shape);
+    size_t nq = std::get<2>(shape);
+
+    // get_tensor reads the range (0, 0) as the whole axis, so p = 0 comes out of the first two
+    if (p > 0 || np == 1) {
+        return dfh_->get_tensor(name, std::make_pair(0, 0), std::make_pair(p, p), std::make_pair(0, 0));
+    }
+    std::shared_ptr<Matrix> two = dfh_->get_tensor(name, std::make_pair(0, 0), std::make_pair(0, 1), std::make_pair(0, 0));
+    std::shared_ptr<Matrix> one(new Matrix(name, nQ, nq));
+    double** twop = two->pointer();
+    double** onep = one->pointer();
+    for (size_t Q = 0; Q < nQ; Q++) {
+        C_DCOPY(nq, twop[Q], 1, onep[Q], 1);
+    }
+    return one;
+}
 void FISAPT::felst()
 {
     outfile->Printf("  ==> F-SAPT Electrostatics <==\n\n");
@@ -2771,53 +2825,26 @@ void FISAPT::felst()
     std::shared_ptr<BasisSet> jkfit = reference_->get_basisset("DF_BASIS_SCF");
     size_t nQ = jkfit->nbf();
 
-    std::shared_ptr<DFERI> df = DFERI::build(primary_,jkfit,options_);
-    df->clear();
-
-    std::vector<std::shared_ptr<Matrix> > Cs;
-    Cs.push_back(matrices_["Locc0A"]);
-    Cs.push_back(matrices_["Locc0B"]);
-    std::shared_ptr<Matrix> Call = Matrix::horzcat(Cs);
-    Cs.clear();
-
-    df->set_C(Call);
-    df->set_memory(doubles_);
-
-    size_t offset = 0;
-    df->add_space("a",offset,offset+na); offset += na;
-    df->add_space("b",offset,offset+nb); offset += nb;
-
-    df->add_pair_space("Aaa", "a", "a");
-    df->add_pair_space("Abb", "b", "b");
-
-    df->print_header();
-    df->compute();
-
-    std::map<std::string, std::shared_ptr<Tensor> >& ints = df->ints();
-    std::shared_ptr<Tensor> AaaT = ints["Aaa"];
-    std::shared_ptr<Tensor> AbbT = ints["Abb"];
-
-    df.reset();
+    std::shared_ptr<df_helper::DF_Helper> dfh = fsapt_dfh();
+    dfh->add_space("a", matrices_["Locc0A"]);
+    dfh->add_space("b", matrices_["Locc0B"]);
+    dfh->add_transformation("Aaa", "a", "a");
+    dfh->add_transformation("Abb", "b", "b");
+    dfh->transform();
 
     std::shared_ptr<Matrix> QaC(new Matrix("QaC", na, nQ));
     double** QaCp = QaC->pointer();
-    FILE* Aaaf = AaaT->file_pointer();
-    fseek(Aaaf,0L,SEEK_SET);
     for (size_t a = 0; a < na; a++) {
-        fseek(Aaaf,(a * na + a) * nQ * sizeof(double), SEEK_SET);
-        size_t statusvalue=fread(QaCp[a], sizeof(double), nQ, Aaaf);
+        double** Qap = fsapt_dfh_slice("Aaa", a)->pointer();
+        C_DCOPY(nQ, &Qap[0][a], na, QaCp[a], 1);
     }
-    AaaT.reset();
 
     std::shared_ptr<Matrix> QbC(new Matrix("QbC", nb, nQ));
     double** QbCp = QbC->pointer();
-    FILE* Abbf = AbbT->file_pointer();
-    fseek(Abbf,0L,SEEK_SET);
     for (size_t b = 0; b < nb; b++) {
-        fseek(Abbf,(b * nb + b) * nQ * sizeof(double), SEEK_SET);
-        size_t statusvalue=fread(QbCp[b], sizeof(double), nQ, Abbf);
+        double** Qbp = fsapt_dfh_slice("Abb", b)->pointer();
+        C_DCOPY(nQ, &Qbp[0][b], nb, QbCp[b], 1);
     }
-    AbbT.reset();
 
     std::shared_ptr<Matrix> Elst10_3 = Matrix::doublet(QaC,QbC,false,true);
     double** Elst10_3p = Elst10_3->pointer();
@@ -2934,37 +2961,14 @@ void FISAPT::fexch()
     std::shared_ptr<BasisSet> jkfit = reference_->get_basisset("DF_BASIS_SCF");
     int nQ = jkfit->nbf();
 
-    std::shared_ptr<DFERI> df = DFERI::build(primary_,jkfit,options_);
-    df->clear();
-
-    std::vector<std::shared_ptr<Matrix> > Cs;
-    Cs.push_back(LoccA);
-    Cs.push_back(CvirA);
-    Cs.push_back(LoccB);
-    Cs.push_back(CvirB);
-    std::shared_ptr<Matrix> Call = Matrix::horzcat(Cs);
-    Cs.clear();
-
-    df->set_C(Call);
-    df->set_memory(doubles_);
-
-    int offset = 0;
-    df->add_space("a",offset,offset+na); offset+=na;
-    df->add_space("r",offset,offset+nr); offset+=nr;
-    df->add_space("b",offset,offset+nb); offset+=nb;
-    df->add_space("s",offset,offset+ns); offset+=ns;
-
-    df->add_pair_space("Aar", "a", "r");
-    df->add_pair_space("Abs", "b", "s");
-
-    df->print_header();
-    df->compute();
-
-    std::map<std::string, std::shared_ptr<Tensor> >& ints = df->ints();
-    std::shared_ptr<Tensor> AarT = ints["Aar"];
-    std::shared_ptr<Tensor> AbsT = ints["Abs"];
-
-    df.reset();
+    std::shared_ptr<df_helper::DF_Helper> dfh = fsapt_dfh();
+    dfh->add_space("a", LoccA);
+    dfh->add_space("r", CvirA);
+    dfh->add_space("b", LoccB);
+    dfh->add_space("s", CvirB);
+    dfh->add_transformation("Aar", "a", "r");
+    dfh->add_transformation("Abs", "b", "s");
+    dfh->transform();
 
     // ==> Electrostatic Potentials <== //
 
@@ -3020,34 +3024,26 @@ void FISAPT::fexch()
     //E_exch1->print();
     //E_exch2->print();
 
-    std::shared_ptr<Matrix> TrQ(new Matrix("TrQ",nr,nQ));
-    double** TrQp = TrQ->pointer();
-    std::shared_ptr<Matrix> TsQ(new Matrix("TsQ",ns,nQ));
-    double** TsQp = TsQ->pointer();
     std::shared_ptr<Matrix> TbQ(new Matrix("TbQ",nb,nQ));
     double** TbQp = TbQ->pointer();
     std::shared_ptr<Matrix> TaQ(new Matrix("TaQ",na,nQ));
     double** TaQp = TaQ->pointer();
 
     std::shared_ptr<Tensor> BabT = DiskTensor::build("BabT","na",na,"nb",nb,"nQ",nQ,false,false);
-    FILE* Aarf = AarT->file_pointer();
     FILE* Babf = BabT->file_pointer();
     fseek(Babf,0L,SEEK_SET);
-    fseek(Aarf,0L,SEEK_SET);
     for (int a = 0; a < na; a++) {
-        size_t statusvalue=fread(TrQp[0],sizeof(double),nr*nQ,Aarf);
-        C_DGEMM('N','N',nb,nQ,nr,1.0,Sbrp[0],nr,TrQp[0],nQ,0.0,TbQp[0],nQ);
+        double** QrTp = fsapt_dfh_slice("Aar", a)->pointer();
+        C_DGEMM('N','T',nb,nQ,nr,1.0,Sbrp[0],nr,QrTp[0],nr,0.0,TbQp[0],nQ);
         fwrite(TbQp[0],sizeof(double),nb*nQ,Babf);
     }
 
     std::shared_ptr<Tensor> BbaT = DiskTensor::build("BbaT","nb",nb,"na",na,"nQ",nQ,false,false);
-    FILE* Absf = AbsT->file_pointer();
     FILE* Bbaf = BbaT->file_pointer();
     fseek(Bbaf,0L,SEEK_SET);
-    fseek(Absf,0L,SEEK_SET);
     for (int b = 0; b < nb; b++) {
-        size_t statusvalue=fread(TsQp[0],sizeof(double),ns*nQ,Absf);
-        C_DGEMM('N','N',na,nQ,ns,1.0,Sasp[0],ns,TsQp[0],nQ,0.0,TaQp[0],nQ);
+        double** QsTp = fsapt_dfh_slice("Abs", b)->pointer();
+        C_DGEMM('N','T',na,nQ,ns,1.0,Sasp[0],ns,QsTp[0],ns,0.0,TaQp[0],nQ);
         fwrite(TaQp[0],sizeof(double),na*nQ,Bbaf);
     }
 
@@ -3188,73 +3184,46 @@ void FISAPT::find()
     std::shared_ptr<BasisSet> jkfit = reference_->get_basisset("DF_BASIS_SCF");
     size_t nQ = jkfit->nbf();
 
-    std::shared_ptr<DFERI> df = DFERI::build(primary_,jkfit,options_);
-    df->clear();
-
-    std::vector<std::shared_ptr<Matrix> > Cs;
-    Cs.push_back(Cocc_A);
-    Cs.push_back(Cvir_A);
-    Cs.push_back(Cocc_B);
-    Cs.push_back(Cvir_B);
-    std::shared_ptr<Matrix> Call = Matrix::horzcat(Cs);
-    Cs.clear();
-
-    df->set_C(Call);
-    df->set_memory(doubles_);
-
-    int offset = 0;
-    df->add_space("a",offset,offset+na); offset += na;
-    df->add_space("r",offset,offset+nr); offset += nr;
-    df->add_space("b",offset,offset+nb); offset += nb;
-    df->add_space("s",offset,offset+ns); offset += ns;
-
-    df->add_pair_space("Aar", "a", "r");
-    df->add_pair_space("Abs", "b", "s");
-
-    df->print_header();
-    df->compute();
-
-    std::map<std::string, std::shared_ptr<Tensor> >& ints = df->ints();
-    std::shared_ptr<Tensor> AarT = ints["Aar"];
-    std::shared_ptr<Tensor> AbsT = ints["Abs"];
-
-    df.reset();
+    std::shared_ptr<df_helper::DF_Helper> dfh = fsapt_dfh();
+    dfh->add_space("a", Cocc_A);
+    dfh->add_space("r", Cvir_A);
+    dfh->add_space("b", Cocc_B);
+    dfh->add_space("s", Cvir_B);
+    dfh->add_transformation("Aar", "a", "r");
+    dfh->add_transformation("Abs", "b", "s");
+    dfh->transform();
 
     // => Electronic Part (Massive PITA) <= //
 
     double** RaCp = matrices_["Vlocc0A"]->pointer();
     double** RbDp = matrices_["Vlocc0B"]->pointer();
 
-    FILE* Absf = AbsT->file_pointer();
-    fseek(Absf,0L,SEEK_SET);
-    std::shared_ptr<Matrix> TsQ(new Matrix("TsQ",ns,nQ));
     std::shared_ptr<Matrix> T1As(new Matrix("T1As",na,ns));
-    double** TsQp = TsQ->pointer();
     double** T1Asp = T1As->pointer();
     for (size_t b = 0; b < nb; b++) {
-        size_t statusvalue=fread(TsQp[0],sizeof(double),ns*nQ,Absf);
-        C_DGEMM('N','T',na,ns,nQ,2.0,RaCp[0],nQ,TsQp[0],nQ,0.0,T1Asp[0],ns);
+        double** QsTp = fsapt_dfh_slice("Abs", b)->pointer();
+        C_DGEMM('N','N',na,ns,nQ,2.0,RaCp[0],nQ,QsTp[0],ns,0.0,T1Asp[0],ns);
         for (size_t a = 0; a < na; a++) {
             fseek(WAbsf,nA*nb*ns*sizeof(double) + a*nb*ns*sizeof(double) + b*ns*sizeof(double),SEEK_SET);
             fwrite(T1Asp[a],sizeof(double),ns,WAbsf);
         }
     }
 
-    FILE* Aarf = AarT->file_pointer();
-    fseek(Aarf,0L,SEEK_SET);
-    std::shared_ptr<Matrix> TrQ(new Matrix("TrQ",nr,nQ));
     std::shared_ptr<Matrix> T1Br(new Matrix("T1Br",nb,nr));
-    double** TrQp = TrQ->pointer();
     double** T1Brp = T1Br->pointer();
     for (size_t a = 0; a < na; a++) {
-        size_t statusvalue=fread(TrQp[0],sizeof(double),nr*nQ,Aarf);
-        C_DGEMM('N','T',nb,nr,nQ,2.0,RbDp[0],nQ,TrQp[0],nQ,0.0,T1Brp[0],nr);
+        double** QrTp = fsapt_dfh_slice("Aar", a)->pointer();
+        C_DGEMM('N','N',nb,nr,nQ,2.0,RbDp[0],nQ,QrTp[0],nr,0.0,T1Brp[0],nr);
         for (size_t b = 0; b < nb; b++) {
             fseek(WBarf,nB*na*nr*sizeof(double) + b*na*nr*sizeof(double) + a*nr*sizeof(double),SEEK_SET);
             fwrite(T1Brp[b],sizeof(double),nr,WBarf);
         }
     }
 
+    // Last use of the JKFIT integrals, fdisp fits in its own basis
+    dfh.reset();
+    dfh_.reset();
+
     // ==> Stack Variables <== //
 
     double*  eap = eps_occ_A->pointer();
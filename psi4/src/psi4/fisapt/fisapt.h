@@ -40,6 +40,10 @@ namespace psi {
 
 class JK;
 
+namespace df_helper {
+class DF_Helper;
+}
+
 namespace fisapt {
 
 class FISAPT {
@@ -61,6 +65,8 @@ protected:
 
     /// Global JK object
     std::shared_ptr<JK> jk_;
+    /// Fitted (Q|mn) in the SCF fitting basis, transformed by felst, fexch, and find
+    std::shared_ptr<df_helper::DF_Helper> dfh_;
 
     /// Map of scalars
     std::map<std::string, double> scalars_;
@@ -111,6 +117,11 @@ protected:
     /// Output
     void fdrop();
 
+    /// dfh_, built on first use (in core if it fits), cleared of earlier spaces
+    std::shared_ptr<df_helper::DF_Helper> fsapt_dfh();
+    /// (Q|pq) of the transformed dfh_ tensor name for one p, as an nQ x nq matrix
+    std::shared_ptr<Matrix> fsapt_dfh_slice(const std::string& name, size_t p);
+
     // => SAPT0 <= //
 
     /// Delta HF
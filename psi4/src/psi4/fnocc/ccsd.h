@@ -103,6 +103,11 @@ class CoupledCluster: public Wavefunction{
     PsiReturnType lowmemory_triples();
     double et;
 
+    /// rank and number of MPI ranks sharing the (T) loops (0 and 1 unless TRIPLES_DISTRIBUTED)
+    void triples_ranks(int &rank, int &nrank);
+    /// sum each rank's share of the (T) energy
+    double triples_reduce(double myet, int nrank);
+
     /// mp4 triples
     void mp4_triples();
     double emp4_t;
@@ -246,6 +251,8 @@ class DFCoupledCluster : public CoupledCluster{
 
     /// workspace buffers.
     double*Abij,*Sbij;
+    /// length of integrals, in doubles
+    long int dim_integrals;
 
     /// check energy
     virtual double CheckEnergy();
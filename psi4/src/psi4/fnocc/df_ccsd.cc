@@ -665,6 +665,7 @@ void DFCoupledCluster::AllocateMemory() {
   // max (v*v*nQ, full*ndocc*nQ)
   Qvv = (double*)malloc(max*sizeof(double));
 
+  dim_integrals = dim;
   integrals = (double*)malloc(dim*sizeof(double));
   tempt     = (double*)malloc((o*(o+1)*v*(v+1)+o*v)*sizeof(double));
   tempv     = (double*)malloc(tempvdim*sizeof(double));
@@ -833,12 +834,6 @@ void DFCoupledCluster::Vabcd1(){
     psio->open(PSIF_DCC_R2,PSIO_OPEN_OLD);
     psio->read_entry(PSIF_DCC_R2,"residual",(char*)&tempv[0],o*o*v*v*sizeof(double));
 
-    int nthreads = Process::environment.get_n_threads();
-
-    double * Vcdb = integrals;
-    double * Vm   = integrals+v*v*v;
-    double * Vp   = Vm;
-
     // qvv transpose
     #pragma omp parallel for schedule (static)
     for (int q = 0; q < nQ; q++) {
@@ -846,69 +841,63 @@ void DFCoupledCluster::Vabcd1(){
     }
     C_DCOPY(nQ*v*v,integrals,1,Qvv,1);
 
-    double time1 = 0.0;
-    double time2 = 0.0;
-    double time3 = 0.0;
-    for (long int a = 0; a < v; a++) {
+    // The ladder is built one (a, b-tile) at a time: (ac|bd) for the tile
+    // comes straight from Qvv, its symmetric and antisymmetric cd packings
+    // are formed in a single pass, and both are contracted before the next
+    // tile. Scratch per tile is nbt(v^2 + v(v+1)), which the integrals
+    // buffer (at least 2v^3) holds for tiles of almost v columns.
+    long int btile = dim_integrals / (v*v + 2L*vtri);
+    if (btile > v) btile = v;
+    if (btile < 1) btile = 1;
 
-        double start1 = omp_get_wtime();
-        int nb = v-a;
-        F_DGEMM('t','n',v,v*nb,nQ,1.0,Qvv+a*v*nQ,nQ,Qvv+a*v*nQ,nQ,0.0,Vcdb,v);
-
-        #pragma omp parallel for schedule (static)
-        for (long int b = a; b < v; b++){
-            long int cd = 0;
-            long int ind1 = (b-a)*vtri;
-            long int ind2 = (b-a)*v*v;
-            long int v1,v2;
-            for (long int c=0; c<v; c++){
-                for (long int d=0; d<=c; d++){
-                    Vp[ind1+cd] = Vcdb[ind2+d*v+c] + Vcdb[ind2+c*v+d];
-                    cd++;
-                }
-            }
-        }
-        double end1 = omp_get_wtime();
-
-        double start2 = omp_get_wtime();
-        F_DGEMM('n','n',otri,nb,vtri,0.5,tempt,otri,Vp,vtri,0.0,Abij,otri);
-        #pragma omp parallel for schedule (static)
-        for (long int b = a; b < v; b++){
-            long int cd = 0;
-            long int ind1 = (b-a)*vtri;
-            long int ind2 = (b-a)*v*v;
-            long int v1,v2;
-            for (long int c=0; c<v; c++){
-                for (long int d=0; d<=c; d++){
-                    Vm[ind1+cd] = Vcdb[ind2+d*v+c] - Vcdb[ind2+c*v+d];
-                    cd++;
+    double * Vcdb = integrals;
+    double * Vp   = Vcdb + v*v*btile;
+    double * Vm   = Vp + vtri*btile;
+
+    for (long int a = 0; a < v; a++) {
+        for (long int b0 = a; b0 < v; b0 += btile) {
+            long int nb = (v - b0 < btile) ? v - b0 : btile;
+
+            // (ca|db) for b in [b0, b0+nb): Vcdb[b][d][c]
+            F_DGEMM('t','n',v,v*nb,nQ,1.0,Qvv+a*v*nQ,nQ,Qvv+b0*v*nQ,nQ,0.0,Vcdb,v);
+
+            // fused packing: (ac|bd) +/- (ad|bc) over c >= d
+            #pragma omp parallel for schedule (static)
+            for (long int b = 0; b < nb; b++){
+                long int cd = 0;
+                long int ind1 = b*vtri;
+                long int ind2 = b*v*v;
+                for (long int c=0; c<v; c++){
+                    for (long int d=0; d<=c; d++){
+                        double dc = Vcdb[ind2+d*v+c];
+                        double cdv = Vcdb[ind2+c*v+d];
+                        Vp[ind1+cd] = dc + cdv;
+                        Vm[ind1+cd] = dc - cdv;
+                        cd++;
+                    }
                 }
             }
-        }
-        F_DGEMM('n','n',otri,nb,vtri,0.5,tempt+otri*vtri,otri,Vm,vtri,0.0,Sbij,otri);
-        double end2 = omp_get_wtime();
-
-        // contribute to residual
-        double start3 = omp_get_wtime();
-        #pragma omp parallel for schedule (static)
-        for (long int b = a; b < v; b++) {
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    int sg = ( i > j ) ? 1 : -1;
-                    tempv[a*oo*v+b*oo+i*o+j]    +=    Abij[(b-a)*otri+Position(i,j)]
-                                                +  sg*Sbij[(b-a)*otri+Position(i,j)];
-                    if (a!=b) {
-                       tempv[b*oov+a*oo+i*o+j] +=    Abij[(b-a)*otri+Position(i,j)]
-                                               -  sg*Sbij[(b-a)*otri+Position(i,j)];
+
+            F_DGEMM('n','n',otri,nb,vtri,0.5,tempt,otri,Vp,vtri,0.0,Abij,otri);
+            F_DGEMM('n','n',otri,nb,vtri,0.5,tempt+otri*vtri,otri,Vm,vtri,0.0,Sbij,otri);
+
+            // contribute to residual
+            #pragma omp parallel for schedule (static)
+            for (long int bb = 0; bb < nb; bb++) {
+                long int b = b0 + bb;
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        int sg = ( i > j ) ? 1 : -1;
+                        tempv[a*oo*v+b*oo+i*o+j]    +=    Abij[bb*otri+Position(i,j)]
+                                                    +  sg*Sbij[bb*otri+Position(i,j)];
+                        if (a!=b) {
+                           tempv[b*oov+a*oo+i*o+j] +=    Abij[bb*otri+Position(i,j)]
+                                                   -  sg*Sbij[bb*otri+Position(i,j)];
+                        }
                     }
                 }
             }
         }
-        double end3 = omp_get_wtime();
-
-        time1 += end1 - start1;
-        time2 += end2 - start2;
-        time3 += end3 - start3;
     }
 
     // contribute to residual
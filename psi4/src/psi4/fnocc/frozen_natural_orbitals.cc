@@ -631,7 +631,7 @@ void DFFrozenNO::ThreeIndexIntegrals() {
           std::shared_ptr<BasisSet> primary = basisset();
           std::shared_ptr<IntegralFactory> integral (new IntegralFactory(primary,primary,primary,primary));
           double tol = options_.get_double("CHOLESKY_TOLERANCE");
-          std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(std::shared_ptr<TwoBodyAOInt>(integral->eri()),0.0,tol,Process::environment.get_memory()));
+          std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(integral,0.0,tol,Process::environment.get_memory()));
           Ch->choleskify();
           nQ  = Ch->Q();
           std::shared_ptr<Matrix> L = Ch->L();
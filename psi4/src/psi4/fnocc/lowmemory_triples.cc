@@ -240,6 +240,14 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
 
   for (int i=0; i<nthreads; i++) etrip[i] = 0.0;
 
+  // abc are dealt out round-robin over the MPI ranks
+  int rank, nrank;
+  triples_ranks(rank,nrank);
+  if (nrank > 1) {
+     outfile->Printf("        Number of MPI ranks:        %ld\n",(long int)nrank);
+     outfile->Printf("\n");
+  }
+
   outfile->Printf("        Computing (T) correction...\n");
   outfile->Printf("\n");
   outfile->Printf("        %% complete  total time\n");
@@ -256,7 +264,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
 
   if (threaded){
      #pragma omp parallel for schedule (dynamic) num_threads(nthreads)
-     for (long int ind=0; ind<nabc; ind++){
+     for (long int ind=rank; ind<nabc; ind+=nrank){
          long int a = abc[ind][0];
          long int b = abc[ind][1];
          long int c = abc[ind][2];
@@ -510,6 +518,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
 
   double myet = 0.0;
   for (int i=0; i<nthreads; i++) myet += etrip[i];
+  myet = triples_reduce(myet,nrank);
 
   // ccsd(t) or qcisd(t)
   if (ccmethod <= 1) {
@@ -36,6 +36,8 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <vector>
+
 namespace psi{namespace fnocc{
 typedef long int size_t;
 struct integral{
@@ -89,7 +91,6 @@ void SortIntegrals(int nfzc,int nfzv,int norbs,int ndoccact,int nvirt,Options&op
 }
 void SortAllIntegrals(iwlbuf *Buf,int nfzc,int nfzv,int norbs,int ndoccact,int nvirt,Options&options){
 
-  double val;
   size_t o = ndoccact;
   size_t v = nvirt;
   size_t fstact = nfzc;
@@ -98,7 +99,7 @@ void SortAllIntegrals(iwlbuf *Buf,int nfzc,int nfzv,int norbs,int ndoccact,int n
   size_t lastbuf;
   Label *lblptr;
   Value *valptr;
-  size_t nocc,idx, p, q, r, s, pq, rs, pqrs;
+  size_t idx, p, q, r, s;
 
   lblptr = Buf->labels;
   valptr = Buf->values;
@@ -112,6 +113,19 @@ void SortAllIntegrals(iwlbuf *Buf,int nfzc,int nfzv,int norbs,int ndoccact,int n
   // available memory:
   size_t memory = Process::environment.get_memory();
 
+  int nthreads = 1;
+  #ifdef _OPENMP
+      nthreads = Process::environment.get_n_threads();
+  #endif
+
+  // the initial sort reads chunksize integrals at a time, and each can expand
+  // into at most 8 bucket entries. that staging memory comes off the top.
+  size_t perint = 4*sizeof(size_t) + sizeof(double) + 8*sizeof(struct integral);
+  size_t chunksize = 16384L * nthreads;
+  if (chunksize * perint > memory / 4) chunksize = memory / 4 / perint;
+  if (chunksize < 1024) chunksize = 1024;
+  memory -= chunksize * perint;
+
   // 8 bytes for tmp, 16 for integral struct
   size_t maxelem = memory / (sizeof(double) + sizeof(struct integral));
 
@@ -302,206 +316,158 @@ void SortAllIntegrals(iwlbuf *Buf,int nfzc,int nfzv,int norbs,int ndoccact,int n
   }
 
   outfile->Printf("        Initial sort........");
-  /**
-    * first buffer (read in when Buf was initialized)
-    */
-  for (idx=4*Buf->idx; Buf->idx<Buf->inbuf; Buf->idx++) {
-      p = (size_t) lblptr[idx++];
-      q = (size_t) lblptr[idx++];
-      r = (size_t) lblptr[idx++];
-      s = (size_t) lblptr[idx++];
 
-      if (p < fstact || q < fstact || r < fstact || s < fstact) continue;
-      if (p > lstact || q > lstact || r > lstact || s > lstact) continue;
-      p -= fstact;
-      q -= fstact;
-      r -= fstact;
-      s -= fstact;
-
-      pq   = Position(p,q);
-      rs   = Position(r,s);
-      pqrs = Position(pq,rs);
-
-      nocc = 0;
-      if (p<o) nocc++;
-      if (q<o) nocc++;
-      if (r<o) nocc++;
-      if (s<o) nocc++;
-
-      // which type of integral?
-
-      if (nocc==4){
-         val = (double)valptr[Buf->idx];
-         ijkl_terms(val,pq,rs,p,q,r,s,o,nijkl,ijkl);
-
-         if (nijkl>=nelem){
-            psio->open(PSIF_DCC_IJKL,PSIO_OPEN_OLD);
-            psio->write(PSIF_DCC_IJKL,"E2ijkl",(char*)&ijkl[0],nijkl*sizeof(struct integral),ijkl_addr,&ijkl_addr);
-            psio->close(PSIF_DCC_IJKL,1);
-            totalnijkl+=nijkl;
-            nijkl=0;
-         }
-      }
-      else if (nocc==3){
-         val = (double)valptr[Buf->idx];
-         ijak_terms(val,p,q,r,s,o,v,nijak,ijak);
-         if (nijak>=nelem){
-            psio->open(PSIF_DCC_IJAK,PSIO_OPEN_OLD);
-            psio->write(PSIF_DCC_IJAK,"E2ijak",(char*)&ijak[0],nijak*sizeof(struct integral),ijak_addr,&ijak_addr);
-            psio->close(PSIF_DCC_IJAK,1);
-            totalnijak+=nijak;
-            nijak=0;
-         }
-         ijak2_terms(val,p,q,r,s,o,v,nijak2,ijak2);
-         if (nijak2>=nelem){
-            psio->open(PSIF_DCC_IJAK2,PSIO_OPEN_OLD);
-            psio->write(PSIF_DCC_IJAK2,"E2ijak2",(char*)&ijak2[0],nijak2*sizeof(struct integral),ijak2_addr,&ijak2_addr);
-            psio->close(PSIF_DCC_IJAK2,1);
-            totalnijak2+=nijak2;
-            nijak2=0;
-         }
+  // write a bucket to its file
+  auto flush = [&](size_t file,const char*label,struct integral*bucket,size_t&n,size_t&total,psio_address&addr){
+      psio->open(file,PSIO_OPEN_OLD);
+      psio->write(file,label,(char*)&bucket[0],n*sizeof(struct integral),addr,&addr);
+      psio->close(file,1);
+      total+=n;
+      n=0;
+  };
+  // append staged entries to a bucket
+  auto merge = [&](const std::vector<struct integral>&in,size_t file,const char*label,struct integral*bucket,size_t&n,size_t&total,psio_address&addr){
+      for (size_t m = 0; m < (size_t)in.size(); m++) {
+          bucket[n++] = in[m];
+          if (n>=nelem) flush(file,label,bucket,n,total,addr);
       }
-      else if (nocc==2){
-         val = (double)valptr[Buf->idx];
-
-         if ((p<o && q>=o) || (p>=o && q<o)){
-            klcd_terms(val,pq,rs,p,q,r,s,o,v,nklcd,klcd);
-
-            if (nklcd>=nelem){
-               psio->open(PSIF_DCC_IAJB,PSIO_OPEN_OLD);
-               psio->write(PSIF_DCC_IAJB,"E2iajb",(char*)&klcd[0],nklcd*sizeof(struct integral),klcd_addr,&klcd_addr);
-               psio->close(PSIF_DCC_IAJB,1);
-               totalnklcd+=nklcd;
-               nklcd=0;
-            }
-         }
-         else{
-            akjc_terms(val,p,q,r,s,o,v,nakjc,akjc);
-            if (nakjc>=nelem){
-               psio->open(PSIF_DCC_IJAB,PSIO_OPEN_OLD);
-               psio->write(PSIF_DCC_IJAB,"E2ijab",(char*)&akjc[0],nakjc*sizeof(struct integral),akjc_addr,&akjc_addr);
-               psio->close(PSIF_DCC_IJAB,1);
-               totalnakjc+=nakjc;
-               nakjc=0;
-             }
-         }
+  };
+  // append staged entries to the buckets of a block split over several files
+  auto merge_binned = [&](const std::vector<struct integral>&in,size_t filestart,const char*label,struct integral**bucket,size_t*n,size_t*total,psio_address*addr,size_t binsize){
+      for (size_t m = 0; m < (size_t)in.size(); m++) {
+          size_t k = in[m].ind / binsize;
+          bucket[k][n[k]++] = in[m];
+          if (n[k]>=bucketsize) flush(filestart+k,label,bucket[k],n[k],total[k],addr[k]);
       }
-      else if (nocc==1){
-         val = (double)valptr[Buf->idx];
-         abci1_terms_new(val,p,q,r,s,o,v,nabci1,totalnabci1,abci1,ov3filesize,bucketsize,abci1_addr,PSIF_DCC_SORT_START+2*nfiles,ov3nfiles);
-         abci3_terms_new(val,p,q,r,s,o,v,nabci3,totalnabci3,abci3,ov3filesize,bucketsize,abci3_addr,PSIF_DCC_SORT_START+2*nfiles+ov3nfiles,ov3nfiles);
-         abci5_terms_new(val,p,q,r,s,o,v,nabci5,totalnabci5,abci5,ov3filesize,bucketsize,abci5_addr,PSIF_DCC_SORT_START+2*nfiles+2*ov3nfiles,ov3nfiles);
-      }
-      else if (nocc==0){
-         val = (double)valptr[Buf->idx];
-         abcd1_terms_new(val,pq,rs,p,q,r,s,o,v,nabcd1,totalnabcd1,abcd1,filesize,bucketsize,abcd1_addr,nfiles);
-         abcd2_terms_new(val,pq,rs,p,q,r,s,o,v,nabcd2,totalnabcd2,abcd2,filesize,bucketsize,abcd2_addr,nfiles);
-      }
-  }
+  };
 
   /**
-    * now do the same for the rest of the buffers
+    * integrals are read a chunk of IWL buffers at a time. each thread
+    * expands its share of the chunk into private staging buckets, and the
+    * staging buckets are then merged into the real ones, in thread order.
+    * every integral only ever lands in one place in the sorted blocks, so
+    * the order in which entries reach the files does not matter.
     */
-  while(!lastbuf){
-      iwl_buf_fetch(Buf);
-      lastbuf = Buf->lastbuf;
-      for (idx=4*Buf->idx; Buf->idx<Buf->inbuf; Buf->idx++) {
-
-          p = (size_t) lblptr[idx++];
-          q = (size_t) lblptr[idx++];
-          r = (size_t) lblptr[idx++];
-          s = (size_t) lblptr[idx++];
-
-          if (p < fstact || q < fstact || r < fstact || s < fstact) continue;
-          if (p > lstact || q > lstact || r > lstact || s > lstact) continue;
-          p -= fstact;
-          q -= fstact;
-          r -= fstact;
-          s -= fstact;
-
-          pq   = Position(p,q);
-          rs   = Position(r,s);
-          pqrs = Position(pq,rs);
-
-          nocc = 0;
-          if (p<o) nocc++;
-          if (q<o) nocc++;
-          if (r<o) nocc++;
-          if (s<o) nocc++;
-
-          // which type of integral?
-
-          if (nocc==4){
-             val = (double)valptr[Buf->idx];
-             ijkl_terms(val,pq,rs,p,q,r,s,o,nijkl,ijkl);
-
-             if (nijkl>=nelem){
-                psio->open(PSIF_DCC_IJKL,PSIO_OPEN_OLD);
-                psio->write(PSIF_DCC_IJKL,"E2ijkl",(char*)&ijkl[0],nijkl*sizeof(struct integral),ijkl_addr,&ijkl_addr);
-                psio->close(PSIF_DCC_IJKL,1);
-                totalnijkl+=nijkl;
-                nijkl=0;
-             }
-          }
-          else if (nocc==3){
-             val = (double)valptr[Buf->idx];
-             ijak_terms(val,p,q,r,s,o,v,nijak,ijak);
-             if (nijak>=nelem){
-                psio->open(PSIF_DCC_IJAK,PSIO_OPEN_OLD);
-                psio->write(PSIF_DCC_IJAK,"E2ijak",(char*)&ijak[0],nijak*sizeof(struct integral),ijak_addr,&ijak_addr);
-                psio->close(PSIF_DCC_IJAK,1);
-                totalnijak+=nijak;
-                nijak=0;
-             }
-             ijak2_terms(val,p,q,r,s,o,v,nijak2,ijak2);
-             if (nijak2>=nelem){
-                psio->open(PSIF_DCC_IJAK2,PSIO_OPEN_OLD);
-                psio->write(PSIF_DCC_IJAK2,"E2ijak2",(char*)&ijak2[0],nijak2*sizeof(struct integral),ijak2_addr,&ijak2_addr);
-                psio->close(PSIF_DCC_IJAK2,1);
-                totalnijak2+=nijak2;
-                nijak2=0;
-             }
-          }
-          else if (nocc==2){
-             val = (double)valptr[Buf->idx];
-
-             if ((p<o && q>=o) || (p>=o && q<o)){
-                klcd_terms(val,pq,rs,p,q,r,s,o,v,nklcd,klcd);
-
-                if (nklcd>=nelem){
-                   psio->open(PSIF_DCC_IAJB,PSIO_OPEN_OLD);
-                   psio->write(PSIF_DCC_IAJB,"E2iajb",(char*)&klcd[0],nklcd*sizeof(struct integral),klcd_addr,&klcd_addr);
-                   psio->close(PSIF_DCC_IAJB,1);
-                   totalnklcd+=nklcd;
-                   nklcd=0;
-                }
-             }
-             else{
-                akjc_terms(val,p,q,r,s,o,v,nakjc,akjc);
-
-                if (nakjc>=nelem){
-                   psio->open(PSIF_DCC_IJAB,PSIO_OPEN_OLD);
-                   psio->write(PSIF_DCC_IJAB,"E2ijab",(char*)&akjc[0],nakjc*sizeof(struct integral),akjc_addr,&akjc_addr);
-                   psio->close(PSIF_DCC_IJAB,1);
-                   totalnakjc+=nakjc;
-                   nakjc=0;
-                }
-             }
-          }
-          else if (nocc==1){
-             val = (double)valptr[Buf->idx];
-             abci1_terms_new(val,p,q,r,s,o,v,nabci1,totalnabci1,abci1,ov3filesize,bucketsize,abci1_addr,PSIF_DCC_SORT_START+2*nfiles,ov3nfiles);
-             abci3_terms_new(val,p,q,r,s,o,v,nabci3,totalnabci3,abci3,ov3filesize,bucketsize,abci3_addr,PSIF_DCC_SORT_START+2*nfiles+ov3nfiles,ov3nfiles);
-             abci5_terms_new(val,p,q,r,s,o,v,nabci5,totalnabci5,abci5,ov3filesize,bucketsize,abci5_addr,PSIF_DCC_SORT_START+2*nfiles+2*ov3nfiles,ov3nfiles);
+  enum {IJKL, IJAK, IJAK2, IAJB, IJAB, ABCI1, ABCI3, ABCI5, ABCD1, ABCD2, NCLASS};
+  std::vector<size_t> chunklabels(4*chunksize);
+  std::vector<double> chunkvalues(chunksize);
+  std::vector<std::vector<std::vector<struct integral> > > staging(nthreads,std::vector<std::vector<struct integral> >(NCLASS));
+
+  bool moreints = true;
+  while (moreints) {
+
+      // gather the next chunk (the first buffer was read when Buf was initialized)
+      size_t nchunk = 0;
+      while (nchunk < chunksize) {
+          if (Buf->idx >= Buf->inbuf) {
+              if (lastbuf) {
+                 moreints = false;
+                 break;
+              }
+              iwl_buf_fetch(Buf);
+              lastbuf = Buf->lastbuf;
+              continue;
           }
-          else if (nocc==0){
-             val = (double)valptr[Buf->idx];
-             abcd1_terms_new(val,pq,rs,p,q,r,s,o,v,nabcd1,totalnabcd1,abcd1,filesize,bucketsize,abcd1_addr,nfiles);
-             abcd2_terms_new(val,pq,rs,p,q,r,s,o,v,nabcd2,totalnabcd2,abcd2,filesize,bucketsize,abcd2_addr,nfiles);
+          for (idx=4*Buf->idx; Buf->idx<Buf->inbuf && nchunk<chunksize; Buf->idx++) {
+              p = (size_t) lblptr[idx++];
+              q = (size_t) lblptr[idx++];
+              r = (size_t) lblptr[idx++];
+              s = (size_t) lblptr[idx++];
+
+              if (p < fstact || q < fstact || r < fstact || s < fstact) continue;
+              if (p > lstact || q > lstact || r > lstact || s > lstact) continue;
+              chunklabels[4*nchunk]   = p - fstact;
+              chunklabels[4*nchunk+1] = q - fstact;
+              chunklabels[4*nchunk+2] = r - fstact;
+              chunklabels[4*nchunk+3] = s - fstact;
+              chunkvalues[nchunk++]   = (double)valptr[Buf->idx];
           }
+      }
 
+      // expand
+      #pragma omp parallel for schedule(static) num_threads(nthreads)
+      for (int t = 0; t < nthreads; t++) {
+          std::vector<std::vector<struct integral> > & st = staging[t];
+          for (int c = 0; c < NCLASS; c++) st[c].clear();
+
+          struct integral terms[8];
+          size_t nterms = 0;
+          auto stage = [&](int c){
+              st[c].insert(st[c].end(),terms,terms+nterms);
+              nterms = 0;
+          };
+
+          size_t first = nchunk * t / nthreads;
+          size_t last  = nchunk * (t+1) / nthreads;
+          for (size_t n = first; n < last; n++) {
+              size_t p = chunklabels[4*n];
+              size_t q = chunklabels[4*n+1];
+              size_t r = chunklabels[4*n+2];
+              size_t s = chunklabels[4*n+3];
+              double val = chunkvalues[n];
+
+              size_t pq = Position(p,q);
+              size_t rs = Position(r,s);
+
+              size_t nocc = 0;
+              if (p<o) nocc++;
+              if (q<o) nocc++;
+              if (r<o) nocc++;
+              if (s<o) nocc++;
+
+              // which type of integral?
+
+              if (nocc==4){
+                 ijkl_terms(val,pq,rs,p,q,r,s,o,nterms,terms);
+                 stage(IJKL);
+              }
+              else if (nocc==3){
+                 ijak_terms(val,p,q,r,s,o,v,nterms,terms);
+                 stage(IJAK);
+                 ijak2_terms(val,p,q,r,s,o,v,nterms,terms);
+                 stage(IJAK2);
+              }
+              else if (nocc==2){
+                 if ((p<o && q>=o) || (p>=o && q<o)){
+                    klcd_terms(val,pq,rs,p,q,r,s,o,v,nterms,terms);
+                    stage(IAJB);
+                 }
+                 else{
+                    akjc_terms(val,p,q,r,s,o,v,nterms,terms);
+                    stage(IJAB);
+                 }
+              }
+              else if (nocc==1){
+                 abci1_terms(val,p,q,r,s,o,v,nterms,terms);
+                 stage(ABCI1);
+                 abci3_terms(val,p,q,r,s,o,v,nterms,terms);
+                 stage(ABCI3);
+                 abci5_terms(val,p,q,r,s,o,v,nterms,terms);
+                 stage(ABCI5);
+              }
+              else if (nocc==0){
+                 abcd1_terms(val,pq,rs,p,q,r,s,o,v,nterms,terms);
+                 stage(ABCD1);
+                 abcd2_terms(val,pq,rs,p,q,r,s,o,v,nterms,terms);
+                 stage(ABCD2);
+              }
+          }
       }
 
+      // merge
+      for (int t = 0; t < nthreads; t++) {
+          std::vector<std::vector<struct integral> > & st = staging[t];
+          merge(st[IJKL],PSIF_DCC_IJKL,"E2ijkl",ijkl,nijkl,totalnijkl,ijkl_addr);
+          merge(st[IJAK],PSIF_DCC_IJAK,"E2ijak",ijak,nijak,totalnijak,ijak_addr);
+          merge(st[IJAK2],PSIF_DCC_IJAK2,"E2ijak2",ijak2,nijak2,totalnijak2,ijak2_addr);
+          merge(st[IAJB],PSIF_DCC_IAJB,"E2iajb",klcd,nklcd,totalnklcd,klcd_addr);
+          merge(st[IJAB],PSIF_DCC_IJAB,"E2ijab",akjc,nakjc,totalnakjc,akjc_addr);
+          merge_binned(st[ABCI1],PSIF_DCC_SORT_START+2*nfiles,"E2abci",abci1,nabci1,totalnabci1,abci1_addr,ov3filesize);
+          merge_binned(st[ABCI3],PSIF_DCC_SORT_START+2*nfiles+ov3nfiles,"E2abci3",abci3,nabci3,totalnabci3,abci3_addr,ov3filesize);
+          merge_binned(st[ABCI5],PSIF_DCC_SORT_START+2*nfiles+2*ov3nfiles,"E2abci2",abci5,nabci5,totalnabci5,abci5_addr,ov3filesize);
+          merge_binned(st[ABCD1],PSIF_DCC_SORT_START,"E2abcd1",abcd1,nabcd1,totalnabcd1,abcd1_addr,filesize);
+          merge_binned(st[ABCD2],PSIF_DCC_SORT_START+nfiles,"E2abcd2",abcd2,nabcd2,totalnabcd2,abcd2_addr,filesize);
+      }
   }
   outfile->Printf("done.\n\n");
   /**
@@ -1927,6 +1893,7 @@ void SortBlockNewNew(size_t*nelem,size_t blockdim,struct integral*buffer,double*
          // read coreload from this file
          psio->read_entry(filestart+k,string,(char*)&buffer[0],nelem[k]*sizeof(struct integral));
          // loop over elements and sort into tmp
+         #pragma omp parallel for schedule(static)
          for (size_t j = 0; j < nelem[k]; j++) {
              tmp[buffer[j].ind-k*binsize] = buffer[j].val;
          }
@@ -1951,6 +1918,7 @@ void SortBlockNew(size_t nelem,size_t blockdim,struct integral*buffer,double*tmp
      psio->close(PSIFILE,0);
 
      memset((void*)tmp,'\0',blockdim*sizeof(double));
+     #pragma omp parallel for schedule(static)
      for (size_t j=0; j<nelem; j++){
          tmp[buffer[j].ind] = buffer[j].val;
      }
@@ -2136,6 +2104,7 @@ void SortBlock(size_t nelem,size_t blockdim,struct integral*buffer,double*tmp,si
      psio->close(PSIFILE,0);
 
      memset((void*)tmp,'\0',blockdim*sizeof(double));
+     #pragma omp parallel for schedule(static)
      for (size_t j=0; j<nelem; j++){
          tmp[buffer[j].ind] = buffer[j].val;
      }
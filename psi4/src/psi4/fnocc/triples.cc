@@ -37,11 +37,42 @@
 #ifdef _OPENMP
    #include<omp.h>
 #endif
+#ifdef HAVE_MPI
+   #include<mpi.h>
+#endif
 
 using namespace psi;
 
 namespace psi{namespace fnocc{
 
+/**
+  *  with TRIPLES_DISTRIBUTED, every MPI rank has run the same CCSD and holds
+  *  its own copy of the integrals and amplitudes, so the (T) loops can be
+  *  split over the ranks and only the energy needs to be summed.
+  */
+void CoupledCluster::triples_ranks(int &rank, int &nrank){
+  rank  = 0;
+  nrank = 1;
+  if (!options_.get_bool("TRIPLES_DISTRIBUTED")) return;
+  #ifdef HAVE_MPI
+      int initialized = 0;
+      MPI_Initialized(&initialized);
+      if (!initialized) {
+         throw PSIEXCEPTION("TRIPLES_DISTRIBUTED: MPI has not been initialized (e.g., import mpi4py before psi4).");
+      }
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+  #endif
+}
+double CoupledCluster::triples_reduce(double myet, int nrank){
+  #ifdef HAVE_MPI
+      if (nrank > 1) {
+         MPI_Allreduce(MPI_IN_PLACE, &myet, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      }
+  #endif
+  return myet;
+}
+
 PsiReturnType CoupledCluster::triples(){
 
   char*name = new char[10];
@@ -128,6 +159,13 @@ PsiReturnType CoupledCluster::triples(){
       }
   }
   outfile->Printf("        Number of ijk combinations: %ld\n",nijk);
+
+  // ijk are dealt out round-robin over the MPI ranks
+  int rank, nrank;
+  triples_ranks(rank,nrank);
+  if (nrank > 1) {
+     outfile->Printf("        Number of MPI ranks:        %ld\n",(long int)nrank);
+  }
   outfile->Printf("\n");
 
 
@@ -182,7 +220,7 @@ PsiReturnType CoupledCluster::triples(){
     *  if there is enough memory to explicitly thread, do so
     */
   #pragma omp parallel for schedule (dynamic) num_threads(nthreads)
-  for (long int ind=0; ind<nijk; ind++){
+  for (long int ind=rank; ind<nijk; ind+=nrank){
       long int i = ijk[ind][0];
       long int j = ijk[ind][1];
       long int k = ijk[ind][2];
@@ -365,6 +403,7 @@ PsiReturnType CoupledCluster::triples(){
 
   double myet = 0.0;
   for (int i=0; i<nthreads; i++) myet += etrip[i];
+  myet = triples_reduce(myet,nrank);
 
   // ccsd(t) or qcisd(t)
   if (ccmethod <= 1) {
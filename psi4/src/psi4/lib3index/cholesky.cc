@@ -33,17 +33,20 @@
  PRAGMA_WARNING_POP
 #include "psi4/libqt/qt.h"
 #include <math.h>
+#include <algorithm>
 #include <limits>
 #include <vector>
 #include "cholesky.h"
 #include "psi4/psifiles.h"
 #include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libiwl/iwl.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/integral.h"
 #ifdef _OPENMP
     #include <omp.h>
 #endif
@@ -69,6 +72,11 @@ void Cholesky::choleskify()
     size_t max_rows_ULI = ((memory_ - n) / (2L * n));
     size_t max_rows = (max_rows_ULI > max_size_t ? max_size_t : max_rows_ULI);
 
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
     // Get the diagonal (Q|Q)^(0)
     double* diag = new double[n];
     compute_diagonal(diag);
@@ -79,65 +87,118 @@ void Cholesky::choleskify()
     // List of selected pivots
     std::vector<int> pivots;
 
+    // Rows are computed a pass at a time for the nthread largest remaining
+    // diagonals, which are the likely next pivots. Within a pass, pivots
+    // are still taken one at a time as the global maximum of the updated
+    // diagonal, exactly as in the one-row algorithm; once that maximum is
+    // not among the precomputed rows the pass ends and the leftovers are
+    // dropped. The factor therefore does not depend on the thread count.
+    std::vector<int> candidates;
+    std::vector<double*> rows;
+    std::vector<size_t> order(n);
+
     // Cholesky procedure
-    while (Q_ < n) {
-
-        // Select the pivot
-        size_t pivot = 0;
-        double Dmax = diag[0];
-        for (size_t P = 0; P < n; P++) {
-            if (Dmax < diag[P]) {
-                Dmax = diag[P];
-                pivot = P;
-            }
+    bool converged = false;
+    while (Q_ < n && !converged) {
+
+        // Guess the pivots of this pass
+        size_t nguess = std::min((size_t) nthread, n - Q_);
+        for (size_t P = 0; P < n; P++) order[P] = P;
+        std::partial_sort(order.begin(), order.begin() + nguess, order.end(),
+                          [diag](size_t a, size_t b) { return diag[a] > diag[b] || (diag[a] == diag[b] && a < b); });
+        candidates.clear();
+        for (size_t k = 0; k < nguess; k++) {
+            if (diag[order[k]] < delta_ || diag[order[k]] < 0.0) break;
+            candidates.push_back(order[k]);
         }
 
-        // Check to see if convergence reached
-        if (Dmax < delta_ || Dmax < 0.0) break;
-
-        // If here, we're trying to add this row
-        pivots.push_back(pivot);
-        double L_QQ = sqrt(Dmax);
-
         // Check to see if memory constraints are OK
-        if (Q_ > max_rows) {
+        if (Q_ + candidates.size() > max_rows + 1) {
             throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
         }
 
-        // If here, we're really going to add this row
-        L.push_back(new double[n]);
+        // (m|Q) for every guess, threaded by the subclass
+        rows.clear();
+        for (size_t k = 0; k < candidates.size(); k++) rows.push_back(new double[n]);
+        compute_rows(candidates, rows);
+
+        std::vector<bool> used(candidates.size(), false);
+        while (Q_ < n) {
+
+            // Select the pivot
+            size_t pivot = 0;
+            double Dmax = diag[0];
+            for (size_t P = 0; P < n; P++) {
+                if (Dmax < diag[P]) {
+                    Dmax = diag[P];
+                    pivot = P;
+                }
+            }
 
-        // (m|Q)
-        compute_row(pivot, L[Q_]);
+            // Check to see if convergence reached
+            if (Dmax < delta_ || Dmax < 0.0) {
+                converged = true;
+                break;
+            }
 
-        // [(m|Q) - L_m^P L_Q^P]
-        for (size_t P = 0; P < Q_; P++) {
-            C_DAXPY(n,-L[P][pivots[Q_]],L[P],1,L[Q_],1);
-        }
+            // Was this row computed in this pass?
+            size_t slot = candidates.size();
+            for (size_t k = 0; k < candidates.size(); k++) {
+                if (!used[k] && (size_t) candidates[k] == pivot) slot = k;
+            }
+            if (slot == candidates.size()) break;
+            used[slot] = true;
+
+            // If here, we're really going to add this row
+            pivots.push_back(pivot);
+            double L_QQ = sqrt(Dmax);
+            L.push_back(rows[slot]);
+            rows[slot] = nullptr;
+            double* LQ = L[Q_];
+
+            // [(m|Q) - L_m^P L_Q^P], threaded over m in cache-sized chunks
+            const size_t chunk = 2048;
+            size_t nchunk = (n + chunk - 1) / chunk;
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (size_t c = 0; c < nchunk; c++) {
+                size_t m0 = c * chunk;
+                size_t nm = std::min(chunk, n - m0);
+                for (size_t P = 0; P < Q_; P++) {
+                    C_DAXPY(nm, -L[P][pivot], &L[P][m0], 1, &LQ[m0], 1);
+                }
+                // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
+                C_DSCAL(nm, 1.0 / L_QQ, &LQ[m0], 1);
+            }
 
-        // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
-        C_DSCAL(n, 1.0 / L_QQ, L[Q_], 1);
+            // Zero the upper triangle
+            for (size_t P = 0; P < pivots.size(); P++) {
+                LQ[pivots[P]] = 0.0;
+            }
 
-        // Zero the upper triangle
-        for (size_t P = 0; P < pivots.size(); P++) {
-            L[Q_][pivots[P]] = 0.0;
-        }
+            // Set the pivot factor
+            LQ[pivot] = L_QQ;
 
-        // Set the pivot factor
-        L[Q_][pivot] = L_QQ;
+            // Update the Schur complement diagonal
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (size_t P = 0; P < n; P++) {
+                diag[P] -= LQ[P] * LQ[P];
+            }
 
-        // Update the Schur complement diagonal
-        for (size_t P = 0; P < n; P++) {
-            diag[P] -= L[Q_][P] * L[Q_][P];
-        }
+            // Force truly zero elements to zero
+            for (size_t P = 0; P < pivots.size(); P++) {
+                diag[pivots[P]] = 0.0;
+            }
 
-        // Force truly zero elements to zero
-        for (size_t P = 0; P < pivots.size(); P++) {
-            diag[pivots[P]] = 0.0;
+            Q_++;
         }
 
-        Q_++;
+        for (size_t k = 0; k < rows.size(); k++) delete[] rows[k];
+
+        // No guess at all means nothing above delta is left
+        if (candidates.empty()) converged = true;
     }
+    delete[] diag;
+
     // Copy into a more permanant Matrix object
     L_ = SharedMatrix(new Matrix("Partial Cholesky", Q_, n));
     double** Lp = L_->pointer();
@@ -147,6 +208,12 @@ void Cholesky::choleskify()
         delete[] L[Q];
     }
 }
+void Cholesky::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets)
+{
+    for (size_t k = 0; k < rows.size(); k++) {
+        compute_row(rows[k], targets[k]);
+    }
+}
 
 CholeskyMatrix::CholeskyMatrix(SharedMatrix A, double delta, size_t memory) :
     A_(A), Cholesky(delta, memory)
@@ -181,6 +248,31 @@ CholeskyERI::CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz,
     integral_(integral), schwarz_(schwarz), Cholesky(delta, memory)
 {
     basisset_ = integral_->basis();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    ints_.push_back(integral_);
+    if (integral_->cloneable()) {
+        for (int thread = 1; thread < nthread; thread++)
+            ints_.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->clone()));
+    }
+}
+CholeskyERI::CholeskyERI(std::shared_ptr<IntegralFactory> factory, double schwarz,
+    double delta, size_t memory) :
+    schwarz_(schwarz), Cholesky(delta, memory)
+{
+    integral_ = std::shared_ptr<TwoBodyAOInt>(factory->eri());
+    basisset_ = integral_->basis();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    ints_.push_back(integral_);
+    for (int thread = 1; thread < nthread; thread++)
+        ints_.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
 }
 CholeskyERI::~CholeskyERI()
 {
@@ -191,11 +283,16 @@ size_t CholeskyERI::N()
 }
 void CholeskyERI::compute_diagonal(double* target)
 {
-    const double* buffer = integral_->buffer();
+#pragma omp parallel for schedule(dynamic) num_threads(ints_.size())
     for (size_t M = 0; M < basisset_->nshell(); M++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double* buffer = ints_[thread]->buffer();
         for (size_t N = 0; N < basisset_->nshell(); N++) {
 
-            integral_->compute_shell(M,N,M,N);
+            ints_[thread]->compute_shell(M,N,M,N);
 
             size_t nM = basisset_->shell(M).nfunction();
             size_t nN = basisset_->shell(N).nfunction();
@@ -212,6 +309,21 @@ void CholeskyERI::compute_diagonal(double* target)
     }
 }
 void CholeskyERI::compute_row(int row, double* target)
+{
+    compute_row(row, target, integral_);
+}
+void CholeskyERI::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets)
+{
+#pragma omp parallel for schedule(dynamic) num_threads(ints_.size())
+    for (size_t k = 0; k < rows.size(); k++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        compute_row(rows[k], targets[k], ints_[thread]);
+    }
+}
+void CholeskyERI::compute_row(int row, double* target, std::shared_ptr<TwoBodyAOInt> ints)
 {
     size_t r = row / basisset_->nbf();
     size_t s = row % basisset_->nbf();
@@ -227,11 +339,11 @@ void CholeskyERI::compute_row(int row, double* target)
     size_t os = s - sstart;
     int nshell = basisset_->nshell();
 
-    const double* buffer = integral_->buffer();
+    const double* buffer = ints->buffer();
     for (size_t M = 0; M < basisset_->nshell(); M++) {
         for (size_t N = M; N < basisset_->nshell(); N++) {
 
-            integral_->compute_shell(M,N,R,S);
+            ints->compute_shell(M,N,R,S);
 
             size_t nM = basisset_->shell(M).nfunction();
             size_t nN = basisset_->shell(N).nfunction();
@@ -31,10 +31,13 @@
 
 #include "psi4/libmints/typedefs.h"
 
+#include <vector>
+
 namespace psi {
 
 class Vector;
 class TwoBodyAOInt;
+class IntegralFactory;
 class BasisSet;
 
 class Cholesky {
@@ -75,6 +78,9 @@ public:
     virtual void compute_diagonal(double* target) = 0;
     /// Row row of the original square tensor, provided by the subclass
     virtual void compute_row(int row, double* target) = 0;
+    /// Several rows at once (targets[k] gets row rows[k]); by default one
+    /// compute_row per entry, subclasses with costly rows may thread this
+    virtual void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets);
 
 };
 
@@ -97,13 +103,21 @@ protected:
     double schwarz_;
     std::shared_ptr<BasisSet> basisset_;
     std::shared_ptr<TwoBodyAOInt> integral_;
+    /// One integral object per thread (integral_ first), clones of integral_
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints_;
+    /// Row row computed with ints
+    void compute_row(int row, double* target, std::shared_ptr<TwoBodyAOInt> ints);
 public:
     CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz, double delta, size_t memory);
+    /// Same, with one factory->eri() per thread for the threaded rows
+    CholeskyERI(std::shared_ptr<IntegralFactory> factory, double schwarz, double delta, size_t memory);
     virtual ~CholeskyERI();
 
     virtual size_t N();
     virtual void compute_diagonal(double* target);
     virtual void compute_row(int row, double* target);
+    /// Rows are spread over the threads; serial if integral_ cannot be cloned
+    virtual void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets);
 };
 
 class CholeskyMP2 : public Cholesky {
@@ -0,0 +1,225 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "df_cache.h"
+#include "df_shm.h"
+#include "dftensor.h"
+
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+namespace psi {
+
+namespace {
+std::map<std::string, SharedMatrix> metric_cache_;
+std::map<std::string, SharedMatrix> cholesky_cache_;
+std::map<std::string, SharedMatrix> Qmn_cache_;
+
+std::string number_key(double x)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6E", x);
+    return std::string(buf);
+}
+}
+
+bool DFIntsCache::enabled()
+{
+    return Process::environment.options.get_bool("DF_INTS_CACHE");
+}
+
+bool DFIntsCache::shm_enabled()
+{
+    return Process::environment.options.get_bool("DF_INTS_SHM");
+}
+
+std::string DFIntsCache::basis_key(std::shared_ptr<BasisSet> basis)
+{
+    std::string key = basis->name() + "/" + std::to_string(basis->nbf()) + "/" + std::to_string(basis->nshell());
+    std::shared_ptr<Molecule> mol = basis->molecule();
+    char buf[96];
+    for (int A = 0; A < mol->natom(); A++) {
+        std::snprintf(buf, sizeof(buf), "|%.10f,%.10f,%.10f", mol->x(A), mol->y(A), mol->z(A));
+        key += buf;
+    }
+    return key;
+}
+
+SharedMatrix DFIntsCache::metric_power(std::shared_ptr<BasisSet> aux, double power, double condition)
+{
+    bool cache = enabled();
+    std::string key;
+    if (cache) {
+        key = basis_key(aux) + "#" + number_key(power) + "#" + number_key(condition);
+        auto it = metric_cache_.find(key);
+        if (it != metric_cache_.end()) return it->second;
+    }
+
+    std::shared_ptr<FittingMetric> metric(new FittingMetric(aux, true));
+    SharedMatrix Jp;
+    if (power == -0.5) {
+        metric->form_eig_inverse(condition);
+        Jp = metric->get_metric();
+    } else if (power == -1.0) {
+        metric->form_full_eig_inverse(condition);
+        Jp = metric->get_metric();
+    } else {
+        metric->form_fitting_metric();
+        Jp = metric->get_metric();
+        Jp->power(power, condition);
+    }
+
+    if (cache) metric_cache_[key] = Jp;
+    return Jp;
+}
+
+SharedMatrix DFIntsCache::metric_cholesky(std::shared_ptr<BasisSet> aux, double condition)
+{
+    bool cache = enabled();
+    std::string key;
+    if (cache) {
+        key = basis_key(aux) + "#" + number_key(condition);
+        auto it = cholesky_cache_.find(key);
+        if (it != cholesky_cache_.end()) return it->second;
+    }
+
+    std::shared_ptr<FittingMetric> metric(new FittingMetric(aux, true));
+    metric->form_fitting_metric();
+    SharedMatrix L = metric->get_metric();
+    L->set_name("SO Basis Cholesky Factor (Lower)");
+    double** Lp = L->pointer();
+    int n = L->rowspi()[0];
+
+    double anorm = 0.0;
+    for (int Q = 0; Q < n; Q++) {
+        double col = 0.0;
+        for (int P = 0; P < n; P++) col += std::fabs(Lp[P][Q]);
+        anorm = std::max(anorm, col);
+    }
+
+    // LAPACK's upper factor of the row-major J is our lower one
+    int info = (n ? C_DPOTRF('U', n, Lp[0], n) : 0);
+    double rcond = 1.0;
+    if (!info && n) {
+        std::vector<double> work(3 * n);
+        std::vector<int> iwork(n);
+        info = C_DPOCON('U', n, Lp[0], n, anorm, &rcond, work.data(), iwork.data());
+    }
+    if (info || rcond < condition) {
+        L.reset();
+    } else {
+        for (int P = 0; P < n; P++)
+            for (int Q = P + 1; Q < n; Q++) Lp[P][Q] = 0.0;
+    }
+
+    if (cache) cholesky_cache_[key] = L;
+    return L;
+}
+
+SharedMatrix DFIntsCache::lookup(const std::string& key)
+{
+    auto it = Qmn_cache_.find(key);
+    if (it != Qmn_cache_.end()) return it->second;
+    if (!shm_enabled()) return SharedMatrix();
+
+    SharedMatrix M = SharedMemoryMatrix::attach(key, "Qmn (Shared)");
+    if (M) Qmn_cache_[key] = M;
+    return M;
+}
+
+SharedMatrix DFIntsCache::store(const std::string& key, SharedMatrix M)
+{
+    if (shm_enabled()) {
+        // Another process may have published it meanwhile, then M stays private
+        SharedMatrix S = SharedMemoryMatrix::create(key, M);
+        if (S) M = S;
+    }
+    Qmn_cache_[key] = M;
+    return M;
+}
+
+SharedMatrix DFIntsCache::get_Qmn(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux, double cutoff)
+{
+    if (!enabled() && !shm_enabled()) return SharedMatrix();
+    SharedMatrix M = lookup(basis_key(primary) + "#" + basis_key(aux) + "#" + number_key(cutoff));
+    if (M) outfile->Printf("    Reusing cached (Q|mn) for %s/%s.\n\n", primary->name().c_str(), aux->name().c_str());
+    return M;
+}
+
+SharedMatrix DFIntsCache::set_Qmn(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux, double cutoff,
+                                  SharedMatrix Qmn)
+{
+    if (!enabled() && !shm_enabled()) return Qmn;
+    return store(basis_key(primary) + "#" + basis_key(aux) + "#" + number_key(cutoff), Qmn);
+}
+
+SharedMatrix DFIntsCache::get_cholesky(std::shared_ptr<BasisSet> primary, double tolerance)
+{
+    if (!enabled() && !shm_enabled()) return SharedMatrix();
+    SharedMatrix M = lookup("CD#" + basis_key(primary) + "#" + number_key(tolerance));
+    if (M) outfile->Printf("    Reusing cached Cholesky (Q|mn) for %s.\n\n", primary->name().c_str());
+    return M;
+}
+
+SharedMatrix DFIntsCache::set_cholesky(std::shared_ptr<BasisSet> primary, double tolerance, SharedMatrix Qmn)
+{
+    if (!enabled() && !shm_enabled()) return Qmn;
+    return store("CD#" + basis_key(primary) + "#" + number_key(tolerance), Qmn);
+}
+
+std::map<std::string, SharedMatrix> DFIntsCache::tensors()
+{
+    return Qmn_cache_;
+}
+
+void DFIntsCache::adopt(const std::string& key, SharedMatrix Qmn)
+{
+    if (!enabled() && !shm_enabled()) return;
+    if (Qmn_cache_.count(key)) return;
+    store(key, Qmn);
+}
+
+void DFIntsCache::clear()
+{
+    metric_cache_.clear();
+    cholesky_cache_.clear();
+    Qmn_cache_.clear();
+    SharedMemoryMatrix::unlink_created();
+}
+
+}  // namespace psi
@@ -0,0 +1,103 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef three_index_df_cache_H
+#define three_index_df_cache_H
+
+#include "psi4/libmints/typedefs.h"
+
+#include <map>
+#include <string>
+
+namespace psi {
+
+class BasisSet;
+
+/**
+ * Process-wide store of three-index intermediates (DF_INTS_CACHE).
+ *
+ * Entries are keyed on the basis set names, sizes and the geometry they sit
+ * on, so a module that builds its own copy of the same auxiliary basis still
+ * hits, and a new geometry never does. Cached matrices are shared, callers
+ * must treat them as read-only. Everything is dropped by psi4.core.clean().
+ *
+ * With DF_INTS_SHM the (Q|mn) tensors are also published as POSIX
+ * shared-memory segments (see SharedMemoryMatrix), which other Psi4
+ * processes of the same user on the node attach to instead of building.
+ */
+class DFIntsCache {
+public:
+    /// Is DF_INTS_CACHE on?
+    static bool enabled();
+    /// Is DF_INTS_SHM on? (implies the in-process cache for tensors)
+    static bool shm_enabled();
+
+    /// J^power of the C1 fitting metric of aux, eigenvalues below condition * max dropped.
+    /// Always computed through FittingMetric; stored and reused when the cache is on.
+    static SharedMatrix metric_power(std::shared_ptr<BasisSet> aux, double power, double condition);
+    /// Lower Cholesky factor L of the C1 fitting metric of aux (J = L L^T), or nullptr when
+    /// the reciprocal condition estimate of J is below condition and the eigenvalue routes
+    /// are needed. L^-1 fits (A|mn) as well as J^-1/2 wherever only B^T B is formed.
+    /// Stored and reused when the cache is on.
+    static SharedMatrix metric_cholesky(std::shared_ptr<BasisSet> aux, double condition);
+
+    /// Fitted (Q|mn) (J^-1/2 or L^-1) over the Schwarz-significant pairs of primary at cutoff, or nullptr
+    static SharedMatrix get_Qmn(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux, double cutoff);
+    /// Keep a fitted (Q|mn) for later get_Qmn() calls (no-op with the cache off).
+    /// Returns the copy the caller should hold on to, which is the shared-memory
+    /// one under DF_INTS_SHM, otherwise Qmn itself.
+    static SharedMatrix set_Qmn(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> aux, double cutoff,
+                                SharedMatrix Qmn);
+
+    /// Cholesky (Q|mn) of primary at tolerance, or nullptr
+    static SharedMatrix get_cholesky(std::shared_ptr<BasisSet> primary, double tolerance);
+    /// As set_Qmn(), for Cholesky (Q|mn)
+    static SharedMatrix set_cholesky(std::shared_ptr<BasisSet> primary, double tolerance, SharedMatrix Qmn);
+
+    /// Every (Q|mn) tensor held, by key (for orbital checkpoints, see CHECKPOINT_DF_INTS)
+    static std::map<std::string, SharedMatrix> tensors();
+    /// Hold Qmn under key, as returned by tensors() in this or an earlier run.
+    /// Keys carry the bases and geometry, so tensors of another system are never hit.
+    static void adopt(const std::string& key, SharedMatrix Qmn);
+
+    /// Drop every entry, and unlink the shared-memory segments this process made
+    static void clear();
+
+protected:
+    /// Name, size and geometry of a basis set
+    static std::string basis_key(std::shared_ptr<BasisSet> basis);
+
+    /// Tensor stored under key, from this process or a shared-memory segment
+    static SharedMatrix lookup(const std::string& key);
+    /// Store a tensor under key, see set_Qmn()
+    static SharedMatrix store(const std::string& key, SharedMatrix M);
+};
+
+}  // namespace psi
+
+#endif
@@ -47,6 +47,8 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/aiohandler.h"
 
+#include <algorithm>
+#include <future>
 #include <unistd.h>
 #ifdef _OPENMP
     #include <omp.h>
@@ -243,6 +245,30 @@ void DF_Helper::prepare_sparsity()
 //    #pragma omp parallel for simd num_threads(nthreads_) schedule(static)
     for(size_t i=0; i<pshells_*pshells_; i++)
         schwarz_shell_mask_[i] = (shell_prints[i]<cutoff_ ? 0 : 1);
+    schwarz_shell_max_ = shell_prints;
+
+    // auxiliary side: (P|mn) <= sqrt((P|P)) sqrt((mn|mn))
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    IntegralFactory auxfactory(aux_, zero, aux_, zero);
+    #pragma omp parallel num_threads(nthreads_) private(rank)
+    {
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        eri[rank] = std::shared_ptr<TwoBodyAOInt>(auxfactory.eri());
+        buffer[rank] = eri[rank]->buffer();
+    }
+    Qshell_max_.assign(Qshells_, 0.0);
+    #pragma omp parallel for private(rank) num_threads(nthreads_) schedule(guided)
+    for(size_t P=0; P<Qshells_; P++){
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        size_t numP = aux_->shell(P).nfunction();
+        eri[rank]->compute_shell(P,0,P,0);
+        for(size_t p=0; p<numP; p++)
+            Qshell_max_[P] = std::max(Qshell_max_[P], std::fabs(buffer[rank][p*numP+p]));
+    }
 
     size_t count;
     #pragma omp parallel for private(count) num_threads(nthreads_)
@@ -269,6 +295,20 @@ void DF_Helper::prepare_sparsity()
         big_skips_[j+1] = size+big_skips_[j];
     }
     small_skips_[nao_]=coltots;
+
+    // pair list, so the gathers below never scan a dense mask row
+    pair_offsets_.assign(nao_+1, 0);
+    for(size_t i=0; i<nao_; i++)
+        pair_offsets_[i+1] = pair_offsets_[i]+small_skips_[i];
+    schwarz_fun_index_.resize(coltots);
+    #pragma omp parallel for num_threads(nthreads_)
+    for(size_t i=0; i<nao_; i++){
+        size_t* row = &schwarz_fun_index_[pair_offsets_[i]];
+        for(size_t j=0; j<nao_; j++){
+            if(schwarz_fun_mask_[i*nao_+j])
+                row[schwarz_fun_mask_[i*nao_+j]-1] = j;
+        }
+    }
 }
 void DF_Helper::print_masks()
 {
@@ -452,6 +492,16 @@ return file_status_[filename].fp;
 }
 void DF_Helper::put_tensor(std::string file, double* b, std::pair<size_t, size_t> i0,
   std::pair<size_t, size_t> i1, std::pair<size_t, size_t> i2, std::string op)
+{
+    write_tensor(stream_check(file, op), file, b, i0, i1, i2);
+}
+void DF_Helper::put_tensor(std::string file, double* Mp, const size_t start1,
+ const size_t stop1, const size_t start2, const size_t stop2, std::string op)
+{
+    write_tensor(stream_check(file, op), file, Mp, start1, stop1, start2, stop2);
+}
+void DF_Helper::write_tensor(FILE* fp, std::string file, double* b, std::pair<size_t, size_t> i0,
+  std::pair<size_t, size_t> i1, std::pair<size_t, size_t> i2)
 {
     // collapse to 2D, assume file has form (i1 | i2 i3)
     size_t A2 = std::get<2>(sizes_[file]);
@@ -469,19 +519,19 @@ void DF_Helper::put_tensor(std::string file, double* b, std::pair<size_t, size_t
 
     // check contiguity (a2)
     if(A2==a2){
-        put_tensor(file, b, sta0, sto0, a2*sta1, a2*(sto1+1)-1, op);
+        write_tensor(fp, file, b, sta0, sto0, a2*sta1, a2*(sto1+1)-1);
     }
     else{ // loop (a0, a1)
         for(size_t j=0; j<a0; j++){
             for(size_t i=0; i<a1; i++){
-                put_tensor(file, &b[j*(a1*a2)+i*a2], sta0+j, sta0+j,
-                  (i+sta1)*A2+sta2, (i+sta1)*A2+sta2+a2-1, op);
+                write_tensor(fp, file, &b[j*(a1*a2)+i*a2], sta0+j, sta0+j,
+                  (i+sta1)*A2+sta2, (i+sta1)*A2+sta2+a2-1);
             }
         }
     }
 }
-void DF_Helper::put_tensor(std::string file, double* Mp, const size_t start1,
- const size_t stop1, const size_t start2, const size_t stop2, std::string op)
+void DF_Helper::write_tensor(FILE* fp, std::string file, double* Mp, const size_t start1,
+ const size_t stop1, const size_t start2, const size_t stop2)
 {
     size_t a0 = stop1-start1+1;
     size_t a1 = stop2-start2+1;
@@ -489,9 +539,6 @@ void DF_Helper::put_tensor(std::string file, double* Mp, const size_t start1,
     size_t A1 = std::get<1>(sizes_[file])*std::get<2>(sizes_[file]);
     size_t st = A1-a1;
 
-    // begin stream
-    FILE* fp = stream_check(file, op);
-
     // adjust position
     fseek(fp, (start1*A0+start2)*sizeof(double), SEEK_SET);
 
@@ -654,23 +701,17 @@ void DF_Helper::compute_AO_Q(const size_t start, const size_t stop, double* Mp,
     size_t   end = Qshell_aggs_[stop+1]-1;
     size_t block_size = end-begin+1;
 
-    // prepare eri buffers
+    // prepare per-thread quartet batches and eri buffers
     size_t nthread = nthreads_;
     if(eri.size() != nthreads_)
         nthread = eri.size();
 
     int rank = 0;
-    std::vector<const double*> buffer(nthread);
-    #pragma omp parallel private(rank) num_threads(nthread)
-    {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<std::vector<ShellQuartet>> batches(nthread);
+    std::vector<std::vector<double>> batch_buffers(nthread);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
-    #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, rank) schedule(guided) num_threads(nthreads_)
+    #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, rank) schedule(guided) num_threads(nthread)
     for (MU=0; MU<pshells_; MU++){
        #ifdef _OPENMP
             rank = omp_get_thread_num();
@@ -679,10 +720,25 @@ void DF_Helper::compute_AO_Q(const size_t start, const size_t stop, double* Mp,
         for (NU=0; NU<pshells_; NU++){
             numnu = primary_ -> shell(NU).nfunction();
             if(!schwarz_shell_mask_[MU*pshells_+NU]){continue;}
+
+            // compute the surviving (P 0|MU NU) of this block in one call
+            std::vector<ShellQuartet>& batch = batches[rank];
+            batch.clear();
+            for (Pshell=start; Pshell<=stop; Pshell++){
+                if(!aux_negligible(Pshell, MU, NU))
+                    batch.push_back({{(int) Pshell, 0, (int) MU, (int) NU}});
+            }
+            std::vector<double>& batch_buffer = batch_buffers[rank];
+            size_t batch_ints = eri[rank] -> batch_size(batch);
+            if(batch_buffer.size() < batch_ints) batch_buffer.resize(batch_ints);
+            if(!batch.empty()) eri[rank] -> compute_shell_batch(batch, batch_buffer.data());
+
+            size_t bind = 0;
+            const double* buffer = batch_buffer.data();
             for (Pshell=start; Pshell<=stop; Pshell++){
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_ -> shell(Pshell).nfunction();
-                eri[rank] -> compute_shell(Pshell, 0, MU, NU);
+                bool skip = (bind == batch.size() || (size_t) batch[bind][0] != Pshell);
                 for (mu=0; mu<nummu; mu++){
                     omu = primary_ -> shell(MU).function_index() + mu;
                     for(nu=0; nu<numnu; nu++){
@@ -691,10 +747,14 @@ void DF_Helper::compute_AO_Q(const size_t start, const size_t stop, double* Mp,
                         for(P=0; P<numP; P++){
                             Mp[(big_skips_[omu]*block_size)/naux_
                               +(PHI+P-begin)*small_skips_[omu]+schwarz_fun_mask_[omu*nao_+onu]-1]
-                              = buffer[rank][P*nummu*numnu + mu*numnu + nu];
+                              = (skip ? 0.0 : buffer[P*nummu*numnu + mu*numnu + nu]);
                         }
                     }
                 }
+                if(!skip){
+                    buffer += numP*nummu*numnu;
+                    bind++;
+                }
             }
         }
     }
@@ -708,20 +768,14 @@ void DF_Helper::compute_AO_p(const size_t start, const size_t stop, double* Mp,
     outfile->Printf("      MU shell: (%zu, %zu)", start, stop);
     outfile->Printf(", nao index: (%zu, %zu), size: %zu\n", begin, end, block_size);
 
-    // prepare eri buffers
+    // prepare per-thread quartet batches and eri buffers
     size_t nthread = nthreads_;
     if(eri.size() != nthreads_)
         nthread = eri.size();
 
     int rank = 0;
-    std::vector<const double*> buffer(nthread);
-    #pragma omp parallel private(rank) num_threads(nthread)
-    {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<std::vector<ShellQuartet>> batches(nthread);
+    std::vector<std::vector<double>> batch_buffers(nthread);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
     #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, rank) schedule(guided) num_threads(nthread)
@@ -733,10 +787,25 @@ void DF_Helper::compute_AO_p(const size_t start, const size_t stop, double* Mp,
         for (NU=0; NU<pshells_; NU++){
             numnu = primary_->shell(NU).nfunction();
             if(!schwarz_shell_mask_[MU*pshells_+NU]) {continue;}
+
+            // compute the surviving (P 0|MU NU) of this block in one call
+            std::vector<ShellQuartet>& batch = batches[rank];
+            batch.clear();
+            for (Pshell=0; Pshell<Qshells_; Pshell++){
+                if(!aux_negligible(Pshell, MU, NU))
+                    batch.push_back({{(int) Pshell, 0, (int) MU, (int) NU}});
+            }
+            std::vector<double>& batch_buffer = batch_buffers[rank];
+            size_t batch_ints = eri[rank]->batch_size(batch);
+            if(batch_buffer.size() < batch_ints) batch_buffer.resize(batch_ints);
+            if(!batch.empty()) eri[rank]->compute_shell_batch(batch, batch_buffer.data());
+
+            size_t bind = 0;
+            const double* buffer = batch_buffer.data();
             for (Pshell=0; Pshell<Qshells_; Pshell++){
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_->shell(Pshell).nfunction();
-                eri[rank]->compute_shell(Pshell, 0, MU, NU);
+                bool skip = (bind == batch.size() || (size_t) batch[bind][0] != Pshell);
                 for (mu=0; mu<nummu; mu++){
                     omu = primary_ -> shell(MU).function_index() + mu;
                     for(nu=0; nu<numnu; nu++){
@@ -745,10 +814,14 @@ void DF_Helper::compute_AO_p(const size_t start, const size_t stop, double* Mp,
                         for(P=0; P<numP; P++){
                             Mp[big_skips_[omu]-startind+(PHI+P)*small_skips_[omu]
                               + schwarz_fun_mask_[omu*nao_+onu]-1]
-                              = buffer[rank][P*nummu*numnu + mu*numnu + nu];
+                              = (skip ? 0.0 : buffer[P*nummu*numnu + mu*numnu + nu]);
                         }
                     }
                 }
+                if(!skip){
+                    buffer += numP*nummu*numnu;
+                    bind++;
+                }
             }
         }
     }
@@ -1056,18 +1129,21 @@ void DF_Helper::clear()
         left  = std::get<0>(files_[kv.first]);
         right = std::get<1>(files_[kv.first]);
 
-        // close streams
+        // close streams (a transformation that never ran has none)
         if(!core_){
-            if(direct_)
+            if(direct_ && file_status_.find(left) != file_status_.end())
                 fclose(file_status_[left].fp);
-            fclose(file_status_[right].fp);
+            if(file_status_.find(right) != file_status_.end())
+                fclose(file_status_[right].fp);
         }
 
-        // delete stream holders
+        // delete stream holders and the files themselves
         if(!core_){
             if(direct_)
                 file_status_.erase(left);
             file_status_.erase(right);
+            remove(left.c_str());
+            remove(right.c_str());
         }
 
         // delete file holders, sizes
@@ -1190,7 +1266,7 @@ void DF_Helper::transform_core()
     // stripe transformed integrals
     for(auto& kv : transf_){
         size_t size = std::get<1>(spaces_[std::get<0>(kv.second)])*std::get<1>(spaces_[std::get<1>(kv.second)]);
-        transf_core_[kv.first].reserve(size*naux);
+        transf_core_[kv.first].resize(size*naux);
     }
 
     // declare bufs
@@ -1228,12 +1304,9 @@ void DF_Helper::transform_core()
 #ifdef _OPENMP
             rank = omp_get_thread_num();
 #endif
-            for(size_t m=0, sp_count= -1; m<nao_; m++){
-                if(schwarz_fun_mask_[k*nao_+m]){
-                    sp_count++;
-                    C_DCOPY(bsize, &Bpt[m*bsize], 1, &C_buffers[rank][sp_count*bsize], 1);
-                }
-            }
+            const size_t* pairs = &schwarz_fun_index_[pair_offsets_[k]];
+            for(size_t sp=0; sp<sp_size; sp++)
+                C_DCOPY(bsize, &Bpt[pairs[sp]*bsize], 1, &C_buffers[rank][sp*bsize], 1);
 
             // (Qm)(mb)->(Qb)
             C_DGEMM('N', 'N', block_size, bsize, sp_size, 1.0,
@@ -1328,6 +1401,16 @@ void DF_Helper::transform_disk() {
         Qlargest_ = shell_blocks(memory_, max, 0, Qshells_, Qsteps_);
     }
 
+    // the pipeline holds two AO blocks and two output blocks at once
+    std::vector<std::pair<size_t, size_t>> Qsteps_serial;
+    std::pair<size_t, size_t> Qlargest_serial;
+    if (AO_async_) {
+        Qsteps_serial = Qsteps_;
+        Qlargest_serial = Qlargest_;
+        Qsteps_.clear();
+        Qlargest_ = shell_blocks(memory_ / 2, max, 0, Qshells_, Qsteps_);
+    }
+
     timer_on("DF_Helper~transform - setup ");
     // enhance cache use
     size_t naux = naux_;
@@ -1364,6 +1447,33 @@ void DF_Helper::transform_disk() {
         double* Tp = T.data();
         double* Fp = F.data();
         double* Np = N.data();
+
+        // pipelined mode: an I/O thread reads AO block j+1 into the second
+        // M while block j is transformed, and writes each finished N while
+        // the next one is formed in the second N
+        std::vector<double> M2;
+        std::vector<double> N2;
+        double* Mbuf[2] = {Mp, Mp};
+        double* Nbuf[2] = {Np, Np};
+        std::future<void> reader;
+        std::future<void> writer;
+        bool prefetch = AO_async_ && !direct_;
+        if (AO_async_) {
+            N2.reserve(naux_ * max);
+            Nbuf[1] = N2.data();
+            // only this thread opens streams, check them all in now
+            for (size_t k = 0; k < order_.size(); k++)
+                stream_check((!direct_ ? std::get<1>(files_[order_[k]]) : std::get<0>(files_[order_[k]])), "wb");
+        }
+        if (prefetch) {
+            M2.reserve(std::get<0>(Qlargest_));
+            Mbuf[1] = M2.data();
+            if (Qsteps_.size()) {
+                size_t start = std::get<0>(Qsteps_[0]);
+                size_t stop = std::get<1>(Qsteps_[0]);
+                reader = std::async(std::launch::async, [this, start, stop, Mp]() { grab_AO(start, stop, Mp); });
+            }
+        }
         timer_off("DF_Helper~transform - setup ");
 
         // transform in steps
@@ -1381,7 +1491,19 @@ void DF_Helper::transform_disk() {
 
             // get AO chunk according to directive
             timer_on("DF_Helper~transform - grab  ");
-            (direct_ ? compute_AO_Q(start, stop, Mp, eri) : grab_AO(start, stop, Mp));
+            if (prefetch) {
+                // block j is in Mbuf[j % 2], the other buffer is free again
+                reader.get();
+                Mp = Mbuf[j % 2];
+                if (j + 1 < Qsteps_.size()) {
+                    size_t nstart = std::get<0>(Qsteps_[j + 1]);
+                    size_t nstop = std::get<1>(Qsteps_[j + 1]);
+                    double* Mnext = Mbuf[(j + 1) % 2];
+                    reader = std::async(std::launch::async,
+                                        [this, nstart, nstop, Mnext]() { grab_AO(nstart, nstop, Mnext); });
+                }
+            } else
+                (direct_ ? compute_AO_Q(start, stop, Mp, eri) : grab_AO(start, stop, Mp));
             timer_off("DF_Helper~transform - grab  ");
 
             size_t count = 0;
@@ -1403,13 +1525,9 @@ void DF_Helper::transform_disk() {
 #ifdef _OPENMP
                     rank = omp_get_thread_num();
 #endif
-                    for (size_t m = 0, sp_count = -1; m < nao_; m++) {
-                        if (schwarz_fun_mask_[k * nao_ + m]) {
-                            sp_count++;
-                            C_DCOPY(bsize, &Bpt[m * bsize], 1, &C_buffers[rank][sp_count * bsize],
-                                    1);
-                        }
-                    }
+                    const size_t* pairs = &schwarz_fun_index_[pair_offsets_[k]];
+                    for (size_t sp = 0; sp < sp_size; sp++)
+                        C_DCOPY(bsize, &Bpt[pairs[sp] * bsize], 1, &C_buffers[rank][sp * bsize], 1);
 
                     // (Qm)(mb)->(Qb)
                     C_DGEMM('N', 'N', block_size, bsize, sp_size, 1.0, &Mp[jump], sp_size,
@@ -1443,6 +1561,7 @@ void DF_Helper::transform_disk() {
                     size_t st1 = bsize * wsize;
                     size_t st2 = bsize * block_size;
 
+                    std::pair<size_t, size_t> i1, i2;
                     if (bspace.compare(left) == 0) { // (w|Qb)->(Q|bw)
                         timer_on("DF_Helper~transform - transp");
                         #pragma omp parallel for num_threads(nthreads_) firstprivate(st1, st2)
@@ -1454,10 +1573,8 @@ void DF_Helper::transform_disk() {
                             }
                         }
                         timer_off("DF_Helper~transform - transp");
-                        timer_on("DF_Helper~transform - write ");
-                        put_tensor(putf, Np, std::make_pair(begin, end), std::make_pair(0, bsize - 1),
-                                             std::make_pair(0, wsize - 1), op);
-                        timer_off("DF_Helper~transform - write ");
+                        i1 = std::make_pair(0, bsize - 1);
+                        i2 = std::make_pair(0, wsize - 1);
                     } else {  // (w|Qb)->(Q|wb)
                         timer_on("DF_Helper~transform - transp");
                         #pragma omp parallel for num_threads(nthreads_) firstprivate(st1, st2)
@@ -1470,17 +1587,35 @@ void DF_Helper::transform_disk() {
                             }
                         }
                         timer_off("DF_Helper~transform - transp");
-                        timer_on("DF_Helper~transform - write ");
-                        put_tensor(putf, Np, std::make_pair(begin, end), std::make_pair(0, wsize - 1),
-                                             std::make_pair(0, bsize - 1), op);
-                        timer_off("DF_Helper~transform - write ");
+                        i1 = std::make_pair(0, wsize - 1);
+                        i2 = std::make_pair(0, bsize - 1);
                     }
+
+                    timer_on("DF_Helper~transform - write ");
+                    if (AO_async_) {
+                        // the previous write (from the other buffer) has to land
+                        // before its stream may be reopened or the buffer refilled
+                        if (writer.valid()) writer.get();
+                        FILE* fp = stream_check(putf, op);
+                        std::pair<size_t, size_t> i0 = std::make_pair(begin, end);
+                        double* Nw = Np;
+                        writer = std::async(std::launch::async,
+                                            [this, fp, putf, Nw, i0, i1, i2]() { write_tensor(fp, putf, Nw, i0, i1, i2); });
+                        Np = (Np == Nbuf[0] ? Nbuf[1] : Nbuf[0]);
+                    } else
+                        put_tensor(putf, Np, std::make_pair(begin, end), i1, i2, op);
+                    timer_off("DF_Helper~transform - write ");
                 }
                 count += strides_[i];
             }
         }
+        if (writer.valid()) writer.get();
         outfile->Printf("\n     ==> DF_Helper:--End Transformations (disk)<==\n\n");
     }
+    if (AO_async_) {
+        Qsteps_ = Qsteps_serial;
+        Qlargest_ = Qlargest_serial;
+    }
     if (direct_) {
         // total size allowed, in doubles
         size_t total_mem = (memory_ - naux_ * naux_) / 2;
@@ -2097,6 +2232,10 @@ void DF_Helper::JK_disk(std::vector<SharedMatrix> Cleft, std::vector<SharedMatri
     std::vector<SharedMatrix> D;
     compute_D(D, Cleft, Cright);
 
+    // density-weighted screening of (km) pairs in the J contraction
+    if (!sieve_) sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+    sieve_->set_density(D);
+
     timer_off("DF_Helper~transform - setup ");
 
     // transform in steps (blocks of Q)
@@ -2132,6 +2271,7 @@ void DF_Helper::JK_disk(std::vector<SharedMatrix> Cleft, std::vector<SharedMatri
      
         bcount += block_size;
     }
+    sieve_->clear_density();
     outfile->Printf("\n     ==> DF_Helper:--End J/K Builds (disk)<==\n\n");
 }
 void DF_Helper::compute_D(std::vector<SharedMatrix>& D, std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright){
@@ -2186,12 +2326,20 @@ void DF_Helper::compute_J(std::vector<SharedMatrix> D, std::vector<SharedMatrix>
             rank = omp_get_thread_num();
             #endif
 
-            for (size_t m = 0, sp_count = -1; m < nao_; m++) {
-                if (schwarz_fun_mask_[k * nao + m]) {
-                    sp_count++;
-                    C_DCOPY(1, &Dp[nao*k+m], 1, &D_buffers[rank][sp_count], 1);
+            bool significant = false;
+            const size_t* pairs = &schwarz_fun_index_[pair_offsets_[k]];
+            for (size_t sp = 0; sp < sp_size; sp++) {
+                size_t m = pairs[sp];
+                if (sieve_->function_pair_significant_density(k, m)) {
+                    D_buffers[rank][sp] = Dp[nao*k+m];
+                    significant = true;
+                } else {
+                    D_buffers[rank][sp] = 0.0;
                 }
             }
+            // no density in this row survives screening
+            if (!significant) continue;
+
             // (Qm)(m) -> (Q)
             C_DGEMV('N', block_size, sp_size, 1.0, &Mp[jump], sp_size, &D_buffers[rank][0], 1, 1.0, &T1p[rank*naux], 1);
         }
@@ -2249,12 +2397,9 @@ void DF_Helper::compute_K(std::vector<SharedMatrix> Cleft,
             rank = omp_get_thread_num();
             #endif
             
-            for (size_t m = 0, sp_count = -1; m < nao_; m++) {
-                if (schwarz_fun_mask_[k * nao_ + m]) {
-                    sp_count++;
-                    C_DCOPY(cleft, &Clp[m * cleft], 1, &C_buffers[rank][sp_count * cleft], 1);
-                }
-            }
+            const size_t* pairs = &schwarz_fun_index_[pair_offsets_[k]];
+            for (size_t sp = 0; sp < sp_size; sp++)
+                C_DCOPY(cleft, &Clp[pairs[sp] * cleft], 1, &C_buffers[rank][sp * cleft], 1);
             // (Qm)(mb)->(Qb)
             C_DGEMM('N', 'N', block_size, cleft, sp_size, 1.0, &Mp[jump], sp_size,
                     &C_buffers[rank][0], cleft, 0.0, &Tp[k * block_size * cleft], cleft);
@@ -2269,12 +2414,9 @@ void DF_Helper::compute_K(std::vector<SharedMatrix> Cleft,
                 rank = omp_get_thread_num();
                 #endif
                 
-                for (size_t m = 0, sp_count = -1; m < nao_; m++) {
-                    if (schwarz_fun_mask_[k * nao_ + m]) {
-                        sp_count++;
-                        C_DCOPY(cright, &Crp[m * cright], 1, &C_buffers[rank][sp_count * cright], 1);
-                    }
-                }
+                const size_t* pairs = &schwarz_fun_index_[pair_offsets_[k]];
+                for (size_t sp = 0; sp < sp_size; sp++)
+                    C_DCOPY(cright, &Crp[pairs[sp] * cright], 1, &C_buffers[rank][sp * cright], 1);
                 // (Qm)(mb)->(Qb)
                 C_DGEMM('N', 'N', block_size, cright, sp_size, 1.0, &Mp[jump], sp_size,
                         &C_buffers[rank][0], cright, 0.0, &T2p[k * block_size * cright], cright);
@@ -2287,4 +2429,55 @@ void DF_Helper::compute_K(std::vector<SharedMatrix> Cleft,
         }
     }
 }
+
+namespace {
+// One entry per shared helper. The primary basis is matched by identity (a new
+// geometry or a new wavefunction builds a new one), the auxiliary basis by name,
+// since modules build their own copies of e.g. DF_BASIS_MP2 and DF_BASIS_CC.
+struct SharedEntry {
+    std::weak_ptr<BasisSet> primary;
+    std::string aux_name;
+    size_t naux;
+    size_t wMO;
+    std::shared_ptr<DF_Helper> dfh;
+};
+std::vector<SharedEntry> shared_helpers_;
+}
+std::shared_ptr<DF_Helper> DF_Helper::get_shared(std::shared_ptr<BasisSet> primary,
+    std::shared_ptr<BasisSet> aux, size_t wMO)
+{
+    // forget helpers that nobody else uses and whose primary basis only they still hold
+    shared_helpers_.erase(std::remove_if(shared_helpers_.begin(), shared_helpers_.end(),
+        [](const SharedEntry& e) { return e.dfh.use_count() == 1 && e.primary.use_count() <= 1; }),
+        shared_helpers_.end());
+
+    for (auto& e : shared_helpers_) {
+        if (e.primary.lock() == primary && e.aux_name == aux->name() && e.naux == (size_t) aux->nbf()
+            && e.wMO >= wMO) {
+            outfile->Printf("    DF_Helper: reusing the (Q|pq) integrals of %s/%s\n",
+                primary->name().c_str(), aux->name().c_str());
+            e.dfh->clear();
+            // transform() trims the hint to the last spaces, restore the blocking bound
+            e.dfh->set_MO_hint(e.wMO);
+            return e.dfh;
+        }
+    }
+    return nullptr;
+}
+void DF_Helper::set_shared(std::shared_ptr<DF_Helper> dfh)
+{
+    if (!dfh->built || dfh->direct_)
+        throw PSIEXCEPTION("DF_Helper:set_shared: only initialized, non-DIRECT helpers hold AO integrals to share");
+    SharedEntry e;
+    e.primary  = dfh->primary_;
+    e.aux_name = dfh->aux_->name();
+    e.naux     = dfh->naux_;
+    e.wMO      = dfh->wMO_;
+    e.dfh      = dfh;
+    shared_helpers_.push_back(e);
+}
+void DF_Helper::release_shared()
+{
+    shared_helpers_.clear();
+}
 }}  // End namespaces
@@ -87,6 +87,11 @@ public:
     // tell me what the worst MO index size is!
     void set_MO_hint(size_t wMO) {wMO_ = wMO;}
     size_t get_MO_hint() { return wMO_;}
+
+    // overlap disk reads and writes with the GEMMs in disk transformations
+    // (costs a second AO and output buffer, taken out of the memory budget)
+    void set_AO_async(bool async) {AO_async_ = async;}
+    bool get_AO_async() { return AO_async_;}
     // user options, must set before build---------------------------------
 
     // Initialize the object
@@ -132,6 +137,15 @@ public:
     void build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, 
         std::vector<SharedMatrix> J, std::vector<SharedMatrix> K); 
 
+    // => Process-wide sharing of the fitted AO integrals <=
+    // an initialized, cleared helper for this basis pair that takes MO spaces up to wMO, or nullptr
+    static std::shared_ptr<DF_Helper> get_shared(std::shared_ptr<BasisSet> primary,
+        std::shared_ptr<BasisSet> aux, size_t wMO);
+    // keep an initialized helper (and its AO integrals) for later get_shared() calls
+    static void set_shared(std::shared_ptr<DF_Helper> dfh);
+    // drop all shared helpers and their scratch files (psi4.core.clean())
+    static void release_shared();
+
 protected:
 
     // basis sets
@@ -161,6 +175,9 @@ protected:
     double mpower_ = -0.5;
     bool hold_met_ = false;
 
+    // pipelined transform_disk
+    bool AO_async_ = false;
+
     // => Internal holders <=
     bool built = false;    
 
@@ -208,6 +225,18 @@ protected:
     std::vector<size_t> schwarz_fun_mask_;
     std::vector<size_t> schwarz_shell_mask_;
     std::vector<size_t> schwarz_fun_count_;
+    // largest (mn|mn) of each primary shell pair and (P|P) of each auxiliary
+    // shell: (P|MN) is skipped when their product is below cutoff_^2
+    std::vector<double> schwarz_shell_max_;
+    std::vector<double> Qshell_max_;
+    bool aux_negligible(size_t Pshell, size_t MU, size_t NU) const {
+        return Qshell_max_[Pshell]*schwarz_shell_max_[MU*pshells_+NU] < cutoff_*cutoff_;
+    }
+    // compressed pair list: the significant nu of row mu are
+    // schwarz_fun_index_[pair_offsets_[mu] .. pair_offsets_[mu+1]), in the
+    // same order as the columns of the stored (mu|Q nu) blocks
+    std::vector<size_t> schwarz_fun_index_;
+    std::vector<size_t> pair_offsets_;
     void prepare_sparsity();
     void print_masks();
 
@@ -258,6 +287,12 @@ protected:
       std::pair<size_t, size_t> a2, std::pair<size_t, size_t> a3, std::string op);
     void put_tensor(std::string file, double* b, const size_t start1,
       const size_t stop1, const size_t start2, const size_t stop2, std::string op);
+    // put_tensor on a stream that is already open; no timers or file_status_
+    // updates, so these are safe to run on an I/O thread
+    void write_tensor(FILE* fp, std::string file, double* b, std::pair<size_t, size_t> a1,
+      std::pair<size_t, size_t> a2, std::pair<size_t, size_t> a3);
+    void write_tensor(FILE* fp, std::string file, double* b, const size_t start1,
+      const size_t stop1, const size_t start2, const size_t stop2);
     void get_tensor_(std::string file, double* b, std::pair<size_t, size_t> a1,
       std::pair<size_t, size_t> a2, std::pair<size_t, size_t> a3);
     void get_tensor_(std::string file, double* b,  const size_t start1,
@@ -287,6 +322,8 @@ protected:
     void transpose_disk(std::string name, std::tuple<size_t, size_t, size_t> order);
 
     // => JK <=
+    // sieve for density-weighted screening of the J contraction
+    std::shared_ptr<ERISieve> sieve_;
     void JK_core(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, 
         std::vector<SharedMatrix> J, std::vector<SharedMatrix> K); 
     void JK_disk(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, 
@@ -0,0 +1,232 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "df_shm.h"
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace psi {
+
+namespace {
+const uint64_t shm_magic = 0x7073693464667368ULL;
+
+/// Leads every segment, followed by the key padded to 64 bytes, then the data
+struct SegmentHeader {
+    uint64_t magic;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t key_size;
+    int64_t creator;
+    std::atomic<uint64_t> ready;
+    char pad[16];
+};
+
+/// Offset of the data in a segment for a key of key_size bytes
+size_t data_offset(size_t key_size)
+{
+    return sizeof(SegmentHeader) + 64 * ((key_size + 63) / 64);
+}
+
+std::vector<std::string> created_segments_;
+
+void unlink_at_exit()
+{
+    SharedMemoryMatrix::unlink_created();
+}
+
+/// Remove seg if its creator died before marking it ready; true if it is gone
+bool reclaim_stale(const std::string& seg)
+{
+    int fd = shm_open(seg.c_str(), O_RDONLY, 0);
+    if (fd < 0) return (errno == ENOENT);
+    struct stat st;
+    if (fstat(fd, &st) || (size_t) st.st_size < sizeof(SegmentHeader)) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, sizeof(SegmentHeader), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    SegmentHeader* header = static_cast<SegmentHeader*>(map);
+    bool stale = (header->magic == shm_magic && !header->ready.load(std::memory_order_acquire) &&
+                  ::kill((pid_t) header->creator, 0) == -1 && errno == ESRCH);
+    munmap(map, sizeof(SegmentHeader));
+    if (!stale) return false;
+
+    outfile->Printf("    Removing shared memory segment %s left behind by a dead process.\n\n", seg.c_str());
+    return (shm_unlink(seg.c_str()) == 0 || errno == ENOENT);
+}
+}
+
+SharedMemoryMatrix::SharedMemoryMatrix(const std::string& name, int rows, int cols, void* map, size_t map_size)
+    : Matrix(name), map_(map), map_size_(map_size)
+{
+    nirrep_ = 1;
+    rowspi_ = Dimension(1);
+    colspi_ = Dimension(1);
+    rowspi_[0] = rows;
+    colspi_[0] = cols;
+
+    // Row pointers into the segment, in the layout Matrix::matrix() makes
+    SegmentHeader* header = static_cast<SegmentHeader*>(map_);
+    double* data = reinterpret_cast<double*>(static_cast<char*>(map_) + data_offset(header->key_size));
+    matrix_ = (double***) malloc(sizeof(double**));
+    matrix_[0] = NULL;
+    if (rows && cols) {
+        matrix_[0] = (double**) malloc(sizeof(double*) * rows);
+        for (int r = 0; r < rows; r++) matrix_[0][r] = data + r * (size_t) cols;
+    }
+}
+
+SharedMemoryMatrix::~SharedMemoryMatrix()
+{
+    // The elements belong to the mapping, keep Matrix::release() off them
+    if (matrix_) {
+        ::free(matrix_[0]);
+        ::free(matrix_);
+        matrix_ = NULL;
+    }
+    munmap(map_, map_size_);
+}
+
+std::string SharedMemoryMatrix::segment_name(const std::string& key)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "/psi4.%u.%016zx", (unsigned) getuid(), std::hash<std::string>()(key));
+    return std::string(buf);
+}
+
+SharedMatrix SharedMemoryMatrix::create(const std::string& key, SharedMatrix source)
+{
+    if (source->nirrep() != 1) return SharedMatrix();
+    std::string seg = segment_name(key);
+    int rows = source->rowspi()[0];
+    int cols = source->colspi()[0];
+    size_t offset = data_offset(key.size());
+    size_t map_size = offset + sizeof(double) * rows * (size_t) cols;
+
+    // O_EXCL: whoever gets here first builds it, everyone else attaches
+    int fd = shm_open(seg.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST && reclaim_stale(seg))
+        fd = shm_open(seg.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return SharedMatrix();
+    if (ftruncate(fd, map_size)) {
+        close(fd);
+        shm_unlink(seg.c_str());
+        return SharedMatrix();
+    }
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(seg.c_str());
+        return SharedMatrix();
+    }
+    // Also unlinked at exit for jobs that never call psi4.core.clean()
+    static bool registered = false;
+    if (!registered) registered = (std::atexit(unlink_at_exit) == 0);
+    created_segments_.push_back(seg);
+
+    SegmentHeader* header = static_cast<SegmentHeader*>(map);
+    header->magic = shm_magic;
+    header->rows = rows;
+    header->cols = cols;
+    header->key_size = key.size();
+    header->creator = (int64_t) getpid();
+    ::memcpy(static_cast<void*>(static_cast<char*>(map) + sizeof(SegmentHeader)), key.data(), key.size());
+    if (rows && cols) {
+        ::memcpy(static_cast<void*>(static_cast<char*>(map) + offset),
+                 static_cast<void*>(source->pointer()[0]), sizeof(double) * rows * (size_t) cols);
+    }
+    header->ready.store(1, std::memory_order_release);
+
+    outfile->Printf("    Stored %s in shared memory segment %s.\n\n", source->name().c_str(), seg.c_str());
+    return SharedMatrix(new SharedMemoryMatrix(source->name(), rows, cols, map, map_size));
+}
+
+SharedMatrix SharedMemoryMatrix::attach(const std::string& key, const std::string& name)
+{
+    std::string seg = segment_name(key);
+
+    int fd = shm_open(seg.c_str(), O_RDONLY, 0);
+    if (fd < 0) return SharedMatrix();
+    struct stat st;
+    if (fstat(fd, &st) || (size_t) st.st_size < sizeof(SegmentHeader)) {
+        close(fd);
+        return SharedMatrix();
+    }
+    size_t map_size = st.st_size;
+    void* map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return SharedMatrix();
+
+    // A segment that is still being filled counts as a miss
+    SegmentHeader* header = static_cast<SegmentHeader*>(map);
+    if (!header->ready.load(std::memory_order_acquire) || header->magic != shm_magic) {
+        munmap(map, map_size);
+        return SharedMatrix();
+    }
+
+    // The name is only a hash of the key: check the key itself and the size
+    const char* stored_key = static_cast<const char*>(map) + sizeof(SegmentHeader);
+    if (header->key_size != key.size() || map_size < data_offset(key.size()) ||
+        ::memcmp(stored_key, key.data(), key.size()) != 0 ||
+        map_size != data_offset(key.size()) + sizeof(double) * header->rows * header->cols) {
+        munmap(map, map_size);
+        outfile->Printf("    Shared memory segment %s holds another tensor, building %s privately.\n\n", seg.c_str(),
+                        name.c_str());
+        return SharedMatrix();
+    }
+
+    outfile->Printf("    Attached %s from shared memory segment %s.\n\n", name.c_str(), seg.c_str());
+    return SharedMatrix(new SharedMemoryMatrix(name, (int) header->rows, (int) header->cols, map, map_size));
+}
+
+void SharedMemoryMatrix::unlink_created()
+{
+    for (size_t k = 0; k < created_segments_.size(); k++) shm_unlink(created_segments_[k].c_str());
+    created_segments_.clear();
+}
+
+}  // namespace psi
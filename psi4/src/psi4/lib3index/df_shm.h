@@ -0,0 +1,80 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef three_index_df_shm_H
+#define three_index_df_shm_H
+
+#include "psi4/libmints/matrix.h"
+
+#include <string>
+
+namespace psi {
+
+/**
+ * A C1 Matrix whose elements live in a named POSIX shared-memory segment
+ * (DF_INTS_SHM), so that processes on one node can share one copy of a
+ * large three-index tensor.
+ *
+ * The first process to store a key creates the segment, fills it and marks
+ * it ready; other processes map it read-only, so an attached matrix must
+ * never be written to. The segment name is a hash of the key, so the full
+ * key is stored in the segment and checked on attach; on a mismatch the
+ * tensor is built privately. A process unlinks the segments it created in
+ * unlink_created(), called from psi4.core.clean() and at exit; processes
+ * already attached keep their mapping until they drop the matrix. A segment
+ * left unfinished by a dead process is removed by the next create() of its
+ * key. Segments of a process killed after filling them stay in /dev/shm as
+ * psi4.<uid>.* until removed by hand.
+ */
+class SharedMemoryMatrix : public Matrix {
+protected:
+    /// Start of the mapping (header, key, then rows x cols doubles)
+    void* map_;
+    /// Length of the mapping in bytes
+    size_t map_size_;
+
+    SharedMemoryMatrix(const std::string& name, int rows, int cols, void* map, size_t map_size);
+
+    /// Segment name for key, unique per user
+    static std::string segment_name(const std::string& key);
+
+public:
+    virtual ~SharedMemoryMatrix();
+
+    /// Copy source into a new segment for key; nullptr if that segment already exists or cannot be made
+    static SharedMatrix create(const std::string& key, SharedMatrix source);
+    /// Map the finished segment for key read-only; nullptr if there is none yet
+    static SharedMatrix attach(const std::string& key, const std::string& name);
+
+    /// Remove the names of every segment this process created
+    static void unlink_created();
+};
+
+}  // namespace psi
+
+#endif
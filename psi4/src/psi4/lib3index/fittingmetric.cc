@@ -45,6 +45,7 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libmints/distlinalg.h"
 
 //MKL Header
 #ifdef USING_LAPACK_MKL
@@ -464,10 +465,15 @@ void FittingMetric::form_eig_inverse(double tol)
         C_DCOPY(n*(size_t)n,J[0],1,Wp[0],1);
 
         double* eigval = new double[n];
-        int lwork = n * 3;
-        double* work = new double[lwork];
-        int stat = C_DSYEV('v','u',n,Wp[0],n,eigval,work,lwork);
-        delete[] work;
+        bool distributed = distlinalg::use_distributed(n);
+        if (distributed) {
+            distlinalg::syev(n,Wp[0],eigval);
+        } else {
+            int lwork = n * 3;
+            double* work = new double[lwork];
+            int stat = C_DSYEV('v','u',n,Wp[0],n,eigval,work,lwork);
+            delete[] work;
+        }
 
         SharedMatrix Jcopy(new Matrix("Jcopy", n, n));
         double** Jcopyp = Jcopy->pointer();
@@ -492,7 +498,10 @@ void FittingMetric::form_eig_inverse(double tol)
         }
         delete[] eigval;
 
-        C_DGEMM('T','N',n,n,n,1.0,Jcopyp[0],n,Wp[0],n,0.0,J[0],n);
+        if (distributed)
+            distlinalg::gemm('T','N',n,1.0,Jcopyp[0],Wp[0],0.0,J[0]);
+        else
+            C_DGEMM('T','N',n,n,n,1.0,Jcopyp[0],n,Wp[0],n,0.0,J[0],n);
 
     }
     metric_->set_name("SO Basis Fitting Inverse (Eig)");
@@ -519,10 +528,15 @@ void FittingMetric::form_full_eig_inverse(double tol)
         C_DCOPY(n*(size_t)n,J[0],1,Wp[0],1);
 
         double* eigval = new double[n];
-        int lwork = n * 3;
-        double* work = new double[lwork];
-        int stat = C_DSYEV('v','u',n,Wp[0],n,eigval,work,lwork);
-        delete[] work;
+        bool distributed = distlinalg::use_distributed(n);
+        if (distributed) {
+            distlinalg::syev(n,Wp[0],eigval);
+        } else {
+            int lwork = n * 3;
+            double* work = new double[lwork];
+            int stat = C_DSYEV('v','u',n,Wp[0],n,eigval,work,lwork);
+            delete[] work;
+        }
 
         SharedMatrix Jcopy(new Matrix("Jcopy", n, n));
         double** Jcopyp = Jcopy->pointer();
@@ -547,7 +561,10 @@ void FittingMetric::form_full_eig_inverse(double tol)
         }
         delete[] eigval;
 
-        C_DGEMM('T','N',n,n,n,1.0,Jcopyp[0],n,Wp[0],n,0.0,J[0],n);
+        if (distributed)
+            distlinalg::gemm('T','N',n,1.0,Jcopyp[0],Wp[0],0.0,J[0]);
+        else
+            C_DGEMM('T','N',n,n,n,1.0,Jcopyp[0],n,Wp[0],n,0.0,J[0],n);
 
     }
     metric_->set_name("SO Basis Fitting Inverse (Eig)");
@@ -0,0 +1,82 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+\file
+\brief Cache-line aligned storage for the dense linear-algebra containers
+\ingroup CIOMR
+*/
+
+#ifndef _psi_src_lib_libciomr_aligned_allocator_h_
+#define _psi_src_lib_libciomr_aligned_allocator_h_
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+namespace psi {
+
+/// Alignment, in bytes, of block_matrix, Matrix and Vector storage
+#define PSI_MEMORY_ALIGNMENT 64
+
+/*!
+** AlignedAllocator: std::allocator replacement whose storage starts on a
+** PSI_MEMORY_ALIGNMENT boundary, so that the data of containers such as
+** Vector can be handed to SIMD kernels that assume aligned loads.
+**
+** \ingroup CIOMR
+*/
+template <typename T>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        if (!n) return nullptr;
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, PSI_MEMORY_ALIGNMENT, n * sizeof(T))) throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+    void deallocate(T* ptr, std::size_t) { std::free(ptr); }
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U> other; };
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+}
+
+#endif /* header guard */
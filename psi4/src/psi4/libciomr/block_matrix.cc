@@ -36,18 +36,86 @@
 #include <cstdlib>
 #include <cstring>
 #include <strings.h>
+#include <mutex>
+#include <unordered_map>
 #include "psi4/psifiles.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_tracker.h"
 #include <unistd.h>
 #ifdef _POSIX_MEMLOCK
 #include <sys/mman.h>
 #endif
 
 #include "psi4/psi4-dec.h"
+#include "psi4/libciomr/aligned_allocator.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
+namespace {
+/* free_block() is not told the size, so block_matrix() notes what it counted
+   for MemoryTracker. Blocks made elsewhere are not in here and count nothing. */
+std::mutex tracked_lock;
+std::unordered_map<double **, size_t> tracked_blocks;
+}
+
+/*!
+** init_aligned_array(): Allocate a zeroed array of doubles that starts on a
+** PSI_MEMORY_ALIGNMENT boundary
+**
+** Large arrays are zeroed by all threads with a static schedule, so that
+** the first touch spreads their pages over the memory of every socket the
+** threads run on, as threaded BLAS and OpenMP loops over the array will.
+**
+** \param size = number of doubles
+**
+** Returns: pointer to the array, to be freed with free_aligned_array()
+**
+** \ingroup CIOMR
+*/
+double * init_aligned_array(size_t size)
+{
+    if(!size) return(static_cast<double *>(0));
+
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, PSI_MEMORY_ALIGNMENT, size*sizeof(double))) {
+        outfile->Printf("init_aligned_array: trouble allocating memory \n");
+        outfile->Printf("size = %ld\n",size);
+        exit(PSI_RETURN_FAILURE);
+    }
+    double *B = static_cast<double *>(ptr);
+
+    // Below a few pages, one thread touching everything is cheaper
+    const size_t parallel_size = 1L << 18;
+    int nthread = 1;
+#ifdef _OPENMP
+    if (size >= parallel_size && !omp_in_parallel())
+        nthread = Process::environment.get_n_threads();
+#endif
+    if (nthread > 1) {
+        long int lsize = size;
+#pragma omp parallel for schedule(static) num_threads(nthread)
+        for (long int i = 0; i < lsize; i++) B[i] = 0.0;
+    } else {
+        memset(static_cast<void*>(B), 0, size*sizeof(double));
+    }
+
+    return(B);
+}
+
+/*!
+** free_aligned_array(): Free an array from init_aligned_array()
+**
+** \ingroup CIOMR
+*/
+void free_aligned_array(double *array)
+{
+    free(array);
+}
+
 /*!
 ** block_matrix(): Allocate a 2D array of doubles using contiguous memory
 **
@@ -58,7 +126,8 @@ namespace psi {
 ** could be used in conjunction with FORTRAN matrix routines.
 **
 ** Allocates memory for an n x m matrix and returns a pointer to the
-** first row.
+** first row.  The data starts on a PSI_MEMORY_ALIGNMENT boundary and
+** is zeroed as described for init_aligned_array().
 **
 ** \param n = number of rows (size_t to allow large matrices)
 ** \param m = number of columns (size_t to allow large matrices)
@@ -83,6 +152,9 @@ double ** block_matrix(size_t n, size_t m, bool memlock)
 
     if(!m || !n) return(static_cast<double **>(0));
 
+    size_t bytes = n * m * sizeof(double);
+    MemoryTracker::allocate(bytes, "block_matrix");
+
     A = new double*[n];
     if (A==NULL) {
         outfile->Printf("block_matrix: trouble allocating memory \n");
@@ -90,13 +162,7 @@ double ** block_matrix(size_t n, size_t m, bool memlock)
         exit(PSI_RETURN_FAILURE);
     }
 
-    B = new double[n*m];
-    if (B == NULL) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("m = %ld\n",m);
-        exit(PSI_RETURN_FAILURE);
-    }
-    memset(static_cast<void*>(B), 0, m*n*sizeof(double));
+    B = init_aligned_array(n*m);
 
     for (i = 0; i < n; i++) {
         A[i] = &(B[i*m]);
@@ -137,6 +203,11 @@ double ** block_matrix(size_t n, size_t m, bool memlock)
     }
 #endif
 
+    {
+        std::lock_guard<std::mutex> guard(tracked_lock);
+        tracked_blocks[A] = bytes;
+    }
+
     return(A);
 }
 
@@ -153,7 +224,15 @@ double ** block_matrix(size_t n, size_t m, bool memlock)
 void free_block(double **array)
 {
     if(array == NULL) return;
-    delete [] array[0];
+    {
+        std::lock_guard<std::mutex> guard(tracked_lock);
+        auto it = tracked_blocks.find(array);
+        if (it != tracked_blocks.end()) {
+            MemoryTracker::release(it->second);
+            tracked_blocks.erase(it);
+        }
+    }
+    free_aligned_array(array[0]);
     delete [] array;
 }
 
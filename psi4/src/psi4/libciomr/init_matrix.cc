@@ -36,6 +36,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libciomr/libciomr.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -68,35 +69,8 @@ namespace psi {
 */
 double ** init_matrix(size_t n, size_t m)
 {
-    double **A=NULL;
-    double *B=NULL;
-    size_t i;
-
-    if(!m || !n) return(static_cast<double **>(0));
-
-//  if ((A = (double **) malloc(n * (size_t)sizeof(double *)))==NULL) {
-    if ((A = new double*[n])==NULL) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("n = %ld\n",n);
-        exit(PSI_RETURN_FAILURE);
-    }
-
-//  if ((B = (double *) malloc(m*n * (size_t)sizeof(double)))==NULL) {
-    if ((B = new double[n*m])==NULL) {
-        outfile->Printf("block_matrix: trouble allocating memory \n");
-        outfile->Printf("m = %ld\n",m);
-        exit(PSI_RETURN_FAILURE);
-    }
-
-    // bzero is not in the C standard, use memset instead.
-    //bzero(B, m*n*(size_t)sizeof(double));
-    memset(static_cast<void*>(B), 0, m*n*sizeof(double));
-
-    for (i = 0; i < n; i++) {
-        A[i] = &(B[i*m]);
-    }
-
-    return(A);
+    // Same storage as block_matrix(), so the two free routines stay interchangeable
+    return block_matrix(n, m);
 // <<<<<<<<<<<<<<<<<<<<<
 // BEGIN DEPRECATED CODE
 // <<<<<<<<<<<<<<<<<<<<<
@@ -147,9 +121,7 @@ double ** init_matrix(size_t n, size_t m)
 */
 void free_matrix(double **array, size_t /*size*/)
 {
-    if(array == NULL) return;
-    delete [] array[0];
-    delete [] array;
+    free_block(array);
 // <<<<<<<<<<<<<<<<<<<<<
 // BEGIN DEPRECATED CODE
 // <<<<<<<<<<<<<<<<<<<<<
@@ -110,6 +110,8 @@ void print_long_int_mat(long int **a, int m, int n, std::string out);
 /* Functions in block_matrix.c */
 double ** block_matrix(size_t n, size_t m, bool mlock = false);
 void free_block(double **array);
+double * init_aligned_array(size_t size);
+void free_aligned_array(double *array);
 
 /* Functions in fndcor */
 void fndcor(long int *maxcrb, std::string out_fname);
@@ -42,12 +42,17 @@
 #include "psi4/libfilesystem/path.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/process.h"
 
 #include "csg.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
 #ifdef _OPENMP
 #include <omp.h>
-#include "psi4/libpsi4util/process.h"
 #endif
 
 namespace psi {
@@ -69,6 +74,11 @@ CubicScalarGrid::CubicScalarGrid(
     D_ = new double[3];
     O_ = new double[3];
 
+    nthreads_ = 1;
+#ifdef _OPENMP
+    nthreads_ = Process::environment.get_n_threads();
+#endif
+
     build_grid(); // Defaults from Options
 }
 CubicScalarGrid::~CubicScalarGrid()
@@ -175,6 +185,7 @@ void CubicScalarGrid::populate_grid()
     nxyz_ = (size_t) pow((double) max_points, 1.0/3.0);
 
     blocks_.clear();
+    block_offsets_.clear();
     size_t offset = 0L;
     for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
         int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
@@ -183,6 +194,7 @@ void CubicScalarGrid::populate_grid()
             for (int kstart = 0L; kstart <= N_[2]; kstart+=nxyz_) {
                 int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
 
+                block_offsets_.push_back(offset);
                 double* xp = &x_[offset];
                 double* yp = &y_[offset];
                 double* zp = &z_[offset];
@@ -212,8 +224,11 @@ void CubicScalarGrid::populate_grid()
             max_functions : blocks_[ind]->functions_local_to_global().size());
     }
 
-    points_ = std::shared_ptr<RKSFunctions>(new RKSFunctions(primary_,max_points,max_functions));
-    points_->set_ansatz(0);
+    point_workers_.clear();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_.push_back(std::shared_ptr<RKSFunctions>(new RKSFunctions(primary_,max_points,max_functions)));
+        point_workers_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::print_header()
 {
@@ -240,19 +255,23 @@ void CubicScalarGrid::print_header()
 }
 void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const std::string& type)
 {
-    if (type == "CUBE") {
-        write_cube_file(v, name);
-    } else {
-        throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
-    }
-}
-void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
-{
+    FILE* fh = open_field_file(name, type);
+
     // => Reorder the grid <= //
 
     double* v2 = new double[npoints_];
+    cube_order(v, v2, 0, N_[0] + 1);
+
+    // => Drop the grid out <= //
+
+    write_field_values(fh, type, v2, npoints_, 0L);
+    fclose(fh);
+    delete[] v2;
+}
+void CubicScalarGrid::cube_order(const double* v, double* v2, int ibegin, int iend) const
+{
     size_t offset = 0L;
-    for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
+    for (int istart = ibegin; istart < iend; istart+=nxyz_) {
         int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
         for (int jstart = 0L; jstart <= N_[1]; jstart+=nxyz_) {
             int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
@@ -261,7 +280,7 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
                 for (int i = istart; i < istart + ni; i++) {
                     for (int j = jstart; j < jstart + nj; j++) {
                         for (int k = kstart; k < kstart + nk; k++) {
-                            size_t index = i * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
+                            size_t index = (i - ibegin) * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
                             v2[index] = v[offset];
                             offset++;
                         }
@@ -270,57 +289,161 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
             }
         }
     }
-
-    // => Drop the grid out <= //
-
-    std::stringstream ss;
-    ss << filepath_ << "/" << name << ".cube";
-
+}
+void CubicScalarGrid::check_filepath() const
+{
     // Is filepath a valid directory?
     if (filesystem::path(filepath_).make_absolute().is_directory() == false) {
         printf("Filepath \"%s\" is not valid.  Please create this directory.\n",filepath_.c_str());
         outfile->Printf("Filepath \"%s\" is not valid.  Please create this directory.\n",filepath_.c_str());
         exit(Failure);
     }
+}
+FILE* CubicScalarGrid::open_field_file(const std::string& name, const std::string& type)
+{
+    if (type != "CUBE" && type != "NPY") {
+        throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
+    }
 
-    FILE* fh = fopen(ss.str().c_str(), "w");
-    // Two comment lines
-    fprintf(fh, "Psi4 Gaussian Cube File.\n");
-    fprintf(fh, "Property: %s\n", name.c_str());
+    std::stringstream ss;
+    ss << filepath_ << "/" << name << (type == "CUBE" ? ".cube" : ".npy");
 
-    // Number of atoms plus origin of data
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", mol_->natom(), O_[0], O_[1], O_[2]);
+    check_filepath();
 
-    // Number of points along axis, displacement along x,y,z
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[0] + 1, D_[0], 0.0, 0.0);
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[1] + 1, 0.0, D_[1], 0.0);
-    fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[2] + 1, 0.0, 0.0, D_[2]);
+    FILE* fh = fopen(ss.str().c_str(), (type == "CUBE" ? "w" : "wb"));
+    if (!fh) throw PSIEXCEPTION("CubicScalarGrid: Unable to open " + ss.str());
 
-    // Atoms of molecule (Z, Q?, x, y, z)
-    for (int A = 0; A < mol_->natom(); A++) {
-        fprintf(fh, "%3d %10.6f %10.6f %10.6f %10.6f\n", (int) mol_->Z(A), 0.0, mol_->x(A), mol_->y(A), mol_->z(A));
+    if (type == "CUBE") {
+        // Two comment lines
+        fprintf(fh, "Psi4 Gaussian Cube File.\n");
+        fprintf(fh, "Property: %s\n", name.c_str());
+
+        // Number of atoms plus origin of data
+        fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", mol_->natom(), O_[0], O_[1], O_[2]);
+
+        // Number of points along axis, displacement along x,y,z
+        fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[0] + 1, D_[0], 0.0, 0.0);
+        fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[1] + 1, 0.0, D_[1], 0.0);
+        fprintf(fh, "%6d %10.6f %10.6f %10.6f\n", N_[2] + 1, 0.0, 0.0, D_[2]);
+
+        // Atoms of molecule (Z, Q?, x, y, z)
+        for (int A = 0; A < mol_->natom(); A++) {
+            fprintf(fh, "%3d %10.6f %10.6f %10.6f %10.6f\n", (int) mol_->Z(A), 0.0, mol_->x(A), mol_->y(A), mol_->z(A));
+        }
+    } else {
+        // NPY 1.0: magic, version, header length, then a dict padded with spaces to a
+        // multiple of 64 bytes (counting the 10 preamble bytes), ending in a newline
+        uint16_t one = 1;
+        bool little = (*reinterpret_cast<char*>(&one) == 1);
+        std::stringstream header;
+        header << "{'descr': '" << (little ? "<" : ">") << "f8', 'fortran_order': False, 'shape': ("
+               << N_[0] + 1 << ", " << N_[1] + 1 << ", " << N_[2] + 1 << "), }";
+        std::string dict = header.str();
+        size_t total = 10 + dict.size() + 1;
+        dict.append((64 - total % 64) % 64, ' ');
+        dict += "\n";
+        uint16_t len = (uint16_t) dict.size();
+        unsigned char preamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                      (unsigned char) (len & 0xff), (unsigned char) (len >> 8)};
+        fwrite(preamble, 1, 10, fh);
+        fwrite(dict.c_str(), 1, dict.size(), fh);
+    }
+    return fh;
+}
+void CubicScalarGrid::write_field_values(FILE* fh, const std::string& type, const double* v2, size_t n, size_t start)
+{
+    if (type == "NPY") {
+        fwrite(v2, sizeof(double), n, fh);
+        return;
     }
 
     // Data, striped (x, y, z)
-    for (size_t ind = 0; ind < npoints_; ind++) {
+    for (size_t ind = 0; ind < n; ind++) {
         fprintf(fh, "%12.5E ", v2[ind]);
-        if (ind % 6 == 5) fprintf(fh,"\n");
+        if ((start + ind) % 6 == 5) fprintf(fh,"\n");
+    }
+}
+void CubicScalarGrid::write_cube_file(double* v, const std::string& name)
+{
+    write_gen_file(v, name, "CUBE");
+}
+void CubicScalarGrid::write_npy_file(double* v, const std::string& name)
+{
+    write_gen_file(v, name, "NPY");
+}
+void CubicScalarGrid::write_streamed(const std::vector<std::string>& names, const std::string& type,
+                                     const std::function<void(double**, int, int, int, int)>& add)
+{
+    int nfield = names.size();
+    size_t nyz = (N_[1] + 1L) * (N_[2] + 1L);
+    // Blocks in one slab of nxyz_ x-planes, which populate_grid() lays out one after another
+    int nslab_blocks = (N_[1] / nxyz_ + 1) * (N_[2] / nxyz_ + 1);
+    size_t slab_points = nxyz_ * nyz;
+
+    // As many fields at a time as fit in half the memory
+    size_t nbatch = Process::environment.get_memory() / 2L / (slab_points * sizeof(double));
+    nbatch = std::max((size_t) 1L, std::min(nbatch, (size_t) nfield));
+
+    double** v = block_matrix(nbatch, slab_points);
+    double* v2 = new double[slab_points];
+
+    for (int f0 = 0; f0 < nfield; f0 += nbatch) {
+        int f1 = std::min((size_t) nfield, f0 + nbatch);
+
+        std::vector<FILE*> fh;
+        for (int f = f0; f < f1; f++) {
+            fh.push_back(open_field_file(names[f], type));
+        }
+
+        size_t written = 0L;
+        int block = 0;
+        for (int istart = 0L; istart <= N_[0]; istart+=nxyz_) {
+            int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
+            size_t npoints = ni * nyz;
+
+            memset(v[0],'\0',nbatch*slab_points*sizeof(double));
+            add(v, f0, f1, block, block + nslab_blocks);
+
+            for (int f = f0; f < f1; f++) {
+                cube_order(v[f - f0], v2, istart, istart + ni);
+                write_field_values(fh[f - f0], type, v2, npoints, written);
+            }
+
+            written += npoints;
+            block += nslab_blocks;
+        }
+
+        for (int f = f0; f < f1; f++) {
+            fclose(fh[f - f0]);
+        }
     }
 
-    fclose(fh);
+    free_block(v);
+    delete[] v2;
 }
 void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D)
 {
-    points_->set_pointers(D);
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    double* rhop = rho->pointer();
+    add_density(v, D, 0, blocks_.size());
+}
+void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D, int start, int stop)
+{
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_pointers(D);
+    }
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+    // Blocks write disjoint stretches of v
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (int ind = start; ind < stop; ind++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        std::shared_ptr<RKSFunctions> points = point_workers_[thread];
+        double* rhop = points->point_value("RHO_A")->pointer();
+
+        points->compute_points(blocks_[ind]);
         size_t npoints = blocks_[ind]->npoints();
-        C_DAXPY(npoints,0.5,rhop,1,&v[offset],1);
-        offset += npoints;
+        C_DAXPY(npoints,0.5,rhop,1,&v[block_offsets_[ind] - block_offsets_[start]],1);
     }
 }
 void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights)
@@ -461,71 +584,233 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
 
     // => Electronic Part <= //
 
-    std::shared_ptr<IntegralFactory> Vfact(new IntegralFactory(auxiliary_,BasisSet::zero_ao_basis_set(),auxiliary_,BasisSet::zero_ao_basis_set()));
+    double multipole_tol = options_.get_double("CUBIC_ESP_MULTIPOLE_TOLERANCE");
+    if (multipole_tol > 0.0) {
+        add_esp_multipole(v, dp, multipole_tol);
+    } else {
+        std::shared_ptr<IntegralFactory> Vfact(new IntegralFactory(auxiliary_,BasisSet::zero_ao_basis_set(),auxiliary_,BasisSet::zero_ao_basis_set()));
+        std::vector<std::shared_ptr<Matrix> > ZxyzT;
+        std::vector<std::shared_ptr<Matrix> > VtempT;
+        std::vector<std::shared_ptr<PotentialInt> > VintT;
+        for (int thread = 0; thread < nthreads; thread++) {
+            ZxyzT.push_back(std::shared_ptr<Matrix>(new Matrix("Zxyz",1,4)));
+            VtempT.push_back(std::shared_ptr<Matrix>(new Matrix("Vtemp",naux,1)));
+            VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
+            VintT[thread]->set_charge_field(ZxyzT[thread]);
+        }
+
+        #pragma omp parallel for schedule(dynamic)
+        for (int P = 0; P < npoints_; P++) {
+
+            // Thread info
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+
+            // Pointers
+            double** ZxyzTp = ZxyzT[thread]->pointer();
+            double** VtempTp = VtempT[thread]->pointer();
+
+            // Integrals
+            VtempT[thread]->zero();
+            ZxyzTp[0][0] = 1.0;
+            ZxyzTp[0][1] = x_[P];
+            ZxyzTp[0][2] = y_[P];
+            ZxyzTp[0][3] = z_[P];
+            VintT[thread]->compute(VtempT[thread]);
+
+            // Contraction
+            v[P] += C_DDOT(naux,dp,1,VtempTp[0],1); // Potential integrals are negative definite already
+        }
+    }
+
+    // => Nuclear Part <= //
+
+    int natom = mol_->natom();
+    std::vector<double> Zxyz(4 * natom);
+    for (int A = 0; A < natom; A++) {
+        Zxyz[4 * A + 0] = mol_->Z(A) * (nuc_weights.size() ? nuc_weights[A] : 1.0);
+        Zxyz[4 * A + 1] = mol_->x(A);
+        Zxyz[4 * A + 2] = mol_->y(A);
+        Zxyz[4 * A + 3] = mol_->z(A);
+    }
+
+    #pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (long int P = 0; P < npoints_; P++) {
+        double val = 0.0;
+        for (int A = 0; A < natom; A++) {
+            double R = sqrt(
+                (Zxyz[4 * A + 1] - x_[P]) * (Zxyz[4 * A + 1] - x_[P]) +
+                (Zxyz[4 * A + 2] - y_[P]) * (Zxyz[4 * A + 2] - y_[P]) +
+                (Zxyz[4 * A + 3] - z_[P]) * (Zxyz[4 * A + 3] - z_[P]));
+            val += (R >= 1.0E-15 ? Zxyz[4 * A] / R : 0.0);
+        }
+        v[P] += val;
+    }
+}
+void CubicScalarGrid::add_esp_multipole(double* v, const double* d, double tolerance)
+{
+    int natom = mol_->natom();
+    int naux = auxiliary_->nbf();
+
+    // => Moments of the Fitted Density <= //
+
+    // Charge, dipole and second moments of every auxiliary function about the origin
+    std::shared_ptr<IntegralFactory> fact(new IntegralFactory(auxiliary_,BasisSet::zero_ao_basis_set(),auxiliary_,BasisSet::zero_ao_basis_set()));
+    std::shared_ptr<Matrix> S(new Matrix("S", naux, 1));
+    std::shared_ptr<OneBodyAOInt> Sint(fact->ao_overlap());
+    Sint->compute(S);
+    std::vector<std::shared_ptr<Matrix> > M;
+    for (int k = 0; k < 9; k++) {
+        M.push_back(std::shared_ptr<Matrix>(new Matrix("M", naux, 1)));
+    }
+    std::shared_ptr<OneBodyAOInt> Mint(fact->ao_multipoles(2));
+    Mint->compute(M);
+
+    // Summed per atom: q, mu (x, y, z), Q (xx, xy, xz, yy, yz, zz)
+    std::vector<double> mom(10 * natom, 0.0);
+    std::vector<std::vector<int> > atom_shells(natom);
+    std::vector<double> alpha_min(natom, 0.0);
+    for (int Q = 0; Q < auxiliary_->nshell(); Q++) {
+        const GaussianShell& shell = auxiliary_->shell(Q);
+        int A = shell.ncenter();
+        atom_shells[A].push_back(Q);
+        for (int k = 0; k < shell.nprimitive(); k++) {
+            if (alpha_min[A] == 0.0 || shell.exp(k) < alpha_min[A]) alpha_min[A] = shell.exp(k);
+        }
+        for (int p = shell.function_index(); p < shell.function_index() + shell.nfunction(); p++) {
+            mom[10 * A] += d[p] * S->get(p, 0);
+            // MultipoleInt carries the electron charge
+            for (int k = 0; k < 9; k++) {
+                mom[10 * A + 1 + k] -= d[p] * M[k]->get(p, 0);
+            }
+        }
+    }
+
+    std::vector<double> xyz(3 * natom);
+    for (int A = 0; A < natom; A++) {
+        xyz[3 * A + 0] = mol_->x(A);
+        xyz[3 * A + 1] = mol_->y(A);
+        xyz[3 * A + 2] = mol_->z(A);
+    }
+
+    // Shifted to the atom
+    std::vector<double> Rcut2(natom, 0.0);
+    double x0 = 0.0, x1 = 10.0;
+    while (x1 - x0 > 1.0E-6) {
+        double x = 0.5 * (x0 + x1);
+        if (std::erfc(x) > tolerance) {
+            x0 = x;
+        } else {
+            x1 = x;
+        }
+    }
+    for (int A = 0; A < natom; A++) {
+        if (atom_shells[A].empty()) continue;
+        double* m = &mom[10 * A];
+        const double* X = &xyz[3 * A];
+        double mu[3] = {m[1], m[2], m[3]};
+        int ij = 4;
+        for (int i = 0; i < 3; i++) {
+            for (int j = i; j < 3; j++, ij++) {
+                m[ij] += -X[i] * mu[j] - X[j] * mu[i] + m[0] * X[i] * X[j];
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            m[1 + i] -= m[0] * X[i];
+        }
+        // Outside this radius the most diffuse function on A has all but
+        // tolerance of its charge inside, so it looks like a multipole
+        double R = x1 / sqrt(alpha_min[A]);
+        Rcut2[A] = R * R;
+    }
+
+    // => Potential <= //
+
+    int nthreads = nthreads_;
     std::vector<std::shared_ptr<Matrix> > ZxyzT;
-    std::vector<std::shared_ptr<Matrix> > VtempT;
     std::vector<std::shared_ptr<PotentialInt> > VintT;
     for (int thread = 0; thread < nthreads; thread++) {
         ZxyzT.push_back(std::shared_ptr<Matrix>(new Matrix("Zxyz",1,4)));
-        VtempT.push_back(std::shared_ptr<Matrix>(new Matrix("Vtemp",naux,1)));
-        VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
+        VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(fact->ao_potential())));
         VintT[thread]->set_charge_field(ZxyzT[thread]);
     }
 
-    #pragma omp parallel for schedule(dynamic)
-    for (int P = 0; P < npoints_; P++) {
+    size_t nexact = 0L;
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads) reduction(+ : nexact)
+    for (long int P = 0; P < npoints_; P++) {
 
-        // Thread info
         int thread = 0;
         #ifdef _OPENMP
             thread = omp_get_thread_num();
         #endif
 
-        // Pointers
         double** ZxyzTp = ZxyzT[thread]->pointer();
-        double** VtempTp = VtempT[thread]->pointer();
-
-        // Integrals
-        VtempT[thread]->zero();
         ZxyzTp[0][0] = 1.0;
         ZxyzTp[0][1] = x_[P];
         ZxyzTp[0][2] = y_[P];
         ZxyzTp[0][3] = z_[P];
-        VintT[thread]->compute(VtempT[thread]);
-
-        // Contraction
-        v[P] += C_DDOT(naux,dp,1,VtempTp[0],1); // Potential integrals are negative definite already
-    }
-
-    // => Nuclear Part <= //
-
-    for (int A = 0; A < mol_->natom(); A++) {
-        double Z = mol_->Z(A) * (nuc_weights.size() ? nuc_weights[A] : 1.0);
-        double x = mol_->x(A);
-        double y = mol_->y(A);
-        double z = mol_->z(A);
-        for (int P = 0; P < npoints_; P++) {
-            double R = sqrt(
-                (x - x_[P]) * (x - x_[P]) +
-                (y - y_[P]) * (y - y_[P]) +
-                (z - z_[P]) * (z - z_[P]));
-            v[P] += (R >= 1.0E-15 ? Z / R : 0.0);
+        const double* buffer = VintT[thread]->buffer();
+
+        double val = 0.0;
+        for (int A = 0; A < natom; A++) {
+            if (atom_shells[A].empty()) continue;
+            double X = x_[P] - xyz[3 * A + 0];
+            double Y = y_[P] - xyz[3 * A + 1];
+            double Z = z_[P] - xyz[3 * A + 2];
+            double R2 = X * X + Y * Y + Z * Z;
+
+            if (R2 > Rcut2[A]) {
+                const double* m = &mom[10 * A];
+                double R = sqrt(R2);
+                double Rm3 = 1.0 / (R2 * R);
+                double Rm5 = Rm3 / R2;
+                double phi = m[0] / R + (m[1] * X + m[2] * Y + m[3] * Z) * Rm3;
+                phi += 0.5 * Rm5 * (m[4] * (3.0 * X * X - R2) + m[7] * (3.0 * Y * Y - R2) + m[9] * (3.0 * Z * Z - R2));
+                phi += 3.0 * Rm5 * (m[5] * X * Y + m[6] * X * Z + m[8] * Y * Z);
+                // Electrons, so the potential is negative
+                val -= phi;
+            } else {
+                nexact++;
+                for (int Q : atom_shells[A]) {
+                    const GaussianShell& shell = auxiliary_->shell(Q);
+                    VintT[thread]->compute_shell(Q, 0);
+                    int oQ = shell.function_index();
+                    for (int p = 0; p < shell.nfunction(); p++) {
+                        val += d[oQ + p] * buffer[p];
+                    }
+                }
+            }
         }
+        v[P] += val;
     }
+
+    outfile->Printf("    ESP: %zu of %zu atom-point pairs from multipoles (tolerance %.1E).\n\n",
+                    npoints_ * natom - nexact, npoints_ * natom, tolerance);
 }
 void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices)
 {
-    std::shared_ptr<Matrix> phi = points_->basis_value("PHI");
-    double** phip = phi->pointer();
+    add_basis_functions(v, indices, 0, blocks_.size());
+}
+void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices, int start, int stop)
+{
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (int ind = start; ind < stop; ind++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        std::shared_ptr<RKSFunctions> points = point_workers_[thread];
+        double** phip = points->basis_value("PHI")->pointer();
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_functions(blocks_[ind]);
+        points->compute_functions(blocks_[ind]);
 
+        size_t offset = block_offsets_[ind] - block_offsets_[start];
         size_t npoints = blocks_[ind]->npoints();
         const std::vector<int>& function_map = blocks_[ind]->functions_local_to_global();
         int nlocal  = function_map.size();
-        int nglobal = points_->max_functions();
+        int nglobal = points->max_functions();
 
         for (int ind1 = 0; ind1 < indices.size(); ind1++) {
             for (int ind2 = 0; ind2 < function_map.size(); ind2++) {
@@ -534,45 +819,58 @@ void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& in
                 }
             }
         }
-
-        offset += npoints;
     }
 }
 void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C)
+{
+    add_orbitals(v, C, 0, blocks_.size());
+}
+void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C, int start, int stop)
 {
     int na = C->colspi()[0];
 
-    points_->set_Cs(C);
-    std::shared_ptr<Matrix> psi = points_->orbital_value("PSI_A");
-    double** psip = psi->pointer();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_Cs(C);
+    }
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_orbitals(blocks_[ind]);
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (int ind = start; ind < stop; ind++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        std::shared_ptr<RKSFunctions> points = point_workers_[thread];
+        double** psip = points->orbital_value("PSI_A")->pointer();
+
+        points->compute_orbitals(blocks_[ind]);
 
         size_t npoints = blocks_[ind]->npoints();
         for (int a = 0; a < na; a++) {
-            C_DAXPY(npoints,1.0,psip[a],1,&v[a][offset],1);
+            C_DAXPY(npoints,1.0,psip[a],1,&v[a][block_offsets_[ind] - block_offsets_[start]],1);
         }
-
-        offset += npoints;
     }
 }
 void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D)
 {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    std::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* taup = tau->pointer();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_ansatz(2);
+        point_workers_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
     for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        std::shared_ptr<RKSFunctions> points = point_workers_[thread];
+        double* rhop = points->point_value("RHO_A")->pointer();
+        double* taup = points->point_value("TAU_A")->pointer();
+
+        points->compute_points(blocks_[ind]);
+        size_t offset = block_offsets_[ind];
         size_t npoints = blocks_[ind]->npoints();
         for (int P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(0.5 * rhop[P], 5.0 / 3.0);
@@ -581,28 +879,34 @@ void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D)
             double v2 = (std::fabs(tau_EX / tau_LSDA) < 1.0E-15 ? 1.0 : t / (1.0 + t));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
 
-    points_->set_ansatz(0);
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D)
 {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    std::shared_ptr<Vector> gam = points_->point_value("GAMMA_AA");
-    std::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* gamp = gam->pointer();
-    double* taup = tau->pointer();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_ansatz(2);
+        point_workers_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
     for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+        std::shared_ptr<RKSFunctions> points = point_workers_[thread];
+        double* rhop = points->point_value("RHO_A")->pointer();
+        double* gamp = points->point_value("GAMMA_AA")->pointer();
+        double* taup = points->point_value("TAU_A")->pointer();
+
+        points->compute_points(blocks_[ind]);
+        size_t offset = block_offsets_[ind];
         size_t npoints = blocks_[ind]->npoints();
         for (int P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(0.5 * rhop[P], 5.0 / 3.0);
@@ -613,18 +917,16 @@ void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D)
             double v2 = (std::fabs(D_LSDA / D_EX) < 1.0E-15 ? 0.0 : 1.0 / (1.0 + B * B));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
 
-    points_->set_ansatz(0);
+    for (int thread = 0; thread < nthreads_; thread++) {
+        point_workers_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::compute_density(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
-    double* v = new double[npoints_];
-    memset(v,'\0',npoints_*sizeof(double));
-    add_density(v,D);
-    write_gen_file(v,name,type);
-    delete[] v;
+    write_streamed(std::vector<std::string>(1, name), type,
+                   [&](double** v, int f0, int f1, int start, int stop) { add_density(v[0], D, start, stop); });
 }
 void CubicScalarGrid::compute_esp(std::shared_ptr<Matrix> D, const std::vector<double>& w, const std::string& name, const std::string& type)
 {
@@ -636,33 +938,41 @@ void CubicScalarGrid::compute_esp(std::shared_ptr<Matrix> D, const std::vector<d
 }
 void CubicScalarGrid::compute_basis_functions(const std::vector<int>& indices, const std::string& name, const std::string& type)
 {
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0],'\0',indices.size()*npoints_*sizeof(double));
-    add_basis_functions(v, indices);
+    std::vector<std::string> names;
     for (int k = 0; k < indices.size(); k++) {
         std::stringstream ss;
         ss << name << "_" << (indices[k] + 1);
-        write_gen_file(v[k],ss.str(),type);
+        names.push_back(ss.str());
     }
-    free_block(v);
+    write_streamed(names, type, [&](double** v, int f0, int f1, int start, int stop) {
+        std::vector<int> batch(indices.begin() + f0, indices.begin() + f1);
+        add_basis_functions(v, batch, start, stop);
+    });
 }
 void CubicScalarGrid::compute_orbitals(std::shared_ptr<Matrix> C, const std::vector<int>& indices, const std::vector<std::string>& labels, const std::string& name, const std::string& type)
 {
-    std::shared_ptr<Matrix> C2(new Matrix(primary_->nbf(), indices.size()));
-    double** Cp  = C->pointer();
-    double** C2p = C2->pointer();
-    for (int k = 0; k < indices.size(); k++) {
-        C_DCOPY(primary_->nbf(), &Cp[0][indices[k]], C->colspi()[0], &C2p[0][k], C2->colspi()[0]);
-    }
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0],'\0',indices.size()*npoints_*sizeof(double));
-    add_orbitals(v, C2);
+    std::vector<std::string> names;
     for (int k = 0; k < indices.size(); k++) {
         std::stringstream ss;
         ss << name << "_" << (indices[k] + 1) << "_" << labels[k];
-        write_gen_file(v[k],ss.str(),type);
+        names.push_back(ss.str());
     }
-    free_block(v);
+
+    // Orbitals of the current batch of fields
+    std::shared_ptr<Matrix> C2;
+    int batch_start = -1;
+    double** Cp = C->pointer();
+    write_streamed(names, type, [&](double** v, int f0, int f1, int start, int stop) {
+        if (f0 != batch_start) {
+            C2 = std::shared_ptr<Matrix>(new Matrix(primary_->nbf(), f1 - f0));
+            double** C2p = C2->pointer();
+            for (int k = f0; k < f1; k++) {
+                C_DCOPY(primary_->nbf(), &Cp[0][indices[k]], C->colspi()[0], &C2p[0][k - f0], f1 - f0);
+            }
+            batch_start = f0;
+        }
+        add_orbitals(v, C2, start, stop);
+    });
 }
 void CubicScalarGrid::compute_LOL(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type)
 {
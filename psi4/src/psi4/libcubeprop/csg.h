@@ -29,8 +29,11 @@
 #ifndef _psi_src_lib_libcubeprop_csg_h_
 #define _psi_src_lib_libcubeprop_csg_h_
 
+#include <cstdio>
+#include <functional>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "psi4/libmints/typedefs.h"
 
@@ -87,13 +90,41 @@ protected:
     std::vector<std::shared_ptr<BlockOPoints> > blocks_;
     /// Points to basis extents, built internally
     std::shared_ptr<BasisExtents> extents_;
-    /// RKS points object
-    std::shared_ptr<RKSFunctions> points_;
+    /// Offset of each block into the fast-ordered grid
+    std::vector<size_t> block_offsets_;
+    /// Number of threads blocks are spread over
+    int nthreads_;
+    /// RKS points objects, one per thread
+    std::vector<std::shared_ptr<RKSFunctions> > point_workers_;
 
     // => Helper Routines <= //
 
     /// Setup grid from info in N_, D_, O_
     void populate_grid();
+    /// Copy the x-planes [ibegin, iend) of v (in fast ordering, starting at plane ibegin)
+    /// into v2 in cube ordering (x slowest, z fastest). Both bounds are multiples of nxyz_
+    /// or the end of the grid.
+    void cube_order(const double* v, double* v2, int ibegin, int iend) const;
+    /// Throw unless filepath_ is an existing directory
+    void check_filepath() const;
+    /// Open filepath/name.ext for a field of type CUBE or NPY and write its header
+    FILE* open_field_file(const std::string& name, const std::string& type);
+    /// Append n values in cube ordering, the first being value number start of the field
+    void write_field_values(FILE* fh, const std::string& type, const double* v2, size_t n, size_t start);
+    /// Write the fields names one slab of x-planes at a time, so that no field is ever held
+    /// on the whole grid. add(v, f0, f1, start, stop) adds fields [f0, f1) over blocks
+    /// [start, stop) into v (rows are fields, relative to the first block).
+    void write_streamed(const std::vector<std::string>& names, const std::string& type,
+                        const std::function<void(double**, int, int, int, int)>& add);
+
+    /// As the public add_density() etc., over blocks [start, stop) only
+    void add_density(double* v, std::shared_ptr<Matrix> D, int start, int stop);
+    void add_basis_functions(double** v, const std::vector<int>& indices, int start, int stop);
+    void add_orbitals(double** v, std::shared_ptr<Matrix> C, int start, int stop);
+
+    /// Add the electronic ESP of the fitted density d, from per-atom multipoles where they
+    /// reproduce the exact potential to within tolerance
+    void add_esp_multipole(double* v, const double* d, double tolerance);
 
 public:
     // => Constructors <= //
@@ -153,6 +184,9 @@ public:
     void write_gen_file(double* v, const std::string& name, const std::string& type);
     /// Write a Gaussian cube file of the scalar field v (in fast ordering) to filepath/name.cube
     void write_cube_file(double* v, const std::string& name);
+    /// Write the scalar field v (in fast ordering) as a binary NumPy array of shape
+    /// (N_x+1, N_y+1, N_z+1) to filepath/name.npy
+    void write_npy_file(double* v, const std::string& name);
 
     // => Low-Level Scalar Field Computation (Use only if you know what you are doing) <= //
 
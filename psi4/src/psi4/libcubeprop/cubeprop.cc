@@ -201,28 +201,28 @@ void CubeProperties::compute_properties()
 }
 void CubeProperties::compute_density(std::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_density(D, key);
+    grid_->compute_density(D, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_esp(std::shared_ptr<Matrix> Dt, const std::vector<double>& w)
 {
-    grid_->compute_density(Dt, "Dt");
-    grid_->compute_esp(Dt, w, "ESP");
+    grid_->compute_density(Dt, "Dt", options_.get_str("CUBEPROP_FORMAT"));
+    grid_->compute_esp(Dt, w, "ESP", options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_orbitals(std::shared_ptr<Matrix> C, const std::vector<int>& indices, const std::vector<std::string>& labels, const std::string& key)
 {
-    grid_->compute_orbitals(C, indices, labels, key);
+    grid_->compute_orbitals(C, indices, labels, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_basis_functions(const std::vector<int>& indices, const std::string& key)
 {
-    grid_->compute_basis_functions(indices, key);
+    grid_->compute_basis_functions(indices, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_LOL(std::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_LOL(D, key);
+    grid_->compute_LOL(D, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 void CubeProperties::compute_ELF(std::shared_ptr<Matrix> D, const std::string& key)
 {
-    grid_->compute_ELF(D, key);
+    grid_->compute_ELF(D, key, options_.get_str("CUBEPROP_FORMAT"));
 }
 
 }
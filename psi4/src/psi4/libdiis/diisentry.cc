@@ -92,6 +92,10 @@ DIISEntry::read_vector_from_disk()
 {
     if (_vector == NULL) {
         _vector = new double[_vectorSize];
+        if (!_vectorSingle.empty()) {
+            for (int i = 0; i < _vectorSize; ++i) _vector[i] = _vectorSingle[i];
+            return;
+        }
         std::string label = _label + " vector";
         open_psi_file();
         _psio->read_entry(PSIF_LIBDIIS, label.c_str(), (char*)_vector, _vectorSize*sizeof(double));
@@ -114,12 +118,34 @@ DIISEntry::read_error_vector_from_disk()
 {
     if (_errorVector == NULL) {
         _errorVector = new double[_errorVectorSize];
+        if (!_errorVectorSingle.empty()) {
+            for (int i = 0; i < _errorVectorSize; ++i) _errorVector[i] = _errorVectorSingle[i];
+            return;
+        }
         std::string label = _label + " error";
         open_psi_file();
         _psio->read_entry(PSIF_LIBDIIS, label.c_str(), (char*)_errorVector, _errorVectorSize*sizeof(double));
     }
 }
 
+/*
+ * The entry's own dot product is formed at full precision; later
+ * entries are dotted against the rounded error vector.
+ */
+void
+DIISEntry::compress()
+{
+    if (_vector != NULL) {
+        _vectorSingle.assign(_vector, _vector + _vectorSize);
+        free_vector_memory();
+    }
+    if (_errorVector != NULL) {
+        _errorVectorSingle.assign(_errorVector, _errorVector + _errorVectorSize);
+        free_error_vector_memory();
+    }
+}
+
+
 void
 DIISEntry::free_vector_memory()
 {
@@ -31,6 +31,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace psi{
 
@@ -89,6 +90,8 @@ class DIISEntry{
         void free_vector_memory();
         /// Free error vector memory
         void free_error_vector_memory();
+        /// Keep single precision copies of both vectors and free the double precision memory
+        void compress();
         /// Returns the error vector
         const double *errorVector() {read_error_vector_from_disk(); return _errorVector;}
         /// Returns the vector
@@ -116,6 +119,10 @@ class DIISEntry{
         double *_errorVector;
         /// The error vector
         double *_vector;
+        /// The single precision copy of the error vector, if compressed
+        std::vector<float> _errorVectorSingle;
+        /// The single precision copy of the vector, if compressed
+        std::vector<float> _vectorSingle;
         /// The label used for disk storage
         std::string _label;
         /// PSIO object
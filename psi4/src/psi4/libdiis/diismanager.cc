@@ -53,7 +53,8 @@ namespace psi{
  * @param maxSubspaceSize Maximum number of vectors allowed in the subspace
  * @param label: the base part of the label used to store the vectors to disk
  * @param removalPolicy: How to decide which vectors to remove when the subspace is full
- * @param storagePolicy: How to store the DIIS vectors
+ * @param storagePolicy: How to store the DIIS vectors.  InCoreSingle halves the memory
+ *        of InCore, at the cost of rounding the stored vectors to single precision
  * @param psio: the PSIO object to use for I/O.  Do not specify if DPD is being used.
  */
 DIISManager::DIISManager(int maxSubspaceSize,
@@ -300,14 +301,25 @@ DIISManager::add_entry(int numQuantities, ...)
                                            _vectorSize, vectorPtr, _psio);
     }
 
-    if(_storagePolicy == OnDisk) {
-        _subspace[entryID]->dump_vector_to_disk();
-        _subspace[entryID]->dump_error_vector_to_disk();
+    // Form the new row of the B matrix while the new error vector is in core,
+    // so that each existing entry is visited once and extrapolate() only
+    // looks up known dot products
+    DIISEntry *newEntry = _subspace[entryID];
+    for(int i = 0; i < _subspace.size(); ++i){
+        if(i == entryID) continue;
+        double dot = C_DDOT(_errorVectorSize, errorVectorPtr, 1,
+                            const_cast<double*>(_subspace[i]->errorVector()), 1);
+        newEntry->set_dot_with(i, dot);
+        _subspace[i]->set_dot_with(entryID, dot);
+        if(_storagePolicy != InCore) _subspace[i]->free_error_vector_memory();
     }
 
-    // Make we don't know any inner products involving this new entry
-    for(int i = 0; i < _subspace.size(); ++i)
-        if(i != entryID) _subspace[i]->invalidate_dot(entryID);
+    if(_storagePolicy == OnDisk) {
+        newEntry->dump_vector_to_disk();
+        newEntry->dump_error_vector_to_disk();
+    }else if(_storagePolicy == InCoreSingle) {
+        newEntry->compress();
+    }
 
     timer_off("DIISManager::add_entry");
 
@@ -386,7 +398,7 @@ DIISManager::extrapolate(int numQuantities, ...)
                 bMatrix[i][j] = dot;
                 entryI->set_dot_with(j, dot);
                 entryJ->set_dot_with(i, dot);
-                if(_storagePolicy == OnDisk){
+                if(_storagePolicy != InCore){
                     entryI->free_error_vector_memory();
                     entryJ->free_error_vector_memory();
                 }
@@ -529,7 +541,7 @@ DIISManager::extrapolate(int numQuantities, ...)
                     throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
             }
         }
-        if(_storagePolicy == OnDisk) _subspace[n]->free_vector_memory();
+        if(_storagePolicy != InCore) _subspace[n]->free_vector_memory();
         va_end(args);
     }
 
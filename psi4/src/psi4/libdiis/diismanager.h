@@ -49,8 +49,9 @@ class DIISManager{
          *
          * OnDisk - Stored on disk, and retrieved when required
          * InCore - Stored in memory throughout
+         * InCoreSingle - Stored in memory throughout, in single precision
          */
-        enum StoragePolicy {InCore, OnDisk};
+        enum StoragePolicy {InCore, OnDisk, InCoreSingle};
         /**
          * @brief How vectors are removed from the subspace, when required
          *
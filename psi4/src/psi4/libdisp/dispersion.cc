@@ -43,9 +43,13 @@
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/process.h"
 
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <map>
 #include <stdlib.h>
 #include <string>
 #include <sstream>
@@ -54,7 +58,21 @@
 
 namespace psi {
 
-Dispersion::Dispersion()
+namespace {
+// Below this many pairs a call is cheaper than waking up the threads
+const long int DISP_MIN_PAIRS_THREAD = 2048;
+
+int disp_threads()
+{
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    return nthread;
+}
+}
+
+Dispersion::Dispersion() : cutoff_(0.0)
 {
 }
 
@@ -328,45 +346,20 @@ double Dispersion::compute_energy(std::shared_ptr <Molecule> m)
             }
         }
     } else {
-        std::shared_ptr <Vector> atom_list = set_atom_list(m);
-        double *atom_list_p = atom_list->pointer();
-        for (int i = 0; i < m->natom(); i++) {
-            for (int j = 0; j < i; j++) {
-
-                double C6, Rm6, f;
-
-
-                double dx = m->x(j) - m->x(i);
-                double dy = m->y(j) - m->y(i);
-                double dz = m->z(j) - m->z(i);
-
-                double R2 = dx * dx + dy * dy + dz * dz;
-                double R = sqrt(R2);
-                double R6 = R2 * R2 * R2;
-                Rm6 = 1.0 / R6;
-
-
-                if (C6_type_ == C6_arit) {
-                    C6 = 2.0 * C6_[(int) atom_list_p[i]] * C6_[(int) atom_list_p[j]] / (C6_[(int) atom_list_p[i]] + C6_[(int) atom_list_p[j]]);
-                } else if (C6_type_ == C6_geom) {
-                    C6 = sqrt(C6_[(int) atom_list_p[i]] * C6_[(int) atom_list_p[j]]);
-                } else {
-                    throw PSIEXCEPTION("Unrecognized C6 Type");
-                }
-
-                if (Damping_type_ == Damping_D1) {
-                    double RvdW = RvdW_[(int) atom_list_p[i]] + RvdW_[(int) atom_list_p[j]];
-                    f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1)));
-                } else if (Damping_type_ == Damping_CHG) {
-                    double RvdW = RvdW_[(int) atom_list_p[i]] + RvdW_[(int) atom_list_p[j]];
-                    f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                } else {
-                    throw PSIEXCEPTION("Unrecognized Damping Function");
-                }
-
-
-                E += C6 * Rm6 * f;
-            }
+        std::vector<double> R;
+        std::vector<int> pairs;
+        form_pairs(m, R, pairs);
+        long int npair = pairs.size();
+        const double *C6p = pair_C6_.data();
+        const double *RvdWp = pair_RvdW_.data();
+        int nthread = (npair >= DISP_MIN_PAIRS_THREAD ? disp_threads() : 1);
+
+#pragma omp parallel for schedule(static) reduction(+ : E) num_threads(nthread)
+        for (long int p = 0; p < npair; p++) {
+            int ij = pairs[p];
+            double e, e_R, e_RR;
+            pair_term(R[4 * p], C6p[ij], RvdWp[ij], e, e_R, e_RR);
+            E += e;
         }
     }
     E *= -s6_;
@@ -379,75 +372,234 @@ SharedMatrix Dispersion::compute_gradient(std::shared_ptr <Molecule> m)
     SharedMatrix G(new Matrix("Dispersion Gradient", m->natom(), 3));
     double **Gp = G->pointer();
 
-    for (int i = 0; i < m->natom(); i++) {
-        for (int j = 0; j < i; j++) {
-
-            double C6, Rm6, f;
-            double C6_R, Rm6_R, f_R;
-
-            double R;
-            double R_xi, R_yi, R_zi;
-            double R_xj, R_yj, R_zj;
+    if (Damping_type_ == Damping_TT) {
+        throw PSIEXCEPTION("+Das Gradients not yet implemented");
+    }
 
-            double dx = m->x(j) - m->x(i);
-            double dy = m->y(j) - m->y(i);
-            double dz = m->z(j) - m->z(i);
+    std::vector<double> R;
+    std::vector<int> pairs;
+    form_pairs(m, R, pairs);
+    long int npair = pairs.size();
+    const double *C6p = pair_C6_.data();
+    const double *RvdWp = pair_RvdW_.data();
+    int nthread = (npair >= DISP_MIN_PAIRS_THREAD ? disp_threads() : 1);
+
+    // dE/dR / R of each pair, scattered onto the atoms afterwards
+    std::vector<double> dE(npair);
+
+#pragma omp parallel for schedule(static) num_threads(nthread)
+    for (long int p = 0; p < npair; p++) {
+        int ij = pairs[p];
+        double e, e_R, e_RR;
+        pair_term(R[4 * p], C6p[ij], RvdWp[ij], e, e_R, e_RR);
+        dE[p] = e_R / R[4 * p];
+    }
 
-            double R2 = dx * dx + dy * dy + dz * dz;
-            R = sqrt(R2);
+    for (long int p = 0; p < npair; p++) {
+        int ij = pairs[p];
+        int i = pair_atoms_[2 * ij];
+        int j = pair_atoms_[2 * ij + 1];
+        for (int x = 0; x < 3; x++) {
+            double g = dE[p] * R[4 * p + 1 + x];
+            Gp[i][x] -= g;
+            Gp[j][x] += g;
+        }
+    }
 
-            R_xi = -dx / R;
-            R_xj = dx / R;
-            R_yi = -dy / R;
-            R_yj = dy / R;
-            R_zi = -dz / R;
-            R_zj = dz / R;
+    G->scale(-s6_);
+    return G;
+}
 
-            double R6 = R2 * R2 * R2;
-            Rm6 = 1.0 / R6;
-            Rm6_R = -6.0 * Rm6 / R;
+SharedMatrix Dispersion::compute_hessian(std::shared_ptr <Molecule> m)
+{
+    int natom = m->natom();
+    SharedMatrix H(new Matrix("Dispersion Hessian", 3 * natom, 3 * natom));
+    double **Hp = H->pointer();
 
-            double RvdW = RvdW_[(int) m->Z(i)] + RvdW_[(int) m->Z(j)];
+    if (Damping_type_ == Damping_TT) {
+        throw PSIEXCEPTION("+Das Hessians not yet implemented");
+    }
 
-            if (C6_type_ == C6_arit) {
-                C6 = 2.0 * C6_[(int) m->Z(i)] * C6_[(int) m->Z(j)] / (C6_[(int) m->Z(i)] + C6_[(int) m->Z(j)]);
-                C6_R = 0.0;
-            } else if (C6_type_ == C6_geom) {
-                C6 = sqrt(C6_[(int) m->Z(i)] * C6_[(int) m->Z(j)]);
-                C6_R = 0.0;
-            } else {
-                throw PSIEXCEPTION("Unrecognized C6 Type");
+    std::vector<double> R;
+    std::vector<int> pairs;
+    form_pairs(m, R, pairs);
+    long int npair = pairs.size();
+    const double *C6p = pair_C6_.data();
+    const double *RvdWp = pair_RvdW_.data();
+    int nthread = (npair >= DISP_MIN_PAIRS_THREAD ? disp_threads() : 1);
+
+    // d2E/dr_x dr_y of each pair in the separation r = r_j - r_i:
+    //  E'' n n^T + E' / R (1 - n n^T)
+    std::vector<double> block(9 * npair);
+
+#pragma omp parallel for schedule(static) num_threads(nthread)
+    for (long int p = 0; p < npair; p++) {
+        int ij = pairs[p];
+        double Rp = R[4 * p];
+        double e, e_R, e_RR;
+        pair_term(Rp, C6p[ij], RvdWp[ij], e, e_R, e_RR);
+        double n[3] = {R[4 * p + 1] / Rp, R[4 * p + 2] / Rp, R[4 * p + 3] / Rp};
+        double t = e_R / Rp;
+        for (int x = 0; x < 3; x++) {
+            for (int y = 0; y < 3; y++) {
+                block[9 * p + 3 * x + y] = (e_RR - t) * n[x] * n[y] + (x == y ? t : 0.0);
             }
-            if (Damping_type_ == Damping_D1) {
-                f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1.0)));
-                f_R = -f * f * exp(-d_ * (R / RvdW - 1.0)) * (-d_ / RvdW);
-            } else if (Damping_type_ == Damping_CHG) {
-                f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                f_R = -f * f * d_ * (-12.0) * pow((R / RvdW), -13.0) * (1.0 / RvdW);
-            } else if (Damping_type_ == Damping_TT) {
-                throw PSIEXCEPTION("+Das Gradients not yet implemented");
-            } else {
-                throw PSIEXCEPTION("Unrecognized Damping Function");
+        }
+    }
+
+    for (long int p = 0; p < npair; p++) {
+        int ij = pairs[p];
+        int i = pair_atoms_[2 * ij];
+        int j = pair_atoms_[2 * ij + 1];
+        const double *b = &block[9 * p];
+        for (int x = 0; x < 3; x++) {
+            for (int y = 0; y < 3; y++) {
+                double h = b[3 * x + y];
+                Hp[3 * i + x][3 * i + y] += h;
+                Hp[3 * j + x][3 * j + y] += h;
+                Hp[3 * i + x][3 * j + y] -= h;
+                Hp[3 * j + x][3 * i + y] -= h;
             }
+        }
+    }
 
-            double E_R = C6_R * Rm6 * f + C6 * Rm6_R * f + C6 * Rm6 * f_R;
+    H->scale(-s6_);
+    return H;
+}
 
-            Gp[i][0] += E_R * R_xi;
-            Gp[i][1] += E_R * R_yi;
-            Gp[i][2] += E_R * R_zi;
-            Gp[j][0] += E_R * R_xj;
-            Gp[j][1] += E_R * R_yj;
-            Gp[j][2] += E_R * R_zj;
-        }
+void Dispersion::pair_term(double R, double C6, double RvdW, double &e, double &e_R, double &e_RR) const
+{
+    double Rm1 = 1.0 / R;
+    double Rm2 = Rm1 * Rm1;
+    double Rm6 = Rm2 * Rm2 * Rm2;
+    double Rm6_R = -6.0 * Rm6 * Rm1;
+    double Rm6_RR = 42.0 * Rm6 * Rm2;
+
+    double f, f_R, f_RR;
+    if (Damping_type_ == Damping_D1) {
+        double u = exp(-d_ * (R / RvdW - 1.0));
+        double a = d_ / RvdW;
+        f = 1.0 / (1.0 + u);
+        f_R = f * f * u * a;
+        f_RR = a * (2.0 * f * f_R * u - f * f * u * a);
+    } else {
+        // Damping_CHG, form_pairs() has turned away everything else
+        double w = d_ * pow((R / RvdW), -12.0);
+        double w_R = -12.0 * w * Rm1;
+        f = 1.0 / (1.0 + w);
+        f_R = -f * f * w_R;
+        f_RR = 2.0 * f * f * f * w_R * w_R - f * f * (156.0 * w * Rm2);
     }
 
-    G->scale(-s6_);
-    return G;
+    e = C6 * Rm6 * f;
+    e_R = C6 * (Rm6_R * f + Rm6 * f_R);
+    e_RR = C6 * (Rm6_RR * f + 2.0 * Rm6_R * f_R + Rm6 * f_RR);
 }
 
-SharedMatrix Dispersion::compute_hessian(std::shared_ptr <Molecule> m)
+void Dispersion::form_pairs(std::shared_ptr <Molecule> m, std::vector<double> &R, std::vector<int> &pairs)
 {
-    throw PSIEXCEPTION("Dispersion: Hessians not implemented");
+    if (Damping_type_ != Damping_D1 && Damping_type_ != Damping_CHG) {
+        throw PSIEXCEPTION("Unrecognized Damping Function");
+    }
+
+    int natom = m->natom();
+    std::vector<int> Z(natom);
+    for (int i = 0; i < natom; i++) {
+        Z[i] = (int) m->Z(i);
+    }
+
+    // The pair parameters only depend on the atom types, so repeated calls on
+    // the same molecule (optimizations, sampling) skip the table lookups
+    if (Z != pair_Z_) {
+        long int npair = (long int) natom * (natom - 1) / 2;
+        pair_C6_.assign(npair, 0.0);
+        pair_RvdW_.assign(npair, 0.0);
+        pair_atoms_.assign(2 * npair, 0);
+        for (int i = 0, ij = 0; i < natom; i++) {
+            for (int j = 0; j < i; j++, ij++) {
+                pair_atoms_[2 * ij] = i;
+                pair_atoms_[2 * ij + 1] = j;
+                double C6i = C6_[Z[i]];
+                double C6j = C6_[Z[j]];
+                // Ghosts carry no C6, and would make the arithmetic mean 0/0
+                if (C6i == 0.0 || C6j == 0.0) continue;
+                if (C6_type_ == C6_arit) {
+                    pair_C6_[ij] = 2.0 * C6i * C6j / (C6i + C6j);
+                } else if (C6_type_ == C6_geom) {
+                    pair_C6_[ij] = sqrt(C6i * C6j);
+                } else {
+                    throw PSIEXCEPTION("Unrecognized C6 Type");
+                }
+                pair_RvdW_[ij] = RvdW_[Z[i]] + RvdW_[Z[j]];
+            }
+        }
+        pair_Z_ = Z;
+    }
+
+    std::vector<double> xyz(3 * natom);
+    for (int i = 0; i < natom; i++) {
+        xyz[3 * i] = m->x(i);
+        xyz[3 * i + 1] = m->y(i);
+        xyz[3 * i + 2] = m->z(i);
+    }
+
+    R.clear();
+    pairs.clear();
+    double cut2 = cutoff_ * cutoff_;
+    auto add_pair = [&](int i, int j) {
+        int ij = i * (i - 1) / 2 + j;
+        if (pair_C6_[ij] == 0.0) return;
+        double dx = xyz[3 * j] - xyz[3 * i];
+        double dy = xyz[3 * j + 1] - xyz[3 * i + 1];
+        double dz = xyz[3 * j + 2] - xyz[3 * i + 2];
+        double R2 = dx * dx + dy * dy + dz * dz;
+        if (cutoff_ > 0.0 && R2 > cut2) return;
+        pairs.push_back(ij);
+        R.push_back(sqrt(R2));
+        R.push_back(dx);
+        R.push_back(dy);
+        R.push_back(dz);
+    };
+
+    if (cutoff_ <= 0.0) {
+        for (int i = 0; i < natom; i++) {
+            for (int j = 0; j < i; j++) {
+                add_pair(i, j);
+            }
+        }
+        return;
+    }
+
+    // Cell list with cells one cutoff wide: partners of an atom can only sit
+    // in its own or the 26 neighbouring cells
+    double lo[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < natom; i++) {
+        for (int x = 0; x < 3; x++) {
+            if (i == 0 || xyz[3 * i + x] < lo[x]) lo[x] = xyz[3 * i + x];
+        }
+    }
+    std::vector<std::array<long int, 3>> cell(natom);
+    std::map<std::array<long int, 3>, std::vector<int>> cells;
+    for (int i = 0; i < natom; i++) {
+        for (int x = 0; x < 3; x++) {
+            cell[i][x] = (long int) floor((xyz[3 * i + x] - lo[x]) / cutoff_);
+        }
+        cells[cell[i]].push_back(i);
+    }
+    for (int i = 0; i < natom; i++) {
+        for (long int a = -1; a <= 1; a++) {
+            for (long int b = -1; b <= 1; b++) {
+                for (long int c = -1; c <= 1; c++) {
+                    std::array<long int, 3> key = {{cell[i][0] + a, cell[i][1] + b, cell[i][2] + c}};
+                    auto it = cells.find(key);
+                    if (it == cells.end()) continue;
+                    for (int j : it->second) {
+                        if (j < i) add_pair(i, j);
+                    }
+                }
+            }
+        }
+    }
 }
 
 std::shared_ptr <Vector> Dispersion::set_atom_list(std::shared_ptr <Molecule> mol)
@@ -37,6 +37,7 @@
 ***********************************************************/
 #include "psi4/psi4-dec.h"
 #include <string>
+#include <vector>
 
 namespace psi {
 
@@ -74,6 +75,22 @@ protected:
     const double *A_;
     const double *Beta_;
 
+    /// Pairs farther apart than this (bohr) are dropped, 0 keeps all pairs
+    double cutoff_;
+
+    /// Atomic numbers the pair parameters below were built for
+    std::vector<int> pair_Z_;
+    /// Combined C6 and R_vdW of each pair i > j, packed as i(i-1)/2 + j
+    std::vector<double> pair_C6_;
+    std::vector<double> pair_RvdW_;
+    /// Atoms (i, j) of each packed pair
+    std::vector<int> pair_atoms_;
+
+    /// Packed indices of the pairs to sum for m, with distance and r_j - r_i of each in R (4 per pair)
+    void form_pairs(std::shared_ptr<Molecule> m, std::vector<double>& R, std::vector<int>& pairs);
+    /// Damped C6 R^-6 of a pair and its first and second derivatives in R (D1 and CHG damping)
+    void pair_term(double R, double C6, double RvdW, double& e, double& e_R, double& e_RR) const;
+
 public:
 
     Dispersion();
@@ -99,6 +116,7 @@ public:
     double get_s8() const { return s8_; }
     double get_a1() const { return a1_; }
     double get_a2() const { return a2_; }
+    double get_cutoff() const { return cutoff_; }
 
     void set_d(double d) { d_ = d; }
     void set_s6(double s6) { s6_ = s6; }
@@ -106,6 +124,7 @@ public:
     void set_s8(double s8) { s8_ = s8; }
     void set_a1(double a1) { a1_ = a1; }
     void set_a2(double a2) { a2_ = a2; }
+    void set_cutoff(double cutoff) { cutoff_ = cutoff; }
 
     std::string print_energy(std::shared_ptr<Molecule> m);
     std::string print_gradient(std::shared_ptr<Molecule> m);
@@ -93,7 +93,6 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/libdpd/dpd.h"
 #include "psi4/psifiles.h"
-#include <pthread.h>
 
 namespace psi {
 
@@ -0,0 +1,229 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*! \file
+    \ingroup DPD
+    \brief Amplitude checkpoints for restarting CC iterations
+*/
+#include "amp_checkpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "dpd.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psifiles.h"
+
+namespace psi {
+
+namespace {
+
+const char amp_magic[8] = {'P', 'S', 'I', '4', 'A', 'M', 'P', '1'};
+const size_t amp_taglen = 64;
+/// Largest orbital coefficient change still taken as the same orbitals
+const double amp_orbital_tolerance = 1.0E-6;
+/// Doubles per DIIS transfer
+const size_t amp_diis_chunk = 1L << 20;
+
+const int diis_units[2] = {PSIF_CC_DIIS_ERR, PSIF_CC_DIIS_AMP};
+const char *diis_labels[2] = {"DIIS Error Vectors", "DIIS Amplitude Vectors"};
+
+}
+
+AmpCheckpoint::AmpCheckpoint(const std::string &path, const std::string &tag) : path_(path), tag_(tag) {
+    tag_.resize(amp_taglen, '\0');
+}
+
+void AmpCheckpoint::add_orbitals(SharedMatrix C) { orbitals_.push_back(C); }
+
+void AmpCheckpoint::add_file2(int filenum, int irrep, int pnum, int qnum, const std::string &label, bool diis) {
+    tensors_.push_back({filenum, irrep, pnum, qnum, label, false, diis});
+}
+
+void AmpCheckpoint::add_file4(int filenum, int irrep, int pqnum, int rsnum, const std::string &label, bool diis) {
+    tensors_.push_back({filenum, irrep, pqnum, rsnum, label, true, diis});
+}
+
+int AmpCheckpoint::transfer(const Tensor &T, FILE *fp, bool save) {
+    int fail;
+    if (T.four) {
+        dpdfile4 F;
+        global_dpd_->file4_init(&F, T.filenum, T.irrep, T.pnum, T.qnum, T.label.c_str());
+        fail = save ? global_dpd_->file4_save(&F, fp) : global_dpd_->file4_load(&F, fp);
+        global_dpd_->file4_close(&F);
+    } else {
+        dpdfile2 F;
+        global_dpd_->file2_init(&F, T.filenum, T.irrep, T.pnum, T.qnum, T.label.c_str());
+        fail = save ? global_dpd_->file2_save(&F, fp) : global_dpd_->file2_load(&F, fp);
+        global_dpd_->file2_close(&F);
+    }
+    return fail;
+}
+
+size_t AmpCheckpoint::diis_length() {
+    size_t length = 0;
+    for (const Tensor &T : tensors_) {
+        if (!T.diis) continue;
+        if (T.four) {
+            dpdfile4 F;
+            global_dpd_->file4_init(&F, T.filenum, T.irrep, T.pnum, T.qnum, T.label.c_str());
+            for (int h = 0; h < F.params->nirreps; h++)
+                length += (size_t)F.params->rowtot[h] * F.params->coltot[h ^ T.irrep];
+            global_dpd_->file4_close(&F);
+        } else {
+            dpdfile2 F;
+            global_dpd_->file2_init(&F, T.filenum, T.irrep, T.pnum, T.qnum, T.label.c_str());
+            for (int h = 0; h < F.params->nirreps; h++)
+                length += (size_t)F.params->rowtot[h] * F.params->coltot[h ^ T.irrep];
+            global_dpd_->file2_close(&F);
+        }
+    }
+    return length;
+}
+
+void AmpCheckpoint::write(int iter, int ndiis) {
+    std::string tmp = path_ + ".tmp";
+    FILE *fp = std::fopen(tmp.c_str(), "wb");
+    if (fp == NULL) {
+        outfile->Printf("    Warning: could not open amplitude checkpoint %s.\n", tmp.c_str());
+        return;
+    }
+
+    int fail = 0;
+    int counts[4] = {iter, ndiis, (int)orbitals_.size(), (int)tensors_.size()};
+    fail |= (std::fwrite(amp_magic, 1, sizeof(amp_magic), fp) != sizeof(amp_magic));
+    fail |= (std::fwrite(tag_.data(), 1, amp_taglen, fp) != amp_taglen);
+    fail |= (std::fwrite(counts, sizeof(int), 4, fp) != 4);
+
+    for (SharedMatrix C : orbitals_) {
+        for (int h = 0; h < C->nirrep(); h++) {
+            int dims[2] = {C->rowdim(h), C->coldim(h)};
+            size_t size = (size_t)dims[0] * dims[1];
+            fail |= (std::fwrite(dims, sizeof(int), 2, fp) != 2);
+            if (size) fail |= (std::fwrite(C->pointer(h)[0], sizeof(double), size, fp) != size);
+        }
+    }
+
+    for (const Tensor &T : tensors_) fail |= transfer(T, fp, true);
+
+    if (ndiis) {
+        size_t total = ndiis * diis_length();
+        std::vector<double> buffer(std::min(total, amp_diis_chunk));
+        for (int u = 0; u < 2; u++) {
+            psio_address next;
+            for (size_t offset = 0; offset < total; offset += buffer.size()) {
+                size_t n = std::min(buffer.size(), total - offset);
+                psio_read(diis_units[u], diis_labels[u], (char *)buffer.data(), n * sizeof(double),
+                          psio_get_address(PSIO_ZERO, offset * sizeof(double)), &next);
+                fail |= (std::fwrite(buffer.data(), sizeof(double), n, fp) != n);
+            }
+        }
+    }
+
+    fail |= std::fclose(fp);
+    if (fail || std::rename(tmp.c_str(), path_.c_str())) {
+        outfile->Printf("    Warning: could not write amplitude checkpoint %s.\n", path_.c_str());
+        std::remove(tmp.c_str());
+        return;
+    }
+    outfile->Printf("    Amplitudes of iteration %d checkpointed to %s.\n", iter, path_.c_str());
+}
+
+int AmpCheckpoint::read() {
+    FILE *fp = std::fopen(path_.c_str(), "rb");
+    if (fp == NULL) return 0;
+
+    char magic[sizeof(amp_magic)];
+    std::string tag(amp_taglen, '\0');
+    int counts[4];
+    bool ok = (std::fread(magic, 1, sizeof(magic), fp) == sizeof(magic)) &&
+              (std::fread(&tag[0], 1, amp_taglen, fp) == amp_taglen) && (std::fread(counts, sizeof(int), 4, fp) == 4);
+    if (!ok || std::memcmp(magic, amp_magic, sizeof(magic)) || tag != tag_ || counts[2] != (int)orbitals_.size() ||
+        counts[3] != (int)tensors_.size()) {
+        outfile->Printf("    Ignoring amplitude checkpoint %s, it belongs to another calculation.\n", path_.c_str());
+        std::fclose(fp);
+        return 0;
+    }
+    int iter = counts[0];
+    int ndiis = counts[1];
+
+    for (SharedMatrix C : orbitals_) {
+        for (int h = 0; h < C->nirrep() && ok; h++) {
+            int dims[2];
+            ok = (std::fread(dims, sizeof(int), 2, fp) == 2) && dims[0] == C->rowdim(h) && dims[1] == C->coldim(h);
+            size_t size = (size_t)C->rowdim(h) * C->coldim(h);
+            if (!ok || !size) continue;
+            std::vector<double> old(size);
+            ok = (std::fread(old.data(), sizeof(double), size, fp) == size);
+            const double *now = C->pointer(h)[0];
+            for (size_t n = 0; n < size && ok; n++) ok = (std::fabs(old[n] - now[n]) < amp_orbital_tolerance);
+        }
+        if (!ok) break;
+    }
+    if (!ok) {
+        outfile->Printf("    Ignoring amplitude checkpoint %s, the orbitals have changed.\n", path_.c_str());
+        std::fclose(fp);
+        return 0;
+    }
+
+    // From here on the iterate is being overwritten, a bad file is fatal
+    for (const Tensor &T : tensors_) {
+        if (transfer(T, fp, false)) {
+            std::fclose(fp);
+            throw PSIEXCEPTION("AmpCheckpoint: " + path_ + " is damaged or does not match " + T.label +
+                               ". Remove it to start from scratch.");
+        }
+    }
+
+    if (ndiis) {
+        size_t total = ndiis * diis_length();
+        std::vector<double> buffer(std::min(total, amp_diis_chunk));
+        for (int u = 0; u < 2; u++) {
+            psio_address next;
+            for (size_t offset = 0; offset < total; offset += buffer.size()) {
+                size_t n = std::min(buffer.size(), total - offset);
+                if (std::fread(buffer.data(), sizeof(double), n, fp) != n) {
+                    std::fclose(fp);
+                    throw PSIEXCEPTION("AmpCheckpoint: " + path_ + " is missing DIIS vectors. Remove it to start from scratch.");
+                }
+                psio_write(diis_units[u], diis_labels[u], (char *)buffer.data(), n * sizeof(double),
+                           psio_get_address(PSIO_ZERO, offset * sizeof(double)), &next);
+            }
+        }
+    }
+    std::fclose(fp);
+
+    outfile->Printf("    Restarting from the amplitudes of iteration %d in %s.\n", iter, path_.c_str());
+    return iter;
+}
+
+}  // namespace psi
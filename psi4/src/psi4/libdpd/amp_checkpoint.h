@@ -0,0 +1,101 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+#ifndef DPD_AMP_CHECKPOINT_H
+#define DPD_AMP_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include "psi4/libmints/typedefs.h"
+
+namespace psi {
+
+/**
+ * Compact restart file for iterative CC solvers (CC_CHECKPOINT_FREQ).
+ *
+ * A module registers the orbitals the amplitudes were built on and the
+ * dpd tensors that define its iterate, then calls write() every few
+ * iterations.  The file lives outside the PSIO scratch namespace, so a
+ * fresh job can call read() and carry on where a killed one stopped.  The
+ * DIIS subspace (PSIF_CC_DIIS_ERR/AMP) goes along, its vector length
+ * being the sum of the tensors registered with diis = true.
+ *
+ * read() refuses a file written by another module or for other orbitals
+ * (including a phase flip of any MO), so a stale checkpoint costs a fresh
+ * start and never a wrong answer.
+ */
+class AmpCheckpoint {
+   public:
+    AmpCheckpoint(const std::string& path, const std::string& tag);
+
+    const std::string& path() const { return path_; }
+
+    /// Orbitals that must be unchanged for the amplitudes to be reused
+    void add_orbitals(SharedMatrix C);
+    /// A file2 of the current global dpd, part of the DIIS vector when diis is true
+    void add_file2(int filenum, int irrep, int pnum, int qnum, const std::string& label, bool diis = true);
+    /// A file4 of the current global dpd, part of the DIIS vector when diis is true
+    void add_file4(int filenum, int irrep, int pqnum, int rsnum, const std::string& label, bool diis = true);
+
+    /**
+     * Atomically replace the checkpoint with the current tensors and the
+     * first ndiis DIIS vectors, tagged with iteration iter.  The solver
+     * resumes at iter + 1, so ndiis must be the number of vectors its DIIS
+     * expects to find at that point.  Failures only print a warning.
+     */
+    void write(int iter, int ndiis);
+    /**
+     * Restore tensors and DIIS vectors from a matching checkpoint.
+     * Returns the iteration it was written at, 0 if there is none to use.
+     */
+    int read();
+
+   private:
+    struct Tensor {
+        int filenum;
+        int irrep;
+        int pnum;
+        int qnum;
+        std::string label;
+        bool four;
+        bool diis;
+    };
+
+    std::string path_;
+    std::string tag_;
+    std::vector<SharedMatrix> orbitals_;
+    std::vector<Tensor> tensors_;
+
+    /// Length of one DIIS vector in doubles
+    size_t diis_length();
+    /// Save or load one registered tensor, 0 on success
+    int transfer(const Tensor& T, FILE* fp, bool save);
+};
+
+}  // namespace psi
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+/*! \file
+    \ingroup DPD
+    \brief Timing of contract444() on synthetic amplitudes
+*/
+
+#include "dpd.h"
+
+#include "psi4/psifiles.h"
+#include "psi4/libmints/dimension.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/libpsi4util.h"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+namespace {
+
+void benchmark_fill(dpdbuf4 *Buf)
+{
+    global_dpd_->buf4_mat_irrep_init(Buf, 0);
+    for(int pq=0; pq < Buf->params->rowtot[0]; pq++)
+        for(int rs=0; rs < Buf->params->coltot[0]; rs++)
+            Buf->matrix[0][pq][rs] = std::rand() / (double) RAND_MAX - 0.5;
+    global_dpd_->buf4_mat_irrep_wrt(Buf, 0);
+    global_dpd_->buf4_mat_irrep_close(Buf, 0);
+}
+
+}  // namespace
+
+/* benchmark_contract444(): Times the particle-particle ladder type
+** contraction Z(ij,ab) = X(ij,kl) Y(kl,ab) through contract444() on a
+** C1 DPD instance with nocc occupied and nvir virtual orbitals.  The
+** operands are random and live in PSIF_CC_TMP, which is deleted on exit,
+** so the timing includes the buffer I/O that a real CC iteration pays.
+**
+** Returns o, v, seconds (per call) and gflops, counting 2 o^4 v^2 flops.
+*/
+
+std::map<std::string, double> benchmark_contract444(int nocc, int nvir, double min_time)
+{
+    if(dpd_list[0]) throw PSIEXCEPTION("benchmark_contract444: DPD instance 0 is in use.");
+
+    std::vector<DPDMOSpace> spaces;
+    spaces.push_back(DPDMOSpace('o', "ijklmn", Dimension(std::vector<int>(1, nocc))));
+    spaces.push_back(DPDMOSpace('v', "abcdef", Dimension(std::vector<int>(1, nvir))));
+    int *cachefiles = init_int_array(PSIO_MAXUNIT);
+    int **cachelist = init_int_matrix(12, 12);
+    dpd_list[0] = new DPD(0, 1, Process::environment.get_memory(), 0, cachefiles, cachelist, NULL, 2, spaces);
+    dpd_default = 0;
+    global_dpd_ = dpd_list[0];
+
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    psio->open(PSIF_CC_TMP, PSIO_OPEN_NEW);
+
+    dpdbuf4 X, Y, Z;
+    global_dpd_->buf4_init(&X, PSIF_CC_TMP, 0, "[o,o]", "[o,o]", "[o,o]", "[o,o]", 0, "X (ij,kl)");
+    global_dpd_->buf4_init(&Y, PSIF_CC_TMP, 0, "[o,o]", "[v,v]", "[o,o]", "[v,v]", 0, "Y (kl,ab)");
+    global_dpd_->buf4_init(&Z, PSIF_CC_TMP, 0, "[o,o]", "[v,v]", "[o,o]", "[v,v]", 0, "Z (ij,ab)");
+    benchmark_fill(&X);
+    benchmark_fill(&Y);
+
+    // First call creates Z on disk and is not timed
+    global_dpd_->contract444(&X, &Y, &Z, 0, 1, 1.0, 0.0);
+
+    double T = 0.0;
+    size_t rounds = 0L;
+    Timer* qq = new Timer();
+    while (T < min_time) {
+        global_dpd_->contract444(&X, &Y, &Z, 0, 1, 1.0, 0.0);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+
+    global_dpd_->buf4_close(&X);
+    global_dpd_->buf4_close(&Y);
+    global_dpd_->buf4_close(&Z);
+    psio->close(PSIF_CC_TMP, 0);
+
+    dpd_close(0);
+    free(cachefiles);
+    free_int_matrix(cachelist);
+
+    double o = nocc;
+    double v = nvir;
+    std::map<std::string, double> results;
+    results["nocc"] = nocc;
+    results["nvir"] = nvir;
+    results["seconds"] = T / (double) rounds;
+    results["gflops"] = 2.0E-9 * o * o * o * o * v * v / results["seconds"];
+    return results;
+}
+
+}
@@ -63,6 +63,7 @@
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/memory_tracker.h"
 #include "psi4/psi4-dec.h"
 
 #include<cstdio>
@@ -107,6 +108,15 @@ DPD::dpd_block_matrix(size_t n, size_t m)
             }
         }
 
+        /* Adaptive cache */
+        else if(dpd_main.cachetype == 2) {
+            if(file4_cache_del_adaptive()) {
+                file4_cache_print("outfile");
+                outfile->Printf( "dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
+
         else dpd_error("LIBDPD Error: invalid cachetype.", "outfile");
     }
 
@@ -117,6 +127,8 @@ DPD::dpd_block_matrix(size_t n, size_t m)
         return(NULL);
     }
 
+    MemoryTracker::allocate(size * sizeof(double), "a DPD buffer");
+
     if((A = (double **) malloc(n * sizeof(double *)))==NULL) {
         outfile->Printf("dpd_block_matrix: trouble allocating memory \n");
         outfile->Printf("n = %zd  m = %zd\n",n, m);
@@ -148,6 +160,15 @@ DPD::dpd_block_matrix(size_t n, size_t m)
                 dpd_error("dpd_block_matrix: No memory left.", "outfile");
             }
         }
+
+        /* Adaptive cache */
+        else if(dpd_main.cachetype == 2) {
+            if(file4_cache_del_adaptive()) {
+                file4_cache_print("outfile");
+                outfile->Printf( "dpd_block_matrix: n = %zd  m = %zd\n", n, m);
+                dpd_error("dpd_block_matrix: No memory left.", "outfile");
+            }
+        }
     }
 
     /*  memset((void *) B, 0, m*n*sizeof(double)); */
@@ -179,6 +200,7 @@ void DPD::free_dpd_block(double **array, size_t n, size_t m)
     free(array);
     /* Decrement the global memory counter */
     dpd_main.memused -= size;
+    MemoryTracker::release(size * sizeof(double));
 }
 
 }
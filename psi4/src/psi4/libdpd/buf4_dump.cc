@@ -36,53 +36,88 @@
 
 namespace psi {
 
+/* buf4_dump(): Writes a four-index quantity to an IWL buffer, with
+** the orbital indices translated through prel, qrel, rrel, srel.
+**
+** bk_pack: the quantity is bra-ket symmetric, so only half of it is
+**   written.  With swap23 the element (pq,rs) goes out as (pr|qs), and
+**   is kept when the pair (pr) is not below (qs); this lets a buffer
+**   in (pq,rs) order be dumped in Mulliken order without sorting it
+**   into a (pr,qs) copy first (all four indices must then belong to
+**   the same orbital space, e.g. Gijkl or Gabcd).
+** swap23: write the element (pq,rs) with indices P R Q S.
+**
+** Rows are read in as many buckets as dpd_memfree() requires, so the
+** whole irrep block never has to be in core.
+*/
 int DPD::buf4_dump(dpdbuf4 *DPDBuf, struct iwlbuf *IWLBuf,
                    int *prel, int *qrel, int *rrel, int *srel,
                    int bk_pack, int swap23)
 {
     int h, row, col, p, q, r, s, P, Q, R, S, my_irrep;
+    int nbuckets, n, first, nrows;
+    long int rowtot, coltot, rows_per_bucket;
     double value;
 
     my_irrep = DPDBuf->file.my_irrep;
 
     for(h=0; h < DPDBuf->params->nirreps; h++) {
-        buf4_mat_irrep_init(DPDBuf, h);
-        buf4_mat_irrep_rd(DPDBuf, h);
-        for(row=0; row < DPDBuf->params->rowtot[h]; row++) {
-            p = DPDBuf->params->roworb[h][row][0]; P = prel[p];
-            q = DPDBuf->params->roworb[h][row][1]; Q = qrel[q];
-            if(bk_pack) {
-                for(col=0; col <= row; col++) {
-                    r = DPDBuf->params->colorb[h^my_irrep][col][0]; R = rrel[r];
-                    s = DPDBuf->params->colorb[h^my_irrep][col][1]; S = srel[s];
+        rowtot = DPDBuf->params->rowtot[h];
+        coltot = DPDBuf->params->coltot[h^my_irrep];
+        if(!rowtot || !coltot) continue;
+
+        rows_per_bucket = dpd_memfree()/coltot;
+        if(rows_per_bucket > rowtot) rows_per_bucket = rowtot;
+        if(!rows_per_bucket) dpd_error("buf4_dump: Not enough memory for one row!", "outfile");
+        nbuckets = (int) ((rowtot + rows_per_bucket - 1) / rows_per_bucket);
 
-                    value = DPDBuf->matrix[h][row][col];
+        buf4_mat_irrep_init_block(DPDBuf, h, rows_per_bucket);
+        for(n=0; n < nbuckets; n++) {
+            first = n * rows_per_bucket;
+            nrows = (n == nbuckets-1) ? rowtot - first : rows_per_bucket;
+            buf4_mat_irrep_rd_block(DPDBuf, h, first, nrows);
 
-                    if(swap23)
-                        iwl_buf_wrt_val(IWLBuf, P, R, Q, S, value, 0,
+            for(row=first; row < first + nrows; row++) {
+                p = DPDBuf->params->roworb[h][row][0]; P = prel[p];
+                q = DPDBuf->params->roworb[h][row][1]; Q = qrel[q];
+                double *G = DPDBuf->matrix[h][row-first];
+                if(bk_pack && swap23) {
+                    for(col=0; col < coltot; col++) {
+                        r = DPDBuf->params->colorb[h^my_irrep][col][0];
+                        s = DPDBuf->params->colorb[h^my_irrep][col][1];
+                        if(DPDBuf->params->rowidx[p][r] < DPDBuf->params->rowidx[q][s]) continue;
+                        R = rrel[r]; S = srel[s];
+                        iwl_buf_wrt_val(IWLBuf, P, R, Q, S, G[col], 0,
                                         "outfile", 0);
-                    else
-                        iwl_buf_wrt_val(IWLBuf, P, Q, R, S, value, 0,
+                    }
+                }
+                else if(bk_pack) {
+                    for(col=0; col <= row; col++) {
+                        r = DPDBuf->params->colorb[h^my_irrep][col][0]; R = rrel[r];
+                        s = DPDBuf->params->colorb[h^my_irrep][col][1]; S = srel[s];
+
+                        iwl_buf_wrt_val(IWLBuf, P, Q, R, S, G[col], 0,
                                         "outfile", 0);
+                    }
                 }
-            }
-            else {
-                for(col=0; col < DPDBuf->params->coltot[h^my_irrep]; col++) {
-                    r = DPDBuf->params->colorb[h^my_irrep][col][0]; R = rrel[r];
-                    s = DPDBuf->params->colorb[h^my_irrep][col][1]; S = srel[s];
+                else {
+                    for(col=0; col < coltot; col++) {
+                        r = DPDBuf->params->colorb[h^my_irrep][col][0]; R = rrel[r];
+                        s = DPDBuf->params->colorb[h^my_irrep][col][1]; S = srel[s];
 
-                    value = DPDBuf->matrix[h][row][col];
+                        value = G[col];
 
-                    if(swap23)
-                        iwl_buf_wrt_val(IWLBuf, P, R, Q, S, value, 0,
-                                        "outfile", 0);
-                    else
-                        iwl_buf_wrt_val(IWLBuf, P, Q, R, S, value, 0,
-                                        "outfile", 0);
+                        if(swap23)
+                            iwl_buf_wrt_val(IWLBuf, P, R, Q, S, value, 0,
+                                            "outfile", 0);
+                        else
+                            iwl_buf_wrt_val(IWLBuf, P, Q, R, S, value, 0,
+                                            "outfile", 0);
+                    }
                 }
             }
         }
-        buf4_mat_irrep_close(DPDBuf, h);
+        buf4_mat_irrep_close_block(DPDBuf, h, rows_per_bucket);
     }
 
     return 0;
@@ -79,9 +79,7 @@ int DPD::buf4_mat_irrep_close(dpdbuf4 *Buf, int irrep)
         //          0;
         //      else
         //          dpd_free_block(Buf->matrix[irrep], rowtot, coltot);
-        if(!(Buf->file.incore && !(Buf->anti) &&
-             (Buf->params->pqnum == Buf->file.params->pqnum) &&
-             (Buf->params->rsnum == Buf->file.params->rsnum)))
+        if(!buf4_shares_cache(Buf))
             free_dpd_block(Buf->matrix[irrep], rowtot, coltot);
     }
 
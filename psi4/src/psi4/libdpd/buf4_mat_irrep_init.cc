@@ -37,6 +37,22 @@
 
 namespace psi {
 
+/* dpd_buf4_shares_cache(): Returns 1 if the irrep blocks of a dpd
+** four-index buffer are the cached blocks of its file, i.e., if
+** buf4_mat_irrep_init() assigns pointers rather than allocating memory
+** and reads and writes of the buffer move no data.
+**
+** Arguments:
+**   dpdbuf4 *Buf: A pointer to the input dpdbuf.
+*/
+
+int DPD::buf4_shares_cache(dpdbuf4 *Buf)
+{
+    return (Buf->file.incore && !(Buf->anti) &&
+            (Buf->params->pqnum == Buf->file.params->pqnum) &&
+            (Buf->params->rsnum == Buf->file.params->rsnum));
+}
+
 /* dpd_buf4_mat_irrep_init(): Allocates and initializes memory for a
 ** matrix for a single irrep of a dpd four-index buffer.
 **
@@ -65,9 +81,7 @@ int DPD::buf4_mat_irrep_init(dpdbuf4 *Buf, int irrep)
         /* If the file member is already in cache and its ordering is the
        same as the parent buffer, don't malloc() memory, just assign
        the pointer */
-        if(Buf->file.incore && !(Buf->anti) &&
-                (Buf->params->pqnum == Buf->file.params->pqnum) &&
-                (Buf->params->rsnum == Buf->file.params->rsnum))
+        if(buf4_shares_cache(Buf))
             Buf->matrix[irrep] = Buf->file.matrix[irrep];
         else {
             Buf->matrix[irrep] = dpd_block_matrix(rowtot,coltot);
@@ -34,6 +34,7 @@
 #include "dpd.h"
 
 #include "psi4/libqt/qt.h"
+#include "psi4/libqt/profile.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
@@ -103,17 +104,22 @@ namespace psi {
 ** IC=in-core capable; OOC=out-of-core capable
 ** pqrs: error  ** pqsr: IC/OOC
 ** prqs: IC/OOC ** prsq: IC/OOC
-** psqr: IC     ** psrq: IC
+** psqr: IC/OOC ** psrq: IC/OOC
 ** qprs: IC/OOC ** qpsr: IC/OOC
-** qrps: IC     ** qrsp: IC
-** qspr: IC     ** qsrp: IC
-** rqps: IC     ** rqsp: IC
-** rpqs: IC     ** rpsq: IC
-** rsqp: IC     ** rspq: IC/OOC
-** sqrp: IC     ** sqpr: none
-** srqp: IC     ** srpq: IC
-** spqr: IC     ** sprq: IC
-** -RAK, Nov. 2005*/
+** qrps: IC/OOC ** qrsp: IC/OOC
+** qspr: IC/OOC ** qsrp: IC/OOC
+** rqps: IC/OOC ** rqsp: IC/OOC
+** rpqs: IC/OOC ** rpsq: IC/OOC
+** rsqp: IC/OOC ** rspq: IC/OOC
+** sqrp: IC/OOC ** sqpr: none
+** srqp: IC/OOC ** srpq: IC/OOC
+** spqr: IC/OOC ** sprq: IC/OOC
+** -RAK, Nov. 2005
+**
+** Out-of-core prqs and the sorts that had no out-of-core path use the
+** bucketed external sort in buf4_sort_bucket(), which reads the source
+** only once.
+*/
 
 int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                     int pqnum, int rsnum, const char *label)
@@ -130,6 +136,9 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
     int in_rows_per_bucket, in_nbuckets, in_rows_left, in_row_start, m;
     int rows_per_bucket, nbuckets, rows_left;
 
+    static const int profile_id = Profile::id("DPD buf4_sort");
+    Profile::Scope profile(profile_id);
+
     nirreps = InBuf->params->nirreps;
     my_irrep = InBuf->file.my_irrep;
 
@@ -338,186 +347,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                 }
             }
         }
-        else { /* pqrs <- prqs */
-
-            for(Gpq=0; Gpq < nirreps; Gpq++) {
-                Grs = Gpq^my_irrep;
-
-                out_rows_per_bucket = dpd_memfree()/(2 * OutBuf.params->coltot[Grs]);
-                if(out_rows_per_bucket > OutBuf.params->rowtot[Gpq])
-                    out_rows_per_bucket = OutBuf.params->rowtot[Gpq];
-                out_nbuckets = (int) ceil((double) OutBuf.params->rowtot[Gpq]/(double) out_rows_per_bucket);
-                if(out_nbuckets == 1) out_rows_left = out_rows_per_bucket;
-                else out_rows_left = OutBuf.params->rowtot[Gpq] % out_rows_per_bucket;
-
-                /* allocate space for the bucket of rows */
-                buf4_mat_irrep_init_block(&OutBuf, Gpq, out_rows_per_bucket);
-
-                for(n=0; n < (out_rows_left ? out_nbuckets-1 : out_nbuckets); n++) {
-
-                    out_row_start = n*out_rows_per_bucket;
-
-                    for(Grow=0; Grow < nirreps; Grow++) { /*Grow = Gpr*/
-                        Gcol = Grow^my_irrep;               /*Gcol = Gqs*/
-
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
-
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
-
-                        /* pqrs <- prqs */
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(pr >= 0 && pr < in_rows_per_bucket) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            /* pqrs <- prqs */
-                            for(pq=0; pq < out_rows_per_bucket; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(pr >= 0 && pr < in_rows_left) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
-                    }
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_per_bucket);
-                }
-                if(out_rows_left) {
-
-                    out_row_start = n*out_rows_per_bucket;
-
-                    for(Grow=0; Grow < nirreps; Grow++) {
-                        Gcol = Grow^my_irrep;
-
-                        /* determine how many rows of InBuf we can store in the other half of the core */
-                        in_rows_per_bucket = dpd_memfree()/(2 * InBuf->params->coltot[Gcol]);
-                        if(in_rows_per_bucket > InBuf->params->rowtot[Grow])
-                            in_rows_per_bucket = InBuf->params->rowtot[Grow];
-                        in_nbuckets = (int) ceil((double) InBuf->params->rowtot[Grow]/(double) in_rows_per_bucket);
-                        if(in_nbuckets == 1) in_rows_left = in_rows_per_bucket;
-                        else in_rows_left = InBuf->params->rowtot[Grow] % in_rows_per_bucket;
-
-                        /* allocate space for the bucket of rows */
-                        buf4_mat_irrep_init_block(InBuf, Grow, in_rows_per_bucket);
-
-                        /* pqrs <- prqs */
-                        for(m=0; m < (in_rows_left ? in_nbuckets-1 : in_nbuckets); m++) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_per_bucket);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in the current in_bucket or not */
-                                        if(pr >= 0 && pr < in_rows_per_bucket) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
-                                    }
-                                }
-                            }
-
-                        }
-                        if(in_rows_left) {
-
-                            in_row_start = m*in_rows_per_bucket;
-                            buf4_mat_irrep_rd_block(InBuf, Grow, in_row_start, in_rows_left);
-
-                            for(pq=0; pq < out_rows_left; pq++) {
-                                p = OutBuf.params->roworb[Gpq][pq+out_row_start][0];
-                                q = OutBuf.params->roworb[Gpq][pq+out_row_start][1];
-                                Gp = OutBuf.params->psym[p];
-                                Gq = Gpq^Gp;
-                                for(rs=0; rs < OutBuf.params->coltot[Grs]; rs++) {
-                                    r = OutBuf.params->colorb[Grs][rs][0];
-                                    s = OutBuf.params->colorb[Grs][rs][1];
-                                    Gr = OutBuf.params->rsym[r];
-                                    Gs = Grs^Gr;
-                                    Gpr = Gp^Gr;
-
-                                    if(Gpr == Grow) {
-                                        pr = InBuf->params->rowidx[p][r] - in_row_start;
-                                        /* check if the current value is in core or not */
-                                        if(pr >= 0 && pr < in_rows_left) {
-                                            qs = InBuf->params->colidx[q][s];
-                                            OutBuf.matrix[Gpq][pq][rs] = InBuf->matrix[Grow][pr][qs];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        buf4_mat_irrep_close_block(InBuf, Grow, in_rows_per_bucket);
-                    }
-
-                    buf4_mat_irrep_wrt_block(&OutBuf, Gpq, out_row_start, out_rows_left);
-                }
-
-                buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
-            }
+        else { /* pqrs <- prqs, streamed once through scratch buckets */
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -801,8 +632,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psqr sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -855,8 +685,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for psrq sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1197,8 +1026,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrps sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1251,8 +1079,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qrsp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1304,8 +1131,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qspr sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1357,8 +1183,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for qsrp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1411,8 +1236,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqps sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1465,8 +1289,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rqsp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1519,8 +1342,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpqs sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1573,8 +1395,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rpsq sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1613,8 +1434,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for rsqp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1764,8 +1584,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sqrp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1809,8 +1628,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srqp sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1848,8 +1666,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for srpq sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1902,8 +1719,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for spqr sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
@@ -1956,8 +1772,7 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index,
             }
         }
         else {
-            outfile->Printf( "LIBDPD: Out-of-core algorithm not yet coded for sprq sort.\n");
-            dpd_error("buf4_sort", "outfile");
+            buf4_sort_bucket(InBuf, &OutBuf, index);
         }
 
 #ifdef DPD_TIMER
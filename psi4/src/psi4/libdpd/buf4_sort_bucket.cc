@@ -0,0 +1,297 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Bucketed external sort for out-of-core buf4 permutations
+*/
+
+#include "dpd.h"
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+/* One scattered element: dense offset within its target bucket, and value */
+struct SortRecord {
+    size_t offset;
+    double value;
+};
+
+/* Target pattern of the enum as a string, Out[pattern] = In[pqrs] */
+const char *sort_pattern(enum indices index)
+{
+    static const char *patterns[] = {"pqrs", "pqsr", "prqs", "prsq", "psqr", "psrq",
+                                     "qprs", "qpsr", "qrps", "qrsp", "qspr", "qsrp",
+                                     "rqps", "rqsp", "rpqs", "rpsq", "rsqp", "rspq",
+                                     "sqrp", "sqpr", "srqp", "srpq", "spqr", "sprq"};
+    return patterns[index];
+}
+
+void sort_file_io(bool write, int fd, char *buffer, size_t size, size_t offset)
+{
+    while(size) {
+        ssize_t done = write ? ::pwrite(fd, buffer, size, offset) : ::pread(fd, buffer, size, offset);
+        if(done <= 0) {
+            outfile->Printf("LIBDPD: I/O error on bucketed sort scratch file.\n");
+            throw PSIEXCEPTION("buf4_sort_bucket: scratch file I/O failed");
+        }
+        buffer += done;
+        offset += done;
+        size -= done;
+    }
+}
+
+}  // namespace
+
+/* buf4_sort_bucket(): Out-of-core sort of InBuf into the already
+** initialized OutBuf for any of the index patterns of buf4_sort().
+**
+** Rather than re-reading the source once per block of target rows, the
+** source is streamed exactly once.  Each block of source rows is
+** scattered, in parallel, into the buckets of target rows that fit in
+** core, and each bucket's share is appended to that bucket's region of a
+** scratch file with one large sequential write.  Each bucket is then read
+** back, merged in parallel into a dense block of target rows, and
+** written out.  The scratch file lives in the PSIO scratch directory and
+** is unlinked as soon as it is opened.
+**
+** Arguments:
+**   dpdbuf4 *InBuf: A pointer to the source buffer.
+**   dpdbuf4 *OutBuf: A pointer to the initialized target buffer.
+**   enum indices index: The sorting pattern (see dpd_buf4_sort()).
+*/
+
+int DPD::buf4_sort_bucket(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index)
+{
+    int nirreps = InBuf->params->nirreps;
+    int my_irrep = InBuf->file.my_irrep;
+    dpdparams4 *Ip = InBuf->params;
+    dpdparams4 *Op = OutBuf->params;
+
+#ifdef DPD_TIMER
+    timer_on("buf4_sort_bucket");
+#endif
+
+    /* Target index k takes source index perm[k] */
+    const char *pattern = sort_pattern(index);
+    int perm[4];
+    for(int k=0; k < 4; k++) perm[k] = pattern[k] - 'p';
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+
+    /* Source rows and scatter records share half of the free memory, the
+       rest is left to the buffer reads */
+    long int memoryd = dpd_memfree()/2;
+
+    /* Buckets of target rows, each small enough to be merged in core */
+    std::vector<int> bucket_irrep, bucket_start, bucket_rows;
+    std::vector<int> first_bucket(nirreps), rows_per_bucket(nirreps);
+    std::vector<size_t> region(1, 0);
+    for(int Gpq=0; Gpq < nirreps; Gpq++) {
+        int Grs = Gpq^my_irrep;
+        first_bucket[Gpq] = bucket_irrep.size();
+        if(!Op->rowtot[Gpq] || !Op->coltot[Grs]) { rows_per_bucket[Gpq] = 1; continue; }
+        long int rows = memoryd/Op->coltot[Grs];
+        if(rows > Op->rowtot[Gpq]) rows = Op->rowtot[Gpq];
+        if(!rows) dpd_error("buf4_sort_bucket: Not enough memory for one row!", "outfile");
+        rows_per_bucket[Gpq] = rows;
+        for(int start=0; start < Op->rowtot[Gpq]; start += rows) {
+            int nrows = std::min(rows, (long int) (Op->rowtot[Gpq] - start));
+            bucket_irrep.push_back(Gpq);
+            bucket_start.push_back(start);
+            bucket_rows.push_back(nrows);
+            region.push_back(region.back() + ((size_t) nrows) * Op->coltot[Grs]);
+        }
+    }
+    int nbuckets = bucket_irrep.size();
+    std::vector<size_t> filled(nbuckets, 0);
+
+    std::string path = PSIOManager::shared_object()->get_default_path() + "psi.dpdsort.XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = ::mkstemp(name.data());
+    if(fd < 0) {
+        outfile->Printf("LIBDPD: unable to create sort scratch file %s.\n", path.c_str());
+        dpd_error("buf4_sort_bucket", "outfile");
+    }
+    ::unlink(name.data());
+
+    /* => Pass 1: stream the source once and scatter it into the buckets <= */
+    for(int Gin=0; Gin < nirreps; Gin++) {
+        int Gincol = Gin^my_irrep;
+        int incols = Ip->coltot[Gincol];
+        if(!Ip->rowtot[Gin] || !incols) continue;
+
+        /* A source element costs one double in the block and one record */
+        long int in_rows = memoryd/(incols * (1 + sizeof(SortRecord)/sizeof(double)));
+        if(in_rows > Ip->rowtot[Gin]) in_rows = Ip->rowtot[Gin];
+        if(!in_rows) dpd_error("buf4_sort_bucket: Not enough memory for one row!", "outfile");
+
+        buf4_mat_irrep_init_block(InBuf, Gin, in_rows);
+        std::vector<SortRecord> records(((size_t) in_rows) * incols);
+        std::vector<size_t> counts(((size_t) nthreads) * nbuckets);
+
+        for(int start=0; start < Ip->rowtot[Gin]; start += in_rows) {
+            int nrows = std::min(in_rows, (long int) (Ip->rowtot[Gin] - start));
+            buf4_mat_irrep_rd_block(InBuf, Gin, start, nrows);
+            double **X = InBuf->matrix[Gin];
+
+            std::fill(counts.begin(), counts.end(), 0);
+
+            /* Count the elements each thread sends to each bucket, then
+               give each (bucket, thread) pair its slice of the records */
+#pragma omp parallel num_threads(nthreads)
+            {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                size_t *mycount = &counts[((size_t) thread) * nbuckets];
+
+                for(int pass=0; pass < 2; pass++) {
+#pragma omp for schedule(static)
+                    for(int row=0; row < nrows; row++) {
+                        int orb[4];
+                        orb[0] = Ip->roworb[Gin][row+start][0];
+                        orb[1] = Ip->roworb[Gin][row+start][1];
+                        for(int col=0; col < incols; col++) {
+                            orb[2] = Ip->colorb[Gincol][col][0];
+                            orb[3] = Ip->colorb[Gincol][col][1];
+                            int p = orb[perm[0]], q = orb[perm[1]], r = orb[perm[2]], s = orb[perm[3]];
+                            int pq = Op->rowidx[p][q];
+                            int rs = Op->colidx[r][s];
+                            if(pq < 0 || rs < 0) continue;
+                            int Gpq = Op->psym[p]^Op->qsym[q];
+                            int b = first_bucket[Gpq] + pq/rows_per_bucket[Gpq];
+                            if(pass == 0) {
+                                mycount[b]++;
+                            }
+                            else {
+                                SortRecord &rec = records[mycount[b]++];
+                                rec.offset = ((size_t) (pq - bucket_start[b])) * Op->coltot[Gpq^my_irrep] + rs;
+                                rec.value = X[row][col];
+                            }
+                        }
+                    }
+                    // implicit barrier
+#pragma omp single
+                    {
+                        if(pass == 0) {
+                            /* Bucket-major layout: all threads of bucket 0, then bucket 1, ... */
+                            size_t offset = 0;
+                            for(int b=0; b < nbuckets; b++) {
+                                for(int t=0; t < nthreads; t++) {
+                                    size_t n = counts[((size_t) t) * nbuckets + b];
+                                    counts[((size_t) t) * nbuckets + b] = offset;
+                                    offset += n;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            /* After pass 2 each thread's cursor ends where the next slice
+               begins, so bucket b is the run up to the cursor of its last thread */
+            size_t begin = 0;
+            for(int b=0; b < nbuckets; b++) {
+                size_t end = counts[((size_t) (nthreads-1)) * nbuckets + b];
+                if(end > begin) {
+                    size_t n = end - begin;
+                    if(filled[b] + n > region[b+1] - region[b])
+                        dpd_error("buf4_sort_bucket: bucket overflow", "outfile");
+                    sort_file_io(true, fd, (char *) &records[begin], n * sizeof(SortRecord),
+                                 (region[b] + filled[b]) * sizeof(SortRecord));
+                    filled[b] += n;
+                    begin = end;
+                }
+            }
+        }
+
+        buf4_mat_irrep_close_block(InBuf, Gin, in_rows);
+    }
+
+    /* => Pass 2: merge each bucket into a dense block of target rows <= */
+    for(int b=0; b < nbuckets; b++) {
+        int Gpq = bucket_irrep[b];
+        int Grs = Gpq^my_irrep;
+        size_t size = ((size_t) bucket_rows[b]) * Op->coltot[Grs];
+
+        buf4_mat_irrep_init_block(OutBuf, Gpq, bucket_rows[b]);
+        double *Y = OutBuf->matrix[Gpq][0];
+        ::memset((void *) Y, 0, size * sizeof(double));
+
+        /* The bucket block uses memoryd doubles at most, records get half that */
+        size_t chunk = std::max((size_t) 1, (size_t) (memoryd * sizeof(double) / (2 * sizeof(SortRecord))));
+        std::vector<SortRecord> records(std::min(chunk, filled[b]));
+        for(size_t done=0; done < filled[b]; done += records.size()) {
+            size_t n = std::min(records.size(), filled[b] - done);
+            sort_file_io(false, fd, (char *) records.data(), n * sizeof(SortRecord),
+                         (region[b] + done) * sizeof(SortRecord));
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+            for(long int i=0; i < (long int) n; i++)
+                Y[records[i].offset] = records[i].value;
+        }
+
+        buf4_mat_irrep_wrt_block(OutBuf, Gpq, bucket_start[b], bucket_rows[b]);
+        buf4_mat_irrep_close_block(OutBuf, Gpq, bucket_rows[b]);
+    }
+
+    ::close(fd);
+
+#ifdef DPD_TIMER
+    timer_off("buf4_sort_bucket");
+#endif
+
+    return 0;
+}
+
+}
@@ -0,0 +1,142 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Row tiles of a dpdbuf4 irrep block, read ahead on a helper thread
+*/
+#include "dpd.h"
+
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace psi {
+
+Buf4Tiles::Buf4Tiles(dpdbuf4 *Buf, int irrep, long int memoryd, bool read, bool write, bool prefetch)
+    : Buf_(Buf), irrep_(irrep), read_(read), write_(write), start_(-1), nrows_(0), stored_(true),
+      current_(nullptr), spare_(nullptr)
+{
+    rowtot_ = Buf->params->rowtot[irrep];
+    coltot_ = Buf->params->coltot[irrep ^ Buf->file.my_irrep];
+
+    if(!rowtot_ || !coltot_) {
+        maxrows_ = rowtot_;
+        return;
+    }
+
+    long int fit = memoryd / coltot_;
+    if(fit < 1)
+        throw PSIEXCEPTION("Buf4Tiles: not enough memory for one row of " + std::string(Buf->file.label));
+
+    // Double-buffered only when it still takes more than one tile
+    long int half = fit / 2;
+    bool double_buffer = prefetch && (fit < rowtot_) && (half > 0);
+    maxrows_ = (int) std::min((long int) rowtot_, double_buffer ? half : fit);
+
+    global_dpd_->buf4_mat_irrep_init_block(Buf_, irrep_, maxrows_);
+    current_ = Buf_->matrix[irrep_];
+    if(double_buffer) spare_ = global_dpd_->dpd_block_matrix(maxrows_, coltot_);
+}
+
+Buf4Tiles::~Buf4Tiles()
+{
+    if(helper_.joinable()) helper_.join();
+    if(!current_) return;
+
+    if(write_ && !stored_) store(current_, start_, nrows_);
+    if(spare_) global_dpd_->free_dpd_block(spare_, maxrows_, coltot_);
+    Buf_->matrix[irrep_] = current_;
+    global_dpd_->buf4_mat_irrep_close_block(Buf_, irrep_, maxrows_);
+}
+
+void Buf4Tiles::load(double **block, int start, int nrows)
+{
+    Buf_->matrix[irrep_] = block;
+    if(read_) global_dpd_->buf4_mat_irrep_rd_block(Buf_, irrep_, start, nrows);
+    else ::memset(block[0], 0, sizeof(double) * nrows * (size_t) coltot_);
+}
+
+void Buf4Tiles::store(double **block, int start, int nrows)
+{
+    Buf_->matrix[irrep_] = block;
+    global_dpd_->buf4_mat_irrep_wrt_block(Buf_, irrep_, start, nrows);
+}
+
+bool Buf4Tiles::next()
+{
+    if(!current_) return false;
+    if(helper_.joinable()) helper_.join();
+
+    int next_start = (start_ < 0) ? 0 : start_ + nrows_;
+    if(next_start >= rowtot_) {
+        if(write_ && !stored_) store(current_, start_, nrows_);
+        stored_ = true;
+        Buf_->matrix[irrep_] = current_;
+        start_ = rowtot_;
+        nrows_ = 0;
+        return false;
+    }
+    int next_rows = std::min(maxrows_, rowtot_ - next_start);
+    int after_start = next_start + next_rows;
+    int after_rows = std::min(maxrows_, rowtot_ - after_start);
+
+    if(!spare_) {
+        if(write_ && !stored_) store(current_, start_, nrows_);
+        load(current_, next_start, next_rows);
+    }
+    else if(start_ < 0) {
+        load(current_, next_start, next_rows);
+        if(after_rows > 0) {
+            double **spare = spare_;
+            helper_ = std::thread([=]() { load(spare, after_start, after_rows); });
+        }
+    }
+    else {
+        // The spare holds the tile to hand out; the finished one is written from, and the one
+        // after next read into, the other buffer
+        double **done = current_;
+        int done_start = start_;
+        int done_rows = nrows_;
+        bool dirty = (write_ && !stored_);
+        current_ = spare_;
+        spare_ = done;
+        helper_ = std::thread([=]() {
+            if(dirty) store(done, done_start, done_rows);
+            if(after_rows > 0) load(done, after_start, after_rows);
+        });
+    }
+
+    start_ = next_start;
+    nrows_ = next_rows;
+    stored_ = false;
+    return true;
+}
+
+}  // namespace psi
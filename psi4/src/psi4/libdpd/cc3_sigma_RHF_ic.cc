@@ -38,14 +38,9 @@
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/psifiles.h"
-#include <pthread.h>
 #include "dpd.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
-//MKL Header
-#ifdef USING_LAPACK_MKL
-#include <mkl.h>
-#endif
 
 
 namespace psi {
@@ -73,7 +68,7 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj,
 {
    std::shared_ptr<psi::PsiOutStream> printer=(out=="outfile"?outfile:
             std::shared_ptr<PsiOutStream>(new PsiOutStream(out)));
-    int h, nirreps, thread, nijk, *ijk_part, errcod=0;
+    int h, nirreps, thread, nijk, *ijk_part;
     int Gi, Gj, Gk, Gl, Ga, Gb, Gc, Gd;
     int i, j, k, l, a, b, c, d, row, col;
     int I, J, K, L, A, B, C, D;
@@ -92,17 +87,11 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj,
     double value_ia, value_ka, denom_ia, denom_ka;
     dpdfile2 fIJ, fAB, *SIA_local;
     dpdbuf4 buf4_tmp, *SIjAb_local;
-    pthread_t  *p_thread;
     struct thread_data *thread_data_array;
     char lbl[32];
 
     thread_data_array = (struct thread_data *) malloc(nthreads*sizeof(struct thread_data));
-    p_thread = (pthread_t *) malloc(nthreads*sizeof(pthread_t));
 
-#ifdef USING_LAPACK_MKL
-    int old_threads = mkl_get_max_threads();
-    mkl_set_num_threads(1);
-#endif
 
     nirreps = CIjAb->params->nirreps;
     /* these are sent to T3 function */
@@ -237,24 +226,9 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj,
                 }
 
                 /* execute threads */
-                for (thread=0;thread<nthreads;++thread) {
-                    if (!ijk_part[thread]) continue;
-                    errcod = pthread_create(&(p_thread[thread]), NULL, cc3_sigma_RHF_ic_thread,
-                                            (void *) &thread_data_array[thread]);
-                    if (errcod) {
-                        outfile->Printf("pthread_create in cc3_sigma_RHF_ic failed\n");
-                        exit(PSI_RETURN_FAILURE);
-                    }
-                }
-
-                for (thread=0; thread<nthreads;++thread) {
-                    if (!ijk_part[thread]) continue;
-                    errcod = pthread_join(p_thread[thread], NULL);
-                    if (errcod) {
-                        outfile->Printf("pthread_join in cc3_sigma_RHF_ic failed\n");
-                        exit(PSI_RETURN_FAILURE);
-                    }
-                }
+                parallel_workers(nthreads, [&](int t) {
+                    if (ijk_part[t]) cc3_sigma_RHF_ic_thread((void *) &thread_data_array[t]);
+                });
 
                 for (thread=0;thread<nthreads;++thread) {
                     if (do_singles) {
@@ -318,11 +292,7 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj,
         }
     }
     free(thread_data_array);
-    free(p_thread);
 
-#ifdef USING_LAPACK_MKL
-    mkl_set_num_threads(old_threads);
-#endif
 
 }
 
@@ -923,7 +893,7 @@ void* cc3_sigma_RHF_ic_thread(void* thread_data_in)
     free(Wa);
     free(Va);
 
-    pthread_exit(NULL);
+    return NULL;
 }
 
 }
@@ -32,7 +32,9 @@
 */
 #include <cstdio>
 #include <cmath>
+#include <thread>
 #include "psi4/libqt/qt.h"
+#include "psi4/libqt/profile.h"
 #include "psi4/libpsio/psio.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -69,6 +71,9 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z,
     double byte_conv;
 #endif
 
+    static const int profile_id = Profile::id("DPD contract444");
+    Profile::Scope profile(profile_id);
+
     nirreps = X->params->nirreps;
     GX = X->file.my_irrep;
     GY = Y->file.my_irrep;
@@ -103,13 +108,18 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z,
         else if (( Xtrans)&&(!Ytrans))  {Hy = Hx;       Hz = Hx^GX; }
         else /* (( Xtrans)&&( Ytrans))*/{Hy = Hx^GY;    Hz = Hx^GX; }
 
+        /* Operands resident in the file4 cache are used in place and
+           need no new memory */
         size_Y = ((long) Y->params->rowtot[Hy]) * ((long) Y->params->coltot[Hy^GY]);
         size_Z = ((long) Z->params->rowtot[Hz]) * ((long) Z->params->coltot[Hz^GZ]);
+        if(buf4_shares_cache(Y)) size_Y = 0;
+        if(buf4_shares_cache(Z)) size_Z = 0;
         size_file_X_row = ((long) X->file.params->coltot[0]); /* need room for a row of the X->file */
 
         memoryd = dpd_memfree() - (size_Y + size_Z + size_file_X_row);
 
-        if(X->params->rowtot[Hx] && X->params->coltot[Hx^GX]) {
+        if(buf4_shares_cache(X)) incore = 1;
+        else if(X->params->rowtot[Hx] && X->params->coltot[Hx^GX]) {
 
             if(X->params->coltot[Hx^GX])
                 rows_per_bucket = memoryd/X->params->coltot[Hx^GX];
@@ -191,27 +201,53 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z,
                 dpd_error("contract444", "outfile");
             }
 
+            /* Double-buffer the row blocks of X when two of them fit: the
+               next block is read on a helper thread while the current one
+               is multiplied.  Only the helper touches the DPD files and
+               cache during the overlap; the main thread just runs DGEMM. */
+            long int rows_per_half = memoryd/(2*X->params->coltot[Hx^GX]);
+            int prefetch = (rows_per_half > 0);
+            if(prefetch) {
+                rows_per_bucket = rows_per_half;
+                nbuckets = (int) ceil((double) X->params->rowtot[Hx]/
+                                      (double) rows_per_bucket);
+            }
+            rows_left = X->params->rowtot[Hx] - (nbuckets-1)*rows_per_bucket;
+
             buf4_mat_irrep_init_block(X, Hx, rows_per_bucket);
+            double **spare_block = nullptr;
+            if(prefetch) spare_block = dpd_block_matrix(rows_per_bucket, X->params->coltot[Hx^GX]);
 
             buf4_mat_irrep_init(Y, Hy);
             buf4_mat_irrep_rd(Y, Hy);
             buf4_mat_irrep_init(Z, Hz);
             if(std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
 
+            buf4_mat_irrep_rd_block(X, Hx, 0, (nbuckets > 1) ? rows_per_bucket : rows_left);
+
             for(n=0; n < nbuckets; n++) {
 
-                if(n < (nbuckets-1))
-                    buf4_mat_irrep_rd_block(X, Hx, n*rows_per_bucket, rows_per_bucket);
-                else
-                    buf4_mat_irrep_rd_block(X, Hx, n*rows_per_bucket, rows_left);
+                double **X_block = X->matrix[Hx];
+                int bucket_rows = n < (nbuckets-1) ? rows_per_bucket : rows_left;
+
+                /* Start reading the next bucket into the spare buffer */
+                std::thread reader;
+                if(n < (nbuckets-1)) {
+                    int next_start = (n+1)*rows_per_bucket;
+                    int next_rows = (n+1) < (nbuckets-1) ? rows_per_bucket : rows_left;
+                    if(prefetch) {
+                        X->matrix[Hx] = spare_block;
+                        reader = std::thread([=]() { buf4_mat_irrep_rd_block(X, Hx, next_start, next_rows); });
+                    }
+                }
 
                 if(!Xtrans && Ytrans) {
-                    nrows = n < (nbuckets-1) ? rows_per_bucket : rows_left;
+                    nrows = bucket_rows;
                     ncols = Z->params->coltot[Hz^GZ];
                     nlinks = numlinks[Hx^symlink];
                     if(nrows && ncols && nlinks)
                         C_DGEMM('n', 't', nrows, ncols, nlinks,
-                                alpha, &(X->matrix[Hx][0][0]), numlinks[Hx^symlink],
+                                alpha, &(X_block[0][0]), numlinks[Hx^symlink],
                                 &(Y->matrix[Hy][0][0]), numlinks[Hx^symlink], beta,
                                 &(Z->matrix[Hz][n*rows_per_bucket][0]), Z->params->coltot[Hz^GZ]);
                 }
@@ -222,15 +258,25 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z,
           thereafter. */
                     nrows = Z->params->rowtot[Hz];
                     ncols = Z->params->coltot[Hz^GZ];
-                    nlinks = n < (nbuckets-1) ? rows_per_bucket : rows_left;
+                    nlinks = bucket_rows;
                     if(nrows && ncols && nlinks)
                         C_DGEMM('t', 'n', nrows, ncols, nlinks,
-                                alpha, &(X->matrix[Hx][0][0]), X->params->coltot[Hx^GX],
+                                alpha, &(X_block[0][0]), X->params->coltot[Hx^GX],
                                 &(Y->matrix[Hy][n*rows_per_bucket][0]), Y->params->coltot[Hy^GY],
                                 (n==0 ? beta : 1.0), &(Z->matrix[Hz][0][0]), Z->params->coltot[Hz^GZ]);
                 }
+
+                if(reader.joinable()) {
+                    reader.join();
+                    spare_block = X_block;
+                }
+                else if(n < (nbuckets-1)) {
+                    int next_rows = (n+1) < (nbuckets-1) ? rows_per_bucket : rows_left;
+                    buf4_mat_irrep_rd_block(X, Hx, (n+1)*rows_per_bucket, next_rows);
+                }
             }
 
+            if(prefetch) free_dpd_block(spare_block, rows_per_bucket, X->params->coltot[Hx^GX]);
             buf4_mat_irrep_close_block(X, Hx, rows_per_bucket);
 
             buf4_mat_irrep_close(Y, Hy);
@@ -43,6 +43,8 @@
  #include <memory>
  PRAGMA_WARNING_POP
 #include <vector>
+#include <map>
+#include <thread>
 #include "psi4/psi4-dec.h"
 
 // Testing -TDC
@@ -167,6 +169,19 @@ struct dpd_file4_cache_entry {
     dpd_file4_cache_entry *last; /* pointer to previous cache entry */
 };
 
+/* DPD File4 Cache history, kept across evictions for the adaptive cache */
+struct dpd_file4_cache_stat {
+    dpd_file4_cache_stat():
+        size(0), usage(0), loads(0), cost(0.0), pinned(0)
+    {
+    }
+    int size;                           /* size of entry in double words */
+    size_t usage;                       /* number of file4_init() calls */
+    size_t loads;                       /* number of reads from disk */
+    double cost;                        /* total seconds spent in those reads */
+    int pinned;                         /* exempt from adaptive eviction? */
+};
+
 /* DPD File2 Cache entries */
 struct dpd_file2_cache_entry {
     dpd_file2_cache_entry():
@@ -228,7 +243,15 @@ struct dpd_gbl {
         file4_cache_most_recent(0),
         file4_cache_least_recent(1),
         file4_cache_lru_del(0),
-        file4_cache_low_del(0)
+        file4_cache_low_del(0),
+        file4_cache_adapt_del(0),
+        file4_cache_hits(0),
+        file4_cache_misses(0),
+        file4_cache_reloads(0),
+        file4_cache_bytes_read(0),
+        file4_cache_bytes_reloaded(0),
+        file4_cache_read_time(0.0),
+        file4_cache_pinned(0)
     {}
     dpd_file2_cache_entry *file2_cache;
     dpd_file4_cache_entry *file4_cache;
@@ -236,7 +259,16 @@ struct dpd_gbl {
     size_t file4_cache_least_recent;
     size_t file4_cache_lru_del;
     size_t file4_cache_low_del;
-    int cachetype;
+    size_t file4_cache_adapt_del;
+    size_t file4_cache_hits;
+    size_t file4_cache_misses;
+    size_t file4_cache_reloads;
+    size_t file4_cache_bytes_read;
+    size_t file4_cache_bytes_reloaded;
+    double file4_cache_read_time;
+    int file4_cache_pinned;  /* has file4_cache_adapt() chosen the pinned set? */
+    std::map<std::string, dpd_file4_cache_stat> file4_cache_stats;
+    int cachetype;          /* 0 = LRU, 1 = priority (LOW), 2 = adaptive */
     int *cachefiles;
     int **cachelist;
     dpd_file4_cache_entry *file4_cache_priority;
@@ -339,6 +371,8 @@ public:
                    double alpha, int transA);
     int file2_axpbycz(dpdfile2 *FileA, dpdfile2 *FileB, dpdfile2 *FileC,
                       double a, double b, double c);
+    int file2_save(dpdfile2 *File, FILE *fp);
+    int file2_load(dpdfile2 *File, FILE *fp);
 
 
     int file4_init(dpdfile4 *File, int filenum, int irrep, int pqnum,
@@ -360,6 +394,8 @@ public:
                                  int num_pq);
     int file4_mat_irrep_wrt_block(dpdfile4 *File, int irrep, int start_pq,
                                   int num_pq);
+    int file4_save(dpdfile4 *File, FILE *fp);
+    int file4_load(dpdfile4 *File, FILE *fp);
 
     int buf4_init(dpdbuf4 *Buf, int inputfile, int irrep, int pqnum, int rsnum,
                   int file_pqnum, int file_rsnum, int anti, const char *label);
@@ -370,6 +406,7 @@ public:
     double buf4_trace(dpdbuf4 *Buf);
     int buf4_close(dpdbuf4 *Buf);
     int buf4_mat_irrep_init(dpdbuf4 *Buf, int irrep);
+    int buf4_shares_cache(dpdbuf4 *Buf);
     int buf4_mat_irrep_close(dpdbuf4 *Buf, int irrep);
     int buf4_mat_irrep_rd(dpdbuf4 *Buf, int irrep);
     int buf4_mat_irrep_wrt(dpdbuf4 *Buf, int irrep);
@@ -381,6 +418,7 @@ public:
                     std::string pq, std::string rs, const char *label);
     int buf4_sort_ooc(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                       int pqnum, int rsnum, const char *label);
+    int buf4_sort_bucket(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index);
     int buf4_sort_axpy(dpdbuf4 *InBuf, int outfilenum, enum indices index,
                        int pqnum, int rsnum, const char *label, double alpha);
     int buf4_axpy(dpdbuf4 *BufX, dpdbuf4 *BufY, double alpha);
@@ -444,6 +482,11 @@ public:
     int file4_cache_del(dpdfile4 *File);
     dpd_file4_cache_entry* file4_cache_find_lru(void);
     int file4_cache_del_lru(void);
+    dpd_file4_cache_entry* file4_cache_find_adaptive(void);
+    int file4_cache_del_adaptive(void);
+    dpd_file4_cache_stat* file4_cache_stat(int filenum, int irrep, int pqnum, int rsnum, const char *label, int dpdnum);
+    void file4_cache_adapt(void);
+    void file4_cache_print_stats(std::string out_fname);
     void file4_cache_dirty(dpdfile4 *File);
     void file4_cache_lock(dpdfile4 *File);
     void file4_cache_unlock(dpdfile4 *File);
@@ -534,6 +577,60 @@ extern int dpd_close(int dpd_num);
 extern long int dpd_memfree(void);
 extern void dpd_memset(long int memory);
 
+/*! \ingroup DPD
+ *  Row tiles of one irrep block of a dpdbuf4, for blocks that do not fit in core:
+ *
+ *      Buf4Tiles tiles(&W, h, dpd_memfree(), true, true);
+ *      while(tiles.next())
+ *          C_DGEMM(..., tiles.nrows(), ..., tiles.block()[0], ...);
+ *
+ *  Each tile is read before next() returns it (or zeroed, without \a read) and, with
+ *  \a write, written back once the caller moves on.  When the budget holds two tiles, the
+ *  next one is read, and the last one written, on a helper thread while the caller works on
+ *  the current one.  Only the helper may touch the DPD files and cache meanwhile, so between
+ *  next() calls the caller must work on block() alone, without DPD or PSIO calls of its own;
+ *  otherwise pass \a prefetch = false.  Buffers go through global_dpd_.
+ */
+class Buf4Tiles {
+  public:
+    Buf4Tiles(dpdbuf4 *Buf, int irrep, long int memoryd, bool read = true, bool write = false,
+              bool prefetch = true);
+    ~Buf4Tiles();
+
+    /// Moves on to the next tile, false once all rows have been seen
+    bool next();
+
+    /// First row of the current tile
+    int start() const { return start_; }
+    /// Rows in the current tile
+    int nrows() const { return nrows_; }
+    /// Rows in a full tile
+    int maxrows() const { return maxrows_; }
+    /// The current tile, nrows() x coltot
+    double **block() const { return current_; }
+
+  private:
+    dpdbuf4 *Buf_;
+    int irrep_;
+    int rowtot_;
+    int coltot_;
+    int maxrows_;
+    bool read_;
+    bool write_;
+    int start_;
+    int nrows_;
+    bool stored_;
+    double **current_;
+    double **spare_;
+    std::thread helper_;
+
+    void load(double **block, int start, int nrows);
+    void store(double **block, int start, int nrows);
+};
+
+/* Timing of contract444() on a C1 o^2v^2 ladder contraction */
+std::map<std::string, double> benchmark_contract444(int nocc, int nvir, double min_time);
+
 
 }// Namespace psi
 
@@ -0,0 +1,107 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*! \file
+    \ingroup DPD
+    \brief Enter brief description of file here
+*/
+#include <cstdio>
+#include <cstring>
+#include "dpd.h"
+
+namespace psi {
+
+/* file2_save(): Appends a dpdfile2 to an open stdio stream, as its label,
+** irrep structure and then the data of each irrep block.  Used for
+** amplitude checkpoints that have to outlive the PSIO scratch files.
+**
+** Returns 0 on success, 1 if the stream could not be written.
+*/
+
+int DPD::file2_save(dpdfile2 *File, FILE *fp)
+{
+    int h, nirreps, my_irrep, dims[2];
+    int fail = 0;
+
+    nirreps = File->params->nirreps;
+    my_irrep = File->my_irrep;
+
+    fail |= (fwrite(File->label, 1, PSIO_KEYLEN, fp) != PSIO_KEYLEN);
+    fail |= (fwrite(&nirreps, sizeof(int), 1, fp) != 1);
+    fail |= (fwrite(&my_irrep, sizeof(int), 1, fp) != 1);
+    for(h=0; h < nirreps; h++) {
+        dims[0] = File->params->rowtot[h];
+        dims[1] = File->params->coltot[h^my_irrep];
+        fail |= (fwrite(dims, sizeof(int), 2, fp) != 2);
+    }
+
+    file2_mat_init(File);
+    file2_mat_rd(File);
+    for(h=0; h < nirreps; h++) {
+        size_t size = (size_t) File->params->rowtot[h] * File->params->coltot[h^my_irrep];
+        if(size) fail |= (fwrite(File->matrix[h][0], sizeof(double), size, fp) != size);
+    }
+    file2_mat_close(File);
+
+    return fail;
+}
+
+/* file2_load(): Reads back a dpdfile2 written by file2_save() and
+** overwrites File with it.  File is left untouched if the label or the
+** irrep structure on the stream does not match it.
+**
+** Returns 0 on success, 1 on a mismatch or a short read.
+*/
+
+int DPD::file2_load(dpdfile2 *File, FILE *fp)
+{
+    int h, nirreps, my_irrep, dims[2];
+    char label[PSIO_KEYLEN];
+
+    if(fread(label, 1, PSIO_KEYLEN, fp) != PSIO_KEYLEN) return 1;
+    if(fread(&nirreps, sizeof(int), 1, fp) != 1) return 1;
+    if(fread(&my_irrep, sizeof(int), 1, fp) != 1) return 1;
+    label[PSIO_KEYLEN-1] = '\0';
+    if(strcmp(label, File->label) || nirreps != File->params->nirreps || my_irrep != File->my_irrep) return 1;
+    for(h=0; h < nirreps; h++) {
+        if(fread(dims, sizeof(int), 2, fp) != 2) return 1;
+        if(dims[0] != File->params->rowtot[h] || dims[1] != File->params->coltot[h^my_irrep]) return 1;
+    }
+
+    int fail = 0;
+    file2_mat_init(File);
+    for(h=0; h < nirreps; h++) {
+        size_t size = (size_t) File->params->rowtot[h] * File->params->coltot[h^my_irrep];
+        if(size) fail |= (fread(File->matrix[h][0], sizeof(double), size, fp) != size);
+    }
+    if(!fail) file2_mat_wrt(File);
+    file2_mat_close(File);
+
+    return fail;
+}
+
+}
@@ -33,6 +33,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
+#include <algorithm>
+#include <vector>
 #include "psi4/libqt/qt.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -45,6 +48,15 @@ void DPD::file4_cache_init(void)
     dpd_main.file4_cache_least_recent = 1;
     dpd_main.file4_cache_lru_del = 0;
     dpd_main.file4_cache_low_del = 0;
+    dpd_main.file4_cache_adapt_del = 0;
+    dpd_main.file4_cache_hits = 0;
+    dpd_main.file4_cache_misses = 0;
+    dpd_main.file4_cache_reloads = 0;
+    dpd_main.file4_cache_bytes_read = 0;
+    dpd_main.file4_cache_bytes_reloaded = 0;
+    dpd_main.file4_cache_read_time = 0.0;
+    dpd_main.file4_cache_pinned = 0;
+    dpd_main.file4_cache_stats.clear();
 }
 
 void DPD::file4_cache_close(void)
@@ -63,7 +75,7 @@ void DPD::file4_cache_close(void)
         dpd_set_default(this_entry->dpdnum);
 
         /* Clean out each file4_cache entry */
-        file4_init(&Outfile, this_entry->filenum, this_entry->irrep,
+        file4_init_nocache(&Outfile, this_entry->filenum, this_entry->irrep,
                    this_entry->pqnum, this_entry->rsnum, this_entry->label);
 
         next_entry = this_entry->next;
@@ -163,6 +175,7 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority)
         dpd_set_default(File->dpdnum);
 
         /* Read all data into core */
+        auto start = std::chrono::steady_clock::now();
         this_entry->size = 0;
         for(h=0; h < File->params->nirreps; h++) {
             this_entry->size +=
@@ -170,6 +183,23 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority)
             file4_mat_irrep_init(File, h);
             file4_mat_irrep_rd(File, h);
         }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        /* Record the real cost of this read for the statistics and the adaptive policy */
+        dpd_file4_cache_stat *stat = file4_cache_stat(File->filenum, File->my_irrep,
+                                                      File->params->pqnum, File->params->rsnum,
+                                                      File->label, File->dpdnum);
+        size_t bytes = ((size_t) this_entry->size) * sizeof(double);
+        if(stat->loads) {
+            dpd_main.file4_cache_reloads++;
+            dpd_main.file4_cache_bytes_reloaded += bytes;
+        }
+        stat->size = this_entry->size;
+        stat->loads++;
+        stat->cost += seconds;
+        dpd_main.file4_cache_misses++;
+        dpd_main.file4_cache_bytes_read += bytes;
+        dpd_main.file4_cache_read_time += seconds;
 
         this_entry->dpdnum = File->dpdnum;
         this_entry->filenum = File->filenum;
@@ -296,8 +326,8 @@ void DPD::file4_cache_print_screen(void)
     outfile->Printf( "Total cached: %9.1f kB; MRU = %6d; LRU = %6d\n",
             (total_size*sizeof(double))/1e3,dpd_main.file4_cache_most_recent,
             dpd_main.file4_cache_least_recent);
-    outfile->Printf( "#LRU deletions = %6d; #Low-priority deletions = %6d\n",
-            dpd_main.file4_cache_lru_del,dpd_main.file4_cache_low_del);
+    outfile->Printf( "#LRU deletions = %6d; #Low-priority deletions = %6d; #Adaptive deletions = %6d\n",
+            dpd_main.file4_cache_lru_del,dpd_main.file4_cache_low_del,dpd_main.file4_cache_adapt_del);
     outfile->Printf( "Core max size:  %9.1f kB\n", (dpd_main.memory)*sizeof(double)/1e3);
     outfile->Printf( "Core used:      %9.1f kB\n", (dpd_main.memused)*sizeof(double)/1e3);
     outfile->Printf( "Core available: %9.1f kB\n", dpd_memfree()*sizeof(double)/1e3);
@@ -336,8 +366,8 @@ void DPD::file4_cache_print(std::string out)
     printer->Printf( "Total cached: %8.1f kB; MRU = %6d; LRU = %6d\n",
             (total_size*sizeof(double))/1e3,dpd_main.file4_cache_most_recent,
             dpd_main.file4_cache_least_recent);
-    printer->Printf( "#LRU deletions = %6d; #Low-priority deletions = %6d\n",
-            dpd_main.file4_cache_lru_del,dpd_main.file4_cache_low_del);
+    printer->Printf( "#LRU deletions = %6d; #Low-priority deletions = %6d; #Adaptive deletions = %6d\n",
+            dpd_main.file4_cache_lru_del,dpd_main.file4_cache_low_del,dpd_main.file4_cache_adapt_del);
     printer->Printf( "Core max size:  %9.1f kB\n", (dpd_main.memory)*sizeof(double)/1e3);
     printer->Printf( "Core used:      %9.1f kB\n", (dpd_main.memused)*sizeof(double)/1e3);
     printer->Printf( "Core available: %9.1f kB\n", dpd_memfree()*sizeof(double)/1e3);
@@ -414,7 +444,7 @@ int DPD::file4_cache_del_lru(void)
         dpdnum = dpd_default;
         dpd_set_default(this_entry->dpdnum);
 
-        file4_init(&File, this_entry->filenum, this_entry->irrep,
+        file4_init_nocache(&File, this_entry->filenum, this_entry->irrep,
                    this_entry->pqnum, this_entry->rsnum, this_entry->label);
 
         file4_cache_del(&File);
@@ -529,7 +559,7 @@ int DPD::file4_cache_del_low(void)
 
         dpd_set_default(this_entry->dpdnum);
 
-        file4_init(&File, this_entry->filenum, this_entry->irrep,
+        file4_init_nocache(&File, this_entry->filenum, this_entry->irrep,
                    this_entry->pqnum, this_entry->rsnum, this_entry->label);
         file4_cache_del(&File);
         file4_close(&File);
@@ -545,6 +575,154 @@ int DPD::file4_cache_del_low(void)
     }
 }
 
+dpd_file4_cache_stat*
+DPD::file4_cache_stat(int filenum, int irrep, int pqnum, int rsnum, const char *label, int dpdnum)
+{
+    char key[PSIO_KEYLEN+64];
+
+    sprintf(key, "%d:%d:%d:%d:%d:%s", dpdnum, filenum, irrep, pqnum, rsnum, label);
+
+    return &(dpd_main.file4_cache_stats[key]);
+}
+
+/* The adaptive score of a file4 is the disk time it is expected to cost,
+** per double word held in core, if it is evicted: its measured average
+** read time weighted by how often it has been requested.  Entries that
+** are cheap to reload or rarely used go first. */
+static double file4_cache_score(const dpd_file4_cache_stat *stat)
+{
+    if(!stat->loads || !stat->size) return 0.0;
+    return (stat->usage * (stat->cost / stat->loads)) / stat->size;
+}
+
+dpd_file4_cache_entry*
+DPD::file4_cache_find_adaptive(void)
+{
+    dpd_file4_cache_entry *this_entry, *low_entry;
+    double score, low_score = 0.0;
+    int low_pinned = 0, pinned;
+
+    low_entry = NULL;
+    for(this_entry = dpd_main.file4_cache; this_entry != NULL; this_entry = this_entry->next) {
+        if(this_entry->lock) continue;
+
+        dpd_file4_cache_stat *stat = file4_cache_stat(this_entry->filenum, this_entry->irrep,
+                                                      this_entry->pqnum, this_entry->rsnum,
+                                                      this_entry->label, this_entry->dpdnum);
+        score = file4_cache_score(stat);
+        pinned = stat->pinned;
+
+        /* Pinned entries are only given up when nothing else is left */
+        if(low_entry == NULL || (low_pinned && !pinned) ||
+                (low_pinned == pinned && score < low_score)) {
+            low_entry = this_entry;
+            low_score = score;
+            low_pinned = pinned;
+        }
+    }
+
+    return low_entry;
+}
+
+int DPD::file4_cache_del_adaptive(void)
+{
+    int dpdnum;
+    dpdfile4 File;
+    dpd_file4_cache_entry *this_entry;
+
+#ifdef DPD_TIMER
+    timer_on("cache_adapt");
+#endif
+
+    this_entry = file4_cache_find_adaptive();
+
+    if(this_entry == NULL) {
+#ifdef DPD_TIMER
+        timer_off("cache_adapt");
+#endif
+        return 1; /* there is no cache or everything is locked */
+    }
+
+    /* increment the global adaptive deletion counter */
+    dpd_main.file4_cache_adapt_del++;
+
+    dpdnum = dpd_default;
+    dpd_set_default(this_entry->dpdnum);
+
+    file4_init_nocache(&File, this_entry->filenum, this_entry->irrep,
+                       this_entry->pqnum, this_entry->rsnum, this_entry->label);
+    file4_cache_del(&File);
+    file4_close(&File);
+
+    dpd_set_default(dpdnum);
+
+#ifdef DPD_TIMER
+    timer_off("cache_adapt");
+#endif
+
+    return 0;
+}
+
+/* file4_cache_adapt(): Chooses the file4s to pin in the cache from the
+** usage and read times observed so far, e.g., after the first iterations
+** of a CC calculation.  Entries are ranked by their adaptive score and
+** pinned greedily until half of the DPD memory is committed; the other
+** half is left for the scratch arrays of the contractions.  Only file4s
+** that were requested more than once are considered.  Pinned entries
+** are evicted only when no unpinned entry is left.  Does nothing unless
+** the cache type is adaptive.
+*/
+void DPD::file4_cache_adapt(void)
+{
+    if(dpd_main.cachetype != 2) return;
+
+    std::vector<std::pair<double, dpd_file4_cache_stat *> > ranked;
+    for(auto &it : dpd_main.file4_cache_stats) {
+        it.second.pinned = 0;
+        if(it.second.usage > 1 && it.second.loads)
+            ranked.push_back(std::make_pair(file4_cache_score(&it.second), &it.second));
+    }
+    std::sort(ranked.begin(), ranked.end(),
+              [](const std::pair<double, dpd_file4_cache_stat *> &a,
+                 const std::pair<double, dpd_file4_cache_stat *> &b) { return a.first > b.first; });
+
+    long int budget = dpd_main.memory/2;
+    long int pinned_size = 0;
+    int npinned = 0;
+    for(size_t i=0; i < ranked.size(); i++) {
+        if(pinned_size + ranked[i].second->size > budget) continue;
+        ranked[i].second->pinned = 1;
+        pinned_size += ranked[i].second->size;
+        npinned++;
+    }
+
+    dpd_main.file4_cache_pinned = 1;
+
+    outfile->Printf("\n    DPD adaptive cache: pinned %d of %zu file4s (%.1f of %.1f MB)\n",
+                    npinned, dpd_main.file4_cache_stats.size(),
+                    pinned_size*sizeof(double)/1e6, budget*sizeof(double)/1e6);
+}
+
+void DPD::file4_cache_print_stats(std::string out)
+{
+    std::shared_ptr<psi::PsiOutStream> printer=(out=="outfile"?outfile:
+             std::shared_ptr<PsiOutStream>(new PsiOutStream(out)));
+    size_t requests = dpd_main.file4_cache_hits + dpd_main.file4_cache_misses;
+
+    printer->Printf("\n    DPD File4 Cache Statistics:\n");
+    printer->Printf("    Hits            = %12zu\n", dpd_main.file4_cache_hits);
+    printer->Printf("    Misses          = %12zu\n", dpd_main.file4_cache_misses);
+    printer->Printf("    Hit ratio       = %12.3f\n",
+                    requests ? (double) dpd_main.file4_cache_hits/requests : 0.0);
+    printer->Printf("    Reloads         = %12zu\n", dpd_main.file4_cache_reloads);
+    printer->Printf("    Read (MB)       = %12.1f\n", dpd_main.file4_cache_bytes_read/1e6);
+    printer->Printf("    Reloaded (MB)   = %12.1f\n", dpd_main.file4_cache_bytes_reloaded/1e6);
+    printer->Printf("    Read time (s)   = %12.2f\n", dpd_main.file4_cache_read_time);
+    printer->Printf("    Deletions       = %12zu (LRU) %zu (LOW) %zu (ADAPTIVE)\n",
+                    dpd_main.file4_cache_lru_del, dpd_main.file4_cache_low_del,
+                    dpd_main.file4_cache_adapt_del);
+}
+
 void DPD::file4_cache_lock(dpdfile4 *File)
 {
     int h;
@@ -111,6 +111,10 @@ int DPD::file4_init(dpdfile4 *File, int filenum, int irrep, int pqnum,
     /* Put this file4 into cache if requested */
     if(dpd_main.cachefiles[filenum] && dpd_main.cachelist[pqnum][rsnum])
     {
+        /* Bookkeeping for the cache statistics and the adaptive policy */
+        file4_cache_stat(filenum, irrep, pqnum, rsnum, label, dpd_default)->usage++;
+        if(File->incore) dpd_main.file4_cache_hits++;
+
         /* Get the file4's cache priority */
         if(dpd_main.cachetype == 1)
             priority = file4_cache_get_priority(File);
@@ -43,7 +43,11 @@
 #include <efp.h>
 #endif
 
+#include <algorithm>
 #include <regex>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 std::regex efpAtomSymbol("A\\d*([A-Z]{1,2})\\d*", std::regex_constants::icase);
 std::smatch reMatches;
@@ -201,6 +205,9 @@ void EFP::finalize_fragments()
     if ((res = efp_prepare(efp_)))
         throw PsiException("EFP::finalize_fragments() " +
             std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+
+    // A new set of fragments can sit where the old one did
+    fixed_key_.clear();
 }
 
 /*
@@ -339,35 +346,48 @@ efp_result electron_density_field_fn(size_t n_pt, const double *xyz, double *fie
     std::shared_ptr<Wavefunction> wfn = Process::environment.legacy_wavefunction();
     std::shared_ptr<Molecule> mol = wfn->molecule();
     std::shared_ptr<BasisSet> basis = wfn->basisset();
-    std::shared_ptr<OneBodyAOInt> field_ints(wfn->integral()->electric_field());
-
     int nbf = basis->nbf();
-    std::vector<SharedMatrix> intmats;
-    intmats.push_back(SharedMatrix(new Matrix("Ex integrals", nbf, nbf)));
-    intmats.push_back(SharedMatrix(new Matrix("Ey integrals", nbf, nbf)));
-    intmats.push_back(SharedMatrix(new Matrix("Ez integrals", nbf, nbf)));
+
+    // One set of integrals per thread, each taking whole points
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::vector<std::shared_ptr<OneBodyAOInt> > field_ints;
+    std::vector<std::vector<SharedMatrix> > intmats(nthread);
+    for (int t = 0; t < nthread; ++t) {
+        field_ints.push_back(std::shared_ptr<OneBodyAOInt>(wfn->integral()->electric_field()));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ex integrals", nbf, nbf)));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ey integrals", nbf, nbf)));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ez integrals", nbf, nbf)));
+    }
 
     SharedMatrix Da = wfn->Da();
     SharedMatrix Db;
     if (!wfn->same_a_b_orbs())
         Db = wfn->Db();
 
-    for (size_t n=0; n<n_pt; ++n) {
-        field_ints->set_origin(Vector3(xyz[3*n], xyz[3*n+1], xyz[3*n+2]));
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int n=0; n<(long int)n_pt; ++n) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        field_ints[thread]->set_origin(Vector3(xyz[3*n], xyz[3*n+1], xyz[3*n+2]));
         for (int m=0; m<3; ++m)
-            intmats[m]->zero();
-        field_ints->compute(intmats);
-        double Ex = Da->vector_dot(intmats[0]);
-        double Ey = Da->vector_dot(intmats[1]);
-        double Ez = Da->vector_dot(intmats[2]);
+            intmats[thread][m]->zero();
+        field_ints[thread]->compute(intmats[thread]);
+        double Ex = Da->vector_dot(intmats[thread][0]);
+        double Ey = Da->vector_dot(intmats[thread][1]);
+        double Ez = Da->vector_dot(intmats[thread][2]);
         if (wfn->same_a_b_dens()) {
             Ex *= 2.0;
             Ey *= 2.0;
             Ez *= 2.0;
         } else {
-            Ex += Db->vector_dot(intmats[0]);
-            Ey += Db->vector_dot(intmats[1]);
-            Ez += Db->vector_dot(intmats[2]);
+            Ex += Db->vector_dot(intmats[thread][0]);
+            Ey += Db->vector_dot(intmats[thread][1]);
+            Ez += Db->vector_dot(intmats[thread][2]);
         }
         field[3*n]   = Ex;
         field[3*n+1] = Ey;
@@ -511,7 +531,6 @@ std::shared_ptr<Matrix> EFP::modify_Fock_permanent()
 
     // Scale multipole integrals by multipole magnitudes.  The result goes into V
     std::shared_ptr<Wavefunction> wfn = Process::environment.legacy_wavefunction();
-    std::shared_ptr<OneBodyAOInt> efp_ints(wfn->integral()->ao_efp_multipole_potential());
 
                                // 0    X    Y    Z      XX       YY       ZZ       XY       XZ       YZ
     const double prefacs[20] = { 1.0, 1.0, 1.0, 1.0, 1.0/3.0, 1.0/3.0, 1.0/3.0, 2.0/3.0, 2.0/3.0, 2.0/3.0,
@@ -519,65 +538,80 @@ std::shared_ptr<Matrix> EFP::modify_Fock_permanent()
       1.0/15.0, 1.0/15.0, 1.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 3.0/15.0, 6.0/15.0};
 
     int nbf = wfn->basisset()->nbf();
-    std::vector<SharedMatrix> mats;
-    for(int i=0; i<20; ++i) {
-        mats.push_back(SharedMatrix(new Matrix(nbf, nbf)));
-    }
 
     // Cartesian basis one-electron EFP perturbation
     SharedMatrix V2(new Matrix("EFP permanent moment contribution to the Fock Matrix", nbf, nbf));
 
-    // multipole contributions to Fock matrix
-    double * xyz_p  = xyz->pointer();
-    double * mult_p = mult->pointer();
-
-    size_t max_natom = 0;
+    // Nuclear charges of all fragment atoms, sorted along x so that each
+    // multipole point finds the atoms it sits on without a full scan
+    std::vector<std::pair<double, std::pair<Vector3, double> > > nuclei;
     for (int frag = 0; frag < nfrag_; frag++) {
         size_t natom = 0;
         if ((res = efp_get_frag_atom_count(efp_,frag,&natom)))
             throw PsiException("EFP::modify_Fock_permanent():efp_get_frag_atom_count(): " +
                 std::string (efp_result_to_string(res)),__FILE__,__LINE__);
-        if ( natom > max_natom ) max_natom = natom;
+        std::vector<efp_atom> atoms(natom);
+        if ((res = efp_get_frag_atoms(efp_, frag, natom, atoms.data())))
+            throw PsiException("EFP::modify_Fock_permanent():efp_get_frag_atoms(): " +
+                std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+        for (size_t i=0; i<natom; i++)
+            nuclei.push_back(std::make_pair(atoms[i].x,
+                std::make_pair(Vector3(atoms[i].x, atoms[i].y, atoms[i].z), atoms[i].znuc)));
     }
-    efp_atom * atoms = (efp_atom*)malloc(max_natom*sizeof(efp_atom));
+    std::sort(nuclei.begin(), nuclei.end(),
+              [](const std::pair<double, std::pair<Vector3, double> >& a,
+                 const std::pair<double, std::pair<Vector3, double> >& b) { return a.first < b.first; });
 
+    double * xyz_p  = xyz->pointer();
+    double * mult_p = mult->pointer();
+
+    // add point charges from atoms to multipoles at atom center
     for (size_t n=0; n<n_multipole; n++) {
+        auto it = std::lower_bound(nuclei.begin(), nuclei.end(), xyz_p[n*3] - 1e-10,
+                                   [](const std::pair<double, std::pair<Vector3, double> >& a, double x) {
+                                       return a.first < x; });
+        for (; it != nuclei.end() && it->first <= xyz_p[n*3] + 1e-10; ++it) {
+            if ( std::fabs(it->second.first[1] - xyz_p[n*3+1]) > 1e-10 ) continue;
+            if ( std::fabs(it->second.first[2] - xyz_p[n*3+2]) > 1e-10 ) continue;
+            mult_p[20*n] += it->second.second;
+        }
+    }
+
+    // multipole contributions to Fock matrix, whole multipoles per thread
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::vector<std::shared_ptr<OneBodyAOInt> > efp_ints;
+    std::vector<std::vector<SharedMatrix> > mats(nthread);
+    std::vector<SharedMatrix> V2s;
+    for (int t = 0; t < nthread; ++t) {
+        efp_ints.push_back(std::shared_ptr<OneBodyAOInt>(wfn->integral()->ao_efp_multipole_potential()));
+        for(int i=0; i<20; ++i)
+            mats[t].push_back(SharedMatrix(new Matrix(nbf, nbf)));
+        V2s.push_back(SharedMatrix(new Matrix(nbf, nbf)));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int n=0; n<(long int)n_multipole; n++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
         for (int i=0; i<20; ++i) {
-           mats[i]->zero();
+           mats[thread][i]->zero();
         }
         Vector3 coords(xyz_p[n*3],xyz_p[n*3+1],xyz_p[n*3+2]);
-        efp_ints->set_origin(coords);
-        efp_ints->compute(mats);
-
-        // add point charges from atoms to multipoles at atom center
-        for (int frag=0; frag<nfrag_; frag++) {
-            size_t natom = 0;
-            if ((res = efp_get_frag_atom_count(efp_, frag, &natom)))
-                throw PsiException("EFP::modify_Fock_permanent():efp_get_frag_atom_count(): " +
-                    std::string (efp_result_to_string(res)),__FILE__,__LINE__);
-            if ((res = efp_get_frag_atoms(efp_, frag, natom, atoms)))
-                throw PsiException("EFP::modify_Fock_permanent():efp_get_frag_atoms(): " +
-                    std::string (efp_result_to_string(res)),__FILE__,__LINE__);
-
-            for (size_t i=0; i<natom; i++) {
-                double dx = atoms[i].x - xyz_p[n*3];
-                if ( std::fabs(dx) > 1e-10 ) continue;
-                double dy = atoms[i].y - xyz_p[n*3+1];
-                if ( std::fabs(dy) > 1e-10 ) continue;
-                double dz = atoms[i].z - xyz_p[n*3+2];
-                if ( std::fabs(dz) > 1e-10 ) continue;
-
-                mult_p[20*n] += atoms[i].znuc;
-                break;
-            }
-        }
+        efp_ints[thread]->set_origin(coords);
+        efp_ints[thread]->compute(mats[thread]);
 
         for (int i=0; i<20; ++i) {
-            mats[i]->scale( -prefacs[i] * mult_p[20*n+i] );
-            V2->add(mats[i]);
+            mats[thread][i]->scale( -prefacs[i] * mult_p[20*n+i] );
+            V2s[thread]->add(mats[thread][i]);
         }
     }
-    free(atoms);
+    for (int t = 0; t < nthread; ++t)
+        V2->add(V2s[t]);
 
     return V2;
 }
@@ -617,33 +651,48 @@ std::shared_ptr<Matrix> EFP::modify_Fock_induced()
 
     // scale field integrals by induced dipole magnitudes.  the result goes into V
     std::shared_ptr<Wavefunction> wfn = Process::environment.legacy_wavefunction();
-    std::shared_ptr<OneBodyAOInt> field_ints(wfn->integral()->electric_field());
 
     int nbf = wfn->basisset()->nbf();
-    std::vector<SharedMatrix> mats;
-    for (int i=0; i<3; ++i)
-        mats.push_back(SharedMatrix(new Matrix(nbf, nbf)));
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::vector<std::shared_ptr<OneBodyAOInt> > field_ints;
+    std::vector<std::vector<SharedMatrix> > mats(nthread);
+    std::vector<SharedMatrix> V2s;
+    for (int t = 0; t < nthread; ++t) {
+        field_ints.push_back(std::shared_ptr<OneBodyAOInt>(wfn->integral()->electric_field()));
+        for (int i=0; i<3; ++i)
+            mats[t].push_back(SharedMatrix(new Matrix(nbf, nbf)));
+        V2s.push_back(SharedMatrix(new Matrix(nbf, nbf)));
+    }
 
     // Cartesian basis one-electron EFP perturbation
     SharedMatrix V2(new Matrix("EFP induced dipole contribution to the Fock Matrix", nbf, nbf));
 
     // induced dipole contributions to Fock matrix
-    // multipole contributions to Fock matrix
     double *xyz_p  = xyz_id->pointer();
     double *mult_p = id->pointer();
-    for (size_t n=0; n<n_id; n++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int n=0; n<(long int)n_id; n++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
         for (int i=0; i<3; ++i) {
-           mats[i]->zero();
+           mats[thread][i]->zero();
         }
         Vector3 coords(xyz_p[n*3],xyz_p[n*3+1],xyz_p[n*3+2]);
-        field_ints->set_origin(coords);
-        field_ints->compute(mats);
+        field_ints[thread]->set_origin(coords);
+        field_ints[thread]->compute(mats[thread]);
         // only dealing with dipoles here:
         for (int i=0; i<3; ++i) {
-            mats[i]->scale(-mult_p[3*n+i]);
-            V2->add(mats[i]);
+            mats[thread][i]->scale(-mult_p[3*n+i]);
+            V2s[thread]->add(mats[thread][i]);
         }
     }
+    for (int t = 0; t < nthread; ++t)
+        V2->add(V2s[t]);
 
     return V2;
 }
@@ -666,24 +715,89 @@ double EFP::scf_energy_update()
 /*
  * Compute efp energy components and/or gradient
  */
+void EFP::compute_terms(unsigned terms, struct efp_energy *energy, SharedMatrix grad) {
+    enum efp_result res;
+    struct efp_opts opts;
+
+    memset(energy, 0, sizeof(struct efp_energy));
+    if (grad) grad->zero();
+    if (!terms) return;
+
+    if ((res = efp_get_opts(efp_, &opts)))
+        throw PsiException("EFP::compute_terms():efp_get_opts() " +
+            std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+    unsigned all_terms = opts.terms;
+    opts.terms = terms;
+    if ((res = efp_set_opts(efp_, &opts)))
+        throw PsiException("EFP::compute_terms():efp_set_opts() " +
+            std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+
+    res = efp_compute(efp_, grad ? 1 : 0);
+    if (!res) res = efp_get_energy(efp_, energy);
+    if (!res && grad) res = efp_get_gradient(efp_, grad->pointer()[0]);
+
+    // All terms have to be back on before anything goes wrong, the SCF relies on them
+    opts.terms = all_terms;
+    enum efp_result res_opts = efp_set_opts(efp_, &opts);
+    if (res)
+        throw PsiException("EFP::compute_terms():efp_compute() " +
+            std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+    if (res_opts)
+        throw PsiException("EFP::compute_terms():efp_set_opts() " +
+            std::string (efp_result_to_string(res_opts)),__FILE__,__LINE__);
+}
+
 void EFP::compute() {
     enum efp_result res;
     struct efp_energy energy;
+    struct efp_opts opts;
 
-    if ((res = efp_compute(efp_, do_grad_ ? 1 : 0)))
-        throw PsiException("EFP::compute():efp_compute() " +
+    if ((res = efp_get_opts(efp_, &opts)))
+        throw PsiException("EFP::compute():efp_get_opts() " +
             std::string (efp_result_to_string(res)),__FILE__,__LINE__);
 
-    if ((res = efp_get_energy(efp_, &energy)))
-        throw PsiException("EFP::compute():efp_get_energy(): " +
+    // EFP/EFP electrostatics, exchange, and dispersion do not see the QM
+    // density, so they are kept while the fragments stay where they are
+    unsigned fixed_terms = opts.terms & (EFP_TERM_ELEC | EFP_TERM_DISP | EFP_TERM_XR);
+    unsigned other_terms = opts.terms & ~fixed_terms;
+
+    std::vector<double> key(6 * nfrag_ + 1);
+    if ((res = efp_get_coordinates(efp_, key.data())))
+        throw PsiException("EFP::compute():efp_get_coordinates() " +
             std::string (efp_result_to_string(res)),__FILE__,__LINE__);
+    key[6 * nfrag_] = fixed_terms | (opts.elec_damp << 8) | (opts.disp_damp << 12) | (do_grad_ << 16);
+
+    SharedMatrix smgrad;
+    if (do_grad_) smgrad = SharedMatrix(new Matrix("EFP Gradient", nfrag_, 6));
+
+    if (!options_.get_bool("EFP_CACHE")) {
+        compute_terms(opts.terms, &energy, smgrad);
+    } else {
+        if (key != fixed_key_) {
+            struct efp_energy fixed;
+            fixed_grad_ = do_grad_ ? SharedMatrix(new Matrix("EFP/EFP Gradient", nfrag_, 6)) : SharedMatrix();
+            compute_terms(fixed_terms, &fixed, fixed_grad_);
+            fixed_energy_[0] = fixed.electrostatic;
+            fixed_energy_[1] = fixed.charge_penetration;
+            fixed_energy_[2] = fixed.dispersion;
+            fixed_energy_[3] = fixed.exchange_repulsion;
+            fixed_energy_[4] = fixed.total;
+            fixed_key_ = key;
+        } else {
+            outfile->Printf("  Reusing EFP/EFP electrostatics, exchange, and dispersion.\n");
+        }
+
+        compute_terms(other_terms, &energy, smgrad);
+        energy.electrostatic = fixed_energy_[0];
+        energy.charge_penetration = fixed_energy_[1];
+        energy.dispersion = fixed_energy_[2];
+        energy.exchange_repulsion = fixed_energy_[3];
+        energy.total += fixed_energy_[4];
+        if (do_grad_) smgrad->add(fixed_grad_);
+    }
 
     if (do_grad_) {
-        SharedMatrix smgrad(new Matrix("EFP Gradient", nfrag_, 6));
         double ** psmgrad = smgrad->pointer();
-        if ((res = efp_get_gradient(efp_, psmgrad[0])))
-            throw PsiException("EFP::compute():efp_get_gradient(): " +
-                std::string (efp_result_to_string(res)),__FILE__,__LINE__);
         smgrad->print_out();
 
         outfile->Printf("  ==> EFP Gradient <==\n\n");
@@ -38,6 +38,7 @@
 #include <vector>
 
 struct efp;
+struct efp_energy;
 
 namespace psi {
     class Options;
@@ -80,6 +81,16 @@ class EFP {
 
         /// If a gradient is available it will be here:
         SharedMatrix torque_;
+
+        /// Fragment coordinates and settings the EFP/EFP terms below belong to (EFP_CACHE)
+        std::vector<double> fixed_key_;
+        /// EFP/EFP electrostatics, charge penetration, dispersion, exchange, and their sum
+        double fixed_energy_[5];
+        /// Gradient of the EFP/EFP terms, if one was asked for
+        SharedMatrix fixed_grad_;
+
+        /// Run libefp for the given subset of the enabled terms only
+        void compute_terms(unsigned terms, struct efp_energy *energy, SharedMatrix grad);
 #endif
     public:
         /// Constructor
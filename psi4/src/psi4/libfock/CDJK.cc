@@ -38,6 +38,7 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/lib3index/cholesky.h"
+#include "psi4/lib3index/df_cache.h"
 #include "psi4/libpsi4util/process.h"
 
 #include "jk.h"
@@ -86,8 +87,19 @@ void CDJK::initialize_JK_core()
         return;
     }
 
+    /// An earlier CDJK (here or in another process, DF_INTS_SHM) may have left them
+    if (df_ints_io_ == "NONE") {
+        SharedMatrix cached = DFIntsCache::get_cholesky(primary_, cholesky_tolerance_);
+        if (cached && cached->coldim() == ntri) {
+            Qmn_ = cached;
+            ncholesky_ = cached->rowdim();
+            timer_off("CD: cholesky decomposition");
+            return;
+        }
+    }
+
     ///If user does not want to read from disk, recompute the cholesky integrals
-    std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(std::shared_ptr<TwoBodyAOInt>(integral->eri()),0.0,cholesky_tolerance_,memory_));
+    std::shared_ptr<CholeskyERI> Ch (new CholeskyERI(integral,0.0,cholesky_tolerance_,memory_));
     Ch->choleskify();
     ncholesky_  = Ch->Q();
     size_t three_memory = ncholesky_ * ntri;
@@ -127,6 +139,7 @@ void CDJK::initialize_JK_core()
         // Not sure if this should really be here.  It is here because Ugur uses this option to get the number of cholesky vectors.
         Process::environment.globals["NAUX (SCF)"] = ncholesky_;
     }
+    Qmn_ = DFIntsCache::set_cholesky(primary_, cholesky_tolerance_, Qmn_);
 }
 void CDJK::manage_JK_core()
 {
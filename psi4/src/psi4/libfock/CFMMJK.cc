@@ -0,0 +1,389 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+#include "jk.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/chargetree.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/vector3.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#include "psi4/libpsi4util/process.h"
+#endif
+
+namespace psi {
+
+namespace {
+
+/* x such that erfc(x) = eps, by bisection; 0 if eps >= 1 */
+double inverse_erfc(double eps)
+{
+    if (eps >= 1.0) return 0.0;
+    double lo = 0.0, hi = 27.0;
+    for (int iter = 0; iter < 64; iter++) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erfc(mid) > eps) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+}  // namespace
+
+CFMMJK::CFMMJK(std::shared_ptr<BasisSet> primary) :
+   DirectJK(primary)
+{
+    common_init();
+}
+CFMMJK::~CFMMJK()
+{
+}
+void CFMMJK::common_init()
+{
+    cfmm_order_ = 8;
+    cfmm_theta_ = 0.4;
+    cfmm_leaf_size_ = 32;
+}
+void CFMMJK::print_header() const
+{
+    if (print_) {
+        outfile->Printf( "  ==> CFMMJK: Continuous Fast Multipole J, Integral-Direct K <==\n\n");
+
+        outfile->Printf( "    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf( "    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf( "    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        if (do_wK_)
+            outfile->Printf( "    Omega:             %11.3E\n", omega_);
+        outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf( "    Multipole Order:   %11d\n", cfmm_order_);
+        outfile->Printf( "    Theta:             %11.3f\n", cfmm_theta_);
+        outfile->Printf( "    Leaf Size:         %11d\n", cfmm_leaf_size_);
+        if (do_K_ || do_wK_) {
+            outfile->Printf( "    Density Screening: %11s\n", (density_screening_ ? "Yes" : "No"));
+            outfile->Printf( "    Incremental Fock:  %11s\n", (incfock_ ? "Yes" : "No"));
+        }
+        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
+    }
+}
+void CFMMJK::preiterations()
+{
+    DirectJK::preiterations();
+
+    if (cfmm_order_ < 0)
+        throw PSIEXCEPTION("CFMMJK: the multipole order must be non-negative.");
+
+    // => Shell pair distributions <= //
+
+    // Each shell pair is centered on the product center of its most diffuse
+    // primitives.  A primitive product exp(-gamma |r - P|^2) overlaps a
+    // distant one by less than the cutoff beyond sqrt(2/gamma) erfc^-1(cutoff)
+    // of P, and the pair's extent is the largest such radius about the center.
+
+    pairs_ = sieve_->shell_pairs();
+    double erfc_cut = inverse_erfc(cutoff_);
+    centers_.resize(3L * pairs_.size());
+    extents_.resize(pairs_.size());
+    for (size_t index = 0; index < pairs_.size(); index++) {
+        const GaussianShell& s1 = primary_->shell(pairs_[index].first);
+        const GaussianShell& s2 = primary_->shell(pairs_[index].second);
+        const double* A = s1.center();
+        const double* B = s2.center();
+
+        double amin = s1.exp(0);
+        double bmin = s2.exp(0);
+        for (int p1 = 1; p1 < s1.nprimitive(); p1++) amin = std::min(amin, s1.exp(p1));
+        for (int p2 = 1; p2 < s2.nprimitive(); p2++) bmin = std::min(bmin, s2.exp(p2));
+        double* C = &centers_[3L * index];
+        for (int k = 0; k < 3; k++)
+            C[k] = (amin * A[k] + bmin * B[k]) / (amin + bmin);
+
+        double extent = 0.0;
+        for (int p1 = 0; p1 < s1.nprimitive(); p1++) {
+            for (int p2 = 0; p2 < s2.nprimitive(); p2++) {
+                double a = s1.exp(p1);
+                double b = s2.exp(p2);
+                double gamma = a + b;
+                double PC2 = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    double PC = (a * A[k] + b * B[k]) / gamma - C[k];
+                    PC2 += PC * PC;
+                }
+                extent = std::max(extent, std::sqrt(PC2) + std::sqrt(2.0 / gamma) * erfc_cut);
+            }
+        }
+        extents_[index] = extent;
+    }
+
+    tree_ = std::make_shared<ChargeMultipoleTree>(centers_, extents_, cfmm_order_, cfmm_leaf_size_);
+
+    if (print_ > 1) {
+        outfile->Printf("  ==> CFMMJK: Shell Pair Tree <==\n\n");
+        outfile->Printf("    Shell pairs:       %11zu\n", pairs_.size());
+        outfile->Printf("    Tree nodes:        %11zu\n\n", tree_->nnode());
+    }
+}
+void CFMMJK::postiterations()
+{
+    DirectJK::postiterations();
+    tree_.reset();
+    pairs_.clear();
+    centers_.clear();
+    extents_.clear();
+}
+void CFMMJK::compute_JK()
+{
+    // K and wK need every shell quartet anyway, DirectJK builds them
+    if (do_K_ || do_wK_) {
+        bool do_J = do_J_;
+        do_J_ = false;
+        DirectJK::compute_JK();
+        do_J_ = do_J;
+    }
+
+    if (do_J_) build_J(D_ao_, J_ao_);
+}
+void CFMMJK::pair_moments(size_t index, OneBodyAOInt* overlap, OneBodyAOInt* multipoles,
+                          std::vector<double>& Q) const
+{
+    int M = pairs_[index].first;
+    int N = pairs_[index].second;
+    size_t nMN = (size_t) primary_->shell(M).nfunction() * primary_->shell(N).nfunction();
+    int nterm = tree_->nterm();
+    Q.resize(nterm * nMN);
+
+    overlap->compute_shell(M, N);
+    const double* buffer = overlap->buffer();
+    std::copy(buffer, buffer + nMN, Q.begin());
+    if (nterm == 1) return;
+
+    // MultipoleInt leaves out the overlap, orders the components like the
+    // tree, and carries the electron's sign
+    const double* C = &centers_[3L * index];
+    multipoles->set_origin(Vector3(C[0], C[1], C[2]));
+    multipoles->compute_shell(M, N);
+    buffer = multipoles->buffer();
+    for (size_t i = 0; i < (nterm - 1) * nMN; i++)
+        Q[nMN + i] = -buffer[i];
+}
+void CFMMJK::build_J(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& J)
+{
+    for (size_t ind = 0; ind < J.size(); ind++) {
+        J[ind]->zero();
+    }
+
+    int nset = D.size();
+    int nterm = tree_->nterm();
+    size_t npair = pairs_.size();
+    int nthread = df_ints_num_threads_;
+
+    // => Per-thread integral objects <= //
+
+    std::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary_,primary_,primary_,primary_));
+    std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > overlap;
+    std::vector<std::shared_ptr<OneBodyAOInt> > multipoles;
+    ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    overlap.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_overlap()));
+    if (cfmm_order_ > 0)
+        multipoles.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_multipoles(cfmm_order_)));
+    for (int thread = 1; thread < nthread; thread++) {
+        if (ints[0]->cloneable())
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
+        else
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        overlap.push_back(std::shared_ptr<OneBodyAOInt>(overlap[0]->clone()));
+        if (cfmm_order_ > 0)
+            multipoles.push_back(std::shared_ptr<OneBodyAOInt>(multipoles[0]->clone()));
+    }
+    std::vector<std::vector<double> > Qs(nthread);
+
+    // => Density-weighted moments of the shell pairs <= //
+
+    // J only sees the symmetric part of D, and a pair M > N stands for NM too
+    std::vector<double> moments(npair * nset * nterm, 0.0);
+
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (size_t index = 0; index < npair; index++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        int M = pairs_[index].first;
+        int N = pairs_[index].second;
+        int Msize = primary_->shell(M).nfunction();
+        int Nsize = primary_->shell(N).nfunction();
+        int Moff = primary_->shell(M).function_index();
+        int Noff = primary_->shell(N).function_index();
+        size_t nMN = (size_t) Msize * Nsize;
+
+        std::vector<double>& Q = Qs[thread];
+        pair_moments(index, overlap[thread].get(), (cfmm_order_ > 0 ? multipoles[thread].get() : nullptr), Q);
+
+        for (int ind = 0; ind < nset; ind++) {
+            double** Dp = D[ind]->pointer();
+            double* m = &moments[(index * nset + ind) * nterm];
+            for (int p = 0; p < Msize; p++) {
+            for (int q = 0; q < Nsize; q++) {
+                double w = Dp[p + Moff][q + Noff];
+                if (M != N) w += Dp[q + Noff][p + Moff];
+                size_t pq = (size_t) p * Nsize + q;
+                for (int t = 0; t < nterm; t++)
+                    m[t] += w * Q[t * nMN + pq];
+            }}
+        }
+    }
+
+    tree_->set_moments(moments, nset);
+
+    // => Bra shell pairs: local expansion of the far field, exact near field <= //
+
+    size_t computed_shells = 0L;
+    size_t computed_ints = 0L;
+    double int_time = 0.0;
+    double task_time = 0.0;
+
+    std::vector<std::vector<double> > Ls(nthread);
+    std::vector<std::vector<double> > JTs(nthread);
+    std::vector<std::vector<std::pair<int, int> > > nears(nthread);
+
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_shells, computed_ints, int_time, task_time)
+    for (size_t index = 0; index < npair; index++) {
+        double task_start = wall_time();
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        int M = pairs_[index].first;
+        int N = pairs_[index].second;
+        int Msize = primary_->shell(M).nfunction();
+        int Nsize = primary_->shell(N).nfunction();
+        int Moff = primary_->shell(M).function_index();
+        int Noff = primary_->shell(N).function_index();
+        size_t nMN = (size_t) Msize * Nsize;
+
+        std::vector<double>& Q = Qs[thread];
+        std::vector<double>& L = Ls[thread];
+        std::vector<double>& JT = JTs[thread];
+        std::vector<std::pair<int, int> >& near = nears[thread];
+
+        L.assign((size_t) nset * nterm, 0.0);
+        JT.assign(nset * nMN, 0.0);
+        near.clear();
+        tree_->local_expansion(&centers_[3L * index], extents_[index], cfmm_theta_, L.data(), near);
+
+        // > Far field: J_pq += sum_j L_j / j! int pq (r - C)^j < //
+
+        pair_moments(index, overlap[thread].get(), (cfmm_order_ > 0 ? multipoles[thread].get() : nullptr), Q);
+        for (int ind = 0; ind < nset; ind++) {
+            for (int t = 0; t < nterm; t++) {
+                double coef = L[ind * nterm + t] * tree_->inv_fact(t);
+                if (coef == 0.0) continue;
+                for (size_t pq = 0; pq < nMN; pq++)
+                    JT[ind * nMN + pq] += coef * Q[t * nMN + pq];
+            }
+        }
+
+        // > Near field: exact (MN|RS) over the pairs of the near leaves < //
+
+        for (const auto& range : near) {
+        for (int i = range.first; i < range.first + range.second; i++) {
+            const std::pair<int, int>& RS = pairs_[tree_->original_index(i)];
+            int R = RS.first;
+            int S = RS.second;
+            if (!sieve_->shell_significant(M,N,R,S)) continue;
+
+            double int_start = wall_time();
+            ints[thread]->compute_shell(M,N,R,S);
+            int_time += wall_time() - int_start;
+            const double* buffer = ints[thread]->buffer();
+
+            int Rsize = primary_->shell(R).nfunction();
+            int Ssize = primary_->shell(S).nfunction();
+            int Roff = primary_->shell(R).function_index();
+            int Soff = primary_->shell(S).function_index();
+            size_t nRS = (size_t) Rsize * Ssize;
+            computed_shells++;
+            computed_ints += nMN * nRS;
+
+            for (int ind = 0; ind < nset; ind++) {
+                double** Dp = D[ind]->pointer();
+                for (size_t pq = 0; pq < nMN; pq++) {
+                    const double* row = buffer + pq * nRS;
+                    double val = 0.0;
+                    for (int r = 0; r < Rsize; r++) {
+                    for (int s = 0; s < Ssize; s++) {
+                        double w = Dp[r + Roff][s + Soff];
+                        if (R != S) w += Dp[s + Soff][r + Roff];
+                        val += row[r * Ssize + s] * w;
+                    }}
+                    JT[ind * nMN + pq] += val;
+                }
+            }
+        }}
+
+        // > Stripe out, each thread owns the J blocks of its bra pairs < //
+
+        for (int ind = 0; ind < nset; ind++) {
+            double** Jp = J[ind]->pointer();
+            for (int p = 0; p < Msize; p++) {
+            for (int q = 0; q < Nsize; q++) {
+                double val = JT[ind * nMN + p * Nsize + q];
+                Jp[p + Moff][q + Noff] = val;
+                Jp[q + Noff][p + Moff] = val;
+            }}
+        }
+
+        task_time += wall_time() - task_start;
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.shells_computed += computed_shells;
+    metrics.integrals += computed_ints;
+    metrics.integral_time += int_time;
+    metrics.contraction_time += task_time - int_time;
+    metrics.flops += nset * 2.0 * computed_ints;
+
+    if (bench_) {
+        outfile->Printf("  ==> CFMMJK: J Build <==\n\n");
+        outfile->Printf("    Near shell quartets: %11zu\n", computed_shells);
+        outfile->Printf("    Near integrals:      %11zu\n\n", computed_ints);
+    }
+}
+
+}
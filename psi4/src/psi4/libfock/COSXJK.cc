@@ -0,0 +1,372 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+#include "jk.h"
+#include "cubature.h"
+#include "points.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#ifdef _OPENMP
+#include <omp.h>
+#include "psi4/libpsi4util/process.h"
+#endif
+
+namespace psi {
+
+COSXJK::COSXJK(std::shared_ptr<BasisSet> primary, Options& options) :
+   DirectJK(primary), options_(options)
+{
+    common_init();
+}
+COSXJK::~COSXJK()
+{
+}
+void COSXJK::common_init()
+{
+    cosx_radial_points_ = 35;
+    cosx_spherical_points_ = 110;
+    overlap_fitting_ = true;
+}
+void COSXJK::print_header() const
+{
+    if (print_) {
+        outfile->Printf( "  ==> COSXJK: Seminumerical K, Integral-Direct J <==\n\n");
+
+        outfile->Printf( "    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf( "    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf( "    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        if (do_wK_)
+            outfile->Printf( "    Omega:             %11.3E\n", omega_);
+        outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf( "    Radial Points:     %11d\n", cosx_radial_points_);
+        outfile->Printf( "    Spherical Points:  %11d\n", cosx_spherical_points_);
+        outfile->Printf( "    Overlap Fitting:   %11s\n", (overlap_fitting_ ? "Yes" : "No"));
+        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
+    }
+}
+void COSXJK::preiterations()
+{
+    DirectJK::preiterations();
+
+    // => Exchange grid <= //
+
+    std::map<std::string, std::string> opts_map;
+    std::map<std::string, int> int_opts_map;
+    int_opts_map["DFT_RADIAL_POINTS"] = cosx_radial_points_;
+    int_opts_map["DFT_SPHERICAL_POINTS"] = cosx_spherical_points_;
+    grid_ = std::shared_ptr<DFTGrid>(new DFTGrid(primary_->molecule(), primary_, int_opts_map, opts_map, options_));
+
+    if (print_ > 1) {
+        outfile->Printf("  ==> COSXJK: Exchange Grid <==\n\n");
+        outfile->Printf("    Total Points:      %11zu\n", (size_t) grid_->npoints());
+        outfile->Printf("    Total Blocks:      %11zu\n\n", grid_->blocks().size());
+    }
+
+    // => Overlap fitting, Q = S [S_grid]^-1 <= //
+
+    Q_.reset();
+    if (!overlap_fitting_) return;
+
+    int nbf = primary_->nbf();
+    int max_points = grid_->max_points();
+    int max_functions = grid_->max_functions();
+    int nthread = df_ints_num_threads_;
+
+    std::vector<std::shared_ptr<BasisFunctions> > functions;
+    std::vector<SharedMatrix> S_thread;
+    std::vector<SharedMatrix> phiw_thread;
+    for (int thread = 0; thread < nthread; thread++) {
+        functions.push_back(std::shared_ptr<BasisFunctions>(new BasisFunctions(primary_, max_points, max_functions)));
+        S_thread.push_back(SharedMatrix(new Matrix("S Grid", nbf, nbf)));
+        phiw_thread.push_back(SharedMatrix(new Matrix("phi w", max_points, max_functions)));
+    }
+
+    const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        functions[thread]->compute_functions(block);
+        double** phi = functions[thread]->basis_value("PHI")->pointer();
+        const std::vector<int>& function_map = functions[thread]->function_map();
+        int npoints = block->npoints();
+        int nlocal = function_map.size();
+        double* w = block->w();
+
+        double** phiwp = phiw_thread[thread]->pointer();
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                phiwp[P][ml] = w[P] * phi[P][ml];
+            }
+        }
+
+        double** Sp = S_thread[thread]->pointer();
+        for (int ml = 0; ml < nlocal; ml++) {
+            int mg = function_map[ml];
+            for (int nl = 0; nl < nlocal; nl++) {
+                int ng = function_map[nl];
+                Sp[mg][ng] += C_DDOT(npoints, &phiwp[0][ml], max_functions, &phi[0][nl], max_functions);
+            }
+        }
+    }
+
+    SharedMatrix S_grid(new Matrix("S Grid", nbf, nbf));
+    for (int thread = 0; thread < nthread; thread++) {
+        S_grid->add(S_thread[thread]);
+    }
+    S_grid->general_invert();
+
+    std::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary_,primary_,primary_,primary_));
+    std::shared_ptr<OneBodyAOInt> overlap(factory->ao_overlap());
+    SharedMatrix S(new Matrix("S", nbf, nbf));
+    overlap->compute(S);
+
+    Q_ = Matrix::doublet(S, S_grid);
+}
+void COSXJK::postiterations()
+{
+    DirectJK::postiterations();
+    grid_.reset();
+    Q_.reset();
+}
+void COSXJK::compute_JK()
+{
+    // J and wK come from DirectJK, with the analytic K switched off
+    if (do_J_ || do_wK_) {
+        bool do_K = do_K_;
+        do_K_ = false;
+        DirectJK::compute_JK();
+        do_K_ = do_K;
+    }
+
+    if (do_K_) build_K(D_ao_, K_ao_);
+}
+void COSXJK::build_K(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K)
+{
+    int nset = D.size();
+    int nbf = primary_->nbf();
+    int nshell = primary_->nshell();
+    int max_points = grid_->max_points();
+    int max_functions = grid_->max_functions();
+    int nthread = df_ints_num_threads_;
+
+    const std::vector<std::pair<int, int> >& shell_pairs = sieve_->shell_pairs();
+
+    // => Per-thread workers <= //
+
+    std::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary_,primary_,primary_,primary_));
+    std::vector<std::shared_ptr<PotentialInt> > pots;
+    std::vector<SharedMatrix> charges;
+    std::vector<std::shared_ptr<BasisFunctions> > functions;
+    std::vector<std::vector<SharedMatrix> > K_thread(nthread);
+    std::vector<std::vector<SharedMatrix> > F_thread(nthread);
+    std::vector<std::vector<SharedMatrix> > G_thread(nthread);
+    std::vector<SharedMatrix> D_local_thread;
+    std::vector<SharedMatrix> phiw_thread;
+    std::vector<std::vector<double> > Fmax_thread(nthread, std::vector<double>(nshell));
+    for (int thread = 0; thread < nthread; thread++) {
+        pots.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential())));
+        // A unit positive charge, PotentialInt integrates -Z / |r - C|
+        charges.push_back(SharedMatrix(new Matrix("Grid Point", 1, 4)));
+        charges[thread]->set(0, 0, -1.0);
+        pots[thread]->set_charge_field(charges[thread]);
+        functions.push_back(std::shared_ptr<BasisFunctions>(new BasisFunctions(primary_, max_points, max_functions)));
+        for (int ind = 0; ind < nset; ind++) {
+            K_thread[thread].push_back(SharedMatrix(new Matrix("K Grid", max_functions, nbf)));
+            F_thread[thread].push_back(SharedMatrix(new Matrix("F", max_points, nbf)));
+            G_thread[thread].push_back(SharedMatrix(new Matrix("G", max_points, nbf)));
+        }
+        D_local_thread.push_back(SharedMatrix(new Matrix("D local", max_functions, nbf)));
+        phiw_thread.push_back(SharedMatrix(new Matrix("phi w", max_points, max_functions)));
+    }
+
+    std::vector<SharedMatrix> K_raw;
+    for (int ind = 0; ind < nset; ind++) {
+        K_raw.push_back(SharedMatrix(new Matrix("K Raw", nbf, nbf)));
+    }
+
+    // => Master grid loop <= //
+
+    size_t computed_pairs = 0L;
+    double int_time = 0.0;
+    double task_time = 0.0;
+
+    const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_pairs, int_time, task_time)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        double task_start = wall_time();
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        functions[thread]->compute_functions(block);
+        double** phi = functions[thread]->basis_value("PHI")->pointer();
+        const std::vector<int>& function_map = functions[thread]->function_map();
+        int npoints = block->npoints();
+        int nlocal = function_map.size();
+        if (!nlocal) continue;
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+
+        // > F_s(g) = sum_l phi_l(g) D_ls, over the functions of the block < //
+
+        double** Dlp = D_local_thread[thread]->pointer();
+        for (int ind = 0; ind < nset; ind++) {
+            double** Dp = D[ind]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                ::memcpy((void*) Dlp[ml], (void*) Dp[function_map[ml]], sizeof(double) * nbf);
+            }
+            double** Fp = F_thread[thread][ind]->pointer();
+            C_DGEMM('N', 'N', npoints, nbf, nlocal, 1.0, phi[0], max_functions, Dlp[0], nbf, 0.0, Fp[0], nbf);
+            G_thread[thread][ind]->zero();
+        }
+
+        // > G_n(g) = sum_s A_ns(g) F_s(g), A_ns(g) = int phi_n phi_s / |r - g| < //
+
+        std::vector<double>& Fmax = Fmax_thread[thread];
+        double** Cp = charges[thread]->pointer();
+        for (int P = 0; P < npoints; P++) {
+            Cp[0][1] = x[P];
+            Cp[0][2] = y[P];
+            Cp[0][3] = z[P];
+
+            std::fill(Fmax.begin(), Fmax.end(), 0.0);
+            for (int ind = 0; ind < nset; ind++) {
+                double* Fp = F_thread[thread][ind]->pointer()[P];
+                for (int S = 0; S < nshell; S++) {
+                    int Soff = primary_->shell(S).function_index();
+                    int Ssize = primary_->shell(S).nfunction();
+                    for (int s = 0; s < Ssize; s++)
+                        Fmax[S] = std::max(Fmax[S], std::fabs(Fp[s + Soff]));
+                }
+            }
+
+            for (const auto& NS : shell_pairs) {
+                int N = NS.first;
+                int S = NS.second;
+                if (std::max(Fmax[N], Fmax[S]) < cutoff_) continue;
+
+                double int_start = wall_time();
+                pots[thread]->compute_shell(N, S);
+                int_time += wall_time() - int_start;
+                computed_pairs++;
+                const double* A = pots[thread]->buffer();
+
+                int Nsize = primary_->shell(N).nfunction();
+                int Ssize = primary_->shell(S).nfunction();
+                int Noff = primary_->shell(N).function_index();
+                int Soff = primary_->shell(S).function_index();
+
+                for (int ind = 0; ind < nset; ind++) {
+                    double* Fp = F_thread[thread][ind]->pointer()[P];
+                    double* Gp = G_thread[thread][ind]->pointer()[P];
+                    for (int n = 0; n < Nsize; n++) {
+                        for (int s = 0; s < Ssize; s++) {
+                            double a = A[n * Ssize + s];
+                            Gp[n + Noff] += a * Fp[s + Soff];
+                            if (N != S) Gp[s + Soff] += a * Fp[n + Noff];
+                        }
+                    }
+                }
+            }
+        }
+
+        // > K_mn += sum_g w_g phi_m(g) G_n(g), for the functions of the block < //
+
+        double** phiwp = phiw_thread[thread]->pointer();
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                phiwp[P][ml] = w[P] * phi[P][ml];
+            }
+        }
+        for (int ind = 0; ind < nset; ind++) {
+            double** KTp = K_thread[thread][ind]->pointer();
+            double** Gp = G_thread[thread][ind]->pointer();
+            C_DGEMM('T', 'N', nlocal, nbf, npoints, 1.0, phiwp[0], max_functions, Gp[0], nbf, 0.0, KTp[0], nbf);
+            double** Kp = K_raw[ind]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                int mg = function_map[ml];
+                for (int n = 0; n < nbf; n++) {
+                    #pragma omp atomic update
+                    Kp[mg][n] += KTp[ml][n];
+                }
+            }
+        }
+
+        task_time += wall_time() - task_start;
+    }
+
+    // => Overlap fitting and symmetrization <= //
+
+    for (int ind = 0; ind < nset; ind++) {
+        if (Q_) {
+            K[ind]->gemm(false, false, 1.0, Q_, K_raw[ind], 0.0);
+        } else {
+            K[ind]->copy(K_raw[ind]);
+        }
+        if (lr_symmetric_) {
+            K[ind]->hermitivitize();
+        }
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integral_time += int_time;
+    metrics.contraction_time += task_time - int_time;
+
+    if (bench_) {
+        outfile->Printf("  ==> COSXJK: K Build <==\n\n");
+        outfile->Printf("    Grid shell pairs:  %11zu\n\n", computed_pairs);
+    }
+}
+
+}
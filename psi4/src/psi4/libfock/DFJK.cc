@@ -38,10 +38,15 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/local.h"
 #include "psi4/lib3index/dftensor.h"
+#include "psi4/lib3index/df_cache.h"
 
 #include "jk.h"
+#include "compression.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include "psi4/libpsi4util/PsiOutStream.h"
 #ifdef _OPENMP
@@ -70,12 +75,21 @@ void DFJK::common_init()
     #endif
     df_ints_io_ = "NONE";
     condition_ = 1.0E-12;
+    disk_tolerance_ = 0.0;
+    compress_step_ = 0.0;
     unit_ = PSIF_DFSCF_BJ;
     is_core_ = true;
     psio_ = PSIO::shared_object();
+    local_K_ = false;
+    local_K_tolerance_ = 1.0E-6;
+    local_K_localizer_ = "BOYS";
+    single_precision_ = false;
 }
 SharedVector DFJK::iaia(SharedMatrix Ci, SharedMatrix Ca)
 {
+    if (single_precision_)
+        resume_double_precision();
+
     // Target quantity
     Dimension dim(Ci->nirrep());
     for (int symm = 0; symm < Ci->nirrep(); symm++) {
@@ -174,7 +188,8 @@ SharedVector DFJK::iaia(SharedMatrix Ci, SharedMatrix Ca)
             Qmnp = &Qmn_->pointer()[Q];
         } else {
             Qmnp = Qmn_->pointer();
-            psio_->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_->pointer()[0]),sizeof(double)*naux*num_nm,addr,&addr);
+            psio_->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_->pointer()[0]),compression::element_size(compress_step_)*rows*num_nm,addr,&addr);
+            unpack_Qmn(Qmn_->pointer()[0], Q, rows);
         }
 
         // (mi|Q)
@@ -269,6 +284,14 @@ void DFJK::print_header() const
         outfile->Printf( "    Algorithm:         %11s\n",  (is_core_ ? "Core" : "Disk"));
         outfile->Printf( "    Integral Cache:    %11s\n",  df_ints_io_.c_str());
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        if (disk_tolerance_ > 0.0)
+            outfile->Printf( "    Disk Tolerance:    %11.0E\n", disk_tolerance_);
+        if (local_K_) {
+            outfile->Printf( "    Local K:           %11s\n", local_K_localizer_.c_str());
+            outfile->Printf( "    Local K Tolerance: %11.0E\n", local_K_tolerance_);
+        }
+        if (mixed_precision_)
+            outfile->Printf( "    Mixed Precision:   %11.0E\n", mixed_precision_switch_);
         outfile->Printf( "    Fitting Condition: %11.0E\n\n", condition_);
 
         outfile->Printf( "   => Auxiliary Basis Set <=\n\n");
@@ -280,6 +303,9 @@ bool DFJK::is_core() const
     size_t ntri = sieve_->function_pairs().size();
     size_t three_memory = ((size_t)auxiliary_->nbf())*ntri;
     size_t two_memory = ((size_t)auxiliary_->nbf())*auxiliary_->nbf();
+    // A single-precision tensor takes half the doubles
+    if (single_precision_)
+        three_memory = (three_memory + 1L) / 2L;
 
     size_t mem = memory_;
     mem -= memory_overhead();
@@ -313,10 +339,13 @@ int DFJK::max_rows() const
 
     // How much will each row cost?
     size_t row_cost = 0L;
-    // Copies of E tensor
-    row_cost += (lr_symmetric_ ? 1L : 2L) * max_nocc() * primary_->nbf();
-    // Slices of Qmn tensor, including AIO buffer (NOTE: AIO not implemented yet)
-    row_cost += (is_core_ ? 1L : 1L) * sieve_->function_pairs().size();
+    // Copies of E tensor, or of the per-thread E_i of local K
+    if (local_K_)
+        row_cost += (lr_symmetric_ ? 1L : 2L) * omp_nthread_ * primary_->nbf();
+    else
+        row_cost += (lr_symmetric_ ? 1L : 2L) * max_nocc() * primary_->nbf();
+    // Slices of Qmn tensor, including the AIO prefetch buffer for disk
+    row_cost += (is_core_ ? 1L : 2L) * sieve_->function_pairs().size();
 
     size_t max_rows = mem / row_cost;
 
@@ -360,6 +389,11 @@ void DFJK::initialize_temps()
         }
     #endif
 
+    if (local_K_ && do_K_) {
+        localize_occupied();
+        return;
+    }
+
     E_left_ = SharedMatrix(new Matrix("E_left", primary_->nbf(), max_rows_ * max_nocc_));
     if (lr_symmetric_)
         E_right_ = E_left_;
@@ -403,6 +437,9 @@ void DFJK::free_temps()
     E_right_.reset();
     C_temp_.clear();
     Q_temp_.clear();
+    C_left_local_.clear();
+    C_right_local_.clear();
+    local_domains_.clear();
 }
 void DFJK::free_w_temps()
 {
@@ -419,11 +456,19 @@ void DFJK::preiterations()
         sieve_ = std::shared_ptr<ERISieve>(new ERISieve(primary_, cutoff_));
     }
 
-    // Core or disk?
+    // Core or disk? (for the double-precision tensor)
+    single_precision_ = false;
     is_core_ =  is_core();
 
+    // Mixed precision holds single-precision (Q|mn) in core, if that fits
+    if (mixed_precision_ && !do_wK_ && !local_K_ && df_ints_io_ == "NONE") {
+        single_precision_ = true;
+        single_precision_ = is_core();
+    }
 
-    if (is_core_)
+    if (single_precision_)
+        initialize_JK_single();
+    else if (is_core_)
         initialize_JK_core();
     else
         initialize_JK_disk();
@@ -438,10 +483,18 @@ void DFJK::preiterations()
 
 void DFJK::compute_JK()
 {
+    if (single_precision_ && density_settled()) {
+        if (print_)
+            outfile->Printf( "    DFJK: density settled, switching to double-precision (Q|mn).\n");
+        resume_double_precision();
+    }
+
     max_nocc_ = max_nocc();
     max_rows_ = max_rows();
 
-    if (do_J_ || do_K_) {
+    if ((do_J_ || do_K_) && single_precision_) {
+        manage_JK_single();
+    } else if (do_J_ || do_K_) {
         initialize_temps();
         if (is_core_)
             manage_JK_core();
@@ -467,6 +520,9 @@ void DFJK::compute_JK()
 }
 void DFJK::postiterations()
 {
+    std::vector<float>().swap(Qmn_single_);
+    D_prev_.clear();
+    single_precision_ = false;
     Qmn_.reset();
     Qlmn_.reset();
     Qrmn_.reset();
@@ -482,6 +538,15 @@ void DFJK::initialize_JK_core()
         nthread = df_ints_num_threads_;
     #endif
 
+    // An earlier DFJK on the same basis pair and cutoff may have left them (DF_INTS_CACHE)
+    if (df_ints_io_ == "NONE") {
+        SharedMatrix cached = DFIntsCache::get_Qmn(primary_, auxiliary_, cutoff_);
+        if (cached && cached->rowdim() == auxiliary_->nbf() && (size_t) cached->coldim() == ntri) {
+            Qmn_ = cached;
+            return;
+        }
+    }
+
     Qmn_ = SharedMatrix(new Matrix("Qmn (Fitted Integrals)",
         auxiliary_->nbf(), ntri));
     double** Qmnp = Qmn_->pointer();
@@ -626,11 +691,28 @@ void DFJK::initialize_JK_core()
     delete []buffer;
     delete []eri;
 
+    // Saved integrals are read by other modules, which expect J^-1/2 fitting
+    if (df_ints_io_ == "NONE") {
+        timer_on("JK: (A|Q) Cholesky");
+        SharedMatrix L = DFIntsCache::metric_cholesky(auxiliary_, 1.0E-10);
+        timer_off("JK: (A|Q) Cholesky");
+
+        if (L) {
+            // (Q|mn) = L^-1 (A|mn), in place
+            timer_on("JK: (Q|mn)");
+            C_DTRSM('L','L','N','N', auxiliary_->nbf(), ntri, 1.0, L->pointer()[0], auxiliary_->nbf(),
+                Qmnp[0], ntri);
+            timer_off("JK: (Q|mn)");
+
+            Qmn_ = DFIntsCache::set_Qmn(primary_, auxiliary_, cutoff_, Qmn_);
+            return;
+        }
+    }
+
     timer_on("JK: (A|Q)^-1/2");
 
-    std::shared_ptr<FittingMetric> Jinv(new FittingMetric(auxiliary_, true));
-    Jinv->form_eig_inverse();
-    double** Jinvp = Jinv->get_metric()->pointer();
+    SharedMatrix Jinv = DFIntsCache::metric_power(auxiliary_, -0.5, 1.0E-10);
+    double** Jinvp = Jinv->pointer();
 
     timer_off("JK: (A|Q)^-1/2");
 
@@ -675,6 +757,8 @@ void DFJK::initialize_JK_core()
         psio_->write_entry(unit_, "(Q|mn) Integrals", (char*) Qmnp[0], sizeof(double) * ntri * auxiliary_->nbf());
         psio_->close(unit_,1);
     }
+
+    Qmn_ = DFIntsCache::set_Qmn(primary_, auxiliary_, cutoff_, Qmn_);
 }
 void DFJK::initialize_JK_disk()
 {
@@ -683,6 +767,12 @@ void DFJK::initialize_JK_disk()
         return;
     }
 
+    // Saved integrals are read uncompressed by other modules
+    compress_step_ = (disk_tolerance_ > 0.0 && df_ints_io_ == "NONE" ? 2.0 * disk_tolerance_ : 0.0);
+    size_t elsize = compression::element_size(compress_step_);
+    compress_cols_.clear();
+    compress_overflow_.clear();
+
     int nshell = primary_->nshell();
     int naux = auxiliary_->nbf();
 
@@ -885,12 +975,15 @@ void DFJK::initialize_JK_disk()
     std::shared_ptr<AIOHandler> aio(new AIOHandler(psio_));
 
     // Dispatch the prestripe
-    aio->zero_disk(unit_,"(Q|mn) Integrals",naux,ntri);
+    aio->zero_disk(unit_,"(Q|mn) Integrals",naux,(ntri*elsize + sizeof(double) - 1L) / sizeof(double));
 
-    // Form the J symmetric inverse
-    std::shared_ptr<FittingMetric> Jinv(new FittingMetric(auxiliary_, true));
-    Jinv->form_eig_inverse();
-    double** Jinvp = Jinv->get_metric()->pointer();
+    // Form the J Cholesky factor or, if J is too ill-conditioned or the
+    // integrals are saved for other modules, the J symmetric inverse
+    SharedMatrix L;
+    if (df_ints_io_ == "NONE")
+        L = DFIntsCache::metric_cholesky(auxiliary_, 1.0E-10);
+    SharedMatrix Jinv = (L ? L : DFIntsCache::metric_power(auxiliary_, -0.5, 1.0E-10));
+    double** Jinvp = Jinv->pointer();
 
     // Synch up
     aio->synchronize();
@@ -913,6 +1006,14 @@ void DFJK::initialize_JK_disk()
         buffer[Q] = eri[Q]->buffer();
     }
 
+    // Blocks holding a value beyond the fixed-point range are stored as doubles instead
+    size_t overflow_size = 0L;
+    if (compress_step_ > 0.0) {
+        compress_cols_.assign(mn_start_b.begin(), mn_start_b.end());
+        compress_cols_.push_back(ntri);
+        compress_overflow_.assign(naux * (size_t) nblock, -1L);
+    }
+
     // ==> Main loop <== //
     for (int block = 0; block < nblock; block++) {
         int MN_start_val = MN_start_b[block];
@@ -964,15 +1065,19 @@ void DFJK::initialize_JK_disk()
 
         timer_on("JK: (Q|mn)");
 
-        for (int mn = 0; mn < mn_col_val; mn+=naux) {
-            int cols = naux;
-            if (mn + naux >= mn_col_val)
-                cols = mn_col_val - mn;
+        if (L) {
+            C_DTRSM('L','L','N','N',naux,mn_col_val,1.0,Jinvp[0],naux,Qmnp[0],max_cols);
+        } else {
+            for (int mn = 0; mn < mn_col_val; mn+=naux) {
+                int cols = naux;
+                if (mn + naux >= mn_col_val)
+                    cols = mn_col_val - mn;
 
-            for (int Q = 0; Q < naux; Q++)
-                C_DCOPY(cols,&Qmnp[Q][mn],1,Amnp[Q],1);
+                for (int Q = 0; Q < naux; Q++)
+                    C_DCOPY(cols,&Qmnp[Q][mn],1,Amnp[Q],1);
 
-            C_DGEMM('N','N',naux,cols,naux,1.0,Jinvp[0],naux,Amnp[0],naux,0.0,&Qmnp[0][mn],max_cols);
+                C_DGEMM('N','N',naux,cols,naux,1.0,Jinvp[0],naux,Amnp[0],naux,0.0,&Qmnp[0][mn],max_cols);
+            }
         }
 
         timer_off("JK: (Q|mn)");
@@ -983,13 +1088,31 @@ void DFJK::initialize_JK_disk()
 
         psio_address addr;
         for (int Q = 0; Q < naux; Q++) {
-            addr = psio_get_address(PSIO_ZERO, (Q*(size_t) ntri + mn_start_val)*sizeof(double));
-            psio_->write(unit_,"(Q|mn) Integrals", (char*)Qmnp[Q],mn_col_val*sizeof(double),addr,&addr);
+            if (compress_step_ > 0.0) {
+                double max_abs = 0.0;
+                for (int mn = 0; mn < mn_col_val; mn++)
+                    max_abs = std::max(max_abs, std::fabs(Qmnp[Q][mn]));
+                if (!compression::representable(max_abs, compress_step_)) {
+                    compress_overflow_[Q * (size_t) nblock + block] = overflow_size;
+                    addr = psio_get_address(PSIO_ZERO, overflow_size*sizeof(double));
+                    psio_->write(unit_,"(Q|mn) Overflow", (char*)Qmnp[Q],mn_col_val*sizeof(double),addr,&addr);
+                    overflow_size += mn_col_val;
+                    continue;
+                }
+                compression::pack(Qmnp[Q], mn_col_val, compress_step_);
+            }
+            addr = psio_get_address(PSIO_ZERO, (Q*(size_t) ntri + mn_start_val)*elsize);
+            psio_->write(unit_,"(Q|mn) Integrals", (char*)Qmnp[Q],mn_col_val*elsize,addr,&addr);
         }
 
         timer_off("JK: (Q|mn) Write");
     }
 
+    if (compress_step_ > 0.0 && overflow_size) {
+        outfile->Printf("  DFJK: %.1f%% of the (Q|mn) integrals exceed the fixed-point range of\n", 100.0 * overflow_size / (naux * (double) ntri));
+        outfile->Printf("        DISK_COMPRESSION_TOLERANCE and are stored uncompressed.\n\n");
+    }
+
     // ==> Close out <== //
     Qmn_.reset();
     delete[] eri;
@@ -997,6 +1120,105 @@ void DFJK::initialize_JK_disk()
 
     psio_->close(unit_,1);
 }
+void DFJK::unpack_Qmn(double* Qmnp, int Q, int nrows)
+{
+    if (compress_step_ == 0.0)
+        return;
+
+    size_t ntri = compress_cols_.back();
+    size_t nblock = compress_cols_.size() - 1;
+    compression::unpack(Qmnp, nrows*ntri, compress_step_);
+
+    // Overwrite the placeholder zeros of blocks that were kept as doubles
+    for (int row = 0; row < nrows; row++) {
+        for (size_t block = 0; block < nblock; block++) {
+            long int offset = compress_overflow_[(Q + row) * nblock + block];
+            if (offset < 0L)
+                continue;
+            size_t cols = compress_cols_[block + 1] - compress_cols_[block];
+            psio_address addr = psio_get_address(PSIO_ZERO, offset*sizeof(double));
+            psio_->read(unit_,"(Q|mn) Overflow", (char*)&Qmnp[row*ntri + compress_cols_[block]],cols*sizeof(double),addr,&addr);
+        }
+    }
+}
+void DFJK::initialize_JK_single()
+{
+    size_t ntri = sieve_->function_pairs().size();
+    size_t naux = auxiliary_->nbf();
+
+    if (is_core_) {
+        // The double tensor fits as well, build it in core and narrow it
+        initialize_JK_core();
+        double* Qmnp = Qmn_->pointer()[0];
+        Qmn_single_.assign(Qmnp, Qmnp + naux * ntri);
+        Qmn_.reset();
+        return;
+    }
+
+    // Only the floats fit: build the double tensor on disk, and keep the
+    // file for the double-precision builds after the switch
+    initialize_JK_disk();
+
+    timer_on("JK: (Q|mn) Single");
+
+    Qmn_single_.resize(naux * ntri);
+    size_t elsize = compression::element_size(compress_step_);
+
+    size_t float_memory = (naux * ntri + 1L) / 2L;
+    size_t rows = (memory_ > float_memory ? (memory_ - float_memory) / ntri : 1L);
+    if (rows > naux)
+        rows = naux;
+    if (rows < 1L)
+        rows = 1L;
+    SharedMatrix block(new Matrix("(Q|mn) Block", rows, ntri));
+    double* blockp = block->pointer()[0];
+
+    psio_->open(unit_,PSIO_OPEN_OLD);
+    psio_address addr = PSIO_ZERO;
+    for (size_t Q = 0; Q < naux; Q += rows) {
+        size_t nrows = (naux - Q <= rows ? naux - Q : rows);
+        psio_->read(unit_,"(Q|mn) Integrals", (char*) blockp, elsize*nrows*ntri, addr, &addr);
+        unpack_Qmn(blockp, Q, nrows);
+        std::copy(blockp, blockp + nrows * ntri, Qmn_single_.begin() + Q * ntri);
+    }
+    psio_->close(unit_,1);
+
+    timer_off("JK: (Q|mn) Single");
+}
+bool DFJK::density_settled()
+{
+    bool comparable = (D_prev_.size() == D_ao_.size() && D_ao_.size());
+    double sum = 0.0;
+    size_t count = 0L;
+    for (size_t N = 0; comparable && N < D_ao_.size(); N++) {
+        size_t size = D_ao_[N]->rowspi()[0] * (size_t) D_ao_[N]->colspi()[0];
+        if (D_prev_[N]->rowspi()[0] * (size_t) D_prev_[N]->colspi()[0] != size) {
+            comparable = false;
+            break;
+        }
+        double* Dp = D_ao_[N]->pointer()[0];
+        double* Pp = D_prev_[N]->pointer()[0];
+        for (size_t mn = 0; mn < size; mn++)
+            sum += (Dp[mn] - Pp[mn]) * (Dp[mn] - Pp[mn]);
+        count += size;
+    }
+
+    D_prev_.resize(D_ao_.size());
+    for (size_t N = 0; N < D_ao_.size(); N++)
+        D_prev_[N] = D_ao_[N]->clone();
+
+    return (comparable && count && std::sqrt(sum / count) < mixed_precision_switch_);
+}
+void DFJK::resume_double_precision()
+{
+    std::vector<float>().swap(Qmn_single_);
+    D_prev_.clear();
+    single_precision_ = false;
+
+    // The disk file written by initialize_JK_single() is still in place
+    if (is_core_)
+        initialize_JK_core();
+}
 void DFJK::initialize_wK_core()
 {
     int naux = auxiliary_->nbf();
@@ -1095,9 +1317,8 @@ void DFJK::initialize_wK_core()
     timer_on("JK: (A|Q)^-1");
 
     // Fitting metric
-    std::shared_ptr<FittingMetric> Jinv(new FittingMetric(auxiliary_, true));
-    Jinv->form_full_eig_inverse();
-    double** Jinvp = Jinv->get_metric()->pointer();
+    SharedMatrix Jinv = DFIntsCache::metric_power(auxiliary_, -1.0, 1.0E-10);
+    double** Jinvp = Jinv->pointer();
 
     timer_off("JK: (A|Q)^-1");
 
@@ -1380,9 +1601,8 @@ void DFJK::initialize_wK_disk()
     aio->zero_disk(unit_,"Left (Q|w|mn) Integrals",naux,ntri);
 
     // Form the J full inverse
-    std::shared_ptr<FittingMetric> Jinv(new FittingMetric(auxiliary_, true));
-    Jinv->form_full_eig_inverse();
-    double** Jinvp = Jinv->get_metric()->pointer();
+    SharedMatrix Jinv = DFIntsCache::metric_power(auxiliary_, -1.0, 1.0E-10);
+    double** Jinvp = Jinv->pointer();
 
     // Synch up
     aio->synchronize();
@@ -1740,16 +1960,45 @@ void DFJK::manage_JK_core()
 void DFJK::manage_JK_disk()
 {
     int ntri = sieve_->function_pairs().size();
-    Qmn_ = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_, ntri));
+    int naux_total = auxiliary_->nbf();
+    size_t elsize = compression::element_size(compress_step_);
+
+    // Double buffered: block k+1 is read by the AIO thread while block k is contracted
+    std::vector<SharedMatrix> Qmn_blocks(2);
+    Qmn_blocks[0] = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_, ntri));
+    if (max_rows_ < naux_total)
+        Qmn_blocks[1] = SharedMatrix(new Matrix("(Q|mn) Block", max_rows_, ntri));
+    psio_address addr_ends[2];
+
     psio_->open(unit_,PSIO_OPEN_OLD);
-    for (int Q = 0 ; Q < auxiliary_->nbf(); Q += max_rows_) {
-        int naux = (auxiliary_->nbf() - Q <= max_rows_ ? auxiliary_->nbf() - Q : max_rows_);
-        psio_address addr = psio_get_address(PSIO_ZERO, (Q*(size_t) ntri) * sizeof(double));
+    std::shared_ptr<AIOHandler> aio(new AIOHandler(psio_));
+
+    // Dispatch the first read
+    int naux_first = (naux_total <= max_rows_ ? naux_total : max_rows_);
+    size_t jobid = aio->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_blocks[0]->pointer()[0]),
+        elsize*naux_first*ntri, PSIO_ZERO, &addr_ends[0]);
+
+    for (int Q = 0, block = 0; Q < naux_total; Q += max_rows_, block++) {
+        int naux = (naux_total - Q <= max_rows_ ? naux_total - Q : max_rows_);
+        int current = block % 2;
 
         timer_on("JK: (Q|mn) Read");
-        psio_->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_->pointer()[0]),sizeof(double)*naux*ntri,addr,&addr);
+        aio->wait_for_job(jobid);
         timer_off("JK: (Q|mn) Read");
 
+        // Unpack before the prefetch, overflow blocks are read synchronously from unit_
+        Qmn_ = Qmn_blocks[current];
+        unpack_Qmn(Qmn_->pointer()[0], Q, naux);
+
+        // Prefetch the next block into the other buffer
+        int Qnext = Q + max_rows_;
+        if (Qnext < naux_total) {
+            int naux_next = (naux_total - Qnext <= max_rows_ ? naux_total - Qnext : max_rows_);
+            psio_address addr = psio_get_address(PSIO_ZERO, (Qnext*(size_t) ntri) * elsize);
+            jobid = aio->read(unit_,"(Q|mn) Integrals", (char*)(Qmn_blocks[1 - current]->pointer()[0]),
+                elsize*naux_next*ntri, addr, &addr_ends[1 - current]);
+        }
+
         if (do_J_) {
             timer_on("JK: J");
             block_J(&Qmn_->pointer()[0],naux);
@@ -1761,9 +2010,133 @@ void DFJK::manage_JK_disk()
             timer_off("JK: K");
         }
     }
+    aio->synchronize();
     psio_->close(unit_,1);
     Qmn_.reset();
 }
+void DFJK::manage_JK_single()
+{
+    const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
+    const std::vector<long int>& function_pairs_reverse = sieve_->function_pairs_reverse();
+    size_t num_nm = function_pairs.size();
+    int naux_total = auxiliary_->nbf();
+    int nbf = primary_->nbf();
+    double start = wall_time();
+    double flops = 0.0;
+
+    size_t npair = 0L;
+    for (size_t m = 0; m < sieve_->function_to_function().size(); m++)
+        npair += sieve_->function_to_function()[m].size();
+
+    // => J: all of Q at once, two SGEMV per density <= //
+    if (do_J_) {
+        timer_on("JK: J");
+        std::vector<float> D2(num_nm), J2(num_nm), d(naux_total);
+        for (size_t N = 0; N < J_ao_.size(); N++) {
+            double** Dp = D_ao_[N]->pointer();
+            double** Jp = J_ao_[N]->pointer();
+            for (size_t mn = 0; mn < num_nm; ++mn) {
+                int m = function_pairs[mn].first;
+                int n = function_pairs[mn].second;
+                D2[mn] = (float) (m == n ? Dp[m][n] : Dp[m][n] + Dp[n][m]);
+            }
+            C_SGEMV('N',naux_total,num_nm,1.0f,Qmn_single_.data(),num_nm,D2.data(),1,0.0f,d.data(),1);
+            C_SGEMV('T',naux_total,num_nm,1.0f,Qmn_single_.data(),num_nm,d.data(),1,0.0f,J2.data(),1);
+            for (size_t mn = 0; mn < num_nm; ++mn) {
+                int m = function_pairs[mn].first;
+                int n = function_pairs[mn].second;
+                Jp[m][n] += J2[mn];
+                Jp[n][m] += (m == n ? 0.0 : J2[mn]);
+            }
+        }
+        flops += 4.0 * J_ao_.size() * naux_total * num_nm;
+        timer_off("JK: J");
+    }
+
+    // => K: blocks of max_rows_ auxiliary functions, as in block_K() <= //
+    if (do_K_) {
+        timer_on("JK: K");
+
+        std::vector<std::vector<float> > C_temp(omp_nthread_), Q_temp(omp_nthread_);
+        for (int thread = 0; thread < omp_nthread_; thread++) {
+            C_temp[thread].resize(max_nocc_ * (size_t) nbf);
+            Q_temp[thread].resize(max_rows_ * (size_t) nbf);
+        }
+        std::vector<float> E_left(nbf * (size_t) max_rows_ * max_nocc_);
+        std::vector<float> E_right(lr_symmetric_ ? 0L : E_left.size());
+        std::vector<float> K_temp(nbf * (size_t) nbf);
+
+        for (int Q = 0; Q < naux_total; Q += max_rows_) {
+            int naux = (naux_total - Q <= max_rows_ ? naux_total - Q : max_rows_);
+            float* Qmnp = &Qmn_single_[Q * num_nm];
+
+            for (size_t N = 0; N < K_ao_.size(); N++) {
+
+                int nocc = C_left_ao_[N]->colspi()[0];
+                if (!nocc) continue;
+
+                double** Kp = K_ao_[N]->pointer();
+
+                // E_i(Q,m) = (Q|mn) C_ni, for the left and (if distinct) right C
+                for (int side = 0; side < (lr_symmetric_ ? 1 : 2); side++) {
+                    SharedMatrix C = (side ? C_right_ao_[N] : C_left_ao_[N]);
+                    const std::vector<SharedMatrix >& Cs = (side ? C_right_ : C_left_);
+                    std::vector<float>& E = (side ? E_right : E_left);
+
+                    if (N > 0 && Cs[N].get() == Cs[N-1].get()) continue;
+                    if (side && C_right_[N].get() == C_left_[N].get()) {
+                        std::copy(E_left.begin(), E_left.begin() + naux * (size_t) nocc * nbf, E_right.begin());
+                        continue;
+                    }
+
+                    double** Cp = C->pointer();
+
+                    #pragma omp parallel for schedule (dynamic) num_threads(omp_nthread_)
+                    for (int m = 0; m < nbf; m++) {
+
+                        int thread = 0;
+                        #ifdef _OPENMP
+                            thread = omp_get_thread_num();
+                        #endif
+
+                        float* Ctp = C_temp[thread].data();
+                        float* QSp = Q_temp[thread].data();
+
+                        const std::vector<int>& pairs = sieve_->function_to_function()[m];
+                        int rows = pairs.size();
+
+                        for (int i = 0; i < rows; i++) {
+                            int n = pairs[i];
+                            long int ij = function_pairs_reverse[(m >= n ? (m * (m + 1L) >> 1) + n : (n * (n + 1L) >> 1) + m)];
+                            for (int P = 0; P < naux; P++)
+                                QSp[P * (size_t) nbf + i] = Qmnp[P * num_nm + ij];
+                            for (int o = 0; o < nocc; o++)
+                                Ctp[o * (size_t) nbf + i] = (float) Cp[n][o];
+                        }
+
+                        C_SGEMM('N','T',nocc,naux,rows,1.0f,Ctp,nbf,QSp,nbf,0.0f,&E[m*(size_t)nocc*naux],naux);
+                    }
+                    flops += 2.0 * nocc * naux * npair;
+                }
+
+                float* Erp = (lr_symmetric_ ? E_left.data() : E_right.data());
+                C_SGEMM('N','T',nbf,nbf,naux*nocc,1.0f,E_left.data(),naux*nocc,Erp,naux*nocc,0.0f,K_temp.data(),nbf);
+                flops += 2.0 * nbf * nbf * naux * nocc;
+
+                double* K2p = Kp[0];
+                for (size_t mn = 0; mn < nbf * (size_t) nbf; mn++)
+                    K2p[mn] += K_temp[mn];
+            }
+        }
+
+        timer_off("JK: K");
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += (J_ao_.size() * num_nm + K_ao_.size() * npair) * naux_total;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
+}
 void DFJK::manage_wK_core()
 {
     int max_rows_w = max_rows_ / 2;
@@ -1810,6 +2183,7 @@ void DFJK::block_J(double** Qmnp, int naux)
 {
     const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
     size_t num_nm = function_pairs.size();
+    double start = wall_time();
 
     for (size_t N = 0; N < J_ao_.size(); N++) {
 
@@ -1838,12 +2212,29 @@ void DFJK::block_J(double** Qmnp, int naux)
             Jp[n][m] += (m == n ? 0.0 : J2p[mn]);
         }
     }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += J_ao_.size() * naux * num_nm;
+    metrics.flops += 4.0 * J_ao_.size() * naux * num_nm;
+    metrics.contraction_time += wall_time() - start;
 }
 void DFJK::block_K(double** Qmnp, int naux)
 {
+    if (local_K_) {
+        block_K_local(Qmnp, naux);
+        return;
+    }
+
     const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
     const std::vector<long int>& function_pairs_reverse = sieve_->function_pairs_reverse();
     size_t num_nm = function_pairs.size();
+    double start = wall_time();
+    double flops = 0.0;
+
+    // Pairs (m,n) gathered by the first-half GEMMs, summed over m
+    size_t npair = 0L;
+    for (size_t m = 0; m < sieve_->function_to_function().size(); m++)
+        npair += sieve_->function_to_function()[m].size();
 
     for (size_t N = 0; N < K_ao_.size(); N++) {
 
@@ -1887,6 +2278,7 @@ void DFJK::block_K(double** Qmnp, int naux)
             }
 
             timer_off("JK: K1");
+            flops += 2.0 * nocc * naux * npair;
 
         }
 
@@ -1923,6 +2315,7 @@ void DFJK::block_K(double** Qmnp, int naux)
                 }
 
                 timer_off("JK: K1");
+                flops += 2.0 * nocc * naux * npair;
 
             }
 
@@ -1931,14 +2324,182 @@ void DFJK::block_K(double** Qmnp, int naux)
         timer_on("JK: K2");
         C_DGEMM('N','T',nbf,nbf,naux*nocc,1.0,Elp[0],naux*nocc,Erp[0],naux*nocc,1.0,Kp[0],nbf);
         timer_off("JK: K2");
+        flops += 2.0 * nbf * nbf * naux * nocc;
     }
 
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += K_ao_.size() * naux * npair;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
+
+}
+void DFJK::localize_occupied()
+{
+    C_left_local_.clear();
+    C_right_local_.clear();
+    local_domains_.clear();
+
+    size_t ndomain = 0L;
+    size_t norbital = 0L;
+    for (size_t N = 0; N < C_left_ao_.size(); N++) {
+
+        // K is invariant to a common rotation of the left and right orbitals
+        if (N > 0 && C_left_[N].get() == C_left_[N-1].get() && C_right_[N].get() == C_right_[N-1].get()) {
+            C_left_local_.push_back(C_left_local_[N-1]);
+            C_right_local_.push_back(C_right_local_[N-1]);
+            local_domains_.push_back(local_domains_[N-1]);
+            continue;
+        }
+
+        int nbf = C_left_ao_[N]->rowspi()[0];
+        int nocc = C_left_ao_[N]->colspi()[0];
+
+        SharedMatrix Cl = C_left_ao_[N];
+        SharedMatrix Cr = C_right_ao_[N];
+        if (nocc) {
+            std::shared_ptr<Localizer> localizer = Localizer::build(local_K_localizer_, primary_, C_left_ao_[N]);
+            localizer->set_print(0);
+            localizer->localize();
+            SharedMatrix U = localizer->U();
+            Cl = Matrix::doublet(C_left_ao_[N], U);
+            Cr = (C_right_[N].get() == C_left_[N].get() ? Cl : Matrix::doublet(C_right_ao_[N], U));
+        }
+
+        double** Clp = Cl->pointer();
+        double** Crp = Cr->pointer();
+        std::vector<std::vector<int> > domains(nocc);
+        for (int i = 0; i < nocc; i++) {
+            for (int n = 0; n < nbf; n++) {
+                if (std::max(std::fabs(Clp[n][i]), std::fabs(Crp[n][i])) >= local_K_tolerance_)
+                    domains[i].push_back(n);
+            }
+            ndomain += domains[i].size();
+        }
+        norbital += nocc;
+
+        C_left_local_.push_back(Cl);
+        C_right_local_.push_back(Cr);
+        local_domains_.push_back(domains);
+    }
+
+    if (print_ > 1 && norbital) {
+        outfile->Printf("    Local K: %zu orbitals, average domain of %.1f of %d functions\n\n",
+            norbital, ndomain / (double) norbital, primary_->nbf());
+    }
+}
+void DFJK::block_K_local(double** Qmnp, int naux)
+{
+    const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
+    const std::vector<long int>& function_pairs_reverse = sieve_->function_pairs_reverse();
+    const std::vector<std::vector<int> >& function_to_function = sieve_->function_to_function();
+    size_t num_nm = function_pairs.size();
+    int nbf = primary_->nbf();
+    double start = wall_time();
+    double flops = 0.0;
+    size_t nints = 0L;
+
+    // Per-thread E_i = (Q|m n) C_ni and the AOs m it touches
+    std::vector<std::vector<double> > El_temp(omp_nthread_);
+    std::vector<std::vector<double> > Er_temp(omp_nthread_);
+    std::vector<std::vector<double> > K_temp(omp_nthread_);
+    std::vector<std::vector<int> > M_temp(omp_nthread_);
+    std::vector<std::vector<int> > local_temp(omp_nthread_, std::vector<int>(nbf, -1));
+
+    for (size_t N = 0; N < K_ao_.size(); N++) {
+
+        int nocc = C_left_local_[N]->colspi()[0];
+        if (!nocc) continue;
+
+        double** Clp = C_left_local_[N]->pointer();
+        double** Crp = C_right_local_[N]->pointer();
+        double** Kp  = K_ao_[N]->pointer();
+        bool same = lr_symmetric_ || C_left_local_[N].get() == C_right_local_[N].get();
+        const std::vector<std::vector<int> >& domains = local_domains_[N];
+
+        timer_on("JK: K Local");
+
+        #pragma omp parallel for schedule (dynamic) num_threads(omp_nthread_) reduction(+: flops, nints)
+        for (int i = 0; i < nocc; i++) {
+
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+
+            // => AOs paired with the domain of i <= //
+
+            std::vector<int>& M = M_temp[thread];
+            std::vector<int>& local = local_temp[thread];
+            M.clear();
+            const std::vector<int>& domain = domains[i];
+            for (int n : domain) {
+                for (int m : function_to_function[n]) {
+                    if (local[m] < 0) {
+                        local[m] = M.size();
+                        M.push_back(m);
+                    }
+                }
+            }
+            int nM = M.size();
+            if (!nM) continue;
+
+            // => E_i[m][Q] = sum_n (Q|mn) C_ni over the domain <= //
+
+            std::vector<double>& El = El_temp[thread];
+            std::vector<double>& Er = Er_temp[thread];
+            El.assign(nM * (size_t) naux, 0.0);
+            if (!same) Er.assign(nM * (size_t) naux, 0.0);
+            for (int n : domain) {
+                double cl = Clp[n][i];
+                double cr = Crp[n][i];
+                for (int m : function_to_function[n]) {
+                    long int ij = function_pairs_reverse[(m >= n ? (m * (m + 1L) >> 1) + n : (n * (n + 1L) >> 1) + m)];
+                    size_t ml = local[m];
+                    C_DAXPY(naux,cl,&Qmnp[0][ij],num_nm,&El[ml * naux],1);
+                    if (!same) C_DAXPY(naux,cr,&Qmnp[0][ij],num_nm,&Er[ml * naux],1);
+                }
+                size_t npair = function_to_function[n].size() * (size_t) naux;
+                nints += npair;
+                flops += (same ? 2.0 : 4.0) * npair;
+            }
+
+            // => K_mn += sum_Q E_i[m][Q] E_i[n][Q] <= //
+
+            std::vector<double>& Kt = K_temp[thread];
+            Kt.resize(nM * (size_t) nM);
+            C_DGEMM('N','T',nM,nM,naux,1.0,El.data(),naux,(same ? El.data() : Er.data()),naux,0.0,Kt.data(),nM);
+            flops += 2.0 * nM * nM * naux;
+
+            for (int a = 0; a < nM; a++) {
+                for (int b = 0; b < nM; b++) {
+                    #pragma omp atomic update
+                    Kp[M[a]][M[b]] += Kt[a * (size_t) nM + b];
+                }
+            }
+
+            for (int m : M) local[m] = -1;
+        }
+
+        timer_off("JK: K Local");
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += nints;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
 }
 void DFJK::block_wK(double** Qlmnp, double** Qrmnp, int naux)
 {
     const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
     const std::vector<long int>& function_pairs_reverse = sieve_->function_pairs_reverse();
     size_t num_nm = function_pairs.size();
+    double start = wall_time();
+    double flops = 0.0;
+
+    // Pairs (m,n) gathered by the first-half GEMMs, summed over m
+    size_t npair = 0L;
+    for (size_t m = 0; m < sieve_->function_to_function().size(); m++)
+        npair += sieve_->function_to_function()[m].size();
 
     for (size_t N = 0; N < wK_ao_.size(); N++) {
 
@@ -1982,6 +2543,7 @@ void DFJK::block_wK(double** Qlmnp, double** Qrmnp, int naux)
             }
 
             timer_off("JK: wK1");
+            flops += 2.0 * nocc * naux * npair;
 
         }
 
@@ -2012,10 +2574,17 @@ void DFJK::block_wK(double** Qlmnp, double** Qrmnp, int naux)
         }
 
         timer_off("JK: wK1");
+        flops += 2.0 * nocc * naux * npair;
 
         timer_on("JK: wK2");
         C_DGEMM('N','T',nbf,nbf,naux*nocc,1.0,Elp[0],naux*nocc,Erp[0],naux*nocc,1.0,wKp[0],nbf);
         timer_off("JK: wK2");
+        flops += 2.0 * nbf * nbf * naux * nocc;
     }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += wK_ao_.size() * naux * npair;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
 }
 }
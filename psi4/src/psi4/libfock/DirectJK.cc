@@ -45,9 +45,11 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/eri.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/lib3index/cholesky.h"
 
+#include <algorithm>
 #include <sstream>
 #include "psi4/libpsi4util/PsiOutStream.h"
 #ifdef _OPENMP
@@ -72,6 +74,13 @@ void DirectJK::common_init()
     #ifdef _OPENMP
         df_ints_num_threads_ = Process::environment.get_n_threads();
     #endif
+
+    density_screening_ = false;
+
+    incfock_ = false;
+    incfock_full_fock_every_ = 20;
+    incfock_count_ = 0;
+    do_incfock_iter_ = false;
 }
 void DirectJK::print_header() const
 {
@@ -85,36 +94,79 @@ void DirectJK::print_header() const
             outfile->Printf( "    Omega:             %11.3E\n", omega_);
         outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
         //outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf( "    Density Screening: %11s\n", (density_screening_ ? "Yes" : "No"));
+        outfile->Printf( "    Incremental Fock:  %11s\n", (incfock_ ? "Yes" : "No"));
+        if (incfock_)
+            outfile->Printf( "    Full Fock Every:   %11d\n", incfock_full_fock_every_);
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
     }
 }
 void DirectJK::preiterations()
 {
     sieve_ = std::shared_ptr<ERISieve>(new ERISieve(primary_, cutoff_));
+    incfock_count_ = 0;
+}
+bool DirectJK::incfock_possible() const
+{
+    if (!incfock_ || incfock_count_ == 0) return false;
+    if (incfock_full_fock_every_ > 0 && incfock_count_ % incfock_full_fock_every_ == 0) return false;
+    if (D_prev_.size() != D_ao_.size()) return false;
+    if (do_J_ && J_prev_.size() != D_ao_.size()) return false;
+    if (do_K_ && K_prev_.size() != D_ao_.size()) return false;
+    if (do_wK_ && wK_prev_.size() != D_ao_.size()) return false;
+    return true;
+}
+void DirectJK::incfock_store()
+{
+    D_prev_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
+    for (size_t N = 0; N < D_ao_.size(); N++) {
+        D_prev_.push_back(D_ao_[N]->clone());
+        if (do_J_) J_prev_.push_back(J_ao_[N]->clone());
+        if (do_K_) K_prev_.push_back(K_ao_[N]->clone());
+        if (do_wK_) wK_prev_.push_back(wK_ao_[N]->clone());
+    }
 }
 void DirectJK::compute_JK()
 {
     std::shared_ptr<IntegralFactory> factory(new IntegralFactory(primary_,primary_,primary_,primary_));
 
-    if (do_wK_) {
-        std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
-        for (int thread = 0; thread < df_ints_num_threads_; thread++) {
-            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_)));
-        }
-        // TODO: Fast K algorithm
-        if (do_J_) {
-            build_JK(ints,D_ao_,J_ao_,wK_ao_);
-        } else {
-            std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
-            }
-            build_JK(ints,D_ao_,temp,wK_ao_);
+    // => Incremental Fock build <= //
+
+    // J, K, and wK are linear in D, so J[D] = J[D_prev] + J[D - D_prev].
+    // As the SCF converges D - D_prev gets small, and density screening
+    // removes most of the shell quartets from the incremental build.
+
+    do_incfock_iter_ = incfock_possible();
+
+    std::vector<SharedMatrix> D_ao = D_ao_;
+    if (do_incfock_iter_) {
+        D_ao.clear();
+        for (size_t N = 0; N < D_ao_.size(); N++) {
+            SharedMatrix dD = D_ao_[N]->clone();
+            dD->subtract(D_prev_[N]);
+            D_ao.push_back(dD);
         }
     }
 
-    if (do_J_ || do_K_) {
-        std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+    // Long-range quartets are screened by their own bounds
+    if (do_wK_ && sieve_->omega() != omega_) {
+        sieve_->set_omega(omega_);
+    }
+
+    std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+    if (do_wK_ && (do_J_ || do_K_)) {
+        // J, K, and wK in one pass, the erf integrals reusing the primitive data of the Coulomb ones
+        for (int thread = 0; thread < df_ints_num_threads_; thread++) {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->coulomb_erf_eri(omega_)));
+        }
+    } else if (do_wK_) {
+        for (int thread = 0; thread < df_ints_num_threads_; thread++) {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_)));
+        }
+    } else if (do_J_ || do_K_) {
         ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
         for (int thread = 1; thread < df_ints_num_threads_; thread++) {
             if(ints[0]->cloneable())
@@ -122,32 +174,40 @@ void DirectJK::compute_JK()
             else
                 ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
         }
-        if (do_J_ && do_K_) {
-            build_JK(ints,D_ao_,J_ao_,K_ao_);
-        } else if (do_J_) {
-            std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
-            }
-            build_JK(ints,D_ao_,J_ao_,temp);
-        } else {
-            std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::shared_ptr<Matrix>(new Matrix("temp", primary_->nbf(), primary_->nbf())));
+    }
+
+    // Whichever of J, K, or wK is not wanted is neither accumulated nor allocated
+    if (!ints.empty()) {
+        std::vector<std::shared_ptr<Matrix> > none;
+        build_JK(ints, D_ao, (do_J_ ? J_ao_ : none), (do_K_ ? K_ao_ : none), (do_wK_ ? wK_ao_ : none));
+    }
+
+    if (incfock_) {
+        if (do_incfock_iter_) {
+            for (size_t N = 0; N < D_ao_.size(); N++) {
+                if (do_J_) J_ao_[N]->add(J_prev_[N]);
+                if (do_K_) K_ao_[N]->add(K_prev_[N]);
+                if (do_wK_) wK_ao_[N]->add(wK_prev_[N]);
             }
-            build_JK(ints,D_ao_,temp,K_ao_);
         }
+        incfock_store();
+        incfock_count_++;
     }
-
+    do_incfock_iter_ = false;
 }
 void DirectJK::postiterations()
 {
     sieve_.reset();
+    D_prev_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
 }
 void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
                         std::vector<std::shared_ptr<Matrix> >& D,
                         std::vector<std::shared_ptr<Matrix> >& J,
-                        std::vector<std::shared_ptr<Matrix> >& K)
+                        std::vector<std::shared_ptr<Matrix> >& K,
+                        std::vector<std::shared_ptr<Matrix> >& wK)
 {
     // => Zeroing <= //
 
@@ -157,6 +217,9 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
     for (size_t ind = 0; ind < K.size(); ind++) {
         K[ind]->zero();
     }
+    for (size_t ind = 0; ind < wK.size(); ind++) {
+        wK[ind]->zero();
+    }
 
     // => Sizing <= //
 
@@ -238,24 +301,71 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
     size_t ntask_pair = task_pairs.size();
     size_t ntask_pair2 = ntask_pair * ntask_pair;
 
+    // => Density Screening <= //
+
+    // Always used for incremental builds, where D is the density difference
+    bool density_screen = density_screening_ || do_incfock_iter_;
+    if (density_screen) {
+        sieve_->set_density(D);
+    }
+
     // => Intermediate Buffers <= //
 
+    // Each thread owns max_task x max_task stripes for the task it is working on, which
+    // are flushed atomically into J, K, and wK when the task is done. Only the stripes of
+    // the requested matrices are kept, so an empty J, K, or wK costs neither memory nor updates.
+    bool do_J = !J.empty();
+    bool do_K = !K.empty();
+    bool do_wK = !wK.empty();
+    size_t nXblock = (lr_symmetric_ ? 4L : 8L);
+    size_t nJblock = (do_J ? 2L : 0L);
+    size_t nKblock = (do_K ? nXblock : 0L);
+    size_t nwKblock = (do_wK ? nXblock : 0L);
+    size_t wKblock = nJblock + nKblock;
+
     std::vector<std::vector<std::shared_ptr<Matrix> > > JKT;
     for (int thread = 0; thread < nthread; thread++) {
         std::vector<std::shared_ptr<Matrix> > JK2;
         for (size_t ind = 0; ind < D.size(); ind++) {
-            JK2.push_back(std::shared_ptr<Matrix>(new Matrix("JKT", (lr_symmetric_ ? 6 : 10) * max_task, max_task)));
+            JK2.push_back(std::shared_ptr<Matrix>(new Matrix("JKT", (wKblock + nwKblock) * max_task, max_task)));
         }
         JKT.push_back(JK2);
     }
 
+    // => Range Separation <= //
+
+    // With J or K wanted too, wK comes from the erf buffer of a CoulombErfERI; alone, the
+    // integrals in ints are already the attenuated ones
+    bool coulomb = do_J || do_K;
+    bool fused = do_wK && coulomb;
+    std::vector<CoulombErfERI*> fused_ints;
+    if (fused) {
+        for (int thread = 0; thread < nthread; thread++) {
+            CoulombErfERI* eri = dynamic_cast<CoulombErfERI*>(ints[thread].get());
+            if (!eri) throw PSIEXCEPTION("DirectJK::build_JK: J/K with wK needs CoulombErfERI integrals.");
+            fused_ints.push_back(eri);
+        }
+    }
+
+    // => Shell Quartet Batches <= //
+
+    std::vector<std::vector<ShellQuartet> > batches(nthread);
+    std::vector<std::vector<std::pair<int, int> > > batch_RS2s(nthread);
+    std::vector<std::vector<char> > batch_erfs(nthread);
+    std::vector<std::vector<double> > batch_buffers(nthread);
+    std::vector<std::vector<double> > batch_erf_buffers(nthread);
+
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
+    size_t computed_ints = 0L;
+    size_t computed_erf_ints = 0L;
+    double int_time = 0.0;
+    double task_time = 0.0;
 
     // ==> Master Task Loop <== //
 
-    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_shells)
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_shells, computed_ints, computed_erf_ints, int_time, task_time)
     for (size_t task = 0L; task < ntask_pair2; task++) {
 
         size_t task1 = task / ntask_pair;
@@ -273,6 +383,8 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
         // regardless of Qtask's index
         if (Rtask > Ptask) continue;
 
+        double task_start = wall_time();
+
         //printf("Task: %2d %2d %2d %2d\n", Ptask, Qtask, Rtask, Stask);
 
         int nPtask = task_starts[Ptask + 1] - task_starts[Ptask];
@@ -295,184 +407,75 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             thread = omp_get_thread_num();
         #endif
 
-        // => Master shell quartet loops <= //
-
-        bool touched = false;
-        for (int P2 = P2start; P2 < P2start + nPtask; P2++) {
-        for (int Q2 = Q2start; Q2 < Q2start + nQtask; Q2++) {
-            if (Q2 > P2) continue;
-            int P = task_shells[P2];
-            int Q = task_shells[Q2];
-            if (!sieve_->shell_pair_significant(P,Q)) continue;
-        for (int R2 = R2start; R2 < R2start + nRtask; R2++) {
-        for (int S2 = S2start; S2 < S2start + nStask; S2++) {
-            if (S2 > R2) continue;
-            int R = task_shells[R2];
-            int S = task_shells[S2];
-            if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
-            if (!sieve_->shell_pair_significant(R,S)) continue;
-            if (!sieve_->shell_significant(P,Q,R,S)) continue;
-
-            //printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
-
-            //if (thread == 0) timer_on("JK: Ints");
-            if(ints[thread]->compute_shell(P,Q,R,S) == 0)
-                continue; // No integrals in this shell quartet
-            computed_shells++;
-            //if (thread == 0) timer_off("JK: Ints");
-
-            const double* buffer = ints[thread]->buffer();
+        // => Exchange stripes <= //
 
-            int Psize = primary_->shell(P).nfunction();
-            int Qsize = primary_->shell(Q).nfunction();
-            int Rsize = primary_->shell(R).nfunction();
-            int Ssize = primary_->shell(S).nfunction();
-
-            int Poff = primary_->shell(P).function_index();
-            int Qoff = primary_->shell(Q).function_index();
-            int Roff = primary_->shell(R).function_index();
-            int Soff = primary_->shell(S).function_index();
-
-            int Poff2 = task_offsets[P2] - task_offsets[P2start];
-            int Qoff2 = task_offsets[Q2] - task_offsets[Q2start];
-            int Roff2 = task_offsets[R2] - task_offsets[R2start];
-            int Soff2 = task_offsets[S2] - task_offsets[S2start];
-
-            //if (thread == 0) timer_on("JK: GEMV");
-            for (size_t ind = 0; ind < D.size(); ind++) {
-                double** Dp = D[ind]->pointer();
-                double** JKTp = JKT[thread][ind]->pointer();
-                const double* buffer2 = buffer;
-
-                if (!touched) {
-                    ::memset((void*) JKTp[0L * max_task], '\0', dPsize * dQsize * sizeof(double));
-                    ::memset((void*) JKTp[1L * max_task], '\0', dRsize * dSsize * sizeof(double));
-                    ::memset((void*) JKTp[2L * max_task], '\0', dPsize * dRsize * sizeof(double));
-                    ::memset((void*) JKTp[3L * max_task], '\0', dPsize * dSsize * sizeof(double));
-                    ::memset((void*) JKTp[4L * max_task], '\0', dQsize * dRsize * sizeof(double));
-                    ::memset((void*) JKTp[5L * max_task], '\0', dQsize * dSsize * sizeof(double));
-                    if (!lr_symmetric_) {
-                        ::memset((void*) JKTp[6L * max_task], '\0', dRsize * dPsize * sizeof(double));
-                        ::memset((void*) JKTp[7L * max_task], '\0', dSsize * dPsize * sizeof(double));
-                        ::memset((void*) JKTp[8L * max_task], '\0', dRsize * dQsize * sizeof(double));
-                        ::memset((void*) JKTp[9L * max_task], '\0', dSsize * dQsize * sizeof(double));
-                    }
-                }
-
-                double* J1p = JKTp[0L * max_task];
-                double* J2p = JKTp[1L * max_task];
-                double* K1p = JKTp[2L * max_task];
-                double* K2p = JKTp[3L * max_task];
-                double* K3p = JKTp[4L * max_task];
-                double* K4p = JKTp[5L * max_task];
-                double* K5p;
-                double* K6p;
-                double* K7p;
-                double* K8p;
+        // K and wK are digested and flushed alike, from X[0 .. nXblock) (rows of max_task)
+        auto zero_exchange = [&](double** X) {
+            ::memset((void*) X[0L * max_task], '\0', dPsize * dRsize * sizeof(double));
+            ::memset((void*) X[1L * max_task], '\0', dPsize * dSsize * sizeof(double));
+            ::memset((void*) X[2L * max_task], '\0', dQsize * dRsize * sizeof(double));
+            ::memset((void*) X[3L * max_task], '\0', dQsize * dSsize * sizeof(double));
+            if (!lr_symmetric_) {
+                ::memset((void*) X[4L * max_task], '\0', dRsize * dPsize * sizeof(double));
+                ::memset((void*) X[5L * max_task], '\0', dSsize * dPsize * sizeof(double));
+                ::memset((void*) X[6L * max_task], '\0', dRsize * dQsize * sizeof(double));
+                ::memset((void*) X[7L * max_task], '\0', dSsize * dQsize * sizeof(double));
+            }
+        };
+
+        auto digest_exchange = [&](double** X, double** Dp, const double* buffer2, double prefactor,
+                                   int Psize, int Qsize, int Rsize, int Ssize,
+                                   int Poff, int Qoff, int Roff, int Soff,
+                                   int Poff2, int Qoff2, int Roff2, int Soff2) {
+            double* K1p = X[0L * max_task];
+            double* K2p = X[1L * max_task];
+            double* K3p = X[2L * max_task];
+            double* K4p = X[3L * max_task];
+            double* K5p = nullptr;
+            double* K6p = nullptr;
+            double* K7p = nullptr;
+            double* K8p = nullptr;
+            if (!lr_symmetric_) {
+                K5p = X[4L * max_task];
+                K6p = X[5L * max_task];
+                K7p = X[6L * max_task];
+                K8p = X[7L * max_task];
+            }
+            for (int p = 0; p < Psize; p++) {
+            for (int q = 0; q < Qsize; q++) {
+            for (int r = 0; r < Rsize; r++) {
+            for (int s = 0; s < Ssize; s++) {
+                K1p[(p + Poff2) * dRsize + r + Roff2] += prefactor * (Dp[q + Qoff][s + Soff]) * (*buffer2);
+                K2p[(p + Poff2) * dSsize + s + Soff2] += prefactor * (Dp[q + Qoff][r + Roff]) * (*buffer2);
+                K3p[(q + Qoff2) * dRsize + r + Roff2] += prefactor * (Dp[p + Poff][s + Soff]) * (*buffer2);
+                K4p[(q + Qoff2) * dSsize + s + Soff2] += prefactor * (Dp[p + Poff][r + Roff]) * (*buffer2);
                 if (!lr_symmetric_) {
-                    K5p = JKTp[6L * max_task];
-                    K6p = JKTp[7L * max_task];
-                    K7p = JKTp[8L * max_task];
-                    K8p = JKTp[9L * max_task];
+                    K5p[(r + Roff2) * dPsize + p + Poff2] += prefactor * (Dp[s + Soff][q + Qoff]) * (*buffer2);
+                    K6p[(s + Soff2) * dPsize + p + Poff2] += prefactor * (Dp[r + Roff][q + Qoff]) * (*buffer2);
+                    K7p[(r + Roff2) * dQsize + q + Qoff2] += prefactor * (Dp[s + Soff][p + Poff]) * (*buffer2);
+                    K8p[(s + Soff2) * dQsize + q + Qoff2] += prefactor * (Dp[r + Roff][p + Poff]) * (*buffer2);
                 }
-
-                double prefactor = 1.0;
-                if (P == Q)           prefactor *= 0.5;
-                if (R == S)           prefactor *= 0.5;
-                if (P == R && Q == S) prefactor *= 0.5;
-
-                for (int p = 0; p < Psize; p++) {
-                for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                for (int s = 0; s < Ssize; s++) {
-                    J1p[(p + Poff2) * dQsize + q + Qoff2] += prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) * (*buffer2);
-                    J2p[(r + Roff2) * dSsize + s + Soff2] += prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) * (*buffer2);
-                    K1p[(p + Poff2) * dRsize + r + Roff2] += prefactor * (Dp[q + Qoff][s + Soff]) * (*buffer2);
-                    K2p[(p + Poff2) * dSsize + s + Soff2] += prefactor * (Dp[q + Qoff][r + Roff]) * (*buffer2);
-                    K3p[(q + Qoff2) * dRsize + r + Roff2] += prefactor * (Dp[p + Poff][s + Soff]) * (*buffer2);
-                    K4p[(q + Qoff2) * dSsize + s + Soff2] += prefactor * (Dp[p + Poff][r + Roff]) * (*buffer2);
-                    if (!lr_symmetric_) {
-                        K5p[(r + Roff2) * dPsize + p + Poff2] += prefactor * (Dp[s + Soff][q + Qoff]) * (*buffer2);
-                        K6p[(s + Soff2) * dPsize + p + Poff2] += prefactor * (Dp[r + Roff][q + Qoff]) * (*buffer2);
-                        K7p[(r + Roff2) * dQsize + q + Qoff2] += prefactor * (Dp[s + Soff][p + Poff]) * (*buffer2);
-                        K8p[(s + Soff2) * dQsize + q + Qoff2] += prefactor * (Dp[r + Roff][p + Poff]) * (*buffer2);
-                    }
-                    buffer2++;
-                }}}}
-
-            }
-            touched = true;
-            //if (thread == 0) timer_off("JK: GEMV");
-
-        }}}} // End Shell Quartets
-
-        if (!touched) continue;
-
-        // => Stripe out <= //
-
-        //if (thread == 0) timer_on("JK: Atomic");
-        for (size_t ind = 0; ind < D.size(); ind++) {
-            double** JKTp = JKT[thread][ind]->pointer();
-            double** Jp = J[ind]->pointer();
-            double** Kp = K[ind]->pointer();
-
-            double* J1p = JKTp[0L * max_task];
-            double* J2p = JKTp[1L * max_task];
-            double* K1p = JKTp[2L * max_task];
-            double* K2p = JKTp[3L * max_task];
-            double* K3p = JKTp[4L * max_task];
-            double* K4p = JKTp[5L * max_task];
-            double* K5p;
-            double* K6p;
-            double* K7p;
-            double* K8p;
+                buffer2++;
+            }}}}
+        };
+
+        auto flush_exchange = [&](double** Kp, double** X) {
+            double* K1p = X[0L * max_task];
+            double* K2p = X[1L * max_task];
+            double* K3p = X[2L * max_task];
+            double* K4p = X[3L * max_task];
+            double* K5p = nullptr;
+            double* K6p = nullptr;
+            double* K7p = nullptr;
+            double* K8p = nullptr;
             if (!lr_symmetric_) {
-                K5p = JKTp[6L * max_task];
-                K6p = JKTp[7L * max_task];
-                K7p = JKTp[8L * max_task];
-                K8p = JKTp[9L * max_task];
+                K5p = X[4L * max_task];
+                K6p = X[5L * max_task];
+                K7p = X[6L * max_task];
+                K8p = X[7L * max_task];
             }
 
-            // > J_PQ < //
-
-            for (int P2 = 0; P2 < nPtask; P2++) {
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                int P = task_shells[P2start + P2];
-                int Q = task_shells[Q2start + Q2];
-                int Psize = primary_->shell(P).nfunction();
-                int Qsize = primary_->shell(Q).nfunction();
-                int Poff =  primary_->shell(P).function_index();
-                int Qoff =  primary_->shell(Q).function_index();
-                int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                for (int p = 0; p < Psize; p++) {
-                for (int q = 0; q < Qsize; q++) {
-                    #pragma omp atomic
-                    Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
-                }}
-            }}
-
-            // > J_RS < //
-
-            for (int R2 = 0; R2 < nRtask; R2++) {
-            for (int S2 = 0; S2 < nStask; S2++) {
-                int R = task_shells[R2start + R2];
-                int S = task_shells[S2start + S2];
-                int Rsize = primary_->shell(R).nfunction();
-                int Ssize = primary_->shell(S).nfunction();
-                int Roff =  primary_->shell(R).function_index();
-                int Soff =  primary_->shell(S).function_index();
-                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                for (int r = 0; r < Rsize; r++) {
-                for (int s = 0; s < Ssize; s++) {
-                    #pragma omp atomic
-                    Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
-                }}
-            }}
-
             // > K_PR < //
-
             for (int P2 = 0; P2 < nPtask; P2++) {
             for (int R2 = 0; R2 < nRtask; R2++) {
                 int P = task_shells[P2start + P2];
@@ -495,7 +498,6 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             }}
 
             // > K_PS < //
-
             for (int P2 = 0; P2 < nPtask; P2++) {
             for (int S2 = 0; S2 < nStask; S2++) {
                 int P = task_shells[P2start + P2];
@@ -518,7 +520,6 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             }}
 
             // > K_QR < //
-
             for (int Q2 = 0; Q2 < nQtask; Q2++) {
             for (int R2 = 0; R2 < nRtask; R2++) {
                 int Q = task_shells[Q2start + Q2];
@@ -541,7 +542,6 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             }}
 
             // > K_QS < //
-
             for (int Q2 = 0; Q2 < nQtask; Q2++) {
             for (int S2 = 0; S2 < nStask; S2++) {
                 int Q = task_shells[Q2start + Q2];
@@ -562,25 +562,253 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
                     }
                 }}
             }}
+        };
+
+        // => Master shell quartet loops <= //
+
+        bool touched = false;
+        for (int P2 = P2start; P2 < P2start + nPtask; P2++) {
+        for (int Q2 = Q2start; Q2 < Q2start + nQtask; Q2++) {
+            if (Q2 > P2) continue;
+            int P = task_shells[P2];
+            int Q = task_shells[Q2];
+            if (!sieve_->shell_pair_significant(P,Q)) continue;
+        // Gather the surviving (RS| for this |PQ) and compute them as one
+        // batch, ordered by ket angular momenta so backends can vectorize
+        std::vector<ShellQuartet>& batch = batches[thread];
+        std::vector<std::pair<int, int> >& batch_RS2 = batch_RS2s[thread];
+        std::vector<char>& batch_erf = batch_erfs[thread];
+        batch.clear();
+        batch_RS2.clear();
+        batch_erf.clear();
+        for (int R2 = R2start; R2 < R2start + nRtask; R2++) {
+        for (int S2 = S2start; S2 < S2start + nStask; S2++) {
+            if (S2 > R2) continue;
+            int R = task_shells[R2];
+            int S = task_shells[S2];
+            if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
+            if (!sieve_->shell_pair_significant(R,S)) continue;
+            // (MN|erf|MN) <= (MN|MN), so a fused pass only ever drops the erf half of a quartet
+            bool erf = do_wK && sieve_->shell_significant_erf(P,Q,R,S);
+            if (coulomb) {
+                if (!sieve_->shell_significant(P,Q,R,S)) continue;
+                if (density_screen && !sieve_->shell_significant_density(P,Q,R,S)) continue;
+            } else if (!erf) {
+                continue;
+            }
+            batch_RS2.push_back(std::pair<int,int>(R2,S2));
+        }}
+        if (batch_RS2.empty()) continue;
+
+        std::stable_sort(batch_RS2.begin(), batch_RS2.end(),
+            [&](const std::pair<int,int>& a, const std::pair<int,int>& b) {
+                int amRa = primary_->shell(task_shells[a.first]).am();
+                int amRb = primary_->shell(task_shells[b.first]).am();
+                if (amRa != amRb) return amRa < amRb;
+                return primary_->shell(task_shells[a.second]).am() <
+                       primary_->shell(task_shells[b.second]).am();
+        });
+        for (const auto& RS2 : batch_RS2) {
+            ShellQuartet quartet = {{P, Q, task_shells[RS2.first], task_shells[RS2.second]}};
+            batch.push_back(quartet);
+            batch_erf.push_back(do_wK && sieve_->shell_significant_erf(P, Q, quartet[2], quartet[3]));
+        }
+
+        std::vector<double>& batch_buffer = batch_buffers[thread];
+        std::vector<double>& batch_erf_buffer = batch_erf_buffers[thread];
+        size_t batch_ints = ints[thread]->batch_size(batch);
+        if (batch_buffer.size() < batch_ints) batch_buffer.resize(batch_ints);
+        if (fused && batch_erf_buffer.size() < batch_ints) batch_erf_buffer.resize(batch_ints);
+
+        double int_start = wall_time();
+        if (fused) {
+            fused_ints[thread]->compute_shell_batch(batch, batch_erf, batch_buffer.data(), batch_erf_buffer.data());
+        } else {
+            ints[thread]->compute_shell_batch(batch, batch_buffer.data());
+        }
+        int_time += wall_time() - int_start;
+        computed_shells += batch.size();
+
+        // Coulomb integrals in buffer and attenuated ones in erf_buffer, or attenuated ones
+        // only, in buffer, when there is no J or K
+        const double* buffer = batch_buffer.data();
+        const double* erf_buffer = (fused ? batch_erf_buffer.data() : batch_buffer.data());
+        for (size_t RSind = 0; RSind < batch_RS2.size(); RSind++) {
+            const auto& RS2 = batch_RS2[RSind];
+            bool erf = batch_erf[RSind];
+            int R2 = RS2.first;
+            int S2 = RS2.second;
+            int R = task_shells[R2];
+            int S = task_shells[S2];
+
+            int Psize = primary_->shell(P).nfunction();
+            int Qsize = primary_->shell(Q).nfunction();
+            int Rsize = primary_->shell(R).nfunction();
+            int Ssize = primary_->shell(S).nfunction();
+
+            int Poff = primary_->shell(P).function_index();
+            int Qoff = primary_->shell(Q).function_index();
+            int Roff = primary_->shell(R).function_index();
+            int Soff = primary_->shell(S).function_index();
+
+            int Poff2 = task_offsets[P2] - task_offsets[P2start];
+            int Qoff2 = task_offsets[Q2] - task_offsets[Q2start];
+            int Roff2 = task_offsets[R2] - task_offsets[R2start];
+            int Soff2 = task_offsets[S2] - task_offsets[S2start];
+
+            size_t nPQRS = (size_t) Psize * Qsize * Rsize * Ssize;
+            if (coulomb) computed_ints += nPQRS;
+            if (do_wK && erf) computed_erf_ints += nPQRS;
+
+            double prefactor = 1.0;
+            if (P == Q)           prefactor *= 0.5;
+            if (R == S)           prefactor *= 0.5;
+            if (P == R && Q == S) prefactor *= 0.5;
+
+            //if (thread == 0) timer_on("JK: GEMV");
+            for (size_t ind = 0; ind < D.size(); ind++) {
+                double** Dp = D[ind]->pointer();
+                double** JKTp = JKT[thread][ind]->pointer();
+
+                if (!touched) {
+                    if (do_J) {
+                        ::memset((void*) JKTp[0L * max_task], '\0', dPsize * dQsize * sizeof(double));
+                        ::memset((void*) JKTp[1L * max_task], '\0', dRsize * dSsize * sizeof(double));
+                    }
+                    if (do_K) zero_exchange(JKTp + nJblock * max_task);
+                    if (do_wK) zero_exchange(JKTp + wKblock * max_task);
+                }
+
+                if (do_J) {
+                    double* J1p = JKTp[0L * max_task];
+                    double* J2p = JKTp[1L * max_task];
+                    const double* buffer2 = buffer;
+                    for (int p = 0; p < Psize; p++) {
+                    for (int q = 0; q < Qsize; q++) {
+                    for (int r = 0; r < Rsize; r++) {
+                    for (int s = 0; s < Ssize; s++) {
+                        J1p[(p + Poff2) * dQsize + q + Qoff2] += prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) * (*buffer2);
+                        J2p[(r + Roff2) * dSsize + s + Soff2] += prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) * (*buffer2);
+                        buffer2++;
+                    }}}}
+                }
+
+                if (do_K) {
+                    digest_exchange(JKTp + nJblock * max_task, Dp, buffer, prefactor, Psize, Qsize, Rsize, Ssize,
+                                    Poff, Qoff, Roff, Soff, Poff2, Qoff2, Roff2, Soff2);
+                }
+                if (do_wK && erf) {
+                    digest_exchange(JKTp + wKblock * max_task, Dp, erf_buffer, prefactor, Psize, Qsize, Rsize, Ssize,
+                                    Poff, Qoff, Roff, Soff, Poff2, Qoff2, Roff2, Soff2);
+                }
+            }
+            touched = true;
+            buffer += nPQRS;
+            erf_buffer += nPQRS;
+        }
+        }} // End Shell Quartets
+
+        if (!touched) {
+            task_time += wall_time() - task_start;
+            continue;
+        }
+
+        // => Stripe out <= //
+
+        //if (thread == 0) timer_on("JK: Atomic");
+        for (size_t ind = 0; ind < D.size(); ind++) {
+            double** JKTp = JKT[thread][ind]->pointer();
+            double** Jp = (do_J ? J[ind]->pointer() : nullptr);
+            double* J1p = (do_J ? JKTp[0L * max_task] : nullptr);
+            double* J2p = (do_J ? JKTp[1L * max_task] : nullptr);
+
+            // > J_PQ < //
+
+            if (do_J) {
+                for (int P2 = 0; P2 < nPtask; P2++) {
+                for (int Q2 = 0; Q2 < nQtask; Q2++) {
+                    int P = task_shells[P2start + P2];
+                    int Q = task_shells[Q2start + Q2];
+                    int Psize = primary_->shell(P).nfunction();
+                    int Qsize = primary_->shell(Q).nfunction();
+                    int Poff =  primary_->shell(P).function_index();
+                    int Qoff =  primary_->shell(Q).function_index();
+                    int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
+                    int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
+                    for (int p = 0; p < Psize; p++) {
+                    for (int q = 0; q < Qsize; q++) {
+                        #pragma omp atomic
+                        Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
+                    }}
+                }}
+            }
+
+            // > J_RS < //
+
+            if (do_J) {
+                for (int R2 = 0; R2 < nRtask; R2++) {
+                for (int S2 = 0; S2 < nStask; S2++) {
+                    int R = task_shells[R2start + R2];
+                    int S = task_shells[S2start + S2];
+                    int Rsize = primary_->shell(R).nfunction();
+                    int Ssize = primary_->shell(S).nfunction();
+                    int Roff =  primary_->shell(R).function_index();
+                    int Soff =  primary_->shell(S).function_index();
+                    int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
+                    int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
+                    for (int r = 0; r < Rsize; r++) {
+                    for (int s = 0; s < Ssize; s++) {
+                        #pragma omp atomic
+                        Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
+                    }}
+                }}
+            }
+
+            if (do_K) flush_exchange(K[ind]->pointer(), JKTp + nJblock * max_task);
+            if (do_wK) flush_exchange(wK[ind]->pointer(), JKTp + wKblock * max_task);
 
         } // End stripe out
         //if (thread == 0) timer_off("JK: Atomic");
 
+        task_time += wall_time() - task_start;
+
     } // End master task list
 
-    for (size_t ind = 0; ind < D.size(); ind++) {
+    if (density_screen) {
+        sieve_->clear_density();
+    }
+
+    for (size_t ind = 0; ind < J.size(); ind++) {
         J[ind]->scale(2.0);
         J[ind]->hermitivitize();
-        if (lr_symmetric_) {
+    }
+    if (lr_symmetric_) {
+        for (size_t ind = 0; ind < K.size(); ind++) {
             K[ind]->scale(2.0);
             K[ind]->hermitivitize();
         }
+        for (size_t ind = 0; ind < wK.size(); ind++) {
+            wK[ind]->scale(2.0);
+            wK[ind]->hermitivitize();
+        }
     }
 
+    size_t ntri = nshell * (nshell + 1L) / 2L;
+    size_t possible_shells = ntri * (ntri + 1L) / 2L;
+
+    // Per integral and density: 2 J updates of 4 flops, 4 (8 if nonsymmetric) K or wK updates of 3
+    JKMetrics& metrics = current_metrics();
+    metrics.shells_computed += computed_shells;
+    metrics.shells_screened += possible_shells - computed_shells;
+    metrics.integrals += computed_ints + computed_erf_ints;
+    metrics.integral_time += int_time;
+    metrics.contraction_time += task_time - int_time;
+    double Xflops = (lr_symmetric_ ? 12.0 : 24.0);
+    metrics.flops += D.size() * ((do_J ? 8.0 : 0.0) + (do_K ? Xflops : 0.0)) * computed_ints;
+    metrics.flops += D.size() * Xflops * computed_erf_ints;
+
     if (bench_) {
        std::shared_ptr<PsiOutStream> printer(new PsiOutStream("bench.dat",std::ostream::app));
-        size_t ntri = nshell * (nshell + 1L) / 2L;
-        size_t possible_shells = ntri * (ntri + 1L) / 2L;
         printer->Printf( "Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells, possible_shells, computed_shells / (double) possible_shells);
     }
 }
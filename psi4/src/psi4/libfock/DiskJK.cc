@@ -102,6 +102,10 @@ void DiskJK::preiterations()
 }
 void DiskJK::compute_JK()
 {
+    double start = wall_time();
+    size_t nint_JK = 0L;
+    size_t nint_wK = 0L;
+
     std::shared_ptr<PSIO> psio(new PSIO());
     IWL *iwl = new IWL(psio.get(), PSIF_SO_TEI, cutoff_, 1, 1);
     Label *lblptr = iwl->labels();
@@ -275,6 +279,7 @@ void DiskJK::compute_JK()
                     }
                 }
             } /* end loop through current buffer */
+            nint_JK += iwl->buffer_count();
             if(!lastBuffer) iwl->fetch();
         }while(!lastBuffer);
 
@@ -454,6 +459,7 @@ void DiskJK::compute_JK()
                     }
                 }
             } /* end loop through current buffer */
+            nint_JK += iwl->buffer_count();
             if(!lastBuffer) iwl->fetch();
         }while(!lastBuffer);
 
@@ -584,6 +590,7 @@ void DiskJK::compute_JK()
                     }
                 }
             } /* end loop through current buffer */
+            nint_wK += iwl->buffer_count();
             if(!lastBuffer) iwl->fetch();
         }while(!lastBuffer);
 
@@ -593,6 +600,14 @@ void DiskJK::compute_JK()
         iwl->set_keep_flag(1);
         delete iwl;
     }
+
+    // Per integral and density: up to 4 J and 8 K (or wK) multiply-adds
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals = nint_JK + nint_wK;
+    metrics.flops = D_.size() * ((do_J_ ? 8.0 : 0.0) + (do_K_ ? 16.0 : 0.0)) * nint_JK
+                  + D_.size() * 16.0 * nint_wK;
+    metrics.contraction_time = wall_time() - start;
+    metrics.psio_bytes += psio->bytes_read();
 }
 void DiskJK::postiterations()
 {
@@ -0,0 +1,336 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/lib3index/dftensor.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include "jk.h"
+
+#include <algorithm>
+#include <climits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+// MPI counts are ints, large buffers go over in chunks
+const size_t max_mpi_count = INT_MAX / 2;
+
+void dist_allreduce(double* buffer, size_t size)
+{
+#ifdef HAVE_MPI
+    for (size_t offset = 0L; offset < size; offset += max_mpi_count) {
+        int count = (int) std::min(max_mpi_count, size - offset);
+        MPI_Allreduce(MPI_IN_PLACE, buffer + offset, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+#else
+    // One rank already holds the sum
+    (void) buffer;
+    (void) size;
+#endif
+}
+
+void dist_reduce(double* send, double* recv, size_t size, int root)
+{
+#ifdef HAVE_MPI
+    for (size_t offset = 0L; offset < size; offset += max_mpi_count) {
+        int count = (int) std::min(max_mpi_count, size - offset);
+        MPI_Reduce(send + offset, (recv == nullptr ? nullptr : recv + offset), count, MPI_DOUBLE, MPI_SUM, root, MPI_COMM_WORLD);
+    }
+#else
+    (void) root;
+    ::memcpy((void*) recv, (void*) send, sizeof(double) * size);
+#endif
+}
+
+}
+
+DistDFJK::DistDFJK(std::shared_ptr<BasisSet> primary,
+   std::shared_ptr<BasisSet> auxiliary) :
+   DFJK(primary, auxiliary)
+{
+    rank_ = 0;
+    nrank_ = 1;
+#ifdef HAVE_MPI
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) {
+        throw PSIEXCEPTION("DistDFJK: MPI has not been initialized (e.g., import mpi4py before psi4).");
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank_);
+#endif
+}
+DistDFJK::~DistDFJK()
+{
+}
+void DistDFJK::print_header() const
+{
+    if (print_) {
+        outfile->Printf( "  ==> DistDFJK: Distributed Density-Fitted J/K Matrices <==\n\n");
+
+        outfile->Printf( "    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf( "    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf( "    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf( "    MPI ranks:         %11d\n", nrank_);
+        outfile->Printf( "    OpenMP threads:    %11d\n", omp_nthread_);
+        outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf( "    Local Q rows:      %11d\n", naux_local());
+        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf( "    Fitting Condition: %11.0E\n\n", condition_);
+
+        outfile->Printf( "   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+void DistDFJK::partition_aux()
+{
+    int naux = auxiliary_->nbf();
+    int nshell = auxiliary_->nshell();
+
+    aux_shell_starts_.assign(nrank_ + 1, nshell);
+    aux_starts_.assign(nrank_ + 1, naux);
+    aux_shell_starts_[0] = 0;
+    aux_starts_[0] = 0;
+
+    // Close each slab once it reaches its share of functions
+    int rank = 1;
+    for (int P = 0; P < nshell && rank < nrank_; P++) {
+        int Pend = auxiliary_->shell(P).function_index() + auxiliary_->shell(P).nfunction();
+        if ((size_t) Pend >= (rank * (size_t) naux) / nrank_) {
+            aux_shell_starts_[rank] = P + 1;
+            aux_starts_[rank] = Pend;
+            rank++;
+        }
+    }
+}
+void DistDFJK::preiterations()
+{
+    if (do_wK_) {
+        throw PSIEXCEPTION("DistDFJK: wK integrals are not implemented.");
+    }
+
+    // DF requires constant sieve, must be static throughout object life
+    if (!sieve_) {
+        sieve_ = std::shared_ptr<ERISieve>(new ERISieve(primary_, cutoff_));
+    }
+
+    // Each rank keeps its slab in core
+    is_core_ = true;
+
+    partition_aux();
+    initialize_JK_core();
+}
+void DistDFJK::compute_JK()
+{
+    max_nocc_ = max_nocc();
+    max_rows_ = std::max(1, std::min(max_rows(), naux_local()));
+
+    if (do_J_ || do_K_) {
+        initialize_temps();
+        manage_JK_core();
+        free_temps();
+    }
+
+    // Sum the slab contributions over ranks
+    if (nrank_ > 1) {
+        timer_on("JK: Allreduce");
+        int nbf = primary_->nbf();
+        for (size_t N = 0; N < D_ao_.size(); N++) {
+            if (do_J_) dist_allreduce(J_ao_[N]->pointer()[0], nbf * (size_t) nbf);
+            if (do_K_) dist_allreduce(K_ao_[N]->pointer()[0], nbf * (size_t) nbf);
+        }
+        timer_off("JK: Allreduce");
+    }
+}
+void DistDFJK::manage_JK_core()
+{
+    int nlocal = naux_local();
+    for (int Q = 0 ; Q < nlocal; Q += max_rows_) {
+        int naux = (nlocal - Q <= max_rows_ ? nlocal - Q : max_rows_);
+        if (do_J_) {
+            timer_on("JK: J");
+            block_J(&Qmn_->pointer()[Q],naux);
+            timer_off("JK: J");
+        }
+        if (do_K_) {
+            timer_on("JK: K");
+            block_K(&Qmn_->pointer()[Q],naux);
+            timer_off("JK: K");
+        }
+    }
+}
+void DistDFJK::initialize_JK_core()
+{
+    size_t ntri = sieve_->function_pairs().size();
+    int naux = auxiliary_->nbf();
+    int nlocal = naux_local();
+    int Astart = aux_starts_[rank_];
+
+    int nthread = 1;
+    #ifdef _OPENMP
+        nthread = df_ints_num_threads_;
+    #endif
+
+    const std::vector<long int>& schwarz_fun_pairs = sieve_->function_pairs_reverse();
+    const std::vector<std::pair<int,int> >& shell_pairs = sieve_->shell_pairs();
+
+    // => Raw (A|mn) for the local A slab <= //
+
+    SharedMatrix Amn(new Matrix("Amn (Local Raw Integrals)", nlocal, ntri));
+    double** Amnp = Amn->pointer();
+
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    std::shared_ptr<IntegralFactory> rifactory(new IntegralFactory(auxiliary_, zero, primary_, primary_));
+    std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+    eri.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory->eri()));
+    for (int thread = 1; thread < nthread; thread++) {
+        if (eri[0]->cloneable())
+            eri.push_back(std::shared_ptr<TwoBodyAOInt>(eri[0]->clone()));
+        else
+            eri.push_back(std::shared_ptr<TwoBodyAOInt>(rifactory->eri()));
+    }
+
+    timer_on("JK: (A|mn)");
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t MN = 0L; MN < shell_pairs.size(); MN++) {
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        int M = shell_pairs[MN].first;
+        int N = shell_pairs[MN].second;
+        int nM = primary_->shell(M).nfunction();
+        int nN = primary_->shell(N).nfunction();
+        int oM = primary_->shell(M).function_index();
+        int oN = primary_->shell(N).function_index();
+        const double* buffer = eri[thread]->buffer();
+
+        for (int P = aux_shell_starts_[rank_]; P < aux_shell_starts_[rank_ + 1]; P++) {
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index() - Astart;
+            eri[thread]->compute_shell(P, 0, M, N);
+            for (int p = 0; p < nP; p++) {
+                for (int m = 0; m < nM; m++) {
+                    for (int n = 0; n < nN; n++) {
+                        int om = m + oM;
+                        int on = n + oN;
+                        if (om < on) continue;
+                        long int sfp = schwarz_fun_pairs[(om * (om + 1L) >> 1) + on];
+                        if (sfp < 0) continue;
+                        Amnp[p + oP][sfp] = buffer[(p * nM + m) * nN + n];
+                    }
+                }
+            }
+        }
+    }
+
+    timer_off("JK: (A|mn)");
+
+    eri.clear();
+
+    // => (Q|A)^-1/2, replicated on every rank <= //
+
+    timer_on("JK: (A|Q)^-1/2");
+
+    std::shared_ptr<FittingMetric> Jinv(new FittingMetric(auxiliary_, true));
+    Jinv->form_eig_inverse(condition_);
+    double** Jinvp = Jinv->get_metric()->pointer();
+
+    timer_off("JK: (A|Q)^-1/2");
+
+    // => (Q|mn) = (Q|A)^-1/2 (A|mn), reduced onto the owner of each Q slab <= //
+
+    Qmn_ = SharedMatrix(new Matrix("Qmn (Fitted Integrals)", nlocal, ntri));
+    double** Qmnp = Qmn_->pointer();
+
+    int max_slab = 0;
+    for (int r = 0; r < nrank_; r++) {
+        max_slab = std::max(max_slab, aux_starts_[r + 1] - aux_starts_[r]);
+    }
+
+    size_t used = 2L * nlocal * ntri + (size_t) naux * naux;
+    size_t max_cols = (memory_ > used ? (memory_ - used) / (2L * std::max(max_slab, 1)) : 1L);
+    if (max_cols < 1)
+        max_cols = 1;
+    if (max_cols > ntri)
+        max_cols = ntri;
+
+    SharedMatrix send(new Matrix("Qmn send buffer", max_slab, max_cols));
+    SharedMatrix recv(new Matrix("Qmn recv buffer", max_slab, max_cols));
+    double** sendp = send->pointer();
+    double** recvp = recv->pointer();
+
+    timer_on("JK: (Q|mn)");
+
+    for (int r = 0; r < nrank_; r++) {
+        int Qstart = aux_starts_[r];
+        int nQ = aux_starts_[r + 1] - aux_starts_[r];
+        if (!nQ) continue;
+
+        for (size_t col = 0L; col < ntri; col += max_cols) {
+            size_t ncol = (ntri - col <= max_cols ? ntri - col : max_cols);
+
+            if (nlocal) {
+                C_DGEMM('N','N', nQ, ncol, nlocal, 1.0, &Jinvp[Qstart][Astart], naux,
+                    &Amnp[0][col], ntri, 0.0, sendp[0], ncol);
+            } else {
+                ::memset((void*) sendp[0], '\0', sizeof(double) * nQ * ncol);
+            }
+
+            dist_reduce(sendp[0], (rank_ == r ? recvp[0] : nullptr), nQ * ncol, r);
+
+            if (rank_ == r) {
+                for (int Q = 0; Q < nQ; Q++) {
+                    C_DCOPY(ncol, &recvp[0][Q * ncol], 1, &Qmnp[Q][col], 1);
+                }
+            }
+        }
+    }
+
+    timer_off("JK: (Q|mn)");
+}
+
+}
@@ -27,15 +27,19 @@
  */
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/libfock/jk.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
 #ifdef ENABLE_GTFOCK
 #include <GTFock/MinimalInterface.h>
 #else
 namespace psi {
 struct MinimalInterface{
-    MinimalInterface(size_t,bool)
+    MinimalInterface()
     {
         throw PSIEXCEPTION("PSI4 has not been compiled with GTFock support");
     }
+    void create_pfock(size_t,bool){}
+    void destroy_gtfock(){}
     void SetP(std::vector<SharedMatrix>&){}
     void GetJ(std::vector<SharedMatrix>&){}
     void GetK(std::vector<SharedMatrix>&){}
@@ -44,23 +48,61 @@ struct MinimalInterface{
 }
 #endif
 
-
-#ifdef ENABLE_GTFOCK
 namespace psi {
+bool JK::gtfock_available() {
+#ifdef ENABLE_GTFOCK
+    return true;
+#else
+    return false;
+#endif
+}
+
 GTFockJK::GTFockJK(std::shared_ptr<psi::BasisSet> Primary) :
       JK(Primary),Impl_(new MinimalInterface()){
 
 }
+
+GTFockJK::GTFockJK(std::shared_ptr<psi::BasisSet> Primary, size_t NMats, bool AreSymm) :
+      JK(Primary),Impl_(new MinimalInterface()){
+    // GTFock partitions its shell quartet tasks over the processes when
+    // the Fock builder is created; doing it now keeps that out of the
+    // first iteration.
+    Impl_->create_pfock(NMats, AreSymm);
+    NMats_ = NMats;
+    Symm_ = AreSymm;
+}
+
+GTFockJK::~GTFockJK() {
+    if (NMats_) Impl_->destroy_gtfock();
+}
+
 void GTFockJK::compute_JK() {
+    if (do_wK_) {
+        throw PSIEXCEPTION("GTFockJK: GTFock has no range-separated exchange, use SCF_TYPE DIRECT for wK.");
+    }
 
-   NMats_ = C_left_.size();
-   Impl_->create_pfock(NMats_, lr_symmetric_);
-   Impl_->SetP(D_ao_);
-   Impl_->GetJ(J_ao_);
-   Impl_->GetK(K_ao_);
-   Impl_->destroy_gtfock();
+    // The distributed builder is only rebuilt when the number or symmetry
+    // of the densities changes, e.g. going from SCF to a stability analysis
+    if ((size_t)NMats_ != C_left_.size() || Symm_ != lr_symmetric_) {
+        if (NMats_) Impl_->destroy_gtfock();
+        NMats_ = C_left_.size();
+        Symm_ = lr_symmetric_;
+        Impl_->create_pfock(NMats_, Symm_);
+    }
+    Impl_->SetP(D_ao_);
+    if (do_J_) Impl_->GetJ(J_ao_);
+    if (do_K_) Impl_->GetK(K_ao_);
 }
 
+void GTFockJK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> GTFockJK: Distributed J/K Matrices <==\n\n");
+        outfile->Printf("    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    Memory (MB):       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
+    }
+}
 
 }
-#endif
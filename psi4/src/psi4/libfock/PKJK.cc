@@ -130,6 +130,7 @@ void PKJK::preiterations()
 void PKJK::compute_JK()
 {
     timer_on("PK computes JK");
+    double start = wall_time();
     // We form the vector containing the density matrix triangular elements
     PKmanager_->prepare_JK(D_ao_,C_left_ao_,C_right_ao_);
 
@@ -147,6 +148,13 @@ void PKJK::compute_JK()
 
     PKmanager_->finalize_JK();
 
+    // Each supermatrix element touches two pairs of each density: 2 multiply-adds
+    size_t nsuper = (J_ao_.size() ? 1 : 0) + (K_ao_.size() ? 1 : 0) + (wK_ao_.size() ? 1 : 0);
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals = nsuper * PKmanager_->pk_size();
+    metrics.flops = 4.0 * D_ao_.size() * metrics.integrals;
+    metrics.contraction_time = wall_time() - start;
+
     timer_off("PK computes JK");
 
 }
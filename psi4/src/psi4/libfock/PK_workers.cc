@@ -30,22 +30,43 @@
 #include "psi4/libpsio/aiohandler.h"
 #include "psi4/libiwl/config.h"
 #include "PK_workers.h"
+#include "compression.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace psi {
 
 namespace pk {
 
+namespace {
+/// Row of the lower triangle holding packed index x, i.e. the largest r with r(r+1)/2 <= x
+size_t tri_row(size_t x) {
+    size_t r = (size_t)((std::sqrt(8.0 * (double)x + 1.0) - 1.0) / 2.0);
+    while(r * (r + 1) / 2 > x) --r;
+    while((r + 1) * (r + 2) / 2 <= x) ++r;
+    return r;
+}
+}
+
 AOShellSieveIterator::AOShellSieveIterator(std::shared_ptr<BasisSet> prim,
                                            SharedSieve sieve_input) :
 shell_pairs_(sieve_input->shell_pairs()) {
     bs_ = prim;
     sieve_ = sieve_input;
     npairs_ = shell_pairs_.size();
+    PQ_begin_ = 0;
+    PQ_end_ = npairs_;
     PQ_ = 0;
     RS_ = 0;
     done_ = false;
 }
 
+void AOShellSieveIterator::restrict_bra(size_t begin, size_t end) {
+    PQ_begin_ = begin;
+    PQ_end_ = std::min(end, npairs_);
+}
+
 void AOShellSieveIterator::populate_indices() {
     P_ = shell_pairs_[PQ_].first;
     Q_ = shell_pairs_[PQ_].second;
@@ -55,8 +76,13 @@ void AOShellSieveIterator::populate_indices() {
 
 void AOShellSieveIterator::first() {
 
-    PQ_ = 0;
+    PQ_ = PQ_begin_;
     RS_ = 0;
+    if(PQ_ >= PQ_end_) {
+        done_ = true;
+        return;
+    }
+    done_ = false;
     populate_indices();
     while(!sieve_->shell_significant(P_,Q_,R_,S_)) {
         // We do not use a function to increment so we can directly
@@ -65,7 +91,7 @@ void AOShellSieveIterator::first() {
         if(RS_ > PQ_) {
             RS_ = 0;
             ++PQ_;
-            if(PQ_ >= npairs_) {
+            if(PQ_ >= PQ_end_) {
                 done_ = true;
                 return;
             }
@@ -80,7 +106,7 @@ void AOShellSieveIterator::next() {
     if(RS_ > PQ_) {
         RS_ = 0;
         ++PQ_;
-        if(PQ_ >= npairs_) {
+        if(PQ_ >= PQ_end_) {
             done_ = true;
             return;
         }
@@ -93,7 +119,7 @@ void AOShellSieveIterator::next() {
         if(RS_ > PQ_) {
             RS_ = 0;
             ++PQ_;
-            if(PQ_ >= npairs_) {
+            if(PQ_ >= PQ_end_) {
                 done_ = true;
                 return;
             }
@@ -335,6 +361,7 @@ PKWorker::PKWorker(std::shared_ptr<BasisSet> primary, SharedSieve sieve,
     bufidx_ = 0;
     offset_ = 0;
     do_wK_ = false;
+    compress_step_ = 0.0;
 
 }
 
@@ -364,6 +391,7 @@ void PKWorker::first_quartet(size_t i) {
 //DEBUG    #pragma omp critical
 //DEBUG    outfile->Printf("thread %d, offset is %lu and max_idx is %lu\n",omp_get_thread_num(),offset_,max_idx_);
 //DEBUG    std::cout << "thread" << omp_get_thread_num() << ", offset is " << offset_ << " and max_idx is " << max_idx_ << std::endl;
+    restrict_shells();
     shells_left_ = false;
     for(shelliter_->first(); (shells_left_ || shelliter_->is_done()) == false; shelliter_->next()) {
         P_ = shelliter_->p();
@@ -376,6 +404,28 @@ void PKWorker::first_quartet(size_t i) {
 
 }
 
+void PKWorker::restrict_shells() {
+    // The largest of the four indices of any integral is the first index of
+    // its J and K supermatrix rows, and it lies in the bra's first shell.
+    // Only bra pairs whose first shell spans the first indices of the rows
+    // in [offset_, max_idx_] can contribute to this task.
+    size_t nbf = primary_->nbf();
+    size_t i_lo = tri_row(tri_row(offset_));
+    size_t i_hi = std::min(tri_row(tri_row(max_idx_)), nbf - 1);
+    if(i_lo >= nbf) {
+        shelliter_->restrict_bra(0, 0);
+        return;
+    }
+    int P_lo = primary_->function_to_shell(i_lo);
+    int P_hi = primary_->function_to_shell(i_hi);
+
+    // Shell pairs are sorted on their first shell
+    const std::vector< std::pair<int, int> >& pairs = sieve_->shell_pairs();
+    auto begin = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(P_lo, 0));
+    auto end = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(P_hi + 1, 0));
+    shelliter_->restrict_bra(begin - pairs.begin(), end - pairs.begin());
+}
+
 bool PKWorker::is_shell_relevant() {
     // May implement the sieve here
 
@@ -652,13 +702,18 @@ void PKWrkrReord::write(std::vector<size_t> min_ind, std::vector<size_t> max_ind
         labels_J_[buf_].push_back(get_label_J(b));
         size_t start = std::max(offset(), min_ind[b]);
         size_t stop = std::min(max_idx() + 1, max_ind[b]);
-        psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * sizeof(double));
+        size_t elsize = compression::element_size(compress_step());
+        psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * elsize);
         size_t nints = stop - start;
+        if (compress_step() > 0.0) {
+            compression::pack(&J_bufs_[buf_][start - offset()], nints, compress_step());
+            compression::pack(&K_bufs_[buf_][start - offset()], nints, compress_step());
+        }
         jobID_J_[buf_].push_back(AIO()->write(target_file(), labels_J_[buf_][i], (char *)(&J_bufs_[buf_][start - offset()]),
-                    nints * sizeof(double), adr, &dummy_));
+                    nints * elsize, adr, &dummy_));
         labels_K_[buf_].push_back(get_label_K(b));
         jobID_K_[buf_].push_back(AIO()->write(target_file(), labels_K_[buf_][i], (char *)(&K_bufs_[buf_][start - offset()]),
-                    nints * sizeof(double), adr, &dummy_));
+                    nints * elsize, adr, &dummy_));
     }
 
     // Update the buffer being written into
@@ -725,10 +780,14 @@ void PKWrkrReord::write_wK(std::vector<size_t> min_ind, std::vector<size_t> max_
         labels_wK_[buf_].push_back(get_label_wK(b));
         size_t start = std::max(offset(), min_ind[b]);
         size_t stop = std::min(max_idx() + 1, max_ind[b]);
-        psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * sizeof(double));
+        size_t elsize = compression::element_size(compress_step());
+        psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * elsize);
         size_t nints = stop - start;
+        if (compress_step() > 0.0) {
+            compression::pack(&wK_bufs_[buf_][start - offset()], nints, compress_step());
+        }
         jobID_wK_[buf_].push_back(AIO()->write(target_file(), labels_wK_[buf_][i], (char *)(&wK_bufs_[buf_][start - offset()]),
-                    nints * sizeof(double), adr, &dummy_));
+                    nints * elsize, adr, &dummy_));
     }
 
     // Update the buffer being written into
@@ -71,6 +71,8 @@ class AOShellSieveIterator {
     const std::vector< std::pair<int, int> >& shell_pairs_;
     // Number of shell pairs
     size_t npairs_;
+    // Range [PQ_begin_, PQ_end_) of bra pairs to visit
+    size_t PQ_begin_, PQ_end_;
     // Shell triangular indices
     size_t PQ_, RS_;
     // Shell indices
@@ -84,6 +86,9 @@ public:
     /// Constructor
     AOShellSieveIterator(std::shared_ptr< BasisSet > prim, SharedSieve sieve_input);
 
+    /// Only visit quartets whose bra is one of the shell pairs [begin, end)
+    void restrict_bra(size_t begin, size_t end);
+
     /// Iterator functions
     void first();
     void next();
@@ -242,12 +247,16 @@ private:
     size_t nbuf_;
     /// Are there any shells left ?
     bool shells_left_;
+    /// Fixed-point step for compressed PK storage, 0.0 for plain doubles
+    double compress_step_;
 
     /// Indices of the current shell quartet
     size_t P_, Q_, R_, S_;
 
     /// Is the current shell relevant to the current worker ?
     bool is_shell_relevant();
+    /// Limit the shell iterator to the bra pairs that can reach [offset_, max_idx_]
+    void restrict_shells();
 
     // This class should never be copied
     PKWorker(const PKWorker &other) {}
@@ -284,6 +293,9 @@ public:
     bool do_wK()                        const { return do_wK_; }
     /// Set do_wK
     void set_do_wK(bool tmp) { do_wK_ = tmp; }
+    /// Compressed storage step, see compression.h
+    double compress_step()             const { return compress_step_; }
+    void set_compress_step(double step) { compress_step_ = step; }
 
     /// Get TOC labels for J or K
     static char* get_label_J(const int batch);
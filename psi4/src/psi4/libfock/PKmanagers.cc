@@ -391,87 +391,164 @@ void PKManager::form_D_vec(std::vector<SharedMatrix> D, std::vector<SharedMatrix
         outfile->Printf("  All matrices considered asymmetric.\n");
     }
 
-    for (int N = 0; N < D.size(); ++N) {
-        // Symmetric density matrix: store triangular form
-        if(is_sym(N)) {
-            double* Dvec = new double[pk_pairs_];
-// All elements are filled, don't need memset
-            //::memset((void *)Dvec,'\0',pk_pairs_ * sizeof(double));
-            D_vec_.push_back(Dvec);
-            size_t pqval = 0;
-            for(int p = 0; p < nbf_; ++p) {
-                for(int q = 0; q <= p; ++q) {
-                    if(p != q) {
-                        Dvec[pqval] = 2.0 * D[N]->get(0,p,q);
-                    } else {
-                        Dvec[pqval] = D[N]->get(0,p,q);
-                    }
-                    ++pqval;
-                }
-            }
-        // Non-symmetric density matrix: store the whole thing with
-        // appropriate factors
-        } else {
-            double* Dvec = new double[nbf_ * nbf_];
-            D_vec_.push_back(Dvec);
-            size_t pqval = 0;
-            for (int p = 0; p < nbf_; ++p) {
-                for(int q = 0; q < nbf_; ++q) {
-                    if(p != q) {
-                        Dvec[pqval] = D[N]->get(0,p,q);
-                    } else {
-                        Dvec[pqval] = 0.5 * D[N]->get(0,p,q);
-                    }
-                    ++pqval;
-                }
-            }
+}
 
+void PKManager::pack_densities(DensityBatch& batch, std::vector<SharedMatrix> J, std::string exch,
+                               std::vector<SharedMatrix> K) {
+    // J goes through the triangular kernel for every density: J is symmetric
+    // and only needs D_pq + D_qp. Exchange with non-symmetric densities, and
+    // wK for all of them, is contracted from the J supermatrix as full matrices.
+    std::vector<int> J_ids, K_ids;
+    for (int N = 0; N < J.size(); ++N) {
+        if (exch == "") {
+            J_ids.push_back(N);
+            if (K.size() && !is_sym(N)) K_ids.push_back(N);
+        } else if (exch == "K") {
+            if (is_sym(N)) J_ids.push_back(N);
+        } else if (exch == "wK") {
+            K_ids.push_back(N);
+        }
+    }
+
+    size_t nJ = J_ids.size();
+    batch.J_targets.clear();
+    batch.D_tri.assign(pk_pairs_ * nJ, 0.0);
+    batch.J_tri.assign(pk_pairs_ * nJ, 0.0);
+    for (size_t n = 0; n < nJ; ++n) {
+        int N = J_ids[n];
+        batch.J_targets.push_back(J[N]);
+        double** Dp = D_[N]->pointer();
+        size_t pq = 0;
+        for (int p = 0; p < nbf_; ++p) {
+            for (int q = 0; q < p; ++q, ++pq) {
+                batch.D_tri[pq * nJ + n] = Dp[p][q] + Dp[q][p];
+            }
+            batch.D_tri[pq * nJ + n] = Dp[p][p];
+            ++pq;
         }
     }
 
+    size_t nK = K_ids.size();
+    size_t nbf2 = (size_t)nbf_ * nbf_;
+    batch.K_targets.clear();
+    batch.D_full.assign(nbf2 * nK, 0.0);
+    batch.K_full.assign(nbf2 * nK, 0.0);
+    for (size_t n = 0; n < nK; ++n) {
+        int N = K_ids[n];
+        batch.K_targets.push_back(exch == "wK" ? J[N] : K[N]);
+        double* Dp = D_[N]->pointer()[0];
+        for (size_t pq = 0; pq < nbf2; ++pq) {
+            batch.D_full[pq * nK + n] = Dp[pq];
+        }
+    }
 }
 
-void PKManager::make_J_vec(std::vector<SharedMatrix> J) {
-    for(int N = 0; N < J.size(); ++N) {
-        // Symmetric density matrix: stores triangular J
-        if(is_sym(N)) {
-            double* Jvec = new double[pk_pairs_];
-            ::memset((void*)Jvec,'\0',pk_pairs_ * sizeof(double));
-            JK_vec_.push_back(Jvec);
-        // Non-symmetric density matrix: stores NULL pointer
-        // as we will use full J.
-        // Shared pointer initialized to null
-        //TODO Could actually store triangle since J is always symmetric
-        } else {
-            JK_vec_.push_back(nullptr);
+void PKManager::contract_J_block(DensityBatch& batch, const double* block, size_t min_pq, size_t max_pq) {
+    size_t nd = batch.J_targets.size();
+    if (nd == 0) return;
+    const double* D = batch.D_tri.data();
+    double* J = batch.J_tri.data();
+    std::vector<double> J_pq(nd);
+
+    // Row pq of the block holds (pq|rs) for rs <= pq, the diagonal halved
+    const double* j_ptr = block;
+    for (size_t pq = min_pq; pq < max_pq; ++pq) {
+        const double* D_pq = D + pq * nd;
+        std::fill(J_pq.begin(), J_pq.end(), 0.0);
+        const double* D_rs = D;
+        double* J_rs = J;
+        for (size_t rs = 0; rs <= pq; ++rs) {
+            double val = *j_ptr++;
+            for (size_t n = 0; n < nd; ++n) {
+                J_pq[n] += val * D_rs[n];
+                J_rs[n] += val * D_pq[n];
+            }
+            D_rs += nd;
+            J_rs += nd;
+        }
+        double* J_out = J + pq * nd;
+        for (size_t n = 0; n < nd; ++n) {
+            J_out[n] += J_pq[n];
         }
     }
 }
 
-void PKManager::get_results(std::vector<SharedMatrix> J,std::string exch) {
-    // Now, directly transfer data to resulting matrices
-    for(int N = 0; N < J.size(); ++N) {
-        // Symmetric density matrix: copy triangle and build full matrix
-        if(is_sym(N) && exch != "wK") {
-            double *Jp = JK_vec_[N];
-            for(int p = 0; p < nbf_; ++p) {
-                for(int q = 0; q <= p; ++q) {
-                    J[N]->set(0,p,q,*Jp++);
+void PKManager::contract_K_block(DensityBatch& batch, const double* block, size_t min_pq, size_t max_pq) {
+    size_t nd = batch.K_targets.size();
+    if (nd == 0 || min_pq >= max_pq) return;
+    const double* D = batch.D_full.data();
+    double* K = batch.K_full.data();
+    size_t nbf = nbf_;
+
+    int p = 0;
+    while ((size_t)(p + 1) * (p + 2) / 2 <= min_pq) ++p;
+    int q = min_pq - (size_t)p * (p + 1) / 2;
+
+    const double* j_ptr = block;
+    for (size_t pq = min_pq; pq < max_pq; ++pq) {
+        for (int r = 0; r <= p; ++r) {
+            int maxs = (r == p) ? q : r;
+            for (int s = 0; s <= maxs; ++s) {
+                // Need ugly factors for now. A better solution would be great.
+                double fac = 1.0;
+                if (p == q && r == s && p == r) {
+                    fac = 0.25; // Divide only be 4, PK stores integral with a
+                    // factor 0.5 on the (pq|pq) diagonal.
+                } else if ( (p == q && q == r) || (q == r && r == s) ) {
+                    fac = 0.5;
+                } else if ( p == q && r == s) {
+                    fac = 0.25;
+                } else if (p == q || r == s) {
+                    fac = 0.5;
+                }
+                double val = (*j_ptr++) * fac;
+                size_t pr = (p * nbf + r) * nd, rp = (r * nbf + p) * nd;
+                size_t qr = (q * nbf + r) * nd, rq = (r * nbf + q) * nd;
+                size_t ps = (p * nbf + s) * nd, sp = (s * nbf + p) * nd;
+                size_t qs = (q * nbf + s) * nd, sq = (s * nbf + q) * nd;
+                for (size_t n = 0; n < nd; ++n) {
+                    K[pr + n] += val * D[qs + n];
+                    K[rp + n] += val * D[sq + n];
+                    K[qr + n] += val * D[ps + n];
+                    K[ps + n] += val * D[qr + n];
+                    K[sp + n] += val * D[rq + n];
+                    K[rq + n] += val * D[sp + n];
+                    K[sq + n] += val * D[rp + n];
+                    K[qs + n] += val * D[pr + n];
                 }
             }
-            J[N]->copy_lower_to_upper();
-            delete [] JK_vec_[N];
-        // Non-symmetric density matrix: result is already in the target
-        //TODO: if we store the triangle only, change that.
-        } else if (exch == "") {
-          double** Jp = J[N]->pointer();
-          for(int p = 0; p < nbf_; ++p) {
-            Jp[p][p] *= 0.5;
-          }
+        }
+        if (++q > p) {
+            ++p;
+            q = 0;
         }
     }
-    JK_vec_.clear();
+}
 
+void PKManager::unpack_results(DensityBatch& batch) {
+    size_t nJ = batch.J_targets.size();
+    for (size_t n = 0; n < nJ; ++n) {
+        double** Jp = batch.J_targets[n]->pointer();
+        const double* J_tri = batch.J_tri.data() + n;
+        for (int p = 0; p < nbf_; ++p) {
+            for (int q = 0; q <= p; ++q) {
+                Jp[p][q] = Jp[q][p] = *J_tri;
+                J_tri += nJ;
+            }
+        }
+    }
+    size_t nK = batch.K_targets.size();
+    size_t nbf2 = (size_t)nbf_ * nbf_;
+    for (size_t n = 0; n < nK; ++n) {
+        double* Kp = batch.K_targets[n]->pointer()[0];
+        for (size_t pq = 0; pq < nbf2; ++pq) {
+            Kp[pq] += batch.K_full[pq * nK + n];
+        }
+    }
+    batch.D_tri.clear();
+    batch.J_tri.clear();
+    batch.D_full.clear();
+    batch.K_full.clear();
 }
 
 void PKManager::form_K(std::vector<SharedMatrix> K) {
@@ -488,10 +565,8 @@ void PKManager::form_wK(std::vector<SharedMatrix> wK) {
 }
 
 void PKManager::finalize_D() {
-    for(int N = 0; N < D_vec_.size(); ++N) {
-        delete [] D_vec_[N];
-    }
-    D_vec_.clear();
+    D_.clear();
+    symmetric_.clear();
 }
 
 PKMgrDisk::PKMgrDisk(std::shared_ptr<PSIO> psio, std::shared_ptr<BasisSet> primary,
@@ -503,6 +578,18 @@ PKMgrDisk::PKMgrDisk(std::shared_ptr<PSIO> psio, std::shared_ptr<BasisSet> prima
 
     // No current writing since we are constructing
     writing_ = false;
+
+    // Every PK element is bounded by the largest Schwarz pair value
+    compress_step_ = 0.0;
+    double tol = options.get_double("DISK_COMPRESSION_TOLERANCE");
+    if (tol > 0.0) {
+        compress_step_ = 2.0 * tol;
+        if (!compression::representable(2.0 * sieve()->max(), compress_step_)) {
+            outfile->Printf("  DISK_COMPRESSION_TOLERANCE is too tight for the largest integral.\n");
+            outfile->Printf("  PK supermatrix will be stored uncompressed.\n");
+            compress_step_ = 0.0;
+        }
+    }
 }
 
 
@@ -596,28 +683,13 @@ void PKMgrDisk::batch_sizing() {
       throw PSIEXCEPTION("  PK Failure: max batches exceeded\n");
 
     }
-
-    // Finally, we want to store the pairs of indices p,q corresponding
-    // to min pq and max pq for each batch (useful for non-sym. density matrices)
-    // We go beyond the number of pq to make sure we include the last one.
-    outfile->Printf("  Building batch lookup table.\n");
-    ind_for_pq_[0] = std::make_pair(0,0);
-    int nb = 0;
-    for(int p = 0; p <= nbf(); ++p) {
-        for(int q = 0; q <= p; ++q) {
-            pq = INDEX2(p,q);
-            if(batch_pq_max_[nb] == pq) {
-                ind_for_pq_[pq] = std::make_pair(p,q);
-                ++nb;
-            }
-        }
-    }
-
-
 }
 
 void PKMgrDisk::print_batches() {
     PKManager::print_batches();
+    if (compress_step_ > 0.0) {
+        outfile->Printf("  Compressed PK storage, absolute error %11.3E per integral.\n", 0.5 * compress_step_);
+    }
     // Print batches for the user and for control
     for(int batch = 0; batch < batch_pq_min_.size(); ++batch){
         outfile->Printf("\tBatch %3d pq = [%8zu,%8zu] index = [%14zu,%zu] size = %12zu\n",
@@ -680,9 +752,10 @@ void PKMgrDisk::finalize_PK() {
 
 void PKMgrDisk::form_J(std::vector<SharedMatrix> J, std::string exch,
                        std::vector<SharedMatrix> K) {
-    make_J_vec(J);
+    DensityBatch densities;
+    pack_densities(densities, J, exch, K);
 
-    // Now loop over batches
+    // Now loop over batches, each one read once for all density matrices
     for(int batch = 0; batch < batch_pq_min_.size(); ++batch) {
         size_t min_index = batch_index_min_[batch];
         size_t max_index = batch_index_max_[batch];
@@ -699,125 +772,21 @@ void PKMgrDisk::form_J(std::vector<SharedMatrix> J, std::string exch,
         } else {
             label = PKWorker::get_label_J(batch);
         }
-        psio_->read_entry(pk_file_, label, (char *) j_block, batch_size * sizeof(double));
-
-        // Read one entry, use it for all density matrices
-        for(int N = 0; N < J.size(); ++N) {
-            // Symmetric density matrix, pure triangular
-            if(is_sym(N) && exch != "wK") {
-                double* D_vec = D_glob_vecs(N);
-                double* J_vec = JK_glob_vecs(N);
-                double* j_ptr = j_block;
-            //TODO Could consider parallelizing this loop
-                for(size_t pq = min_pq; pq < max_pq; ++pq) {
-                    double D_pq = D_vec[pq];
-                    double *D_rs = D_vec;
-                    double J_pq = 0.0;
-                    double *J_rs = J_vec;
-                    for(size_t rs = 0; rs <= pq; ++rs) {
-//DEBUG                        if(!exch && rs == 0) {
-//DEBUG                          outfile->Printf("PK int (%lu|%lu) = %20.16f\n",pq,rs,*j_ptr);
-//DEBUG                        }
-                        J_pq += *j_ptr * (*D_rs);
-                        *J_rs += *j_ptr * D_pq;
-                        ++D_rs;
-                        ++J_rs;
-                        ++j_ptr;
-                    }
-                    J_vec[pq] += J_pq;
-                }
-            // Non-symmetric density matrix case
-            } else if (exch == "" || exch == "wK") {
-                double* j_ptr = j_block;
-                const int fp = ind_for_pq_[min_pq].first;
-                const int fq = ind_for_pq_[min_pq].second;
-                const int maxp = ind_for_pq_[max_pq].first;
-                if(exch != "wK") {
-                    double* D_vec = D_glob_vecs(N);
-                    double** J_vec = J[N]->pointer();
-                    for(int p = fp; p <= maxp; ++p) {
-                      int maxq = (p == maxp) ? ind_for_pq_[max_pq].second : p + 1;
-                      int poffs = p * nbf();
-                      int q = (p == fp) ? fq : 0;
-                      for(;q < maxq; ++q) {
-                        int qoffs = q * nbf();
-                        for(int r = 0; r <= p; ++r) {
-                          int roffs = r * nbf();
-                          int maxs = (r == p) ? q : r;
-                          for(int s = 0; s <= maxs; ++s) {
-//                            if(!exch && INDEX2(r,s) == 0) {
-//                              outfile->Printf("PK int (%lu|%lu) = %20.16f\n",INDEX2(p,q),INDEX2(r,s),*j_ptr);
-//                              int x = 0;  // For the lolz
-//                            }
-                              J_vec[p][q] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                              J_vec[q][p] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                              J_vec[r][s] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                              J_vec[s][r] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                              ++j_ptr;
-                          }
-
-                        }
-                      }
-                    }
-                }
-                // Since we just read a batch, might as well compute K
-                // Primitive algorithm, just contract integrals with appropriate
-                // element on the fly. Might be faster than reading/writing the appropriate
-                // PK supermatrix
-                if(K.size() || exch == "wK") {
-                    double** Dmat = original_D(N)->pointer();
-                    double** K_vec;
-                    if(exch == "wK") {
-                        K_vec = J[N]->pointer();
-                    } else {
-                        K_vec = K[N]->pointer();
-                    }
-                    j_ptr = j_block;
-                    for(int p = fp; p <= maxp; ++p) {
-                      int maxq = (p == maxp) ? ind_for_pq_[max_pq].second : p + 1;
-               //       int poffs = p * nbf();
-                      int q = (p == fp) ? fq : 0;
-                      for(;q < maxq; ++q) {
-                 //       int qoffs = q * nbf();
-                        for(int r = 0; r <= p; ++r) {
-                   //       int roffs = r * nbf();
-                          int maxs = (r == p) ? q : r;
-                          for(int s = 0; s <= maxs; ++s) {
-                          // Need ugly factors for now. A better solution would be great.
-                            double fac = 1.0;
-                     //       int soffs = s * nbf();
-                            if (p == q && r == s && p == r) {
-                                fac = 0.25; // Divide only be 4, PK stores integral with a
-                                // factor 0.5 on the (pq|pq) diagonal.
-                            } else if ( (p == q && q == r) || (q == r && r == s) ) {
-                                fac = 0.5;
-                            } else if ( p == q && r == s) {
-                                fac = 0.25;
-                            } else if (p == q || r == s) {
-                                fac = 0.5;
-                            }
-                            K_vec[p][r] += (*j_ptr) * fac * Dmat[q][s];
-                            K_vec[r][p] += (*j_ptr) * fac * Dmat[s][q];
-                            K_vec[q][r] += (*j_ptr) * fac * Dmat[p][s];
-                            K_vec[p][s] += (*j_ptr) * fac * Dmat[q][r];
-                            K_vec[s][p] += (*j_ptr) * fac * Dmat[r][q];
-                            K_vec[r][q] += (*j_ptr) * fac * Dmat[s][p];
-                            K_vec[s][q] += (*j_ptr) * fac * Dmat[r][p];
-                            K_vec[q][s] += (*j_ptr) * fac * Dmat[p][r];
-                            ++j_ptr;
-                          }
-                        }
-                      }
-                    }
+        psio_->read_entry(pk_file_, label, (char *) j_block,
+                          batch_size * compression::element_size(compress_step_));
+        if (compress_step_ > 0.0) {
+            compression::unpack(j_block, batch_size, compress_step_);
+        }
 
-                }
-            }  // end of non-symmetric case
-        }  // End of loop over J matrices
+        contract_J_block(densities, j_block, min_pq, max_pq);
+        // Since we just read a batch, might as well compute K for the
+        // non-symmetric densities from it
+        contract_K_block(densities, j_block, min_pq, max_pq);
 
         delete [] label;
         delete [] j_block;
     }  // End of batch loop
-    get_results(J,exch);
+    unpack_results(densities);
 }
 
 void PKMgrDisk::finalize_JK() {
@@ -839,9 +808,9 @@ void PKMgrReorder::prestripe_files() {
         size_t batch_size = batch_ind_max()[batch] - batch_ind_min()[batch];
         // We need to keep the labels around in a vector
         label_J_.push_back(PKWorker::get_label_J(batch));
-        AIO()->zero_disk(pk_file(),label_J_[batch],1,batch_size);
+        AIO()->zero_disk(pk_file(),label_J_[batch],1,stored_size(batch_size));
         label_K_.push_back(PKWorker::get_label_K(batch));
-        AIO()->zero_disk(pk_file(),label_K_[batch],1,batch_size);
+        AIO()->zero_disk(pk_file(),label_K_[batch],1,stored_size(batch_size));
     }
 }
 
@@ -853,7 +822,7 @@ void PKMgrReorder::prestripe_files_wK() {
         size_t batch_size = batch_ind_max()[batch] - batch_ind_min()[batch];
         // Keep the labels around in a vector
         label_wK_.push_back(PKWorker::get_label_wK(batch));
-        AIO()->zero_disk(pk_file(),label_wK_[batch],1,batch_size);
+        AIO()->zero_disk(pk_file(),label_wK_[batch],1,stored_size(batch_size));
     }
 }
 
@@ -883,6 +852,7 @@ void PKMgrReorder::allocate_buffers() {
     // we want for each thread. We can allocate IO buffers.
     for(int i = 0; i < nthreads(); ++i) {
         fill_buffer(SharedPKWrkr(new PKWrkrReord(primary(),sieve(),AIO(),pk_file(),buf_size,buf_per_thread)));
+        buffer(i)->set_compress_step(compress_step());
     }
 
 }
@@ -1327,7 +1297,11 @@ void PKMgrYoshimine::generate_J_PK(double *twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq,pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
+            if (compress_step() > 0.0) {
+                compression::pack(twoel_ints, nintegrals, compress_step());
+            }
+            psio()->write_entry(pk_file(), label, (char*)twoel_ints,
+                                nintegrals * compression::element_size(compress_step()));
             delete [] label;
             ++batch;
             if(batch < nbatches) {
@@ -1412,7 +1386,11 @@ void PKMgrYoshimine::generate_K_PK(double *twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq,pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
+            if (compress_step() > 0.0) {
+                compression::pack(twoel_ints, nintegrals, compress_step());
+            }
+            psio()->write_entry(pk_file(), label, (char*)twoel_ints,
+                                nintegrals * compression::element_size(compress_step()));
             delete [] label;
             ++batch;
             if(batch < nbatches) {
@@ -1472,7 +1450,11 @@ void PKMgrYoshimine::generate_wK_PK(double *twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq,pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
+            if (compress_step() > 0.0) {
+                compression::pack(twoel_ints, nintegrals, compress_step());
+            }
+            psio()->write_entry(pk_file(), label, (char*)twoel_ints,
+                                nintegrals * compression::element_size(compress_step()));
             delete [] label;
             ++batch;
             if(batch < nbatches) {
@@ -1566,126 +1548,15 @@ void PKMgrInCore::prepare_JK(std::vector<SharedMatrix> D, std::vector<SharedMatr
 }
 
 void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vector<SharedMatrix> K) {
+    DensityBatch densities;
+    pack_densities(densities, J, exch, K);
 
-    make_J_vec(J);
-
-    for(int N = 0; N < J.size(); ++N) {
-        double* j_ptr;
-        if(exch == "K") {
-            j_ptr = K_ints_.get();
-        } else {
-            j_ptr = J_ints_.get();
-        }
-//TODO We should totally parallelize this loop now.
-        // Symmetric density matrix case
-        if(is_sym(N) && exch != "wK") {
-            double* J_vec = JK_glob_vecs(N);
-            double* D_vec = D_glob_vecs(N);
-            for(size_t pq = 0; pq < pk_pairs(); ++pq) {
-                double D_pq = D_vec[pq];
-                double *D_rs = D_vec;
-                double J_pq = 0.0;
-                double *J_rs = J_vec;
-                for(size_t rs = 0; rs <= pq; ++rs) {
-        //DEBUG               if(!exch && rs == 0) {
-        //DEBUG                 outfile->Printf("PK int (%lu|%lu) = %20.16f\n",pq,rs,*j_ptr);
-        //DEBUG               }
-                    J_pq += *j_ptr * (*D_rs);
-                    *J_rs += *j_ptr * D_pq;
-                    ++D_rs;
-                    ++J_rs;
-                    ++j_ptr;
-                }
-                J_vec[pq] += J_pq;
-            }
-
-        //TODO ? Fuse J and K loops ?
-        // Non-symmetric density matrix
-        } else if (exch == "" || exch == "wK") {
-            if(exch == "") {
-                double* D_vec = D_glob_vecs(N);
-                double** J_vec = J[N]->pointer();
-                for(int p = 0;p < nbf(); ++p) {
-                  int poffs = p * nbf();
-                  for(int q = 0;q <= p; ++q) {
-                    int qoffs = q * nbf();
-                    for(int r = 0; r <= p; ++r) {
-                      int roffs = r * nbf();
-                      int maxs = (r == p) ? q : r;
-                      for(int s = 0; s <= maxs; ++s) {
-                          J_vec[p][q] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                          J_vec[q][p] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                          J_vec[r][s] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                          J_vec[s][r] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                          ++j_ptr;
-                      }
-
-                    }
-                  }
-                }
-            }
-            // Since we just read a batch, might as well compute K
-            // Primitive algorithm, just contract integrals with appropriate
-            // element on the fly. Might be faster than reading/writing the appropriate
-            // PK supermatrix
-            if(K.size() || exch =="wK") {
-                double** Dmat = original_D(N)->pointer();
-                double** K_vec;
-                if(exch == "wK") {
-                    K_vec = J[N]->pointer();
-                    j_ptr = wK_ints_.get();
-                } else {
-                    K_vec = K[N]->pointer();
-                    // We use J supermatrix because it contains every unique integral
-                    // K supermatrix has summed some integrals that we need separately
-                    j_ptr = J_ints_.get();
-                }
-                for(int p = 0;p < nbf(); ++p) {
-          //        int poffs = p * nbf();
-                  for(int q = 0;q <= p; ++q) {
-          //          int qoffs = q * nbf();
-                    for(int r = 0; r <= p; ++r) {
-          //            int roffs = r * nbf();
-                      int maxs = (r == p) ? q : r;
-                      for(int s = 0; s <= maxs; ++s) {
-                      // Need ugly factors for now. A better solution would be great.
-                        double fac = 1.0;
-          //              int soffs = s * nbf();
-                        if (p == q && r == s && p == r) {
-                            fac = 0.25; // Divide only be 4, PK stores integral with a
-                            // factor 0.5 on the (pq|pq) diagonal.
-                        } else if ( (p == q && q == r) || (q == r && r == s) ) {
-                            fac = 0.5;
-                        } else if ( p == q && r == s) {
-                            fac = 0.25;
-                        } else if (p == q || r == s) {
-                            fac = 0.5;
-                        }
-//DEBUG                       bool prt = (p == 0 && r == 0) || (q == 0 && r == 0) || (p == 0 && s == 0) || (s == 0 && q == 0);
-//DEBUG                       if(exch == "wK" && prt) {
-//DEBUG                         outfile->Printf("PK int (%d %d|%d %d) = %20.16f\n",p,q,r,s,*j_ptr);
-//DEBUG                       }
-                        K_vec[p][r] += (*j_ptr) * fac * Dmat[q][s];
-                        K_vec[r][p] += (*j_ptr) * fac * Dmat[s][q];
-                        K_vec[q][r] += (*j_ptr) * fac * Dmat[p][s];
-                        K_vec[p][s] += (*j_ptr) * fac * Dmat[q][r];
-                        K_vec[s][p] += (*j_ptr) * fac * Dmat[r][q];
-                        K_vec[r][q] += (*j_ptr) * fac * Dmat[s][p];
-                        K_vec[s][q] += (*j_ptr) * fac * Dmat[r][p];
-                        K_vec[q][s] += (*j_ptr) * fac * Dmat[p][r];
-                        ++j_ptr;
-                        }
-                    }
-                  }
-                }
-
-            }
-
-        } // End of non-symmetric condition
-    } // End of loop over J/K matrices
-
-    get_results(J,exch);
+    contract_J_block(densities, exch == "K" ? K_ints_.get() : J_ints_.get(), 0, pk_pairs());
+    // We use J supermatrix for exchange because it contains every unique integral
+    // K supermatrix has summed some integrals that we need separately
+    contract_K_block(densities, exch == "wK" ? wK_ints_.get() : J_ints_.get(), 0, pk_pairs());
 
+    unpack_results(densities);
 }
 
 void PKMgrInCore::finalize_JK() {
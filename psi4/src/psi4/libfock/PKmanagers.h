@@ -27,6 +27,7 @@
 //TODO Const correctness of everything
 #include "psi4/libmints/typedefs.h"
 #include <psi4/libpsio/psio.hpp>
+#include "psi4/libfock/compression.h"
 #include <vector>
 
 namespace psi {
@@ -117,8 +118,6 @@ private:
     /// Array of IOBuffer_PK for task handling
     std::vector<SharedPKWrkr> iobuffers_;
 
-    /// Vector of triangular D matrices
-    std::vector<double*> D_vec_;
     /// Vector of original D matrices. We keep it around for building exchange
     /// in non-symmetric cases.
     std::vector<SharedMatrix> D_;
@@ -126,8 +125,6 @@ private:
     std::vector< bool > symmetric_;
     /// Are all density matrices symmetric?
     bool all_sym_;
-    /// Vector of triangular result J/K matrices
-    std::vector<double*> JK_vec_;
 
     /// Setter functions for internal wK options
     void set_wK(bool dowK) { do_wK_ = dowK; }
@@ -137,6 +134,31 @@ protected:
     /// Setter objects for internal data
     void fill_buffer(SharedPKWrkr tmp) { iobuffers_.push_back(tmp); }
 
+    /**
+     * The densities contracted by one form_J call, interleaved as
+     * [index * n + N] so that each supermatrix element is read once and
+     * applied to all n of them.
+     */
+    struct DensityBatch {
+        /// Results formed as triangles through the J kernel
+        std::vector<SharedMatrix> J_targets;
+        /// Symmetrized triangular densities and triangular results
+        std::vector<double> D_tri, J_tri;
+        /// Results formed as full matrices through the exchange kernel
+        std::vector<SharedMatrix> K_targets;
+        /// Full densities and full results
+        std::vector<double> D_full, K_full;
+    };
+    /// Sort the densities of a form_J call between the two kernels and pack them
+    void pack_densities(DensityBatch& batch, std::vector<SharedMatrix> J, std::string exch,
+                        std::vector<SharedMatrix> K);
+    /// Contract the supermatrix rows [min_pq, max_pq) against every density of the J kernel
+    void contract_J_block(DensityBatch& batch, const double* block, size_t min_pq, size_t max_pq);
+    /// Contract the J supermatrix rows [min_pq, max_pq) as exchange, for non-symmetric densities and wK
+    void contract_K_block(DensityBatch& batch, const double* block, size_t min_pq, size_t max_pq);
+    /// Copy the results into their matrices
+    void unpack_results(DensityBatch& batch);
+
 public:
 
     /// Base constructor
@@ -157,8 +179,6 @@ public:
     size_t ntasks()                         const { return ntasks_; }
     size_t memory()                         const { return memory_; }
     SharedPKWrkr buffer(int i)              const { return iobuffers_[i]; }
-    double* D_glob_vecs(int i)              const { return D_vec_[i]; }
-    double* JK_glob_vecs(int i)             const { return JK_vec_[i]; }
     std::shared_ptr< BasisSet > primary() const { return primary_; }
     bool is_sym(int i)                      const { return symmetric_[i]; }
     bool all_sym()                          const { return all_sym_; }
@@ -227,15 +247,11 @@ public:
     /// Forming J, shared_ptr() initializes to null
     virtual void form_J(std::vector<SharedMatrix> J, std::string exch = "",
                         std::vector<SharedMatrix> K = std::vector<SharedMatrix>())=0;
-    /// Preparing triangular vector for J/K
-    void make_J_vec(std::vector<SharedMatrix> J);
-    /// Extracting results from vectors to matrix
-    void get_results(std::vector<SharedMatrix> J,std::string exch);
     /// Forming K
     void form_K(std::vector<SharedMatrix> K);
     /// Forming wK
     virtual void form_wK(std::vector<SharedMatrix> wK);
-    /// Finalize and delete the density matrix vectors
+    /// Release the density matrices
     void finalize_D();
 };
 
@@ -255,9 +271,6 @@ private:
     /// Mapping pq indices to the correct batch
     std::vector<int> batch_for_pq_;
 
-    /// Mapping the min and max pq's to p,q pairs
-    std::map< size_t, std::pair< int, int> > ind_for_pq_;
-
     /// Maximum number of batches
     int max_batches_;
 
@@ -269,6 +282,8 @@ private:
     int pk_file_;
     /// Is there any pending AIO writing ?
     bool writing_;
+    /// Fixed-point step for compressed PK storage, 0.0 for plain doubles
+    double compress_step_;
 
 public:
     /// Constructor for PKMgrDisk
@@ -281,6 +296,11 @@ public:
     void set_writing(bool tmp) { writing_ = tmp; }
     bool writing()  const { return writing_; }
     int pk_file() const { return pk_file_; }
+    double compress_step() const { return compress_step_; }
+    /// Number of doubles spanned on disk by n stored PK elements
+    size_t stored_size(size_t n) const {
+        return (n * compression::element_size(compress_step_) + sizeof(double) - 1) / sizeof(double);
+    }
     std::vector< size_t >& batch_ind_min() { return batch_index_min_;}
     std::vector< size_t >& batch_ind_max() { return batch_index_max_;}
     std::vector< size_t >& batch_pq_min() { return batch_pq_min_;}
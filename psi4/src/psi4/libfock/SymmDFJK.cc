@@ -0,0 +1,467 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include "jk.h"
+
+#include <algorithm>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+SymmDFJK::SymmDFJK(std::shared_ptr<BasisSet> primary,
+   std::shared_ptr<BasisSet> auxiliary) :
+   DFJK(primary, auxiliary)
+{
+    c1_ = (AO2USO_->nirrep() == 1);
+}
+SymmDFJK::~SymmDFJK()
+{
+}
+void SymmDFJK::print_header() const
+{
+    if (c1_) {
+        DFJK::print_header();
+        return;
+    }
+    if (print_) {
+        outfile->Printf( "  ==> SymmDFJK: Density-Fitted J/K Matrices in the SO Basis <==\n\n");
+
+        outfile->Printf( "    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf( "    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf( "    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf( "    OpenMP threads:    %11d\n", omp_nthread_);
+        outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf( "    Irreps:            %11d\n", AO2USO_->nirrep());
+        outfile->Printf( "    Integral Cache:    %11s\n",  df_ints_io_.c_str());
+        outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf( "    Fitting Condition: %11.0E\n\n", condition_);
+
+        outfile->Printf( "   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+size_t SymmDFJK::so_pair_sizes()
+{
+    int nirrep = AO2USO_->nirrep();
+    const Dimension& nsopi = AO2USO_->colspi();
+    const Dimension& nauxpi = AO2USO_aux_->colspi();
+
+    size_t total = 0L;
+    pair_offset_.assign(nirrep, std::vector<size_t>(nirrep, 0L));
+    for (int h = 0; h < nirrep; h++) {
+        size_t npair = 0L;
+        for (int a = 0; a < nirrep; a++) {
+            int b = a ^ h;
+            if (a < b) continue;
+            pair_offset_[h][a] = npair;
+            npair += (a == b ? nsopi[a] * (nsopi[a] + 1L) / 2L : nsopi[a] * (size_t) nsopi[b]);
+        }
+        total += npair * nauxpi[h];
+    }
+    return total;
+}
+void SymmDFJK::preiterations()
+{
+    // Range-separated, local and mixed-precision builds are C1 only
+    c1_ = (AO2USO_->nirrep() == 1 || do_wK_ || local_K_ || mixed_precision_);
+
+    if (!c1_) {
+        if (!sieve_) {
+            sieve_ = std::shared_ptr<ERISieve>(new ERISieve(primary_, cutoff_));
+        }
+
+        std::shared_ptr<IntegralFactory> integral(new IntegralFactory(auxiliary_, auxiliary_, auxiliary_, auxiliary_));
+        std::shared_ptr<PetiteList> pet(new PetiteList(auxiliary_, integral));
+        AO2USO_aux_ = SharedMatrix(pet->aotoso());
+
+        // The AO tensor, the SO tensor, and the rotation temps share core
+        size_t nbf = primary_->nbf();
+        size_t naux = auxiliary_->nbf();
+        size_t nso_max = AO2USO_->colspi().max();
+        size_t so_memory = so_pair_sizes();
+        size_t three_memory = naux * sieve_->function_pairs().size();
+        size_t temp_memory = omp_nthread_ * (nbf * nbf + nbf * nso_max + nso_max * nso_max);
+
+        single_precision_ = false;
+        is_core_ = is_core();
+        if (!is_core_ || three_memory + so_memory + 2L * naux * naux + temp_memory > memory_)
+            c1_ = true;
+    }
+
+    if (c1_) {
+        AO2USO_aux_.reset();
+        DFJK::preiterations();
+        return;
+    }
+
+    initialize_JK_core();
+    initialize_JK_symmetric();
+}
+void SymmDFJK::initialize_JK_symmetric()
+{
+    int nirrep = AO2USO_->nirrep();
+    int nbf = primary_->nbf();
+    int naux = auxiliary_->nbf();
+    size_t ntri = sieve_->function_pairs().size();
+    const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
+    const Dimension& nsopi = AO2USO_->colspi();
+    const Dimension& nauxpi = AO2USO_aux_->colspi();
+    int nso_max = nsopi.max();
+
+    double** Qmnp = Qmn_->pointer();
+
+    timer_on("JK: (Q|mn) SO");
+
+    // => Auxiliary index: (Q_so|mn) = U^T (P|mn), in column blocks as the fitting <= //
+
+    SharedMatrix Ut(new Matrix("U^T (Aux)", naux, naux));
+    double** Utp = Ut->pointer();
+    for (int h = 0, offset = 0; h < nirrep; offset += nauxpi[h], h++) {
+        for (int P = 0; P < naux; P++)
+            for (int Q = 0; Q < nauxpi[h]; Q++)
+                Utp[offset + Q][P] = AO2USO_aux_->get(h, P, Q);
+    }
+
+    size_t used = naux * ntri + 2L * naux * (size_t) naux;
+    size_t max_cols = (memory_ > used ? (memory_ - used) / naux : 1L);
+    if (max_cols < 1)
+        max_cols = 1;
+    if (max_cols > ntri)
+        max_cols = ntri;
+    SharedMatrix temp(new Matrix("Qmn buffer", naux, max_cols));
+    double** tempp = temp->pointer();
+
+    for (size_t col = 0; col < ntri; col += max_cols) {
+        size_t ncol = (col + max_cols > ntri ? ntri - col : max_cols);
+        C_DGEMM('N','N',naux,ncol,naux,1.0,Utp[0],naux,&Qmnp[0][col],ntri,0.0,tempp[0],max_cols);
+        for (int Q = 0; Q < naux; Q++)
+            C_DCOPY(ncol,tempp[Q],1,&Qmnp[Q][col],1);
+    }
+    temp.reset();
+    Ut.reset();
+
+    // => Primary pairs: (Q_h|m_a n_b) = U_a^T (Q_h|mn) U_b, for a^b = h <= //
+
+    Qso_.clear();
+    for (int h = 0; h < nirrep; h++) {
+        size_t npair = 0L;
+        for (int a = 0; a < nirrep; a++) {
+            int b = a ^ h;
+            if (a > b) npair += nsopi[a] * (size_t) nsopi[b];
+            else if (a == b) npair += nsopi[a] * (nsopi[a] + 1L) / 2L;
+        }
+        Qso_.push_back(SharedMatrix(new Matrix("Qso (Fitted Integrals)", nauxpi[h], npair)));
+    }
+
+    std::vector<std::vector<double> > M(omp_nthread_), T1(omp_nthread_), S(omp_nthread_);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        M[thread].resize(nbf * (size_t) nbf);
+        T1[thread].resize(nbf * (size_t) nso_max);
+        S[thread].resize(nso_max * (size_t) nso_max);
+    }
+
+    for (int h = 0, offset = 0; h < nirrep; offset += nauxpi[h], h++) {
+        if (!nauxpi[h] || !Qso_[h]->coldim(0)) continue;
+        double** Bp = Qso_[h]->pointer();
+
+        #pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+        for (int Q = 0; Q < nauxpi[h]; Q++) {
+
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+
+            double* Mp = M[thread].data();
+            double* T1p = T1[thread].data();
+            double* Sp = S[thread].data();
+
+            ::memset((void*) Mp, '\0', sizeof(double) * nbf * nbf);
+            const double* Qrow = Qmnp[offset + Q];
+            for (size_t mn = 0; mn < ntri; mn++) {
+                int m = function_pairs[mn].first;
+                int n = function_pairs[mn].second;
+                Mp[m * (size_t) nbf + n] = Qrow[mn];
+                Mp[n * (size_t) nbf + m] = Qrow[mn];
+            }
+
+            for (int a = 0; a < nirrep; a++) {
+                int b = a ^ h;
+                int na = nsopi[a];
+                int nb = nsopi[b];
+                if (a < b || !na || !nb) continue;
+
+                C_DGEMM('N','N',nbf,nb,nbf,1.0,Mp,nbf,AO2USO_->pointer(b)[0],nb,0.0,T1p,nb);
+                C_DGEMM('T','N',na,nb,nbf,1.0,AO2USO_->pointer(a)[0],na,T1p,nb,0.0,Sp,nb);
+
+                double* dest = &Bp[Q][pair_offset_[h][a]];
+                if (a > b) {
+                    ::memcpy((void*) dest, (void*) Sp, sizeof(double) * na * nb);
+                } else {
+                    for (int m = 0; m < na; m++)
+                        for (int r = 0; r <= m; r++)
+                            *dest++ = Sp[m * (size_t) nb + r];
+                }
+            }
+        }
+    }
+
+    timer_off("JK: (Q|mn) SO");
+
+    Qmn_.reset();
+}
+const double* SymmDFJK::so_block(const double* Qrow, int h, int a, double* T) const
+{
+    int b = a ^ h;
+    int na = AO2USO_->colspi()[a];
+    int nb = AO2USO_->colspi()[b];
+
+    // Stored as is
+    if (a > b)
+        return Qrow + pair_offset_[h][a];
+
+    if (a < b) {
+        const double* block = Qrow + pair_offset_[h][b];
+        for (int m = 0; m < na; m++)
+            for (int r = 0; r < nb; r++)
+                T[m * (size_t) nb + r] = block[r * (size_t) na + m];
+    } else {
+        const double* block = Qrow + pair_offset_[h][a];
+        for (int m = 0; m < na; m++) {
+            for (int r = 0; r <= m; r++) {
+                T[m * (size_t) na + r] = *block;
+                T[r * (size_t) na + m] = *block;
+                block++;
+            }
+        }
+    }
+    return T;
+}
+void SymmDFJK::compute_JK()
+{
+    if (c1_) {
+        DFJK::compute_JK();
+        return;
+    }
+
+    if (do_J_) {
+        timer_on("JK: J");
+        block_J_symmetric();
+        timer_off("JK: J");
+    }
+    if (do_K_) {
+        timer_on("JK: K");
+        block_K_symmetric();
+        timer_off("JK: K");
+    }
+}
+void SymmDFJK::block_J_symmetric()
+{
+    int nirrep = AO2USO_->nirrep();
+    const Dimension& nsopi = AO2USO_->colspi();
+    double start = wall_time();
+    double flops = 0.0;
+    size_t integrals = 0L;
+
+    for (size_t N = 0; N < J_.size(); N++) {
+
+        // (Q|mn) D_mn only survives for Q in the irrep of D
+        int s = D_[N]->symmetry();
+        int naux = Qso_[s]->rowdim(0);
+        size_t npair = Qso_[s]->coldim(0);
+        if (!naux || !npair) continue;
+
+        std::vector<double> D2(npair), J2(npair), d(naux);
+
+        for (int a = 0; a < nirrep; a++) {
+            int b = a ^ s;
+            if (a < b) continue;
+            double* D2p = &D2[pair_offset_[s][a]];
+            if (a > b) {
+                for (int m = 0; m < nsopi[a]; m++)
+                    for (int r = 0; r < nsopi[b]; r++)
+                        *D2p++ = D_[N]->get(a, m, r) + D_[N]->get(b, r, m);
+            } else {
+                for (int m = 0; m < nsopi[a]; m++)
+                    for (int r = 0; r <= m; r++)
+                        *D2p++ = (m == r ? D_[N]->get(a, m, m) : D_[N]->get(a, m, r) + D_[N]->get(a, r, m));
+            }
+        }
+
+        double** Bp = Qso_[s]->pointer();
+        C_DGEMV('N',naux,npair,1.0,Bp[0],npair,D2.data(),1,0.0,d.data(),1);
+        C_DGEMV('T',naux,npair,1.0,Bp[0],npair,d.data(),1,0.0,J2.data(),1);
+        flops += 4.0 * naux * npair;
+        integrals += naux * npair;
+
+        for (int a = 0; a < nirrep; a++) {
+            int b = a ^ s;
+            if (a < b) continue;
+            double* J2p = &J2[pair_offset_[s][a]];
+            double** Jap = J_[N]->pointer(a);
+            double** Jbp = J_[N]->pointer(b);
+            if (a > b) {
+                for (int m = 0; m < nsopi[a]; m++) {
+                    for (int r = 0; r < nsopi[b]; r++) {
+                        Jap[m][r] += *J2p;
+                        Jbp[r][m] += *J2p;
+                        J2p++;
+                    }
+                }
+            } else {
+                for (int m = 0; m < nsopi[a]; m++) {
+                    for (int r = 0; r <= m; r++) {
+                        Jap[m][r] += *J2p;
+                        if (m != r) Jap[r][m] += *J2p;
+                        J2p++;
+                    }
+                }
+            }
+        }
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += integrals;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
+}
+void SymmDFJK::block_K_symmetric()
+{
+    int nirrep = AO2USO_->nirrep();
+    const Dimension& nsopi = AO2USO_->colspi();
+    int nso_max = nsopi.max();
+    double start = wall_time();
+    double flops = 0.0;
+    size_t integrals = 0L;
+
+    // Rows of Q per E block, from what the SO tensor leaves free
+    int naux_max = 0;
+    size_t so_memory = 0L;
+    for (int h = 0; h < nirrep; h++) {
+        naux_max = std::max(naux_max, Qso_[h]->rowdim(0));
+        so_memory += Qso_[h]->rowdim(0) * (size_t) Qso_[h]->coldim(0);
+    }
+    int nocc_max = 1;
+    for (size_t N = 0; N < C_left_.size(); N++)
+        for (int h = 0; h < nirrep; h++)
+            nocc_max = std::max(nocc_max, C_left_[N]->colspi()[h]);
+    size_t used = so_memory + memory_overhead() + omp_nthread_ * (size_t) nso_max * nso_max;
+    size_t avail = (memory_ > used ? memory_ - used : 0L);
+    size_t max_rows = avail / (2L * nso_max * nocc_max);
+    if (max_rows > (size_t) naux_max)
+        max_rows = naux_max;
+    if (max_rows < 1L)
+        max_rows = 1L;
+
+    std::vector<double> E_left(max_rows * nso_max * (size_t) nocc_max);
+    std::vector<double> E_right(lr_symmetric_ ? 0L : E_left.size());
+    std::vector<std::vector<double> > T(omp_nthread_, std::vector<double>(nso_max * (size_t) nso_max));
+
+    for (size_t N = 0; N < K_.size(); N++) {
+        int sl = C_left_[N]->symmetry();
+        int sr = C_right_[N]->symmetry();
+        bool same = (lr_symmetric_ || C_left_[N].get() == C_right_[N].get());
+
+        for (int h = 0; h < nirrep; h++) {
+            int naux_h = Qso_[h]->rowdim(0);
+            if (!naux_h || !Qso_[h]->coldim(0)) continue;
+            double** Bp = Qso_[h]->pointer();
+
+            for (int c = 0; c < nirrep; c++) {
+                // Occupied irrep c: C rows of irrep bl (br), E and K rows of irrep a (d)
+                int bl = c ^ sl;
+                int br = c ^ sr;
+                int a = h ^ bl;
+                int d = h ^ br;
+                int nocc = C_left_[N]->colspi()[c];
+                if (!nocc || !nsopi[a] || !nsopi[d] || !nsopi[bl] || !nsopi[br]) continue;
+
+                double** Clp = C_left_[N]->pointer(bl);
+                double** Crp = C_right_[N]->pointer(br);
+
+                for (int Q0 = 0; Q0 < naux_h; Q0 += max_rows) {
+                    int nrows = std::min((int) max_rows, naux_h - Q0);
+                    int ld = nrows * nocc;
+
+                    // E(m, Q i) = (Q|m r) C_ri
+                    for (int side = 0; side < (same ? 1 : 2); side++) {
+                        int e = (side ? d : a);
+                        int b = (side ? br : bl);
+                        double** Cp = (side ? Crp : Clp);
+                        double* Ep = (side ? E_right.data() : E_left.data());
+
+                        #pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+                        for (int Q = 0; Q < nrows; Q++) {
+
+                            int thread = 0;
+                            #ifdef _OPENMP
+                                thread = omp_get_thread_num();
+                            #endif
+
+                            const double* Mp = so_block(Bp[Q0 + Q], h, e, T[thread].data());
+                            C_DGEMM('N','N',nsopi[e],nocc,nsopi[b],1.0,const_cast<double*>(Mp),nsopi[b],
+                                Cp[0],C_left_[N]->colspi()[c],0.0,&Ep[Q * (size_t) nocc],ld);
+                        }
+                        flops += 2.0 * nrows * nsopi[e] * nsopi[b] * nocc;
+                        integrals += nrows * (size_t) nsopi[e] * nsopi[b];
+                    }
+
+                    double* Erp = (same ? E_left.data() : E_right.data());
+                    C_DGEMM('N','T',nsopi[a],nsopi[d],ld,1.0,E_left.data(),ld,Erp,ld,1.0,K_[N]->pointer(a)[0],nsopi[d]);
+                    flops += 2.0 * nsopi[a] * nsopi[d] * ld;
+                }
+            }
+        }
+    }
+
+    JKMetrics& metrics = current_metrics();
+    metrics.integrals += integrals;
+    metrics.flops += flops;
+    metrics.contraction_time += wall_time() - start;
+}
+void SymmDFJK::postiterations()
+{
+    Qso_.clear();
+    AO2USO_aux_.reset();
+    DFJK::postiterations();
+}
+
+}
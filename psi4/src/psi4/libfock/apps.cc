@@ -1025,6 +1025,8 @@ double RCIS::compute_energy()
     H->set_bench(bench_);
     H->set_exact_diagonal(options_.get_bool("SOLVER_EXACT_DIAGONAL"));
     solver->set_convergence(convergence_);
+    // The subspace vectors get what the JK object leaves
+    solver->set_memory((size_t)(0.125 * (1.0 - options_.get_double("CPHF_MEM_SAFETY_FACTOR")) * memory_));
 
     // Initialization/Memory
     solver->initialize();
@@ -1395,6 +1397,7 @@ double RTDA::compute_energy()
     // Extra Knobs
     H->set_print(print_);
     H->set_debug(debug_);
+    solver->set_memory((size_t)(0.125 * (1.0 - options_.get_double("CPHF_MEM_SAFETY_FACTOR")) * memory_));
 
     // Initialization/Memory
     solver->initialize();
@@ -0,0 +1,92 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef libfock_compression_H
+#define libfock_compression_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+/**
+ * Fixed-accuracy storage for integrals written to scratch.
+ *
+ * A value v is stored as the 32-bit integer round(v / step), so that with
+ * step = 2 * tol every decompressed value is within tol of the original and
+ * the on-disk footprint is halved. Packing and unpacking work in place on a
+ * double buffer: the integers occupy the first half of the buffer's bytes.
+ */
+namespace compression {
+
+/// Bytes per stored element for a given step (0.0 means uncompressed doubles)
+inline size_t element_size(double step) {
+    return (step > 0.0 ? sizeof(int32_t) : sizeof(double));
+}
+
+/// Can every value up to max_abs be represented at this step?
+inline bool representable(double max_abs, double step) {
+    return (max_abs / step < (double) std::numeric_limits<int32_t>::max());
+}
+
+/// Pack n doubles into n int32 at the front of buf, in place
+inline void pack(double* buf, size_t n, double step) {
+    const double inv = 1.0 / step;
+    const double imax = (double) std::numeric_limits<int32_t>::max();
+    char* bytes = reinterpret_cast<char*>(buf);
+    // Ascending order never overwrites an unread double, int i lives in bytes [4i, 4i+4)
+    for (size_t i = 0; i < n; i++) {
+        double q = std::round(buf[i] * inv);
+        if (std::fabs(q) > imax)
+            throw PSIEXCEPTION("Integral too large for DISK_COMPRESSION_TOLERANCE, increase the tolerance or set it to 0.0");
+        int32_t qi = (int32_t) q;
+        std::memcpy(bytes + i * sizeof(int32_t), &qi, sizeof(int32_t));
+    }
+}
+
+/// Unpack n int32 at the front of buf back into n doubles, in place
+inline void unpack(double* buf, size_t n, double step) {
+    const char* bytes = reinterpret_cast<const char*>(buf);
+    // Descending order never overwrites an unread int
+    for (size_t i = n; i > 0; i--) {
+        int32_t qi;
+        std::memcpy(&qi, bytes + (i - 1) * sizeof(int32_t), sizeof(int32_t));
+        buf[i - 1] = step * (double) qi;
+    }
+}
+
+}  // namespace compression
+
+}  // namespace psi
+
+#endif
@@ -40,10 +40,15 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/pointgrp.h"
 
 #include <vector>
 #include <string>
 #include <sstream>
+#include <fstream>
+#include <map>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <limits>
 #include <ctype.h>
@@ -2677,6 +2682,8 @@ class NuclearWeightMgr
     std::shared_ptr<Molecule> molecule_;
     double** inv_dist_;
     double** amatrix_;
+    /// STRATMANN only: (distance, atom) to every atom, nearest first, per atom
+    std::vector<std::vector<std::pair<double, int> > > neighbors_;
     ////
 
     inline double distToAtom(MassPoint mp, int A) const {
@@ -2687,6 +2694,7 @@ class NuclearWeightMgr
 
     static double BeckeStepFunction(double x);
     static double StratmannStepFunction(double mu);
+    double computeStratmannWeight(MassPoint mp, int A) const;
 
     // Becke says u = (chi-1)/(chi+1), a = u/(u^2-1), then clip so that |a| <= 1/2.
     // We can save a step and find `a' directly from chi.
@@ -2726,6 +2734,14 @@ NuclearWeightMgr::NuclearWeightMgr(std::shared_ptr<Molecule> mol, int scheme)
         for (int i = 0; i < natom; i++)
             for (int j = 0; j < natom; j++)
                 amatrix_[i][j] = 0;
+        if (scheme == STRATMANN) {
+            neighbors_.resize(natom);
+            for (int A = 0; A < natom; A++) {
+                for (int B = 0; B < natom; B++)
+                    neighbors_[A].push_back(std::make_pair((A == B) ? 0.0 : 1.0 / inv_dist_[A][B], B));
+                std::sort(neighbors_[A].begin(), neighbors_[A].end());
+            }
+        }
     } else if (scheme == BECKE || scheme == TREUTLER) {
         for (int i = 0; i < natom; i++) {
             for (int j = 0; j < i; j++) {
@@ -2844,6 +2860,8 @@ double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratm
     // Stratmann's step function gives us this handy check
     if (scheme_ == STRATMANN && distToAtom(mp, A) <= stratmannCutoff)
         return 1;
+    if (scheme_ == STRATMANN)
+        return computeStratmannWeight(mp, A);
 
     int natom = molecule_->natom();
     // Find the distance from point mp to each atom in the molecule.
@@ -2873,6 +2891,63 @@ double NuclearWeightMgr::computeNuclearWeight(MassPoint mp, int A, double stratm
     return numerator/denominator;
 }
 
+// Stratmann's s(mu) is exactly 1 below mu = -0.64 and exactly 0 above 0.64. Since
+// |mu_ij| >= |d_i - d_j| / (d_i + d_j) for the point distances d_i, d_j, s(mu_ij) == 1
+// whenever atom j is more than ratio = 1.64/0.36 times as far from the point as atom i,
+// and P_i == 0 whenever atom i is more than ratio times as far as the nearest atom (at d0).
+// So only atoms within ratio*d0 have a cell function, each only needs partners within ratio*d_i,
+// and nothing beyond ratio^2*d0 of the point enters. The weight is the same as from
+// the full double loop, at a cost set by the local atom density.
+double NuclearWeightMgr::computeStratmannWeight(MassPoint mp, int A) const
+{
+    const double ratio = 1.64 / 0.36;
+    double dA = distToAtom(mp, A);
+
+    // d0 <= dA, so every atom that matters lies within (1 + ratio^2)*dA of atom A
+    const std::vector<std::pair<double, int> >& neighbors = neighbors_[A];
+    double reach = (1.0 + ratio * ratio) * dA;
+    int nnear = 0;
+    int near[neighbors.size()];
+    double dist[neighbors.size()];
+    double d0 = dA;
+    for (size_t k = 0; k < neighbors.size() && neighbors[k].first <= reach; k++) {
+        near[nnear] = neighbors[k].second;
+        dist[nnear] = distToAtom(mp, near[nnear]);
+        d0 = std::min(d0, dist[nnear]);
+        nnear++;
+    }
+    if (dA > ratio * d0)
+        return 0;
+
+    // Nearest first, so both loops stop at their cutoff
+    int order[nnear];
+    for (int k = 0; k < nnear; k++) order[k] = k;
+    std::sort(order, order + nnear, [&dist](int a, int b) { return dist[a] < dist[b]; });
+
+    double numerator = 0;
+    double denominator = 0;
+    for (int ii = 0; ii < nnear; ii++) {
+        int i = order[ii];
+        if (dist[i] > ratio * d0)
+            break;
+        double prod = 1;
+        for (int jj = 0; jj < nnear; jj++) {
+            int j = order[jj];
+            if (dist[j] > ratio * dist[i])
+                break;
+            if (i == j)
+                continue;
+            double mu = (dist[i] - dist[j]) * inv_dist_[near[i]][near[j]];
+            prod *= StratmannStepFunction(mu);
+            if (prod == 0)
+                break;
+        }
+        if (near[i] == A) numerator = prod;
+        denominator += prod;
+    }
+    return numerator/denominator;
+}
+
 class OrientationMgr
 {
     // "Local" vector, matrix, atom, and molecule definitions.
@@ -3540,6 +3615,16 @@ int RadialPruneMgr::GetPrunedNumAngPts(double rho)
     return LebedevGridMgr::findNPointsByOrder_roundUp(pruned_order);
 }
 
+// The nominal radial count is for the second period; each period up or down adds or removes the increment
+static int RadialPointsForElement(MolecularGrid::MolecularGridOptions const& opt, int Z)
+{
+    if (opt.radial_row_increment == 0) return opt.nradpts;
+    static const int period_ends[] = {2, 10, 18, 36, 54, 86};
+    int period = 1;
+    while (period <= 6 && Z > period_ends[period - 1]) period++;
+    return std::max(1, opt.nradpts + opt.radial_row_increment * (period - 2));
+}
+
 void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
 {
     options_ = opt; // Save a copy
@@ -3554,33 +3639,51 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
     orientation_ = std_orientation.orientation();
     radial_grids_.clear();
     spherical_grids_.clear();
+    point_atoms_.clear();
+    point_raw_weights_.clear();
+    symmetry_unique_ = opt.symmetry_unique;
 
     // Iterate over atoms
     for (int A = 0; A < molecule_->natom(); A++) {
         int Z = molecule_->true_atomic_number(A);
         double stratmannCutoff = nuc.GetStratmannCutoff(A);
 
+        // The grid of an equivalent atom is the image of its unique atom's, which stands in for all of them
+        bool keep = true;
+        double multiplicity = 1.0;
+        if (symmetry_unique_) {
+            int U = molecule_->atom_to_unique(A);
+            keep = (molecule_->unique(U) == A);
+            multiplicity = molecule_->nequivalent(U);
+        }
+
         if (opt.namedGrid == -1) { // Not using a named grid
-            double r[opt.nradpts];
-            double wr[opt.nradpts];
+            int nradpts = RadialPointsForElement(opt, Z);
+            double r[nradpts];
+            double wr[nradpts];
             double alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
-            RadialGridMgr::makeRadialGrid(opt.nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r, wr, alpha);
+            RadialGridMgr::makeRadialGrid(nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r, wr, alpha);
 
             // RMP: Want this stuff too
-            radial_grids_.push_back(RadialGrid::build("Unknown", opt.nradpts, r, wr, alpha));
+            radial_grids_.push_back(RadialGrid::build("Unknown", nradpts, r, wr, alpha));
             std::vector<std::shared_ptr<SphericalGrid> > spheres;
             spherical_grids_.push_back(spheres);
 
-            for (int i = 0; i < opt.nradpts; i++) {
+            for (int i = 0; i < nradpts; i++) {
                 int numAngPts = prune.GetPrunedNumAngPts(r[i]/alpha);
                 const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
 
                 // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
                 spherical_grids_[A].push_back(SphericalGrid::build("Unknown", numAngPts, anggrid));
+                if (!keep) continue;
 
                 for (int j = 0; j < numAngPts; j++) {
-                    MassPoint mp = { r[i] * anggrid[j].x, r[i]*anggrid[j].y, r[i]*anggrid[j].z, wr[i]*anggrid[j].w };
+                    MassPoint mp = { r[i] * anggrid[j].x, r[i]*anggrid[j].y, r[i]*anggrid[j].z, multiplicity * wr[i]*anggrid[j].w };
                     mp = std_orientation.MoveIntoPosition(mp, A);
+                    if (keep_partition_data_) {
+                        point_atoms_.push_back(A);
+                        point_raw_weights_.push_back(mp.w);
+                    }
                     mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff); // This ain't gonna fly. Must abate this mickey mouse a most rikky tikki tavi.
                     grid.push_back(mp);
                     assert(!std::isnan(mp.w));
@@ -3590,9 +3693,15 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
             assert(opt.namedGrid == 0 || opt.namedGrid == 1);
             int npts            = (opt.namedGrid == 0) ? StandardGridMgr::GetSG0size(Z) : StandardGridMgr::GetSG1size(Z);
             const MassPoint *sg = (opt.namedGrid == 0) ? StandardGridMgr::GetSG0grid(Z) : StandardGridMgr::GetSG1grid(Z);
+            if (!keep) continue;
 
             for (int i = 0; i < npts; i++) {
                 MassPoint mp = std_orientation.MoveIntoPosition(sg[i], A);
+                mp.w *= multiplicity;
+                if (keep_partition_data_) {
+                    point_atoms_.push_back(A);
+                    point_raw_weights_.push_back(mp.w);
+                }
                 mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff); // This ain't gonna fly. Must abate this mickey mouse a most rikky tikki tavi.
                 grid.push_back(mp);
                 assert(!std::isnan(mp.w));
@@ -3632,6 +3741,7 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt,
     orientation_ = std_orientation.orientation();
     radial_grids_.clear();
     spherical_grids_.clear();
+    symmetry_unique_ = false;
 
     // Iterate over atoms
     for (int A = 0; A < molecule_->natom(); A++) {
@@ -3965,6 +4075,47 @@ void BlockOPoints::print(std::string out, int print)
         printer->Printf( "\n\n");
     }
 }
+// Does every operation of the point group carry each atom onto an equivalent one, and the oriented
+// Lebedev spheres onto themselves? Then the grid of every atom is the image of its unique atom's grid.
+static bool GridRespectsPointGroup(std::shared_ptr<Molecule> mol, std::shared_ptr<Matrix> orientation)
+{
+    CharacterTable ct = mol->point_group()->char_table();
+    if (ct.order() == 1) return false;
+    double** R = orientation->pointer();
+    int natom = mol->natom();
+
+    for (int g = 0; g < ct.order(); g++) {
+        SymmetryOperation so = ct.symm_operation(g);
+
+        // The spheres have the octahedral group, so R^T g R must be a signed permutation
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                double M = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    for (int l = 0; l < 3; l++) {
+                        M += R[k][i] * so(k, l) * R[l][j];
+                    }
+                }
+                if (std::fabs(M) > 1.0E-8 && std::fabs(std::fabs(M) - 1.0) > 1.0E-8) return false;
+            }
+        }
+
+        for (int A = 0; A < natom; A++) {
+            double x = so(0, 0) * mol->x(A) + so(0, 1) * mol->y(A) + so(0, 2) * mol->z(A);
+            double y = so(1, 0) * mol->x(A) + so(1, 1) * mol->y(A) + so(1, 2) * mol->z(A);
+            double z = so(2, 0) * mol->x(A) + so(2, 1) * mol->y(A) + so(2, 2) * mol->z(A);
+            bool found = false;
+            for (int B = 0; B < natom && !found; B++) {
+                if (mol->atom_to_unique(B) != mol->atom_to_unique(A)) continue;
+                double dx = x - mol->x(B), dy = y - mol->y(B), dz = z - mol->z(B);
+                found = (dx * dx + dy * dy + dz * dz < 1.0E-12);
+            }
+            if (!found) return false;
+        }
+    }
+    return true;
+}
+
 DFTGrid::DFTGrid(std::shared_ptr<Molecule> molecule,
                  std::shared_ptr<BasisSet> primary,
                  Options& options) :
@@ -4002,7 +4153,8 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map, std:
     }
 
     std::map<std::string, int> full_int_options;
-    std::vector<std::string> int_keys = {"DFT_BLOCK_MAX_POINTS", "DFT_BLOCK_MIN_POINTS", "DFT_SPHERICAL_POINTS", "DFT_RADIAL_POINTS"};
+    std::vector<std::string> int_keys = {"DFT_BLOCK_MAX_POINTS", "DFT_BLOCK_MIN_POINTS", "DFT_SPHERICAL_POINTS", "DFT_RADIAL_POINTS",
+                                         "DFT_RADIAL_ROW_INCREMENT"};
     for (auto key : int_keys){
         if (int_opts_map.find(key) != int_opts_map.end()){
             full_int_options[key] = int_opts_map[key];
@@ -4022,21 +4174,270 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map, std:
     opt.namedGrid = StandardGridMgr::WhichGrid(full_str_options["DFT_GRID_NAME"].c_str());
     opt.nradpts = full_int_options["DFT_RADIAL_POINTS"];
     opt.nangpts = full_int_options["DFT_SPHERICAL_POINTS"];
+    opt.radial_row_increment = full_int_options["DFT_RADIAL_ROW_INCREMENT"];
+    opt.symmetry_unique = false;
+    if (int_opts_map.count("DFT_GRID_SYMMETRY") && int_opts_map["DFT_GRID_SYMMETRY"]) {
+        OrientationMgr std_orientation(molecule_);
+        opt.symmetry_unique = GridRespectsPointGroup(molecule_, std_orientation.orientation());
+    }
 
     if (LebedevGridMgr::findOrderByNPoints(opt.nangpts) == -1) {
         LebedevGridMgr::PrintHelp(); // Tell what the admissible values are.
         throw PSIEXCEPTION("Invalid number of spherical points (not a Lebedev number)");
     }
 
-    MolecularGrid::buildGridFromOptions(opt);
-
     // Blocking/sieving info
     int max_points = full_int_options["DFT_BLOCK_MAX_POINTS"];
     int min_points = full_int_options["DFT_BLOCK_MIN_POINTS"];
     double max_radius = options_.get_double("DFT_BLOCK_MAX_RADIUS");
     double epsilon = options_.get_double("DFT_BASIS_TOLERANCE");
     std::shared_ptr<BasisExtents> extents(new BasisExtents(primary_, epsilon));
+
+    bool use_cache = options_.get_bool("DFT_GRID_CACHE");
+    if (use_cache) {
+        std::stringstream key;
+        key.precision(17);
+        key << primary_->name() << " " << primary_->nbf() << " |";
+        for (int A = 0; A < molecule_->natom(); A++) {
+            key << " " << molecule_->true_atomic_number(A);
+        }
+        key << " | " << opt.radscheme << " " << opt.prunescheme << " " << opt.nucscheme << " "
+            << opt.namedGrid << " " << opt.nradpts << " " << opt.radial_row_increment << " " << opt.nangpts << " " << opt.bs_radius_alpha
+            << " " << opt.pruning_alpha << " " << max_points << " " << min_points << " " << max_radius
+            << " " << epsilon << " " << options_.get_str("DFT_BLOCK_SCHEME");
+        if (opt.symmetry_unique) {
+            key << " | unique";
+            for (int A = 0; A < molecule_->natom(); A++) {
+                key << " " << molecule_->atom_to_unique(A);
+            }
+        }
+        cache_key_ = key.str();
+
+        MolecularGrid::options_ = opt;
+        if (load_from_cache(extents, opt.nucscheme)) return;
+    }
+
+    keep_partition_data_ = use_cache;
+    MolecularGrid::buildGridFromOptions(opt);
     postProcess(extents, max_points, min_points, max_radius);
+
+    if (use_cache) {
+        save_to_cache();
+    }
+    keep_partition_data_ = false;
+    point_atoms_.clear();
+    point_raw_weights_.clear();
+}
+
+/// A blocked DFT grid kept between Wavefunctions, see DFT_GRID_CACHE
+struct DFTGridCacheEntry {
+    /// Atom positions the grid was built for, [natom][3]
+    std::vector<double> geometry;
+    /// Point coordinates, in blocked order
+    std::vector<double> x, y, z;
+    /// Weights before nuclear partitioning, in blocked order
+    std::vector<double> raw_weights;
+    /// Parent atom of each point
+    std::vector<int> atoms;
+    /// Slow index of each point
+    std::vector<int> index;
+    /// Number of points in each block
+    std::vector<int> block_sizes;
+    /// Orientation and atomic grids of the original build (in-memory entries only)
+    std::shared_ptr<Matrix> orientation;
+    std::vector<std::shared_ptr<RadialGrid> > radial_grids;
+    std::vector<std::vector<std::shared_ptr<SphericalGrid> > > spherical_grids;
+};
+
+namespace {
+
+std::map<std::string, std::shared_ptr<DFTGridCacheEntry> > dft_grid_cache;
+
+template <class T>
+void write_cache_array(std::ofstream& out, const std::vector<T>& v)
+{
+    size_t n = v.size();
+    out.write(reinterpret_cast<const char*>(&n), sizeof(size_t));
+    out.write(reinterpret_cast<const char*>(v.data()), n * sizeof(T));
+}
+
+template <class T>
+bool read_cache_array(std::ifstream& in, std::vector<T>& v)
+{
+    size_t n = 0;
+    if (!in.read(reinterpret_cast<char*>(&n), sizeof(size_t))) return false;
+    v.resize(n);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(v.data()), n * sizeof(T)));
+}
+
+// File layout: key, then each array of DFTGridCacheEntry as (length, data)
+void write_cache_file(const std::string& filename, const std::string& key, const DFTGridCacheEntry& entry)
+{
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        outfile->Printf("  DFTGrid: unable to write grid cache file %s.\n\n", filename.c_str());
+        return;
+    }
+    std::vector<char> keyv(key.begin(), key.end());
+    write_cache_array(out, keyv);
+    write_cache_array(out, entry.geometry);
+    write_cache_array(out, entry.x);
+    write_cache_array(out, entry.y);
+    write_cache_array(out, entry.z);
+    write_cache_array(out, entry.raw_weights);
+    write_cache_array(out, entry.atoms);
+    write_cache_array(out, entry.index);
+    write_cache_array(out, entry.block_sizes);
+}
+
+std::shared_ptr<DFTGridCacheEntry> read_cache_file(const std::string& filename, const std::string& key)
+{
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in) return std::shared_ptr<DFTGridCacheEntry>();
+
+    std::vector<char> keyv;
+    if (!read_cache_array(in, keyv) || std::string(keyv.begin(), keyv.end()) != key)
+        return std::shared_ptr<DFTGridCacheEntry>();
+
+    std::shared_ptr<DFTGridCacheEntry> entry(new DFTGridCacheEntry);
+    bool ok = read_cache_array(in, entry->geometry) && read_cache_array(in, entry->x) &&
+              read_cache_array(in, entry->y) && read_cache_array(in, entry->z) &&
+              read_cache_array(in, entry->raw_weights) && read_cache_array(in, entry->atoms) &&
+              read_cache_array(in, entry->index) && read_cache_array(in, entry->block_sizes);
+    if (!ok) return std::shared_ptr<DFTGridCacheEntry>();
+    return entry;
+}
+
+}  // namespace
+
+void DFTGrid::clear_cache()
+{
+    dft_grid_cache.clear();
+}
+
+void DFTGrid::save_to_cache()
+{
+    std::shared_ptr<DFTGridCacheEntry> entry(new DFTGridCacheEntry);
+
+    int natom = molecule_->natom();
+    entry->geometry.resize(3L * natom);
+    for (int A = 0; A < natom; A++) {
+        entry->geometry[3L * A + 0] = molecule_->x(A);
+        entry->geometry[3L * A + 1] = molecule_->y(A);
+        entry->geometry[3L * A + 2] = molecule_->z(A);
+    }
+
+    entry->x.assign(x_, x_ + npoints_);
+    entry->y.assign(y_, y_ + npoints_);
+    entry->z.assign(z_, z_ + npoints_);
+    entry->index.assign(index_, index_ + npoints_);
+    entry->atoms.resize(npoints_);
+    entry->raw_weights.resize(npoints_);
+    for (int Q = 0; Q < npoints_; Q++) {
+        entry->atoms[Q] = point_atoms_[index_[Q]];
+        entry->raw_weights[Q] = point_raw_weights_[index_[Q]];
+    }
+
+    // Blocks are contiguous runs of the blocked arrays
+    size_t offset = 0;
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        if (blocks_[b]->x() != x_ + offset)
+            throw PSIEXCEPTION("DFTGrid: grid blocks are not contiguous, cannot cache the grid.");
+        entry->block_sizes.push_back(blocks_[b]->npoints());
+        offset += blocks_[b]->npoints();
+    }
+
+    entry->orientation = orientation_;
+    entry->radial_grids = radial_grids_;
+    entry->spherical_grids = spherical_grids_;
+
+    dft_grid_cache[cache_key_] = entry;
+
+    std::string filename = options_.get_str("DFT_GRID_CACHE_FILE");
+    if (!filename.empty()) {
+        write_cache_file(filename, cache_key_, *entry);
+    }
+}
+
+bool DFTGrid::load_from_cache(std::shared_ptr<BasisExtents> extents, int nucscheme)
+{
+    std::shared_ptr<DFTGridCacheEntry> entry;
+    if (dft_grid_cache.count(cache_key_)) {
+        entry = dft_grid_cache[cache_key_];
+    } else {
+        std::string filename = options_.get_str("DFT_GRID_CACHE_FILE");
+        if (filename.empty()) return false;
+        entry = read_cache_file(filename, cache_key_);
+        if (!entry) return false;
+        dft_grid_cache[cache_key_] = entry;
+    }
+
+    // Points are carried rigidly with their atoms, so only small moves are allowed
+    int natom = molecule_->natom();
+    std::vector<double> shift(3L * natom);
+    double max_shift = 0.0;
+    for (int A = 0; A < natom; A++) {
+        shift[3L * A + 0] = molecule_->x(A) - entry->geometry[3L * A + 0];
+        shift[3L * A + 1] = molecule_->y(A) - entry->geometry[3L * A + 1];
+        shift[3L * A + 2] = molecule_->z(A) - entry->geometry[3L * A + 2];
+        double R = sqrt(shift[3L * A + 0] * shift[3L * A + 0] + shift[3L * A + 1] * shift[3L * A + 1] +
+                        shift[3L * A + 2] * shift[3L * A + 2]);
+        max_shift = std::max(max_shift, R);
+    }
+    if (max_shift > options_.get_double("DFT_GRID_CACHE_MAX_SHIFT")) return false;
+
+    NuclearWeightMgr nuc(molecule_, nucscheme);
+    std::vector<double> stratmannCutoff(natom);
+    for (int A = 0; A < natom; A++) {
+        stratmannCutoff[A] = nuc.GetStratmannCutoff(A);
+    }
+
+    npoints_ = entry->x.size();
+    x_ = new double[npoints_];
+    y_ = new double[npoints_];
+    z_ = new double[npoints_];
+    w_ = new double[npoints_];
+    index_ = new int[npoints_];
+
+    // Only the nuclear partition depends on the relative atom positions
+    for (int Q = 0; Q < npoints_; Q++) {
+        int A = entry->atoms[Q];
+        MassPoint mp = {entry->x[Q] + shift[3L * A + 0], entry->y[Q] + shift[3L * A + 1],
+                        entry->z[Q] + shift[3L * A + 2], entry->raw_weights[Q]};
+        mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff[A]);
+        x_[Q] = mp.x;
+        y_[Q] = mp.y;
+        z_[Q] = mp.z;
+        w_[Q] = mp.w;
+        index_[Q] = entry->index[Q];
+    }
+
+    extents_ = extents;
+    MolecularGrid::primary_ = extents_->basis();
+    symmetry_unique_ = MolecularGrid::options_.symmetry_unique;
+
+    max_points_ = 0;
+    max_functions_ = 0;
+    size_t offset = 0;
+    for (size_t b = 0; b < entry->block_sizes.size(); b++) {
+        int n = entry->block_sizes[b];
+        std::shared_ptr<BlockOPoints> block(
+            new BlockOPoints(n, &x_[offset], &y_[offset], &z_[offset], &w_[offset], extents_));
+        max_points_ = std::max(max_points_, n);
+        max_functions_ = std::max(max_functions_, static_cast<int>(block->functions_local_to_global().size()));
+        blocks_.push_back(block);
+        offset += n;
+    }
+
+    if (entry->orientation) {
+        orientation_ = entry->orientation;
+        radial_grids_ = entry->radial_grids;
+        spherical_grids_ = entry->spherical_grids;
+    }
+
+    outfile->Printf("  DFTGrid: reusing cached grid of %d points (max atom shift %.3E bohr).\n\n", npoints_,
+                    max_shift);
+    return true;
 }
 
 
@@ -4062,6 +4463,8 @@ void PseudospectralGrid::buildGridFromOptions()
     opt.namedGrid = StandardGridMgr::WhichGrid(options_.get_str("PS_GRID_NAME").c_str());
     opt.nradpts = options_.get_int("PS_RADIAL_POINTS");
     opt.nangpts = options_.get_int("PS_SPHERICAL_POINTS");
+    opt.radial_row_increment = 0;
+    opt.symmetry_unique = false;
 
     if (LebedevGridMgr::findOrderByNPoints(opt.nangpts) < -1) {
         LebedevGridMgr::PrintHelp(); // Tell what the admissible values are.
@@ -4081,7 +4484,8 @@ void PseudospectralGrid::buildGridFromOptions()
 }
 
 MolecularGrid::MolecularGrid(std::shared_ptr<Molecule> molecule) :
-    debug_(0), molecule_(molecule), npoints_(0), max_points_(0), max_functions_(0)
+    debug_(0), molecule_(molecule), npoints_(0), max_points_(0), max_functions_(0),
+    keep_partition_data_(false), symmetry_unique_(false)
 {
 }
 MolecularGrid::~MolecularGrid()
@@ -4197,8 +4601,12 @@ void MolecularGrid::print(std::string out, int /*print*/) const
     printer->Printf("    BS radius alpha     = %14g\n", options_.bs_radius_alpha);
     printer->Printf("    Pruning alpha       = %14g\n", options_.pruning_alpha);
     printer->Printf("    Radial Points       = %14d\n", options_.nradpts);
+    if (options_.radial_row_increment != 0)
+        printer->Printf("    Radial Row Increment= %14d\n", options_.radial_row_increment);
     printer->Printf("    Spherical Points    = %14d\n", options_.nangpts);
     printer->Printf("    Total Points        = %14d\n", npoints_);
+    if (symmetry_unique_)
+        printer->Printf("    Symmetry-Unique     = %14s\n", "TRUE");
     printer->Printf("    Total Blocks        = %14zu\n", blocks_.size());
     printer->Printf("    Max Points          = %14d\n", max_points_);
     printer->Printf("    Max Functions       = %14d\n", max_functions_);
@@ -98,6 +98,16 @@ protected:
     /// Vector of blocks
     std::vector<std::shared_ptr<BlockOPoints> > blocks_;
 
+    /// Record point_atoms_ and point_raw_weights_ while building (used by the DFT grid cache)
+    bool keep_partition_data_;
+    /// Parent atom of each point, by slow index
+    std::vector<int> point_atoms_;
+    /// Weight of each point before nuclear partitioning, by slow index
+    std::vector<double> point_raw_weights_;
+
+    /// Are only the symmetry-unique atomic grids present (see MolecularGridOptions)?
+    bool symmetry_unique_;
+
     /// Points to basis extents, built internally
     std::shared_ptr<BasisExtents> extents_;
     /// BasisSet from extents_
@@ -118,6 +128,8 @@ public:
         short namedGrid; // -1 = None, 0 = SG-0, 1 = SG-1
         int nradpts;
         int nangpts;
+        int radial_row_increment; // Radial points added per period of the periodic table, 0 for none
+        bool symmetry_unique;     // Only the atoms unique under the point group, weighted by their equivalents
     };
 protected:
     /// A copy of the options used, for printing purposes.
@@ -153,6 +165,8 @@ public:
     int max_points() const { return max_points_; }
     /// Maximum number of funtions in a block
     int max_functions() const { return max_functions_; }
+    /// Does this grid hold only the symmetry-unique atoms? Then it integrates totally symmetric functions only
+    bool symmetry_unique() const { return symmetry_unique_; }
 
     /// The x points. You do not own this
     double* x() const { return x_; }
@@ -195,6 +209,12 @@ public:
 
 };
 
+/**
+ * Besides the option names, the int_opts_map of the constructor may hold
+ * DFT_GRID_SYMMETRY = 1, which asks for the symmetry-unique grid of
+ * MolecularGridOptions::symmetry_unique. The full grid is built instead
+ * when the point group does not map the oriented atomic grids onto each other.
+ */
 class DFTGrid : public MolecularGrid {
 
 protected:
@@ -206,12 +226,24 @@ protected:
     /// The Options object
     Options& options_;
 
+    // => Grid cache (DFT_GRID_CACHE) <= //
+
+    /// Identifies the atoms, basis and grid options of this grid in the cache
+    std::string cache_key_;
+    /// Store the blocked grid in the cache, and in DFT_GRID_CACHE_FILE if set
+    void save_to_cache();
+    /// Rebuild from a cached grid of a nearby geometry. Returns false if none applies
+    bool load_from_cache(std::shared_ptr<BasisExtents> extents, int nucscheme);
+
 public:
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary, Options& options);
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
          std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map,
          Options& options);
 virtual ~DFTGrid();
+
+    /// Drop all grids held in the in-memory DFT grid cache
+    static void clear_cache();
 };
 
 class RadialGrid {
@@ -409,6 +441,12 @@ public:
     const std::vector<int>& shells_local_to_global() const { return shells_local_to_global_; }
     /// Relevant functions, local -> global
     const std::vector<int>& functions_local_to_global() const { return functions_local_to_global_; }
+    /// The extents object this block was populated with
+    std::shared_ptr<BasisExtents> extents() const { return extents_; }
+    /// Center of the bounding sphere of the points
+    const Vector3& xc() const { return xc_; }
+    /// Radius of the bounding sphere of the points
+    double R() const { return R_; }
 };
 
 class BasisExtents {
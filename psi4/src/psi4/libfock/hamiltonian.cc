@@ -1501,312 +1501,209 @@ void USTABHamiltonian::product(const std::vector<std::pair <std::shared_ptr<Vect
     C_left.clear();
     C_right.clear();
 
-    int nirrepa = (x.size() ? x[0].first->nirrep() : 0);
-    int nirrepb = (x.size() ? x[0].second->nirrep() : 0);
-
-//    Alpha orbitals are handled first
-
-    for (int symm = 0; symm < nirrepa; ++symm) {
-        for (size_t N = 0; N < x.size(); ++N) {
-            double* xp = x[N].first->pointer(symm);
-            long int offset = 0L;
-
-            // Is this a delta (low-rank) vector?
-            bool delta_vector = true;
-            int  delta_h = 0;
-            int  delta_i = 0;
-            int  delta_a = 0;
-            double delta_sum = 0.0;
-            for (int h = 0; h < Cocca_->nirrep(); ++h) {
-                int nocc = Cocca_->colspi()[h];
-                int nvir = Cvira_->colspi()[h^symm];
-                for (int i = 0; i < nocc; i++) {
-                    for (int a = 0; a < nvir; a++) {
-                        double x = xp[i * nvir + a + offset];
-                        if (x != 0.0 && x != 1.0) {
-                            delta_vector = false;
-                            break;
-                        }
-                        delta_sum += x;
-                        if (x == 1.0) {
-                            delta_i = i;
-                            delta_a = a;
-                            delta_h = h;
-                        }
-                    }
-                }
-                offset += nocc * nvir;
-            }
-            if (delta_sum != 1.0) {
-                delta_vector = false;
-            }
-
-            if (delta_vector) {
-
-                Dimension rank(Cocca_->nirrep());
-                rank[delta_h] = 1;
-
-                std::stringstream ss;
-                ss << "C_left alpha, h = " << symm << ", N = " << N;
-                SharedMatrix Cl(new Matrix(ss.str(), Cocca_->nirrep(), Cocca_->rowspi(), rank));
-
-                double** Clp = Cl->pointer(delta_h);
-                double** Cop = Cocca_->pointer(delta_h);
-                C_DCOPY(Cocca_->rowspi()[delta_h],&Cop[0][delta_i],Cocca_->colspi()[delta_h],Clp[0],1);
-
-                std::stringstream ss2;
-                ss2 << "C_right alpha, h = " << symm << ", N = " << N;
-                SharedMatrix Cr(new Matrix(ss2.str(), Cocca_->nirrep(), Cocca_->rowspi(), rank, symm));
-
-                double** Crp = Cr->pointer(delta_h^symm);
-                double** Cvp = Cvira_->pointer(delta_h^symm);
-                C_DCOPY(Cvira_->rowspi()[delta_h^symm],&Cvp[0][delta_a],Cvira_->colspi()[delta_h^symm],Crp[0],1);
-
-                C_left.push_back(Cl);
-                C_right.push_back(Cr);
-
-            } else {
-                std::stringstream ss;
-                ss << "C_right alpha, h = " << symm << ", N = " << N;
-                SharedMatrix Cr(new Matrix(ss.str(), Cocca_->nirrep(), Cocca_->rowspi(), Cocca_->colspi(), symm));
+    size_t nx = x.size();
+    int nirrep = (nx ? x[0].first->nirrep() : 0);
+    if (nx && x[0].second->nirrep() != nirrep) {
+        throw PSIEXCEPTION("USTABHamiltonian::product: Alpha and Beta should have same number of irreps.");
+    }
 
-                offset = 0L;
-                for (int h = 0; h < Cocca_->nirrep(); ++h) {
+    SharedMatrix Cocc[2] = {Cocca_, Coccb_};
+    SharedMatrix Cvir[2] = {Cvira_, Cvirb_};
+    std::shared_ptr<Vector> eps_occ[2] = {eps_occa_, eps_occb_};
+    std::shared_ptr<Vector> eps_vir[2] = {eps_vira_, eps_virb_};
+    const char* spin_label[2] = {"alpha", "beta"};
 
-                    int nocc = Cocca_->colspi()[h];
-                    int nvir = Cvira_->colspi()[h^symm];
-                    int nso  = Cvira_->rowspi()[h^symm];
+    // Position of the density of spin s, irrep symm, vector N in the JK lists at
+    // jk_index[s][symm * nx + N]. All-zero blocks (locked roots, the unused
+    // irreps of the guess vectors) get -1 and no density at all.
+    std::vector<int> jk_index[2];
 
-                    if (!nso || !nocc || !nvir) continue;
+    // Both spins of all trial vectors go through a single JK call
+    for (int s = 0; s < 2; ++s) {
+        jk_index[s].assign(nirrep * nx, -1);
+        const SharedMatrix& Co = Cocc[s];
+        const SharedMatrix& Cv = Cvir[s];
 
-                    double** Cvp = Cvira_->pointer(h^symm);
-                    double** Crp = Cr->pointer(h^symm);
-
-                    C_DGEMM('N','T',nso,nocc,nvir,1.0,Cvp[0],nvir,&xp[offset],nvir,0.0,Crp[0],nocc);
-
-                    offset += nocc * nvir;
+        for (int symm = 0; symm < nirrep; ++symm) {
+            for (size_t N = 0; N < nx; ++N) {
+                const std::shared_ptr<Vector>& xv = (s ? x[N].second : x[N].first);
+                double* xp = xv->pointer(symm);
+                int dim = xv->dimpi()[symm];
+
+                bool zero_vector = true;
+                for (int k = 0; k < dim; k++) {
+                    if (xp[k] != 0.0) {
+                        zero_vector = false;
+                        break;
+                    }
                 }
-
-                C_left.push_back(Cocca_);
-                C_right.push_back(Cr);
-            }
-        }
-    }
-
-//    Then beta orbitals get exactly the same treatment. Rewrite that in a smarter way.
-
-    for (int symm = 0; symm < nirrepb; ++symm) {
-        for (size_t N = 0; N < x.size(); ++N) {
-            double* xp = x[N].second->pointer(symm);
-            long int offset = 0L;
-
-            // Is this a delta (low-rank) vector?
-            bool delta_vector = true;
-            int  delta_h = 0;
-            int  delta_i = 0;
-            int  delta_a = 0;
-            double delta_sum = 0.0;
-            for (int h = 0; h < Coccb_->nirrep(); ++h) {
-                int nocc = Coccb_->colspi()[h];
-                int nvir = Cvirb_->colspi()[h^symm];
-                for (int i = 0; i < nocc; i++) {
-                    for (int a = 0; a < nvir; a++) {
-                        double x = xp[i * nvir + a + offset];
-                        if (x != 0.0 && x != 1.0) {
-                            delta_vector = false;
-                            break;
-                        }
-                        delta_sum += x;
-                        if (x == 1.0) {
-                            delta_i = i;
-                            delta_a = a;
-                            delta_h = h;
+                if (zero_vector) continue;
+
+                long int offset = 0L;
+
+                // Is this a delta (low-rank) vector?
+                bool delta_vector = true;
+                int  delta_h = 0;
+                int  delta_i = 0;
+                int  delta_a = 0;
+                double delta_sum = 0.0;
+                for (int h = 0; h < Co->nirrep(); ++h) {
+                    int nocc = Co->colspi()[h];
+                    int nvir = Cv->colspi()[h^symm];
+                    for (int i = 0; i < nocc; i++) {
+                        for (int a = 0; a < nvir; a++) {
+                            double x = xp[i * nvir + a + offset];
+                            if (x != 0.0 && x != 1.0) {
+                                delta_vector = false;
+                                break;
+                            }
+                            delta_sum += x;
+                            if (x == 1.0) {
+                                delta_i = i;
+                                delta_a = a;
+                                delta_h = h;
+                            }
                         }
                     }
+                    offset += nocc * nvir;
+                }
+                if (delta_sum != 1.0) {
+                    delta_vector = false;
                 }
-                offset += nocc * nvir;
-            }
-            if (delta_sum != 1.0) {
-                delta_vector = false;
-            }
 
-            if (delta_vector) {
+                if (delta_vector) {
 
-                Dimension rank(Coccb_->nirrep());
-                rank[delta_h] = 1;
+                    Dimension rank(Co->nirrep());
+                    rank[delta_h] = 1;
 
-                std::stringstream ss;
-                ss << "C_left beta, h = " << symm << ", N = " << N;
-                SharedMatrix Cl(new Matrix(ss.str(), Coccb_->nirrep(), Coccb_->rowspi(), rank));
+                    std::stringstream ss;
+                    ss << "C_left " << spin_label[s] << ", h = " << symm << ", N = " << N;
+                    SharedMatrix Cl(new Matrix(ss.str(), Co->nirrep(), Co->rowspi(), rank));
 
-                double** Clp = Cl->pointer(delta_h);
-                double** Cop = Coccb_->pointer(delta_h);
-                C_DCOPY(Coccb_->rowspi()[delta_h],&Cop[0][delta_i],Coccb_->colspi()[delta_h],Clp[0],1);
+                    double** Clp = Cl->pointer(delta_h);
+                    double** Cop = Co->pointer(delta_h);
+                    C_DCOPY(Co->rowspi()[delta_h],&Cop[0][delta_i],Co->colspi()[delta_h],Clp[0],1);
 
-                std::stringstream ss2;
-                ss2 << "C_right beta, h = " << symm << ", N = " << N;
-                SharedMatrix Cr(new Matrix(ss2.str(), Coccb_->nirrep(), Coccb_->rowspi(), rank, symm));
+                    std::stringstream ss2;
+                    ss2 << "C_right " << spin_label[s] << ", h = " << symm << ", N = " << N;
+                    SharedMatrix Cr(new Matrix(ss2.str(), Co->nirrep(), Co->rowspi(), rank, symm));
 
-                double** Crp = Cr->pointer(delta_h^symm);
-                double** Cvp = Cvirb_->pointer(delta_h^symm);
-                C_DCOPY(Cvirb_->rowspi()[delta_h^symm],&Cvp[0][delta_a],Cvirb_->colspi()[delta_h^symm],Crp[0],1);
+                    double** Crp = Cr->pointer(delta_h^symm);
+                    double** Cvp = Cv->pointer(delta_h^symm);
+                    C_DCOPY(Cv->rowspi()[delta_h^symm],&Cvp[0][delta_a],Cv->colspi()[delta_h^symm],Crp[0],1);
 
-                C_left.push_back(Cl);
-                C_right.push_back(Cr);
+                    C_left.push_back(Cl);
+                    C_right.push_back(Cr);
 
-            } else {
-                std::stringstream ss;
-                ss << "C_right beta, h = " << symm << ", N = " << N;
-                SharedMatrix Cr(new Matrix(ss.str(), Coccb_->nirrep(), Coccb_->rowspi(), Coccb_->colspi(), symm));
+                } else {
+                    std::stringstream ss;
+                    ss << "C_right " << spin_label[s] << ", h = " << symm << ", N = " << N;
+                    SharedMatrix Cr(new Matrix(ss.str(), Co->nirrep(), Co->rowspi(), Co->colspi(), symm));
 
-                offset = 0L;
-                for (int h = 0; h < Coccb_->nirrep(); ++h) {
+                    offset = 0L;
+                    for (int h = 0; h < Co->nirrep(); ++h) {
 
-                    int nocc = Coccb_->colspi()[h];
-                    int nvir = Cvirb_->colspi()[h^symm];
-                    int nso  = Cvirb_->rowspi()[h^symm];
+                        int nocc = Co->colspi()[h];
+                        int nvir = Cv->colspi()[h^symm];
+                        int nso  = Cv->rowspi()[h^symm];
 
-                    if (!nso || !nocc || !nvir) continue;
+                        if (!nso || !nocc || !nvir) continue;
 
-                    double** Cvp = Cvirb_->pointer(h^symm);
-                    double** Crp = Cr->pointer(h^symm);
+                        double** Cvp = Cv->pointer(h^symm);
+                        double** Crp = Cr->pointer(h^symm);
 
-                    C_DGEMM('N','T',nso,nocc,nvir,1.0,Cvp[0],nvir,&xp[offset],nvir,0.0,Crp[0],nocc);
+                        C_DGEMM('N','T',nso,nocc,nvir,1.0,Cvp[0],nvir,&xp[offset],nvir,0.0,Crp[0],nocc);
 
-                    offset += nocc * nvir;
+                        offset += nocc * nvir;
+                    }
+
+                    C_left.push_back(Co);
+                    C_right.push_back(Cr);
                 }
 
-                C_left.push_back(Coccb_);
-                C_right.push_back(Cr);
+                jk_index[s][symm * nx + N] = C_left.size() - 1;
             }
         }
     }
 
-    jk_->compute();
+    if (C_left.size()) jk_->compute();
 
     const std::vector<SharedMatrix >& J = jk_->J();
     const std::vector<SharedMatrix >& K = jk_->K();
 
-//    Compute the alpha part of the b vector
+//    Compute the b vectors, spin by spin
 
-    double* Tp = new double[Cocca_->max_nrow() * Cocca_->max_ncol()];
+    for (int s = 0; s < 2; ++s) {
+        const SharedMatrix& Co = Cocc[s];
+        const SharedMatrix& Cv = Cvir[s];
 
-    for (int symm = 0; symm < nirrepa; ++symm) {
-        for (size_t N = 0; N < x.size(); ++N) {
+        double* Tp = new double[Co->max_nrow() * Co->max_ncol()];
 
-            double* bp = b[N].first->pointer(symm);
-            double* xp = x[N].first->pointer(symm);
-            long int offset = 0L;
+        for (int symm = 0; symm < nirrep; ++symm) {
+            for (size_t N = 0; N < nx; ++N) {
 
-            for (int h = 0; h < Cocca_->nirrep(); ++h) {
+                const std::shared_ptr<Vector>& bv = (s ? b[N].second : b[N].first);
+                double* bp = bv->pointer(symm);
+                double* xp = (s ? x[N].second : x[N].first)->pointer(symm);
+                if (bv->dimpi()[symm]) ::memset((void*) bp, '\0', sizeof(double) * bv->dimpi()[symm]);
 
-                int nsoocc = Cocca_->rowspi()[h];
-                int nocc = Cocca_->colspi()[h];
-                int nsovir = Cvira_->rowspi()[h^symm];
-                int nvir = Cvira_->colspi()[h^symm];
+                // Exchange of this spin, Coulomb of both
+                int Kidx = jk_index[s][symm * nx + N];
+                int Jaidx = jk_index[0][symm * nx + N];
+                int Jbidx = jk_index[1][symm * nx + N];
 
-                if (!nsoocc || !nsovir || !nocc || !nvir) continue;
+                long int offset = 0L;
 
-                double** Cop = Cocca_->pointer(h);
-                double** Cvp = Cvira_->pointer(h^symm);
-                double*  eop  = eps_occa_->pointer(h);
-                double*  evp  = eps_vira_->pointer(h^symm);
+                for (int h = 0; h < Co->nirrep(); ++h) {
 
-                double** Jap  = J[symm * x.size() + N]->pointer(h);
-                double** Jbp  = J[(nirrepa + symm) * x.size() + N]->pointer(h);
-                double** Kp  = K[symm * x.size() + N]->pointer(h);
-                double** KTp  = K[symm * x.size() + N]->pointer(h^symm);
-                // We need to use h^symm representation of h because we want the
-                // columns to be in h^symm so that the transpose has lines in h^symm
+                    int nsoocc = Co->rowspi()[h];
+                    int nocc = Co->colspi()[h];
+                    int nsovir = Cv->rowspi()[h^symm];
+                    int nvir = Cv->colspi()[h^symm];
 
-                // -(ij|ab)P_jb = C_im K_mn C_na
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Kp[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,0.0,&bp[offset],nvir);
+                    if (!nsoocc || !nsovir || !nocc || !nvir) continue;
 
-                // -(ib|ja) P_jb = C_im (K^{T})_mn C_na
-                C_DGEMM('T','T',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,KTp[0],nsoocc,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                    double** Cop = Co->pointer(h);
+                    double** Cvp = Cv->pointer(h^symm);
+                    double*  eop  = eps_occ[s]->pointer(h);
+                    double*  evp  = eps_vir[s]->pointer(h^symm);
 
-                // 2(ia|jb)P_jb = C_im J_mn C_na for J alpha
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jap[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,2.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                    if (Kidx >= 0) {
+                        double** Kp  = K[Kidx]->pointer(h);
+                        double** KTp  = K[Kidx]->pointer(h^symm);
+                        // We need to use h^symm representation of h because we want the
+                        // columns to be in h^symm so that the transpose has lines in h^symm
 
-                // 2(ia|jb)P_jb = C_im J_mn C_na for J beta
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jbp[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,2.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                        // -(ij|ab)P_jb = C_im K_mn C_na
+                        C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Kp[0],nsovir,0.0,Tp,nsovir);
+                        C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
 
-                for (int i = 0; i < nocc; ++i) {
-                    for (int a = 0; a < nvir; ++a) {
-                        bp[i * nvir + a + offset] += (evp[a] - eop[i]) * xp[i * nvir + a + offset];
+                        // -(ib|ja) P_jb = C_im (K^{T})_mn C_na
+                        C_DGEMM('T','T',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,KTp[0],nsoocc,0.0,Tp,nsovir);
+                        C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
                     }
-                }
-
-                offset += nocc * nvir;
-            }
-        }
-    }
-
-
-    delete[] Tp;
-
-//    Compute the beta part of the b vector
-
-    Tp = new double[Coccb_->max_nrow() * Coccb_->max_ncol()];
-
-    for (int symm = 0; symm < nirrepb; ++symm) {
-        for (size_t N = 0; N < x.size(); ++N) {
-
-            double* bp = b[N].second->pointer(symm);
-            double* xp = x[N].second->pointer(symm);
-            long int offset = 0L;
-
-            for (int h = 0; h < Coccb_->nirrep(); ++h) {
-
-                int nsoocc = Coccb_->rowspi()[h];
-                int nocc = Coccb_->colspi()[h];
-                int nsovir = Cvirb_->rowspi()[h^symm];
-                int nvir = Cvirb_->colspi()[h^symm];
-
-                if (!nsoocc || !nsovir || !nocc || !nvir) continue;
 
-                double** Cop = Coccb_->pointer(h);
-                double** Cvp = Cvirb_->pointer(h^symm);
-                double*  eop  = eps_occb_->pointer(h);
-                double*  evp  = eps_virb_->pointer(h^symm);
-
-                double** Jap  = J[symm * x.size() + N]->pointer(h);
-                double** Jbp  = J[(nirrepa + symm) * x.size() + N]->pointer(h);
-                double** Kp  = K[(nirrepa + symm) * x.size() + N]->pointer(h);
-                double** KTp  = K[(nirrepa + symm) * x.size() + N]->pointer(h^symm);
-
-                // -(ij|ab)P_jb = C_im K_mn C_na
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Kp[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,0.0,&bp[offset],nvir);
-
-                // -(ib|ja) P_jb = C_im (K^{T})_mn C_na
-                C_DGEMM('T','T',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,KTp[0],nsoocc,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
-
-                // 2(ia|jb)P_jb = C_im J_mn C_na for J alpha
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jap[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,2.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
-
-                // 2(ia|jb)P_jb = C_im J_mn C_na for J beta
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jbp[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,2.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                    // 2(ia|jb)P_jb = C_im J_mn C_na for J alpha, then J beta
+                    for (int Jidx : {Jaidx, Jbidx}) {
+                        if (Jidx < 0) continue;
+                        double** Jp = J[Jidx]->pointer(h);
+                        C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jp[0],nsovir,0.0,Tp,nsovir);
+                        C_DGEMM('N','N',nocc,nvir,nsovir,2.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                    }
 
-                for (int i = 0; i < nocc; ++i) {
-                    for (int a = 0; a < nvir; ++a) {
-                        bp[i * nvir + a + offset] += (evp[a] - eop[i]) * xp[i * nvir + a + offset];
+                    for (int i = 0; i < nocc; ++i) {
+                        for (int a = 0; a < nvir; ++a) {
+                            bp[i * nvir + a + offset] += (evp[a] - eop[i]) * xp[i * nvir + a + offset];
+                        }
                     }
-                }
 
-                offset += nocc * nvir;
+                    offset += nocc * nvir;
+                }
             }
         }
-    }
 
-    delete[] Tp;
+        delete[] Tp;
+    }
 
     if (debug_ > 3) {
         for (size_t N = 0; N < x.size(); N++) {
@@ -44,7 +44,14 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
-
+#include "psi4/libpsi4util/libpsi4util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <vector>
 #ifdef _OPENMP
@@ -63,10 +70,69 @@ JK::JK( std::shared_ptr<BasisSet> primary) :
 JK::~JK()
 {
 }
+
+namespace {
+
+std::mutex& backend_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+std::map<std::string, std::shared_ptr<const JKBackend> >& backend_registry() {
+    static std::map<std::string, std::shared_ptr<const JKBackend> > registry;
+    return registry;
+}
+
+}  // namespace
+
+void JK::register_backend(const std::string& name, const JKBackend& backend) {
+    std::string key = to_upper_copy(name);
+    const char* builtin[] = {"AUTO", "CD", "DF", "PK", "OUT_OF_CORE", "GTFOCK", "DIRECT", "CFMM", "COSX"};
+    for (const char* type : builtin) {
+        if (key == type) throw PSIEXCEPTION("JK::register_backend: " + key + " is a built-in JK type.");
+    }
+    if (key.empty() || !backend.build) throw PSIEXCEPTION("JK::register_backend: A backend needs a name and a build function.");
+
+    std::lock_guard<std::mutex> lock(backend_mutex());
+    backend_registry()[key] = std::make_shared<const JKBackend>(backend);
+}
+std::vector<std::string> JK::registered_backends() {
+    std::lock_guard<std::mutex> lock(backend_mutex());
+    std::vector<std::string> names;
+    for (const auto& kv : backend_registry()) names.push_back(kv.first);
+    return names;
+}
+std::shared_ptr<const JKBackend> JK::get_backend(const std::string& name) {
+    std::lock_guard<std::mutex> lock(backend_mutex());
+    auto it = backend_registry().find(to_upper_copy(name));
+    return (it == backend_registry().end() ? nullptr : it->second);
+}
+
 std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
                                  std::shared_ptr<BasisSet> auxiliary, Options& options,
                                  std::string jk_type) {
-    if (jk_type == "CD") {
+    std::shared_ptr<const JKBackend> backend = get_backend(jk_type);
+    if (backend) {
+        if (backend->auxiliary && (!auxiliary || auxiliary->nbf() == 0)) {
+            throw PSIEXCEPTION("JK::build_JK: JK backend " + jk_type + " needs an auxiliary basis; set DF_BASIS_SCF and SCF_TYPE DF.");
+        }
+        std::shared_ptr<JK> jk = backend->build(primary, auxiliary, options);
+        if (!jk) throw PSIEXCEPTION("JK::build_JK: JK backend " + jk_type + " built no JK object.");
+        jk->backend_ = backend;
+
+        if (options["INTS_TOLERANCE"].has_changed())
+            jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed())
+            jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed())
+            jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed())
+            jk->set_bench(options.get_int("BENCH"));
+
+        return jk;
+
+    } else if (jk_type == "AUTO") {
+        return build_JK(primary, auxiliary, options, select_type(primary, auxiliary, options));
+    } else if (jk_type == "CD") {
 
         CDJK* jk = new CDJK(primary,options.get_double("CHOLESKY_TOLERANCE"));
 
@@ -89,7 +155,13 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
 
     } else if (jk_type == "DF") {
 
-        DFJK* jk = new DFJK(primary,auxiliary);
+        DFJK* jk;
+        if (options["DF_SCF_DISTRIBUTED"].has_changed() && options.get_bool("DF_SCF_DISTRIBUTED"))
+            jk = new DistDFJK(primary,auxiliary);
+        else if (options["DF_SCF_SYMMETRY"].has_changed() && options.get_bool("DF_SCF_SYMMETRY"))
+            jk = new SymmDFJK(primary,auxiliary);
+        else
+            jk = new DFJK(primary,auxiliary);
 
         if (options["INTS_TOLERANCE"].has_changed())
             jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
@@ -105,6 +177,14 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
             jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["DISK_COMPRESSION_TOLERANCE"].has_changed())
+            jk->set_disk_compression_tolerance(options.get_double("DISK_COMPRESSION_TOLERANCE"));
+        if (options["DF_LOCAL_K"].has_changed())
+            jk->set_local_K(options.get_bool("DF_LOCAL_K"));
+        if (options["DF_LOCAL_K_TOLERANCE"].has_changed())
+            jk->set_local_K_tolerance(options.get_double("DF_LOCAL_K_TOLERANCE"));
+        if (options["DF_LOCAL_K_LOCALIZER"].has_changed())
+            jk->set_local_K_localizer(options.get_str("DF_LOCAL_K_LOCALIZER"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -136,6 +216,24 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
 
         return std::shared_ptr<JK>(jk);
 
+    } else if (jk_type == "GTFOCK" ||
+               (jk_type == "DIRECT" && options.exists("GTFOCK_AUTO_NBF") && options.get_int("GTFOCK_AUTO_NBF") > 0 &&
+                primary->nbf() >= options.get_int("GTFOCK_AUTO_NBF") && gtfock_available())) {
+        // GTFock picks up the molecule through the legacy slot
+        std::shared_ptr<Molecule> other_legacy = Process::environment.legacy_molecule();
+        Process::environment.set_legacy_molecule(primary->molecule());
+        GTFockJK* jk = new GTFockJK(primary);
+        Process::environment.set_legacy_molecule(other_legacy);
+
+        if (options["INTS_TOLERANCE"].has_changed())
+            jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed())
+            jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed())
+            jk->set_debug(options.get_int("DEBUG"));
+
+        return std::shared_ptr<JK>(jk);
+
     } else if (jk_type == "DIRECT") {
         DirectJK* jk = new DirectJK(primary);
 
@@ -149,6 +247,68 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
             jk->set_bench(options.get_int("BENCH"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["SCREENING"].has_changed())
+            jk->set_density_screening(options.get_str("SCREENING") == "DENSITY");
+        if (options["INCFOCK"].has_changed())
+            jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+
+        return std::shared_ptr<JK>(jk);
+
+    } else if (jk_type == "CFMM") {
+        CFMMJK* jk = new CFMMJK(primary);
+
+        if (options["INTS_TOLERANCE"].has_changed())
+            jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed())
+            jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed())
+            jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed())
+            jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_INTS_NUM_THREADS"].has_changed())
+            jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["SCREENING"].has_changed())
+            jk->set_density_screening(options.get_str("SCREENING") == "DENSITY");
+        if (options["INCFOCK"].has_changed())
+            jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+        if (options["CFMM_ORDER"].has_changed())
+            jk->set_cfmm_order(options.get_int("CFMM_ORDER"));
+        if (options["CFMM_THETA"].has_changed())
+            jk->set_cfmm_theta(options.get_double("CFMM_THETA"));
+        if (options["CFMM_LEAF_SIZE"].has_changed())
+            jk->set_cfmm_leaf_size(options.get_int("CFMM_LEAF_SIZE"));
+
+        return std::shared_ptr<JK>(jk);
+
+    } else if (jk_type == "COSX") {
+        COSXJK* jk = new COSXJK(primary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed())
+            jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed())
+            jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed())
+            jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed())
+            jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_INTS_NUM_THREADS"].has_changed())
+            jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["SCREENING"].has_changed())
+            jk->set_density_screening(options.get_str("SCREENING") == "DENSITY");
+        if (options["INCFOCK"].has_changed())
+            jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+        if (options["COSX_RADIAL_POINTS"].has_changed())
+            jk->set_cosx_radial_points(options.get_int("COSX_RADIAL_POINTS"));
+        if (options["COSX_SPHERICAL_POINTS"].has_changed())
+            jk->set_cosx_spherical_points(options.get_int("COSX_SPHERICAL_POINTS"));
+        if (options["COSX_OVERLAP_FITTING"].has_changed())
+            jk->set_overlap_fitting(options.get_bool("COSX_OVERLAP_FITTING"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -158,6 +318,13 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
 }
 std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary,
                                  std::shared_ptr<BasisSet> auxiliary, Options& options) {
+    if (options.exists("JK_BACKEND") && !options.get_str("JK_BACKEND").empty()) {
+        std::string backend = options.get_str("JK_BACKEND");
+        if (!get_backend(backend)) {
+            throw PSIEXCEPTION("JK::build_JK: JK_BACKEND " + backend + " is not registered; load its plugin first.");
+        }
+        return build_JK(primary, auxiliary, options, backend);
+    }
     return build_JK(primary, auxiliary, options, options.get_str("SCF_TYPE"));
 }
 SharedVector JK::iaia(SharedMatrix /*Ci*/, SharedMatrix /*Ca*/) {
@@ -181,11 +348,32 @@ void JK::common_init() {
     do_wK_ = false;
     lr_symmetric_ = false;
     omega_ = 0.0;
+    mixed_precision_ = false;
+    mixed_precision_switch_ = 1.0E-4;
 
     std::shared_ptr<IntegralFactory> integral(
         new IntegralFactory(primary_, primary_, primary_, primary_));
     std::shared_ptr<PetiteList> pet(new PetiteList(primary_, integral));
     AO2USO_ = SharedMatrix(pet->aotoso());
+
+    // An SO combines at most the group order of AOs, so USO2AO/AO2USO only visit those
+    int nao = AO2USO_->rowspi()[0];
+    AO2USO_start_.assign(AO2USO_->nirrep(), std::vector<size_t>(1, 0L));
+    AO2USO_ao_.assign(AO2USO_->nirrep(), std::vector<int>());
+    AO2USO_coef_.assign(AO2USO_->nirrep(), std::vector<double>());
+    for (int h = 0; h < AO2USO_->nirrep(); h++) {
+        int nso = AO2USO_->colspi()[h];
+        if (!nso) continue;
+        double** Up = AO2USO_->pointer(h);
+        for (int i = 0; i < nso; i++) {
+            for (int m = 0; m < nao; m++) {
+                if (Up[m][i] == 0.0) continue;
+                AO2USO_ao_[h].push_back(m);
+                AO2USO_coef_[h].push_back(Up[m][i]);
+            }
+            AO2USO_start_[h].push_back(AO2USO_ao_[h].size());
+        }
+    }
 }
 size_t JK::memory_overhead() const {
     size_t mem = 0L;
@@ -393,12 +581,30 @@ void JK::USO2AO()
             int nsol = AO2USO_->colspi()[h];
             int nsor = AO2USO_->colspi()[h^symm];
             if (!nsol || !nsor) continue;
-            double** Ulp = AO2USO_->pointer(h);
-            double** Urp = AO2USO_->pointer(h^symm);
+            const size_t* startl = AO2USO_start_[h].data();
+            const size_t* startr = AO2USO_start_[h^symm].data();
+            const int* aol = AO2USO_ao_[h].data();
+            const int* aor = AO2USO_ao_[h^symm].data();
+            const double* Ul = AO2USO_coef_[h].data();
+            const double* Ur = AO2USO_coef_[h^symm].data();
             double** DSOp = D_[N]->pointer(h^symm);
             double** DAOp = D_ao_[N]->pointer();
-            C_DGEMM('N','T',nsol,nao,nsor,1.0,DSOp[0],nsor,Urp[0],nsor,0.0,temp,nao);
-            C_DGEMM('N','N',nao,nao,nsol,1.0,Ulp[0],nsol,temp,nao,1.0,DAOp[0],nao);
+
+            // temp = D U_r^T, then D_ao += U_l temp, both over the nonzeros of U
+            ::memset((void*) temp, '\0', sizeof(double) * nsol * nao);
+            for (int i = 0; i < nsol; i++) {
+                double* tp = &temp[i * (size_t) nao];
+                for (int j = 0; j < nsor; j++) {
+                    double d = DSOp[i][j];
+                    if (d == 0.0) continue;
+                    for (size_t k = startr[j]; k < startr[j + 1]; k++) tp[aor[k]] += Ur[k] * d;
+                }
+            }
+            for (int i = 0; i < nsol; i++) {
+                for (size_t k = startl[i]; k < startl[i + 1]; k++) {
+                    C_DAXPY(nao, Ul[k], &temp[i * (size_t) nao], 1, DAOp[aol[k]], 1);
+                }
+            }
         }
     }
     delete[] temp;
@@ -415,15 +621,17 @@ void JK::USO2AO()
 
         int offset = 0;
         for (int h = 0; h < AO2USO_->nirrep(); ++h) {
-            int nao = AO2USO_->rowspi()[0];
             int nso = AO2USO_->colspi()[h];
-            int ncol = C_left_ao_[N]->colspi()[0];
             int ncolspi = C_left_[N]->colspi()[h];
             if (nso == 0 || ncolspi == 0) continue;
-            double** Up = AO2USO_->pointer(h);
             double** CAOp = C_left_ao_[N]->pointer();
             double** CSOp = C_left_[N]->pointer(h);
-            C_DGEMM('N','N',nao,ncolspi,nso,1.0,Up[0],nso,CSOp[0],ncolspi,0.0,&CAOp[0][offset],ncol);
+            // C_ao rows are freshly zeroed; each SO row lands on its few AOs
+            for (int i = 0; i < nso; i++) {
+                for (size_t k = AO2USO_start_[h][i]; k < AO2USO_start_[h][i + 1]; k++) {
+                    C_DAXPY(ncolspi, AO2USO_coef_[h][k], CSOp[i], 1, &CAOp[AO2USO_ao_[h][k]][offset], 1);
+                }
+            }
             offset += ncolspi;
         }
     }
@@ -440,15 +648,16 @@ void JK::USO2AO()
         int offset = 0;
         int symm = D_[N]->symmetry();
         for (int h = 0; h < AO2USO_->nirrep(); ++h) {
-            int nao = AO2USO_->rowspi()[0];
             int nso = AO2USO_->colspi()[h];
-            int ncol = C_right_ao_[N]->colspi()[0];
             int ncolspi = C_right_[N]->colspi()[h^symm];
             if (nso == 0 || ncolspi == 0) continue;
-            double** Up = AO2USO_->pointer(h);
             double** CAOp = C_right_ao_[N]->pointer();
             double** CSOp = C_right_[N]->pointer(h);
-            C_DGEMM('N','N',nao,ncolspi,nso,1.0,Up[0],nso,CSOp[0],ncolspi,0.0,&CAOp[0][offset],ncol);
+            for (int i = 0; i < nso; i++) {
+                for (size_t k = AO2USO_start_[h][i]; k < AO2USO_start_[h][i + 1]; k++) {
+                    C_DAXPY(ncolspi, AO2USO_coef_[h][k], CSOp[i], 1, &CAOp[AO2USO_ao_[h][k]][offset], 1);
+                }
+            }
             offset += ncolspi;
         }
     }
@@ -494,34 +703,54 @@ void JK::AO2USO()
 
             if (!nsol || !nsor) continue;
 
-            double** Ulp = AO2USO_->pointer(h);
-            double** Urp = AO2USO_->pointer(h^symm);
-
-            if (do_J_) {
-                double** JAOp = J_ao_[N]->pointer();
-                double** JSOp = J_[N]->pointer(h);
-                C_DGEMM('N','N',nao,nsor,nao,1.0,JAOp[0],nao,Urp[0],nsor,0.0,temp,nsor);
-                C_DGEMM('T','N',nsol,nsor,nao,1.0,Ulp[0],nsol,temp,nsor,0.0,JSOp[0],nsor);
-            }
-            if (do_K_) {
-                double** KAOp = K_ao_[N]->pointer();
-                double** KSOp = K_[N]->pointer(h);
-                C_DGEMM('N','N',nao,nsor,nao,1.0,KAOp[0],nao,Urp[0],nsor,0.0,temp,nsor);
-                C_DGEMM('T','N',nsol,nsor,nao,1.0,Ulp[0],nsol,temp,nsor,0.0,KSOp[0],nsor);
-            }
-            if (do_wK_) {
-                double** wKAOp = wK_ao_[N]->pointer();
-                double** wKSOp = wK_[N]->pointer(h);
-                C_DGEMM('N','N',nao,nsor,nao,1.0,wKAOp[0],nao,Urp[0],nsor,0.0,temp,nsor);
-                C_DGEMM('T','N',nsol,nsor,nao,1.0,Ulp[0],nsol,temp,nsor,0.0,wKSOp[0],nsor);
-            }
+            const size_t* startl = AO2USO_start_[h].data();
+            const size_t* startr = AO2USO_start_[h^symm].data();
+            const int* aol = AO2USO_ao_[h].data();
+            const int* aor = AO2USO_ao_[h^symm].data();
+            const double* Ul = AO2USO_coef_[h].data();
+            const double* Ur = AO2USO_coef_[h^symm].data();
+
+            // SO = U_l^T AO U_r, as temp = U_l^T AO then gathers of temp over the nonzeros of U_r
+            auto transform = [&](SharedMatrix AO, SharedMatrix SO) {
+                double** AOp = AO->pointer();
+                double** SOp = SO->pointer(h);
+                ::memset((void*) temp, '\0', sizeof(double) * nsol * nao);
+                for (int i = 0; i < nsol; i++) {
+                    for (size_t k = startl[i]; k < startl[i + 1]; k++) {
+                        C_DAXPY(nao, Ul[k], AOp[aol[k]], 1, &temp[i * (size_t) nao], 1);
+                    }
+                }
+                for (int i = 0; i < nsol; i++) {
+                    const double* tp = &temp[i * (size_t) nao];
+                    for (int j = 0; j < nsor; j++) {
+                        double val = 0.0;
+                        for (size_t k = startr[j]; k < startr[j + 1]; k++) val += Ur[k] * tp[aor[k]];
+                        SOp[i][j] = val;
+                    }
+                }
+            };
+
+            if (do_J_) transform(J_ao_[N], J_[N]);
+            if (do_K_) transform(K_ao_[N], K_[N]);
+            if (do_wK_) transform(wK_ao_[N], wK_[N]);
         }
     }
     delete[] temp;
 }
-void JK::initialize() { preiterations(); }
+void JK::initialize() {
+    metrics_.clear();
+    preiterations();
+}
 void JK::compute() {
 
+    // External engines only get the tasks they signed up for
+    if (backend_) {
+        if (do_wK_ && !backend_->wK)
+            throw PSIEXCEPTION("JK: This JK backend cannot form wK.");
+        if (C_left_.size() > 1 && !backend_->multiple_densities)
+            throw PSIEXCEPTION("JK: This JK backend takes one density per compute().");
+    }
+
     // Is this density symmetric?
     if (C_left_.size() && !C_right_.size()) {
         lr_symmetric_ = true;
@@ -576,10 +805,26 @@ void JK::compute() {
         allocate_JK();
     }
 
+    metrics_.push_back(JKMetrics());
+    current_metrics().iteration = metrics_.size() - 1;
+    size_t psio_start = PSIO::shared_object()->bytes_read();
+    double start = wall_time();
+
     timer_on("JK: JK");
     compute_JK();
     timer_off("JK: JK");
 
+    current_metrics().total_time = wall_time() - start;
+    current_metrics().psio_bytes += PSIO::shared_object()->bytes_read() - psio_start;
+
+    if (bench_) {
+        const JKMetrics& m = current_metrics();
+        outfile->Printf("  %s metrics, call %zu: %zu quartets computed, %zu screened, %.3f s ints, "
+                        "%.3f s contraction, %.3f s total, %zu PSIO bytes, %.3f GFLOP/s\n",
+                        name().c_str(), m.iteration, m.shells_computed, m.shells_screened, m.integral_time,
+                        m.contraction_time, m.total_time, m.psio_bytes, m.gflops());
+    }
+
     if (C1()) {
         timer_on("JK: AO2USO");
         AO2USO();
@@ -612,5 +857,27 @@ void JK::finalize()
 {
     postiterations();
 }
+double JK::wall_time()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+std::string JK::metrics_json() const
+{
+    std::stringstream json;
+    char buf[512];
+    json << "{\"algorithm\": \"" << name() << "\", \"iterations\": [";
+    for (size_t i = 0; i < metrics_.size(); i++) {
+        const JKMetrics& m = metrics_[i];
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"iteration\": %zu, \"shells_computed\": %zu, \"shells_screened\": %zu, "
+                      "\"integrals\": %zu, \"integral_time\": %.6e, \"contraction_time\": %.6e, "
+                      "\"total_time\": %.6e, \"psio_bytes\": %zu, \"flops\": %.6e, \"gflops\": %.6e}",
+                      (i ? ", " : ""), m.iteration, m.shells_computed, m.shells_screened, m.integrals,
+                      m.integral_time, m.contraction_time, m.total_time, m.psio_bytes, m.flops, m.gflops());
+        json << buf;
+    }
+    json << "]}";
+    return json.str();
+}
 
 }
@@ -29,6 +29,8 @@
 #ifndef JK_H
 #define JK_H
 
+#include <functional>
+#include <string>
 #include <vector>
  #include "psi4/pragma.h"
  PRAGMA_WARNING_PUSH
@@ -44,13 +46,85 @@ class BasisSet;
 class Matrix;
 class ERISieve;
 class TwoBodyAOInt;
+class OneBodyAOInt;
+class ChargeMultipoleTree;
+class DFTGrid;
 class Options;
 class PSIO;
+class JK;
 
 namespace pk {
 class PKManager;
 }
 
+// => EXTERNAL BACKENDS <= //
+
+/**
+ * Struct JKBackend
+ *
+ * A JK engine from outside libfock (a plugin's GPU or vendor-library
+ * JK), registered by name with JK::register_backend, usually when the
+ * plugin is loaded. JK::build_JK builds it when asked for that name as
+ * jk_type, and for every build from options when JK_BACKEND names it,
+ * so SCF, CPHF, SAPT and FISAPT pick it up without changes. The flags
+ * are checked against each compute().
+ */
+struct JKBackend {
+    /// Returns a JK ready for initialize(). It may hand the same engine to several callers.
+    std::function<std::shared_ptr<JK>(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
+                                      Options& options)> build;
+    /// Can form wK (range-separated exchange)
+    bool wK;
+    /// Takes more than one C pair in one compute()
+    bool multiple_densities;
+    /// Needs an auxiliary basis from the caller
+    bool auxiliary;
+    /// Lives within the memory given to set_memory(); false if it manages its own (device) memory
+    bool host_memory;
+
+    JKBackend() : wK(false), multiple_densities(true), auxiliary(false), host_memory(true) {}
+};
+
+// => PERFORMANCE RECORD <= //
+
+/**
+ * Struct JKMetrics
+ *
+ * What one call of JK::compute() did. The base class opens a
+ * record before compute_JK() and fills in total_time and
+ * psio_bytes; the algorithm fills in the rest. Times of
+ * threaded loops are summed over threads; reads interleaved
+ * with the contraction (DiskJK) count as contraction time.
+ * Flop counts are model counts of the contraction arithmetic,
+ * not hardware counters.
+ */
+struct JKMetrics {
+    /// Zero-based index of the compute() call
+    size_t iteration;
+    /// Shell quartets evaluated (integral-direct algorithms only)
+    size_t shells_computed;
+    /// Unique shell quartets skipped by Schwarz or density screening
+    size_t shells_screened;
+    /// Integral values contracted with the densities
+    size_t integrals;
+    /// Seconds spent computing integrals
+    double integral_time;
+    /// Seconds spent contracting integrals with densities
+    double contraction_time;
+    /// Wall seconds of compute_JK()
+    double total_time;
+    /// Bytes read through PSIO during compute_JK()
+    size_t psio_bytes;
+    /// Floating point operations of the contraction
+    double flops;
+
+    JKMetrics() : iteration(0), shells_computed(0), shells_screened(0), integrals(0),
+                  integral_time(0.0), contraction_time(0.0), total_time(0.0),
+                  psio_bytes(0), flops(0.0) {}
+    /// Achieved contraction rate, GFLOP per wall second of compute_JK()
+    double gflops() const { return (total_time > 0.0 ? 1.0E-9 * flops / total_time : 0.0); }
+};
+
 // => BASE CLASS <= //
 
 /**
@@ -243,6 +317,10 @@ protected:
     double cutoff_;
     /// Whether to all desymmetrization, for cases when it's already been performed elsewhere
     std::vector<bool> input_symmetry_cast_map_;
+    /// One record per compute() call since initialize() or clear_metrics()
+    std::vector<JKMetrics> metrics_;
+    /// Registered backend this object was built as, NULL for the built-in algorithms
+    std::shared_ptr<const JKBackend> backend_;
 
     // => Tasks <= //
 
@@ -259,6 +337,11 @@ protected:
     /// Left-right symmetric? Determined in each call of compute()
     bool lr_symmetric_;
 
+    /// May early builds run in reduced precision? Defaults to false
+    bool mixed_precision_;
+    /// RMS AO density change between builds below which full precision resumes
+    double mixed_precision_switch_;
+
     // => Architecture-Level State Variables (Spatial Symmetry) <= //
 
     /// Pseudo-occupied C matrices, left side
@@ -280,6 +363,11 @@ protected:
     std::shared_ptr<BasisSet> primary_;
     /// AO2USO transformation matrix
     SharedMatrix AO2USO_;
+    /// Nonzeros of AO2USO_ by SO: SO i of irrep h is the sum over k in
+    /// [AO2USO_start_[h][i], AO2USO_start_[h][i+1]) of AO2USO_coef_[h][k] AO AO2USO_ao_[h][k]
+    std::vector<std::vector<size_t> > AO2USO_start_;
+    std::vector<std::vector<int> > AO2USO_ao_;
+    std::vector<std::vector<double> > AO2USO_coef_;
     /// Pseudo-occupied C matrices, left side
     std::vector<SharedMatrix> C_left_ao_;
     /// Pseudo-occupied C matrices, right side
@@ -329,6 +417,10 @@ protected:
 
     /// Memory (doubles) used to hold J/K/wK/C/D and ao versions, at current moment
     size_t memory_overhead() const;
+    /// Record of the compute() call in progress, for compute_JK() to fill in
+    JKMetrics& current_metrics() { return metrics_.back(); }
+    /// Monotonic wall clock, in seconds
+    static double wall_time();
 
 public:
     // => Constructors <= //
@@ -354,15 +446,39 @@ public:
 
     /**
     * Static instance constructor, used to get prebuilt DFJK/DirectJK objects
-    * using knobs in options.
-    * Nmat and sym are options for GTFock
-    * sym means that all density matrices will be symmetric
+    * using knobs in options. GTFockJK is sized from the first densities
+    * it is given; DIRECT switches to it from GTFOCK_AUTO_NBF functions on.
     * @return abstract JK object, tuned in with preset options
     */
     static std::shared_ptr<JK> build_JK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
                                           Options& options);
     static std::shared_ptr<JK> build_JK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
                                           Options& options, std::string jk_type);
+    /**
+    * SCF_TYPE AUTO: the cheapest of DIRECT, PK, OUT_OF_CORE and (with an
+    * auxiliary basis, unless JK_AUTO_EXACT) DF for JK_AUTO_ITERATIONS builds.
+    * The model counts the Schwarz-significant integrals and times a sample of
+    * them, a DGEMM and, if some variant would spill, the scratch disk.
+    * @return the chosen SCF_TYPE
+    */
+    static std::string select_type(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
+                                   Options& options);
+    /// Was PSI4 built with GTFock, so that SCF_TYPE GTFOCK can run?
+    static bool gtfock_available();
+
+    /**
+    * Makes an external JK engine available as jk_type name (upper-cased),
+    * replacing any backend registered under it before. The built-in types
+    * cannot be overridden.
+    */
+    static void register_backend(const std::string& name, const JKBackend& backend);
+    /// Names of the registered backends
+    static std::vector<std::string> registered_backends();
+    /// The registered backend called name, NULL if there is none
+    static std::shared_ptr<const JKBackend> get_backend(const std::string& name);
+
+    /// The backend this object was built as, NULL for the built-in algorithms
+    std::shared_ptr<const JKBackend> backend() const { return backend_; }
 
 
     /// Do we need to backtransform to C1 under the hood?
@@ -424,6 +540,21 @@ public:
     * @param omega range-separation parameter
     */
     void set_omega(double omega) { omega_ = omega; }
+    /**
+    * Allow reduced precision for the early builds of an SCF, until
+    * the density settles. Only the SCF driver turns this on, other
+    * consumers always get full precision. DFJK holds (Q|mn) in
+    * single precision, unless wK, local K or DF_INTS_IO other
+    * than NONE are used; other algorithms ignore it.
+    * @param val use mixed precision?
+    */
+    void set_mixed_precision(bool val) { mixed_precision_ = val; }
+    /**
+    * RMS change of the AO densities between two builds below
+    * which full precision resumes
+    * @param val a small positive number, defaults to 1.0E-4
+    */
+    void set_mixed_precision_switch(double val) { mixed_precision_switch_ = val; }
 
     // => Computers <= //
 
@@ -508,6 +639,18 @@ public:
      */
     const std::vector<SharedMatrix >& D() const { return D_; }
 
+    /// Per-call performance records, oldest first
+    const std::vector<JKMetrics>& metrics() const { return metrics_; }
+    /// Drop the performance records
+    void clear_metrics() { metrics_.clear(); }
+    /**
+    * The performance records as a JSON object: the algorithm
+    * name and one entry per compute() call
+    */
+    std::string metrics_json() const;
+    /// Short algorithm name used in metrics_json(), e.g. "DFJK"
+    virtual std::string name() const { return "JK"; }
+
     /**
     * Print header information regarding JK
     * type on output file
@@ -566,6 +709,8 @@ public:
     * type on output file
     */
     virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "DiskJK"; }
 };
 
 /**
@@ -632,6 +777,8 @@ public:
     * type on output file
     */
     virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "PKJK"; }
 };
 
 /**
@@ -654,6 +801,28 @@ protected:
     /// ERI Sieve
     std::shared_ptr<ERISieve> sieve_;
 
+    /// Use density-weighted sieving in full builds? Defaults to false
+    bool density_screening_;
+
+    // => Incremental Fock build <= //
+
+    /// Build J/K from the density difference since the last call? Defaults to false
+    bool incfock_;
+    /// Number of compute_JK() calls between full rebuilds in incremental mode
+    int incfock_full_fock_every_;
+    /// Number of compute_JK() calls since the last full reset
+    int incfock_count_;
+    /// Is the current build incremental? (always density screened)
+    bool do_incfock_iter_;
+    /// Pseudo-densities of the previous build (AO basis)
+    std::vector<SharedMatrix> D_prev_;
+    /// J matrices of the previous build (AO basis)
+    std::vector<SharedMatrix> J_prev_;
+    /// K matrices of the previous build (AO basis)
+    std::vector<SharedMatrix> K_prev_;
+    /// wK matrices of the previous build (AO basis)
+    std::vector<SharedMatrix> wK_prev_;
+
     // => Required Algorithm-Specific Methods <= //
 
     /// Do we need to backtransform to C1 under the hood?
@@ -665,11 +834,21 @@ protected:
     /// Delete integrals, files, etc
     virtual void postiterations();
 
-    /// Build the J and K matrices for this integral class
+    /**
+     * Build the J, K, and wK matrices in one pass over the shell quartets; an empty
+     * J, K, or wK is skipped. With wK and J or K, ints must be CoulombErfERI objects;
+     * with wK alone, erf-attenuated integrals.
+     */
     void build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
         std::vector<std::shared_ptr<Matrix> >& D,
         std::vector<std::shared_ptr<Matrix> >& J,
-        std::vector<std::shared_ptr<Matrix> >& K);
+        std::vector<std::shared_ptr<Matrix> >& K,
+        std::vector<std::shared_ptr<Matrix> >& wK);
+
+    /// Can this build be formed incrementally from the previous one?
+    bool incfock_possible() const;
+    /// Stash the current D/J/K/wK for the next incremental build
+    void incfock_store();
 
     /// Common initialization
     void common_init();
@@ -695,6 +874,207 @@ public:
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Skip shell quartets whose Schwarz bound times the largest
+     * relevant density element is below the cutoff?
+     * @param val do density screening?
+     */
+    void set_density_screening(bool val) { density_screening_ = val; }
+    /**
+     * Build J/K from the change in density since the last
+     * call to compute(), with density-weighted screening?
+     * @param val do incremental builds?
+     */
+    void set_incfock(bool val) { incfock_ = val; }
+    /**
+     * Number of builds between full (non-incremental) rebuilds,
+     * used to limit the accumulation of screening errors
+     * @param val a positive integer
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = val; }
+    /// Discard the stored densities, the next build will be a full one
+    void reset_incfock() { incfock_count_ = 0; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "DirectJK"; }
+};
+
+/**
+ * Class CFMMJK
+ *
+ * DirectJK with a continuous fast multipole J build.  The
+ * significant shell pairs of the ERISieve are charge
+ * distributions with a center and an extent; they are
+ * sorted into an octree whose nodes carry the
+ * density-weighted Cartesian multipoles of their pairs.
+ * For each bra pair, well separated nodes enter J through a
+ * local expansion about the pair's center, and the pairs of
+ * the remaining leaves through exact integrals.  K and wK
+ * are left to DirectJK, so the savings are in J-only builds
+ * (pure functionals).
+ */
+class CFMMJK : public DirectJK {
+
+protected:
+
+    /// Order of the multipole and local expansions
+    int cfmm_order_;
+    /// Separation parameter, larger is faster and less accurate
+    double cfmm_theta_;
+    /// Largest number of shell pairs in a leaf of the tree
+    int cfmm_leaf_size_;
+
+    /// Significant shell pairs (M >= N), the sources of the tree
+    std::vector<std::pair<int, int> > pairs_;
+    /// Expansion center of each shell pair
+    std::vector<double> centers_;
+    /// Extent of each shell pair
+    std::vector<double> extents_;
+    /// Tree of the shell pairs
+    std::shared_ptr<ChargeMultipoleTree> tree_;
+
+    /// Setup integrals, files, etc
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+    /// Delete integrals, files, etc
+    virtual void postiterations();
+
+    /// Moments about its center of each function pair of shell pair index
+    void pair_moments(size_t index, OneBodyAOInt* overlap, OneBodyAOInt* multipoles,
+                      std::vector<double>& Q) const;
+    /// Build J for the densities D by the tree
+    void build_J(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& J);
+
+    /// Common initialization
+    void common_init();
+
+public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     *        AO2USO transforms will be built with the molecule
+     *        contained in this basis object, so the incoming
+     *        C matrices must have the same spatial symmetry
+     *        structure as this molecule
+     */
+    CFMMJK(std::shared_ptr<BasisSet> primary);
+    /// Destructor
+    virtual ~CFMMJK();
+
+    // => Knobs <= //
+
+    /**
+     * Order of the multipole expansions of the far field
+     * @param val a non-negative integer
+     */
+    void set_cfmm_order(int val) { cfmm_order_ = val; }
+    /**
+     * Two distributions interact through their multipoles if the
+     * sum of their extents is below theta times their distance
+     * @param val a number between 0 and 1
+     */
+    void set_cfmm_theta(double val) { cfmm_theta_ = val; }
+    /**
+     * Largest number of shell pairs in a leaf of the tree
+     * @param val a positive integer
+     */
+    void set_cfmm_leaf_size(int val) { cfmm_leaf_size_ = val; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "CFMMJK"; }
+};
+
+/**
+ * Class COSXJK
+ *
+ * DirectJK with a seminumerical (chain-of-spheres) K build.
+ * One electron of each exchange integral is put on a DFT
+ * grid and the other is integrated analytically,
+ *     K_mn = sum_g w_g phi_m(g) sum_s A_ns(g) F_s(g),
+ * with A_ns(g) the potential integral of a unit charge at g
+ * and F_s(g) = sum_l phi_l(g) D_ls.  The quadrature error is
+ * reduced by overlap fitting, which premultiplies K by
+ * S [S_grid]^-1.  J and wK are left to DirectJK.
+ */
+class COSXJK : public DirectJK {
+
+protected:
+
+    /// Options object, for the grid
+    Options& options_;
+    /// Exchange grid
+    std::shared_ptr<DFTGrid> grid_;
+    /// Overlap fitting matrix S [S_grid]^-1, null if not used
+    SharedMatrix Q_;
+    /// Number of radial and spherical points of the grid
+    int cosx_radial_points_;
+    int cosx_spherical_points_;
+    /// Fit the quadrature to the analytic overlap?
+    bool overlap_fitting_;
+
+    /// Setup integrals, files, etc
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+    /// Delete integrals, files, etc
+    virtual void postiterations();
+
+    /// Build K for the densities D on the grid
+    void build_K(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K);
+
+    /// Common initialization
+    void common_init();
+
+public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     *        AO2USO transforms will be built with the molecule
+     *        contained in this basis object, so the incoming
+     *        C matrices must have the same spatial symmetry
+     *        structure as this molecule
+     * @param options Options reference, for the DFT grid options
+     *        that the exchange grid does not override
+     */
+    COSXJK(std::shared_ptr<BasisSet> primary, Options& options);
+    /// Destructor
+    virtual ~COSXJK();
+
+    // => Knobs <= //
+
+    /**
+     * Radial points per atom of the exchange grid
+     * @param val a positive integer
+     */
+    void set_cosx_radial_points(int val) { cosx_radial_points_ = val; }
+    /**
+     * Spherical points per radial shell of the exchange grid
+     * @param val a Lebedev number of points
+     */
+    void set_cosx_spherical_points(int val) { cosx_spherical_points_ = val; }
+    /**
+     * Premultiply K by S [S_grid]^-1 to cancel most of the
+     * quadrature error?
+     * @param val do overlap fitting?
+     */
+    void set_overlap_fitting(bool val) { overlap_fitting_ = val; }
 
     // => Accessors <= //
 
@@ -703,6 +1083,8 @@ public:
     * type on output file
     */
     virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "COSXJK"; }
 };
 
 /** \brief Derived class extending the JK object to GTFock
@@ -722,7 +1104,9 @@ class GTFockJK: public JK{
    private:
       ///The actual instance that does the implementing
       std::shared_ptr<MinimalInterface> Impl_;
+      /// Number and symmetry of the densities the builder was created for
       int NMats_ = 0;
+      bool Symm_ = true;
 
    protected:
       /// Do we need to backtransform to C1 under the hood?
@@ -733,8 +1117,9 @@ class GTFockJK: public JK{
       virtual void compute_JK();
       /// Delete integrals, files, etc
       virtual void postiterations(){}
-      ///I don't fell the need to further clutter the output...
-      virtual void print_header() const{}
+      virtual void print_header() const;
+      /// Algorithm name, for metrics_json()
+      virtual std::string name() const { return "GTFockJK"; }
    public:
       /** \brief Your public interface to GTFock
        *
@@ -757,6 +1142,7 @@ class GTFockJK: public JK{
       *   This code calls GTFock once the number of densities was read from jk object
       */
       GTFockJK(std::shared_ptr<psi::BasisSet> Primary);
+      virtual ~GTFockJK();
 };
 
 /**
@@ -781,6 +1167,14 @@ protected:
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_;
+    /// Absolute error allowed in compressed disk (Q|mn), 0.0 (default) stores doubles
+    double disk_tolerance_;
+    /// Fixed-point step of the (Q|mn) file actually written, see compression.h
+    double compress_step_;
+    /// First mn column of each compressed (Q|mn) write block, then ntri
+    std::vector<size_t> compress_cols_;
+    /// Per (Q, block) element offset into "(Q|mn) Overflow", -1 if the block is packed
+    std::vector<long int> compress_overflow_;
     /// File number for (Q|mn) tensor
     size_t unit_;
     /// Core or disk?
@@ -809,6 +1203,29 @@ protected:
     std::vector<SharedMatrix > C_temp_;
     std::vector<SharedMatrix > Q_temp_;
 
+    // => Local K <= //
+
+    /// Build K from localized occupied orbitals, each over its own AO domain?
+    bool local_K_;
+    /// Smallest localized orbital coefficient kept in a domain
+    double local_K_tolerance_;
+    /// Localization algorithm, BOYS or PIPEK_MEZEY
+    std::string local_K_localizer_;
+    /// Localized C_left and C_right (AO basis), for the current compute_JK()
+    std::vector<SharedMatrix > C_left_local_;
+    std::vector<SharedMatrix > C_right_local_;
+    /// AO domain of each localized orbital of each C pair
+    std::vector<std::vector<std::vector<int> > > local_domains_;
+
+    // => Mixed precision <= //
+
+    /// Are the current builds single precision?
+    bool single_precision_;
+    /// Single-precision (Q|mn), naux x ntri, while single_precision_
+    std::vector<float> Qmn_single_;
+    /// AO densities of the previous build, to detect the switch
+    std::vector<SharedMatrix > D_prev_;
+
     // => Required Algorithm-Specific Methods <= //
 
     /// Do we need to backtransform to C1 under the hood?
@@ -837,8 +1254,24 @@ protected:
     virtual void initialize_JK_disk();
     virtual void manage_JK_core();
     virtual void manage_JK_disk();
+    /// Unpack rows [Q, Q + nrows) of the compressed (Q|mn) just read into Qmnp, unit_ open
+    void unpack_Qmn(double* Qmnp, int Q, int nrows);
     virtual void block_J(double** Qmnp, int naux);
     virtual void block_K(double** Qmnp, int naux);
+    /// Localize the occupied orbitals and build their domains, for block_K_local()
+    void localize_occupied();
+    /// Local K: E_i = (Q|m n) C_ni over the domain of each localized orbital i
+    void block_K_local(double** Qmnp, int naux);
+
+    // => Mixed precision J/K <= //
+    /// Narrow the double (Q|mn) just built, in core or on disk, into Qmn_single_
+    void initialize_JK_single();
+    /// Has the density settled enough to go back to double? Stashes D_ao_
+    bool density_settled();
+    /// Drop Qmn_single_ and restore the double (Q|mn), in core or on disk
+    void resume_double_precision();
+    /// J/K over Qmn_single_ with SGEMM/SGEMV, accumulated into J_ao_/K_ao_
+    void manage_JK_single();
 
     // => wK <= //
     virtual void initialize_wK_core();
@@ -883,6 +1316,13 @@ public:
      *        defaults to 1.0E-12
      */
     void set_condition(double condition) { condition_ = condition; }
+    /**
+     * Store disk (Q|mn) integrals in 32-bit fixed point, each within
+     * tol of its exact value. Ignored unless DF_INTS_IO is NONE, as
+     * saved integral files are read by other modules.
+     * @param tol absolute error per integral, defaults to 0.0 (off)
+     */
+    void set_disk_compression_tolerance(double tol) { disk_tolerance_ = tol; }
     /**
      * Which file number should the (Q|mn) integrals go in
      * @param unit Unit number
@@ -898,6 +1338,23 @@ public:
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Build K from localized occupied orbitals, contracting
+     * each one only over the AOs where it is significant
+     * @param val do local K?
+     */
+    void set_local_K(bool val) { local_K_ = val; }
+    /**
+     * Localized orbital coefficients below this are dropped
+     * from the orbital's domain
+     * @param val a small positive number, defaults to 1.0E-6
+     */
+    void set_local_K_tolerance(double val) { local_K_tolerance_ = val; }
+    /**
+     * Localization algorithm for local K
+     * @param val BOYS or PIPEK_MEZEY
+     */
+    void set_local_K_localizer(const std::string& val) { local_K_localizer_ = val; }
 
     // => Accessors <= //
 
@@ -906,6 +1363,129 @@ public:
     * type on output file
     */
     virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "DFJK"; }
+};
+/**
+ * Class DistDFJK
+ *
+ * DFJK with the auxiliary index of the fitted (Q|mn) tensor
+ * distributed over MPI ranks. Each rank holds a contiguous
+ * slab of Q (in core), forms the J/K contributions of its slab
+ * with the DFJK block kernels, and the nbf x nbf results are
+ * summed over all ranks. Without MPI support this is an in-core
+ * DFJK on a single rank. wK and integral caching (DF_INTS_IO)
+ * are not available.
+ */
+class DistDFJK : public DFJK {
+
+protected:
+
+    /// Rank of this process and number of processes
+    int rank_;
+    int nrank_;
+    /// First auxiliary shell owned by each rank (nrank + 1 entries)
+    std::vector<int> aux_shell_starts_;
+    /// First auxiliary function owned by each rank (nrank + 1 entries)
+    std::vector<int> aux_starts_;
+
+    /// Partition the auxiliary shells over ranks, balanced by function count
+    void partition_aux();
+    /// Number of auxiliary functions held by this rank
+    int naux_local() const { return aux_starts_[rank_ + 1] - aux_starts_[rank_]; }
+
+    /// Do we need to backtransform to C1 under the hood?
+    virtual bool C1() const { return true; }
+    /// Build this rank's slab of (Q|mn)
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+
+    /// Build (Q|mn) for the local Q slab, fitting distributed over ranks
+    virtual void initialize_JK_core();
+    /// Contract the local Q slab with the current densities
+    virtual void manage_JK_core();
+
+public:
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for this system.
+     */
+    DistDFJK(std::shared_ptr<BasisSet> primary,
+       std::shared_ptr<BasisSet> auxiliary);
+    /// Destructor
+    virtual ~DistDFJK();
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "DistDFJK"; }
+};
+/**
+ * Class SymmDFJK
+ *
+ * DFJK in the SO basis. The fitted (Q|mn) tensor is built as in
+ * the core DFJK, then rotated to the SO auxiliary functions and
+ * SO pairs of the primary basis, keeping for each auxiliary irrep
+ * h only the pairs of symmetry h (about a factor of the order of
+ * the point group less storage). J and K are formed directly in
+ * the SO basis, J only from the auxiliary irrep of the density.
+ * Falls back to the C1 DFJK algorithms for C1 molecules, wK,
+ * local K, mixed precision, or when the tensors do not fit in core.
+ */
+class SymmDFJK : public DFJK {
+
+protected:
+
+    /// Running the C1 DFJK algorithms instead?
+    bool c1_;
+    /// Auxiliary AO to SO transform
+    SharedMatrix AO2USO_aux_;
+    /// Fitted (Q_h|m_a n_b) with a^b = h, naux_h x npair_h per irrep h
+    std::vector<SharedMatrix > Qso_;
+    /// Offset of the (a, a^h) block in the pairs of irrep h, for a >= a^h
+    std::vector<std::vector<size_t> > pair_offset_;
+
+    /// Do we need to backtransform to C1 under the hood?
+    virtual bool C1() const { return c1_; }
+    /// Setup integrals, files, etc
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+    /// Delete integrals, files, etc
+    virtual void postiterations();
+
+    /// Size the SO pair blocks, returns the doubles in Qso_
+    size_t so_pair_sizes();
+    /// Rotate the AO Qmn_ into Qso_ and free Qmn_
+    void initialize_JK_symmetric();
+    /// (Q|m_a n_b) of row Q of irrep h as a dense nso_a x nso_b block, in T
+    const double* so_block(const double* Qrow, int h, int a, double* T) const;
+    /// J from the auxiliary irrep of each density
+    void block_J_symmetric();
+    /// K from (Q_h|m_a r_b) C_ri, irrep block by irrep block
+    void block_K_symmetric();
+
+public:
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for this system.
+     */
+    SymmDFJK(std::shared_ptr<BasisSet> primary,
+       std::shared_ptr<BasisSet> auxiliary);
+    /// Destructor
+    virtual ~SymmDFJK();
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "SymmDFJK"; }
 };
 /**
  * Class CDJK
@@ -937,6 +1517,8 @@ protected:
     * type on output file
     */
     virtual void print_header() const;
+    /// Algorithm name, for metrics_json()
+    virtual std::string name() const { return "CDJK"; }
 
 public:
     // => Constructors < = //
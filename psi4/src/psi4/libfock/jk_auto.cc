@@ -0,0 +1,240 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "jk.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/benchmark.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/liboptions/liboptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace psi {
+
+namespace {
+
+/// Significant (mn|rs) with m >= n, r >= s, mn >= rs, and significant m >= n pairs
+void count_significant(std::shared_ptr<ERISieve> sieve, int nbf, double& nquartet, double& npair) {
+    std::vector<double> values = sieve->function_pair_values();
+    std::vector<double> pairs;
+    pairs.reserve(nbf * (size_t)(nbf + 1) / 2);
+    for (int m = 0; m < nbf; m++) {
+        for (int n = 0; n <= m; n++) {
+            pairs.push_back(values[m * (size_t)nbf + n]);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    double cut2 = sieve->sieve() * sieve->sieve();
+    double ordered = 0.0;
+    double diagonal = 0.0;
+    npair = 0.0;
+    for (size_t PQ = 0; PQ < pairs.size(); PQ++) {
+        double v = pairs[PQ];
+        if (v * pairs.back() < cut2) continue;
+        npair += 1.0;
+        double partner = (v > 0.0 ? cut2 / v : 0.0);
+        ordered += (double)(pairs.end() - std::lower_bound(pairs.begin(), pairs.end(), partner));
+        if (v * v >= cut2) diagonal += 1.0;
+    }
+    nquartet = 0.5 * (ordered + diagonal);
+}
+
+/// Integrals per second of one thread, over a strided sample of the significant shell quartets
+double eri_rate(std::shared_ptr<BasisSet> primary, std::shared_ptr<ERISieve> sieve, double max_time) {
+    IntegralFactory factory(primary, primary, primary, primary);
+    std::shared_ptr<TwoBodyAOInt> eri(factory.eri());
+
+    const std::vector<std::pair<int, int> >& shell_pairs = sieve->shell_pairs();
+    size_t npairs = shell_pairs.size();
+    size_t nquartets = npairs * (npairs + 1) / 2;
+    size_t stride = std::max(nquartets / 2000, (size_t)1);
+
+    double computed = 0.0;
+    Timer timer;
+    double T = 0.0;
+    for (size_t index = 0; index < nquartets && T < max_time; index += stride) {
+        size_t PQ = (size_t)((std::sqrt(8.0 * index + 1.0) - 1.0) / 2.0);
+        while (PQ * (PQ + 1) / 2 > index) PQ--;
+        while ((PQ + 1) * (PQ + 2) / 2 <= index) PQ++;
+        size_t RS = index - PQ * (PQ + 1) / 2;
+        int P = shell_pairs[PQ].first;
+        int Q = shell_pairs[PQ].second;
+        int R = shell_pairs[RS].first;
+        int S = shell_pairs[RS].second;
+        if (!sieve->shell_significant(P, Q, R, S)) continue;
+        eri->compute_shell(P, Q, R, S);
+        computed += (double)primary->shell(P).nfunction() * primary->shell(Q).nfunction() *
+                    primary->shell(R).nfunction() * primary->shell(S).nfunction();
+        T = timer.get();
+    }
+    T = timer.get();
+
+    // Far too small to time (a few s functions): integrals are the least of our problems
+    if (computed == 0.0 || T <= 0.0) return 1.0E8;
+    return computed / T;
+}
+
+/// Flops per second of C_DGEMM, as threaded by the BLAS
+double dgemm_rate(double max_time) {
+    const int n = 256;
+    std::vector<double> A(n * n, 1.0E-3);
+    std::vector<double> B(n * n, 1.0E-3);
+    std::vector<double> C(n * n, 0.0);
+
+    size_t rounds = 0L;
+    Timer timer;
+    double T = 0.0;
+    while (T < max_time) {
+        C_DGEMM('N', 'N', n, n, n, 1.0, A.data(), n, B.data(), n, 0.0, C.data(), n);
+        rounds++;
+        T = timer.get();
+    }
+    return 2.0 * n * n * (double)n * rounds / T;
+}
+
+/// PSIO bytes per second: the user's figure, or one measurement per process
+double disk_rate(Options& options) {
+    if (options.get_double("JK_AUTO_DISK_BANDWIDTH") > 0.0)
+        return options.get_double("JK_AUTO_DISK_BANDWIDTH") * 1024.0 * 1024.0;
+    static double measured = 0.0;
+    if (measured == 0.0) measured = benchmark_disk_bandwidth(64L * 1024L * 1024L);
+    return measured;
+}
+
+}  // namespace
+
+std::string JK::select_type(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
+                            Options& options) {
+    double cutoff = (options["INTS_TOLERANCE"].has_changed() ? options.get_double("INTS_TOLERANCE") : 1.0E-12);
+    double memory = options.get_double("SCF_MEM_SAFETY_FACTOR") * (Process::environment.get_memory() / 8L);
+    int nthread = Process::environment.get_n_threads();
+    double niter = options.get_int("JK_AUTO_ITERATIONS");
+    bool exact = options.get_bool("JK_AUTO_EXACT");
+    int print = options.get_int("PRINT");
+
+    double nbf = primary->nbf();
+    double nocc = 0.0;
+    std::shared_ptr<Molecule> mol = primary->molecule();
+    for (int A = 0; A < mol->natom(); A++) nocc += mol->Z(A);
+    nocc = std::max(std::ceil(0.5 * (nocc - mol->molecular_charge())), 1.0);
+
+    // => Machine and problem <= //
+
+    std::shared_ptr<ERISieve> sieve(new ERISieve(primary, cutoff));
+    double nquartet, npair;
+    count_significant(sieve, primary->nbf(), nquartet, npair);
+    double ri = eri_rate(primary, sieve, 0.05) * nthread;
+    double rf = dgemm_rate(0.02);
+
+    // Disk is only timed if something has to go there
+    double rd = 0.0;
+    auto disk = [&]() {
+        if (rd == 0.0) rd = disk_rate(options);
+        return rd;
+    };
+
+    // => Costs [s] <= //
+
+    std::vector<std::pair<std::string, double> > costs;
+    std::vector<std::string> where;
+
+    // DirectJK: every iteration recomputes the integrals, the digestion is small beside them
+    costs.push_back(std::make_pair(std::string("DIRECT"), niter * nquartet / ri));
+    where.push_back("none");
+
+    // PKJK: J and K supermatrices of all unique (mn|rs)
+    double pk_pairs = nbf * (nbf + 1.0) / 2.0;
+    double pk_size = pk_pairs * (pk_pairs + 1.0) / 2.0;
+    double pk = nquartet / ri + niter * 4.0 * pk_size / rf;
+    if (2.0 * pk_size < memory) {
+        where.push_back("core");
+    } else {
+        pk += (1.0 + niter) * 2.0 * pk_size * sizeof(double) / disk();
+        where.push_back("disk");
+    }
+    costs.push_back(std::make_pair(std::string("PK"), pk));
+
+    // DiskJK: labeled IWL integrals are written once and read every iteration.
+    // It cannot beat an in-core PK, which does the same integrals without I/O.
+    if (where.back() == "disk") {
+        double iwl_bytes = nquartet * (sizeof(double) + 4 * sizeof(short));
+        costs.push_back(std::make_pair(std::string("OUT_OF_CORE"), nquartet / ri + (1.0 + niter) * iwl_bytes / disk() +
+                                                                       niter * 4.0 * nquartet / rf));
+        where.push_back("disk");
+    }
+
+    // DFJK: (Q|mn) over the significant pairs, fitted once; J and K by GEMM thereafter
+    if (auxiliary && !exact) {
+        double naux = auxiliary->nbf();
+        double df = naux * npair / ri + 2.0 * naux * naux * npair / rf + naux * naux * naux / rf;
+        df += niter * (4.0 * naux * npair + 4.0 * naux * nbf * nbf * nocc) / rf;
+        if (naux * npair + 2.0 * naux * naux < memory) {
+            where.push_back("core");
+        } else {
+            df += (1.0 + niter) * naux * npair * sizeof(double) / disk();
+            where.push_back("disk");
+        }
+        costs.push_back(std::make_pair(std::string("DF"), df));
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < costs.size(); i++) {
+        if (costs[i].second < costs[best].second) best = i;
+    }
+
+    if (print) {
+        outfile->Printf("  ==> JK Algorithm Selection <==\n\n");
+        outfile->Printf("    Significant (mn|rs):  %11.3E\n", nquartet);
+        outfile->Printf("    Memory (MB):          %11.0f\n", memory * 8.0 / (1024.0 * 1024.0));
+        outfile->Printf("    Threads:              %11d\n", nthread);
+        outfile->Printf("    Integrals [1/s]:      %11.3E\n", ri);
+        outfile->Printf("    DGEMM [GFLOP/s]:      %11.3f\n", rf * 1.0E-9);
+        if (rd > 0.0) outfile->Printf("    Disk [MB/s]:          %11.1f\n", rd / (1024.0 * 1024.0));
+        outfile->Printf("    Iterations assumed:   %11.0f\n\n", niter);
+        outfile->Printf("    %-12s %8s %14s\n", "SCF_TYPE", "Storage", "Estimate [s]");
+        for (size_t i = 0; i < costs.size(); i++) {
+            outfile->Printf("    %-12s %8s %14.3f%s\n", costs[i].first.c_str(), where[i].c_str(), costs[i].second,
+                            (i == best ? "  <==" : ""));
+        }
+        outfile->Printf("\n");
+    }
+
+    return costs[best].first;
+}
+
+}  // namespace psi
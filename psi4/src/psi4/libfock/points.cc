@@ -36,6 +36,7 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/vector.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace psi {
@@ -107,19 +108,19 @@ void RKSFunctions::set_pointers(SharedMatrix /*Da_AO*/, SharedMatrix /*Db_AO*/)
 {
     throw PSIEXCEPTION("RKSFunctions::unrestricted pointers are not appropriate. Read the source.");
 }
-void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
+void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool screen)
 {
     if (!D_AO_)
         throw PSIEXCEPTION("RKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
     // timer_on("Functions: Points");
-    BasisFunctions::compute_functions(block);
+    BasisFunctions::compute_functions(block, screen);
     // timer_off("Functions: Points");
 
     // => Global information <= //
     int npoints = block->npoints();
-    const std::vector<int>& function_map = block->functions_local_to_global();
+    const std::vector<int>& function_map = function_map_;
     int nglobal = max_functions_;
     int nlocal = function_map.size();
 
@@ -329,6 +330,7 @@ std::vector<SharedMatrix> UKSFunctions::scratch()
     std::vector<SharedMatrix> vec;
     vec.push_back(tempa_);
     vec.push_back(tempb_);
+    vec.push_back(tempab_);
     return vec;
 }
 std::vector<SharedMatrix> UKSFunctions::D_scratch()
@@ -344,6 +346,8 @@ void UKSFunctions::build_temps()
     Da_local_ = SharedMatrix(new Matrix("Dlocal",max_functions_,max_functions_));
     tempb_ = SharedMatrix(new Matrix("Temp",max_points_,max_functions_));
     Db_local_ = SharedMatrix(new Matrix("Dlocal",max_functions_,max_functions_));
+    tempab_ = SharedMatrix(new Matrix("Temp",max_points_,2 * max_functions_));
+    Dab_local_ = SharedMatrix(new Matrix("Dlocal",max_functions_,2 * max_functions_));
 }
 void UKSFunctions::allocate()
 {
@@ -383,30 +387,31 @@ void UKSFunctions::set_pointers(SharedMatrix Da_AO, SharedMatrix Db_AO)
     Da_AO_ = Da_AO;
     Db_AO_ = Db_AO;
 }
-void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
+void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool screen)
 {
     if (!Da_AO_)
         throw PSIEXCEPTION("UKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
     // timer_on("Functions: Points");
-    BasisFunctions::compute_functions(block);
+    BasisFunctions::compute_functions(block, screen);
     // timer_off("Functions: Points");
 
     // => Global information <= //
     int npoints = block->npoints();
-    const std::vector<int>& function_map = block->functions_local_to_global();
+    const std::vector<int>& function_map = function_map_;
     int nglobal = max_functions_;
     int nlocal  = function_map.size();
 
-    double** Tap = tempa_->pointer();
-    double** Tbp = tempb_->pointer();
+    // Alpha and beta go through each GEMM together, so the basis values are read once
+    double** Tp = tempab_->pointer();
 
     // => Build local D matrix <= //
     double** Dap = Da_AO_->pointer();
     double** Da2p = Da_local_->pointer();
     double** Dbp = Db_AO_->pointer();
     double** Db2p = Db_local_->pointer();
+    double** Dp = Dab_local_->pointer();
 
     for (int ml = 0; ml < nlocal; ml++) {
         int mg = function_map[ml];
@@ -420,6 +425,10 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
             Da2p[nl][ml] = Daval;
             Db2p[ml][nl] = Dbval;
             Db2p[nl][ml] = Dbval;
+            Dp[ml][nl] = Daval;
+            Dp[nl][ml] = Daval;
+            Dp[ml][nlocal + nl] = Dbval;
+            Dp[nl][nlocal + ml] = Dbval;
         }
     }
 
@@ -428,14 +437,10 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
     double* rhoap = point_values_["RHO_A"]->pointer();
     double* rhobp = point_values_["RHO_B"]->pointer();
 
-    C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phip[0],nglobal,Da2p[0],nglobal,0.0,Tap[0],nglobal);
+    C_DGEMM('N','N',npoints,2 * nlocal,nlocal,1.0,phip[0],nglobal,Dp[0],2 * nglobal,0.0,Tp[0],2 * nglobal);
     for (int P = 0; P < npoints; P++) {
-        rhoap[P] = C_DDOT(nlocal,phip[P],1,Tap[P],1);
-    }
-
-    C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phip[0],nglobal,Db2p[0],nglobal,0.0,Tbp[0],nglobal);
-    for (int P = 0; P < npoints; P++) {
-        rhobp[P] = C_DDOT(nlocal,phip[P],1,Tbp[P],1);
+        rhoap[P] = C_DDOT(nlocal,phip[P],1,Tp[P],1);
+        rhobp[P] = C_DDOT(nlocal,phip[P],1,Tp[P] + nlocal,1);
     }
 
     // => Build GGA quantities <= //
@@ -455,13 +460,15 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
         double* gammabbp = point_values_["GAMMA_BB"]->pointer();
 
         for (int P = 0; P < npoints; P++) {
+            double* Tap = Tp[P];
+            double* Tbp = Tp[P] + nlocal;
             // 2.0 for Px D P + P D Px
-            double rhoa_x = 2.0 * C_DDOT(nlocal, phixp[P], 1, Tap[P], 1);
-            double rhoa_y = 2.0 * C_DDOT(nlocal, phiyp[P], 1, Tap[P], 1);
-            double rhoa_z = 2.0 * C_DDOT(nlocal, phizp[P], 1, Tap[P], 1);
-            double rhob_x = 2.0 * C_DDOT(nlocal, phixp[P], 1, Tbp[P], 1);
-            double rhob_y = 2.0 * C_DDOT(nlocal, phiyp[P], 1, Tbp[P], 1);
-            double rhob_z = 2.0 * C_DDOT(nlocal, phizp[P], 1, Tbp[P], 1);
+            double rhoa_x = 2.0 * C_DDOT(nlocal, phixp[P], 1, Tap, 1);
+            double rhoa_y = 2.0 * C_DDOT(nlocal, phiyp[P], 1, Tap, 1);
+            double rhoa_z = 2.0 * C_DDOT(nlocal, phizp[P], 1, Tap, 1);
+            double rhob_x = 2.0 * C_DDOT(nlocal, phixp[P], 1, Tbp, 1);
+            double rhob_y = 2.0 * C_DDOT(nlocal, phiyp[P], 1, Tbp, 1);
+            double rhob_z = 2.0 * C_DDOT(nlocal, phizp[P], 1, Tbp, 1);
             rhoaxp[P] = rhoa_x;
             rhoayp[P] = rhoa_y;
             rhoazp[P] = rhoa_z;
@@ -490,29 +497,13 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block)
         phi[1] = phiyp;
         phi[2] = phizp;
 
-        double* tau[2];
-        tau[0] = tauap;
-        tau[1] = taubp;
-
-        double** D[2];
-        D[0] = Da2p;
-        D[1] = Db2p;
-
-        double** T[2];
-        T[0] = Tap;
-        T[1] = Tbp;
-
         for (int x = 0; x < 3; x++) {
-            for (int t = 0; t < 2; t++) {
-                double** phic = phi[x];
-                double** Dc = D[t];
-                double** Tc = T[t];
-                double*  tauc = tau[t];
-                C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phic[0], nglobal, Dc[0], nglobal,
-                        0.0, Tc[0], nglobal);
-                for (int P = 0; P < npoints; P++) {
-                    tauc[P] += C_DDOT(nlocal, phic[P], 1, Tc[P], 1);
-                }
+            double** phic = phi[x];
+            C_DGEMM('N', 'N', npoints, 2 * nlocal, nlocal, 1.0, phic[0], nglobal, Dp[0], 2 * nglobal,
+                    0.0, Tp[0], 2 * nglobal);
+            for (int P = 0; P < npoints; P++) {
+                tauap[P] += C_DDOT(nlocal, phic[P], 1, Tp[P], 1);
+                taubp[P] += C_DDOT(nlocal, phic[P], 1, Tp[P] + nlocal, 1);
             }
         }
     }
@@ -662,18 +653,24 @@ void BasisFunctions::allocate()
     int max_am = primary_->max_am();
     int max_cart = (max_am + 1) * (max_am + 2) / 2;
 
+    // Blocked kernel temps: per-point geometry, contracted radial factors, and
+    // Cartesian powers, all laid out [row][point]
+    basis_temps_["GEOM"] = SharedMatrix (new Matrix("GEOM", 4, max_points_));
+    basis_temps_["RADIAL"] = SharedMatrix (new Matrix("RADIAL", 4, max_points_));
+    basis_temps_["POW"] = SharedMatrix (new Matrix("POW", 3 * (max_am + 4), max_points_));
+
     if (deriv_ >= 0) {
         basis_values_["PHI"] = SharedMatrix (new Matrix("PHI", max_points_, max_functions_));
-        basis_temps_["PHI"] = SharedMatrix (new Matrix("PHI", max_points_, max_cart));
+        basis_temps_["PHI"] = SharedMatrix (new Matrix("PHI", max_cart, max_points_));
     }
 
     if (deriv_ >= 1) {
         basis_values_["PHI_X"] = SharedMatrix (new Matrix("PHI_X", max_points_, max_functions_));
         basis_values_["PHI_Y"] = SharedMatrix (new Matrix("PHI_Y", max_points_, max_functions_));
         basis_values_["PHI_Z"] = SharedMatrix (new Matrix("PHI_Z", max_points_, max_functions_));
-        basis_temps_["PHI_X"] = SharedMatrix (new Matrix("PHI_X", max_points_, max_cart));
-        basis_temps_["PHI_Y"] = SharedMatrix (new Matrix("PHI_Y", max_points_, max_cart));
-        basis_temps_["PHI_Z"] = SharedMatrix (new Matrix("PHI_Z", max_points_, max_cart));
+        basis_temps_["PHI_X"] = SharedMatrix (new Matrix("PHI_X", max_cart, max_points_));
+        basis_temps_["PHI_Y"] = SharedMatrix (new Matrix("PHI_Y", max_cart, max_points_));
+        basis_temps_["PHI_Z"] = SharedMatrix (new Matrix("PHI_Z", max_cart, max_points_));
     }
 
     if (deriv_ >= 2) {
@@ -683,26 +680,32 @@ void BasisFunctions::allocate()
         basis_values_["PHI_YY"] = SharedMatrix (new Matrix("PHI_YY", max_points_, max_functions_));
         basis_values_["PHI_YZ"] = SharedMatrix (new Matrix("PHI_YZ", max_points_, max_functions_));
         basis_values_["PHI_ZZ"] = SharedMatrix (new Matrix("PHI_ZZ", max_points_, max_functions_));
-        basis_temps_["PHI_XX"] = SharedMatrix (new Matrix("PHI_XX", max_points_, max_cart));
-        basis_temps_["PHI_XY"] = SharedMatrix (new Matrix("PHI_XY", max_points_, max_cart));
-        basis_temps_["PHI_XZ"] = SharedMatrix (new Matrix("PHI_XZ", max_points_, max_cart));
-        basis_temps_["PHI_YY"] = SharedMatrix (new Matrix("PHI_YY", max_points_, max_cart));
-        basis_temps_["PHI_YZ"] = SharedMatrix (new Matrix("PHI_YZ", max_points_, max_cart));
-        basis_temps_["PHI_ZZ"] = SharedMatrix (new Matrix("PHI_ZZ", max_points_, max_cart));
+        basis_temps_["PHI_XX"] = SharedMatrix (new Matrix("PHI_XX", max_cart, max_points_));
+        basis_temps_["PHI_XY"] = SharedMatrix (new Matrix("PHI_XY", max_cart, max_points_));
+        basis_temps_["PHI_XZ"] = SharedMatrix (new Matrix("PHI_XZ", max_cart, max_points_));
+        basis_temps_["PHI_YY"] = SharedMatrix (new Matrix("PHI_YY", max_cart, max_points_));
+        basis_temps_["PHI_YZ"] = SharedMatrix (new Matrix("PHI_YZ", max_cart, max_points_));
+        basis_temps_["PHI_ZZ"] = SharedMatrix (new Matrix("PHI_ZZ", max_cart, max_points_));
+    }
+
+    if (deriv_ >= 3) {
+        static const char* third[] = {"PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ",
+                                      "PHI_XZZ", "PHI_YYY", "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"};
+        for (int c = 0; c < 10; c++) {
+            basis_values_[third[c]] = SharedMatrix (new Matrix(third[c], max_points_, max_functions_));
+            basis_temps_[third[c]] = SharedMatrix (new Matrix(third[c], max_cart, max_points_));
+        }
     }
 
-    if (deriv_ >= 3)
-        throw PSIEXCEPTION("BasisFunctions: Only up to Hessians are currently supported");
+    if (deriv_ >= 4)
+        throw PSIEXCEPTION("BasisFunctions: Only up to third derivatives are currently supported");
 }
 SharedMatrix BasisFunctions::basis_value(const std::string& key)
 {
     return basis_values_[key];
 }
-void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block)
+void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block, bool screen)
 {
-    int max_am = primary_->max_am();
-    int max_cart = (max_am + 1) * (max_am + 2) / 2;
-
     int nso = max_functions_;
 
     int npoints = block->npoints();
@@ -710,389 +713,411 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block)
     double * y = block->y();
     double * z = block->z();
 
-    int maxL = primary_->max_am();
-
-    double * xc_pow = new double[maxL + 3];
-    double * yc_pow = new double[maxL + 3];
-    double * zc_pow = new double[maxL + 3];
-
     const std::vector<int>& shells = block->shells_local_to_global();
 
     int nsig_functions = block->functions_local_to_global().size();
 
-    if (deriv_ == 0) {
-        double** cartp = basis_temps_["PHI"]->pointer();
-        double** purep = basis_values_["PHI"]->pointer();
-
+    // Value types in output order: PHI, then gradients, then Hessians, then third derivatives
+    static const char* keys[] = {"PHI", "PHI_X", "PHI_Y", "PHI_Z",
+                                 "PHI_XX", "PHI_XY", "PHI_XZ", "PHI_YY", "PHI_YZ", "PHI_ZZ",
+                                 "PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ",
+                                 "PHI_XZZ", "PHI_YYY", "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"};
+    static const int ncomps[] = {1, 4, 10, 20};
+    int ncomp = ncomps[deriv_];
+
+    // Cartesian temps are [component][point] so every kernel loop below runs
+    // with unit stride over the points of the block and vectorizes
+    std::vector<double**> cartp(ncomp);
+    std::vector<double**> purep(ncomp);
+    for (int c = 0; c < ncomp; c++) {
+        cartp[c] = basis_temps_[keys[c]]->pointer();
+        purep[c] = basis_values_[keys[c]]->pointer();
         for (int P = 0; P < npoints; P++) {
-            ::memset(static_cast<void*>(purep[P]),'\0',nsig_functions*sizeof(double));
+            ::memset(static_cast<void*>(purep[c][P]), '\0', nsig_functions * sizeof(double));
         }
+    }
 
-        int function_offset = 0;
-        for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
-            int Qglobal = shells[Qlocal];
-            const GaussianShell& Qshell = primary_->shell(Qglobal);
-            Vector3 v     = Qshell.center();
-            int L         = Qshell.am();
-            int nQ        = Qshell.nfunction();
-            int nprim     = Qshell.nprimitive();
-            const double *alpha = Qshell.exps();
-            const double *norm  = Qshell.coefs();
-
-            const std::vector<std::tuple<int, int, double>>& transform = spherical_transforms_[L];
+    double** geomp = basis_temps_["GEOM"]->pointer();
+    double* restrict xc = geomp[0];
+    double* restrict yc = geomp[1];
+    double* restrict zc = geomp[2];
+    double* restrict R2 = geomp[3];
+
+    double** radp = basis_temps_["RADIAL"]->pointer();
+    double* restrict V1 = radp[0];
+    double* restrict V2 = radp[1];
+    double* restrict V3 = radp[2];
+    double* restrict V4 = radp[3];
+
+    // Power rows are shifted by deriv_ so that x^(l - k) for l < k reads a row of zeros
+    int npow = primary_->max_am() + 4;
+    double** powp = basis_temps_["POW"]->pointer();
+    double** xpow = &powp[0];
+    double** ypow = &powp[npow];
+    double** zpow = &powp[2 * npow];
+    for (int k = 0; k < deriv_; k++) {
+        ::memset(static_cast<void*>(xpow[k]), '\0', npoints * sizeof(double));
+        ::memset(static_cast<void*>(ypow[k]), '\0', npoints * sizeof(double));
+        ::memset(static_cast<void*>(zpow[k]), '\0', npoints * sizeof(double));
+    }
+    for (int P = 0; P < npoints; P++) {
+        xpow[deriv_][P] = 1.0;
+        ypow[deriv_][P] = 1.0;
+        zpow[deriv_][P] = 1.0;
+    }
 
-            xc_pow[0] = 1.0;
-            yc_pow[0] = 1.0;
-            zc_pow[0] = 1.0;
+    int function_offset = 0;
+    for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
+        int Qglobal = shells[Qlocal];
+        const GaussianShell& Qshell = primary_->shell(Qglobal);
+        Vector3 v     = Qshell.center();
+        int L         = Qshell.am();
+        int nQ        = Qshell.nfunction();
+        int nprim     = Qshell.nprimitive();
+        const double *alpha = Qshell.exps();
+        const double *norm  = Qshell.coefs();
+
+        const std::vector<std::tuple<int, int, double>>& transform = spherical_transforms_[L];
+
+        // => Geometry and powers <= //
+
+        const double vx = v[0];
+        const double vy = v[1];
+        const double vz = v[2];
+        # pragma omp simd
+        for (int P = 0; P < npoints; P++) {
+            xc[P] = x[P] - vx;
+            yc[P] = y[P] - vy;
+            zc[P] = z[P] - vz;
+            R2[P] = xc[P] * xc[P] + yc[P] * yc[P] + zc[P] * zc[P];
+        }
 
-            // Computation of points
+        for (int LL = deriv_ + 1; LL <= L + deriv_; LL++) {
+            double* restrict xl = xpow[LL];
+            double* restrict yl = ypow[LL];
+            double* restrict zl = zpow[LL];
+            const double* restrict xm = xpow[LL - 1];
+            const double* restrict ym = ypow[LL - 1];
+            const double* restrict zm = zpow[LL - 1];
+            # pragma omp simd
             for (int P = 0; P < npoints; P++) {
+                xl[P] = xm[P] * xc[P];
+                yl[P] = ym[P] * yc[P];
+                zl[P] = zm[P] * zc[P];
+            }
+        }
 
-                double xc = x[P] - v[0];
-                double yc = y[P] - v[1];
-                double zc = z[P] - v[2];
-
-                for (int LL = 1; LL < L + 1; LL++) {
-                    xc_pow[LL] = xc_pow[LL - 1] * xc;
-                    yc_pow[LL] = yc_pow[LL - 1] * yc;
-                    zc_pow[LL] = zc_pow[LL - 1] * zc;
-                }
-
-                double R2 = xc * xc + yc * yc + zc * zc;
-                double S0 = 0.0;
-                for (int K = 0; K < nprim; K++) {
-                    S0 += norm[K] * exp(-alpha[K] * R2);
+        // => Contracted radial part and its radial derivatives <= //
+
+        ::memset(static_cast<void*>(V1), '\0', npoints * sizeof(double));
+        if (deriv_ >= 1) ::memset(static_cast<void*>(V2), '\0', npoints * sizeof(double));
+        if (deriv_ >= 2) ::memset(static_cast<void*>(V3), '\0', npoints * sizeof(double));
+        if (deriv_ >= 3) ::memset(static_cast<void*>(V4), '\0', npoints * sizeof(double));
+        for (int K = 0; K < nprim; K++) {
+            const double a = alpha[K];
+            const double c = norm[K];
+            if (deriv_ == 0) {
+                # pragma omp simd
+                for (int P = 0; P < npoints; P++) {
+                    V1[P] += c * exp(-a * R2[P]);
                 }
-
-                for (int i=0, index = 0; i<=L; ++i) {
-                    int l = L-i;
-
-                    // # pragma omp simd
-                    for (int j=0; j<=i; j++, index++) {
-                        int m = i-j;
-                        int n = j;
-
-                        cartp[P][index] = S0 * xc_pow[l] * yc_pow[m] * zc_pow[n];
-                    }
+            } else if (deriv_ == 1) {
+                const double m2a = -2.0 * a;
+                # pragma omp simd
+                for (int P = 0; P < npoints; P++) {
+                    double T1 = c * exp(-a * R2[P]);
+                    V1[P] += T1;
+                    V2[P] += m2a * T1;
                 }
-            }
-
-            // Spherical transform
-            if (puream_) {
-                for (size_t index = 0; index < transform.size(); index++) {
-                    int pureindex = std::get<0>(transform[index]);
-                    int cartindex = std::get<1>(transform[index]);
-                    double coef   = std::get<2>(transform[index]);
-
-                    C_DAXPY(npoints,coef,&cartp[0][cartindex],max_cart,&purep[0][pureindex + function_offset],nso);
+            } else if (deriv_ == 2) {
+                const double m2a = -2.0 * a;
+                const double a4 = 4.0 * a * a;
+                # pragma omp simd
+                for (int P = 0; P < npoints; P++) {
+                    double T1 = c * exp(-a * R2[P]);
+                    V1[P] += T1;
+                    V2[P] += m2a * T1;
+                    V3[P] += a4 * T1;
                 }
             } else {
-                for (int q = 0; q < nQ; q++) {
-                    C_DCOPY(npoints,&cartp[0][q],max_cart,&purep[0][q + function_offset],nso);
+                const double m2a = -2.0 * a;
+                const double a4 = 4.0 * a * a;
+                const double m8a = -8.0 * a * a * a;
+                # pragma omp simd
+                for (int P = 0; P < npoints; P++) {
+                    double T1 = c * exp(-a * R2[P]);
+                    V1[P] += T1;
+                    V2[P] += m2a * T1;
+                    V3[P] += a4 * T1;
+                    V4[P] += m8a * T1;
                 }
             }
-
-            function_offset += nQ;
-        }
-    } else if (deriv_ == 1) {
-        double** cartp = basis_temps_["PHI"]->pointer();
-        double** cartxp = basis_temps_["PHI_X"]->pointer();
-        double** cartyp = basis_temps_["PHI_Y"]->pointer();
-        double** cartzp = basis_temps_["PHI_Z"]->pointer();
-        double** purep = basis_values_["PHI"]->pointer();
-        double** purexp = basis_values_["PHI_X"]->pointer();
-        double** pureyp = basis_values_["PHI_Y"]->pointer();
-        double** purezp = basis_values_["PHI_Z"]->pointer();
-
-        for (int P = 0; P < npoints; P++) {
-            ::memset(static_cast<void*>(purep[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purexp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(pureyp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purezp[P]), '\0', nsig_functions * sizeof(double));
         }
 
-        int function_offset = 0;
-        for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
-            int Qglobal = shells[Qlocal];
-            const GaussianShell& Qshell = primary_->shell(Qglobal);
-            Vector3 v     = Qshell.center();
-            int L         = Qshell.am();
-            int nQ        = Qshell.nfunction();
-            int nprim     = Qshell.nprimitive();
-            const double *alpha = Qshell.exps();
-            const double *norm  = Qshell.coefs();
-
-            const std::vector<std::tuple<int,int,double> >& transform = spherical_transforms_[L];
-
-            xc_pow[0] = 0.0;
-            yc_pow[0] = 0.0;
-            zc_pow[0] = 0.0;
-            xc_pow[1] = 1.0;
-            yc_pow[1] = 1.0;
-            zc_pow[1] = 1.0;
+        // => Cartesian functions <= //
 
-            for (int P = 0; P < npoints; P++) {
-
-                double xc = x[P] - v[0];
-                double yc = y[P] - v[1];
-                double zc = z[P] - v[2];
+        for (int i = 0, index = 0; i <= L; ++i) {
+            int l = L - i;
+            for (int j = 0; j <= i; j++, index++) {
+                int m = i - j;
+                int n = j;
 
-                for (int LL = 2; LL < L + 2; LL++) {
-                    xc_pow[LL] = xc_pow[LL - 1] * xc;
-                    yc_pow[LL] = yc_pow[LL - 1] * yc;
-                    zc_pow[LL] = zc_pow[LL - 1] * zc;
-                }
+                const double* restrict X0 = xpow[l + deriv_];
+                const double* restrict Y0 = ypow[m + deriv_];
+                const double* restrict Z0 = zpow[n + deriv_];
 
-                double R2 = xc * xc + yc * yc + zc * zc;
-                double V1 = 0.0;
-                double V2 = 0.0;
-//                double V3 = 0.0;
-                double T1,T2;
-                for (int K = 0; K < nprim; K++) {
-                    T1 =  norm[K] * exp(-alpha[K] * R2);
-                    T2 =  -2.0 * alpha[K] * T1;
-                    V1 += T1;
-                    V2 += T2;
-                }
-                double S0 = V1;
-                double SX = V2 * xc;
-                double SY = V2 * yc;
-                double SZ = V2 * zc;
-
-                // # pragma simd
-                for (int i = 0, index = 0; i <= L; ++i) {
-                    int l = L - i + 1;
-
-                    for (int j = 0; j <= i; j++, index++) {
-                        int m = i - j + 1;
-                        int n = j + 1;
-
-                        int lp = l - 1;
-                        int mp = m - 1;
-                        int np = n - 1;
-
-                        double xyz = xc_pow[l] * yc_pow[m] * zc_pow[n];
-                        cartp[P][index] = S0 * xyz;
-                        cartxp[P][index] = S0 * lp * xc_pow[l-1] * yc_pow[m] * zc_pow[n] + SX * xyz;
-                        cartyp[P][index] = S0 * mp * xc_pow[l] * yc_pow[m-1] * zc_pow[n] + SY * xyz;
-                        cartzp[P][index] = S0 * np * xc_pow[l] * yc_pow[m] * zc_pow[n-1] + SZ * xyz;
+                if (deriv_ == 0) {
+                    double* restrict phi = cartp[0][index];
+                    # pragma omp simd
+                    for (int P = 0; P < npoints; P++) {
+                        phi[P] = V1[P] * X0[P] * Y0[P] * Z0[P];
+                    }
+                } else if (deriv_ == 1) {
+                    const double* restrict X1 = xpow[l];
+                    const double* restrict Y1 = ypow[m];
+                    const double* restrict Z1 = zpow[n];
+                    const double dl = l;
+                    const double dm = m;
+                    const double dn = n;
+                    double* restrict phi = cartp[0][index];
+                    double* restrict phix = cartp[1][index];
+                    double* restrict phiy = cartp[2][index];
+                    double* restrict phiz = cartp[3][index];
+                    # pragma omp simd
+                    for (int P = 0; P < npoints; P++) {
+                        double S = V1[P];
+                        double A = X0[P] * Y0[P] * Z0[P];
+                        phi[P]  = S * A;
+                        phix[P] = S * dl * X1[P] * Y0[P] * Z0[P] + V2[P] * xc[P] * A;
+                        phiy[P] = S * dm * X0[P] * Y1[P] * Z0[P] + V2[P] * yc[P] * A;
+                        phiz[P] = S * dn * X0[P] * Y0[P] * Z1[P] + V2[P] * zc[P] * A;
+                    }
+                } else if (deriv_ == 2) {
+                    const double* restrict X1 = xpow[l + 1];
+                    const double* restrict Y1 = ypow[m + 1];
+                    const double* restrict Z1 = zpow[n + 1];
+                    const double* restrict X2 = xpow[l];
+                    const double* restrict Y2 = ypow[m];
+                    const double* restrict Z2 = zpow[n];
+                    const double dl = l;
+                    const double dm = m;
+                    const double dn = n;
+                    double* restrict phi = cartp[0][index];
+                    double* restrict phix = cartp[1][index];
+                    double* restrict phiy = cartp[2][index];
+                    double* restrict phiz = cartp[3][index];
+                    double* restrict phixx = cartp[4][index];
+                    double* restrict phixy = cartp[5][index];
+                    double* restrict phixz = cartp[6][index];
+                    double* restrict phiyy = cartp[7][index];
+                    double* restrict phiyz = cartp[8][index];
+                    double* restrict phizz = cartp[9][index];
+                    # pragma omp simd
+                    for (int P = 0; P < npoints; P++) {
+                        double S = V1[P];
+                        double SX = V2[P] * xc[P];
+                        double SY = V2[P] * yc[P];
+                        double SZ = V2[P] * zc[P];
+                        double SXY = V3[P] * xc[P] * yc[P];
+                        double SXZ = V3[P] * xc[P] * zc[P];
+                        double SYZ = V3[P] * yc[P] * zc[P];
+                        double SXX = V3[P] * xc[P] * xc[P] + V2[P];
+                        double SYY = V3[P] * yc[P] * yc[P] + V2[P];
+                        double SZZ = V3[P] * zc[P] * zc[P] + V2[P];
+
+                        double A = X0[P] * Y0[P] * Z0[P];
+                        double AX = dl * X1[P] * Y0[P] * Z0[P];
+                        double AY = dm * X0[P] * Y1[P] * Z0[P];
+                        double AZ = dn * X0[P] * Y0[P] * Z1[P];
+                        double AXY = dl * dm * X1[P] * Y1[P] * Z0[P];
+                        double AXZ = dl * dn * X1[P] * Y0[P] * Z1[P];
+                        double AYZ = dm * dn * X0[P] * Y1[P] * Z1[P];
+                        double AXX = dl * (dl - 1.0) * X2[P] * Y0[P] * Z0[P];
+                        double AYY = dm * (dm - 1.0) * X0[P] * Y2[P] * Z0[P];
+                        double AZZ = dn * (dn - 1.0) * X0[P] * Y0[P] * Z2[P];
+
+                        phi[P]  = S * A;
+                        phix[P] = S * AX + SX * A;
+                        phiy[P] = S * AY + SY * A;
+                        phiz[P] = S * AZ + SZ * A;
+                        phixx[P] = SXX * A + SX * AX + SX * AX + S * AXX;
+                        phiyy[P] = SYY * A + SY * AY + SY * AY + S * AYY;
+                        phizz[P] = SZZ * A + SZ * AZ + SZ * AZ + S * AZZ;
+                        phixy[P] = SXY * A + SX * AY + SY * AX + S * AXY;
+                        phixz[P] = SXZ * A + SX * AZ + SZ * AX + S * AXZ;
+                        phiyz[P] = SYZ * A + SY * AZ + SZ * AY + S * AYZ;
+                    }
+                } else {
+                    const double* restrict X1 = xpow[l + 2];
+                    const double* restrict Y1 = ypow[m + 2];
+                    const double* restrict Z1 = zpow[n + 2];
+                    const double* restrict X2 = xpow[l + 1];
+                    const double* restrict Y2 = ypow[m + 1];
+                    const double* restrict Z2 = zpow[n + 1];
+                    const double* restrict X3 = xpow[l];
+                    const double* restrict Y3 = ypow[m];
+                    const double* restrict Z3 = zpow[n];
+                    const double dl = l;
+                    const double dm = m;
+                    const double dn = n;
+                    const double dl2 = dl * (dl - 1.0);
+                    const double dm2 = dm * (dm - 1.0);
+                    const double dn2 = dn * (dn - 1.0);
+                    const double dl3 = dl2 * (dl - 2.0);
+                    const double dm3 = dm2 * (dm - 2.0);
+                    const double dn3 = dn2 * (dn - 2.0);
+                    double* restrict phi = cartp[0][index];
+                    double* restrict phix = cartp[1][index];
+                    double* restrict phiy = cartp[2][index];
+                    double* restrict phiz = cartp[3][index];
+                    double* restrict phixx = cartp[4][index];
+                    double* restrict phixy = cartp[5][index];
+                    double* restrict phixz = cartp[6][index];
+                    double* restrict phiyy = cartp[7][index];
+                    double* restrict phiyz = cartp[8][index];
+                    double* restrict phizz = cartp[9][index];
+                    double* restrict phixxx = cartp[10][index];
+                    double* restrict phixxy = cartp[11][index];
+                    double* restrict phixxz = cartp[12][index];
+                    double* restrict phixyy = cartp[13][index];
+                    double* restrict phixyz = cartp[14][index];
+                    double* restrict phixzz = cartp[15][index];
+                    double* restrict phiyyy = cartp[16][index];
+                    double* restrict phiyyz = cartp[17][index];
+                    double* restrict phiyzz = cartp[18][index];
+                    double* restrict phizzz = cartp[19][index];
+                    # pragma omp simd
+                    for (int P = 0; P < npoints; P++) {
+                        double xp = xc[P];
+                        double yp = yc[P];
+                        double zp = zc[P];
+
+                        // Radial part: S_ijk = V4 x_i x_j x_k + V3 (d_ij x_k + d_ik x_j + d_jk x_i)
+                        double S = V1[P];
+                        double SX = V2[P] * xp;
+                        double SY = V2[P] * yp;
+                        double SZ = V2[P] * zp;
+                        double SXY = V3[P] * xp * yp;
+                        double SXZ = V3[P] * xp * zp;
+                        double SYZ = V3[P] * yp * zp;
+                        double SXX = V3[P] * xp * xp + V2[P];
+                        double SYY = V3[P] * yp * yp + V2[P];
+                        double SZZ = V3[P] * zp * zp + V2[P];
+                        double SXXX = V4[P] * xp * xp * xp + 3.0 * V3[P] * xp;
+                        double SYYY = V4[P] * yp * yp * yp + 3.0 * V3[P] * yp;
+                        double SZZZ = V4[P] * zp * zp * zp + 3.0 * V3[P] * zp;
+                        double SXXY = V4[P] * xp * xp * yp + V3[P] * yp;
+                        double SXXZ = V4[P] * xp * xp * zp + V3[P] * zp;
+                        double SXYY = V4[P] * xp * yp * yp + V3[P] * xp;
+                        double SXZZ = V4[P] * xp * zp * zp + V3[P] * xp;
+                        double SYYZ = V4[P] * yp * yp * zp + V3[P] * zp;
+                        double SYZZ = V4[P] * yp * zp * zp + V3[P] * yp;
+                        double SXYZ = V4[P] * xp * yp * zp;
+
+                        // Angular part
+                        double A = X0[P] * Y0[P] * Z0[P];
+                        double AX = dl * X1[P] * Y0[P] * Z0[P];
+                        double AY = dm * X0[P] * Y1[P] * Z0[P];
+                        double AZ = dn * X0[P] * Y0[P] * Z1[P];
+                        double AXY = dl * dm * X1[P] * Y1[P] * Z0[P];
+                        double AXZ = dl * dn * X1[P] * Y0[P] * Z1[P];
+                        double AYZ = dm * dn * X0[P] * Y1[P] * Z1[P];
+                        double AXX = dl2 * X2[P] * Y0[P] * Z0[P];
+                        double AYY = dm2 * X0[P] * Y2[P] * Z0[P];
+                        double AZZ = dn2 * X0[P] * Y0[P] * Z2[P];
+                        double AXXX = dl3 * X3[P] * Y0[P] * Z0[P];
+                        double AYYY = dm3 * X0[P] * Y3[P] * Z0[P];
+                        double AZZZ = dn3 * X0[P] * Y0[P] * Z3[P];
+                        double AXXY = dl2 * dm * X2[P] * Y1[P] * Z0[P];
+                        double AXXZ = dl2 * dn * X2[P] * Y0[P] * Z1[P];
+                        double AXYY = dl * dm2 * X1[P] * Y2[P] * Z0[P];
+                        double AXZZ = dl * dn2 * X1[P] * Y0[P] * Z2[P];
+                        double AYYZ = dm2 * dn * X0[P] * Y2[P] * Z1[P];
+                        double AYZZ = dm * dn2 * X0[P] * Y1[P] * Z2[P];
+                        double AXYZ = dl * dm * dn * X1[P] * Y1[P] * Z1[P];
+
+                        phi[P]  = S * A;
+                        phix[P] = S * AX + SX * A;
+                        phiy[P] = S * AY + SY * A;
+                        phiz[P] = S * AZ + SZ * A;
+                        phixx[P] = SXX * A + SX * AX + SX * AX + S * AXX;
+                        phiyy[P] = SYY * A + SY * AY + SY * AY + S * AYY;
+                        phizz[P] = SZZ * A + SZ * AZ + SZ * AZ + S * AZZ;
+                        phixy[P] = SXY * A + SX * AY + SY * AX + S * AXY;
+                        phixz[P] = SXZ * A + SX * AZ + SZ * AX + S * AXZ;
+                        phiyz[P] = SYZ * A + SY * AZ + SZ * AY + S * AYZ;
+                        phixxx[P] = SXXX * A + 3.0 * (SXX * AX + SX * AXX) + S * AXXX;
+                        phiyyy[P] = SYYY * A + 3.0 * (SYY * AY + SY * AYY) + S * AYYY;
+                        phizzz[P] = SZZZ * A + 3.0 * (SZZ * AZ + SZ * AZZ) + S * AZZZ;
+                        phixxy[P] = SXXY * A + SXX * AY + 2.0 * (SXY * AX + SX * AXY) + SY * AXX + S * AXXY;
+                        phixxz[P] = SXXZ * A + SXX * AZ + 2.0 * (SXZ * AX + SX * AXZ) + SZ * AXX + S * AXXZ;
+                        phixyy[P] = SXYY * A + SYY * AX + 2.0 * (SXY * AY + SY * AXY) + SX * AYY + S * AXYY;
+                        phixzz[P] = SXZZ * A + SZZ * AX + 2.0 * (SXZ * AZ + SZ * AXZ) + SX * AZZ + S * AXZZ;
+                        phiyyz[P] = SYYZ * A + SYY * AZ + 2.0 * (SYZ * AY + SY * AYZ) + SZ * AYY + S * AYYZ;
+                        phiyzz[P] = SYZZ * A + SZZ * AY + 2.0 * (SYZ * AZ + SZ * AYZ) + SY * AZZ + S * AYZZ;
+                        phixyz[P] = SXYZ * A + SXY * AZ + SXZ * AY + SYZ * AX +
+                                    SX * AYZ + SY * AXZ + SZ * AXY + S * AXYZ;
                     }
                 }
             }
+        }
+
+        // => Spherical transform and scatter into [point][function] <= //
+
+        if (puream_) {
+            for (size_t index = 0; index < transform.size(); index++) {
+                int pureindex = std::get<0>(transform[index]);
+                int cartindex = std::get<1>(transform[index]);
+                double coef   = std::get<2>(transform[index]);
 
-            // Spherical transform
-            if (puream_) {
-                for (size_t index = 0; index < transform.size(); index++) {
-                    int pureindex = std::get<0>(transform[index]);
-                    int cartindex = std::get<1>(transform[index]);
-                    double coef   = std::get<2>(transform[index]);
-
-                    C_DAXPY(npoints, coef, &cartp[0][cartindex], max_cart,
-                            &purep[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartxp[0][cartindex], max_cart,
-                            &purexp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartyp[0][cartindex], max_cart,
-                            &pureyp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartzp[0][cartindex], max_cart,
-                            &purezp[0][pureindex + function_offset], nso);
+                for (int c = 0; c < ncomp; c++) {
+                    C_DAXPY(npoints,coef,cartp[c][cartindex],1,&purep[c][0][pureindex + function_offset],nso);
                 }
-            } else {
-                for (int q = 0; q < nQ; q++) {
-                    C_DCOPY(npoints, &cartp[0][q], max_cart, &purep[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartxp[0][q], max_cart, &purexp[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartyp[0][q], max_cart, &pureyp[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartzp[0][q], max_cart, &purezp[0][q + function_offset], nso);
+            }
+        } else {
+            for (int q = 0; q < nQ; q++) {
+                for (int c = 0; c < ncomp; c++) {
+                    C_DCOPY(npoints,cartp[c][q],1,&purep[c][0][q + function_offset],nso);
                 }
             }
-
-            function_offset += nQ;
         }
-    } else if (deriv_ == 2) {
-        double** cartp = basis_temps_["PHI"]->pointer();
-        double** cartxp = basis_temps_["PHI_X"]->pointer();
-        double** cartyp = basis_temps_["PHI_Y"]->pointer();
-        double** cartzp = basis_temps_["PHI_Z"]->pointer();
-        double** cartxxp = basis_temps_["PHI_XX"]->pointer();
-        double** cartxyp = basis_temps_["PHI_XY"]->pointer();
-        double** cartxzp = basis_temps_["PHI_XZ"]->pointer();
-        double** cartyyp = basis_temps_["PHI_YY"]->pointer();
-        double** cartyzp = basis_temps_["PHI_YZ"]->pointer();
-        double** cartzzp = basis_temps_["PHI_ZZ"]->pointer();
-        double** purep = basis_values_["PHI"]->pointer();
-        double** purexp = basis_values_["PHI_X"]->pointer();
-        double** pureyp = basis_values_["PHI_Y"]->pointer();
-        double** purezp = basis_values_["PHI_Z"]->pointer();
-        double** purexxp = basis_values_["PHI_XX"]->pointer();
-        double** purexyp = basis_values_["PHI_XY"]->pointer();
-        double** purexzp = basis_values_["PHI_XZ"]->pointer();
-        double** pureyyp = basis_values_["PHI_YY"]->pointer();
-        double** pureyzp = basis_values_["PHI_YZ"]->pointer();
-        double** purezzp = basis_values_["PHI_ZZ"]->pointer();
 
-        for (int P = 0; P < npoints; P++) {
-            ::memset(static_cast<void*>(purep[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purexp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(pureyp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purezp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purexxp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purexyp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purexzp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(pureyyp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(pureyzp[P]), '\0', nsig_functions * sizeof(double));
-            ::memset(static_cast<void*>(purezzp[P]), '\0', nsig_functions * sizeof(double));
-        }
+        function_offset += nQ;
+    }
 
-        int function_offset = 0;
-        for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
-            int Qglobal = shells[Qlocal];
-            const GaussianShell& Qshell = primary_->shell(Qglobal);
-            Vector3 v     = Qshell.center();
-            int L         = Qshell.am();
-            int nQ        = Qshell.nfunction();
-            int nprim     = Qshell.nprimitive();
-            const double *alpha = Qshell.exps();
-            const double *norm  = Qshell.coefs();
-
-            const std::vector<std::tuple<int,int,double> >& transform = spherical_transforms_[L];
-
-            xc_pow[0] = 0.0;
-            yc_pow[0] = 0.0;
-            zc_pow[0] = 0.0;
-            xc_pow[1] = 0.0;
-            yc_pow[1] = 0.0;
-            zc_pow[1] = 0.0;
-            xc_pow[2] = 1.0;
-            yc_pow[2] = 1.0;
-            zc_pow[2] = 1.0;
+    // => Significance screening <= //
 
-            for (int P = 0; P < npoints; P++) {
-                double xc = x[P] - v[0];
-                double yc = y[P] - v[1];
-                double zc = z[P] - v[2];
-
-                for (int LL = 3; LL < L + 3; LL++) {
-                    xc_pow[LL] = xc_pow[LL - 1] * xc;
-                    yc_pow[LL] = yc_pow[LL - 1] * yc;
-                    zc_pow[LL] = zc_pow[LL - 1] * zc;
-                }
+    const std::vector<int>& block_map = block->functions_local_to_global();
+    if (!screen) {
+        function_map_ = block_map;
+        return;
+    }
 
-                double R2 = xc * xc + yc * yc + zc * zc;
-                double V1 = 0.0;
-                double V2 = 0.0;
-                double V3 = 0.0;
-                double T1, T2, T3;
-                for (int K = 0; K < nprim; K++) {
-                    T1 = norm[K] * exp(-alpha[K] * R2);
-                    T2 = -2.0 * alpha[K] * T1;
-                    T3 = -2.0 * alpha[K] * T2;
-                    V1 += T1;
-                    V2 += T2;
-                    V3 += T3;
-                }
-                double S = V1;
-                double SX = V2 * xc;
-                double SY = V2 * yc;
-                double SZ = V2 * zc;
-                double SXY = V3 * xc * yc;
-                double SXZ = V3 * xc * zc;
-                double SYZ = V3 * yc * zc;
-                double SXX = V3 * xc * xc + V2;
-                double SYY = V3 * yc * yc + V2;
-                double SZZ = V3 * zc * zc + V2;
-
-                for (int i = 0, index = 0; i <= L; ++i) {
-                    int l = L - i + 2;
-
-                    // # pragma omp simd
-                    for (int j = 0; j <= i; j++, index++) {
-                        int m = i - j + 2;
-                        int n = j + 2;
-
-                        int lp = l - 2;
-                        int mp = m - 2;
-                        int np = n - 2;
-
-                        double A = xc_pow[l] * yc_pow[m] * zc_pow[n];
-                        double AX = lp * xc_pow[l - 1] * yc_pow[m] * zc_pow[n];
-                        double AY = mp * xc_pow[l] * yc_pow[m - 1] * zc_pow[n];
-                        double AZ = np * xc_pow[l] * yc_pow[m] * zc_pow[n - 1];
-                        double AXY = lp * mp * xc_pow[l - 1] * yc_pow[m - 1] * zc_pow[n];
-                        double AXZ = lp * np * xc_pow[l - 1] * yc_pow[m] * zc_pow[n - 1];
-                        double AYZ = mp * np * xc_pow[l] * yc_pow[m - 1] * zc_pow[n - 1];
-                        double AXX = lp * (lp - 1) * xc_pow[l - 2] * yc_pow[m] * zc_pow[n];
-                        double AYY = mp * (mp - 1) * xc_pow[l] * yc_pow[m - 2] * zc_pow[n];
-                        double AZZ = np * (np - 1) * xc_pow[l] * yc_pow[m] * zc_pow[n - 2];
-
-                        cartp[P][index] = S * A;
-                        cartxp[P][index] = S * AX + SX * A;
-                        cartyp[P][index] = S * AY + SY * A;
-                        cartzp[P][index] = S * AZ + SZ * A;
-                        cartxxp[P][index] = SXX * A + SX * AX + SX * AX + S * AXX;
-                        cartyyp[P][index] = SYY * A + SY * AY + SY * AY + S * AYY;
-                        cartzzp[P][index] = SZZ * A + SZ * AZ + SZ * AZ + S * AZZ;
-                        cartxyp[P][index] = SXY * A + SX * AY + SY * AX + S * AXY;
-                        cartxzp[P][index] = SXZ * A + SX * AZ + SZ * AX + S * AXZ;
-                        cartyzp[P][index] = SYZ * A + SY * AZ + SZ * AY + S * AYZ;
-                    }
-                }
+    // A function is kept if its value or gradient reaches the extents cutoff
+    // anywhere in the block; kept columns are packed in place, in order
+    double delta = block->extents()->delta();
+    int ntest = (deriv_ == 0 ? 1 : 4);
+    function_map_.clear();
+    int nkept = 0;
+    for (int ml = 0; ml < nsig_functions; ml++) {
+        double maxval = 0.0;
+        for (int c = 0; c < ntest && maxval < delta; c++) {
+            for (int P = 0; P < npoints; P++) {
+                maxval = std::max(maxval, std::fabs(purep[c][P][ml]));
             }
+        }
+        if (maxval < delta) continue;
 
-            // Spherical transform
-            if (puream_) {
-                for (size_t index = 0; index < transform.size(); index++) {
-                    int pureindex = std::get<0>(transform[index]);
-                    int cartindex = std::get<1>(transform[index]);
-                    double coef = std::get<2>(transform[index]);
-
-                    C_DAXPY(npoints, coef, &cartp[0][cartindex], max_cart,
-                            &purep[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartxp[0][cartindex], max_cart,
-                            &purexp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartyp[0][cartindex], max_cart,
-                            &pureyp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartzp[0][cartindex], max_cart,
-                            &purezp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartxxp[0][cartindex], max_cart,
-                            &purexxp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartxyp[0][cartindex], max_cart,
-                            &purexyp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartxzp[0][cartindex], max_cart,
-                            &purexzp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartyyp[0][cartindex], max_cart,
-                            &pureyyp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartyzp[0][cartindex], max_cart,
-                            &pureyzp[0][pureindex + function_offset], nso);
-                    C_DAXPY(npoints, coef, &cartzzp[0][cartindex], max_cart,
-                            &purezzp[0][pureindex + function_offset], nso);
-                }
-            } else {
-                for (int q = 0; q < nQ; q++) {
-                    C_DCOPY(npoints, &cartp[0][q], max_cart, &purep[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartxp[0][q], max_cart, &purexp[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartyp[0][q], max_cart, &pureyp[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartzp[0][q], max_cart, &purezp[0][q + function_offset], nso);
-                    C_DCOPY(npoints, &cartxxp[0][q], max_cart, &purexxp[0][q + function_offset],
-                            nso);
-                    C_DCOPY(npoints, &cartxyp[0][q], max_cart, &purexyp[0][q + function_offset],
-                            nso);
-                    C_DCOPY(npoints, &cartxzp[0][q], max_cart, &purexzp[0][q + function_offset],
-                            nso);
-                    C_DCOPY(npoints, &cartyyp[0][q], max_cart, &pureyyp[0][q + function_offset],
-                            nso);
-                    C_DCOPY(npoints, &cartyzp[0][q], max_cart, &pureyzp[0][q + function_offset],
-                            nso);
-                    C_DCOPY(npoints, &cartzzp[0][q], max_cart, &purezzp[0][q + function_offset],
-                            nso);
+        if (nkept != ml) {
+            for (int c = 0; c < ncomp; c++) {
+                for (int P = 0; P < npoints; P++) {
+                    purep[c][P][nkept] = purep[c][P][ml];
                 }
             }
-
-            function_offset += nQ;
         }
+        function_map_.push_back(block_map[ml]);
+        nkept++;
     }
-
-    delete[] xc_pow;
-    delete[] yc_pow;
-    delete[] zc_pow;
 }
 void BasisFunctions::print(std::string out, int print) const
 {
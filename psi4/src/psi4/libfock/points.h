@@ -63,6 +63,8 @@ protected:
     std::map<std::string, SharedMatrix > basis_temps_;
     /// [L]: pure_index, cart_index, coef
     std::vector<std::vector<std::tuple<int,int,double> > > spherical_transforms_;
+    /// Functions held in basis_values_ after the last compute_functions, local -> global
+    std::vector<int> function_map_;
 
     /// Setup spherical_transforms_
     void build_spherical();
@@ -77,10 +79,19 @@ public:
 
     // => Computers <= //
 
-    void compute_functions(std::shared_ptr<BlockOPoints> block);
+    /**
+     * Compute the basis function values (and derivatives up to deriv) on the block.
+     * If screen is true, local functions whose value and gradient stay below the
+     * block's extents cutoff at every point are dropped and the remaining columns
+     * are packed to the front; function_map() then gives the surviving functions.
+     */
+    void compute_functions(std::shared_ptr<BlockOPoints> block, bool screen = false);
 
     // => Accessors <= //
 
+    /// Functions held in the basis values, local -> global
+    const std::vector<int>& function_map() const { return function_map_; }
+
     SharedMatrix basis_value(const std::string& key);
     std::map<std::string, SharedMatrix>& basis_values() { return basis_values_; }
 
@@ -118,7 +129,7 @@ public:
 
     // => Computers <= //
 
-    virtual void compute_points(std::shared_ptr<BlockOPoints> block) = 0;
+    virtual void compute_points(std::shared_ptr<BlockOPoints> block, bool screen = false) = 0;
 
     // => Accessors <= //
 
@@ -180,7 +191,7 @@ public:
     void set_pointers(SharedMatrix Da_occ_AO);
     void set_pointers(SharedMatrix Da_occ_AO, SharedMatrix Db_occ_AO);
 
-    void compute_points(std::shared_ptr<BlockOPoints> block);
+    void compute_points(std::shared_ptr<BlockOPoints> block, bool screen = false);
 
     std::vector<SharedMatrix> scratch();
     std::vector<SharedMatrix> D_scratch();
@@ -212,6 +223,10 @@ protected:
     SharedMatrix Da_local_;
     /// Local D matrix
     SharedMatrix Db_local_;
+    /// Local Da and Db side by side, [nlocal][2 * max_functions_] with Db from column nlocal
+    SharedMatrix Dab_local_;
+    /// Half-transform of Dab_local_, [max_points_][2 * max_functions_], same layout
+    SharedMatrix tempab_;
 
     /// Build temporary work arrays
     void build_temps();
@@ -236,7 +251,7 @@ public:
     void set_pointers(SharedMatrix Da_occ_AO);
     void set_pointers(SharedMatrix Da_occ_AO, SharedMatrix Db_occ_AO);
 
-    void compute_points(std::shared_ptr<BlockOPoints> block);
+    void compute_points(std::shared_ptr<BlockOPoints> block, bool screen = false);
 
     std::vector<SharedMatrix> scratch();
     std::vector<SharedMatrix> D_scratch();
@@ -37,8 +37,10 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/libpsi4util.h"
 
 #include <cmath>
+#include <algorithm>
 #include <sstream>
 
 #ifdef _OPENMP
@@ -633,6 +635,7 @@ DLRSolver::DLRSolver(std::shared_ptr<RHamiltonian> H) :
     max_subspace_(6),
     min_subspace_(2),
     nguess_(1),
+    adaptive_subspace_(true),
     nsubspace_(0),
     nconverged_(0)
 {
@@ -713,6 +716,21 @@ void DLRSolver::initialize()
     E_.clear();
 
     diag_ = H_->diagonal();
+
+    // With a storage budget, take as large a subspace as fits (see memory_estimate),
+    // but always leave room to add one corrector per root after a restart
+    if (memory_ && adaptive_subspace_) {
+        size_t dimension = 0L;
+        for (int h = 0; h < diag_->nirrep(); h++) {
+            dimension += diag_->dimpi()[h];
+        }
+        if (dimension) {
+            long int nfit = ((long int) (memory_ / dimension) - 3L * nroot_ - 1L) / 2L;
+            nfit = std::min(nfit, (long int) dimension);
+            long int nmin = std::max(min_subspace_, nroot_) + nroot_;
+            max_subspace_ = (int) std::max(nfit, nmin);
+        }
+    }
 }
 void DLRSolver::solve()
 {
@@ -720,6 +738,8 @@ void DLRSolver::solve()
     converged_ = false;
     nconverged_ = 0;
     convergence_ = 0.0;
+    locked_.assign(nroot_, false);
+    G_.reset();
 
     if (print_ > 1) {
         outfile->Printf( "  => Iterations <=\n\n");
@@ -913,6 +933,11 @@ void DLRSolver::subspaceHamiltonian()
         npi[h] = n;
     }
 
+    // The subspace only grows between collapses, so the leading block is reused
+    SharedMatrix G_old = G_;
+    int n_old = (G_old ? G_old->rowspi()[0] : 0);
+    if (n_old > n) n_old = 0;
+
     G_ = SharedMatrix (new Matrix("Subspace Hamiltonian",nirrep,npi,npi));
     delete[] npi;
 
@@ -923,7 +948,13 @@ void DLRSolver::subspaceHamiltonian()
         if (!dimension) continue;
 
         double** Gp = G_->pointer(h);
-        for (int i = 0; i < n; i++) {
+        if (n_old) {
+            double** G_oldp = G_old->pointer(h);
+            for (int i = 0; i < n_old; i++) {
+                ::memcpy((void*) Gp[i], (void*) G_oldp[i], sizeof(double) * n_old);
+            }
+        }
+        for (int i = n_old; i < n; i++) {
             for (int j = 0; j <= i; j++) {
                 Gp[i][j] = Gp[j][i] = C_DDOT(dimension,b_[i]->pointer(h),1,s_[j]->pointer(h),1);
             }
@@ -1058,6 +1089,12 @@ void DLRSolver::residuals()
 
     for (int k = 0; k < nroot_; k++) {
 
+        // Locked roots keep the residual norm they converged with
+        if (locked_[k]) {
+            nconverged_++;
+            continue;
+        }
+
         double R2 = 0.0;
         double S2 = 0.0;
 
@@ -1090,6 +1127,7 @@ void DLRSolver::residuals()
         n_[k] = rnorm;
         if (rnorm < criteria_) {
             nconverged_++;
+            locked_[k] = true;
         }
     }
 
@@ -1272,10 +1310,16 @@ void DLRSolver::subspaceCollapse()
 {
     if (nsubspace_ <= max_subspace_) return;
 
+    // Thick restart: keep the current Ritz vector of every root, along with
+    // its sigma vector, so that no root is lost and no product is recomputed
+    int n = a_->rowspi()[0];
+    int nkeep = std::max(min_subspace_, nroot_);
+    if (nkeep > n) nkeep = n;
+
     std::vector<std::shared_ptr<Vector> > s2;
     std::vector<std::shared_ptr<Vector> > b2;
 
-    for (int k = 0; k < min_subspace_; ++k) {
+    for (int k = 0; k < nkeep; ++k) {
         std::stringstream bs;
         bs << "Subspace Vector " << k;
         b2.push_back(std::shared_ptr<Vector>(new Vector(bs.str(), diag_->dimpi())));
@@ -1284,8 +1328,7 @@ void DLRSolver::subspaceCollapse()
         s2.push_back(std::shared_ptr<Vector>(new Vector(ss.str(), diag_->dimpi())));
     }
 
-    int n = a_->rowspi()[0];
-    for (int k = 0; k < min_subspace_; ++k) {
+    for (int k = 0; k < nkeep; ++k) {
         for (int h = 0; h < diag_->nirrep(); ++h) {
             int dimension = diag_->dimpi()[h];
             if (!dimension) continue;
@@ -1306,6 +1349,7 @@ void DLRSolver::subspaceCollapse()
     s_ = s2;
     b_ = b2;
     nsubspace_ = b_.size();
+    G_.reset();
 
     if (debug_) {
         outfile->Printf( "   > SubspaceCollapse <\n\n");
@@ -2553,6 +2597,8 @@ void DLUSolver::finalize()
 {
     b_.clear();
     s_.clear();
+    active_.clear();
+    n_irrep_.clear();
     G_.reset();
     a_.reset();
     l_.reset();
@@ -2699,26 +2745,35 @@ void DLUSolver::sigma()
 }
 void DLUSolver::subspaceHamiltonian()
 {
-    int n = s_.size();
     int nirrep = diag_->nirrep();
-    int* npi = new int[nirrep];
+
+    // Blocks of locked roots are zero, each irrep works in the span of its nonzero blocks
+    active_.assign(nirrep, std::vector<int>());
+    Dimension npi(nirrep);
     for (int h = 0; h < nirrep; ++h) {
-        npi[h] = n;
+        int dimension = diag_->dimpi()[h];
+        if (!dimension) continue;
+        for (size_t i = 0; i < b_.size(); i++) {
+            double* bp = b_[i]->pointer(h);
+            if (C_DDOT(dimension,bp,1,bp,1) != 0.0) active_[h].push_back(i);
+        }
+        npi[h] = active_[h].size();
     }
 
-    G_ = SharedMatrix (new Matrix("Subspace Hamiltonian",nirrep,npi,npi));
-    delete[] npi;
+    G_ = SharedMatrix (new Matrix("Subspace Hamiltonian",npi,npi));
 
     for (int h = 0; h < nirrep; ++h) {
 
         int dimension = diag_->dimpi()[h];
+        int n = npi[h];
 
-        if (!dimension) continue;
+        if (!dimension || !n) continue;
 
+        const std::vector<int>& act = active_[h];
         double** Gp = G_->pointer(h);
         for (int i = 0; i < n; i++) {
             for (int j = 0; j <= i; j++) {
-                Gp[i][j] = Gp[j][i] = C_DDOT(dimension,b_[i]->pointer(h),1,s_[j]->pointer(h),1);
+                Gp[i][j] = Gp[j][i] = C_DDOT(dimension,b_[act[i]]->pointer(h),1,s_[act[j]]->pointer(h),1);
             }
         }
     }
@@ -2731,12 +2786,8 @@ void DLUSolver::subspaceHamiltonian()
 }
 void DLUSolver::subspaceDiagonalization()
 {
-    int n = s_.size();
     int nirrep = diag_->nirrep();
-    Dimension npi(nirrep);
-    for (int h = 0; h < nirrep; ++h) {
-        npi[h] = n;
-    }
+    const Dimension& npi = G_->rowspi();
 
     SharedMatrix G2(G_->clone());
     a_ = SharedMatrix (new Matrix("Subspace Eigenvectors",npi,npi));
@@ -2747,6 +2798,7 @@ void DLUSolver::subspaceDiagonalization()
     // Resort to remove false zeros for cases with too small of irreps
     for (int h = 0; h < nirrep; h++) {
 
+        int n = npi[h];
         int dim = diag_->dimpi()[h];
 
         int nfalse = n - dim;
@@ -2794,12 +2846,14 @@ void DLUSolver::eigenvecs()
 
         if (!dimension) continue;
 
+        const std::vector<int>& act = active_[h];
         double** ap = a_->pointer(h);
         for (int m = 0; m < nroot_; m++) {
             double* cp = c_[m]->pointer(h);
             ::memset((void*) cp, '\0', dimension*sizeof(double));
-            for (size_t i = 0; i < b_.size(); i++) {
-                double* bp = b_[i]->pointer(h);
+            if (m >= (int)act.size()) continue;
+            for (size_t i = 0; i < act.size(); i++) {
+                double* bp = b_[act[i]]->pointer(h);
                 C_DAXPY(dimension,ap[i][m],bp,1,cp,1);
             }
         }
@@ -2821,7 +2875,7 @@ void DLUSolver::eigenvals()
 
     for (int h = 0; h < diag_->nirrep(); ++h) {
         for (int k = 0; k < nroot_; k++) {
-            E_[k].push_back(l_->get(h,k));
+            E_[k].push_back(k < l_->dimpi()[h] ? l_->get(h,k) : 0.0);
         }
     }
 
@@ -2840,6 +2894,7 @@ void DLUSolver::eigenvals()
 void DLUSolver::residuals()
 {
     n_.resize(nroot_);
+    n_irrep_.assign(nroot_, std::vector<double>(diag_->nirrep(), 0.0));
     nconverged_ = 0;
 
     if (r_.size() != (size_t)nroot_) {
@@ -2862,23 +2917,29 @@ void DLUSolver::residuals()
         int dimension = diag_->dimpi()[h];
         if (!dimension) continue;
 
-            double** ap = a_->pointer(h);
-            double*  lp = l_->pointer(h);
+            const std::vector<int>& act = active_[h];
             double*  rp = r_[k]->pointer(h);
             double*  cp = c_[k]->pointer(h);
 
             ::memset((void*)rp, '\0', dimension*sizeof(double));
+            if (k >= (int)act.size()) continue;
 
-            for (size_t i = 0; i < b_.size(); i++) {
-                double* sp = s_[i]->pointer(h);
+            double** ap = a_->pointer(h);
+            double*  lp = l_->pointer(h);
+
+            for (size_t i = 0; i < act.size(); i++) {
+                double* sp = s_[act[i]]->pointer(h);
                 C_DAXPY(dimension,ap[i][k],sp,1,rp,1);
             }
-            S2 += C_DDOT(dimension,rp,1,rp,1);
+            double S2h = C_DDOT(dimension,rp,1,rp,1);
 
             C_DAXPY(dimension,-lp[k],cp,1,rp,1);
 
-            R2 += C_DDOT(dimension,rp,1,rp,1);
+            double R2h = C_DDOT(dimension,rp,1,rp,1);
+            n_irrep_[k][h] = (S2h > 0.0 ? sqrt(R2h/S2h) : 0.0);
 
+            R2 += R2h;
+            S2 += S2h;
         }
 
         // Residual norm k
@@ -2931,6 +2992,9 @@ void DLUSolver::correctors()
             int dimension = diag_->dimpi()[h];
             if (!dimension) continue;
 
+            // Locked, the block stays zero
+            if (n_irrep_[k][h] < criteria_) continue;
+
             double* hp = diag_->pointer(h);
             double lambda = E_[k][h];
             double* dp = d->pointer(h);
@@ -3083,19 +3147,19 @@ void DLUSolver::subspaceCollapse()
         s2.push_back(std::shared_ptr<Vector>(new Vector(ss.str(), diag_->dimpi())));
     }
 
-    int n = a_->rowspi()[0];
     for (int k = 0; k < min_subspace_; ++k) {
         for (int h = 0; h < diag_->nirrep(); ++h) {
             int dimension = diag_->dimpi()[h];
-            if (!dimension) continue;
+            const std::vector<int>& act = active_[h];
+            if (!dimension || k >= (int)act.size()) continue;
 
             double** ap = a_->pointer(h);
             double*  b2p = b2[k]->pointer(h);
             double*  s2p = s2[k]->pointer(h);
 
-            for (int i = 0; i < n; ++i) {
-                double*  bp = b_[i]->pointer(h);
-                double*  sp = s_[i]->pointer(h);
+            for (size_t i = 0; i < act.size(); ++i) {
+                double*  bp = b_[act[i]]->pointer(h);
+                double*  sp = s_[act[i]]->pointer(h);
                 C_DAXPY(dimension,ap[i][k],sp,1,s2p,1);
                 C_DAXPY(dimension,ap[i][k],bp,1,b2p,1);
             }
@@ -3118,4 +3182,152 @@ void DLUSolver::subspaceCollapse()
 }
 
 
+std::pair<std::vector<SharedMatrix>, std::vector<SharedMatrix> > cg_solver(
+    const std::vector<SharedMatrix>& rhs, MatrixProduct hx, MatrixProduct precon,
+    const std::vector<SharedMatrix>& guess, MatrixResidual printer, int printlvl, int maxiter, double rcond)
+{
+    size_t nrhs = rhs.size();
+    Timer timer;
+
+    if (printlvl) {
+        outfile->Printf("\n   -----------------------------------------------------\n");
+        outfile->Printf("                   Generalized CG Solver\n");
+        outfile->Printf("                  by Daniel. G. A. Smith\n");
+        outfile->Printf("   -----------------------------------------------------\n");
+        outfile->Printf("    Maxiter             = %11d\n", maxiter);
+        outfile->Printf("    Convergence         = %11.3E\n", rcond);
+        outfile->Printf("    Number of equations = %11zu\n\n", nrhs);
+        outfile->Printf("     %4s %14s %12s  %6s  %6s\n", "Iter", "Residual RMS", "Max RMS", "Remain", "Time [s]");
+        outfile->Printf("   -----------------------------------------------------\n");
+    }
+
+    std::vector<bool> active(nrhs, true);
+
+    // Both products must hand back one matrix per equation, at least for the active ones
+    auto product = [&](MatrixProduct& f, const std::vector<SharedMatrix>& v, const char* name) {
+        std::vector<SharedMatrix> ret = f(v, active);
+        if (ret.size() != nrhs) {
+            throw PSIEXCEPTION(std::string("CG Solver: ") + name + " returned the wrong number of vectors.");
+        }
+        for (size_t k = 0; k < nrhs; k++) {
+            if (active[k] && !ret[k]) {
+                throw PSIEXCEPTION(std::string("CG Solver: ") + name + " returned no vector for an active equation.");
+            }
+        }
+        return ret;
+    };
+
+    auto summary = [&](const std::vector<double>& resid, double& mean, double& max) {
+        mean = 0.0;
+        max = 0.0;
+        for (size_t k = 0; k < nrhs; k++) {
+            mean += resid[k];
+            max = std::max(max, resid[k]);
+        }
+        mean /= (nrhs ? nrhs : 1);
+    };
+
+    // Start function
+    std::vector<SharedMatrix> x;
+    if (guess.empty()) {
+        x = product(precon, rhs, "preconditioner");
+    } else {
+        if (guess.size() != nrhs) {
+            throw PSIEXCEPTION("CG Solver: Guess vector length does not match RHS vector length.");
+        }
+        for (size_t k = 0; k < nrhs; k++) x.push_back(SharedMatrix(guess[k]->clone()));
+    }
+
+    // Set it up, r = b - Ax
+    std::vector<SharedMatrix> Ax = product(hx, x, "Hx function");
+    std::vector<SharedMatrix> r;
+    for (size_t k = 0; k < nrhs; k++) {
+        r.push_back(SharedMatrix(rhs[k]->clone()));
+        r[k]->axpy(-1.0, Ax[k]);
+    }
+    Ax.clear();
+
+    std::vector<SharedMatrix> z = product(precon, r, "preconditioner");
+    std::vector<SharedMatrix> p;
+    for (size_t k = 0; k < nrhs; k++) p.push_back(SharedMatrix(z[k]->clone()));
+
+    // First RMS
+    std::vector<double> grad_dot(nrhs);
+    std::vector<double> resid(nrhs);
+    for (size_t k = 0; k < nrhs; k++) {
+        grad_dot[k] = rhs[k]->sum_of_squares();
+        resid[k] = std::sqrt(r[k]->sum_of_squares() / grad_dot[k]);
+    }
+
+    double mean, max;
+    if (printer) {
+        resid = printer(0, x, r);
+    } else if (printlvl) {
+        summary(resid, mean, max);
+        outfile->Printf("    %5s %14.3e %12.3e %7zu %9d\n", "Guess", mean, max, nrhs, (int) timer.get());
+    }
+
+    std::vector<double> rz_old(nrhs, 0.0);
+
+    // CG iterations
+    for (int iter = 0; iter < maxiter; iter++) {
+
+        // Build old RZ so we can discard vectors
+        for (size_t k = 0; k < nrhs; k++) {
+            if (active[k]) rz_old[k] = r[k]->vector_dot(z[k]);
+        }
+
+        // Build Hx product
+        std::vector<SharedMatrix> Ap = product(hx, p, "Hx function");
+
+        // Update x and r
+        for (size_t k = 0; k < nrhs; k++) {
+            if (!active[k]) continue;
+            double alpha = rz_old[k] / Ap[k]->vector_dot(p[k]);
+            if (std::isnan(alpha)) {
+                outfile->Printf("CG: Alpha is NaN for vector %zu. Stopping vector.", k);
+                active[k] = false;
+                continue;
+            }
+            x[k]->axpy(alpha, p[k]);
+            r[k]->axpy(-alpha, Ap[k]);
+            resid[k] = std::sqrt(r[k]->sum_of_squares() / grad_dot[k]);
+        }
+        Ap.clear();
+
+        // Print out or compute the resid function
+        if (printer) resid = printer(iter + 1, x, r);
+
+        // Converged vectors leave the active set
+        size_t nactive = 0;
+        for (size_t k = 0; k < nrhs; k++) {
+            if (active[k] && resid[k] < rcond) active[k] = false;
+            if (active[k]) nactive++;
+        }
+
+        // Print out if requested
+        if (printlvl) {
+            summary(resid, mean, max);
+            outfile->Printf("    %5d %14.3e %12.3e %7zu %9d\n", iter + 1, mean, max, nactive, (int) timer.get());
+        }
+
+        if (nactive == 0) break;
+
+        // Update p
+        z = product(precon, r, "preconditioner");
+        for (size_t k = 0; k < nrhs; k++) {
+            if (!active[k]) continue;
+            double beta = r[k]->vector_dot(z[k]) / rz_old[k];
+            p[k]->scale(beta);
+            p[k]->add(z[k]);
+        }
+    }
+
+    if (printlvl) {
+        outfile->Printf("   -----------------------------------------------------\n");
+    }
+
+    return std::make_pair(x, r);
+}
+
 }
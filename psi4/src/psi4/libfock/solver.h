@@ -32,6 +32,7 @@
 #include <psi4/libmints/typedefs.h>
 #include <psi4/liboptions/liboptions.h>
 
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -285,6 +286,8 @@ protected:
     int min_subspace_;
     /// Number of guess vectors to build
     int nguess_;
+    /// Size max_subspace_ from memory_ in initialize()? (cleared by set_max_subspace)
+    bool adaptive_subspace_;
 
     // => Iteration values <= //
 
@@ -292,6 +295,8 @@ protected:
     int nsubspace_;
     /// The number of converged roots
     int nconverged_;
+    /// Roots whose residuals have converged, and are no longer updated (nroots)
+    std::vector<bool> locked_;
 
     // => State values <= //
 
@@ -377,9 +382,12 @@ public:
 
     /// Set number of roots (defaults to 1)
     void set_nroot(int nroot) { nroot_ = nroot; }
-    /// Set maximum subspace size (defaults to 6)
-    void set_max_subspace(double max_subspace) { max_subspace_ = max_subspace; }
-    /// Set minimum subspace size, for collapse (defaults to 2)
+    /**
+     * Set maximum subspace size (defaults to 6, or to what fits in
+     * the memory given to set_memory() if this is never called)
+     */
+    void set_max_subspace(double max_subspace) { max_subspace_ = max_subspace; adaptive_subspace_ = false; }
+    /// Set minimum subspace size, for collapse (defaults to 2, raised to the number of roots)
     void set_min_subspace(double min_subspace) { min_subspace_ = min_subspace; }
     /// Set number of guesses (defaults to 1)
     void set_nguess(int nguess) { nguess_ = nguess; }
@@ -578,16 +586,21 @@ protected:
     SharedMatrix A_;
     /// Delta Subspace indices
     std::vector<std::vector<int> > A_inds_;
-    /// G_ij Subspace Hamiltonian (nsubspace x nsubspace)
+    /// Per irrep, the b vectors that are nonzero in it, which span its subspace
+    std::vector<std::vector<int> > active_;
+    /// G_ij Subspace Hamiltonian (nactive x nactive per irrep)
     SharedMatrix G_;
-    /// Subspace eigenvectors (nsubspace x nsubspace)
+    /// Subspace eigenvectors (nactive x nactive per irrep)
     SharedMatrix a_;
-    /// Subspace eigenvalues (nsubspace)
+    /// Subspace eigenvalues (nactive per irrep)
     std::shared_ptr<Vector> l_;
     /// Residual vectors (nroots)
     std::vector<std::shared_ptr<Vector> > r_;
     /// Residual vector 2-norms (nroots)
     std::vector<double> n_;
+    /// Residual 2-norms per root and irrep. Converged blocks are locked:
+    /// they get no correctors, so the sigma vectors skip their densities.
+    std::vector<std::vector<double> > n_irrep_;
     /// Correction vectors (nroots)
     std::vector<std::shared_ptr<Vector> > d_;
     /// Diagonal of Hamiltonian
@@ -672,6 +685,35 @@ public:
 
 };
 
+// => MATRIX SOLVERS <= //
+
+/// Products of the x[k] with active[k] set; the other entries are not read and may be null
+typedef std::function<std::vector<SharedMatrix>(const std::vector<SharedMatrix>& x, const std::vector<bool>& active)>
+    MatrixProduct;
+/// Called as (iteration, x, r) after each update, returning the residual of every equation
+typedef std::function<std::vector<double>(int iter, const std::vector<SharedMatrix>& x,
+                                          const std::vector<SharedMatrix>& r)>
+    MatrixResidual;
+
+/**
+ * Preconditioned CG for the equations A x[k] = rhs[k], A hermitian positive definite,
+ * all x[k] held as Matrix objects and updated in place. hx and precon are only asked
+ * for the still unconverged equations. Without printer, the residual of k is
+ * |r[k]| / |rhs[k]|. Returns the x and r vectors.
+ *
+ * @param rhs The right-hand sides
+ * @param hx The products A x
+ * @param precon The preconditioned residuals, in new matrices
+ * @param guess Starting x, else precon(rhs)
+ * @param printer Optional residual function, which also does any printing
+ * @param printlvl Print the iterations if nonzero and printer is empty
+ * @param maxiter Maximum number of iterations
+ * @param rcond Converged once the residual is below this
+ */
+std::pair<std::vector<SharedMatrix>, std::vector<SharedMatrix> > cg_solver(
+    const std::vector<SharedMatrix>& rhs, MatrixProduct hx, MatrixProduct precon,
+    const std::vector<SharedMatrix>& guess = std::vector<SharedMatrix>(), MatrixResidual printer = nullptr,
+    int printlvl = 1, int maxiter = 20, double rcond = 1.0E-6);
 
 }
 #endif
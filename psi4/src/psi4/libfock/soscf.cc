@@ -930,21 +930,16 @@ void DFSOMCSCF::transform(bool approx_only)
 void DFSOMCSCF::set_act_MO()
 {
     // Build (aa|aa)
-    std::map<std::string, std::shared_ptr<Tensor> >& dfints = dferi_->ints();
     int nQ = dferi_->size_Q();
-    std::shared_ptr<Tensor> aaQT = dfints["aaQ"];
-    SharedMatrix aaQ(new Matrix("aaQ", nact_ * nact_, nQ));
-    double* aaQp = aaQ->pointer()[0];
-    FILE* aaQF = aaQT->file_pointer();
-    fseek(aaQF,0L,SEEK_SET);
-    fread(aaQp, sizeof(double), nact_ * nact_ * nQ, aaQF);
-    matrices_["actMO"] = Matrix::doublet(aaQ, aaQ, false, true);
-    aaQ.reset();
+    int nact2 = nact_ * nact_;
+    double* aaQp = dferi_->core_ints("aaQ");
+    SharedMatrix actMO(new Matrix("actMO", nact2, nact2));
+    C_DGEMM('N', 'T', nact2, nact2, nQ, 1.0, aaQp, nQ, aaQp, nQ, 0.0, actMO->pointer()[0], nact2);
+    matrices_["actMO"] = actMO;
 }
 SharedMatrix DFSOMCSCF::compute_Q(SharedMatrix TPDM){
 
     timer_on("SOMCSCF: DF-Q matrix");
-    std::map<std::string, std::shared_ptr<Tensor> >& dfints = dferi_->ints();
 
     int nQ = dferi_->size_Q();
     int nact2 = nact_ * nact_;
@@ -962,34 +957,22 @@ SharedMatrix DFSOMCSCF::compute_Q(SharedMatrix TPDM){
     }
 
 
-    // Load aaQ
-    std::shared_ptr<Tensor> aaQT = dfints["aaQ"];
-    SharedMatrix aaQ(new Matrix("aaQ", nact_ * nact_, nQ));
-    double* aaQp = aaQ->pointer()[0];
-    FILE* aaQF = aaQT->file_pointer();
-    fseek(aaQF,0L,SEEK_SET);
-    fread(aaQp, sizeof(double), nact_ * nact_ * nQ, aaQF);
+    // aaQ and NaQ stay in core from one call to the next until the
+    // integrals are transformed again
+    double* aaQp = dferi_->core_ints("aaQ");
 
     // d_vwxy I_xyQ -> d_vwQ (Qa^4)
     SharedMatrix vwQ(new Matrix("vwQ", nact_ * nact_, nQ));
     double* vwQp = vwQ->pointer()[0];
     C_DGEMM('N', 'N', nact2, nQ, nact2, 1.0, TPDMp, nact2, aaQp, nQ, 0.0, vwQp, nQ);
-    aaQ.reset();
 
-    // Load NaQ
-    std::shared_ptr<Tensor> NaQT = dfints["RaQ"];
-    SharedMatrix NaQ(new Matrix("NaQ", nmo_ * nact_, nQ));
-    double* NaQp = NaQ->pointer()[0];
-    FILE* NaQF = NaQT->file_pointer();
-    fseek(NaQF, 0L, SEEK_SET);
-    fread(NaQp, sizeof(double), nmo_ * nact_ * nQ, NaQF);
+    double* NaQp = dferi_->core_ints("RaQ");
 
     // d_vwQ I_NwQ -> Q_vN (NQa^2)
     SharedMatrix denQ(new Matrix("Dense Qvn", nact_, nmo_));
     double** denQp = denQ->pointer();
     C_DGEMM('N', 'T', nact_, nmo_, nQ * nact_, 1.0, vwQp, nQ * nact_, NaQp, nQ * nact_, 0.0,
             denQp[0], nmo_);
-    NaQ.reset();
 
     // Symmetry block Q
     SharedMatrix Q(new Matrix("Qvn", nirrep_, nactpi_, nmopi_));
@@ -1045,13 +1028,8 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
         throw PSIEXCEPTION(error.str().c_str());
     }
 
-    // Read NaQ
-    std::shared_ptr<Tensor> NaQT = dfints["RaQ"];
-    SharedMatrix NaQ(new Matrix("RaQ", nmo_ * nact_, nQ));
-    double* NaQp = NaQ->pointer()[0];
-    FILE* NaQF = NaQT->file_pointer();
-    fseek(NaQF,0L,SEEK_SET);
-    fread(NaQp, sizeof(double), nmo_ * nact_ * nQ, NaQF);
+    // NaQ from core, read once per transformation rather than once per microiteration
+    double* NaQp = dferi_->core_ints("RaQ");
 
     SharedMatrix xyQ(new Matrix("xyQ", nact_ * nact_, nQ));
     double* xyQp = xyQ->pointer()[0];
@@ -1074,9 +1052,9 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
     }
 
     // nwQ,xyQ => tmp_nwxy (NaQ, xyQ) NQa^3
-    SharedMatrix Gnwxy = Matrix::doublet(NaQ, xyQ, false, true);
+    SharedMatrix Gnwxy(new Matrix("Gnwxy", nmo_ * nact_, nact2));
     double* Gnwxyp = Gnwxy->pointer()[0];
-    NaQ.reset();
+    C_DGEMM('N', 'T', nmo_ * nact_, nact2, nQ, 1.0, NaQp, nQ, xyQp, nQ, 0.0, Gnwxyp, nact2);
 
     // vwxy,nwxy => Qk_vm (TPDM, tmp_nwxy) Na^4
     SharedMatrix dQk(new Matrix("dQk", nact_, nmo_));
@@ -1106,17 +1084,9 @@ SharedMatrix DFSOMCSCF::compute_Qk(SharedMatrix TPDM, SharedMatrix U, SharedMatr
     }
     NNQ.reset();
 
-    // Read aaQ
-    std::shared_ptr<Tensor> aaQT = dfints["aaQ"];
-    SharedMatrix aaQ(new Matrix("aaQ", nact_ * nact_, nQ));
-    double* aaQp = aaQ->pointer()[0];
-    FILE* aaQF = aaQT->file_pointer();
-    fseek(aaQF,0L,SEEK_SET);
-    fread(aaQp, sizeof(double), nact_ * nact_ * nQ, aaQF);
-
     // wnQ,xyQ => tmp_wnxy (wNQ, aaQ) NQa^3
+    double* aaQp = dferi_->core_ints("aaQ");
     C_DGEMM('N', 'T', nmo_ * nact_, nact2, nQ, 1.0, wnQp[0], nQ, aaQp, nQ, 0.0, Gnwxyp, nact2);
-    aaQ.reset();
 
     // Should probably figure out an inplace algorithm
     SharedMatrix Gleft(new Matrix("Gnwxy", nmo_, nact3));
@@ -41,6 +41,7 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/petitelist.h"
+#include "psi4/libmints/pointgrp.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
@@ -49,6 +50,8 @@
 #include <sstream>
 #include <string>
 #include <numeric>
+#include <algorithm>
+#include <cstring>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -56,6 +59,11 @@
 
 namespace psi {
 
+namespace {
+/// Per-thread scratch, in doubles, for the batched perturbed densities of RV::compute_Vx
+const size_t vx_batch_doubles = 1L << 22;
+}
+
 VBase::VBase(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisSet> primary,
              Options& options)
     : options_(options), primary_(primary), functional_(functional) {
@@ -67,6 +75,7 @@ void VBase::common_init() {
     debug_ = options_.get_int("DEBUG");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
+    vv10_screen_radius_ = options_.get_double("DFT_VV10_SCREEN_RADIUS");
     grac_initialized_ = false;
     num_threads_ = 1;
 #ifdef _OPENMP
@@ -133,12 +142,31 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
 }
 void VBase::initialize() {
     timer_on("V: Grid");
-    grid_ = std::shared_ptr<DFTGrid>(new DFTGrid(primary_->molecule(), primary_, options_));
+    // A V that goes back to the SO basis only needs the totally symmetric part of each
+    // integrand, which the grids of the symmetry-unique atoms give exactly. Everything
+    // else (Vx, gradients, Hessians) keeps the full grid.
+    sym_grid_.reset();
+    std::shared_ptr<Molecule> mol = primary_->molecule();
+    if (options_.get_bool("DFT_GRID_SYMMETRY") && mol->point_group()->char_table().order() > 1) {
+        std::map<std::string, int> sym_options = grid_int_options_;
+        sym_options["DFT_GRID_SYMMETRY"] = 1;
+        grid_ = std::shared_ptr<DFTGrid>(new DFTGrid(mol, primary_, sym_options, grid_str_options_, options_));
+        if (grid_->symmetry_unique()) {
+            sym_grid_ = grid_;
+            grid_.reset();
+        }
+    }
+    if (!grid_) {
+        grid_ = std::shared_ptr<DFTGrid>(new DFTGrid(mol, primary_, grid_int_options_, grid_str_options_, options_));
+    }
     timer_off("V: Grid");
 
     for (size_t i = 0; i < num_threads_; i++) {
         // Need a functional worker per thread
         functional_workers_.push_back(functional_->build_worker());
+        if (options_.get_bool("DFT_NATIVE_KERNELS")) {
+            functional_workers_[i]->set_native_kernels(true);
+        }
     }
 }
 SharedMatrix VBase::compute_gradient() {
@@ -205,10 +233,30 @@ void VBase::print_header() const {
     outfile->Printf("  ==> DFT Potential <==\n\n");
     functional_->print("outfile", print_);
     grid_->print("outfile", print_);
+    if (sym_grid_) {
+        outfile->Printf("    Symmetry-unique grid for V: %d of %d points in %zu blocks.\n\n", sym_grid_->npoints(),
+                        grid_->npoints(), sym_grid_->blocks().size());
+    }
+}
+void VBase::zero_asymmetric_moments() {
+    CharacterTable ct = primary_->molecule()->point_group()->char_table();
+    const char* axes = "XYZ";
+    for (int k = 0; k < 3; k++) {
+        bool symmetric = true;
+        for (int g = 0; g < ct.order(); g++) {
+            if (ct.symm_operation(g)(k, k) < 0.0) symmetric = false;
+        }
+        if (symmetric) continue;
+        quad_values_[std::string("RHO_A") + axes[k]] = 0.0;
+        quad_values_[std::string("RHO_B") + axes[k]] = 0.0;
+    }
 }
 std::shared_ptr<BlockOPoints> VBase::get_block(int block) { return grid_->blocks()[block]; }
 size_t VBase::nblocks() { return grid_->blocks().size(); }
-void VBase::finalize() { grid_.reset(); }
+void VBase::finalize() {
+    grid_.reset();
+    sym_grid_.reset();
+}
 
 double VBase::vv10_nlc(SharedMatrix ret){
 
@@ -240,6 +288,7 @@ double VBase::vv10_nlc(SharedMatrix ret){
     std::map<std::string, int> opt_int_map;
     opt_int_map["DFT_RADIAL_POINTS"] = options_.get_int("DFT_VV10_RADIAL_POINTS");
     opt_int_map["DFT_SPHERICAL_POINTS"] = options_.get_int("DFT_VV10_SPHERICAL_POINTS");
+    opt_int_map["DFT_RADIAL_ROW_INCREMENT"] = 0;
 
     DFTGrid nlgrid = DFTGrid(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
 
@@ -266,6 +315,24 @@ double VBase::vv10_nlc(SharedMatrix ret){
                                                         vv10_rho_cutoff_, block->npoints(), false);
     }
 
+    // => Screened kernel: each block only sees the blocks near it <=
+    // The octree blocks are compact, so their bounding spheres bound every point pair
+    bool screen = (vv10_screen_radius_ > 0.0);
+    std::vector<std::vector<size_t>> neighbors;
+    if (screen) {
+        size_t nblock = nlgrid.blocks().size();
+        neighbors.resize(nblock);
+        for (size_t Q = 0; Q < nblock; Q++) {
+            std::shared_ptr<BlockOPoints> lblock = nlgrid.blocks()[Q];
+            for (size_t R = 0; R < nblock; R++) {
+                if (!vv10_tmp_cache[R]["W"]->dimpi()[0]) continue;
+                std::shared_ptr<BlockOPoints> rblock = nlgrid.blocks()[R];
+                double gap = lblock->xc().distance(rblock->xc()) - lblock->R() - rblock->R();
+                if (gap <= vv10_screen_radius_) neighbors[Q].push_back(R);
+            }
+        }
+    }
+
     // Stitch the cache together to make a single contiguous cache
     size_t total_size = 0;
     for (auto cache : vv10_tmp_cache){
@@ -306,8 +373,8 @@ double VBase::vv10_nlc(SharedMatrix ret){
         offset += csize;
     }
 
-    // Should cleanup, but...
-    vv10_tmp_cache.clear();
+    // The screened kernel still needs the per-block pieces
+    if (!screen) vv10_tmp_cache.clear();
 
 // => Compute the kernel <=
 #pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
@@ -337,7 +404,13 @@ double VBase::vv10_nlc(SharedMatrix ret){
         // Updates the vals map and returns the energy
         vals["V_RHO_A"]->zero();
         vals["V_GAMMA_AA"]->zero();
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints);
+        if (screen) {
+            std::vector<std::map<std::string, SharedVector>> near;
+            for (size_t R : neighbors[Q]) near.push_back(vv10_tmp_cache[R]);
+            vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), near, block, npoints);
+        } else {
+            vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints);
+        }
 
         double** phi = pworker->basis_value("PHI")->pointer();
         double * rho_a = pworker->point_value("RHO_A")->pointer();
@@ -404,6 +477,10 @@ void RV::initialize() {
     VBase::initialize();
     int max_points = grid_->max_points();
     int max_functions = grid_->max_functions();
+    if (sym_grid_) {
+        max_points = std::max(max_points, sym_grid_->max_points());
+        max_functions = std::max(max_functions, sym_grid_->max_functions());
+    }
     for (size_t i = 0; i < num_threads_; i++) {
         // Need a points worker per thread
         std::shared_ptr<PointFunctions> point_tmp(new RKSFunctions(primary_, max_points, max_functions));
@@ -425,8 +502,9 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     int ansatz = functional_->ansatz();
 
     // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
+    std::shared_ptr<DFTGrid> grid = potential_grid();
+    int max_functions = grid->max_functions();
+    int max_points = grid->max_points();
 
     // Setup the pointers
     for (size_t i = 0; i < num_threads_; i++){
@@ -454,7 +532,7 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
 
     // Traverse the blocks of points
     #pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+    for (size_t Q = 0; Q < grid->blocks().size(); Q++) {
 
         // Get thread info
         #ifdef _OPENMP
@@ -469,21 +547,21 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
         // Scratch
         double** Tp = pworker->scratch()[0]->pointer();
 
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
+        std::shared_ptr<BlockOPoints> block = grid->blocks()[Q];
         int npoints = block->npoints();
         double * x = block->x();
         double * y = block->y();
         double * z = block->z();
         double * w = block->w();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
 
-
-        // Compute Rho, Phi, etc
+        // Compute Rho, Phi, etc, only over the functions significant on this block
         // timer_on("V: Properties");
-        pworker->compute_points(block);
+        pworker->compute_points(block, true);
         // timer_off("V: Properties");
 
+        const std::vector<int>& function_map = pworker->function_map();
+        int nlocal = function_map.size();
+
 
         // Compute functional values
         // timer_on("V: Functional");
@@ -621,6 +699,7 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     quad_values_["RHO_BX"]     = quad_values_["RHO_AX"];
     quad_values_["RHO_BY"]     = quad_values_["RHO_AY"];
     quad_values_["RHO_BZ"]     = quad_values_["RHO_AZ"];
+    if (grid->symmetry_unique()) zero_asymmetric_moments();
 
     if (debug_) {
         outfile->Printf("   => Numerical Integrals <=\n\n");
@@ -679,12 +758,20 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
     }
 
 
+    // The perturbed densities of a block are stacked side by side, so that
+    // phi D^k and phi^T T^k are each one wide DGEMM per batch of densities
+    size_t nbatch = Dx_vec.size();
+    size_t per_density = 2L * max_functions * max_functions + (size_t)max_points * max_functions;
+    size_t max_batch = std::max<size_t>(1, vx_batch_doubles / per_density);
+    if (nbatch > max_batch) nbatch = max_batch;
+
     // Per [R]ank quantities
-    std::vector<SharedMatrix> R_Vx_local, R_Dx_local;
+    std::vector<SharedMatrix> R_Vx_local, R_Dx_local, R_T_local;
     std::vector<std::shared_ptr<Vector>> R_rho_k, R_rho_k_x, R_rho_k_y, R_rho_k_z, R_gamma_k;
     for (size_t i = 0; i < num_threads_; i++) {
-        R_Vx_local.push_back(SharedMatrix(new Matrix("Vx Temp", max_functions, max_functions)));
-        R_Dx_local.push_back(SharedMatrix(new Matrix("Dk Temp", max_functions, max_functions)));
+        R_Vx_local.push_back(SharedMatrix(new Matrix("Vx Temp", max_functions, nbatch * max_functions)));
+        R_Dx_local.push_back(SharedMatrix(new Matrix("Dk Temp", max_functions, nbatch * max_functions)));
+        R_T_local.push_back(SharedMatrix(new Matrix("Tk Temp", max_points, nbatch * max_functions)));
 
         R_rho_k.push_back(std::shared_ptr<Vector>(new Vector("Rho K Temp", max_points)));
 
@@ -717,17 +804,16 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // => Setup <= //
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** Vx_localp = R_Vx_local[rank]->pointer();
-        double** Dx_localp = R_Dx_local[rank]->pointer();
-
-        // => Compute blocks <= //
-        double** Tp = pworker->scratch()[0]->pointer();
+        double* Vx_stack = R_Vx_local[rank]->pointer()[0];
+        double* Dx_stack = R_Dx_local[rank]->pointer()[0];
+        double* T_stack = R_T_local[rank]->pointer()[0];
 
         std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         int npoints = block->npoints();
         double * w = block->w();
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
+        if (!nlocal) continue;
 
         // Compute Rho, Phi, etc
         pworker->compute_points(block);
@@ -769,101 +855,113 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // Meta
         // Forget that!
 
-        // Loop over perturbation tensors
-        for (size_t dindex = 0; dindex < Dx_vec.size(); dindex++) {
-            double** Dxp = Dx_vec[dindex]->pointer();
+        // Loop over batches of perturbation tensors
+        for (size_t dstart = 0; dstart < Dx_vec.size(); dstart += nbatch) {
+            int nd = std::min(nbatch, Dx_vec.size() - dstart);
+            int ld = nd * nlocal;
 
             // => Build Rotated Densities <= //
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < nlocal; nl++) {
-                    int ng = function_map[nl];
-                    Dx_localp[ml][nl] = Dxp[mg][ng];
+            // Symmetrized, D^k_xy + D^k_yx, with density k in columns [k * nlocal, (k + 1) * nlocal)
+            for (int k = 0; k < nd; k++) {
+                double** Dxp = Dx_vec[dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int ng = function_map[nl];
+                        Dx_stack[ml * ld + k * nlocal + nl] = Dxp[mg][ng] + Dxp[ng][mg];
+                    }
                 }
             }
 
-            // Rho_a = D^k_xy phi_xa phi_ya
-            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], max_functions, Dx_localp[0],
-                    max_functions, 0.0, Tp[0], max_functions);
-            C_DGEMM('N', 'T', npoints, nlocal, nlocal, 1.0, phi[0], max_functions, Dx_localp[0],
-                    max_functions, 1.0, Tp[0], max_functions);
+            // T^k_ay = phi_xa (D^k_xy + D^k_yx)
+            C_DGEMM('N', 'N', npoints, ld, nlocal, 1.0, phi[0], max_functions, Dx_stack,
+                    ld, 0.0, T_stack, ld);
 
-            for (int P = 0; P < npoints; P++) {
-                rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tp[P], 1);
-            }
+            for (int k = 0; k < nd; k++) {
+                double* Tk = T_stack + k * nlocal;
 
-            // Rho^d_k and gamma_k
-            if (ansatz >= 1) {
+                // Rho_a = D^k_xy phi_xa phi_ya
                 for (int P = 0; P < npoints; P++) {
-                    rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tp[P], 1);
-                    rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tp[P], 1);
-                    rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tp[P], 1);
-                    gamma_k[P] =  rho_k_x[P] * rho_x[P];
-                    gamma_k[P] += rho_k_y[P] * rho_y[P];
-                    gamma_k[P] += rho_k_z[P] * rho_z[P];
-                    gamma_k[P] *= 2;
+                    rho_k[P] = 0.5 * C_DDOT(nlocal, phi[P], 1, Tk + P * ld, 1);
                 }
-            }
-
-            // => LSDA contribution (symmetrized) <= //
-            for (int P = 0; P < npoints; P++) {
-                ::memset(static_cast<void*>(Tp[P]), '\0', nlocal * sizeof(double));
-                if (rho_a[P] < v2_rho_cutoff_) continue;
-                C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, Tp[P], 1);
-            }
 
-            // => GGA contribution <= //
-            if (ansatz >= 1) {
-                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
-                double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
-                double tmp_val = 0.0, v2_val = 0.0;
+                // Rho^d_k and gamma_k
+                if (ansatz >= 1) {
+                    for (int P = 0; P < npoints; P++) {
+                        rho_k_x[P] = C_DDOT(nlocal, phi_x[P], 1, Tk + P * ld, 1);
+                        rho_k_y[P] = C_DDOT(nlocal, phi_y[P], 1, Tk + P * ld, 1);
+                        rho_k_z[P] = C_DDOT(nlocal, phi_z[P], 1, Tk + P * ld, 1);
+                        gamma_k[P] =  rho_k_x[P] * rho_x[P];
+                        gamma_k[P] += rho_k_y[P] * rho_y[P];
+                        gamma_k[P] += rho_k_z[P] * rho_z[P];
+                        gamma_k[P] *= 2;
+                    }
+                }
 
+                // => LSDA contribution (symmetrized) <= //
                 for (int P = 0; P < npoints; P++) {
+                    ::memset(static_cast<void*>(Tk + P * ld), '\0', nlocal * sizeof(double));
                     if (rho_a[P] < v2_rho_cutoff_) continue;
+                    C_DAXPY(nlocal, 0.5 * v2_rho2[P] * w[P] * rho_k[P], phi[P], 1, Tk + P * ld, 1);
+                }
 
-                    // V contributions
-                    C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1, Tp[P],
-                            1);
+                // => GGA contribution <= //
+                if (ansatz >= 1) {
+                    double* v_gamma = vals["V_GAMMA_AA"]->pointer();
+                    double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
+                    double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
+                    double tmp_val = 0.0, v2_val = 0.0;
 
-                    // W contributions
-                    v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
+                    for (int P = 0; P < npoints; P++) {
+                        if (rho_a[P] < v2_rho_cutoff_) continue;
+
+                        // V contributions
+                        C_DAXPY(nlocal, (0.5 * w[P] * v2_rho_gamma[P] * gamma_k[P]), phi[P], 1,
+                                Tk + P * ld, 1);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tp[P], 1);
+                        // W contributions
+                        v2_val = (v2_rho_gamma[P] * rho_k[P] + v2_gamma_gamma[P] * gamma_k[P]);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tp[P], 1);
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_x[P] + v2_val * rho_x[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_x[P], 1, Tk + P * ld, 1);
 
-                    tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
-                    C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tp[P], 1);
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_y[P] + v2_val * rho_y[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_y[P], 1, Tk + P * ld, 1);
+
+                        tmp_val = 2.0 * w[P] * (v_gamma[P] * rho_k_z[P] + v2_val * rho_z[P]);
+                        C_DAXPY(nlocal, tmp_val, phi_z[P], 1, Tk + P * ld, 1);
+                    }
                 }
             }
 
             // Put it all together
-            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], max_functions, Tp[0],
-                    max_functions, 0.0, Vx_localp[0], max_functions);
+            C_DGEMM('T', 'N', nlocal, ld, npoints, 1.0, phi[0], max_functions, T_stack,
+                    ld, 0.0, Vx_stack, ld);
 
-            // Symmetrization (V is *always* Hermitian)
-            for (int m = 0; m < nlocal; m++) {
-                for (int n = 0; n <= m; n++) {
-                    Vx_localp[m][n] = Vx_localp[n][m] = Vx_localp[m][n] + Vx_localp[n][m];
+            for (int k = 0; k < nd; k++) {
+                double* Vk = Vx_stack + k * nlocal;
+
+                // Symmetrization (V is *always* Hermitian)
+                for (int m = 0; m < nlocal; m++) {
+                    for (int n = 0; n <= m; n++) {
+                        Vk[m * ld + n] = Vk[n * ld + m] = Vk[m * ld + n] + Vk[n * ld + m];
+                    }
                 }
-            }
 
-            // => Unpacking <= //
-            double** Vxp = Vx_AO[dindex]->pointer();
-            for (int ml = 0; ml < nlocal; ml++) {
-                int mg = function_map[ml];
-                for (int nl = 0; nl < ml; nl++) {
-                    int ng = function_map[nl];
-                    #pragma omp atomic update
-                    Vxp[mg][ng] += Vx_localp[ml][nl];
+                // => Unpacking <= //
+                double** Vxp = Vx_AO[dstart + k]->pointer();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int nl = 0; nl < ml; nl++) {
+                        int ng = function_map[nl];
+                        #pragma omp atomic update
+                        Vxp[mg][ng] += Vk[ml * ld + nl];
+                        #pragma omp atomic update
+                        Vxp[ng][mg] += Vk[ml * ld + nl];
+                    }
                     #pragma omp atomic update
-                    Vxp[ng][mg] += Vx_localp[ml][nl];
+                    Vxp[mg][mg] += Vk[ml * ld + ml];
                 }
-                #pragma omp atomic update
-                Vxp[mg][mg] += Vx_localp[ml][ml];
             }
         }
     }
@@ -1031,42 +1129,25 @@ SharedMatrix RV::compute_gradient()
 
             C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dp[0],max_functions,0.0,Up[0],max_functions);
 
-            // x
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*) Tp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ax[P]), Up[P], 1, Tp[P], 1);
-            }
-            for (int ml = 0; ml < nlocal; ml++) {
-                int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_xx[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_xy[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_xz[0][ml],max_functions);
-            }
-
-            // y
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*) Tp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ay[P]), Up[P], 1, Tp[P], 1);
-            }
-            for (int ml = 0; ml < nlocal; ml++) {
-                int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_xy[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_yy[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-            }
-
-            // z
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*) Tp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_az[P]), Up[P], 1, Tp[P], 1);
-            }
+            // All three directions in one pass over the points of each function
             for (int ml = 0; ml < nlocal; ml++) {
                 int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_xz[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_zz[0][ml],max_functions);
+                double gx = 0.0;
+                double gy = 0.0;
+                double gz = 0.0;
+                for (int P = 0; P < npoints; P++) {
+                    double u = -2.0 * w[P] * (2.0 * v_gamma_aa[P]) * Up[P][ml];
+                    double cx = u * rho_ax[P];
+                    double cy = u * rho_ay[P];
+                    double cz = u * rho_az[P];
+                    gx += cx * phi_xx[P][ml] + cy * phi_xy[P][ml] + cz * phi_xz[P][ml];
+                    gy += cx * phi_xy[P][ml] + cy * phi_yy[P][ml] + cz * phi_yz[P][ml];
+                    gz += cx * phi_xz[P][ml] + cy * phi_yz[P][ml] + cz * phi_zz[P][ml];
+                }
+                Gp[A][0] += gx;
+                Gp[A][1] += gy;
+                Gp[A][2] += gz;
             }
-
         }
 
         // => Meta Contribution <= //
@@ -1153,8 +1234,8 @@ SharedMatrix RV::compute_gradient()
 
 SharedMatrix RV::compute_hessian()
 {
-    if(functional_->is_gga() || functional_->is_meta())
-        throw PSIEXCEPTION("Hessians for GGA and meta GGA functionals are not yet implemented.");
+    if (functional_->is_meta())
+        throw PSIEXCEPTION("Hessians for meta GGA functionals are not yet implemented.");
 
     if ((D_AO_.size() != 1))
         throw PSIEXCEPTION("V: RKS should have only one D Matrix");
@@ -1166,7 +1247,6 @@ SharedMatrix RV::compute_hessian()
     // Build the target Hessian Matrix
     int natom = primary_->molecule()->natom();
     SharedMatrix H(new Matrix("XC Hessian", 3*natom,3*natom));
-    double** Hp = H->pointer();
 
     // Thread info
     int rank = 0;
@@ -1177,31 +1257,35 @@ SharedMatrix RV::compute_hessian()
 
     // How many functions are there (for lda in Vtemp, T)
     int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
 
-    int derivlev = (functional_->is_gga() || functional_->is_meta()) ? 3 : 2;
-    functional_->set_deriv(derivlev);
+    // The GGA terms differentiate the density gradient twice, so need one more order of basis derivatives
+    bool gga = functional_->is_gga();
+    int basis_deriv = (gga ? 3 : 2);
+    functional_->set_deriv(2);
 
     // Setup the pointers
     for (size_t i = 0; i < num_threads_; i++){
         point_workers_[i]->set_pointers(D_AO_[0]);
-        point_workers_[i]->set_deriv(derivlev);
-        functional_workers_[i]->set_deriv(derivlev);
+        point_workers_[i]->set_deriv(basis_deriv);
+        functional_workers_[i]->set_deriv(2);
         functional_workers_[i]->allocate();
     }
 
     // Per thread temporaries
-    std::vector<SharedMatrix> V_local;
-    std::vector<std::shared_ptr<Vector>> Q_temp;
+    std::vector<SharedMatrix> H_local;
     for (size_t i = 0; i < num_threads_; i++){
-        V_local.push_back(SharedMatrix(new Matrix("V Temp", max_functions, max_functions)));
-        Q_temp.push_back(std::shared_ptr<Vector>(new Vector("Quadrature Tempt", max_points)));
+        H_local.push_back(SharedMatrix(new Matrix("H Temp", 3*natom, 3*natom)));
     }
 
-    std::shared_ptr<Vector> QT(new Vector("Quadrature Temp", max_points));
-    double* QTp = QT->pointer();
     const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
 
+    // Third derivative keys, by sorted index triple
+    static const char* third_keys[3][3][3] = {
+        {{"PHI_XXX", "PHI_XXY", "PHI_XXZ"}, {"PHI_XXY", "PHI_XYY", "PHI_XYZ"}, {"PHI_XXZ", "PHI_XYZ", "PHI_XZZ"}},
+        {{"PHI_XXY", "PHI_XYY", "PHI_XYZ"}, {"PHI_XYY", "PHI_YYY", "PHI_YYZ"}, {"PHI_XYZ", "PHI_YYZ", "PHI_YZZ"}},
+        {{"PHI_XXZ", "PHI_XYZ", "PHI_XZZ"}, {"PHI_XYZ", "PHI_YYZ", "PHI_YZZ"}, {"PHI_XZZ", "PHI_YZZ", "PHI_ZZZ"}}};
+
+    #pragma omp parallel for private (rank) schedule(dynamic) num_threads(num_threads_)
     for (size_t Q = 0; Q < blocks.size(); Q++) {
 
         // Get thread info
@@ -1211,184 +1295,268 @@ SharedMatrix RV::compute_hessian()
 
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** V2p = V_local[rank]->pointer();
-        double* QTp = Q_temp[rank]->pointer();
+        double** Hp = H_local[rank]->pointer();
         double** Dp = pworker->D_scratch()[0]->pointer();
 
-        // Scratch
-        double** Tp = pworker->scratch()[0]->pointer();
-        SharedMatrix U_local(pworker->scratch()[0]->clone());
-        double** Up = U_local->pointer();
-
-        // ACS TODO: these need to be threaded eventually, to fit in with the new infrastructure
-        SharedVector Tmpx(new Vector("Tx", max_functions));
-        SharedVector Tmpy(new Vector("Ty", max_functions));
-        SharedVector Tmpz(new Vector("Tz", max_functions));
-        double *pTx = Tmpx->pointer();
-        double *pTy = Tmpy->pointer();
-        double *pTz = Tmpz->pointer();
-        SharedMatrix Tx(U_local->clone());
-        SharedMatrix Ty(U_local->clone());
-        SharedMatrix Tz(U_local->clone());
-        double **pTx2 = Tx->pointer();
-        double **pTy2 = Ty->pointer();
-        double **pTz2 = Tz->pointer();
-
         std::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
-        double* x = block->x();
-        double* y = block->y();
-        double* z = block->z();
         double* w = block->w();
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
+        if (nlocal == 0) continue;
 
         pworker->compute_points(block);
         std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
 
-        double** phi    = pworker->basis_value("PHI")->pointer();
-        double** phi_x  = pworker->basis_value("PHI_X")->pointer();
-        double** phi_y  = pworker->basis_value("PHI_Y")->pointer();
-        double** phi_z  = pworker->basis_value("PHI_Z")->pointer();
-        double** phi_xx = pworker->basis_value("PHI_XX")->pointer();
-        double** phi_xy = pworker->basis_value("PHI_XY")->pointer();
-        double** phi_xz = pworker->basis_value("PHI_XZ")->pointer();
-        double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
-        double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
-        double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-        double* v_rho_a  = vals["V_RHO_A"]->pointer();
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_i[3];
+        phi_i[0] = pworker->basis_value("PHI_X")->pointer();
+        phi_i[1] = pworker->basis_value("PHI_Y")->pointer();
+        phi_i[2] = pworker->basis_value("PHI_Z")->pointer();
+        double** phi_ij[3][3];
+        phi_ij[0][0] = pworker->basis_value("PHI_XX")->pointer();
+        phi_ij[0][1] = phi_ij[1][0] = pworker->basis_value("PHI_XY")->pointer();
+        phi_ij[0][2] = phi_ij[2][0] = pworker->basis_value("PHI_XZ")->pointer();
+        phi_ij[1][1] = pworker->basis_value("PHI_YY")->pointer();
+        phi_ij[1][2] = phi_ij[2][1] = pworker->basis_value("PHI_YZ")->pointer();
+        phi_ij[2][2] = pworker->basis_value("PHI_ZZ")->pointer();
+        double** phi_ijk[3][3][3];
+        if (gga) {
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    for (int k = 0; k < 3; k++) {
+                        phi_ijk[i][j][k] = pworker->basis_value(third_keys[i][j][k])->pointer();
+                    }
+                }
+            }
+        }
+
+        double* rho_a = pworker->point_value("RHO_A")->pointer();
+        double* v_rho_a = vals["V_RHO_A"]->pointer();
         double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
 
+        // Filter out small densities
+        std::vector<double> wP(npoints);
         for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
+            wP[P] = (std::fabs(rho_a[P]) < 1E-8 ? 0.0 : w[P]);
         }
 
+        // => Atoms of the block <= //
 
-        // => LSDA Contribution <= //
-
+        // Nuclear derivative columns below are 3 * (atom of the block) + i
+        std::vector<int> atoms;
+        std::vector<int> function_atom(nlocal);
+        for (int ml = 0; ml < nlocal; ml++) {
+            int A = primary_->function_to_center(function_map[ml]);
+            size_t a = std::find(atoms.begin(), atoms.end(), A) - atoms.begin();
+            if (a == atoms.size()) atoms.push_back(A);
+            function_atom[ml] = 3 * a;
+        }
+        int nc = 3 * atoms.size();
+
+        // T = ɸ D and, for GGA, T_k = ɸ_k D
+        SharedMatrix T(new Matrix("T", npoints, nlocal));
+        double** Tp = T->pointer();
+        C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dp[0],max_functions,0.0,Tp[0],nlocal);
+        std::vector<SharedMatrix> Tk;
+        double** Tkp[3];
+        if (gga) {
+            for (int k = 0; k < 3; k++) {
+                Tk.push_back(SharedMatrix(new Matrix("T_k", npoints, nlocal)));
+                Tkp[k] = Tk[k]->pointer();
+                C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_i[k][0],max_functions,Dp[0],max_functions,0.0,Tkp[k][0],nlocal);
+            }
+        }
 
         /*
-         *                        m             n  ∂^2 F
-         *  H_mn <- 4 D_ab ɸ_a ɸ_b  D_cd ɸ_c ɸ_d   ------
-         *                                         ∂ ρ^2
+         * First nuclear derivatives of the density variables
+         *
+         *   ρ^Ai   = -4 ɸ^i_a D_ab ɸ_b
+         *   ρ_k^Ai = -4 (ɸ^ik_a D_ab ɸ_b + ɸ^i_a D_ab ɸ^k_b)
+         *   γ^Ai   =  2 ρ_k ρ_k^Ai
          */
-
-        // T = ɸ D
-        C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi[0],max_functions,Dp[0],max_functions,0.0,Tp[0],max_functions);
-
-
-        // Compute rho, to filter out small values
-        for (int P = 0; P < npoints; P++) {
-            double rho = C_DDOT(nlocal,phi[P],1,Tp[P],1);
-            if(std::fabs(rho) < 1E-8){
-                v_rho_a[P] = 0.0;
-                v_rho_aa[P] = 0.0;
+        SharedMatrix R(new Matrix("Rho^A", npoints, nc));
+        double** Rp = R->pointer();
+        std::vector<SharedMatrix> G;
+        double** Gp[3];
+        if (gga) {
+            for (int k = 0; k < 3; k++) {
+                G.push_back(SharedMatrix(new Matrix("Rho_k^A", npoints, nc)));
+                Gp[k] = G[k]->pointer();
             }
-//            outfile->Printf("%f %f %f\n", w[P], v_rho_a[P], v_rho_aa[P]);
         }
-
         for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
-        }
-
-        for (int ml = 0; ml < nlocal; ml++) {
-            pTx[ml] = C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_x[0][ml],max_functions);
-            pTy[ml] = C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_y[0][ml],max_functions);
-            pTz[ml] = C_DDOT(npoints,&Tp[0][ml],max_functions,&phi_z[0][ml],max_functions);
-        }
-
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double mx = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_x[0][ml],max_functions);
-            double my = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_y[0][ml],max_functions);
-            double mz = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_z[0][ml],max_functions);
-            for (int nl = 0; nl < nlocal; nl++) {
-                int B = primary_->function_to_center(function_map[nl]);
-                Hp[3*A+0][3*B+0] += mx*pTx[nl];
-                Hp[3*A+0][3*B+1] += mx*pTy[nl];
-                Hp[3*A+0][3*B+2] += mx*pTz[nl];
-                Hp[3*A+1][3*B+0] += my*pTx[nl];
-                Hp[3*A+1][3*B+1] += my*pTy[nl];
-                Hp[3*A+1][3*B+2] += my*pTz[nl];
-                Hp[3*A+2][3*B+0] += mz*pTx[nl];
-                Hp[3*A+2][3*B+1] += mz*pTy[nl];
-                Hp[3*A+2][3*B+2] += mz*pTz[nl];
+            for (int ml = 0; ml < nlocal; ml++) {
+                int a = function_atom[ml];
+                double t = Tp[P][ml];
+                for (int i = 0; i < 3; i++) {
+                    Rp[P][a + i] -= 4.0 * phi_i[i][P][ml] * t;
+                }
+                if (!gga) continue;
+                for (int k = 0; k < 3; k++) {
+                    double tk = Tkp[k][P][ml];
+                    for (int i = 0; i < 3; i++) {
+                        Gp[k][P][a + i] -= 4.0 * (phi_ij[i][k][P][ml] * t + phi_i[i][P][ml] * tk);
+                    }
+                }
             }
         }
 
+        // => Products of first derivatives <= //
+
         /*
-         *                        mn  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a ɸ_b    ---
-         *                            ∂ ρ
+         *            ∂^2 F               ∂^2 F                         ∂^2 F             ∂ F
+         *  H <- ρ^A ------ ρ^B + (ρ^A ------- γ^B + γ^A ρ^B) + γ^A ------- γ^B + 2 ---  ρ_k^A ρ_k^B
+         *           ∂ ρ^2               ∂ρ ∂γ                         ∂ γ^2             ∂ γ
          */
-        for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], Tp[P], 1, Up[P], 1);
+        SharedMatrix Hc(new Matrix("H Block", nc, nc));
+        double** Hcp = Hc->pointer();
+        SharedMatrix Rw(R->clone());
+        double** Rwp = Rw->pointer();
+        double* rho_k[3];
+        double* v_gamma_aa = nullptr;
+        if (!gga) {
+            for (int P = 0; P < npoints; P++) {
+                C_DSCAL(nc, wP[P] * v_rho_aa[P], Rwp[P], 1);
+            }
+            C_DGEMM('T','N',nc,nc,npoints,1.0,Rp[0],nc,Rwp[0],nc,0.0,Hcp[0],nc);
+        } else {
+            rho_k[0] = pworker->point_value("RHO_AX")->pointer();
+            rho_k[1] = pworker->point_value("RHO_AY")->pointer();
+            rho_k[2] = pworker->point_value("RHO_AZ")->pointer();
+            v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
+            double* v_rho_a_gamma_aa = vals["V_RHO_A_GAMMA_AA"]->pointer();
+            double* v_gamma_aa_gamma_aa = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
+
+            SharedMatrix S(new Matrix("Gamma^A", npoints, nc));
+            double** Sp = S->pointer();
+            for (int P = 0; P < npoints; P++) {
+                for (int k = 0; k < 3; k++) {
+                    C_DAXPY(nc, 2.0 * rho_k[k][P], Gp[k][P], 1, Sp[P], 1);
+                }
+            }
+
+            SharedMatrix Sw(S->clone());
+            double** Swp = Sw->pointer();
+            for (int P = 0; P < npoints; P++) {
+                C_DSCAL(nc, wP[P] * v_rho_aa[P], Rwp[P], 1);
+                C_DAXPY(nc, wP[P] * v_rho_a_gamma_aa[P], Sp[P], 1, Rwp[P], 1);
+                C_DSCAL(nc, wP[P] * v_gamma_aa_gamma_aa[P], Swp[P], 1);
+                C_DAXPY(nc, wP[P] * v_rho_a_gamma_aa[P], Rp[P], 1, Swp[P], 1);
+            }
+            C_DGEMM('T','N',nc,nc,npoints,1.0,Rp[0],nc,Rwp[0],nc,0.0,Hcp[0],nc);
+            C_DGEMM('T','N',nc,nc,npoints,1.0,Sp[0],nc,Swp[0],nc,1.0,Hcp[0],nc);
+
+            for (int k = 0; k < 3; k++) {
+                for (int P = 0; P < npoints; P++) {
+                    C_DCOPY(nc, Gp[k][P], 1, Swp[P], 1);
+                    C_DSCAL(nc, 2.0 * wP[P] * v_gamma_aa[P], Swp[P], 1);
+                }
+                C_DGEMM('T','N',nc,nc,npoints,1.0,Gp[k][0],nc,Swp[0],nc,1.0,Hcp[0],nc);
+            }
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double Txx = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_xx[0][ml],max_functions);
-            double Txy = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_xy[0][ml],max_functions);
-            double Txz = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_xz[0][ml],max_functions);
-            double Tyy = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_yy[0][ml],max_functions);
-            double Tyz = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-            double Tzz = C_DDOT(npoints,&Up[0][ml],max_functions,&phi_zz[0][ml],max_functions);
-            Hp[3*A+0][3*A+0] += Txx;
-            Hp[3*A+0][3*A+1] += Txy;
-            Hp[3*A+0][3*A+2] += Txz;
-            Hp[3*A+1][3*A+0] += Txy;
-            Hp[3*A+1][3*A+1] += Tyy;
-            Hp[3*A+1][3*A+2] += Tyz;
-            Hp[3*A+2][3*A+0] += Txz;
-            Hp[3*A+2][3*A+1] += Tyz;
-            Hp[3*A+2][3*A+2] += Tzz;
+        for (size_t a = 0; a < atoms.size(); a++) {
+            for (size_t b = 0; b < atoms.size(); b++) {
+                for (int i = 0; i < 3; i++) {
+                    for (int j = 0; j < 3; j++) {
+                        Hp[3 * atoms[a] + i][3 * atoms[b] + j] += Hcp[3 * a + i][3 * b + j];
+                    }
+                }
+            }
         }
 
+        // => Second derivatives of the density variables <= //
+
         /*
-         *                    m    n  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a  ɸ_b   ---
-         *                            ∂ ρ
+         *         ∂ F                  ∂ F
+         *  H <-  ---  ρ^AB  +  2 ρ_k  ---  ρ_k^AB
+         *        ∂ ρ                   ∂ γ
+         *
+         *   ρ^AB   = 4 (δ_AB ɸ^ij_a D_ab ɸ_b + ɸ^i_a D_ab ɸ^j_b)
+         *   ρ_k^AB = 4 (δ_AB (ɸ^ijk_a D_ab ɸ_b + ɸ^ij_a D_ab ɸ^k_b) + ɸ^ik_a D_ab ɸ^j_b + ɸ^i_a D_ab ɸ^jk_b)
          */
-        // T = ɸ_x D
-        C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_x[0],max_functions,Dp[0],max_functions,0.0,pTx2[0],max_functions);
-        C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_y[0],max_functions,Dp[0],max_functions,0.0,pTy2[0],max_functions);
-        C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_z[0],max_functions,Dp[0],max_functions,0.0,pTz2[0],max_functions);
-        // x derivatives
+        std::vector<double> vr(npoints);
+        std::vector<std::vector<double> > vg(3, std::vector<double>(npoints, 0.0));
         for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTx2[P], 1, Up[P], 1);
-        }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3*A+0][3*A+0] += C_DDOT(npoints,&pTx2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+0][3*A+1] += C_DDOT(npoints,&pTy2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+0][3*A+2] += C_DDOT(npoints,&pTz2[0][ml],max_functions,&Up[0][ml],max_functions);;
+            vr[P] = wP[P] * v_rho_a[P];
+            if (!gga) continue;
+            for (int k = 0; k < 3; k++) {
+                vg[k][P] = 2.0 * wP[P] * v_gamma_aa[P] * rho_k[k][P];
+            }
         }
-        // y derivatives
+
+        // Same atom: W = vr T + vg_k T_k against ɸ^ij, and vg_k T against ɸ^ijk
+        SharedMatrix W(T->clone());
+        double** Wp = W->pointer();
         for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTy2[P], 1, Up[P], 1);
+            C_DSCAL(nlocal, vr[P], Wp[P], 1);
+            if (!gga) continue;
+            for (int k = 0; k < 3; k++) {
+                C_DAXPY(nlocal, vg[k][P], Tkp[k][P], 1, Wp[P], 1);
+            }
         }
         for (int ml = 0; ml < nlocal; ml++) {
             int A = primary_->function_to_center(function_map[ml]);
-            Hp[3*A+1][3*A+0] += C_DDOT(npoints,&pTx2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+1][3*A+1] += C_DDOT(npoints,&pTy2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+1][3*A+2] += C_DDOT(npoints,&pTz2[0][ml],max_functions,&Up[0][ml],max_functions);;
+            for (int i = 0; i < 3; i++) {
+                for (int j = i; j < 3; j++) {
+                    double val = C_DDOT(npoints,&phi_ij[i][j][0][ml],max_functions,&Wp[0][ml],nlocal);
+                    if (gga) {
+                        for (int P = 0; P < npoints; P++) {
+                            val += Tp[P][ml] * (vg[0][P] * phi_ijk[i][j][0][P][ml] +
+                                                vg[1][P] * phi_ijk[i][j][1][P][ml] +
+                                                vg[2][P] * phi_ijk[i][j][2][P][ml]);
+                        }
+                    }
+                    Hp[3*A+i][3*A+j] += 4.0 * val;
+                    if (i != j) Hp[3*A+j][3*A+i] += 4.0 * val;
+                }
+            }
         }
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            ::memset((void*) Up[P], '\0', sizeof(double) * nlocal);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTz2[P], 1, Up[P], 1);
+
+        // Function pairs: M^ij = Y_i^T ɸ_j + ɸ_i^T Z_j, with Y_i = vr ɸ_i + vg_k ɸ_ik and Z_j = vg_k ɸ_jk
+        std::vector<SharedMatrix> Y, Z;
+        double** Yp[3];
+        double** Zp[3];
+        for (int i = 0; i < 3; i++) {
+            Y.push_back(SharedMatrix(new Matrix("Y", npoints, nlocal)));
+            Yp[i] = Y[i]->pointer();
+            for (int P = 0; P < npoints; P++) {
+                C_DAXPY(nlocal, vr[P], phi_i[i][P], 1, Yp[i][P], 1);
+            }
+            if (!gga) continue;
+            Z.push_back(SharedMatrix(new Matrix("Z", npoints, nlocal)));
+            Zp[i] = Z[i]->pointer();
+            for (int P = 0; P < npoints; P++) {
+                for (int k = 0; k < 3; k++) {
+                    C_DAXPY(nlocal, vg[k][P], phi_ij[i][k][P], 1, Zp[i][P], 1);
+                }
+            }
+            for (int P = 0; P < npoints; P++) {
+                C_DAXPY(nlocal, 1.0, Zp[i][P], 1, Yp[i][P], 1);
+            }
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3*A+2][3*A+0] += C_DDOT(npoints,&pTx2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+2][3*A+1] += C_DDOT(npoints,&pTy2[0][ml],max_functions,&Up[0][ml],max_functions);;
-            Hp[3*A+2][3*A+2] += C_DDOT(npoints,&pTz2[0][ml],max_functions,&Up[0][ml],max_functions);;
+
+        SharedMatrix M(new Matrix("M", nlocal, nlocal));
+        double** Mp = M->pointer();
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,Yp[i][0],nlocal,phi_i[j][0],max_functions,0.0,Mp[0],nlocal);
+                if (gga) {
+                    C_DGEMM('T','N',nlocal,nlocal,npoints,1.0,phi_i[i][0],max_functions,Zp[j][0],nlocal,1.0,Mp[0],nlocal);
+                }
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int A = primary_->function_to_center(function_map[ml]);
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int B = primary_->function_to_center(function_map[nl]);
+                        Hp[3*A+i][3*B+j] += 4.0 * Dp[ml][nl] * Mp[ml][nl];
+                    }
+                }
+            }
         }
+    }
 
+    for (auto const &val: H_local){
+        H->add(val);
     }
 
     if (debug_) {
@@ -1402,11 +1570,12 @@ SharedMatrix RV::compute_hessian()
 
     for (size_t i = 0; i < num_threads_; i++){
         point_workers_[i]->set_deriv(old_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
     }
     functional_->set_deriv(old_func_deriv);
 
-    // RKS
-    H->scale(2.0);
+    // The terms above are the full RKS derivatives of the total density, no spin factor left
     H->hermitivitize();
 
     return H;
@@ -1420,6 +1589,10 @@ void UV::initialize() {
     VBase::initialize();
     int max_points = grid_->max_points();
     int max_functions = grid_->max_functions();
+    if (sym_grid_) {
+        max_points = std::max(max_points, sym_grid_->max_points());
+        max_functions = std::max(max_functions, sym_grid_->max_functions());
+    }
     for (size_t i = 0; i < num_threads_; i++) {
         // Need a points worker per thread
         std::shared_ptr<PointFunctions> point_tmp =
@@ -1453,20 +1626,20 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
     int ansatz = functional_->ansatz();
 
     // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
+    std::shared_ptr<DFTGrid> grid = potential_grid();
+    int max_functions = grid->max_functions();
+    int max_points = grid->max_points();
 
     // Setup the pointers
     for (size_t i = 0; i < num_threads_; i++){
         point_workers_[i]->set_pointers(D_AO_[0], D_AO_[1]);
     }
 
-    // Per thread temporaries
-    std::vector<SharedMatrix> Va_local, Vb_local;
+    // Per thread temporaries, Va and Vb side by side as [nlocal][2 * max_functions]
+    std::vector<SharedMatrix> V_local;
     std::vector<std::shared_ptr<Vector>> Qa_temp, Qb_temp;
     for (size_t i = 0; i < num_threads_; i++){
-        Va_local.push_back(SharedMatrix(new Matrix("Va Temp", max_functions, max_functions)));
-        Vb_local.push_back(SharedMatrix(new Matrix("Vb Temp", max_functions, max_functions)));
+        V_local.push_back(SharedMatrix(new Matrix("V Temp", max_functions, 2 * max_functions)));
         Qa_temp.push_back(std::shared_ptr<Vector>(new Vector("Quadrature A Temp", max_points)));
         Qb_temp.push_back(std::shared_ptr<Vector>(new Vector("Quadrature B Temp", max_points)));
     }
@@ -1487,7 +1660,7 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
     std::vector<double> rhobzq(num_threads_);
 
     // Loop over grid
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+    for (size_t Q = 0; Q < grid->blocks().size(); Q++) {
 
         // Get thread info
         #ifdef _OPENMP
@@ -1496,28 +1669,29 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
 
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** Va2p = Va_local[rank]->pointer();
-        double** Vb2p = Vb_local[rank]->pointer();
+        double** V2p = V_local[rank]->pointer();
         double* QTap = Qa_temp[rank]->pointer();
         double* QTbp = Qb_temp[rank]->pointer();
 
-        // Scratch
-        double** Tap = pworker->scratch()[0]->pointer();
-        double** Tbp = pworker->scratch()[1]->pointer();
+        // Scratch, Ta and Tb side by side like V2p
+        double** Tp = pworker->scratch()[2]->pointer();
 
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
+        std::shared_ptr<BlockOPoints> block = grid->blocks()[Q];
         int npoints = block->npoints();
         double* x = block->x();
         double* y = block->y();
         double* z = block->z();
         double* w = block->w();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
 
+        // Compute Rho, Phi, etc, only over the functions significant on this block
         // timer_on("V: Properties");
-        pworker->compute_points(block);
+        pworker->compute_points(block, true);
         // timer_off("V: Properties");
 
+        const std::vector<int>& function_map = pworker->function_map();
+        int nlocal = function_map.size();
+        int ld = 2 * max_functions;
+
         // timer_on("V: Functional");
         std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
         // timer_off("V: Functional");
@@ -1553,10 +1727,9 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
         // => LSDA contribution (symmetrized) <= //
         // timer_on("V: LSDA");
         for (int P = 0; P < npoints; P++) {
-            ::memset(static_cast<void*>(Tap[P]), '\0', nlocal * sizeof(double));
-            ::memset(static_cast<void*>(Tbp[P]), '\0', nlocal * sizeof(double));
-            C_DAXPY(nlocal, 0.5 * v_rho_a[P] * w[P], phi[P], 1, Tap[P], 1);
-            C_DAXPY(nlocal, 0.5 * v_rho_b[P] * w[P], phi[P], 1, Tbp[P], 1);
+            ::memset(static_cast<void*>(Tp[P]), '\0', 2 * nlocal * sizeof(double));
+            C_DAXPY(nlocal, 0.5 * v_rho_a[P] * w[P], phi[P], 1, Tp[P], 1);
+            C_DAXPY(nlocal, 0.5 * v_rho_b[P] * w[P], phi[P], 1, Tp[P] + nlocal, 1);
         }
         // timer_off("V: LSDA");
 
@@ -1577,28 +1750,28 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
             double * v_sigma_bb = vals["V_GAMMA_BB"]->pointer();
 
             for (int P = 0; P < npoints; P++) {
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ay[P] + v_sigma_ab[P] * rho_by[P]), phiy[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_az[P] + v_sigma_ab[P] * rho_bz[P]), phiz[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_bx[P] + v_sigma_ab[P] * rho_ax[P]), phix[P], 1, Tbp[P], 1);
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_by[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1, Tbp[P], 1);
-                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_bz[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1, Tbp[P], 1);
+                double* Tap = Tp[P];
+                double* Tbp = Tp[P] + nlocal;
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1, Tap, 1);
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_ay[P] + v_sigma_ab[P] * rho_by[P]), phiy[P], 1, Tap, 1);
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_aa[P] * rho_az[P] + v_sigma_ab[P] * rho_bz[P]), phiz[P], 1, Tap, 1);
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_bx[P] + v_sigma_ab[P] * rho_ax[P]), phix[P], 1, Tbp, 1);
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_by[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1, Tbp, 1);
+                C_DAXPY(nlocal,w[P] * (2.0 * v_sigma_bb[P] * rho_bz[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1, Tbp, 1);
             }
             // timer_off("V: GGA");
         }
 
         // timer_on("V: LSDA");
-        // Single GEMM slams GGA+LSDA together (man but GEM's hot!)
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], max_functions, Tap[0],
-                max_functions, 0.0, Va2p[0], max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], max_functions, Tbp[0],
-                max_functions, 0.0, Vb2p[0], max_functions);
+        // Single GEMM slams GGA+LSDA and both spins together
+        C_DGEMM('T', 'N', nlocal, 2 * nlocal, npoints, 1.0, phi[0], max_functions, Tp[0],
+                ld, 0.0, V2p[0], ld);
 
         // Symmetrization (V is Hermitian)
         for (int m = 0; m < nlocal; m++) {
             for (int n = 0; n <= m; n++) {
-                Va2p[m][n] = Va2p[n][m] = Va2p[m][n] + Va2p[n][m];
-                Vb2p[m][n] = Vb2p[n][m] = Vb2p[m][n] + Vb2p[n][m];
+                V2p[m][n] = V2p[n][m] = V2p[m][n] + V2p[n][m];
+                V2p[m][nlocal + n] = V2p[n][nlocal + m] = V2p[m][nlocal + n] + V2p[n][nlocal + m];
             }
         }
         // timer_off("V: LSDA");
@@ -1617,26 +1790,15 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
             phi[1] = phiy;
             phi[2] = phiz;
 
-            double* v_tau[2];
-            v_tau[0] = v_tau_a;
-            v_tau[1] = v_tau_b;
-
-            double** V_val[2];
-            V_val[0] = Va2p;
-            V_val[1] = Vb2p;
-
-            for (int s = 0; s < 2; s++) {
-                double** V2p = V_val[s];
-                double* v_taup = v_tau[s];
-                for (int i = 0; i < 3; i++) {
-                    double** phiw = phi[i];
-                    for (int P = 0; P < npoints; P++) {
-                        ::memset(static_cast<void*>(Tap[P]), '\0', nlocal * sizeof(double));
-                        C_DAXPY(nlocal, v_taup[P] * w[P], phiw[P], 1, Tap[P], 1);
-                    }
-                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phiw[0], max_functions, Tap[0],
-                            max_functions, 1.0, V2p[0], max_functions);
+            for (int i = 0; i < 3; i++) {
+                double** phiw = phi[i];
+                for (int P = 0; P < npoints; P++) {
+                    ::memset(static_cast<void*>(Tp[P]), '\0', 2 * nlocal * sizeof(double));
+                    C_DAXPY(nlocal, v_tau_a[P] * w[P], phiw[P], 1, Tp[P], 1);
+                    C_DAXPY(nlocal, v_tau_b[P] * w[P], phiw[P], 1, Tp[P] + nlocal, 1);
                 }
+                C_DGEMM('T', 'N', nlocal, 2 * nlocal, npoints, 1.0, phiw[0], max_functions, Tp[0],
+                        ld, 1.0, V2p[0], ld);
             }
 
             // timer_off("V: Meta");
@@ -1648,18 +1810,18 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
             for (int nl = 0; nl < ml; nl++) {
                 int ng = function_map[nl];
                 # pragma omp atomic update
-                Vap[mg][ng] += Va2p[ml][nl];
+                Vap[mg][ng] += V2p[ml][nl];
                 # pragma omp atomic update
-                Vap[ng][mg] += Va2p[ml][nl];
+                Vap[ng][mg] += V2p[ml][nl];
                 # pragma omp atomic update
-                Vbp[mg][ng] += Vb2p[ml][nl];
+                Vbp[mg][ng] += V2p[ml][nlocal + nl];
                 # pragma omp atomic update
-                Vbp[ng][mg] += Vb2p[ml][nl];
+                Vbp[ng][mg] += V2p[ml][nlocal + nl];
             }
             # pragma omp atomic update
-            Vap[mg][mg] += Va2p[ml][ml];
+            Vap[mg][mg] += V2p[ml][ml];
             # pragma omp atomic update
-            Vbp[mg][mg] += Vb2p[ml][ml];
+            Vbp[mg][mg] += V2p[ml][nlocal + ml];
         }
         // timer_off("V: V_XC");
     }
@@ -1682,6 +1844,7 @@ void UV::compute_V(std::vector<SharedMatrix> ret)
     quad_values_["RHO_BX"]     = std::accumulate(rhobxq.begin(), rhobxq.end(), 0.0);
     quad_values_["RHO_BY"]     = std::accumulate(rhobyq.begin(), rhobyq.end(), 0.0);
     quad_values_["RHO_BZ"]     = std::accumulate(rhobzq.begin(), rhobzq.end(), 0.0);
+    if (grid->symmetry_unique()) zero_asymmetric_moments();
 
     if (debug_) {
         outfile->Printf("   => Numerical Integrals <=\n\n");
@@ -2177,8 +2340,6 @@ SharedMatrix UV::compute_gradient()
 
     // Build the target gradient Matrix
     int natom = primary_->molecule()->natom();
-    SharedMatrix G(new Matrix("XC Gradient", natom,3));
-    double** Gp = G->pointer();
 
     // What local XC ansatz are we in?
     int ansatz = functional_->ansatz();
@@ -2197,8 +2358,10 @@ SharedMatrix UV::compute_gradient()
     }
 
     // Thread scratch
+    std::vector<SharedMatrix> G_local;
     std::vector<std::shared_ptr<Vector>> Q_temp;
     for (size_t i = 0; i < num_threads_; i++){
+        G_local.push_back(SharedMatrix(new Matrix("G Temp", natom, 3)));
         Q_temp.push_back(std::shared_ptr<Vector>(new Vector("Quadrature Temp", max_points)));
     }
 
@@ -2213,7 +2376,8 @@ SharedMatrix UV::compute_gradient()
     std::vector<double> rhobzq(num_threads_);
 
 
-    // timer_off("V: V_XC");
+    // Traverse the blocks of points
+    #pragma omp parallel for private (rank) schedule(dynamic) num_threads(num_threads_)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 
         // Get thread info
@@ -2223,6 +2387,7 @@ SharedMatrix UV::compute_gradient()
 
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        double** Gp = G_local[rank]->pointer();
         double* QTp = Q_temp[rank]->pointer();
 
         double** Tap = pworker->scratch()[0]->pointer();
@@ -2363,67 +2528,29 @@ SharedMatrix UV::compute_gradient()
             C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], max_functions, Dbp[0],
                     max_functions, 0.0, Ubp[0], max_functions);
 
-            // x
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*)Tap[P], '\0', sizeof(double) * nlocal);
-                ::memset((void*)Tbp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal,
-                        -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ax[P] + v_gamma_ab[P] * rho_bx[P]),
-                        Uap[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal,
-                        -2.0 * w[P] * (2.0 * v_gamma_bb[P] * rho_bx[P] + v_gamma_ab[P] * rho_ax[P]),
-                        Ubp[P], 1, Tbp[P], 1);
-            }
-            for (int ml = 0; ml < nlocal; ml++) {
-                int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] +=
-                    C_DDOT(npoints, &Tap[0][ml], max_functions, &phi_xx[0][ml], max_functions);
-                Gp[A][1] +=
-                    C_DDOT(npoints, &Tap[0][ml], max_functions, &phi_xy[0][ml], max_functions);
-                Gp[A][2] +=
-                    C_DDOT(npoints, &Tap[0][ml], max_functions, &phi_xz[0][ml], max_functions);
-                Gp[A][0] +=
-                    C_DDOT(npoints, &Tbp[0][ml], max_functions, &phi_xx[0][ml], max_functions);
-                Gp[A][1] +=
-                    C_DDOT(npoints, &Tbp[0][ml], max_functions, &phi_xy[0][ml], max_functions);
-                Gp[A][2] +=
-                    C_DDOT(npoints, &Tbp[0][ml], max_functions, &phi_xz[0][ml], max_functions);
-            }
-
-            // y
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*) Tap[P], '\0', sizeof(double) * nlocal);
-                ::memset((void*) Tbp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ay[P] + v_gamma_ab[P] * rho_by[P]), Uap[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_bb[P] * rho_by[P] + v_gamma_ab[P] * rho_ay[P]), Ubp[P], 1, Tbp[P], 1);
-            }
-            for (int ml = 0; ml < nlocal; ml++) {
-                int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_xy[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_yy[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-                Gp[A][0] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_xy[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_yy[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-            }
-
-            // z
-            for (int P = 0; P < npoints; P++) {
-                ::memset((void*) Tap[P], '\0', sizeof(double) * nlocal);
-                ::memset((void*) Tbp[P], '\0', sizeof(double) * nlocal);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_az[P] + v_gamma_ab[P] * rho_bz[P]), Uap[P], 1, Tap[P], 1);
-                C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_bb[P] * rho_bz[P] + v_gamma_ab[P] * rho_az[P]), Ubp[P], 1, Tbp[P], 1);
-            }
+            // Both spins and all three directions in one pass over the points of each function
             for (int ml = 0; ml < nlocal; ml++) {
                 int A = primary_->function_to_center(function_map[ml]);
-                Gp[A][0] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_xz[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tap[0][ml],max_functions,&phi_zz[0][ml],max_functions);
-                Gp[A][0] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_xz[0][ml],max_functions);
-                Gp[A][1] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_yz[0][ml],max_functions);
-                Gp[A][2] += C_DDOT(npoints,&Tbp[0][ml],max_functions,&phi_zz[0][ml],max_functions);
+                double gx = 0.0;
+                double gy = 0.0;
+                double gz = 0.0;
+                for (int P = 0; P < npoints; P++) {
+                    double ua = -2.0 * w[P] * Uap[P][ml];
+                    double ub = -2.0 * w[P] * Ubp[P][ml];
+                    double cx = ua * (2.0 * v_gamma_aa[P] * rho_ax[P] + v_gamma_ab[P] * rho_bx[P]) +
+                                ub * (2.0 * v_gamma_bb[P] * rho_bx[P] + v_gamma_ab[P] * rho_ax[P]);
+                    double cy = ua * (2.0 * v_gamma_aa[P] * rho_ay[P] + v_gamma_ab[P] * rho_by[P]) +
+                                ub * (2.0 * v_gamma_bb[P] * rho_by[P] + v_gamma_ab[P] * rho_ay[P]);
+                    double cz = ua * (2.0 * v_gamma_aa[P] * rho_az[P] + v_gamma_ab[P] * rho_bz[P]) +
+                                ub * (2.0 * v_gamma_bb[P] * rho_bz[P] + v_gamma_ab[P] * rho_az[P]);
+                    gx += cx * phi_xx[P][ml] + cy * phi_xy[P][ml] + cz * phi_xz[P][ml];
+                    gy += cx * phi_xy[P][ml] + cy * phi_yy[P][ml] + cz * phi_yz[P][ml];
+                    gz += cx * phi_xz[P][ml] + cy * phi_yz[P][ml] + cz * phi_zz[P][ml];
+                }
+                Gp[A][0] += gx;
+                Gp[A][1] += gy;
+                Gp[A][2] += gz;
             }
-
         }
 
         // => Meta Contribution <= //
@@ -2455,18 +2582,18 @@ SharedMatrix UV::compute_gradient()
 
             double** Ds[2];
             Ds[0] = Dap;
-            Ds[1] = Dap;
+            Ds[1] = Dbp;
 
             double* v_tau_s[2];
             v_tau_s[0] = v_tau_a;
             v_tau_s[1] = v_tau_b;
 
             for (int s = 0; s < 2; s++) {
-//                double** Dp = Ds[s];
+                double** Dp = Ds[s];
                 double* v_tau = v_tau_s[s];
                 for (int i = 0; i < 3; i++) {
                     double*** phi_j = phi_ij[i];
-                    C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_i[i][0],max_functions,Dap[0],max_functions,0.0,Uap[0],max_functions);
+                    C_DGEMM('N','N',npoints,nlocal,nlocal,1.0,phi_i[i][0],max_functions,Dp[0],max_functions,0.0,Uap[0],max_functions);
                     for (int P = 0; P < npoints; P++) {
                         ::memset((void*) Tap[P], '\0', sizeof(double) * nlocal);
                         C_DAXPY(nlocal, -2.0 * w[P] * (v_tau[P]), Uap[P], 1, Tap[P], 1);
@@ -2484,7 +2611,12 @@ SharedMatrix UV::compute_gradient()
         Ub_local.reset();
 
     }
-    // timer_off("V: V_XC");
+
+    // Sum up the matrix
+    SharedMatrix G(new Matrix("XC Gradient", natom, 3));
+    for (auto const &val: G_local){
+        G->add(val);
+    }
 
     quad_values_["FUNCTIONAL"] = std::accumulate(functionalq.begin(), functionalq.end(), 0.0);
     quad_values_["RHO_A"]      = std::accumulate(rhoaq.begin(), rhoaq.end(), 0.0);
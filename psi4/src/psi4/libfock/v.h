@@ -64,6 +64,8 @@ protected:
     double v2_rho_cutoff_;
     /// VV10 interior kernel threshold
     double vv10_rho_cutoff_;
+    /// VV10 block pair distance cutoff, 0.0 for none
+    double vv10_screen_radius_;
     /// Options object, used to build grid
     Options& options_;
     /// Basis set used in the integration
@@ -76,6 +78,11 @@ protected:
     std::vector<std::shared_ptr<PointFunctions>> point_workers_;
     /// Integration grid, built by KSPotential
     std::shared_ptr<DFTGrid> grid_;
+    /// Grid of the symmetry-unique atoms for compute_V in a point group (DFT_GRID_SYMMETRY), else null
+    std::shared_ptr<DFTGrid> sym_grid_;
+    /// Grid options that override the global ones when the grid is built
+    std::map<std::string, int> grid_int_options_;
+    std::map<std::string, std::string> grid_str_options_;
     /// Quadrature values obtained during integration
     std::map<std::string, double> quad_values_;
 
@@ -92,6 +99,11 @@ protected:
     // VV10 dispersion, return vv10_nlc energy
     double vv10_nlc(SharedMatrix ret);
 
+    /// The grid compute_V integrates over: sym_grid_ when V is returned in the SO basis
+    std::shared_ptr<DFTGrid> potential_grid() const { return (AO2USO_ && sym_grid_) ? sym_grid_ : grid_; }
+    /// Zero the components of <r rho> in quad_values_ that the point group forces to vanish
+    void zero_asymmetric_moments();
+
     /// Set things up
     void common_init();
 public:
@@ -119,6 +131,13 @@ public:
     // Set the site of the grac shift
     void set_grac_shift(double value);
 
+    /// Override grid options (such as DFT_SPHERICAL_POINTS) for this potential; call before initialize
+    void set_grid_options(const std::map<std::string, int>& int_opts,
+                          const std::map<std::string, std::string>& str_opts = {}) {
+        grid_int_options_ = int_opts;
+        grid_str_options_ = str_opts;
+    }
+
     /// Throws by default
     virtual void compute_V(std::vector<SharedMatrix> ret);
     virtual void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret);
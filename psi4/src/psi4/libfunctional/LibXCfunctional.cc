@@ -28,6 +28,7 @@
 
 #include "functional.h"
 #include "LibXCfunctional.h"
+#include "native_kernels.h"
 
 #include "psi4/libmints/vector.h"
 #include "psi4/psi4-dec.h"
@@ -127,6 +128,25 @@ LibXCFunctional::LibXCFunctional(std::string xc_name, bool unpolarized) {
         needs_vv10_ = true;
     }
 
+    // Native kernels (DFT_NATIVE_KERNELS), restricted only and with every component covered
+    use_native_ = false;
+    native_threshold_ = xc_functional_.dens_threshold;
+    if (unpolarized_ && !lrc_ && !needs_vv10_) {
+        if (xc_functional_.mix_coef == nullptr) {
+            native_terms_.push_back(std::make_pair(func_id_, 1.0));
+        } else {
+            for (size_t i = 0; i < xc_functional_.n_func_aux; i++) {
+                native_terms_.push_back(
+                    std::make_pair(xc_functional_.func_aux[i]->info->number, xc_functional_.mix_coef[i]));
+            }
+        }
+        for (size_t k = 0; k < native_terms_.size(); k++) {
+            if (!native_xc::supported(native_terms_[k].first)) {
+                native_terms_.clear();
+                break;
+            }
+        }
+    }
 }
 LibXCFunctional::~LibXCFunctional() { xc_func_end(&xc_functional_); }
 std::shared_ptr<Functional> LibXCFunctional::build_worker() {
@@ -151,6 +171,7 @@ std::shared_ptr<Functional> LibXCFunctional::build_worker() {
     func->exc_ = exc_;
     func->vxc_ = vxc_;
     func->fxc_ = fxc_;
+    func->use_native_ = use_native_;
 
     return static_cast<std::shared_ptr<Functional>>(func);
 }
@@ -284,6 +305,14 @@ void LibXCFunctional::set_tweak(std::vector<double> values) {
 
     user_tweakers_ = values;
 }
+bool LibXCFunctional::use_native_kernels() const {
+    return use_native_ && !native_terms_.empty() && !user_omega_ && user_tweakers_.empty();
+}
+double* LibXCFunctional::scratch(std::vector<double>& buffer, size_t size) {
+    // Keeps its capacity, so a worker allocates only when the blocks grow
+    buffer.assign(size, 0.0);
+    return buffer.data();
+}
 std::vector<std::tuple<std::string, int, double>> LibXCFunctional::get_mix_data() {
     std::vector<std::tuple<std::string, int, double>> ret;
 
@@ -497,41 +526,46 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
 
         // Compute deriv
         if (deriv >= 1) {
-            // Allocate
-            std::vector<double> fv(npoints);
-            std::vector<double> fv_rho(npoints);
+            // Scratch, kept by the worker between calls
+            double* fv = scratch(fv_, npoints);
+            double* fv_rho = scratch(fv_rho_, npoints);
 
             // GGA
-            std::vector<double> fgamma, fv_gamma;
+            double* fv_gamma = nullptr;
             if (gga_) {
-                fgamma.resize(npoints);
-                fv_gamma.resize(npoints);
+                fv_gamma = scratch(fv_gamma_, npoints);
             }
 
             // Meta
-            std::vector<double> flapl, fv_lapl, fv_tau;
+            double* flapl = nullptr;
+            double* fv_lapl = nullptr;
+            double* fv_tau = nullptr;
             if (meta_) {
-                flapl.resize(npoints);
-                fv_lapl.resize(npoints);
-                fv_tau.resize(npoints);
+                flapl = scratch(flapl_, npoints);
+                fv_lapl = scratch(fv_lapl_, npoints);
+                fv_tau = scratch(fv_tau_, npoints);
             }
 
             double* fvp = nullptr;
             if (exc_){
-                fvp = fv.data();
+                fvp = fv;
             }
 
             // Compute
-            if (meta_) {
-                xc_mgga_exc_vxc(&xc_functional_, npoints, rho_ap, gamma_aap, flapl.data(), tau_ap,
-                                fvp, fv_rho.data(), fv_gamma.data(), fv_lapl.data(),
-                                fv_tau.data());
+            if (use_native_kernels()) {
+                for (size_t k = 0; k < native_terms_.size(); k++) {
+                    native_xc::compute_rks(native_terms_[k].first, native_terms_[k].second, npoints, rho_ap,
+                                           gamma_aap, fvp, fv_rho, fv_gamma, native_threshold_);
+                }
+            } else if (meta_) {
+                xc_mgga_exc_vxc(&xc_functional_, npoints, rho_ap, gamma_aap, flapl, tau_ap,
+                                fvp, fv_rho, fv_gamma, fv_lapl, fv_tau);
             } else if (gga_) {
                 xc_gga_exc_vxc(&xc_functional_, npoints, rho_ap, gamma_aap, fvp,
-                               fv_rho.data(), fv_gamma.data());
+                               fv_rho, fv_gamma);
 
             } else {
-                xc_lda_exc_vxc(&xc_functional_, npoints, rho_ap, fvp, fv_rho.data());
+                xc_lda_exc_vxc(&xc_functional_, npoints, rho_ap, fvp, fv_rho);
             }
             // printf("%s | %lf %lf\n", xc_func_name_.c_str(), fv_rho[0], fv_gamma[0]);
 
@@ -542,14 +576,14 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
                 }
             }
 
-            C_DAXPY(npoints, alpha_, fv_rho.data(), 1, v_rho_a, 1);
+            C_DAXPY(npoints, alpha_, fv_rho, 1, v_rho_a, 1);
 
             if (gga_) {
-                C_DAXPY(npoints, alpha_, fv_gamma.data(), 1, v_gamma_aa, 1);
+                C_DAXPY(npoints, alpha_, fv_gamma, 1, v_gamma_aa, 1);
             }
 
             if (meta_) {
-                C_DAXPY(npoints, 0.5 * alpha_, fv_tau.data(), 1, v_tau_a, 1);
+                C_DAXPY(npoints, 0.5 * alpha_, fv_tau, 1, v_tau_a, 1);
             }
         }
 
@@ -561,55 +595,59 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
                     "available");
 
             } else if (gga_) {
-                std::vector<double> fv2_rho2(npoints);
-                std::vector<double> fv2_rho_gamma(npoints);
-                std::vector<double> fv2_gamma2(npoints);
+                double* fv2_rho2 = scratch(fv2_rho2_, npoints);
+                double* fv2_rho_gamma = scratch(fv2_rho_gamma_, npoints);
+                double* fv2_gamma2 = scratch(fv2_gamma2_, npoints);
 
-                xc_gga_fxc(&xc_functional_, npoints, rho_ap, gamma_aap, fv2_rho2.data(),
-                           fv2_rho_gamma.data(), fv2_gamma2.data());
+                xc_gga_fxc(&xc_functional_, npoints, rho_ap, gamma_aap, fv2_rho2,
+                           fv2_rho_gamma, fv2_gamma2);
 
-                C_DAXPY(npoints, alpha_, fv2_rho2.data(), 1, v_rho_a_rho_a, 1);
-                C_DAXPY(npoints, alpha_, fv2_gamma2.data(), 1, v_gamma_aa_gamma_aa, 1);
-                C_DAXPY(npoints, alpha_, fv2_rho_gamma.data(), 1, v_rho_a_gamma_aa, 1);
+                C_DAXPY(npoints, alpha_, fv2_rho2, 1, v_rho_a_rho_a, 1);
+                C_DAXPY(npoints, alpha_, fv2_gamma2, 1, v_gamma_aa_gamma_aa, 1);
+                C_DAXPY(npoints, alpha_, fv2_rho_gamma, 1, v_rho_a_gamma_aa, 1);
 
             } else {
-                std::vector<double> fv2_rho2(npoints);
+                double* fv2_rho2 = scratch(fv2_rho2_, npoints);
 
-                xc_lda_fxc(&xc_functional_, npoints, rho_ap, fv2_rho2.data());
+                xc_lda_fxc(&xc_functional_, npoints, rho_ap, fv2_rho2);
 
-                C_DAXPY(npoints, alpha_, fv2_rho2.data(), 1, v_rho_a_rho_a, 1);
+                C_DAXPY(npoints, alpha_, fv2_rho2, 1, v_rho_a_rho_a, 1);
             }
         }
 
     } else {  // End unpolarized
 
-        // Allocate input data
-        std::vector<double> frho(npoints * 2);
-        std::vector<double> fv(npoints);
-        std::vector<double> fv_rho(npoints * 2);
+        // Interleave the input data, in scratch kept by the worker between calls
+        double* frho = scratch(frho_, npoints * 2);
+        double* fv = scratch(fv_, npoints);
+        double* fv_rho = scratch(fv_rho_, npoints * 2);
 
-        C_DCOPY(npoints, rho_ap, 1, frho.data(), 2);
-        C_DCOPY(npoints, rho_bp, 1, (frho.data() + 1), 2);
+        C_DCOPY(npoints, rho_ap, 1, frho, 2);
+        C_DCOPY(npoints, rho_bp, 1, (frho + 1), 2);
 
-        std::vector<double> fgamma, fv_gamma;
+        double* fgamma = nullptr;
+        double* fv_gamma = nullptr;
         if (gga_) {
-            fgamma.resize(npoints * 3);
-            fv_gamma.resize(npoints * 3);
+            fgamma = scratch(fgamma_, npoints * 3);
+            fv_gamma = scratch(fv_gamma_, npoints * 3);
 
-            C_DCOPY(npoints, gamma_aap, 1, fgamma.data(), 3);
-            C_DCOPY(npoints, gamma_abp, 1, (fgamma.data() + 1), 3);
-            C_DCOPY(npoints, gamma_bbp, 1, (fgamma.data() + 2), 3);
+            C_DCOPY(npoints, gamma_aap, 1, fgamma, 3);
+            C_DCOPY(npoints, gamma_abp, 1, (fgamma + 1), 3);
+            C_DCOPY(npoints, gamma_bbp, 1, (fgamma + 2), 3);
         }
 
-        std::vector<double> ftau, flapl, fv_lapl, fv_tau;
+        double* ftau = nullptr;
+        double* flapl = nullptr;
+        double* fv_lapl = nullptr;
+        double* fv_tau = nullptr;
         if (meta_) {
-            ftau.resize(npoints * 2);
-            flapl.resize(npoints * 2);
-            fv_lapl.resize(npoints * 2);
-            fv_tau.resize(npoints * 2);
+            ftau = scratch(ftau_, npoints * 2);
+            flapl = scratch(flapl_, npoints * 2);
+            fv_lapl = scratch(fv_lapl_, npoints * 2);
+            fv_tau = scratch(fv_tau_, npoints * 2);
 
-            C_DCOPY(npoints, tau_ap, 1, ftau.data(), 2);
-            C_DCOPY(npoints, tau_bp, 1, (ftau.data() + 1), 2);
+            C_DCOPY(npoints, tau_ap, 1, ftau, 2);
+            C_DCOPY(npoints, tau_bp, 1, (ftau + 1), 2);
         }
 
 
@@ -621,22 +659,20 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
             // Special cases
             double* fvp;
             if (exc_) {
-                fvp = fv.data();
+                fvp = fv;
             } else {
                 fvp = nullptr;
             }
 
             if (meta_) {
-                xc_mgga_exc_vxc(&xc_functional_, npoints, frho.data(), fgamma.data(), flapl.data(),
-                                ftau.data(), fvp, fv_rho.data(), fv_gamma.data(), fv_lapl.data(),
-                                fv_tau.data());
+                xc_mgga_exc_vxc(&xc_functional_, npoints, frho, fgamma, flapl, ftau, fvp, fv_rho,
+                                fv_gamma, fv_lapl, fv_tau);
 
             } else if (gga_) {
-                xc_gga_exc_vxc(&xc_functional_, npoints, frho.data(), fgamma.data(), fvp,
-                               fv_rho.data(), fv_gamma.data());
+                xc_gga_exc_vxc(&xc_functional_, npoints, frho, fgamma, fvp, fv_rho, fv_gamma);
 
             } else {
-                xc_lda_exc_vxc(&xc_functional_, npoints, frho.data(), fvp, fv_rho.data());
+                xc_lda_exc_vxc(&xc_functional_, npoints, frho, fvp, fv_rho);
             }
 
             // Re-apply
@@ -646,18 +682,18 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
                 }
             }
 
-            C_DAXPY(npoints, alpha_, fv_rho.data(), 2, v_rho_a, 1);
-            C_DAXPY(npoints, alpha_, (fv_rho.data() + 1), 2, v_rho_b, 1);
+            C_DAXPY(npoints, alpha_, fv_rho, 2, v_rho_a, 1);
+            C_DAXPY(npoints, alpha_, (fv_rho + 1), 2, v_rho_b, 1);
 
             if (gga_) {
-                C_DAXPY(npoints, alpha_, fv_gamma.data(), 3, v_gamma_aa, 1);
-                C_DAXPY(npoints, alpha_, (fv_gamma.data() + 1), 3, v_gamma_ab, 1);
-                C_DAXPY(npoints, alpha_, (fv_gamma.data() + 2), 3, v_gamma_bb, 1);
+                C_DAXPY(npoints, alpha_, fv_gamma, 3, v_gamma_aa, 1);
+                C_DAXPY(npoints, alpha_, (fv_gamma + 1), 3, v_gamma_ab, 1);
+                C_DAXPY(npoints, alpha_, (fv_gamma + 2), 3, v_gamma_bb, 1);
             }
 
             if (meta_) {
-                C_DAXPY(npoints, 0.5 * alpha_, fv_tau.data(), 2, v_tau_a, 1);
-                C_DAXPY(npoints, 0.5 * alpha_, (fv_tau.data() + 1), 2, v_tau_b, 1);
+                C_DAXPY(npoints, 0.5 * alpha_, fv_tau, 2, v_tau_a, 1);
+                C_DAXPY(npoints, 0.5 * alpha_, (fv_tau + 1), 2, v_tau_b, 1);
             }
         }
 
@@ -668,12 +704,12 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
                     "Second derivative for meta functionals is not yet available");
 
             } else if (gga_) {
-                std::vector<double> fv2_rho2(npoints * 3);
-                std::vector<double> fv2_rhogamma(npoints * 6);
-                std::vector<double> fv2_gamma2(npoints * 6);
+                double* fv2_rho2 = scratch(fv2_rho2_, npoints * 3);
+                double* fv2_rhogamma = scratch(fv2_rho_gamma_, npoints * 6);
+                double* fv2_gamma2 = scratch(fv2_gamma2_, npoints * 6);
 
-                xc_gga_fxc(&xc_functional_, npoints, frho.data(), fgamma.data(), fv2_rho2.data(),
-                           fv2_rhogamma.data(), fv2_gamma2.data());
+                xc_gga_fxc(&xc_functional_, npoints, frho, fgamma, fv2_rho2,
+                           fv2_rhogamma, fv2_gamma2);
 
                 for (size_t i = 0; i < npoints; i++) {
                     // v2rho2(3)       = (u_u, u_d, d_d)
@@ -700,9 +736,9 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
 
             } else {
 
-                std::vector<double> fv2_rho2(npoints * 3);
+                double* fv2_rho2 = scratch(fv2_rho2_, npoints * 3);
 
-                xc_lda_fxc(&xc_functional_, npoints, frho.data(), fv2_rho2.data());
+                xc_lda_fxc(&xc_functional_, npoints, frho, fv2_rho2);
 
                 for (size_t i = 0; i < npoints; i++) {
                     // v2rho2(3)       = (u_u, u_d, d_d)
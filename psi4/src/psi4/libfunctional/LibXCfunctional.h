@@ -32,6 +32,9 @@
 #include "psi4/libmints/typedefs.h"
 #include "libxc/xc.h"
 
+#include <utility>
+#include <vector>
+
 namespace psi {
 
 /**
@@ -62,6 +65,19 @@ private:
     // User defined tweakers
     std::vector<double> user_tweakers_;
 
+    // Native kernels: (LibXC id, mixing coefficient) of each component, empty if any lacks one
+    bool use_native_;
+    std::vector<std::pair<int, double>> native_terms_;
+    double native_threshold_;
+    bool use_native_kernels() const;
+
+    // Per-worker scratch for the LibXC outputs and interleaved inputs
+    std::vector<double> fv_, fv_rho_, fv_gamma_, fv_tau_, fv_lapl_;
+    std::vector<double> frho_, fgamma_, ftau_, flapl_;
+    std::vector<double> fv2_rho2_, fv2_rho_gamma_, fv2_gamma2_;
+    /// Zeroed buffer of size doubles, reallocated only when it has to grow
+    double* scratch(std::vector<double>& buffer, size_t size);
+
 public:
 
     LibXCFunctional(std::string xc_name, bool unpolarized);
@@ -77,6 +93,9 @@ public:
     // Setters and getters
     void set_omega(double omega);
     void set_tweak(std::vector<double> values);
+    /// Evaluate restricted first derivatives with native_xc instead of LibXC, where covered
+    void set_native_kernels(bool native) { use_native_ = native; }
+    bool has_native_kernels() const { return !native_terms_.empty(); }
     std::vector<std::tuple<std::string, int, double>> get_mix_data();
 
 
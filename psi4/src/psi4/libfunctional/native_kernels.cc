@@ -0,0 +1,243 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "native_kernels.h"
+#include "libxc/xc.h"
+
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace psi {
+namespace native_xc {
+
+namespace {
+
+/**
+ * A value with its derivatives along rho and sigma. Each kernel is written
+ * once, as the energy density f(rho, sigma), and the potentials come along.
+ */
+struct Dual {
+    double v, dr, ds;
+    Dual(double val = 0.0, double r = 0.0, double s = 0.0) : v(val), dr(r), ds(s) {}
+};
+
+inline Dual operator+(const Dual& a, const Dual& b) { return Dual(a.v + b.v, a.dr + b.dr, a.ds + b.ds); }
+inline Dual operator-(const Dual& a, const Dual& b) { return Dual(a.v - b.v, a.dr - b.dr, a.ds - b.ds); }
+inline Dual operator-(const Dual& a) { return Dual(-a.v, -a.dr, -a.ds); }
+inline Dual operator*(const Dual& a, const Dual& b) {
+    return Dual(a.v * b.v, a.dr * b.v + a.v * b.dr, a.ds * b.v + a.v * b.ds);
+}
+inline Dual operator/(const Dual& a, const Dual& b) {
+    double ib = 1.0 / b.v;
+    double q = a.v * ib;
+    return Dual(q, (a.dr - q * b.dr) * ib, (a.ds - q * b.ds) * ib);
+}
+inline Dual operator+(const Dual& a, double b) { return Dual(a.v + b, a.dr, a.ds); }
+inline Dual operator+(double a, const Dual& b) { return Dual(a + b.v, b.dr, b.ds); }
+inline Dual operator-(const Dual& a, double b) { return Dual(a.v - b, a.dr, a.ds); }
+inline Dual operator-(double a, const Dual& b) { return Dual(a - b.v, -b.dr, -b.ds); }
+inline Dual operator*(const Dual& a, double b) { return Dual(a.v * b, a.dr * b, a.ds * b); }
+inline Dual operator*(double a, const Dual& b) { return Dual(a * b.v, a * b.dr, a * b.ds); }
+inline Dual operator/(const Dual& a, double b) { return a * (1.0 / b); }
+inline Dual operator/(double a, const Dual& b) {
+    double q = a / b.v;
+    double d = -q / b.v;
+    return Dual(q, d * b.dr, d * b.ds);
+}
+
+/// Chain rule, given f(a.v) and f'(a.v)
+inline Dual chain(const Dual& a, double f, double df) { return Dual(f, df * a.dr, df * a.ds); }
+
+inline Dual exp(const Dual& a) {
+    double e = std::exp(a.v);
+    return chain(a, e, e);
+}
+inline Dual log(const Dual& a) { return chain(a, std::log(a.v), 1.0 / a.v); }
+inline Dual sqrt(const Dual& a) {
+    double s = std::sqrt(a.v);
+    return chain(a, s, 0.5 / s);
+}
+inline Dual pow(const Dual& a, double p) {
+    double f = std::pow(a.v, p);
+    return chain(a, f, p * f / a.v);
+}
+inline Dual atan(const Dual& a) { return chain(a, std::atan(a.v), 1.0 / (1.0 + a.v * a.v)); }
+inline Dual asinh(const Dual& a) { return chain(a, std::asinh(a.v), 1.0 / std::sqrt(1.0 + a.v * a.v)); }
+
+// LibXC floors the squared gradient at MIN_GRAD^2
+const double sigma_floor = 5.0E-13 * 5.0E-13;
+
+// => Exchange <= //
+
+/// Slater exchange
+inline Dual lda_x(const Dual& n) {
+    const double Cx = 0.75 * std::cbrt(3.0 / M_PI);
+    return -Cx * pow(n, 4.0 / 3.0);
+}
+
+/// Becke 88, written per spin with rho_a = rho_b = n/2
+inline Dual gga_x_b88(const Dual& n, const Dual& sigma) {
+    const double beta = 0.0042;
+    const double gamma = 6.0;
+    const double Cs = 1.5 * std::cbrt(3.0 / (4.0 * M_PI));
+    Dual rho_s = 0.5 * n;
+    Dual rho43 = pow(rho_s, 4.0 / 3.0);
+    Dual x = 0.5 * sqrt(sigma) / rho43;
+    Dual h = Cs + beta * x * x / (1.0 + gamma * beta * x * asinh(x));
+    return -2.0 * rho43 * h;
+}
+
+/// PBE exchange
+inline Dual gga_x_pbe(const Dual& n, const Dual& sigma) {
+    const double kappa = 0.8040;
+    const double mu = 0.2195149727645171;
+    const double Cx = 0.75 * std::cbrt(3.0 / M_PI);
+    const double Cs = 1.0 / (4.0 * std::pow(3.0 * M_PI * M_PI, 2.0 / 3.0));
+    Dual s2 = Cs * sigma / pow(n, 8.0 / 3.0);
+    Dual F = 1.0 + kappa - kappa / (1.0 + mu * s2 / kappa);
+    return -Cx * pow(n, 4.0 / 3.0) * F;
+}
+
+// => Correlation <= //
+
+/// VWN RPA parametrization, paramagnetic
+inline Dual lda_c_vwn_rpa(const Dual& n) {
+    const double A = 0.0310907;
+    const double b = 13.0720;
+    const double c = 42.7198;
+    const double x0 = -0.409286;
+    const double Q = std::sqrt(4.0 * c - b * b);
+    const double X0 = x0 * x0 + b * x0 + c;
+    Dual x = sqrt(pow(3.0 / (4.0 * M_PI) / n, 1.0 / 3.0));
+    Dual X = x * x + b * x + c;
+    Dual at = atan(Q / (2.0 * x + b));
+    Dual eps = A * (log(x * x / X) + 2.0 * b / Q * at -
+                    b * x0 / X0 * (log((x - x0) * (x - x0) / X) + 2.0 * (b + 2.0 * x0) / Q * at));
+    return n * eps;
+}
+
+/// Lee-Yang-Parr in the Miehlich form, closed shell
+inline Dual gga_c_lyp(const Dual& n, const Dual& sigma) {
+    const double a = 0.04918;
+    const double b = 0.132;
+    const double c = 0.2533;
+    const double d = 0.349;
+    const double CF = 0.3 * std::pow(3.0 * M_PI * M_PI, 2.0 / 3.0);
+    Dual nm13 = pow(n, -1.0 / 3.0);
+    Dual den = 1.0 + d * nm13;
+    Dual omega = exp(-c * nm13) / den * pow(n, -11.0 / 3.0);
+    Dual delta = c * nm13 + d * nm13 / den;
+    Dual n2 = n * n;
+    return -a * n / den -
+           a * b * omega * n2 * (CF * pow(n, 8.0 / 3.0) - sigma * (1.0 / 24.0 + 7.0 / 72.0 * delta));
+}
+
+/// Perdew-Wang 92 (LibXC's PW_MOD digits), paramagnetic
+inline Dual lda_c_pw_mod(const Dual& rs) {
+    const double A = 0.0310907;
+    const double alpha1 = 0.21370;
+    const double beta1 = 7.5957;
+    const double beta2 = 3.5876;
+    const double beta3 = 1.6382;
+    const double beta4 = 0.49294;
+    Dual srs = sqrt(rs);
+    Dual den = 2.0 * A * (beta1 * srs + beta2 * rs + beta3 * rs * srs + beta4 * rs * rs);
+    return -2.0 * A * (1.0 + alpha1 * rs) * log(1.0 + 1.0 / den);
+}
+
+/// PBE correlation, closed shell (zeta = 0, phi = 1)
+inline Dual gga_c_pbe(const Dual& n, const Dual& sigma) {
+    const double beta = 0.06672455060314922;
+    const double gamma = (1.0 - std::log(2.0)) / (M_PI * M_PI);
+    Dual rs = pow(3.0 / (4.0 * M_PI) / n, 1.0 / 3.0);
+    Dual eps = lda_c_pw_mod(rs);
+    Dual kF = pow(3.0 * M_PI * M_PI * n, 1.0 / 3.0);
+    Dual ks2 = 4.0 * kF / M_PI;
+    Dual t2 = sigma / (4.0 * ks2 * n * n);
+    Dual A = (beta / gamma) / (exp(-eps / gamma) - 1.0);
+    Dual At2 = A * t2;
+    Dual H = gamma * log(1.0 + beta / gamma * t2 * (1.0 + At2) / (1.0 + At2 + At2 * At2));
+    return n * (eps + H);
+}
+
+/// Energy density of xc_id, with derivatives
+inline Dual energy_density(int xc_id, const Dual& n, const Dual& sigma) {
+    switch (xc_id) {
+        case XC_LDA_X:
+            return lda_x(n);
+        case XC_GGA_X_B88:
+            return gga_x_b88(n, sigma);
+        case XC_GGA_X_PBE:
+            return gga_x_pbe(n, sigma);
+        case XC_LDA_C_VWN_RPA:
+            return lda_c_vwn_rpa(n);
+        case XC_GGA_C_LYP:
+            return gga_c_lyp(n, sigma);
+        case XC_GGA_C_PBE:
+            return gga_c_pbe(n, sigma);
+    }
+    return Dual();
+}
+
+inline bool is_gga(int xc_id) { return xc_id != XC_LDA_X && xc_id != XC_LDA_C_VWN_RPA; }
+
+}  // namespace
+
+bool supported(int xc_id) {
+    switch (xc_id) {
+        case XC_LDA_X:
+        case XC_GGA_X_B88:
+        case XC_GGA_X_PBE:
+        case XC_LDA_C_VWN_RPA:
+        case XC_GGA_C_LYP:
+        case XC_GGA_C_PBE:
+            return true;
+    }
+    return false;
+}
+
+void compute_rks(int xc_id, double coef, size_t npoints, const double* rho, const double* sigma,
+                 double* zk, double* vrho, double* vsigma, double dens_threshold) {
+    if (!supported(xc_id)) throw PSIEXCEPTION("native_xc: no kernel for this functional");
+    bool gga = is_gga(xc_id);
+
+    for (size_t i = 0; i < npoints; i++) {
+        if (rho[i] < dens_threshold) continue;
+        Dual n(rho[i], 1.0, 0.0);
+        Dual s(gga ? std::max(sigma[i], sigma_floor) : 0.0, 0.0, 1.0);
+        Dual f = energy_density(xc_id, n, s);
+        if (zk) zk[i] += coef * f.v / rho[i];
+        vrho[i] += coef * f.dr;
+        if (gga) vsigma[i] += coef * f.ds;
+    }
+}
+
+}  // namespace native_xc
+}  // namespace psi
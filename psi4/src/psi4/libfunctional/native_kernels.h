@@ -0,0 +1,60 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef NATIVE_KERNELS_H
+#define NATIVE_KERNELS_H
+
+#include <cstddef>
+
+namespace psi {
+
+/**
+ * Closed-shell first-derivative kernels for the LibXC components of the
+ * common functionals (Slater, B88, PBE exchange; VWN(RPA), LYP, PBE
+ * correlation), with LibXC's default parameters and output conventions.
+ * Used by LibXCFunctional under DFT_NATIVE_KERNELS.
+ */
+namespace native_xc {
+
+/// Is there a kernel for the LibXC functional number xc_id?
+bool supported(int xc_id);
+
+/**
+ * Adds coef times the LibXC-style outputs of xc_id at npoints points:
+ * zk (energy per particle), vrho and, for GGAs, vsigma. rho and sigma are the
+ * total density and its squared gradient; points with rho below
+ * dens_threshold are left alone.
+ */
+void compute_rks(int xc_id, double coef, size_t npoints, const double* rho, const double* sigma,
+                 double* zk, double* vrho, double* vsigma, double dens_threshold);
+
+}  // namespace native_xc
+
+}  // namespace psi
+
+#endif
@@ -371,6 +371,16 @@ void SuperFunctional::set_grac_beta(double grac_beta) {
     can_edit();
     grac_beta_ = grac_beta;
 }
+void SuperFunctional::set_native_kernels(bool native) {
+    for (size_t i = 0; i < x_functionals_.size(); i++) {
+        std::shared_ptr<LibXCFunctional> func = std::dynamic_pointer_cast<LibXCFunctional>(x_functionals_[i]);
+        if (func) func->set_native_kernels(native);
+    }
+    for (size_t i = 0; i < c_functionals_.size(); i++) {
+        std::shared_ptr<LibXCFunctional> func = std::dynamic_pointer_cast<LibXCFunctional>(c_functionals_[i]);
+        if (func) func->set_native_kernels(native);
+    }
+}
 void SuperFunctional::set_grac_shift(double grac_shift) {
     can_edit();
     if (!grac_x_functional_){
@@ -827,6 +837,21 @@ double SuperFunctional::compute_vv10_kernel(
     double* l_W0 = vv_values_["W0"]->pointer();
     double* l_kappa = vv_values_["KAPPA"]->pointer();
 
+    // Get right points, once for all left points
+    size_t r_nblock = vv10_cache.size();
+    std::vector<double*> r_xs, r_ys, r_zs, r_ws, r_rhos, r_W0s, r_kappas;
+    std::vector<size_t> r_sizes;
+    for (const auto& r_block : vv10_cache) {
+        r_xs.push_back(r_block.find("X")->second->pointer());
+        r_ys.push_back(r_block.find("Y")->second->pointer());
+        r_zs.push_back(r_block.find("Z")->second->pointer());
+        r_ws.push_back(r_block.find("W")->second->pointer());
+        r_rhos.push_back(r_block.find("RHO")->second->pointer());
+        r_W0s.push_back(r_block.find("W0")->second->pointer());
+        r_kappas.push_back(r_block.find("KAPPA")->second->pointer());
+        r_sizes.push_back(r_block.find("KAPPA")->second->dimpi()[0]);
+    }
+
     for (size_t i = 0; i < l_npoints; i++){
 
         // Add Phi agnostic quantities
@@ -839,18 +864,17 @@ double SuperFunctional::compute_vv10_kernel(
         double phi = 0.0;
         double U = 0.0;
         double W = 0.0;
-        for (auto r_block : vv10_cache){
-
-            // Get right points
-            double* r_x = r_block["X"]->pointer();
-            double* r_y = r_block["Y"]->pointer();
-            double* r_z = r_block["Z"]->pointer();
-            double* r_w = r_block["W"]->pointer();
-            double* r_rho = r_block["RHO"]->pointer();
-            double* r_W0 = r_block["W0"]->pointer();
-            double* r_kappa = r_block["KAPPA"]->pointer();
-
-            size_t r_npoints = r_block["KAPPA"]->dimpi()[0];
+        for (size_t r = 0; r < r_nblock; r++){
+
+            double* r_x = r_xs[r];
+            double* r_y = r_ys[r];
+            double* r_z = r_zs[r];
+            double* r_w = r_ws[r];
+            double* r_rho = r_rhos[r];
+            double* r_W0 = r_W0s[r];
+            double* r_kappa = r_kappas[r];
+
+            size_t r_npoints = r_sizes[r];
 
             // Interior Kernel
             # pragma omp simd reduction(+: phi, U, W)
@@ -192,6 +192,8 @@ public:
     void set_grac_shift(double grac_shift);
     void set_grac_alpha(double grac_alpha);
     void set_grac_beta(double grac_beta);
+    /// Hand restricted first derivatives to the native kernels where they cover a LibXC component
+    void set_native_kernels(bool native);
 
     // => Accessors <= //
 
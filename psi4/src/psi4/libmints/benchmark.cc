@@ -30,6 +30,7 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/3coverlap.h"
+#include "psi4/libmints/twobody.h"
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
@@ -39,6 +40,7 @@
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <cmath>
@@ -1564,6 +1566,28 @@ void benchmark_disk(int N, double min_time)
     outfile->Printf( "\n");
 
 
+}
+double benchmark_disk_bandwidth(size_t bytes)
+{
+    size_t n = std::max(bytes / sizeof(double), (size_t) 1);
+    double* A = init_array(n);
+
+    std::shared_ptr<PSIO> psio_ = PSIO::shared_object();
+    psio_address psiadd;
+    psio_->open(0, PSIO_OPEN_NEW);
+
+    Timer* qq = new Timer();
+    psiadd = PSIO_ZERO;
+    psio_->write(0,"BENCH_DATA", (char*) &A[0], n * sizeof(double), psiadd, &psiadd);
+    psiadd = PSIO_ZERO;
+    psio_->read(0,"BENCH_DATA", (char*) &A[0], n * sizeof(double), psiadd, &psiadd);
+    double t = qq->get();
+    delete qq;
+
+    psio_->close(0, 0);
+    free(A);
+
+    return (t > 0.0 ? 2.0 * n * sizeof(double) / t : 0.0);
 }
 void benchmark_math(double min_time)
 {
@@ -2607,4 +2631,124 @@ void benchmark_integrals(int max_am, double min_time)
 
 }
 
+std::map<std::string, double> benchmark_gemm(int dim, double min_time)
+{
+    size_t full_dim = dim * (size_t) dim;
+    double* A = init_array(full_dim);
+    double* B = init_array(full_dim);
+    double* C = init_array(full_dim);
+    for (size_t i = 0; i < full_dim; i++) {
+        A[i] = std::rand() / (double) RAND_MAX;
+        B[i] = std::rand() / (double) RAND_MAX;
+    }
+
+    double T = 0.0;
+    size_t rounds = 0L;
+    Timer* qq = new Timer();
+    while (T < min_time) {
+        C_DGEMM('N', 'N', dim, dim, dim, 1.0, A, dim, B, dim, 0.0, C, dim);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+
+    free(A);
+    free(B);
+    free(C);
+
+    std::map<std::string, double> results;
+    results["dim"] = dim;
+    results["seconds"] = T / (double) rounds;
+    results["gflops"] = 2.0E-9 * full_dim * dim / results["seconds"];
+    return results;
+}
+
+std::map<std::string, double> benchmark_psio(int N, double min_time)
+{
+    size_t dim = 1L << N;
+    size_t full_dim = dim * dim;
+    size_t size = full_dim * sizeof(double);
+    double* A = init_array(full_dim);
+
+    std::shared_ptr<PSIO> psio_ = PSIO::shared_object();
+    psio_address psiadd;
+    psio_->open(0, PSIO_OPEN_NEW);
+
+    // First touch, not timed
+    psiadd = PSIO_ZERO;
+    psio_->write(0, "BENCH_DATA", (char*) &A[0], size, psiadd, &psiadd);
+
+    double T = 0.0;
+    size_t rounds = 0L;
+    Timer* qq = new Timer();
+    while (T < min_time) {
+        psiadd = PSIO_ZERO;
+        psio_->write(0, "BENCH_DATA", (char*) &A[0], size, psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    double t_write = T / (double) rounds;
+
+    T = 0.0;
+    rounds = 0L;
+    qq = new Timer();
+    while (T < min_time) {
+        psiadd = PSIO_ZERO;
+        psio_->read(0, "BENCH_DATA", (char*) &A[0], size, psiadd, &psiadd);
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+    double t_read = T / (double) rounds;
+
+    psio_->close(0, 0);
+    free(A);
+
+    std::map<std::string, double> results;
+    results["bytes"] = size;
+    results["write_seconds"] = t_write;
+    results["read_seconds"] = t_read;
+    results["write_mb_per_second"] = size / (1024.0 * 1024.0 * t_write);
+    results["read_mb_per_second"] = size / (1024.0 * 1024.0 * t_read);
+    return results;
+}
+
+std::map<std::string, double> benchmark_eri(std::shared_ptr<BasisSet> basis, double min_time)
+{
+    std::shared_ptr<IntegralFactory> factory(new IntegralFactory(basis, basis, basis, basis));
+    std::shared_ptr<TwoBodyAOInt> eri(factory->eri());
+    int nshell = basis->nshell();
+
+    double T = 0.0;
+    size_t rounds = 0L;
+    size_t quartets = 0L;
+    size_t integrals = 0L;
+    Timer* qq = new Timer();
+    while (T < min_time) {
+        // Unique quartets, no screening
+        for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q <= P; Q++) {
+        for (int R = 0; R <= P; R++) {
+        for (int S = 0; S <= (R == P ? Q : R); S++) {
+            eri->compute_shell(P, Q, R, S);
+            quartets++;
+            integrals += basis->shell(P).nfunction() * (size_t) basis->shell(Q).nfunction() *
+                         basis->shell(R).nfunction() * basis->shell(S).nfunction();
+        }}}}
+        T = qq->get();
+        rounds++;
+    }
+    delete qq;
+
+    std::map<std::string, double> results;
+    results["nbf"] = basis->nbf();
+    results["quartets"] = quartets / (double) rounds;
+    results["integrals"] = integrals / (double) rounds;
+    results["seconds"] = T / (double) rounds;
+    results["quartets_per_second"] = quartets / T;
+    results["integrals_per_second"] = integrals / T;
+    return results;
+}
+
 }
@@ -29,8 +29,15 @@
 #ifndef _psi_src_lib_libmints_bench_h
 #define _psi_src_lib_libmints_bench_h
 
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
 namespace psi {
 
+class BasisSet;
+
 /**
 * Perform a benchmark traverse of BLAS 1 routines on 
 * the current hardware
@@ -67,6 +74,13 @@ void benchmark_blas3(int N, double min_time, int nthread = 1);
 **/
 void benchmark_disk(int N, double min_time);
 /**
+* Measure the PSIO streaming rate of this node, by writing and
+* reading back one array through scratch
+* \param bytes size of the array [bytes]
+* \return bytes moved per second, averaged over the write and the read
+**/
+double benchmark_disk_bandwidth(size_t bytes);
+/**
 * Perform a benchmark of psi integrals (of libmints type)
 * on the current hardware
 * All integrals will be called from different centers
@@ -82,6 +96,29 @@ void benchmark_integrals(int max_am, double min_time);
 **/
 void benchmark_math(double min_time);
 
+// => Machine-readable kernels, for psi4.benchmark_suite() <= //
+
+/**
+* Time a square C_DGEMM of dimension dim
+* \param min_time minimum amount of time to run [s]
+* \return dim, seconds (per call) and gflops
+**/
+std::map<std::string, double> benchmark_gemm(int dim, double min_time);
+/**
+* Time continuous PSIO writes and reads of a 2^N x 2^N
+* double array on scratch
+* \param min_time minimum amount of time to run each direction [s]
+* \return bytes, write/read seconds and MB per second
+**/
+std::map<std::string, double> benchmark_psio(int N, double min_time);
+/**
+* Time all unique, unscreened ERI shell quartets of basis
+* \param min_time minimum amount of time to run [s]
+* \return nbf, quartets and integrals (per sweep), seconds
+* (per sweep), and quartets/integrals per second
+**/
+std::map<std::string, double> benchmark_eri(std::shared_ptr<BasisSet> basis, double min_time);
+
 }
 
 #endif
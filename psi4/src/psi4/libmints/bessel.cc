@@ -122,7 +122,7 @@ int BesselFunction::tabulate(const double accuracy) {
 
 // Calculate modified spherical Bessel function K_l(z), weighted with an exponential factor e^(-z)
 // for l = 0 to lMax. This restricts K(z) to the interval [0,1].
-void BesselFunction::calculate(const double z, int maxL, std::vector<double> &values) {
+void BesselFunction::calculate(const double z, int maxL, std::vector<double> &values) const {
 	if (lMax < maxL) {
 		std::cerr << "Asked for " << maxL << " but only initialised to maximum L = " << lMax << "\n";
 		maxL = lMax;
@@ -98,7 +98,7 @@ public:
 	  * @param maxL - maximum angular momentum needed; must be <= lMax for object
 	  * @param values - reference to vector in which to put the values for l = 0 to maxL
 	  */
-	void calculate(const double z, int maxL, std::vector<double> &values);
+	void calculate(const double z, int maxL, std::vector<double> &values) const;
 };
 
 }
@@ -0,0 +1,384 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/chargetree.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace psi {
+
+ChargeMultipoleTree::ChargeMultipoleTree(SharedMatrix Zxyz, int order, int leaf_size) :
+    order_(order), leaf_size_(std::max(leaf_size, 1)), nset_(1)
+{
+    common_init();
+
+    int ncharge = Zxyz->rowspi()[0];
+    double** Zxyzp = Zxyz->pointer();
+    charges_.resize(4L * ncharge);
+    index_.resize(ncharge);
+    for (int i = 0; i < ncharge; ++i) {
+        index_[i] = i;
+        for (int k = 0; k < 4; ++k)
+            charges_[4L * i + k] = Zxyzp[i][k];
+    }
+
+    build_tree();
+    compute_moments();
+}
+
+ChargeMultipoleTree::ChargeMultipoleTree(const std::vector<double>& centers, const std::vector<double>& extents,
+                                         int order, int leaf_size) :
+    order_(order), leaf_size_(std::max(leaf_size, 1)), nset_(0)
+{
+    if (centers.size() != 3 * extents.size())
+        throw PSIEXCEPTION("ChargeMultipoleTree: one center and one extent are needed per source.");
+
+    common_init();
+
+    int nsource = extents.size();
+    charges_.assign(4L * nsource, 0.0);
+    extents_ = extents;
+    index_.resize(nsource);
+    for (int i = 0; i < nsource; ++i) {
+        index_[i] = i;
+        for (int k = 0; k < 3; ++k)
+            charges_[4L * i + k + 1] = centers[3L * i + k];
+    }
+
+    build_tree();
+}
+
+void ChargeMultipoleTree::common_init()
+{
+    if (order_ < 0)
+        throw PSIEXCEPTION("ChargeMultipoleTree: the expansion order must be non-negative.");
+
+    // => Multi-indices <= //
+
+    int p1 = order_ + 1;
+    term_.assign(p1 * p1 * p1, -1);
+    nterm_ = 0;
+    for (int l = 0; l <= order_; ++l) {
+        for (int kx = l; kx >= 0; --kx) {
+            for (int ky = l - kx; ky >= 0; --ky) {
+                int kz = l - kx - ky;
+                term_[(kx * p1 + ky) * p1 + kz] = nterm_++;
+                powers_.push_back(kx);
+                powers_.push_back(ky);
+                powers_.push_back(kz);
+                double fact = 1.0;
+                for (int i = 2; i <= kx; ++i) fact *= i;
+                for (int i = 2; i <= ky; ++i) fact *= i;
+                for (int i = 2; i <= kz; ++i) fact *= i;
+                inv_fact_.push_back(1.0 / fact);
+            }
+        }
+    }
+
+    binom_.assign(p1 * p1, 0.0);
+    for (int k = 0; k <= order_; ++k) {
+        binom_[k * p1] = binom_[k * p1 + k] = 1.0;
+        for (int i = 1; i < k; ++i)
+            binom_[k * p1 + i] = binom_[(k - 1) * p1 + i - 1] + binom_[(k - 1) * p1 + i];
+    }
+}
+
+void ChargeMultipoleTree::build_tree()
+{
+    int ncharge = index_.size();
+    if (!ncharge) return;
+
+    // => Root cube <= //
+
+    double lo[3], hi[3];
+    for (int k = 0; k < 3; ++k) {
+        lo[k] = hi[k] = charges_[k + 1];
+    }
+    for (int i = 1; i < ncharge; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], charges_[4L * i + k + 1]);
+            hi[k] = std::max(hi[k], charges_[4L * i + k + 1]);
+        }
+    }
+    double half = 0.0;
+    Node root;
+    for (int k = 0; k < 3; ++k) {
+        root.center[k] = 0.5 * (lo[k] + hi[k]);
+        half = std::max(half, 0.5 * (hi[k] - lo[k]));
+    }
+    root.first = 0;
+    root.count = ncharge;
+    nodes_.push_back(root);
+    build(0, half, 0);
+}
+
+void ChargeMultipoleTree::build(int node, double half, int depth)
+{
+    Node& n = nodes_[node];
+    n.child = -1;
+    n.nchild = 0;
+
+    n.radius = 0.0;
+    for (int i = n.first; i < n.first + n.count; ++i) {
+        const double* q = &charges_[4L * i];
+        double dx = q[1] - n.center[0];
+        double dy = q[2] - n.center[1];
+        double dz = q[3] - n.center[2];
+        double extent = extents_.empty() ? 0.0 : extents_[i];
+        n.radius = std::max(n.radius, std::sqrt(dx * dx + dy * dy + dz * dz) + extent);
+    }
+
+    // Coincident charges would never separate, so the depth is capped
+    if (n.count <= leaf_size_ || depth >= 24 || half == 0.0) return;
+
+    // Order the charges by octant, x-major, in place.  Rows of charges_ and
+    // index_ are permuted together through an index sort
+    double center[3] = {n.center[0], n.center[1], n.center[2]};
+    int first = n.first;
+    int count = n.count;
+    std::vector<int> order(count);
+    for (int i = 0; i < count; ++i) order[i] = first + i;
+    auto octant = [&](int i) {
+        const double* q = &charges_[4L * i];
+        return (q[1] >= center[0] ? 4 : 0) + (q[2] >= center[1] ? 2 : 0) + (q[3] >= center[2] ? 1 : 0);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return octant(a) < octant(b); });
+
+    std::vector<double> charges(4L * count);
+    std::vector<double> extents(extents_.empty() ? 0 : count);
+    std::vector<int> index(count);
+    std::vector<int> noct(8, 0);
+    for (int i = 0; i < count; ++i) {
+        std::copy(&charges_[4L * order[i]], &charges_[4L * order[i]] + 4, &charges[4L * i]);
+        if (!extents_.empty()) extents[i] = extents_[order[i]];
+        index[i] = index_[order[i]];
+        noct[octant(order[i])]++;
+    }
+    std::copy(charges.begin(), charges.end(), &charges_[4L * first]);
+    std::copy(extents.begin(), extents.end(), extents_.begin() + first);
+    std::copy(index.begin(), index.end(), &index_[first]);
+
+    // Children of a node are stored consecutively
+    int child = nodes_.size();
+    int start = first;
+    for (int o = 0; o < 8; ++o) {
+        if (!noct[o]) continue;
+        Node c;
+        c.center[0] = center[0] + ((o & 4) ? 0.5 : -0.5) * half;
+        c.center[1] = center[1] + ((o & 2) ? 0.5 : -0.5) * half;
+        c.center[2] = center[2] + ((o & 1) ? 0.5 : -0.5) * half;
+        c.first = start;
+        c.count = noct[o];
+        start += noct[o];
+        nodes_.push_back(c);
+    }
+    int nchild = nodes_.size() - child;
+    // nodes_ may have been reallocated, so n is not used past this point
+    nodes_[node].child = child;
+    nodes_[node].nchild = nchild;
+    for (int c = child; c < child + nchild; ++c)
+        build(c, 0.5 * half, depth + 1);
+}
+
+void ChargeMultipoleTree::set_moments(const std::vector<double>& moments, int nset)
+{
+    if (extents_.size() != index_.size())
+        throw PSIEXCEPTION("ChargeMultipoleTree: the moments of point charges are fixed by their charges.");
+    if (moments.size() != (size_t) nset * nterm_ * index_.size())
+        throw PSIEXCEPTION("ChargeMultipoleTree: nset * nterm moments are needed per source.");
+    nset_ = nset;
+    source_moments_ = moments;
+    compute_moments();
+}
+
+void ChargeMultipoleTree::shift_moments(const double* m, const double d[3], double* M) const
+{
+    // (r - C)^k = sum_l (k l) d^(k-l) (r - C - d)^l, one Cartesian direction at a time
+    int p1 = order_ + 1;
+    std::vector<double> px(p1), py(p1), pz(p1);
+    px[0] = py[0] = pz[0] = 1.0;
+    for (int l = 1; l <= order_; ++l) {
+        px[l] = px[l - 1] * d[0];
+        py[l] = py[l - 1] * d[1];
+        pz[l] = pz[l - 1] * d[2];
+    }
+    for (int t = 0; t < nterm_; ++t) {
+        const int* k = powers(t);
+        double sum = 0.0;
+        for (int lx = 0; lx <= k[0]; ++lx) {
+            double cx = binom_[k[0] * p1 + lx] * px[k[0] - lx];
+            for (int ly = 0; ly <= k[1]; ++ly) {
+                double cy = cx * binom_[k[1] * p1 + ly] * py[k[1] - ly];
+                for (int lz = 0; lz <= k[2]; ++lz) {
+                    sum += cy * binom_[k[2] * p1 + lz] * pz[k[2] - lz] * m[term_[(lx * p1 + ly) * p1 + lz]];
+                }
+            }
+        }
+        M[t] += sum;
+    }
+}
+
+void ChargeMultipoleTree::compute_moments()
+{
+    size_t nblock = (size_t) nset_ * nterm_;
+    moments_.assign(nodes_.size() * nblock, 0.0);
+    std::vector<double> px(order_ + 1), py(order_ + 1), pz(order_ + 1);
+
+    // Children are stored after their parents, so a backward sweep sees
+    // every child before its parent and the parents are translations of them
+    for (int node = (int) nodes_.size() - 1; node >= 0; --node) {
+        const Node& n = nodes_[node];
+        double* M = &moments_[node * nblock];
+        if (n.child >= 0) {
+            for (int c = n.child; c < n.child + n.nchild; ++c) {
+                double d[3];
+                for (int k = 0; k < 3; ++k) d[k] = nodes_[c].center[k] - n.center[k];
+                for (int s = 0; s < nset_; ++s)
+                    shift_moments(&moments_[c * nblock + s * nterm_], d, M + s * nterm_);
+            }
+            continue;
+        }
+        for (int i = n.first; i < n.first + n.count; ++i) {
+            const double* q = &charges_[4L * i];
+            if (!source_moments_.empty()) {
+                double d[3] = {q[1] - n.center[0], q[2] - n.center[1], q[3] - n.center[2]};
+                for (int s = 0; s < nset_; ++s)
+                    shift_moments(&source_moments_[(index_[i] * (size_t) nset_ + s) * nterm_], d, M + s * nterm_);
+                continue;
+            }
+            px[0] = py[0] = pz[0] = 1.0;
+            for (int l = 1; l <= order_; ++l) {
+                px[l] = px[l - 1] * (q[1] - n.center[0]);
+                py[l] = py[l - 1] * (q[2] - n.center[1]);
+                pz[l] = pz[l - 1] * (q[3] - n.center[2]);
+            }
+            for (int t = 0; t < nterm_; ++t) {
+                const int* k = powers(t);
+                M[t] += q[0] * px[k[0]] * py[k[1]] * pz[k[2]];
+            }
+        }
+    }
+
+    // Fold in the Taylor factor (-1)^|k| / k!, once all translations are done
+    for (size_t b = 0; b < nodes_.size() * nset_; ++b) {
+        double* M = &moments_[b * nterm_];
+        for (int t = 0; t < nterm_; ++t) {
+            const int* k = powers(t);
+            M[t] *= ((k[0] + k[1] + k[2]) % 2 ? -1.0 : 1.0) * inv_fact_[t];
+        }
+    }
+}
+
+void ChargeMultipoleTree::interaction_tensor(const double R[3], std::vector<double>& T) const
+{
+    int p1 = order_ + 1;
+    T.resize((size_t) p1 * p1 * p1 * p1);
+    auto at = [p1](int n, int t, int u, int v) { return ((n * p1 + t) * p1 + u) * p1 + v; };
+
+    double R2 = R[0] * R[0] + R[1] * R[1] + R[2] * R[2];
+    double oR2 = 1.0 / R2;
+    // R^n_000 = (-1)^n (2n-1)!! / R^(2n+1)
+    double val = 1.0 / std::sqrt(R2);
+    for (int n = 0; n <= order_; ++n) {
+        T[at(n, 0, 0, 0)] = val;
+        val *= -(2 * n + 1) * oR2;
+    }
+
+    // R^n_{t+1,u,v} = t R^{n+1}_{t-1,u,v} + X R^{n+1}_{t,u,v}, and likewise in y and z.
+    // The n = 0 slab is the one kept, and it comes first.
+    for (int L = 1; L <= order_; ++L) {
+        for (int t = L; t >= 0; --t) {
+            for (int u = L - t; u >= 0; --u) {
+                int v = L - t - u;
+                for (int n = 0; n <= order_ - L; ++n) {
+                    double r;
+                    if (t) {
+                        r = R[0] * T[at(n + 1, t - 1, u, v)];
+                        if (t > 1) r += (t - 1) * T[at(n + 1, t - 2, u, v)];
+                    } else if (u) {
+                        r = R[1] * T[at(n + 1, t, u - 1, v)];
+                        if (u > 1) r += (u - 1) * T[at(n + 1, t, u - 2, v)];
+                    } else {
+                        r = R[2] * T[at(n + 1, t, u, v - 1)];
+                        if (v > 1) r += (v - 1) * T[at(n + 1, t, u, v - 2)];
+                    }
+                    T[at(n, t, u, v)] = r;
+                }
+            }
+        }
+    }
+}
+
+void ChargeMultipoleTree::local_expansion(const double E[3], double radius, double theta,
+                                          double* L, std::vector<std::pair<int,int> >& near) const
+{
+    if (nodes_.empty()) return;
+    std::vector<double> T;
+    traverse(0, E, radius, theta, L, T, near);
+}
+
+void ChargeMultipoleTree::traverse(int node, const double E[3], double radius, double theta,
+                                   double* L, std::vector<double>& T,
+                                   std::vector<std::pair<int,int> >& near) const
+{
+    const Node& n = nodes_[node];
+    double R[3] = {E[0] - n.center[0], E[1] - n.center[1], E[2] - n.center[2]};
+    double dist = std::sqrt(R[0] * R[0] + R[1] * R[1] + R[2] * R[2]);
+
+    if (radius + n.radius < theta * dist) {
+        // Multipole to local: L_j += sum_k (-1)^|k| / k! M_k T_{j+k}(E - C)
+        interaction_tensor(R, T);
+        int p1 = order_ + 1;
+        for (int s = 0; s < nset_; ++s) {
+            const double* M = &moments_[((size_t) node * nset_ + s) * nterm_];
+            double* Ls = L + (size_t) s * nterm_;
+            for (int j = 0; j < nterm_; ++j) {
+                const int* pj = powers(j);
+                int lj = pj[0] + pj[1] + pj[2];
+                double sum = 0.0;
+                for (int k = 0; k < nterm_; ++k) {
+                    const int* pk = powers(k);
+                    // Terms are ordered by |k|, so the rest are out of range
+                    if (lj + pk[0] + pk[1] + pk[2] > order_) break;
+                    sum += M[k] * T[((pj[0] + pk[0]) * p1 + pj[1] + pk[1]) * p1 + pj[2] + pk[2]];
+                }
+                Ls[j] += sum;
+            }
+        }
+    } else if (n.child < 0) {
+        near.push_back(std::make_pair(n.first, n.count));
+    } else {
+        for (int c = n.child; c < n.child + n.nchild; ++c)
+            traverse(c, E, radius, theta, L, T, near);
+    }
+}
+
+}
@@ -0,0 +1,173 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_chargetree_h_
+#define _psi_src_lib_libmints_chargetree_h_
+
+#include <vector>
+#include <utility>
+#include "psi4/libmints/typedefs.h"
+
+namespace psi {
+
+/*! \ingroup MINTS
+ *  \class ChargeMultipoleTree
+ *  \brief Octree of point charges with Cartesian multipoles for the far field.
+ *
+ *  The charges are sorted so that every node of the tree owns a contiguous
+ *  range of them, and each node carries its Cartesian moments up to order()
+ *  about its center.  For a sphere (an expansion point and a radius), the
+ *  nodes that are well separated from it (node radius + sphere radius <
+ *  theta * distance) are folded into a Taylor (local) expansion of their
+ *  potential about the expansion point, and the charges of the remaining
+ *  leaves are handed back for exact treatment.  The multipole and local
+ *  orders are truncated together, |k| + |j| <= order().
+ *
+ *  The sources may also be continuous charge distributions, each with a
+ *  center, an extent and its own moments (see set_moments()).  Node radii
+ *  then include the extents, so that well separated nodes do not overlap
+ *  the sphere, and several sets of moments (one per density) can share a
+ *  single traversal.
+ */
+class ChargeMultipoleTree
+{
+protected:
+    struct Node {
+        double center[3];
+        //! Distance from the center to the farthest charge of the node
+        double radius;
+        //! Range of the node's charges in the sorted charge array
+        int first, count;
+        //! Index of the first child, -1 for a leaf.  Children are consecutive
+        int child, nchild;
+    };
+
+    int order_;
+    int nterm_;
+    int leaf_size_;
+    //! Number of moment sets carried by each node
+    int nset_;
+
+    //! (Z,x,y,z) rows of the sorted charges
+    std::vector<double> charges_;
+    //! Extent of each sorted source, empty for point charges
+    std::vector<double> extents_;
+    //! Index of each sorted charge in the original field
+    std::vector<int> index_;
+
+    std::vector<Node> nodes_;
+    //! (-1)^|k| / k! M_k of each node, nset_ * nterm_ per node
+    std::vector<double> moments_;
+    //! Raw moments of the sources, in original order, empty for point charges
+    std::vector<double> source_moments_;
+
+    //! Cartesian powers of each multi-index, and 1/k!
+    std::vector<int> powers_;
+    std::vector<double> inv_fact_;
+    //! Multi-index of (kx,ky,kz), (order+1)^3, -1 if |k| > order
+    std::vector<int> term_;
+    //! Binomial coefficients, (order+1)^2
+    std::vector<double> binom_;
+
+    void common_init();
+    void build_tree();
+    void build(int node, double half, int depth);
+    void compute_moments();
+    //! M += moments m shifted from a center at C + d to C
+    void shift_moments(const double* m, const double d[3], double* M) const;
+    void traverse(int node, const double E[3], double radius, double theta,
+                  double* L, std::vector<double>& T, std::vector<std::pair<int,int> >& near) const;
+
+public:
+    /**
+     * @param Zxyz Charges (Z,x,y,z), one per row, in bohr
+     * @param order Order of the multipole and local expansions
+     * @param leaf_size Largest number of charges in a leaf
+     */
+    ChargeMultipoleTree(SharedMatrix Zxyz, int order = 6, int leaf_size = 32);
+    /**
+     * Tree of continuous sources, whose moments are given by set_moments()
+     * @param centers (x,y,z) of each source, in bohr
+     * @param extents Radius outside of which each source is negligible
+     * @param order Order of the multipole and local expansions
+     * @param leaf_size Largest number of sources in a leaf
+     */
+    ChargeMultipoleTree(const std::vector<double>& centers, const std::vector<double>& extents,
+                        int order = 6, int leaf_size = 32);
+
+    /**
+     * Replaces the moments of the sources and recomputes those of the nodes.
+     * @param moments nset * nterm() raw moments int rho_s (r - c)^k of each
+     *        source, about its center and in the original order
+     * @param nset Number of moment sets (e.g., one per density)
+     */
+    void set_moments(const std::vector<double>& moments, int nset);
+
+    int order() const { return order_; }
+    //! Number of Cartesian multi-indices with |k| <= order
+    int nterm() const { return nterm_; }
+    //! Multi-index of (kx,ky,kz), -1 if out of range
+    int term(int kx, int ky, int kz) const {
+        if (kx < 0 || ky < 0 || kz < 0 || kx + ky + kz > order_) return -1;
+        return term_[(kx * (order_ + 1) + ky) * (order_ + 1) + kz];
+    }
+    //! Powers (kx,ky,kz) of multi-index t
+    const int* powers(int t) const { return &powers_[3 * t]; }
+    //! 1 / (kx! ky! kz!) of multi-index t
+    double inv_fact(int t) const { return inv_fact_[t]; }
+
+    //! Number of moment sets, local expansions hold nset() * nterm() values
+    int nset() const { return nset_; }
+    size_t ncharge() const { return index_.size(); }
+    size_t nnode() const { return nodes_.size(); }
+    //! (Z,x,y,z) rows of the charges, in tree order
+    const double* charges() const { return charges_.data(); }
+    //! Index in the original field of the tree-ordered charge i
+    int original_index(int i) const { return index_[i]; }
+
+    /**
+     * Adds into L (nset() * nterm() values) the Taylor coefficients
+     *     L_j = d^j/dr^j sum_q Z_q / |r - C_q| at r = E
+     * of the charges well separated from the sphere (E, radius), and
+     * appends the (first, count) ranges of the other charges to near.
+     */
+    void local_expansion(const double E[3], double radius, double theta,
+                         double* L, std::vector<std::pair<int,int> >& near) const;
+
+    /**
+     * Derivatives of 1/|R| with respect to R, by the McMurchie-Davidson
+     * recursion.  T is used as workspace of (order+1)^4 values and on return
+     * T[(t * (order+1) + u) * (order+1) + v] = d^(t+u+v)/dx^t dy^u dz^v 1/|R|
+     * for t+u+v <= order().
+     */
+    void interaction_tensor(const double R[3], std::vector<double>& T) const;
+};
+
+}
+
+#endif
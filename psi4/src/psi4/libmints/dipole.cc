@@ -67,6 +67,18 @@ DipoleInt::~DipoleInt()
     delete[] buffer_;
 }
 
+bool DipoleInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* DipoleInt::clone() const
+{
+    OneBodyAOInt* ints = new DipoleInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    copy_settings(ints);
+    return ints;
+}
+
 SharedVector DipoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, const Vector3& origin)
 {
     std::shared_ptr<Vector> sret(new Vector(3));
@@ -60,6 +60,10 @@ public:
     //! Virtual destructor
     virtual ~DipoleInt();
 
+        virtual bool cloneable() const;
+    /// Returns a new DipoleInt with the same origin and settings
+    virtual OneBodyAOInt* clone() const;
+
     //! Does the method provide first derivatives?
     bool has_deriv1() { return true; }
 
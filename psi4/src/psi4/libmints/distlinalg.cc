@@ -0,0 +1,290 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "distlinalg.h"
+
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+
+#ifdef HAVE_SCALAPACK
+#include <mpi.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef HAVE_ELPA
+extern "C" {
+#include <elpa/elpa.h>
+}
+#endif
+
+#ifdef USE_FCMANGLE_H
+#include "FCMangle.h"
+#define F_NUMROC   FC_GLOBAL(numroc  , NUMROC  )
+#define F_DESCINIT FC_GLOBAL(descinit, DESCINIT)
+#define F_PDSYEVD  FC_GLOBAL(pdsyevd , PDSYEVD )
+#define F_PDGEMM   FC_GLOBAL(pdgemm  , PDGEMM  )
+#else
+#define F_NUMROC   numroc_
+#define F_DESCINIT descinit_
+#define F_PDSYEVD  pdsyevd_
+#define F_PDGEMM   pdgemm_
+#endif
+
+extern "C" {
+void Cblacs_get(int icontxt, int what, int* val);
+void Cblacs_gridinit(int* icontxt, const char* order, int nprow, int npcol);
+void Cblacs_gridinfo(int icontxt, int* nprow, int* npcol, int* myrow, int* mycol);
+int F_NUMROC(const int* n, const int* nb, const int* iproc, const int* isrcproc, const int* nprocs);
+void F_DESCINIT(int* desc, const int* m, const int* n, const int* mb, const int* nb, const int* irsrc,
+                const int* icsrc, const int* ictxt, const int* lld, int* info);
+void F_PDSYEVD(const char* jobz, const char* uplo, const int* n, double* a, const int* ia, const int* ja,
+               const int* desca, double* w, double* z, const int* iz, const int* jz, const int* descz,
+               double* work, const int* lwork, int* iwork, const int* liwork, int* info);
+void F_PDGEMM(const char* transa, const char* transb, const int* m, const int* n, const int* k,
+              const double* alpha, const double* a, const int* ia, const int* ja, const int* desca,
+              const double* b, const int* ib, const int* jb, const int* descb, const double* beta,
+              double* c, const int* ic, const int* jc, const int* descc);
+}
+#endif
+
+namespace psi {
+
+namespace distlinalg {
+
+#ifdef HAVE_SCALAPACK
+namespace {
+
+/// The process grid, built on first use and kept for the life of the process
+struct Grid {
+    int context;
+    int nprow;
+    int npcol;
+    int myrow;
+    int mycol;
+};
+
+const Grid& grid()
+{
+    static Grid g = {-1, 0, 0, -1, -1};
+    if (g.context < 0) {
+        int nrank;
+        MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+        // As square as the rank count allows
+        int nprow = (int) std::sqrt((double) nrank);
+        while (nrank % nprow) nprow--;
+        Cblacs_get(-1, 0, &g.context);
+        Cblacs_gridinit(&g.context, "Row", nprow, nrank / nprow);
+        Cblacs_gridinfo(g.context, &g.nprow, &g.npcol, &g.myrow, &g.mycol);
+    }
+    return g;
+}
+
+int block_size()
+{
+    return Process::environment.options.get_int("LINALG_DISTRIBUTED_BLOCK");
+}
+
+/// An n x n matrix in nb x nb block-cyclic layout on the grid
+struct BlockCyclic {
+    int n;
+    int nb;
+    int mloc;
+    int nloc;
+    int desc[9];
+    std::vector<double> local;
+
+    BlockCyclic(int n_, int nb_) : n(n_), nb(nb_)
+    {
+        const Grid& g = grid();
+        int zero = 0;
+        mloc = F_NUMROC(&n, &nb, &g.myrow, &zero, &g.nprow);
+        nloc = F_NUMROC(&n, &nb, &g.mycol, &zero, &g.npcol);
+        int lld = std::max(1, mloc);
+        int info;
+        F_DESCINIT(desc, &n, &n, &nb, &nb, &zero, &zero, &g.context, &lld, &info);
+        if (info) throw PSIEXCEPTION("distlinalg: DESCINIT failed.");
+        local.assign(std::max(1, mloc) * (size_t) std::max(1, nloc), 0.0);
+    }
+
+    int global_row(int il) const { return ((il / nb) * grid().nprow + grid().myrow) * nb + il % nb; }
+    int global_col(int jl) const { return ((jl / nb) * grid().npcol + grid().mycol) * nb + jl % nb; }
+
+    /// Pick this rank's blocks out of a replicated column-major matrix
+    void scatter(const double* full)
+    {
+        for (int jl = 0; jl < nloc; jl++) {
+            int j = global_col(jl);
+            for (int il = 0; il < mloc; il++) {
+                local[il + jl * (size_t) mloc] = full[global_row(il) + j * (size_t) n];
+            }
+        }
+    }
+
+    /// Reassemble the replicated column-major matrix on every rank
+    void gather(double* full) const
+    {
+        size_t size = n * (size_t) n;
+        ::memset(static_cast<void*>(full), '\0', sizeof(double) * size);
+        for (int jl = 0; jl < nloc; jl++) {
+            int j = global_col(jl);
+            for (int il = 0; il < mloc; il++) {
+                full[global_row(il) + j * (size_t) n] = local[il + jl * (size_t) mloc];
+            }
+        }
+        // MPI counts are ints, large matrices go over in chunks
+        const size_t max_count = INT_MAX / 2;
+        for (size_t offset = 0L; offset < size; offset += max_count) {
+            int count = (int) std::min(max_count, size - offset);
+            MPI_Allreduce(MPI_IN_PLACE, full + offset, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        }
+    }
+};
+
+void pdsyevd(int n, BlockCyclic& A, BlockCyclic& Z, double* w)
+{
+    int one = 1;
+    int info;
+    int lwork = -1;
+    int liwork = -1;
+    double work_query;
+    int iwork_query;
+    F_PDSYEVD("V", "U", &n, A.local.data(), &one, &one, A.desc, w, Z.local.data(), &one, &one, Z.desc,
+              &work_query, &lwork, &iwork_query, &liwork, &info);
+    lwork = (int) work_query;
+    liwork = std::max(1, iwork_query);
+    std::vector<double> work(lwork);
+    std::vector<int> iwork(liwork);
+    F_PDSYEVD("V", "U", &n, A.local.data(), &one, &one, A.desc, w, Z.local.data(), &one, &one, Z.desc,
+              work.data(), &lwork, iwork.data(), &liwork, &info);
+    if (info) throw PSIEXCEPTION("distlinalg::syev: PDSYEVD failed with info = " + std::to_string(info));
+}
+
+#ifdef HAVE_ELPA
+void elpa_solve(int n, BlockCyclic& A, BlockCyclic& Z, double* w)
+{
+    const Grid& g = grid();
+    int error;
+    if (elpa_init(20171201) != ELPA_OK) throw PSIEXCEPTION("distlinalg::syev: ELPA API version not supported.");
+    elpa_t handle = elpa_allocate(&error);
+    elpa_set_integer(handle, "na", n, &error);
+    elpa_set_integer(handle, "nev", n, &error);
+    elpa_set_integer(handle, "local_nrows", A.mloc, &error);
+    elpa_set_integer(handle, "local_ncols", A.nloc, &error);
+    elpa_set_integer(handle, "nblk", A.nb, &error);
+    elpa_set_integer(handle, "mpi_comm_parent", (int) MPI_Comm_c2f(MPI_COMM_WORLD), &error);
+    elpa_set_integer(handle, "process_row", g.myrow, &error);
+    elpa_set_integer(handle, "process_col", g.mycol, &error);
+    if (elpa_setup(handle) != ELPA_OK) throw PSIEXCEPTION("distlinalg::syev: ELPA setup failed.");
+    elpa_set_integer(handle, "solver", ELPA_SOLVER_2STAGE, &error);
+    elpa_eigenvectors_a_h_a_d(handle, A.local.data(), w, Z.local.data(), &error);
+    elpa_deallocate(handle, &error);
+    if (error != ELPA_OK) throw PSIEXCEPTION("distlinalg::syev: ELPA eigensolver failed.");
+}
+#endif
+
+}  // namespace
+#endif
+
+bool available()
+{
+#ifdef HAVE_SCALAPACK
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) return false;
+    int nrank;
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank);
+    return nrank > 1;
+#else
+    return false;
+#endif
+}
+
+bool use_distributed(int n)
+{
+#ifdef HAVE_SCALAPACK
+    int min_dim = Process::environment.options.get_int("LINALG_DISTRIBUTED_MIN_DIM");
+    return min_dim > 0 && n >= min_dim && available();
+#else
+    return false;
+#endif
+}
+
+void syev(int n, double* A, double* w)
+{
+#ifdef HAVE_SCALAPACK
+    BlockCyclic Ad(n, block_size());
+    BlockCyclic Zd(n, block_size());
+    // A is symmetric, so row- and column-major are the same matrix
+    Ad.scatter(A);
+
+    std::string solver = Process::environment.options.get_str("LINALG_DISTRIBUTED_SOLVER");
+    if (solver == "ELPA") {
+#ifdef HAVE_ELPA
+        elpa_solve(n, Ad, Zd, w);
+#else
+        throw PSIEXCEPTION("distlinalg::syev: LINALG_DISTRIBUTED_SOLVER ELPA requested, but Psi4 was built without ELPA.");
+#endif
+    } else {
+        pdsyevd(n, Ad, Zd, w);
+    }
+
+    // Column k of the column-major Z is row k of the row-major result, as with DSYEV
+    Zd.gather(A);
+#else
+    throw PSIEXCEPTION("distlinalg::syev: Psi4 was built without ScaLAPACK.");
+#endif
+}
+
+void gemm(char transa, char transb, int n, double alpha, const double* A, const double* B, double beta, double* C)
+{
+#ifdef HAVE_SCALAPACK
+    int nb = block_size();
+    BlockCyclic Ad(n, nb);
+    BlockCyclic Bd(n, nb);
+    BlockCyclic Cd(n, nb);
+    Ad.scatter(A);
+    Bd.scatter(B);
+    Cd.scatter(C);
+
+    // Row-major C = op(A) op(B) is column-major C^T = op(B)^T op(A)^T
+    int one = 1;
+    F_PDGEMM(&transb, &transa, &n, &n, &n, &alpha, Bd.local.data(), &one, &one, Bd.desc, Ad.local.data(), &one,
+             &one, Ad.desc, &beta, Cd.local.data(), &one, &one, Cd.desc);
+
+    Cd.gather(C);
+#else
+    throw PSIEXCEPTION("distlinalg::gemm: Psi4 was built without ScaLAPACK.");
+#endif
+}
+
+}  // namespace distlinalg
+
+}  // namespace psi
@@ -0,0 +1,71 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef LIBMINTS_DISTLINALG_H
+#define LIBMINTS_DISTLINALG_H
+
+/**
+* distlinalg.h
+* Block-cyclic ScaLAPACK (optionally ELPA) kernels for large dense blocks.
+*
+* Inputs and outputs are replicated on every MPI rank, in the same layout
+* the serial C_DSYEV/C_DGEMM calls use, so a caller can switch on
+* use_distributed(n) and otherwise keep its serial path unchanged. Every
+* rank must make the same calls in the same order (all of them are
+* collective over MPI_COMM_WORLD). Without -DENABLE_SCALAPACK=ON, or on a
+* single rank, use_distributed() is always false.
+**/
+
+namespace psi {
+
+namespace distlinalg {
+
+/// Is the distributed backend compiled in and running on more than one rank?
+bool available();
+
+/// Should an n x n block go through the distributed kernels (LINALG_DISTRIBUTED_MIN_DIM)?
+bool use_distributed(int n);
+
+/**
+* Symmetric eigendecomposition, equivalent to C_DSYEV('V', 'U', n, A, n, w, ...).
+* On exit row k of A (row-major) holds the eigenvector of w[k], w ascending.
+* Throws on failure.
+**/
+void syev(int n, double* A, double* w);
+
+/**
+* Square matrix multiply, equivalent to
+* C_DGEMM(transa, transb, n, n, n, alpha, A, n, B, n, beta, C, n).
+**/
+void gemm(char transa, char transb, int n, double alpha, const double* A, const double* B, double beta, double* C);
+
+}  // namespace distlinalg
+
+}  // namespace psi
+
+#endif
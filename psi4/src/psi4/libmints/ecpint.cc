@@ -44,6 +44,9 @@
 #include <cmath>
 #include <algorithm>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
 
 namespace psi {
 
@@ -343,24 +346,47 @@ bool AngularIntegral::isZero(int k, int l, int m, int lam, int mu, int rho, int
 	else return true;
 }
 
+std::shared_ptr<const AngularIntegral> AngularIntegral::shared(int LB, int LE) {
+	static std::mutex lock;
+	static std::map<std::pair<int, int>, std::shared_ptr<const AngularIntegral> > tables;
+	
+	std::lock_guard<std::mutex> guard(lock);
+	std::shared_ptr<const AngularIntegral> &table = tables[std::make_pair(LB, LE)];
+	if (!table) {
+		std::shared_ptr<AngularIntegral> built = std::make_shared<AngularIntegral>(LB, LE);
+		built->compute();
+		table = built;
+	}
+	return table;
+}
+
 //****************************************** RADIAL INTEGRAL *********************************************
 
-RadialIntegral::RadialIntegral() {}
+RadialIntegral::RadialIntegral() : paramsA(nullptr), paramsB(nullptr) {}
 
 void RadialIntegral::init(int maxL, double tol, int small, int large) {
 	bigGrid.initGrid(large, ONEPOINT);
 	smallGrid.initGrid(small, TWOPOINT);
 	smallGrid.transformZeroInf();
 	
-	bessie.init(maxL, 1600, 200, tol);
+	// The Bessel tabulation is by far the most expensive part, and read-only once built
+	static std::mutex lock;
+	static std::map<std::pair<int, double>, std::shared_ptr<const BesselFunction> > tables;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		std::shared_ptr<const BesselFunction> &table = tables[std::make_pair(maxL, tol)];
+		if (!table) table = std::make_shared<BesselFunction>(maxL, 1600, 200, tol);
+		bessie = table;
+	}
 	
 	tolerance = tol;
+	paramsA = paramsB = nullptr;
 }
 
 void RadialIntegral::buildBessel(std::vector<double> &r, int nr, int maxL, TwoIndex<double> &values, double weight) {
 	std::vector<double> besselValues;
 	for (int i = 0; i < nr; i++) {
-		bessie.calculate(weight * r[i], maxL, besselValues);
+		bessie->calculate(weight * r[i], maxL, besselValues);
 		for (int l = 0; l <= maxL; l++) values(l, i) = besselValues[l];
 	}
 }
@@ -376,6 +402,14 @@ double RadialIntegral::integrand(double r, double *p, int ix) {
 }
 
 void RadialIntegral::buildParameters(const GaussianShell &shellA, const GaussianShell &shellB, ShellPairData &data) {
+	// Only the exponents and the relative positions enter
+	double AB[6] = {data.A[0], data.A[1], data.A[2], data.B[0], data.B[1], data.B[2]};
+	if (paramsA == shellA.exps() && paramsB == shellB.exps() && std::equal(AB, AB + 6, paramsAB))
+		return;
+	paramsA = shellA.exps();
+	paramsB = shellB.exps();
+	std::copy(AB, AB + 6, paramsAB);
+	
 	int npA = shellA.nprimitive();
 	int npB = shellB.nprimitive();
 
@@ -435,8 +469,6 @@ void RadialIntegral::type1(int maxL, int N, int offset, const GaussianShell &U,
 	int npA = shellA.nprimitive(); 
 	int npB = shellB.nprimitive();
 	
-	buildParameters(shellA, shellB, data);
-	
 	int gridSize = bigGrid.getN();
 
 	// Now pretabulate integrand
@@ -657,12 +689,18 @@ ECPInt::ECPInt(std::vector<SphericalTransform>& st, std::shared_ptr<BasisSet> bs
 	int maxam1 = bs1->max_am(); int maxam2 = bs2->max_am();  
 	int maxLB = maxam1 > maxam2 ? maxam1 : maxam2;
     int maxLU = bs1_->max_ecp_am();
-	angInts.init(maxLB + deriv, maxLU);
-	angInts.compute();
+	angInts = AngularIntegral::shared(maxLB + deriv, maxLU);
 	radInts.init(2*(maxLB + deriv) + maxLU);
 	
 	int maxnao1 = INT_NCART(maxam1);
 	int maxnao2 = INT_NCART(maxam2);
+	if (deriv == 1) {
+		// x, y, z for every atom, as for PotentialInt
+		set_chunks(3*natom_);
+		maxnao1 *= 3*natom_;
+	} else if (deriv > 1) {
+		throw PSIEXCEPTION("ECPInt: deriv > 1 is not supported.");
+	}
 	buffer_ = new double[maxnao1*maxnao2];
 	
 }
@@ -754,7 +792,7 @@ void ECPInt::type1(const GaussianShell &U, const GaussianShell &shellA, const Ga
 												
 												for (int lam = lparity; lam <= ix; lam+=2) {
 													for (int mu = mparity; mu <= lam; mu+=2) 
-														values(na, nb) += C * angInts.getIntegral(k, l, m, lam, msign*mu) * radials(ix, lam, lam+msign*mu);
+														values(na, nb) += C * angInts->getIntegral(k, l, m, lam, msign*mu) * radials(ix, lam, lam+msign*mu);
 												}
 								
 											}
@@ -836,7 +874,7 @@ void ECPInt::type2(int lam, const GaussianShell& U, const GaussianShell &shellA,
 															val2 = val1 * SA(lam1, lam1+mu1) * SB(lam2, lam2+mu2);
 															
 															for (int mu = -lam; mu <= lam; mu++) 
-																values(na, nb, lam+mu) += val2 * angInts.getIntegral(alpha_x, alpha_y, alpha_z, lam, mu, lam1, mu1) * angInts.getIntegral(beta_x, beta_y, beta_z, lam, mu, lam2, mu2);
+																values(na, nb, lam+mu) += val2 * angInts->getIntegral(alpha_x, alpha_y, alpha_z, lam, mu, lam1, mu1) * angInts->getIntegral(beta_x, beta_y, beta_z, lam, mu, lam2, mu2);
 							
 														}
 													}
@@ -886,6 +924,8 @@ void ECPInt::compute_shell_pair(const GaussianShell &U, const GaussianShell &she
 	data.RAB2 = RAB[0]*RAB[0] + RAB[1]*RAB[1] + RAB[2]*RAB[2];
 	data.RABm = sqrt(data.RAB2);
 	
+	radInts.buildParameters(shellA, shellB, data);
+	
 	// Construct coefficients 
 	FiveIndex<double> CA(1, data.ncartA, data.LA+1, data.LA+1, data.LA+1);
 	FiveIndex<double> CB(1, data.ncartB, data.LB+1, data.LB+1, data.LB+1);
@@ -933,6 +973,93 @@ void ECPInt::compute_pair(const GaussianShell &shellA, const GaussianShell &shel
     }
 }
 
+namespace {
+/// Shell over the exponents of s with angular momentum am and every coefficient scaled by 2 zeta (if raised)
+GaussianShell shifted_shell(const GaussianShell &s, int am, bool raised, std::vector<double> &coefs) {
+	coefs.resize(s.nprimitive());
+	for (int p = 0; p < s.nprimitive(); p++)
+		coefs[p] = raised ? 2.0 * s.exp(p) * s.coef(p) : s.coef(p);
+	return GaussianShell(Gaussian, am, s.nprimitive(), coefs.data(), coefs.data(), coefs.data(), s.exps(),
+	                     Cartesian, s.ncenter(), s.center(), -1);
+}
+
+/// Index of the Cartesian component (x, y, z) in a shell of angular momentum x + y + z
+int cart_index(int x, int y, int z) {
+	int i = y + z;
+	return i*(i+1)/2 + z;
+}
+}
+
+void ECPInt::compute_pair_deriv1(const GaussianShell &shellA, const GaussianShell &shellB) {
+	int LA = shellA.am(), LB = shellB.am();
+	int ncartA = shellA.ncartesian(), ncartB = shellB.ncartesian();
+	int size = ncartA * ncartB;
+	memset(buffer_, 0, 3 * natom_ * size * sizeof(double));
+	
+	// d/dAx x_A^l exp(-zeta x_A^2) = 2 zeta x_A^(l+1) exp(..) - l x_A^(l-1) exp(..)
+	std::vector<double> cAp, cAm, cBp, cBm;
+	GaussianShell Ap = shifted_shell(shellA, LA + 1, true, cAp);
+	GaussianShell Am = shifted_shell(shellA, LA > 0 ? LA - 1 : 0, false, cAm);
+	GaussianShell Bp = shifted_shell(shellB, LB + 1, true, cBp);
+	GaussianShell Bm = shifted_shell(shellB, LB > 0 ? LB - 1 : 0, false, cBm);
+	
+	int atomA = shellA.ncenter(), atomB = shellB.ncenter();
+	TwoIndex<double> VAp, VAm, VBp, VBm;
+	std::vector<double> dA(3 * size), dB(3 * size);
+	for (int i = 0; i < bs1_->n_ecp_shell(); i++) {
+		const GaussianShell &U = bs1_->ecp_shell(i);
+		compute_shell_pair(U, Ap, shellB, VAp);
+		compute_shell_pair(U, shellA, Bp, VBp);
+		if (LA > 0) compute_shell_pair(U, Am, shellB, VAm);
+		if (LB > 0) compute_shell_pair(U, shellA, Bm, VBm);
+		
+		int na = 0;
+		for (int x1 = LA; x1 >= 0; x1--) {
+			for (int y1 = LA-x1; y1 >= 0; y1--) {
+				int z1 = LA - x1 - y1;
+				int nb = 0;
+				for (int x2 = LB; x2 >= 0; x2--) {
+					for (int y2 = LB-x2; y2 >= 0; y2--) {
+						int z2 = LB - x2 - y2;
+						int ab = na * ncartB + nb;
+						
+						dA[ab] = VAp(cart_index(x1+1, y1, z1), nb);
+						dA[size + ab] = VAp(cart_index(x1, y1+1, z1), nb);
+						dA[2*size + ab] = VAp(cart_index(x1, y1, z1+1), nb);
+						if (x1) dA[ab] -= x1 * VAm(cart_index(x1-1, y1, z1), nb);
+						if (y1) dA[size + ab] -= y1 * VAm(cart_index(x1, y1-1, z1), nb);
+						if (z1) dA[2*size + ab] -= z1 * VAm(cart_index(x1, y1, z1-1), nb);
+						
+						dB[ab] = VBp(na, cart_index(x2+1, y2, z2));
+						dB[size + ab] = VBp(na, cart_index(x2, y2+1, z2));
+						dB[2*size + ab] = VBp(na, cart_index(x2, y2, z2+1));
+						if (x2) dB[ab] -= x2 * VBm(na, cart_index(x2-1, y2, z2));
+						if (y2) dB[size + ab] -= y2 * VBm(na, cart_index(x2, y2-1, z2));
+						if (z2) dB[2*size + ab] -= z2 * VBm(na, cart_index(x2, y2, z2-1));
+						nb++;
+					}
+				}
+				na++;
+			}
+		}
+		
+		// Translational invariance of each ECP center's term gives its own derivative
+		int atomC = U.ncenter();
+		for (int xyz = 0; xyz < 3; xyz++) {
+			double *bufA = buffer_ + (3*atomA + xyz) * size;
+			double *bufB = buffer_ + (3*atomB + xyz) * size;
+			double *bufC = buffer_ + (3*atomC + xyz) * size;
+			for (int ab = 0; ab < size; ab++) {
+				double a = dA[xyz*size + ab];
+				double b = dB[xyz*size + ab];
+				bufA[ab] += a;
+				bufB[ab] += b;
+				bufC[ab] -= a + b;
+			}
+		}
+	}
+}
+
 ECPSOInt::ECPSOInt(const std::shared_ptr<OneBodyAOInt> &aoint, const std::shared_ptr<IntegralFactory> &fact)
     : OneBodySOInt(aoint, fact)
 {
@@ -41,6 +41,7 @@
 #ifndef ECPINT_HEAD
 #define ECPINT_HEAD
 
+#include <memory>
 #include <vector>
 #include "psi4/libmints/multiarr.h"
 #include "psi4/libmints/gaussquad.h"
@@ -180,6 +181,12 @@ public:
 	bool isZero(int k, int l, int m, int lam, int mu, double tolerance) const;
 	/// is Omega(k, l, m, lam, mu, rho, sigma) zero to within a given tolerance?
 	bool isZero(int k, int l, int m, int lam, int mu, int rho, int sigma, double tolerance) const;	
+
+	/**
+	  * The computed integrals for LB, LE, built on first request and shared by every
+	  * ECPInt of the process (and so by every thread and geometry) from then on.
+	  */
+	static std::shared_ptr<const AngularIntegral> shared(int LB, int LE);
 };
 
 
@@ -198,11 +205,14 @@ private:
 	GCQuadrature bigGrid;
 	/// The smaller integration grid, default for the type 2 integrals
     GCQuadrature smallGrid;
-	/// Modified spherical Bessel function of the first kind
-	BesselFunction bessie;
+	/// Modified spherical Bessel function of the first kind, tabulated once per maxL and tolerance
+	std::shared_ptr<const BesselFunction> bessie;
 	
 	/// Matrices of parameters needed in both type 1 and 2 integrations
 	TwoIndex<double> p, P, P2, K;
+	/// Exponents and positions (relative to the ECP center) the parameters were last built for
+	const double *paramsA, *paramsB;
+	double paramsAB[6];
 	
 	/// Tolerance for change below which an integral is considered converged
 	double tolerance;
@@ -272,10 +282,12 @@ public:
 	
 	/**
 	  * Given two GaussianShells, builds the parameters needed by both kind of integral. 
+	  * Must be called before type1() and type2() for a new shell pair or ECP center;
+	  * returns at once if the exponents and relative positions are those of the last call,
+	  * as for the other ECP shells on a center, or the shifted shells of derivatives.
 	  * @param shellA - the first GaussianShell
 	  * @param shellB - the second GaussianShell
-	  * @param A - position vector (relative to the ECP center) of shell A
-	  * @param B - position vector (relative to the ECP center) of shell B
+	  * @param data - positions of A and B relative to the ECP center, among others
 	  */
 	void buildParameters(const GaussianShell &shellA, const GaussianShell &shellB, ShellPairData &data);
 	
@@ -325,8 +337,8 @@ class ECPInt : public OneBodyAOInt
 private:
 	/// The interface to the radial integral calculation
 	RadialIntegral radInts;
-	/// The angular integrals, which can be reused over all ECP centers
-	AngularIntegral angInts;
+	/// The angular integrals, which can be reused over all ECP centers (and ECPInt objects)
+	std::shared_ptr<const AngularIntegral> angInts;
 	
 	/// Worker functions for calculating binomial expansion coefficients
 	double calcC(int a, int m, double A) const;
@@ -339,6 +351,12 @@ private:
 	
 	/// Overridden shell-pair integral calculation over all ECP centers
 	void compute_pair(const GaussianShell &shellA, const GaussianShell &shellB);
+	/**
+	  * Overridden first derivatives over all ECP centers: 3*natom chunks (x, y, z of each atom),
+	  * from the integrals over shells with angular momentum raised and lowered by one.
+	  * The ECP centers get the negative sum of the basis center derivatives.
+	  */
+	void compute_pair_deriv1(const GaussianShell &shellA, const GaussianShell &shellB);
 	
 	/// Computes the overall ECP integrals over the given ECP center and shell pair
     void compute_shell_pair(const GaussianShell &U, const GaussianShell &shellA, const GaussianShell &shellB, TwoIndex<double> &values, int shiftA = 0, int shiftB = 0);
@@ -66,6 +66,18 @@ ElectricFieldInt::~ElectricFieldInt()
     delete[] buffer_;
 }
 
+bool ElectricFieldInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* ElectricFieldInt::clone() const
+{
+    OneBodyAOInt* ints = new ElectricFieldInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    copy_settings(ints);
+    return ints;
+}
+
 Vector3 ElectricFieldInt::nuclear_contribution(const Vector3 &origin, std::shared_ptr<Molecule> mol)
 {
     int natom = mol->natom();
@@ -53,6 +53,9 @@ public:
     ElectrostaticInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv=0);
     ~ElectrostaticInt();
 
+    /// The PotentialInt clone would not compute these integrals
+    bool cloneable() const { return false; }
+
     // Intel C++ 12 thinks we're trying to overload the "void compute_shell(int, int)" and warns us about it.
     // The following line is to shut it up.
     #pragma warning disable 1125
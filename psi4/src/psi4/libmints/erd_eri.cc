@@ -668,6 +668,21 @@ size_t ERDTwoElectronInt::compute_shell(int shell_i, int shell_j, int shell_k, i
 }
 
 
+size_t ERDTwoElectronInt::compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out)
+{
+    // compute_shell() always fills target_ (zeros if ERD screened the quartet),
+    // so point it into the caller's buffer and skip the copy out of buffer()
+    double* start = out;
+    for (const auto& q : quartets) {
+        target_ = out;
+        compute_shell(q[0], q[1], q[2], q[3]);
+        out += quartet_size(q[0], q[1], q[2], q[3]);
+    }
+    target_ = target_full_;
+    return out - start;
+}
+
+
 size_t ERDTwoElectronInt::compute_shell_deriv1(int, int, int, int)
 {
     throw PSIEXCEPTION("Derivatives for ERD are NYI!");
@@ -130,6 +130,7 @@ public:
     void compute_scratch_size();
     virtual size_t compute_shell(const psi::AOShellCombinationsIterator&);
     virtual size_t compute_shell(int, int, int, int);
+    virtual size_t compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out);
     virtual size_t compute_shell_deriv1(int, int, int, int);
     virtual size_t compute_shell_deriv2(int, int, int, int);
 };
@@ -30,7 +30,10 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/fjt.h"
-;
+
+#include <cstring>
+#include <utility>
+
 using namespace psi;
 
 /////////
@@ -179,6 +182,75 @@ void ErfERI::setOmega(double omega)
     (static_cast<ErfFundamental*>(fjt_))->setOmega(omega);
 }
 
+/////////
+// CoulombErfERI
+/////////
+
+CoulombErfERI::CoulombErfERI(double omega, const IntegralFactory *integral, bool use_shell_pairs)
+    : TwoElectronInt(integral, 0, use_shell_pairs), erf_wanted_(true)
+{
+    int max_am = basis1()->max_am() + basis2()->max_am() + basis3()->max_am() + basis4()->max_am();
+    fjt_ = new Taylor_Fjt(max_am + 1, 1e-15);
+    erf_fjt_ = new ErfFundamental(omega, max_am + 1);
+
+    size_t size = INT_NCART(basis1()->max_am()) * INT_NCART(basis2()->max_am()) *
+                  INT_NCART(basis3()->max_am()) * INT_NCART(basis4()->max_am());
+    erf_target_ = new double[size];
+    memset(erf_target_, 0, sizeof(double) * size);
+}
+
+CoulombErfERI::~CoulombErfERI()
+{
+    delete fjt_;
+    delete erf_fjt_;
+    delete[] erf_target_;
+}
+
+size_t CoulombErfERI::compute_shell(int sh1, int sh2, int sh3, int sh4)
+{
+    size_t ncomputed = TwoElectronInt::compute_shell(sh1, sh2, sh3, sh4);
+    if (!ncomputed || !erf_wanted_) return ncomputed;
+
+    // The libint order TwoElectronInt::compute_shell() chose
+    int s1 = sh1, s2 = sh2, s3 = sh3, s4 = sh4;
+    if (p12_) std::swap(s1, s2);
+    if (p34_) std::swap(s3, s4);
+    if (p13p24_) {
+        std::swap(s1, s3);
+        std::swap(s2, s4);
+    }
+
+    recompute_quartet(erf_fjt_, s1, s2, s3, s4);
+    if (p12_ || p34_ || p13p24_) {
+        permute_target(source_, erf_target_, s1, s2, s3, s4, p12_, p34_, p13p24_);
+    } else {
+        memcpy(erf_target_, source_, curr_buff_size_ * sizeof(double));
+    }
+    return ncomputed;
+}
+
+size_t CoulombErfERI::compute_shell_batch(const std::vector<ShellQuartet>& quartets, const std::vector<char>& erf,
+                                          double* out, double* erf_out)
+{
+    double* start = out;
+    for (size_t i = 0; i < quartets.size(); i++) {
+        const ShellQuartet& q = quartets[i];
+        size_t n1234 = quartet_size(q[0], q[1], q[2], q[3]);
+        erf_wanted_ = erf[i];
+        if (compute_shell(q[0], q[1], q[2], q[3])) {
+            ::memcpy(out, target_full_, sizeof(double) * n1234);
+            if (erf[i]) ::memcpy(erf_out, erf_target_, sizeof(double) * n1234);
+        } else {
+            ::memset(out, 0, sizeof(double) * n1234);
+            if (erf[i]) ::memset(erf_out, 0, sizeof(double) * n1234);
+        }
+        out += n1234;
+        erf_out += n1234;
+    }
+    erf_wanted_ = true;
+    return out - start;
+}
+
 /////////
 // ErfComplementERI
 /////////
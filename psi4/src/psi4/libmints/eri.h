@@ -32,6 +32,9 @@
 #include <libint/libint.h>
 #include <libint/libderiv.h>
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/shellpair.h"
+
+#include <vector>
 
 namespace psi {
 
@@ -42,31 +45,6 @@ class Fjt;
 class AOShellCombinationsIterator;
 class CorrelationFactor;
 
-/**
-  * \ingroup MINTS
-  * Structure to hold precomputed shell pair information
-  */
-typedef struct ShellPair_typ {
-    //! Shells for this information.
-    int i, j;
-    //! Matrix over primitives with x, y, z coordinate of average Gaussian
-    double ***  P;
-    //! Distance between shell i and shell j centers
-    double AB[3];
-    //! Distance between P and shell i center
-    double ***  PA;
-    //! Distance between P and shell j center
-    double ***  PB;
-    //! Array of alphas for both centers
-    double *  ai, *  aj;
-    //! Array of the gammas (ai + aj)
-    double **  gamma;
-    //! Contraction coefficients
-    double *  ci, *  cj;
-    //! Overlap between primitives on i and j
-    double **  overlap;
-} ShellPair;
-
 /*! \ingroup MINTS
  *  \class ERI
  *  \brief Capable of computing two-electron repulsion integrals.
@@ -85,34 +63,32 @@ protected:
     //! Computes the fundamental
     Fjt *fjt_;
 
+    //! Boys function arguments, reduced exponents, prefactors and values of a quartet's primitives
+    std::vector<double> fjt_T_, fjt_rho_, fjt_scale_, fjt_F_;
+
+    //! Number of primitive quartets of the last compute_quartet()
+    size_t nprim_;
+
     //! Computes the ERIs between four shells.
     size_t compute_quartet(int, int, int, int);
 
+    //! Runs libint on the primitive data in libint_ and transforms the result into source_
+    size_t build_quartet(int, int, int, int, size_t nprim);
+
+    //! Redoes the last compute_quartet() (same shells, same order) with the fundamentals of fjt
+    size_t recompute_quartet(Fjt *fjt, int, int, int, int);
+
     //! Computes the ERI derivatives between four shells.
     size_t compute_quartet_deriv1(int, int, int, int);
 
     //! Computes the ERI second derivative between four shells.
     size_t compute_quartet_deriv2(int, int, int, int);
 
-    //! Form shell pair information. Must be smart enough to handle arbitrary basis sets
-    void init_shell_pairs12();
-    void init_shell_pairs34();
-
-    //! Free shell pair information
-    void free_shell_pairs12();
-    void free_shell_pairs34();
-
     //! Should we use shell pair information?
     bool use_shell_pairs_;
 
-    //! Stack memory pointer, used in init_shell_pairs, freed in destructor
-    double *stack12_, *stack34_;
-
-    //! Shell pair information
-    ShellPair **pairs12_, **pairs34_;
-
-    //! Evaluates how much memory (in doubles) is needed to store shell pair data
-    size_t memory_to_store_shell_pairs(const std::shared_ptr<BasisSet>&, const std::shared_ptr<BasisSet>&);
+    //! Screened primitive pair data, shared with every integral object of the factory
+    std::shared_ptr<ShellPairStore> pairs_;
 
     //! Original shell index requested
     int osh1_, osh2_, osh3_, osh4_;
@@ -191,6 +167,42 @@ public:
     void setOmega(double omega);
 };
 
+/**
+ * Coulomb and erf-attenuated ERIs of the same quartet from one pass over its primitives.
+ * The primitive data and Boys arguments are formed once; only the fundamentals and the
+ * libint recursion are redone for erf(omega r)/r. compute_shell() leaves the Coulomb
+ * integrals in buffer() and, unless compute_erf(false), the attenuated ones in erf_buffer().
+ */
+class CoulombErfERI : public TwoElectronInt
+{
+    //! Fundamentals of the attenuated operator
+    Fjt *erf_fjt_;
+    //! Attenuated integrals, laid out as buffer()
+    double *erf_target_;
+    //! Are the attenuated integrals wanted for the next quartets?
+    bool erf_wanted_;
+
+public:
+    CoulombErfERI(double omega, const IntegralFactory* integral, bool use_shell_pairs=false);
+    virtual ~CoulombErfERI();
+
+    /// The erf-attenuated integrals of the last compute_shell()
+    const double *erf_buffer() const { return erf_target_; }
+    /// Skip (false) or do (true, the default) the attenuated integrals from now on
+    void compute_erf(bool wanted) { erf_wanted_ = wanted; }
+
+    virtual size_t compute_shell(int, int, int, int);
+
+    using TwoBodyAOInt::compute_shell_batch;
+    /**
+     * Coulomb integrals of the batch go to out, as TwoBodyAOInt::compute_shell_batch(). The
+     * attenuated ones go to the same place in erf_out, for the quartets with erf[i] set;
+     * the others are skipped and their part of erf_out is left alone.
+     */
+    size_t compute_shell_batch(const std::vector<ShellQuartet>& quartets, const std::vector<char>& erf,
+                               double* out, double* erf_out);
+};
+
 class ErfComplementERI : public TwoElectronInt
 {
 public:
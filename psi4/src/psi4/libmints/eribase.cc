@@ -1649,148 +1649,136 @@ static void handle_reordering12(PermutedOrder permutation, Libderiv_t &libderiv_
 }
 
 /**
-     * @brief Fills the primitive data structure used by libint/libderiv with information from the ShellPairs
+     * @brief Finishes the primitive data with the fundamentals F_j(T), 0 <= j <= J, of nprim primitive quartets in one batch
+     * @param T The Boys function arguments of the quartets
+     * @param rho The reduced exponents, for fundamentals that depend on them
+     * @param scale The prefactor each F_j(T) is multiplied by
+     * @param F Scratch for nprim * (J + 1) values
+     */
+static void fill_fundamentals(prim_data *PrimQuartet, Fjt *fjt, size_t nprim, int J,
+                              const double *T, const double *rho, const double *scale, double *F)
+{
+    fjt->batch_values(J, nprim, T, rho, F);
+    for (size_t p = 0; p < nprim; ++p) {
+        for (int j = 0; j <= J; ++j)
+            PrimQuartet[p].F[j] = F[j * nprim + p] * scale[p];
+    }
+}
+
+/**
+     * @brief Fills the primitive data structure used by libint/libderiv with information from the ShellPairStore
      * @param PrimQuartet The structure to hold the data.
      * @param fjt Object used to compute the fundamental integrals.
-     * @param p12 ShellPair data structure for the left
-     * @param p34 ShellPair data structure for the right
+     * @param p12 Screened primitive pairs for the left
+     * @param p34 Screened primitive pairs for the right
      * @param am Total angular momentum of this quartet
-     * @param nprim1 Number of primitives on center 1
-     * @param nprim2 Number of primitives on center 2
-     * @param nprim3 Number of primitives on center 3
-     * @param nprim4 Number of primitives on center 4
-     * @param sh1eqsh2 Is the shell on center 1 identical to that on center 2?
-     * @param sh3eqsh4 Is the shell on center 3 identical to that on center 4?
      * @param deriv_lvl Derivitive level of the integral
+     * @param Tv, rhov, scalev, Fv Scratch for fill_fundamentals
      * @return The total number of primitive combinations found. This is passed to libint/libderiv.
      */
 static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt,
-                                  const ShellPair *p12, const ShellPair *p34,
-                                  int am,
-                                  int nprim1, int nprim2, int nprim3, int nprim4,
-                                  bool sh1eqsh2, bool sh3eqsh4, int deriv_lvl)
+                                  const PrimitivePairs &p12, const PrimitivePairs &p34,
+                                  int am, int deriv_lvl, double *Tv, double *rhov, double *scalev, double *Fv)
 {
-    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T, *F;
+    double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34;
     double a1, a2, a3, a4;
-    int p1, p2, p3, p4, i;
+    int p12i, p34i;
     size_t nprim = 0L;
-    double *pai = p12->ai;
-    double *pgamma12 = p12->gamma[0];
-    double *poverlap12 = p12->overlap[0];
-    for (p1 = 0; p1 < nprim1; ++p1) {
-        a1 = *pai;
-        ++pai;
-        double *paj = p12->aj;
-        for (p2 = 0; p2 < nprim2; ++p2) {
-            a2 = *paj;
-            zeta = *pgamma12;
-            o12 = *poverlap12;
-            ++paj;
-            ++pgamma12;
-            ++poverlap12;
-            double PAx = p12->PA[p1][p2][0];
-            double PAy = p12->PA[p1][p2][1];
-            double PAz = p12->PA[p1][p2][2];
-            double PBx = p12->PB[p1][p2][0];
-            double PBy = p12->PB[p1][p2][1];
-            double PBz = p12->PB[p1][p2][2];
-            double PABx = p12->P[p1][p2][0];
-            double PABy = p12->P[p1][p2][1];
-            double PABz = p12->P[p1][p2][2];
-
-            double *pak = p34->ai;
-            double *pgamma34 = p34->gamma[0];
-            double *poverlap34 = p34->overlap[0];
-            for (p3 = 0; p3 < nprim3; ++p3) {
-                a3 = *pak;
-                ++pak;
-                double *pal = p34->aj;
-                for (p4 = 0; p4 < nprim4; ++p4) {
-                    a4 = *pal;
-                    eta = *pgamma34;
-                    o34 = *poverlap34;
-                    ++pal;
-                    ++pgamma34;
-                    ++poverlap34;
-
-                    double PCx = p34->PA[p3][p4][0];
-                    double PCy = p34->PA[p3][p4][1];
-                    double PCz = p34->PA[p3][p4][2];
-                    double PDx = p34->PB[p3][p4][0];
-                    double PDy = p34->PB[p3][p4][1];
-                    double PDz = p34->PB[p3][p4][2];
-                    double PCDx = p34->P[p3][p4][0];
-                    double PCDy = p34->P[p3][p4][1];
-                    double PCDz = p34->P[p3][p4][2];
-
-                    ooze = 1.0 / (zeta + eta);
-                    poz = eta * ooze;
-                    rho = zeta * poz;
-                    coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
-
-                    PrimQuartet[nprim].poz = poz;
-                    PrimQuartet[nprim].oo2zn = 0.5 * ooze;
-                    PrimQuartet[nprim].pon = zeta * ooze;
-                    PrimQuartet[nprim].oo2z = 0.5 / zeta;
-                    PrimQuartet[nprim].oo2n = 0.5 / eta;
-                    PrimQuartet[nprim].twozeta_a = 2.0 * a1;
-                    PrimQuartet[nprim].twozeta_b = 2.0 * a2;
-                    PrimQuartet[nprim].twozeta_c = 2.0 * a3;
-                    PrimQuartet[nprim].twozeta_d = 2.0 * a4;
-
-                    PQx = PABx - PCDx;
-                    PQy = PABy - PCDy;
-                    PQz = PABz - PCDz;
-                    PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
-
-                    Wx = (PABx * zeta + PCDx * eta) * ooze;
-                    Wy = (PABy * zeta + PCDy * eta) * ooze;
-                    Wz = (PABz * zeta + PCDz * eta) * ooze;
-
-                    // PA
-                    PrimQuartet[nprim].U[0][0] = PAx;
-                    PrimQuartet[nprim].U[0][1] = PAy;
-                    PrimQuartet[nprim].U[0][2] = PAz;
-                    // PB
-                    PrimQuartet[nprim].U[1][0] = PBx;
-                    PrimQuartet[nprim].U[1][1] = PBy;
-                    PrimQuartet[nprim].U[1][2] = PBz;
-                    // QC
-                    PrimQuartet[nprim].U[2][0] = PCx;
-                    PrimQuartet[nprim].U[2][1] = PCy;
-                    PrimQuartet[nprim].U[2][2] = PCz;
-                    // QD
-                    PrimQuartet[nprim].U[3][0] = PDx;
-                    PrimQuartet[nprim].U[3][1] = PDy;
-                    PrimQuartet[nprim].U[3][2] = PDz;
-                    // WP
-                    PrimQuartet[nprim].U[4][0] = Wx - PABx;
-                    PrimQuartet[nprim].U[4][1] = Wy - PABy;
-                    PrimQuartet[nprim].U[4][2] = Wz - PABz;
-                    // WQ
-                    PrimQuartet[nprim].U[5][0] = Wx - PCDx;
-                    PrimQuartet[nprim].U[5][1] = Wy - PCDy;
-                    PrimQuartet[nprim].U[5][2] = Wz - PCDz;
-
-                    T = rho * PQ2;
-                    fjt->set_rho(rho);
-                    F = fjt->values(am + deriv_lvl, T);
-
-                    for (i = 0; i <= am + deriv_lvl; ++i)
-                        PrimQuartet[nprim].F[i] = F[i] * coef1;
-
-                    nprim++;
-                }
-            }
+    for (p12i = 0; p12i < p12.nprim; ++p12i) {
+        a1 = p12.ai[p12i];
+        a2 = p12.aj[p12i];
+        zeta = p12.gamma[p12i];
+        o12 = p12.overlap[p12i];
+        double PAx = p12.PAx[p12i];
+        double PAy = p12.PAy[p12i];
+        double PAz = p12.PAz[p12i];
+        double PBx = p12.PBx[p12i];
+        double PBy = p12.PBy[p12i];
+        double PBz = p12.PBz[p12i];
+        double PABx = p12.Px[p12i];
+        double PABy = p12.Py[p12i];
+        double PABz = p12.Pz[p12i];
+
+        for (p34i = 0; p34i < p34.nprim; ++p34i) {
+            a3 = p34.ai[p34i];
+            a4 = p34.aj[p34i];
+            eta = p34.gamma[p34i];
+            o34 = p34.overlap[p34i];
+
+            double PCx = p34.PAx[p34i];
+            double PCy = p34.PAy[p34i];
+            double PCz = p34.PAz[p34i];
+            double PDx = p34.PBx[p34i];
+            double PDy = p34.PBy[p34i];
+            double PDz = p34.PBz[p34i];
+            double PCDx = p34.Px[p34i];
+            double PCDy = p34.Py[p34i];
+            double PCDz = p34.Pz[p34i];
+
+            ooze = 1.0 / (zeta + eta);
+            poz = eta * ooze;
+            rho = zeta * poz;
+            coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
+
+            PrimQuartet[nprim].poz = poz;
+            PrimQuartet[nprim].oo2zn = 0.5 * ooze;
+            PrimQuartet[nprim].pon = zeta * ooze;
+            PrimQuartet[nprim].oo2z = 0.5 / zeta;
+            PrimQuartet[nprim].oo2n = 0.5 / eta;
+            PrimQuartet[nprim].twozeta_a = 2.0 * a1;
+            PrimQuartet[nprim].twozeta_b = 2.0 * a2;
+            PrimQuartet[nprim].twozeta_c = 2.0 * a3;
+            PrimQuartet[nprim].twozeta_d = 2.0 * a4;
+
+            PQx = PABx - PCDx;
+            PQy = PABy - PCDy;
+            PQz = PABz - PCDz;
+            PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
+
+            Wx = (PABx * zeta + PCDx * eta) * ooze;
+            Wy = (PABy * zeta + PCDy * eta) * ooze;
+            Wz = (PABz * zeta + PCDz * eta) * ooze;
+
+            // PA
+            PrimQuartet[nprim].U[0][0] = PAx;
+            PrimQuartet[nprim].U[0][1] = PAy;
+            PrimQuartet[nprim].U[0][2] = PAz;
+            // PB
+            PrimQuartet[nprim].U[1][0] = PBx;
+            PrimQuartet[nprim].U[1][1] = PBy;
+            PrimQuartet[nprim].U[1][2] = PBz;
+            // QC
+            PrimQuartet[nprim].U[2][0] = PCx;
+            PrimQuartet[nprim].U[2][1] = PCy;
+            PrimQuartet[nprim].U[2][2] = PCz;
+            // QD
+            PrimQuartet[nprim].U[3][0] = PDx;
+            PrimQuartet[nprim].U[3][1] = PDy;
+            PrimQuartet[nprim].U[3][2] = PDz;
+            // WP
+            PrimQuartet[nprim].U[4][0] = Wx - PABx;
+            PrimQuartet[nprim].U[4][1] = Wy - PABy;
+            PrimQuartet[nprim].U[4][2] = Wz - PABz;
+            // WQ
+            PrimQuartet[nprim].U[5][0] = Wx - PCDx;
+            PrimQuartet[nprim].U[5][1] = Wy - PCDy;
+            PrimQuartet[nprim].U[5][2] = Wz - PCDz;
+
+            Tv[nprim] = rho * PQ2;
+            rhov[nprim] = rho;
+            scalev[nprim] = coef1;
+
+            nprim++;
         }
     }
+    fill_fundamentals(PrimQuartet, fjt, nprim, am + deriv_lvl, Tv, rhov, scalev, Fv);
     return nprim;
 }
 
 } // end namespace
 
 TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool use_shell_pairs)
-        : TwoBodyAOInt(integral, deriv), use_shell_pairs_(use_shell_pairs)
+        : TwoBodyAOInt(integral, deriv), nprim_(0), use_shell_pairs_(use_shell_pairs)
 {
     // Initialize libint static data
     init_libint_base();
@@ -1841,6 +1829,10 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
         outfile->Printf("Error allocating memory for libint/libderiv.\n");
         exit(EXIT_FAILURE);
     }
+    fjt_T_.resize(max_nprim);
+    fjt_rho_.resize(max_nprim);
+    fjt_scale_.resize(max_nprim);
+    fjt_F_.resize((size_t) max_nprim * (4 * max_am + deriv_ + 1));
     size_t size = INT_NCART(basis1()->max_am()) * INT_NCART(basis2()->max_am()) *
                   INT_NCART(basis3()->max_am()) * INT_NCART(basis4()->max_am());
 
@@ -1882,11 +1874,8 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
     }
 
     if (use_shell_pairs_) {
-        // Precompute a bunch of information
-        init_shell_pairs12();
-        // If basis3 and basis4 equals basis1 and basis2, then the following function will do nothing,
-        // except assign pairs34_ to pairs12_
-        init_shell_pairs34();
+        // Shared by all the integral objects of this factory, computed on first use
+        pairs_ = integral->shell_pairs();
     }
 
     // form the blocking. We use the default
@@ -1901,316 +1890,6 @@ TwoElectronInt::~TwoElectronInt()
     free_libint(&libint_);
     if (deriv_)
         free_libderiv(&libderiv_);
-    free_shell_pairs12();
-    free_shell_pairs34();       // This shouldn't do anything, but this might change in the future
-}
-
-void TwoElectronInt::init_shell_pairs12()
-{
-    ShellPair *sp;
-    Vector3 P, PA, PB, AB, A, B;
-    int i, j, si, sj, np_i, np_j;
-    size_t memd;
-    double a1, a2, ab2, gam, c1, c2;
-    double *curr_stack_ptr;
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = TwoElectronInt::memory_to_store_shell_pairs(basis1(), basis2());
-
-    // Allocate a stack of memory
-    stack12_ = new double[memd];
-    curr_stack_ptr = stack12_;
-
-    // Allocate shell pair memory
-    pairs12_ = new ShellPair *[basis1()->nshell()];
-    for (i = 0; i < basis1()->nshell(); ++i)
-        pairs12_[i] = new ShellPair[basis2()->nshell()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        A = basis1()->shell(si).center();
-
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            B = basis2()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs12_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0];
-            sp->AB[1] = AB[1];
-            sp->AB[2] = AB[2];
-
-            np_i = basis1()->shell(si).nprimitive();
-            np_j = basis2()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P = new double **[np_i];
-            sp->PA = new double **[np_i];
-            sp->PB = new double **[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->P[i] = new double *[np_j];
-                sp->PA[i] = new double *[np_j];
-                sp->PB[i] = new double *[np_j];
-
-                for (j = 0; j < np_j; ++j) {
-                    sp->P[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i = 0; i < np_i; ++i) {
-                a1 = basis1()->shell(si).exp(i);
-                c1 = basis1()->shell(si).coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j = 0; j < np_j; ++j) {
-                    a2 = basis2()->shell(sj).exp(j);
-                    c2 = basis2()->shell(sj).coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute Gaussian product and component distances
-                    P = (A * a1 + B * a2) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0] = P[0];
-                    sp->P[i][j][1] = P[1];
-                    sp->P[i][j][2] = P[2];
-                    sp->PA[i][j][0] = PA[0];
-                    sp->PA[i][j][1] = PA[1];
-                    sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0];
-                    sp->PB[i][j][1] = PB[1];
-                    sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI / gam, 3.0 / 2.0) * exp(-a1 * a2 * ab2 / gam) * c1 * c2;
-                }
-            }
-        }
-    }
-}
-
-void TwoElectronInt::init_shell_pairs34()
-{
-    // If basis1 == basis3 && basis2 == basis4, then we don't need to do anything except use the pointer
-    // of pairs12_.
-    if (use_shell_pairs_ == true) {
-        // This assumes init_shell_pairs12 was called and precomputed the values.
-        pairs34_ = pairs12_;
-        stack34_ = NULL;
-        return;
-    }
-#if 0
-                                                                                                                            outfile->Printf( "  Pre-computing additional values for two-electron integrals. [ |34) does not equal (12| ]\n");
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = ERIBase::memory_to_store_shell_pairs(basis3(), basis4());
-
-    // Allocate a stack of memory
-    stack34_ = new double[memd];
-    curr_stack_ptr = stack34_;
-
-    // Allocate shell pair memory
-    pairs34_ = new ShellPair*[basis3()->nprimitive()];
-    for (i=0; i<basis3()->nprimitive(); ++i)
-        pairs34_[i] = new ShellPair[basis4()->nprimitive()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si=0; si<basis3()->nprimitive(); ++si) {
-        A = basis3()->shell(si).center();
-
-        for (sj=0; sj<basis4()->nprimitive(); ++sj) {
-            B = basis4()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs34_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0]; sp->AB[1] = AB[1]; sp->AB[2] = AB[2];
-
-            np_i = basis3()->shell(si).nprimitive();
-            np_j = basis4()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P  = new double**[np_i];
-            sp->PA = new double**[np_i];
-            sp->PB = new double**[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->P[i]  = new double*[np_j];
-                sp->PA[i] = new double*[np_j];
-                sp->PB[i] = new double*[np_j];
-
-                for (j=0; j<np_j; ++j) {
-                    sp->P[i][j]  = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i=0; i<np_i; ++i) {
-                a1 = basis3()->shell(si)->exp(i);
-                c1 = basis3()->shell(si)->coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j=0; j<np_j; ++j) {
-                    a2 = basis4()->shell(sj)->exp(j);
-                    c2 = basis4()->shell(sj)->coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute some distances
-                    P = ( A * a1 + B * a2 ) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0]  = P[0];  sp->P[i][j][1]  = P[1];  sp->P[i][j][2]  = P[2];
-                    sp->PA[i][j][0] = PA[0]; sp->PA[i][j][1] = PA[1]; sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0]; sp->PB[i][j][1] = PB[1]; sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI/gam, 3.0/2.0) * exp(-a1*a2*ab2/gam) * c1 * c2;
-                }
-            }
-        }
-    }
-#endif
-}
-
-void TwoElectronInt::free_shell_pairs12()
-{
-    int i, si, sj;
-    ShellPair *sp;
-    int np_i;
-
-    if (!use_shell_pairs_)
-        return;
-
-    delete[] stack12_;
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            np_i = basis1()->shell(si).nprimitive();
-            sp = &(pairs12_[si][sj]);
-
-            delete[] sp->gamma;
-            delete[] sp->overlap;
-
-            if (sp->P != NULL) {
-                for (i = 0; i < np_i; ++i)
-                    delete[] sp->P[i];
-                delete[] sp->P;
-            }
-            if (sp->PA != NULL) {
-                for (i = 0; i < np_i; ++i)
-                    delete[] sp->PA[i];
-                delete[] sp->PA;
-            }
-            if (sp->PB != NULL) {
-                for (i = 0; i < np_i; ++i)
-                    delete[] sp->PB[i];
-                delete[] sp->PB;
-            }
-        }
-    }
-
-    for (si = 0; si < basis1()->nshell(); ++si)
-        delete[] pairs12_[si];
-    delete[] pairs12_;
-}
-
-void TwoElectronInt::free_shell_pairs34()
-{
-}
-
-size_t TwoElectronInt::memory_to_store_shell_pairs(const std::shared_ptr<BasisSet> &bs1, const std::shared_ptr<BasisSet> &bs2)
-{
-    int i, j, np_i, np_j;
-    size_t mem = 0;
-
-    for (i = 0; i < bs1->nshell(); ++i) {
-        np_i = bs1->shell(i).nprimitive();
-        for (j = 0; j < bs2->nshell(); ++j) {
-            np_j = bs2->shell(j).nprimitive();
-            mem += (2 * (np_i + np_j) + 11 * np_i * np_j);
-        }
-    }
-    return mem;
 }
 
 size_t TwoElectronInt::compute_shell(const AOShellCombinationsIterator &shellIter)
@@ -2440,12 +2119,8 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4)
 
     // If we can, use the precomputed values found in ShellPair.
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        // 1234 -> 1234 no change
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2, sh3 == sh4, 0);
+        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, pairs_->pair(sh1, sh2), pairs_->pair(sh3, sh4), am, 0,
+                                    fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     } else {
         const double *a1s = s1.exps();
         const double *a2s = s2.exps();
@@ -2548,26 +2223,44 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4)
                         libint_.PrimQuartet[nprim].pon = rho * oon;
                         libint_.PrimQuartet[nprim].oo2p = oo2rho;
 
-                        double T = rho * PQ2;
-                        fjt_->set_rho(rho);
-                        double *F = fjt_->values(am, T);
+                        fjt_T_[nprim] = rho * PQ2;
+                        fjt_rho_[nprim] = rho;
 
-                        // Modify F to include overlap of ab and cd, eqs 14, 15, 16 of libint manual
+                        // F is scaled by the overlap of ab and cd, eqs 14, 15, 16 of libint manual
                         double Scd = pow(M_PI * oon, 3.0 / 2.0) * exp(-a3 * a4 * oon * CD2) * c3 * c4;
-                        double val = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd;
-                        for (int i = 0; i <= am; ++i) {
-                            libint_.PrimQuartet[nprim].F[i] = F[i] * val;
-                        }
+                        fjt_scale_[nprim] = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd;
                         nprim++;
                     }
                 }
             }
         }
+        fill_fundamentals(libint_.PrimQuartet, fjt_, nprim, am, fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     }
 #ifdef MINTS_TIMER
     timer_off("Primitive setup");
 #endif
 
+    nprim_ = nprim;
+    return build_quartet(sh1, sh2, sh3, sh4, nprim);
+}
+
+size_t TwoElectronInt::recompute_quartet(Fjt *fjt, int sh1, int sh2, int sh3, int sh4)
+{
+    int am = bs1_->shell(sh1).am() + bs2_->shell(sh2).am() + bs3_->shell(sh3).am() + bs4_->shell(sh4).am();
+
+    // The Boys arguments, reduced exponents and overlap prefactors are those of the last quartet
+    fill_fundamentals(libint_.PrimQuartet, fjt, nprim_, am, fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
+    return build_quartet(sh1, sh2, sh3, sh4, nprim_);
+}
+
+size_t TwoElectronInt::build_quartet(int sh1, int sh2, int sh3, int sh4, size_t nprim)
+{
+    int am1 = bs1_->shell(sh1).am();
+    int am2 = bs2_->shell(sh2).am();
+    int am3 = bs3_->shell(sh3).am();
+    int am4 = bs4_->shell(sh4).am();
+    int am = am1 + am2 + am3 + am4;
+
     // How many are there?
     size_t size = INT_NCART(am1) * INT_NCART(am2) * INT_NCART(am3) * INT_NCART(am4);
 
@@ -2807,11 +2500,8 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     nprim = 0;
 
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2, sh3 == sh4, 1);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, pairs_->pair(sh1, sh2), pairs_->pair(sh3, sh4), am, 1,
+                                    fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -2901,22 +2591,19 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
                         libderiv_.PrimQuartet[nprim].twozeta_c = 2.0 * a3;
                         libderiv_.PrimQuartet[nprim].twozeta_d = 2.0 * a4;
 
-                        double T = rho * PQ2;
-                        double *F = fjt_->values(am + 1, T);
+                        fjt_T_[nprim] = rho * PQ2;
+                        fjt_rho_[nprim] = rho;
 
-                        // Modify F to include overlap of ab and cd, eqs 14, 15, 16 of libint manual
+                        // F is scaled by the overlap of ab and cd, eqs 14, 15, 16 of libint manual
                         double Scd = pow(M_PI * oon, 3.0 / 2.0) * exp(-a3 * a4 * oon * CD2) * c3 * c4;
-                        double val = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd * prefactor;
-
-                        for (int i = 0; i <= am + DERIV_LVL; ++i) {
-                            libderiv_.PrimQuartet[nprim].F[i] = F[i] * val;
-                        }
+                        fjt_scale_[nprim] = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd * prefactor;
 
                         nprim++;
                     }
                 }
             }
         }
+        fill_fundamentals(libderiv_.PrimQuartet, fjt_, nprim, am + 1, fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     }
 
     // How many are there?
@@ -3143,11 +2830,8 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
 
     // prepare all the data needed for libderiv
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2, sh3 == sh4, 2);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, pairs_->pair(sh1, sh2), pairs_->pair(sh3, sh4), am, 2,
+                                    fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -3237,22 +2921,19 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
                         libderiv_.PrimQuartet[nprim].twozeta_c = 2.0 * a3;
                         libderiv_.PrimQuartet[nprim].twozeta_d = 2.0 * a4;
 
-                        double T = rho * PQ2;
-                        double *F = fjt_->values(am + 2, T);
+                        fjt_T_[nprim] = rho * PQ2;
+                        fjt_rho_[nprim] = rho;
 
-                        // Modify F to include overlap of ab and cd, eqs 14, 15, 16 of libint manual
+                        // F is scaled by the overlap of ab and cd, eqs 14, 15, 16 of libint manual
                         double Scd = pow(M_PI * oon, 3.0 / 2.0) * exp(-a3 * a4 * oon * CD2) * c3 * c4;
-                        double val = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd * prefactor;
-
-                        for (int i = 0; i <= am + 2; ++i) {
-                            libderiv_.PrimQuartet[nprim].F[i] = F[i] * val;
-                        }
+                        fjt_scale_[nprim] = 2.0 * sqrt(rho * M_1_PI) * Sab * Scd * prefactor;
 
                         nprim++;
                     }
                 }
             }
         }
+        fill_fundamentals(libderiv_.PrimQuartet, fjt_, nprim, am + 2, fjt_T_.data(), fjt_rho_.data(), fjt_scale_.data(), fjt_F_.data());
     }
 
     size_t size = INT_NCART(am1) * INT_NCART(am2) * INT_NCART(am3) * INT_NCART(am4);
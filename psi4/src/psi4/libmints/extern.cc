@@ -32,12 +32,16 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/chargetree.h"
+#include "psi4/liboptions/liboptions.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -45,6 +49,30 @@
 
 namespace psi {
 
+namespace {
+
+/// Do a and b hold the same shells, at the same centers?
+bool same_basis(std::shared_ptr<BasisSet> a, std::shared_ptr<BasisSet> b)
+{
+    if (a == b) return true;
+    if (!a || !b) return false;
+    if (a->nbf() != b->nbf() || a->nshell() != b->nshell() || a->has_puream() != b->has_puream()) return false;
+    for (int P = 0; P < a->nshell(); P++) {
+        const GaussianShell& sa = a->shell(P);
+        const GaussianShell& sb = b->shell(P);
+        if (sa.am() != sb.am() || sa.nprimitive() != sb.nprimitive()) return false;
+        for (int k = 0; k < 3; k++) {
+            if (sa.center()[k] != sb.center()[k]) return false;
+        }
+        for (int K = 0; K < sa.nprimitive(); K++) {
+            if (sa.exp(K) != sb.exp(K) || sa.coef(K) != sb.coef(K)) return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 ExternalPotential::ExternalPotential() :
         debug_(0), print_(1)
 {
@@ -65,6 +93,22 @@ void ExternalPotential::addCharge(double Z, double x, double y, double z)
     charges_.push_back(std::make_tuple(Z, x, y, z));
 }
 
+void ExternalPotential::updateCharge(size_t i, double x, double y, double z)
+{
+    if (i >= charges_.size())
+        throw PSIEXCEPTION("ExternalPotential::updateCharge: no charge with this index.");
+    std::get<1>(charges_[i]) = x;
+    std::get<2>(charges_[i]) = y;
+    std::get<3>(charges_[i]) = z;
+}
+
+void ExternalPotential::clearCache()
+{
+    cached_V_.reset();
+    cached_basis_.reset();
+    cached_charges_.clear();
+}
+
 void ExternalPotential::addBasis(std::shared_ptr <BasisSet> basis, SharedVector coefs)
 {
     bases_.push_back(std::make_pair(basis, coefs));
@@ -106,35 +150,103 @@ void ExternalPotential::print(std::string out) const
     }
 }
 
+SharedMatrix ExternalPotential::computeChargeMatrix(std::shared_ptr <BasisSet> basis, SharedMatrix Zxyz)
+{
+    int n = basis->nbf();
+    SharedMatrix V_charge(new Matrix("External Potential (Charges)", n, n));
+    std::shared_ptr <IntegralFactory> fact(new IntegralFactory(basis, basis, basis, basis));
+
+    std::shared_ptr <PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
+    pot->set_charge_field(Zxyz);
+
+    // Distant groups of charges enter through their multipoles
+    Options& options = Process::environment.options;
+    if (Zxyz->rowspi()[0] && options.get_bool("EXTERN_FMM")) {
+        std::shared_ptr<ChargeMultipoleTree> tree(new ChargeMultipoleTree(Zxyz,
+            options.get_int("EXTERN_FMM_ORDER"), options.get_int("EXTERN_FMM_LEAF_SIZE")));
+        pot->set_far_field(tree, options.get_double("EXTERN_FMM_THETA"));
+        if (print_)
+            outfile->Printf("  External potential: %zu charges in %zu multipole tree nodes (order %d, theta %.2f).\n\n",
+                            tree->ncharge(), tree->nnode(), tree->order(), options.get_double("EXTERN_FMM_THETA"));
+    }
+    pot->compute(V_charge);
+
+    return V_charge;
+}
+
 SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr <BasisSet> basis)
 {
     int n = basis->nbf();
     SharedMatrix V(new Matrix("External Potential", n, n));
-    std::shared_ptr <IntegralFactory> fact(new IntegralFactory(basis, basis, basis, basis));
 
     double convfac = 1.0;
     if (basis->molecule()->units() == Molecule::Angstrom)
         convfac /= pc_bohr2angstroms;
 
-    // Monopoles
-    SharedMatrix V_charge(new Matrix("External Potential (Charges)", n, n));
+    // Monopoles, in bohr
+    std::vector<std::tuple<double,double,double,double> > charges(charges_.size());
+    for (size_t i = 0; i < charges_.size(); i++) {
+        charges[i] = std::make_tuple(std::get<0>(charges_[i]),
+                                     convfac * std::get<1>(charges_[i]),
+                                     convfac * std::get<2>(charges_[i]),
+                                     convfac * std::get<3>(charges_[i]));
+    }
 
-    SharedMatrix Zxyz(new Matrix("Charges (Z,x,y,z)", charges_.size(), 4));
+    // The potential is linear in the charges: against the last matrix, charge i is a correction
+    // of +Z at its new position and -Z at the one cached_V_ has it at.  Charges that moved less
+    // than the tolerance stay where they are in the cache, so they drift by at most that much.
+    Options& options = Process::environment.options;
+    double tolerance = (options.exists("EXTERN_UPDATE_TOLERANCE") ? options.get_double("EXTERN_UPDATE_TOLERANCE") : 0.0);
+    std::vector<std::tuple<double,double,double,double> > delta;
+    bool incremental = (cached_V_ && same_basis(basis, cached_basis_));
+    if (incremental) {
+        size_t ncommon = std::min(charges.size(), cached_charges_.size());
+        for (size_t i = 0; i < ncommon; i++) {
+            const std::tuple<double,double,double,double>& now = charges[i];
+            const std::tuple<double,double,double,double>& old = cached_charges_[i];
+            double dx = std::get<1>(now) - std::get<1>(old);
+            double dy = std::get<2>(now) - std::get<2>(old);
+            double dz = std::get<3>(now) - std::get<3>(old);
+            double R = std::sqrt(dx * dx + dy * dy + dz * dz);
+            if (std::get<0>(now) == std::get<0>(old) && (R <= tolerance)) {
+                charges[i] = old;
+                continue;
+            }
+            delta.push_back(now);
+            delta.push_back(std::make_tuple(-std::get<0>(old), std::get<1>(old), std::get<2>(old), std::get<3>(old)));
+        }
+        for (size_t i = ncommon; i < charges.size(); i++) {
+            delta.push_back(charges[i]);
+        }
+        for (size_t i = ncommon; i < cached_charges_.size(); i++) {
+            const std::tuple<double,double,double,double>& old = cached_charges_[i];
+            delta.push_back(std::make_tuple(-std::get<0>(old), std::get<1>(old), std::get<2>(old), std::get<3>(old)));
+        }
+        // A correction as long as the field itself is no cheaper than the field
+        incremental = (delta.size() < charges.size());
+    }
+    if (!incremental) delta = charges;
+
+    SharedMatrix Zxyz(new Matrix("Charges (Z,x,y,z)", delta.size(), 4));
     double **Zxyzp = Zxyz->pointer();
-    for (size_t i = 0; i < charges_.size(); i++) {
-        Zxyzp[i][0] = std::get<0>(charges_[i]);
-        Zxyzp[i][1] = convfac * std::get<1>(charges_[i]);
-        Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
-        Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
+    for (size_t i = 0; i < delta.size(); i++) {
+        Zxyzp[i][0] = std::get<0>(delta[i]);
+        Zxyzp[i][1] = std::get<1>(delta[i]);
+        Zxyzp[i][2] = std::get<2>(delta[i]);
+        Zxyzp[i][3] = std::get<3>(delta[i]);
     }
 
-    std::shared_ptr <PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
-    pot->set_charge_field(Zxyz);
-    pot->compute(V_charge);
+    if (incremental) {
+        if (print_ > 1)
+            outfile->Printf("  External potential: %zu correction charges for a field of %zu.\n\n", delta.size(), charges.size());
+        if (delta.size()) cached_V_->add(computeChargeMatrix(basis, Zxyz));
+    } else {
+        cached_V_ = computeChargeMatrix(basis, Zxyz);
+    }
+    cached_basis_ = basis;
+    cached_charges_ = charges;
 
-    V->add(V_charge);
-    V_charge.reset();
-    pot.reset();
+    V->add(cached_V_);
 
     // Diffuse Bases
     for (size_t ind = 0; ind < bases_.size(); ind++) {
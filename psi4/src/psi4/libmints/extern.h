@@ -61,6 +61,16 @@ protected:
     /// Auxiliary basis sets (with accompanying molecules and coefs) of diffuse charges
     std::vector<std::pair<std::shared_ptr<BasisSet>, SharedVector> > bases_;
 
+    /// Point-charge part of the last potential matrix, kept for incremental updates
+    SharedMatrix cached_V_;
+    /// Basis set cached_V_ was computed in
+    std::shared_ptr<BasisSet> cached_basis_;
+    /// <Z,x,y,z> (bohr) of the charges summed into cached_V_
+    std::vector<std::tuple<double,double,double,double> > cached_charges_;
+
+    /// Point-charge potential matrix of the field Zxyz (bohr), exact or through EXTERN_FMM
+    SharedMatrix computeChargeMatrix(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz);
+
 public:
     /// Constructur, does nothing
     ExternalPotential();
@@ -72,13 +82,20 @@ public:
 
     /// Add a charge Z at (x,y,z)
     void addCharge(double Z,double x, double y, double z);
+    /// Move charge i to (x,y,z), keeping its Z
+    void updateCharge(size_t i, double x, double y, double z);
     /// Add a basis of S auxiliary functions with DF coefficients
     void addBasis(std::shared_ptr<BasisSet> basis, SharedVector coefs);
 
-    /// Reset the field to zero (eliminates all entries)
+    /// Reset the field to zero (eliminates all entries). The cached potential is kept, so a
+    /// field refilled with mostly the same charges is still updated incrementally.
     void clear();
+    /// Drop the cached point-charge potential, the next matrix is built from scratch
+    void clearCache();
 
-    /// Compute the external potential matrix in the given basis set
+    /// Compute the external potential matrix in the given basis set. If the previous call was
+    /// for the same basis, only the charges that were added, removed, or moved by more than
+    /// EXTERN_UPDATE_TOLERANCE since then are integrated, as a correction to that matrix.
     SharedMatrix computePotentialMatrix(std::shared_ptr<BasisSet> basis);
     /// Compute the gradients due to the external potential
     SharedMatrix computePotentialGradients(std::shared_ptr<BasisSet> basis, std::shared_ptr<Matrix> Dt);
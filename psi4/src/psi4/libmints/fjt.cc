@@ -82,6 +82,16 @@ const double oon[] = {0.0, 1.0, 1.0/2.0, 1.0/3.0, 1.0/4.0, 1.0/5.0, 1.0/6.0, 1.0
 Fjt::Fjt() {}
 Fjt::~Fjt() {}
 
+void Fjt::batch_values(int J, size_t n, const double *T, const double *rho, double *F)
+{
+    for (size_t i = 0; i < n; ++i) {
+        set_rho(rho[i]);
+        const double *Fi = values(J, T[i]);
+        for (int j = 0; j <= J; ++j)
+            F[j * n + i] = Fi[j];
+    }
+}
+
 double Taylor_Fjt::relative_zero_(1e-6);
 
 /*------------------------------------------------------
@@ -331,6 +341,38 @@ Taylor_Fjt::values(int l, double T)
     return F_;
 }
 
+void
+Taylor_Fjt::batch_values(int J, size_t n, const double *T, const double * /*rho*/, double *F)
+{
+    // T_crit grows with j, so as in values() the asymptotic formula is used for all
+    // j at the points past T_crit[J]. Each sweep below runs over all the points.
+    const double T_crit = T_crit_[J];
+    for (int j = 0; j <= J; ++j) {
+        const double *Fjm1 = F + (j > 0 ? j - 1 : 0) * n;
+        const double dfj = (double)(2 * j - 1);
+        double *Fj = F + j * n;
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) {
+            const double Ti = T[i];
+            if (Ti > T_crit) {
+                /*--- Asymptotic formula, upward from F_0 ---*/
+                const double X = 0.5 / Ti;
+                Fj[i] = (j == 0) ? M_SQRT_PI_2 * std::sqrt(X) : dfj * X * Fjm1[i];
+            }
+            else {
+                /*--- Taylor interpolation, in Horner form ---*/
+                const int T_ind = (int)std::floor(0.5 + Ti * oodelT_);
+                const double h = T_ind * delT_ - Ti;
+                const double *F_row = grid_[T_ind] + j;
+                double Fi = F_row[TAYLOR_INTERPOLATION_ORDER];
+                for (int k = TAYLOR_INTERPOLATION_ORDER; k > 0; --k)
+                    Fi = F_row[k-1] + oon[k] * h * Fi;
+                Fj[i] = Fi;
+            }
+        }
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 /* Tablesize should always be at least 121. */
@@ -812,7 +854,7 @@ ErfFundamental::~ErfFundamental()
 
 double* ErfFundamental::values(int J, double T)
 {
-    double *Fvals = boys_->values(J, T);
+    double *Fvals;
 
     for (int n=0; n<=J; ++n)
         value_[n] = 0.0;
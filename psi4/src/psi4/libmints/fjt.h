@@ -56,6 +56,8 @@
 #ifndef _chemistry_qc_basis_fjt_h
 #define _chemistry_qc_basis_fjt_h
 
+#include <cstddef>
+
 namespace psi {
 
 class CorrelationFactor;
@@ -70,6 +72,10 @@ public:
         The values will be overwritten with the next call to this functions.
         The pointer will be invalidated after the call to ~Fjt. */
     virtual double *values(int J, double T) =0;
+    /** Computes F_j(T[i]) for every 0 <= j <= J at n points at once, into
+        F[j*n + i] (n*(J+1) doubles). rho[i] is handed to set_rho() before
+        point i. The default calls values() point by point. */
+    virtual void batch_values(int J, size_t n, const double *T, const double *rho, double *F);
     virtual void set_rho(double /*rho*/) { }
 };
 
@@ -85,6 +91,9 @@ public:
     virtual ~Taylor_Fjt();
     /// Implements Fjt::values()
     double *values(int J, double T);
+    /// Implements Fjt::batch_values(): the scheme of values(), one j at a time
+    /// with the loop over the points innermost
+    void batch_values(int J, size_t n, const double *T, const double *rho, double *F);
 private:
     double **grid_;            /* Table of "exact" Fm(T) values. Row index corresponds to
                                   values of T (max_T+1 rows), column index to values
@@ -33,6 +33,7 @@
 #include "psi4/libmints/tracelessquadrupole.h"
 #include "psi4/libmints/efpmultipolepotential.h"
 #include "psi4/libmints/eri.h"
+#include "psi4/libmints/shellpair.h"
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/quadrupole.h"
 #include "psi4/libmints/angularmomentum.h"
@@ -107,10 +108,23 @@ void IntegralFactory::set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<B
     bs3_ = bs3;
     bs4_ = bs4;
 
+    {
+        std::lock_guard<std::mutex> lock(shell_pairs_lock_);
+        shell_pairs_.reset();
+    }
+
     // Use the max am from libint
     init_spherical_harmonics(LIBINT_MAX_AM+1);
 }
 
+std::shared_ptr<ShellPairStore> IntegralFactory::shell_pairs() const
+{
+    std::lock_guard<std::mutex> lock(shell_pairs_lock_);
+    if (!shell_pairs_)
+        shell_pairs_ = std::make_shared<ShellPairStore>(bs1_, bs2_);
+    return shell_pairs_;
+}
+
 OneBodyAOInt* IntegralFactory::ao_overlap(int deriv)
 {
     return new OverlapInt(spherical_transforms_, bs1_, bs2_, deriv);
@@ -303,6 +317,11 @@ TwoBodyAOInt* IntegralFactory::erf_eri(double omega, int deriv, bool use_shell_p
     return new ErfERI(omega, this, deriv, use_shell_pairs);
 }
 
+CoulombErfERI* IntegralFactory::coulomb_erf_eri(double omega, bool use_shell_pairs)
+{
+    return new CoulombErfERI(omega, this, use_shell_pairs);
+}
+
 TwoBodyAOInt* IntegralFactory::erf_complement_eri(double omega, int deriv, bool use_shell_pairs)
 {
     return new ErfComplementERI(omega, this, deriv, use_shell_pairs);
@@ -35,6 +35,7 @@
  #include <memory>
  PRAGMA_WARNING_POP
 #include <vector>
+#include <mutex>
 
 #include "onebody.h"
 #include "twobody.h"
@@ -79,6 +80,8 @@ class ShellRotation;
 class SymmetryOperation;
 class SOBasisSet;
 class CorrelationFactor;
+class ShellPairStore;
+class CoulombErfERI;
 
 /*! \ingroup MINTS */
 class SphericalTransformComponent
@@ -398,6 +401,10 @@ protected:
     /// Provides ability to transform from sphericals (d=0, f=1, g=2)
     std::vector<ISphericalTransform> ispherical_transforms_;
 
+    /// Primitive pair data for (bs1 bs2|, built on first use
+    mutable std::shared_ptr<ShellPairStore> shell_pairs_;
+    mutable std::mutex shell_pairs_lock_;
+
 public:
     /** Initialize IntegralFactory object given a BasisSet for each center. */
     IntegralFactory(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
@@ -420,6 +427,10 @@ public:
     virtual void set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
         std::shared_ptr<BasisSet> bs3, std::shared_ptr<BasisSet> bs4);
 
+    /// Screened primitive pair data of (bs1 bs2|, computed once and shared by
+    /// every two-electron integral object created from this factory.
+    std::shared_ptr<ShellPairStore> shell_pairs() const;
+
     /// Returns an OneBodyInt that computes the overlap integral.
     virtual OneBodyAOInt* ao_overlap(int deriv=0);
 
@@ -496,6 +507,9 @@ public:
     /// Returns an erf ERI integral object (omega integral)
     virtual TwoBodyAOInt* erf_eri(double omega, int deriv=0, bool use_shell_pairs=true);
 
+    /// Returns an object computing the Coulomb and the erf ERIs of each quartet together
+    virtual CoulombErfERI* coulomb_erf_eri(double omega, bool use_shell_pairs=true);
+
     /// Returns an erf complement ERI integral object (omega integral)
     virtual TwoBodyAOInt* erf_complement_eri(double omega, int deriv=0, bool use_shell_pairs=true);
 
@@ -72,6 +72,18 @@ KineticInt::~KineticInt()
     delete[] buffer_;
 }
 
+bool KineticInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* KineticInt::clone() const
+{
+    OneBodyAOInt* ints = new KineticInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    copy_settings(ints);
+    return ints;
+}
+
 // The engine only supports segmented basis sets
 void KineticInt::compute_pair(const GaussianShell& s1, const GaussianShell& s2)
 {
@@ -68,6 +68,10 @@ public:
     //! Virtual destructor.
     virtual ~KineticInt();
 
+        virtual bool cloneable() const;
+    /// Returns a new KineticInt with the same origin and settings
+    virtual OneBodyAOInt* clone() const;
+
     /// Does the method provide first derivatives?
     bool has_deriv1() { return true; }
 
@@ -38,11 +38,589 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace psi;
 
 namespace psi {
 
+namespace {
+
+/**
+ * A localization metric of the form sum_k sum_i (Q^k_ii)^2, where the Q^k are
+ * the orbital representations of symmetric operators (dipole components for
+ * Boys, atomic Mulliken charges for Pipek-Mezey). The state is rotated in
+ * place; the optimizers below only see it through this interface.
+ */
+class LocalMetric {
+   public:
+    virtual ~LocalMetric() {}
+
+    /// Current value of the metric
+    virtual double metric() = 0;
+    /// Jacobi quantities of the pair i, j: a = sum (Q_ii - Q_jj)^2, b = sum (2Q_ij)^2, c = sum (Q_ii - Q_jj) 2Q_ij
+    virtual void pair(int i, int j, double& a, double& b, double& c) = 0;
+    /// Givens rotations of the pairs {i, j}, which share no orbital
+    virtual void rotate(const std::vector<std::pair<int, int> >& pairs, const std::vector<double>& cs,
+                        const std::vector<double>& ss) = 0;
+    /// Orbital gradient G_ij = 2 sum Q_ij (Q_jj - Q_ii) and the diagonal of the Hessian
+    virtual void gradient(double** G, double** Hd) = 0;
+    /// Derivative of the gradient along the antisymmetric rotation X
+    virtual void hessian(double** X, double** dG) = 0;
+    /// Q <- K^T Q K for the orthogonal K
+    virtual void transform(double** K) = 0;
+};
+
+class BoysMetric : public LocalMetric {
+    int nmo_;
+    std::vector<std::shared_ptr<Matrix> > D_;
+    std::shared_ptr<Matrix> T_;
+
+   public:
+    BoysMetric(const std::vector<std::shared_ptr<Matrix> >& Dmo) : D_(Dmo) {
+        nmo_ = D_[0]->rowspi()[0];
+        T_ = std::shared_ptr<Matrix>(new Matrix("T", nmo_, nmo_));
+    }
+
+    double metric() {
+        double metric = 0.0;
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            metric += C_DDOT(nmo_, Ak[0], nmo_ + 1, Ak[0], nmo_ + 1);
+        }
+        return metric;
+    }
+    void pair(int i, int j, double& a, double& b, double& c) {
+        a = 0.0;
+        b = 0.0;
+        c = 0.0;
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            double Ad = (Ak[i][i] - Ak[j][j]);
+            double Ao = 2.0 * Ak[i][j];
+            a += Ad * Ad;
+            b += Ao * Ao;
+            c += Ad * Ao;
+        }
+    }
+    void rotate(const std::vector<std::pair<int, int> >& pairs, const std::vector<double>& cs,
+                const std::vector<double>& ss) {
+        int npair = pairs.size();
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            // rows of A^k, one pair at a time
+#pragma omp parallel for schedule(static)
+            for (int p = 0; p < npair; p++) {
+                C_DROT(nmo_, Ak[pairs[p].first], 1, Ak[pairs[p].second], 1, cs[p], ss[p]);
+            }
+            // then the columns, one row at a time
+#pragma omp parallel for schedule(static)
+            for (int r = 0; r < nmo_; r++) {
+                double* Ar = Ak[r];
+                for (int p = 0; p < npair; p++) {
+                    double x = Ar[pairs[p].first];
+                    double y = Ar[pairs[p].second];
+                    Ar[pairs[p].first] = cs[p] * x + ss[p] * y;
+                    Ar[pairs[p].second] = cs[p] * y - ss[p] * x;
+                }
+            }
+        }
+    }
+    void gradient(double** G, double** Hd) {
+        ::memset(G[0], '\0', sizeof(double) * nmo_ * nmo_);
+        ::memset(Hd[0], '\0', sizeof(double) * nmo_ * nmo_);
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            for (int i = 0; i < nmo_; i++) {
+                for (int j = 0; j < nmo_; j++) {
+                    double Ad = Ak[j][j] - Ak[i][i];
+                    G[i][j] += 2.0 * Ak[i][j] * Ad;
+                    Hd[i][j] += 2.0 * (4.0 * Ak[i][j] * Ak[i][j] - Ad * Ad);
+                }
+            }
+        }
+    }
+    void hessian(double** X, double** dG) {
+        ::memset(dG[0], '\0', sizeof(double) * nmo_ * nmo_);
+        double** Rp = T_->pointer();
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            // R = [A^k, X]
+            C_DGEMM('N', 'N', nmo_, nmo_, nmo_, 1.0, Ak[0], nmo_, X[0], nmo_, 0.0, Rp[0], nmo_);
+            C_DGEMM('N', 'N', nmo_, nmo_, nmo_, -1.0, X[0], nmo_, Ak[0], nmo_, 1.0, Rp[0], nmo_);
+            for (int i = 0; i < nmo_; i++) {
+                for (int j = 0; j < nmo_; j++) {
+                    dG[i][j] += 2.0 * (Rp[i][j] * (Ak[j][j] - Ak[i][i]) + Ak[i][j] * (Rp[j][j] - Rp[i][i]));
+                }
+            }
+        }
+    }
+    void transform(double** K) {
+        double** Tp = T_->pointer();
+        for (int xyz = 0; xyz < 3; xyz++) {
+            double** Ak = D_[xyz]->pointer();
+            C_DGEMM('N', 'N', nmo_, nmo_, nmo_, 1.0, Ak[0], nmo_, K[0], nmo_, 0.0, Tp[0], nmo_);
+            C_DGEMM('T', 'N', nmo_, nmo_, nmo_, 1.0, K[0], nmo_, Tp[0], nmo_, 0.0, Ak[0], nmo_);
+        }
+    }
+};
+
+/**
+ * Pipek-Mezey charges Q^A_ij = 1/2 sum_{m on A} (LS_mi L_mj + LS_mj L_mi), kept
+ * as the orbital-major L^T and (SL)^T so that each orbital is a contiguous row,
+ * plus the table of the diagonal charges.
+ */
+class PMMetric : public LocalMetric {
+    int nso_;
+    int nmo_;
+    int nA_;
+    int nthread_;
+    const std::vector<int>& Astarts_;
+    std::shared_ptr<Matrix> LT_;
+    std::shared_ptr<Matrix> LST_;
+    /// Q^A_ii, nmo x nA
+    std::shared_ptr<Matrix> P_;
+    /// Per-thread Q^A, R^A and accumulators
+    std::vector<std::shared_ptr<Matrix> > Qt_;
+    std::vector<std::shared_ptr<Matrix> > Rt_;
+    std::vector<std::shared_ptr<Matrix> > Gt_;
+    std::vector<std::shared_ptr<Matrix> > Ht_;
+
+    void charges(int i) {
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+        double* Pi = P_->pointer()[i];
+        for (int A = 0; A < nA_; A++) {
+            int off = Astarts_[A];
+            Pi[A] = C_DDOT(Astarts_[A + 1] - off, &LSp[i][off], 1, &Lp[i][off], 1);
+        }
+    }
+    // Q^A = 1/2 (LS_A^T L_A + L_A^T LS_A), from the orbital-major X = LS^T and Y = L^T blocks of atom A
+    void charge_matrix(int A, double** X, double** Y, double** Q) {
+        int off = Astarts_[A];
+        int nm = Astarts_[A + 1] - off;
+        C_DGEMM('N', 'T', nmo_, nmo_, nm, 0.5, &X[0][off], nso_, &Y[0][off], nso_, 0.0, Q[0], nmo_);
+        for (int i = 0; i < nmo_; i++) {
+            for (int j = 0; j < i; j++) {
+                double q = Q[i][j] + Q[j][i];
+                Q[i][j] = q;
+                Q[j][i] = q;
+            }
+            Q[i][i] *= 2.0;
+        }
+    }
+    void reduce(std::vector<std::shared_ptr<Matrix> >& parts, double** target) {
+        ::memset(target[0], '\0', sizeof(double) * nmo_ * nmo_);
+        for (int t = 0; t < nthread_; t++) {
+            C_DAXPY(nmo_ * nmo_, 1.0, parts[t]->pointer()[0], 1, target[0], 1);
+        }
+    }
+
+   public:
+    PMMetric(std::shared_ptr<Matrix> L, std::shared_ptr<Matrix> LS, const std::vector<int>& Astarts)
+        : Astarts_(Astarts) {
+        nso_ = L->rowspi()[0];
+        nmo_ = L->colspi()[0];
+        nA_ = Astarts_.size() - 1;
+        LT_ = L->transpose();
+        LST_ = LS->transpose();
+        P_ = std::shared_ptr<Matrix>(new Matrix("P", nmo_, nA_));
+        for (int i = 0; i < nmo_; i++) {
+            charges(i);
+        }
+        nthread_ = 1;
+#ifdef _OPENMP
+        nthread_ = omp_get_max_threads();
+#endif
+    }
+
+    std::shared_ptr<Matrix> L() const { return LT_->transpose(); }
+
+    double metric() { return P_->vector_dot(P_); }
+    void pair(int i, int j, double& a, double& b, double& c) {
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+        double* Pi = P_->pointer()[i];
+        double* Pj = P_->pointer()[j];
+        a = 0.0;
+        b = 0.0;
+        c = 0.0;
+        for (int A = 0; A < nA_; A++) {
+            int nm = Astarts_[A + 1] - Astarts_[A];
+            int off = Astarts_[A];
+            double Aij = 0.5 * C_DDOT(nm, &LSp[i][off], 1, &Lp[j][off], 1) +
+                         0.5 * C_DDOT(nm, &LSp[j][off], 1, &Lp[i][off], 1);
+            double Ad = (Pi[A] - Pj[A]);
+            double Ao = 2.0 * Aij;
+            a += Ad * Ad;
+            b += Ao * Ao;
+            c += Ad * Ao;
+        }
+    }
+    void rotate(const std::vector<std::pair<int, int> >& pairs, const std::vector<double>& cs,
+                const std::vector<double>& ss) {
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+        int npair = pairs.size();
+#pragma omp parallel for schedule(static)
+        for (int p = 0; p < npair; p++) {
+            int i = pairs[p].first;
+            int j = pairs[p].second;
+            C_DROT(nso_, LSp[i], 1, LSp[j], 1, cs[p], ss[p]);
+            C_DROT(nso_, Lp[i], 1, Lp[j], 1, cs[p], ss[p]);
+            charges(i);
+            charges(j);
+        }
+    }
+    void gradient(double** G, double** Hd) {
+        if (Qt_.empty()) {
+            for (int t = 0; t < nthread_; t++) {
+                Qt_.push_back(std::shared_ptr<Matrix>(new Matrix("Q", nmo_, nmo_)));
+                Rt_.push_back(std::shared_ptr<Matrix>(new Matrix("R", nmo_, nmo_)));
+                Gt_.push_back(std::shared_ptr<Matrix>(new Matrix("G", nmo_, nmo_)));
+                Ht_.push_back(std::shared_ptr<Matrix>(new Matrix("H", nmo_, nmo_)));
+            }
+        }
+        for (int t = 0; t < nthread_; t++) {
+            Gt_[t]->zero();
+            Ht_[t]->zero();
+        }
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+
+#pragma omp parallel for schedule(dynamic)
+        for (int A = 0; A < nA_; A++) {
+            int t = 0;
+#ifdef _OPENMP
+            t = omp_get_thread_num();
+#endif
+            double** Qp = Qt_[t]->pointer();
+            double** Gp = Gt_[t]->pointer();
+            double** Hp = Ht_[t]->pointer();
+            charge_matrix(A, LSp, Lp, Qp);
+            for (int i = 0; i < nmo_; i++) {
+                for (int j = 0; j < nmo_; j++) {
+                    double Ad = Qp[j][j] - Qp[i][i];
+                    Gp[i][j] += 2.0 * Qp[i][j] * Ad;
+                    Hp[i][j] += 2.0 * (4.0 * Qp[i][j] * Qp[i][j] - Ad * Ad);
+                }
+            }
+        }
+
+        reduce(Gt_, G);
+        reduce(Ht_, Hd);
+    }
+    void hessian(double** X, double** dG) {
+        // Along X, L^T moves by -X L^T and (SL)^T by -X (SL)^T
+        std::shared_ptr<Matrix> dL(new Matrix("dL", nmo_, nso_));
+        std::shared_ptr<Matrix> dLS(new Matrix("dLS", nmo_, nso_));
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+        double** dLp = dL->pointer();
+        double** dLSp = dLS->pointer();
+        C_DGEMM('N', 'N', nmo_, nso_, nmo_, -1.0, X[0], nmo_, Lp[0], nso_, 0.0, dLp[0], nso_);
+        C_DGEMM('N', 'N', nmo_, nso_, nmo_, -1.0, X[0], nmo_, LSp[0], nso_, 0.0, dLSp[0], nso_);
+
+        for (int t = 0; t < nthread_; t++) {
+            Gt_[t]->zero();
+        }
+
+#pragma omp parallel for schedule(dynamic)
+        for (int A = 0; A < nA_; A++) {
+            int t = 0;
+#ifdef _OPENMP
+            t = omp_get_thread_num();
+#endif
+            double** Qp = Qt_[t]->pointer();
+            double** Rp = Rt_[t]->pointer();
+            double** Gp = Gt_[t]->pointer();
+            int off = Astarts_[A];
+            int nm = Astarts_[A + 1] - off;
+            charge_matrix(A, LSp, Lp, Qp);
+            // R^A = [Q^A, X], the derivative of Q^A
+            C_DGEMM('N', 'T', nmo_, nmo_, nm, 0.5, &dLSp[0][off], nso_, &Lp[0][off], nso_, 0.0, Rp[0], nmo_);
+            C_DGEMM('N', 'T', nmo_, nmo_, nm, 0.5, &LSp[0][off], nso_, &dLp[0][off], nso_, 1.0, Rp[0], nmo_);
+            for (int i = 0; i < nmo_; i++) {
+                for (int j = 0; j < i; j++) {
+                    double r = Rp[i][j] + Rp[j][i];
+                    Rp[i][j] = r;
+                    Rp[j][i] = r;
+                }
+                Rp[i][i] *= 2.0;
+            }
+            for (int i = 0; i < nmo_; i++) {
+                for (int j = 0; j < nmo_; j++) {
+                    Gp[i][j] += 2.0 * (Rp[i][j] * (Qp[j][j] - Qp[i][i]) + Qp[i][j] * (Rp[j][j] - Rp[i][i]));
+                }
+            }
+        }
+
+        reduce(Gt_, dG);
+    }
+    void transform(double** K) {
+        std::shared_ptr<Matrix> T(new Matrix("T", nmo_, nso_));
+        double** Tp = T->pointer();
+        double** Lp = LT_->pointer();
+        double** LSp = LST_->pointer();
+        C_DGEMM('T', 'N', nmo_, nso_, nmo_, 1.0, K[0], nmo_, Lp[0], nso_, 0.0, Tp[0], nso_);
+        LT_->copy(T);
+        C_DGEMM('T', 'N', nmo_, nso_, nmo_, 1.0, K[0], nmo_, LSp[0], nso_, 0.0, Tp[0], nso_);
+        LST_->copy(T);
+        for (int i = 0; i < nmo_; i++) {
+            charges(i);
+        }
+    }
+};
+
+/**
+ * One Jacobi sweep in round-robin order: the orbitals, listed as in order, are
+ * paired off nmo/2 at a time so that every pair meets once over nmo - 1 rounds
+ * and no two pairs of a round share an orbital. The rotations of a round
+ * commute, so they are found and applied concurrently. U collects the
+ * rotations in its rows.
+ */
+void jacobi_sweep(LocalMetric& Q, double** Up, const std::vector<int>& order, int debug) {
+    int nmo = order.size();
+    std::vector<int> slots(order);
+    if (nmo % 2) slots.push_back(-1);
+    int nslot = slots.size();
+
+    std::vector<std::pair<int, int> > pairs;
+    std::vector<double> thetas, cs, ss;
+
+    for (int round = 0; round < nslot - 1; round++) {
+        pairs.clear();
+        for (int k = 0; k < nslot / 2; k++) {
+            int i = slots[k];
+            int j = slots[nslot - 1 - k];
+            if (i < 0 || j < 0) continue;
+            pairs.push_back(std::make_pair(i, j));
+        }
+        int npair = pairs.size();
+        thetas.resize(npair);
+        cs.resize(npair);
+        ss.resize(npair);
+
+        // > Compute the rotations < //
+
+#pragma omp parallel for schedule(dynamic)
+        for (int p = 0; p < npair; p++) {
+            double a, b, c;
+            Q.pair(pairs[p].first, pairs[p].second, a, b, c);
+
+            double Hd = a - b;
+            double Ho = 2.0 * c;
+            double theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
+
+            // Check for trivial (maximal) rotation, which might be better with theta = pi/4
+            if (std::fabs(theta) < 1.0E-8 && a < b) {
+                theta = M_PI / 4.0;
+            }
+
+            thetas[p] = theta;
+            cs[p] = cos(theta);
+            ss[p] = sin(theta);
+        }
+
+        if (debug > 3) {
+            for (int p = 0; p < npair; p++) {
+                outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", pairs[p].first, pairs[p].second,
+                                thetas[p]);
+            }
+        }
+
+        // > Apply the rotations < //
+
+        Q.rotate(pairs, cs, ss);
+#pragma omp parallel for schedule(static)
+        for (int p = 0; p < npair; p++) {
+            C_DROT(nmo, Up[pairs[p].first], 1, Up[pairs[p].second], 1, cs[p], ss[p]);
+        }
+
+        std::rotate(slots.begin() + 1, slots.end() - 1, slots.end());
+    }
+}
+
+/**
+ * One truncated Newton step U <- exp(X)^T U, with X from preconditioned CG on
+ * the Hessian H X = dG(X) - 1/2 [G, X] and backtracking on the metric.
+ * Returns false, leaving everything as it was, if the Hessian is not negative
+ * along the gradient or no step raises the metric; a Jacobi sweep is due then.
+ */
+bool newton_step(LocalMetric& Q, double** Up, int nmo, double& metric, int debug) {
+    std::shared_ptr<Matrix> G(new Matrix("G", nmo, nmo));
+    std::shared_ptr<Matrix> M(new Matrix("Hd", nmo, nmo));
+    double** Gp = G->pointer();
+    double** Mp = M->pointer();
+    Q.gradient(Gp, Mp);
+
+    double gnorm = std::sqrt(G->vector_dot(G));
+    if (gnorm == 0.0) return false;
+
+    // Diagonal preconditioner for -H, floored where the pairs are not concave
+    double Mmax = 0.0;
+    for (int i = 0; i < nmo; i++) {
+        for (int j = 0; j < nmo; j++) {
+            Mp[i][j] = -Mp[i][j];
+            Mmax = std::max(Mmax, Mp[i][j]);
+        }
+    }
+    if (Mmax <= 0.0) return false;
+    for (int i = 0; i < nmo; i++) {
+        for (int j = 0; j < nmo; j++) {
+            Mp[i][j] = std::max(Mp[i][j], 1.0E-3 * Mmax);
+        }
+    }
+
+    std::shared_ptr<Matrix> X(new Matrix("X", nmo, nmo));
+    std::shared_ptr<Matrix> R(G->clone());
+    std::shared_ptr<Matrix> Z(G->clone());
+    Z->apply_denominator(M);
+    std::shared_ptr<Matrix> P(Z->clone());
+    std::shared_ptr<Matrix> HP(new Matrix("HP", nmo, nmo));
+    double** Xp = X->pointer();
+    double** Rp = R->pointer();
+    double** Pp = P->pointer();
+    double** HPp = HP->pointer();
+
+    // Solve -H X = G to a relative residual of min(0.5, sqrt(|G|))
+    double eta = std::min(0.5, std::sqrt(gnorm));
+    double rz = R->vector_dot(Z);
+    int maxcg = std::min(50, nmo * (nmo - 1) / 2);
+    int cg = 0;
+    for (; cg < maxcg; cg++) {
+        Q.hessian(Pp, HPp);
+        C_DGEMM('N', 'N', nmo, nmo, nmo, -0.5, Gp[0], nmo, Pp[0], nmo, 1.0, HPp[0], nmo);
+        C_DGEMM('N', 'N', nmo, nmo, nmo, 0.5, Pp[0], nmo, Gp[0], nmo, 1.0, HPp[0], nmo);
+        HP->scale(-1.0);
+
+        double curvature = P->vector_dot(HP);
+        if (curvature <= 0.0) {
+            if (cg == 0) return false;
+            break;
+        }
+        double alpha = rz / curvature;
+        C_DAXPY(nmo * nmo, alpha, Pp[0], 1, Xp[0], 1);
+        C_DAXPY(nmo * nmo, -alpha, HPp[0], 1, Rp[0], 1);
+        if (std::sqrt(R->vector_dot(R)) < eta * gnorm) {
+            cg++;
+            break;
+        }
+        Z->copy(R);
+        Z->apply_denominator(M);
+        double rz2 = R->vector_dot(Z);
+        P->scale(rz2 / rz);
+        P->add(Z);
+        rz = rz2;
+    }
+
+    // No angle beyond pi/4, where the quadratic model is long gone
+    double xmax = X->absmax();
+    if (xmax > M_PI / 4.0) X->scale(M_PI / 4.0 / xmax);
+
+    // Backtrack until the metric rises
+    for (int half = 0; half < 5; half++) {
+        std::shared_ptr<Matrix> K(X->clone());
+        K->expm(4, true);
+        Q.transform(K->pointer());
+        double trial = Q.metric();
+        if (debug > 3) {
+            outfile->Printf("@Newton, CG = %3d, Step = %24.16E, Metric = %24.16E\n", cg, std::sqrt(X->vector_dot(X)), trial);
+        }
+        if (trial >= metric) {
+            std::shared_ptr<Matrix> U(new Matrix("U", nmo, nmo));
+            C_DGEMM('T', 'N', nmo, nmo, nmo, 1.0, K->pointer()[0], nmo, Up[0], nmo, 0.0, U->pointer()[0], nmo);
+            C_DCOPY(nmo * nmo, U->pointer()[0], 1, Up[0], 1);
+            metric = trial;
+            return true;
+        }
+        K->transpose_this();
+        Q.transform(K->pointer());
+        X->scale(0.5);
+    }
+    return false;
+}
+
+/**
+ * Maximize the metric by Jacobi sweeps over randomly labeled orbitals, or by
+ * Newton steps that fall back to sweeps wherever they cannot make progress.
+ * Returns convergence in the relative change of the metric.
+ */
+bool optimize(LocalMetric& Q, double** Up, int nmo, int maxiter, double convergence, bool newton, int print,
+              int debug, const char* label) {
+    // => Seed the random idempotently <= //
+
+    srand(0L);
+
+    double metric = Q.metric();
+    double old_metric = metric;
+
+    // => Iteration Print <= //
+    if (print) {
+        outfile->Printf("    Iteration %24s %14s\n", "Metric", "Residual");
+        outfile->Printf("    @%s %4d %24.16E %14s\n", label, 0, metric, "-");
+    }
+
+    // ==> Master Loop <== //
+
+    for (int iter = 1; iter <= maxiter; iter++) {
+        bool stepped = (newton && newton_step(Q, Up, nmo, metric, debug));
+
+        if (!stepped) {
+            // => Random Permutation <= //
+
+            std::vector<int> order;
+            for (int i = 0; i < nmo; i++) {
+                order.push_back(i);
+            }
+            std::vector<int> order2;
+            for (int i = 0; i < nmo; i++) {
+                int pivot = (1L * (nmo - i) * rand()) / RAND_MAX;
+                int i2 = order[pivot];
+                order[pivot] = order[nmo - i - 1];
+                order2.push_back(i2);
+            }
+
+            // => Jacobi sweep <= //
+
+            jacobi_sweep(Q, Up, order2, debug);
+
+            // => Metric <= //
+
+            metric = Q.metric();
+        }
+
+        double conv = std::fabs(metric - old_metric) / std::fabs(old_metric);
+        old_metric = metric;
+
+        // => Iteration Print <= //
+
+        if (print) {
+            if (newton) {
+                outfile->Printf("    @%s %4d %24.16E %14.6E %s\n", label, iter, metric, conv,
+                                (stepped ? "Newton" : "Jacobi"));
+            } else {
+                outfile->Printf("    @%s %4d %24.16E %14.6E\n", label, iter, metric, conv);
+            }
+        }
+
+        // => Convergence Check <= //
+
+        if (conv < convergence) return true;
+    }
+
+    return false;
+}
+
+}  // namespace
+
 Localizer::Localizer(std::shared_ptr<BasisSet> primary, std::shared_ptr<Matrix> C) :
     primary_(primary), C_(C)
 {
@@ -64,6 +642,7 @@ void Localizer::common_init()
     bench_ = 0;
     convergence_ = 1.0E-8;
     maxiter_ = 50;
+    newton_ = false;
     converged_ = false;
 }
 std::shared_ptr<Localizer> Localizer::build(const std::string& type, std::shared_ptr<BasisSet> primary, std::shared_ptr<Matrix> C, Options& options)
@@ -85,6 +664,7 @@ std::shared_ptr<Localizer> Localizer::build(const std::string& type, std::shared
     local->set_bench(options.get_int("BENCH"));
     local->set_convergence(options.get_double("LOCAL_CONVERGENCE"));
     local->set_maxiter(options.get_int("LOCAL_MAXITER"));
+    local->set_newton(options.get_str("LOCAL_SOLVER") == "NEWTON");
 
     return local;
 }
@@ -157,6 +737,7 @@ void BoysLocalizer::print_header() const
     outfile->Printf( "  ==> Boys Localizer <==\n\n");
     outfile->Printf( "    Convergence = %11.3E\n", convergence_);
     outfile->Printf( "    Maxiter     = %11d\n", maxiter_);
+    outfile->Printf( "    Solver      = %11s\n", (newton_ ? "NEWTON" : "JACOBI"));
     outfile->Printf( "\n");
 
 }
@@ -203,146 +784,22 @@ void BoysLocalizer::localize()
 
     // => Pointers <= //
 
-    std::vector<double**> Dp;
-    for (int xyz = 0; xyz < 3; xyz++) {
-        Dp.push_back(Dmo[xyz]->pointer());
-    }
     double** Cp = C_->pointer();
     double** Lp = L_->pointer();
     double** Up = U_->pointer();
 
-    // => Seed the random idempotently <= //
-
-    srand(0L);
-
-    // => Metric <= //
-
-    double metric = 0.0;
-    for (int xyz = 0; xyz < 3; xyz++) {
-        metric += C_DDOT(nmo,Dp[xyz][0],nmo+1,Dp[xyz][0],nmo+1);
-    }
-    double old_metric = metric;
-
-    // => Iteration Print <= //
-    outfile->Printf( "    Iteration %24s %14s\n", "Metric", "Residual");
-    outfile->Printf( "    @Boys %4d %24.16E %14s\n", 0, metric, "-");
-
-    // ==> Master Loop <== //
-
-    double Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
-
-    for (int iter = 1; iter <= maxiter_; iter++) {
-
-        // => Random Permutation <= //
-
-        std::vector<int> order;
-        for (int i = 0; i < nmo; i++) {
-            order.push_back(i);
-        }
-        std::vector<int> order2;
-        for (int i = 0; i < nmo; i++) {
-            int pivot = (1L * (nmo - i) * rand()) / RAND_MAX;
-            int i2 = order[pivot];
-            order[pivot] = order[nmo - i - 1];
-            order2.push_back(i2);
-        }
-
-        // => Jacobi sweep <= //
-
-        for (int i2 = 0; i2 < nmo-1; i2++) {
-            for (int j2 = i2+1; j2 < nmo; j2++) {
-
-                int i = order2[i2];
-                int j = order2[j2];
-
-                // > Compute the rotation < //
-
-                // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
-                for (int xyz = 0; xyz < 3; xyz++) {
-                    double** Ak = Dp[xyz];
-                    Ad = (Ak[i][i] - Ak[j][j]);
-                    Ao = 2.0 * Ak[i][j];
-                    a += Ad * Ad;
-                    b += Ao * Ao;
-                    c += Ad * Ao;
-                }
-
-                // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
-
-                // Check for trivial (maximal) rotation, which might be better with theta = pi/4
-                if (std::fabs(theta) < 1.0E-8) {
-                    double O0 = 0.0;
-                    double O1 = 0.0;;
-                    for (int xyz = 0; xyz < 3; xyz++) {
-                        double** Ak = Dp[xyz];
-                        O0 += Ak[i][j] * Ak[i][j];
-                        O1 += 0.25 * (Ak[j][j] - Ak[i][i]) * (Ak[j][j] - Ak[i][i]);
-                    }
-                    if (O1 < O0) {
-                        theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf( "@Break\n");
-                        }
-                    }
-                }
-
-                // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
-
-                if (debug_ > 3) {
-                    outfile->Printf( "@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j,theta);
-                    outfile->Printf( "@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
-                }
-
-                // > Apply the rotation < //
-
-                // rows and columns of A^k
-                for (int xyz = 0; xyz < 3; xyz++) {
-                    double** Ak = Dp[xyz];
-                    C_DROT(nmo,&Ak[i][0],1,&Ak[j][0],1,cc,ss);
-                    C_DROT(nmo,&Ak[0][i],nmo,&Ak[0][j],nmo,cc,ss);
-                }
-
-                // Q
-                C_DROT(nmo,Up[i],1,Up[j],1,cc,ss);
-            }
-        }
-
-        // => Metric <= //
-
-        metric = 0.0;
-        for (int xyz = 0; xyz < 3; xyz++) {
-            metric += C_DDOT(nmo,Dp[xyz][0],nmo+1,Dp[xyz][0],nmo+1);
-        }
-
-        double conv = std::fabs(metric - old_metric) / std::fabs(old_metric);
-        old_metric = metric;
-
-        // => Iteration Print <= //
-
-        outfile->Printf( "    @Boys %4d %24.16E %14.6E\n", iter, metric, conv);
+    // => Optimization <= //
 
-        // => Convergence Check <= //
+    BoysMetric metric(Dmo);
+    converged_ = optimize(metric, Up, nmo, maxiter_, convergence_, newton_, print_, debug_, "Boys");
 
-        if (conv < convergence_) {
-            converged_ = true;
-            break;
+    if (print_) {
+        outfile->Printf( "\n");
+        if (converged_) {
+            outfile->Printf( "    Boys Localizer converged.\n\n");
+        } else {
+            outfile->Printf( "    Boys Localizer failed.\n\n");
         }
-
-    }
-
-    outfile->Printf( "\n");
-    if (converged_) {
-        outfile->Printf( "    Boys Localizer converged.\n\n");
-    } else {
-        outfile->Printf( "    Boys Localizer failed.\n\n");
     }
 
     U_->transpose_this();
@@ -365,6 +822,7 @@ void PMLocalizer::print_header() const
     outfile->Printf( "  ==> Pipek-Mezey Localizer <==\n\n");
     outfile->Printf( "    Convergence = %11.3E\n", convergence_);
     outfile->Printf( "    Maxiter     = %11d\n", maxiter_);
+    outfile->Printf( "    Solver      = %11s\n", (newton_ ? "NEWTON" : "JACOBI"));
     outfile->Printf( "\n");
 
 }
@@ -376,7 +834,6 @@ void PMLocalizer::localize()
 
     int nso = C_->rowspi()[0];
     int nmo = C_->colspi()[0];
-    int nA  = primary_->molecule()->natom();
 
     // => Overlap Integrals <= //
 
@@ -421,159 +878,20 @@ void PMLocalizer::localize()
     }
     Astarts.push_back(primary_->nbf());
 
-    // => Seed the random idempotently <= //
-
-    srand(0L);
-
-    // => Metric <= //
-
-
-    double metric = 0.0;
-    for (int i = 0; i < nmo; i++) {
-        for (int A = 0; A < nA; A++) {
-            int nm = Astarts[A+1] - Astarts[A];
-            int off = Astarts[A];
-            double PA = C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][i],nmo);
-            metric += PA * PA;
-        }
-    }
-    double old_metric = metric;
-
-    // => Iteration Print <= //
-    outfile->Printf( "    Iteration %24s %14s\n", "Metric", "Residual");
-    outfile->Printf( "    @PM %4d %24.16E %14s\n", 0, metric, "-");
-
-    // ==> Master Loop <== //
-
-    double Aii, Ajj, Aij, Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
+    // => Optimization <= //
 
-    for (int iter = 1; iter <= maxiter_; iter++) {
+    PMMetric metric(L_, LS, Astarts);
+    LS.reset();
+    converged_ = optimize(metric, Up, nmo, maxiter_, convergence_, newton_, print_, debug_, "PM");
+    L_->copy(metric.L());
 
-        // => Random Permutation <= //
-
-        std::vector<int> order;
-        for (int i = 0; i < nmo; i++) {
-            order.push_back(i);
-        }
-        std::vector<int> order2;
-        for (int i = 0; i < nmo; i++) {
-            int pivot = (1L * (nmo - i) * rand()) / RAND_MAX;
-            int i2 = order[pivot];
-            order[pivot] = order[nmo - i - 1];
-            order2.push_back(i2);
+    if (print_) {
+        outfile->Printf( "\n");
+        if (converged_) {
+            outfile->Printf( "    PM Localizer converged.\n\n");
+        } else {
+            outfile->Printf( "    PM Localizer failed.\n\n");
         }
-
-        // => Jacobi sweep <= //
-
-        for (int i2 = 0; i2 < nmo-1; i2++) {
-            for (int j2 = i2+1; j2 < nmo; j2++) {
-
-                int i = order2[i2];
-                int j = order2[j2];
-
-                // > Compute the rotation < //
-
-                // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
-                for (int A = 0; A < nA; A++) {
-
-                    int nm = Astarts[A+1] - Astarts[A];
-                    int off = Astarts[A];
-                    Aii = C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][i],nmo);
-                    Ajj = C_DDOT(nm,&LSp[off][j],nmo,&Lp[off][j],nmo);
-                    Aij = 0.5 * C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][j],nmo) +
-                          0.5 * C_DDOT(nm,&LSp[off][j],nmo,&Lp[off][i],nmo);
-
-
-                    Ad = (Aii - Ajj);
-                    Ao = 2.0 * Aij;
-                    a += Ad * Ad;
-                    b += Ao * Ao;
-                    c += Ad * Ao;
-                }
-
-                // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
-
-                // Check for trivial (maximal) rotation, which might be better with theta = pi/4
-                if (std::fabs(theta) < 1.0E-8) {
-                    double O0 = 0.0;
-                    double O1 = 0.0;;
-                    for (int A = 0; A < nA; A++) {
-                        int nm = Astarts[A+1] - Astarts[A];
-                        int off = Astarts[A];
-                        Aii = C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][i],nmo);
-                        Ajj = C_DDOT(nm,&LSp[off][j],nmo,&Lp[off][j],nmo);
-                        Aij = 0.5 * C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][j],nmo) +
-                              0.5 * C_DDOT(nm,&LSp[off][j],nmo,&Lp[off][i],nmo);
-                        O0 += Aij * Aij;
-                        O1 += 0.25 * (Ajj - Aii) * (Ajj - Aii);
-                    }
-                    if (O1 < O0) {
-                        theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf( "@Break\n");
-                        }
-                    }
-                }
-
-                // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
-
-                if (debug_ > 3) {
-                    outfile->Printf( "@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j,theta);
-                    outfile->Printf( "@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
-                }
-
-                // > Apply the rotation < //
-
-                // columns of LS and L
-                C_DROT(nso,&LSp[0][i],nmo,&LSp[0][j],nmo,cc,ss);
-                C_DROT(nso,&Lp[0][i],nmo,&Lp[0][j],nmo,cc,ss);
-
-                // Q
-                C_DROT(nmo,Up[i],1,Up[j],1,cc,ss);
-            }
-        }
-
-        // => Metric <= //
-
-        metric = 0.0;
-        for (int i = 0; i < nmo; i++) {
-            for (int A = 0; A < nA; A++) {
-                int nm = Astarts[A+1] - Astarts[A];
-                int off = Astarts[A];
-                double PA = C_DDOT(nm,&LSp[off][i],nmo,&Lp[off][i],nmo);
-                metric += PA * PA;
-            }
-        }
-
-        double conv = std::fabs(metric - old_metric) / std::fabs(old_metric);
-        old_metric = metric;
-
-        // => Iteration Print <= //
-
-        outfile->Printf( "    @PM %4d %24.16E %14.6E\n", iter, metric, conv);
-
-        // => Convergence Check <= //
-
-        if (conv < convergence_) {
-            converged_ = true;
-            break;
-        }
-
-    }
-
-    outfile->Printf( "\n");
-    if (converged_) {
-        outfile->Printf( "    PM Localizer converged.\n\n");
-    } else {
-        outfile->Printf( "    PM Localizer failed.\n\n");
     }
 
     U_->transpose_this();
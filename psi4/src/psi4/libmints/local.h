@@ -56,6 +56,8 @@ protected:
     double convergence_;
     /// Maximum number of iterations
     int maxiter_;
+    /// Take Newton steps, with Jacobi sweeps as the fallback?
+    bool newton_;
 
     /// Primary orbital basis set
     std::shared_ptr <BasisSet> primary_;
@@ -127,6 +129,9 @@ public:
     void set_maxiter(int maxiter)
     { maxiter_ = maxiter; }
 
+    void set_newton(bool newton)
+    { newton_ = newton; }
+
 };
 
 class BoysLocalizer : public Localizer
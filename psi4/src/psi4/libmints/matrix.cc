@@ -36,6 +36,7 @@
 
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/memory_tracker.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libiwl/iwl.hpp"
@@ -52,6 +53,7 @@
 #include "molecule.h"
 #include "pointgrp.h"
 #include "petitelist.h"
+#include "distlinalg.h"
 
 #include <cmath>
 #include <cstdio>
@@ -63,6 +65,10 @@
 #include <regex>
 #include <tuple>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // In molecule.cc
 namespace psi {
 extern int str_to_int(const std::string &s);
@@ -72,6 +78,19 @@ extern double str_to_double(const std::string &s);
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 #define MAX(x, y) ((x) > (y) ? (x) : (y))
 
+namespace {
+
+/// Per-thread scratch for the intermediates of transforms and triplets.
+/// It only grows, so steady-state SCF and CPHF iterations stop allocating.
+double *transform_workspace(size_t size)
+{
+    static thread_local std::vector<double> work;
+    if (work.size() < size) work.resize(size);
+    return work.data();
+}
+
+}
+
 Matrix::Matrix()
 {
     matrix_ = NULL;
@@ -269,9 +288,7 @@ Matrix::~Matrix()
 double **Matrix::matrix(int nrow, int ncol)
 {
     double **mat = (double **) malloc(sizeof(double *) * nrow);
-    const size_t size = sizeof(double) * nrow * ncol;
-    mat[0] = (double *) malloc(size);
-    ::memset((void *) mat[0], 0, size);
+    mat[0] = init_aligned_array(nrow * (size_t) ncol);
     for (int r = 1; r < nrow; ++r) mat[r] = mat[r - 1] + ncol;
     return mat;
 }
@@ -279,7 +296,7 @@ double **Matrix::matrix(int nrow, int ncol)
 /// free a (block) matrix -- analogous to libciomr's free_block
 void Matrix::free(double **Block)
 {
-    ::free(Block[0]);
+    free_aligned_array(Block[0]);
     ::free(Block);
 }
 
@@ -318,6 +335,36 @@ SharedMatrix Matrix::create(const std::string &name,
     return SharedMatrix(new Matrix(name, rows, cols));
 }
 
+SharedMatrix Matrix::wrap(const std::string &name,
+                          const Dimension &rows,
+                          const Dimension &cols,
+                          const std::vector<double *> &blocks,
+                          std::shared_ptr<void> owner)
+{
+    if (rows.n() != cols.n() || (size_t) rows.n() != blocks.size())
+        throw PSIEXCEPTION("Matrix::wrap: Need one block per irrep.");
+
+    SharedMatrix ret(new Matrix(name));
+    ret->nirrep_ = rows.n();
+    ret->rowspi_ = rows;
+    ret->colspi_ = cols;
+    if (!ret->nirrep_) return ret;
+
+    ret->matrix_ = (double ***) malloc(sizeof(double ***) * ret->nirrep_);
+    for (int h = 0; h < ret->nirrep_; ++h) {
+        if (rows[h] != 0 && cols[h] != 0) {
+            if (blocks[h] == NULL)
+                throw PSIEXCEPTION("Matrix::wrap: Non-empty block without data.");
+            ret->matrix_[h] = (double **) malloc(sizeof(double *) * rows[h]);
+            for (int r = 0; r < rows[h]; ++r) ret->matrix_[h][r] = blocks[h] + r * (size_t) cols[h];
+        } else {
+            ret->matrix_[h] = NULL;
+        }
+    }
+    ret->external_ = owner;
+    return ret;
+}
+
 SharedMatrix Matrix::clone() const
 {
     SharedMatrix temp(new Matrix(this));
@@ -530,6 +577,11 @@ void Matrix::alloc()
         return;
     }
 
+    size_t bytes = 0;
+    for (int h = 0; h < nirrep_; ++h) bytes += sizeof(double) * rowspi_[h] * (size_t) colspi_[h ^ symmetry_];
+    MemoryTracker::allocate(bytes, name_.empty() ? "a Matrix" : name_.c_str());
+    tracked_bytes_ = bytes;
+
     matrix_ = (double ***) malloc(sizeof(double ***) * nirrep_);
     for (int h = 0; h < nirrep_; ++h) {
         if (rowspi_[h] != 0 && colspi_[h ^ symmetry_] != 0)
@@ -553,11 +605,17 @@ void Matrix::release()
         return;
 
     for (int h = 0; h < nirrep_; ++h) {
-        if (matrix_[h])
+        if (!matrix_[h]) continue;
+        if (external_)
+            ::free(matrix_[h]);
+        else
             Matrix::free(matrix_[h]);
     }
     ::free(matrix_);
     matrix_ = NULL;
+    external_.reset();
+    MemoryTracker::release(tracked_bytes_);
+    tracked_bytes_ = 0;
 }
 
 void Matrix::copy_from(double ***c)
@@ -1405,6 +1463,72 @@ double Matrix::absmax()
     return max;
 }
 
+bool Matrix::triplet_into_ok(const Matrix *L, const Matrix *F, const Matrix *R) const
+{
+    return L->nirrep_ == F->nirrep_ && R->nirrep_ == F->nirrep_ && nirrep_ == F->nirrep_ &&
+           !L->symmetry_ && !R->symmetry_ && symmetry_ == F->symmetry_;
+}
+
+void Matrix::triplet_into(const Matrix *L, bool transL, const Matrix *F, bool transF,
+                          const Matrix *R, bool transR, bool resize)
+{
+    int nirrep = F->nirrep_;
+    int sym = F->symmetry_;
+    if (transF && sym)
+        throw PSIEXCEPTION("Matrix::triplet_into: transposed F must be totally symmetric.");
+
+    // Block h of op(F) has rows in irrep h and columns in irrep h ^ sym
+    std::vector<int> m(nirrep), n(nirrep), k(nirrep), kL(nirrep);
+    std::vector<size_t> offset(nirrep + 1, 0L);
+    for (int h = 0; h < nirrep; h++) {
+        int hc = h ^ sym;
+        k[h] = (transF ? F->rowspi_[h] : F->colspi_[hc]);
+        kL[h] = (transF ? F->colspi_[h] : F->rowspi_[h]);
+        m[h] = (transL ? L->colspi_[h] : L->rowspi_[h]);
+        n[h] = (transR ? R->rowspi_[hc] : R->colspi_[hc]);
+        if (k[h] != (transR ? R->colspi_[hc] : R->rowspi_[hc]) || kL[h] != (transL ? L->rowspi_[h] : L->colspi_[h]))
+            throw PSIEXCEPTION("Matrix::triplet_into: Dimension mismatch");
+        offset[h + 1] = offset[h] + kL[h] * (size_t) n[h];
+    }
+
+    // => op(F) op(R), for every irrep before this is touched, as F may be this <= //
+    double *work = transform_workspace(offset[nirrep]);
+    for (int h = 0; h < nirrep; h++) {
+        int hc = h ^ sym;
+        if (!kL[h] || !n[h]) continue;
+        if (!k[h]) {
+            ::memset((void *) &work[offset[h]], '\0', sizeof(double) * kL[h] * n[h]);
+            continue;
+        }
+        C_DGEMM((transF ? 'T' : 'N'), (transR ? 'T' : 'N'), kL[h], n[h], k[h], 1.0,
+                F->matrix_[h][0], F->colspi_[hc], R->matrix_[hc][0], R->colspi_[hc],
+                0.0, &work[offset[h]], n[h]);
+    }
+
+    if (resize) {
+        Dimension rows(nirrep), cols(nirrep);
+        for (int h = 0; h < nirrep; h++) {
+            rows[h] = m[h];
+            cols[h ^ sym] = n[h];
+        }
+        if (rows != rowspi_ || cols != colspi_)
+            init(rows, cols, name_, sym);
+    }
+
+    // => op(L) [op(F) op(R)] <= //
+    for (int h = 0; h < nirrep; h++) {
+        int hc = h ^ sym;
+        if (!m[h] || !n[h]) continue;
+        if (!kL[h]) {
+            ::memset((void *) matrix_[h][0], '\0', sizeof(double) * m[h] * n[h]);
+            continue;
+        }
+        C_DGEMM((transL ? 'T' : 'N'), 'N', m[h], n[h], kL[h], 1.0,
+                L->matrix_[h][0], L->colspi_[h], &work[offset[h]], n[h],
+                0.0, matrix_[h][0], colspi_[hc]);
+    }
+}
+
 void Matrix::transform(const Matrix *const a, const Matrix *const transformer)
 {
 #ifdef PSIDEBUG
@@ -1414,6 +1538,11 @@ void Matrix::transform(const Matrix *const a, const Matrix *const transformer)
         throw PSIEXCEPTION("Matrix::transformer(a, transformer): Target matrix does not have correct dimensions.");
 #endif
 
+    if (triplet_into_ok(transformer, a, transformer)) {
+        triplet_into(transformer, true, a, false, transformer, false, false);
+        return;
+    }
+
     Matrix temp(a->rowspi(), transformer->colspi());
     temp.gemm(false, false, 1.0, a, transformer, 0.0);
     gemm(true, false, 1.0, transformer, &temp, 0.0);
@@ -1426,6 +1555,11 @@ void Matrix::transform(const SharedMatrix &a, const SharedMatrix &transformer)
 
 void Matrix::transform(const Matrix *const transformer)
 {
+    if (triplet_into_ok(transformer, this, transformer)) {
+        triplet_into(transformer, true, this, false, transformer, false, true);
+        return;
+    }
+
     Matrix temp(nirrep_, rowspi_, transformer->colspi());
     temp.gemm(false, false, 1.0, this, transformer, 0.0);
 
@@ -1452,6 +1586,11 @@ void Matrix::transform(const SharedMatrix &L,
         throw PSIEXCEPTION("Matrix::transformer(L, F, R): Target matrix does not have correct dimensions.");
 #endif
 
+    if (triplet_into_ok(L.get(), F.get(), R.get())) {
+        triplet_into(L.get(), true, F.get(), false, R.get(), false, false);
+        return;
+    }
+
     Matrix temp(nirrep_, F->rowspi_, R->colspi_, F->symmetry_ ^ R->symmetry_);
     temp.gemm(false, false, 1.0, F, R, 0.0);
     gemm(true, false, 1.0, L, temp, 0.0);
@@ -1459,6 +1598,11 @@ void Matrix::transform(const SharedMatrix &L,
 
 void Matrix::back_transform(const Matrix *const a, const Matrix *const transformer)
 {
+    if (triplet_into_ok(transformer, a, transformer)) {
+        triplet_into(transformer, false, a, false, transformer, true, false);
+        return;
+    }
+
     Matrix temp(transformer->rowspi(), a->colspi());
 
     temp.gemm(false, false, 1.0, transformer, a, 0.0);
@@ -1472,6 +1616,11 @@ void Matrix::back_transform(const SharedMatrix &a, const SharedMatrix &transform
 
 void Matrix::back_transform(const Matrix *const transformer)
 {
+    if (triplet_into_ok(transformer, this, transformer)) {
+        triplet_into(transformer, false, this, false, transformer, true, true);
+        return;
+    }
+
     bool square = true;
     int h = 0;
 
@@ -1680,8 +1829,23 @@ SharedMatrix Matrix::doublet(const SharedMatrix &A, const SharedMatrix &B, bool
 
 SharedMatrix Matrix::triplet(const SharedMatrix &A, const SharedMatrix &B, const SharedMatrix &C, bool transA, bool transB, bool transC)
 {
-    SharedMatrix T = Matrix::doublet(A, B, transA, transB);
-    SharedMatrix S = Matrix::doublet(T, C, false, transC);
+    if (A->symmetry() || B->symmetry() || C->symmetry()) {
+        throw PSIEXCEPTION("Matrix::triplet is not supported for this non-totally-symmetric thing.");
+    }
+
+    if (A->nirrep() != B->nirrep() || B->nirrep() != C->nirrep()) {
+        throw PSIEXCEPTION("Matrix::triplet: Matrices do not have the same nirreps");
+    }
+
+    int nirrep = A->nirrep();
+    Dimension m(nirrep), n(nirrep);
+    for (int h = 0; h < nirrep; h++) {
+        m[h] = (transA ? A->colspi()[h] : A->rowspi()[h]);
+        n[h] = (transC ? C->rowspi()[h] : C->colspi()[h]);
+    }
+
+    SharedMatrix S(new Matrix("T", m, n));
+    S->triplet_into(A.get(), transA, B.get(), transB, C.get(), transC, false);
     return S;
 }
 
@@ -1995,12 +2159,100 @@ void Matrix::diagonalize(Matrix *eigvectors, Vector *eigvalues, diagonalize_orde
     }
     int h;
     for (h = 0; h < nirrep_; ++h) {
-        if (rowspi_[h]) {
+        if (rowspi_[h] == 0) continue;
+        int n = rowspi_[h];
+        if (distlinalg::use_distributed(n)) {
+            // Block-cyclic pdsyevd/ELPA, sorted and transposed to match sq_rsp
+            std::vector<double> Z(matrix_[h][0], matrix_[h][0] + n * (size_t) n);
+            std::vector<double> w(n);
+            distlinalg::syev(n, Z.data(), w.data());
+            bool descend = (nMatz == evals_only_descending || nMatz == descending);
+            bool vectors = (nMatz == ascending || nMatz == descending);
+            for (int k = 0; k < n; k++) {
+                int kk = descend ? n - 1 - k : k;
+                eigvalues->vector_[h][k] = w[kk];
+                if (vectors) C_DCOPY(n, &Z[kk * (size_t) n], 1, &eigvectors->matrix_[h][0][k], n);
+            }
+        } else {
             sq_rsp(rowspi_[h], colspi_[h], matrix_[h], eigvalues->vector_[h], static_cast<int>(nMatz), eigvectors->matrix_[h], 1.0e-14);
         }
     }
 }
 
+void Matrix::diagonalize_batch(const std::vector<SharedMatrix>& mats, const std::vector<SharedMatrix>& eigvectors,
+                               const std::vector<SharedVector>& eigvalues, diagonalize_order nMatz)
+{
+    if (eigvectors.size() != mats.size() || eigvalues.size() != mats.size()) {
+        throw PSIEXCEPTION("Matrix::diagonalize_batch: one eigvector matrix and eigvalue vector per matrix, please.");
+    }
+
+    // One task per nonempty irrep block; the distributed ones keep the single-matrix path
+    std::vector<std::pair<size_t, int> > tasks;
+    int nmax = 0;
+    for (size_t k = 0; k < mats.size(); k++) {
+        if (mats[k]->symmetry_) {
+            throw PSIEXCEPTION("Matrix::diagonalize_batch: Matrix is non-totally symmetric.");
+        }
+        for (int h = 0; h < mats[k]->nirrep_; h++) {
+            int n = mats[k]->rowspi_[h];
+            if (n == 0) continue;
+            if (distlinalg::use_distributed(n)) {
+                Matrix block("Block", n, n);
+                Matrix vecs("Block vectors", n, n);
+                Vector vals("Block values", n);
+                C_DCOPY(n * (size_t) n, mats[k]->matrix_[h][0], 1, block.matrix_[0][0], 1);
+                block.diagonalize(&vecs, &vals, nMatz);
+                C_DCOPY(n, vals.vector_[0], 1, eigvalues[k]->vector_[h], 1);
+                if (nMatz == ascending || nMatz == descending)
+                    C_DCOPY(n * (size_t) n, vecs.matrix_[0][0], 1, eigvectors[k]->matrix_[h][0], 1);
+                continue;
+            }
+            tasks.push_back(std::make_pair(k, h));
+            nmax = std::max(nmax, n);
+        }
+    }
+    if (tasks.empty()) return;
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = std::min((int) tasks.size(), Process::environment.get_n_threads());
+    if (omp_in_parallel()) nthread = 1;
+#endif
+
+    bool vectors = (nMatz == ascending || nMatz == descending);
+    bool descend = (nMatz == evals_only_descending || nMatz == descending);
+
+    // Same DSYEV call and workspace length as sq_rsp, so the results match Matrix::diagonalize
+    std::vector<std::vector<double> > A(nthread, std::vector<double>(nmax * (size_t) nmax));
+    std::vector<std::vector<double> > work(nthread, std::vector<double>(3 * (size_t) nmax));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t task = 0; task < tasks.size(); task++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        Matrix* M = mats[tasks[task].first].get();
+        int h = tasks[task].second;
+        int n = M->rowspi_[h];
+        double* Ap = A[thread].data();
+        double* w = eigvalues[tasks[task].first]->vector_[h];
+
+        C_DCOPY(n * (size_t) n, M->matrix_[h][0], 1, Ap, 1);
+        C_DSYEV((vectors ? 'V' : 'N'), 'U', n, Ap, n, w, work[thread].data(), 3 * n);
+
+        if (descend) std::reverse(w, w + n);
+        if (vectors) {
+            // LAPACK leaves the eigenvectors in the rows of A
+            double** Vp = eigvectors[tasks[task].first]->matrix_[h];
+            for (int k = 0; k < n; k++) {
+                int kk = descend ? n - 1 - k : k;
+                C_DCOPY(n, &Ap[kk * (size_t) n], 1, &Vp[0][k], n);
+            }
+        }
+    }
+}
+
 void Matrix::diagonalize(SharedMatrix &eigvectors, std::shared_ptr <Vector> &eigvalues, diagonalize_order nMatz)
 {
     diagonalize(eigvectors.get(), eigvalues.get(), nMatz);
@@ -2574,14 +2826,19 @@ Dimension Matrix::power(double alpha, double cutoff)
         memcpy(static_cast<void *>(A1[0]), static_cast<void *>(A[0]), sizeof(double) * n * n);
 
         // Eigendecomposition
-        double lwork;
-        int stat = C_DSYEV('V', 'U', n, A1[0], n, a, &lwork, -1);
-        double *work = new double[(int) lwork];
-        stat = C_DSYEV('V', 'U', n, A1[0], n, a, work, (int) lwork);
-        delete[] work;
+        bool distributed = distlinalg::use_distributed(n);
+        if (distributed) {
+            distlinalg::syev(n, A1[0], a);
+        } else {
+            double lwork;
+            int stat = C_DSYEV('V', 'U', n, A1[0], n, a, &lwork, -1);
+            double *work = new double[(int) lwork];
+            stat = C_DSYEV('V', 'U', n, A1[0], n, a, work, (int) lwork);
+            delete[] work;
 
-        if (stat)
-            throw PSIEXCEPTION("Matrix::power: C_DSYEV failed");
+            if (stat)
+                throw PSIEXCEPTION("Matrix::power: C_DSYEV failed");
+        }
 
         memcpy(static_cast<void *>(A2[0]), static_cast<void *>(A1[0]), sizeof(double) * n * n);
 
@@ -2604,7 +2861,10 @@ Dimension Matrix::power(double alpha, double cutoff)
         }
         remaining[h] = remain;
 
-        C_DGEMM('T', 'N', n, n, n, 1.0, A2[0], n, A1[0], n, 0.0, A[0], n);
+        if (distributed)
+            distlinalg::gemm('T', 'N', n, 1.0, A2[0], A1[0], 0.0, A[0]);
+        else
+            C_DGEMM('T', 'N', n, n, n, 1.0, A2[0], n, A1[0], n, 0.0, A[0], n);
 
         delete[] a;
         Matrix::free(A1);
@@ -2910,10 +3170,7 @@ void Matrix::hermitivitize()
 
 void Matrix::transform(const Matrix &a, const Matrix &transformer)
 {
-    // Allocate adaquate size temporary matrix.
-    Matrix temp(a.rowspi(), transformer.colspi());
-    temp.gemm(false, false, 1.0, a, transformer, 0.0);
-    gemm(true, false, 1.0, transformer, temp, 0.0);
+    transform(&a, &transformer);
 }
 
 void Matrix::apply_symmetry(const SharedMatrix &a, const SharedMatrix &transformer)
@@ -3036,26 +3293,17 @@ void Matrix::remove_symmetry(const SharedMatrix &a, const SharedMatrix &SO2AO)
 
 void Matrix::transform(const Matrix &transformer)
 {
-    Matrix temp(this);
-
-    temp.gemm(false, false, 1.0, *this, transformer, 0.0);
-    gemm(true, false, 1.0, transformer, temp, 0.0);
+    transform(&transformer);
 }
 
 void Matrix::back_transform(const Matrix &a, const Matrix &transformer)
 {
-    Matrix temp(a);
-
-    temp.gemm(false, true, 1.0, a, transformer, 0.0);
-    gemm(false, false, 1.0, transformer, temp, 0.0);
+    back_transform(&a, &transformer);
 }
 
 void Matrix::back_transform(const Matrix &transformer)
 {
-    Matrix temp(this);
-
-    temp.gemm(false, true, 1.0, *this, transformer, 0.0);
-    gemm(false, false, 1.0, transformer, temp, 0.0);
+    back_transform(&transformer);
 }
 
 double Matrix::vector_dot(const Matrix &rhs)
@@ -3414,6 +3662,7 @@ void Matrix::load_mpqc(const std::string &filename)
     else
         throw PSIEXCEPTION("Matrix::load_mpqc: Third line must be 'blocks #'");
 
+    release();
     nirrep_ = infile_nirrep;
 
     rowspi_ = Dimension(nirrep_);
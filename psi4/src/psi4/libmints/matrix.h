@@ -77,6 +77,10 @@ protected:
     std::string name_;
     /// Symmetry of this matrix (in most cases this will be 0 [totally symmetric])
     int symmetry_;
+    /// Bytes of matrix_ counted by MemoryTracker, as dimensions may change before release()
+    size_t tracked_bytes_ = 0;
+    /// Owner of the blocks when they were handed in to wrap(); matrix_ then holds only row pointers
+    std::shared_ptr<void> external_;
 
     /// Allocates matrix_
     void alloc();
@@ -93,6 +97,17 @@ protected:
 
     void print_mat(const double *const *const a, int m, int n, std::string out) const;
 
+    /**
+     * this = op(L) op(F) op(R), irrep block by irrep block, with the
+     * intermediate op(F) op(R) held in a per-thread workspace instead of a
+     * temporary Matrix. L and R must be totally symmetric, and F as well if
+     * transF. F may be this; if resize, this is reshaped to fit the product.
+     */
+    void triplet_into(const Matrix* L, bool transL, const Matrix* F, bool transF,
+                      const Matrix* R, bool transR, bool resize);
+    /// Can triplet_into write op(L) F op(R) into this?
+    bool triplet_into_ok(const Matrix* L, const Matrix* F, const Matrix* R) const;
+
     /// Numpy Shape
     std::vector<int> numpy_shape_;
 
@@ -217,6 +232,21 @@ public:
                                const Dimension& rows,
                                const Dimension& cols);
 
+    /**
+     * A totally symmetric matrix over memory it does not own, e.g. a NumPy array.
+     * Irrep h is the row-major rows[h] x cols[h] block at blocks[h]; owner is kept
+     * alive as long as the matrix uses the blocks. Anything that reallocates the
+     * matrix (init, load, ...) leaves the blocks and moves to memory of its own.
+     */
+    static SharedMatrix wrap(const std::string& name,
+                             const Dimension& rows,
+                             const Dimension& cols,
+                             const std::vector<double*>& blocks,
+                             std::shared_ptr<void> owner);
+
+    /// Are the blocks owned by someone else (see wrap())?
+    bool is_wrapped() const { return static_cast<bool>(external_); }
+
     /**
      * @{
      * Copies data onto this
@@ -853,7 +883,8 @@ public:
     */
     static SharedMatrix doublet(const SharedMatrix& A, const SharedMatrix& B, bool transA = false, bool transB = false);
 
-    /** Simple triplet GEMM with on-the-fly allocation
+    /** Simple triplet GEMM with on-the-fly allocation of the result only,
+    * the intermediate lives in a per-thread workspace
     * \param A The first matrix
     * \param B The second matrix
     * \param C The third matrix
@@ -884,6 +915,14 @@ public:
     void diagonalize(SharedMatrix& eigvectors, Vector& eigvalues, diagonalize_order nMatz = ascending);
     /// @}
 
+    /**
+     * Diagonalizes every matrix in mats, as mats[k]->diagonalize(eigvectors[k], eigvalues[k], nMatz).
+     * The irrep blocks of all of them are handed out over the threads, each with one LAPACK
+     * workspace reused for all its blocks; meant for many small problems.
+     */
+    static void diagonalize_batch(const std::vector<SharedMatrix>& mats, const std::vector<SharedMatrix>& eigvectors,
+                                  const std::vector<SharedVector>& eigvalues, diagonalize_order nMatz = ascending);
+
     /// @{
     /// Diagonalizes this, applying supplied metric, eigvectors and eigvalues must be created by caller.  Only for symmetric matrices.
     void diagonalize(SharedMatrix& metric, SharedMatrix& eigvectors, std::shared_ptr<Vector>& eigvalues, diagonalize_order nMatz = ascending);
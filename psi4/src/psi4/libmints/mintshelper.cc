@@ -49,6 +49,8 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <sstream>
 #include <vector>
 
@@ -116,6 +118,148 @@ public:
     { return count_; }
 };
 
+/**
+* Per-thread IWL buffer for use with SO TEIs.  Full buffers are handed to the
+* shared IWL file one at a time; the partial buffer left at the end is merged
+* by merge() after the parallel region
+**/
+class IWLThreadWriter
+{
+    IWL &writeto_;
+    size_t count_;
+    int current_buffer_count_;
+    int ints_per_buffer_;
+
+    std::vector<Label> labels_;
+    std::vector<Value> values_;
+public:
+
+    IWLThreadWriter(IWL &writeto) : writeto_(writeto), count_(0), current_buffer_count_(0),
+                                    ints_per_buffer_(writeto.ints_per_buffer()),
+                                    labels_(4 * ints_per_buffer_), values_(ints_per_buffer_)
+    {
+    }
+
+    void operator()(int i, int j, int k, int l, int, int, int, int, int, int, int, int, double value)
+    {
+        int current_label_position = 4 * current_buffer_count_;
+
+        // Save the labels
+        labels_[current_label_position++] = i;
+        labels_[current_label_position++] = j;
+        labels_[current_label_position++] = k;
+        labels_[current_label_position] = l;
+
+        // Save the value
+        values_[current_buffer_count_++] = value;
+
+        // Increment overall counter
+        count_++;
+
+        // If our buffer is full, hand it to the shared IWL file
+        if (current_buffer_count_ == ints_per_buffer_) {
+#pragma omp critical(IWLThreadWriter_put)
+            {
+                ::memcpy(writeto_.labels(), labels_.data(), 4 * ints_per_buffer_ * sizeof(Label));
+                ::memcpy(writeto_.values(), values_.data(), ints_per_buffer_ * sizeof(Value));
+                writeto_.last_buffer() = 0;
+                writeto_.buffer_count() = ints_per_buffer_;
+                writeto_.put();
+            }
+            current_buffer_count_ = 0;
+        }
+    }
+
+    /// Serially append the partial buffer to writer
+    void merge(IWLWriter &writer)
+    {
+        for (int n = 0; n < current_buffer_count_; n++)
+            writer(labels_[4 * n], labels_[4 * n + 1], labels_[4 * n + 2], labels_[4 * n + 3],
+                   0, 0, 0, 0, 0, 0, 0, 0, values_[n]);
+    }
+
+    size_t count() const
+    { return count_; }
+};
+
+/**
+* Computes all unique SO TEIs of eri into the (fresh) IWL file out, with
+* each thread working on its own (PQ| pairs and IWL buffer.  Returns the
+* number of integrals written; out is left ready for flush(1)
+**/
+static size_t compute_iwl_integrals(std::shared_ptr<TwoBodySOInt> eri, std::shared_ptr<SOBasisSet> sobasis,
+                                    IWL &out, int nthread)
+{
+    std::vector<std::pair<int, int> > PQ;
+    SO_PQ_Iterator PQIter(sobasis);
+    for (PQIter.first(); PQIter.is_done() == false; PQIter.next())
+        PQ.push_back(std::make_pair(PQIter.p(), PQIter.q()));
+
+    std::vector<std::shared_ptr<IWLThreadWriter> > writers;
+    for (int i = 0; i < nthread; ++i)
+        writers.push_back(std::make_shared<IWLThreadWriter>(out));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int pq = 0; pq < (long int) PQ.size(); pq++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        SO_RS_Iterator RSIter(PQ[pq].first, PQ[pq].second, sobasis, sobasis, sobasis, sobasis);
+        for (RSIter.first(); RSIter.is_done() == false; RSIter.next())
+            eri->compute_shell(RSIter.p(), RSIter.q(), RSIter.r(), RSIter.s(), *writers[thread]);
+    }
+
+    IWLWriter writer(out);
+    size_t count = 0;
+    for (int i = 0; i < nthread; ++i) {
+        writers[i]->merge(writer);
+        count += writers[i]->count();
+    }
+    return count;
+}
+
+/**
+* Scatters SO TEIs into a contiguous range of rows of the PSIF_SO_TEI_BLOCKED
+* layout; integrals whose bra or ket row falls outside the range are dropped
+**/
+class BlockedSOFiller
+{
+    const std::vector<int> &pairidx_;
+    const std::vector<int> &pairsym_;
+    const std::vector<size_t> &rowstart_;
+    const std::vector<size_t> &rowoff_;
+    int nso_;
+    size_t first_, last_;
+    double *block_;
+
+    void put(int P, int R, int h, double value)
+    {
+        size_t g = rowstart_[h] + P;
+        if (g >= first_ && g < last_)
+            block_[rowoff_[g] - rowoff_[first_] + R] = value;
+    }
+public:
+    BlockedSOFiller(const std::vector<int> &pairidx, const std::vector<int> &pairsym,
+                    const std::vector<size_t> &rowstart, const std::vector<size_t> &rowoff,
+                    int nso, size_t first, size_t last, double *block)
+        : pairidx_(pairidx), pairsym_(pairsym), rowstart_(rowstart), rowoff_(rowoff),
+          nso_(nso), first_(first), last_(last), block_(block)
+    {
+    }
+
+    void operator()(int i, int j, int k, int l, int, int, int, int, int, int, int, int, double value)
+    {
+        int ij = i * nso_ + j;
+        int kl = k * nso_ + l;
+        int h = pairsym_[ij];
+        int P = pairidx_[ij];
+        int R = pairidx_[kl];
+        put(P, R, h, value);
+        put(R, P, h, value);
+    }
+};
+
 MintsHelper::MintsHelper(std::shared_ptr <BasisSet> basis, Options &options, int print)
         : options_(options), print_(print)
 {
@@ -266,15 +410,11 @@ void MintsHelper::integrals()
 
     // Open the IWL buffer where we will store the integrals.
     IWL ERIOUT(psio_.get(), PSIF_SO_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Let the user know what we're doing.
     if (print_) { outfile->Printf("      Computing two-electron integrals..."); }
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
-        eri->compute_shell(shellIter, writer);
-    }
+    size_t count = compute_iwl_integrals(eri, sobasis_, ERIOUT, nthread_);
 
     // Flush out buffers.
     ERIOUT.flush(1);
@@ -283,10 +423,128 @@ void MintsHelper::integrals()
     ERIOUT.set_keep_flag(true);
     ERIOUT.close();
 
+    // Only one SO TEI file is current at a time
+    if (psio_->exists(PSIF_SO_TEI_BLOCKED)) {
+        psio_->open(PSIF_SO_TEI_BLOCKED, PSIO_OPEN_OLD);
+        psio_->close(PSIF_SO_TEI_BLOCKED, 0);
+    }
+
     if (print_) {
         outfile->Printf("done\n");
         outfile->Printf("      Computed %lu non-zero two-electron integrals.\n"
-                                "        Stored in file %d.\n\n", writer.count(), PSIF_SO_TEI);
+                                "        Stored in file %d.\n\n", count, PSIF_SO_TEI);
+    }
+}
+
+void MintsHelper::integrals_blocked()
+{
+    if (print_) { outfile->Printf(" MINTS: Blocked SO integrals for libtrans.\n\n"); }
+
+    std::vector <std::shared_ptr<TwoBodyAOInt>> tb;
+    for (int i = 0; i < nthread_; ++i)
+        tb.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->eri()));
+    std::shared_ptr <TwoBodySOInt> eri(new TwoBodySOInt(tb, integral_));
+
+    one_electron_integrals();
+
+    // The (nn|nn) pairs of each irrep, in the order libdpd gives "[n>=n]+" pairs
+    int nirrep = sobasis_->nirrep();
+    int nso = sobasis_->dimension().sum();
+    std::vector<int> sopi(nirrep), sooff(nirrep, 0);
+    for (int h = 0; h < nirrep; ++h) {
+        sopi[h] = sobasis_->nfunction_in_irrep(h);
+        if (h) sooff[h] = sooff[h - 1] + sopi[h - 1];
+    }
+    std::vector<int> pairidx(nso * nso, -1), pairsym(nso * nso, -1), npair(nirrep, 0);
+    for (int h = 0; h < nirrep; ++h) {
+        for (int h0 = 0; h0 < nirrep; ++h0) {
+            int h1 = h0 ^ h;
+            if (h0 < h1) continue;
+            for (int p = 0; p < sopi[h0]; ++p) {
+                for (int q = 0; q < (h0 == h1 ? p + 1 : sopi[h1]); ++q) {
+                    int P = p + sooff[h0];
+                    int Q = q + sooff[h1];
+                    pairidx[P * nso + Q] = pairidx[Q * nso + P] = npair[h];
+                    pairsym[P * nso + Q] = pairsym[Q * nso + P] = h;
+                    npair[h]++;
+                }
+            }
+        }
+    }
+
+    // Global row numbering (irrep by irrep) and the offset of each row in the file
+    std::vector<size_t> rowstart(nirrep), rowoff(1, 0);
+    for (int h = 0; h < nirrep; ++h) {
+        rowstart[h] = rowoff.size() - 1;
+        for (int P = 0; P < npair[h]; ++P)
+            rowoff.push_back(rowoff.back() + npair[h]);
+    }
+    size_t nrow = rowoff.size() - 1;
+
+    // Rows are computed in as few passes as memory allows
+    size_t maxd = (size_t) (0.9 * Process::environment.get_memory() / sizeof(double));
+    std::vector<size_t> passes(1, 0);
+    for (size_t g = 0; g < nrow; ++g) {
+        if (rowoff[g + 1] - rowoff[passes.back()] > maxd) {
+            if (g == passes.back())
+                throw PSIEXCEPTION("MintsHelper::integrals_blocked: Not enough memory for one row of integrals.");
+            passes.push_back(g);
+        }
+    }
+    passes.push_back(nrow);
+    int npass = passes.size() - 1;
+
+    if (print_) {
+        outfile->Printf("      Number of threads:              %4d\n", nthread_);
+        outfile->Printf("      Number of SO pairs per irrep:  [");
+        for (int h = 0; h < nirrep; ++h) outfile->Printf("%6d ", npair[h]);
+        outfile->Printf("]\n");
+        outfile->Printf("      Number of passes:               %4d\n", npass);
+        outfile->Printf("      Computing two-electron integrals...");
+    }
+
+    psio_->open(PSIF_SO_TEI_BLOCKED, PSIO_OPEN_NEW);
+    std::vector<int> header(1, nirrep);
+    header.insert(header.end(), sopi.begin(), sopi.end());
+    psio_->write_entry(PSIF_SO_TEI_BLOCKED, "SO TEI Blocked Irreps", (char *) header.data(),
+                       header.size() * sizeof(int));
+
+    std::vector<std::pair<int, int> > PQ;
+    SO_PQ_Iterator PQIter(sobasis_);
+    for (PQIter.first(); PQIter.is_done() == false; PQIter.next())
+        PQ.push_back(std::make_pair(PQIter.p(), PQIter.q()));
+
+    psio_address next = PSIO_ZERO;
+    std::vector<double> block;
+    for (int n = 0; n < npass; ++n) {
+        size_t size = rowoff[passes[n + 1]] - rowoff[passes[n]];
+        block.assign(size, 0.0);
+
+        // Every unique integral lands in a distinct element, so threads need no locking
+        BlockedSOFiller filler(pairidx, pairsym, rowstart, rowoff, nso, passes[n], passes[n + 1], block.data());
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (long int pq = 0; pq < (long int) PQ.size(); pq++) {
+            SO_RS_Iterator RSIter(PQ[pq].first, PQ[pq].second, sobasis_, sobasis_, sobasis_, sobasis_);
+            for (RSIter.first(); RSIter.is_done() == false; RSIter.next())
+                eri->compute_shell(RSIter.p(), RSIter.q(), RSIter.r(), RSIter.s(), filler);
+        }
+
+        psio_->write(PSIF_SO_TEI_BLOCKED, "SO TEI Blocked", (char *) block.data(), size * sizeof(double),
+                     next, &next);
+    }
+
+    psio_->close(PSIF_SO_TEI_BLOCKED, 1);
+
+    // Only one SO TEI file is current at a time
+    if (psio_->exists(PSIF_SO_TEI)) {
+        psio_->open(PSIF_SO_TEI, PSIO_OPEN_OLD);
+        psio_->close(PSIF_SO_TEI, 0);
+    }
+
+    if (print_) {
+        outfile->Printf("done\n");
+        outfile->Printf("      Stored %lu two-electron integrals in %d symmetry blocks in file %d.\n\n",
+                        rowoff[nrow], nirrep, PSIF_SO_TEI_BLOCKED);
     }
 }
 
@@ -295,7 +553,6 @@ void MintsHelper::integrals_erf(double w)
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERF_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector <std::shared_ptr<TwoBodyAOInt>> tb;
@@ -306,9 +563,7 @@ void MintsHelper::integrals_erf(double w)
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERF integrals (omega = %.3f)...", omega);
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next())
-        erf->compute_shell(shellIter, writer);
+    size_t count = compute_iwl_integrals(erf, sobasis_, ERIOUT, nthread_);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -319,7 +574,7 @@ void MintsHelper::integrals_erf(double w)
 
     outfile->Printf("done\n");
     outfile->Printf("      Computed %lu non-zero ERF integrals.\n"
-                            "        Stored in file %d.\n\n", writer.count(), PSIF_SO_ERF_TEI);
+                            "        Stored in file %d.\n\n", count, PSIF_SO_ERF_TEI);
 }
 
 void MintsHelper::integrals_erfc(double w)
@@ -327,7 +582,6 @@ void MintsHelper::integrals_erfc(double w)
     double omega = (w == -1.0 ? options_.get_double("OMEGA_ERF") : w);
 
     IWL ERIOUT(psio_.get(), PSIF_SO_ERFC_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
 
     // Get ERI object
     std::vector <std::shared_ptr<TwoBodyAOInt>> tb;
@@ -338,9 +592,7 @@ void MintsHelper::integrals_erfc(double w)
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERFComplement integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next())
-        erf->compute_shell(shellIter, writer);
+    size_t count = compute_iwl_integrals(erf, sobasis_, ERIOUT, nthread_);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -351,7 +603,7 @@ void MintsHelper::integrals_erfc(double w)
 
     outfile->Printf("done\n");
     outfile->Printf("      Computed %lu non-zero ERFComplement integrals.\n"
-                            "        Stored in file %d.\n\n", writer.count(), PSIF_SO_ERFC_TEI);
+                            "        Stored in file %d.\n\n", count, PSIF_SO_ERFC_TEI);
 }
 
 
@@ -679,12 +931,20 @@ SharedMatrix MintsHelper::so_dkh(int dkh_order)
     return dkh;
 }
 
-SharedMatrix MintsHelper::ao_helper(const std::string &label, std::shared_ptr <TwoBodyAOInt> ints)
+std::vector<std::shared_ptr<TwoBodyAOInt>> MintsHelper::thread_ints(std::function<TwoBodyAOInt*()> build)
 {
-    std::shared_ptr <BasisSet> bs1 = ints->basis1();
-    std::shared_ptr <BasisSet> bs2 = ints->basis2();
-    std::shared_ptr <BasisSet> bs3 = ints->basis3();
-    std::shared_ptr <BasisSet> bs4 = ints->basis4();
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    for (int i = 0; i < nthread_; ++i)
+        ints.push_back(std::shared_ptr<TwoBodyAOInt>(build()));
+    return ints;
+}
+
+SharedMatrix MintsHelper::ao_helper(const std::string &label, std::vector<std::shared_ptr<TwoBodyAOInt>> ints)
+{
+    std::shared_ptr <BasisSet> bs1 = ints[0]->basis1();
+    std::shared_ptr <BasisSet> bs2 = ints[0]->basis2();
+    std::shared_ptr <BasisSet> bs3 = ints[0]->basis3();
+    std::shared_ptr <BasisSet> bs4 = ints[0]->basis4();
 
     int nbf1 = bs1->nbf();
     int nbf2 = bs2->nbf();
@@ -693,15 +953,72 @@ SharedMatrix MintsHelper::ao_helper(const std::string &label, std::shared_ptr <T
 
     SharedMatrix I(new Matrix(label, nbf1 * nbf2, nbf3 * nbf4));
     double **Ip = I->pointer();
-    const double *buffer = ints->buffer();
-
+    int nthread = ints.size();
+
+    if (bs1 == bs2 && bs1 == bs3 && bs1 == bs4) {
+        // One basis on all four centers: each unique quartet is computed once and
+        // copied to its eight images, none of which belongs to another quartet
+        int nbf = nbf1;
+        std::vector<std::pair<int, int>> pairs;
+        for (int M = 0; M < bs1->nshell(); M++)
+            for (int N = 0; N <= M; N++)
+                pairs.push_back(std::make_pair(M, N));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for (long int MN = 0; MN < (long int) pairs.size(); MN++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            const double *buffer = ints[thread]->buffer();
+            const GaussianShell &sM = bs1->shell(pairs[MN].first);
+            const GaussianShell &sN = bs1->shell(pairs[MN].second);
+
+            for (long int RS = 0; RS <= MN; RS++) {
+                const GaussianShell &sR = bs1->shell(pairs[RS].first);
+                const GaussianShell &sS = bs1->shell(pairs[RS].second);
+
+                ints[thread]->compute_shell(pairs[MN].first, pairs[MN].second, pairs[RS].first, pairs[RS].second);
+
+                for (int m = 0, index = 0; m < sM.nfunction(); m++) {
+                    size_t om = sM.function_index() + m;
+                    for (int n = 0; n < sN.nfunction(); n++) {
+                        size_t on = sN.function_index() + n;
+                        for (int r = 0; r < sR.nfunction(); r++) {
+                            size_t orr = sR.function_index() + r;
+                            for (int q = 0; q < sS.nfunction(); q++, index++) {
+                                size_t os = sS.function_index() + q;
+                                double val = buffer[index];
+                                Ip[om * nbf + on][orr * nbf + os] = val;
+                                Ip[on * nbf + om][orr * nbf + os] = val;
+                                Ip[om * nbf + on][os * nbf + orr] = val;
+                                Ip[on * nbf + om][os * nbf + orr] = val;
+                                Ip[orr * nbf + os][om * nbf + on] = val;
+                                Ip[orr * nbf + os][on * nbf + om] = val;
+                                Ip[os * nbf + orr][om * nbf + on] = val;
+                                Ip[os * nbf + orr][on * nbf + om] = val;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } else {
+        int nshell2 = bs2->nshell();
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for (long int MN = 0; MN < bs1->nshell() * (long int) nshell2; MN++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            const double *buffer = ints[thread]->buffer();
+            int M = MN / nshell2;
+            int N = MN % nshell2;
 
-    for (int M = 0; M < bs1->nshell(); M++) {
-        for (int N = 0; N < bs2->nshell(); N++) {
             for (int P = 0; P < bs3->nshell(); P++) {
                 for (int Q = 0; Q < bs4->nshell(); Q++) {
 
-                    ints->compute_shell(M, N, P, Q);
+                    ints[thread]->compute_shell(M, N, P, Q);
 
                     for (int m = 0, index = 0; m < bs1->shell(M).nfunction(); m++) {
                         for (int n = 0; n < bs2->shell(N).nfunction(); n++) {
@@ -759,13 +1076,213 @@ SharedMatrix MintsHelper::ao_shell_getter(const std::string &label, std::shared_
 
 SharedMatrix MintsHelper::ao_erf_eri(double omega)
 {
-    return ao_helper("AO ERF ERI Integrals", std::shared_ptr<TwoBodyAOInt>(integral_->erf_eri(omega)));
+    return ao_helper("AO ERF ERI Integrals", thread_ints([&]() { return integral_->erf_eri(omega); }));
 }
 
 SharedMatrix MintsHelper::ao_eri()
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->eri());
-    return ao_helper("AO ERI Tensor", ints);
+    return ao_helper("AO ERI Tensor", thread_ints([&]() { return integral_->eri(); }));
+}
+
+SharedVector MintsHelper::ao_eri_packed()
+{
+    int nbf = basisset_->nbf();
+    size_t npair = nbf * (size_t) (nbf + 1) / 2;
+    size_t size = npair * (npair + 1) / 2;
+    if (size > (size_t) std::numeric_limits<int>::max())
+        throw PSIEXCEPTION("MintsHelper::ao_eri_packed: too many unique integrals for a Vector.");
+
+    SharedVector I(new Vector("AO ERI Packed", (int) size));
+    double *Ip = I->pointer();
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints = thread_ints([&]() { return integral_->eri(); });
+    std::vector<std::pair<int, int>> pairs;
+    for (int M = 0; M < basisset_->nshell(); M++)
+        for (int N = 0; N <= M; N++)
+            pairs.push_back(std::make_pair(M, N));
+
+    // Every packed element belongs to one unique shell quartet
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (long int MN = 0; MN < (long int) pairs.size(); MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = ints[thread]->buffer();
+        const GaussianShell &sM = basisset_->shell(pairs[MN].first);
+        const GaussianShell &sN = basisset_->shell(pairs[MN].second);
+
+        for (long int RS = 0; RS <= MN; RS++) {
+            const GaussianShell &sR = basisset_->shell(pairs[RS].first);
+            const GaussianShell &sS = basisset_->shell(pairs[RS].second);
+
+            ints[thread]->compute_shell(pairs[MN].first, pairs[MN].second, pairs[RS].first, pairs[RS].second);
+
+            for (int m = 0, index = 0; m < sM.nfunction(); m++) {
+                size_t om = sM.function_index() + m;
+                for (int n = 0; n < sN.nfunction(); n++) {
+                    size_t on = sN.function_index() + n;
+                    size_t mn = (om >= on ? om * (om + 1) / 2 + on : on * (on + 1) / 2 + om);
+                    for (int r = 0; r < sR.nfunction(); r++) {
+                        size_t orr = sR.function_index() + r;
+                        for (int q = 0; q < sS.nfunction(); q++, index++) {
+                            size_t os = sS.function_index() + q;
+                            size_t rs = (orr >= os ? orr * (orr + 1) / 2 + os : os * (os + 1) / 2 + orr);
+                            size_t mnrs = (mn >= rs ? mn * (mn + 1) / 2 + rs : rs * (rs + 1) / 2 + mn);
+                            Ip[mnrs] = buffer[index];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return I;
+}
+
+SharedMatrix MintsHelper::ao_eri_slab(int Mstart, int Mstop)
+{
+    if (Mstart < 0 || Mstop > basisset_->nshell() || Mstart >= Mstop)
+        throw PSIEXCEPTION("MintsHelper::ao_eri_slab: shell range out of bounds.");
+
+    int nbf = basisset_->nbf();
+    int nshell = basisset_->nshell();
+    int mstart = basisset_->shell(Mstart).function_index();
+    int nm = (Mstop == nshell ? nbf : basisset_->shell(Mstop).function_index()) - mstart;
+
+    SharedMatrix I(new Matrix("AO ERI Slab", nm * nbf, nbf * nbf));
+    double **Ip = I->pointer();
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints = thread_ints([&]() { return integral_->eri(); });
+
+    // Each (MN| block of rows is one task; the kets are computed for R >= S only
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (long int MN = 0; MN < (Mstop - Mstart) * (long int) nshell; MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = ints[thread]->buffer();
+        int M = Mstart + MN / nshell;
+        int N = MN % nshell;
+        const GaussianShell &sM = basisset_->shell(M);
+        const GaussianShell &sN = basisset_->shell(N);
+
+        for (int R = 0; R < nshell; R++) {
+            const GaussianShell &sR = basisset_->shell(R);
+            for (int S = 0; S <= R; S++) {
+                const GaussianShell &sS = basisset_->shell(S);
+
+                ints[thread]->compute_shell(M, N, R, S);
+
+                for (int m = 0, index = 0; m < sM.nfunction(); m++) {
+                    for (int n = 0; n < sN.nfunction(); n++) {
+                        double *Imn = Ip[(sM.function_index() + m - mstart) * (size_t) nbf + sN.function_index() + n];
+                        for (int r = 0; r < sR.nfunction(); r++) {
+                            size_t orr = sR.function_index() + r;
+                            for (int q = 0; q < sS.nfunction(); q++, index++) {
+                                size_t os = sS.function_index() + q;
+                                Imn[orr * nbf + os] = buffer[index];
+                                Imn[os * nbf + orr] = buffer[index];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> nshape{nm, nbf, nbf, nbf};
+    I->set_numpy_shape(nshape);
+
+    return I;
+}
+
+SharedMatrix MintsHelper::ao_3index_slab(std::shared_ptr<BasisSet> aux, int Pstart, int Pstop)
+{
+    if (Pstart < 0 || Pstop > aux->nshell() || Pstart >= Pstop)
+        throw PSIEXCEPTION("MintsHelper::ao_3index_slab: auxiliary shell range out of bounds.");
+
+    int nbf = basisset_->nbf();
+    int nshell = basisset_->nshell();
+    int pstart = aux->shell(Pstart).function_index();
+    int np = (Pstop == aux->nshell() ? aux->nbf() : aux->shell(Pstop).function_index()) - pstart;
+
+    SharedMatrix I(new Matrix("AO 3-Index Slab", np, nbf * nbf));
+    double **Ip = I->pointer();
+
+    IntegralFactory intf(aux, BasisSet::zero_ao_basis_set(), basisset_, basisset_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints = thread_ints([&]() { return intf.eri(); });
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (long int PM = 0; PM < (Pstop - Pstart) * (long int) nshell; PM++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = ints[thread]->buffer();
+        int P = Pstart + PM / nshell;
+        int M = PM % nshell;
+        const GaussianShell &sP = aux->shell(P);
+        const GaussianShell &sM = basisset_->shell(M);
+
+        for (int N = 0; N <= M; N++) {
+            const GaussianShell &sN = basisset_->shell(N);
+
+            ints[thread]->compute_shell(P, 0, M, N);
+
+            for (int p = 0, index = 0; p < sP.nfunction(); p++) {
+                double *Ip_p = Ip[sP.function_index() + p - pstart];
+                for (int m = 0; m < sM.nfunction(); m++) {
+                    size_t om = sM.function_index() + m;
+                    for (int n = 0; n < sN.nfunction(); n++, index++) {
+                        size_t on = sN.function_index() + n;
+                        Ip_p[om * nbf + on] = buffer[index];
+                        Ip_p[on * nbf + om] = buffer[index];
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> nshape{np, nbf, nbf};
+    I->set_numpy_shape(nshape);
+
+    return I;
+}
+
+SharedMatrix MintsHelper::mo_3index_slab(std::shared_ptr<BasisSet> aux, int Pstart, int Pstop, SharedMatrix C1,
+                                         SharedMatrix C2)
+{
+    SharedMatrix Iao = ao_3index_slab(aux, Pstart, Pstop);
+    int nbf = basisset_->nbf();
+    int np = Iao->rowspi()[0];
+    int n1 = C1->colspi()[0];
+    int n2 = C2->colspi()[0];
+    double **Iaop = Iao->pointer();
+    double **C1p = C1->pointer();
+    double **C2p = C2->pointer();
+
+    SharedMatrix Imo(new Matrix("MO 3-Index Slab", np, n1 * n2));
+    double **Imop = Imo->pointer();
+
+    // (Q|in) = sum_m C1_mi (Q|mn), then (Q|ij), one Q per thread
+    std::vector<std::vector<double>> half(nthread_, std::vector<double>(n1 * (size_t) nbf));
+#pragma omp parallel for schedule(static) num_threads(nthread_)
+    for (int Q = 0; Q < np; Q++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *Hp = half[thread].data();
+        C_DGEMM('T', 'N', n1, nbf, nbf, 1.0, C1p[0], n1, Iaop[Q], nbf, 0.0, Hp, nbf);
+        C_DGEMM('N', 'N', n1, n2, nbf, 1.0, Hp, nbf, C2p[0], n2, 0.0, Imop[Q], n2);
+    }
+
+    std::vector<int> nshape{np, n1, n2};
+    Imo->set_numpy_shape(nshape);
+
+    return Imo;
 }
 
 SharedMatrix MintsHelper::ao_eri(std::shared_ptr <BasisSet> bs1,
@@ -774,8 +1291,7 @@ SharedMatrix MintsHelper::ao_eri(std::shared_ptr <BasisSet> bs1,
                                  std::shared_ptr <BasisSet> bs4)
 {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr <TwoBodyAOInt> ints(intf.eri());
-    return ao_helper("AO ERI Tensor", ints);
+    return ao_helper("AO ERI Tensor", thread_ints([&]() { return intf.eri(); }));
 }
 
 SharedMatrix MintsHelper::ao_eri_shell(int M, int N, int P, int Q)
@@ -788,14 +1304,12 @@ SharedMatrix MintsHelper::ao_eri_shell(int M, int N, int P, int Q)
 
 SharedMatrix MintsHelper::ao_erfc_eri(double omega)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->erf_complement_eri(omega));
-    return ao_helper("AO ERFC ERI Tensor", ints);
+    return ao_helper("AO ERFC ERI Tensor", thread_ints([&]() { return integral_->erf_complement_eri(omega); }));
 }
 
 SharedMatrix MintsHelper::ao_f12(std::shared_ptr <CorrelationFactor> corr)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->f12(corr));
-    return ao_helper("AO F12 Tensor", ints);
+    return ao_helper("AO F12 Tensor", thread_ints([&]() { return integral_->f12(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12(std::shared_ptr <CorrelationFactor> corr,
@@ -805,14 +1319,12 @@ SharedMatrix MintsHelper::ao_f12(std::shared_ptr <CorrelationFactor> corr,
                                  std::shared_ptr <BasisSet> bs4)
 {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr <TwoBodyAOInt> ints(intf.f12(corr));
-    return ao_helper("AO F12 Tensor", ints);
+    return ao_helper("AO F12 Tensor", thread_ints([&]() { return intf.f12(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12_scaled(std::shared_ptr <CorrelationFactor> corr)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->f12_scaled(corr));
-    return ao_helper("AO F12 Scaled Tensor", ints);
+    return ao_helper("AO F12 Scaled Tensor", thread_ints([&]() { return integral_->f12_scaled(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12_scaled(std::shared_ptr <CorrelationFactor> corr,
@@ -822,14 +1334,12 @@ SharedMatrix MintsHelper::ao_f12_scaled(std::shared_ptr <CorrelationFactor> corr
                                         std::shared_ptr <BasisSet> bs4)
 {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr <TwoBodyAOInt> ints(intf.f12_scaled(corr));
-    return ao_helper("AO F12 Scaled Tensor", ints);
+    return ao_helper("AO F12 Scaled Tensor", thread_ints([&]() { return intf.f12_scaled(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12_squared(std::shared_ptr <CorrelationFactor> corr)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->f12_squared(corr));
-    return ao_helper("AO F12 Squared Tensor", ints);
+    return ao_helper("AO F12 Squared Tensor", thread_ints([&]() { return integral_->f12_squared(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12_squared(std::shared_ptr <CorrelationFactor> corr,
@@ -839,8 +1349,7 @@ SharedMatrix MintsHelper::ao_f12_squared(std::shared_ptr <CorrelationFactor> cor
                                          std::shared_ptr <BasisSet> bs4)
 {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr <TwoBodyAOInt> ints(intf.f12_squared(corr));
-    return ao_helper("AO F12 Squared Tensor", ints);
+    return ao_helper("AO F12 Squared Tensor", thread_ints([&]() { return intf.f12_squared(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_3coverlap_helper(const std::string &label, std::shared_ptr<ThreeCenterOverlapInt> ints)
@@ -910,55 +1419,53 @@ SharedMatrix MintsHelper::ao_3coverlap(std::shared_ptr<BasisSet> bs1,
 
 SharedMatrix MintsHelper::ao_f12g12(std::shared_ptr <CorrelationFactor> corr)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->f12g12(corr));
-    return ao_helper("AO F12G12 Tensor", ints);
+    return ao_helper("AO F12G12 Tensor", thread_ints([&]() { return integral_->f12g12(corr); }));
 }
 
 SharedMatrix MintsHelper::ao_f12_double_commutator(std::shared_ptr <CorrelationFactor> corr)
 {
-    std::shared_ptr <TwoBodyAOInt> ints(integral_->f12_double_commutator(corr));
-    return ao_helper("AO F12 Double Commutator Tensor", ints);
+    return ao_helper("AO F12 Double Commutator Tensor", thread_ints([&]() { return integral_->f12_double_commutator(corr); }));
 }
 
 SharedMatrix MintsHelper::mo_erf_eri(double omega, SharedMatrix C1, SharedMatrix C2,
                                      SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_erf_eri(omega), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->erf_eri(omega); }), C1, C2, C3, C4);
     mo_ints->set_name("MO ERF ERI Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_erfc_eri(double omega, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_erfc_eri(omega), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->erf_complement_eri(omega); }), C1, C2, C3, C4);
     mo_ints->set_name("MO ERFC ERI Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_f12(std::shared_ptr <CorrelationFactor> corr, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_f12(corr), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->f12(corr); }), C1, C2, C3, C4);
     mo_ints->set_name("MO F12 Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_f12_squared(std::shared_ptr <CorrelationFactor> corr, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_f12_squared(corr), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->f12_squared(corr); }), C1, C2, C3, C4);
     mo_ints->set_name("MO F12 Squared Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_f12g12(std::shared_ptr <CorrelationFactor> corr, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_f12g12(corr), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->f12g12(corr); }), C1, C2, C3, C4);
     mo_ints->set_name("MO F12G12 Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_f12_double_commutator(std::shared_ptr <CorrelationFactor> corr, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_f12_double_commutator(corr), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->f12_double_commutator(corr); }), C1, C2, C3, C4);
     mo_ints->set_name("MO F12 Double Commutator Tensor");
     return mo_ints;
 }
@@ -966,159 +1473,127 @@ SharedMatrix MintsHelper::mo_f12_double_commutator(std::shared_ptr <CorrelationF
 SharedMatrix MintsHelper::mo_eri(SharedMatrix C1, SharedMatrix C2,
                                  SharedMatrix C3, SharedMatrix C4)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), C1, C2, C3, C4);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->eri(); }), C1, C2, C3, C4);
     mo_ints->set_name("MO ERI Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_erf_eri(double omega, SharedMatrix Co, SharedMatrix Cv)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_erf_eri(omega), Co, Cv);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->erf_eri(omega); }), Co, Cv, Co, Cv);
     mo_ints->set_name("MO ERF ERI Tensor");
     return mo_ints;
 }
 
 SharedMatrix MintsHelper::mo_eri(SharedMatrix Co, SharedMatrix Cv)
 {
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), Co, Cv);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->eri(); }), Co, Cv, Co, Cv);
     mo_ints->set_name("MO ERI Tensor");
     return mo_ints;
 }
 
-SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, SharedMatrix C2,
-                                        SharedMatrix C3, SharedMatrix C4)
+SharedMatrix MintsHelper::mo_eri_helper(std::vector<std::shared_ptr<TwoBodyAOInt>> ints, SharedMatrix C1,
+                                        SharedMatrix C2, SharedMatrix C3, SharedMatrix C4)
 {
     int nso = basisset_->nbf();
+    int nshell = basisset_->nshell();
     int n1 = C1->colspi()[0];
     int n2 = C2->colspi()[0];
     int n3 = C3->colspi()[0];
     int n4 = C4->colspi()[0];
+    size_t n34 = n3 * (size_t) n4;
 
     double **C1p = C1->pointer();
     double **C2p = C2->pointer();
     double **C3p = C3->pointer();
     double **C4p = C4->pointer();
 
-    double **Isop = Iso->pointer();
-    SharedMatrix I2(new Matrix("MO ERI Tensor", n1 * nso, nso * nso));
-    double **I2p = I2->pointer();
+    // => Ket half-transform, (mn|kl), one (MN| shell pair block at a time <= //
 
-    C_DGEMM('T', 'N', n1, nso * (size_t) nso * nso, nso, 1.0, C1p[0], n1, Isop[0], nso * (size_t) nso * nso, 0.0, I2p[0], nso * (size_t) nso * nso);
+    SharedMatrix Ihalf(new Matrix("MO ERI Tensor", nso * nso, n34));
+    double **Ihalfp = Ihalf->pointer();
 
-    Iso.reset();
-    SharedMatrix I3(new Matrix("MO ERI Tensor", n1 * nso, nso * n3));
-    double **I3p = I3->pointer();
+    std::vector<std::pair<int, int>> pairs;
+    for (int M = 0; M < nshell; M++)
+        for (int N = 0; N <= M; N++)
+            pairs.push_back(std::make_pair(M, N));
 
-    C_DGEMM('N', 'N', n1 * (size_t) nso * nso, n3, nso, 1.0, I2p[0], nso, C3p[0], n3, 0.0, I3p[0], n3);
+    int maxf = basisset_->max_function_per_shell();
+    int nthread = ints.size();
+    std::vector<std::vector<double>> block(nthread, std::vector<double>(maxf * (size_t) maxf * nso * nso));
+    std::vector<std::vector<double>> quarter(nthread, std::vector<double>(maxf * (size_t) maxf * nso * n4));
 
-    I2.reset();
-    SharedMatrix I4(new Matrix("MO ERI Tensor", nso * n1, n3 * nso));
-    double **I4p = I4->pointer();
-
-    for (int i = 0; i < n1; i++) {
-        for (int j = 0; j < n3; j++) {
-            for (int m = 0; m < nso; m++) {
-                for (int n = 0; n < nso; n++) {
-                    I4p[m * n1 + i][j * nso + n] = I3p[i * nso + m][n * n3 + j];
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int MN = 0; MN < (long int) pairs.size(); MN++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = ints[thread]->buffer();
+        double *Bp = block[thread].data();
+        double *Qp = quarter[thread].data();
+
+        int M = pairs[MN].first;
+        int N = pairs[MN].second;
+        int nM = basisset_->shell(M).nfunction();
+        int nN = basisset_->shell(N).nfunction();
+        int oM = basisset_->shell(M).function_index();
+        int oN = basisset_->shell(N).function_index();
+
+        // (mn|rs) for all rs, from the R >= S quartets
+        for (int R = 0; R < nshell; R++) {
+            int nR = basisset_->shell(R).nfunction();
+            int oR = basisset_->shell(R).function_index();
+            for (int S = 0; S <= R; S++) {
+                int nS = basisset_->shell(S).nfunction();
+                int oS = basisset_->shell(S).function_index();
+
+                ints[thread]->compute_shell(M, N, R, S);
+
+                for (int m = 0, index = 0; m < nM; m++) {
+                    for (int n = 0; n < nN; n++) {
+                        double *Bmn = Bp + (m * nN + n) * (size_t) nso * nso;
+                        for (int r = 0; r < nR; r++) {
+                            for (int q = 0; q < nS; q++, index++) {
+                                Bmn[(oR + r) * (size_t) nso + oS + q] = buffer[index];
+                                Bmn[(oS + q) * (size_t) nso + oR + r] = buffer[index];
+                            }
+                        }
+                    }
                 }
             }
         }
-    }
-
-    I3.reset();
-    SharedMatrix I5(new Matrix("MO ERI Tensor", n2 * n1, n3 * nso));
-    double **I5p = I5->pointer();
 
-    C_DGEMM('T', 'N', n2, n1 * (size_t) n3 * nso, nso, 1.0, C2p[0], n2, I4p[0], n1 * (size_t) n3 * nso, 0.0, I5p[0], n1 * (size_t) n3 * nso);
-
-    I4.reset();
-    SharedMatrix I6(new Matrix("MO ERI Tensor", n2 * n1, n3 * n4));
-    double **I6p = I6->pointer();
-
-    C_DGEMM('N', 'N', n2 * (size_t) n1 * n3, n4, nso, 1.0, I5p[0], nso, C4p[0], n4, 0.0, I6p[0], n4);
-
-    I5.reset();
-    SharedMatrix Imo(new Matrix("MO ERI Tensor", n1 * n2, n3 * n4));
-    double **Imop = Imo->pointer();
-
-    for (int i = 0; i < n1; i++) {
-        for (int j = 0; j < n3; j++) {
-            for (int a = 0; a < n2; a++) {
-                for (int b = 0; b < n4; b++) {
-                    Imop[i * n2 + a][j * n4 + b] = I6p[a * n1 + i][j * n4 + b];
-                }
+        // (mn|rl), then (mn|kl)
+        C_DGEMM('N', 'N', nM * nN * nso, n4, nso, 1.0, Bp, nso, C4p[0], n4, 0.0, Qp, n4);
+        for (int m = 0; m < nM; m++) {
+            for (int n = 0; n < nN; n++) {
+                double *Qmn = Qp + (m * nN + n) * (size_t) nso * n4;
+                double *Imn = Ihalfp[(oM + m) * (size_t) nso + oN + n];
+                C_DGEMM('T', 'N', n3, n4, nso, 1.0, C3p[0], n3, Qmn, n4, 0.0, Imn, n4);
+                if (M != N) ::memcpy(Ihalfp[(oN + n) * (size_t) nso + oM + m], Imn, n34 * sizeof(double));
             }
         }
     }
-    // Build numpy and final matrix shape
-    std::vector<int> nshape{n1, n2, n3, n4};
-    Imo->set_numpy_shape(nshape);
-
-    return Imo;
-}
-
-SharedMatrix MintsHelper::mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, SharedMatrix Cv)
-{
-    int nso = basisset_->nbf();
-    int nocc = Co->colspi()[0];
-    int nvir = Cv->colspi()[0];
-
-    double **Cop = Co->pointer();
-    double **Cvp = Cv->pointer();
+    block.clear();
+    quarter.clear();
 
-    double **Isop = Iso->pointer();
-    SharedMatrix I2(new Matrix("MO ERI Tensor", nocc * nso, nso * nso));
-    double **I2p = I2->pointer();
+    // => Bra transform <= //
 
-    C_DGEMM('T', 'N', nocc, nso * (size_t) nso * nso, nso, 1.0, Cop[0], nocc, Isop[0], nso * (size_t) nso * nso, 0.0, I2p[0], nso * (size_t) nso * nso);
-
-    Iso.reset();
-    SharedMatrix I3(new Matrix("MO ERI Tensor", nocc * nso, nso * nocc));
+    SharedMatrix I3(new Matrix("MO ERI Tensor", n1, nso * n34));
     double **I3p = I3->pointer();
+    C_DGEMM('T', 'N', n1, nso * n34, nso, 1.0, C1p[0], n1, Ihalfp[0], nso * n34, 0.0, I3p[0], nso * n34);
+    Ihalf.reset();
 
-    C_DGEMM('N', 'N', nocc * (size_t) nso * nso, nocc, nso, 1.0, I2p[0], nso, Cop[0], nocc, 0.0, I3p[0], nocc);
-
-    I2.reset();
-    SharedMatrix I4(new Matrix("MO ERI Tensor", nso * nocc, nocc * nso));
-    double **I4p = I4->pointer();
-
-    for (int i = 0; i < nocc; i++) {
-        for (int j = 0; j < nocc; j++) {
-            for (int m = 0; m < nso; m++) {
-                for (int n = 0; n < nso; n++) {
-                    I4p[m * nocc + i][j * nso + n] = I3p[i * nso + m][n * nocc + j];
-                }
-            }
-        }
-    }
-
-    I3.reset();
-    SharedMatrix I5(new Matrix("MO ERI Tensor", nvir * nocc, nocc * nso));
-    double **I5p = I5->pointer();
-
-    C_DGEMM('T', 'N', nvir, nocc * (size_t) nocc * nso, nso, 1.0, Cvp[0], nvir, I4p[0], nocc * (size_t) nocc * nso, 0.0, I5p[0], nocc * (size_t) nocc * nso);
-
-    I4.reset();
-    SharedMatrix I6(new Matrix("MO ERI Tensor", nvir * nocc, nocc * nvir));
-    double **I6p = I6->pointer();
-
-    C_DGEMM('N', 'N', nvir * (size_t) nocc * nocc, nvir, nso, 1.0, I5p[0], nso, Cvp[0], nvir, 0.0, I6p[0], nvir);
-
-    I5.reset();
-    SharedMatrix Imo(new Matrix("MO ERI Tensor", nocc * nvir, nocc * nvir));
+    SharedMatrix Imo(new Matrix("MO ERI Tensor", n1 * n2, n3 * n4));
     double **Imop = Imo->pointer();
-
-    for (int i = 0; i < nocc; i++) {
-        for (int j = 0; j < nocc; j++) {
-            for (int a = 0; a < nvir; a++) {
-                for (int b = 0; b < nvir; b++) {
-                    Imop[i * nvir + a][j * nvir + b] = I6p[a * nocc + i][j * nvir + b];
-                }
-            }
-        }
+#pragma omp parallel for schedule(static) num_threads(nthread)
+    for (int i = 0; i < n1; i++) {
+        C_DGEMM('T', 'N', n2, n34, nso, 1.0, C2p[0], n2, I3p[i], n34, 0.0, Imop[i * (size_t) n2], n34);
     }
+
     // Build numpy and final matrix shape
-    std::vector<int> nshape{nocc, nvir, nocc, nvir};
+    std::vector<int> nshape{n1, n2, n3, n4};
     Imo->set_numpy_shape(nshape);
 
     return Imo;
@@ -1128,7 +1603,7 @@ SharedMatrix MintsHelper::mo_spin_eri(SharedMatrix Co, SharedMatrix Cv)
 {
     int n1 = Co->colspi()[0];
     int n2 = Cv->colspi()[0];
-    SharedMatrix mo_ints = mo_eri_helper(ao_eri(), Co, Cv);
+    SharedMatrix mo_ints = mo_eri_helper(thread_ints([&]() { return integral_->eri(); }), Co, Cv, Co, Cv);
     SharedMatrix mo_spin_ints = mo_spin_eri_helper(mo_ints, n1, n2);
     mo_ints.reset();
     mo_spin_ints->set_name("MO Spin ERI Tensor");
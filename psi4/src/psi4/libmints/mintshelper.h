@@ -33,6 +33,7 @@
 #include "psi4/libmints/multipolesymmetry.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <functional>
 #include <vector>
 
 namespace psi {
@@ -67,16 +68,18 @@ private:
     /// Value which any two-electron integral is below is discarded
     double cutoff_;
 
-    // In-core O(N^5) transqt
-    SharedMatrix mo_eri_helper(SharedMatrix Iso, SharedMatrix Co, SharedMatrix Cv);
-    // In-core O(N^5) transqt
-    SharedMatrix mo_eri_helper(SharedMatrix Iso, SharedMatrix C1, SharedMatrix C2,
-                                                 SharedMatrix C3, SharedMatrix C4);
+    /// (C1 C2|C3 C4), half-transformed one (MN| shell pair block at a time, so that
+    /// no nbf^4 tensor is formed
+    SharedMatrix mo_eri_helper(std::vector<std::shared_ptr<TwoBodyAOInt>> ints, SharedMatrix C1, SharedMatrix C2,
+                               SharedMatrix C3, SharedMatrix C4);
     /// In-core builds spin eri's
     SharedMatrix mo_spin_eri_helper(SharedMatrix Iso, int n1, int n2);
 
 
-    SharedMatrix ao_helper(const std::string& label, std::shared_ptr<TwoBodyAOInt> ints);
+    /// nthread_ integral objects from build, one per thread
+    std::vector<std::shared_ptr<TwoBodyAOInt>> thread_ints(std::function<TwoBodyAOInt*()> build);
+    /// Full (12|34) tensor, threaded over bra shell pairs
+    SharedMatrix ao_helper(const std::string& label, std::vector<std::shared_ptr<TwoBodyAOInt>> ints);
     SharedMatrix ao_shell_getter(const std::string& label, std::shared_ptr<TwoBodyAOInt> ints, int M, int N, int P, int Q);
 
     SharedMatrix ao_3coverlap_helper(const std::string &label, std::shared_ptr<ThreeCenterOverlapInt> ints);
@@ -137,6 +140,9 @@ public:
     void integrals();
     void integrals_erf(double w = -1.0);
     void integrals_erfc(double w = -1.0);
+    /// SO integrals in PSIF_SO_TEI_BLOCKED: for each irrep of the (nn|nn) pairs a
+    /// dense square block, rows and columns in libdpd's "[n>=n]+" pair order
+    void integrals_blocked();
 
     /// Standard one electron integrals (just like oeints used to do)
     void one_electron_integrals();
@@ -151,6 +157,21 @@ public:
                         std::shared_ptr<BasisSet> bs2,
                         std::shared_ptr<BasisSet> bs3,
                         std::shared_ptr<BasisSet> bs4);
+    /**
+     * Unique AO ERIs (mn|rs), m >= n, r >= s, mn >= rs, at
+     * mnrs = mn (mn + 1) / 2 + rs with mn = m (m + 1) / 2 + n
+     */
+    SharedVector ao_eri_packed();
+    /**
+     * Rows (mn|rs) of the AO ERI tensor whose m lies on shells [Mstart, Mstop),
+     * a (nm * nbf) x (nbf * nbf) slab, threaded over the (MN| shell pairs
+     */
+    SharedMatrix ao_eri_slab(int Mstart, int Mstop);
+    /// Unfitted (Q|mn) for the Q on auxiliary shells [Pstart, Pstop), (nQ) x (nbf * nbf)
+    SharedMatrix ao_3index_slab(std::shared_ptr<BasisSet> aux, int Pstart, int Pstop);
+    /// The ao_3index_slab() rows transformed to (Q|ij) with C1 and C2, (nQ) x (n1 * n2)
+    SharedMatrix mo_3index_slab(std::shared_ptr<BasisSet> aux, int Pstart, int Pstop, SharedMatrix C1,
+                                SharedMatrix C2);
     /// AO ERI Shell
     SharedMatrix ao_eri_shell(int M, int N, int P, int Q);
     /// AO ERF Integrals
@@ -355,6 +355,53 @@ int Molecule::atom_at_position2(Vector3 &b, double tol) const
     return -1;
 }
 
+size_t AtomLookup::CellHash::operator()(const Cell& c) const
+{
+    size_t h = std::hash<long int>()(c.i);
+    h = h * 1000003UL ^ std::hash<long int>()(c.j);
+    h = h * 1000003UL ^ std::hash<long int>()(c.k);
+    return h;
+}
+
+AtomLookup::AtomLookup(const Molecule& mol, double tol)
+    : tol_(tol), width_(std::max(tol, 0.5))
+{
+    xyz_.reserve(mol.natom());
+    for (int i = 0; i < mol.natom(); ++i) {
+        xyz_.push_back(mol.xyz(i));
+        cells_[cell(xyz_[i])].push_back(i);
+    }
+}
+
+AtomLookup::Cell AtomLookup::cell(const Vector3& r) const
+{
+    Cell c;
+    c.i = (long int) std::floor(r[0] / width_);
+    c.j = (long int) std::floor(r[1] / width_);
+    c.k = (long int) std::floor(r[2] / width_);
+    return c;
+}
+
+int AtomLookup::atom_at(const Vector3& b) const
+{
+    Cell c = cell(b);
+    int atom = -1;
+    for (long int di = -1; di <= 1; ++di) {
+        for (long int dj = -1; dj <= 1; ++dj) {
+            for (long int dk = -1; dk <= 1; ++dk) {
+                Cell n = {c.i + di, c.j + dj, c.k + dk};
+                auto it = cells_.find(n);
+                if (it == cells_.end()) continue;
+                for (int i : it->second) {
+                    if ((atom < 0 || i < atom) && b.distance(xyz_[i]) < tol_)
+                        atom = i;
+                }
+            }
+        }
+    }
+    return atom;
+}
+
 Vector3 Molecule::nuclear_dipole() const
 {
     Vector3 origin(0.0, 0.0, 0.0);
@@ -2104,10 +2151,16 @@ RotorType Molecule::rotor_type(double zero_tol) const
 // Symmetry
 //
 bool Molecule::has_inversion(Vector3 &origin, double tol) const
+{
+    AtomLookup lookup(*this, tol);
+    return has_inversion(lookup, origin, tol);
+}
+
+bool Molecule::has_inversion(const AtomLookup &lookup, Vector3 &origin, double tol) const
 {
     for (int i = 0; i < natom(); ++i) {
         Vector3 inverted = origin - (xyz(i) - origin);
-        int atom = atom_at_position2(inverted, tol);
+        int atom = lookup.atom_at(inverted);
         if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
             return false;
         }
@@ -2116,13 +2169,19 @@ bool Molecule::has_inversion(Vector3 &origin, double tol) const
 }
 
 bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const
+{
+    AtomLookup lookup(*this, tol);
+    return is_plane(lookup, origin, uperp, tol);
+}
+
+bool Molecule::is_plane(const AtomLookup &lookup, Vector3 &origin, Vector3 &uperp, double tol) const
 {
     for (int i = 0; i < natom(); ++i) {
         Vector3 A = xyz(i) - origin;
         Vector3 Apar = uperp.dot(A) * uperp;
         Vector3 Aperp = A - Apar;
         A = (Aperp - Apar) + origin;
-        int atom = atom_at_position2(A, tol);
+        int atom = lookup.atom_at(A);
         if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
             return false;
         }
@@ -2131,6 +2190,12 @@ bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const
 }
 
 bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) const
+{
+    AtomLookup lookup(*this, tol);
+    return is_axis(lookup, origin, axis, order, tol);
+}
+
+bool Molecule::is_axis(const AtomLookup &lookup, Vector3 &origin, Vector3 &axis, int order, double tol) const
 {
     for (int i = 0; i < natom(); ++i) {
         Vector3 A = xyz(i) - origin;
@@ -2138,7 +2203,7 @@ bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) co
             Vector3 R = A;
             R.rotate(j * 2.0 * M_PI / order, axis);
             R += origin;
-            int atom = atom_at_position2(R, tol);
+            int atom = lookup.atom_at(R);
             if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
                 return false;
             }
@@ -2244,7 +2309,7 @@ int Molecule::max_nequivalent() const
 
 std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
 {
-    int i, j;
+    int i;
 
     Vector3 com = center_of_mass();
 
@@ -2255,7 +2320,42 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
     bool linear, planar;
     is_linear_planar(linear, planar, tol);
 
-    bool have_inversion = has_inversion(com, tol);
+    // Every trial element below comes from a pair of equivalent atoms at the
+    // same distance from the com. Order the atoms by that distance so each
+    // atom only meets the partners inside its tol window.
+    std::vector<std::pair<double, int> > radii(natom());
+    for (i = 0; i < natom(); ++i) {
+        Vector3 A = xyz(i) - com;
+        radii[i] = std::make_pair(A.dot(A), i);
+    }
+    std::sort(radii.begin(), radii.end());
+    // The atoms equivalent to atom (itself included) near its distance, in index order
+    auto partners = [&](int atom) {
+        Vector3 A = xyz(atom) - com;
+        double AdotA = A.dot(A);
+        auto first = std::lower_bound(radii.begin(), radii.end(), std::make_pair(AdotA - 2.0 * tol, -1));
+        std::vector<int> js;
+        for (auto it = first; it != radii.end() && it->first <= AdotA + 2.0 * tol; ++it) {
+            if (atoms_[atom]->is_equivalent_to(atoms_[it->second])) js.push_back(it->second);
+        }
+        std::sort(js.begin(), js.end());
+        return js;
+    };
+
+    // Unless it is linear or planar, a molecule with no such pair has no
+    // element at all: each atom would have to lie on every one of them
+    if (natom() > 1 && !linear && !planar) {
+        bool paired = false;
+        for (i = 0; i < natom() && !paired; ++i) paired = partners(i).size() > 1;
+        if (!paired) {
+            SharedMatrix frame(new Matrix(3, 3));
+            frame->identity();
+            return frame;
+        }
+    }
+
+    AtomLookup lookup(*this, tol);
+    bool have_inversion = has_inversion(lookup, com, tol);
 
     // check for C2 axis
     Vector3 c2axis;
@@ -2289,9 +2389,8 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
         for (i = 0; i < natom(); ++i) {
             Vector3 A = xyz(i) - com;
             double AdotA = A.dot(A);
-            for (j = 0; j <= i; ++j) {
-                // the atoms must be identical
-                if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
+            for (int j : partners(i)) {
+                if (j > i) break;
                 Vector3 B = xyz(j) - com;
                 // the atoms must be the same distance from the com
                 if (std::fabs(AdotA - B.dot(B)) > tol) continue;
@@ -2299,7 +2398,7 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
                 // atoms colinear with the com don't work
                 if (axis.norm() < tol) continue;
                 axis.normalize();
-                if (is_axis(com, axis, 2, tol)) {
+                if (is_axis(lookup, com, axis, 2, tol)) {
                     have_c2axis = true;
                     c2axis = axis;
                     goto symmframe_found_c2axis;
@@ -2333,9 +2432,8 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
                 double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
-                    // the atoms must be identical
-                    if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
+                for (int j : partners(i)) {
+                    if (j >= i) break;
                     Vector3 B = xyz(j) - com;
                     // the atoms must be the same distance from the com
                     if (std::fabs(AdotA - B.dot(B)) > tol) continue;
@@ -2345,7 +2443,7 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
                     axis.normalize();
                     // if axis is not perp continue
                     if (std::fabs(axis.dot(c2axis)) > tol) continue;
-                    if (is_axis(com, axis, 2, tol)) {
+                    if (is_axis(lookup, com, axis, 2, tol)) {
                         have_c2axisperp = true;
                         c2axisperp = axis;
                         goto symmframe_found_c2axisperp;
@@ -2405,9 +2503,8 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
                 double AdotA = A.dot(A);
                 // the second atom can equal i because i might be
                 // in the plane
-                for (j = 0; j <= i; ++j) {
-                    // the atoms must be identical
-                    if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
+                for (int j : partners(i)) {
+                    if (j > i) break;
                     Vector3 B = xyz(j) - com;
                     // the atoms must be the same distance from the com
                     if (std::fabs(AdotA - B.dot(B)) > tol) continue;
@@ -2419,7 +2516,7 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (is_plane(lookup, com, perp, tol)) {
                         have_sigmav = true;
                         sigmav = perp;
                         goto symmframe_found_sigmav;
@@ -2469,9 +2566,8 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
                 double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
-                    // the atomsmust be identical
-                    if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
+                for (int j : partners(i)) {
+                    if (j >= i) break;
                     Vector3 B = xyz(j) - com;
                     double BdotB = B.dot(B);
                     // the atoms must be the same distance from the com
@@ -2480,7 +2576,7 @@ std::shared_ptr <Matrix> Molecule::symmetry_frame(double tol)
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (is_plane(lookup, com, perp, tol)) {
                         have_sigma = true;
                         sigma = perp;
                         goto found_sigma;
@@ -2589,6 +2685,7 @@ std::shared_ptr <PointGroup> Molecule::find_highest_point_group(double tol) cons
     };
 
     SymmetryOperation symop;
+    AtomLookup lookup(*this, tol);
 
     int matching_atom = -1;
     // Only needs to detect the 8 symmetry operations
@@ -2605,7 +2702,7 @@ std::shared_ptr <PointGroup> Molecule::find_highest_point_group(double tol) cons
             Vector3 op(symop(0, 0), symop(1, 1), symop(2, 2));
             Vector3 pos = xyz(i) * op;
 
-            if ((matching_atom = atom_at_position2(pos, tol)) >= 0) {
+            if ((matching_atom = lookup.atom_at(pos)) >= 0) {
                 if (atoms_[i]->is_equivalent_to(atoms_[matching_atom]) == false) {
                     found = false;
                     break;
@@ -2723,9 +2820,10 @@ void Molecule::set_point_group(std::shared_ptr <PointGroup> pg)
 
 bool Molecule::has_symmetry_element(Vector3 &op, double tol) const
 {
+    AtomLookup lookup(*this, tol);
     for (int i = 0; i < natom(); ++i) {
         Vector3 result = xyz(i) * op;
-        int atom = atom_at_position2(result, tol);
+        int atom = lookup.atom_at(result);
 
         if (atom != -1) {
             if (!atoms_[atom]->is_equivalent_to(atoms_[i]))
@@ -2824,6 +2922,7 @@ void Molecule::form_symmetry_information(double tol)
     atom_to_unique_[0] = 0;
 
     CharacterTable ct = point_group()->char_table();
+    AtomLookup lookup(*this, tol);
 
     Vector3 ac;
     SymmetryOperation so;
@@ -2846,17 +2945,14 @@ void Molecule::form_symmetry_information(double tol)
             }
 
             // See if the transformed atom is equivalent to a
-            // unique atom
-            for (int j = 0; j < nunique_; ++j) {
-                int unique = equiv_[j][0];
-                Vector3 aj(xyz(unique));
-                if (np.distance(aj) < tol
-                    && Z(unique) == Z(i)
-                    && std::fabs(mass(unique) - mass(i)) < tol) {
-                    i_is_unique = 0;
-                    i_equiv = j;
-                    break;
-                }
+            // unique atom, i.e. lands on the first of an earlier set
+            int unique = lookup.atom_at(np);
+            if (unique >= 0 && unique < i
+                && equiv_[atom_to_unique_[unique]][0] == unique
+                && Z(unique) == Z(i)
+                && std::fabs(mass(unique) - mass(i)) < tol) {
+                i_is_unique = 0;
+                i_equiv = atom_to_unique_[unique];
             }
         }
         if (i_is_unique) {
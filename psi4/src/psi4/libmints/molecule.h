@@ -34,6 +34,7 @@
 #include <cstdio>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #define LINEAR_A_TOL 1.0E-2 //When sin(a) is below this, we consider the angle to be linear
 #define DEFAULT_SYM_TOL 1.0E-8
@@ -45,6 +46,7 @@
 namespace psi {
 class PointGroup;
 class BasisSet;
+class AtomLookup;
 enum RotorType {RT_ASYMMETRIC_TOP, RT_SYMMETRIC_TOP, RT_SPHERICAL_TOP, RT_LINEAR, RT_ATOM};
 enum FullPointGroup {PG_ATOM, PG_Cinfv, PG_Dinfh, PG_C1, PG_Cs, PG_Ci, PG_Cn, PG_Cnv,
  PG_Cnh, PG_Sn, PG_Dn, PG_Dnd, PG_Dnh, PG_Td, PG_Oh, PG_Ih};
@@ -176,6 +178,13 @@ protected:
     /// Whether this molecule has at least one zmatrix entry
     bool zmat_;
 
+    /// @{
+    /// The symmetry element tests, finding images through a prebuilt lookup
+    bool has_inversion(const AtomLookup& lookup, Vector3& origin, double tol) const;
+    bool is_plane(const AtomLookup& lookup, Vector3& origin, Vector3& uperp, double tol) const;
+    bool is_axis(const AtomLookup& lookup, Vector3& origin, Vector3& axis, int order, double tol) const;
+    /// @}
+
 public:
 //****AVC****//
     /// The list of atom ranges defining each fragment from parent molecule
@@ -672,6 +681,40 @@ public:
     void update_geometry();
 };
 
+/*! \ingroup MINTS
+ *  \class AtomLookup
+ *  \brief Finds the atom of a Molecule at a given position.
+ *
+ * Atoms are bucketed on a grid of cells at least tol wide, so a lookup
+ * visits the 27 cells around the position rather than every atom. The
+ * buckets are a snapshot of the geometry: build a new AtomLookup after
+ * the molecule moves.
+ */
+class AtomLookup
+{
+    struct Cell {
+        long int i, j, k;
+        bool operator==(const Cell& other) const { return i == other.i && j == other.j && k == other.k; }
+    };
+    struct CellHash {
+        size_t operator()(const Cell& c) const;
+    };
+
+    double tol_;
+    double width_;
+    std::vector<Vector3> xyz_;
+    std::unordered_map<Cell, std::vector<int>, CellHash> cells_;
+
+    Cell cell(const Vector3& r) const;
+
+public:
+    AtomLookup(const Molecule& mol, double tol);
+
+    /// Lowest-numbered atom within tol of b, or -1, as Molecule::atom_at_position2
+    int atom_at(const Vector3& b) const;
+    int atom_at(const double* b) const { return atom_at(Vector3(b[0], b[1], b[2])); }
+};
+
 }
 
 #endif
@@ -60,6 +60,18 @@ MultipoleInt::~MultipoleInt()
     delete[] buffer_;
 }
 
+bool MultipoleInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* MultipoleInt::clone() const
+{
+    OneBodyAOInt* ints = new MultipoleInt(spherical_transforms_, bs1_, bs2_, order_, deriv_);
+    copy_settings(ints);
+    return ints;
+}
+
 SharedVector MultipoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, int order, const Vector3 &origin)
 {
     int ntot = (order+1)*(order+2)*(order+3)/6 - 1;
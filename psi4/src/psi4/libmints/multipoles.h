@@ -63,6 +63,10 @@ public:
     //! Virtual destructor
     virtual ~MultipoleInt();
 
+        virtual bool cloneable() const;
+    /// Returns a new MultipoleInt with the same origin and settings
+    virtual OneBodyAOInt* clone() const;
+
     //! Does the method provide first derivatives?
     bool has_deriv1() { return false; }
 
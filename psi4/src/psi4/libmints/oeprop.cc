@@ -51,6 +51,7 @@
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/dipole.h"
+#include "psi4/libmints/potentialint.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
@@ -64,9 +65,28 @@
 #include <fstream>
 #include <regex>
 #include <tuple>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
+namespace {
+/// Contracts PCMPotentialInt integrals over unit charges with a Cartesian density
+class ESPContractFunctor
+{
+    double **pD_;
+    double *V_;
+    double scale_;
+public:
+    ESPContractFunctor(SharedMatrix D, double *V, double scale) : pD_(D->pointer()), V_(V), scale_(scale) {}
+    void operator()(int bf1, int bf2, int center, double integral)
+    {
+        V_[center] += scale_ * pD_[bf1][bf2] * integral;
+    }
+};
+}
+
 Prop::Prop(std::shared_ptr<Wavefunction> wfn) : wfn_(wfn)
 {
     if (wfn_.get() == NULL)
@@ -769,6 +789,7 @@ void OEProp::common_init()
     Options &options = Process::environment.options;
 
     print_ = options.get_int("PRINT");
+    esp_screening_ = options.get_double("OEPROP_ESP_SCREENING");
 
     std::shared_ptr<Molecule> mol = basisset_->molecule();
     int natoms = mol->natom();
@@ -865,6 +886,9 @@ void OEProp::compute()
 
     outfile->Printf( "\nProperties computed using the %s density matrix\n\n", title_.c_str());
 
+    // The densities may have been reset since the last call
+    Dtot_cart_.reset();
+
     // Search for multipole strings, which are handled separately
     std::set<std::string>::const_iterator iter = tasks_.begin();
     std::regex mpoles("^MULTIPOLE(?:S)?\\s*\\((\\d+)\\)$");
@@ -1046,13 +1070,9 @@ public:
     }
 };
 
-void OEProp::compute_esp_over_grid()
+SharedMatrix OEProp::total_cartesian_density()
 {
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
-    outfile->Printf( "\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
+    if (Dtot_cart_) return Dtot_cart_;
 
     SharedMatrix Dtot = wfn_->D_subset_helper(Da_so_, Ca_so_, "AO");
     if (same_dens_) {
@@ -1060,33 +1080,127 @@ void OEProp::compute_esp_over_grid()
     }else{
         Dtot->add(wfn_->D_subset_helper(Db_so_, Cb_so_, "AO"));
     }
+    if (!basisset_->has_puream()) {
+        Dtot_cart_ = Dtot;
+        return Dtot_cart_;
+    }
+
+    // PCMPotentialInt works in the Cartesian functions, so take D there once: D_cart = T D T^t
+    SharedMatrix T(new Matrix("Cartesian to AO", basisset_->nao(), basisset_->nbf()));
+    double **Tp = T->pointer();
+    for (int P = 0; P < basisset_->nshell(); ++P) {
+        const GaussianShell& shell = basisset_->shell(P);
+        int cart0 = basisset_->shell_to_ao_function(P);
+        int func0 = basisset_->shell_to_basis_function(P);
+        if (!shell.is_pure()) {
+            for (int p = 0; p < shell.ncartesian(); ++p)
+                Tp[cart0 + p][func0 + p] = 1.0;
+            continue;
+        }
+        std::shared_ptr<SphericalTransformIter> trans(integral_->spherical_transform_iter(shell.am()));
+        for (trans->first(); !trans->is_done(); trans->next())
+            Tp[cart0 + trans->cartindex()][func0 + trans->pureindex()] = trans->coef();
+    }
+    Dtot_cart_ = Matrix::triplet(T, Dtot, T, false, false, true);
+    return Dtot_cart_;
+}
+
+void OEProp::compute_esp_over_points(const std::vector<Vector3>& points, std::vector<double>& Velec)
+{
+    int npoint = points.size();
+    Velec.assign(npoint, 0.0);
+    if (npoint == 0) return;
+
+    SharedMatrix Dcart = total_cartesian_density();
+
+    // Every point is a unit charge, so one pass over the shell pairs serves them all
+    SharedMatrix Zxyz(new Matrix("Grid points", npoint, 4));
+    double **Zxyzp = Zxyz->pointer();
+    for (int i = 0; i < npoint; ++i) {
+        Zxyzp[i][0] = 1.0;
+        Zxyzp[i][1] = points[i][0];
+        Zxyzp[i][2] = points[i][1];
+        Zxyzp[i][3] = points[i][2];
+    }
+
+    int nshell = basisset_->nshell();
+    std::vector<std::pair<int, int> > PQ_pairs;
+    for (int P = 0; P < nshell; ++P)
+        for (int Q = 0; Q <= P; ++Q)
+            PQ_pairs.push_back(std::make_pair(P, Q));
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::vector<std::shared_ptr<PCMPotentialInt> > ints;
+    std::vector<std::vector<double> > Vt(nthread, std::vector<double>(npoint, 0.0));
+    for (int t = 0; t < nthread; ++t) {
+        ints.push_back(std::shared_ptr<PCMPotentialInt>(static_cast<PCMPotentialInt*>(integral_->pcm_potentialint())));
+        ints[t]->set_charge_field(Zxyz);
+        ints[t]->set_screening(esp_screening_);
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (long int PQ = 0L; PQ < (long int) PQ_pairs.size(); ++PQ) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int P = PQ_pairs[PQ].first;
+        int Q = PQ_pairs[PQ].second;
+        ESPContractFunctor contract(Dcart, Vt[thread].data(), P == Q ? 1.0 : 2.0);
+        ints[thread]->compute_pair(P, Q, basisset_->shell_to_ao_function(P),
+                                   basisset_->shell_to_ao_function(Q), contract);
+    }
 
-    int nbf = basisset_->nbf();
-    SharedMatrix ints(new Matrix("Ex integrals", nbf, nbf));
+    for (int t = 0; t < nthread; ++t)
+        for (int i = 0; i < npoint; ++i)
+            Velec[i] += Vt[t][i];
+}
 
-    Vvals_.clear();
-    FILE *gridout = fopen("grid_esp.dat", "w");
-    if(!gridout)
-        throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+void OEProp::compute_esp_over_grid()
+{
+    std::shared_ptr<Molecule> mol = basisset_->molecule();
+
+    outfile->Printf( "\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
+
+    std::vector<Vector3> points;
     GridIterator griditer("grid.dat");
     for(griditer.first(); !griditer.last(); griditer.next()){
         Vector3 origin(griditer.gridpoints());
         if(mol->units() == Molecule::Angstrom)
             origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
+        points.push_back(origin);
+    }
+
+    std::vector<double> Velec;
+    compute_esp_over_points(points, Velec);
+
+    int npoint = points.size();
+    int natom = mol->natom();
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    Vvals_.assign(npoint, 0.0);
+#pragma omp parallel for schedule(static) num_threads(nthread)
+    for (int p = 0; p < npoint; ++p) {
         double Vnuc = 0.0;
-        int natom = mol->natom();
         for(int i=0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
+            Vector3 dR = points[p] - mol->xyz(i);
             double r = dR.norm();
             if(r > 1.0E-8)
                 Vnuc += mol->Z(i)/r;
         }
-        Vvals_.push_back(Velec+Vnuc);
-        fprintf(gridout, "%16.10f\n", Velec+Vnuc);
+        Vvals_[p] = Velec[p] + Vnuc;
     }
+
+    FILE *gridout = fopen("grid_esp.dat", "w");
+    if(!gridout)
+        throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    for (int p = 0; p < npoint; ++p)
+        fprintf(gridout, "%16.10f\n", Vvals_[p]);
     fclose(gridout);
 }
 
@@ -1095,8 +1209,6 @@ void OEProp::compute_field_over_grid()
 {
     std::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     outfile->Printf( "\n Field computed on the grid and written to grid_field.dat\n");
 
     SharedMatrix Dtot = wfn_->D_subset_helper(Da_so_, Ca_so_, "AO");
@@ -1106,39 +1218,57 @@ void OEProp::compute_field_over_grid()
         Dtot->add(wfn_->D_subset_helper(Db_so_, Cb_so_, "AO"));
     }
 
-    std::shared_ptr<ElectricFieldInt> field_ints(dynamic_cast<ElectricFieldInt*>(wfn_->integral()->electric_field()));
-
-    int nbf = basisset_->nbf();
-    std::vector<SharedMatrix> intmats;
-    intmats.push_back(SharedMatrix(new Matrix("Ex integrals", nbf, nbf)));
-    intmats.push_back(SharedMatrix(new Matrix("Ey integrals", nbf, nbf)));
-    intmats.push_back(SharedMatrix(new Matrix("Ez integrals", nbf, nbf)));
-
-    Exvals_.clear();
-    Eyvals_.clear();
-    Ezvals_.clear();
-
-    FILE *gridout = fopen("grid_field.dat", "w");
-    if(!gridout)
-        throw PSIEXCEPTION("Unable to write to grid_field.dat");
+    std::vector<Vector3> points;
     GridIterator griditer("grid.dat");
     for(griditer.first(); !griditer.last(); griditer.next()){
         Vector3 origin(griditer.gridpoints());
         if(mol->units() == Molecule::Angstrom)
             origin /= pc_bohr2angstroms;
-        field_ints->set_origin(origin);
+        points.push_back(origin);
+    }
+    int npoint = points.size();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    // The field integrals carry their origin, so each thread has its own
+    int nbf = basisset_->nbf();
+    std::vector<std::shared_ptr<ElectricFieldInt> > field_ints;
+    std::vector<std::vector<SharedMatrix> > intmats(nthread);
+    for (int t = 0; t < nthread; ++t) {
+        field_ints.push_back(std::shared_ptr<ElectricFieldInt>(dynamic_cast<ElectricFieldInt*>(integral_->electric_field())));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ex integrals", nbf, nbf)));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ey integrals", nbf, nbf)));
+        intmats[t].push_back(SharedMatrix(new Matrix("Ez integrals", nbf, nbf)));
+    }
+
+    Exvals_.assign(npoint, 0.0);
+    Eyvals_.assign(npoint, 0.0);
+    Ezvals_.assign(npoint, 0.0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int p = 0; p < npoint; ++p) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        std::vector<SharedMatrix>& mats = intmats[thread];
+        field_ints[thread]->set_origin(points[p]);
         for (int m=0; m<3; ++m)
-            intmats[m]->zero();
-        field_ints->compute(intmats);
-        double Ex = Dtot->vector_dot(intmats[0]);
-        double Ey = Dtot->vector_dot(intmats[1]);
-        double Ez = Dtot->vector_dot(intmats[2]);
-        Vector3 nuc = field_ints->nuclear_contribution(origin, mol);
-        Exvals_.push_back(Ex+nuc[0]);
-        Eyvals_.push_back(Ey+nuc[1]);
-        Ezvals_.push_back(Ez+nuc[2]);
-        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Ex+nuc[0], Ey+nuc[1], Ez+nuc[2]);
+            mats[m]->zero();
+        field_ints[thread]->compute(mats);
+        Vector3 nuc = field_ints[thread]->nuclear_contribution(points[p], mol);
+        Exvals_[p] = Dtot->vector_dot(mats[0]) + nuc[0];
+        Eyvals_[p] = Dtot->vector_dot(mats[1]) + nuc[1];
+        Ezvals_[p] = Dtot->vector_dot(mats[2]) + nuc[2];
     }
+
+    FILE *gridout = fopen("grid_field.dat", "w");
+    if(!gridout)
+        throw PSIEXCEPTION("Unable to write to grid_field.dat");
+    for (int p = 0; p < npoint; ++p)
+        fprintf(gridout, "%16.10f %16.10f %16.10f\n", Exvals_[p], Eyvals_[p], Ezvals_[p]);
     fclose(gridout);
 }
 
@@ -1147,17 +1277,13 @@ void OEProp::compute_esp_at_nuclei()
 {
     std::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
-    int nbf = basisset_->nbf();
     int natoms = mol->natom();
 
-    SharedMatrix Dtot = wfn_->D_subset_helper(Da_so_, Ca_so_, "AO");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    }else{
-        Dtot->add(wfn_->D_subset_helper(Db_so_, Cb_so_, "AO"));
-    }
+    std::vector<Vector3> points;
+    for(int atom = 0; atom < natoms; ++atom)
+        points.push_back(mol->xyz(atom));
+    std::vector<double> Velec;
+    compute_esp_over_points(points, Velec);
 
     Matrix dist = mol->distance_matrix();
     outfile->Printf( "\n Electrostatic potentials at the nuclear coordinates:\n");
@@ -1167,11 +1293,7 @@ void OEProp::compute_esp_at_nuclei()
     for(int atom1 = 0; atom1 < natoms; ++atom1){
         std::stringstream s;
         s << "ESP AT CENTER " << atom1+1;
-        SharedMatrix ints(new Matrix(s.str(), nbf, nbf));
-        epot->compute(ints, mol->xyz(atom1));
-        if(print_ > 2)
-            ints->print();
-        double elec = Dtot->vector_dot(ints);
+        double elec = Velec[atom1];
         double nuc = 0.0;
         for(int atom2 = 0; atom2 < natoms; ++atom2){
             if(atom1 == atom2)
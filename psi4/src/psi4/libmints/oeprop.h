@@ -265,6 +265,10 @@ protected:
     void compute_esp_over_grid();
     /// Compute field at specified grid points
     void compute_field_over_grid();
+    /// Electronic ESP at each of points (bohr), from one threaded pass over the shell pairs
+    void compute_esp_over_points(const std::vector<Vector3>& points, std::vector<double>& Velec);
+    /// Total density in the Cartesian AO basis, built once per compute()
+    SharedMatrix total_cartesian_density();
 
 
     /// The center about which properties are computed
@@ -272,6 +276,11 @@ protected:
     /// Whether the origin is on a symmetry axis or not
     bool origin_preserves_symmetry_;
 
+    /// Total Cartesian AO density, see total_cartesian_density()
+    SharedMatrix Dtot_cart_;
+    /// Primitive screening for the ESP integrals (OEPROP_ESP_SCREENING)
+    double esp_screening_;
+
     /// The ESP in a.u., computed at each grid point
     std::vector<double> Vvals_;
     /// The field components in a.u. computed at each grid point
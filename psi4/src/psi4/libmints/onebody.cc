@@ -31,8 +31,12 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -75,6 +79,15 @@ static void transform1e_2(int am, SphericalTransformIter &sti, double *s, double
         }
     }
 }
+
+/// Row/column offset of each shell in the AO (or Cartesian) basis
+static std::vector<int> shell_offsets(const std::shared_ptr<BasisSet> &bs, bool cartesian)
+{
+    std::vector<int> offsets(bs->nshell() + 1, 0);
+    for (int i = 0; i < bs->nshell(); ++i)
+        offsets[i + 1] = offsets[i] + (cartesian ? bs->shell(i).ncartesian() : bs->shell(i).nfunction());
+    return offsets;
+}
 } // namespace anonmyous
 
 OneBodyAOInt::OneBodyAOInt(std::vector <SphericalTransform> &spherical_transforms, std::shared_ptr <BasisSet> bs1, std::shared_ptr <BasisSet> bs2, int deriv)
@@ -126,6 +139,29 @@ OneBodyAOInt *OneBodyAOInt::clone() const
     throw FeatureNotImplemented("libmints", "OneBodyInt::clone()", __FILE__, __LINE__);
 }
 
+void OneBodyAOInt::copy_settings(OneBodyAOInt *other) const
+{
+    other->force_cartesian_ = force_cartesian_;
+    other->origin_ = origin_;
+}
+
+int OneBodyAOInt::thread_ints(std::vector<OneBodyAOInt *> &ints, std::vector<std::shared_ptr<OneBodyAOInt> > &clones)
+{
+    int nthread = 1;
+#ifdef _OPENMP
+    // Nested calls (e.g. from an already threaded caller) stay serial
+    if (cloneable() && !omp_in_parallel())
+        nthread = Process::environment.get_n_threads();
+#endif
+    ints.assign(1, this);
+    clones.clear();
+    for (int t = 1; t < nthread; ++t) {
+        clones.push_back(std::shared_ptr<OneBodyAOInt>(clone()));
+        ints.push_back(clones.back().get());
+    }
+    return nthread;
+}
+
 void OneBodyAOInt::normalize_am(const GaussianShell & /*s1*/, const GaussianShell & /*s2*/, int /*nchunk*/)
 {
     // ACS removed this; the normalize function just returns 1.0
@@ -268,31 +304,40 @@ void OneBodyAOInt::compute(SharedMatrix &result)
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
 
-    int i_offset = 0;
-    double *location;
+    std::vector<int> i_offsets = shell_offsets(bs1_, force_cartesian_);
+    std::vector<int> j_offsets = shell_offsets(bs2_, force_cartesian_);
+
+    // Each thread owns the rows of the shells i it is handed
+    std::vector<OneBodyAOInt *> ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > clones;
+    int nthread = thread_ints(ints, clones);
 
     // Leave as this full double for loop. We could be computing nonsymmetric integrals
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i = 0; i < ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset = 0;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        OneBodyAOInt *in = ints[thread];
+        int ni = i_offsets[i + 1] - i_offsets[i];
+        int i_offset = i_offsets[i];
         for (int j = 0; j < ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+            int nj = j_offsets[j + 1] - j_offsets[j];
+            int j_offset = j_offsets[j];
 
             // Compute the shell (automatically transforms to pure am in needed)
-            compute_shell(i, j);
+            in->compute_shell(i, j);
 
             // For each integral that we got put in its contribution
-            location = buffer_;
+            const double *location = in->buffer_;
             for (int p = 0; p < ni; ++p) {
                 for (int q = 0; q < nj; ++q) {
                     result->add(0, i_offset + p, j_offset + q, *location);
                     location++;
                 }
             }
-
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
@@ -301,8 +346,6 @@ void OneBodyAOInt::compute(std::vector <SharedMatrix> &result)
     // Do not worry about zeroing out result
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
-    int i_offset = 0;
-    double *location = 0;
 
     // Check the length of result, must be chunk
     // There not an easy way of checking the size now.
@@ -318,17 +361,31 @@ void OneBodyAOInt::compute(std::vector <SharedMatrix> &result)
         }
     }
 
+    std::vector<int> i_offsets = shell_offsets(bs1_, force_cartesian_);
+    std::vector<int> j_offsets = shell_offsets(bs2_, force_cartesian_);
+
+    std::vector<OneBodyAOInt *> ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > clones;
+    int nthread = thread_ints(ints, clones);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i = 0; i < ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset = 0;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        OneBodyAOInt *in = ints[thread];
+        int ni = i_offsets[i + 1] - i_offsets[i];
+        int i_offset = i_offsets[i];
         for (int j = 0; j < ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+            int nj = j_offsets[j + 1] - j_offsets[j];
+            int j_offset = j_offsets[j];
 
             // Compute the shell
-            compute_shell(i, j);
+            in->compute_shell(i, j);
 
             // For each integral that we got put in its contribution
-            location = buffer_;
+            const double *location = in->buffer_;
             for (int r = 0; r < nchunk_; ++r) {
                 for (int p = 0; p < ni; ++p) {
                     for (int q = 0; q < nj; ++q) {
@@ -337,9 +394,7 @@ void OneBodyAOInt::compute(std::vector <SharedMatrix> &result)
                     }
                 }
             }
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
@@ -351,8 +406,6 @@ void OneBodyAOInt::compute_deriv1(std::vector <SharedMatrix> &result)
     // Do not worry about zeroing out result
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
-    int i_offset = 0;
-    double *location = 0;
 
     // Check the length of result, must be 3*natom_
     if (result.size() != (size_t) 3 * natom_)
@@ -361,21 +414,35 @@ void OneBodyAOInt::compute_deriv1(std::vector <SharedMatrix> &result)
     if (result[0]->nirrep() != 1)
         throw SanityCheckError("OneBodyInt::compute_deriv1(result): results must be C1 symmetry.", __FILE__, __LINE__);
 
+    std::vector<int> i_offsets = shell_offsets(bs1_, force_cartesian_);
+    std::vector<int> j_offsets = shell_offsets(bs2_, force_cartesian_);
+
+    std::vector<OneBodyAOInt *> ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > clones;
+    int nthread = thread_ints(ints, clones);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i = 0; i < ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        OneBodyAOInt *in = ints[thread];
+        int ni = i_offsets[i + 1] - i_offsets[i];
+        int i_offset = i_offsets[i];
         int center_i3 = 3 * bs1_->shell(i).ncenter();
-        int j_offset = 0;
         for (int j = 0; j < ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(i).ncartesian() : bs2_->shell(j).nfunction();
+            int nj = j_offsets[j + 1] - j_offsets[j];
+            int j_offset = j_offsets[j];
             int center_j3 = 3 * bs2_->shell(j).ncenter();
 
             if (center_i3 != center_j3) {
 
                 // Compute the shell
-                compute_shell_deriv1(i, j);
+                in->compute_shell_deriv1(i, j);
 
                 // Center i
-                location = buffer_;
+                const double *location = in->buffer_;
                 for (int r = 0; r < 3; ++r) {
                     for (int p = 0; p < ni; ++p) {
                         for (int q = 0; q < nj; ++q) {
@@ -396,10 +463,7 @@ void OneBodyAOInt::compute_deriv1(std::vector <SharedMatrix> &result)
                 }
 
             }
-
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
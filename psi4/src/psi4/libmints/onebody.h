@@ -85,6 +85,17 @@ protected:
     void set_chunks(int nchunk) { nchunk_ = nchunk; }
     void pure_transform(const GaussianShell&, const GaussianShell&, int=1);
 
+    /// Copy the run-time settings (origin, Cartesian flag) onto a clone
+    void copy_settings(OneBodyAOInt* other) const;
+
+    /**
+     * Integral objects for the threads of a shell-pair loop: this object,
+     * followed by clones kept alive in clones.  Falls back to one thread if
+     * the class isn't cloneable or we're already inside a parallel region.
+     * @return The number of threads
+     */
+    int thread_ints(std::vector<OneBodyAOInt*>& ints, std::vector<std::shared_ptr<OneBodyAOInt> >& clones);
+
     /// Normalize Cartesian functions based on angular momentum
     void normalize_am(const GaussianShell&, const GaussianShell&, int nchunk=1);
 
@@ -72,6 +72,18 @@ OverlapInt::~OverlapInt()
     delete[] buffer_;
 }
 
+bool OverlapInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* OverlapInt::clone() const
+{
+    OneBodyAOInt* ints = new OverlapInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    copy_settings(ints);
+    return ints;
+}
+
 // The engine only supports segmented basis sets
 void OverlapInt::compute_pair(const GaussianShell& s1, const GaussianShell& s2)
 {
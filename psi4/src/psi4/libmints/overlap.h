@@ -59,6 +59,10 @@ public:
     OverlapInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv=0);
     virtual ~OverlapInt();
 
+        virtual bool cloneable() const;
+    /// Returns a new OverlapInt with the same origin and settings
+    virtual OneBodyAOInt* clone() const;
+
     /// Does the method provide first derivatives?
     bool has_deriv1() { return true; }
     /// Does the method provide second derivatives?
@@ -58,6 +58,7 @@
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
 #include "psi4/libmints/shellrotation.h"
 #include "psi4/libmints/dimension.h"
 #include "psi4/libmints/cartesianiter.h"
@@ -65,10 +66,77 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
-;
+#include <algorithm>
+#include <deque>
+#include <mutex>
 
 namespace psi {
 
+struct PetiteList::SymmetryInfo {
+    /// Guards everything below, which is filled in once
+    std::mutex lock;
+    // From init(), once ready
+    bool ready = false;
+    std::vector<char> p1;
+    std::vector<char> lamij;
+    std::vector<int> nbf_in_ir;
+    int nblocks = 0;
+    // From compute_aotoso_info(), once have_sos: per block, its length and SOs
+    bool have_sos = false;
+    std::vector<int> block_len;
+    std::vector<std::vector<std::vector<contribution> > > sos;
+};
+
+std::shared_ptr<PetiteList::SymmetryInfo> PetiteList::cached_symmetry(const std::vector<int>& key)
+{
+    // A frequency run of a symmetric molecule visits a handful of subgroups
+    const size_t max_entries = 16;
+    static std::mutex cache_lock;
+    static std::map<std::vector<int>, std::shared_ptr<SymmetryInfo> > cache;
+    // Keys in the order they were added; the oldest go first
+    static std::deque<std::vector<int> > order;
+
+    std::lock_guard<std::mutex> guard(cache_lock);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+    if (order.size() == max_entries) {
+        cache.erase(order.front());
+        order.pop_front();
+    }
+    auto info = std::make_shared<SymmetryInfo>();
+    cache[key] = info;
+    order.push_back(key);
+    return info;
+}
+
+std::vector<int> PetiteList::symmetry_key() const
+{
+    const BasisSet& gbs = *basis_;
+    const Molecule& mol = *gbs.molecule();
+    std::vector<int> key;
+    key.push_back(group_);
+    key.push_back(include_pure_transform_);
+    key.push_back(natom_);
+    key.push_back(ng_);
+    for (int i = 0; i < natom_; i++)
+        for (int g = 0; g < ng_; g++)
+            key.push_back(atom_map(i, g));
+    key.push_back(mol.nunique());
+    for (int i = 0; i < mol.nunique(); i++) {
+        key.push_back(mol.nequivalent(i));
+        for (int j = 0; j < mol.nequivalent(i); j++)
+            key.push_back(mol.equivalent(i, j));
+    }
+    key.push_back(nshell_);
+    for (int s = 0; s < nshell_; s++) {
+        const GaussianShell& shell = gbs.shell(s);
+        key.push_back(shell.ncenter());
+        key.push_back(shell.am());
+        key.push_back(shell.is_pure());
+    }
+    return key;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 contribution::contribution()
@@ -316,6 +384,7 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
 
     double np[3];
     SymmetryOperation so;
+    AtomLookup lookup(mol, tol);
 
     // loop over all centers
     for (int i = 0; i < natom; i++) {
@@ -332,7 +401,7 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
                     np[ii] += so(ii, jj) * ac[jj];
             }
 
-            atom_map[i][g] = mol.atom_at_position1(np, tol);
+            atom_map[i][g] = lookup.atom_at(np);
             if (atom_map[i][g] < 0) {
                 outfile->Printf("\tERROR: Symmetry operation %d did not map atom %d to another atom:\n", g, i + 1);
                 if (!suppress_mol_print_in_exc) {
@@ -552,6 +621,7 @@ void PetiteList::init(double tol)
         lamij_ = 0;
         nbf_in_ir_ = 0;
         stablizer_ = 0;
+        info_ = cached_symmetry(symmetry_key());
         return;
     }
 
@@ -584,6 +654,7 @@ void PetiteList::init(double tol)
     SymmetryOperation so;
 
     max_stablizer_ = nirrep_ / mol.max_nequivalent();
+    AtomLookup lookup(mol, tol);
 
     // loop over all centers
     for (i = 0; i < natom_; i++) {
@@ -602,7 +673,7 @@ void PetiteList::init(double tol)
                     np[ii] += so(ii, jj) * ac[jj];
             }
 
-            atom_map_[i][g] = mol.atom_at_position1(np, tol);
+            atom_map_[i][g] = lookup.atom_at(np);
 
             // We want the list of operations that keeps the atom the same that is not E.
             if (atom_map_[i][g] == i)
@@ -640,6 +711,19 @@ void PetiteList::init(double tol)
         }
     }
 
+    info_ = cached_symmetry(symmetry_key());
+    {
+        std::lock_guard<std::mutex> guard(info_->lock);
+        if (info_->ready) {
+            std::copy(info_->p1.begin(), info_->p1.end(), p1_);
+            std::copy(info_->lamij.begin(), info_->lamij.end(), lamij_);
+            nbf_in_ir_ = new int[nirrep_];
+            std::copy(info_->nbf_in_ir.begin(), info_->nbf_in_ir.end(), nbf_in_ir_);
+            nblocks_ = info_->nblocks;
+            return;
+        }
+    }
+
     memset(p1_, 0, nshell_);
     memset(lamij_, 0, i_offset64(nshell_));
 
@@ -728,6 +812,15 @@ void PetiteList::init(double tol)
     }
 
     delete[] red_rep;
+
+    std::lock_guard<std::mutex> guard(info_->lock);
+    if (!info_->ready) {
+        info_->p1.assign(p1_, p1_ + nshell_);
+        info_->lamij.assign(lamij_, lamij_ + i_offset64(nshell_));
+        info_->nbf_in_ir.assign(nbf_in_ir_, nbf_in_ir_ + nirrep_);
+        info_->nblocks = nblocks_;
+        info_->ready = true;
+    }
 }
 
 Dimension PetiteList::AO_basisdim()
@@ -822,6 +915,23 @@ void PetiteList::print(std::string out)
 SO_block *
 PetiteList::compute_aotoso_info()
 {
+    {
+        std::lock_guard<std::mutex> guard(info_->lock);
+        if (info_->have_sos) {
+            SO_block *SOs = new SO_block[nirrep_];
+            for (int h = 0; h < nirrep_; ++h) {
+                const std::vector<std::vector<contribution> >& sos = info_->sos[h];
+                SOs[h].set_length(info_->block_len[h]);
+                for (size_t j = 0; j < sos.size(); ++j) {
+                    SO& so = SOs[h].so[j];
+                    so.set_length(sos[j].size());
+                    std::copy(sos[j].begin(), sos[j].end(), so.cont);
+                }
+            }
+            return SOs;
+        }
+    }
+
     bool to_pure = include_pure_transform_ && basis_->has_puream();
     bool from_cart = include_pure_transform_ || !basis_->has_puream();
 
@@ -1015,6 +1125,20 @@ PetiteList::compute_aotoso_info()
     }
     delete[] function_parities;
 
+    std::lock_guard<std::mutex> guard(info_->lock);
+    if (!info_->have_sos) {
+        info_->block_len.resize(nirrep_);
+        info_->sos.assign(nirrep_, std::vector<std::vector<contribution> >());
+        for (int h = 0; h < nirrep_; ++h) {
+            info_->block_len[h] = SOs[h].len;
+            for (size_t j = 0; j < functions_per_irrep[h]; ++j) {
+                const SO& so = SOs[h].so[j];
+                info_->sos[h].push_back(std::vector<contribution>(so.cont, so.cont + so.length));
+            }
+        }
+        info_->have_sos = true;
+    }
+
     return SOs;
 }
 
@@ -33,6 +33,7 @@
 #include "pointgrp.h"
 
 #include <map>
+#include <vector>
 #include <cstdio>
 #include <stdint.h>
 
@@ -177,7 +178,21 @@ class PetiteList
     unsigned short *stablizer_;
     int max_stablizer_;
 
+    /// What the petite lists of one symmetry share, see symmetry_key()
+    struct SymmetryInfo;
+    std::shared_ptr<SymmetryInfo> info_;
+
     void init(double tol=0.05);
+    /** Everything init() and compute_aotoso_info() work out depends only on
+     *  the point group, how its operations permute the atoms, and the shell
+     *  structure of the basis, not on the geometry itself. This is that, and
+     *  keys a process-wide cache, so the many petite lists of a job, and the
+     *  displaced geometries of a finite-difference run that share a
+     *  subgroup, compute it once.
+     */
+    std::vector<int> symmetry_key() const;
+    /// The cache entry for key, added empty if there is none
+    static std::shared_ptr<SymmetryInfo> cached_symmetry(const std::vector<int>& key);
 
 public:
     PetiteList(const std::shared_ptr<BasisSet>&, const std::shared_ptr<IntegralFactory>&, bool include_pure_transform = false);
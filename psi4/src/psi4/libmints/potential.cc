@@ -37,6 +37,12 @@
 #include "psi4/physconst.h"
 #include "typedefs.h"
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 #define VDEBUG 1
@@ -46,7 +52,7 @@ using namespace psi;
 
 // Initialize potential_recur_ to +1 basis set angular momentum
 PotentialInt::PotentialInt(std::vector<SphericalTransform>& st, std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, int deriv) :
-    OneBodyAOInt(st, bs1, bs2, deriv)
+    OneBodyAOInt(st, bs1, bs2, deriv), far_theta_(0.3), far_recur_(0)
 {
     if (deriv == 0)
         potential_recur_ = new ObaraSaikaTwoCenterVIRecursion(bs1->max_am()+1, bs2->max_am()+1);
@@ -95,6 +101,35 @@ PotentialInt::~PotentialInt()
 {
     delete[] buffer_;
     delete potential_recur_;
+    delete far_recur_;
+}
+
+void PotentialInt::set_far_field(std::shared_ptr<ChargeMultipoleTree> tree, double theta)
+{
+    far_field_ = tree;
+    far_theta_ = theta;
+    delete far_recur_;
+    far_recur_ = 0;
+    if (far_field_) {
+        // Moments up to order p about the pair center need p more units on center 1
+        far_recur_ = new ObaraSaikaTwoCenterRecursion(bs1_->max_am() + far_field_->order(), bs2_->max_am());
+        far_L_.resize(far_field_->nterm());
+    }
+}
+
+bool PotentialInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* PotentialInt::clone() const
+{
+    PotentialInt* pot = new PotentialInt(spherical_transforms_, bs1_, bs2_, deriv_);
+    copy_settings(pot);
+    // The charge field is only read, so the clones share it
+    pot->set_charge_field(Zxyz_);
+    pot->set_far_field(far_field_, far_theta_);
+    return pot;
 }
 
 // The engine only supports segmented basis sets
@@ -131,8 +166,36 @@ void PotentialInt::compute_pair(const GaussianShell& s1,
 
     double ***vi = potential_recur_->vi();
 
-    double** Zxyzp = Zxyz_->pointer();
-    int ncharge = Zxyz_->rowspi()[0];
+    // Charges as (Z,x,y,z) rows, and the ranges of them that are integrated exactly
+    const double* charges = Zxyz_->rowspi()[0] ? Zxyz_->pointer()[0] : 0;
+    near_.clear();
+    double E[3];
+    if (far_field_) {
+        charges = far_field_->charges();
+
+        // Expand about the midpoint, over a sphere holding every primitive product
+        double radius = 0.0;
+        for (int k=0; k<3; ++k)
+            E[k] = 0.5 * (A[k] + B[k]);
+        for (int p1=0; p1<nprim1; ++p1) {
+            for (int p2=0; p2<nprim2; ++p2) {
+                double a1 = s1.exp(p1);
+                double a2 = s2.exp(p2);
+                double oog = 1.0/(a1 + a2);
+                double PE2 = 0.0;
+                for (int k=0; k<3; ++k) {
+                    double PE = (a1*A[k] + a2*B[k])*oog - E[k];
+                    PE2 += PE * PE;
+                }
+                // exp(-gamma r^2) < 1E-11 beyond this distance
+                radius = MAX(radius, sqrt(PE2) + sqrt(25.0*oog));
+            }
+        }
+        std::fill(far_L_.begin(), far_L_.end(), 0.0);
+        far_field_->local_expansion(E, radius, far_theta_, far_L_.data(), near_);
+    } else {
+        near_.push_back(std::make_pair(0, Zxyz_->rowspi()[0]));
+    }
 
     for (int p1=0; p1<nprim1; ++p1) {
         double a1 = s1.exp(p1);
@@ -160,14 +223,16 @@ void PotentialInt::compute_pair(const GaussianShell& s1,
 
             // Loop over atoms of basis set 1 (only works if bs1_ and bs2_ are on the same
             // molecule)
-            for (int atom=0; atom<ncharge; ++atom) {
+            for (const std::pair<int,int>& range : near_) {
+            for (int atom=range.first; atom<range.first+range.second; ++atom) {
                 double PC[3];
+                const double* q = charges + 4L*atom;
 
-                double Z = Zxyzp[atom][0];
+                double Z = q[0];
 
-                PC[0] = P[0] - Zxyzp[atom][1];
-                PC[1] = P[1] - Zxyzp[atom][2];
-                PC[2] = P[2] - Zxyzp[atom][3];
+                PC[0] = P[0] - q[1];
+                PC[1] = P[1] - q[2];
+                PC[2] = P[2] - q[3];
 
                 // Do recursion
                 potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
@@ -197,6 +262,115 @@ void PotentialInt::compute_pair(const GaussianShell& s1,
                     }
                 }
             }
+            }
+        }
+    }
+
+    if (far_field_)
+        add_far_field(s1, s2, E);
+}
+
+void PotentialInt::add_far_field(const GaussianShell& s1, const GaussianShell& s2, const double E[3])
+{
+    int am1 = s1.am();
+    int am2 = s2.am();
+    int nprim1 = s1.nprimitive();
+    int nprim2 = s2.nprimitive();
+    int order = far_field_->order();
+    int nterm = far_field_->nterm();
+
+    double A[3], B[3], AE[3];
+    for (int k=0; k<3; ++k) {
+        A[k] = s1.center()[k];
+        B[k] = s2.center()[k];
+        AE[k] = A[k] - E[k];
+    }
+    double AB2 = 0.0;
+    AB2 += (A[0] - B[0]) * (A[0] - B[0]);
+    AB2 += (A[1] - B[1]) * (A[1] - B[1]);
+    AB2 += (A[2] - B[2]) * (A[2] - B[2]);
+
+    // Taylor coefficients of the far-field potential, phi(r) = sum_j W_j (r-E)^j
+    std::vector<double> W(nterm);
+    bool any = false;
+    for (int t=0; t<nterm; ++t) {
+        W[t] = far_L_[t] * far_field_->inv_fact(t);
+        if (W[t] != 0.0) any = true;
+    }
+    if (!any) return;
+
+    // Binomial coefficients and powers of A - E for (x-Ex)^k = sum_i (k i) AEx^(k-i) (x-Ax)^i
+    std::vector<std::vector<double> > binom(order+1, std::vector<double>(order+1, 0.0));
+    for (int k=0; k<=order; ++k) {
+        binom[k][0] = binom[k][k] = 1.0;
+        for (int i=1; i<k; ++i)
+            binom[k][i] = binom[k-1][i-1] + binom[k-1][i];
+    }
+    std::vector<double> AEpow(3*(order+1));
+    for (int k=0; k<3; ++k) {
+        AEpow[k*(order+1)] = 1.0;
+        for (int l=1; l<=order; ++l)
+            AEpow[k*(order+1)+l] = AEpow[k*(order+1)+l-1] * AE[k];
+    }
+
+    double **x = far_recur_->x();
+    double **y = far_recur_->y();
+    double **z = far_recur_->z();
+    std::vector<double> mx(order+1), my(order+1), mz(order+1);
+
+    for (int p1=0; p1<nprim1; ++p1) {
+        double a1 = s1.exp(p1);
+        double c1 = s1.coef(p1);
+        for (int p2=0; p2<nprim2; ++p2) {
+            double a2 = s2.exp(p2);
+            double c2 = s2.coef(p2);
+            double gamma = a1 + a2;
+            double oog = 1.0/gamma;
+
+            double PA[3], PB[3];
+            for (int k=0; k<3; ++k) {
+                double P = (a1*A[k] + a2*B[k])*oog;
+                PA[k] = P - A[k];
+                PB[k] = P - B[k];
+            }
+
+            double over_pf = exp(-a1*a2*AB2*oog) * sqrt(M_PI*oog) * M_PI * oog * c1 * c2;
+
+            far_recur_->compute(PA, PB, gamma, am1+order, am2);
+
+            int ao12 = 0;
+            for(int ii = 0; ii <= am1; ii++) {
+                int l1 = am1 - ii;
+                for(int jj = 0; jj <= ii; jj++) {
+                    int m1 = ii - jj;
+                    int n1 = jj;
+                    for(int kk = 0; kk <= am2; kk++) {
+                        int l2 = am2 - kk;
+                        for(int ll = 0; ll <= kk; ll++) {
+                            int m2 = kk - ll;
+                            int n2 = ll;
+
+                            // 1D moments about E
+                            for (int k=0; k<=order; ++k) {
+                                mx[k] = my[k] = mz[k] = 0.0;
+                                for (int i=0; i<=k; ++i) {
+                                    double c = binom[k][i];
+                                    mx[k] += c * AEpow[k-i] * x[l1+i][l2];
+                                    my[k] += c * AEpow[(order+1)+k-i] * y[m1+i][m2];
+                                    mz[k] += c * AEpow[2*(order+1)+k-i] * z[n1+i][n2];
+                                }
+                            }
+
+                            double val = 0.0;
+                            for (int t=0; t<nterm; ++t) {
+                                const int* k = far_field_->powers(t);
+                                val += W[t] * mx[k[0]] * my[k[1]] * mz[k[2]];
+                            }
+                            buffer_[ao12++] -= val * over_pf;
+                        }
+                    }
+                }
+            }
         }
     }
 }
@@ -786,24 +960,40 @@ void PotentialInt::compute_deriv1(std::vector<SharedMatrix > &result)
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
     int result_size = result.size();
-    int i_offset = 0;
-    double *location = 0;
 
     // Check the length of result, must be 3*natom_
     if (result.size() != (size_t)3*natom_)
         throw SanityCheckError("PotentialInt::compute_deriv1(result): result must be 3 * natom in length.", __FILE__, __LINE__);
 
+    std::vector<int> i_offsets(ns1 + 1, 0), j_offsets(ns2 + 1, 0);
+    for (int i=0; i<ns1; ++i)
+        i_offsets[i+1] = i_offsets[i] + (force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction());
+    for (int j=0; j<ns2; ++j)
+        j_offsets[j+1] = j_offsets[j] + (force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction());
+
+    // Every external charge contributes to each shell pair, so thread over rows
+    std::vector<OneBodyAOInt*> ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > clones;
+    int nthread = thread_ints(ints, clones);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i=0; i<ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset=0;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        PotentialInt* in = static_cast<PotentialInt*>(ints[thread]);
+        int ni = i_offsets[i+1] - i_offsets[i];
+        int i_offset = i_offsets[i];
         for (int j=0; j<ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+            int nj = j_offsets[j+1] - j_offsets[j];
+            int j_offset = j_offsets[j];
 
             // Compute the shell
-            compute_shell_deriv1(i, j);
+            in->compute_shell_deriv1(i, j);
 
             // For each integral that we got put in its contribution
-            location = buffer_;
+            const double *location = in->buffer_;
             for (int r=0; r<result_size; ++r) {
                 for (int p=0; p<ni; ++p) {
                     for (int q=0; q<nj; ++q) {
@@ -812,9 +1002,7 @@ void PotentialInt::compute_deriv1(std::vector<SharedMatrix > &result)
                     }
                 }
             }
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
@@ -845,24 +1033,40 @@ void PotentialInt::compute_deriv1_no_charge_term(std::vector<SharedMatrix > &res
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
     int result_size = result.size();
-    int i_offset = 0;
-    double *location = 0;
 
     // Check the length of result, must be 3*natom_
     if (result.size() != (size_t)3*natom_)
         throw SanityCheckError("PotentialInt::compute_deriv1(result): result must be 3 * natom in length.", __FILE__, __LINE__);
 
+    std::vector<int> i_offsets(ns1 + 1, 0), j_offsets(ns2 + 1, 0);
+    for (int i=0; i<ns1; ++i)
+        i_offsets[i+1] = i_offsets[i] + (force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction());
+    for (int j=0; j<ns2; ++j)
+        j_offsets[j+1] = j_offsets[j] + (force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction());
+
+    // Every external charge contributes to each shell pair, so thread over rows
+    std::vector<OneBodyAOInt*> ints;
+    std::vector<std::shared_ptr<OneBodyAOInt> > clones;
+    int nthread = thread_ints(ints, clones);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
     for (int i=0; i<ns1; ++i) {
-        int ni = force_cartesian_ ? bs1_->shell(i).ncartesian() : bs1_->shell(i).nfunction();
-        int j_offset=0;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        PotentialInt* in = static_cast<PotentialInt*>(ints[thread]);
+        int ni = i_offsets[i+1] - i_offsets[i];
+        int i_offset = i_offsets[i];
         for (int j=0; j<ns2; ++j) {
-            int nj = force_cartesian_ ? bs2_->shell(j).ncartesian() : bs2_->shell(j).nfunction();
+            int nj = j_offsets[j+1] - j_offsets[j];
+            int j_offset = j_offsets[j];
 
             // Compute the shell
-            compute_shell_deriv1_no_charge_term(i, j);
+            in->compute_shell_deriv1_no_charge_term(i, j);
 
             // For each integral that we got put in its contribution
-            location = buffer_;
+            const double *location = in->buffer_;
             for (int r=0; r<result_size; ++r) {
                 for (int p=0; p<ni; ++p) {
                     for (int q=0; q<nj; ++q) {
@@ -871,9 +1075,7 @@ void PotentialInt::compute_deriv1_no_charge_term(std::vector<SharedMatrix > &res
                     }
                 }
             }
-            j_offset += nj;
         }
-        i_offset += ni;
     }
 }
 
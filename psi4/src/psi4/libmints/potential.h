@@ -34,6 +34,7 @@
 #include "psi4/libmints/onebody.h"
 #include "psi4/libmints/sointegral_onebody.h"
 #include "psi4/libmints/osrecur.h"
+#include "psi4/libmints/chargetree.h"
 
 namespace psi {
     class BasisSet;
@@ -63,11 +64,28 @@ protected:
     /// Matrix of coordinates/charges of partial charges
     SharedMatrix Zxyz_;
 
+    /// Multipole tree of the charges, if the far field is expanded
+    std::shared_ptr<ChargeMultipoleTree> far_field_;
+    /// Separation criterion of the far field
+    double far_theta_;
+    /// Overlap recursion for the moments of a shell pair about its center
+    ObaraSaikaTwoCenterRecursion* far_recur_;
+    /// Local expansion and near-field charge ranges of the current shell pair
+    std::vector<double> far_L_;
+    std::vector<std::pair<int,int> > near_;
+
+    /// Adds -sum_j far_L_[j] / j! <a|(r-E)^j|b> to buffer_
+    void add_far_field(const GaussianShell&, const GaussianShell&, const double E[3]);
+
 public:
     /// Constructor. Assumes nuclear centers/charges as the potential
     PotentialInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv=0);
     virtual ~PotentialInt();
 
+    virtual bool cloneable() const;
+    /// Returns a new PotentialInt sharing this charge field
+    virtual OneBodyAOInt* clone() const;
+
     /// Computes the first derivatives and stores them in result
     virtual void compute_deriv1(std::vector<SharedMatrix > &result);
 
@@ -86,6 +104,16 @@ public:
     /// Get the field of charges
     SharedMatrix charge_field() const { return Zxyz_; }
 
+    /**
+     * Expand the potential of distant charges in multipoles.  For each shell
+     * pair, the nodes of tree that are well separated from the pair (sum of
+     * the radii < theta * distance) enter through a local expansion, and only
+     * the charges of the remaining leaves are integrated exactly.  The
+     * charges of tree replace the charge field in compute(); derivative
+     * integrals are always exact.  A null tree restores exact integrals.
+     */
+    void set_far_field(std::shared_ptr<ChargeMultipoleTree> tree, double theta = 0.3);
+
     /// Does the method provide first derivatives?
     bool has_deriv1() { return true; }
 };
@@ -32,7 +32,7 @@ namespace psi{
 
 PCMPotentialInt::PCMPotentialInt(std::vector<SphericalTransform>& trans,
 std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> /* bs2 */, int /* deriv */):
-    PotentialInt(trans, bs1, bs1)
+    PotentialInt(trans, bs1, bs1), screening_(0.0)
 {
     // We don't want to transform the integrals from Cartesian (6d, 10f, ...) to Pure (5d, 7f, ...)
     // for each external charge.  It'll be better to backtransform the density / Fock matrices to
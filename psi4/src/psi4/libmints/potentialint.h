@@ -36,6 +36,8 @@
 #include "psi4/libmints/osrecur.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <cmath>
+
 namespace psi{
 
 class GaussianShell;
@@ -57,9 +59,17 @@ class PCMPotentialInt : public PotentialInt
 {
 public:
     PCMPotentialInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv=0);
+    bool cloneable() const { return false; }
     /// Drives the loops over all shell pairs, to compute integrals
     template<typename PCMPotentialIntFunctor>
     void compute(PCMPotentialIntFunctor &functor);
+    /// Integrals of shells i and j over all charges; functions are numbered from bf1_offset and bf2_offset
+    template<typename PCMPotentialIntFunctor>
+    void compute_pair(int i, int j, int bf1_offset, int bf2_offset, PCMPotentialIntFunctor &functor);
+    /// Skip primitive pairs whose overlap-type prefactor falls below this bound (default 0, none)
+    void set_screening(double cutoff) { screening_ = cutoff; }
+protected:
+    double screening_;
 };
 
 template<typename PCMPotentialIntFunctor>
@@ -70,131 +80,137 @@ void PCMPotentialInt::compute(PCMPotentialIntFunctor &functor)
     int ns2 = bs2_->nshell();
     int bf1_offset = 0;
     for (int i=0; i<ns1; ++i) {
-        const GaussianShell& s1 = bs1_->shell(i);
-        int ni = s1.ncartesian();
+        int ni = bs1_->shell(i).ncartesian();
         int bf2_offset = 0;
         for (int j=0; j<ns2; ++j) {
-            const GaussianShell& s2 = bs2_->shell(j);
-            int nj = s2.ncartesian();
-            // Compute the shell
+            compute_pair(i, j, bf1_offset, bf2_offset, functor);
+            bf2_offset += bs2_->shell(j).ncartesian();
+        } // End loop over shell 2
+        bf1_offset += ni;
+    } // End loop over shell 1
+}
 
-            int ao12;
-            int am1 = s1.am();
-            int am2 = s2.am();
-            int nprim1 = s1.nprimitive();
-            int nprim2 = s2.nprimitive();
-            double A[3], B[3];
-            A[0] = s1.center()[0];
-            A[1] = s1.center()[1];
-            A[2] = s1.center()[2];
-            B[0] = s2.center()[0];
-            B[1] = s2.center()[1];
-            B[2] = s2.center()[2];
+template<typename PCMPotentialIntFunctor>
+void PCMPotentialInt::compute_pair(int i, int j, int bf1_offset, int bf2_offset, PCMPotentialIntFunctor &functor)
+{
+    const GaussianShell& s1 = bs1_->shell(i);
+    const GaussianShell& s2 = bs2_->shell(j);
+    // Compute the shell
 
-            int izm = 1;
-            int iym = am1 + 1;
-            int ixm = iym * iym;
-            int jzm = 1;
-            int jym = am2 + 1;
-            int jxm = jym * jym;
+    int ao12;
+    int am1 = s1.am();
+    int am2 = s2.am();
+    int nprim1 = s1.nprimitive();
+    int nprim2 = s2.nprimitive();
+    double A[3], B[3];
+    A[0] = s1.center()[0];
+    A[1] = s1.center()[1];
+    A[2] = s1.center()[2];
+    B[0] = s2.center()[0];
+    B[1] = s2.center()[1];
+    B[2] = s2.center()[2];
 
-            // compute intermediates
-            double AB2 = 0.0;
-            AB2 += (A[0] - B[0]) * (A[0] - B[0]);
-            AB2 += (A[1] - B[1]) * (A[1] - B[1]);
-            AB2 += (A[2] - B[2]) * (A[2] - B[2]);
+    int izm = 1;
+    int iym = am1 + 1;
+    int ixm = iym * iym;
+    int jzm = 1;
+    int jym = am2 + 1;
+    int jxm = jym * jym;
 
+    // compute intermediates
+    double AB2 = 0.0;
+    AB2 += (A[0] - B[0]) * (A[0] - B[0]);
+    AB2 += (A[1] - B[1]) * (A[1] - B[1]);
+    AB2 += (A[2] - B[2]) * (A[2] - B[2]);
 
-            double ***vi = potential_recur_->vi();
 
-            double** Zxyzp = Zxyz_->pointer();
-            int ncharge = Zxyz_->rowspi()[0];
+    double ***vi = potential_recur_->vi();
 
-            for (int atom=0; atom<ncharge; ++atom) {
-                memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
-                double PC[3];
+    double** Zxyzp = Zxyz_->pointer();
+    int ncharge = Zxyz_->rowspi()[0];
 
-                double Z = Zxyzp[atom][0];
+    for (int atom=0; atom<ncharge; ++atom) {
+        memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
+        double PC[3];
 
-                double C[3];
-                C[0] = Zxyzp[atom][1];
-                C[1] = Zxyzp[atom][2];
-                C[2] = Zxyzp[atom][3];
-                for (int p1=0; p1<nprim1; ++p1) {
-                    double a1 = s1.exp(p1);
-                    double c1 = s1.coef(p1);
-                    for (int p2=0; p2<nprim2; ++p2) {
-                        double a2 = s2.exp(p2);
-                        double c2 = s2.coef(p2);
-                        double gamma = a1 + a2;
-                        double oog = 1.0/gamma;
+        double Z = Zxyzp[atom][0];
 
-                        double PA[3], PB[3], P[3];
-                        P[0] = (a1*A[0] + a2*B[0])*oog;
-                        P[1] = (a1*A[1] + a2*B[1])*oog;
-                        P[2] = (a1*A[2] + a2*B[2])*oog;
-                        PA[0] = P[0] - A[0];
-                        PA[1] = P[1] - A[1];
-                        PA[2] = P[2] - A[2];
-                        PB[0] = P[0] - B[0];
-                        PB[1] = P[1] - B[1];
-                        PB[2] = P[2] - B[2];
-                        PC[0] = P[0] - C[0];
-                        PC[1] = P[1] - C[1];
-                        PC[2] = P[2] - C[2];
+        double C[3];
+        C[0] = Zxyzp[atom][1];
+        C[1] = Zxyzp[atom][2];
+        C[2] = Zxyzp[atom][3];
+        for (int p1=0; p1<nprim1; ++p1) {
+            double a1 = s1.exp(p1);
+            double c1 = s1.coef(p1);
+            for (int p2=0; p2<nprim2; ++p2) {
+                double a2 = s2.exp(p2);
+                double c2 = s2.coef(p2);
+                double gamma = a1 + a2;
+                double oog = 1.0/gamma;
 
-                        double over_pf = exp(-a1*a2*AB2*oog) * sqrt(M_PI*oog) * M_PI * oog * c1 * c2;
+                double PA[3], PB[3], P[3];
+                P[0] = (a1*A[0] + a2*B[0])*oog;
+                P[1] = (a1*A[1] + a2*B[1])*oog;
+                P[2] = (a1*A[2] + a2*B[2])*oog;
+                PA[0] = P[0] - A[0];
+                PA[1] = P[1] - A[1];
+                PA[2] = P[2] - A[2];
+                PB[0] = P[0] - B[0];
+                PB[1] = P[1] - B[1];
+                PB[2] = P[2] - B[2];
+                PC[0] = P[0] - C[0];
+                PC[1] = P[1] - C[1];
+                PC[2] = P[2] - C[2];
 
+                double over_pf = exp(-a1*a2*AB2*oog) * sqrt(M_PI*oog) * M_PI * oog * c1 * c2;
+                if (std::fabs(over_pf) < screening_) continue;
 
-                        // Do recursion
-                        potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
 
-                        ao12 = 0;
-                        for(int ii = 0; ii <= am1; ii++) {
-                            int l1 = am1 - ii;
-                            for(int jj = 0; jj <= ii; jj++) {
-                                int m1 = ii - jj;
-                                int n1 = jj;
-                                /*--- create all am components of sj ---*/
-                                for(int kk = 0; kk <= am2; kk++) {
-                                    int l2 = am2 - kk;
-                                    for(int ll = 0; ll <= kk; ll++) {
-                                        int m2 = kk - ll;
-                                        int n2 = ll;
+                // Do recursion
+                potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
 
-                                        // Compute location in the recursion and store the value
-                                        int iind = l1 * ixm + m1 * iym + n1 * izm;
-                                        int jind = l2 * jxm + m2 * jym + n2 * jzm;
-                                        buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
-                                    }
-                                }
-                            }
-                        }
-                    } // End loop over primitives of shell 2
-                } // End loop over primitives of shell 1
                 ao12 = 0;
-                int ao1 = 0;
                 for(int ii = 0; ii <= am1; ii++) {
+                    int l1 = am1 - ii;
                     for(int jj = 0; jj <= ii; jj++) {
+                        int m1 = ii - jj;
+                        int n1 = jj;
                         /*--- create all am components of sj ---*/
-                        int ao2 = 0;
                         for(int kk = 0; kk <= am2; kk++) {
+                            int l2 = am2 - kk;
                             for(int ll = 0; ll <= kk; ll++) {
-                                // Compute location in the recursion
-                                double val = buffer_[ao12++];
-                                // Hand the work off to the functor
-                                functor(ao1+bf1_offset, ao2+bf2_offset, atom, val);
-                                ao2++;
+                                int m2 = kk - ll;
+                                int n2 = ll;
+
+                                // Compute location in the recursion and store the value
+                                int iind = l1 * ixm + m1 * iym + n1 * izm;
+                                int jind = l2 * jxm + m2 * jym + n2 * jzm;
+                                buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
                             }
                         }
-                        ao1++;
                     }
                 }
-            } // End loop over points
-            bf2_offset += nj;
-        } // End loop over shell 2
-        bf1_offset += ni;
-    } // End loop over shell 1
+            } // End loop over primitives of shell 2
+        } // End loop over primitives of shell 1
+        ao12 = 0;
+        int ao1 = 0;
+        for(int ii = 0; ii <= am1; ii++) {
+            for(int jj = 0; jj <= ii; jj++) {
+                /*--- create all am components of sj ---*/
+                int ao2 = 0;
+                for(int kk = 0; kk <= am2; kk++) {
+                    for(int ll = 0; ll <= kk; ll++) {
+                        // Compute location in the recursion
+                        double val = buffer_[ao12++];
+                        // Hand the work off to the functor
+                        functor(ao1+bf1_offset, ao2+bf2_offset, atom, val);
+                        ao2++;
+                    }
+                }
+                ao1++;
+            }
+        }
+    } // End loop over points
 }
 
 class PrintIntegralsFunctor
@@ -57,6 +57,18 @@ QuadrupoleInt::~QuadrupoleInt()
     delete[] buffer_;
 }
 
+bool QuadrupoleInt::cloneable() const
+{
+    return true;
+}
+
+OneBodyAOInt* QuadrupoleInt::clone() const
+{
+    OneBodyAOInt* ints = new QuadrupoleInt(spherical_transforms_, bs1_, bs2_);
+    copy_settings(ints);
+    return ints;
+}
+
 SharedVector QuadrupoleInt::nuclear_contribution(std::shared_ptr<Molecule> mol, const Vector3 &origin)
 {
     std::shared_ptr<Vector> sret(new Vector(6));
@@ -54,6 +54,10 @@ public:
     QuadrupoleInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>);
     virtual ~QuadrupoleInt();
 
+        virtual bool cloneable() const;
+    /// Returns a new QuadrupoleInt with the same origin and settings
+    virtual OneBodyAOInt* clone() const;
+
     static SharedVector nuclear_contribution(std::shared_ptr<Molecule> mol, const Vector3 &origin);
 
 };
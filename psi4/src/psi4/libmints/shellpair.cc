@@ -0,0 +1,123 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+#include "psi4/libmints/shellpair.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libmints/vector3.h"
+
+#include <cmath>
+
+namespace psi {
+
+ShellPairStore::ShellPairStore(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
+                               double cutoff) :
+    nshell1_(bs1->nshell()), nshell2_(bs2->nshell()), cutoff_(cutoff), nprim_total_(0)
+{
+    size_t npair = (size_t) nshell1_ * nshell2_;
+    size_t maxprim = 0;
+    for (int P = 0; P < nshell1_; ++P)
+        for (int Q = 0; Q < nshell2_; ++Q)
+            maxprim += (size_t) bs1->shell(P).nprimitive() * bs2->shell(Q).nprimitive();
+
+    std::vector<double> *fields[] = {&ai_, &aj_, &gamma_, &overlap_, &Px_, &Py_, &Pz_,
+                                     &PAx_, &PAy_, &PAz_, &PBx_, &PBy_, &PBz_};
+    for (std::vector<double> *field : fields)
+        field->reserve(maxprim);
+    offset_.reserve(npair + 1);
+    offset_.push_back(0);
+
+    for (int P = 0; P < nshell1_; ++P) {
+        const GaussianShell &s1 = bs1->shell(P);
+        Vector3 A = s1.center();
+        for (int Q = 0; Q < nshell2_; ++Q) {
+            const GaussianShell &s2 = bs2->shell(Q);
+            Vector3 B = s2.center();
+            Vector3 AB = A - B;
+            double ab2 = AB.dot(AB);
+
+            int np1 = s1.nprimitive();
+            int np2 = s2.nprimitive();
+            nprim_total_ += (size_t) np1 * np2;
+
+            // Screen on the overlap, keeping the largest pair as a fallback
+            size_t kept = 0;
+            double smax = -1.0;
+            int imax = 0, jmax = 0;
+            for (int run = 0; run < 2 && !kept; ++run) {
+                for (int i = 0; i < np1; ++i) {
+                    double a1 = s1.exp(i);
+                    double c1 = s1.coef(i);
+                    for (int j = 0; j < np2; ++j) {
+                        double a2 = s2.exp(j);
+                        double c2 = s2.coef(j);
+                        double gam = a1 + a2;
+                        double S = pow(M_PI / gam, 3.0 / 2.0) * exp(-a1 * a2 * ab2 / gam) * c1 * c2;
+                        if (run == 0) {
+                            if (std::fabs(S) > smax) {
+                                smax = std::fabs(S);
+                                imax = i;
+                                jmax = j;
+                            }
+                            if (std::fabs(S) < cutoff_) continue;
+                        } else if (i != imax || j != jmax) {
+                            continue;
+                        }
+
+                        // Gaussian product and component distances
+                        Vector3 Pc = (A * a1 + B * a2) / gam;
+                        Vector3 PA = Pc - A;
+                        Vector3 PB = Pc - B;
+
+                        ai_.push_back(a1);
+                        aj_.push_back(a2);
+                        gamma_.push_back(gam);
+                        overlap_.push_back(S);
+                        Px_.push_back(Pc[0]);
+                        Py_.push_back(Pc[1]);
+                        Pz_.push_back(Pc[2]);
+                        PAx_.push_back(PA[0]);
+                        PAy_.push_back(PA[1]);
+                        PAz_.push_back(PA[2]);
+                        PBx_.push_back(PB[0]);
+                        PBy_.push_back(PB[1]);
+                        PBz_.push_back(PB[2]);
+                        kept++;
+                    }
+                }
+            }
+            offset_.push_back(offset_.back() + kept);
+        }
+    }
+
+    for (std::vector<double> *field : fields)
+        field->shrink_to_fit();
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_shellpair_h_
+#define _psi_src_lib_libmints_shellpair_h_
+
+#include <vector>
+#include <memory>
+
+namespace psi {
+
+class BasisSet;
+
+/**
+  * \ingroup MINTS
+  * View of the screened primitive pairs of one shell pair in a ShellPairStore.
+  * Each pointer addresses nprim consecutive values.
+  */
+struct PrimitivePairs {
+    //! Number of primitive pairs kept after screening
+    int nprim;
+    //! Exponents on the first and second center
+    const double *ai, *aj;
+    //! The gammas (ai + aj)
+    const double *gamma;
+    //! Overlap between the primitives, including the contraction coefficients
+    const double *overlap;
+    //! x, y, z coordinates of the Gaussian product center
+    const double *Px, *Py, *Pz;
+    //! Distance between P and the first center
+    const double *PAx, *PAy, *PAz;
+    //! Distance between P and the second center
+    const double *PBx, *PBy, *PBz;
+};
+
+/*! \ingroup MINTS
+ *  \class ShellPairStore
+ *  \brief Precomputed primitive pair data for all shell pairs of two basis sets.
+ *
+ *  The Gaussian product data of every (ij| is computed once and laid out
+ *  field by field, so the primitive pairs of a shell pair are contiguous in
+ *  each array.  Primitive pairs whose overlap falls below the cutoff are
+ *  dropped, but every shell pair keeps at least its largest one.  The store
+ *  is read-only after construction, so one instance is shared by all the
+ *  integral objects (and threads) created from an IntegralFactory.
+ */
+class ShellPairStore
+{
+protected:
+    int nshell1_, nshell2_;
+    double cutoff_;
+
+    //! Offset of the first primitive pair of shell pair PQ, size nshell1*nshell2+1
+    std::vector<size_t> offset_;
+
+    std::vector<double> ai_, aj_, gamma_, overlap_;
+    std::vector<double> Px_, Py_, Pz_;
+    std::vector<double> PAx_, PAy_, PAz_;
+    std::vector<double> PBx_, PBy_, PBz_;
+
+    //! Primitive pairs before screening
+    size_t nprim_total_;
+
+public:
+    ShellPairStore(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
+                   double cutoff = 1.0E-15);
+
+    //! The screened primitive pairs of shell pair (P, Q)
+    PrimitivePairs pair(int P, int Q) const {
+        size_t PQ = (size_t) P * nshell2_ + Q;
+        size_t off = offset_[PQ];
+        PrimitivePairs block;
+        block.nprim = (int) (offset_[PQ + 1] - off);
+        block.ai = &ai_[off];
+        block.aj = &aj_[off];
+        block.gamma = &gamma_[off];
+        block.overlap = &overlap_[off];
+        block.Px = &Px_[off];
+        block.Py = &Py_[off];
+        block.Pz = &Pz_[off];
+        block.PAx = &PAx_[off];
+        block.PAy = &PAy_[off];
+        block.PAz = &PAz_[off];
+        block.PBx = &PBx_[off];
+        block.PBy = &PBy_[off];
+        block.PBz = &PBz_[off];
+        return block;
+    }
+
+    //! Overlap cutoff used to drop primitive pairs
+    double cutoff() const { return cutoff_; }
+    //! Number of primitive pairs kept
+    size_t nprim_kept() const { return offset_.back(); }
+    //! Number of primitive pairs before screening
+    size_t nprim_total() const { return nprim_total_; }
+    //! Memory held by the store, in doubles
+    size_t memory() const { return 13 * offset_.back() + offset_.size(); }
+};
+
+}
+
+#endif
@@ -32,10 +32,17 @@
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
 #include <cfloat>
+#include <map>
+#include <mutex>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
@@ -63,11 +70,21 @@ void ERISieve::common_init()
     do_qqr_ = false; // Code below for QQR was/is utterly broken.
 
     debug_ = 0;
+    has_density_ = false;
 
+    omega_ = 0.0;
     integrals();
+    erf_shell_pair_values_ = shell_pair_values_;
     set_sieve(sieve_);
 }
 
+void ERISieve::set_omega(double omega)
+{
+    omega_ = omega;
+    erf_diagonal_ = compute_diagonal(primary_, omega);
+    erf_shell_pair_values_ = erf_diagonal_->shell_pair_values.data();
+}
+
 void ERISieve::set_sieve(double sieve)
 {
     sieve_ = sieve;
@@ -113,6 +130,8 @@ void ERISieve::set_sieve(double sieve)
     shell_to_shell_.resize(nshell_);
     function_to_function_.resize(nbf_);
 
+    // Rows are independent
+#pragma omp parallel for schedule(dynamic, 16)
     for (int MU = 0; MU < nshell_; MU++) {
         for (int NU = 0; NU < nshell_; NU++) {
             if (shell_pair_values_[MU * (size_t) nshell_ + NU] >= sieve2_over_max_) {
@@ -121,6 +140,7 @@ void ERISieve::set_sieve(double sieve)
         }
     }
 
+#pragma omp parallel for schedule(dynamic, 64)
     for (int mu = 0; mu < nbf_; mu++) {
         for (int nu = 0; nu < nbf_; nu++) {
             if (function_pair_values_[mu * (size_t) nbf_ + nu] >= sieve2_over_max_) {
@@ -203,48 +223,62 @@ void ERISieve::set_sieve(double sieve)
 
 }
 
-void ERISieve::integrals()
+void ERISieve::set_density(const std::vector<SharedMatrix>& D)
 {
-    int nshell = primary_->nshell();
-    int nbf = primary_->nbf();
-
-    nbf_ = nbf;
-    nshell_ = nshell;
-
-    function_pair_values_.resize(nbf * (size_t) nbf);
-    shell_pair_values_.resize(nshell * (size_t) nshell);
-    ::memset(&function_pair_values_[0], '\0', sizeof(double) * nbf * nbf);
-    ::memset(&shell_pair_values_[0], '\0', sizeof(double) * nshell * nshell);
-    max_ = 0.0;
+    shell_pair_density_.assign(nshell_ * (size_t) nshell_, 0.0);
+    function_pair_density_.assign(nbf_ * (size_t) nbf_, 0.0);
 
-    IntegralFactory schwarzfactory(primary_, primary_, primary_, primary_);
-    std::shared_ptr <TwoBodyAOInt> eri = std::shared_ptr<TwoBodyAOInt>(schwarzfactory.eri());
-    const double *buffer = eri->buffer();
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        if (D[ind]->nirrep() != 1 || D[ind]->rowdim() != nbf_ || D[ind]->coldim() != nbf_) {
+            throw PSIEXCEPTION("ERISieve::set_density: densities must be C1 and nbf x nbf.");
+        }
+        double** Dp = D[ind]->pointer();
+        for (int m = 0; m < nbf_; m++) {
+            for (int n = 0; n <= m; n++) {
+                double val = std::max(std::fabs(Dp[m][n]), std::fabs(Dp[n][m]));
+                double& Dmn = function_pair_density_[m * (size_t) nbf_ + n];
+                Dmn = std::max(Dmn, val);
+                function_pair_density_[n * (size_t) nbf_ + m] = Dmn;
+            }
+        }
+    }
 
-    for (int P = 0; P < nshell_; P++) {
-        for (int Q = 0; Q <= P; Q++) {
-            int nP = primary_->shell(P).nfunction();
-            int nQ = primary_->shell(Q).nfunction();
-            int oP = primary_->shell(P).function_index();
-            int oQ = primary_->shell(Q).function_index();
-            eri->compute_shell(P, Q, P, Q);
+    for (int M = 0; M < nshell_; M++) {
+        int nM = primary_->shell(M).nfunction();
+        int oM = primary_->shell(M).function_index();
+        for (int N = 0; N <= M; N++) {
+            int nN = primary_->shell(N).nfunction();
+            int oN = primary_->shell(N).function_index();
             double max_val = 0.0;
-            for (int p = 0; p < nP; p++) {
-                for (int q = 0; q < nQ; q++) {
-                    max_val = std::max(max_val, std::fabs(buffer[p * (nQ * nP * nQ + nQ) + q * (nP * nQ + 1)]));
-                }
-            }
-            max_ = std::max(max_, max_val);
-            shell_pair_values_[P * nshell_ + Q] = shell_pair_values_[Q * nshell_ + P] = max_val;
-            for (int p = 0; p < nP; p++) {
-                for (int q = 0; q < nQ; q++) {
-                    function_pair_values_[(p + oP) * nbf_ + (q + oQ)] =
-                    function_pair_values_[(q + oQ) * nbf_ + (p + oP)] = max_val;
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    max_val = std::max(max_val, function_pair_density_[(m + oM) * (size_t) nbf_ + (n + oN)]);
                 }
             }
+            shell_pair_density_[M * (size_t) nshell_ + N] = shell_pair_density_[N * (size_t) nshell_ + M] = max_val;
         }
     }
 
+    has_density_ = true;
+}
+
+void ERISieve::clear_density()
+{
+    has_density_ = false;
+    shell_pair_density_.clear();
+    function_pair_density_.clear();
+}
+
+void ERISieve::integrals()
+{
+    nbf_ = primary_->nbf();
+    nshell_ = primary_->nshell();
+
+    diagonal_ = shared_diagonal(primary_);
+    function_pair_values_ = diagonal_->function_pair_values.data();
+    shell_pair_values_ = diagonal_->shell_pair_values.data();
+    max_ = diagonal_->max;
+
     // All this is broken (only built one shell-pair's info)
 #if 0
     if (do_qqr_) {
@@ -343,6 +377,97 @@ bool ERISieve::shell_significant_qqr(int M, int N, int R, int S)
 }
 
 
+std::shared_ptr<const ERISieve::Diagonal> ERISieve::shared_diagonal(std::shared_ptr<BasisSet> primary)
+{
+    // Keyed by address; an entry is dropped once its basis or its last sieve is gone,
+    // so an address reused by a new basis never finds stale integrals
+    struct Entry {
+        std::weak_ptr<BasisSet> basis;
+        std::weak_ptr<const Diagonal> diagonal;
+    };
+    static std::mutex lock;
+    static std::map<const BasisSet*, Entry> cache;
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.basis.expired() || it->second.diagonal.expired()) {
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto it = cache.find(primary.get());
+    if (it != cache.end()) {
+        std::shared_ptr<const Diagonal> diagonal = it->second.diagonal.lock();
+        if (diagonal) return diagonal;
+    }
+
+    std::shared_ptr<const Diagonal> diagonal = compute_diagonal(primary);
+    cache[primary.get()] = Entry{primary, diagonal};
+    return diagonal;
+}
+
+std::shared_ptr<const ERISieve::Diagonal> ERISieve::compute_diagonal(std::shared_ptr<BasisSet> primary, double omega)
+{
+    int nshell = primary->nshell();
+    int nbf = primary->nbf();
+
+    std::shared_ptr<Diagonal> diagonal = std::make_shared<Diagonal>();
+    diagonal->function_pair_values.assign(nbf * (size_t) nbf, 0.0);
+    diagonal->shell_pair_values.assign(nshell * (size_t) nshell, 0.0);
+    double* fvals = diagonal->function_pair_values.data();
+    double* svals = diagonal->shell_pair_values.data();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    IntegralFactory schwarzfactory(primary, primary, primary, primary);
+    std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+    for (int thread = 0; thread < nthread; thread++) {
+        eri.push_back(std::shared_ptr<TwoBodyAOInt>(omega > 0.0 ? schwarzfactory.erf_eri(omega) : schwarzfactory.eri()));
+    }
+
+    // Each (P,Q) writes only its own blocks, and the rows grow with P
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int P = nshell - 1; P >= 0; P--) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = eri[thread]->buffer();
+        int nP = primary->shell(P).nfunction();
+        int oP = primary->shell(P).function_index();
+        for (int Q = 0; Q <= P; Q++) {
+            int nQ = primary->shell(Q).nfunction();
+            int oQ = primary->shell(Q).function_index();
+            eri[thread]->compute_shell(P, Q, P, Q);
+            double max_val = 0.0;
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) {
+                    max_val = std::max(max_val, std::fabs(buffer[p * (nQ * nP * nQ + nQ) + q * (nP * nQ + 1)]));
+                }
+            }
+            svals[P * (size_t) nshell + Q] = svals[Q * (size_t) nshell + P] = max_val;
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) {
+                    fvals[(p + oP) * (size_t) nbf + (q + oQ)] =
+                    fvals[(q + oQ) * (size_t) nbf + (p + oP)] = max_val;
+                }
+            }
+        }
+    }
+
+    diagonal->max = 0.0;
+    for (size_t PQ = 0; PQ < nshell * (size_t) nshell; PQ++) {
+        diagonal->max = std::max(diagonal->max, svals[PQ]);
+    }
+
+    return diagonal;
+}
+
 double ERISieve::shell_pair_value(int m, int n) const
 {
 
@@ -32,9 +32,11 @@
 // need this for erfc^{-1} in the QQR sieve
 //#include <cfloat>
 #include <vector>
+#include <algorithm>
 #include <memory>
 //#include <utility>
 #include "psi4/libmints/vector3.h"
+#include "psi4/libmints/typedefs.h"
 
 namespace psi {
 
@@ -55,6 +57,10 @@ class BasisSet;
  *     // Initialize the sieve object
  *     std::shared_ptr<ERISieve> sieve(basisset, sieve_cutoff);
  *
+ *     // The (MN|MN) integrals are computed once per basis set (threaded) and
+ *     // shared by every sieve of that basis while any of them is alive, so
+ *     // building one per consumer and cutoff is cheap
+ *
  *     // Reset the sieve cutoff (you can do this wherever)
  *     sieve->set_sieve(new_cutoff);
  *
@@ -71,6 +77,11 @@ class BasisSet;
  *     if (sieve->shell_ceiling2(M,N,R,S) * D_RS * D_RS >= sieve_cutoff * sieve_cutoff)
  *         eri->compute(M,N,R,S);
  *
+ *     // Or let the sieve do the density weighting for J/K builds
+ *     // (D is a vector of C1 AO densities, stored until clear_density())
+ *     sieve->set_density(D);
+ *     if (sieve->shell_significant_density(M,N,R,S)) eri->compute(M,N,R,S);
+ *
  *     // Index the significant MN shell pairs (triangular M,N)
  *     const std::vector<std::pair<int,int> >& MN = sieve->shell_pairs();
  *     for (long int index = 0L; index < MN.size(); ++index) {
@@ -117,10 +128,28 @@ protected:
     /// sieve_ * sieve_ / max_
     double sieve2_over_max_;
 
-    /// |(mn|mn)| values (nbf * nbf)
-    std::vector<double> function_pair_values_;
-    /// max |(MN|MN)| values (nshell * nshell)
-    std::vector<double> shell_pair_values_;
+    /// The cutoff-independent part of a sieve
+    struct Diagonal {
+        /// Maximum |(mn|ls)|
+        double max;
+        /// |(mn|mn)| values (nbf * nbf)
+        std::vector<double> function_pair_values;
+        /// max |(MN|MN)| values (nshell * nshell)
+        std::vector<double> shell_pair_values;
+    };
+    /// Diagonal integrals of primary_, shared with the other sieves of primary_
+    std::shared_ptr<const Diagonal> diagonal_;
+    /// |(mn|mn)| values (nbf * nbf), in diagonal_
+    const double* function_pair_values_;
+    /// max |(MN|MN)| values (nshell * nshell), in diagonal_
+    const double* shell_pair_values_;
+
+    /// Range-separation parameter of erf_diagonal_ (0.0 if none)
+    double omega_;
+    /// Diagonal integrals of erf(omega_ r)/r, if set_omega() was called
+    std::shared_ptr<const Diagonal> erf_diagonal_;
+    /// max |(MN|erf|MN)| values (nshell * nshell), in erf_diagonal_, or shell_pair_values_
+    const double* erf_shell_pair_values_;
 
     /// Significant unique bra- function pairs, in reduced triangular indexing
     std::vector<std::pair<int,int> > function_pairs_;
@@ -135,6 +164,13 @@ protected:
     /// Significant shell pairs, indexes by shell
     std::vector<std::vector<int> > function_to_function_;
 
+    /// Has a density been provided through set_density()?
+    bool has_density_;
+    /// max |D_mn| over the MN shell pair block and all densities (nshell * nshell)
+    std::vector<double> shell_pair_density_;
+    /// max |D_mn| over all densities (nbf * nbf)
+    std::vector<double> function_pair_density_;
+
   ///////////////////////////////////////
   // adding stuff for QQR sieves
 
@@ -163,8 +199,12 @@ protected:
 
     /// Set initial indexing
     void common_init();
-    /// Compute sieve integrals (only done once)
+    /// Get the sieve integrals, computing them if no other sieve of primary_ holds them
     void integrals();
+    /// The diagonal integrals of primary, from the process-wide cache
+    static std::shared_ptr<const Diagonal> shared_diagonal(std::shared_ptr<BasisSet> primary);
+    /// Compute the (MN|MN) integrals of primary, threaded over shell pairs (erf-attenuated if omega > 0)
+    static std::shared_ptr<const Diagonal> compute_diagonal(std::shared_ptr<BasisSet> primary, double omega = 0.0);
 
 public:
 
@@ -227,6 +267,82 @@ public:
     inline bool function_pair_significant(int m, int n) {
         return function_pair_values_[m * (size_t) nbf_ + n] *
                max_ >= sieve2_; }
+
+    // => Density-Weighted Significance Checks <= //
+
+    /**
+     * Set the densities used for density-weighted sieving. The
+     * maximum |D_mn| over each shell pair block (and over all
+     * densities) is stored, so D may be changed after this call.
+     * @param D C1 AO densities (nbf x nbf)
+     */
+    void set_density(const std::vector<SharedMatrix>& D);
+    /// Discard the density, density-weighted checks fall back to Schwarz checks
+    void clear_density();
+    /// Has a density been set?
+    bool has_density() const { return has_density_; }
+
+    /// max |D_mn| over shell pair block MN (no restriction on MN order)
+    inline double shell_pair_density(int M, int N) const {
+        return shell_pair_density_[M * (size_t) nshell_ + N]; }
+
+    /**
+     * Is the shell quartet (MN|RS) significant to a J or K build with
+     * the current density? (no restriction on MNRS order)
+     * The J terms involve D_MN and D_RS, the K terms D_MR, D_MS, D_NR, and D_NS
+     */
+    inline bool shell_significant_density(int M, int N, int R, int S) const {
+        if (!has_density_) {
+            return shell_pair_values_[N * (size_t) nshell_ + M] *
+                   shell_pair_values_[R * (size_t) nshell_ + S] >= sieve2_;
+        }
+        double D2 = 4.0 * std::max(shell_pair_density_[M * (size_t) nshell_ + N],
+                                   shell_pair_density_[R * (size_t) nshell_ + S]);
+        D2 = std::max(D2, shell_pair_density_[M * (size_t) nshell_ + R]);
+        D2 = std::max(D2, shell_pair_density_[M * (size_t) nshell_ + S]);
+        D2 = std::max(D2, shell_pair_density_[N * (size_t) nshell_ + R]);
+        D2 = std::max(D2, shell_pair_density_[N * (size_t) nshell_ + S]);
+        D2 *= D2;
+        return shell_pair_values_[N * (size_t) nshell_ + M] *
+               shell_pair_values_[R * (size_t) nshell_ + S] * D2 >= sieve2_; }
+
+    /**
+     * Can the function pair mn contribute to a Coulomb contraction
+     * sum_mn (ls|mn) D_mn with the current density? (no restriction on mn order)
+     */
+    inline bool function_pair_significant_density(int m, int n) const {
+        if (!has_density_) {
+            return function_pair_values_[m * (size_t) nbf_ + n] * max_ >= sieve2_;
+        }
+        double D = function_pair_density_[m * (size_t) nbf_ + n];
+        return function_pair_values_[m * (size_t) nbf_ + n] * max_ * D * D >= sieve2_; }
+
+    // => Long-Range Significance Checks <= //
+
+    /**
+     * Compute the diagonals max |(MN|erf(omega r)/r|MN)|, the Schwarz bounds of the
+     * long-range operator, for screening range-separated exchange on its own. These
+     * never exceed the Coulomb ones. (The QQR extents built on erfc_thresh_ remain off.)
+     */
+    void set_omega(double omega);
+    /// Range-separation parameter of the long-range bounds, 0.0 if set_omega() was not called
+    double omega() const { return omega_; }
+
+    /**
+     * Is the shell quartet (MN|erf|RS) significant? With a density set, it is weighted
+     * by the K terms D_MR, D_MS, D_NR, and D_NS only. Without set_omega(), this is the
+     * Coulomb bound. (no restriction on MNRS order)
+     */
+    inline bool shell_significant_erf(int M, int N, int R, int S) const {
+        double bound = erf_shell_pair_values_[N * (size_t) nshell_ + M] *
+                       erf_shell_pair_values_[R * (size_t) nshell_ + S];
+        if (!has_density_) return bound >= sieve2_;
+        double D = std::max(shell_pair_density_[M * (size_t) nshell_ + R],
+                            shell_pair_density_[M * (size_t) nshell_ + S]);
+        D = std::max(D, shell_pair_density_[N * (size_t) nshell_ + R]);
+        D = std::max(D, shell_pair_density_[N * (size_t) nshell_ + S]);
+        return bound * D * D >= sieve2_; }
+
     // => Indexing [these change after a call to sieve()] <= //
 
     /// Significant unique bra- function pairs, in reduced triangular indexing
@@ -247,9 +363,9 @@ public:
     // just return the value of the bound for pair m and n
     double shell_pair_value(int m, int n) const;
     // return the vector of
-    std::vector<double> shell_pair_values() { return shell_pair_values_;}
+    std::vector<double> shell_pair_values() { return diagonal_->shell_pair_values;}
     // return the vector of function pairs
-    std::vector<double> function_pair_values() {return function_pair_values_;}
+    std::vector<double> function_pair_values() {return diagonal_->function_pair_values;}
 
     /// Set debug flag (defaults to 0)
     void set_debug(int debug) { debug_ = debug; }
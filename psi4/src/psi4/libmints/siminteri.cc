@@ -438,6 +438,95 @@ SimintTwoElectronInt::compute_shell_blocks(int shellpair1, int shellpair2,
     }
 }
 
+size_t SimintTwoElectronInt::compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out)
+{
+    double* start = out;
+    const auto nsh2 = original_bs2_->nshell();
+    std::vector<simint_shell> ket_shells;
+
+    size_t first = 0;
+    while(first < quartets.size())
+    {
+        // A run shares the bra pair and the ket angular momenta, so that
+        // simint can compute all of its kets in one vectorized call
+        const auto & q0 = quartets[first];
+        const int am3 = original_bs3_->shell(q0[2]).am();
+        const int am4 = original_bs4_->shell(q0[3]).am();
+        size_t last = first + 1;
+        while(last < quartets.size() && last - first < batchsize_ &&
+              quartets[last][0] == q0[0] && quartets[last][1] == q0[1] &&
+              original_bs3_->shell(quartets[last][2]).am() == am3 &&
+              original_bs4_->shell(quartets[last][3]).am() == am4)
+            last++;
+
+        const size_t nrun = last - first;
+        if(nrun == 1)
+        {
+            // No batching to be had; skip building a multi shell pair
+            const size_t n1234 = quartet_size(q0[0], q0[1], q0[2], q0[3]);
+            if(compute_shell(q0[0], q0[1], q0[2], q0[3]))
+                ::memcpy(out, target_full_, sizeof(double) * n1234);
+            else
+                ::memset(out, 0, sizeof(double) * n1234);
+            out += n1234;
+            first = last;
+            continue;
+        }
+
+        const auto & shell1 = original_bs1_->shell(q0[0]);
+        const auto & shell2 = original_bs2_->shell(q0[1]);
+        const auto & shell3 = original_bs3_->shell(q0[2]);
+        const auto & shell4 = original_bs4_->shell(q0[3]);
+
+        bool do_cart = force_cartesian_ || (shell1.is_cartesian() &&
+                                            shell2.is_cartesian() &&
+                                            shell3.is_cartesian() &&
+                                            shell4.is_cartesian());
+
+        const size_t ncart1234 = (size_t) shell1.ncartesian() * shell2.ncartesian() *
+                                 shell3.ncartesian() * shell4.ncartesian();
+        const size_t n1234 = quartet_size(q0[0], q0[1], q0[2], q0[3]);
+        curr_buff_size_ = n1234;
+
+        // copying simint shells copies the pointers, which is fine as long
+        // as the shell pair does not outlive them
+        ket_shells.clear();
+        for(size_t i = first; i < last; i++)
+        {
+            ket_shells.push_back((*shells3_)[quartets[i][2]]);
+            ket_shells.push_back((*shells4_)[quartets[i][3]]);
+        }
+        simint_multi_shellpair Q;
+        simint_initialize_multi_shellpair(&Q);
+        simint_create_multi_shellpair2(nrun, ket_shells.data(), &Q, SIMINT_SCREEN);
+
+        const simint_multi_shellpair * P = &(*single_spairs_bra_)[q0[0]*nsh2 + q0[1]];
+
+        // Cartesian results go straight to the caller; otherwise each quartet
+        // is transformed from source_ into its slot of out
+        if(do_cart)
+            simint_compute_eri(P, &Q, SIMINT_SCREEN_TOL, sharedwork_, out);
+        else
+        {
+            simint_compute_eri(P, &Q, SIMINT_SCREEN_TOL, sharedwork_, source_full_);
+            for(size_t i = first; i < last; i++)
+            {
+                source_ = source_full_ + (i - first) * ncart1234;
+                target_ = out + (i - first) * n1234;
+                pure_transform(q0[0], q0[1], quartets[i][2], quartets[i][3], 1, false);
+            }
+            source_ = source_full_;
+            target_ = target_full_;
+        }
+        simint_free_multi_shellpair(&Q);
+
+        out += nrun * n1234;
+        first = last;
+    }
+
+    return out - start;
+}
+
 void SimintTwoElectronInt::create_blocks(void)
 {
     blocks12_.clear();
@@ -53,6 +53,8 @@ class SimintTwoElectronInt : public TwoBodyAOInt
         compute_shell_blocks(int shellpair1, int shellpair2,
                              int npair1 = -1, int npair2 = -1) override;
 
+        virtual size_t compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out) override;
+
         virtual size_t compute_shell_deriv1(int, int, int, int);
 
         virtual size_t compute_shell_deriv2(int, int, int, int);
@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <cstring>
 #include <stdexcept>
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/twobody.h"
@@ -213,6 +214,38 @@ void TwoBodyAOInt::compute_shell_blocks(int shellpair12, int shellpair34,
     }
 }
 
+size_t TwoBodyAOInt::quartet_size(int sh1, int sh2, int sh3, int sh4) const
+{
+    if (force_cartesian_)
+        return (size_t) original_bs1_->shell(sh1).ncartesian() * original_bs2_->shell(sh2).ncartesian() *
+               original_bs3_->shell(sh3).ncartesian() * original_bs4_->shell(sh4).ncartesian();
+    return (size_t) original_bs1_->shell(sh1).nfunction() * original_bs2_->shell(sh2).nfunction() *
+           original_bs3_->shell(sh3).nfunction() * original_bs4_->shell(sh4).nfunction();
+}
+
+size_t TwoBodyAOInt::batch_size(const std::vector<ShellQuartet>& quartets) const
+{
+    size_t size = 0;
+    for (const auto& q : quartets)
+        size += quartet_size(q[0], q[1], q[2], q[3]);
+    return size;
+}
+
+size_t TwoBodyAOInt::compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out)
+{
+    // Default implementation - one quartet at a time, copied out of buffer()
+    double* start = out;
+    for (const auto& q : quartets) {
+        size_t n1234 = quartet_size(q[0], q[1], q[2], q[3]);
+        if (compute_shell(q[0], q[1], q[2], q[3]))
+            ::memcpy(out, target_full_, sizeof(double) * n1234);
+        else
+            ::memset(out, 0, sizeof(double) * n1234);
+        out += n1234;
+    }
+    return out - start;
+}
+
 void TwoBodyAOInt::normalize_am(std::shared_ptr<GaussianShell> s1, std::shared_ptr<GaussianShell> s2, std::shared_ptr<GaussianShell> s3, std::shared_ptr<GaussianShell> s4, int nchunk)
 {
     // Integrals assume this normalization is 1.0.
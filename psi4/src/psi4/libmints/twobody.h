@@ -31,6 +31,7 @@
 
 #include "psi4/pragma.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -48,6 +49,9 @@ enum PermutedOrder { ABCD = 0, BACD = 1, ABDC = 2, BADC = 3, CDAB = 4, CDBA = 5,
 
 typedef std::vector<std::pair<int, int>> ShellPairBlock;
 
+//! Shell indices (P, Q, R, S) of one quartet for compute_shell_batch()
+typedef std::array<int, 4> ShellQuartet;
+
 
 class IntegralFactory;
 class AOShellCombinationsIterator;
@@ -107,6 +111,9 @@ protected:
      */
     void create_blocks(void);
 
+    /// Number of integrals in the buffer of quartet (sh1 sh2|sh3 sh4)
+    size_t quartet_size(int sh1, int sh2, int sh3, int sh4) const;
+
 
     void permute_target(double *s, double *t, int sh1, int sh2, int sh3, int sh4, bool p12, bool p34, bool p13p24);
     void permute_1234_to_1243(double *s, double *t, int nbf1, int nbf2, int nbf3, int nbf4);
@@ -182,6 +189,25 @@ public:
     compute_shell_blocks(int shellpair12, int shellpair34,
                          int npair12 = -1, int npair34 = -1);
 
+    /*! Compute a batch of shell quartets into a contiguous buffer
+     *
+     * The integrals of quartet i are written to \p out right after those of
+     * quartet i-1, each in the layout buffer() has after compute_shell();
+     * quartets the backend screens out are written as zeros. \p out must
+     * hold batch_size(quartets) doubles.
+     *
+     * Runs of consecutive quartets with the same bra shell pair and the same
+     * ket angular momenta are what vectorized backends compute in one call,
+     * so callers should order their batches that way. The default computes
+     * the quartets one at a time.
+     *
+     * Returns the number of integrals written.
+     */
+    virtual size_t compute_shell_batch(const std::vector<ShellQuartet>& quartets, double* out);
+
+    /// Number of doubles compute_shell_batch() writes for \p quartets
+    size_t batch_size(const std::vector<ShellQuartet>& quartets) const;
+
     /// Is the shell zero?
     virtual int shell_is_zero(int,int,int,int) { return 0; }
 
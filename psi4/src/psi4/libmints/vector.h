@@ -31,6 +31,7 @@
 
 #include "psi4/libmints/dimension.h"
 #include "psi4/libmints/typedefs.h"
+#include "psi4/libciomr/aligned_allocator.h"
 
 #include <cstdlib>
 #include <cstdio>
@@ -49,7 +50,7 @@ class Vector
 {
 protected:
     /// Actual data, of size dimpi_.sum()
-    std::vector<double> v_;
+    std::vector<double, AlignedAllocator<double> > v_;
     /// Pointer offsets into v_, of size dimpi_.n()
     std::vector<double *> vector_;
     /// Number of irreps
@@ -239,8 +240,8 @@ public:
     /// Scale the elements of the vector
     void scale(const double &sc);
 
-    typedef std::vector<double>::iterator iterator;
-    typedef std::vector<double>::const_iterator const_iterator;
+    typedef std::vector<double, AlignedAllocator<double> >::iterator iterator;
+    typedef std::vector<double, AlignedAllocator<double> >::const_iterator const_iterator;
 
     /// @{
     /** Returns the starting iterator for the entire v_. */
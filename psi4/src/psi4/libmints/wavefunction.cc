@@ -93,8 +93,8 @@ void Wavefunction::shallow_copy(SharedWavefunction other)
 
 void Wavefunction::shallow_copy(const Wavefunction *other)
 {
+    copy_common(other);
 
-    name_ = other->name_;
     basisset_ = other->basisset_;
     basissets_ = other->basissets_;
     sobasisset_ = other->sobasisset_;
@@ -105,33 +105,6 @@ void Wavefunction::shallow_copy(const Wavefunction *other)
     psio_ = other->psio_;
     integral_ = other->integral_;
     factory_ = other->factory_;
-    memory_ = other->memory_;
-    nalpha_ = other->nalpha_;
-    nbeta_ = other->nbeta_;
-    nfrzc_ = other->nfrzc_;
-
-    print_ = other->print_;
-    debug_ = other->debug_;
-    density_fitted_ = other->density_fitted_;
-
-    energy_ = other->energy_;
-    efzc_ = other->efzc_;
-
-    doccpi_ = other->doccpi_;
-    soccpi_ = other->soccpi_;
-    frzcpi_ = other->frzcpi_;
-    frzvpi_ = other->frzvpi_;
-    nalphapi_ = other->nalphapi_;
-    nbetapi_ = other->nbetapi_;
-    nsopi_ = other->nsopi_;
-    nmopi_ = other->nmopi_;
-
-    nso_ = other->nso_;
-    nmo_ = other->nmo_;
-    nirrep_ = other->nirrep_;
-
-    same_a_b_dens_ = other->same_a_b_dens_;
-    same_a_b_orbs_ = other->same_a_b_orbs_;
 
     // Set by other classes
     H_ = other->H_;
@@ -148,7 +121,6 @@ void Wavefunction::shallow_copy(const Wavefunction *other)
     hessian_ = other->hessian_;
     external_pot_ = other->external_pot_;
 
-    variables_ = other->variables_;
     arrays_ = other->arrays_;
 }
 
@@ -159,13 +131,14 @@ void Wavefunction::deep_copy(SharedWavefunction other)
 
 void Wavefunction::deep_copy(const Wavefunction *other)
 {
-    if (!S_) {
+    if (!other->S_) {
         throw PSIEXCEPTION("Wavefunction::deep_copy must copy an initialized wavefunction.");
     }
 
+    copy_common(other);
+
     /// From typical constructor
     /// Some member data is not clone-able so we will copy
-    name_ = other->name_;
     molecule_ = std::shared_ptr<Molecule>(new Molecule(other->molecule_->clone()));
     basisset_ = other->basisset_;
     basissets_ = other->basissets_; // Still cannot copy basissets
@@ -177,6 +150,45 @@ void Wavefunction::deep_copy(const Wavefunction *other)
     S_ = other->S_->clone();
 
     psio_ = other->psio_; // We dont actually copy psio
+
+    // Not sure...
+    external_pot_ = other->external_pot_;
+
+    clone_arrays(other);
+}
+
+void Wavefunction::shared_basis_copy(SharedWavefunction other)
+{
+    shared_basis_copy(other.get());
+}
+
+void Wavefunction::shared_basis_copy(const Wavefunction *other)
+{
+    if (!other->S_) {
+        throw PSIEXCEPTION("Wavefunction::shared_basis_copy must copy an initialized wavefunction.");
+    }
+
+    copy_common(other);
+
+    // Fixed once the geometry and basis are: shared, and read-only from here on
+    molecule_ = other->molecule_;
+    basisset_ = other->basisset_;
+    basissets_ = other->basissets_;
+    integral_ = other->integral_;
+    sobasisset_ = other->sobasisset_;
+    factory_ = other->factory_;
+    AO2SO_ = other->AO2SO_;
+    S_ = other->S_;
+    external_pot_ = other->external_pot_;
+
+    psio_ = other->psio_;
+
+    clone_arrays(other);
+}
+
+void Wavefunction::copy_common(const Wavefunction *other)
+{
+    name_ = other->name_;
     memory_ = other->memory_;
     nalpha_ = other->nalpha_;
     nbeta_ = other->nbeta_;
@@ -188,7 +200,6 @@ void Wavefunction::deep_copy(const Wavefunction *other)
 
     energy_ = other->energy_;
     efzc_ = other->efzc_;
-    variables_ = other->variables_;
 
     doccpi_ = other->doccpi_;
     soccpi_ = other->soccpi_;
@@ -206,27 +217,28 @@ void Wavefunction::deep_copy(const Wavefunction *other)
     same_a_b_dens_ = other->same_a_b_dens_;
     same_a_b_orbs_ = other->same_a_b_orbs_;
 
-    /// Below is not set in the typical constructor
-    if (other->H_) H_ = other->H_->clone();
-    if (other->Ca_) Ca_ = other->Ca_->clone();
-    if (other->Cb_) Cb_ = other->Cb_->clone();
-    if (other->Da_) Da_ = other->Da_->clone();
-    if (other->Db_) Db_ = other->Db_->clone();
-    if (other->Fa_) Fa_ = other->Fa_->clone();
-    if (other->Fb_) Fb_ = other->Fb_->clone();
-    if (other->epsilon_a_) epsilon_a_ = SharedVector(other->epsilon_a_->clone());
-    if (other->epsilon_b_) epsilon_b_ = SharedVector(other->epsilon_b_->clone());
-
-    if (other->gradient_) gradient_ = other->gradient_->clone();
-    if (other->hessian_) hessian_ = other->hessian_->clone();
-
-    // Not sure...
-    external_pot_ = other->external_pot_;
-
     // Copy assignment
     variables_ = other->variables_;
+}
+
+void Wavefunction::clone_arrays(const Wavefunction *other)
+{
+    /// Below is not set in the typical constructor
+    H_ = (other->H_ ? other->H_->clone() : SharedMatrix());
+    Ca_ = (other->Ca_ ? other->Ca_->clone() : SharedMatrix());
+    Cb_ = (other->Cb_ ? other->Cb_->clone() : SharedMatrix());
+    Da_ = (other->Da_ ? other->Da_->clone() : SharedMatrix());
+    Db_ = (other->Db_ ? other->Db_->clone() : SharedMatrix());
+    Fa_ = (other->Fa_ ? other->Fa_->clone() : SharedMatrix());
+    Fb_ = (other->Fb_ ? other->Fb_->clone() : SharedMatrix());
+    epsilon_a_ = (other->epsilon_a_ ? SharedVector(other->epsilon_a_->clone()) : SharedVector());
+    epsilon_b_ = (other->epsilon_b_ ? SharedVector(other->epsilon_b_->clone()) : SharedVector());
+
+    gradient_ = (other->gradient_ ? other->gradient_->clone() : SharedMatrix());
+    hessian_ = (other->hessian_ ? other->hessian_->clone() : SharedMatrix());
 
     // Need to explicitly call copy
+    arrays_.clear();
     for (auto const &kv : other->arrays_) {
         arrays_[kv.first] = kv.second->clone();
     }
@@ -232,6 +232,11 @@ private:
     // Wavefunction() {}
     void common_init();
 
+    /// Names, dimensions, energies and variables, by value
+    void copy_common(const Wavefunction* other);
+    /// Clones of H, C, D, F, epsilon, gradient, Hessian and the arrays of other
+    void clone_arrays(const Wavefunction* other);
+
 public:
 
     /// Constructor for an entirely new wavefunction with an existing basis
@@ -267,6 +272,19 @@ public:
     void deep_copy(SharedWavefunction other);
     void deep_copy(const Wavefunction* other);
 
+    /**
+    * Copy the contents of another Wavefunction into this one, for independent
+    * jobs on the same molecule and basis (e.g. run side by side on threads).
+    * -Does not set options or callbacks
+    * -The molecule, basis sets, integral and matrix factories, SO basis, AO2SO,
+    *  S and external potential are shared with other, and must not be changed
+    *  by either wavefunction while the other is in use
+    * -Matrices and Vectors (Ca,Da,Fa,epsilon_a, etc) are deep copied, so this
+    *  one can be changed freely.
+    **/
+    void shared_basis_copy(SharedWavefunction other);
+    void shared_basis_copy(const Wavefunction* other);
+
     virtual ~Wavefunction();
 
     /// Compute energy. Subclasses override this function to compute its energy.
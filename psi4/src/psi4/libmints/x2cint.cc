@@ -34,16 +34,130 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/rel_potential.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/mintshelper.h"
 #include "psi4/libmints/x2cint.h"
 #include "psi4/libmints/sointegral_onebody.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/factory.h"
 #include "psi4/libmints/sobasis.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/libmints/potential.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <cstdio>
+#include <map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
+namespace {
+/* X and R of a free atom, by element and atomic basis (X2C_DECOUPLING DLU).
+   They do not depend on where the atom sits, so they outlive the molecule. */
+std::map<std::string, std::pair<SharedMatrix, SharedMatrix> > atomic_xr_cache_;
+
+/* Nuclear charge and the shells on atom A, down to the last digit that matters */
+std::string atom_key(std::shared_ptr<BasisSet> basis, int A)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.10E", basis->molecule()->Z(A));
+    std::string key(buf);
+    for (int s = 0; s < basis->nshell_on_center(A); ++s) {
+        const GaussianShell& shell = basis->shell(basis->shell_on_center(A, s));
+        key += "|" + std::to_string(shell.am()) + (shell.is_pure() ? "p" : "c");
+        for (int k = 0; k < shell.nprimitive(); ++k) {
+            std::snprintf(buf, sizeof(buf), ",%.10E:%.10E", shell.exp(k), shell.coef(k));
+            key += buf;
+        }
+    }
+    return key;
+}
+
+/* Block of a one-electron operator over the functions of atom A */
+SharedMatrix atom_block(OneBodyAOInt* ints, std::shared_ptr<BasisSet> basis, int A, int offset, int n)
+{
+    SharedMatrix M(new Matrix(n, n));
+    double** Mp = M->pointer();
+    for (int s1 = 0; s1 < basis->nshell_on_center(A); ++s1) {
+        int P = basis->shell_on_center(A, s1);
+        int nP = basis->shell(P).nfunction();
+        int oP = basis->shell(P).function_index() - offset;
+        for (int s2 = 0; s2 < basis->nshell_on_center(A); ++s2) {
+            int Q = basis->shell_on_center(A, s2);
+            int nQ = basis->shell(Q).nfunction();
+            int oQ = basis->shell(Q).function_index() - offset;
+            ints->compute_shell(P, Q);
+            const double* buffer = ints->buffer();
+            for (int p = 0; p < nP; ++p)
+                for (int q = 0; q < nQ; ++q)
+                    Mp[oP + p][oQ + q] = *buffer++;
+        }
+    }
+    return M;
+}
+
+/* X and R from the Dirac equation of one atom, as X2CInt does for the molecule */
+void atomic_decoupling(SharedMatrix S, SharedMatrix T, SharedMatrix V, SharedMatrix W,
+                       SharedMatrix& X, SharedMatrix& R)
+{
+    int n = S->rowdim();
+    double c2 = pc_c_au * pc_c_au;
+    SharedMatrix D(new Matrix(2 * n, 2 * n));
+    SharedMatrix SX(new Matrix(2 * n, 2 * n));
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            SX->set(p, q, S->get(p, q));
+            SX->set(p + n, q + n, 0.5 * T->get(p, q) / c2);
+            D->set(p, q, V->get(p, q));
+            D->set(p + n, q, T->get(p, q));
+            D->set(p, q + n, T->get(p, q));
+            D->set(p + n, q + n, 0.25 * W->get(p, q) / c2 - T->get(p, q));
+        }
+    }
+
+    SharedMatrix evecs(new Matrix(2 * n, 2 * n));
+    SharedVector evals(new Vector(2 * n));
+    SX->power(-1.0 / 2.0);
+    D->transform(SX);
+    D->diagonalize(evecs, evals);
+    SharedMatrix C(new Matrix(2 * n, 2 * n));
+    C->gemm(false, false, 1.0, SX, evecs, 0.0);
+
+    // The positive-energy solutions are the upper half
+    SharedMatrix CL(new Matrix(n, n));
+    SharedMatrix CS(new Matrix(n, n));
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            CL->set(p, q, C->get(p, q + n));
+            CS->set(p, q, C->get(p + n, q + n));
+        }
+    }
+    CL->general_invert();
+    X = SharedMatrix(new Matrix("X matrix", n, n));
+    X->gemm(false, false, 1.0, CS, CL, 0.0);
+
+    SharedMatrix S_tilde(new Matrix(n, n));
+    S_tilde->transform(X, T, X);
+    S_tilde->scale(1.0 / (2.0 * c2));
+    S_tilde->add(S);
+
+    SharedMatrix S_inv_half = S->clone();
+    S_inv_half->power(-1.0 / 2.0);
+    SharedMatrix sTmp1(new Matrix(n, n));
+    sTmp1->transform(S_tilde, S_inv_half);
+    sTmp1->power(-1.0 / 2.0);
+    SharedMatrix sTmp2(new Matrix(n, n));
+    sTmp2->gemm(false, false, 1.0, S_inv_half, sTmp1, 0.0);
+    S_inv_half->general_invert();
+    R = SharedMatrix(new Matrix("R matrix", n, n));
+    R->gemm(false, false, 1.0, sTmp2, S_inv_half, 0.0);
+}
+}
+
 X2CInt::X2CInt()
 {
 }
@@ -58,17 +172,22 @@ void X2CInt::compute(std::shared_ptr<BasisSet> basis,
     // tstart();
     setup(basis, x2c_basis);
     compute_integrals();
-    form_dirac_h();
-    diagonalize_dirac_h();
-    form_X();
-    form_R();
+    if (do_local_) {
+        form_local_X_R();
+    } else {
+        form_dirac_h();
+        diagonalize_dirac_h();
+        form_X();
+        form_R();
+    }
     form_h_FW_plus();
 
     if(do_project_){
         project();
     }
 
-    test_h_FW_plus();
+    // The molecular Dirac equation is never solved in the local scheme
+    if (!do_local_) test_h_FW_plus();
 
     S->copy(S_x2c_);
     T->copy(T_x2c_);
@@ -93,11 +212,13 @@ void X2CInt::setup(std::shared_ptr<BasisSet> basis,
     x2c_basis_ = x2c_basis->name();
     aoBasis_ = x2c_basis;
     do_project_ = true;
+    do_local_ = Process::environment.options.get_str("X2C_DECOUPLING") == "DLU";
 
     // Print X2C options
     outfile->Printf("\n  ==> X2C Options <==\n");
     outfile->Printf("\n    Computational Basis: %s",basis_.c_str());
     outfile->Printf("\n    X2C Basis: %s",x2c_basis_.c_str());
+    outfile->Printf("\n    Decoupling: %s", do_local_ ? "atomic blocks (DLU)" : "full molecule");
     outfile->Printf("\n    The X2C Hamiltonian will be computed in the X2C Basis\n");
 
     // The integral factory oversees the creation of integral objects
@@ -125,23 +246,20 @@ void X2CInt::setup(std::shared_ptr<BasisSet> basis,
 
 void X2CInt::compute_integrals()
 {
-    // Create the integral objects
-    std::shared_ptr<OneBodySOInt> sOBI(integral_->so_overlap());
-    std::shared_ptr<OneBodySOInt> tOBI(integral_->so_kinetic());
-    std::shared_ptr<OneBodySOInt> vOBI(integral_->so_potential());
-    std::shared_ptr<OneBodySOInt> wOBI(integral_->so_rel_potential());
-
-    // Form the one-electron integral matrices from the matrix factory
-    sMat = SharedMatrix(soFactory_->create_matrix("Overlap"));
-    tMat = SharedMatrix(soFactory_->create_matrix("Kinetic"));
-    vMat = SharedMatrix(soFactory_->create_matrix("Potential"));
-    wMat = SharedMatrix(soFactory_->create_matrix("Relativistic Potential"));
-
-    // Compute the one electron integrals, telling each object where to store the result
-    sOBI->compute(sMat);
-    tOBI->compute(tMat);
-    vOBI->compute(vMat);
-    wOBI->compute(wMat);
+    // The decontracted basis is large, so the AO integrals are computed over shell pairs on
+    // all threads (one integral object each) and only then symmetrized into the SO basis
+    MintsHelper helper(aoBasis_, Process::environment.options, 0);
+    SharedMatrix U = helper.petite_list()->aotoso();
+    auto so_matrix = [&](SharedMatrix ao, const std::string& name) {
+        SharedMatrix so(soFactory_->create_matrix(name));
+        so->apply_symmetry(ao, U);
+        return so;
+    };
+
+    sMat = so_matrix(helper.ao_overlap(), "Overlap");
+    tMat = so_matrix(helper.ao_kinetic(), "Kinetic");
+    vMat = so_matrix(helper.ao_potential(), "Potential");
+    wMat = so_matrix(helper.ao_pvp(), "Relativistic Potential");
 
 #if X2CDEBUG
     sMat->print();
@@ -355,6 +473,110 @@ void X2CInt::form_R()
 #endif
 }
 
+void X2CInt::form_local_X_R()
+{
+    /*
+     * Diagonal local unitary (DLU) decoupling: X and R are block diagonal,
+     * each block that of the free atom in its own functions, with only its
+     * own nucleus in V and W. h^{FW}_{+} is then built as usual from the
+     * molecular T, V, and W.
+     */
+    std::shared_ptr<Molecule> mol = aoBasis_->molecule();
+    int natom = mol->natom();
+    int nbf = aoBasis_->nbf();
+
+    std::vector<int> offsets(natom + 1, 0);
+    for (int A = 0; A < natom; ++A) {
+        int n = 0;
+        for (int s = 0; s < aoBasis_->nshell_on_center(A); ++s)
+            n += aoBasis_->shell(aoBasis_->shell_on_center(A, s)).nfunction();
+        offsets[A + 1] = offsets[A] + n;
+    }
+
+    // One atom per element and basis that has not been solved before
+    std::vector<std::string> keys(natom);
+    std::map<std::string, int> todo_map;
+    for (int A = 0; A < natom; ++A) {
+        keys[A] = atom_key(aoBasis_, A);
+        if (offsets[A + 1] > offsets[A] && !atomic_xr_cache_.count(keys[A]) && !todo_map.count(keys[A]))
+            todo_map[keys[A]] = A;
+    }
+    std::vector<int> todo;
+    for (auto& kv : todo_map) todo.push_back(kv.second);
+
+    outfile->Printf("\n    Solving the Dirac equation for %zu of %d atoms\n", todo.size(), natom);
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::vector<std::shared_ptr<OneBodyAOInt> > sInt, tInt, vInt, wInt;
+    for (int t = 0; t < nthread; ++t) {
+        sInt.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap()));
+        tInt.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic()));
+        vInt.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential()));
+        wInt.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_rel_potential()));
+    }
+
+    std::vector<std::pair<SharedMatrix, SharedMatrix> > solved(todo.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t i = 0; i < todo.size(); ++i) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int A = todo[i];
+        int n = offsets[A + 1] - offsets[A];
+
+        // The potential of nucleus A alone
+        SharedMatrix Zxyz(new Matrix("Partial Charge Field (Z,x,y,z)", 1, 4));
+        Zxyz->set(0, 0, mol->Z(A));
+        Zxyz->set(0, 1, mol->x(A));
+        Zxyz->set(0, 2, mol->y(A));
+        Zxyz->set(0, 3, mol->z(A));
+        static_cast<PotentialInt*>(vInt[thread].get())->set_charge_field(Zxyz);
+        static_cast<RelPotentialInt*>(wInt[thread].get())->set_charge_field(Zxyz);
+
+        SharedMatrix S = atom_block(sInt[thread].get(), aoBasis_, A, offsets[A], n);
+        SharedMatrix T = atom_block(tInt[thread].get(), aoBasis_, A, offsets[A], n);
+        SharedMatrix V = atom_block(vInt[thread].get(), aoBasis_, A, offsets[A], n);
+        SharedMatrix W = atom_block(wInt[thread].get(), aoBasis_, A, offsets[A], n);
+        atomic_decoupling(S, T, V, W, solved[i].first, solved[i].second);
+    }
+    for (size_t i = 0; i < todo.size(); ++i)
+        atomic_xr_cache_[keys[todo[i]]] = solved[i];
+
+    SharedMatrix X_ao(new Matrix("X matrix (AO)", nbf, nbf));
+    SharedMatrix R_ao(new Matrix("R matrix (AO)", nbf, nbf));
+    for (int A = 0; A < natom; ++A) {
+        int n = offsets[A + 1] - offsets[A];
+        if (!n) continue;
+        const std::pair<SharedMatrix, SharedMatrix>& XR = atomic_xr_cache_[keys[A]];
+        for (int p = 0; p < n; ++p) {
+            for (int q = 0; q < n; ++q) {
+                X_ao->set(offsets[A] + p, offsets[A] + q, XR.first->get(p, q));
+                R_ao->set(offsets[A] + p, offsets[A] + q, XR.second->get(p, q));
+            }
+        }
+    }
+
+    // Symmetry-equivalent atoms carry the same blocks, so X and R commute
+    // with the point group and carry over to the (orthonormal) SO basis
+    PetiteList petite(aoBasis_, integral_);
+    SharedMatrix U = petite.aotoso();
+    xMat = SharedMatrix(soFactory_->create_matrix("X matrix"));
+    xMat->apply_symmetry(X_ao, U);
+    rMat = SharedMatrix(soFactory_->create_matrix("R matrix"));
+    rMat->apply_symmetry(R_ao, U);
+
+    xrMat = SharedMatrix(soFactory_->create_matrix("XR matrix"));
+    xrMat->gemm(false, false, 1.0, xMat, rMat, 0.0 );     // XR = X R matrix
+#if X2CDEBUG
+    xMat->print();
+    rMat->print();
+#endif
+}
+
 void X2CInt::form_h_FW_plus()
 {
     // Check if the matrices are allocated and have the correct size
@@ -71,6 +71,8 @@ private:
     std::string x2c_basis_;
     /// Do basis set projection?
     bool do_project_;
+    /// Build X and R from atomic blocks (X2C_DECOUPLING DLU)?
+    bool do_local_;
 
     /// Integral factory
     std::shared_ptr<IntegralFactory> integral_;
@@ -135,6 +137,8 @@ private:
     void form_X();
     /// Form the matrices R and XR
     void form_R();
+    /// Form X, R, and XR from the decoupling of each atom on its own
+    void form_local_X_R();
     /// Form the FW Hamiltonian for positive energy states
     void form_h_FW_plus();
     /// Write the FW Hamiltonian for positive energy states
@@ -109,7 +109,10 @@ public:
 
   // DGEMM timing
   void        set_dgemm_timing(double value)           {dgemm_timing=value;}
-  void        add_dgemm_timing(double value)           {dgemm_timing+=value;}
+  void        add_dgemm_timing(double value)           {
+    #pragma omp atomic
+    dgemm_timing+=value;
+  }
   double      get_dgemm_timing()                 const {return(dgemm_timing);}
 
   // Convergence Options
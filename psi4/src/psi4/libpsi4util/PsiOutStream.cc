@@ -31,13 +31,19 @@
 
 #include "psi4/libpsi4util/exception.h"
 
+#include <chrono>
 #include <cstdio>
 #include <fstream>
 #include <cstdarg>
 
 namespace psi {
 
-PsiOutStream::PsiOutStream(std::string fname, std::ios_base::openmode mode) {
+namespace {
+/* Pending text at which the writer thread is woken early */
+const size_t chunk_size = 1L << 16;
+}
+
+PsiOutStream::PsiOutStream(std::string fname, std::ios_base::openmode mode) : buffered_(false), stop_(false) {
     if (fname == "") {
         stream_ = &std::cout;
         is_cout_ = true;
@@ -57,6 +63,7 @@ PsiOutStream::PsiOutStream(std::string fname, std::ios_base::openmode mode) {
 }
 
 PsiOutStream::~PsiOutStream() {
+    set_buffered(false);
     if (!is_cout_) {
         delete stream_;
     }
@@ -64,28 +71,87 @@ PsiOutStream::~PsiOutStream() {
 
 void PsiOutStream::Printf(const char* format, ...) {
     // We can check if the buffer is large enough
-    va_list args;
+    va_list args, retry;
     va_start(args, format);
+    va_copy(retry, args);
     int left = vsnprintf(buffer_.data(), buffer_.size(), format, args);
+    va_end(args);
 
     if (left < 0) {
         // Encoding error?!?
+        va_end(retry);
         throw PSIEXCEPTION("PsiOutStream: vsnprintf encoding error!");
     } else if (left >= buffer_.size()) {
         // Buffer was too small! Try again
         std::vector<char> tmp_buffer(left + 1);
-        left = vsnprintf(tmp_buffer.data(), left + 1, format, args);
+        left = vsnprintf(tmp_buffer.data(), left + 1, format, retry);
+        va_end(retry);
         if (left < 0) {
             throw PSIEXCEPTION("PsiOutStream: vsnprintf encoding error!");
         }
+        write(tmp_buffer.data(), left);
+        return;
     }
     // Everything is cool
 
-    va_end(args);
-    (*stream_) << buffer_.data() << std::flush;
+    va_end(retry);
+    write(buffer_.data(), left);
 }
 void PsiOutStream::Printf(std::string fp) {
-    (*stream_) << fp << std::flush;
+    write(fp.data(), fp.size());
+}
+
+void PsiOutStream::write(const char* text, size_t size) {
+    if (!buffered_) {
+        stream_->write(text, size);
+        stream_->flush();
+        return;
+    }
+    std::lock_guard<std::mutex> guard(pending_lock_);
+    bool was_small = pending_.size() < chunk_size;
+    pending_.append(text, size);
+    if (was_small && pending_.size() >= chunk_size) wake_.notify_one();
+}
+
+void PsiOutStream::flush() {
+    std::lock_guard<std::mutex> out(stream_lock_);
+    std::string chunk;
+    {
+        std::lock_guard<std::mutex> guard(pending_lock_);
+        chunk.swap(pending_);
+    }
+    if (!chunk.empty()) stream_->write(chunk.data(), chunk.size());
+    stream_->flush();
+}
+
+void PsiOutStream::writer_loop() {
+    std::unique_lock<std::mutex> lock(pending_lock_);
+    while (!stop_) {
+        wake_.wait_for(lock, std::chrono::seconds(1), [this] { return stop_ || pending_.size() >= chunk_size; });
+        if (pending_.empty()) continue;
+        // flush() takes the stream lock before this one
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void PsiOutStream::set_buffered(bool buffered) {
+    if (buffered == buffered_) return;
+    if (buffered) {
+        stop_ = false;
+        buffered_ = true;
+        writer_ = std::thread(&PsiOutStream::writer_loop, this);
+    } else {
+        {
+            std::lock_guard<std::mutex> guard(pending_lock_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+        buffered_ = false;
+        flush();
+    }
 }
 
 } // End Psi Namespace
@@ -29,6 +29,9 @@
 #ifndef _psi_src_lib_libpsi4util_psioutstream_h_
 #define _psi_src_lib_libpsi4util_psioutstream_h_
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -42,6 +45,21 @@ class PsiOutStream {
     bool is_cout_;
     std::vector<char> buffer_;
 
+    // => Buffered output, see set_buffered() <= //
+    bool buffered_;
+    /// Text printed but not yet handed to stream_
+    std::string pending_;
+    /// Guards pending_ and stop_
+    std::mutex pending_lock_;
+    /// Held while a chunk is taken from pending_ and written, so chunks stay in order
+    std::mutex stream_lock_;
+    std::condition_variable wake_;
+    std::thread writer_;
+    bool stop_;
+
+    void write(const char* text, size_t size);
+    void writer_loop();
+
    public:
     PsiOutStream(std::string fname = "", std::ios_base::openmode mode = std::ostream::trunc);
     ~PsiOutStream();
@@ -50,7 +68,23 @@ class PsiOutStream {
     void Printf(std::string fp);
     void MakeBanner(std::string header);
 
-    std::ostream* stream() { return stream_; }
+    /**
+     * Unbuffered (the default), every Printf is written and flushed before it
+     * returns. Buffered, Printf only appends to memory, and a background thread
+     * writes the text out whenever a chunk has gathered, and at least every
+     * second, so iteration loops do not wait on the filesystem. Output of the
+     * last second is lost if the process dies without flush().
+     */
+    void set_buffered(bool buffered);
+    bool buffered() const { return buffered_; }
+    /// Write out and flush everything printed so far
+    void flush();
+
+    /// The underlying stream, once everything printed through Printf is written to it
+    std::ostream* stream() {
+        flush();
+        return stream_;
+    }
 
     // Incase we want to overload << again
     // template <class T>
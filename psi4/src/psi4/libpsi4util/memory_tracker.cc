@@ -0,0 +1,126 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "psi4/libpsi4util/memory_tracker.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/psi4-dec.h"
+
+namespace psi {
+
+std::atomic<size_t> MemoryTracker::current_(0);
+std::atomic<size_t> MemoryTracker::peak_(0);
+std::atomic<size_t> MemoryTracker::module_peak_(0);
+size_t MemoryTracker::limit_ = 0;
+
+namespace {
+std::mutex lock_;
+bool report_ = false;
+std::string module_;
+/* (module, high-water mark) in the order the modules first ran */
+std::vector<std::pair<std::string, size_t> > windows_;
+
+/* Raise peak to at least value */
+void raise_to(std::atomic<size_t>& peak, size_t value) {
+    size_t old = peak.load(std::memory_order_relaxed);
+    while (old < value && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+    }
+}
+
+double mib(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+}
+
+/* Record the window of module_ and start the next at the current usage; lock_ must be held */
+void MemoryTracker::close_window() {
+    if (!module_.empty()) {
+        size_t mark = module_peak_.load();
+        // A module that runs again (SCF in an optimization, FINDIF) keeps one line, with its highest mark
+        auto it = std::find_if(windows_.begin(), windows_.end(),
+                               [](const std::pair<std::string, size_t>& w) { return w.first == module_; });
+        if (it != windows_.end())
+            it->second = std::max(it->second, mark);
+        else
+            windows_.push_back(std::make_pair(module_, mark));
+    }
+    module_peak_.store(current());
+}
+
+void MemoryTracker::configure() {
+    Options& options = Process::environment.options;
+    report_ = options.get_bool("MEMORY_REPORT");
+    limit_ = options.get_bool("MEMORY_ENFORCE") ? Process::environment.get_memory() : 0;
+}
+
+void MemoryTracker::start_module(const std::string& name) {
+    std::lock_guard<std::mutex> guard(lock_);
+    close_window();
+    module_ = name;
+}
+
+void MemoryTracker::allocate(size_t bytes, const char* what) {
+    size_t total = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (limit_ && total > limit_) {
+        current_.fetch_sub(bytes, std::memory_order_relaxed);
+        char msg[512];
+        snprintf(msg, sizeof(msg),
+                 "MemoryTracker: allocating %.2f MiB for %s would hold %.2f MiB, over the %.2f MiB "
+                 "budget. Raise the memory, or unset MEMORY_ENFORCE.",
+                 mib(bytes), what, mib(total), mib(limit_));
+        throw PSIEXCEPTION(msg);
+    }
+    raise_to(peak_, total);
+    raise_to(module_peak_, total);
+}
+
+void MemoryTracker::report() {
+    std::lock_guard<std::mutex> guard(lock_);
+    close_window();
+
+    if (report_ && !windows_.empty()) {
+        outfile->Printf("\n  ==> Tracked Memory High-Water Marks <==\n\n");
+        outfile->Printf("    %-20s %14s\n", "Module", "Peak [MiB]");
+        outfile->Printf("    %-20s %14s\n", "--------------------", "--------------");
+        for (const auto& window : windows_) outfile->Printf("    %-20s %14.2f\n", window.first.c_str(), mib(window.second));
+        outfile->Printf("    %-20s %14.2f\n", "Process", mib(peak()));
+        outfile->Printf("    %-20s %14.2f\n", "Held now", mib(current()));
+        if (limit_) outfile->Printf("    %-20s %14.2f\n", "Budget", mib(limit_));
+        outfile->Printf("\n");
+    }
+    windows_.clear();
+}
+
+}  // namespace psi
@@ -0,0 +1,87 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsi4util_memory_tracker_h_
+#define _psi_src_lib_libpsi4util_memory_tracker_h_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace psi {
+
+/**
+ * Process-wide count of the bytes held by the large allocators: Matrix
+ * blocks, block_matrix() (and so the DFOCC Tensor2d's), and DPD buffers.
+ *
+ * allocate() and release() are one atomic add each plus, on a new peak, a
+ * compare-and-swap, so they are cheap enough for every Matrix. Besides the
+ * process peak, the peak within each module is kept: start_module() (called
+ * as every module starts) opens a new window at the current usage.
+ *
+ * With the option MEMORY_ENFORCE, an allocation that would take the tracked
+ * total past the |globals__memory| budget throws a PsiException instead of
+ * going ahead, so an oversubscribed job stops with a message naming the
+ * allocation rather than being killed by the OS. With MEMORY_REPORT,
+ * report() (called by py_psi_clean()) prints the per-module high-water marks.
+ * Memory that comes through none of these allocators (std::vector, new[],
+ * LibXC, BLAS workspaces) is not counted.
+ */
+class MemoryTracker {
+   public:
+    /// Reread MEMORY_ENFORCE and MEMORY_REPORT, and the memory budget
+    static void configure();
+    /// Close the window of the previous module and open one for module name
+    static void start_module(const std::string& name);
+
+    /// Count bytes about to be allocated for what. Throws, counting nothing,
+    /// if that breaks an enforced budget.
+    static void allocate(size_t bytes, const char* what);
+    /// Count bytes given back
+    static void release(size_t bytes) { current_.fetch_sub(bytes, std::memory_order_relaxed); }
+
+    /// Bytes held now
+    static size_t current() { return current_.load(std::memory_order_relaxed); }
+    /// Most bytes held at once since the process started
+    static size_t peak() { return peak_.load(std::memory_order_relaxed); }
+
+    /// Print the per-module high-water marks, if MEMORY_REPORT is on, and forget them
+    static void report();
+
+   private:
+    static void close_window();
+
+    static std::atomic<size_t> current_;
+    static std::atomic<size_t> peak_;
+    static std::atomic<size_t> module_peak_;
+    static size_t limit_;
+};
+
+}  // namespace psi
+
+#endif
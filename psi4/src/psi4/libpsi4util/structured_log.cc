@@ -0,0 +1,135 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "psi4/libpsi4util/structured_log.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+namespace psi {
+
+std::shared_ptr<PsiOutStream> StructuredLog::stream_;
+
+namespace {
+std::string path_;
+std::chrono::steady_clock::time_point opened_;
+
+/* s as a JSON string literal, appended to out */
+void append_string(std::string& out, const std::string& s) {
+    out += '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+}
+
+void StructuredLog::configure() {
+    std::string path = Process::environment.options.get_str("STRUCTURED_LOG_FILE");
+    if (path == path_) return;
+    close();
+    path_ = path;
+    if (path_.empty()) return;
+    stream_ = std::make_shared<PsiOutStream>(path_, std::ostream::app);
+    stream_->set_buffered(true);
+    opened_ = std::chrono::steady_clock::now();
+}
+
+void StructuredLog::flush() {
+    if (stream_) stream_->flush();
+}
+
+void StructuredLog::close() {
+    stream_.reset();
+    path_.clear();
+}
+
+StructuredLog::Record::Record(const std::string& event) : active_(StructuredLog::enabled()) {
+    if (!active_) return;
+    line_ = "{";
+    key("event");
+    append_string(line_, event);
+    add("module", Process::environment.options.get_current_module());
+    add("time", std::chrono::duration<double>(std::chrono::steady_clock::now() - opened_).count());
+}
+
+void StructuredLog::Record::key(const std::string& key) {
+    if (line_.size() > 1) line_ += ", ";
+    append_string(line_, key);
+    line_ += ": ";
+}
+
+StructuredLog::Record& StructuredLog::Record::add(const std::string& key, double value) {
+    if (!active_) return *this;
+    this->key(key);
+    if (std::isfinite(value)) {
+        char number[32];
+        snprintf(number, sizeof(number), "%.17g", value);
+        line_ += number;
+    } else {
+        // JSON has no NaN or infinity
+        line_ += "null";
+    }
+    return *this;
+}
+
+StructuredLog::Record& StructuredLog::Record::add(const std::string& key, int value) {
+    if (!active_) return *this;
+    this->key(key);
+    line_ += std::to_string(value);
+    return *this;
+}
+
+StructuredLog::Record& StructuredLog::Record::add(const std::string& key, const std::string& value) {
+    if (!active_) return *this;
+    this->key(key);
+    append_string(line_, value);
+    return *this;
+}
+
+void StructuredLog::Record::write() {
+    if (!active_ || !StructuredLog::stream_) return;
+    line_ += "}\n";
+    StructuredLog::stream_->Printf(line_);
+    active_ = false;
+}
+
+}  // namespace psi
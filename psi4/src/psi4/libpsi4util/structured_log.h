@@ -0,0 +1,85 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsi4util_structured_log_h_
+#define _psi_src_lib_libpsi4util_structured_log_h_
+
+#include <memory>
+#include <string>
+
+namespace psi {
+
+class PsiOutStream;
+
+/**
+ * Machine-readable companion to the output file. With the option
+ * STRUCTURED_LOG_FILE set (looked at whenever a module starts), modules
+ * append one JSON object per line for events such as an SCF or CC
+ * iteration, so drivers and notebooks can follow a job without parsing the
+ * text output:
+ *
+ *     StructuredLog::Record("scf iteration").add("iteration", iter).add("energy", E).write();
+ *
+ * Every record carries its event, the module running, and the wall seconds
+ * since the log was opened. The file is written through a buffered
+ * PsiOutStream, so a record costs a few string appends. With no log, a
+ * Record does nothing.
+ */
+class StructuredLog {
+   public:
+    /// Reread STRUCTURED_LOG_FILE, opening or closing the log as needed
+    static void configure();
+    /// Is a log open?
+    static bool enabled() { return static_cast<bool>(stream_); }
+    /// Write out everything logged so far
+    static void flush();
+    /// Flush and close the log
+    static void close();
+
+    /// One line of the log, written by write()
+    class Record {
+       public:
+        explicit Record(const std::string& event);
+        Record& add(const std::string& key, double value);
+        Record& add(const std::string& key, int value);
+        Record& add(const std::string& key, const std::string& value);
+        void write();
+
+       private:
+        bool active_;
+        std::string line_;
+        void key(const std::string& key);
+    };
+
+   private:
+    static std::shared_ptr<PsiOutStream> stream_;
+};
+
+}  // namespace psi
+
+#endif
@@ -49,31 +49,36 @@ void PSIO::change_file_namespace(size_t unit, const std::string & ns1, const std
     _default_psio_lib_->get_filename(unit, &old_name, true);
     _default_psio_lib_->get_filename(unit, &new_name, true);
     //_default_psio_lib_->get_volpath(unit, 0, &path);
-    std::string tpath = PSIOManager::shared_object()->get_file_path(unit);
-    const char* path = tpath.c_str();
+    /* Every volume of a striped unit carries the namespace in its name */
+    size_t numvols = _default_psio_lib_->get_numvols(unit);
+    if (!numvols) numvols = 1;
+    for (size_t vol = 0; vol < numvols; vol++) {
+        std::string tpath = _default_psio_lib_->volume_dir(unit, vol);
+        const char* path = tpath.c_str();
 
-    old_fullpath = (char*) malloc( (strlen(path)+strlen(old_name)+80)*sizeof(char));
-    new_fullpath = (char*) malloc( (strlen(path)+strlen(new_name)+80)*sizeof(char));
+        old_fullpath = (char*) malloc( (strlen(path)+strlen(old_name)+80)*sizeof(char));
+        new_fullpath = (char*) malloc( (strlen(path)+strlen(new_name)+80)*sizeof(char));
 
-    if (ns1 == "") {
-        sprintf(old_fullpath, "%s%s.%zu", path, old_name, unit);
-    } else {
-        sprintf(old_fullpath, "%s%s.%s.%zu", path, old_name, ns1.c_str(), unit);
-    }
-    if (ns2 == "") {
-        sprintf(new_fullpath, "%s%s.%zu", path, new_name, unit);
-    } else {
-        sprintf(new_fullpath, "%s%s.%s.%zu", path, new_name, ns2.c_str(), unit);
-    }
+        if (ns1 == "") {
+            sprintf(old_fullpath, "%s%s.%zu", path, old_name, unit);
+        } else {
+            sprintf(old_fullpath, "%s%s.%s.%zu", path, old_name, ns1.c_str(), unit);
+        }
+        if (ns2 == "") {
+            sprintf(new_fullpath, "%s%s.%zu", path, new_name, unit);
+        } else {
+            sprintf(new_fullpath, "%s%s.%s.%zu", path, new_name, ns2.c_str(), unit);
+        }
 
-    //printf("%s\n",old_fullpath);
-    //printf("%s\n",new_fullpath);
+        //printf("%s\n",old_fullpath);
+        //printf("%s\n",new_fullpath);
 
-    PSIOManager::shared_object()->move_file(std::string(old_fullpath), std::string(new_fullpath));
+        PSIOManager::shared_object()->move_file(std::string(old_fullpath), std::string(new_fullpath));
         ::rename(old_fullpath,new_fullpath);
 
-    free(old_fullpath);
-    free(new_fullpath);
+        free(old_fullpath);
+        free(new_fullpath);
+    }
 }
 
 }
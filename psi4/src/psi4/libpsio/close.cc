@@ -55,7 +55,18 @@ void PSIO::close(size_t unit, int keep) {
   /* Dump the current TOC back out to disk */
   tocwrite(unit);
 
+  /* An in-core unit reaches its file only if the file outlives the unit,
+     and a resident one not even then (beyond what SCRATCH_MEMORY_LIMIT spilled) */
+  if (this_unit->incore) {
+    if (keep && this_unit->resident) core_park(unit);
+    else if (keep) core_flush(unit);
+    core_free(unit);
+    this_unit->incore = 0;
+    this_unit->resident = 0;
+  }
+
   /* Free the TOC */
+  tocindex_clear(unit);
   this_entry = this_unit->toc;
   for (i=0; i < this_unit->toclen; i++) {
     next_entry = this_entry->next;
@@ -63,6 +74,10 @@ void PSIO::close(size_t unit, int keep) {
     this_entry = next_entry;
   }
 
+  /* Drop the mapping; any outstanding views die with it */
+  unmap(unit);
+  this_unit->mmap = 0;
+
   /* Close each volume (remove if necessary) and free the path */
   for (i=0; i < this_unit->numvols; i++) {
     int errcod;
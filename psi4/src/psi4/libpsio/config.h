@@ -29,8 +29,14 @@
 #ifndef _psi_src_lib_libpsio_config_h_
 #define _psi_src_lib_libpsio_config_h_
 
+#include <string>
+#include <unordered_map>
+#include <pthread.h>
+
 namespace psi {
 
+class CoreImage;
+
 #define PSIO_OPEN_NEW 0
 #define PSIO_OPEN_OLD 1
 
@@ -59,6 +65,8 @@ namespace psi {
 #define PSIO_ERROR_BLKEND    18
 #define PSIO_ERROR_IDENTVOLPATH 19
 #define PSIO_ERROR_MAXUNIT   20
+#define PSIO_ERROR_MMAP      21
+#define PSIO_ERROR_INCORE    22
 
 typedef struct {
     size_t page; /* First page of entry */
@@ -78,13 +86,41 @@ typedef struct psio_entry {
     struct psio_entry *last;
 } psio_tocentry;
 
+/* Key index over the entries of one TOC; the linked list stays the TOC itself */
+typedef std::unordered_map<std::string, psio_tocentry *> psio_tocindex;
+
 typedef struct {
     size_t numvols;
+    size_t stripe; /* Bytes laid out on one volume before moving to the next, a multiple of PSIO_PAGELEN */
     psio_vol vol[PSIO_MAXVOL];
     size_t toclen;
     psio_tocentry *toc;
+    psio_tocindex *tocindex; /* Built by the first lookup after the TOC is read, NULL before */
+    int mmap; /* Reads are served from a shared mapping of the (single) volume */
+    char *map; /* Start of the address range reserved for the read-only mapping, NULL if not mapped */
+    size_t maplen; /* Number of bytes of the file currently mapped at map */
+    int incore; /* Contents live in memory, the file is only touched at open()/close() */
+    CoreImage *core; /* In-core image of the (single) volume, NULL if not in core */
+    int resident; /* In-core image is parked in memory, not flushed, when kept at close() */
+    pthread_rwlock_t lock; /* Shared by read()/read_view(), exclusive for write() and TOC edits */
 } psio_ud;
 
+/* Holds the lock of a unit for a scope, shared or exclusive */
+class psio_unit_lock {
+    pthread_rwlock_t *lock_;
+    psio_unit_lock(const psio_unit_lock&);
+    psio_unit_lock& operator=(const psio_unit_lock&);
+public:
+    psio_unit_lock(psio_ud *unit, bool exclusive) : lock_(&unit->lock) {
+        if (exclusive) pthread_rwlock_wrlock(lock_);
+        else pthread_rwlock_rdlock(lock_);
+    }
+    ~psio_unit_lock() { pthread_rwlock_unlock(lock_); }
+    /* Trade a shared hold for an exclusive one; other writers may run in between */
+    void exclusive() { pthread_rwlock_unlock(lock_); pthread_rwlock_wrlock(lock_); }
+    void shared() { pthread_rwlock_unlock(lock_); pthread_rwlock_rdlock(lock_); }
+};
+
 /** A convenient address initialization struct */
 extern psio_address PSIO_ZERO;
 
@@ -0,0 +1,241 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "psi4/libpsio/coreimage.h"
+#include "psi4/libpsio/config.h"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+namespace {
+std::mutex lock_;
+
+void write_fully(int stream, const char* buffer, size_t size, size_t offset, const std::string& path) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pwrite(stream, buffer + done, size - done, offset + done);
+        if (n <= 0) throw PSIEXCEPTION("PSIO: unable to write in-core file " + path + " out to disk.");
+        done += n;
+    }
+}
+}
+
+CoreImage::LRU CoreImage::lru_;
+size_t CoreImage::total_ = 0;
+size_t CoreImage::limit_ = 0;
+
+CoreImage::CoreImage(const std::string& path, int stream, size_t length)
+    : path_(path), stream_(stream), length_(length) {
+    size_t npage = (length + PSIO_PAGELEN - 1) / PSIO_PAGELEN;
+    pages_.assign(npage, nullptr);
+    state_.assign(npage, ON_DISK);
+    where_.resize(npage);
+}
+
+CoreImage::~CoreImage() {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (size_t i = 0; i < pages_.size(); i++) {
+        if (pages_[i] == nullptr) continue;
+        free(pages_[i]);
+        lru_.erase(where_[i]);
+        total_ -= PSIO_PAGELEN;
+    }
+}
+
+void CoreImage::set_limit(size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock_);
+    limit_ = bytes;
+}
+
+size_t CoreImage::length() {
+    std::lock_guard<std::mutex> guard(lock_);
+    return length_;
+}
+
+size_t CoreImage::page_bytes(size_t i) const {
+    size_t start = i * PSIO_PAGELEN;
+    return (length_ > start) ? std::min((size_t)PSIO_PAGELEN, length_ - start) : 0;
+}
+
+void CoreImage::reserve() {
+    while (limit_ && total_ + PSIO_PAGELEN > limit_ && !lru_.empty()) {
+        CoreImage* image = lru_.back().first;
+        if (image->stream_ == -1)
+            image->spill_all();
+        else
+            image->spill(lru_.back().second, image->stream_);
+    }
+}
+
+char* CoreImage::fault(size_t i) {
+    if (i >= pages_.size()) {
+        pages_.resize(i + 1, nullptr);
+        state_.resize(i + 1, 0);
+        where_.resize(i + 1);
+    }
+    if (pages_[i] != nullptr) {
+        lru_.splice(lru_.begin(), lru_, where_[i]);
+        return pages_[i];
+    }
+
+    reserve();
+    char* page = (char*)malloc(PSIO_PAGELEN);
+    if (page == nullptr) throw PSIEXCEPTION("PSIO: unable to allocate a page for in-core file " + path_ + ".");
+    ::memset(page, 0, PSIO_PAGELEN);
+
+    if (state_[i] & ON_DISK) {
+        int stream = (stream_ == -1) ? ::open(path_.c_str(), O_RDONLY) : stream_;
+        if (stream == -1) throw PSIEXCEPTION("PSIO: unable to read in-core file " + path_ + " back from disk.");
+        size_t done = 0;
+        size_t size = page_bytes(i);
+        while (done < size) {
+            ssize_t n = ::pread(stream, page + done, size - done, i * PSIO_PAGELEN + done);
+            if (n < 0) throw PSIEXCEPTION("PSIO: unable to read in-core file " + path_ + " back from disk.");
+            /* Past the end of the file reads as zeros, as it would on disk */
+            if (n == 0) break;
+            done += n;
+        }
+        if (stream_ == -1) ::close(stream);
+    }
+
+    pages_[i] = page;
+    lru_.push_front(std::make_pair(this, i));
+    where_[i] = lru_.begin();
+    total_ += PSIO_PAGELEN;
+    return page;
+}
+
+void CoreImage::spill(size_t i, int stream) {
+    if (state_[i] & DIRTY) {
+        write_fully(stream, pages_[i], page_bytes(i), i * PSIO_PAGELEN, path_);
+        state_[i] = ON_DISK;
+    }
+    free(pages_[i]);
+    pages_[i] = nullptr;
+    lru_.erase(where_[i]);
+    total_ -= PSIO_PAGELEN;
+}
+
+int CoreImage::open_for_spill() {
+    int stream = ::open(path_.c_str(), O_CREAT | O_WRONLY, 0644);
+    if (stream == -1) throw PSIEXCEPTION("PSIO: unable to write in-core file " + path_ + " out to disk.");
+    return stream;
+}
+
+void CoreImage::spill_all() {
+    int stream = open_for_spill();
+    for (size_t i = 0; i < pages_.size(); i++)
+        if (pages_[i] != nullptr) spill(i, stream);
+    ::close(stream);
+}
+
+void CoreImage::read(char* buffer, size_t offset, size_t size) {
+    std::lock_guard<std::mutex> guard(lock_);
+    while (size) {
+        size_t i = offset / PSIO_PAGELEN;
+        size_t in_page = offset % PSIO_PAGELEN;
+        size_t n = std::min(size, PSIO_PAGELEN - in_page);
+        if (i < pages_.size() && (pages_[i] != nullptr || (state_[i] & ON_DISK)))
+            ::memcpy(buffer, fault(i) + in_page, n);
+        else
+            /* Never written: a hole, which reads as zeros without taking a page */
+            ::memset(buffer, 0, n);
+        buffer += n;
+        offset += n;
+        size -= n;
+    }
+}
+
+void CoreImage::write(const char* buffer, size_t offset, size_t size) {
+    std::lock_guard<std::mutex> guard(lock_);
+    while (size) {
+        size_t i = offset / PSIO_PAGELEN;
+        size_t in_page = offset % PSIO_PAGELEN;
+        size_t n = std::min(size, PSIO_PAGELEN - in_page);
+        ::memcpy(fault(i) + in_page, buffer, n);
+        state_[i] |= DIRTY;
+        buffer += n;
+        offset += n;
+        size -= n;
+        length_ = std::max(length_, offset);
+    }
+}
+
+const char* CoreImage::view(size_t offset, size_t size) {
+    if (size && offset / PSIO_PAGELEN == (offset + size - 1) / PSIO_PAGELEN) {
+        std::lock_guard<std::mutex> guard(lock_);
+        return fault(offset / PSIO_PAGELEN) + offset % PSIO_PAGELEN;
+    }
+    /* Pages are not contiguous, so a view across pages is a copy, one buffer per thread */
+    thread_local std::vector<char> view_buffer;
+    view_buffer.resize(size);
+    read(view_buffer.data(), offset, size);
+    return view_buffer.data();
+}
+
+void CoreImage::flush() {
+    std::lock_guard<std::mutex> guard(lock_);
+    int stream = (stream_ == -1) ? open_for_spill() : stream_;
+    for (size_t i = 0; i < pages_.size(); i++) {
+        if (pages_[i] == nullptr || !(state_[i] & DIRTY)) continue;
+        write_fully(stream, pages_[i], page_bytes(i), i * PSIO_PAGELEN, path_);
+        state_[i] = ON_DISK;
+    }
+    if (::ftruncate(stream, (off_t)length_) == -1)
+        throw PSIEXCEPTION("PSIO: unable to write in-core file " + path_ + " out to disk.");
+    if (stream_ == -1) ::close(stream);
+}
+
+void CoreImage::detach() {
+    std::lock_guard<std::mutex> guard(lock_);
+    stream_ = -1;
+}
+
+void CoreImage::attach(int stream) {
+    std::lock_guard<std::mutex> guard(lock_);
+    stream_ = stream;
+}
+
+void CoreImage::rename(const std::string& path) {
+    std::lock_guard<std::mutex> guard(lock_);
+    path_ = path;
+}
+
+}  // namespace psi
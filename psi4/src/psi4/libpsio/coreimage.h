@@ -0,0 +1,113 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_coreimage_h_
+#define _psi_src_lib_libpsio_coreimage_h_
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace psi {
+
+/**
+ * In-memory image of a single-volume PSIO unit ("incore" and "resident"
+ * units), laid out exactly as the file would be.
+ *
+ * The image is kept in PSIO_PAGELEN pages. All images of the process share
+ * the budget set_limit() (the option SCRATCH_MEMORY_LIMIT): once it is used
+ * up, the least recently touched pages are written to their file and
+ * dropped, and are read back the next time they are touched. An image of an
+ * existing file starts with every page on disk and pulls pages in as they
+ * are first read.
+ *
+ * Images may be used from the AIO thread while the main thread works on
+ * another unit, so every public member takes one process-wide lock.
+ */
+class CoreImage {
+   public:
+    /// Image of the file at path, open as stream, whose first length bytes are valid on disk
+    CoreImage(const std::string& path, int stream, size_t length);
+    ~CoreImage();
+
+    /// Number of valid bytes
+    size_t length();
+    void read(char* buffer, size_t offset, size_t size);
+    void write(const char* buffer, size_t offset, size_t size);
+    /// Pointer to size bytes at offset. Valid until the calling thread's next view(), and
+    /// until its page is spilled if it lies in one page (never, without a limit).
+    const char* view(size_t offset, size_t size);
+
+    /// Bring the file up to date with the image and truncate it to length()
+    void flush();
+    /// The file was closed; the image lives on, spilling through path if needed
+    void detach();
+    /// The file at path is open again as stream
+    void attach(int stream);
+    /// The (detached) file was moved to path
+    void rename(const std::string& path);
+
+    /// Budget in bytes for all images of the process together, 0 for none
+    static void set_limit(size_t bytes);
+
+   private:
+    typedef std::list<std::pair<CoreImage*, size_t> > LRU;
+
+    /// Page state bits
+    enum { ON_DISK = 1, DIRTY = 2 };
+
+    std::string path_;
+    int stream_;
+    size_t length_;
+    std::vector<char*> pages_;
+    std::vector<char> state_;
+    std::vector<LRU::iterator> where_;
+
+    static LRU lru_;
+    static size_t total_;
+    static size_t limit_;
+
+    /// Bytes of page i that lie within the image
+    size_t page_bytes(size_t i) const;
+    /// Make page i resident (reading it back, or zeroed), and most recently used
+    char* fault(size_t i);
+    /// Take page i out of memory, writing it out first if the file lacks it
+    void spill(size_t i, int stream);
+    /// Spill every resident page (used for detached images, opening the file once)
+    void spill_all();
+    /// Open path for writing out a detached image
+    int open_for_spill();
+    /// Make room for one more page
+    static void reserve();
+};
+
+}  // namespace psi
+
+#endif
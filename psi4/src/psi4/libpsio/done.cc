@@ -76,6 +76,8 @@ PSIO::~PSIO() {
   free(psio_writlen);
 #endif
 
+  for (int unit = 0; unit < PSIO_MAXUNIT; unit++)
+    pthread_rwlock_destroy(&(psio_unit[unit].lock));
   free(psio_unit);
   state_ = 0;
   files_keywords_.clear();
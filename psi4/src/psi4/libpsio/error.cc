@@ -124,6 +124,12 @@ namespace psi {
         fprintf(stderr, "Open failed because unit %zu exceeds ", unit);
         fprintf(stderr, "PSIO_MAXUNIT = %d.\n", PSIO_MAXUNIT);
         break;
+      case PSIO_ERROR_MMAP:
+        fprintf(stderr, "PSIO_ERROR: %d (memory mapping failed or unit not mapped)\n", PSIO_ERROR_MMAP);
+        break;
+      case PSIO_ERROR_INCORE:
+        fprintf(stderr, "PSIO_ERROR: %d (in-core unit allocation failed or read past its end)\n", PSIO_ERROR_INCORE);
+        break;
     }
     fflush(stderr);
     throw PSIEXCEPTION("PSIO Error");
@@ -33,6 +33,7 @@
 
 #include "psio.hpp"
 #include "psio.h"
+#include "iotrace.h"
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -133,6 +134,7 @@ void PSIOManager::move_file(const std::string& old_full_path, const std::string&
 {
     files_[new_full_path] = files_[old_full_path];
     files_.erase(old_full_path);
+    PSIO::resident_move(old_full_path, new_full_path);
     mirror_to_disk();
 }
 void PSIOManager::print(std::string out)
@@ -236,13 +238,18 @@ void PSIOManager::mark_file_for_retention(const std::string& file, bool retain)
 }
 void PSIOManager::psiclean()
 {
+    IOTrace::report();
+
     std::map<std::string, bool> temp;
     for (std::map<std::string, bool>::iterator it = files_.begin(); it != files_.end(); it++) {
         if (retained_files_.count((*it).first) == 0) {
             //Safe to delete
 
                 unlink((*it).first.c_str());
+                PSIO::resident_drop((*it).first);
         } else {
+            // Outlives the process, so must be on disk
+            PSIO::resident_flush((*it).first);
             temp[(*it).first] = (*it).second;
         }
     }
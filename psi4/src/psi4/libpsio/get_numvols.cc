@@ -62,6 +62,20 @@ size_t PSIO::get_numvols(size_t unit) {
   abort();
 }
 
+size_t PSIO::get_stripe(size_t unit) {
+  std::string charnum;
+  charnum = filecfg_kwd("PSI", "STRIPE", unit);
+  if (charnum.empty())
+    charnum = filecfg_kwd("PSI", "STRIPE", -1);
+  if (charnum.empty())
+    charnum = filecfg_kwd("DEFAULT", "STRIPE", unit);
+  if (charnum.empty())
+    charnum = filecfg_kwd("DEFAULT", "STRIPE", -1);
+
+  int pages = charnum.empty() ? 1 : atoi(charnum.c_str());
+  return ((size_t) (pages > 0 ? pages : 1));
+}
+
   size_t psio_get_numvols_default(void) {
     std::string charnum;
 
@@ -70,6 +70,20 @@ void PSIO::get_volpath(size_t unit, size_t volume, char **path) {
   abort();
 }
 
+std::string PSIO::volume_dir(size_t unit, size_t volume) {
+  /* The first volume follows PSIOManager, which knows about scratch
+     directories set per unit; further ones are where "volumeX" puts them */
+  if (volume == 0)
+    return PSIOManager::shared_object()->get_file_path(unit);
+
+  char *path;
+  get_volpath(unit, volume, &path);
+  std::string dir(path);
+  free(path);
+  if (!dir.empty() && dir[dir.size() - 1] != '/') dir += "/";
+  return dir;
+}
+
   int psio_get_volpath_default(size_t volume, char **path) {
     std::string kval;
     char volumeX[20];
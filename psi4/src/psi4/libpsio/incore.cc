@@ -0,0 +1,211 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <cstdio>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <map>
+#include <string>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/coreimage.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/psifiles.h"
+
+namespace psi {
+
+namespace {
+/* Images of resident units closed with keep, by full path of their file */
+std::map<std::string, CoreImage *> parked_;
+
+/* Units that SCRATCH_IN_MEMORY CORRELATED covers: the SO integrals, their
+   transforms, and what the conventional correlated modules hand each other */
+bool correlated_unit(size_t unit) {
+  return unit == PSIF_SO_TEI || unit == PSIF_MO_TEI ||
+         (unit >= PSIF_LIBTRANS_DPD && unit <= PSIF_LIBTRANS_B_HT) ||
+         (unit >= PSIF_CC_MIN && unit <= PSIF_CC_MAX) ||
+         (unit >= PSIF_DCC_IJAK && unit <= PSIF_DCC_QSO) ||
+         (unit >= PSIF_OCC_DPD && unit <= PSIF_OCC_IABC);
+}
+}
+
+bool PSIO::get_incore(size_t unit) {
+  std::string val;
+  val = filecfg_kwd("PSI", "INCORE", unit);
+  if (val.empty())
+    val = filecfg_kwd("PSI", "INCORE", -1);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "INCORE", unit);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "INCORE", -1);
+
+  return (val == "TRUE" || val == "true" || val == "1");
+}
+
+bool PSIO::get_resident(size_t unit) {
+  /* Files someone asked to keep have to reach the disk */
+  if (PSIOManager::shared_object()->get_specific_retention(unit))
+    return false;
+
+  std::string val;
+  val = filecfg_kwd("PSI", "RESIDENT", unit);
+  if (val.empty())
+    val = filecfg_kwd("PSI", "RESIDENT", -1);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "RESIDENT", unit);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "RESIDENT", -1);
+  if (!val.empty())
+    return (val == "TRUE" || val == "true" || val == "1");
+
+  std::string scope = Process::environment.options.get_str("SCRATCH_IN_MEMORY");
+  if (scope == "ALL") return true;
+  if (scope == "CORRELATED") return correlated_unit(unit);
+  return false;
+}
+
+int PSIO::in_core(size_t unit) {
+  return psio_unit[unit].incore;
+}
+
+int PSIO::resident(size_t unit) {
+  return psio_unit[unit].resident;
+}
+
+void PSIO::core_park(size_t unit) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  std::string path(this_unit->vol[0].path);
+
+  resident_drop(path);
+  this_unit->core->detach();
+  parked_[path] = this_unit->core;
+  this_unit->core = NULL;
+}
+
+void PSIO::core_unpark(size_t unit, int status) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  std::string path(this_unit->vol[0].path);
+  auto it = parked_.find(path);
+  if (it == parked_.end()) return;
+
+  if (status == PSIO_OPEN_NEW) {
+    /* The file starts over anyway */
+    resident_drop(path);
+  } else if (this_unit->incore) {
+    core_free(unit);
+    this_unit->core = it->second;
+    this_unit->core->attach(this_unit->vol[0].stream);
+    parked_.erase(it);
+  } else {
+    /* Reopened without being in core (say SCRATCH_IN_MEMORY changed), so
+       the file itself has to hold the data again */
+    resident_flush(path);
+  }
+}
+
+void PSIO::resident_move(const std::string& old_path, const std::string& new_path) {
+  auto it = parked_.find(old_path);
+  if (it == parked_.end()) return;
+  CoreImage *image = it->second;
+  parked_.erase(it);
+  resident_drop(new_path);
+  /* Pages already spilled went along with the file */
+  image->rename(new_path);
+  parked_[new_path] = image;
+}
+
+void PSIO::resident_drop(const std::string& path) {
+  auto it = parked_.find(path);
+  if (it == parked_.end()) return;
+  delete it->second;
+  parked_.erase(it);
+}
+
+void PSIO::resident_flush(const std::string& path) {
+  auto it = parked_.find(path);
+  if (it == parked_.end()) return;
+  it->second->flush();
+  resident_drop(path);
+}
+
+void PSIO::core_free(size_t unit) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+
+  delete this_unit->core;
+  this_unit->core = NULL;
+}
+
+void PSIO::core_rw(size_t unit, char *buffer, psio_address address, size_t size,
+                   int wrt) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+
+  /* An in-core unit has exactly one volume, so pages are laid out contiguously */
+  size_t offset = address.page * PSIO_PAGELEN + address.offset;
+
+  if (wrt) {
+    this_unit->core->write(buffer, offset, size);
+    return;
+  }
+  if (offset + size > this_unit->core->length())
+    psio_error(unit, PSIO_ERROR_INCORE);
+  this_unit->core->read(buffer, offset, size);
+}
+
+void PSIO::core_load(size_t unit, int status) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  int stream = this_unit->vol[0].stream;
+  size_t size = 0;
+
+  if (status == PSIO_OPEN_OLD) {
+    struct stat st;
+    if (::fstat(stream, &st) == -1)
+      psio_error(unit, PSIO_ERROR_READ);
+    size = (size_t) st.st_size;
+  }
+
+  core_free(unit);
+  CoreImage::set_limit((size_t) Process::environment.options.get_int("SCRATCH_MEMORY_LIMIT") * 1024L * 1024L);
+  /* Nothing is read yet, pages come in as they are touched */
+  this_unit->core = new CoreImage(std::string(this_unit->vol[0].path), stream, size);
+}
+
+void PSIO::core_flush(size_t unit) {
+  try {
+    psio_unit[unit].core->flush();
+  } catch (const PsiException&) {
+    psio_error(unit, PSIO_ERROR_WRITE);
+  }
+}
+
+}
@@ -66,6 +66,8 @@ PSIO::PSIO()
     psio_writlen = (size_t *) malloc(sizeof(size_t) * PSIO_MAXUNIT);
 #endif
     state_ = 1;
+    bytes_read_ = 0;
+    bytes_written_ = 0;
 
     if (psio_unit == NULL) {
         ::fprintf(stderr, "Error in PSIO_INIT()!\n");
@@ -77,12 +79,21 @@ PSIO::PSIO()
         psio_readlen[i] = psio_writlen[i] = 0;
 #endif
         psio_unit[i].numvols = 0;
+        psio_unit[i].stripe = PSIO_PAGELEN;
         for (j=0; j < PSIO_MAXVOL; j++) {
             psio_unit[i].vol[j].path = NULL;
             psio_unit[i].vol[j].stream = -1;
         }
         psio_unit[i].toclen = 0;
         psio_unit[i].toc = NULL;
+        psio_unit[i].tocindex = NULL;
+        psio_unit[i].mmap = 0;
+        psio_unit[i].map = NULL;
+        psio_unit[i].maplen = 0;
+        psio_unit[i].incore = 0;
+        psio_unit[i].core = NULL;
+        psio_unit[i].resident = 0;
+        pthread_rwlock_init(&(psio_unit[i].lock), NULL);
     }
 
     /* Open user's general .psirc file, if exists */
@@ -111,6 +122,7 @@ PSIO::PSIO()
     }
     filecfg_kwd("DEFAULT", "NAME", -1, psi_file_prefix);
     filecfg_kwd("DEFAULT", "NVOLUME", -1, "1");
+    filecfg_kwd("DEFAULT", "STRIPE", -1, "1");
 
     pid_ = getpid();
 }
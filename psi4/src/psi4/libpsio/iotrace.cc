@@ -0,0 +1,175 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "psi4/libpsio/iotrace.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/psi4-dec.h"
+
+namespace psi {
+
+namespace {
+struct EntryStats {
+    size_t reads = 0;
+    size_t writes = 0;
+    size_t bytes_read = 0;
+    size_t bytes_written = 0;
+    double read_time = 0.0;
+    double write_time = 0.0;
+    size_t seeks = 0;
+};
+
+std::mutex lock_;
+std::map<std::pair<size_t, std::string>, EntryStats> entries_;
+/* Byte after the last transfer on each unit, for counting seeks */
+std::map<size_t, size_t> position_;
+
+std::string escaped(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+}
+
+bool IOTrace::enabled_ = false;
+
+void IOTrace::configure() { enabled_ = Process::environment.options.get_bool("PSIO_TRACE"); }
+
+void IOTrace::record(size_t unit, const char* key, bool wrt, size_t address, size_t size, double seconds) {
+    std::lock_guard<std::mutex> guard(lock_);
+    EntryStats& e = entries_[std::make_pair(unit, std::string(key))];
+    if (wrt) {
+        e.writes++;
+        e.bytes_written += size;
+        e.write_time += seconds;
+    } else {
+        e.reads++;
+        e.bytes_read += size;
+        e.read_time += seconds;
+    }
+    auto pos = position_.find(unit);
+    if (pos != position_.end() && pos->second != address) e.seeks++;
+    position_[unit] = address + size;
+}
+
+std::string IOTrace::json() {
+    std::lock_guard<std::mutex> guard(lock_);
+    std::stringstream json;
+    char buf[512];
+    json << "{\"entries\": [";
+    bool first = true;
+    for (const auto& kv : entries_) {
+        const EntryStats& e = kv.second;
+        std::snprintf(buf, sizeof(buf),
+                      "\"reads\": %zu, \"bytes_read\": %zu, \"read_time\": %.6e, \"writes\": %zu, "
+                      "\"bytes_written\": %zu, \"write_time\": %.6e, \"seeks\": %zu}",
+                      e.reads, e.bytes_read, e.read_time, e.writes, e.bytes_written, e.write_time, e.seeks);
+        json << (first ? "" : ", ") << "{\"unit\": " << kv.first.first << ", \"key\": \""
+             << escaped(kv.first.second) << "\", " << buf;
+        first = false;
+    }
+    json << "]}";
+    return json.str();
+}
+
+void IOTrace::report() {
+    std::vector<std::pair<std::pair<size_t, std::string>, EntryStats> > rows;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (entries_.empty() || !outfile) return;
+        rows.assign(entries_.begin(), entries_.end());
+    }
+
+    /* Heaviest traffic first, so the table can be cut off by eye */
+    std::sort(rows.begin(), rows.end(), [](const std::pair<std::pair<size_t, std::string>, EntryStats>& a,
+                                           const std::pair<std::pair<size_t, std::string>, EntryStats>& b) {
+        return a.second.bytes_read + a.second.bytes_written > b.second.bytes_read + b.second.bytes_written;
+    });
+
+    outfile->Printf("\n  ==> PSIO Trace <==\n\n");
+    outfile->Printf("    %4s  %-32s %8s %11s %9s %8s %11s %9s %8s\n", "Unit", "Key", "Reads", "Read [MB]",
+                    "Read [s]", "Writes", "Wrote [MB]", "Write [s]", "Seeks");
+    std::map<size_t, EntryStats> units;
+    for (const auto& row : rows) {
+        const EntryStats& e = row.second;
+        outfile->Printf("    %4zu  %-32.32s %8zu %11.3f %9.3f %8zu %11.3f %9.3f %8zu\n", row.first.first,
+                        row.first.second.c_str(), e.reads, e.bytes_read / 1.0e6, e.read_time, e.writes,
+                        e.bytes_written / 1.0e6, e.write_time, e.seeks);
+        EntryStats& u = units[row.first.first];
+        u.reads += e.reads;
+        u.writes += e.writes;
+        u.bytes_read += e.bytes_read;
+        u.bytes_written += e.bytes_written;
+        u.read_time += e.read_time;
+        u.write_time += e.write_time;
+        u.seeks += e.seeks;
+    }
+
+    /* Seeks per call say how scattered the access to a unit is */
+    outfile->Printf("\n    %4s  %8s %11s %9s %8s %11s %9s %8s %10s\n", "Unit", "Reads", "Read [MB]", "Read [s]",
+                    "Writes", "Wrote [MB]", "Write [s]", "Seeks", "Seeks/Call");
+    for (const auto& kv : units) {
+        const EntryStats& u = kv.second;
+        outfile->Printf("    %4zu  %8zu %11.3f %9.3f %8zu %11.3f %9.3f %8zu %10.3f\n", kv.first, u.reads,
+                        u.bytes_read / 1.0e6, u.read_time, u.writes, u.bytes_written / 1.0e6, u.write_time, u.seeks,
+                        u.seeks / (double)(u.reads + u.writes));
+    }
+    outfile->Printf("\n");
+
+    std::string path = Process::environment.options.get_str("PSIO_TRACE_FILE");
+    if (!path.empty()) {
+        std::ofstream out(path.c_str(), std::ios::app);
+        out << json() << std::endl;
+    }
+    clear();
+}
+
+void IOTrace::clear() {
+    std::lock_guard<std::mutex> guard(lock_);
+    entries_.clear();
+    position_.clear();
+}
+
+}  // namespace psi
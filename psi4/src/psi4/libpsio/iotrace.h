@@ -0,0 +1,72 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_iotrace_h_
+#define _psi_src_lib_libpsio_iotrace_h_
+
+#include <cstddef>
+#include <string>
+
+namespace psi {
+
+/**
+ * Per-(unit, key) PSIO traffic counters, kept while the option PSIO_TRACE
+ * is on (the option is looked at whenever a unit is opened).
+ *
+ * PSIO::read() and PSIO::write() report every call with its size, global
+ * address and wall time. A call that does not start where the previous one
+ * on the same unit ended counts as a seek. PSIOManager::psiclean() calls
+ * report(), which prints the table to the output file, appends it to
+ * PSIO_TRACE_FILE as one line of JSON if that is set, and starts over.
+ * The counters are shared by the whole process and locked, as the AIO
+ * thread reads and writes too.
+ */
+class IOTrace {
+   public:
+    /// Reread PSIO_TRACE
+    static void configure();
+    /// Is tracing on? Cheap enough for every read and write
+    static bool enabled() { return enabled_; }
+
+    /// One read (wrt = false) or write of size bytes of key, at global byte address of unit
+    static void record(size_t unit, const char* key, bool wrt, size_t address, size_t size, double seconds);
+
+    /// Print, optionally save, and clear everything recorded so far (no-op if nothing was)
+    static void report();
+    /// The records as a JSON object
+    static std::string json();
+    /// Forget everything recorded so far
+    static void clear();
+
+   private:
+    static bool enabled_;
+};
+
+}  // namespace psi
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+
+namespace psi {
+
+bool PSIO::get_mmap(size_t unit) {
+  std::string val;
+  val = filecfg_kwd("PSI", "MMAP", unit);
+  if (val.empty())
+    val = filecfg_kwd("PSI", "MMAP", -1);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "MMAP", unit);
+  if (val.empty())
+    val = filecfg_kwd("DEFAULT", "MMAP", -1);
+
+  return (val == "TRUE" || val == "true" || val == "1");
+}
+
+int PSIO::mapped(size_t unit) {
+  return psio_unit[unit].mmap;
+}
+
+namespace {
+/* Address space reserved for the mapping of one unit. The mapping grows in
+   place inside it, so views never move while the unit is open. */
+const size_t map_reserve = ((size_t) 1) << 42;
+}
+
+void PSIO::unmap(size_t unit) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+
+  if (this_unit->map != NULL) {
+    if (::munmap(this_unit->map, map_reserve) == -1)
+      psio_error(unit, PSIO_ERROR_MMAP);
+  }
+  this_unit->map = NULL;
+  this_unit->maplen = 0;
+}
+
+void PSIO::remap(size_t unit, size_t length) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  struct stat st;
+
+  if (this_unit->maplen >= length) return;
+
+  /* The file has grown through write() since the last mapping; map all of it */
+  if (::fstat(this_unit->vol[0].stream, &st) == -1)
+    psio_error(unit, PSIO_ERROR_MMAP);
+  if ((size_t) st.st_size < length)
+    psio_error(unit, PSIO_ERROR_READ);
+  if ((size_t) st.st_size > map_reserve)
+    psio_error(unit, PSIO_ERROR_MMAP);
+
+  if (this_unit->map == NULL) {
+    void *base = ::mmap(NULL, map_reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+      psio_error(unit, PSIO_ERROR_MMAP);
+    this_unit->map = (char *) base;
+    this_unit->maplen = 0;
+  }
+
+  /* Map the new tail over the reservation, from the page holding the old end;
+     pages mapped already are replaced by the same file pages, so views stay valid */
+  size_t pagesize = (size_t) ::sysconf(_SC_PAGESIZE);
+  size_t start = (this_unit->maplen / pagesize) * pagesize;
+  void *map = ::mmap(this_unit->map + start, (size_t) st.st_size - start, PROT_READ, MAP_SHARED | MAP_FIXED,
+                     this_unit->vol[0].stream, (off_t) start);
+  if (map == MAP_FAILED)
+    psio_error(unit, PSIO_ERROR_MMAP);
+  this_unit->maplen = (size_t) st.st_size;
+}
+
+const char* PSIO::map_view(size_t unit, psio_address address, size_t size) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+
+  if (!this_unit->mmap)
+    psio_error(unit, PSIO_ERROR_MMAP);
+
+  /* A mapped unit has exactly one volume, so pages are laid out contiguously */
+  size_t offset = address.page * PSIO_PAGELEN + address.offset;
+  remap(unit, offset + size);
+
+  return this_unit->map + offset;
+}
+
+}
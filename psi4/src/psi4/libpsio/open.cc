@@ -43,12 +43,13 @@
 #include <sstream>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/iotrace.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
 void PSIO::open(size_t unit, int status) {
   size_t i;
-  char *name, *path;
+  char *name;
   psio_ud *this_unit;
 
   /* check for too large unit */
@@ -63,6 +64,9 @@ void PSIO::open(size_t unit, int status) {
     psio_error(unit, PSIO_ERROR_MAXVOL);
   if (!(this_unit->numvols))
     this_unit->numvols = 1;
+  this_unit->stripe = get_stripe(unit) * PSIO_PAGELEN;
+
+  IOTrace::configure();
 
   /* Check to see if this unit is already open */
   for (i=0; i < this_unit->numvols; i++) {
@@ -80,25 +84,20 @@ void PSIO::open(size_t unit, int status) {
     Names names;
     for (i=0; i < this_unit->numvols; i++) {
       std::ostringstream oss;
-      get_volpath(unit, i, &path);
-      oss << path << name << "." << unit;
+      oss << volume_dir(unit, i) << name << "." << unit;
       const std::string fullpath = oss.str();
       typedef Names::const_iterator citer;
       citer n = names.find(fullpath);
       if (n != names.end())
         psio_error(unit, PSIO_ERROR_IDENTVOLPATH);
       names[fullpath] = 1;
-      free(path);
     }
   }
 
   /* Build the name for each volume and open the file */
   for (i=0; i < this_unit->numvols; i++) {
     char* fullpath;
-    get_volpath(unit, i, &path);
-
-    // A bit of a hack in psio open at the moment, breaks volumes and some error checking
-    std::string spath2 = PSIOManager::shared_object()->get_file_path(unit);
+    std::string spath2 = volume_dir(unit, i);
     const char* path2 = spath2.c_str();
 
     fullpath = (char*) malloc( (strlen(path2)+strlen(name)+80)*sizeof(char));
@@ -120,15 +119,30 @@ void PSIO::open(size_t unit, int status) {
 
     if(this_unit->vol[i].stream == -1)
       psio_error(unit,PSIO_ERROR_OPEN);
+  }
 
-    free(path);
+  /* Zero-copy views need a contiguous file, so only single-volume units are mapped */
+  this_unit->mmap = (get_mmap(unit) && this_unit->numvols == 1) ? 1 : 0;
+  this_unit->map = NULL;
+  this_unit->maplen = 0;
+
+  /* In-core units keep a paged image of the file (see CoreImage), which replaces any mapping */
+  bool resident = get_resident(unit);
+  this_unit->incore = ((resident || get_incore(unit)) && this_unit->numvols == 1) ? 1 : 0;
+  this_unit->resident = (this_unit->incore && resident) ? 1 : 0;
+  if (this_unit->incore) {
+    this_unit->mmap = 0;
+    core_load(unit, status);
   }
+  /* A resident unit closed earlier left its contents in memory, not in the file */
+  core_unpark(unit, status);
 
   if (status == PSIO_OPEN_OLD) tocread(unit);
   else if (status == PSIO_OPEN_NEW) {
     /* Init the TOC stats and write them to disk */
     this_unit->toclen = 0;
     this_unit->toc = NULL;
+    tocindex_clear(unit);
     wt_toclen(unit, 0);
   }
   else psio_error(unit,PSIO_ERROR_OSTAT);
@@ -140,7 +154,7 @@ void PSIO::open(size_t unit, int status) {
 // status needs is assumed PSIO_OPEN_OLD if this is called
 bool PSIO::exists(size_t unit) {
   size_t i;
-  char *name, *path;
+  char *name;
   psio_ud *this_unit;
 
   if (unit > PSIO_MAXUNIT)
@@ -154,6 +168,7 @@ bool PSIO::exists(size_t unit) {
     psio_error(unit, PSIO_ERROR_MAXVOL);
   if (!(this_unit->numvols))
     this_unit->numvols = 1;
+  this_unit->stripe = get_stripe(unit) * PSIO_PAGELEN;
 
   /* Check to see if this unit is already open, if so, should be good.
      If every volume has a sream value other than -1, it's open */
@@ -175,15 +190,13 @@ bool PSIO::exists(size_t unit) {
     Names names;
     for (i=0; i < this_unit->numvols; i++) {
       std::ostringstream oss;
-      get_volpath(unit, i, &path);
-      oss << path << name << "." << unit;
+      oss << volume_dir(unit, i) << name << "." << unit;
       const std::string fullpath = oss.str();
       typedef Names::const_iterator citer;
       citer n = names.find(fullpath);
       if (n != names.end())
         psio_error(unit, PSIO_ERROR_IDENTVOLPATH);
       names[fullpath] = 1;
-      free(path);
     }
   }
 
@@ -192,10 +205,7 @@ bool PSIO::exists(size_t unit) {
   for (i=0; i < this_unit->numvols; i++) {
     char* fullpath;
     int stream;
-    get_volpath(unit, i, &path);
-
-    // A bit of a hack in psio open at the moment, breaks volumes and some error checking
-    std::string spath2 = PSIOManager::shared_object()->get_file_path(unit);
+    std::string spath2 = volume_dir(unit, i);
     const char* path2 = spath2.c_str();
 
     fullpath = (char*) malloc( (strlen(path2)+strlen(name)+80)*sizeof(char));
@@ -212,7 +222,6 @@ bool PSIO::exists(size_t unit) {
       file_exists = false;
     }
 
-    free(path);
     free(fullpath);
   }
 
@@ -29,6 +29,7 @@
 #ifndef _psi_src_lib_libpsio_psio_hpp_
 #define _psi_src_lib_libpsio_psio_hpp_
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <set>
@@ -190,6 +191,7 @@ public:
    The following example best demonstrates how to configure a PSIO instance Lib:
    Lib->filecfg_kwd("DEFAULT","NAME",-1,"newwfn")      // all modules will set filename prefix to newwfn for all units
    Lib->filecfg_kwd("DEFAULT","NVOLUME",34,"2")        // all modules will stripe unit 34 over 2 volumes
+   Lib->filecfg_kwd("DEFAULT","STRIPE",34,"16")        // ... in stripes of 16 pages (1 MiB)
    Lib->filecfg_kwd("CINTS","VOLUME1",-1,"/scratch1/") // module CINTS will access volume 1 of all units under /scratch
    etc.
 
@@ -213,7 +215,16 @@ public:
        PSIO understands the following keywords: "name" (specifies the prefix for the filename,
        i.e. if name is set to "psi" then unit 35 will be named "psi.35"), "nvolume" (number of files over which
        to stripe this unit, cannot be greater than PSIO_MAXVOL), "volumeX", where X is a positive integer less than or equal to
-       the value of "nvolume".
+       the value of "nvolume" (volume 1 always lives in the scratch directory of PSIOManager), "stripe" (number of
+       PSIO_PAGELEN pages written to one volume before the next; transfers longer than that go to the volumes
+       from concurrent threads), "mmap" (if "TRUE", reads on a single-volume unit are served from a shared
+       memory mapping of the file, and read_view() can hand out zero-copy views; takes effect at open()), and
+       "incore" (if "TRUE", the whole unit is held in memory while it is open: pages of an old file are read
+       as they are first touched, and the image is written back at close() only if the file is kept; under
+       SCRATCH_MEMORY_LIMIT the least recently used pages spill to the file early; takes precedence over "mmap"), and
+       "resident" (if "TRUE", an in-core unit that is kept at close() stays in process memory instead of being
+       written out, and the next open() of the same file picks the image up again; implies "incore"). Without
+       a "resident" keyword, the option SCRATCH_IN_MEMORY decides.
        */
     void filecfg_kwd(const char* kwdgrp, const char* kwd, int unit,
                      const char* kwdval);
@@ -237,6 +248,11 @@ public:
     /// return 1 if unit is open
     int open_check(size_t unit);
     /** Reads data from within a TOC entry from a PSI file.
+       **
+       ** Threads may read the same open unit concurrently (each transfer is a
+       ** pread() at its own address); write(), tocdel() and tocclean() on that
+       ** unit wait for them, and they for it. Opening or closing a unit while it
+       ** is being read is not safe.
        **
        **  \param unit   = The PSI unit number used to identify the file to all
        **                  read and write functions.
@@ -266,10 +282,34 @@ public:
     void read_entry(size_t unit, const char *key, char *buffer, size_t size);
     void write_entry(size_t unit, const char *key, char *buffer, size_t size);
 
+    /** Returns a zero-copy view of data within a TOC entry of a memory-mapped unit.
+       **
+       ** Arguments are as for read(), minus the buffer. The unit must have been opened
+       ** with the "MMAP" or "INCORE" file keyword set (see mapped() and in_core()). The
+       ** view is read-only. On a mapped unit it stays valid until the unit is closed:
+       ** the mapping grows in place, so reads and writes by any thread do not move it,
+       ** but a later write() over the same bytes shows through the view. On an in-core
+       ** unit it stays valid until the calling thread's next view of the unit, or until
+       ** its page is spilled under SCRATCH_MEMORY_LIMIT.
+       */
+    const char* read_view(size_t unit, const char *key, size_t size,
+                          psio_address start, psio_address *end);
+    /// Zero-copy view of a whole TOC entry, see read_view()
+    const char* read_entry_view(size_t unit, const char *key, size_t size);
+    /// return 1 if reads on unit are served from a memory mapping
+    int mapped(size_t unit);
+    /// return 1 if unit is held entirely in memory
+    int in_core(size_t unit);
+    /// return 1 if unit will stay in process memory when closed and kept
+    int resident(size_t unit);
+
     /** Zeros out a double precision array in a PSI file.
        ** Typically used before striping out a transposed array
        **  Total fill size is rows*cols*sizeof(double)
        **  Buffer memory of cols*sizeof(double) is used
+       **  A new entry of an on-disk unit only has zeros written over file space
+       **  that already holds (stale) bytes; the files are extended over the rest,
+       **  which the filesystem keeps as holes until they are written
        **
        **  \param unit    = The PSI unit number used to identify the file
        **  \param key     = The TOC keyword identifying the desired entry.
@@ -314,6 +354,13 @@ public:
     /// Change file FILENO from NS1 to NS2
     static void change_file_namespace(size_t fileno, const std::string & ns1, const std::string & ns2);
 
+    /// Re-key the parked image of a resident unit after its file moved from old_path to new_path
+    static void resident_move(const std::string& old_path, const std::string& new_path);
+    /// Forget the parked image of the file at path, if any (the file is being deleted)
+    static void resident_drop(const std::string& path);
+    /// Write the parked image of the file at path out to it and forget it, if any
+    static void resident_flush(const std::string& path);
+
     /// Return the global shared object
     static std::shared_ptr<PSIO> shared_object();
 
@@ -329,6 +376,11 @@ public:
        */
     size_t rd_toclen(size_t unit);
 
+    /// Entry bytes read (or handed out as views) through this object so far
+    size_t bytes_read() const { return bytes_read_; }
+    /// Entry bytes written through this object so far
+    size_t bytes_written() const { return bytes_written_; }
+
     /// grab the filename of unit and strdup into name.
     void get_filename(size_t unit, char **name, bool remove_namespace = false);
 
@@ -355,12 +407,52 @@ private:
     size_t *psio_writlen;
 #endif
 
+    /// Running totals behind bytes_read()/bytes_written(); the AIO thread updates them too
+    std::atomic<size_t> bytes_read_;
+    std::atomic<size_t> bytes_written_;
+
     /// Library state variable
     int state_;
     /// return the number of volumes over which unit will be striped
     size_t get_numvols(size_t unit);
+    /// return the number of pages laid out on one volume of unit before the next takes over
+    size_t get_stripe(size_t unit);
+    /// return true if unit is configured to be memory mapped
+    bool get_mmap(size_t unit);
+    /// map (at least) the first length bytes of a mapped unit, growing the mapping in place if needed
+    void remap(size_t unit, size_t length);
+    /// release the mapping of unit, if any
+    void unmap(size_t unit);
+    /// pointer to size bytes at global address within the mapping of unit
+    const char* map_view(size_t unit, psio_address address, size_t size);
+    /// return true if unit is configured to be held in memory
+    bool get_incore(size_t unit);
+    /// return true if unit is configured to outlive close() in memory (keyword "resident" or SCRATCH_IN_MEMORY)
+    bool get_resident(size_t unit);
+    /// hand the image of a closing resident unit to the parked store
+    void core_park(size_t unit);
+    /// take the parked image of the file just opened as unit, or write it to the file if unit is not in core
+    void core_unpark(size_t unit, int status);
+    /// read/write size bytes at global address of an in-core unit, growing it on writes
+    void core_rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
+    /// start the in-core image of unit over its freshly opened volume (read lazily if status is PSIO_OPEN_OLD)
+    void core_load(size_t unit, int status);
+    /// write the in-core image of unit back to its volume
+    void core_flush(size_t unit);
+    /// release the in-core image of unit, if any
+    void core_free(size_t unit);
+    /// bounds-check a read of size bytes at entry-relative start and return its global address
+    psio_address entry_address(size_t unit, const char *key, size_t size,
+                               psio_address start, psio_address *end);
+    /// entry_address() for a reader holding the unit's lock shared
+    psio_address locked_entry_address(size_t unit, psio_unit_lock &lock, const char *key, size_t size,
+                                      psio_address start, psio_address *end);
+    /// grow the mapping of a mapped unit over size bytes at start_data, if needed, for a shared holder of lock
+    void prepare_read(size_t unit, psio_unit_lock &lock, psio_address start_data, size_t size);
     /// grab the path to volume of unit and strdup into path.
     void get_volpath(size_t unit, size_t volume, char **path);
+    /// directory (with trailing slash) that holds the given volume of unit
+    std::string volume_dir(size_t unit, size_t volume);
     /// return the last TOC entry
     psio_tocentry* toclast(size_t unit);
     /// Compute the length of the TOC for a given unit using the in-core TOC list.
@@ -374,6 +466,10 @@ private:
     void wt_toclen(size_t unit, size_t toclen);
     /// Read the table of contents for file number 'unit'.
     void tocread(size_t unit);
+    /// The entry for key in the TOC of the open unit 'unit', or NULL, through the key index
+    psio_tocentry* tocfind(size_t unit, const char *key);
+    /// Drop the key index of unit's TOC (the next lookup rebuilds it)
+    void tocindex_clear(size_t unit);
 
     friend class AIO_Handler;
 
@@ -33,6 +33,7 @@
 
 #include <cstdlib>
 #include <unistd.h>
+#include <chrono>
 #include <cstring>
  #include "psi4/pragma.h"
  PRAGMA_WARNING_PUSH
@@ -41,18 +42,17 @@
  PRAGMA_WARNING_POP
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/coreimage.h"
+#include "psi4/libpsio/iotrace.h"
 
 namespace psi {
 
-void PSIO::read(size_t unit, const char *key, char *buffer, size_t size,
-                psio_address start, psio_address *end) {
-  psio_ud *this_unit;
+psio_address PSIO::entry_address(size_t unit, const char *key, size_t size,
+                                 psio_address start, psio_address *end) {
   psio_tocentry *this_entry;
   psio_address start_toc, start_data, end_data; /* global addresses */
   size_t tocentry_size;
 
-  this_unit = &(psio_unit[unit]);
-
   /* Find the entry in the TOC */
   this_entry = tocscan(unit, key);
 
@@ -91,12 +91,71 @@ void PSIO::read(size_t unit, const char *key, char *buffer, size_t size,
     *end = psio_get_address(start, size);
   }
 
+  return start_data;
+}
+
+void PSIO::prepare_read(size_t unit, psio_unit_lock &lock, psio_address start_data, size_t size) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+  if (!this_unit->mmap || this_unit->maplen >= start_data.page * PSIO_PAGELEN + start_data.offset + size)
+    return;
+  lock.exclusive();
+  remap(unit, start_data.page * PSIO_PAGELEN + start_data.offset + size);
+  lock.shared();
+}
+
+psio_address PSIO::locked_entry_address(size_t unit, psio_unit_lock &lock, const char *key, size_t size,
+                                        psio_address start, psio_address *end) {
+  /* The key index is built by the first lookup; do that one alone */
+  if (psio_unit[unit].tocindex == NULL && open_check(unit)) {
+    lock.exclusive();
+    tocfind(unit, key);
+    lock.shared();
+  }
+  return entry_address(unit, key, size, start, end);
+}
+
+void PSIO::read(size_t unit, const char *key, char *buffer, size_t size,
+                psio_address start, psio_address *end) {
+  psio_unit_lock lock(&(psio_unit[unit]), false);
+  psio_address start_data = locked_entry_address(unit, lock, key, size, start, end);
+  prepare_read(unit, lock, start_data, size);
+
   /* Now read the actual data from the unit */
-  rw(unit, buffer, start_data, size, 0);
+  if (IOTrace::enabled()) {
+    auto t0 = std::chrono::steady_clock::now();
+    rw(unit, buffer, start_data, size, 0);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    IOTrace::record(unit, key, false, start_data.page * PSIO_PAGELEN + start_data.offset, size, dt.count());
+  } else {
+    rw(unit, buffer, start_data, size, 0);
+  }
+
+  bytes_read_ += size;
+#ifdef PSIO_STATS
+  psio_readlen[unit] += size;
+#endif
+}
 
+const char* PSIO::read_view(size_t unit, const char *key, size_t size,
+                            psio_address start, psio_address *end) {
+  psio_unit_lock lock(&(psio_unit[unit]), false);
+  psio_address start_data = locked_entry_address(unit, lock, key, size, start, end);
+  if (!psio_unit[unit].incore) prepare_read(unit, lock, start_data, size);
+
+  /* Hand out a pointer into the mapping instead of copying */
+  const char* view;
+  if (psio_unit[unit].incore)
+    view = psio_unit[unit].core->view(start_data.page * PSIO_PAGELEN + start_data.offset, size);
+  else
+    view = map_view(unit, start_data, size);
+  if (IOTrace::enabled())
+    IOTrace::record(unit, key, false, start_data.page * PSIO_PAGELEN + start_data.offset, size, 0.0);
+
+  bytes_read_ += size;
 #ifdef PSIO_STATS
   psio_readlen[unit] += size;
 #endif
+  return view;
 }
 
   /*!
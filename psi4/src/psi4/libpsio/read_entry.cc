@@ -41,6 +41,11 @@ void PSIO::read_entry(size_t unit, const char *key, char *buffer, size_t size) {
   read(unit, key, buffer, size, PSIO_ZERO, &end);
 }
 
+const char* PSIO::read_entry_view(size_t unit, const char *key, size_t size) {
+  psio_address end;
+  return read_view(unit, key, size, PSIO_ZERO, &end);
+}
+
   /*!
    ** PSIO_READ_ENTRY(): Reads an entire TOC entry from a PSI file.
    **
@@ -67,6 +67,8 @@ void PSIO::rename_file(size_t old_unit, size_t new_unit) {
   sprintf(old_full_path, "%s%s.%zu", old_path, old_name, old_unit);
   sprintf(new_full_path, "%s%s.%zu", new_path, new_name, new_unit);
 
+  PSIO::resident_move(old_full_path, new_full_path);
+
   /* move the file.  i don't know how to do this without a system call */
   char*systemcall =
       (char*)malloc((strlen(old_full_path)+strlen(new_full_path)+100)*sizeof(char));
@@ -74,6 +76,16 @@ void PSIO::rename_file(size_t old_unit, size_t new_unit) {
   int returnvalue=system(systemcall);
 
   free(systemcall);
+
+  /* The further volumes of a striped unit follow their first one */
+  size_t numvols = get_numvols(old_unit);
+  for (size_t vol = 1; vol < numvols; vol++) {
+    std::string old_vol = volume_dir(old_unit, vol) + old_name + "." + std::to_string(old_unit);
+    std::string new_vol = volume_dir(new_unit, vol) + new_name + "." + std::to_string(new_unit);
+    std::string call = "mv " + old_vol + " " + new_vol;
+    returnvalue = system(call.c_str());
+  }
+
   free(old_name);
   free(new_name);
   free(old_full_path);
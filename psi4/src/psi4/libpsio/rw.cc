@@ -31,7 +31,11 @@
  \ingroup PSIO
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
 #include <unistd.h>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
@@ -39,96 +43,96 @@
 
 namespace psi {
 
+namespace {
+/* One piece of a transfer that is contiguous on its volume */
+struct Extent {
+  off_t local;
+  size_t buf_offset;
+  size_t size;
+};
+
+/* pread()/pwrite() all of size bytes; false if the volume ends or fails first */
+bool transfer(int stream, char *buffer, size_t size, off_t offset, int wrt) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = wrt ? ::pwrite(stream, buffer + done, size - done, offset + done)
+                    : ::pread(stream, buffer + done, size - done, offset + done);
+    if (n <= 0) return false;
+    done += n;
+  }
+  return true;
+}
+
+bool transfer_all(int stream, char *buffer, const std::vector<Extent>& extents, int wrt) {
+  for (const Extent& e : extents)
+    if (!transfer(stream, buffer + e.buf_offset, e.size, e.local, wrt)) return false;
+  return true;
+}
+}
+
 void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size,
               int wrt) {
-  int errcod;
-  size_t i;
-  size_t errcod_uli;
-  size_t page, offset;
-  size_t buf_offset;
-  size_t this_page, this_page_max, this_page_total;
-  size_t first_vol, this_vol, numvols;
-  size_t bytes_left, num_full_pages;
-  psio_ud *this_unit;
-
-  this_unit = &(psio_unit[unit]);
-  numvols = this_unit->numvols;
-  page = address.page;
-  offset = address.offset;
-
-  /* Seek all volumes to correct starting positions */
-  first_vol = page % numvols;
-  errcod = psio_volseek(&(this_unit->vol[first_vol]), page, offset, numvols);
-  if (errcod == -1)
-    psio_error(unit, PSIO_ERROR_LSEEK);
-  for (i=1, this_page=page+1; i < numvols; i++, this_page++) {
-    this_vol = this_page % numvols;
-    errcod = psio_volseek(&(this_unit->vol[this_vol]), this_page, (size_t) 0,
-                          numvols);
-    if (errcod == -1)
-      psio_error(unit, PSIO_ERROR_LSEEK);
+  psio_ud *this_unit = &(psio_unit[unit]);
+  size_t numvols = this_unit->numvols;
+
+  /* In-core units never touch the file between open() and close() */
+  if (this_unit->incore) {
+    core_rw(unit, buffer, address, size, wrt);
+    return;
   }
 
-  /* Number of bytes left on the first page */
-  this_page_max = PSIO_PAGELEN - offset;
-
-  /* If we have enough room on this page, use it */
-  if (size <= this_page_max)
-    this_page_total = size;
-  else
-    this_page_total = this_page_max;
-  buf_offset = 0;
-  if (wrt) {
-      errcod_uli =:: write(this_unit->vol[first_vol].stream, &(buffer[buf_offset]),
-          this_page_total);
-    if(errcod_uli != this_page_total) psio_error(unit,PSIO_ERROR_WRITE);
+  /* Mapped units serve reads straight from the page cache; writes still go
+     through write(), which the shared mapping sees coherently */
+  if (this_unit->mmap && !wrt) {
+    const char* view = map_view(unit, address, size);
+    ::memcpy(buffer, view, size);
+    return;
   }
-  else {
-      errcod_uli = ::read(this_unit->vol[first_vol].stream, &(buffer[buf_offset]),
-          this_page_total);
-    if(errcod_uli != this_page_total)
-      psio_error(unit,PSIO_ERROR_READ);
+
+  int error = wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ;
+  size_t global = address.page * PSIO_PAGELEN + address.offset;
+
+  if (numvols == 1) {
+    if (!transfer(this_unit->vol[0].stream, buffer, size, (off_t) global, wrt))
+      psio_error(unit, error);
+    return;
   }
 
-  /* Total number of bytes remaining to be read/written */
-  bytes_left = size - this_page_total;
-
-  /* Read/Write all the full pages */
-  num_full_pages = bytes_left/PSIO_PAGELEN;
-  buf_offset += this_page_total;
-  for(i=0,this_page=page+1; i < num_full_pages; i++,this_page++) {
-    this_vol = this_page % numvols;
-    this_page_total = PSIO_PAGELEN;
-    if(wrt) {
-        errcod_uli = ::write(this_unit->vol[this_vol].stream, &(buffer[buf_offset]),
-            this_page_total);
-      if(errcod_uli != this_page_total) psio_error(unit,PSIO_ERROR_WRITE);
-    }
-    else {
-        errcod_uli = ::read(this_unit->vol[this_vol].stream, &(buffer[buf_offset]),
-            this_page_total);
-      if(errcod_uli != this_page_total)
-        psio_error(unit,PSIO_ERROR_READ);
-    }
-    buf_offset += this_page_total;
+  /* Stripe unit k of the unit lives on volume k % numvols, as unit k / numvols
+     of that volume's file */
+  size_t stripe = this_unit->stripe;
+  std::vector<std::vector<Extent> > extents(numvols);
+  for (size_t done = 0; done < size;) {
+    size_t k = (global + done) / stripe;
+    size_t in_stripe = (global + done) % stripe;
+    size_t n = std::min(size - done, stripe - in_stripe);
+    Extent e = {(off_t) ((k / numvols) * stripe + in_stripe), done, n};
+    extents[k % numvols].push_back(e);
+    done += n;
   }
 
-  /* Read/Write the final partial page */
-  bytes_left -= num_full_pages * PSIO_PAGELEN;
-  this_vol = this_page % numvols;
-  if(bytes_left) {
-    if(wrt) {
-        errcod_uli = ::write(this_unit->vol[this_vol].stream, &(buffer[buf_offset]),
-            bytes_left);
-      if(errcod_uli != bytes_left) psio_error(unit,PSIO_ERROR_WRITE);
-    }
-    else {
-        errcod_uli = ::read(this_unit->vol[this_vol].stream, &(buffer[buf_offset]),
-            bytes_left);
-      if(errcod_uli != bytes_left)
-        psio_error(unit,PSIO_ERROR_READ);
-    }
+  /* Anything beyond one stripe unit touches several volumes, which then
+     proceed concurrently, one thread each */
+  if (size <= stripe) {
+    for (size_t v = 0; v < numvols; v++)
+      if (!transfer_all(this_unit->vol[v].stream, buffer, extents[v], wrt))
+        psio_error(unit, error);
+    return;
   }
+
+  std::vector<char> ok(numvols, 1);
+  std::vector<std::thread> threads;
+  for (size_t v = 1; v < numvols; v++) {
+    if (extents[v].empty()) continue;
+    threads.emplace_back([&, v]() {
+      ok[v] = transfer_all(this_unit->vol[v].stream, buffer, extents[v], wrt);
+    });
+  }
+  ok[0] = transfer_all(this_unit->vol[0].stream, buffer, extents[0], wrt);
+  for (std::thread& t : threads) t.join();
+
+  for (size_t v = 0; v < numvols; v++)
+    if (!ok[v]) psio_error(unit, error);
 }
 
   /*!
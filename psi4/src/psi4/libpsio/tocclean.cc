@@ -47,6 +47,7 @@ void PSIO::tocclean(size_t unit, const char *key) {
   psio_ud *this_unit;
 
   this_unit = &(psio_unit[unit]);
+  psio_unit_lock lock(this_unit, true);
 
   this_entry = tocscan(unit, key);
   if (this_entry == NULL) {
@@ -65,6 +66,7 @@ void PSIO::tocclean(size_t unit, const char *key) {
   while ((last_entry != this_entry) && (last_entry != NULL)) {
     /* Now free all the remaining members */
     prev_entry = last_entry->last;
+    if (this_unit->tocindex) this_unit->tocindex->erase(last_entry->key);
     free(last_entry);
     last_entry = prev_entry;
     this_unit->toclen--;
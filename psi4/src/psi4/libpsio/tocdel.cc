@@ -46,21 +46,21 @@
 namespace psi {
 
 bool PSIO::tocdel(size_t unit, const char *key) {
+  psio_unit_lock lock(&(psio_unit[unit]), true);
   psio_tocentry *this_entry = tocscan(unit, key);
 
   if (this_entry == NULL) return false;
 
+  psio_ud *this_unit = &(psio_unit[unit]);
   psio_tocentry *last_entry = this_entry->last;
   psio_tocentry *next_entry = this_entry->next;
 
-  if(next_entry == NULL) last_entry->next = NULL;
-  else {
-    last_entry->next = next_entry;
-    next_entry->last = last_entry;
-  }
+  if (last_entry == NULL) this_unit->toc = next_entry;
+  else last_entry->next = next_entry;
+  if (next_entry != NULL) next_entry->last = last_entry;
 
+  if (this_unit->tocindex) this_unit->tocindex->erase(this_entry->key);
   free(this_entry);
-  psio_ud *this_unit = &(psio_unit[unit]);
   this_unit->toclen--;
 
   return true;
@@ -37,6 +37,7 @@
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/coreimage.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -61,6 +62,12 @@ size_t PSIO::rd_toclen(size_t unit) {
 
   this_unit = &(psio_unit[unit]);
 
+  if (this_unit->incore) {
+    if (this_unit->core->length() < sizeof(size_t)) return(0);
+    core_rw(unit, (char *) &len, PSIO_ZERO, sizeof(size_t), 0);
+    return(len);
+  }
+
   /* Seek vol[0] to its beginning */
   stream = this_unit->vol[0].stream;
 
@@ -85,6 +92,11 @@ void PSIO::wt_toclen(size_t unit, size_t len) {
 
   this_unit = &(psio_unit[unit]);
 
+  if (this_unit->incore) {
+    core_rw(unit, (char *) &len, PSIO_ZERO, sizeof(size_t), 1);
+    return;
+  }
+
   /* Seek vol[0] to its beginning */
   stream = this_unit->vol[0].stream;
 
@@ -52,6 +52,8 @@ void PSIO::tocread(size_t unit) {
   //if (!open_check(unit))
   //  ;
 
+  tocindex_clear(unit);
+
   /* grab the number of records */
   this_unit->toclen = rd_toclen(unit);
 
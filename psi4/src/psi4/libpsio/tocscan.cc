@@ -42,6 +42,26 @@
 
 namespace psi {
 
+psio_tocentry *PSIO::tocfind(size_t unit, const char *key) {
+  psio_ud *this_unit = &(psio_unit[unit]);
+
+  if (this_unit->tocindex == NULL) {
+    this_unit->tocindex = new psio_tocindex;
+    this_unit->tocindex->reserve(this_unit->toclen);
+    /* A key written twice resolves to its first entry, as a scan from the top would */
+    for (psio_tocentry *this_entry = this_unit->toc; this_entry != NULL; this_entry = this_entry->next)
+      this_unit->tocindex->emplace(this_entry->key, this_entry);
+  }
+
+  psio_tocindex::const_iterator it = this_unit->tocindex->find(key);
+  return (it == this_unit->tocindex->end() ? NULL : it->second);
+}
+
+void PSIO::tocindex_clear(size_t unit) {
+  delete psio_unit[unit].tocindex;
+  psio_unit[unit].tocindex = NULL;
+}
+
 psio_tocentry*PSIO::tocscan(size_t unit, const char *key) {
   psio_tocentry *this_entry;
 
@@ -54,18 +74,10 @@ psio_tocentry*PSIO::tocscan(size_t unit, const char *key) {
   bool already_open = open_check(unit);
   if(!already_open) open(unit, PSIO_OPEN_OLD);
 
-  this_entry = psio_unit[unit].toc;
-
-  while (this_entry != NULL) {
-    if (!strcmp(this_entry->key, key)) {
-      if(!already_open) close(unit, 1); // keep
-      return (this_entry);
-    }
-    this_entry = this_entry->next;
-  }
+  this_entry = tocfind(unit, key);
 
   if(!already_open) close(unit, 1); // keep
-  return (NULL);
+  return (this_entry);
 }
 
   /*!
@@ -91,18 +103,10 @@ bool PSIO::tocentry_exists(size_t unit, const char *key) {
   bool already_open = open_check(unit);
   if(!already_open) open(unit, PSIO_OPEN_OLD);
 
-  this_entry = psio_unit[unit].toc;
-
-  while (this_entry != NULL) {
-    if (!strcmp(this_entry->key, key)) {
-      if(!already_open) close(unit, 1); // keep
-      return (true);
-    }
-    this_entry = this_entry->next;
-  }
+  this_entry = tocfind(unit, key);
 
   if(!already_open) close(unit, 1); // keep
-  return (false);
+  return (this_entry != NULL);
 }
 
   /*!
@@ -32,6 +32,7 @@
  */
 
 #include <cstdlib>
+#include <chrono>
 #include <cstring>
  #include "psi4/pragma.h"
  PRAGMA_WARNING_PUSH
@@ -40,6 +41,7 @@
  PRAGMA_WARNING_POP
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/iotrace.h"
 
 namespace psi {
 
@@ -52,6 +54,7 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size,
   int dirty = 0;
 
   this_unit = &(psio_unit[unit]);
+  psio_unit_lock lock(this_unit, true);
 
   /* Find the entry in the TOC */
   this_entry = tocscan(unit, key);
@@ -81,6 +84,7 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size,
       last_entry->next = this_entry;
       this_entry->last = last_entry;
     }
+    if (this_unit->tocindex) (*this_unit->tocindex)[this_entry->key] = this_entry;
 
     /* compute important global addresses for the entry */
     start_toc = this_entry->sadd;
@@ -138,8 +142,16 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size,
     rw(unit, (char *) this_entry, start_toc, tocentry_size, 1);
 
   /* Now write the actual data to the unit */
-  rw(unit, buffer, start_data, size, 1);
+  if (IOTrace::enabled()) {
+    auto t0 = std::chrono::steady_clock::now();
+    rw(unit, buffer, start_data, size, 1);
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    IOTrace::record(unit, key, true, start_data.page * PSIO_PAGELEN + start_data.offset, size, dt.count());
+  } else {
+    rw(unit, buffer, start_data, size, 1);
+  }
 
+  bytes_written_ += size;
 #ifdef PSIO_STATS
   psio_writlen[unit] += size;
 #endif
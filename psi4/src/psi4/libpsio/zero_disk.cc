@@ -38,7 +38,12 @@
  PRAGMA_WARNING_POP
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include <algorithm>
+#include <vector>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace psi {
 
@@ -47,12 +52,67 @@ void PSIO::zero_disk(size_t unit, const char *key, size_t rows, size_t cols) {
       double* buf = new double[cols];
       ::memset(static_cast<void*>(buf),'\0',cols*sizeof(double));
 
+      psio_ud *this_unit = &(psio_unit[unit]);
+      bool sparse = (rows > 1 && cols && !this_unit->incore && !tocentry_exists(unit, key));
+
       psio_address next_psio = PSIO_ZERO;
-      for (int i=0; i<rows; i++) {
+      for (int i=0; i<(sparse ? 1 : rows); i++) {
           PSIO::write(unit,key,(char *) (buf),
           sizeof(double)*cols,next_psio,&next_psio);
       }
 
+      if (sparse) {
+          /* The new entry is the last one: stretch it over the other rows
+             without writing them */
+          psio_unit_lock lock(this_unit, true);
+          psio_tocentry *this_entry = tocscan(unit, key);
+          if (this_entry->next != NULL)
+              psio_error(unit, PSIO_ERROR_BLKEND);
+
+          size_t tocentry_size = sizeof(psio_tocentry) - 2*sizeof(psio_tocentry *);
+          psio_address start_data = this_entry->eadd;
+          this_entry->eadd = psio_get_address(start_data, sizeof(double)*cols*(rows-1));
+          rw(unit, (char *) this_entry, this_entry->sadd, tocentry_size, 1);
+
+          size_t g0 = start_data.page * PSIO_PAGELEN + start_data.offset;
+          size_t g1 = this_entry->eadd.page * PSIO_PAGELEN + this_entry->eadd.offset;
+
+          /* Global bytes in stripe unit k live on volume k % numvols, at
+             (k / numvols) * stripe + offset in the unit (see rw()) */
+          size_t numvols = this_unit->numvols;
+          size_t stripe = (numvols == 1 ? g1 : this_unit->stripe);
+          std::vector<size_t> length(numvols), needed(numvols, 0);
+          for (size_t v = 0; v < numvols; v++) {
+              struct stat st;
+              if (::fstat(this_unit->vol[v].stream, &st) == -1)
+                  psio_error(unit, PSIO_ERROR_WRITE);
+              length[v] = (size_t) st.st_size;
+          }
+
+          for (size_t g = g0; g < g1;) {
+              size_t k = g / stripe;
+              size_t n = std::min(g1 - g, (k + 1) * stripe - g);
+              size_t v = k % numvols;
+              size_t local = (k / numvols) * stripe + g % stripe;
+              needed[v] = std::max(needed[v], local + n);
+
+              /* Space some earlier, deleted data still occupies gets real zeros */
+              size_t stale = (local < length[v] ? std::min(n, length[v] - local) : 0);
+              for (size_t done = 0; done < stale;) {
+                  size_t m = std::min(stale - done, sizeof(double)*cols);
+                  psio_address addr = {(g + done) / PSIO_PAGELEN, (g + done) % PSIO_PAGELEN};
+                  rw(unit, (char *) buf, addr, m, 1);
+                  done += m;
+              }
+              g += n;
+          }
+
+          for (size_t v = 0; v < numvols; v++) {
+              if (needed[v] > length[v] && ::ftruncate(this_unit->vol[v].stream, (off_t) needed[v]) == -1)
+                  psio_error(unit, PSIO_ERROR_WRITE);
+          }
+      }
+
       delete[] buf;
 }
 
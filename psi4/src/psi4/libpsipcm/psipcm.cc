@@ -35,12 +35,75 @@
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/petitelist.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
 #include <PCMSolver/PCMInput.h>
 
-
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
+/// What PCM() sets up before the SCF, kept for the next PCM object on the same system
+class PCMCavity {
+  public:
+    /// Molecule, basis, and PCMSolver input this was built for
+    std::string key;
+    pcmsolver_context_t * context = nullptr;
+    int ntess = 0;
+    int ntessirr = 0;
+    SharedMatrix tess_Zxyz;
+    std::vector<double> pot_n;
+    std::vector<double> charges_n;
+    /// Potential integrals of each tessera over the packed lower triangle of
+    /// Cartesian functions, or empty when they are computed on the fly
+    std::vector<double> ints;
+    size_t npair = 0;
+
+    ~PCMCavity() { if (context) pcmsolver_delete(context); }
+};
+
+namespace {
+/* Only the latest cavity is kept, geometry steps replace rather than pile up */
+std::shared_ptr<PCMCavity> last_cavity_;
+
+std::string cavity_key(std::shared_ptr<BasisSet> basisset, Options &options)
+{
+  std::shared_ptr<Molecule> molecule = basisset->molecule();
+  std::ostringstream key;
+  key << basisset->name() << "/" << basisset->nbf() << "/" << basisset->nao() << "/"
+      << options.get_bool("PCM_STORE_INTEGRALS") << "/" << options.get_double("PCM_SCREENING");
+  char buf[128];
+  for (int i = 0; i < molecule->natom(); ++i) {
+    snprintf(buf, sizeof(buf), "|%.10f,%.10f,%.10f,%.10f,%.10f", molecule->fZ(i), molecule->charge(i),
+             molecule->x(i), molecule->y(i), molecule->z(i));
+    key << buf;
+  }
+  // PCMSolver reads its own, already parsed, input from the working directory
+  std::ifstream input("@pcmsolver.inp");
+  if (input) key << "|" << input.rdbuf();
+  return key.str();
+}
+
+/* Stores the lower triangle of the integrals of each tessera */
+class StoreTesseraIntegralsFunctor
+{
+  protected:
+    double *ints_;
+    size_t npair_;
+  public:
+    StoreTesseraIntegralsFunctor(double *ints, size_t npair): ints_(ints), npair_(npair) {}
+    void operator()(int bf1, int bf2, int center, double integral)
+    {
+      if (bf1 >= bf2) ints_[center * npair_ + bf1 * (bf1 + 1) / 2 + bf2] = integral;
+    }
+};
+}
+
 void collect_atoms(std::shared_ptr<Molecule> molecule, double charges[], double centers[])
 {
     int nat = molecule->natom();
@@ -113,73 +176,112 @@ PCM::PCM(Options &options, std::shared_ptr<PSIO> /* psio */, int nirrep, std::sh
   my_aotoso_ = petite.aotoso();
 
   potential_int_ = static_cast<PCMPotentialInt*>(integrals->pcm_potentialint());
+  potential_int_->set_screening(options.get_double("PCM_SCREENING"));
 
   std::shared_ptr<Molecule> molecule = basisset->molecule();
 
-  /* PCMSolver needs to know who has to parse the input.
-   * We should have something like this here:
-   * int PSI4_provides_input = false;
-   * if (PSI4_has_pcmsolver_input) {
-   *    PSI4_provides_input = true;
-   * }
-   */
-  double * charges = new double[molecule->natom()];
-  double * coordinates = new double[3*molecule->natom()];
-  collect_atoms(molecule, charges, coordinates);
-  int symmetry_info[4] = {0, 0, 0, 0};
-  int PSI4_provides_input = false;
-  PCMInput host_input;
-  if (PSI4_provides_input) {
-    host_input = pcmsolver_input();
-    context_ = pcmsolver_new(PCMSOLVER_READER_HOST, molecule->natom(), charges, coordinates,
-                             symmetry_info, &host_input, host_writer);
+  std::string key = cavity_key(basisset, options);
+  if (last_cavity_ && last_cavity_->key == key) {
+    cavity_ = last_cavity_;
+    outfile->Printf("  Reusing the cavity and nuclear charges of the previous PCM calculation.\n");
   } else {
-    context_ = pcmsolver_new(PCMSOLVER_READER_OWN, molecule->natom(), charges, coordinates,
-                             symmetry_info, &host_input, host_writer);
+    // Let the old cavity and its integrals go before the new ones are made
+    last_cavity_.reset();
+    cavity_ = std::make_shared<PCMCavity>();
+    cavity_->key = key;
+
+    /* PCMSolver needs to know who has to parse the input.
+     * We should have something like this here:
+     * int PSI4_provides_input = false;
+     * if (PSI4_has_pcmsolver_input) {
+     *    PSI4_provides_input = true;
+     * }
+     */
+    double * charges = new double[molecule->natom()];
+    double * coordinates = new double[3*molecule->natom()];
+    collect_atoms(molecule, charges, coordinates);
+    int symmetry_info[4] = {0, 0, 0, 0};
+    int PSI4_provides_input = false;
+    PCMInput host_input;
+    if (PSI4_provides_input) {
+      host_input = pcmsolver_input();
+      cavity_->context = pcmsolver_new(PCMSOLVER_READER_HOST, molecule->natom(), charges, coordinates,
+                                       symmetry_info, &host_input, host_writer);
+    } else {
+      cavity_->context = pcmsolver_new(PCMSOLVER_READER_OWN, molecule->natom(), charges, coordinates,
+                                       symmetry_info, &host_input, host_writer);
+    }
+    delete [] charges;
+    delete [] coordinates;
+    cavity_->ntess = pcmsolver_get_cavity_size(cavity_->context);
+    cavity_->ntessirr = pcmsolver_get_irreducible_cavity_size(cavity_->context);
+    int ntess = cavity_->ntess;
+
+    int natom = molecule->natom();
+    SharedMatrix atom_Zxyz_ = SharedMatrix(new Matrix("Atom Zxyz", natom, 4));
+    for(int atom = 0; atom < natom; ++atom){
+      Vector3 xyz = molecule->xyz(atom);
+      atom_Zxyz_->set(atom, 0, molecule->charge(atom));
+      atom_Zxyz_->set(atom, 1, xyz[0]);
+      atom_Zxyz_->set(atom, 2, xyz[1]);
+      atom_Zxyz_->set(atom, 3, xyz[2]);
+    }
+
+    // The charge and {x,y,z} coordinates (in bohr) for each tessera
+    cavity_->tess_Zxyz = SharedMatrix(new Matrix("Tess Zxyz", ntess, 4));
+    double **ptess_Zxyz = cavity_->tess_Zxyz->pointer();
+    // Set the tesserae's coordinates (note the loop bounds; this function is 1-based)
+    for(int tess = 1; tess <= ntess; ++tess)
+        pcmsolver_get_center(cavity_->context, tess, &(ptess_Zxyz[tess-1][1]));
+
+    // Compute the nuclear potentials at the tesserae
+    double **patom_Zxyz = atom_Zxyz_->pointer();
+    cavity_->pot_n.assign(ntess, 0.0);
+    double *pot_n = cavity_->pot_n.data();
+    for(int atom = 0; atom < natom; ++atom){
+        double Z = patom_Zxyz[atom][0];
+        for(int tess = 0; tess < ntess; ++tess){
+            double dx = ptess_Zxyz[tess][1] - patom_Zxyz[atom][1];
+            double dy = ptess_Zxyz[tess][2] - patom_Zxyz[atom][2];
+            double dz = ptess_Zxyz[tess][3] - patom_Zxyz[atom][3];
+            double r = sqrt(dx*dx + dy*dy + dz*dz);
+            pot_n[tess] += Z / r;
+            if(r < 1.0E-3)
+                outfile->Printf("Warning! Tessera %d is only %.3f bohr from atom %d!\n", tess, r, atom+1);
+        }
+    }
+
+    // Compute the nuclear charges, since they don't change
+    cavity_->charges_n.assign(ntess, 0.0);
+    const char *potential_name = "NucMEP";
+    const char *charge_name = "NucASC";
+    pcmsolver_set_surface_function(cavity_->context, ntess, pot_n, potential_name);
+    int irrep = 0;
+    pcmsolver_compute_asc(cavity_->context, potential_name, charge_name, irrep);
+    pcmsolver_get_surface_function(cavity_->context, ntess, cavity_->charges_n.data(), charge_name);
+
+    last_cavity_ = cavity_;
   }
+
+  context_ = cavity_->context;
+  ntess_ = cavity_->ntess;
+  ntessirr_ = cavity_->ntessirr;
+  tess_Zxyz_ = cavity_->tess_Zxyz;
+  tess_pot_n_ = cavity_->pot_n.data();
+  tess_charges_n_ = cavity_->charges_n.data();
+
   pcmsolver_print(context_);
-  ntess_ = pcmsolver_get_cavity_size(context_);
-  ntessirr_ = pcmsolver_get_irreducible_cavity_size(context_);
   outfile->Printf("  There are %d tesserae, %d of which irreducible.\n\n",ntess_,ntessirr_);
   tess_pot_ = new double[ntess_];
   tess_pot_e_ = new double[ntess_];
-  tess_pot_n_ = new double[ntess_];
   tess_charges_e_ = new double[ntess_];
-  tess_charges_n_ = new double[ntess_];
   tess_charges_ = new double[ntess_];
 
-  int natom = molecule->natom();
-  SharedMatrix atom_Zxyz_ = SharedMatrix(new Matrix("Atom Zxyz", natom, 4));
-  for(int atom = 0; atom < natom; ++atom){
-    Vector3 xyz = molecule->xyz(atom);
-    atom_Zxyz_->set(atom, 0, molecule->charge(atom));
-    atom_Zxyz_->set(atom, 1, xyz[0]);
-    atom_Zxyz_->set(atom, 2, xyz[1]);
-    atom_Zxyz_->set(atom, 3, xyz[2]);
-  }
-
-  // The charge and {x,y,z} coordinates (in bohr) for each tessera
-  tess_Zxyz_ = SharedMatrix(new Matrix("Tess Zxyz", ntess_, 4));
-  double **ptess_Zxyz = tess_Zxyz_->pointer();
-  // Set the tesserae's coordinates (note the loop bounds; this function is 1-based)
-  for(int tess = 1; tess <= ntess_; ++tess)
-      pcmsolver_get_center(context_, tess, &(ptess_Zxyz[tess-1][1]));
-
-  // Compute the nuclear potentials at the tesserae
-  double **patom_Zxyz = atom_Zxyz_->pointer();
-  ::memset(tess_pot_n_, 0, ntess_*sizeof(double));
-  for(int atom = 0; atom < natom; ++atom){
-      double Z = patom_Zxyz[atom][0];
-      for(int tess = 0; tess < ntess_; ++tess){
-          double dx = ptess_Zxyz[tess][1] - patom_Zxyz[atom][1];
-          double dy = ptess_Zxyz[tess][2] - patom_Zxyz[atom][2];
-          double dz = ptess_Zxyz[tess][3] - patom_Zxyz[atom][3];
-          double r = sqrt(dx*dx + dy*dy + dz*dz);
-          tess_pot_n_[tess] += Z / r;
-          if(r < 1.0E-3)
-              outfile->Printf("Warning! Tessera %d is only %.3f bohr from atom %d!\n", tess, r, atom+1);
-      }
-  }
+  if (options.get_bool("PCM_STORE_INTEGRALS") && cavity_->ints.empty())
+    store_integrals(integrals, options.get_double("PCM_SCREENING"));
+  if (!cavity_->ints.empty())
+    outfile->Printf("  Tessera potential integrals are held in memory (%zu MiB).\n\n",
+                    cavity_->ints.size() * sizeof(double) / (1024 * 1024));
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -189,15 +291,6 @@ PCM::PCM(Options &options, std::shared_ptr<PSIO> /* psio */, int nirrep, std::sh
         outfile->Printf("tess[%4d] -> %16.10f\n", tess, tess_pot_n_[tess]);
   }
 
-  // Compute the nuclear charges, since they don't change
-  ::memset(tess_charges_n_, 0, ntess_*sizeof(double));
-  const char *potential_name = "NucMEP";
-  const char *charge_name = "NucASC";
-  pcmsolver_set_surface_function(context_, ntess_, tess_pot_n_, potential_name);
-  int irrep = 0;
-  pcmsolver_compute_asc(context_, potential_name, charge_name, irrep);
-  pcmsolver_get_surface_function(context_, ntess_, tess_charges_n_, charge_name);
-
   // A little debug info
   if(pcm_print_ > 2) {
     outfile->Printf("Nuclear ASC at each tessera:\n");
@@ -212,12 +305,102 @@ PCM::~PCM()
 {
   delete [] tess_pot_;
   delete [] tess_pot_e_;
-  delete [] tess_pot_n_;
   delete [] tess_charges_;
   delete [] tess_charges_e_;
-  delete [] tess_charges_n_;
+  // The cavity goes with the last PCM object sharing it
+}
+
+void PCM::store_integrals(std::shared_ptr<IntegralFactory> integrals, double screening)
+{
+  size_t nao = basisset_->nao();
+  size_t npair = nao * (nao + 1) / 2;
+  // Half of the memory at most, the SCF needs the rest
+  size_t bytes = (size_t) ntess_ * npair * sizeof(double);
+  if (bytes > (size_t) Process::environment.get_memory() / 2) {
+    outfile->Printf("  Tessera potential integrals (%zu MiB) do not fit, computing them on the fly.\n\n",
+                    bytes / (1024 * 1024));
+    return;
+  }
+  cavity_->npair = npair;
+  cavity_->ints.assign((size_t) ntess_ * npair, 0.0);
+
+  double **ptess_Zxyz = tess_Zxyz_->pointer();
+  for(int tess = 0; tess < ntess_; ++tess) ptess_Zxyz[tess][0] = 1.0;
+
+  int nshell = basisset_->nshell();
+  std::vector<int> offsets(nshell + 1, 0);
+  for (int P = 0; P < nshell; ++P)
+    offsets[P + 1] = offsets[P] + basisset_->shell(P).ncartesian();
+  std::vector<std::pair<int, int> > PQ_pairs;
+  for (int P = 0; P < nshell; ++P)
+    for (int Q = 0; Q <= P; ++Q)
+      PQ_pairs.push_back(std::make_pair(P, Q));
+
+  // PCMPotentialInt cannot be cloned, so each thread makes its own
+  int nthread = 1;
+#ifdef _OPENMP
+  nthread = Process::environment.get_n_threads();
+#endif
+  std::vector<std::shared_ptr<PCMPotentialInt> > ints;
+  for (int t = 0; t < nthread; ++t) {
+    ints.push_back(std::shared_ptr<PCMPotentialInt>(static_cast<PCMPotentialInt*>(integrals->pcm_potentialint())));
+    ints[t]->set_charge_field(tess_Zxyz_);
+    ints[t]->set_screening(screening);
+  }
+
+  StoreTesseraIntegralsFunctor store(cavity_->ints.data(), npair);
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+  for (long int PQ = 0L; PQ < (long int) PQ_pairs.size(); ++PQ) {
+    int thread = 0;
+#ifdef _OPENMP
+    thread = omp_get_thread_num();
+#endif
+    int P = PQ_pairs[PQ].first;
+    int Q = PQ_pairs[PQ].second;
+    ints[thread]->compute_pair(P, Q, offsets[P], offsets[Q], store);
+  }
+}
+
+void PCM::compute_potential(SharedMatrix D_carts, double *pot)
+{
+  if (cavity_->ints.empty()) {
+    ContractOverDensityFunctor contract_density_functor(ntess_, pot, D_carts);
+    // Add in the electronic contribution to the potential at each tessera
+    potential_int_->compute(contract_density_functor);
+    return;
+  }
 
-  pcmsolver_delete(context_);
+  // The integrals are symmetric, so the off-diagonal density counts twice
+  int nao = D_carts->rowdim();
+  double **Dp = D_carts->pointer();
+  std::vector<double> Dpacked(cavity_->npair);
+  for (int p = 0; p < nao; ++p) {
+    for (int q = 0; q < p; ++q)
+      Dpacked[p * (p + 1) / 2 + q] = Dp[p][q] + Dp[q][p];
+    Dpacked[p * (p + 1) / 2 + p] = Dp[p][p];
+  }
+  C_DGEMV('n', ntess_, cavity_->npair, 1.0, cavity_->ints.data(), cavity_->npair, Dpacked.data(), 1,
+          1.0, pot, 1);
+}
+
+SharedMatrix PCM::compute_V_cart(const double *charges)
+{
+  SharedMatrix V_pcm_cart = SharedMatrix(new Matrix("PCM potential cart", basisset_->nao(), basisset_->nao()));
+  if (cavity_->ints.empty()) {
+    ContractOverChargesFunctor contract_charges_functor(charges, V_pcm_cart);
+    potential_int_->compute(contract_charges_functor);
+    return V_pcm_cart;
+  }
+
+  int nao = basisset_->nao();
+  std::vector<double> Vpacked(cavity_->npair);
+  C_DGEMV('t', ntess_, cavity_->npair, 1.0, cavity_->ints.data(), cavity_->npair, const_cast<double*>(charges), 1,
+          0.0, Vpacked.data(), 1);
+  double **Vp = V_pcm_cart->pointer();
+  for (int p = 0; p < nao; ++p)
+    for (int q = 0; q <= p; ++q)
+      Vp[p][q] = Vp[q][p] = Vpacked[p * (p + 1) / 2 + q];
+  return V_pcm_cart;
 }
 
 double PCM::compute_E(SharedMatrix &D, CalcType type)
@@ -250,9 +433,8 @@ double PCM::compute_E_total(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  compute_potential(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -305,9 +487,8 @@ double PCM::compute_E_separate(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  compute_potential(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -375,9 +556,8 @@ double PCM::compute_E_electronic(SharedMatrix &D)
   }
   else D_carts = D;
 
-  ContractOverDensityFunctor contract_density_functor(ntess_, tess_pot_e_, D_carts);
   // Add in the electronic contribution to the potential at each tessera
-  potential_int_->compute(contract_density_functor);
+  compute_potential(D_carts, tess_pot_e_);
 
   // A little debug info
   if(pcm_print_ > 2) {
@@ -411,9 +591,7 @@ double PCM::compute_E_electronic(SharedMatrix &D)
 
 SharedMatrix PCM::compute_V()
 {
-  SharedMatrix V_pcm_cart = SharedMatrix(new Matrix("PCM potential cart", basisset_->nao(), basisset_->nao()));
-  ContractOverChargesFunctor contract_charges_functor(tess_charges_, V_pcm_cart);
-  potential_int_->compute(contract_charges_functor);
+  SharedMatrix V_pcm_cart = compute_V_cart(tess_charges_);
   // The potential might need to be transformed to the spherical harmonic basis
   SharedMatrix V_pcm_pure;
   if(basisset_->has_puream()){
@@ -426,9 +604,7 @@ SharedMatrix PCM::compute_V()
 
 SharedMatrix PCM::compute_V_electronic()
 {
-  SharedMatrix V_pcm_cart = SharedMatrix(new Matrix("PCM potential cart", basisset_->nao(), basisset_->nao()));
-  ContractOverChargesFunctor contract_charges_functor(tess_charges_e_, V_pcm_cart);
-  potential_int_->compute(contract_charges_functor);
+  SharedMatrix V_pcm_cart = compute_V_cart(tess_charges_e_);
   // The potential might need to be transformed to the spherical harmonic basis
   SharedMatrix V_pcm_pure;
   if(basisset_->has_puream()){
@@ -43,7 +43,9 @@
 
 namespace psi {
 class BasisSet;
+class IntegralFactory;
 class Options;
+class PCMCavity;
 using SharedMatrix=std::shared_ptr<Matrix>;
 
 class PCM {
@@ -57,6 +59,9 @@ class PCM {
     SharedMatrix compute_V_electronic(); // This is needed by the CC code (and maybe the LR-SCF code)
 
   protected:
+    /// Cavity, nuclear charges, and stored integrals; shared with later PCM
+    /// objects on the same molecule, basis, and PCMSolver input
+    std::shared_ptr<PCMCavity> cavity_;
     /// The number of tesserae in PCMSolver.
     int ntess_;
     /// The number of irreducible tesserae in PCMSolver.
@@ -81,6 +86,12 @@ class PCM {
     double compute_E_separate(SharedMatrix &D);
     /// Calculate electronic polarization energy (U_ee) only (for CC step)
     double compute_E_electronic(SharedMatrix &D);
+    /// Electronic potential at the tesserae from the (Cartesian) density D_carts
+    void compute_potential(SharedMatrix D_carts, double *pot);
+    /// Cartesian one-electron operator of the given tessera charges
+    SharedMatrix compute_V_cart(const double *charges);
+    /// Compute the nbf x nbf integrals of every tessera into the cavity, if they fit
+    void store_integrals(std::shared_ptr<IntegralFactory> integrals, double screening);
 
     /// Current basis set (for puream and nao/nso info)
     std::shared_ptr<BasisSet> basisset_;
@@ -0,0 +1,116 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Thread control shared by the BLAS and the explicitly threaded codes
+** \ingroup QT
+**
+** Codes that run their own workers around BLAS calls (the (T) and CC3
+** triples kernels, the SAD atoms) go through parallel_workers() or a
+** BlasThreadScope, so the process thread count is split between the
+** workers and the BLAS rather than multiplied. Workers are OpenMP
+** threads: OMP_PROC_BIND and OMP_PLACES pin them as they pin every other
+** threaded loop in the program.
+*/
+
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <algorithm>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
+
+namespace psi {
+
+int blas_get_num_threads()
+{
+#ifdef USING_LAPACK_MKL
+    return mkl_get_max_threads();
+#elif defined(_OPENMP)
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void blas_set_num_threads(int nthread)
+{
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(nthread);
+#endif
+    // Other BLAS either run serially or take their count from the OpenMP
+    // region they are called from, which parallel_workers() keeps at one
+}
+
+BlasThreadScope::BlasThreadScope(int nworker) : old_(blas_get_num_threads())
+{
+    int total = Process::environment.get_n_threads();
+    blas_set_num_threads(std::max(1, total / std::max(1, nworker)));
+}
+
+BlasThreadScope::~BlasThreadScope()
+{
+    blas_set_num_threads(old_);
+}
+
+void parallel_workers(int nworker, const std::function<void(int)>& work)
+{
+    BlasThreadScope blas(nworker);
+    std::exception_ptr error;
+
+    // The runtime may grant fewer threads than asked for; the survivors
+    // take the remaining worker indices in turn
+#pragma omp parallel num_threads(nworker)
+    {
+        int first = 0;
+        int stride = 1;
+#ifdef _OPENMP
+        first = omp_get_thread_num();
+        stride = omp_get_num_threads();
+#endif
+        for (int w = first; w < nworker; w += stride) {
+            try {
+                work(w);
+            } catch (...) {
+#pragma omp critical
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+}  // namespace psi
@@ -0,0 +1,353 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Low-overhead profiling regions with per-thread call trees
+** \ingroup QT
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "psi4/libqt/profile.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/psi4-dec.h"
+
+namespace psi {
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+/* Instances recorded per thread for PROFILE_TRACE_FILE before dropping */
+const size_t max_events = 1 << 20;
+
+enum { CYCLES = 0, INSTRUCTIONS = 1, NCOUNTERS = 2 };
+
+struct Node {
+    int id;
+    size_t calls = 0;
+    int64_t ns = 0;
+    uint64_t counts[NCOUNTERS] = {0, 0};
+    /* (region, node) of each child, searched linearly: a region has few */
+    std::vector<std::pair<int, int> > children;
+    explicit Node(int i) : id(i) {}
+};
+
+struct Frame {
+    int node;
+    int64_t start;
+    uint64_t counts[NCOUNTERS];
+};
+
+struct Event {
+    int id;
+    int depth;
+    int64_t start;
+    int64_t end;
+};
+
+struct ThreadState {
+    int tid;
+    std::vector<Node> nodes;
+    std::vector<Frame> stack;
+    std::vector<Event> events;
+    size_t dropped = 0;
+    int counter_fd = -1;
+    bool counters_tried = false;
+
+    explicit ThreadState(int t) : tid(t) { nodes.push_back(Node(-1)); }
+
+    int child(int parent, int id) {
+        for (const auto& c : nodes[parent].children)
+            if (c.first == id) return c.second;
+        int node = nodes.size();
+        nodes.push_back(Node(id));
+        nodes[parent].children.push_back(std::make_pair(id, node));
+        return node;
+    }
+};
+
+std::mutex lock_;
+std::map<std::string, int> ids_;
+std::vector<std::string> names_;
+std::vector<std::unique_ptr<ThreadState> > threads_;
+thread_local ThreadState* local_ = nullptr;
+
+bool counters_ = false;
+bool trace_ = false;
+clock::time_point epoch_ = clock::now();
+
+ThreadState& local() {
+    if (!local_) {
+        std::lock_guard<std::mutex> guard(lock_);
+        threads_.emplace_back(new ThreadState(threads_.size()));
+        local_ = threads_.back().get();
+    }
+    return *local_;
+}
+
+inline int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch_).count(); }
+
+/* Cycles and instructions of the calling thread, as one perf event group */
+void open_counters(ThreadState& t) {
+    t.counters_tried = true;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    int leader = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    if (leader < 0) return;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    int member = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+    if (member < 0) {
+        close(leader);
+        return;
+    }
+    t.counter_fd = leader;
+#endif
+}
+
+void read_counters(ThreadState& t, uint64_t* counts) {
+    counts[CYCLES] = counts[INSTRUCTIONS] = 0;
+#ifdef __linux__
+    if (!t.counters_tried) open_counters(t);
+    if (t.counter_fd < 0) return;
+    uint64_t buf[1 + NCOUNTERS];
+    if (read(t.counter_fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf)) {
+        counts[CYCLES] = buf[1];
+        counts[INSTRUCTIONS] = buf[2];
+    }
+#endif
+}
+
+/* The call trees of all threads, merged by region path */
+struct Merged {
+    size_t calls = 0;
+    int64_t ns = 0;
+    uint64_t counts[NCOUNTERS] = {0, 0};
+    int threads = 0;
+    std::map<int, Merged> children;
+};
+
+void merge(const ThreadState& t, int node, Merged& into) {
+    for (const auto& c : t.nodes[node].children) {
+        const Node& n = t.nodes[c.second];
+        Merged& m = into.children[c.first];
+        if (n.calls) {
+            m.calls += n.calls;
+            m.ns += n.ns;
+            for (int k = 0; k < NCOUNTERS; k++) m.counts[k] += n.counts[k];
+            m.threads++;
+        }
+        merge(t, c.second, m);
+    }
+}
+
+size_t total_calls(const Merged& m) {
+    size_t calls = m.calls;
+    for (const auto& c : m.children) calls += total_calls(c.second);
+    return calls;
+}
+
+void print(const Merged& m, const std::string& indent) {
+    for (const auto& c : m.children) {
+        const Merged& r = c.second;
+        if (!total_calls(r)) continue;
+        std::string key = indent + names_[c.first];
+        if (key.size() < 40) key.resize(40, ' ');
+        outfile->Printf("    %s %10zu %12.4f %7d", key.c_str(), r.calls, r.ns * 1.0e-9, r.threads);
+        if (counters_) {
+            outfile->Printf(" %12.4e %12.4e %6.2f", (double)r.counts[CYCLES], (double)r.counts[INSTRUCTIONS],
+                            r.counts[CYCLES] ? r.counts[INSTRUCTIONS] / (double)r.counts[CYCLES] : 0.0);
+        }
+        outfile->Printf("\n");
+        print(r, indent + "| ");
+    }
+}
+
+std::string escaped(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+/* Start over, keeping the trees (and so the regions still open) in place; lock_ is held */
+void reset() {
+    for (const auto& t : threads_) {
+        for (Node& n : t->nodes) {
+            n.calls = 0;
+            n.ns = 0;
+            n.counts[CYCLES] = n.counts[INSTRUCTIONS] = 0;
+        }
+        t->events.clear();
+        t->dropped = 0;
+    }
+}
+
+/* Chrome trace event format: one complete ("X") event per region instance */
+void write_trace(const std::string& path) {
+    std::ofstream out(path.c_str());
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    char buf[128];
+    for (const auto& t : threads_) {
+        for (const Event& e : t->events) {
+            std::snprintf(buf, sizeof(buf), "\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                          t->tid, e.start * 1.0e-3, (e.end - e.start) * 1.0e-3);
+            out << (first ? "" : ",\n") << "{\"name\": \"" << escaped(names_[e.id]) << buf;
+            first = false;
+        }
+    }
+    out << "]}" << std::endl;
+}
+
+}  // namespace
+
+bool Profile::enabled_ = false;
+
+void Profile::configure() {
+    counters_ = Process::environment.options.get_bool("PROFILE_COUNTERS");
+    trace_ = !Process::environment.options.get_str("PROFILE_TRACE_FILE").empty();
+    enabled_ = Process::environment.options.get_bool("PROFILE") || counters_ || trace_;
+}
+
+int Profile::id(const std::string& key) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = ids_.find(key);
+    if (it != ids_.end()) return it->second;
+    int id = names_.size();
+    names_.push_back(key);
+    ids_[key] = id;
+    return id;
+}
+
+void Profile::on(int id) {
+    if (!enabled_) return;
+    ThreadState& t = local();
+    Frame f;
+    f.node = t.child(t.stack.empty() ? 0 : t.stack.back().node, id);
+    if (counters_) read_counters(t, f.counts);
+    f.start = now();
+    t.stack.push_back(f);
+}
+
+void Profile::off(int id) {
+    if (!enabled_) return;
+    int64_t end = now();
+    ThreadState& t = local();
+    /* Opened before profiling was turned on */
+    if (t.stack.empty()) return;
+
+    const Frame& f = t.stack.back();
+    Node& n = t.nodes[f.node];
+    if (n.id != id) {
+        std::lock_guard<std::mutex> guard(lock_);
+        throw PsiException("Profile region " + names_[id] + " is not the innermost one open (" + names_[n.id] + ")",
+                           __FILE__, __LINE__);
+    }
+    n.calls++;
+    n.ns += end - f.start;
+    if (counters_) {
+        uint64_t counts[NCOUNTERS];
+        read_counters(t, counts);
+        for (int k = 0; k < NCOUNTERS; k++) n.counts[k] += counts[k] - f.counts[k];
+    }
+    if (trace_) {
+        if (t.events.size() < max_events) {
+            Event e = {id, (int)t.stack.size() - 1, f.start, end};
+            t.events.push_back(e);
+        } else {
+            t.dropped++;
+        }
+    }
+    t.stack.pop_back();
+}
+
+void Profile::report() {
+    std::lock_guard<std::mutex> guard(lock_);
+    Merged root;
+    size_t dropped = 0;
+    for (const auto& t : threads_) {
+        merge(*t, 0, root);
+        dropped += t->dropped;
+    }
+    if (!total_calls(root) || !outfile) return;
+
+    outfile->Printf("\n  ==> Profile <==\n\n");
+    outfile->Printf("    %-40s %10s %12s %7s", "Region", "Calls", "Wall [s]", "Threads");
+    if (counters_) outfile->Printf(" %12s %12s %6s", "Cycles", "Instructions", "IPC");
+    outfile->Printf("\n");
+    print(root, "");
+    outfile->Printf("\n    Wall time is summed over threads.\n");
+
+    std::string path = Process::environment.options.get_str("PROFILE_TRACE_FILE");
+    if (trace_ && !path.empty()) {
+        write_trace(path);
+        outfile->Printf("    Trace written to %s", path.c_str());
+        if (dropped) outfile->Printf(" (%zu region instances past %zu per thread dropped)", dropped, max_events);
+        outfile->Printf(".\n");
+    }
+    outfile->Printf("\n");
+
+    reset();
+}
+
+void Profile::clear() {
+    std::lock_guard<std::mutex> guard(lock_);
+    reset();
+}
+
+}  // namespace psi
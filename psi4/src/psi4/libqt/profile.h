@@ -0,0 +1,95 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libqt_profile_h_
+#define _psi_src_lib_libqt_profile_h_
+
+#include <string>
+
+namespace psi {
+
+/**
+ * Low-overhead profiling regions, kept while the option PROFILE is on (the
+ * option is looked at whenever a module starts).
+ *
+ * Unlike timer_on()/timer_off(), a region is named once: id() interns the
+ * name, and the number is what on() and off() take, so a call site keeps it
+ * in a static local,
+ *
+ *     static const int id = Profile::id("DFMP2 Gamma");
+ *     Profile::Scope region(id);
+ *
+ * Each thread accumulates calls and wall time into its own call tree, with
+ * no locking after a thread's first region; the trees are merged only by
+ * report(). Regions nest and may be used inside OpenMP parallel sections.
+ * With PROFILE_COUNTERS, each region also counts CPU cycles and
+ * instructions through Linux perf events. With PROFILE_TRACE_FILE, every
+ * region instance is also recorded and report() writes them out as a Chrome
+ * trace (viewable as a flame graph in about://tracing, Perfetto or
+ * speedscope). py_psi_clean() calls report(), which prints the merged tree
+ * to the output file and starts over.
+ */
+class Profile {
+   public:
+    /// Reread PROFILE, PROFILE_COUNTERS and PROFILE_TRACE_FILE
+    static void configure();
+    /// Is profiling on?
+    static bool enabled() { return enabled_; }
+
+    /// Number of the region called key, the same for every call with that key
+    static int id(const std::string& key);
+    /// Enter region id on the calling thread
+    static void on(int id);
+    /// Leave region id, which must be the innermost one open on the calling thread
+    static void off(int id);
+
+    /// Print, optionally save, and clear everything recorded so far (no-op if nothing was)
+    static void report();
+    /// Forget everything recorded so far
+    static void clear();
+
+    /// Region open for the lifetime of the object
+    class Scope {
+       public:
+        explicit Scope(int id) : id_(id) { Profile::on(id_); }
+        ~Scope() { Profile::off(id_); }
+
+       private:
+        int id_;
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+   private:
+    static bool enabled_;
+};
+
+}  // namespace psi
+
+#endif
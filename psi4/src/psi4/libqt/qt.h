@@ -40,6 +40,7 @@
 #define _psi_src_lib_libqt_qt_h_
 
 #include <cstdio>
+#include <functional>
 #include <string>
 #include "psi4/psi4-dec.h"
 // I think this is forward-declaring class Options -CDS
@@ -93,6 +94,31 @@ void parallel_timer_off(const std::string& key, int thread_rank);
 void start_skip_timers();
 void stop_skip_timers();
 
+/// Threads the BLAS/LAPACK library may use for each call
+int blas_get_num_threads();
+void blas_set_num_threads(int nthread);
+
+/**
+ * For its lifetime, holds the BLAS to the share of the process threads left
+ * for each of nworker workers, then restores the old count (exceptions
+ * included). For code that calls threaded BLAS from its own parallel loop.
+ */
+class BlasThreadScope {
+    int old_;
+    BlasThreadScope(const BlasThreadScope&);
+    BlasThreadScope& operator=(const BlasThreadScope&);
+public:
+    explicit BlasThreadScope(int nworker);
+    ~BlasThreadScope();
+};
+
+/**
+ * Runs work(0) ... work(nworker-1) concurrently on OpenMP threads, under a
+ * BlasThreadScope for nworker, and rethrows the first exception any of them
+ * threw. Every index runs exactly once even if fewer threads are granted.
+ */
+void parallel_workers(int nworker, const std::function<void(int)>& work);
+
 void print_block(double *, int, int, FILE *);
 
 int david(double **A, int N, int M, double *eps, double **v, double cutoff,
@@ -147,6 +173,10 @@ void C_DSYRK(char uplo, char trans, int n, int k, double alpha, double* a, int l
 void C_DSYR2K(char uplo, char trans, int n, int k, double alpha, double* a, int lda, double* b, int ldb, double beta, double* c, int ldc);
 void C_DTRSV(char uplo, char trans, char diag, int n, double* a, int lda, double* x, int incx);
 
+// BLAS 2/3 Single routines, for mixed-precision kernels
+void C_SGEMV(char trans, int m, int n, float alpha, float* a, int lda, float* x, int incx, float beta, float* y, int incy);
+void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b, int ldb, float beta, float* c, int ldc);
+
 
 // LAPACK 3.2 Double routines
 // Sorry guys, I know its rather epic
@@ -35,8 +35,11 @@ namespace psi { namespace sapt {
  * This dispersion evaluation will work with an arbitrary amount of memory,
  * however, it is not optimal if everything would fit in core.
  *
- * This exists only for debugging purposes to test the accuracy of Laplace
- * denominators.
+ * Disp20 is assembled from the denominator vectors as a sum over the
+ * quadrature points of X_PQ Y_PQ contractions, so no (ar|bs) quantity is
+ * ever formed.  With SAPT0_LAPLACE_DISP this is the production Disp20 and
+ * exch_disp20_n5() only screens in the exchange terms; otherwise it exists
+ * for debugging purposes to test the accuracy of the denominators.
  *
  */
 void SAPT0::disp20()
@@ -116,7 +119,7 @@ void SAPT0::disp20()
   free_block(T_p_AR);
   free_block(T_p_BS);
 
-  if (print_) {
+  if (print_ && !laplace_disp_) {
     outfile->Printf("    Disp20              = %18.12lf [Eh]\n",e_disp20_);
 
   }
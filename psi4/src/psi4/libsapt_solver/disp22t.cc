@@ -30,6 +30,36 @@
 
 namespace psi { namespace sapt {
 
+namespace {
+
+// Sum over ar, a1r1 of (4 t1 - 2 t2) t1 / D, with t1 = w[ar][a1r1] + w[a1r1][ar],
+// t2 the same with r and r1 swapped, and D = e_a + e_a1 - e_r - e_r1 + e_bs
+double disp22t_energy(double **w, int aocc, int nvir, const double *eocc,
+  const double *evir, double e_bs)
+{
+  double energy = 0.0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:energy)
+  for(int a=0; a<aocc; a++) {
+  for(int r=0; r<nvir; r++) {
+    int ar = a*nvir+r;
+    for(int a1=0,a1r1=0; a1<aocc; a1++) {
+      double e_ara1 = eocc[a]+eocc[a1]-evir[r]+e_bs;
+      int a1r = a1*nvir+r;
+      for(int r1=0; r1<nvir; r1++,a1r1++) {
+        int ar1 = a*nvir+r1;
+        double tval1 = w[ar][a1r1]+w[a1r1][ar];
+        double tval2 = w[a1r][ar1]+w[ar1][a1r];
+        energy += ((4.0*tval1-2.0*tval2)*tval1)/(e_ara1-evir[r1]);
+      }
+    }
+  }}
+
+  return(energy);
+}
+
+}
+
 void SAPT2p::disp22t()
 {
   if (print_) {
@@ -297,7 +327,7 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel,
   double **B_p_AA = get_DF_ints(AAfile,AAlabel,foccA,noccA,foccA,noccA);
   double **B_p_AR = get_DF_ints(AAfile,ARlabel,foccA,noccA,0,nvirA);
   double **B_p_RR = get_DF_ints(AAfile,RRlabel,0,nvirA,0,nvirA);
-  double *B_p_bs = init_array(ndf_+3);
+  double **B_p_bS = block_matrix(nvirB,ndf_+3);
 
   double **C_p_AR = block_matrix(aoccA*nvirA,ndf_+3);
 
@@ -308,12 +338,15 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel,
   time_t stop;
 
   for(int b=0,bs=0; b<aoccB; b++) {
-  for(int s=0; s<nvirB; s++,bs++) {
 
-    psio_address next_DF_BS = psio_get_address(PSIO_ZERO,
-      sizeof(double)*(b+foccB)*nvirB*(ndf_+3) + sizeof(double)*s*(ndf_+3));
-    psio_->read(BBfile,BSlabel,(char *) &(B_p_bs[0]),sizeof(double)*(ndf_+3),
-      next_DF_BS,&next_DF_BS);
+  // All (bs|P) of this b in one read
+  psio_address next_DF_BS = psio_get_address(PSIO_ZERO,
+    sizeof(double)*(b+foccB)*nvirB*(ndf_+3));
+  psio_->read(BBfile,BSlabel,(char *) &(B_p_bS[0][0]),
+    sizeof(double)*nvirB*(ndf_+3),next_DF_BS,&next_DF_BS);
+
+  for(int s=0; s<nvirB; s++,bs++) {
+    double *B_p_bs = B_p_bS[s];
 
     C_DGEMV('n',aoccA*nvirA,ndf_+3,1.0,B_p_AR[0],ndf_+3,B_p_bs,1,
       0.0,tbsAR[0],1);
@@ -341,19 +374,8 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel,
     C_DGEMM('N','T',aoccA*nvirA,aoccA*nvirA,ndf_+3,1.0,&(B_p_AR[0][0]),ndf_+3,
       &(C_p_AR[0][0]),ndf_+3,1.0,&(wARAR[0][0]),aoccA*nvirA);
 
-    for(int a=0,ar=0; a<aoccA; a++) {
-    for(int r=0; r<nvirA; r++,ar++) {
-      for(int a1=0,a1r1=0; a1<aoccA; a1++) {
-      for(int r1=0; r1<nvirA; r1++,a1r1++) {
-        int a1r = a1*nvirA+r;
-        int ar1 = a*nvirA+r1;
-        double tval1 = wARAR[ar][a1r1]+wARAR[a1r1][ar];
-        double tval2 = wARAR[a1r][ar1]+wARAR[ar1][a1r];
-        double denom = evalsA[a+foccA]+evalsA[a1+foccA]+evalsB[b+foccB]-
-                  evalsA[r+noccA]-evalsA[r1+noccA]-evalsB[s+noccB];
-        energy += ((4.0*tval1-2.0*tval2)*tval1)/denom;
-      }}
-    }}
+    energy += disp22t_energy(wARAR,aoccA,nvirA,&(evalsA[foccA]),
+      &(evalsA[noccA]),evalsB[b+foccB]-evalsB[s+noccB]);
    }
   stop = time(NULL);
   if (print_) {
@@ -361,7 +383,7 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel,
       stop-start);
   }  }
 
-  free(B_p_bs);
+  free_block(B_p_bS);
   free_block(wARAR);
   free_block(vbsAA);
   free_block(vbsRR);
@@ -396,7 +418,7 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
     foccA,noccA+foccA);
   double **B_p_AR = get_DF_ints_nongimp(Rnum,AR_label,foccA,noccA+foccA,0,nvirA);
   double **B_p_RR = get_DF_ints_nongimp(Rnum,RR_label,0,nvirA,0,nvirA);
-  double *B_p_bs = init_array(ndf_);
+  double **B_p_bS = block_matrix(nvirB,ndf_+3);
 
   double **t_bsAR = block_matrix(noccA,nvirA);
   double **t_ARAR;
@@ -447,12 +469,15 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
   time_t stop;
 
   for(int b=0,bs=0; b<noccB; b++) {
-  for(int s=0; s<nvirB; s++,bs++) {
 
-    psio_address next_DF_BS = psio_get_address(PSIO_ZERO,((foccB + b)*nvirB + s)*
-      (ndf_+3)*(size_t) sizeof(double));
-    psio_->read(BBnum,BS_label,(char *) &(B_p_bs[0]),sizeof(double)*
-      ndf_,next_DF_BS,&next_DF_BS);
+  // All (bs|P) of this b in one read
+  psio_address next_DF_BS = psio_get_address(PSIO_ZERO,(foccB + b)*nvirB*
+    (ndf_+3)*(size_t) sizeof(double));
+  psio_->read(BBnum,BS_label,(char *) &(B_p_bS[0][0]),sizeof(double)*
+    nvirB*(ndf_+3),next_DF_BS,&next_DF_BS);
+
+  for(int s=0; s<nvirB; s++,bs++) {
+    double *B_p_bs = B_p_bS[s];
 
     if (ampnum == PSIF_SAPT_CCD) {
       next_BSAR = psio_get_address(PSIO_ZERO,bs*noccA*nvirA*sizeof(double));
@@ -496,27 +521,15 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
             &(B_p_AR[0][0]),ndf_,&(C_p_AR[0][0]),ndf_,
             1.0,&(w_ARAR[0][0]),noccA*nvirA);
 
-    for(int a=0,ar=0; a<noccA; a++) {
-    for(int r=0; r<nvirA; r++,ar++) {
-      for(int a1=0,a1r1=0; a1<noccA; a1++) {
-      for(int r1=0; r1<nvirA; r1++,a1r1++) {
-        int a1r = a1*nvirA+r;
-        int ar1 = a*nvirA+r1;
-        double tval1 = w_ARAR[ar][a1r1]+w_ARAR[a1r1][ar];
-        double tval2 = w_ARAR[a1r][ar1]+w_ARAR[ar1][a1r];
-        double denom = evalsA[a+foccA]+evalsA[a1+foccA]+evalsB[b+foccB]-
-                  evalsA[r+noccA+foccA]-evalsA[r1+noccA+foccA]-
-                  evalsB[s+noccB+foccB];
-        energy += ((4.0*tval1-2.0*tval2)*tval1)/denom;
-      }}
-    }}
+    energy += disp22t_energy(w_ARAR,noccA,nvirA,&(evalsA[foccA]),
+      &(evalsA[noccA+foccA]),evalsB[b+foccB]-evalsB[s+noccB+foccB]);
    }
   stop = time(NULL);
     outfile->Printf("    (i = %3d of %3d) %10ld seconds\n",b+1,noccB,stop-start);
   
   }
 
-  free(B_p_bs);
+  free_block(B_p_bS);
   free_block(w_ARAR);
   free_block(v_bsAA);
   free_block(v_bsRR);
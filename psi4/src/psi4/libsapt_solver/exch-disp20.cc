@@ -26,6 +26,8 @@
  * @END LICENSE
  */
 
+#include <cmath>
+
 #include "sapt0.h"
 #include "sapt2.h"
 
@@ -45,6 +47,7 @@ void SAPT0::exch_disp20_n5()
 
   double e_disp20 = 0.0;
   double v_1 = 0.0, q_12 = 0.0;
+  long int nscreened = 0;
 
   bool A_in_core = false;
   bool B_in_core = false;
@@ -115,6 +118,15 @@ void SAPT0::exch_disp20_n5()
   double **Q_BR = block_matrix(B_chunk*nvirA_,ndf_+3);
   double **Q_AS = block_matrix(A_chunk*nvirB_,ndf_+3);
 
+  // Frobenius norms of each occupied row of the blocks, used to bound the
+  // V1 + Q12 contribution of an (a,b) pair when Disp20 comes from disp20()
+  double *tA = init_array(A_chunk);
+  double *vA = init_array(A_chunk);
+  double *qA = init_array(A_chunk);
+  double *tB = init_array(B_chunk);
+  double *vB = init_array(B_chunk);
+  double *qB = init_array(B_chunk);
+
   if (A_in_core) {
 
     psio_->read_entry(PSIF_SAPT_TEMP,"AR RI Integrals",(char *)
@@ -163,6 +175,17 @@ void SAPT0::exch_disp20_n5()
         &next_Q_AS);
     }
 
+    if (laplace_disp_) {
+      for (int arel=0; arel<A_length; arel++) {
+        tA[arel] = sqrt(C_DDOT((long int) nvirA_*ndf_,T_AR[arel*nvirA_],1,
+          T_AR[arel*nvirA_],1));
+        vA[arel] = sqrt(C_DDOT((long int) nvirB_*(ndf_+3),V_AS[arel*nvirB_],1,
+          V_AS[arel*nvirB_],1));
+        qA[arel] = sqrt(C_DDOT((long int) nvirB_*(ndf_+3),Q_AS[arel*nvirB_],1,
+          Q_AS[arel*nvirB_],1));
+      }
+    }
+
     for (int b=0,bmax=0; b<B_blocks; b++) {
 
       int B_length = -bmax;
@@ -182,9 +205,20 @@ void SAPT0::exch_disp20_n5()
           &next_Q_BR);
       }
 
+      if (laplace_disp_) {
+        for (int brel=0; brel<B_length; brel++) {
+          tB[brel] = sqrt(C_DDOT((long int) nvirB_*ndf_,T_BS[brel*nvirB_],1,
+            T_BS[brel*nvirB_],1));
+          vB[brel] = sqrt(C_DDOT((long int) nvirA_*(ndf_+3),V_BR[brel*nvirA_],
+            1,V_BR[brel*nvirA_],1));
+          qB[brel] = sqrt(C_DDOT((long int) nvirA_*(ndf_+3),Q_BR[brel*nvirA_],
+            1,Q_BR[brel*nvirA_],1));
+        }
+      }
+
 #pragma omp parallel
 {
-#pragma omp for private(rank) reduction(+:e_disp20,v_1,q_12)
+#pragma omp for private(rank) reduction(+:e_disp20,v_1,q_12,nscreened)
       for (int ab=0; ab<A_length*B_length; ab++) {
 
 #ifdef _OPENMP
@@ -196,6 +230,19 @@ void SAPT0::exch_disp20_n5()
         int aabs = amax - A_length + arel;
         int babs = bmax - B_length + brel;
 
+        // |t_ab| <= |T_a||T_b| / (smallest denominator of the pair), and the
+        // exchange kernels are bounded by the norms of their two halves
+        if (laplace_disp_) {
+          double denom = evalsA_[noccA_] + evalsB_[noccB_]
+            - evalsA_[aabs+foccA_] - evalsB_[babs+foccB_];
+          double bound = tA[arel]*tB[brel]/denom*
+            (vA[arel]*vB[brel] + qA[arel]*qB[brel]);
+          if (bound < disp_pair_tol_) {
+            nscreened++;
+            continue;
+          }
+        }
+
         C_DGEMM('N','T',nvirA_,nvirB_,ndf_,1.0,T_AR[arel*nvirA_],ndf_,
           T_BS[brel*nvirB_],ndf_,0.0,tabRS[rank],nvirB_);
 
@@ -238,7 +285,15 @@ void SAPT0::exch_disp20_n5()
   free_block(Q_BR);
   free_block(Q_AS);
 
-  e_disp20_ = e_disp20;
+  free(tA);
+  free(vA);
+  free(qA);
+  free(tB);
+  free(vB);
+  free(qB);
+
+  // The Laplace Disp20 from disp20() is kept, the pair sum above is partial
+  if (!laplace_disp_) e_disp20_ = e_disp20;
   e_disp20_os_ = 0.5 * e_disp20_;
   e_disp20_ss_ = 0.5 * e_disp20_;
   e_exch_disp20_ = -2.0*(v_1+q_12);
@@ -247,6 +302,9 @@ void SAPT0::exch_disp20_n5()
     outfile->Printf("    Disp20              = %18.12lf [Eh]\n",e_disp20_);
     outfile->Printf("    Disp20 (SS)         = %18.12lf [Eh]\n",e_disp20_ss_);
     outfile->Printf("    Disp20 (OS)         = %18.12lf [Eh]\n",e_disp20_os_);
+    if (laplace_disp_)
+      outfile->Printf("    Screened %ld of %ld occupied pairs in Exch-Disp20\n",
+        nscreened,(long int) aoccA_*aoccB_);
 
   }
 
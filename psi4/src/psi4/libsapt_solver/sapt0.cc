@@ -32,6 +32,7 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/lib3index/df_helper.h"
 
 
 namespace psi { namespace sapt {
@@ -70,6 +71,10 @@ SAPT0::SAPT0(SharedWavefunction Dimer, SharedWavefunction MonomerA,
   do_e10_ = options_.get_bool("SAPT0_E10");
   do_e20ind_ = options_.get_bool("SAPT0_E20IND");
   do_e20disp_ = options_.get_bool("SAPT0_E20DISP");
+  laplace_disp_ = options_.get_bool("SAPT0_LAPLACE_DISP");
+  disp_pair_tol_ = options_.get_double("SAPT0_DISP_PAIR_TOLERANCE");
+  df_ints_incore_ = false;
+  df_ints_dfh_ = false;
 
   // If no specific term is requested, it means that we do everything
   if(!do_e10_ && !do_e20ind_ && !do_e20disp_) {
@@ -86,13 +91,15 @@ SAPT0::~SAPT0()
 {
   if (wBAR_ != NULL) free_block(wBAR_);
   if (wABS_ != NULL) free_block(wABS_);
-  psio_->close(PSIF_SAPT_AA_DF_INTS,1);
-  psio_->close(PSIF_SAPT_BB_DF_INTS,1);
-  psio_->close(PSIF_SAPT_AB_DF_INTS,1);
+  // Writing in-core integrals back out would cost the disk traffic they saved
+  psio_->close(PSIF_SAPT_AA_DF_INTS,!df_ints_incore_);
+  psio_->close(PSIF_SAPT_BB_DF_INTS,!df_ints_incore_);
+  psio_->close(PSIF_SAPT_AB_DF_INTS,!df_ints_incore_);
 }
 
 double SAPT0::compute_energy()
 {
+  set_df_ints_storage();
   check_memory();
 
   if (elst_basis_ && do_e10_)
@@ -103,7 +110,9 @@ double SAPT0::compute_energy()
   psio_->open(PSIF_SAPT_AB_DF_INTS,PSIO_OPEN_NEW);
 
   timer_on("DF Integrals       ");
-    if (aio_dfints_)
+    if (df_ints_dfh_)
+      df_integrals_core();
+    else if (aio_dfints_)
       df_integrals_aio();
     else
       df_integrals();
@@ -135,7 +144,7 @@ double SAPT0::compute_energy()
       timer_off("Exch-Ind20         ");
   }
   if(do_e20disp_) {
-      if (debug_) disp20();
+      if (debug_ || laplace_disp_) disp20();
       timer_on("Exch-Disp20 N^5    ");
         psio_->open(PSIF_SAPT_TEMP,PSIO_OPEN_NEW);
         exch_disp20_n5();
@@ -392,6 +401,60 @@ void SAPT0::print_results()
 
 }
 
+/*
+ * The AA, BB and AB DF integral files are written once and then read many
+ * times by every term.  When their MO-basis blocks fit in memory, the PSIO
+ * units are held in core so that all readers work on memory instead of
+ * scratch; the memory they use is taken from mem_ before any block sizes are
+ * chosen.  In-core integrals are built by DF_Helper's in-core transformation
+ * when its AO tensor and unpacked MO blocks fit in what is left, and by
+ * df_integrals() through scratch otherwise.
+ */
+void SAPT0::set_df_ints_storage()
+{
+  std::string storage = options_.get_str("SAPT_DF_INTS_STORAGE");
+
+  long int indices = noccA_*noccA_ + noccA_*nvirA_ + nvirA_*(nvirA_+1)/2
+    + noccB_*noccB_ + noccB_*nvirB_ + nvirB_*(nvirB_+1)/2
+    + noccA_*noccB_ + noccA_*nvirB_ + nvirA_*noccB_;
+  long int ints_size = (long int) ribasis_->nbf()*indices;
+
+  if (storage == "CORE")
+    df_ints_incore_ = true;
+  else if (storage == "AUTO")
+    df_ints_incore_ = (2L*ints_size <= mem_);
+  else
+    df_ints_incore_ = false;
+
+  // An empty value defers to whatever the user configured for the unit
+  const char *incore = df_ints_incore_ ? "TRUE" :
+    (storage == "DISK" ? "FALSE" : "");
+  psio_->filecfg_kwd("PSI","INCORE",PSIF_SAPT_AA_DF_INTS,incore);
+  psio_->filecfg_kwd("PSI","INCORE",PSIF_SAPT_BB_DF_INTS,incore);
+  psio_->filecfg_kwd("PSI","INCORE",PSIF_SAPT_AB_DF_INTS,incore);
+
+  if (df_ints_incore_) {
+    mem_ -= ints_size;
+    if (mem_ <= 0)
+      throw PsiException("Not enough memory for in-core DF integrals",
+        __FILE__,__LINE__);
+
+    // DF_Helper's AO tensor, its unpacked MO blocks and one copy handed out
+    long int nvir = (nvirA_ > nvirB_ ? nvirA_ : nvirB_);
+    long int dfh_size = (long int) ribasis_->nbf()*((long int) nso_*nso_
+      + noccA_*noccA_ + noccA_*nvirA_ + nvirA_*nvirA_
+      + noccB_*noccB_ + noccB_*nvirB_ + nvirB_*nvirB_
+      + noccA_*noccB_ + noccA_*nvirB_ + nvirA_*noccB_ + nvir*nvir);
+    df_ints_dfh_ = (dfh_size <= mem_);
+  }
+
+  if (print_) {
+    outfile->Printf("    DF integrals are kept %s (%.1lf MB)%s\n\n",
+      df_ints_incore_ ? "in core" : "on disk",8.0*ints_size/1000000.0,
+      df_ints_dfh_ ? ", built by DF_Helper" : "");
+  }
+}
+
 void SAPT0::check_memory()
 {
   double memory = 8.0*mem_/1000000.0;
@@ -456,10 +519,8 @@ void SAPT0::df_integrals()
   psio_->open(PSIF_SAPT_TEMP,PSIO_OPEN_NEW);
 
   // Get fitting metric
-  std::shared_ptr<FittingMetric> metric = std::shared_ptr<FittingMetric>(
-    new FittingMetric(ribasis_));
-  metric->form_eig_inverse();
-  double **J_temp = metric->get_metric()->pointer();
+  SharedMatrix metric = DFIntsCache::metric_power(ribasis_, -0.5, 1.0E-10);
+  double **J_temp = metric->pointer();
   double **J_mhalf = block_matrix(ndf_,ndf_);
   C_DCOPY(ndf_*ndf_,J_temp[0],1,J_mhalf[0],1);
   metric.reset();
@@ -964,6 +1025,85 @@ void SAPT0::df_integrals()
   psio_->close(PSIF_SAPT_TEMP,0);
 }
 
+/*
+ * Builds the AA, BB and AB DF integrals with DF_Helper's in-core
+ * transformation and stores them in the (in-core) PSIO units under the same
+ * labels and layouts df_integrals() writes.
+ */
+void SAPT0::df_integrals_core()
+{
+  int nthreads = 1;
+  #ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+  #endif
+
+  auto columns = [&](const char *name, double **C, size_t start,
+    size_t ncol) -> SharedMatrix {
+    SharedMatrix M(new Matrix(name,nso_,ncol));
+    double **Mp = M->pointer();
+    for (int mu=0; mu<nso_; mu++)
+      C_DCOPY(ncol,&(C[mu][start]),1,Mp[mu],1);
+    return M;
+  };
+
+  std::shared_ptr<df_helper::DF_Helper> dfh(new df_helper::DF_Helper(
+    basisset_, ribasis_));
+  dfh->set_memory(mem_);
+  dfh->set_method("STORE");
+  dfh->set_nthreads(nthreads);
+  dfh->set_schwarz_cutoff(schwarz_);
+  dfh->set_on_core(true);
+  dfh->initialize();
+
+  dfh->add_space("a",columns("A occ",CA_,0,noccA_));
+  dfh->add_space("r",columns("A vir",CA_,noccA_,nvirA_));
+  dfh->add_space("b",columns("B occ",CB_,0,noccB_));
+  dfh->add_space("s",columns("B vir",CB_,noccB_,nvirB_));
+
+  dfh->add_transformation("AA","a","a");
+  dfh->add_transformation("AR","a","r");
+  dfh->add_transformation("RR","r","r");
+  dfh->add_transformation("BB","b","b");
+  dfh->add_transformation("BS","b","s");
+  dfh->add_transformation("SS","s","s");
+  dfh->add_transformation("AB","a","b");
+  dfh->add_transformation("AS","a","s");
+  dfh->add_transformation("RB","r","b");
+  dfh->transform();
+
+  // DF_Helper hands out (P|pq) with P as the row, as the readers expect
+  auto store = [&](int unit, const char *label, const std::string& name) {
+    SharedMatrix B = dfh->get_tensor(name);
+    psio_->write_entry(unit,label,(char *) B->pointer()[0],
+      sizeof(double)*B->nrow()*B->ncol());
+  };
+
+  // The virtual-virtual blocks are stored as lower triangles
+  auto store_tri = [&](int unit, const char *label, const std::string& name,
+    size_t nvir) {
+    SharedMatrix B = dfh->get_tensor(name);
+    double **Bp = B->pointer();
+    for (size_t P=0; P<ndf_; P++) {
+      for (size_t r=0; r<nvir; r++)
+        ::memmove(&(Bp[P][r*(r+1)/2]),&(Bp[P][r*nvir]),sizeof(double)*(r+1));
+    }
+    size_t ntri = nvir*(nvir+1)/2;
+    for (size_t P=1; P<ndf_; P++)
+      ::memmove(&(Bp[0][P*ntri]),Bp[P],sizeof(double)*ntri);
+    psio_->write_entry(unit,label,(char *) Bp[0],sizeof(double)*ndf_*ntri);
+  };
+
+  store(PSIF_SAPT_AA_DF_INTS,"AA RI Integrals","AA");
+  store(PSIF_SAPT_AA_DF_INTS,"AR RI Integrals","AR");
+  store_tri(PSIF_SAPT_AA_DF_INTS,"RR RI Integrals","RR",nvirA_);
+  store(PSIF_SAPT_BB_DF_INTS,"BB RI Integrals","BB");
+  store(PSIF_SAPT_BB_DF_INTS,"BS RI Integrals","BS");
+  store_tri(PSIF_SAPT_BB_DF_INTS,"SS RI Integrals","SS",nvirB_);
+  store(PSIF_SAPT_AB_DF_INTS,"AB RI Integrals","AB");
+  store(PSIF_SAPT_AB_DF_INTS,"AS RI Integrals","AS");
+  store(PSIF_SAPT_AB_DF_INTS,"RB RI Integrals","RB");
+}
+
 void SAPT0::df_integrals_aio()
 {
   std::shared_ptr<AIOHandler> aio(new AIOHandler(psio_));
@@ -971,10 +1111,8 @@ void SAPT0::df_integrals_aio()
   psio_->open(PSIF_SAPT_TEMP,PSIO_OPEN_NEW);
 
   // Get fitting metric
-  std::shared_ptr<FittingMetric> metric = std::shared_ptr<FittingMetric>(
-    new FittingMetric(ribasis_));
-  metric->form_eig_inverse();
-  double **J_temp = metric->get_metric()->pointer();
+  SharedMatrix metric = DFIntsCache::metric_power(ribasis_, -0.5, 1.0E-10);
+  double **J_temp = metric->pointer();
   double **J_mhalf = block_matrix(ndf_,ndf_);
   C_DCOPY(ndf_*ndf_,J_temp[0],1,J_mhalf[0],1);
   metric.reset();
@@ -1803,10 +1941,8 @@ void SAPT0::oo_df_integrals()
   free_block(B_p_BB);
 
   // Get fitting metric
-  std::shared_ptr<FittingMetric> metric = std::shared_ptr<FittingMetric>(
-    new FittingMetric(elstbasis_));
-  metric->form_eig_inverse();
-  double **J_temp = metric->get_metric()->pointer();
+  SharedMatrix metric = DFIntsCache::metric_power(elstbasis_, -0.5, 1.0E-10);
+  double **J_temp = metric->pointer();
   double **J_mhalf = block_matrix(ndf_,ndf_);
   C_DCOPY(ndf_*ndf_,J_temp[0],1,J_mhalf[0],1);
   metric.reset();
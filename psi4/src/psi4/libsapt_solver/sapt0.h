@@ -42,9 +42,11 @@ private:
   virtual void print_results();
 
   void check_memory();
+  void set_df_ints_storage();
 
   void df_integrals();
   void df_integrals_aio();
+  void df_integrals_core();
   void w_integrals();
 
   void first_order_terms();
@@ -129,6 +131,10 @@ protected:
   bool do_e10_;
   bool do_e20ind_;
   bool do_e20disp_;
+  bool laplace_disp_;
+  bool df_ints_incore_;
+  bool df_ints_dfh_;
+  double disp_pair_tol_;
 
   int maxiter_;
   double e_conv_;
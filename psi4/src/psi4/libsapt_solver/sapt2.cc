@@ -444,10 +444,8 @@ void SAPT2::print_results()
 void SAPT2::df_integrals()
 {
   // Get fitting metric
-  std::shared_ptr<FittingMetric> metric = std::shared_ptr<FittingMetric>(
-    new FittingMetric(ribasis_));
-  metric->form_eig_inverse();
-  double **J_temp = metric->get_metric()->pointer();
+  SharedMatrix metric = DFIntsCache::metric_power(ribasis_, -0.5, 1.0E-10);
+  double **J_temp = metric->pointer();
   double **J_mhalf = block_matrix(ndf_,ndf_);
   C_DCOPY(ndf_*ndf_,J_temp[0],1,J_mhalf[0],1);
   metric.reset();
@@ -30,6 +30,7 @@
 #include "psi4/libfock/jk.h"
 #include "psi4/libthce/thce.h"
 #include "psi4/libthce/lreri.h"
+#include "psi4/lib3index/df_helper.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/physconst.h"
 #include "psi4/libmints/basisset.h"
@@ -1603,6 +1604,7 @@ void CPKS_USAPT0::preconditioner(std::shared_ptr<Matrix> r,
     double* op = o->pointer();
     double* vp = v->pointer();
 
+    #pragma omp parallel for
     for (int i = 0; i < no; i++) {
         for (int a = 0; a < nv; a++) {
             zp[i][a] = rp[i][a] / (vp[a] - op[i]);
@@ -1709,6 +1711,7 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(std::map<st
         double** bp = b["Aa"]->pointer();
         double* op = eps_occa_A_->pointer();
         double* vp = eps_vira_A_->pointer();
+        #pragma omp parallel for
         for (int i = 0; i < no; i++) {
             for (int a = 0; a < nv; a++) {
                 Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
@@ -1732,6 +1735,7 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(std::map<st
         bp = b["Ab"]->pointer();
         op = eps_occb_A_->pointer();
         vp = eps_virb_A_->pointer();
+        #pragma omp parallel for
         for (int i = 0; i < no; i++) {
             for (int a = 0; a < nv; a++) {
                 Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
@@ -1771,6 +1775,7 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(std::map<st
         double** bp = b["Ba"]->pointer();
         double* op = eps_occa_B_->pointer();
         double* vp = eps_vira_B_->pointer();
+        #pragma omp parallel for
         for (int i = 0; i < no; i++) {
             for (int a = 0; a < nv; a++) {
                 Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
@@ -1795,6 +1800,7 @@ std::map<std::string, std::shared_ptr<Matrix> > CPKS_USAPT0::product(std::map<st
         bp = b["Bb"]->pointer();
         op = eps_occb_B_->pointer();
         vp = eps_virb_B_->pointer();
+        #pragma omp parallel for
         for (int i = 0; i < no; i++) {
             for (int a = 0; a < nv; a++) {
                 Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
@@ -1975,93 +1981,102 @@ void USAPT0::mp2_terms()
 
     // => Memory <= //
 
-    // => Integrals from the THCE <= //
-
-    std::shared_ptr<DFERI> df = DFERI::build(primary_,mp2fit_,Process::environment.options);
-    df->clear();
-
-    std::vector<std::shared_ptr<Matrix> > Cs;
-    Cs.push_back(Caocca_A_);
-    Cs.push_back(Cavira_A_);
-    Cs.push_back(Caocca_B_);
-    Cs.push_back(Cavira_B_);
-    Cs.push_back(Ca_r1);
-    Cs.push_back(Ca_s1);
-    Cs.push_back(Ca_a2);
-    Cs.push_back(Ca_b2);
-    Cs.push_back(Ca_r3);
-    Cs.push_back(Ca_s3);
-    Cs.push_back(Ca_a4);
-    Cs.push_back(Ca_b4);
-
-    Cs.push_back(Caoccb_A_);
-    Cs.push_back(Cavirb_A_);
-    Cs.push_back(Caoccb_B_);
-    Cs.push_back(Cavirb_B_);
-    Cs.push_back(Cb_r1);
-    Cs.push_back(Cb_s1);
-    Cs.push_back(Cb_a2);
-    Cs.push_back(Cb_b2);
-    Cs.push_back(Cb_r3);
-    Cs.push_back(Cb_s3);
-    Cs.push_back(Cb_a4);
-    Cs.push_back(Cb_b4);
-    std::shared_ptr<Matrix> Call = Matrix::horzcat(Cs);
-    Cs.clear();
-
-    df->set_C(Call);
-    df->set_memory(memory_ - Call->nrow() * Call->ncol());
-
-    int offset = 0;
-    df->add_space("a_a",offset,offset+Caocca_A_->colspi()[0]); offset += Caocca_A_->colspi()[0];
-    df->add_space("a_r",offset,offset+Cavira_A_->colspi()[0]); offset += Cavira_A_->colspi()[0];
-    df->add_space("a_b",offset,offset+Caocca_B_->colspi()[0]); offset += Caocca_B_->colspi()[0];
-    df->add_space("a_s",offset,offset+Cavira_B_->colspi()[0]); offset += Cavira_B_->colspi()[0];
-    df->add_space("a_r1",offset,offset+Ca_r1->colspi()[0]); offset += Ca_r1->colspi()[0];
-    df->add_space("a_s1",offset,offset+Ca_s1->colspi()[0]); offset += Ca_s1->colspi()[0];
-    df->add_space("a_a2",offset,offset+Ca_a2->colspi()[0]); offset += Ca_a2->colspi()[0];
-    df->add_space("a_b2",offset,offset+Ca_b2->colspi()[0]); offset += Ca_b2->colspi()[0];
-    df->add_space("a_r3",offset,offset+Ca_r3->colspi()[0]); offset += Ca_r3->colspi()[0];
-    df->add_space("a_s3",offset,offset+Ca_s3->colspi()[0]); offset += Ca_s3->colspi()[0];
-    df->add_space("a_a4",offset,offset+Ca_a4->colspi()[0]); offset += Ca_a4->colspi()[0];
-    df->add_space("a_b4",offset,offset+Ca_b4->colspi()[0]); offset += Ca_b4->colspi()[0];
-
-    df->add_space("b_a",offset,offset+Caoccb_A_->colspi()[0]); offset += Caoccb_A_->colspi()[0];
-    df->add_space("b_r",offset,offset+Cavirb_A_->colspi()[0]); offset += Cavirb_A_->colspi()[0];
-    df->add_space("b_b",offset,offset+Caoccb_B_->colspi()[0]); offset += Caoccb_B_->colspi()[0];
-    df->add_space("b_s",offset,offset+Cavirb_B_->colspi()[0]); offset += Cavirb_B_->colspi()[0];
-    df->add_space("b_r1",offset,offset+Cb_r1->colspi()[0]); offset += Cb_r1->colspi()[0];
-    df->add_space("b_s1",offset,offset+Cb_s1->colspi()[0]); offset += Cb_s1->colspi()[0];
-    df->add_space("b_a2",offset,offset+Cb_a2->colspi()[0]); offset += Cb_a2->colspi()[0];
-    df->add_space("b_b2",offset,offset+Cb_b2->colspi()[0]); offset += Cb_b2->colspi()[0];
-    df->add_space("b_r3",offset,offset+Cb_r3->colspi()[0]); offset += Cb_r3->colspi()[0];
-    df->add_space("b_s3",offset,offset+Cb_s3->colspi()[0]); offset += Cb_s3->colspi()[0];
-    df->add_space("b_a4",offset,offset+Cb_a4->colspi()[0]); offset += Cb_a4->colspi()[0];
-    df->add_space("b_b4",offset,offset+Cb_b4->colspi()[0]); offset += Cb_b4->colspi()[0];
-
-
-    df->add_pair_space("Aa_ar", "a_a", "a_r");
-    df->add_pair_space("Aa_bs", "a_b", "a_s");
-    df->add_pair_space("Ba_as", "a_a", "a_s1");
-    df->add_pair_space("Ba_br", "a_b", "a_r1");
-    df->add_pair_space("Ca_as", "a_a2","a_s");
-    df->add_pair_space("Ca_br", "a_b2","a_r");
-    df->add_pair_space("Da_ar", "a_a", "a_r3");
-    df->add_pair_space("Da_bs", "a_b", "a_s3");
-    df->add_pair_space("Ea_ar", "a_a4","a_r");
-    df->add_pair_space("Ea_bs", "a_b4","a_s");
-
-    df->add_pair_space("Ab_ar", "b_a", "b_r");
-    df->add_pair_space("Ab_bs", "b_b", "b_s");
-    df->add_pair_space("Bb_as", "b_a", "b_s1");
-    df->add_pair_space("Bb_br", "b_b", "b_r1");
-    df->add_pair_space("Cb_as", "b_a2","b_s");
-    df->add_pair_space("Cb_br", "b_b2","b_r");
-    df->add_pair_space("Db_ar", "b_a", "b_r3");
-    df->add_pair_space("Db_bs", "b_b", "b_s3");
-    df->add_pair_space("Eb_ar", "b_a4","b_r");
-    df->add_pair_space("Eb_bs", "b_b4","b_s");
+    long int overhead = 0L;
+    overhead += 2L * nT * nar * nas + 2L * nT * nbr * nbs;
+    overhead += 2L * nT * nbr * nas + 2L * nT * nar * nbs;
+    overhead += 2L * naa * nas + 2L * nab * nar + 2L * naa * nar + 2L * nab * nas;
+    overhead += 2L * nba * nbs + 2L * nbb * nbr + 2L * nba * nbr + 2L * nbb * nbs;
 
+    // All twenty DF tensors, held once by DF_Helper and once transposed for the loops below,
+    // next to DF_Helper's AO tensor
+    long int ntensor = 3L * naa * nar + 3L * nab * nas + 2L * naa * nas + 2L * nab * nar;
+    ntensor += 3L * nba * nbr + 3L * nbb * nbs + 2L * nba * nbs + 2L * nbb * nbr;
+    ntensor *= nQ;
+    bool incore = (overhead + 2L * ntensor + (long int) nQ * nn * nn <= (long int) memory_);
+
+    // => Integrals <= //
+
+    std::vector<std::pair<std::string, std::shared_ptr<Matrix> > > spaces = {
+        {"a_a", Caocca_A_}, {"a_r", Cavira_A_}, {"a_b", Caocca_B_}, {"a_s", Cavira_B_},
+        {"a_r1", Ca_r1}, {"a_s1", Ca_s1}, {"a_a2", Ca_a2}, {"a_b2", Ca_b2},
+        {"a_r3", Ca_r3}, {"a_s3", Ca_s3}, {"a_a4", Ca_a4}, {"a_b4", Ca_b4},
+        {"b_a", Caoccb_A_}, {"b_r", Cavirb_A_}, {"b_b", Caoccb_B_}, {"b_s", Cavirb_B_},
+        {"b_r1", Cb_r1}, {"b_s1", Cb_s1}, {"b_a2", Cb_a2}, {"b_b2", Cb_b2},
+        {"b_r3", Cb_r3}, {"b_s3", Cb_s3}, {"b_a4", Cb_a4}, {"b_b4", Cb_b4}};
+
+    std::vector<std::vector<std::string> > pairs = {
+        {"Aa_ar", "a_a", "a_r"}, {"Aa_bs", "a_b", "a_s"},
+        {"Ba_as", "a_a", "a_s1"}, {"Ba_br", "a_b", "a_r1"},
+        {"Ca_as", "a_a2", "a_s"}, {"Ca_br", "a_b2", "a_r"},
+        {"Da_ar", "a_a", "a_r3"}, {"Da_bs", "a_b", "a_s3"},
+        {"Ea_ar", "a_a4", "a_r"}, {"Ea_bs", "a_b4", "a_s"},
+        {"Ab_ar", "b_a", "b_r"}, {"Ab_bs", "b_b", "b_s"},
+        {"Bb_as", "b_a", "b_s1"}, {"Bb_br", "b_b", "b_r1"},
+        {"Cb_as", "b_a2", "b_s"}, {"Cb_br", "b_b2", "b_r"},
+        {"Db_ar", "b_a", "b_r3"}, {"Db_bs", "b_b", "b_s3"},
+        {"Eb_ar", "b_a4", "b_r"}, {"Eb_bs", "b_b4", "b_s"}};
+
+    // Disk-backed tensors, (pq|Q) on file
+    std::map<std::string, std::shared_ptr<Tensor> > ints;
+    // In-core tensors, (pq|Q)
+    std::map<std::string, std::shared_ptr<Matrix> > incore_ints;
+
+    if (incore) {
+        outfile->Printf("    DF tensors are held in core by DF_Helper.\n\n");
+
+        std::shared_ptr<df_helper::DF_Helper> dfh(new df_helper::DF_Helper(primary_, mp2fit_));
+        dfh->set_memory(memory_ - overhead - ntensor);
+        dfh->set_method("STORE");
+        dfh->set_nthreads(nT);
+        dfh->set_schwarz_cutoff(options_.get_double("INTS_TOLERANCE"));
+        dfh->set_on_core(true);
+        dfh->initialize();
+
+        for (size_t i = 0; i < spaces.size(); i++) {
+            dfh->add_space(spaces[i].first, spaces[i].second);
+        }
+        for (size_t i = 0; i < pairs.size(); i++) {
+            dfh->add_transformation(pairs[i][0], pairs[i][1], pairs[i][2]);
+        }
+        dfh->transform();
+
+        // DF_Helper hands out (Q|pq)
+        for (size_t i = 0; i < pairs.size(); i++) {
+            incore_ints[pairs[i][0]] = dfh->get_tensor(pairs[i][0])->transpose();
+            incore_ints[pairs[i][0]]->set_name(pairs[i][0]);
+        }
+    } else {
+        std::shared_ptr<DFERI> df = DFERI::build(primary_,mp2fit_,Process::environment.options);
+        df->clear();
+
+        std::vector<std::shared_ptr<Matrix> > Cs;
+        for (size_t i = 0; i < spaces.size(); i++) {
+            Cs.push_back(spaces[i].second);
+        }
+        std::shared_ptr<Matrix> Call = Matrix::horzcat(Cs);
+        Cs.clear();
+
+        df->set_C(Call);
+        df->set_memory(memory_ - Call->nrow() * Call->ncol());
+
+        int offset = 0;
+        for (size_t i = 0; i < spaces.size(); i++) {
+            int ncol = spaces[i].second->colspi()[0];
+            df->add_space(spaces[i].first, offset, offset + ncol);
+            offset += ncol;
+        }
+        for (size_t i = 0; i < pairs.size(); i++) {
+            df->add_pair_space(pairs[i][0], pairs[i][1], pairs[i][2]);
+        }
+        Call.reset();
+
+        df->print_header();
+        df->compute();
+
+        ints = df->ints();
+    }
+
+    spaces.clear();
     Ca_r1.reset();
     Ca_s1.reset();
     Ca_a2.reset();
@@ -2078,44 +2093,9 @@ void USAPT0::mp2_terms()
     Cb_s3.reset();
     Cb_a4.reset();
     Cb_b4.reset();
-    Call.reset();
-
-    df->print_header();
-    df->compute();
-
-    std::map<std::string, std::shared_ptr<Tensor> >& ints = df->ints();
-
-    std::shared_ptr<Tensor> Aa_arT = ints["Aa_ar"];
-    std::shared_ptr<Tensor> Aa_bsT = ints["Aa_bs"];
-    std::shared_ptr<Tensor> Ba_asT = ints["Ba_as"];
-    std::shared_ptr<Tensor> Ba_brT = ints["Ba_br"];
-    std::shared_ptr<Tensor> Ca_asT = ints["Ca_as"];
-    std::shared_ptr<Tensor> Ca_brT = ints["Ca_br"];
-    std::shared_ptr<Tensor> Da_arT = ints["Da_ar"];
-    std::shared_ptr<Tensor> Da_bsT = ints["Da_bs"];
-    std::shared_ptr<Tensor> Ea_arT = ints["Ea_ar"];
-    std::shared_ptr<Tensor> Ea_bsT = ints["Ea_bs"];
-
-    std::shared_ptr<Tensor> Ab_arT = ints["Ab_ar"];
-    std::shared_ptr<Tensor> Ab_bsT = ints["Ab_bs"];
-    std::shared_ptr<Tensor> Bb_asT = ints["Bb_as"];
-    std::shared_ptr<Tensor> Bb_brT = ints["Bb_br"];
-    std::shared_ptr<Tensor> Cb_asT = ints["Cb_as"];
-    std::shared_ptr<Tensor> Cb_brT = ints["Cb_br"];
-    std::shared_ptr<Tensor> Db_arT = ints["Db_ar"];
-    std::shared_ptr<Tensor> Db_bsT = ints["Db_bs"];
-    std::shared_ptr<Tensor> Eb_arT = ints["Eb_ar"];
-    std::shared_ptr<Tensor> Eb_bsT = ints["Eb_bs"];
-
-    df.reset();
 
     // => Blocking <= //
 
-    long int overhead = 0L;
-    overhead += 2L * nT * nar * nas + 2L * nT * nbr * nbs;
-    overhead += 2L * nT * nbr * nas + 2L * nT * nar * nbs;
-    overhead += 2L * naa * nas + 2L * nab * nar + 2L * naa * nar + 2L * nab * nas;
-    overhead += 2L * nba * nbs + 2L * nbb * nbr + 2L * nba * nbr + 2L * nbb * nbs;
     long int rem = memory_ - overhead;
 
     if (rem < 0L) {
@@ -2132,29 +2112,41 @@ void USAPT0::mp2_terms()
     maxa_b = (maxa_b > nab ? nab : maxa_b);
     maxb_a = (maxb_a > nba ? nba : maxb_a);
     maxb_b = (maxb_b > nbb ? nbb : maxb_b);
+    if (incore) {
+        maxa_a = naa;
+        maxa_b = nab;
+        maxb_a = nba;
+        maxb_b = nbb;
+    }
     if (maxa_a < 1L || maxa_b < 1L || maxb_a < 1L || maxb_b < 1L) {
         throw PSIEXCEPTION("Too little dynamic memory for USAPT0::mp2_terms");
     }
 
     // => Tensor Slices <= //
 
-    std::shared_ptr<Matrix> Aa_ar(new Matrix("Aa_ar",maxa_a*nar,nQ));
-    std::shared_ptr<Matrix> Aa_bs(new Matrix("Aa_bs",maxa_b*nas,nQ));
-    std::shared_ptr<Matrix> Ba_as(new Matrix("Ba_as",maxa_a*nas,nQ));
-    std::shared_ptr<Matrix> Ba_br(new Matrix("Ba_br",maxa_b*nar,nQ));
-    std::shared_ptr<Matrix> Ca_as(new Matrix("Ca_as",maxa_a*nas,nQ));
-    std::shared_ptr<Matrix> Ca_br(new Matrix("Ca_br",maxa_b*nar,nQ));
-    std::shared_ptr<Matrix> Da_ar(new Matrix("Da_ar",maxa_a*nar,nQ));
-    std::shared_ptr<Matrix> Da_bs(new Matrix("Da_bs",maxa_b*nas,nQ));
-
-    std::shared_ptr<Matrix> Ab_ar(new Matrix("Ab_ar",maxb_a*nbr,nQ));
-    std::shared_ptr<Matrix> Ab_bs(new Matrix("Ab_bs",maxb_b*nbs,nQ));
-    std::shared_ptr<Matrix> Bb_as(new Matrix("Bb_as",maxb_a*nbs,nQ));
-    std::shared_ptr<Matrix> Bb_br(new Matrix("Bb_br",maxb_b*nbr,nQ));
-    std::shared_ptr<Matrix> Cb_as(new Matrix("Cb_as",maxb_a*nbs,nQ));
-    std::shared_ptr<Matrix> Cb_br(new Matrix("Cb_br",maxb_b*nbr,nQ));
-    std::shared_ptr<Matrix> Db_ar(new Matrix("Db_ar",maxb_a*nbr,nQ));
-    std::shared_ptr<Matrix> Db_bs(new Matrix("Db_bs",maxb_b*nbs,nQ));
+    // Whole tensors when in core, block buffers otherwise
+    auto slice = [&](const std::string& name, long int nrow) -> std::shared_ptr<Matrix> {
+        if (incore) return incore_ints[name];
+        return std::shared_ptr<Matrix>(new Matrix(name, nrow, nQ));
+    };
+
+    std::shared_ptr<Matrix> Aa_ar = slice("Aa_ar", maxa_a*nar);
+    std::shared_ptr<Matrix> Aa_bs = slice("Aa_bs", maxa_b*nas);
+    std::shared_ptr<Matrix> Ba_as = slice("Ba_as", maxa_a*nas);
+    std::shared_ptr<Matrix> Ba_br = slice("Ba_br", maxa_b*nar);
+    std::shared_ptr<Matrix> Ca_as = slice("Ca_as", maxa_a*nas);
+    std::shared_ptr<Matrix> Ca_br = slice("Ca_br", maxa_b*nar);
+    std::shared_ptr<Matrix> Da_ar = slice("Da_ar", maxa_a*nar);
+    std::shared_ptr<Matrix> Da_bs = slice("Da_bs", maxa_b*nas);
+
+    std::shared_ptr<Matrix> Ab_ar = slice("Ab_ar", maxb_a*nbr);
+    std::shared_ptr<Matrix> Ab_bs = slice("Ab_bs", maxb_b*nbs);
+    std::shared_ptr<Matrix> Bb_as = slice("Bb_as", maxb_a*nbs);
+    std::shared_ptr<Matrix> Bb_br = slice("Bb_br", maxb_b*nbr);
+    std::shared_ptr<Matrix> Cb_as = slice("Cb_as", maxb_a*nbs);
+    std::shared_ptr<Matrix> Cb_br = slice("Cb_br", maxb_b*nbr);
+    std::shared_ptr<Matrix> Db_ar = slice("Db_ar", maxb_a*nbr);
+    std::shared_ptr<Matrix> Db_bs = slice("Db_bs", maxb_b*nbs);
 
     // => Thread Work Arrays <= //
 
@@ -2228,73 +2220,82 @@ void USAPT0::mp2_terms()
 
     // => File Pointers <= //
 
-    FILE* Aa_arf = Aa_arT->file_pointer();
-    FILE* Aa_bsf = Aa_bsT->file_pointer();
-    FILE* Ba_asf = Ba_asT->file_pointer();
-    FILE* Ba_brf = Ba_brT->file_pointer();
-    FILE* Ca_asf = Ca_asT->file_pointer();
-    FILE* Ca_brf = Ca_brT->file_pointer();
-    FILE* Da_arf = Da_arT->file_pointer();
-    FILE* Da_bsf = Da_bsT->file_pointer();
-    FILE* Ea_arf = Ea_arT->file_pointer();
-    FILE* Ea_bsf = Ea_bsT->file_pointer();
-
-    FILE* Ab_arf = Ab_arT->file_pointer();
-    FILE* Ab_bsf = Ab_bsT->file_pointer();
-    FILE* Bb_asf = Bb_asT->file_pointer();
-    FILE* Bb_brf = Bb_brT->file_pointer();
-    FILE* Cb_asf = Cb_asT->file_pointer();
-    FILE* Cb_brf = Cb_brT->file_pointer();
-    FILE* Db_arf = Db_arT->file_pointer();
-    FILE* Db_bsf = Db_bsT->file_pointer();
-    FILE* Eb_arf = Eb_arT->file_pointer();
-    FILE* Eb_bsf = Eb_bsT->file_pointer();
+    auto file = [&](const std::string& name) -> FILE* { return (incore ? NULL : ints[name]->file_pointer()); };
+
+    FILE* Aa_arf = file("Aa_ar");
+    FILE* Aa_bsf = file("Aa_bs");
+    FILE* Ba_asf = file("Ba_as");
+    FILE* Ba_brf = file("Ba_br");
+    FILE* Ca_asf = file("Ca_as");
+    FILE* Ca_brf = file("Ca_br");
+    FILE* Da_arf = file("Da_ar");
+    FILE* Da_bsf = file("Da_bs");
+    FILE* Ea_arf = file("Ea_ar");
+    FILE* Ea_bsf = file("Ea_bs");
+
+    FILE* Ab_arf = file("Ab_ar");
+    FILE* Ab_bsf = file("Ab_bs");
+    FILE* Bb_asf = file("Bb_as");
+    FILE* Bb_brf = file("Bb_br");
+    FILE* Cb_asf = file("Cb_as");
+    FILE* Cb_brf = file("Cb_br");
+    FILE* Db_arf = file("Db_ar");
+    FILE* Db_bsf = file("Db_bs");
+    FILE* Eb_arf = file("Eb_ar");
+    FILE* Eb_bsf = file("Eb_bs");
 
     // => Slice D + E -> D <= //
 
-//  Here we could read more slices in memory, or just move that to the master loop directly.
-    fseek(Da_arf,0L,SEEK_SET);
-    fseek(Ea_arf,0L,SEEK_SET);
-    for (int astart = 0; astart < naa; astart += 2L * maxa_a) {
-        int nablock = (astart + maxa_a >= naa ? naa - astart : maxa_a);
-        fread(Da_arp[0],sizeof(double),nablock*narQ,Da_arf);
-        fread(Aa_arp[0],sizeof(double),nablock*narQ,Ea_arf);
-        C_DAXPY(nablock*narQ,1.0,Aa_arp[0],1,Da_arp[0],1);
-        fseek(Da_arf,sizeof(double)*astart*narQ,SEEK_SET);
-        fwrite(Da_arp[0],sizeof(double),nablock*narQ,Da_arf);
-    }
+    if (incore) {
+        const char* DE[4][2] = {{"Da_ar", "Ea_ar"}, {"Db_ar", "Eb_ar"}, {"Da_bs", "Ea_bs"}, {"Db_bs", "Eb_bs"}};
+        for (int i = 0; i < 4; i++) {
+            incore_ints[DE[i][0]]->add(incore_ints[DE[i][1]]);
+            incore_ints.erase(DE[i][1]);
+        }
+    } else {
+        for (int astart = 0; astart < naa; astart += maxa_a) {
+            int nablock = (astart + maxa_a >= naa ? naa - astart : maxa_a);
+            fseek(Da_arf,sizeof(double)*astart*narQ,SEEK_SET);
+            fread(Da_arp[0],sizeof(double),nablock*narQ,Da_arf);
+            fseek(Ea_arf,sizeof(double)*astart*narQ,SEEK_SET);
+            fread(Aa_arp[0],sizeof(double),nablock*narQ,Ea_arf);
+            C_DAXPY(nablock*narQ,1.0,Aa_arp[0],1,Da_arp[0],1);
+            fseek(Da_arf,sizeof(double)*astart*narQ,SEEK_SET);
+            fwrite(Da_arp[0],sizeof(double),nablock*narQ,Da_arf);
+        }
 
-    fseek(Db_arf,0L,SEEK_SET);
-    fseek(Eb_arf,0L,SEEK_SET);
-    for (int astart = 0; astart < nba; astart += 2L * maxb_a) {
-        int nablock = (astart + maxb_a >= nba ? nba - astart : maxb_a);
-        fread(Db_arp[0],sizeof(double),nablock*nbrQ,Db_arf);
-        fread(Ab_arp[0],sizeof(double),nablock*nbrQ,Eb_arf);
-        C_DAXPY(nablock*nbrQ,1.0,Ab_arp[0],1,Db_arp[0],1);
-        fseek(Db_arf,sizeof(double)*astart*nbrQ,SEEK_SET);
-        fwrite(Db_arp[0],sizeof(double),nablock*nbrQ,Db_arf);
-    }
+        for (int astart = 0; astart < nba; astart += maxb_a) {
+            int nablock = (astart + maxb_a >= nba ? nba - astart : maxb_a);
+            fseek(Db_arf,sizeof(double)*astart*nbrQ,SEEK_SET);
+            fread(Db_arp[0],sizeof(double),nablock*nbrQ,Db_arf);
+            fseek(Eb_arf,sizeof(double)*astart*nbrQ,SEEK_SET);
+            fread(Ab_arp[0],sizeof(double),nablock*nbrQ,Eb_arf);
+            C_DAXPY(nablock*nbrQ,1.0,Ab_arp[0],1,Db_arp[0],1);
+            fseek(Db_arf,sizeof(double)*astart*nbrQ,SEEK_SET);
+            fwrite(Db_arp[0],sizeof(double),nablock*nbrQ,Db_arf);
+        }
 
-    fseek(Da_bsf,0L,SEEK_SET);
-    fseek(Ea_bsf,0L,SEEK_SET);
-    for (int bstart = 0; bstart < nab; bstart += 2L * maxa_b) {
-        int nbblock = (bstart + maxa_b >= nab ? nab - bstart : maxa_b);
-        fread(Da_bsp[0],sizeof(double),nbblock*nasQ,Da_bsf);
-        fread(Aa_bsp[0],sizeof(double),nbblock*nasQ,Ea_bsf);
-        C_DAXPY(nbblock*nasQ,1.0,Aa_bsp[0],1,Da_bsp[0],1);
-        fseek(Da_bsf,sizeof(double)*bstart*nasQ,SEEK_SET);
-        fwrite(Da_bsp[0],sizeof(double),nbblock*nasQ,Da_bsf);
-    }
+        for (int bstart = 0; bstart < nab; bstart += maxa_b) {
+            int nbblock = (bstart + maxa_b >= nab ? nab - bstart : maxa_b);
+            fseek(Da_bsf,sizeof(double)*bstart*nasQ,SEEK_SET);
+            fread(Da_bsp[0],sizeof(double),nbblock*nasQ,Da_bsf);
+            fseek(Ea_bsf,sizeof(double)*bstart*nasQ,SEEK_SET);
+            fread(Aa_bsp[0],sizeof(double),nbblock*nasQ,Ea_bsf);
+            C_DAXPY(nbblock*nasQ,1.0,Aa_bsp[0],1,Da_bsp[0],1);
+            fseek(Da_bsf,sizeof(double)*bstart*nasQ,SEEK_SET);
+            fwrite(Da_bsp[0],sizeof(double),nbblock*nasQ,Da_bsf);
+        }
 
-    fseek(Db_bsf,0L,SEEK_SET);
-    fseek(Eb_bsf,0L,SEEK_SET);
-    for (int bstart = 0; bstart < nbb; bstart += 2L * maxb_b) {
-        int nbblock = (bstart + maxb_b >= nbb ? nbb - bstart : maxb_b);
-        fread(Db_bsp[0],sizeof(double),nbblock*nbsQ,Db_bsf);
-        fread(Ab_bsp[0],sizeof(double),nbblock*nbsQ,Eb_bsf);
-        C_DAXPY(nbblock*nbsQ,1.0,Ab_bsp[0],1,Db_bsp[0],1);
-        fseek(Db_bsf,sizeof(double)*bstart*nbsQ,SEEK_SET);
-        fwrite(Db_bsp[0],sizeof(double),nbblock*nbsQ,Db_bsf);
+        for (int bstart = 0; bstart < nbb; bstart += maxb_b) {
+            int nbblock = (bstart + maxb_b >= nbb ? nbb - bstart : maxb_b);
+            fseek(Db_bsf,sizeof(double)*bstart*nbsQ,SEEK_SET);
+            fread(Db_bsp[0],sizeof(double),nbblock*nbsQ,Db_bsf);
+            fseek(Eb_bsf,sizeof(double)*bstart*nbsQ,SEEK_SET);
+            fread(Ab_bsp[0],sizeof(double),nbblock*nbsQ,Eb_bsf);
+            C_DAXPY(nbblock*nbsQ,1.0,Ab_bsp[0],1,Db_bsp[0],1);
+            fseek(Db_bsf,sizeof(double)*bstart*nbsQ,SEEK_SET);
+            fwrite(Db_bsp[0],sizeof(double),nbblock*nbsQ,Db_bsf);
+        }
     }
 
     // => Targets <= //
@@ -2304,26 +2305,28 @@ void USAPT0::mp2_terms()
 
     // ==> Master Loop <== //
 
-    fseek(Aa_arf,0L,SEEK_SET);
-    fseek(Ba_asf,0L,SEEK_SET);
-    fseek(Ca_asf,0L,SEEK_SET);
-    fseek(Da_arf,0L,SEEK_SET);
-    fseek(Ab_arf,0L,SEEK_SET);
-    fseek(Bb_asf,0L,SEEK_SET);
-    fseek(Cb_asf,0L,SEEK_SET);
-    fseek(Db_arf,0L,SEEK_SET);
+    if (!incore) {
+        fseek(Aa_arf,0L,SEEK_SET);
+        fseek(Ba_asf,0L,SEEK_SET);
+        fseek(Ca_asf,0L,SEEK_SET);
+        fseek(Da_arf,0L,SEEK_SET);
+        fseek(Ab_arf,0L,SEEK_SET);
+        fseek(Bb_asf,0L,SEEK_SET);
+        fseek(Cb_asf,0L,SEEK_SET);
+        fseek(Db_arf,0L,SEEK_SET);
+    }
     for (int astart = 0; astart < std::max(naa, nba); astart += maxa_a) {
         int na_ablock = (astart + maxa_a >= naa ? naa - astart : maxa_a);
         int nb_ablock = (astart + maxb_a >= nba ? nba - astart : maxb_a);
 
-        if ( na_ablock > 0) {
+        if (!incore && na_ablock > 0) {
             fread(Aa_arp[0],sizeof(double),na_ablock*narQ,Aa_arf);
             fread(Ba_asp[0],sizeof(double),na_ablock*nasQ,Ba_asf);
             fread(Ca_asp[0],sizeof(double),na_ablock*nasQ,Ca_asf);
             fread(Da_arp[0],sizeof(double),na_ablock*narQ,Da_arf);
         }
 
-        if ( nb_ablock > 0) {
+        if (!incore && nb_ablock > 0) {
             fread(Ab_arp[0],sizeof(double),nb_ablock*nbrQ,Ab_arf);
             fread(Bb_asp[0],sizeof(double),nb_ablock*nbsQ,Bb_asf);
             fread(Cb_asp[0],sizeof(double),nb_ablock*nbsQ,Cb_asf);
@@ -2331,26 +2334,28 @@ void USAPT0::mp2_terms()
         }
 
 
-        fseek(Aa_bsf,0L,SEEK_SET);
-        fseek(Ba_brf,0L,SEEK_SET);
-        fseek(Ca_brf,0L,SEEK_SET);
-        fseek(Da_bsf,0L,SEEK_SET);
-        fseek(Ab_bsf,0L,SEEK_SET);
-        fseek(Bb_brf,0L,SEEK_SET);
-        fseek(Cb_brf,0L,SEEK_SET);
-        fseek(Db_bsf,0L,SEEK_SET);
+        if (!incore) {
+            fseek(Aa_bsf,0L,SEEK_SET);
+            fseek(Ba_brf,0L,SEEK_SET);
+            fseek(Ca_brf,0L,SEEK_SET);
+            fseek(Da_bsf,0L,SEEK_SET);
+            fseek(Ab_bsf,0L,SEEK_SET);
+            fseek(Bb_brf,0L,SEEK_SET);
+            fseek(Cb_brf,0L,SEEK_SET);
+            fseek(Db_bsf,0L,SEEK_SET);
+        }
         for (int bstart = 0; bstart < std::max(nab, nbb); bstart += maxa_b) {
             int na_bblock = (bstart + maxa_b >= nab ? nab - bstart : maxa_b);
             int nb_bblock = (bstart + maxb_b >= nbb ? nbb - bstart : maxb_b);
 
-            if ( na_bblock > 0) {
+            if (!incore && na_bblock > 0) {
                 fread(Aa_bsp[0],sizeof(double),na_bblock*nasQ,Aa_bsf);
                 fread(Ba_brp[0],sizeof(double),na_bblock*narQ,Ba_brf);
                 fread(Ca_brp[0],sizeof(double),na_bblock*narQ,Ca_brf);
                 fread(Da_bsp[0],sizeof(double),na_bblock*nasQ,Da_bsf);
             }
 
-            if ( nb_bblock > 0) {
+            if (!incore && nb_bblock > 0) {
                 fread(Ab_bsp[0],sizeof(double),nb_bblock*nbsQ,Ab_bsf);
                 fread(Bb_brp[0],sizeof(double),nb_bblock*nbrQ,Bb_brf);
                 fread(Cb_brp[0],sizeof(double),nb_bblock*nbrQ,Cb_brf);
@@ -31,6 +31,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 #include <string>
 #include <sstream>
@@ -56,6 +57,7 @@
 #endif
 
 #include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/structured_log.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/mintshelper.h"
@@ -358,6 +360,22 @@ void HF::common_init()
     soscf_max_iter_ = options_.get_int("SOSCF_MAX_ITER");
     soscf_conv_ = options_.get_double("SOSCF_CONV");
     soscf_print_ = options_.get_bool("SOSCF_PRINT");
+    soscf_type_ = options_.get_str("SOSCF_TYPE");
+    soscf_max_step_ = options_.get_double("SOSCF_MAX_STEP");
+    soscf_trust_ = soscf_max_step_;
+    soscf_last_E_ = 0.0;
+
+    // Density-matrix purification
+    purification_ = options_.get_str("DENSITY_PURIFICATION");
+    purification_r_start_ = options_.get_double("DENSITY_PURIFICATION_START_CONVERGENCE");
+    purified_ = false;
+    if (purification_ != "NONE") {
+        std::string reference = options_.get_str("REFERENCE");
+        if (reference != "RHF" && reference != "RKS")
+            throw PSIEXCEPTION("DENSITY_PURIFICATION is only available for RHF and RKS references.");
+        if (soscf_enabled_ || options_.get_int("MOM_START") != 0 || options_.get_int("FRAC_START") != 0)
+            throw PSIEXCEPTION("DENSITY_PURIFICATION needs no orbitals during the iterations, turn off SOSCF, MOM and FRAC.");
+    }
 
     // MOM convergence acceleration
     MOM_enabled_ = (options_.get_int("MOM_START") != 0);
@@ -370,17 +388,11 @@ void HF::common_init()
     print_header();
 
     // DFT stuff
+    dft_grid_guess_ = false;
     if (functional_->needs_xc()){
-        potential_ = VBase::build_V(basisset_, functional_, options_, (options_.get_str("REFERENCE") == "RKS" ? "RV" : "UV"));
-        potential_->initialize();
-
-        // Do the GRAC
-        if (options_.get_double("DFT_GRAC_SHIFT") != 0.0){
-            potential_->set_grac_shift(options_.get_double("DFT_GRAC_SHIFT"));
-        }
-
-        // Print the KS-specific stuff
-        potential_->print_header();
+        dft_grid_guess_ = (options_.get_int("DFT_GUESS_SPHERICAL_POINTS") > 0) &&
+                          (options_.get_str("DFT_GRID_NAME") == "");
+        build_potential(dft_grid_guess_);
     } else {
         potential_ = nullptr;
     }
@@ -411,6 +423,164 @@ int HF::soscf_update() {
         "Sorry, second-order convergence has not been implemented for this "
         "type of SCF wavefunction yet.");
 }
+
+namespace {
+
+// Dot product and axpy over the blocks of an orbital rotation
+double block_dot(const std::vector<SharedMatrix>& a, const std::vector<SharedMatrix>& b) {
+    double dot = 0.0;
+    for (size_t i = 0; i < a.size(); i++) dot += a[i]->vector_dot(b[i]);
+    return dot;
+}
+void block_axpy(double alpha, const std::vector<SharedMatrix>& x, std::vector<SharedMatrix>& y) {
+    for (size_t i = 0; i < x.size(); i++) y[i]->axpy(alpha, x[i]);
+}
+std::vector<SharedMatrix> block_clone(const std::vector<SharedMatrix>& x) {
+    std::vector<SharedMatrix> y;
+    for (size_t i = 0; i < x.size(); i++) y.push_back(x[i]->clone());
+    return y;
+}
+
+}  // namespace
+
+SharedMatrix HF::soscf_diagonal(SharedMatrix C, SharedMatrix F, const Dimension& noccpi) {
+    Dimension virpi = nmopi_ - noccpi;
+    SharedMatrix IFock = Matrix::triplet(C, F, C, true, false, false);
+    SharedMatrix diag(new Matrix("SOSCF Diagonal", nirrep_, noccpi, virpi));
+    for (size_t h = 0; h < nirrep_; h++) {
+        if (!noccpi[h] || !virpi[h]) continue;
+        double* dp = diag->pointer(h)[0];
+        double** fp = IFock->pointer(h);
+        for (size_t i = 0, target = 0; i < noccpi[h]; i++) {
+            for (size_t a = noccpi[h]; a < nmopi_[h]; a++) {
+                dp[target++] = -fp[i][i] + fp[a][a];
+            }
+        }
+    }
+    return diag;
+}
+
+/*
+ * Davidson on the augmented Hessian [[0, -g^T], [-g, H]] of the model
+ * E(x) = -g.x + 1/2 x.Hx that cphf_solve's Newton step minimizes.  The
+ * lowest eigenvector (1, x) gives (H - lambda) x = g with lambda <= 0, a
+ * level-shifted step that stays downhill when H is not positive definite.
+ * The step is then held to the trust radius, which is halved whenever the
+ * previous AH step raised the energy.
+ */
+int HF::soscf_ah_step(const std::vector<SharedMatrix>& g, const std::vector<SharedMatrix>& diag,
+                      std::vector<SharedMatrix>& x) {
+    double gnorm = sqrt(block_dot(g, g));
+    if (gnorm == 0.0) return 0;
+
+    // => Trust radius update <= //
+    if (soscf_last_E_ != 0.0) {
+        if (E_ > soscf_last_E_) {
+            soscf_trust_ *= 0.5;
+        } else {
+            soscf_trust_ = std::min(1.5 * soscf_trust_, soscf_max_step_);
+        }
+    }
+    soscf_last_E_ = E_;
+
+    if (soscf_print_) {
+        outfile->Printf("\n    ==> AH SOSCF, trust radius = %8.2E <==\n\n", soscf_trust_);
+        outfile->Printf("    %4s %14s %14s\n", "Iter", "Lambda", "Residual");
+    }
+
+    std::vector<std::vector<SharedMatrix> > V, HV;
+    std::vector<double> c;
+    double lambda = 0.0;
+    int nmicro = 0;
+
+    std::vector<SharedMatrix> trial = block_clone(g);
+    for (size_t b = 0; b < g.size(); b++) trial[b]->apply_denominator(diag[b]);
+
+    for (int iter = 0; iter < soscf_max_iter_; iter++) {
+        // Orthonormalize against the subspace, twice for stability
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t j = 0; j < V.size(); j++) block_axpy(-block_dot(V[j], trial), V[j], trial);
+        }
+        double tnorm = sqrt(block_dot(trial, trial));
+        if (tnorm < 1.e-12) break;
+        for (size_t b = 0; b < trial.size(); b++) trial[b]->scale(1.0 / tnorm);
+
+        // One JK call covers every block of the trial vector
+        HV.push_back(cphf_Hx(trial));
+        V.push_back(trial);
+        nmicro++;
+
+        // Augmented subspace Hessian
+        int n = V.size();
+        SharedMatrix M(new Matrix("Augmented Hessian", n + 1, n + 1));
+        double** Mp = M->pointer();
+        for (int i = 0; i < n; i++) {
+            Mp[0][i + 1] = Mp[i + 1][0] = -block_dot(g, V[i]);
+            for (int j = 0; j <= i; j++) {
+                Mp[i + 1][j + 1] = Mp[j + 1][i + 1] =
+                    0.5 * (block_dot(V[i], HV[j]) + block_dot(V[j], HV[i]));
+            }
+        }
+        SharedMatrix evecs(new Matrix("Augmented Hessian Eigenvectors", n + 1, n + 1));
+        SharedVector evals(new Vector("Augmented Hessian Eigenvalues", n + 1));
+        M->diagonalize(evecs, evals, ascending);
+
+        double y0 = evecs->get(0, 0);
+        if (std::fabs(y0) < 1.e-8) break;
+        lambda = evals->get(0);
+        c.resize(n);
+        for (int j = 0; j < n; j++) c[j] = evecs->get(j + 1, 0) / y0;
+
+        // Residual, (H - lambda) x - g
+        std::vector<SharedMatrix> r = block_clone(g);
+        for (size_t b = 0; b < r.size(); b++) r[b]->scale(-1.0);
+        for (int j = 0; j < n; j++) {
+            block_axpy(c[j], HV[j], r);
+            block_axpy(-lambda * c[j], V[j], r);
+        }
+        double rnorm = sqrt(block_dot(r, r)) / gnorm;
+
+        if (soscf_print_) {
+            outfile->Printf("    %4d %14.6E %14.6E\n", nmicro, lambda, rnorm);
+        }
+        if ((rnorm < soscf_conv_) && (nmicro >= soscf_min_iter_)) break;
+
+        // Next trial, r / (diag - lambda)
+        trial = r;
+        for (size_t b = 0; b < trial.size(); b++) {
+            for (int h = 0; h < trial[b]->nirrep(); h++) {
+                size_t size = (size_t)trial[b]->rowspi()[h] * trial[b]->colspi()[h];
+                if (!size) continue;
+                double* tp = trial[b]->pointer(h)[0];
+                double* dp = diag[b]->pointer(h)[0];
+                for (size_t p = 0; p < size; p++) {
+                    double denom = dp[p] - lambda;
+                    if (std::fabs(denom) < 1.e-4) denom = (denom < 0.0 ? -1.e-4 : 1.e-4);
+                    tp[p] /= denom;
+                }
+            }
+        }
+    }
+
+    if (c.empty()) return 0;
+
+    // => Assemble and restrict the step <= //
+    x = block_clone(g);
+    for (size_t b = 0; b < x.size(); b++) x[b]->zero();
+    for (size_t j = 0; j < c.size(); j++) block_axpy(c[j], V[j], x);
+
+    double xnorm = sqrt(block_dot(x, x));
+    if (xnorm > soscf_trust_) {
+        for (size_t b = 0; b < x.size(); b++) x[b]->scale(soscf_trust_ / xnorm);
+        if (soscf_print_) {
+            outfile->Printf("    Step of norm %8.2E restricted to the trust radius.\n", xnorm);
+        }
+    }
+    if (soscf_print_) outfile->Printf("\n");
+
+    cphf_nfock_builds_ = nmicro;
+    return nmicro;
+}
 void HF::form_V() {
     throw PSIEXCEPTION(
         "Sorry, DFT functionals are not suppored for this type of SCF wavefunction.");
@@ -485,26 +655,10 @@ void HF::integrals()
 
     // Build the JK from options, symmetric type
     // try {
-    if(options_.get_str("SCF_TYPE") == "GTFOCK") {
-      #ifdef HAVE_JK_FACTORY
-        //DGAS is adding to the ghetto, this Python -> C++ -> C -> C++ -> back to C is FUBAR
-        std::shared_ptr<Molecule> other_legacy = Process::environment.legacy_molecule();
-        Process::environment.set_legacy_molecule(molecule_);
-        if(options_.get_bool("SOSCF"))
-            jk_ = std::shared_ptr<JK>(new GTFockJK(basisset_,2,false));
-        else
-            jk_ = std::shared_ptr<JK>(new GTFockJK(basisset_,2,true));
-        Process::environment.set_legacy_molecule(other_legacy);
-      #else
-        throw PSIEXCEPTION("GTFock was not compiled in this version.\n");
-      #endif
+    if (options_.get_str("SCF_TYPE") == "DF"){
+        jk_ = JK::build_JK(get_basisset("ORBITAL"), get_basisset("DF_BASIS_SCF"), options_);
     } else {
-        if (options_.get_str("SCF_TYPE") == "DF"){
-            jk_ = JK::build_JK(get_basisset("ORBITAL"), get_basisset("DF_BASIS_SCF"), options_);
-        } else {
-            jk_ = JK::build_JK(get_basisset("ORBITAL"), BasisSet::zero_ao_basis_set(), options_);
-
-        }
+        jk_ = JK::build_JK(get_basisset("ORBITAL"), BasisSet::zero_ao_basis_set(), options_);
     }
 
     // Tell the JK to print
@@ -519,6 +673,9 @@ void HF::integrals()
     jk_->set_do_wK(functional_->is_x_lrc());
     // w Value
     jk_->set_omega(functional_->x_omega());
+    // Early builds in single precision, for this SCF only
+    jk_->set_mixed_precision(options_.get_bool("DF_SCF_MIXED_PRECISION"));
+    jk_->set_mixed_precision_switch(options_.get_double("DF_SCF_MIXED_PRECISION_SWITCH"));
 
     // Initialize
     jk_->initialize();
@@ -685,6 +842,11 @@ void HF::finalize()
 {
     // Clean memory off, handle diis closeout, etc
 
+    if (jk_ && !options_.get_str("JK_METRICS_FILE").empty()) {
+        std::ofstream metrics(options_.get_str("JK_METRICS_FILE").c_str());
+        metrics << jk_->metrics_json() << std::endl;
+    }
+
     // This will be the only one
     if (!options_.get_bool("SAVE_JK")) {
         jk_.reset();
@@ -1843,6 +2005,14 @@ void HF::iterations()
 
         outfile->Printf( "   @%s%s iter %3d: %20.14f   %12.5e   %-11.5e %s\n", df ? "DF-" : "",
                           reference.c_str(), iteration_, E_, E_ - Eold_, Drms_, status.c_str());
+        StructuredLog::Record("scf iteration")
+            .add("reference", (df ? "DF-" : "") + reference)
+            .add("iteration", iteration_)
+            .add("energy", E_)
+            .add("delta_energy", E_ - Eold_)
+            .add("density_rms", Drms_)
+            .add("status", status)
+            .write();
 
 
         // If a an excited MOM is requested but not started, don't stop yet
@@ -1863,11 +2033,45 @@ void HF::iterations()
             integrals();
         }
 
+        // If on the coarse guess grid, move to the full grid and keep running
+        if (converged_ && dft_grid_guess_) {
+            outfile->Printf( "\n  Coarse grid guess converged, moving to the full DFT grid.\n\n");
+            converged_ = false;
+            if(initialized_diis_manager_)
+                diis_manager_->reset_subspace();
+            dft_grid_guess_ = false;
+            build_potential(false);
+        }
+
         // Call any postiteration callbacks
 //        call_postiteration_callbacks();
 
     } while (!converged_ && iteration_ < maxiter_ );
 
+    finish_purification();
+}
+
+void HF::build_potential(bool coarse)
+{
+    potential_ = VBase::build_V(basisset_, functional_, options_, (options_.get_str("REFERENCE") == "RKS" ? "RV" : "UV"));
+    if (coarse) {
+        std::map<std::string, int> grid_opts;
+        grid_opts["DFT_SPHERICAL_POINTS"] = options_.get_int("DFT_GUESS_SPHERICAL_POINTS");
+        if (options_.get_int("DFT_GUESS_RADIAL_POINTS") > 0) {
+            grid_opts["DFT_RADIAL_POINTS"] = options_.get_int("DFT_GUESS_RADIAL_POINTS");
+        }
+        potential_->set_grid_options(grid_opts);
+    }
+    potential_->initialize();
+
+    // Do the GRAC
+    if (options_.get_double("DFT_GRAC_SHIFT") != 0.0){
+        potential_->set_grac_shift(options_.get_double("DFT_GRAC_SHIFT"));
+    }
+
+    // Print the KS-specific stuff
+    if (coarse) outfile->Printf("  Starting on a coarse DFT grid...\n\n");
+    potential_->print_header();
 }
 
 void HF::print_energies()
@@ -1991,6 +2195,112 @@ void HF::diagonalize_F(const SharedMatrix& Fm, SharedMatrix& Cm, std::shared_ptr
     Cm->gemm(false, false, 1.0, X_, diag_C_temp_, 0.0);
 }
 
+bool HF::purify_density(const SharedMatrix& Fm, const Dimension& noccpi, SharedMatrix& Dm)
+{
+    const int max_iter = 100;
+
+    //Form F' = X'FX, the projector P is formed in diag_C_temp_
+    diag_temp_->gemm(true, false, 1.0, X_, Fm, 0.0);
+    diag_F_temp_->gemm(false, false, 1.0, diag_temp_, X_, 0.0);
+    diag_C_temp_->zero();
+
+    for (int h = 0; h < nirrep_; h++) {
+        int n = nmopi_[h];
+        int nocc = noccpi[h];
+        if (!n) continue;
+
+        double** Fp = diag_F_temp_->pointer(h);
+        double** Pp = diag_C_temp_->pointer(h);
+
+        if (nocc == 0) continue;
+        if (nocc >= n) {
+            for (int i = 0; i < n; i++) Pp[i][i] = 1.0;
+            continue;
+        }
+
+        // Gershgorin bounds of the spectrum
+        double emin = Fp[0][0], emax = Fp[0][0], trF = 0.0;
+        for (int i = 0; i < n; i++) {
+            double radius = 0.0;
+            for (int j = 0; j < n; j++)
+                if (j != i) radius += std::fabs(Fp[i][j]);
+            emin = std::min(emin, Fp[i][i] - radius);
+            emax = std::max(emax, Fp[i][i] + radius);
+            trF += Fp[i][i];
+        }
+        if (emax - emin < 1.0E-10) return false;
+
+        // Initial guess with the spectrum mapped into [0,1], occupied towards 1
+        size_t nn = n * (size_t) n;
+        std::vector<double> X(nn), X2(nn), T(nn);
+        if (purification_ == "TRS4") {
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    X[i * n + j] = ((i == j ? emax : 0.0) - Fp[i][j]) / (emax - emin);
+        } else {
+            double mu = trF / n;
+            double lambda = std::min(nocc / (emax - mu), (n - nocc) / (mu - emin));
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    X[i * n + j] = lambda / n * ((i == j ? mu : 0.0) - Fp[i][j]) + (i == j ? (double) nocc / n : 0.0);
+        }
+
+        bool converged = false;
+        for (int iter = 0; iter < max_iter; iter++) {
+            C_DGEMM('N', 'N', n, n, n, 1.0, X.data(), n, X.data(), n, 0.0, X2.data(), n);
+
+            double trX = 0.0, trX2 = 0.0;
+            for (int i = 0; i < n; i++) {
+                trX += X[i * n + i];
+                trX2 += X2[i * n + i];
+            }
+            double idempotency = trX - trX2;
+            if (std::fabs(idempotency) < 1.0E-12 * n) {
+                converged = true;
+                break;
+            }
+
+            // Traces of the symmetric powers without forming them, tr(X^3) = X2.X, tr(X^4) = X2.X2
+            double trX3 = C_DDOT(nn, X2.data(), 1, X.data(), 1);
+
+            if (purification_ == "TRS4") {
+                // Niklasson's trace-resetting fourth-order purification
+                double trX4 = C_DDOT(nn, X2.data(), 1, X2.data(), 1);
+                double trFX = 4.0 * trX3 - 3.0 * trX4;
+                double trGX = trX2 - 2.0 * trX3 + trX4;
+                double gamma = (trGX > 0.0 ? (nocc - trFX) / trGX : 0.0);
+                if (gamma > 6.0) {
+                    for (size_t ij = 0; ij < nn; ij++) X[ij] = 2.0 * X[ij] - X2[ij];
+                } else if (gamma < 0.0) {
+                    X.swap(X2);
+                } else {
+                    // X <- X2 ((4 - 2g) X + (g - 3) X2 + g)
+                    for (size_t ij = 0; ij < nn; ij++) T[ij] = (4.0 - 2.0 * gamma) * X[ij] + (gamma - 3.0) * X2[ij];
+                    for (int i = 0; i < n; i++) T[i * n + i] += gamma;
+                    C_DGEMM('N', 'N', n, n, n, 1.0, X2.data(), n, T.data(), n, 0.0, X.data(), n);
+                }
+            } else {
+                // Palser and Manolopoulos canonical purification, c = tr(X2 - X3) / tr(X - X2)
+                C_DGEMM('N', 'N', n, n, n, 1.0, X2.data(), n, X.data(), n, 0.0, T.data(), n);
+                double c = (trX2 - trX3) / idempotency;
+                if (c >= 0.5) {
+                    for (size_t ij = 0; ij < nn; ij++) X[ij] = ((1.0 + c) * X2[ij] - T[ij]) / c;
+                } else {
+                    for (size_t ij = 0; ij < nn; ij++) X[ij] = ((1.0 - 2.0 * c) * X[ij] + (1.0 + c) * X2[ij] - T[ij]) / (1.0 - c);
+                }
+            }
+        }
+        if (!converged) return false;
+
+        ::memcpy((void*) Pp[0], (void*) X.data(), sizeof(double) * nn);
+    }
+
+    //Form D = XPX'
+    diag_temp_->gemm(false, true, 1.0, diag_C_temp_, X_, 0.0);
+    Dm->gemm(false, false, 1.0, X_, diag_temp_, 0.0);
+    return true;
+}
+
 void HF::reset_occupation()
 {
     // RHF style for now
@@ -145,6 +145,11 @@ protected:
     /// TODO We should really get rid of that and put it in the driver
     std::string old_scf_type_;
 
+    /// Is the KS potential still on the coarse DFT_GUESS_SPHERICAL_POINTS grid?
+    bool dft_grid_guess_;
+    /// Build potential_ on the full grid, or on the coarse guess grid
+    void build_potential(bool coarse);
+
     /// Perturb the Hamiltonian?
     int perturb_h_;
     /// How big of a perturbation
@@ -199,6 +204,21 @@ protected:
     double soscf_conv_;
     /// Do we print the microiterations?
     double soscf_print_;
+    /// Second-order step, NEWTON (CG on the Newton equations) or AH (augmented Hessian)
+    std::string soscf_type_;
+    /// Largest norm of an AH orbital rotation
+    double soscf_max_step_;
+    /// Current trust radius of the AH step
+    double soscf_trust_;
+    /// Energy before the previous AH step (0 if none was taken)
+    double soscf_last_E_;
+
+    /// Density-matrix purification in place of diagonalization, NONE, TRS4 or CANONICAL
+    std::string purification_;
+    /// Purify once the density RMS is below this
+    double purification_r_start_;
+    /// Was the current density purified (so that the orbitals are stale)?
+    bool purified_;
 
     /// The amount (%) of the previous orbitals to mix in during SCF damping
     double damping_percentage_;
@@ -352,9 +372,29 @@ protected:
     /** Applies second-order convergence acceleration */
     virtual int soscf_update();
 
+    /**
+     * Trust-region augmented-Hessian orbital step.
+     * @param g The occ x vir orbital gradient blocks (one for RHF, alpha and beta for UHF)
+     * @param diag The matching diagonal Hessian guesses, used as the preconditioner
+     * @param x On return, the rotation blocks to pass to rotate_orbitals
+     * @return The number of Hessian products taken, zero if no step was found
+     */
+    int soscf_ah_step(const std::vector<SharedMatrix>& g, const std::vector<SharedMatrix>& diag,
+                      std::vector<SharedMatrix>& x);
+
+    /// Diagonal guess of the orbital Hessian, f_aa - f_ii, for orbitals C with noccpi occupied
+    SharedMatrix soscf_diagonal(SharedMatrix C, SharedMatrix F, const Dimension& noccpi);
+
     /** Transformation, diagonalization, and backtransform of Fock matrix */
     virtual void diagonalize_F(const SharedMatrix& F, SharedMatrix& C, std::shared_ptr<Vector>& eps);
 
+    /** Occupied projector of F with noccpi orbitals per irrep, by purification in the
+     *  orthogonal basis, D = X P(X^T F X) X^T. Returns false (D untouched) if it fails. */
+    bool purify_density(const SharedMatrix& F, const Dimension& noccpi, SharedMatrix& D);
+
+    /** Orbitals and density from the final Fock matrix after purified iterations */
+    virtual void finish_purification() {}
+
     /** Computes the initial MO coefficients (default is to call form_C) */
     virtual void form_initial_C() { form_C(); }
 
@@ -190,7 +190,11 @@ void RHF::form_G()
     /// Push the C matrix on
     std::vector<SharedMatrix> & C = jk_->C_left();
     C.clear();
-    C.push_back(Ca_subset("SO", "OCC"));
+    // A purified D has no orbitals, its Cholesky factor stands in for them
+    if (purified_)
+        C.push_back(D_->partial_cholesky_factorize(1.0E-12, false));
+    else
+        C.push_back(Ca_subset("SO", "OCC"));
 
     // Run the JK object
     jk_->compute();
@@ -280,11 +284,30 @@ void RHF::form_F() {
 }
 
 void RHF::form_C() {
+    // Purify D straight from F once the occupations have settled
+    purified_ = false;
+    if (purification_ != "NONE" && iteration_ > 1 && Drms_ < purification_r_start_) {
+        timer_on("HF: Purify D");
+        purified_ = purify_density(Fa_, doccpi_, D_);
+        timer_off("HF: Purify D");
+        if (purified_) return;
+    }
+
     diagonalize_F(Fa_, Ca_, epsilon_a_);
     find_occupation();
 }
 
+void RHF::finish_purification() {
+    if (!purified_) return;
+    purified_ = false;
+    diagonalize_F(Fa_, Ca_, epsilon_a_);
+    form_D();
+}
+
 void RHF::form_D() {
+    // Already formed by purification
+    if (purified_) return;
+
     for (int h = 0; h < nirrep_; ++h) {
         int nso = nsopi_[h];
         int nmo = nmopi_[h];
@@ -657,6 +680,31 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
         outfile->Printf("   -----------------------------------------------------\n");
     }
 
+    // => Shared subspace for several right-hand sides <= //
+    // Possible when all perturbations have the same shape and the subspace fits in memory
+    bool shared = (x_vec.size() > 1);
+    for (size_t i = 1; shared && i < x_vec.size(); i++) {
+        if ((c1_input_[i] != c1_input_[0]) || (x_vec[i]->symmetry() != x_vec[0]->symmetry()) ||
+            (x_vec[i]->rowspi() != x_vec[0]->rowspi()) || (x_vec[i]->colspi() != x_vec[0]->colspi())) {
+            shared = false;
+        }
+    }
+    if (shared) {
+        size_t vec_size = 0;
+        for (int h = 0; h < x_vec[0]->nirrep(); h++) {
+            vec_size += (size_t)x_vec[0]->rowspi()[h] * x_vec[0]->colspi()[h ^ x_vec[0]->symmetry()];
+        }
+        size_t subspace_bytes = 2L * x_vec.size() * std::max(max_iter, 1) * vec_size * sizeof(double);
+        if (subspace_bytes > (size_t)memory_ / 2) shared = false;
+    }
+    if (shared) {
+        std::vector<SharedMatrix> ret_vec = cphf_solve_shared(
+            x_vec, (c1_input_[0] ? Precon_ao : Precon_so), conv_tol, max_iter, print_lvl, start);
+        Precon_ao.reset();
+        Precon_so.reset();
+        return ret_vec;
+    }
+
     // => Initial state <= //
 
     // What vectors do we need?
@@ -831,6 +879,150 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
 
 }
 
+/**
+ * Solves all of the CPHF equations in one shared, preconditioned subspace.
+ * Each iteration adds the preconditioned residuals of the unconverged
+ * equations, builds their Hessian products in a single cphf_Hx call, and
+ * solves the projected equations for every right-hand side at once, so a
+ * direction found for one perturbation is used by all of them.
+ */
+std::vector<SharedMatrix> RHF::cphf_solve_shared(const std::vector<SharedMatrix>& x_vec,
+                                                 SharedMatrix Precon, double conv_tol,
+                                                 int max_iter, int print_lvl, time_t start) {
+    int nvecs = x_vec.size();
+    std::vector<SharedMatrix> ret_vec(nvecs), r_vec(nvecs);
+    std::vector<double> resid_denom(nvecs), rms(nvecs);
+    std::vector<bool> active(nvecs, true);
+
+    // Orthonormal subspace vectors, their Hessian products, and the projections
+    std::vector<SharedMatrix> V, AV;
+    std::vector<std::vector<double> > G;
+    std::vector<std::vector<double> > F(nvecs);
+
+    // Guess: preconditioned right-hand sides
+    std::vector<SharedMatrix> trial;
+    for (size_t i = 0; i < nvecs; i++) {
+        resid_denom[i] = x_vec[i]->sum_of_squares();
+        if (resid_denom[i] < 1.e-14) {
+            resid_denom[i] = 1.e-14;  // Prevent rel denom from being too small
+        }
+        trial.push_back(x_vec[i]->clone());
+        trial.back()->apply_denominator(Precon);
+    }
+
+    int nremain = nvecs;
+    time_t stop;
+    for (int iter = 1; iter <= max_iter && nremain; iter++) {
+        // Gram-Schmidt, twice, against the subspace and the other new vectors
+        size_t nold = V.size();
+        std::vector<SharedMatrix> new_vecs;
+        for (size_t t = 0; t < trial.size(); t++) {
+            SharedMatrix v = trial[t];
+            double norm0 = sqrt(v->sum_of_squares());
+            for (int pass = 0; pass < 2; pass++) {
+                for (size_t j = 0; j < V.size(); j++) v->axpy(-v->vector_dot(V[j]), V[j]);
+                for (size_t j = 0; j < new_vecs.size(); j++) v->axpy(-v->vector_dot(new_vecs[j]), new_vecs[j]);
+            }
+            double norm = sqrt(v->sum_of_squares());
+            if (norm == 0.0 || norm <= 1.e-10 * norm0) continue;
+            v->scale(1.0 / norm);
+            new_vecs.push_back(v);
+        }
+        if (new_vecs.empty()) break;
+
+        std::vector<SharedMatrix> Anew = cphf_Hx(new_vecs);
+        cphf_nfock_builds_ += new_vecs.size();
+        V.insert(V.end(), new_vecs.begin(), new_vecs.end());
+        AV.insert(AV.end(), Anew.begin(), Anew.end());
+
+        // Grow the projected Hessian and right-hand sides by the new rows
+        size_t n = V.size();
+        G.resize(n);
+        for (size_t i = 0; i < n; i++) G[i].resize(n, 0.0);
+        for (size_t i = nold; i < n; i++) {
+            for (size_t j = 0; j <= i; j++) {
+                G[i][j] = G[j][i] = V[j]->vector_dot(AV[i]);
+            }
+        }
+        for (size_t k = 0; k < nvecs; k++) {
+            for (size_t i = nold; i < n; i++) F[k].push_back(V[i]->vector_dot(x_vec[k]));
+        }
+
+        // Solve the projected equations, all right-hand sides at once
+        std::vector<double> Gp(n * n), c(n * nvecs);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) Gp[i * n + j] = G[i][j];
+        }
+        for (size_t k = 0; k < nvecs; k++) {
+            for (size_t i = 0; i < n; i++) c[k * n + i] = F[k][i];
+        }
+        std::vector<int> ipiv(n);
+        int info = C_DGESV(n, nvecs, Gp.data(), n, ipiv.data(), c.data(), n);
+        if (info) {
+            outfile->Printf("RHF::CPHF Warning subspace Hessian is singular (info = %d). Stopping.\n", info);
+            break;
+        }
+
+        // Solutions and residuals, r = x - A c
+        double max_rms = 0.0;
+        double mean_rms = 0.0;
+        nremain = 0;
+        trial.clear();
+        for (size_t k = 0; k < nvecs; k++) {
+            ret_vec[k] = x_vec[k]->clone();
+            ret_vec[k]->zero();
+            r_vec[k] = x_vec[k]->clone();
+            for (size_t i = 0; i < n; i++) {
+                ret_vec[k]->axpy(c[k * n + i], V[i]);
+                r_vec[k]->axpy(-c[k * n + i], AV[i]);
+            }
+            rms[k] = sqrt(r_vec[k]->sum_of_squares() / resid_denom[k]);
+            mean_rms += rms[k];
+            if (rms[k] > max_rms) max_rms = rms[k];
+
+            // Converged equations leave the active set for good
+            if (active[k] && rms[k] < conv_tol) active[k] = false;
+            if (active[k]) {
+                trial.push_back(r_vec[k]->clone());
+                trial.back()->apply_denominator(Precon);
+                nremain++;
+            }
+        }
+        mean_rms /= (double)nvecs;
+
+        stop = time(NULL);
+        if (print_lvl) {
+            outfile->Printf("    %5d %14.3e %12.3e %7d %9ld\n", iter, mean_rms, max_rms, nremain,
+                            stop - start);
+        }
+    }
+
+    // Fall back on the guess if not even one subspace could be built
+    for (size_t k = 0; k < nvecs; k++) {
+        if (!ret_vec[k]) {
+            ret_vec[k] = x_vec[k]->clone();
+            ret_vec[k]->apply_denominator(Precon);
+        }
+    }
+
+    if (!nremain) {
+        cphf_converged_ = true;
+    }
+
+    // Print out tail
+    if (print_lvl > 1) {
+        outfile->Printf("   -----------------------------------------------------\n");
+        outfile->Printf("\n");
+        if (nremain) {
+            outfile->Printf("    Warning! %d equations did not converge!\n\n", nremain);
+        } else {
+            outfile->Printf("    Solver has converged.\n\n");
+        }
+    }
+
+    return ret_vec;
+}
+
 int RHF::soscf_update()
 {
     int fock_builds;
@@ -854,8 +1046,13 @@ int RHF::soscf_update()
         return 0;
     }
 
-    std::vector<SharedMatrix> ret_x = cphf_solve({Gradient}, soscf_conv_, soscf_max_iter_,
-                                             soscf_print_ ? 2 : 0);
+    std::vector<SharedMatrix> ret_x;
+    if (soscf_type_ == "AH") {
+        std::vector<SharedMatrix> diag = {soscf_diagonal(Ca_, Fa_, doccpi_)};
+        if (!soscf_ah_step({Gradient}, diag, ret_x)) return 0;
+    } else {
+        ret_x = cphf_solve({Gradient}, soscf_conv_, soscf_max_iter_, soscf_print_ ? 2 : 0);
+    }
 
     // => Rotate orbitals <= //
     rotate_orbitals(Ca_, ret_x[0]);
@@ -49,6 +49,7 @@ protected:
 
     void form_C();
     void form_D();
+    virtual void finish_purification();
     virtual void damp_update();
     double compute_initial_E();
     virtual double compute_E();
@@ -73,6 +74,11 @@ protected:
     // Second-order convergence code
     virtual int soscf_update(void);
 
+    /// Multiple right-hand side CPHF solver in one shared subspace, used by cphf_solve
+    std::vector<SharedMatrix> cphf_solve_shared(const std::vector<SharedMatrix>& x_vec,
+                                                SharedMatrix Precon, double conv_tol,
+                                                int max_iter, int print_lvl, time_t start);
+
 public:
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional);
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional,
@@ -38,8 +38,18 @@
 #include <cstdio>
 #include <cmath>
 #include <algorithm>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
 #include <vector>
 #include <utility>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "psi4/psifiles.h"
 #include "psi4/libciomr/libciomr.h"
@@ -68,6 +78,84 @@ using namespace psi;
 
 namespace psi { namespace scf {
 
+namespace {
+
+/// Atomic UHF densities of this process, by sad_density_key()
+std::map<std::string, SharedMatrix> sad_density_cache;
+
+/// Everything an atomic UHF density depends on: element, electron count
+/// and spin, the exact (fitting) basis, and the SAD options
+std::string sad_density_key(std::shared_ptr<BasisSet> bas, std::shared_ptr<BasisSet> fit, int nelec, int nhigh, Options& options)
+{
+    std::stringstream key;
+    key << std::setprecision(17);
+    key << "Z " << bas->molecule()->Z(0) << " nelec " << nelec << " nhigh " << nhigh;
+    key << " type " << options.get_str("SAD_SCF_TYPE") << " frac " << options.get_bool("SAD_FRAC_OCC");
+    key << " e " << options.get_double("SAD_E_CONVERGENCE") << " d " << options.get_double("SAD_D_CONVERGENCE");
+    key << " maxiter " << options.get_int("SAD_MAXITER");
+    std::vector<std::shared_ptr<BasisSet> > bases(1, bas);
+    if (options.get_str("SAD_SCF_TYPE") == "DF") bases.push_back(fit);
+    for (std::shared_ptr<BasisSet> b : bases) {
+        key << " |";
+        for (int P = 0; P < b->nshell(); P++) {
+            const GaussianShell& shell = b->shell(P);
+            key << " " << shell.am() << (shell.is_pure() ? "p" : "c");
+            for (int K = 0; K < shell.nprimitive(); K++)
+                key << " " << shell.exp(K) << " " << shell.original_coef(K);
+        }
+    }
+    return key.str();
+}
+
+std::string sad_cache_filename(const std::string& dir, const std::string& key)
+{
+    std::stringstream name;
+    name << dir << "/sad." << std::hex << std::hash<std::string>()(key) << ".dat";
+    return name.str();
+}
+
+// File layout: key length, key, nbf, then the nbf x nbf density
+SharedMatrix read_sad_cache_file(const std::string& dir, const std::string& key, int nbf)
+{
+    std::ifstream in(sad_cache_filename(dir, key).c_str(), std::ios::binary);
+    if (!in) return SharedMatrix();
+
+    size_t n = 0;
+    if (!in.read(reinterpret_cast<char*>(&n), sizeof(size_t)) || n != key.size()) return SharedMatrix();
+    std::string file_key(n, ' ');
+    int file_nbf = 0;
+    if (!in.read(&file_key[0], n) || file_key != key) return SharedMatrix();
+    if (!in.read(reinterpret_cast<char*>(&file_nbf), sizeof(int)) || file_nbf != nbf) return SharedMatrix();
+
+    SharedMatrix D(new Matrix("Atomic D", nbf, nbf));
+    if (nbf && !in.read(reinterpret_cast<char*>(D->pointer()[0]), sizeof(double) * nbf * nbf)) return SharedMatrix();
+    return D;
+}
+
+void write_sad_cache_file(const std::string& dir, const std::string& key, SharedMatrix D)
+{
+    // Concurrent jobs may share the directory: write a private file, then rename it in place
+    std::string filename = sad_cache_filename(dir, key);
+    std::stringstream tmpname;
+    tmpname << filename << "." << getpid() << ".tmp";
+    {
+        std::ofstream out(tmpname.str().c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            outfile->Printf("  SAD: unable to write atomic density cache file %s.\n", filename.c_str());
+            return;
+        }
+        size_t n = key.size();
+        int nbf = D->rowdim();
+        out.write(reinterpret_cast<const char*>(&n), sizeof(size_t));
+        out.write(key.data(), n);
+        out.write(reinterpret_cast<const char*>(&nbf), sizeof(int));
+        if (nbf) out.write(reinterpret_cast<const char*>(D->pointer()[0]), sizeof(double) * nbf * nbf);
+    }
+    std::rename(tmpname.str().c_str(), filename.c_str());
+}
+
+}  // namespace
+
 SADGuess::SADGuess(std::shared_ptr<BasisSet> basis,
                    std::vector<std::shared_ptr<BasisSet>> atomic_bases,
                    int nalpha, int nbeta, Options& options) :
@@ -255,28 +343,82 @@ SharedMatrix SADGuess::form_D_AO()
         }
     }
 
-    //Atomic D matrices within the atom specific AO basis
-    std::vector<SharedMatrix> atomic_D;
+    //Atomic D matrices within the atom specific AO basis, from the caches where possible
+    std::string cache_dir = options_.get_str("SAD_CACHE_DIR");
+    bool do_df = (options_.get_str("SAD_SCF_TYPE") == "DF");
+    std::vector<SharedMatrix> atomic_D(nunique);
+    std::vector<std::string> keys(nunique);
+    std::vector<int> tasks;
     for (int A = 0; A<nunique; A++) {
-        int nbf = atomic_bases_[atomic_indices[A]]->nbf();
-        SharedMatrix dtmp(new Matrix("Atomic D", nbf, nbf));
-        atomic_D.push_back(dtmp);
+        int index = atomic_indices[A];
+        int nbf = atomic_bases_[index]->nbf();
+        keys[A] = sad_density_key(atomic_bases_[index], (do_df ? atomic_fit_bases_[index] : BasisSet::zero_ao_basis_set()),
+                                  nelec[index], nhigh[index], options_);
+        if (sad_density_cache.count(keys[A])) {
+            atomic_D[A] = sad_density_cache[keys[A]];
+            if (!cache_dir.empty() && !std::ifstream(sad_cache_filename(cache_dir, keys[A]).c_str()))
+                write_sad_cache_file(cache_dir, keys[A], atomic_D[A]);
+        } else if (!cache_dir.empty() && (atomic_D[A] = read_sad_cache_file(cache_dir, keys[A], nbf))) {
+            sad_density_cache[keys[A]] = atomic_D[A];
+        } else {
+            atomic_D[A] = SharedMatrix(new Matrix("Atomic D", nbf, nbf));
+            tasks.push_back(A);
+        }
+        if (print_ > 1 && std::find(tasks.begin(), tasks.end(), A) == tasks.end())
+            outfile->Printf("  Unique Atom %d which is Atom %d: cached atomic density\n", A, index);
     }
 
+    // The unique atoms are independent: run them side by side, one thread
+    // (and one BLAS thread) each, unless their output has to stay in order
+    int ntask = tasks.size();
+    int nworker = 1;
+#ifdef _OPENMP
+    nworker = std::min(Process::environment.get_n_threads(), ntask);
+    if (print_ > 1 || omp_in_parallel()) nworker = 1;
+#endif
+    nworker = std::max(nworker, 1);
+    size_t memory = (size_t)(0.5 * (Process::environment.get_memory() / 8L) / nworker);
+
     if (print_ > 1)
         outfile->Printf("\n  Performing Atomic UHF Computations:\n");
-    for (int A = 0; A<nunique; A++) {
-        int index = atomic_indices[A];
-        if (print_ > 1)
-            outfile->Printf("\n  UHF Computation for Unique Atom %d which is Atom %d:",A, index);
-        if (options_.get_str("SAD_SCF_TYPE") == "DF"){
-            get_uhf_atomic_density(atomic_bases_[index], atomic_fit_bases_[index], nelec[index], nhigh[index], atomic_D[A]);
-        } else {
-            std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
-            get_uhf_atomic_density(atomic_bases_[index], zbas, nelec[index], nhigh[index], atomic_D[A]);
+
+    std::exception_ptr error;
+    if (nworker > 1) {
+        // The serial timers and BLAS thread pools are not meant for this
+        start_skip_timers();
+        BlasThreadScope blas(nworker);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nworker)
+        for (int t = 0; t < ntask; t++) {
+            int A = tasks[t];
+            int index = atomic_indices[A];
+            try {
+                get_uhf_atomic_density(atomic_bases_[index], (do_df ? atomic_fit_bases_[index] : BasisSet::zero_ao_basis_set()),
+                                       nelec[index], nhigh[index], atomic_D[A], memory);
+            } catch (...) {
+#pragma omp critical
+                if (!error) error = std::current_exception();
+            }
+        }
+
+        stop_skip_timers();
+    } else {
+        for (int t = 0; t < ntask; t++) {
+            int A = tasks[t];
+            int index = atomic_indices[A];
+            if (print_ > 1)
+                outfile->Printf("\n  UHF Computation for Unique Atom %d which is Atom %d:",A, index);
+            get_uhf_atomic_density(atomic_bases_[index], (do_df ? atomic_fit_bases_[index] : BasisSet::zero_ao_basis_set()),
+                                   nelec[index], nhigh[index], atomic_D[A], memory);
+            if (print_ > 1)
+                outfile->Printf("Finished UHF Computation!\n");
         }
-        if (print_ > 1)
-            outfile->Printf("Finished UHF Computation!\n");
+    }
+    if (error) std::rethrow_exception(error);
+
+    for (int A : tasks) {
+        sad_density_cache[keys[A]] = atomic_D[A];
+        if (!cache_dir.empty()) write_sad_cache_file(cache_dir, keys[A], atomic_D[A]);
     }
     if (print_)
         outfile->Printf("\n");
@@ -301,7 +443,7 @@ SharedMatrix SADGuess::form_D_AO()
 
     return DAO;
 }
-void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared_ptr<BasisSet> fit, int nelec, int nhigh, SharedMatrix D)
+void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared_ptr<BasisSet> fit, int nelec, int nhigh, SharedMatrix D, size_t memory)
 {
     std::shared_ptr<Molecule> mol = bas->molecule();
     mol->update_geometry();
@@ -445,8 +587,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
     SharedMatrix Cb_occ(new Matrix("Cb occupied", norbs, nbeta));
 
     //Compute initial Cx, Dx, and D from core guess
-    form_C_and_D(nalpha, norbs, X, H, Ca, Ca_occ, occ_a, Da);
-    form_C_and_D(nbeta, norbs, X, H, Cb, Cb_occ, occ_b, Db);
+    form_C_and_D(nalpha, nbeta, norbs, X, H, H, Ca, Cb, Ca_occ, Cb_occ, occ_a, occ_b, Da, Db);
 
     D->zero();
     D->add(Da);
@@ -502,7 +643,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         throw PSIEXCEPTION(msg.str());
     }
 
-    jk->set_memory((size_t)(0.5 * (Process::environment.get_memory() / 8L)));
+    jk->set_memory(memory);
     jk->initialize();
     if (print_ > 1)
         jk->print_header();
@@ -561,8 +702,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         diis_manager.extrapolate(2, Fa.get(), Fb.get());
 
         //Diagonalize Fa and Fb to from Ca and Cb and Da and Db
-        form_C_and_D(nalpha, norbs, X, Fa, Ca, Ca_occ, occ_a, Da);
-        form_C_and_D(nbeta, norbs, X, Fb, Cb, Cb_occ, occ_b, Db);
+        form_C_and_D(nalpha, nbeta, norbs, X, Fa, Fb, Ca, Cb, Ca_occ, Cb_occ, occ_a, occ_b, Da, Db);
 
         //Form D
         D->copy(Da);
@@ -623,41 +763,58 @@ void SADGuess::form_gradient(int norbs, SharedMatrix grad, SharedMatrix F, Share
 }
 
 
-void SADGuess::form_C_and_D(int nocc, int norbs, SharedMatrix X, SharedMatrix F,
-                                        SharedMatrix C, SharedMatrix Cocc, SharedVector occ,
-                                        SharedMatrix D)
+void SADGuess::form_C_and_D(int nalpha, int nbeta, int norbs, SharedMatrix X, SharedMatrix Fa,
+                            SharedMatrix Fb, SharedMatrix Ca, SharedMatrix Cb, SharedMatrix Ca_occ,
+                            SharedMatrix Cb_occ, SharedVector occ_a, SharedVector occ_b, SharedMatrix Da,
+                            SharedMatrix Db)
 {
-    if (nocc == 0) return;
+    int nocc[2] = {nalpha, nbeta};
+    SharedMatrix F[2] = {Fa, Fb};
+    SharedMatrix C[2] = {Ca, Cb};
+    SharedMatrix Cocc[2] = {Ca_occ, Cb_occ};
+    SharedVector occ[2] = {occ_a, occ_b};
+    SharedMatrix D[2] = {Da, Db};
+
+    // The core guess hands in the same F for both spins, which needs one eigenproblem
+    bool same = (Fa == Fb);
 
     //Forms C in the AO basis for SAD Guesses
     SharedMatrix Scratch1(new Matrix("Scratch1", norbs, norbs));
-    SharedMatrix Scratch2(new Matrix("Scratch2", norbs, norbs));
-
-    // Form Fp = XFX
-    Scratch1->gemm(true, false, 1.0, X, F, 0.0);
-    Scratch2->gemm(false, false, 1.0, Scratch1, X, 0.0);
-
-    SharedVector eigvals(new Vector("Eigenvalue scratch", norbs));
-    Scratch2->diagonalize(Scratch1, eigvals);
-
-    //Form C = XC'
-    C->gemm(false, false, 1.0, X, Scratch1, 0.0);
-
-    // Copy over Cocc
-    double** Coccp = Cocc->pointer();
-    double** Cp = C->pointer();
-    for (int i = 0; i < norbs; i++){
-        C_DCOPY(nocc, Cp[i], 1, Coccp[i], 1);
-    }
-    // Scale by occ
-    for (int i = 0; i < nocc; i++){
-        C_DSCAL(norbs, occ->get(i), &Cp[0][i], nocc);
+    std::vector<SharedMatrix> Fp;
+    std::vector<SharedMatrix> Cp;
+    std::vector<SharedVector> eigvals;
+    for (int s = 0; s < 2; s++) {
+        if (nocc[s] == 0 || (s == 1 && same && nocc[0])) continue;
+
+        // Form Fp = XFX
+        Scratch1->gemm(true, false, 1.0, X, F[s], 0.0);
+        Fp.push_back(SharedMatrix(new Matrix("Fp", norbs, norbs)));
+        Fp.back()->gemm(false, false, 1.0, Scratch1, X, 0.0);
+        Cp.push_back(SharedMatrix(new Matrix("Cp", norbs, norbs)));
+        eigvals.push_back(SharedVector(new Vector("Eigenvalue scratch", norbs)));
+    }
+    Matrix::diagonalize_batch(Fp, Cp, eigvals);
+
+    for (int s = 0, k = 0; s < 2; s++) {
+        if (nocc[s] == 0) continue;
+
+        //Form C = XC'
+        C[s]->gemm(false, false, 1.0, X, Cp[k], 0.0);
+        if (!(s == 0 && same)) k++;
+
+        // Copy over Cocc
+        double** Coccp = Cocc[s]->pointer();
+        double** Csp = C[s]->pointer();
+        for (int i = 0; i < norbs; i++){
+            C_DCOPY(nocc[s], Csp[i], 1, Coccp[i], 1);
+        }
+        // Scale by occ
+        for (int i = 0; i < nocc[s]; i++){
+            C_DSCAL(norbs, occ[s]->get(i), &Csp[0][i], nocc[s]);
+        }
+        //Form D = Cocc*Cocc'
+        D[s]->gemm(false, true, 1.0, Cocc[s], Cocc[s], 0.0);
     }
-    //Form D = Cocc*Cocc'
-    D->gemm(false, true, 1.0, Cocc, Cocc, 0.0);
-
-    Scratch1.reset();
-    Scratch2.reset();
 }
 
 void HF::compute_SAD_guess()
@@ -64,11 +64,13 @@ protected:
     SharedMatrix form_D_AO();
     void form_gradient(int norbs, SharedMatrix grad, SharedMatrix F, SharedMatrix D,
                       SharedMatrix S, SharedMatrix X);
+    /// Atomic UHF density of one atom into D, with memory doubles for its JK object
     void get_uhf_atomic_density(std::shared_ptr<BasisSet> atomic_basis, std::shared_ptr<BasisSet> fit_basis,
-                                int n_electrons, int multiplicity, SharedMatrix D);
-    void form_C_and_D(int nocc, int norbs, SharedMatrix X, SharedMatrix F,
-                                  SharedMatrix C, SharedMatrix Cocc, SharedVector occ,
-                                  SharedMatrix D);
+                                int n_electrons, int multiplicity, SharedMatrix D, size_t memory);
+    /// Both spins' C, Cocc and D from Fa and Fb, with the two eigenproblems solved as one batch
+    void form_C_and_D(int nalpha, int nbeta, int norbs, SharedMatrix X, SharedMatrix Fa, SharedMatrix Fb,
+                      SharedMatrix Ca, SharedMatrix Cb, SharedMatrix Ca_occ, SharedMatrix Cb_occ,
+                      SharedVector occ_a, SharedVector occ_b, SharedMatrix Da, SharedMatrix Db);
 
     void form_D();
     void form_C();
@@ -861,8 +861,15 @@ int UHF::soscf_update(void)
         }
         return 0;
     }
-    std::vector<SharedMatrix> ret_x = cphf_solve({Gradient_a, Gradient_b}, soscf_conv_, soscf_max_iter_,
-                                             soscf_print_ ? 2 : 0);
+    std::vector<SharedMatrix> ret_x;
+    if (soscf_type_ == "AH") {
+        std::vector<SharedMatrix> diag = {soscf_diagonal(Ca_, Fa_, nalphapi_),
+                                          soscf_diagonal(Cb_, Fb_, nbetapi_)};
+        if (!soscf_ah_step({Gradient_a, Gradient_b}, diag, ret_x)) return 0;
+    } else {
+        ret_x = cphf_solve({Gradient_a, Gradient_b}, soscf_conv_, soscf_max_iter_,
+                           soscf_print_ ? 2 : 0);
+    }
 
     // => Rotate orbitals <= //
     rotate_orbitals(Ca_, ret_x[0]);
@@ -267,6 +267,7 @@ void DFERI::clear_pair_spaces()
     pair_powers_.clear();
     pair_transposes_.clear();
     ints_.clear();
+    core_ints_.clear();
 }
 void DFERI::clear()
 {
@@ -394,8 +395,29 @@ std::shared_ptr<Matrix> DFERI::Jpow(double power)
 
     return J;
 }
+double* DFERI::core_ints(const std::string& name)
+{
+    auto it = core_ints_.find(name);
+    if (it != core_ints_.end()) return it->second.data();
+
+    auto T = ints_.find(name);
+    if (T == ints_.end()) {
+        throw PSIEXCEPTION("DFERI::core_ints: No computed pair space " + name);
+    }
+    std::vector<double>& data = core_ints_[name];
+    data.resize(T->second->numel());
+    FILE* fh = T->second->file_pointer();
+    fseek(fh, 0L, SEEK_SET);
+    if (fread(data.data(), sizeof(double), data.size(), fh) != data.size()) {
+        core_ints_.erase(name);
+        throw PSIEXCEPTION("DFERI::core_ints: Could not read pair space " + name);
+    }
+    return data.data();
+}
 void DFERI::compute()
 {
+    core_ints_.clear();
+
     // => Allocation <= //
 
     allocate();
@@ -905,6 +927,12 @@ std::map<std::string, std::shared_ptr<Tensor> > LSTHCERI::build_X(bool meth)
                 C_DGEMM('T','N',na,nP,nm,1.0,&Cp[0][start],nn,X1p[0],nP,0.0,X2p,nP);
 
                 if (balance_) {
+                    int nthread = 1;
+                    #ifdef _OPENMP
+                        nthread = Process::environment.get_n_threads();
+                    #endif
+
+                    #pragma omp parallel for num_threads(nthread)
                     for (int P = 0; P < nP; P++) {
                         double w = C_DDOT(na, X2p + P, nP, X2p + P, nP);
                         C_DSCAL(na, pow(w, -1.0/2.0), X2p + P, nP);
@@ -1241,10 +1269,14 @@ std::map<std::string, std::shared_ptr<Tensor> > LSTHCERI::build_S(std::map<std::
                 C_DGEMM('T','N',nP,nP,n1,1.0,X1p,nP,X1p,nP,0.0,S1p,nP);
                 C_DGEMM('T','N',nP,nP,n2,1.0,X2p,nP,X2p,nP,0.0,S2p,nP);
 
-                double* S1tp = S1p;
-                double* S2tp = S2p;
+                int nthread = 1;
+                #ifdef _OPENMP
+                    nthread = Process::environment.get_n_threads();
+                #endif
+
+                #pragma omp parallel for num_threads(nthread)
                 for (size_t ind = 0L; ind < nP * (size_t) nP; ind++) {
-                    (*S1tp++) *= (*S2tp++);
+                    S1p[ind] *= S2p[ind];
                 }
 
                 S1->hermitivitize();
@@ -1282,19 +1314,30 @@ std::map<std::string, std::shared_ptr<Tensor> > LSTHCERI::build_L(std::map<std::
 
                 std::shared_ptr<Tensor> L = CoreTensor::build("L_" + space1 + "_" + space2,
                     "NP", nP, "NAUX", nA);
-                std::shared_ptr<Matrix> T(new Matrix("LT", nA, nP));
 
+                // L = S (J E)^T, streamed over column blocks of E so that
+                // neither E nor J E is ever held in full
+                size_t left = memory_;
+                size_t held = nA * (size_t) nA + 2L * nP * (size_t) nA + nP * (size_t) nP;
+                left = (left > held ? left - held : 0L);
+                size_t max_cols = left / (2L * nA);
+                max_cols = (max_cols < 1L ? 1L : max_cols);
+                max_cols = (max_cols > (size_t) nP ? (size_t) nP : max_cols);
+
+                std::shared_ptr<Matrix> Eblock(new Matrix("E block", nA, max_cols));
+                std::shared_ptr<Matrix> T(new Matrix("LT", nA, max_cols));
+
+                double* Ebp = Eblock->pointer()[0];
                 double* Tp = T->pointer()[0];
                 double* Lp = L->pointer();
                 double* Sp = S->pointer();
-                FILE* fh = E->file_pointer();
 
-                // Avert your eyes
-                fseek(fh,0,SEEK_SET);
-                size_t statusvalue=fread(Lp,sizeof(double),nA*(size_t)nP,fh);
-
-                C_DGEMM('N','N',nA,nP,nA,1.0,Jp,nA,Lp,nP,0.0,Tp,nP);
-                C_DGEMM('N','T',nP,nA,nP,1.0,Sp,nP,Tp,nP,0.0,Lp,nA);
+                for (size_t P0 = 0L; P0 < (size_t) nP; P0 += max_cols) {
+                    int ncol = (int) std::min(max_cols, nP - P0);
+                    E->read_columns(Ebp, P0, ncol);
+                    C_DGEMM('N','N',nA,ncol,nA,1.0,Jp,nA,Ebp,ncol,0.0,Tp,ncol);
+                    C_DGEMM('N','T',nP,nA,ncol,1.0,Sp + P0,nP,Tp,ncol,(P0 ? 1.0 : 0.0),Lp,nA);
+                }
 
                 S->swap_out();
                 L->swap_out();
@@ -1351,6 +1394,81 @@ void LSTHCERI::pack(std::map<std::string, std::shared_ptr<Tensor> >& Xs,
         ints_[name] = task;
     }
 }
+void LSTHCERI::compute_eri_block(const std::string& name, int start1, int end1, double* target)
+{
+    if (!ints_.count(name)) {
+        throw PSIEXCEPTION("LSTHCERI::compute_eri_block: unknown ERI space " + name + ", call compute() first.");
+    }
+    std::vector<std::shared_ptr<Tensor> >& task = ints_[name];
+    std::shared_ptr<Tensor> X1 = task[0];
+    std::shared_ptr<Tensor> X2 = task[1];
+    std::shared_ptr<Tensor> Z  = task[2];
+    std::shared_ptr<Tensor> X3 = task[3];
+    std::shared_ptr<Tensor> X4 = task[4];
+
+    int n1 = X1->sizes()[0];
+    int n2 = X2->sizes()[0];
+    int n3 = X3->sizes()[0];
+    int n4 = X4->sizes()[0];
+    int nP = X1->sizes()[1];
+    size_t n34 = n3 * (size_t) n4;
+    if (start1 < 0 || end1 > n1 || start1 > end1) {
+        throw PSIEXCEPTION("LSTHCERI::compute_eri_block: row range out of bounds.");
+    }
+
+    int nthread = 1;
+    #ifdef _OPENMP
+        nthread = Process::environment.get_n_threads();
+    #endif
+
+    double* X1p = X1->pointer();
+    double* X2p = X2->pointer();
+    double* X3p = X3->pointer();
+    double* X4p = X4->pointer();
+
+    // W_rs^Q = X3_r^Q X4_s^Q
+    std::shared_ptr<Matrix> W(new Matrix("W", n34, nP));
+    double** Wp = W->pointer();
+    #pragma omp parallel for num_threads(nthread)
+    for (int r = 0; r < n3; r++) {
+        for (int s = 0; s < n4; s++) {
+            for (int Q = 0; Q < nP; Q++) {
+                Wp[r * (size_t) n4 + s][Q] = X3p[r * (size_t) nP + Q] * X4p[s * (size_t) nP + Q];
+            }
+        }
+    }
+
+    // Y_P^rs = Z_PQ W_rs^Q
+    std::shared_ptr<Matrix> Y(new Matrix("Y", nP, n34));
+    double** Yp = Y->pointer();
+    Z->swap_in();
+    C_DGEMM('N','T',nP,n34,nP,1.0,Z->pointer(),nP,Wp[0],nP,0.0,Yp[0],n34);
+    Z->swap_out(false);
+    W.reset();
+
+    // (pq|rs) = (X1_p^P X2_q^P) Y_P^rs, one p at a time
+    std::vector<std::shared_ptr<Matrix> > V;
+    for (int thread = 0; thread < nthread; thread++) {
+        V.push_back(std::shared_ptr<Matrix>(new Matrix("V", n2, nP)));
+    }
+
+    #pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int p = start1; p < end1; p++) {
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        double** Vp = V[thread]->pointer();
+        for (int q = 0; q < n2; q++) {
+            for (int P = 0; P < nP; P++) {
+                Vp[q][P] = X1p[p * (size_t) nP + P] * X2p[q * (size_t) nP + P];
+            }
+        }
+        C_DGEMM('N','N',n2,n34,nP,1.0,Vp[0],nP,Yp[0],n34,0.0,target + (p - start1) * n2 * n34,n34);
+    }
+}
 void LSTHCERI::pack_meth(std::map<std::string, std::shared_ptr<Tensor> >& Xs,
                          std::map<std::string, std::shared_ptr<Tensor> >& Ss)
 {
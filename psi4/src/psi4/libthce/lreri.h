@@ -157,6 +157,8 @@ protected:
 
     /// Keep the raw (Q|ia)-type integrals?
     bool keep_raw_integrals_;
+    /// In-core copies of computed tensors, by name, see core_ints()
+    std::map<std::string, std::vector<double> > core_ints_;
 
     // => Utility Routines <= //
 
@@ -201,6 +203,9 @@ public:
     virtual void compute();
     /// Handle to computed disk tensors, by name in add_pair above
     std::map<std::string, std::shared_ptr<Tensor> >& ints() { return ints_; }
+    /// The computed tensor name, read into core on first use and kept until the next
+    /// compute() or clear(). The data is shared by all callers and must not be modified.
+    double* core_ints(const std::string& name);
     /// Return the J matrix raised to the desired power
     std::shared_ptr<Matrix> Jpow(double power = -1.0/2.0);
 
@@ -308,6 +313,14 @@ public:
     virtual void compute();
     /// LS-LSTHC factors [X1,X2,Z,X3,X4,L12,L34,Sinv12,Sinv34]
     std::map<std::string, std::vector<std::shared_ptr<Tensor> > >& ints() { return ints_; };
+    /**
+     * Rebuild a block of the factorized ERIs from ints()[name], for
+     * correlated codes that want (pq|rs) a slice at a time:
+     * target[p - start1][q][r][s] = (pq|rs) for start1 <= p < end1,
+     * q, r, s over all of spaces 2, 3, 4. Needs nP x n3 n4 scratch.
+     * Call compute() first.
+     **/
+    void compute_eri_block(const std::string& name, int start1, int end1, double* target);
 
     /// O: Compute the METH X and Sinv matrices
     virtual void compute_meth();
@@ -1504,4 +1504,33 @@ void DiskTensor::zero()
     delete[] buf;
 }
 
+void DiskTensor::read_block(double* data, size_t offset, size_t size)
+{
+    if (offset + size > numel_) throw PSIEXCEPTION("DiskTensor::read_block: out of range.");
+    fseek(fh_, offset * sizeof(double), SEEK_SET);
+    if (fread((void*) data, sizeof(double), size, fh_) != size)
+        throw PSIEXCEPTION("DiskTensor::read_block: read error.");
+}
+void DiskTensor::write_block(const double* data, size_t offset, size_t size)
+{
+    if (offset + size > numel_) throw PSIEXCEPTION("DiskTensor::write_block: out of range.");
+    fseek(fh_, offset * sizeof(double), SEEK_SET);
+    if (fwrite((const void*) data, sizeof(double), size, fh_) != size)
+        throw PSIEXCEPTION("DiskTensor::write_block: write error.");
+}
+void DiskTensor::read_columns(double* data, size_t col_start, size_t ncol)
+{
+    if (!order_) throw PSIEXCEPTION("DiskTensor::read_columns: scalar tensor.");
+    size_t nrow = sizes_[0];
+    size_t ncol_tot = numel_ / nrow;
+    if (col_start + ncol > ncol_tot) throw PSIEXCEPTION("DiskTensor::read_columns: out of range.");
+    if (ncol == ncol_tot) {
+        read_block(data, 0L, numel_);
+        return;
+    }
+    for (size_t row = 0L; row < nrow; row++) {
+        read_block(data + row * ncol, row * ncol_tot + col_start, ncol);
+    }
+}
+
 }
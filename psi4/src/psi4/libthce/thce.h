@@ -266,6 +266,12 @@ public:
 
     /// Set save flag in DiskTensor
     virtual void set_save(bool save) { throw PSIEXCEPTION("Not implemented in this Tensor subclass."); }
+    /// Read size doubles starting at element offset (flat, row-major)
+    virtual void read_block(double* data, size_t offset, size_t size) { throw PSIEXCEPTION("Not implemented in this Tensor subclass."); }
+    /// Write size doubles starting at element offset (flat, row-major)
+    virtual void write_block(const double* data, size_t offset, size_t size) { throw PSIEXCEPTION("Not implemented in this Tensor subclass."); }
+    /// Read columns [col_start, col_start + ncol) of the tensor seen as a matrix (first index x rest) into data (rows x ncol)
+    virtual void read_columns(double* data, size_t col_start, size_t ncol) { throw PSIEXCEPTION("Not implemented in this Tensor subclass."); }
 };
 
 /**
@@ -488,6 +494,15 @@ public:
     /// Zero the tensor out and prestripe
     virtual void zero();
 
+    // > Streaming < //
+
+    /// Read size doubles starting at element offset (flat, row-major)
+    virtual void read_block(double* data, size_t offset, size_t size);
+    /// Write size doubles starting at element offset (flat, row-major)
+    virtual void write_block(const double* data, size_t offset, size_t size);
+    /// Read columns [col_start, col_start + ncol) of the tensor seen as a matrix (first index x rest) into data (rows x ncol)
+    virtual void read_columns(double* data, size_t col_start, size_t ncol);
+
 };
 
 } // End namespace
@@ -265,6 +265,8 @@ class IntegralTransform{
 
         void trans_one(int m, int n, double *input, double *output, double **C, int soOffset,
                        int *order, bool backtransform = false, double scale = 0.0);
+        void transform_ket_block(dpdbuf4 *J, dpdbuf4 *K, int h, int nrows, SharedMatrix c1, SharedMatrix c2,
+                                 const int *orbspi1, const int *orbspi2);
 
         // Has this instance been initialized yet?
         bool initialized_;
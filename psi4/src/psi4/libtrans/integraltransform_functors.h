@@ -590,5 +590,29 @@ void iwl_integrals(IWL* iwl, DPDFunctor &dpd, FockFunctor &fock)
     iwl->set_keep_flag(1);
 }
 
+/*
+ * Hands each unique integral of nrows rows of a blocked "[n>=n]+" DPD
+ * buffer, already in file->matrix[h] and starting at row offset, to the
+ * Fock functor.  Rows and columns share the pair list, so the unique
+ * integrals are those with rs <= pq.
+ */
+template <class FockFunctor>
+void blocked_integrals(dpdfile4 *file, int h, int offset, int nrows, FockFunctor &fock)
+{
+    dpdparams4 *params = file->params;
+    for(int row = 0; row < nrows; ++row){
+        int pq = row + offset;
+        int p = params->roworb[h][pq][0];
+        int q = params->roworb[h][pq][1];
+        double *values = file->matrix[h][row];
+        for(int rs = 0; rs <= pq; ++rs){
+            if(values[rs] == 0.0) continue;
+            int r = params->colorb[h][rs][0];
+            int s = params->colorb[h][rs][1];
+            fock(p,q,r,s,0,0,0,0,0,0,0,0,values[rs]);
+        }
+    }
+}
+
 } // Namespaces
 #endif // INTEGRALTRANSFORM_FUNCTORS_H
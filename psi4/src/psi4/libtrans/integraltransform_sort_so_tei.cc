@@ -31,6 +31,7 @@
 #include "integraltransform.h"
 
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/psio.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libiwl/iwl.hpp"
@@ -39,6 +40,7 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 
 #include <cmath>
+#include <vector>
 
 #define EXTERN
 #include "psi4/libdpd/dpd.gbl"
@@ -351,6 +353,26 @@ IntegralTransform::presort_so_tei()
 
     }
 
+    /* MintsHelper::integrals_blocked() leaves the integrals already in this
+       file's layout, so the buckets are read instead of sorted */
+    bool blocked = (soIntTEIFile_ == PSIF_SO_TEI) && psio_->exists(PSIF_SO_TEI_BLOCKED);
+    std::vector<size_t> blockStart(nirreps_, 0);
+    if(blocked) {
+        psio_->open(PSIF_SO_TEI_BLOCKED, PSIO_OPEN_OLD);
+        std::vector<int> header(nirreps_ + 1, 0);
+        psio_->read_entry(PSIF_SO_TEI_BLOCKED, "SO TEI Blocked Irreps", (char *) header.data(),
+                          header.size() * sizeof(int));
+        if(header[0] != nirreps_)
+            throw PSIEXCEPTION("LibTrans: the blocked SO integral file was written for a different point group.");
+        for(int h = 0; h < nirreps_; ++h) {
+            if(header[h+1] != sopi_[h])
+                throw PSIEXCEPTION("LibTrans: the blocked SO integral file was written for a different basis.");
+            if(h) blockStart[h] = blockStart[h-1] + static_cast<size_t>(I.params->rowtot[h-1]) * I.params->coltot[h-1];
+        }
+        if(print_)
+            outfile->Printf( "\tReading SO integrals in blocks from file %d.\n", PSIF_SO_TEI_BLOCKED);
+    }
+
     next = PSIO_ZERO;
     for(int n=0; n < nBuckets; ++n) { /* nbuckets = number of passes */
         /* Prepare target matrix */
@@ -358,6 +380,32 @@ IntegralTransform::presort_so_tei()
             I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
         }
 
+        if(blocked) {
+            for(int h=0; h < nirreps_; ++h) {
+                if(!bucketSize[n][h]) continue;
+                psio_address start = psio_get_address(PSIO_ZERO, (blockStart[h] +
+                        static_cast<size_t>(bucketOffset[n][h]) * I.params->coltot[h]) * sizeof(double));
+                psio_->read(PSIF_SO_TEI_BLOCKED, "SO TEI Blocked", (char *) I.matrix[h][0],
+                            bucketSize[n][h]*((long int) sizeof(double)), start, &start);
+                // Each unique integral sits in exactly one bucket, so the Fock contributions go on every pass
+                if(transformationType_ == Restricted){
+                    FrozenCoreAndFockRestrictedFunctor fock(aD, aFzcD,aFock,aFzcOp);
+                    blocked_integrals(&I, h, bucketOffset[n][h], bucketRowDim[n][h], fock);
+                }else{
+                    FrozenCoreAndFockUnrestrictedFunctor fock(aD, bD, aFzcD, bFzcD,
+                                                              aFock, bFock, aFzcOp, bFzcOp);
+                    blocked_integrals(&I, h, bucketOffset[n][h], bucketRowDim[n][h], fock);
+                }
+            }
+            for(int h=0; h < nirreps_; ++h) {
+                if(bucketSize[n][h])
+                    psio_->write(I.filenum, I.label, (char *) I.matrix[h][0],
+                            bucketSize[n][h]*((long int) sizeof(double)), next, &next);
+                free_block(I.matrix[h]);
+            }
+            continue;
+        }
+
         DPDFillerFunctor dpdfiller(&I,n,bucketMap,bucketOffset, false, true);
         NullFunctor null;
         IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
@@ -388,8 +436,12 @@ IntegralTransform::presort_so_tei()
     } /* end loop over buckets/passes */
 
     /* Get rid of the input integral file */
-    psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
-    psio_->close(soIntTEIFile_, keepIwlSoInts_);
+    if(blocked) {
+        psio_->close(PSIF_SO_TEI_BLOCKED, keepIwlSoInts_);
+    } else {
+        psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
+        psio_->close(soIntTEIFile_, keepIwlSoInts_);
+    }
 
     free_int_matrix(bucketMap);
 
@@ -31,14 +31,22 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/libqt/qt.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsi4util/process.h"
 #include <math.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <algorithm>
+#include <vector>
 #include "psi4/psifiles.h"
 #include "mospace.h"
 #define EXTERN
 #include "psi4/libdpd/dpd.gbl"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ;
 using namespace psi;
 
@@ -67,3 +75,99 @@ IntegralTransform::transform_tei(const std::shared_ptr<MOSpace> s1, const std::s
     }
     transform_tei_second_half(s1, s2, s3, s4);
 }
+
+/**
+ * Transforms the ket of the first numRows rows in the current block of J (irrep h)
+ * into K, i.e. K[pq][ij] = Sum_rs C1[r][i] C2[s][j] J[pq][rs].  J must hold a
+ * full (n,n) ket.  The rows are spread over the threads.  Without symmetry
+ * each row is a single nso x nso matrix, so each thread stacks a batch of
+ * rows into one GEMM for the ( n n | n n ) -> ( n n | n S2 ) step, with as
+ * many rows as the free DPD memory allows.
+ *
+ * @param J       - the buffer with the rows to transform
+ * @param K       - the buffer receiving the transformed rows
+ * @param h       - the irrep of the rows
+ * @param numRows - the number of rows in the current block
+ * @param c1      - the coefficients for the first ket index
+ * @param c2      - the coefficients for the second ket index
+ * @param orbspi1 - the number of orbitals per irrep for the first ket index
+ * @param orbspi2 - the number of orbitals per irrep for the second ket index
+ */
+void
+IntegralTransform::transform_ket_block(dpdbuf4 *J, dpdbuf4 *K, int h, int numRows, SharedMatrix c1, SharedMatrix c2,
+                                       const int *orbspi1, const int *orbspi2)
+{
+    if(numRows <= 0) return;
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    if(nthread > numRows) nthread = numRows;
+
+    // The number of rows handed to a thread at once
+    int batch = 1;
+    if(nirreps_ == 1 && orbspi2[0]) {
+        size_t rowSize = static_cast<size_t>(nso_) * orbspi2[0];
+        long int memFree = dpd_memfree();
+        size_t fit = memFree > 0 ? static_cast<size_t>(memFree) / (nthread * rowSize) : 0;
+        size_t perThread = (numRows + nthread - 1) / nthread;
+        batch = static_cast<int>(std::max(static_cast<size_t>(1),
+                                          std::min(fit, std::min(perThread, static_cast<size_t>(64)))));
+    }
+    size_t tmpSize = std::max(static_cast<size_t>(nso_) * nso_,
+                              static_cast<size_t>(batch) * nso_ * (nirreps_ == 1 ? orbspi2[0] : 0));
+    std::vector<std::vector<double> > tmp(nthread, std::vector<double>(tmpSize));
+
+    int nbatch = (numRows + batch - 1) / batch;
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for(int b=0; b < nbatch; b++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *TMP = tmp[thread].data();
+        int first = b * batch;
+        int last = std::min(first + batch, numRows);
+        if(batch > 1) {
+            // Transform ( n n | n n ) -> ( n n | n S2 ) for the whole batch
+            int nmo1 = orbspi1[0];
+            int nmo2 = orbspi2[0];
+            C_DGEMM('n', 'n', (last - first) * nso_, nmo2, nso_, 1.0, J->matrix[h][first],
+                    nso_, c2->pointer(0)[0], nmo2, 0.0, TMP, nmo2);
+            // Transform ( n n | n S2 ) -> ( n n | S1 S2 ), one row at a time
+            if(nmo1) {
+                for(int pq=first; pq < last; pq++)
+                    C_DGEMM('t', 'n', nmo1, nmo2, nso_, 1.0, c1->pointer(0)[0], nmo1,
+                            &TMP[static_cast<size_t>(pq - first) * nso_ * nmo2], nmo2, 0.0, K->matrix[h][pq], nmo2);
+            }
+            continue;
+        }
+        for(int pq=first; pq < last; pq++) {
+            for(int Gr=0; Gr < nirreps_; Gr++) {
+                // Transform ( n n | n n ) -> ( n n | n S2 )
+                int Gs = h^Gr;
+                int nrows = sopi_[Gr];
+                int ncols = orbspi2[Gs];
+                int nlinks = sopi_[Gs];
+                int rs = J->col_offset[h][Gr];
+                double **pc2 = c2->pointer(Gs);
+                if(nrows && ncols && nlinks)
+                    C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J->matrix[h][pq][rs],
+                            nlinks, pc2[0], ncols, 0.0, TMP, nso_);
+                //TODO else if s2->label() == MOSPACE_NIL, copy buffer...
+
+                // Transform ( n n | n S2 ) -> ( n n | S1 S2 )
+                nrows = orbspi1[Gr];
+                ncols = orbspi2[Gs];
+                nlinks = sopi_[Gr];
+                rs = K->col_offset[h][Gr];
+                double **pc1 = c1->pointer(Gr);
+                if(nrows && ncols && nlinks)
+                    C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc1[0], nrows,
+                            TMP, nso_, 0.0, &K->matrix[h][pq][rs], ncols);
+                //TODO else if s1->label() == MOSPACE_NIL, copy buffer...
+            } /* Gr */
+        } /* pq */
+    }
+}
@@ -78,8 +78,6 @@ IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace> s1, c
     size_t rowsLeft;
     size_t memFree;
 
-    double **TMP = block_matrix(nso_, nso_);
-
     /*** AA/AB two-electron integral transformation ***/
 
     if(print_) {
@@ -139,32 +137,7 @@ IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace> s1, c
             else
                 thisBucketRows = (n < nBuckets-1) ? rowsPerBucket : rowsLeft;
             global_dpd_->buf4_mat_irrep_rd_block(&J, h, n*rowsPerBucket, thisBucketRows);
-            for(int pq=0; pq < thisBucketRows; pq++) {
-                for(int Gr=0; Gr < nirreps_; Gr++) {
-                    // Transform ( n n | n n ) -> ( n n | n S2 )
-                    int Gs = h^Gr;
-                    int nrows = sopi_[Gr];
-                    int ncols = aOrbsPI2[Gs];
-                    int nlinks = sopi_[Gs];
-                    int rs = J.col_offset[h][Gr];
-                    double **pc2a = c2a->pointer(Gs);
-                    if(nrows && ncols && nlinks)
-                        C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J.matrix[h][pq][rs],
-                                nlinks, pc2a[0], ncols, 0.0, TMP[0], nso_);
-                    //TODO else if s1->label() == MOSPACE_NIL, copy buffer...
-
-                    // Transform ( n n | n S2 ) -> ( n n | S1 S2 )
-                    nrows = aOrbsPI1[Gr];
-                    ncols = aOrbsPI2[Gs];
-                    nlinks = sopi_[Gr];
-                    rs = K.col_offset[h][Gr];
-                    double **pc1a = c1a->pointer(Gr);
-                    if(nrows && ncols && nlinks)
-                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc1a[0], nrows,
-                                TMP[0], nso_, 0.0, &K.matrix[h][pq][rs], ncols);
-                    //TODO else if s2->label() == MOSPACE_NIL, copy buffer...
-                } /* Gr */
-            } /* pq */
+            transform_ket_block(&J, &K, h, thisBucketRows, c1a, c2a, aOrbsPI1, aOrbsPI2);
             global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n*rowsPerBucket, thisBucketRows);
         }
         global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
@@ -252,32 +225,7 @@ IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace> s1, c
                 else
                     thisBucketRows = (n < nBuckets-1) ? rowsPerBucket : rowsLeft;
                 global_dpd_->buf4_mat_irrep_rd_block(&J, h, n*rowsPerBucket, thisBucketRows);
-                for(int pq=0; pq < thisBucketRows; pq++) {
-                    for(int Gr=0; Gr < nirreps_; Gr++) {
-                        // Transform ( n n | n n ) -> ( n n | n s2 )
-                        int Gs = h^Gr;
-                        int nrows = sopi_[Gr];
-                        int ncols = bOrbsPI2[Gs];
-                        int nlinks = sopi_[Gs];
-                        int rs = J.col_offset[h][Gr];
-                        double **pc2b = c2b->pointer(Gs);
-                        if(nrows && ncols && nlinks)
-                            C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J.matrix[h][pq][rs],
-                            nlinks, pc2b[0], ncols, 0.0, TMP[0], nso_);
-                        //TODO else if s2->label() == MOSPACE_NIL, copy buffer...
-
-                        // Transform ( n n | n s2 ) -> ( n n | s1 s2 )
-                        nrows = bOrbsPI1[Gr];
-                        ncols = bOrbsPI2[Gs];
-                        nlinks = sopi_[Gr];
-                        rs = K.col_offset[h][Gr];
-                        double **pc1b = c1b->pointer(Gr);
-                        if(nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc1b[0], nrows,
-                                    TMP[0], nso_, 0.0, &K.matrix[h][pq][rs], ncols);
-                        //TODO else if s1->label() == MOSPACE_NIL, copy buffer...
-                    } /* Gr */
-                } /* pq */
+                transform_ket_block(&J, &K, h, thisBucketRows, c1b, c2b, bOrbsPI1, bOrbsPI2);
                 global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n*rowsPerBucket, thisBucketRows);
             }
             global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
@@ -313,7 +261,6 @@ IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace> s1, c
 
     psio_->close(PSIF_SO_PRESORT, keepDpdSoInts_);
 
-    free_block(TMP);
     delete [] label;
 
     if(print_){
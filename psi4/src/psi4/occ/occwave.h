@@ -94,6 +94,7 @@ protected:
     void dump_pdms();
     void occ_iterations();
     void tei_sort_iabc();
+    void sort_chem_phys(dpdbuf4 *K, int braID, int ketID, const char *phys, const char *anti, int swap);
     void ekt_ip();
     void ekt_ea();
     void z_vector();
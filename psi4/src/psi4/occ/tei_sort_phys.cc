@@ -0,0 +1,141 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2017 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+#include <algorithm>
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psifiles.h"
+
+#include "occwave.h"
+#include "defines.h"
+
+
+using namespace psi;
+
+namespace psi{ namespace occwave{
+
+/*
+ * Sorts the chemists' notation integrals in K to <pq|rs> = (pr|qs), labelled phys,
+ * and with swap = 1 or 2 also writes the antisymmetrized integrals, labelled anti:
+ *
+ *   swap = 1: <pq||rs> = <pq|rs> - <pq|sr> = (pr|qs) - (ps|qr)
+ *   swap = 2: <pq||rs> = <pq|rs> - <qp|rs> = (pr|qs) - (qr|ps)
+ *
+ * When K and one irrep of each target fit in core, both targets come out of a
+ * single threaded pass over K. Otherwise this falls back to buf4_sort, a copy,
+ * and an antisymmetrization sweep over the sorted integrals.
+ */
+void OCCWave::sort_chem_phys(dpdbuf4 *K, int braID, int ketID, const char *phys, const char *anti, int swap)
+{
+    dpdbuf4 P, A;
+    global_dpd_->buf4_init(&P, PSIF_LIBTRANS_DPD, 0, braID, ketID, braID, ketID, 0, phys);
+
+    long int need = 0;
+    long int block = 0;
+    for(int h = 0; h < nirrep_; ++h){
+        need += (long int) K->params->rowtot[h] * K->params->coltot[h];
+        block = std::max(block, (long int) P.params->rowtot[h] * P.params->coltot[h]);
+    }
+    need += (swap ? 2 : 1) * block;
+
+    // One pass
+    if (need <= dpd_memfree()) {
+        if (swap) global_dpd_->buf4_init(&A, PSIF_LIBTRANS_DPD, 0, braID, ketID, braID, ketID, 0, anti);
+        for(int h = 0; h < nirrep_; ++h){
+            global_dpd_->buf4_mat_irrep_init(K, h);
+            global_dpd_->buf4_mat_irrep_rd(K, h);
+        }
+        for(int h = 0; h < nirrep_; ++h){
+            global_dpd_->buf4_mat_irrep_init(&P, h);
+            if (swap) global_dpd_->buf4_mat_irrep_init(&A, h);
+            #pragma omp parallel for schedule(dynamic)
+            for(int pq = 0; pq < P.params->rowtot[h]; ++pq){
+                int p = P.params->roworb[h][pq][0];
+                int q = P.params->roworb[h][pq][1];
+                for(int rs = 0; rs < P.params->coltot[h]; ++rs){
+                    int r = P.params->colorb[h][rs][0];
+                    int s = P.params->colorb[h][rs][1];
+                    int Gpr = K->params->psym[p] ^ K->params->qsym[r];
+                    double value = K->matrix[Gpr][K->params->rowidx[p][r]][K->params->colidx[q][s]];
+                    P.matrix[h][pq][rs] = value;
+                    if (swap == 1) {
+                        int Gps = K->params->psym[p] ^ K->params->qsym[s];
+                        A.matrix[h][pq][rs] = value - K->matrix[Gps][K->params->rowidx[p][s]][K->params->colidx[q][r]];
+                    }
+                    else if (swap == 2) {
+                        int Gqr = K->params->psym[q] ^ K->params->qsym[r];
+                        A.matrix[h][pq][rs] = value - K->matrix[Gqr][K->params->rowidx[q][r]][K->params->colidx[p][s]];
+                    }
+                }
+            }
+            global_dpd_->buf4_mat_irrep_wrt(&P, h);
+            global_dpd_->buf4_mat_irrep_close(&P, h);
+            if (swap) {
+                global_dpd_->buf4_mat_irrep_wrt(&A, h);
+                global_dpd_->buf4_mat_irrep_close(&A, h);
+            }
+        }
+        for(int h = 0; h < nirrep_; ++h) global_dpd_->buf4_mat_irrep_close(K, h);
+        global_dpd_->buf4_close(&P);
+        if (swap) global_dpd_->buf4_close(&A);
+        return;
+    }
+
+    // Out of core
+    global_dpd_->buf4_close(&P);
+    global_dpd_->buf4_sort(K, PSIF_LIBTRANS_DPD, prqs, braID, ketID, phys);
+    if (!swap) return;
+
+    global_dpd_->buf4_init(&P, PSIF_LIBTRANS_DPD, 0, braID, ketID, braID, ketID, 0, phys);
+    global_dpd_->buf4_copy(&P, PSIF_LIBTRANS_DPD, anti);
+    global_dpd_->buf4_init(&A, PSIF_LIBTRANS_DPD, 0, braID, ketID, braID, ketID, 0, anti);
+    for(int h = 0; h < nirrep_; ++h){
+        global_dpd_->buf4_mat_irrep_init(&A, h);
+        global_dpd_->buf4_mat_irrep_init(&P, h);
+        global_dpd_->buf4_mat_irrep_rd(&A, h);
+        global_dpd_->buf4_mat_irrep_rd(&P, h);
+        #pragma omp parallel for schedule(dynamic)
+        for(int pq = 0; pq < A.params->rowtot[h]; ++pq){
+            int p = A.params->roworb[h][pq][0];
+            int q = A.params->roworb[h][pq][1];
+            for(int rs = 0; rs < A.params->coltot[h]; ++rs){
+                int r = A.params->colorb[h][rs][0];
+                int s = A.params->colorb[h][rs][1];
+                if (swap == 1) A.matrix[h][pq][rs] -= P.matrix[h][pq][P.params->colidx[s][r]];
+                else A.matrix[h][pq][rs] -= P.matrix[h][P.params->rowidx[q][p]][rs];
+            }
+        }
+        global_dpd_->buf4_mat_irrep_wrt(&A, h);
+        global_dpd_->buf4_mat_irrep_close(&A, h);
+        global_dpd_->buf4_mat_irrep_close(&P, h);
+    }
+    global_dpd_->buf4_close(&A);
+    global_dpd_->buf4_close(&P);
+}// end sort_chem_phys
+}} // End Namespaces
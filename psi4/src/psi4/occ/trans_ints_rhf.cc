@@ -95,7 +95,7 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      // (OO|OO) -> <OO|OO>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,O]"),
                   ID("[O>=O]+"), ID("[O>=O]+"), 0, "MO Ints (OO|OO)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[O,O]"), "MO Ints <OO|OO>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[O,O]"), "MO Ints <OO|OO>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|OO) -> <OO|OO>");
 
@@ -104,7 +104,7 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      // (OO|OV) -> <OO|OV>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,V]"),
                   ID("[O>=O]+"), ID("[O,V]"), 0, "MO Ints (OO|OV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[O,V]"), "MO Ints <OO|OV>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[O,V]"), "MO Ints <OO|OV>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|OV) -> <OO|OV>");
 
@@ -113,7 +113,7 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      // (OV|OV) -> <OO|VV>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"),
                   ID("[O,V]"), ID("[O,V]"), 0, "MO Ints (OV|OV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OV|OV) -> <OO|VV>");
 
@@ -122,7 +122,7 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      // (OO|VV) -> <OV|OV>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"),
                   ID("[O>=O]+"), ID("[V>=V]+"), 0, "MO Ints (OO|VV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,V]"), ID("[O,V]"), "MO Ints <OV|OV>");
+     sort_chem_phys(&K, ID("[O,V]"), ID("[O,V]"), "MO Ints <OV|OV>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|VV) -> <OV|OV>");
 
@@ -136,7 +136,7 @@ if (wfn_type_ == "OMP2" && incore_iabc_ == 0) {
 else {
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
                   ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
+     sort_chem_phys(&K, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>", NULL, 0);
      global_dpd_->buf4_close(&K);
 }
      timer_off("Sort (OV|VV) -> <OV|VV>");
@@ -147,7 +147,7 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      // (VV|VV) -> <VV|VV>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"),
                  ID("[V>=V]+"), ID("[V>=V]+"), 0, "MO Ints (VV|VV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[V,V]"), ID("[V,V]"), "MO Ints <VV|VV>");
+     sort_chem_phys(&K, ID("[V,V]"), ID("[V,V]"), "MO Ints <VV|VV>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (VV|VV) -> <VV|VV>");
 }// end if (wfn_type_ == "OMP3" || wfn_type_ == "OCEPA") {
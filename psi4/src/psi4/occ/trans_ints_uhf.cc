@@ -113,19 +113,19 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      timer_on("Sort (OO|OO) -> <OO|OO>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,O]"),
                   ID("[O>=O]+"), ID("[O>=O]+"), 0, "MO Ints (OO|OO)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[O,O]"), "MO Ints <OO|OO>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[O,O]"), "MO Ints <OO|OO>", "MO Ints <OO||OO>", 1);
      global_dpd_->buf4_close(&K);
 
      // (oo|oo) -> <oo|oo>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,o]"),
                   ID("[o>=o]+"), ID("[o>=o]+"), 0, "MO Ints (oo|oo)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[o,o]"), ID("[o,o]"), "MO Ints <oo|oo>");
+     sort_chem_phys(&K, ID("[o,o]"), ID("[o,o]"), "MO Ints <oo|oo>", "MO Ints <oo||oo>", 1);
      global_dpd_->buf4_close(&K);
 
      // (OO|oo) -> <Oo|Oo>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[o,o]"),
                   ID("[O>=O]+"), ID("[o>=o]+"), 0, "MO Ints (OO|oo)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,o]"), ID("[O,o]"), "MO Ints <Oo|Oo>");
+     sort_chem_phys(&K, ID("[O,o]"), ID("[O,o]"), "MO Ints <Oo|Oo>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|OO) -> <OO|OO>");
 
@@ -135,25 +135,25 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      timer_on("Sort (OO|OV) -> <OO|OV>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,V]"),
                   ID("[O>=O]+"), ID("[O,V]"), 0, "MO Ints (OO|OV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[O,V]"), "MO Ints <OO|OV>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[O,V]"), "MO Ints <OO|OV>", "MO Ints <OO||OV>", 2);
      global_dpd_->buf4_close(&K);
 
      // (oo|ov) -> <oo|ov>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,v]"),
                   ID("[o>=o]+"), ID("[o,v]"), 0, "MO Ints (oo|ov)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[o,o]"), ID("[o,v]"), "MO Ints <oo|ov>");
+     sort_chem_phys(&K, ID("[o,o]"), ID("[o,v]"), "MO Ints <oo|ov>", "MO Ints <oo||ov>", 2);
      global_dpd_->buf4_close(&K);
 
      // (OO|ov) -> <Oo|Ov>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[o,v]"),
                   ID("[O>=O]+"), ID("[o,v]"), 0, "MO Ints (OO|ov)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,o]"), ID("[O,v]"), "MO Ints <Oo|Ov>");
+     sort_chem_phys(&K, ID("[O,o]"), ID("[O,v]"), "MO Ints <Oo|Ov>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (OV|oo) -> <Oo|Vo>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[o,o]"),
                   ID("[O,V]"), ID("[o>=o]+"), 0, "MO Ints (OV|oo)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,o]"), ID("[V,o]"), "MO Ints <Oo|Vo>");
+     sort_chem_phys(&K, ID("[O,o]"), ID("[V,o]"), "MO Ints <Oo|Vo>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|OV) -> <OO|OV>");
 
@@ -163,19 +163,19 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      timer_on("Sort (OV|OV) -> <OO|VV>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"),
                   ID("[O,V]"), ID("[O,V]"), 0, "MO Ints (OV|OV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
+     sort_chem_phys(&K, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>", "MO Ints <OO||VV>", 1);
      global_dpd_->buf4_close(&K);
 
      // (ov|ov) -> <oo|vv>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,v]"), ID("[o,v]"),
                   ID("[o,v]"), ID("[o,v]"), 0, "MO Ints (ov|ov)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[o,o]"), ID("[v,v]"), "MO Ints <oo|vv>");
+     sort_chem_phys(&K, ID("[o,o]"), ID("[v,v]"), "MO Ints <oo|vv>", "MO Ints <oo||vv>", 1);
      global_dpd_->buf4_close(&K);
 
      // (OV|ov) -> <Oo|Vv>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[o,v]"),
                   ID("[O,V]"), ID("[o,v]"), 0, "MO Ints (OV|ov)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,o]"), ID("[V,v]"), "MO Ints <Oo|Vv>");
+     sort_chem_phys(&K, ID("[O,o]"), ID("[V,v]"), "MO Ints <Oo|Vv>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (OV|ov) -> <Ov|Vo>: <Ia||Bj> = <Ia|Bj> = (IB|ja)
@@ -190,25 +190,25 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      timer_on("Sort (OO|VV) -> <OV|OV>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"),
                   ID("[O>=O]+"), ID("[V>=V]+"), 0, "MO Ints (OO|VV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,V]"), ID("[O,V]"), "MO Ints <OV|OV>");
+     sort_chem_phys(&K, ID("[O,V]"), ID("[O,V]"), "MO Ints <OV|OV>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (oo|vv) -> <ov|ov>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[v,v]"),
                   ID("[o>=o]+"), ID("[v>=v]+"), 0, "MO Ints (oo|vv)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[o,v]"), ID("[o,v]"), "MO Ints <ov|ov>");
+     sort_chem_phys(&K, ID("[o,v]"), ID("[o,v]"), "MO Ints <ov|ov>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (OO|vv) -> <Ov|Ov>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[v,v]"),
                   ID("[O>=O]+"), ID("[v>=v]+"), 0, "MO Ints (OO|vv)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,v]"), ID("[O,v]"), "MO Ints <Ov|Ov>");
+     sort_chem_phys(&K, ID("[O,v]"), ID("[O,v]"), "MO Ints <Ov|Ov>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (VV|oo) -> <Vo|Vo>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[o,o]"),
                   ID("[V>=V]+"), ID("[o>=o]+"), 0, "MO Ints (VV|oo)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[V,o]"), ID("[V,o]"), "MO Ints <Vo|Vo>");
+     sort_chem_phys(&K, ID("[V,o]"), ID("[V,o]"), "MO Ints <Vo|Vo>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OO|VV) -> <OV|OV>");
 
@@ -219,25 +219,25 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
      timer_on("Sort (OV|VV) -> <OV|VV>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"),
                   ID("[O,V]"), ID("[V>=V]+"), 0, "MO Ints (OV|VV)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>");
+     sort_chem_phys(&K, ID("[O,V]"), ID("[V,V]"), "MO Ints <OV|VV>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (ov|vv) -> <ov|vv>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,v]"), ID("[v,v]"),
                   ID("[o,v]"), ID("[v>=v]+"), 0, "MO Ints (ov|vv)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[o,v]"), ID("[v,v]"), "MO Ints <ov|vv>");
+     sort_chem_phys(&K, ID("[o,v]"), ID("[v,v]"), "MO Ints <ov|vv>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (OV|vv) -> <Ov|Vv>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[v,v]"),
                   ID("[O,V]"), ID("[v>=v]+"), 0, "MO Ints (OV|vv)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[O,v]"), ID("[V,v]"), "MO Ints <Ov|Vv>");
+     sort_chem_phys(&K, ID("[O,v]"), ID("[V,v]"), "MO Ints <Ov|Vv>", NULL, 0);
      global_dpd_->buf4_close(&K);
 
      // (VV|ov) -> <Vo|Vv>
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[o,v]"),
                   ID("[V>=V]+"), ID("[o,v]"), 0, "MO Ints (VV|ov)");
-     global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[V,o]"), ID("[V,v]"), "MO Ints <Vo|Vv>");
+     sort_chem_phys(&K, ID("[V,o]"), ID("[V,v]"), "MO Ints <Vo|Vv>", NULL, 0);
      global_dpd_->buf4_close(&K);
      timer_off("Sort (OV|VV) -> <OV|VV>");
 
@@ -248,19 +248,19 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
       timer_on("Sort (VV|VV) -> <VV|VV>");
       global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[V,V]"),
                   ID("[V>=V]+"), ID("[V>=V]+"), 0, "MO Ints (VV|VV)");
-      global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[V,V]"), ID("[V,V]"), "MO Ints <VV|VV>");
+      sort_chem_phys(&K, ID("[V,V]"), ID("[V,V]"), "MO Ints <VV|VV>", NULL, 0);
       global_dpd_->buf4_close(&K);
 
       // (vv|vv) -> <vv|vv>
       global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[v,v]"), ID("[v,v]"),
                   ID("[v>=v]+"), ID("[v>=v]+"), 0, "MO Ints (vv|vv)");
-      global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[v,v]"), ID("[v,v]"), "MO Ints <vv|vv>");
+      sort_chem_phys(&K, ID("[v,v]"), ID("[v,v]"), "MO Ints <vv|vv>", NULL, 0);
       global_dpd_->buf4_close(&K);
 
       // (VV|vv) -> <Vv|Vv>
       global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[V,V]"), ID("[v,v]"),
                   ID("[V>=V]+"), ID("[v>=v]+"), 0, "MO Ints (VV|vv)");
-      global_dpd_->buf4_sort(&K, PSIF_LIBTRANS_DPD , prqs, ID("[V,v]"), ID("[V,v]"), "MO Ints <Vv|Vv>");
+      sort_chem_phys(&K, ID("[V,v]"), ID("[V,v]"), "MO Ints <Vv|Vv>", NULL, 0);
       global_dpd_->buf4_close(&K);
       timer_off("Sort (VV|VV) -> <VV|VV>");
       timer_off("Sort chem -> phys");
@@ -270,194 +270,6 @@ if (wfn_type_ != "OMP2" || ekt_ea_ == "TRUE") {
 /************************** Antisymmetrized Ints ********************************************/
 /********************************************************************************************/
       timer_on("Antisymmetrize integrals");
-     // <OO||OO>:  <IJ||KL> =  <IJ|KL> - <IJ|LK>
-     timer_on("Make <OO||OO>");
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,O]"),
-                  ID("[O,O]"), ID("[O,O]"), 0, "MO Ints <OO|OO>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <OO||OO>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,O]"),
-                  ID("[O,O]"), ID("[O,O]"), 0, "MO Ints <OO||OO>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,O]"),
-                  ID("[O,O]"), ID("[O,O]"), 0, "MO Ints <OO|OO>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-        global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            for(int kl = 0; kl < K.params->coltot[h]; ++kl){
-                int k = K.params->colorb[h][kl][0];
-                int l = K.params->colorb[h][kl][1];
-		int lk = G.params->colidx[l][k];
-                K.matrix[h][ij][kl] -= G.matrix[h][ij][lk];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-     }
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_close(&G);
-
-
-     // <oo||oo>:  <ij||kl> =  <ij|kl> - <ij|lk>
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,o]"),
-                  ID("[o,o]"), ID("[o,o]"), 0, "MO Ints <oo|oo>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <oo||oo>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,o]"),
-                  ID("[o,o]"), ID("[o,o]"), 0, "MO Ints <oo||oo>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,o]"),
-                  ID("[o,o]"), ID("[o,o]"), 0, "MO Ints <oo|oo>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-        global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            for(int kl = 0; kl < K.params->coltot[h]; ++kl){
-                int k = K.params->colorb[h][kl][0];
-                int l = K.params->colorb[h][kl][1];
-		int lk = G.params->colidx[l][k];
-                K.matrix[h][ij][kl] -= G.matrix[h][ij][lk];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-     }
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_close(&G);
-     timer_off("Make <OO||OO>");
-
-
-     // <OO||OV>:  <IJ||KA> = <IJ|KA> - <JI|KA>
-     timer_on("Make <OO||OV>");
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,V]"),
-                  ID("[O,O]"), ID("[O,V]"), 0, "MO Ints <OO|OV>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <OO||OV>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,V]"),
-                  ID("[O,O]"), ID("[O,V]"), 0, "MO Ints <OO||OV>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[O,V]"),
-                  ID("[O,O]"), ID("[O,V]"), 0, "MO Ints <OO|OV>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-        global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            int i = K.params->roworb[h][ij][0];
-            int j = K.params->roworb[h][ij][1];
-            int ji = G.params->rowidx[j][i];
-            for(int ka = 0; ka < K.params->coltot[h]; ++ka){
-                K.matrix[h][ij][ka] -= G.matrix[h][ji][ka];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-     }
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_close(&G);
-
-
-
-     // <oo||ov>:   <ij||ka> = <ij|ka> - <ji|ka>
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,v]"),
-                  ID("[o,o]"), ID("[o,v]"), 0, "MO Ints <oo|ov>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <oo||ov>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,v]"),
-                  ID("[o,o]"), ID("[o,v]"), 0, "MO Ints <oo||ov>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[o,v]"),
-                  ID("[o,o]"), ID("[o,v]"), 0, "MO Ints <oo|ov>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-        global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            int i = K.params->roworb[h][ij][0];
-            int j = K.params->roworb[h][ij][1];
-            int ji = G.params->rowidx[j][i];
-            for(int ka = 0; ka < K.params->coltot[h]; ++ka){
-                K.matrix[h][ij][ka] -= G.matrix[h][ji][ka];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-     }
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_close(&G);
-     timer_off("Make <OO||OV>");
-
-
-
-     // <OO||VV>:  <IJ||AB> = <IJ|AB> - <IJ|BA>
-     timer_on("Make <OO||VV>");
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "MO Ints <OO|VV>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <OO||VV>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "MO Ints <OO||VV>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"),
-                  ID("[O,O]"), ID("[V,V]"), 0, "MO Ints <OO|VV>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-	global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            for(int ab = 0; ab < K.params->coltot[h]; ++ab){
-                int a = K.params->colorb[h][ab][0];
-                int b = K.params->colorb[h][ab][1];
-		int ba = G.params->colidx[b][a];
-		K.matrix[h][ij][ab] -= G.matrix[h][ij][ba];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-    }
-    global_dpd_->buf4_close(&K);
-    global_dpd_->buf4_close(&G);
-
-
-     // <oo||vv>:  <ij||ab> = <ij|ab> - <ij|ba>
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[v,v]"),
-                  ID("[o,o]"), ID("[v,v]"), 0, "MO Ints <oo|vv>");
-     global_dpd_->buf4_copy(&K, PSIF_LIBTRANS_DPD, "MO Ints <oo||vv>");
-     global_dpd_->buf4_close(&K);
-     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[v,v]"),
-                  ID("[o,o]"), ID("[v,v]"), 0, "MO Ints <oo||vv>");
-     global_dpd_->buf4_init(&G, PSIF_LIBTRANS_DPD, 0, ID("[o,o]"), ID("[v,v]"),
-                  ID("[o,o]"), ID("[v,v]"), 0, "MO Ints <oo|vv>");
-     for(int h = 0; h < nirrep_; ++h){
-        global_dpd_->buf4_mat_irrep_init(&K, h);
-	global_dpd_->buf4_mat_irrep_init(&G, h);
-        global_dpd_->buf4_mat_irrep_rd(&K, h);
-        global_dpd_->buf4_mat_irrep_rd(&G, h);
-        for(int ij = 0; ij < K.params->rowtot[h]; ++ij){
-            for(int ab = 0; ab < K.params->coltot[h]; ++ab){
-                int a = K.params->colorb[h][ab][0];
-                int b = K.params->colorb[h][ab][1];
-		int ba = G.params->colidx[b][a];
-		K.matrix[h][ij][ab] -= G.matrix[h][ij][ba];
-            }
-        }
-        global_dpd_->buf4_mat_irrep_wrt(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&K, h);
-        global_dpd_->buf4_mat_irrep_close(&G, h);
-    }
-    global_dpd_->buf4_close(&K);
-    global_dpd_->buf4_close(&G);
-    timer_off("Make <OO||VV>");
-
-
       // <OV||OV>:  <IA||JB> = <IB|JA> - (IB|JA)
      timer_on("Make <OV||OV>");
      global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"),
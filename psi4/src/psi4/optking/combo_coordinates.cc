@@ -33,6 +33,7 @@
 
 #include "coordinates.h"
 #include "psi4/optking/physconst.h"
+#include <algorithm>
 #include <sstream>
 #include "print.h"
 
@@ -83,6 +84,52 @@ bool COMBO_COORDINATES::DqDx(GeomType geom, int lookup, double *dqdx, int atom_o
   return true;
 }
 
+void COMBO_COORDINATES::DqDx(GeomType geom, SPARSE_MATRIX &B, int atom_offset) const {
+  vector<double **> dqdx_simple(simples.size(), static_cast<double **>(NULL));
+  vector<double> row(B.ncol, 0.0);
+  vector<bool> in_row(B.ncol, false);
+  vector<int> row_cols;
+
+  B.nrow = index.size();
+  B.start.assign(1, 0);
+  B.col.clear();
+  B.val.clear();
+
+  for (std::size_t cc=0; cc<index.size(); ++cc) {
+    for (std::size_t s=0; s<index[cc].size(); ++s) {
+      int i = index[cc][s];
+      if (dqdx_simple[i] == NULL)
+        dqdx_simple[i] = simples[i]->DqDx(geom);
+
+      for (int j=0; j < simples[i]->g_natom(); ++j) {
+        int atom = atom_offset + simples[i]->g_atom(j);
+        for (int xyz=0; xyz<3; ++xyz) {
+          int c = 3*atom + xyz;
+          if (!in_row[c]) {
+            in_row[c] = true;
+            row_cols.push_back(c);
+          }
+          row[c] += coeff[cc][s] * dqdx_simple[i][j][xyz];
+        }
+      }
+    }
+
+    std::sort(row_cols.begin(), row_cols.end());
+    for (std::size_t k=0; k<row_cols.size(); ++k) {
+      B.col.push_back(row_cols[k]);
+      B.val.push_back(row[row_cols[k]]);
+      row[row_cols[k]] = 0.0;
+      in_row[row_cols[k]] = false;
+    }
+    row_cols.clear();
+    B.start.push_back(B.col.size());
+  }
+
+  for (std::size_t i=0; i<dqdx_simple.size(); ++i)
+    if (dqdx_simple[i] != NULL)
+      free_matrix(dqdx_simple[i]);
+}
+
 // Fills in a B' derivative matrix for one coordinate.
 // If the desired cartesian indices/dimension spans more than just one fragment, provide the atom offset.
 
@@ -36,6 +36,7 @@
 
 #include <vector>
 #include <string>
+#include "linear_algebra.h"
 
 using std::vector;
 using std::string;
@@ -67,6 +68,11 @@ class COMBO_COORDINATES {
   // possibly more than just one fragment, then provide the atom offset.
   bool DqDx(GeomType geom, int lookup, double *dqdx, int frag_atom_offset=0) const;
 
+  // Fills in the rows of all coordinates of a sparse B matrix, whose columns have
+  // to be set already.  Each simple is differentiated once, however many
+  // combinations contain it.
+  void DqDx(GeomType geom, SPARSE_MATRIX &B, int frag_atom_offset=0) const;
+
   // Fills in a B' derivative matrix for one coordinate.
   // If the desired cartesian indices/dimension spans the molecule, i.e.,
   // possibly more than just one fragment, then provide the atom offset.
@@ -651,8 +651,16 @@ void FRAG::compute_B(double **B, int coord_offset, int atom_offset) const {
     for (int x = 0; x <3*natom; ++x)
       B[coord_offset+cc][3*atom_offset + x] = 0.0;
 
+  SPARSE_MATRIX Bs;
+  compute_B(Bs);
   for (int cc=0; cc<Ncoord(); ++cc)
-    coords.DqDx(geom, cc, B[coord_offset+cc], atom_offset);
+    for (int k=Bs.start[cc]; k<Bs.start[cc+1]; ++k)
+      B[coord_offset+cc][3*atom_offset + Bs.col[k]] = Bs.val[k];
+}
+
+void FRAG::compute_B(SPARSE_MATRIX &B) const {
+  B.ncol = 3*natom;
+  coords.DqDx(geom, B);
 }
 
 
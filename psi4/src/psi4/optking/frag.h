@@ -135,6 +135,9 @@ class FRAG {
   // Compute B matrix. Use prevously allocated memory.  Offsets are ideal for molecule.
   void compute_B(double **B_in, int coord_offset, int atom_offset) const ;
 
+  // compute sparse B matrix, columns for the atoms of this fragment only
+  void compute_B(SPARSE_MATRIX &B) const;
+
   // Compute B only for the simple coordinates.
   //void compute_B_simples(double **B, int coord_offset, int atom_offset) const;
 
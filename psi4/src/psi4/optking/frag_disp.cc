@@ -251,8 +251,13 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
   double * first_geom = init_array(Ncarts); // first try at back-transformation
   double * dx = init_array(Ncarts);
   double * tmp_v_Nints = init_array(Nints);
-  double **B = init_matrix(Nints, Ncarts);
-  double **G = init_matrix(Nints, Nints);
+  // Large fragments never form G: dx = B^+ dq by an iterative solve with sparse B
+  bool sparse = Opt_params.bt_sparse_natom > 0 && natom >= Opt_params.bt_sparse_natom;
+  SPARSE_MATRIX B_sparse;
+  double **B = sparse ? NULL : init_matrix(Nints, Ncarts);
+  double **G = sparse ? NULL : init_matrix(Nints, Nints);
+  if (sparse && Opt_params.print_lvl >= 2)
+    oprintf_out("\tUsing sparse B matrix for back-transformation.\n");
 
   bool bt_iter_done = false;
   bool bt_converged = true;
@@ -284,14 +289,21 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
     // B dx = B * (Bt (B Bt)^-1) dq
     //   dx = Bt (B Bt)^-1 dq
     //   dx = Bt G^-1 dq, where G = B B^t.
-    compute_B(B,0,0);
-    opt_matrix_mult(B, 0, B, 1, G, 0, Nints, Ncarts, Nints, 0);
-
-    // u B^t (G_inv dq) = dx
-    G_inv = symm_matrix_inv(G, Nints, true);
-    opt_matrix_mult(G_inv, 0, &dq, 1, &tmp_v_Nints, 1, Nints, Nints, 1, 0);
-    opt_matrix_mult(B, 1, &tmp_v_Nints, 1, &dx, 1, Ncarts, Nints, 1, 0);
-    free_matrix(G_inv);
+    if (sparse) {
+      compute_B(B_sparse);
+      if (!sparse_lsq_solve(B_sparse, dq, dx, 1.0e-12, 2*Ncarts))
+        oprintf_out("\tIterative solve for dx did not converge fully.\n");
+    }
+    else {
+      compute_B(B,0,0);
+      opt_matrix_mult(B, 0, B, 1, G, 0, Nints, Ncarts, Nints, 0);
+
+      // u B^t (G_inv dq) = dx
+      G_inv = symm_matrix_inv(G, Nints, true);
+      opt_matrix_mult(G_inv, 0, &dq, 1, &tmp_v_Nints, 1, Nints, Nints, 1, 0);
+      opt_matrix_mult(B, 1, &tmp_v_Nints, 1, &dx, 1, Ncarts, Nints, 1, 0);
+      free_matrix(G_inv);
+    }
 
     for (i=0; i<Ncarts; ++i)
       new_geom[i] += dx[i];
@@ -379,11 +391,11 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
   else rval = true; // not converged and only for constraint fixing
 
   free_matrix(G);
+  free_matrix(B);
   free_array(new_geom);
   free_array(first_geom);
   free_array(dx);
   free_array(tmp_v_Nints);
-  free_matrix(B);
 
   free_array(q_target);
   free_array(q_orig);
@@ -369,4 +369,61 @@ void matrix_root(double **A, int dim, bool inverse) {
   free_array(A_evals);
 }
 
+void SPARSE_MATRIX::mult(const double *x, double *y) const {
+  for (int i=0; i<nrow; ++i) {
+    double sum = 0.0;
+    for (int k=start[i]; k<start[i+1]; ++k)
+      sum += val[k] * x[col[k]];
+    y[i] = sum;
+  }
+}
+
+void SPARSE_MATRIX::mult_t(const double *x, double *y) const {
+  for (int j=0; j<ncol; ++j)
+    y[j] = 0.0;
+  for (int i=0; i<nrow; ++i)
+    for (int k=start[i]; k<start[i+1]; ++k)
+      y[col[k]] += val[k] * x[i];
+}
+
+// Starting from x = 0 keeps every iterate in the row space of A, so the
+// least-squares solution reached is the minimum-norm one, B^t G^-1 b for B.
+bool sparse_lsq_solve(const SPARSE_MATRIX &A, const double *b, double *x, double conv, int maxiter) {
+  std::vector<double> r(b, b + A.nrow), q(A.nrow);
+  std::vector<double> s(A.ncol), p(A.ncol);
+
+  for (int j=0; j<A.ncol; ++j)
+    x[j] = 0.0;
+
+  A.mult_t(r.data(), s.data());
+  p = s;
+  double gamma = array_dot(s.data(), s.data(), A.ncol);
+  double gamma_stop = conv * conv * gamma;
+
+  for (int iter=0; iter<maxiter; ++iter) {
+    if (gamma <= gamma_stop || gamma == 0.0)
+      return true;
+
+    A.mult(p.data(), q.data());
+    double qq = array_dot(q.data(), q.data(), A.nrow);
+    if (qq == 0.0)
+      return true;
+    double alpha = gamma / qq;
+
+    for (int j=0; j<A.ncol; ++j)
+      x[j] += alpha * p[j];
+    for (int i=0; i<A.nrow; ++i)
+      r[i] -= alpha * q[i];
+
+    A.mult_t(r.data(), s.data());
+    double gamma_new = array_dot(s.data(), s.data(), A.ncol);
+    double beta = gamma_new / gamma;
+    gamma = gamma_new;
+
+    for (int j=0; j<A.ncol; ++j)
+      p[j] = s[j] + beta * p[j];
+  }
+  return (gamma <= gamma_stop);
+}
+
 } // namespace:: opt
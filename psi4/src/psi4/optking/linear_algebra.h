@@ -33,6 +33,8 @@
 #ifndef _opt_linear_algebra_h_
 #define _opt_linear_algebra_h_
 
+#include <vector>
+
 // C functions called by opt which use BLAS/LAPACK routines
 extern "C" {
 
@@ -69,6 +71,28 @@ double array_rms(double *v1, int n);
 // Compute matrix ^1/2 or ^-1/2 if inverse=true
 void matrix_root(double **A, int dim, bool inverse);
 
+// Matrix stored by rows of (column, value) entries, for B matrices whose rows
+// only touch the atoms of one coordinate.  Row i is entries start[i] to start[i+1]-1.
+struct SPARSE_MATRIX {
+  int nrow;
+  int ncol;
+  std::vector<int> start;
+  std::vector<int> col;
+  std::vector<double> val;
+
+  SPARSE_MATRIX(int nr = 0, int nc = 0) : nrow(nr), ncol(nc), start(nr+1, 0) { }
+
+  // y = A x
+  void mult(const double *x, double *y) const;
+  // y = A^t x
+  void mult_t(const double *x, double *y) const;
+};
+
+// Minimum-norm least-squares solution x = A^+ b by conjugate gradients on the
+// normal equations (CGLS).  Stops once |A^t (b - A x)| has dropped by conv;
+// returns false if that took more than maxiter iterations.
+bool sparse_lsq_solve(const SPARSE_MATRIX &A, const double *b, double *x, double conv, int maxiter);
+
 }
 
 #endif
@@ -176,6 +176,10 @@ struct OPT_PARAMS {
   double bt_max_iter;
   bool ensure_bt_convergence;
 
+  // fragments of at least this many atoms are back-transformed with a sparse B matrix
+  // and an iterative least-squares solve instead of inverting G; 0 for never
+  int bt_sparse_natom;
+
   double geom_maxiter;
 
   // rms and max change in cartesian coordinates in backtransformation
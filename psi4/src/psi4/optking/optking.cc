@@ -42,6 +42,7 @@
 
 #if defined(OPTKING_PACKAGE_PSI)
   #include "psi4/libpsi4util/exception.h"
+  #include "psi4/libmints/matrix.h"
 #endif
 
 // Define the return types for optking.
@@ -583,6 +584,29 @@ OptReturnType optking(void) {
   return OptReturnSuccess;
 }
 
+#if defined(OPTKING_PACKAGE_PSI)
+// Lindh model Cartesian Hessian at the current geometry, for a driver that chooses
+// Hessian directions before optking has one (see HESS_SUBSPACE_MODES)
+psi::SharedMatrix model_cartesian_hessian(psi::Options & options) {
+  open_output_dat();
+  set_params(options);
+
+  MOLECULE mol(read_natoms());
+  mol.read_geom_grad();
+  double **H_xyz = mol.Lindh_guess();
+
+  int Ncart = 3 * mol.g_natom();
+  psi::SharedMatrix H(new psi::Matrix("Model Cartesian Hessian", Ncart, Ncart));
+  for (int i=0; i<Ncart; ++i)
+    for (int j=0; j<Ncart; ++j)
+      H->set(i, j, H_xyz[i][j]);
+  free_matrix(H_xyz);
+
+  close_output_dat();
+  return H;
+}
+#endif
+
 // Standard text output file string (psi) or file pointer (qchem)
 // Interpreted by functions in print.cc
 void open_output_dat(void) {
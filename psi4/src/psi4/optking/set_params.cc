@@ -121,6 +121,9 @@ void set_params(void)
 // step to cartesians.
     Opt_params.ensure_bt_convergence = options.get_bool("ENSURE_BT_CONVERGENCE");
 
+// Fragment size from which the back-transformation uses a sparse B matrix
+    Opt_params.bt_sparse_natom = options.get_int("BT_SPARSE_NATOM");
+
 // do stupid, linear scaling of internal coordinates to step limit (not RS-RFO);
     Opt_params.simple_step_scaling = options.get_bool("SIMPLE_STEP_SCALING");
 
@@ -508,6 +511,9 @@ void set_params(void)
   // step to cartesians.
   Opt_params.ensure_bt_convergence = rem_read("REM_GEOM_OPT2_ENSURE_BT_CONVERGENCE");
 
+  // always back-transform with the dense generalized inverse of G
+  Opt_params.bt_sparse_natom = 0;
+
 // follow root   (default 0)
   Opt_params.rfo_follow_root = rem_read(REM_GEOM_OPT2_RFO_FOLLOW_ROOT);
 
@@ -951,6 +957,8 @@ void print_params_out(void) {
   else
     oprintf_out("ensure_bt_convergence = %17s\n", "false");
 
+  oprintf_out( "bt_sparse_natom        = %18d\n", Opt_params.bt_sparse_natom);
+
   if (Opt_params.rfo_follow_root)
   oprintf_out( "rfo_follow_root        = %18s\n", "true");
   else
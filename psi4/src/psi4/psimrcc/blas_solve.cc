@@ -26,8 +26,16 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libmoinfo/libmoinfo.h"
+#include "psi4/libpsi4util/exception.h"
 
 #include "blas.h"
 #include "debugging.h"
@@ -200,6 +208,8 @@ void CCBLAS::compute()
       matrices_in_deque_source[it->get_C_Matrix()]++;
     }
   }
+  if(full_in_core && work.size() > 1 && operations.size() > 1)
+    compute_concurrently();
   while(!operations.empty()){
     // Read the element
     CCOperation& op = operations.front();
@@ -224,6 +234,82 @@ void CCBLAS::compute()
   }
 }
 
+/**
+ * Run the operations of the deque on CC_NUM_THREADS threads. Each operation
+ * goes to the first level after every earlier operation that writes one of
+ * its matrices, or reads the matrix it writes; the operations of a level are
+ * independent and run at the same time, each with its thread's work and
+ * buffer arrays. Conflicting operations keep their order, so the results are
+ * those of the serial loop. Only used when every matrix is in core, as
+ * nothing is loaded or written out while the levels run. The deque is left
+ * for compute() to empty.
+ */
+void CCBLAS::compute_concurrently()
+{
+  std::map<CCMatrix*,int> last_write;
+  std::map<CCMatrix*,int> last_read;
+  std::vector<std::vector<size_t> > levels;
+
+  for(size_t n = 0; n < operations.size(); ++n){
+    CCMatrix* A = operations[n].get_A_Matrix();
+    CCMatrix* sources[2] = {operations[n].get_B_Matrix(),operations[n].get_C_Matrix()};
+    int level = 0;
+    if(A != NULL){
+      if(last_write.count(A)) level = std::max(level,last_write[A] + 1);
+      if(last_read.count(A))  level = std::max(level,last_read[A] + 1);
+    }
+    for(int s = 0; s < 2; ++s)
+      if(sources[s] != NULL && last_write.count(sources[s]))
+        level = std::max(level,last_write[sources[s]] + 1);
+    if(A != NULL) last_write[A] = level;
+    for(int s = 0; s < 2; ++s)
+      if(sources[s] != NULL)
+        last_read[sources[s]] = std::max(level,last_read.count(sources[s]) ? last_read[sources[s]] : 0);
+    if(static_cast<int>(levels.size()) <= level)
+      levels.resize(level + 1);
+    levels[level].push_back(n);
+  }
+
+  int nthreads = static_cast<int>(work.size());
+  for(size_t l = 0; l < levels.size(); ++l){
+    std::vector<size_t>& level = levels[l];
+    std::string error;
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for(size_t k = 0; k < level.size(); ++k){
+      int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      CCOperation& op = operations[level[k]];
+      op.set_scratch(work[thread],buffer[thread]);
+      try{
+        op.compute();
+      }catch(const std::exception& e){
+        #pragma omp critical
+        if(error.empty()) error = e.what();
+      }
+    }
+    if(!error.empty())
+      throw PSIEXCEPTION(error);
+  }
+
+  for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
+    if(it->get_A_Matrix()!=NULL){
+      matrices_in_deque[it->get_A_Matrix()]--;
+      matrices_in_deque_target[it->get_A_Matrix()]--;
+    }
+    if(it->get_B_Matrix()!=NULL){
+      matrices_in_deque[it->get_B_Matrix()]--;
+      matrices_in_deque_source[it->get_B_Matrix()]--;
+    }
+    if(it->get_C_Matrix()!=NULL){
+      matrices_in_deque[it->get_C_Matrix()]--;
+      matrices_in_deque_source[it->get_C_Matrix()]--;
+    }
+  }
+  operations.clear();
+}
+
 /**
  * store a zero_two_diagonal operation without executing it
  * @param cstr
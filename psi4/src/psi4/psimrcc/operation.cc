@@ -37,8 +37,6 @@ namespace psi{
 
     namespace psimrcc{
 
-double* CCOperation::local_work = NULL;
-double* CCOperation::out_of_core_buffer = NULL;
 double CCOperation::zero_timing=0.0;
 double CCOperation::numerical_timing=0.0;
 double CCOperation::contract_timing=0.0;
@@ -56,10 +54,9 @@ CCOperation::CCOperation(double in_factor,std::string in_assignment,
             std::string in_reindexing,std::string in_operation,
             CCMatrix* in_A_Matrix, CCMatrix* in_B_Matrix, CCMatrix* in_C_Matrix,double* work,double* buffer)
 : factor(in_factor), assignment(in_assignment), reindexing(in_reindexing),operation(in_operation),
+out_of_core_buffer(buffer),local_work(work),
 A_Matrix(in_A_Matrix),B_Matrix(in_B_Matrix),C_Matrix(in_C_Matrix)
 {
-  local_work = work;
-  out_of_core_buffer = buffer;
 }
 
 CCOperation::~CCOperation()
@@ -54,6 +54,8 @@ class CCOperation{
     void        print();
     void        print_operation();
     void        compute();
+    /// Point the operation at another pair of scratch arrays (one per thread)
+    void        set_scratch(double* work,double* buffer) {local_work = work; out_of_core_buffer = buffer;}
     static void print_timing();
   private:
   //            Variable        Syntax (p,q,r,s=integers)
@@ -61,8 +63,8 @@ class CCOperation{
     std::string assignment; // = += >= +>=
     std::string reindexing; // ## #pq# #pqrs#
     std::string operation;  // . @ / * X plus
-    static double* out_of_core_buffer;
-    static double* local_work;
+    double*     out_of_core_buffer;
+    double*     local_work;
     CCMatrix*   A_Matrix;
     CCMatrix*   B_Matrix;
     CCMatrix*   C_Matrix;
@@ -86,6 +86,7 @@ void CCOperation::setup_contractions()
       zero_arr(&(local_work[0]),T_matrix_offset);
   }
 
+  #pragma omp atomic
   PartA_timing += PartA.get();
   Timer PartB;
 
@@ -219,6 +220,7 @@ void CCOperation::setup_contractions()
     }
   }  // end of for loop over irreps
 
+  #pragma omp atomic
   PartB_timing += PartB.get();
   Timer PartC;
   if(need_sort){
@@ -228,6 +230,7 @@ void CCOperation::setup_contractions()
         delete[] T_matrix[h];
     delete[] T_matrix;
   }
+  #pragma omp atomic
   PartC_timing += PartC.get();
 }
 
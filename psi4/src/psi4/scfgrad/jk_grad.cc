@@ -80,9 +80,11 @@ std::shared_ptr<JKGrad> JKGrad::build_JKGrad(int deriv, std::shared_ptr<BasisSet
             jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["DF_GRAD_SCREENING_CUTOFF"].has_changed())
+            jk->set_screening_cutoff(options.get_double("DF_GRAD_SCREENING_CUTOFF"));
 
         return std::shared_ptr<JKGrad>(jk);
-    } else if (options.get_str("SCF_TYPE") == "DIRECT" || options.get_str("SCF_TYPE") == "PK" || options.get_str("SCF_TYPE") == "OUT_OF_CORE") {
+    } else if (options.get_str("SCF_TYPE") == "DIRECT" || options.get_str("SCF_TYPE") == "CFMM" || options.get_str("SCF_TYPE") == "COSX" || options.get_str("SCF_TYPE") == "PK" || options.get_str("SCF_TYPE") == "OUT_OF_CORE") {
 
         DirectJKGrad* jk = new DirectJKGrad(deriv,primary);
 
@@ -138,6 +140,7 @@ void DFJKGrad::common_init()
     df_ints_num_threads_ = Process::environment.get_n_threads();
 #endif
     condition_ = 1.0E-12;
+    screening_cutoff_ = 1.0E-12;
     unit_a_ = 105;
     unit_b_ = 106;
     unit_c_ = 107;
@@ -158,6 +161,7 @@ void DFJKGrad::print_header() const
         outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
         outfile->Printf( "    Memory (MB):       %11ld\n", (memory_ *8L) / (1024L * 1024L));
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf( "    Density Screening: %11.0E\n", screening_cutoff_);
         outfile->Printf( "    Fitting Condition: %11.0E\n\n", condition_);
 
         outfile->Printf( "   => Auxiliary Basis Set <=\n\n");
@@ -1140,6 +1144,53 @@ void DFJKGrad::build_Amn_x_terms()
         }
     }
 
+    // => Screening Estimates <= //
+
+    // Schwarz factors sqrt((P|P)) and sqrt((MN|MN)), and the largest |d_P|
+    // and |Dt_MN| of each shell block, so that triplets whose bounded
+    // contribution falls below screening_cutoff_ skip the derivative integrals
+    bool screen = (screening_cutoff_ > 0.0);
+    std::vector<double> P_schwarz;
+    std::vector<double> MN_schwarz;
+    std::vector<double> P_dmax;
+    std::vector<double> MN_Dmax;
+    if (screen) {
+        std::shared_ptr<IntegralFactory> Jfactory(new IntegralFactory(auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_, BasisSet::zero_ao_basis_set()));
+        std::shared_ptr<TwoBodyAOInt> Jint(Jfactory->eri());
+        const double* Jbuffer = Jint->buffer();
+        P_schwarz.resize(auxiliary_->nshell());
+        P_dmax.resize(auxiliary_->nshell(), 0.0);
+        for (int P = 0; P < auxiliary_->nshell(); P++) {
+            Jint->compute_shell(P,0,P,0);
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index();
+            double val = 0.0;
+            for (int p = 0; p < nP; p++) {
+                val = std::max(val, std::fabs(Jbuffer[p * nP + p]));
+                if (do_J_) P_dmax[P] = std::max(P_dmax[P], std::fabs(dp[p + oP]));
+            }
+            P_schwarz[P] = std::sqrt(val);
+        }
+
+        MN_schwarz.resize(npairs);
+        MN_Dmax.resize(npairs, 0.0);
+        for (int MN = 0; MN < npairs; MN++) {
+            int M = shell_pairs[MN].first;
+            int N = shell_pairs[MN].second;
+            MN_schwarz[MN] = std::sqrt(sieve_->shell_pair_value(M,N));
+            if (!do_J_) continue;
+            int nM = primary_->shell(M).nfunction();
+            int oM = primary_->shell(M).function_index();
+            int nN = primary_->shell(N).nfunction();
+            int oN = primary_->shell(N).function_index();
+            for (int m = 0; m < nM; m++) {
+                for (int n = 0; n < nN; n++) {
+                    MN_Dmax[MN] = std::max(MN_Dmax[MN], std::fabs(Dtp[m + oM][n + oN]));
+                }
+            }
+        }
+    }
+
     // => R/U doubling factor <= //
 
     double factor = (restricted ? 2.0 : 1.0);
@@ -1241,10 +1292,6 @@ void DFJKGrad::build_Amn_x_terms()
             int M = shell_pairs[MN].first;
             int N = shell_pairs[MN].second;
 
-            eri[thread]->compute_shell_deriv1(P,0,M,N);
-
-            const double* buffer = eri[thread]->buffer();
-
             int nP = auxiliary_->shell(P).nfunction();
             int cP = auxiliary_->shell(P).ncartesian();
             int aP = auxiliary_->shell(P).ncenter();
@@ -1260,6 +1307,34 @@ void DFJKGrad::build_Amn_x_terms()
             int aN = primary_->shell(N).ncenter();
             int oN = primary_->shell(N).function_index();
 
+            double perm = (M == N ? 1.0 : 2.0);
+
+            if (screen) {
+                double weight = 0.0;
+                if (do_J_) {
+                    weight += P_dmax[P] * MN_Dmax[MN];
+                }
+                if (do_K_ || do_wK_) {
+                    double Jmax = 0.0;
+                    double Kmax = 0.0;
+                    for (int p = 0; p < nP; p++) {
+                        for (int m = 0; m < nM; m++) {
+                            for (int n = 0; n < nN; n++) {
+                                size_t mn = (m + oM) * (size_t) nso + (n + oN);
+                                if (do_K_) Jmax = std::max(Jmax, std::fabs(Jmnp[p + oP][mn]));
+                                if (do_wK_) Kmax = std::max(Kmax, std::fabs(Kmnp[p + oP][mn]));
+                            }
+                        }
+                    }
+                    weight += Jmax + 0.5 * Kmax;
+                }
+                if (perm * weight * P_schwarz[P] * MN_schwarz[MN] < screening_cutoff_) continue;
+            }
+
+            eri[thread]->compute_shell_deriv1(P,0,M,N);
+
+            const double* buffer = eri[thread]->buffer();
+
             int ncart = cP * cM * cN;
             const double *Px = buffer + 0*ncart;
             const double *Py = buffer + 1*ncart;
@@ -1271,77 +1346,88 @@ void DFJKGrad::build_Amn_x_terms()
             const double *Ny = buffer + 7*ncart;
             const double *Nz = buffer + 8*ncart;
 
-            double perm = (M == N ? 1.0 : 2.0);
-
-            double** grad_Jp;
-            double** grad_Kp;
-            double** grad_wKp;
-
-            if (do_J_) {
-                grad_Jp = Jtemps[thread]->pointer();
-            }
-            if (do_K_) {
-                grad_Kp = Ktemps[thread]->pointer();
-            }
-            if (do_wK_) {
-                grad_wKp = wKtemps[thread]->pointer();
-            }
+            // Sum the nine center derivatives of the whole triplet before
+            // touching the per-thread gradients, which lets the loop vectorize
+            double gJ[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            double gK[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            double gwK[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
 
+            int index = 0;
             for (int p = 0; p < nP; p++) {
                 for (int m = 0; m < nM; m++) {
-                    for (int n = 0; n < nN; n++) {
+                    const double* Dtrow = &Dtp[m + oM][oN];
+                    const double* Jrow = ((do_K_ || do_wK_) ? &Jmnp[p + oP][(m + oM) * (size_t) nso + oN] : nullptr);
+                    const double* Krow = (do_wK_ ? &Kmnp[p + oP][(m + oM) * (size_t) nso + oN] : nullptr);
+                    double dval = (do_J_ ? dp[p + oP + pstart] : 0.0);
+                    for (int n = 0; n < nN; n++, index++) {
 
                         if (do_J_) {
-                            double Ival = 1.0 * perm * dp[p + oP + pstart] * Dtp[m + oM][n + oN];
-                            grad_Jp[aP][0] += Ival * (*Px);
-                            grad_Jp[aP][1] += Ival * (*Py);
-                            grad_Jp[aP][2] += Ival * (*Pz);
-                            grad_Jp[aM][0] += Ival * (*Mx);
-                            grad_Jp[aM][1] += Ival * (*My);
-                            grad_Jp[aM][2] += Ival * (*Mz);
-                            grad_Jp[aN][0] += Ival * (*Nx);
-                            grad_Jp[aN][1] += Ival * (*Ny);
-                            grad_Jp[aN][2] += Ival * (*Nz);
+                            double Ival = dval * Dtrow[n];
+                            gJ[0] += Ival * Px[index];
+                            gJ[1] += Ival * Py[index];
+                            gJ[2] += Ival * Pz[index];
+                            gJ[3] += Ival * Mx[index];
+                            gJ[4] += Ival * My[index];
+                            gJ[5] += Ival * Mz[index];
+                            gJ[6] += Ival * Nx[index];
+                            gJ[7] += Ival * Ny[index];
+                            gJ[8] += Ival * Nz[index];
                         }
 
                         if (do_K_) {
-                            double Jval = 1.0 * perm * Jmnp[p + oP][(m + oM) * nso + (n + oN)];
-                            grad_Kp[aP][0] += Jval * (*Px);
-                            grad_Kp[aP][1] += Jval * (*Py);
-                            grad_Kp[aP][2] += Jval * (*Pz);
-                            grad_Kp[aM][0] += Jval * (*Mx);
-                            grad_Kp[aM][1] += Jval * (*My);
-                            grad_Kp[aM][2] += Jval * (*Mz);
-                            grad_Kp[aN][0] += Jval * (*Nx);
-                            grad_Kp[aN][1] += Jval * (*Ny);
-                            grad_Kp[aN][2] += Jval * (*Nz);
+                            double Jval = Jrow[n];
+                            gK[0] += Jval * Px[index];
+                            gK[1] += Jval * Py[index];
+                            gK[2] += Jval * Pz[index];
+                            gK[3] += Jval * Mx[index];
+                            gK[4] += Jval * My[index];
+                            gK[5] += Jval * Mz[index];
+                            gK[6] += Jval * Nx[index];
+                            gK[7] += Jval * Ny[index];
+                            gK[8] += Jval * Nz[index];
                         }
 
                         if (do_wK_) {
-                            double Kval = 0.5 * perm * Kmnp[p + oP][(m + oM) * nso + (n + oN)];
-                            grad_wKp[aP][0] += Kval * (*Px);
-                            grad_wKp[aP][1] += Kval * (*Py);
-                            grad_wKp[aP][2] += Kval * (*Pz);
-                            grad_wKp[aM][0] += Kval * (*Mx);
-                            grad_wKp[aM][1] += Kval * (*My);
-                            grad_wKp[aM][2] += Kval * (*Mz);
-                            grad_wKp[aN][0] += Kval * (*Nx);
-                            grad_wKp[aN][1] += Kval * (*Ny);
-                            grad_wKp[aN][2] += Kval * (*Nz);
+                            double Kval = Krow[n];
+                            gwK[0] += Kval * Px[index];
+                            gwK[1] += Kval * Py[index];
+                            gwK[2] += Kval * Pz[index];
+                            gwK[3] += Kval * Mx[index];
+                            gwK[4] += Kval * My[index];
+                            gwK[5] += Kval * Mz[index];
+                            gwK[6] += Kval * Nx[index];
+                            gwK[7] += Kval * Ny[index];
+                            gwK[8] += Kval * Nz[index];
                         }
-
-                        Px++;
-                        Py++;
-                        Pz++;
-                        Mx++;
-                        My++;
-                        Mz++;
-                        Nx++;
-                        Ny++;
-                        Nz++;
                     }
                 }
             }
+
+            int centers[3] = {aP, aM, aN};
+            if (do_J_) {
+                double** grad_Jp = Jtemps[thread]->pointer();
+                for (int c = 0; c < 3; c++) {
+                    grad_Jp[centers[c]][0] += perm * gJ[3 * c + 0];
+                    grad_Jp[centers[c]][1] += perm * gJ[3 * c + 1];
+                    grad_Jp[centers[c]][2] += perm * gJ[3 * c + 2];
+                }
+            }
+            if (do_K_) {
+                double** grad_Kp = Ktemps[thread]->pointer();
+                for (int c = 0; c < 3; c++) {
+                    grad_Kp[centers[c]][0] += perm * gK[3 * c + 0];
+                    grad_Kp[centers[c]][1] += perm * gK[3 * c + 1];
+                    grad_Kp[centers[c]][2] += perm * gK[3 * c + 2];
+                }
+            }
+            if (do_wK_) {
+                double** grad_wKp = wKtemps[thread]->pointer();
+                for (int c = 0; c < 3; c++) {
+                    grad_wKp[centers[c]][0] += 0.5 * perm * gwK[3 * c + 0];
+                    grad_wKp[centers[c]][1] += 0.5 * perm * gwK[3 * c + 1];
+                    grad_wKp[centers[c]][2] += 0.5 * perm * gwK[3 * c + 2];
+                }
+            }
         }
     }
 
@@ -1664,41 +1750,36 @@ void DFJKGrad::compute_hessian()
     SharedMatrix PQ = metric->get_metric();
     double** PQp = PQ->pointer();
 
+    int maxp = auxiliary_->max_function_per_shell();
+    int maxm = primary_->max_function_per_shell();
+    size_t nij = na * (size_t) na;
+
     SharedVector c(new Vector("c[A] = (mn|A) D[m][n]", np));
     double *cp = c->pointer();
-    SharedMatrix dc(new Matrix("dc[x][A] = (mn|A)^x D[m][n]",  3*natoms, np));
-    double **dcp = dc->pointer();
-    SharedMatrix dAij(new Matrix("dAij[x][A,i,j] = (mn|A)^x C[m][i] C[n][j]",  3*natoms, np*na*na));
-    double **dAijp = dAij->pointer();
     SharedVector d(new Vector("d[A] = Minv[A][B] C[B]", np));
     double *dp = d->pointer();
-    SharedMatrix dd(new Matrix("dd[x][B] = dc[x][A] Minv[A][B]", 3*natoms, np));
-    double **ddp = dd->pointer();
+    SharedMatrix dc(new Matrix("dc[x][A] = (mn|A)^x D[m][n]",  3*natoms, np));
+    double **dcp = dc->pointer();
     SharedMatrix de(new Matrix("de[x][A] = (A|B)^x d[B] ", 3*natoms, np));
     double **dep = de->pointer();
-    SharedMatrix deij(new Matrix("deij[x][A,i,j] = (A|B)^x Bij[B,i,j]", 3*natoms, np*na*na));
-    double **deijp = deij->pointer();
 
     // Build some integral factories
     std::shared_ptr<IntegralFactory> Pmnfactory(new IntegralFactory(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_));
     std::shared_ptr<IntegralFactory> PQfactory(new IntegralFactory(auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_, BasisSet::zero_ao_basis_set()));
     std::shared_ptr<TwoBodyAOInt> Pmnint(Pmnfactory->eri(2));
     std::shared_ptr<TwoBodyAOInt> PQint(PQfactory->eri(2));
-    SharedMatrix Amn(new Matrix("(A|mn)", np, nso*nso));
-    SharedMatrix Ami(new Matrix("(A|mi)", np, nso*na));
-    SharedMatrix Aij(new Matrix("(A|ij)", np, na*na));
-    SharedMatrix Bij(new Matrix("Minv[B][A] (A|ij)", np, na*na));
-    SharedMatrix Bim(new Matrix("Minv[B][A] (A|im)", np, nso*na));
-    SharedMatrix Bmn(new Matrix("Minv[B][A] (A|mn)", np, nso*nso));
+    SharedMatrix Aij(new Matrix("(A|ij)", np, nij));
+    SharedMatrix Bij(new Matrix("Minv[B][A] (A|ij)", np, nij));
     SharedMatrix DPQ(new Matrix("B(P|ij) B(Q|ij)", np, np));
-    double **Amnp = Amn->pointer();
-    double **Amip = Ami->pointer();
     double **Aijp = Aij->pointer();
     double **Bijp = Bij->pointer();
-    double **Bimp = Bim->pointer();
-    double **Bmnp = Bmn->pointer();
     double **DPQp = DPQ->pointer();
 
+    // (A|mn) is only held for one auxiliary shell at a time
+    SharedMatrix Pmn(new Matrix("(P|mn)", maxp, nso*nso));
+    SharedMatrix Pmi(new Matrix("(P|mi)", maxp*nso, na));
+    double **Pmnp = Pmn->pointer();
+    double **Pmip = Pmi->pointer();
 
     for (int P = 0; P < nauxshell; ++P){
         int nP = auxiliary_->shell(P).nfunction();
@@ -1713,147 +1794,41 @@ void DFJKGrad::compute_hessian()
                 Pmnint->compute_shell(P,0,M,N);
                 const double* buffer = Pmnint->buffer();
 
-                for (int p = oP; p < oP+nP; p++) {
+                for (int p = 0; p < nP; p++) {
                     for (int m = oM; m < oM+nM; m++) {
                         for (int n = oN; n < oN+nN; n++) {
-                            Amnp[p][m*nso+n] += (*buffer++);
+                            Pmnp[p][m*nso+n] = (*buffer++);
                         }
                     }
                 }
-                // c[A] = (A|mn) D[m][n]
-                C_DGEMV('N', np, nso*(size_t)nso, 1.0, Amnp[0], nso*(size_t)nso, Dtp[0], 1, 0.0, cp, 1);
-                // (A|mj) = (A|mn) C[n][j]
-                C_DGEMM('N','N',np*(size_t)nso,na,nso,1.0,Amnp[0],nso,Cap[0],na,0.0,Amip[0],na);
-                // (A|ij) = (A|mj) C[m][i]
-                #pragma omp parallel for
-                for (int p = 0; p < np; p++) {
-                    C_DGEMM('T','N',na,na,nso,1.0,Amip[p],na,Cap[0],na,0.0,&Aijp[0][p * (size_t) na * na],na);
-                }
-
             }
         }
+        // c[A] = (A|mn) D[m][n]
+        C_DGEMV('N', nP, nso*(size_t)nso, 1.0, Pmnp[0], nso*(size_t)nso, Dtp[0], 1, 0.0, &cp[oP], 1);
+        // (A|mj) = (A|mn) C[n][j]
+        C_DGEMM('N','N',nP*(size_t)nso,na,nso,1.0,Pmnp[0],nso,Cap[0],na,0.0,Pmip[0],na);
+        // (A|ij) = (A|mj) C[m][i]
+        #pragma omp parallel for
+        for (int p = 0; p < nP; p++) {
+            C_DGEMM('T','N',na,na,nso,1.0,Pmip[p*nso],na,Cap[0],na,0.0,Aijp[p+oP],na);
+        }
     }
+    Pmn.reset();
+    Pmi.reset();
 
     // d[A] = Minv[A][B] c[B]
     C_DGEMV('n', np, np, 1.0, PQp[0], np, cp, 1, 0.0, dp, 1);
     // B[B][i,j] = Minv[A][B] (A|ij)
-    C_DGEMM('n','n', np, na*na, np, 1.0, PQp[0], np, Aijp[0], na*na, 0.0, Bijp[0], na*na);
-    // B[B][i,n] = B[B][i,j] C[n][j]
-    C_DGEMM('N', 'T', np*(size_t)na, nso, na, 1.0, Bijp[0], na, Cap[0], na, 0.0, Bimp[0], nso);
-    // B[B][m,n] = C[m][i] B[B][i,n]
-    #pragma omp parallel for
-    for (int p = 0; p < np; p++) {
-        C_DGEMM('n', 'n', nso, nso, na, 1.0, Cap[0], na, Bimp[p], nso, 0.0, Bmnp[p], nso);
-    }
+    C_DGEMM('n','n', np, nij, np, 1.0, PQp[0], np, Aijp[0], nij, 0.0, Bijp[0], nij);
     // D[A][B] = B[A][ij] B[B][ij]
-    C_DGEMM('n','t', np, np, na*na, 1.0, Bijp[0], na*na, Bijp[0], na*na, 0.0, DPQp[0], np);
-
-    int maxp = auxiliary_->max_function_per_shell();
-    int maxm = primary_->max_function_per_shell();
-    SharedMatrix T(new Matrix("T", maxp, maxm*na));
-    double **Tp = T->pointer();
-
-    for (int P = 0; P < nauxshell; ++P){
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-        int Pcenter = auxiliary_->shell(P).ncenter();
-        int Pncart = auxiliary_->shell(P).ncartesian();
-        int Px = 3 * Pcenter + 0;
-        int Py = 3 * Pcenter + 1;
-        int Pz = 3 * Pcenter + 2;
-        for(int M = 0; M < nshell; ++M){
-            int nM = primary_->shell(M).nfunction();
-            int oM = primary_->shell(M).function_index();
-            int Mcenter = primary_->shell(M).ncenter();
-            int Mncart = primary_->shell(M).ncartesian();
-            int mx = 3 * Mcenter + 0;
-            int my = 3 * Mcenter + 1;
-            int mz = 3 * Mcenter + 2;
-            for(int N = 0; N < nshell; ++N){
-                int nN = primary_->shell(N).nfunction();
-                int oN = primary_->shell(N).function_index();
-                int Ncenter = primary_->shell(N).ncenter();
-                int Nncart = primary_->shell(N).ncartesian();
-                int nx = 3 * Ncenter + 0;
-                int ny = 3 * Ncenter + 1;
-                int nz = 3 * Ncenter + 2;
-
-                size_t stride = Pncart * Mncart * Nncart;
-
-                Pmnint->compute_shell_deriv1(P,0,M,N);
-                const double* buffer = Pmnint->buffer();
-
-                size_t delta = 0L;
-                // Terms for J intermediates
-                // dc[x][A] = D[m][n] (A|mn)^x
-                for (int p = oP; p < oP+nP; p++) {
-                    for (int m = oM; m < oM+nM; m++) {
-                        for (int n = oN; n < oN+nN; n++) {
-                            double Cpmn = Dtp[m][n];
-                            dcp[Px][p] += Cpmn * buffer[0 * stride + delta];
-                            dcp[Py][p] += Cpmn * buffer[1 * stride + delta];
-                            dcp[Pz][p] += Cpmn * buffer[2 * stride + delta];
-                            dcp[mx][p] += Cpmn * buffer[3 * stride + delta];
-                            dcp[my][p] += Cpmn * buffer[4 * stride + delta];
-                            dcp[mz][p] += Cpmn * buffer[5 * stride + delta];
-                            dcp[nx][p] += Cpmn * buffer[6 * stride + delta];
-                            dcp[ny][p] += Cpmn * buffer[7 * stride + delta];
-                            dcp[nz][p] += Cpmn * buffer[8 * stride + delta];
-                            ++delta;
-                        }
-                    }
-                }
-                // Terms for K intermediates
-                // dAij[x][p,i,j] <- (p|mn)^x C[m][i] C[n][j]
-                //
-                // implemented as
-                //
-                // T[p][m,j] <- (p|mn) C[n][j]
-                // dAij[x][p,i,j] <- C[m][i] T[p][m,j]
-                double *ptr = const_cast<double*>(buffer);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+0*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[Px][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+1*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[Py][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+2*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[Pz][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+3*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[mx][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+4*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[my][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+5*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[mz][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+6*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[nx][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+7*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[ny][(p+oP)*na*na], na);
-                C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+8*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
-                #pragma omp parallel for
-                for(int p = 0; p < nP; ++p)
-                    C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &dAijp[nz][(p+oP)*na*na], na);
-
-            }
-        }
-    }
+    C_DGEMM('n','t', np, np, nij, 1.0, Bijp[0], nij, Bijp[0], nij, 0.0, DPQp[0], np);
+    Aij.reset();
 
-    // dd[x][A] = dc[x][B] Minv[B][A]
-    C_DGEMM('N', 'N', 3*natoms, np, np, 1.0, dcp[0], np, PQp[0], np, 0.0, ddp[0], np);
+    // Minv[B][A] (A|mn), again one auxiliary shell at a time
+    SharedMatrix Bmn(new Matrix("Minv[B][A] (A|mn)", maxp, nso*nso));
+    SharedMatrix Bim(new Matrix("Minv[B][A] (A|in)", na, nso));
+    double **Bmnp = Bmn->pointer();
+    double **Bimp = Bim->pointer();
 
     for (int P = 0; P < nauxshell; ++P){
         int nP = auxiliary_->shell(P).nfunction();
@@ -1863,57 +1838,13 @@ void DFJKGrad::compute_hessian()
         int Px = 3 * Pcenter + 0;
         int Py = 3 * Pcenter + 1;
         int Pz = 3 * Pcenter + 2;
-        for(int Q = 0; Q < nauxshell; ++Q){
-            int nQ = auxiliary_->shell(Q).nfunction();
-            int oQ = auxiliary_->shell(Q).function_index();
-            int Qcenter = auxiliary_->shell(Q).ncenter();
-            int Qncart = auxiliary_->shell(Q).ncartesian();
-            int Qx = 3 * Qcenter + 0;
-            int Qy = 3 * Qcenter + 1;
-            int Qz = 3 * Qcenter + 2;
-
-            size_t stride = Pncart * Qncart;
-
-            PQint->compute_shell_deriv1(P,0,Q,0);
-            const double* buffer = PQint->buffer();
-
-            size_t delta = 0L;
-            // J term intermediates
-            // de[x][A] = (A|B)^x d[B]
-            for (int p = oP; p < oP+nP; p++) {
-                for (int q = oQ; q < oQ+nQ; q++) {
-                    double dq = dp[q];
-                    dep[Px][p] += dq * buffer[0 * stride + delta];
-                    dep[Py][p] += dq * buffer[1 * stride + delta];
-                    dep[Pz][p] += dq * buffer[2 * stride + delta];
-                    dep[Qx][p] += dq * buffer[3 * stride + delta];
-                    dep[Qy][p] += dq * buffer[4 * stride + delta];
-                    dep[Qz][p] += dq * buffer[5 * stride + delta];
-                    ++delta;
-                }
-            }
-            // K term intermediates
-            // deij[x][A,i,j] <- (A|B)^x Bij[B,i,j]
-            double *ptr = const_cast<double*>(buffer);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+0*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Px][oP*na*na], na*na);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+1*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Py][oP*na*na], na*na);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+2*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Pz][oP*na*na], na*na);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+3*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Qx][oP*na*na], na*na);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+4*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Qy][oP*na*na], na*na);
-            C_DGEMM('n', 'n', nP, na*na, nQ, 1.0, ptr+5*stride, nQ, Bijp[oQ], na*na, 1.0, &deijp[Qz][oP*na*na], na*na);
 
+        // B[p][m,n] = C[m][i] B[p][i,j] C[n][j]
+        for (int p = 0; p < nP; p++) {
+            C_DGEMM('N', 'T', na, nso, na, 1.0, Bijp[p+oP], na, Cap[0], na, 0.0, Bimp[0], nso);
+            C_DGEMM('N', 'N', nso, nso, na, 1.0, Cap[0], na, Bimp[0], nso, 0.0, Bmnp[p], nso);
         }
-    }
-
 
-    for (int P = 0; P < nauxshell; ++P){
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-        int Pcenter = auxiliary_->shell(P).ncenter();
-        int Pncart = auxiliary_->shell(P).ncartesian();
-        int Px = 3 * Pcenter + 0;
-        int Py = 3 * Pcenter + 1;
-        int Pz = 3 * Pcenter + 2;
         for(int M = 0; M < nshell; ++M){
             int nM = primary_->shell(M).nfunction();
             int oM = primary_->shell(M).function_index();
@@ -2058,7 +1989,7 @@ void DFJKGrad::compute_hessian()
                 for (int p = oP; p < oP+nP; p++) {
                     for (int m = oM; m < oM+nM; m++) {
                         for (int n = oN; n < oN+nN; n++) {
-                            double Cpmn = 2.0 * Bmnp[p][m*nso+n];
+                            double Cpmn = 2.0 * Bmnp[p-oP][m*nso+n];
                             PxPx += Cpmn * buffer[9  * stride + delta];
                             PxPy += Cpmn * buffer[10 * stride + delta];
                             PxPz += Cpmn * buffer[11 * stride + delta];
@@ -2304,25 +2235,193 @@ void DFJKGrad::compute_hessian()
     }
 
 
-    // Stitch all the intermediates together to form the actual Hessian contributions
-    SharedMatrix tmp(new Matrix("Tmp [P][i,j]", np, na*na));
-    double **ptmp = tmp->pointer();
+    Bmn.reset();
+    Bim.reset();
 
-    for(int x = 0; x < 3*natoms; ++x){
-        for(int y = 0; y < 3*natoms; ++y){
-            // J terms
-            JHessp[x][y] += 2.0*C_DDOT(np, ddp[x], 1, dcp[y], 1);
-            JHessp[x][y] -= 4.0*C_DDOT(np, ddp[x], 1, dep[y], 1);
-            C_DGEMV('n', np, np, 1.0, PQp[0], np, dep[y], 1, 0.0, ptmp[0], 1);
-            JHessp[x][y] += 2.0*C_DDOT(np, dep[x], 1, ptmp[0], 1);
+    // => First derivative terms <= //
+    //
+    // With dd = dc Minv, the remaining J terms are 2 dd.dc - 4 dd.de + 2 de Minv de, and the K terms
+    // have the same shape in dAij and deij.  Once the Hessian is symmetrized they collapse to
+    //
+    //    2 (dc - de)[x] Minv (dc - de)[y]   and   2 (dAij - deij)[x] Minv (dAij - deij)[y]
+    //
+    // so only g[x][A,i,j] = dAij - deij is built, for a block of atoms at a time.  With more than one
+    // block, g goes to disk and the K Hessian is assembled block pair by block pair.
 
-            // K terms
-            C_DGEMM('n', 'n', np, na*na, np,  1.0, PQp[0], np, dAijp[y], na*na, 0.0, ptmp[0], na*na);
-            KHessp[x][y] += 2.0*C_DDOT(np*na*na, dAijp[x], 1, ptmp[0], 1);
-            C_DGEMM('n', 'n', np, na*na, np,  1.0, PQp[0], np, deijp[y], na*na, 0.0, ptmp[0], na*na);
-            KHessp[x][y] -= 4.0*C_DDOT(np*na*na, dAijp[x], 1, ptmp[0], 1);
-            KHessp[x][y] += 2.0*C_DDOT(np*na*na, deijp[x], 1, ptmp[0], 1);
+    size_t nrow = nij * np;
+    size_t fixed = 2L * np * (size_t) np + nrow + 2L * 3 * natoms * (size_t) np;
+    size_t max_atoms = (memory_ > fixed ? (memory_ - fixed) / (9L * nrow) : 0L);
+    max_atoms = (max_atoms < 1L ? 1L : max_atoms);
+    max_atoms = (max_atoms > natoms ? natoms : max_atoms);
+
+    std::vector<int> Astarts;
+    for (int A = 0; A < natoms; A += max_atoms) {
+        Astarts.push_back(A);
+    }
+    Astarts.push_back(natoms);
+    int nblock = Astarts.size() - 1;
+    bool disk = (nblock > 1);
+
+    if (disk) {
+        if (print_) {
+            outfile->Printf("    DF Hessian: %d blocks of up to %zu atoms, (A|ij)^x staged on disk\n\n",
+                            nblock, max_atoms);
+        }
+        psio_->open(unit_a_, PSIO_OPEN_NEW);
+    }
+
+    SharedMatrix g(new Matrix("g[x][A,i,j]", 3 * max_atoms, nrow));
+    double **gp = g->pointer();
+    SharedMatrix T(new Matrix("T", maxp, maxm*na));
+    double **Tp = T->pointer();
+
+    for (int block = 0; block < nblock; block++) {
+        int Astart = Astarts[block];
+        int Astop = Astarts[block + 1];
+        g->zero();
+
+        // Rows of g held by this block, -1 if the perturbation is elsewhere
+        auto row = [&](int center, int xyz) { return (center >= Astart && center < Astop ? 3 * (center - Astart) + xyz : -1); };
+
+        for (int P = 0; P < nauxshell; ++P){
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index();
+            int Pcenter = auxiliary_->shell(P).ncenter();
+            int Pncart = auxiliary_->shell(P).ncartesian();
+            for(int M = 0; M < nshell; ++M){
+                int nM = primary_->shell(M).nfunction();
+                int oM = primary_->shell(M).function_index();
+                int Mcenter = primary_->shell(M).ncenter();
+                int Mncart = primary_->shell(M).ncartesian();
+                for(int N = 0; N < nshell; ++N){
+                    int nN = primary_->shell(N).nfunction();
+                    int oN = primary_->shell(N).function_index();
+                    int Ncenter = primary_->shell(N).ncenter();
+                    int Nncart = primary_->shell(N).ncartesian();
+
+                    if (row(Pcenter, 0) < 0 && row(Mcenter, 0) < 0 && row(Ncenter, 0) < 0) continue;
+
+                    size_t stride = Pncart * Mncart * Nncart;
+
+                    Pmnint->compute_shell_deriv1(P,0,M,N);
+                    const double* buffer = Pmnint->buffer();
+                    double *ptr = const_cast<double*>(buffer);
+
+                    int centers[3] = {Pcenter, Mcenter, Ncenter};
+                    for (int k = 0; k < 9; k++) {
+                        int r = row(centers[k / 3], k % 3);
+                        if (r < 0) continue;
+                        int x = 3 * centers[k / 3] + k % 3;
+
+                        // dc[x][A] = D[m][n] (A|mn)^x
+                        size_t delta = 0L;
+                        for (int p = oP; p < oP+nP; p++) {
+                            for (int m = oM; m < oM+nM; m++) {
+                                for (int n = oN; n < oN+nN; n++) {
+                                    dcp[x][p] += Dtp[m][n] * ptr[k * stride + delta];
+                                    ++delta;
+                                }
+                            }
+                        }
+
+                        // g[x][p,i,j] <- (p|mn)^x C[m][i] C[n][j], as
+                        // T[p][m,j] <- (p|mn)^x C[n][j] and g[x][p,i,j] <- C[m][i] T[p][m,j]
+                        C_DGEMM('n', 'n', nP*nM, na, nN, 1.0, ptr+k*stride, nN, Cap[oN], na, 0.0, Tp[0], na);
+                        #pragma omp parallel for
+                        for(int p = 0; p < nP; ++p)
+                            C_DGEMM('t', 'n', na, na, nM, 1.0, Cap[oM], na, Tp[0]+p*(nM*na), na, 1.0, &gp[r][(p+oP)*nij], na);
+                    }
+                }
+            }
         }
+
+        for (int P = 0; P < nauxshell; ++P){
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index();
+            int Pcenter = auxiliary_->shell(P).ncenter();
+            int Pncart = auxiliary_->shell(P).ncartesian();
+            for(int Q = 0; Q < nauxshell; ++Q){
+                int nQ = auxiliary_->shell(Q).nfunction();
+                int oQ = auxiliary_->shell(Q).function_index();
+                int Qcenter = auxiliary_->shell(Q).ncenter();
+                int Qncart = auxiliary_->shell(Q).ncartesian();
+
+                if (row(Pcenter, 0) < 0 && row(Qcenter, 0) < 0) continue;
+
+                size_t stride = Pncart * Qncart;
+
+                PQint->compute_shell_deriv1(P,0,Q,0);
+                const double* buffer = PQint->buffer();
+                double *ptr = const_cast<double*>(buffer);
+
+                int centers[2] = {Pcenter, Qcenter};
+                for (int k = 0; k < 6; k++) {
+                    int r = row(centers[k / 3], k % 3);
+                    if (r < 0) continue;
+                    int x = 3 * centers[k / 3] + k % 3;
+
+                    // de[x][A] = (A|B)^x d[B]
+                    C_DGEMV('n', nP, nQ, 1.0, ptr+k*stride, nQ, &dp[oQ], 1, 1.0, &dep[x][oP], 1);
+                    // g[x][A,i,j] -= (A|B)^x Bij[B,i,j]
+                    C_DGEMM('n', 'n', nP, nij, nQ, -1.0, ptr+k*stride, nQ, Bijp[oQ], nij, 1.0, &gp[r][oP*nij], nij);
+                }
+            }
+        }
+
+        if (disk) {
+            psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * 3L * Astart * nrow);
+            psio_->write(unit_a_, "g[x][A,i,j]", (char*) gp[0], sizeof(double) * 3L * (Astop - Astart) * nrow, addr, &addr);
+        }
+    }
+    T.reset();
+
+    // J terms: 2 (dc - de)[x] Minv (dc - de)[y]
+    dc->subtract(de);
+    SharedMatrix dd(new Matrix("dd[x][B] = (dc - de)[x][A] Minv[A][B]", 3*natoms, np));
+    double **ddp = dd->pointer();
+    C_DGEMM('N', 'N', 3*natoms, np, np, 1.0, dcp[0], np, PQp[0], np, 0.0, ddp[0], np);
+    C_DGEMM('N', 'T', 3*natoms, 3*natoms, np, 2.0, dcp[0], np, ddp[0], np, 1.0, JHessp[0], 3*natoms);
+
+    // K terms: 2 g[x] Minv g[y], over pairs of atom blocks
+    SharedMatrix t(new Matrix("Minv g[y]", 3 * max_atoms, nrow));
+    double **tp = t->pointer();
+    SharedMatrix gx;
+    double **gxp = gp;
+    if (disk) {
+        gx = SharedMatrix(new Matrix("g[x][A,i,j]", 3 * max_atoms, nrow));
+        gxp = gx->pointer();
+    }
+
+    for (int Yblock = 0; Yblock < nblock; Yblock++) {
+        int Y0 = 3 * Astarts[Yblock];
+        int nY = 3 * (Astarts[Yblock + 1] - Astarts[Yblock]);
+        if (disk) {
+            psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * Y0 * nrow);
+            psio_->read(unit_a_, "g[x][A,i,j]", (char*) gp[0], sizeof(double) * nY * nrow, addr, &addr);
+        }
+        #pragma omp parallel for
+        for (int y = 0; y < nY; y++) {
+            C_DGEMM('n', 'n', np, nij, np, 1.0, PQp[0], np, gp[y], nij, 0.0, tp[y], nij);
+        }
+
+        for (int Xblock = 0; Xblock <= Yblock; Xblock++) {
+            int X0 = 3 * Astarts[Xblock];
+            int nX = 3 * (Astarts[Xblock + 1] - Astarts[Xblock]);
+            double **gXp = gp;
+            if (Xblock != Yblock) {
+                psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * X0 * nrow);
+                psio_->read(unit_a_, "g[x][A,i,j]", (char*) gxp[0], sizeof(double) * nX * nrow, addr, &addr);
+                gXp = gxp;
+            }
+            C_DGEMM('N', 'T', nX, nY, nrow, 2.0, gXp[0], nrow, tp[0], nrow, 1.0, &KHessp[X0][Y0], 3*natoms);
+            if (Xblock != Yblock) {
+                C_DGEMM('N', 'T', nY, nX, nrow, 2.0, tp[0], nrow, gXp[0], nrow, 1.0, &KHessp[Y0][X0], 3*natoms);
+            }
+        }
+    }
+
+    if (disk) {
+        psio_->close(unit_a_, 0);
     }
 
     // Make sure the newly added components are symmetric
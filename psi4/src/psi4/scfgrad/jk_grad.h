@@ -176,6 +176,8 @@ protected:
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_;
+    /// Bound below which (A|mn)^x triplets are skipped, defaults to 1.0E-12
+    double screening_cutoff_;
 
     void common_init();
 
@@ -211,6 +213,14 @@ public:
      *        defaults to 1.0E-12
      */
     void set_condition(double condition) { condition_ = condition; }
+    /**
+     * Skip the (A|mn)^x derivative integrals of a shell triplet when the
+     * Schwarz bound times the largest density/fitting coefficient it
+     * multiplies falls below this value
+     * @param cutoff, 0.0 computes every significant triplet,
+     *        defaults to 1.0E-12
+     */
+    void set_screening_cutoff(double cutoff) { screening_cutoff_ = cutoff; }
     /**
      * Which file number should the Alpha (Q|mn) integrals go in
      * @param unit Unit number
@@ -60,6 +60,83 @@ using namespace psi;
 namespace psi {
 namespace scfgrad {
 
+namespace {
+
+/**
+ * Adds weights[c] * D[p][q] (p|O_c|q)^x over all shell pairs to grad (natom x 3). The derivative
+ * buffer of each ints[t] must hold, per operator component c, the Px, Py, Pz, Qx, Qy, Qz blocks, as
+ * the overlap, kinetic and dipole integrals do. The unique shell pairs are shared out over
+ * ints.size() threads, each summing into its own natom x 3 copy.
+ */
+void oei_deriv1_gradient(std::vector<std::shared_ptr<OneBodyAOInt> >& ints, std::shared_ptr<BasisSet> basis,
+                         SharedMatrix D, const std::vector<double>& weights, SharedMatrix grad)
+{
+    int threads = ints.size();
+    double** Dp = D->pointer();
+
+    std::vector<SharedMatrix> temps;
+    for (int t = 0; t < threads; t++) {
+        temps.push_back(SharedMatrix(grad->clone()));
+        temps[t]->zero();
+    }
+
+    // Lower Triangle
+    std::vector<std::pair<int,int> > PQ_pairs;
+    for (int P = 0; P < basis->nshell(); P++) {
+        for (int Q = 0; Q <= P; Q++) {
+            PQ_pairs.push_back(std::pair<int,int>(P,Q));
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+
+        int P = PQ_pairs[PQ].first;
+        int Q = PQ_pairs[PQ].second;
+
+        int thread = 0;
+        #ifdef _OPENMP
+            thread = omp_get_thread_num();
+        #endif
+
+        ints[thread]->compute_shell_deriv1(P,Q);
+        const double* buffer = ints[thread]->buffer();
+
+        int nP = basis->shell(P).nfunction();
+        int oP = basis->shell(P).function_index();
+        int aP = basis->shell(P).ncenter();
+
+        int nQ = basis->shell(Q).nfunction();
+        int oQ = basis->shell(Q).function_index();
+        int aQ = basis->shell(Q).ncenter();
+
+        double perm = (P == Q ? 1.0 : 2.0);
+        int centers[2] = {aP, aQ};
+
+        double** Gp = temps[thread]->pointer();
+
+        for (size_t c = 0; c < weights.size(); c++) {
+            if (weights[c] == 0.0) continue;
+            for (int k = 0; k < 6; k++) {
+                const double* ref = &buffer[(6 * c + k) * nP * nQ];
+                double val = 0.0;
+                for (int p = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++) {
+                        val += Dp[p + oP][q + oQ] * (*ref++);
+                    }
+                }
+                Gp[centers[k / 3]][k % 3] += perm * weights[c] * val;
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        grad->add(temps[t]);
+    }
+}
+
+}  // namespace
+
 SCFGrad::SCFGrad(SharedWavefunction ref_wfn, Options& options) :
     Wavefunction(options)
 {
@@ -119,6 +196,8 @@ SharedMatrix SCFGrad::compute_gradient()
     gradient_terms.push_back("Nuclear");
     gradient_terms.push_back("Kinetic");
     gradient_terms.push_back("Potential");
+    if (basisset_->has_ECP())
+        gradient_terms.push_back("ECP");
     gradient_terms.push_back("Overlap");
     gradient_terms.push_back("Coulomb");
     if(options_.get_bool("PERTURB_H"))
@@ -187,77 +266,20 @@ SharedMatrix SCFGrad::compute_gradient()
     // => Kinetic Gradient <= //
     timer_on("Grad: T");
     {
-        double** Dp = Dt->pointer();
-
         gradients_["Kinetic"] = SharedMatrix(gradients_["Nuclear"]->clone());
         gradients_["Kinetic"]->set_name("Kinetic Gradient");
         gradients_["Kinetic"]->zero();
-        double** Tp = gradients_["Kinetic"]->pointer();
 
         // Kinetic derivatives
-        std::shared_ptr<OneBodyAOInt> Tint(integral_->ao_kinetic(1));
-        const double* buffer = Tint->buffer();
-
-        for (int P = 0; P < basisset_->nshell(); P++) {
-            for (int Q = 0; Q <= P; Q++) {
-
-                Tint->compute_shell_deriv1(P,Q);
-
-                int nP = basisset_->shell(P).nfunction();
-                int oP = basisset_->shell(P).function_index();
-                int aP = basisset_->shell(P).ncenter();
-
-                int nQ = basisset_->shell(Q).nfunction();
-                int oQ = basisset_->shell(Q).function_index();
-                int aQ = basisset_->shell(Q).ncenter();
-
-                int offset = nP * nQ;
-                const double* ref = buffer;
-                double perm = (P == Q ? 1.0 : 2.0);
-
-                // Px
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aP][0] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Py
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aP][1] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Pz
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aP][2] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qx
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aQ][0] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qy
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aQ][1] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qz
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Tp[aQ][2] += perm * Dp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-            }
+        int threads = 1;
+        #ifdef _OPENMP
+            threads = Process::environment.get_n_threads();
+        #endif
+        std::vector<std::shared_ptr<OneBodyAOInt> > Tint;
+        for (int t = 0; t < threads; t++) {
+            Tint.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic(1)));
         }
+        oei_deriv1_gradient(Tint, basisset_, Dt, {1.0}, gradients_["Kinetic"]);
     }
     timer_off("Grad: T");
 
@@ -339,6 +361,80 @@ SharedMatrix SCFGrad::compute_gradient()
     }
     timer_off("Grad: V");
 
+    // => ECP Gradient <= //
+    if (basisset_->has_ECP()) {
+        timer_on("Grad: ECP");
+        double** Dp = Dt->pointer();
+
+        gradients_["ECP"] = SharedMatrix(gradients_["Nuclear"]->clone());
+        gradients_["ECP"]->set_name("ECP Gradient");
+        gradients_["ECP"]->zero();
+
+        int threads = 1;
+        #ifdef _OPENMP
+            threads = Process::environment.get_n_threads();
+        #endif
+
+        std::vector<std::shared_ptr<OneBodyAOInt> > Uint;
+        std::vector<SharedMatrix> Utemps;
+        for (int t = 0; t < threads; t++) {
+            Uint.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_ecp(1)));
+            Utemps.push_back(SharedMatrix(gradients_["ECP"]->clone()));
+        }
+
+        std::vector<std::pair<int,int> > PQ_pairs;
+        for (int P = 0; P < basisset_->nshell(); P++) {
+            for (int Q = 0; Q <= P; Q++) {
+                PQ_pairs.push_back(std::pair<int,int>(P,Q));
+            }
+        }
+
+        // Same buffer layout as the potential derivatives: x, y, z of every atom
+        #pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+
+            int P = PQ_pairs[PQ].first;
+            int Q = PQ_pairs[PQ].second;
+
+            int thread = 0;
+            #ifdef _OPENMP
+                thread = omp_get_thread_num();
+            #endif
+
+            Uint[thread]->compute_shell_deriv1(P,Q);
+            const double* buffer = Uint[thread]->buffer();
+
+            int nP = basisset_->shell(P).nfunction();
+            int oP = basisset_->shell(P).function_index();
+
+            int nQ = basisset_->shell(Q).nfunction();
+            int oQ = basisset_->shell(Q).function_index();
+
+            double perm = (P == Q ? 1.0 : 2.0);
+
+            double** Up = Utemps[thread]->pointer();
+
+            for (int A = 0; A < natom; A++) {
+                const double* ref0 = &buffer[3 * A * nP * nQ + 0 * nP * nQ];
+                const double* ref1 = &buffer[3 * A * nP * nQ + 1 * nP * nQ];
+                const double* ref2 = &buffer[3 * A * nP * nQ + 2 * nP * nQ];
+                for (int p = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++) {
+                        double Uval = perm * Dp[p + oP][q + oQ];
+                        Up[A][0] += Uval * (*ref0++);
+                        Up[A][1] += Uval * (*ref1++);
+                        Up[A][2] += Uval * (*ref2++);
+                    }
+                }
+            }
+        }
+
+        for (int t = 0; t < threads; t++) {
+            gradients_["ECP"]->add(Utemps[t]);
+        }
+        timer_off("Grad: ECP");
+    }
+
     // If an external field exists, add it to the one-electron Hamiltonian
     if (external_pot_) {
         gradient_terms.push_back("External Potential");
@@ -375,8 +471,6 @@ SharedMatrix SCFGrad::compute_gradient()
             throw PSIEXCEPTION(msg);
         }
 
-        double** Dp = Dt->pointer();
-
         gradients_["Perturbation"] = SharedMatrix(gradients_["Nuclear"]->clone());
         gradients_["Perturbation"]->set_name("Perturbation Gradient");
         gradients_["Perturbation"]->zero();
@@ -391,178 +485,15 @@ SharedMatrix SCFGrad::compute_gradient()
         }
 
         // Electronic dipole perturbation derivatives
-        std::shared_ptr<OneBodyAOInt> Dint(integral_->ao_dipole(1));
-        const double* buffer = Dint->buffer();
-
-        for (int P = 0; P < basisset_->nshell(); P++) {
-            for (int Q = 0; Q <= P; Q++) {
-
-                Dint->compute_shell_deriv1(P,Q);
-
-                int nP = basisset_->shell(P).nfunction();
-                int oP = basisset_->shell(P).function_index();
-                int aP = basisset_->shell(P).ncenter();
-
-                int nQ = basisset_->shell(Q).nfunction();
-                int oQ = basisset_->shell(Q).function_index();
-                int aQ = basisset_->shell(Q).ncenter();
-
-                const double* ref = buffer;
-                double perm = (P == Q ? 1.0 : 2.0);
-                double prefac;
-
-                /*
-                 * Mu X derivatives
-                 */
-                if (xlambda != 0.0) {
-                    prefac = perm*xlambda;
-                    // Px
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Py
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Pz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qx
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qy
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-                } else {
-                    // Xlambda is zero, so we just advance the pointer to the buffer
-                    ref += 6*nP*nQ;
-                }
-
-                /*
-                 * Mu Y derivatives
-                 */
-                if (ylambda != 0.0) {
-                    prefac = perm*ylambda;
-                    // Px
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Py
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Pz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qx
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qy
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-                } else {
-                    // Ylambda is zero, so we just advance the pointer to the buffer
-                    ref += 6*nP*nQ;
-                }
-
-                /*
-                 * Mu Z derivatives
-                 */
-                if (zlambda != 0.0) {
-                    prefac = perm*zlambda;
-                    // Px
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Py
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Pz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aP][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qx
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][0] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qy
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][1] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-
-                    // Qz
-                    for (int p = 0; p < nP; p++) {
-                        for (int q = 0; q < nQ; q++) {
-                            Pp[aQ][2] += prefac * Dp[p + oP][q + oQ] * (*ref++);
-                        }
-                    }
-                }
-
-            }
+        int threads = 1;
+        #ifdef _OPENMP
+            threads = Process::environment.get_n_threads();
+        #endif
+        std::vector<std::shared_ptr<OneBodyAOInt> > Dint;
+        for (int t = 0; t < threads; t++) {
+            Dint.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_dipole(1)));
         }
+        oei_deriv1_gradient(Dint, basisset_, Dt, {xlambda, ylambda, zlambda}, gradients_["Perturbation"]);
         timer_off("Grad: Perturbation");
     }
 
@@ -600,72 +531,17 @@ SharedMatrix SCFGrad::compute_gradient()
         gradients_["Overlap"] = SharedMatrix(gradients_["Nuclear"]->clone());
         gradients_["Overlap"]->set_name("Overlap Gradient");
         gradients_["Overlap"]->zero();
-        double** Sp = gradients_["Overlap"]->pointer();
 
         // Overlap derivatives
-        std::shared_ptr<OneBodyAOInt> Sint(integral_->ao_overlap(1));
-        const double* buffer = Sint->buffer();
-
-        for (int P = 0; P < basisset_->nshell(); P++) {
-            for (int Q = 0; Q <= P; Q++) {
-
-                Sint->compute_shell_deriv1(P,Q);
-
-                int nP = basisset_->shell(P).nfunction();
-                int oP = basisset_->shell(P).function_index();
-                int aP = basisset_->shell(P).ncenter();
-
-                int nQ = basisset_->shell(Q).nfunction();
-                int oQ = basisset_->shell(Q).function_index();
-                int aQ = basisset_->shell(Q).ncenter();
-
-                int offset = nP * nQ;
-                const double* ref = buffer;
-                double perm = (P == Q ? 1.0 : 2.0);
-
-                // Px
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aP][0] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Py
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aP][1] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Pz
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aP][2] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qx
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aQ][0] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qy
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aQ][1] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-
-                // Qz
-                for (int p = 0; p < nP; p++) {
-                    for (int q = 0; q < nQ; q++) {
-                        Sp[aQ][2] -= perm * Wp[p + oP][q + oQ] * (*ref++);
-                    }
-                }
-            }
+        int threads = 1;
+        #ifdef _OPENMP
+            threads = Process::environment.get_n_threads();
+        #endif
+        std::vector<std::shared_ptr<OneBodyAOInt> > Sint;
+        for (int t = 0; t < threads; t++) {
+            Sint.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap(1)));
         }
+        oei_deriv1_gradient(Sint, basisset_, W, {-1.0}, gradients_["Overlap"]);
     }
     timer_off("Grad: S");
 
@@ -1512,12 +1388,19 @@ SharedMatrix SCFGrad::compute_hessian()
     // => XC Hessian <= //
     timer_on("Hess: XC");
     if (functional) {
+        // potential->compute_hessian() has the explicit XC term at fixed density, but the
+        // response below carries no XC kernel, so KS Hessians are refused here and the XC
+        // term is only reachable through VBase.compute_hessian from Python
         potential->print_header();
         throw PSIEXCEPTION("KS Hessians not implemented");
-        //hessians["XC"] = potential->compute_hessian();
     }
     timer_off("Hess: XC");
 
+    // => -D Hessian <= //
+    if (arrays_.count("-D Hessian")) {
+        hessians["-D"] = arrays_["-D Hessian"];
+    }
+
     // => Response Terms (Brace Yourself) <= //
     if (options_.get_str("REFERENCE") == "RHF") {
         hessians["Response"] = rhf_hessian_response();
@@ -115,6 +115,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   irreducible representation) -*/
   options.add_str("FREEZE_CORE", "FALSE", "FALSE TRUE");
 
+  /*- Do truncate the virtual space of CCENERGY, DFOCC, and DETCI energy
+  computations to DF-MP2 frozen natural orbitals? The natural orbitals are
+  selected by |dfmp2__occ_tolerance|, |dfmp2__occ_percentage|, or
+  |dfmp2__active_nat_orbs|, and the DF-MP2 energy lost by the truncation is
+  added back to the final energy. RHF references only. -*/
+  options.add_bool("FNO_TRUNCATE", false);
+
   /*- Do use pure angular momentum basis functions?
   If not explicitly set, the default comes from the basis set.
   **Cfour Interface:** Keyword translates into |cfour__cfour_spherical|. -*/
@@ -138,11 +145,22 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- Either :ref:`a set of 3 coordinates or a string <table:oe_origin>`
   describing the origin about which one-electron properties are computed. -*/
   options.add("PROPERTIES_ORIGIN", new ArrayType());
+  /*- Primitive pairs whose overlap prefactor is below this are skipped in
+      the potential integrals behind GRID_ESP and ESP_AT_NUCLEI. Zero keeps
+      them all. -*/
+  options.add_double("OEPROP_ESP_SCREENING", 0.0);
 
   /*- Psi4 dies if energy does not converge. !expert -*/
   options.add_bool("DIE_IF_NOT_CONVERGED", true);
   /*- Integral package to use. If compiled with ERD or Simint support, change this option to use them; LibInt is used otherwise. -*/
   options.add_str("INTEGRAL_PACKAGE", "LIBINT", "ERD LIBINT SIMINT");
+  /*- Layout of the conventional SO two-electron integral file written for
+  correlated methods. IWL is the labeled buffer file every module can read.
+  BLOCKED stores dense symmetry blocks already in the order libtrans sorts to,
+  so its presort reduces to large sequential reads; only modules that get
+  their integrals through libtrans (CCENERGY via CCTRANSORT, DETCI, OCC, FNOCC,
+  ADC) can use it, and DCFT and AO-basis CC always get IWL. -*/
+  options.add_str("SO_TEI_FORMAT", "IWL", "IWL BLOCKED");
 
   // Note that case-insensitive options are only functional as
   //   globals, not as module-level, and should be defined sparingly
@@ -158,8 +176,98 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add_str("PCM_SCF_TYPE", "TOTAL", "TOTAL SEPARATE");
   /*- PCM-CCSD algorithm type. -*/
   options.add_str("PCM_CC_TYPE", "PTE", "PTE");
+  /*- Do keep the potential integrals of every tessera in memory instead of
+      computing them twice per SCF iteration? They are only kept if they
+      take no more than half of the memory. -*/
+  options.add_bool("PCM_STORE_INTEGRALS", true);
+  /*- Primitive pairs whose overlap prefactor is below this are skipped in
+      the tessera potential integrals. Zero keeps them all. -*/
+  options.add_double("PCM_SCREENING", 0.0);
   /*- The density fitting basis to use in coupled cluster computations. -*/
   options.add_str("DF_BASIS_CC", "");
+  /*- Engine that builds the fitted three-index integrals in correlated DF
+  modules. ``DF_HELPER`` uses the shared DF_Helper pipeline, whose fitted AO
+  integrals are kept for later modules with the same orbital and auxiliary
+  basis until ``psi4.core.clean()``; ``MODULE`` uses each module's own code.
+  Currently read by the DF-MP2 energy (DISK algorithm). -*/
+  options.add_str("DF_INTS_ENGINE", "DF_HELPER", "DF_HELPER MODULE");
+  /*- Keep fitted (Q|mn) tensors from in-core DF-SCF and the fitting metric
+  powers and Cholesky factors used by DF-SCF, DF-MP2, DF-OCC and SAPT in memory for the rest of the
+  process, keyed by orbital basis, auxiliary basis, geometry and Schwarz
+  cutoff, so that later JK builds and DF modules on the same pair reuse them.
+  The cached tensors count against no module's memory budget and are only
+  released by ``psi4.core.clean()``. -*/
+  options.add_bool("DF_INTS_CACHE", false);
+  /*- Publish the in-core DF-SCF and CD-SCF (Q|mn) tensors as POSIX
+  shared-memory segments keyed like |globals__df_ints_cache|, so other Psi4
+  processes of the same user on the node (same molecule, basis and cutoff)
+  map the existing copy read-only instead of building and holding their own.
+  Segments are removed by ``psi4.core.clean()`` or at exit of the process
+  that made them; after a crash, leftovers are ``/dev/shm/psi4.<uid>.*``. -*/
+  options.add_bool("DF_INTS_SHM", false);
+  /*- Keep PSIO scratch files in process memory between the modules of a
+  job instead of writing them out. A file closed and kept stays in memory
+  and the next module that opens it reads it from there; the file in the
+  scratch directory stays empty. ``CORRELATED`` covers the SO and MO
+  integral files, the libtrans DPD files and the CC, FNOCC and OCC
+  intermediates, i.e., what the conventional correlated modules hand each
+  other. ``ALL`` covers every file. Files marked for retention are always
+  written to disk. Memory used this way counts against no module's
+  |globals__memory| and is released by ``psi4.core.clean()``. -*/
+  options.add_str("SCRATCH_IN_MEMORY", "NONE", "NONE CORRELATED ALL");
+  /*- Upper bound [MiB] on the memory held by all in-core and
+  |globals__scratch_in_memory| files together. Past it, the least recently
+  used 64 KiB pages are written to the files they belong to and read back
+  when next touched, so a file larger than the bound still works, only with
+  disk traffic. 0 means no bound. -*/
+  options.add_int("SCRATCH_MEMORY_LIMIT", 0);
+  /*- Count PSIO reads, writes, bytes, wall time and seeks per file and TOC
+  entry. The table is printed, and the counters reset, each time scratch files
+  are cleaned up (``psi4.core.clean()``). Takes effect when files are next
+  opened. -*/
+  options.add_bool("PSIO_TRACE", false);
+  /*- File to which each |globals__psio_trace| table is also appended, as one
+  line of JSON. Nothing is written if empty. -*/
+  options.add_str_i("PSIO_TRACE_FILE", "");
+  /*- Accumulate calls and wall time of the code regions marked for
+  profiling, per thread and call path. The merged tree is printed, and the
+  counters reset, each time scratch files are cleaned up
+  (``psi4.core.clean()``). Takes effect when the next module starts. -*/
+  options.add_bool("PROFILE", false);
+  /*- Also count CPU cycles and instructions in each profiled region, through
+  Linux perf events. Regions show zero counts where perf events are not
+  available. Implies |globals__profile|. -*/
+  options.add_bool("PROFILE_COUNTERS", false);
+  /*- File to which every profiled region instance is written as a Chrome
+  trace (JSON), for timeline and flame-graph viewers. Rewritten at each
+  report of |globals__profile|; nothing is written if empty. Implies
+  |globals__profile|. -*/
+  options.add_str_i("PROFILE_TRACE_FILE", "");
+  /*- Stop with an error, rather than allocate, when a Matrix, block matrix
+  (including DFOCC tensors) or DPD buffer would take the memory those hold
+  together past |globals__memory|. Memory allocated by other means is not
+  counted, so this catches most but not all oversubscription. Takes effect
+  when the next module starts. -*/
+  options.add_bool("MEMORY_ENFORCE", false);
+  /*- Print the most memory held at once in Matrix, block-matrix and DPD
+  allocations by each module that ran, each time scratch files are cleaned up
+  (``psi4.core.clean()``). -*/
+  options.add_bool("MEMORY_REPORT", false);
+  /*- Gather output in memory and have a background thread write it to the
+  output file in chunks, at least once a second, instead of writing and
+  flushing every line as it is printed. Saves time where printing is frequent
+  and the file system slow; the last second of output is lost if the process
+  crashes. Takes effect when the next module starts. -*/
+  options.add_bool("OUTPUT_BUFFERING", false);
+  /*- File to which modules append machine-readable records (one JSON object
+  per line, e.g., one per SCF or CC iteration) next to the text output.
+  Nothing is written if empty. Takes effect when the next module starts. -*/
+  options.add_str_i("STRUCTURED_LOG_FILE", "");
+  /*- Run the out-of-core DF_Helper transformations as a pipeline: one
+  auxiliary block of AO integrals is read by a separate I/O thread while the
+  previous one is transformed, and finished blocks are written while the next
+  is formed. The extra buffers halve the block size that fits in memory. -*/
+  options.add_bool("DF_HELPER_ASYNC_IO", false);
   /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here. The code does NOT help you out in any way! !expert -*/
   options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
   /*- Text to be passed directly into CFOUR input files. May contain
@@ -204,6 +312,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- Auxiliary basis set for solving Dirac equation in X2C and DKH
       calculations. Defaults to decontracted orbital basis. -*/
   options.add_str("BASIS_RELATIVISTIC", "");
+  /*- How X2C decouples the large and small components. FULL solves the
+      Dirac equation of the whole molecule; DLU (diagonal local unitary)
+      solves it for each atom alone, once per element and basis, and
+      assembles block-diagonal decoupling matrices, which is far cheaper
+      for large molecules at a small loss of accuracy. -*/
+  options.add_str("X2C_DECOUPLING", "FULL", "FULL DLU");
   /*- Order of Douglas-Kroll-Hess !expert -*/
   options.add_int("DKH_ORDER", 2);
 
@@ -226,16 +340,34 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- List of basis function indices for which cube files are generated
   (1-based). All basis functions computed if empty.-*/
   options.add("CUBEPROP_BASIS_FUNCTIONS", new ArrayType());
+  /*- File format for cubeprop output. ``CUBE`` writes Gaussian cube text files,
+  ``NPY`` writes binary NumPy arrays of shape (nx, ny, nz) in cube ordering, which
+  keep full double precision and skip the text formatting. -*/
+  options.add_str("CUBEPROP_FORMAT", "CUBE", "CUBE NPY");
   /*- CubicScalarGrid basis cutoff. !expert -*/
   options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
   /*- CubicScalarGrid maximum number of grid points per evaluation block. !expert -*/
   options.add_int("CUBIC_BLOCK_MAX_POINTS",1000);
+  /*- Accuracy target for the ESP of the fitted density from per-atom charges,
+  dipoles and quadrupoles. Points far enough from an atom (by the most diffuse
+  auxiliary function there) take its contribution from these multipoles instead
+  of from integrals. 0.0 computes every contribution exactly. !expert -*/
+  options.add_double("CUBIC_ESP_MULTIPOLE_TOLERANCE", 0.0);
   /*- CubicScalarGrid spatial extent in bohr [O_X, O_Y, O_Z]. Defaults to 4.0 bohr each. -*/
   options.add("CUBIC_GRID_OVERAGE", new ArrayType());
   /*- CubicScalarGrid grid spacing in bohr [D_X, D_Y, D_Z]. Defaults to 0.2 bohr each. -*/
   options.add("CUBIC_GRID_SPACING", new ArrayType());
   /* How many NOONS to print -- used in libscf_solver/uhf.cc and libmints/oeprop.cc */
   options.add_str("PRINT_NOONS","3");
+  /*- Smallest dimension of a symmetric block that Matrix diagonalize and power
+  and the fitting-metric inverse hand to the block-cyclic ScaLAPACK/ELPA
+  backend. Only used when Psi4 is built with ``-DENABLE_SCALAPACK=ON`` and
+  runs on more than one MPI rank; 0 disables the backend. !expert -*/
+  options.add_int("LINALG_DISTRIBUTED_MIN_DIM", 4000);
+  /*- Block size of the block-cyclic layout used by the distributed eigensolvers. !expert -*/
+  options.add_int("LINALG_DISTRIBUTED_BLOCK", 64);
+  /*- Eigensolver for the distributed backend. ELPA requires ``-DENABLE_ELPA=ON``. !expert -*/
+  options.add_str("LINALG_DISTRIBUTED_SOLVER", "SCALAPACK", "SCALAPACK ELPA");
 
 
 
@@ -311,6 +443,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     less core memory. -*/
     options.add_int("ICORE", 1);
 
+    /*- Do build the sigma vector blocks on separate MPI ranks? Every rank
+    runs the same iterations and keeps the whole CI vector; each sigma
+    block is formed on one rank and then sent to the others. Applies to
+    |detci__icore| = 0 and 1, and requires a build with ``ENABLE_MPI``. -*/
+    options.add_bool("SIGMA_DISTRIBUTED", false);
+
     /*- Number of threads for DETCI. !expert -*/
     options.add_int("CI_NUM_THREADS", 1);
 
@@ -816,6 +954,17 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     The integrals are computed before any terms, so all integrals will
     be computed even if they are not needed for the requested term !expert -*/
     options.add_bool("SAPT0_E20DISP",false);
+    /*- For SAPT0 only, take $E@@{disp}^{(20)}$ from the Laplace (or
+    Cholesky) denominator vectors of |sapt__denominator_algorithm| rather
+    than from exact orbital-energy denominators, and skip the occupied pairs
+    whose estimated $E@@{exch-disp}^{(20)}$ contribution is below
+    |sapt__sapt0_disp_pair_tolerance|. Recommended for large, well separated
+    monomers. -*/
+    options.add_bool("SAPT0_LAPLACE_DISP",false);
+    /*- Upper bound on the $E@@{exch-disp}^{(20)}$ contribution of an occupied
+    pair below which the pair is neglected when |sapt__sapt0_laplace_disp| is
+    set. -*/
+    options.add_double("SAPT0_DISP_PAIR_TOLERANCE",1.0E-10);
 
     /*- Convergence criterion for energy (change) in the SAPT
     $E@@{ind,resp}^{(20)}$ term during solution of the CPHF equations. -*/
@@ -842,6 +991,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     additional thread. -*/
     options.add_bool("AIO_DF_INTS",false);
 
+    /*- Where SAPT0 keeps the MO-basis DF integrals. ``CORE`` holds the
+    integral files in memory for the whole computation, ``DISK`` writes them
+    to scratch, and ``AUTO`` keeps them in core when they need at most half of
+    the available memory. In-core integrals are built by DF_Helper's in-core
+    transformation when its AO tensor also fits, and through scratch otherwise. -*/
+    options.add_str("SAPT_DF_INTS_STORAGE","AUTO","AUTO CORE DISK");
+
     /*- Maximum number of CPHF iterations -*/
     options.add_int("MAXITER",50);
     /*- Do CCD dispersion correction in SAPT2+, SAPT2+(3) or SAPT2+3? !expert -*/
@@ -1002,6 +1158,8 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
       /*- CubicScalarGrid maximum number of grid points per evaluation block. !expert -*/
       options.add_int("CUBIC_BLOCK_MAX_POINTS",1000);
+      /*- CubicScalarGrid multipole ESP accuracy target, 0.0 for exact. !expert -*/
+      options.add_double("CUBIC_ESP_MULTIPOLE_TOLERANCE", 0.0);
 
       // => Scalar Field Plotting Options <= //
 
@@ -1016,6 +1174,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add_double("LOCAL_CONVERGENCE",1.0E-12);
       /*- Maximum iterations in localization -*/
       options.add_int("LOCAL_MAXITER", 1000);
+      /*- Localization solver. ``JACOBI`` does sweeps of pairwise rotations;
+      ``NEWTON`` takes truncated Newton steps and falls back on a sweep where the
+      Hessian is not yet negative definite. -*/
+      options.add_str("LOCAL_SOLVER", "JACOBI", "JACOBI NEWTON");
       /*- Use ghost atoms in Pipek-Mezey or IBO metric !expert -*/
       options.add_bool("LOCAL_USE_GHOSTS", false);
       /*- Condition number to use in IBO metric inversions !expert -*/
@@ -1199,10 +1361,29 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- What algorithm to use for the SCF computation. See Table :ref:`SCF
     Convergence & Algorithm <table:conv_scf>` for default algorithm for
     different calculation types. -*/
-    options.add_str("SCF_TYPE", "PK", "DIRECT DF PK OUT_OF_CORE CD GTFOCK");
+    options.add_str("SCF_TYPE", "PK", "DIRECT DF PK OUT_OF_CORE CD GTFOCK CFMM COSX AUTO");
+    /*- Number of Fock builds |scf__scf_type| AUTO assumes when it weighs
+    the one-time integral cost of an algorithm against its per-iteration cost. -*/
+    options.add_int("JK_AUTO_ITERATIONS", 15);
+    /*- Do restrict |scf__scf_type| AUTO to the algorithms with exact integrals? -*/
+    options.add_bool("JK_AUTO_EXACT", false);
+    /*- Scratch disk bandwidth [MB/s] for |scf__scf_type| AUTO. 0 measures it
+    once per process, the first time a candidate would not fit in memory. -*/
+    options.add_double("JK_AUTO_DISK_BANDWIDTH", 0.0);
+    /*- Number of basis functions from which |scf__scf_type| DIRECT builds J and K
+    distributed over MPI processes with GTFock, when PSI4 was built with it.
+    0 keeps DIRECT on DirectJK. -*/
+    options.add_int("GTFOCK_AUTO_NBF", 0);
+    /*- Name of a JK engine that a plugin registered through JK::register_backend. If set, every
+    J/K build that follows |scf__scf_type| uses it instead (SCF, CPHF, SAPT, FISAPT, ...);
+    |scf__scf_type| still decides whether an auxiliary basis is loaded. -*/
+    options.add_str("JK_BACKEND", "");
     /*- Maximum numbers of batches to read PK supermatrix. !expert -*/
     options.add_int("PK_MAX_BUCKETS", 500);
-    /*- Select the PK algorithm to use. For debug purposes, selection will be automated later. !expert -*/
+    /*- Select the PK algorithm to use. REORDER has each thread accumulate a
+    contiguous slice of the supermatrix and write it whole; YOSHIMINE sorts
+    labeled integrals through buckets. Chosen from the available memory
+    when unset. !expert -*/
     options.add_str("PK_ALGO", "REORDER", "REORDER YOSHIMINE");
     /*- Deactivate in core algorithm. For debug purposes. !expert -*/
     options.add_bool("PK_NO_INCORE", false);
@@ -1210,13 +1391,54 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("PK_ALL_NONSYM", false);
     /*- Max memory per buf for PK algo REORDER, for debug and tuning -*/
     options.add_int("MAX_MEM_BUF",  0);
+    /*- Absolute error bound for two-electron integrals written to scratch by
+        the disk PK and DF algorithms. When positive, the PK supermatrix and the
+        DF (Q|mn) tensor are stored as 32-bit fixed-point numbers (half the size
+        in double precision), each within this tolerance of its exact value.
+        Zero keeps full double precision. DF integrals are only compressed when
+        |scf__df_ints_io| is NONE. -*/
+    options.add_double("DISK_COMPRESSION_TOLERANCE", 0.0);
     /*- Tolerance for Cholesky decomposition of the ERI tensor -*/
     options.add_double("CHOLESKY_TOLERANCE",1e-4);
     /*- Use DF integrals tech to converge the SCF before switching to a conventional tech
         in a |scf__scf_type| ``DIRECT`` calculation -*/
     options.add_bool("DF_SCF_GUESS", true);
+    /*- Shell-quartet screening in a |scf__scf_type| ``DIRECT`` calculation. ``SCHWARZ``
+        uses the Cauchy-Schwarz bound alone, ``DENSITY`` also weights the bound by
+        the largest density element that the quartet contributes through. -*/
+    options.add_str("SCREENING", "SCHWARZ", "SCHWARZ DENSITY");
+    /*- Do build the Fock matrix incrementally from the change in density
+        between iterations in a |scf__scf_type| ``DIRECT`` calculation? -*/
+    options.add_bool("INCFOCK", false);
+    /*- Frequency (in iterations) with which to rebuild the full Fock matrix
+        when |scf__incfock| is active, to limit accumulated screening error. -*/
+    options.add_int("INCFOCK_FULL_FOCK_EVERY", 20);
+    /*- Order of the multipole expansions of distant shell-pair charge
+        distributions in a |scf__scf_type| ``CFMM`` Coulomb build. -*/
+    options.add_int("CFMM_ORDER", 8);
+    /*- Separation criterion of a |scf__scf_type| ``CFMM`` Coulomb build: two
+        groups of shell pairs interact through multipoles when the sum of
+        their extents is below this fraction of their distance. Smaller is
+        more accurate. -*/
+    options.add_double("CFMM_THETA", 0.4);
+    /*- Largest number of shell pairs in a leaf of the |scf__scf_type|
+        ``CFMM`` tree. !expert -*/
+    options.add_int("CFMM_LEAF_SIZE", 32);
+    /*- Number of radial points per atom of the exchange grid of a
+        |scf__scf_type| ``COSX`` computation. -*/
+    options.add_int("COSX_RADIAL_POINTS", 35);
+    /*- Number of spherical points per radial shell of the exchange grid of
+        a |scf__scf_type| ``COSX`` computation. Must be a Lebedev number. -*/
+    options.add_int("COSX_SPHERICAL_POINTS", 110);
+    /*- Do fit the |scf__scf_type| ``COSX`` quadrature to the analytic
+        overlap matrix? This removes most of the error of small grids. -*/
+    options.add_bool("COSX_OVERLAP_FITTING", true);
     /*- Keep JK object for later use? -*/
     options.add_bool("SAVE_JK", false);
+    /*- File to which the per-iteration JK performance records (quartets computed
+        and screened, integral and contraction time, PSIO bytes, GFLOP/s) are
+        written as JSON when the SCF finishes. No file is written if empty. -*/
+    options.add_str_i("JK_METRICS_FILE", "");
     /*- Memory safety factor for allocating JK -*/
     options.add_double("SCF_MEM_SAFETY_FACTOR",0.75);
     /*- SO orthogonalization: symmetric or canonical? -*/
@@ -1234,6 +1456,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     Useful to produce broken-symmetry unrestricted solutions.
     Notice that this procedure is defined only for calculations in C1 symmetry. -*/
     options.add_bool("GUESS_MIX",false);
+    /*- Do start the SCF of an n-body complex or SAPT dimer from the converged
+    orbitals of its fragments, projected together onto the complex basis?
+    Only applies when no orbitals are read and the fragment electron counts add up. -*/
+    options.add_bool("FRAGMENT_GUESS", true);
     /*- Do write a MOLDEN output file?  If so, the filename will end in
     .molden, and the prefix is determined by |globals__writer_file_label|
     (if set), or else by the name of the output file plus the name of
@@ -1242,6 +1468,17 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- If true, then repeat the specified guess procedure for the orbitals every time -
     even during a geometry optimization. -*/
     options.add_bool("GUESS_PERSIST", false);
+    /*- Path of a portable orbital checkpoint (a NumPy .npz, relative to the
+    working directory). When set, the orbitals, orbital energies, occupations
+    and basis set of every converged SCF are written there in addition to
+    file 180, and |scf__guess| READ takes the orbitals from it when it exists,
+    projecting them onto a new basis or geometry if needed. Unlike file 180
+    it does not depend on the scratch directory of an earlier run. -*/
+    options.add_str_i("CHECKPOINT_FILE", "");
+    /*- Do also store the (Q|mn) tensors held by |globals__df_ints_cache| in
+    |scf__checkpoint_file|? They are handed back to the cache when the
+    checkpoint is read for the same bases and geometry. !expert -*/
+    options.add_bool("CHECKPOINT_DF_INTS", false);
 
     /*- Flag to print the molecular orbitals. -*/
     options.add_bool("PRINT_MOS", false);
@@ -1313,6 +1550,24 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("SOSCF_CONV", 5.0E-3);
     /*- Do we print the SOSCF microiterations?. -*/
     options.add_bool("SOSCF_PRINT", false);
+    /*- Second-order step. NEWTON solves the Newton equations by preconditioned
+    conjugate gradients. AH takes the lowest root of the augmented Hessian, a
+    level-shifted step that stays downhill when the orbital Hessian is not positive
+    definite, and holds it to a trust radius. AH is available for RHF and UHF. -*/
+    options.add_str("SOSCF_TYPE", "NEWTON", "NEWTON AH");
+    /*- Largest norm of an AH orbital rotation, the initial trust radius. The radius
+    is halved whenever an AH step raises the energy and otherwise regrows towards
+    this value. -*/
+    options.add_double("SOSCF_MAX_STEP", 0.5);
+    /*- Form the RHF/RKS density by purification of the Fock matrix instead of
+        diagonalization, once the occupations have settled. ``TRS4`` is
+        trace-resetting fourth-order purification, ``CANONICAL`` is the
+        trace-conserving canonical purification. The occupation per irrep is
+        held at that of the last diagonalization, and the orbitals are formed
+        by one diagonalization after the last iteration. -*/
+    options.add_str("DENSITY_PURIFICATION", "NONE", "NONE TRS4 CANONICAL");
+    /*- When to start |scf__density_purification|, based on the current density RMS -*/
+    options.add_double("DENSITY_PURIFICATION_START_CONVERGENCE", 1.0E-3);
     /*- Whether to perform stability analysis after convergence.  NONE prevents analysis being
         performed. CHECK will print out the analysis of the wavefunction stability at the end of
         the computation.  FOLLOW will perform the analysis and, if a totally symmetric instability
@@ -1357,6 +1612,24 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str("PERTURB_WITH", "DIPOLE", "DIPOLE DIPOLE_X DIPOLE_Y DIPOLE_Z EMBPOT SPHERE DX");
     /*- An ExternalPotential (built by Python or NULL/None) -*/
     options.add_bool("EXTERN", false);
+    /*- Do expand the potential of distant external point charges in
+    multipoles? The charges are sorted into an octree, and for each
+    shell pair only the charges of nearby leaves are integrated exactly.
+    Meant for QM/MM fields of many thousands of charges. -*/
+    options.add_bool("EXTERN_FMM", false);
+    /*- Order of the multipole and local expansions of |EXTERN_FMM| -*/
+    options.add_int("EXTERN_FMM_ORDER", 8);
+    /*- Separation criterion of |EXTERN_FMM|: a group of charges is expanded
+    when the radii of the group and of the shell pair sum to less than
+    this fraction of their distance. Smaller is more accurate. -*/
+    options.add_double("EXTERN_FMM_THETA", 0.3);
+    /*- Largest number of charges in a leaf of the |EXTERN_FMM| octree -*/
+    options.add_int("EXTERN_FMM_LEAF_SIZE", 32);
+    /*- Distance (bohr) an external charge may move before the potential matrix
+    is updated for it. Between SCF runs in the same basis only charges that
+    moved further, or were added or removed, are integrated again, as a
+    correction to the previous matrix. The default of zero is exact. -*/
+    options.add_double("EXTERN_UPDATE_TOLERANCE", 0.0);
 
     /*- Radius (bohr) of a hard-sphere external potential -*/
     options.add_double("RADIUS", 10.0); // bohr
@@ -1394,8 +1667,41 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DF_INTS_NUM_THREADS",0);
     /*- IO caching for CP corrections, etc !expert -*/
     options.add_str("DF_INTS_IO", "NONE", "NONE SAVE LOAD");
+    /*- Distribute the auxiliary index of the DF-SCF integrals over MPI ranks?
+        Each rank keeps its slice in core. Requires a build with ``ENABLE_MPI``. -*/
+    options.add_bool("DF_SCF_DISTRIBUTED", false);
+    /*- Form the DF-SCF J and K in the SO basis, keeping only the symmetry-allowed
+        blocks of the fitted integrals. Falls back to the C1 algorithm for
+        range-separated functionals, |scf__df_local_k|,
+        |scf__df_scf_mixed_precision|, or when the integrals do not fit in core. -*/
+    options.add_bool("DF_SCF_SYMMETRY", false);
     /*- Fitting Condition !expert -*/
     options.add_double("DF_FITTING_CONDITION", 1.0E-12);
+    /*- Build the DF exchange matrix from localized occupied orbitals, each
+        contracted only over the AOs where its coefficients exceed
+        |scf__df_local_k_tolerance|. Pays off for large, gapped systems. -*/
+    options.add_bool("DF_LOCAL_K", false);
+    /*- Coefficient below which an AO drops out of a localized orbital's
+        domain in |scf__df_local_k| builds -*/
+    options.add_double("DF_LOCAL_K_TOLERANCE", 1.0E-6);
+    /*- Localization scheme for the occupied orbitals of |scf__df_local_k| builds -*/
+    options.add_str("DF_LOCAL_K_LOCALIZER", "BOYS", "BOYS PIPEK_MEZEY");
+    /*- Hold the DF-SCF (Q|mn) integrals in single precision, contracted with
+        SGEMM, until the density settles, then rebuild them in double precision
+        for the remaining iterations. Halves the tensor, so larger systems stay
+        in core for the early iterations. Not used with range-separated
+        functionals, |scf__df_local_k|, or |scf__df_ints_io| other than NONE.
+        Only the SCF iterations use it; CPHF, SAPT and other JK users stay
+        in double precision. -*/
+    options.add_bool("DF_SCF_MIXED_PRECISION", false);
+    /*- RMS change of the AO density between two Fock builds below which
+        |scf__df_scf_mixed_precision| switches to double precision -*/
+    options.add_double("DF_SCF_MIXED_PRECISION_SWITCH", 1.0E-4);
+    /*- DF-SCF gradients skip the three-index derivative integrals of a shell
+        triplet whose Schwarz bound, times the largest density and fitting
+        coefficients it is contracted with, is below this value. 0.0 turns
+        the density screening off. !expert -*/
+    options.add_double("DF_GRAD_SCREENING_CUTOFF", 1.0E-12);
     /*- FastDF Fitting Metric -*/
     options.add_str("DF_METRIC", "COULOMB", "COULOMB EWALD OVERLAP");
     /*- FastDF SR Ewald metric range separation parameter -*/
@@ -1425,6 +1731,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("SAD_FRAC_OCC", false);
     /*- Auxiliary basis for the SAD guess !expert -*/
     options.add_double("SAD_CHOL_TOLERANCE", 1E-7);
+    /*- Directory in which atomic SAD densities are stored and looked up, by
+    element, electron count, basis, and SAD options, so that separate jobs
+    can share them. Densities are only kept in memory if empty. -*/
+    options.add_str_i("SAD_CACHE_DIR", "");
 
     /*- SUBSECTION DFT -*/
 
@@ -1443,6 +1753,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DFT_ALPHA_C", 0.0);
     /*- Minima rho cutoff for the second derivative -*/
     options.add_double("DFT_V2_RHO_CUTOFF", 1.e-6);
+    /*- Evaluate restricted Slater, B88, PBE, VWN(RPA), LYP and PBE correlation
+    potentials, alone or as mixed by LibXC (e.g. B3LYP, PBE0), with built-in
+    kernels instead of through LibXC. Second derivatives and other functionals
+    still go to LibXC. -*/
+    options.add_bool("DFT_NATIVE_KERNELS", false);
     /*- The gradient regularized asymptotic correction shift value -*/
     options.add_double("DFT_GRAC_SHIFT", 0.0);
     /*- The gradient regularized asymptotic correction alpha value -*/
@@ -1457,6 +1772,17 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DFT_SPHERICAL_POINTS", 302);
     /*- Number of radial points. -*/
     options.add_int("DFT_RADIAL_POINTS", 75);
+    /*- Radial points added per period of the periodic table. With a nonzero
+        increment, |scf__dft_radial_points| applies to the second period (Li-Ne),
+        H and He get one increment fewer, Na-Ar one more, and so on. -*/
+    options.add_int("DFT_RADIAL_ROW_INCREMENT", 0);
+    /*- Number of spherical points of a coarse grid that the SCF runs on until it
+        first converges. The SCF then moves to the full grid and
+        continues. 0 turns the coarse guess grid off. -*/
+    options.add_int("DFT_GUESS_SPHERICAL_POINTS", 0);
+    /*- Number of radial points of the coarse guess grid of
+        |scf__dft_guess_spherical_points|. 0 keeps |scf__dft_radial_points|. -*/
+    options.add_int("DFT_GUESS_RADIAL_POINTS", 0);
     /*- Spherical Scheme. -*/
     options.add_str("DFT_SPHERICAL_SCHEME", "LEBEDEV", "LEBEDEV");
     /*- Radial Scheme. -*/
@@ -1481,6 +1807,23 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DFT_BLOCK_MAX_RADIUS",3.0);
     /*- The blocking scheme for DFT. !expert -*/
     options.add_str("DFT_BLOCK_SCHEME","OCTREE","NAIVE OCTREE");
+    /*- Do reuse the blocked DFT grid between computations on the same atoms,
+    basis, and grid options? For a geometry within |scf__dft_grid_cache_max_shift|
+    of the cached one, the points move with their atoms and only the nuclear
+    weights are recomputed. -*/
+    options.add_bool("DFT_GRID_CACHE", false);
+    /*- The largest atom displacement [au] for which a cached DFT grid is
+    reused. Beyond it the grid is rebuilt and replaces the cached one. -*/
+    options.add_double("DFT_GRID_CACHE_MAX_SHIFT", 0.1);
+    /*- File in which |scf__dft_grid_cache| also stores the grid, so that it
+    can be read back in a separate run. No file is used if empty. -*/
+    options.add_str_i("DFT_GRID_CACHE_FILE", "");
+    /*- Do build the exchange-correlation potential of a symmetric molecule
+    on the grids of its symmetry-unique atoms only? Their weights are scaled
+    by the number of equivalent atoms, which is exact for the totally
+    symmetric SO blocks of V and the energy. Response, gradient and Hessian
+    terms always use the full grid. -*/
+    options.add_bool("DFT_GRID_SYMMETRY", true);
     /*- Parameters defining the dispersion correction. See Table
     :ref:`-D Functionals <table:dft_disp>` for default values and Table
     :ref:`Dispersion Corrections <table:dashd>` for the order in which
@@ -1492,10 +1835,17 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DFT_VV10_RADIAL_POINTS", 50);
     /*- Rho cutoff for VV10 NL integration. !expert -*/
     options.add_double("DFT_VV10_RHO_CUTOFF", 1.e-8);
+    /*- Distance [a0] beyond which pairs of VV10 grid blocks are left out of the
+    NL kernel, which decays as R^-6. The default of 0.0 pairs every point with
+    every other. !expert -*/
+    options.add_double("DFT_VV10_SCREEN_RADIUS", 0.0);
     /*- The convergence on the orbital localization procedure -*/
     options.add_double("LOCAL_CONVERGENCE",1E-12);
     /*- The maxiter on the orbital localization procedure -*/
     options.add_int("LOCAL_MAXITER",200);
+    /*- The solver of the orbital localization procedure, pairwise ``JACOBI``
+    sweeps or ``NEWTON`` steps (falling back on sweeps far from the optimum) -*/
+    options.add_str("LOCAL_SOLVER", "JACOBI", "JACOBI NEWTON");
     /*- The number of NOONs to print in a UHF calc -*/
     options.add_str("UHF_NOONS", "3");
     /*- Save the UHF NOs -*/
@@ -1714,6 +2064,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- Do restart the coupled-cluster iterations from old $\lambda@@1$ and $\lambda@@2$
     amplitudes? -*/
     options.add_bool("RESTART",false);
+    /*- Write the ground-state $\lambda$ amplitudes and DIIS subspace to
+    ``<writer file label>.cclamps`` every this many iterations and on
+    convergence, and pick them up from there when the orbitals match.
+    Unlike the PSIO scratch files, the checkpoint survives a killed job.
+    Unless RESTART is explicitly turned off, a matching checkpoint is read
+    at startup. 0 turns checkpoints off. -*/
+    options.add_int("CC_CHECKPOINT_FREQ", 0);
     /*- Caching level for libdpd governing the storage of amplitudes,
     integrals, and intermediates in the CC procedure. A value of 0 retains
     no quantities in cache, while a level of 6 attempts to store all
@@ -1790,6 +2147,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("PR", false);
     /*- Number of components of transition amplitudes printed -*/
     options.add_int("NUM_AMPS_PRINT", 5);
+    /*- How to handle the $\langle ia|bc \rangle$ integrals, the largest
+    ones ADC(2) needs. ``DF`` fits them with |dfmp2__df_basis_mp2| instead of
+    transforming and storing them, and builds the sigma vectors of all new
+    trial vectors of an irrep in the same passes over the fitted integrals.
+    The other integrals stay conventional. -*/
+    options.add_str("ADC_OVVV_TYPE", "CONV", "CONV DF");
   }
   if(name == "CCHBAR"|| options.read_globals()) {
      /*- MODULEDESCRIPTION Assembles the coupled cluster effective Hamiltonian. Called whenever CC
@@ -1810,6 +2173,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("CACHELEVEL",2);
     /*- Do use the minimal-disk algorithm for Wabei? It's VERY slow! -*/
     options.add_bool("WABEI_LOWDISK", false);
+    /*- Number of threads for the Wabei contractions; defaults to the
+    number of threads psi4 was given -*/
+    options.add_int("CC_NUM_THREADS", 1);
   }
   if(name == "CCEOM"|| options.read_globals()) {
      /*- MODULEDESCRIPTION Performs equation-of-motion (EOM) coupled cluster excited state computations. -*/
@@ -1829,8 +2195,14 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     which means that all four-index quantities with up to two virtual-orbital
     indices (e.g., $\left\langle ij | ab \right\rangle$ integrals) may be held in the cache. -*/
     options.add_int("CACHELEVEL",2);
-    /*- The criterion used to retain/release cached data -*/
-    options.add_str("CACHETYPE", "LRU", "LOW LRU");
+    /*- The criterion used to retain/release cached data. ``ADAPTIVE``
+    measures how often each cached quantity is used and how long it takes
+    to read from disk during the first iterations, then pins the most
+    valuable ones within the memory budget. -*/
+    options.add_str("CACHETYPE", "LRU", "LOW LRU ADAPTIVE");
+    /*- Number of iterations over which the ``ADAPTIVE`` cache observes
+    usage before choosing the entries to pin. -*/
+    options.add_int("CACHE_ADAPT_ITERS", 2);
     /*- Number of threads -*/
     options.add_int("CC_NUM_THREADS", 1);
     /*- Type of ABCD algorithm will be used -*/
@@ -2099,6 +2471,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     updates, the CC codes will, by default, re-use old vectors, unless
     the user sets RESTART = false. -*/
     options.add_bool("RESTART",1);
+    /*- Write the T amplitudes and DIIS subspace to ``<writer file
+    label>.ccamps`` every this many iterations and on convergence. With
+    RESTART on, a later run on the same orbitals (same phases included)
+    resumes from the checkpoint instead of the MP2 guess.  This is how a
+    killed job gets back its iterations, because the PSIO scratch files
+    are not reused across runs.  0 turns checkpoints off. -*/
+    options.add_int("CC_CHECKPOINT_FREQ", 0);
     /*- Do restart the coupled-cluster iterations even if MO phases are screwed up? !expert -*/
     options.add_bool("FORCE_RESTART", 0);
 //#warning CCEnergy ao_basis keyword type was changed.
@@ -2106,8 +2485,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     If AO_BASIS is ``NONE``, the MO-basis integrals will be used;
     if AO_BASIS is ``DISK``, the AO-basis integrals stored on disk will
     be used; if AO_BASIS is ``DIRECT``, the AO-basis integrals will be computed
-    on the fly as necessary.  NB: The ``DIRECT`` option is not fully
-    implemented and should only be used by experts.  Default is NONE.
+    on the fly as necessary, Schwarz-screened and spread over the CC threads,
+    so the $\left\langle VV||VV\right\rangle$ terms need no integral storage at
+    all.  Default is NONE.
     Note: The developers recommend use of this keyword only as a last
     resort because it significantly slows the calculation. The current
     algorithms for handling the MO-basis four-virtual-index integrals have
@@ -2210,6 +2590,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("MP2_SS_SCALE", 1.0/3.0);
     /*- \% of memory for DF-MP2 three-index buffers -*/
     options.add_double("DFMP2_MEM_FACTOR", 0.9);
+    /*- Algorithm for the DF-MP2 energy. DISK stripes (A|ia) and (Q|ia) through
+    scratch files, INCORE holds all of (Q|ia) in memory, and DIRECT rebuilds
+    blocks of (Q|ia) from the integrals as the energy needs them, so neither
+    touches the disk. AUTO picks INCORE when it fits and DISK otherwise.
+    INCORE and DIRECT are available for RHF energies; gradients, UHF, and ROHF
+    always use DISK. -*/
+    options.add_str("DFMP2_ALGORITHM", "AUTO", "AUTO DISK INCORE DIRECT");
     /*- Minimum absolute value below which integrals are neglected. -*/
     options.add_double("INTS_TOLERANCE", 0.0);
     /*- Minimum error in the 2-norm of the P(2) matrix for corrections to Lia and P. -*/
@@ -2224,6 +2611,19 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("OPDM_RELAX",true);
     /*- Do compute one-particle density matrix? -*/
     options.add_bool("ONEPDM",false);
+    /*- Cutoff for the occupation of the DF-MP2 virtual natural orbitals kept
+    by |globals__fno_truncate|. Virtual NOs with smaller occupations are
+    frozen. -*/
+    options.add_double("OCC_TOLERANCE", 1.0e-6);
+    /*- Percentage of the DF-MP2 virtual occupation kept by
+    |globals__fno_truncate|; the NOs with the largest occupations are kept
+    until the percentage is reached. This keyword overrides
+    |dfmp2__occ_tolerance|. -*/
+    options.add_double("OCC_PERCENTAGE", 99.0);
+    /*- An array containing the number of virtual natural orbitals per irrep
+    (in Cotton order) kept by |globals__fno_truncate|. This keyword overrides
+    |dfmp2__occ_tolerance| and |dfmp2__occ_percentage|. -*/
+    options.add("ACTIVE_NAT_ORBS", new ArrayType());
   }
   if(name == "DFEP2"|| options.read_globals()) {
     /*- MODULEDESCRIPTION Performs density-fitted EP2 computations for RHF reference wavefunctions. -*/
@@ -2260,7 +2660,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DAMPING_PERCENTAGE",0.0);
     /*- Maximum number of error vectors stored for DIIS extrapolation -*/
     options.add_int("DIIS_MAX_VECS",7);
-    /*- Number of threads -*/
+    /*- Number of threads. In a full in-core computation, independent
+        operations of an expression batch are evaluated at the same time,
+        one per thread. -*/
     options.add_int("CC_NUM_THREADS",1);
     /*- Which root of the effective hamiltonian is the target state? -*/
     options.add_int("FOLLOW_ROOT",1);
@@ -2385,6 +2787,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       /*- Reduce step size as necessary to ensure back-transformation of internal
           coordinate step to cartesian coordinates. -*/
       options.add_bool("ENSURE_BT_CONVERGENCE", false);
+      /*- Fragments with at least this many atoms keep their B matrix sparse and
+          back-transform steps to Cartesians by an iterative least-squares solve,
+          never forming or diagonalizing the G matrix. 0 turns this off. -*/
+      options.add_int("BT_SPARSE_NATOM", 100);
       /*= Do stupid, linear scaling of internal coordinates to step limit (not RS-RFO) -*/
       options.add_bool("SIMPLE_STEP_SCALING", false);
       /*- Set number of consecutive backward steps allowed in optimization -*/
@@ -2462,6 +2868,14 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       means recompute every step, and N means recompute every N steps. The
       default (-1) is to never compute the full Hessian. -*/
       options.add_int("FULL_HESS_EVERY", -1);
+      /*- Compute the Hessians asked for by |optking__full_hess_every| only along
+      this many lowest modes of the previous Hessian (of the Lindh model Hessian
+      for the first), by finite differences of gradients along each mode, and
+      keep the previous Hessian for the rest of the space. Costs two gradients
+      per mode instead of two per coordinate; run the optimization with
+      ``mode='farm'`` to compute them concurrently. The default (0) computes
+      full Hessians. -*/
+      options.add_int("HESS_SUBSPACE_MODES", 0);
       /*- Model Hessian to guess intrafragment force constants -*/
       options.add_str("INTRAFRAG_HESS", "SCHLEGEL", "FISCHER SCHLEGEL SIMPLE LINDH LINDH_SIMPLE");
 
@@ -2702,6 +3116,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("CC_DIIS_MIN_VECS",2);
     /*- Maximum number of vectors used in amplitude DIIS -*/
     options.add_int("CC_DIIS_MAX_VECS",6);
+    /*- Storage of the amplitude DIIS subspace. DISK keeps the vectors in the scratch
+    file, CORE keeps them in memory, and CORE_SINGLE keeps them in memory in single
+    precision, at half the memory of CORE. -*/
+    options.add_str("CC_DIIS_STORAGE","DISK","DISK CORE CORE_SINGLE");
     /*- Cutoff value for DF integrals -*/
     options.add_int("INTEGRAL_CUTOFF",9);
     /*- Cutoff value for numerical procedures -*/
@@ -2775,6 +3193,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str("MP2_AMP_TYPE","DIRECT","DIRECT CONV");
     /*- Type of the CCSD PPL term. -*/
     options.add_str("PPL_TYPE","AUTO","LOW_MEM HIGH_MEM CD AUTO");
+    /*- Do evaluate the DF-CCSD particle-particle ladder term with SGEMM
+    until the T2 residual drops below |dfocc__cc_mixed_precision_switch|?
+    The amplitudes stay double, and the last iterations always run in double
+    precision, so the converged energy is unaffected. Not used with
+    |dfocc__ppl_type| CD. -*/
+    options.add_bool("CC_MIXED_PRECISION",false);
+    /*- RMS T2 residual below which |dfocc__cc_mixed_precision| switches
+    the ladder term to double precision -*/
+    options.add_double("CC_MIXED_PRECISION_SWITCH",1.0E-4);
     /*- The algorithm to handle (ia|bc) type integrals that used for (T) correction. -*/
     options.add_str("TRIPLES_IABC_TYPE","DISK","INCORE AUTO DIRECT DISK");
 
@@ -2804,6 +3231,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("READ_SCF_3INDEX",true);
     /*- Do compute one electron properties?  -*/
     options.add_bool("OEPROP",false);
+    /*- Do reuse the memory of released tensors for later ones of the same
+    shape? This saves the allocation and page faults of the temporaries built
+    in every iteration, at the cost of keeping idle buffers. -*/
+    options.add_bool("TENSOR_POOL",false);
+    /*- Fraction of the memory that idle tensor buffers may hold when
+    |dfocc__tensor_pool| is on. -*/
+    options.add_double("TENSOR_POOL_FRACTION",0.2);
     /*- Do compute $\langle \hat{S}^2 \rangle$ for DF-OMP2/DF-MP2?  -*/
     options.add_bool("COMPUT_S2",false);
     /*- Do perform a QCHF computation?  -*/
@@ -2817,6 +3251,18 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("MOLDEN_WRITE",false);
     /*- Do Cholesky decomposition of the ERI tensor -*/
     options.add_bool("CHOLESKY",false);
+    /*- Do model the truncation of the RHF DF-CCSD, DF-CCD and DF-LCCD doubles to pair
+    natural orbitals of the MP2 pair densities? The amplitudes of each pair are confined
+    to its PNOs and the MP2 energy lost to the truncation is added back. This measures
+    the accuracy of a PNO cutoff only: the contractions still run over all canonical
+    virtuals, so the computation is no cheaper than without it. -*/
+    options.add_bool("PNO",false);
+    /*- Occupation number below which PNOs are dropped, if |dfocc__pno| is true -*/
+    options.add_double("PNO_CUTOFF",1e-8);
+    /*- Do form the DF integrals of each orbital iteration by rotating those of the
+    reference MOs with the accumulated orbital rotation, rather than transforming the
+    AO integrals read from disk? Applies to the DF (not CD) orbital-optimized methods. -*/
+    options.add_bool("ROTATE_DF_INTS",false);
   }
   if (name == "MRCC"|| options.read_globals()) {
       /*- MODULEDESCRIPTION Interface to MRCC program written by Mih\ |a_acute|\ ly K\ |a_acute|\ llay. -*/
@@ -2906,6 +3352,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add_bool("COMPUTE_TRIPLES", true);
       /*- Do compute MP4 triples contribution? !expert -*/
       options.add_bool("COMPUTE_MP4_TRIPLES", false);
+      /*- Do split the (T) loops over MPI ranks? Every rank runs the same
+          CCSD and keeps its own copy of the integrals and amplitudes; only
+          the (T) energy is summed. Requires a build with ``ENABLE_MPI``. -*/
+      options.add_bool("TRIPLES_DISTRIBUTED", false);
       /*- Do use MP2 NOs to truncate virtual space for QCISD/CCSD and (T)? -*/
       options.add_bool("NAT_ORBS", false);
       /*- Cutoff for occupation of MP2 virtual NOs in FNO-QCISD/CCSD(T).
@@ -4431,6 +4881,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
         options.add_str("DERTYPE", "NONE", "NONE FIRST");
         /*- Do turn on QM/EFP terms? !expert -*/
         options.add_bool("QMEFP", false);
+        /*- Do keep the EFP/EFP electrostatics, exchange, and dispersion
+            terms between calculations and reuse them while the fragments
+            have not moved? -*/
+        options.add_bool("EFP_CACHE", true);
     }
     if (name == "DMRG"|| options.read_globals()) {
       /*- MODULEDESCRIPTION Performs a DMRG computation